@@ -0,0 +1,61 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+struct VertexData {
+    vec2 TextureCoord;
+};
+
+// Source mip is the only level visible through sampler.
+uniform sampler2D AlbedoMap;
+// xy: scale of texture coordinates into source region, zw: max source texture coordinate.
+uniform vec4 BlitParams;
+
+#ifdef VERTEX
+
+out VertexData Vertex;
+
+// Vertex index 0, 1, 2 maps to texture coordinate (0, 0), (2, 0), (0, 2), so the triangle covers the viewport.
+void main()
+{
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    Vertex.TextureCoord = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+in VertexData Vertex;
+
+out vec4 fragColor;
+
+vec3 sampleSource(vec2 uv)
+{
+    return texture(AlbedoMap, min(uv, BlitParams.zw)).rgb;
+}
+
+void main()
+{
+    vec2 uv = Vertex.TextureCoord * BlitParams.xy;
+    vec2 texel = 1.0 / vec2(textureSize(AlbedoMap, 0));
+
+    // 13 bilinear taps, weighted as overlapping 2x2 boxes to avoid aliasing of single box filter.
+    vec3 a = sampleSource(uv + texel * vec2(-2.0, 2.0));
+    vec3 b = sampleSource(uv + texel * vec2(0.0, 2.0));
+    vec3 c = sampleSource(uv + texel * vec2(2.0, 2.0));
+    vec3 d = sampleSource(uv + texel * vec2(-2.0, 0.0));
+    vec3 e = sampleSource(uv);
+    vec3 f = sampleSource(uv + texel * vec2(2.0, 0.0));
+    vec3 g = sampleSource(uv + texel * vec2(-2.0, -2.0));
+    vec3 h = sampleSource(uv + texel * vec2(0.0, -2.0));
+    vec3 i = sampleSource(uv + texel * vec2(2.0, -2.0));
+    vec3 j = sampleSource(uv + texel * vec2(-1.0, 1.0));
+    vec3 k = sampleSource(uv + texel * vec2(1.0, 1.0));
+    vec3 l = sampleSource(uv + texel * vec2(-1.0, -1.0));
+    vec3 m = sampleSource(uv + texel * vec2(1.0, -1.0));
+
+    vec3 color = e * 0.125 + (a + c + g + i) * 0.03125 + (b + d + f + h) * 0.0625 + (j + k + l + m) * 0.125;
+    fragColor = vec4(color, 1.0);
+}
+
+#endif
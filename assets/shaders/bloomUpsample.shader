@@ -0,0 +1,47 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+struct VertexData {
+    vec2 TextureCoord;
+};
+
+// Smaller mip of bloom chain, result is added to larger one.
+uniform sampler2D AlbedoMap;
+// x: filter radius in source texels.
+uniform vec4 BlitParams;
+
+#ifdef VERTEX
+
+out VertexData Vertex;
+
+// Vertex index 0, 1, 2 maps to texture coordinate (0, 0), (2, 0), (0, 2), so the triangle covers the viewport.
+void main()
+{
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    Vertex.TextureCoord = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+in VertexData Vertex;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec2 uv = Vertex.TextureCoord;
+    vec2 offset = BlitParams.x / vec2(textureSize(AlbedoMap, 0));
+
+    // 3x3 tent filter.
+    vec3 color = texture(AlbedoMap, uv).rgb * 4.0;
+    color += (texture(AlbedoMap, uv + vec2(offset.x, 0.0)).rgb + texture(AlbedoMap, uv - vec2(offset.x, 0.0)).rgb +
+              texture(AlbedoMap, uv + vec2(0.0, offset.y)).rgb + texture(AlbedoMap, uv - vec2(0.0, offset.y)).rgb) * 2.0;
+    color += texture(AlbedoMap, uv + offset).rgb + texture(AlbedoMap, uv - offset).rgb +
+             texture(AlbedoMap, uv + vec2(offset.x, -offset.y)).rgb + texture(AlbedoMap, uv + vec2(-offset.x, offset.y)).rgb;
+
+    fragColor = vec4(color / 16.0, 0.0);
+}
+
+#endif
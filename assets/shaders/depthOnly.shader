@@ -0,0 +1,37 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+// Bound from per frame uniform ring, see UniformBlock::FRAME.
+layout(std140) uniform FrameParams
+{
+    mat4 ViewProjection;
+    vec4 CameraPosition;
+    vec4 LightDirection;
+    vec4 CameraForward;
+    vec4 ClusterScale;
+    vec4 ClusterGrid;
+};
+
+#ifdef VERTEX
+
+layout(location = 0) in vec3 Position;
+// Per instance attribute, set as generic attribute value for non instanced draws.
+layout(location = 6) in mat4 Model;
+
+// Must match pbr.shader, so depth of prepass is bitwise equal to depth of shading pass.
+invariant gl_Position;
+
+void main()
+{
+    vec4 WorldPosition = Model * vec4(Position, 1.0);
+    gl_Position = ViewProjection * WorldPosition;
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+void main()
+{
+}
+
+#endif
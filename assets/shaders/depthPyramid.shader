@@ -0,0 +1,60 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+// Source mip is the only level visible through sampler.
+uniform sampler2D AlbedoMap;
+// x: zero copies source, one reduces 2x2 texels. yz: last texel of source.
+uniform vec4 BlitParams;
+
+#ifdef VERTEX
+
+// Full screen triangle from vertex index, see Render::DrawFullScreenTriangle.
+void main()
+{
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+out vec4 fragColor;
+
+float fetchDepth(ivec2 coord)
+{
+    return texelFetch(AlbedoMap, min(coord, ivec2(BlitParams.yz)), 0).r;
+}
+
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+
+    if (BlitParams.x == 0.0)
+    {
+        fragColor = vec4(fetchDepth(coord));
+        return;
+    }
+
+    // Farthest depth keeps pyramid conservative for occlusion tests.
+    ivec2 source = coord * 2;
+    float depth = max(max(fetchDepth(source), fetchDepth(source + ivec2(1, 0))),
+                      max(fetchDepth(source + ivec2(0, 1)), fetchDepth(source + ivec2(1, 1))));
+
+    // Odd sized source would lose its last column or row otherwise.
+    ivec2 last = ivec2(BlitParams.yz);
+    bool extraColumn = source.x + 2 == last.x;
+    bool extraRow = source.y + 2 == last.y;
+
+    if (extraColumn)
+        depth = max(depth, max(fetchDepth(source + ivec2(2, 0)), fetchDepth(source + ivec2(2, 1))));
+
+    if (extraRow)
+        depth = max(depth, max(fetchDepth(source + ivec2(0, 2)), fetchDepth(source + ivec2(1, 2))));
+
+    if (extraColumn && extraRow)
+        depth = max(depth, fetchDepth(source + ivec2(2, 2)));
+
+    fragColor = vec4(depth);
+}
+
+#endif
@@ -3,8 +3,22 @@
 #define PI 3.1415926535897932384626433832795
 
 uniform vec4 Material;
-uniform vec4 CameraPosition;
-uniform vec4 LightDirection;
+
+// Bound from per frame uniform ring, see UniformBlock::FRAME.
+layout(std140) uniform FrameParams
+{
+    mat4 ViewProjection;
+    vec4 CameraPosition;
+    vec4 LightDirection;
+    vec4 CameraForward;
+    // xy: clusters per pixel, z: slice scale, w: slice bias.
+    vec4 ClusterScale;
+    // xyz: clusters grid size, w: lights count.
+    vec4 ClusterGrid;
+    // Without subpixel jitter, used for motion vectors only.
+    mat4 UnjitteredViewProjection;
+    mat4 PreviousViewProjection;
+};
 
 float saturate(float x)
 {
@@ -109,6 +123,8 @@ struct VertexData {
     vec3 Binormal;
     vec3 WorldPosition;
     vec2 UV;
+    vec4 CurrentClip;
+    vec4 PreviousClip;
 };
 
 #ifdef VERTEX
@@ -116,24 +132,50 @@ struct VertexData {
 layout(location = 0) in vec3 Position;
 layout(location = 1) in vec2 UV;
 layout(location = 2) in vec3 Normal;
-layout(location = 3) in vec3 Tangent;
+// Compact vertex formats store octahedral tangent in xy, bitangent sign in z and zero in w.
+// Full format binds three components, so w reads as one.
+layout(location = 3) in vec4 Tangent;
 layout(location = 4) in vec3 Binormal;
 layout(location = 5) in vec4 Color;
-
-uniform mat4 ViewProjection;
-uniform mat4 Model;
+// Per instance attribute, set as generic attribute value for non instanced draws.
+layout(location = 6) in mat4 Model;
 
 out VertexData Vertex;
 
+// Must match depthOnly.shader, so shading pass passes depth test against prepass depth.
+invariant gl_Position;
+
+vec3 OctahedralDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main()
 {
     vec4 WorldPosition = Model * vec4(Position, 1.0);
 
-    Vertex.Normal = normalize(mat3(Model) * Normal);
-    Vertex.Tangent = normalize(mat3(Model) * Tangent);
-    Vertex.Binormal = normalize(mat3(Model) * Binormal);
+    vec3 normal = Normal;
+    vec3 tangent = Tangent.xyz;
+    vec3 binormal = Binormal;
+
+    if (Tangent.w < 0.5)
+    {
+        normal = OctahedralDecode(Normal.xy);
+        tangent = OctahedralDecode(Tangent.xy);
+        binormal = cross(normal, tangent) * (Tangent.z < 0.0 ? -1.0 : 1.0);
+    }
+
+    Vertex.Normal = normalize(mat3(Model) * normal);
+    Vertex.Tangent = normalize(mat3(Model) * tangent);
+    Vertex.Binormal = normalize(mat3(Model) * binormal);
 	Vertex.WorldPosition = WorldPosition.xyz;
 	Vertex.UV = UV;
+    // Camera motion only, objects are assumed static.
+    Vertex.CurrentClip = UnjitteredViewProjection * WorldPosition;
+    Vertex.PreviousClip = PreviousViewProjection * WorldPosition;
 
 	gl_Position = ViewProjection * WorldPosition;
 }
@@ -144,13 +186,55 @@ void main()
 
 in VertexData Vertex;
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+// Screen space UV offset from previous frame position, ignored when pass has no motion target.
+layout(location = 1) out vec2 Motion;
 
 uniform sampler2D AlbedoMap;
 uniform sampler2D NormalMap;
 uniform sampler2D RoughnessMap;
 uniform sampler2D MetallicMap;
 
+// Clustered point lights, see LightClusters.
+uniform usamplerBuffer LightClusters;
+uniform usamplerBuffer LightIndices;
+uniform samplerBuffer Lights;
+
+vec3 BRDF(vec3 N, vec3 V, vec3 L, vec3 diffuseColor, vec3 f0, float f90, float linearRoughness, float roughness)
+{
+    // This code is an example of call of previous functions
+    float NdotV = abs(dot(N, V)) + 1e-5; // avoid artifact
+
+    vec3 H = normalize(V + L);
+
+    float LdotH = saturate(dot(L, H));
+    float NdotH = saturate(dot(N, H));
+    float NdotL = saturate(dot(N, L));
+
+    // Specular BRDF
+    vec3  F   = F_Schlick(f0, f90, NdotV);
+    float Vis = V_SmithGGXCorrelated(NdotV, NdotL, roughness);
+    float D   = D_GGX(NdotH, roughness);
+    vec3  Fr  = D * F * Vis;
+
+    // Diffuse BRDF
+    //vec3 renormCoeff = vec3(1.0f - F);
+    //vec3 renormCoeff = vec3(mix( 1.0, 1.0 / 1.51, linearRoughness ));
+    //float Fd = Lambert(NdotV, NdotL, LdotH, linearRoughness);
+
+    float Fd = DisneyDiffuseRenorm(NdotV, NdotL, LdotH, linearRoughness);
+    vec3 diffuse = Fd * diffuseColor;
+    return vec3(diffuse + Fr) * NdotL / PI;
+}
+
+// Inverse square falloff windowed to reach zero at light radius.
+float DistanceAttenuation(float distanceSqr, float radius)
+{
+    float factor = distanceSqr / (radius * radius);
+    float window = saturate(1.0 - factor * factor);
+    return window * window / max(distanceSqr, 1e-4);
+}
+
 void main()
 {
     mat3 TBNBasis = mat3(normalize(Vertex.Tangent),
@@ -166,17 +250,6 @@ void main()
     L = dot(L, N) < 0 ? -L : L;
     L = normalize(vec3(-1, 1, 1));
 
-    // This code is an example of call of previous functions
-    float NdotV = abs(dot(N, V)) + 1e-5; // avoid artifact
-
-    vec3 H = normalize(V + L);
-
-    float LdotH = saturate(dot(L, H));
-    float NdotH = saturate(dot(N, H));
-    float NdotL = saturate(dot(N, L));
-
-    float LdotV = saturate(dot(L, V));
-
     float linearRoughness = texture(RoughnessMap, Vertex.UV).r;
     float roughness = linearRoughness * linearRoughness;
     float metallic = texture(MetallicMap, Vertex.UV).r;
@@ -185,25 +258,39 @@ void main()
     vec4 albedo = texture(AlbedoMap, Vertex.UV);
     albedo.rgb = vec3( pow(albedo.r, 2.2), pow(albedo.g, 2.2), pow(albedo.b, 2.2));
 
-    // Specular BRDF
     vec3  f0 = mix(vec3(0.04f, 0.04f, 0.04f), albedo.rgb, metallic);
     float f90 = 1.0 - linearRoughness;// + (1-oneMinusReflectivity));
-    vec3  F   = F_Schlick(f0, f90, NdotV);
-    float Vis = V_SmithGGXCorrelated(NdotV, NdotL, roughness);
-    float D   = D_GGX(NdotH, roughness);
-    vec3  Fr  = D * F * Vis;
     albedo.rgb *= oneMinusReflectivity;
 
-    // Diffuse BRDF
-    //vec3 renormCoeff = vec3(1.0f - F);
-    //vec3 renormCoeff = vec3(mix( 1.0, 1.0 / 1.51, linearRoughness ));
-    //float Fd = Lambert(NdotV, NdotL, LdotH, linearRoughness);
+    vec3 color = BRDF(N, V, L, albedo.rgb, f0, f90, linearRoughness, roughness);
 
-    float Fd = DisneyDiffuseRenorm(NdotV, NdotL, LdotH, linearRoughness);
-    vec3 diffuse = Fd * albedo.rgb;
-	vec3 color = vec3(diffuse + Fr) * NdotL / PI;
+    if (ClusterGrid.w > 0.0)
+    {
+        float depth = dot(Vertex.WorldPosition - CameraPosition.xyz, CameraForward.xyz);
+        ivec3 grid = ivec3(ClusterGrid.xyz);
+        ivec3 cluster = ivec3(gl_FragCoord.xy * ClusterScale.xy, log(max(depth, 1e-4)) * ClusterScale.z + ClusterScale.w);
+        cluster = clamp(cluster, ivec3(0), grid - 1);
+
+        // Only lights overlapping this fragment's cluster are evaluated.
+        uvec2 lightList = texelFetch(LightClusters, (cluster.z * grid.y + cluster.y) * grid.x + cluster.x).xy;
+
+        for (uint index = 0u; index < lightList.y; index++)
+        {
+            int light = int(texelFetch(LightIndices, int(lightList.x + index)).r);
+            vec4 positionRadius = texelFetch(Lights, light * 2);
+            vec3 lightColor = texelFetch(Lights, light * 2 + 1).rgb;
+
+            vec3 toLight = positionRadius.xyz - Vertex.WorldPosition;
+            float distanceSqr = dot(toLight, toLight);
+            float attenuation = DistanceAttenuation(distanceSqr, positionRadius.w);
+
+            if (attenuation > 0.0)
+                color += BRDF(N, V, toLight * inversesqrt(distanceSqr), albedo.rgb, f0, f90, linearRoughness, roughness) * lightColor * attenuation;
+        }
+    }
 
     FragColor = vec4(color, albedo.a);
+    Motion = (Vertex.CurrentClip.xy / Vertex.CurrentClip.w - Vertex.PreviousClip.xy / Vertex.PreviousClip.w) * 0.5;
 }
 
 #endif
\ No newline at end of file
@@ -1,25 +1,29 @@
 #extension GL_ARB_explicit_attrib_location : require
 
-#define PI 3.1415926535897932384626433832795
-
 struct VertexData {
     vec2 TextureCoord;
 };
 
-uniform sampler2D AlbedoTex;
+uniform sampler2D AlbedoMap;
+// Half resolution bloom, covers whole screen regardless of dynamic resolution.
+uniform sampler2D BloomMap;
+// Source is rendered at dynamic resolution into top left corner of texture.
+uniform vec4 UVScale;
+// x: bloom intensity, y: exposure, z: dither amplitude, w: tonemapping enabled.
+uniform vec4 PostParams;
+// xyz: tint, w: saturation.
+uniform vec4 ColorGrading;
 
 #ifdef VERTEX
 
-layout(location = 0) in vec3 Position;
-layout(location = 1) in vec2 TextureCoord;
-layout(location = 2) in vec3 Normal;
-
 out VertexData Vertex;
 
+// Vertex index 0, 1, 2 maps to texture coordinate (0, 0), (2, 0), (0, 2), so the triangle covers the viewport.
 void main()
 {
-    Vertex.TextureCoord = TextureCoord;
-	gl_Position = vec4(Position, 1.0);
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    Vertex.TextureCoord = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
 }
 
 #endif
@@ -30,25 +34,40 @@ in VertexData Vertex;
 
 out vec4 fragColor;
 
+// Narkowicz fit of ACES filmic curve.
+vec3 TonemapACES(vec3 x)
+{
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+float InterleavedGradientNoise(vec2 position)
+{
+    return fract(52.9829189 * fract(dot(position, vec2(0.06711056, 0.00583715))));
+}
+
 void main()
 {
-    vec4 color = texture(AlbedoTex, Vertex.TextureCoord);
-   // color.rgb = (color.rgb / color.a) * 2.0 * PI;
-
-//  if (max(max(color.r, color.g), color.b) > 1.2)
-//    {
-//        fragColor = vec4(0.0, 1.0, 0.0, 1.0);
-//        return;
-//    }
-//
-//    if (max(max(color.r, color.g), color.b) > 1.0)
-//    {
-//        fragColor = vec4(1.0, 0.0, 0.0, 1.0);
-//        return;
-//    }
-
-  // fragColor = vec4( color.rgb, 1.0);
-    fragColor = vec4( pow(color.r, 1/2.2), pow(color.g, 1/2.2), pow(color.b, 1/2.2), 1.0);
+    // Bilinear upscale of rendered region, clamped so filtering doesn't read texels outside of it.
+    vec2 uv = min(Vertex.TextureCoord * UVScale.xy, UVScale.zw);
+    vec3 color = texture(AlbedoMap, uv).rgb;
+
+    // Upscale, bloom composite, tonemapping, grading and dithering are fused, so HDR image is read once.
+    if (PostParams.x > 0.0)
+        color += texture(BloomMap, Vertex.TextureCoord).rgb * PostParams.x;
+
+    color *= PostParams.y;
+
+    if (PostParams.w > 0.0)
+        color = TonemapACES(color);
+
+    float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    color = mix(vec3(luminance), color, ColorGrading.w) * ColorGrading.xyz;
+
+    color = pow(max(color, vec3(0.0)), vec3(1.0 / 2.2));
+    // Breaks banding of 8 bit back buffer.
+    color += (InterleavedGradientNoise(gl_FragCoord.xy) - 0.5) * PostParams.z / 255.0;
+
+    fragColor = vec4(color, 1.0);
 }
 
-#endif
\ No newline at end of file
+#endif
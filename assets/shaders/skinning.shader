@@ -0,0 +1,58 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+// Outputs are captured by transform feedback in Rendering::Vertex layout, see Render::Skin.
+#define FEEDBACK_VERTEX
+
+// Bound from per frame uniform ring, see UniformBlock::SKINNING.
+layout(std140) uniform SkinningParams
+{
+    mat4 Palette[128];
+};
+
+#ifdef VERTEX
+
+layout(location = 0) in vec3 Position;
+layout(location = 1) in vec2 TexCoord;
+layout(location = 2) in vec3 Normal;
+layout(location = 3) in vec3 Tangent;
+layout(location = 4) in vec3 Binormal;
+layout(location = 5) in vec4 Color;
+layout(location = 10) in uvec4 Joints;
+layout(location = 11) in vec4 Weights;
+
+out vec3 OutPosition;
+out vec2 OutTexCoord;
+out vec3 OutNormal;
+out vec3 OutTangent;
+out vec3 OutBinormal;
+out vec4 OutColor;
+
+void main()
+{
+    mat4 Skin = Palette[Joints.x] * Weights.x +
+                Palette[Joints.y] * Weights.y +
+                Palette[Joints.z] * Weights.z +
+                Palette[Joints.w] * Weights.w;
+
+    // Joint scale is expected uniform, so basis vectors need no inverse transpose.
+    mat3 SkinBasis = mat3(Skin);
+
+    OutPosition = (Skin * vec4(Position, 1.0)).xyz;
+    OutTexCoord = TexCoord;
+    OutNormal = normalize(SkinBasis * Normal);
+    OutTangent = normalize(SkinBasis * Tangent);
+    OutBinormal = normalize(SkinBasis * Binormal);
+    OutColor = Color;
+
+    gl_Position = vec4(OutPosition, 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+void main()
+{
+}
+
+#endif
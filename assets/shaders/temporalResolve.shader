@@ -0,0 +1,74 @@
+#extension GL_ARB_explicit_attrib_location : require
+
+struct VertexData {
+    vec2 TextureCoord;
+};
+
+// Current jittered frame, rendered into top left corner of texture.
+uniform sampler2D AlbedoMap;
+// Previous resolved frame, covers whole texture at output resolution.
+uniform sampler2D HistoryMap;
+// UV offset from previous frame position, same layout as AlbedoMap.
+uniform sampler2D MotionMap;
+// xy: scale of texture coordinates into rendered region, zw: max source texture coordinate.
+uniform vec4 UVScale;
+// xy: jitter in rendered region UV units, z: weight of current frame.
+uniform vec4 BlitParams;
+
+#ifdef VERTEX
+
+out VertexData Vertex;
+
+// Vertex index 0, 1, 2 maps to texture coordinate (0, 0), (2, 0), (0, 2), so the triangle covers the viewport.
+void main()
+{
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    Vertex.TextureCoord = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#endif
+
+#ifdef FRAGMENT
+
+in VertexData Vertex;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec2 uv = Vertex.TextureCoord;
+
+    // Jittered frame shows scene shifted by jitter, sampling with the same offset undoes it.
+    vec2 sourceUV = min((uv + BlitParams.xy) * UVScale.xy, UVScale.zw);
+    vec3 current = texture(AlbedoMap, sourceUV).rgb;
+
+    // Color range of nearest source texel neighborhood bounds history.
+    ivec2 sourceSize = ivec2(UVScale.xy * vec2(textureSize(AlbedoMap, 0)) + 0.5);
+    ivec2 texel = ivec2(sourceUV * vec2(textureSize(AlbedoMap, 0)));
+    vec3 minColor = current;
+    vec3 maxColor = current;
+
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            vec3 neighbor = texelFetch(AlbedoMap, clamp(texel + ivec2(x, y), ivec2(0), sourceSize - 1), 0).rgb;
+            minColor = min(minColor, neighbor);
+            maxColor = max(maxColor, neighbor);
+        }
+    }
+
+    vec2 previousUV = uv - texelFetch(MotionMap, texel, 0).xy;
+
+    // Previous position off screen has no history.
+    float weight = BlitParams.z;
+    if (any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0))))
+        weight = 1.0;
+
+    vec3 history = clamp(texture(HistoryMap, previousUV).rgb, minColor, maxColor);
+
+    fragColor = vec4(mix(history, current, weight), 1.0);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+    }
+
+    namespace Benchmarks
+    {
+        // Device context shared by all benchmarks of the process.
+        Render::DeviceContext& GetDeviceContext();
+    }
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include "gapi/LinearAllocator.hpp"
+
+#include "common/threading/BufferedChannel.hpp"
+#include "common/threading/SpscQueue.hpp"
+
+#include <thread>
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        TEST_CASE("BufferedChannel", "[Common][Threading][BufferedChannel]")
+        {
+            // Enough items to amortize producer thread start.
+            constexpr uint32_t itemsCount = 64 * 1024;
+
+            BENCHMARK("Throughput 64K items")
+            {
+                Threading::BufferedChannel<uint64_t, 64> channel;
+
+                std::thread producer([&channel] {
+                    for (uint64_t item = 0; item < itemsCount; item++)
+                        channel.Put(item);
+
+                    channel.Close();
+                });
+
+                uint64_t sum = 0;
+                while (const auto item = channel.GetNext())
+                    sum += item.value();
+
+                producer.join();
+                return sum;
+            };
+        }
+
+        TEST_CASE("SpscQueue", "[Common][Threading][SpscQueue]")
+        {
+            constexpr uint32_t itemsCount = 64 * 1024;
+
+            BENCHMARK("Throughput 64K items")
+            {
+                Threading::SpscQueue<uint64_t, 64> queue;
+
+                std::thread producer([&queue] {
+                    for (uint64_t item = 0; item < itemsCount; item++)
+                        while (!queue.TryPush(item))
+                            std::this_thread::yield();
+                });
+
+                uint64_t sum = 0;
+                for (uint32_t received = 0; received < itemsCount;)
+                {
+                    if (const auto item = queue.TryPop())
+                    {
+                        sum += item.value();
+                        received++;
+                    }
+                }
+
+                producer.join();
+                return sum;
+            };
+        }
+
+        TEST_CASE("LinearAllocator", "[Gapi][LinearAllocator]")
+        {
+            GAPI::LinearAllocator allocator(16 * 1024);
+
+            struct Packet
+            {
+                uint64_t data[4];
+            };
+
+            BENCHMARK("Create 1024 packets and reset")
+            {
+                for (uint32_t index = 0; index < 1024; index++)
+                    allocator.Create<Packet>();
+
+                const auto allocated = allocator.GetCapacity();
+                allocator.Reset();
+                return allocated;
+            };
+
+            BENCHMARK("Allocate 1024 variable sizes and reset")
+            {
+                for (uint32_t index = 0; index < 1024; index++)
+                    allocator.Allocate(16 + (index & 0xFF));
+
+                const auto allocated = allocator.GetCapacity();
+                allocator.Reset();
+                return allocated;
+            };
+        }
+    }
+}
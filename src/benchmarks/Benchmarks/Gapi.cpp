@@ -0,0 +1,126 @@
+#include "gapi_dx12/pch.hpp"
+
+#include "JsonReporter.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResource.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/Texture.hpp"
+
+#include "gapi_dx12/DescriptorHeap.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        TEST_CASE("DescriptorHeap", "[Gapi][DX12][DescriptorHeap]")
+        {
+            constexpr uint32_t descriptorsCount = 1024;
+
+            // Heap only needs the device, so it gets own context instead of reaching into the shared one.
+            ComSharedPtr<IDXGIFactory2> dxgiFactory;
+            REQUIRE(SUCCEEDED(CreateDXGIFactory2(0, IID_PPV_ARGS(dxgiFactory.put()))));
+
+            ComSharedPtr<ID3D12Device> device;
+            REQUIRE(SUCCEEDED(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(device.put()))));
+
+            GAPI::DX12::DeviceContext dx12DeviceContext(device, dxgiFactory, 1);
+
+            const auto heap = std::make_shared<GAPI::DX12::DescriptorHeap>(dx12DeviceContext);
+            heap->Init({ "Benchmark", descriptorsCount, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_NONE });
+
+            BENCHMARK("Allocate and free")
+            {
+                GAPI::DX12::DescriptorHeap::Allocation allocation;
+                heap->Allocate(allocation);
+            };
+
+            // Fragmented heap, allocations are spread over chunks.
+            std::vector<GAPI::DX12::DescriptorHeap::Allocation> allocations(descriptorsCount / 2);
+            for (auto& allocation : allocations)
+                heap->Allocate(allocation);
+
+            BENCHMARK("Allocate and free in half full heap")
+            {
+                GAPI::DX12::DescriptorHeap::Allocation allocation;
+                heap->Allocate(allocation);
+            };
+        }
+
+        TEST_CASE("CpuResourceDataAllocator", "[Gapi][DX12][CpuResourceDataAllocator]")
+        {
+            auto& deviceContext = GetDeviceContext();
+
+            const auto& description = GAPI::GpuResourceDescription::Texture2D(256, 256, GAPI::GpuResourceFormat::RGBA8Unorm, GAPI::GpuResourceBindFlags::ShaderResource);
+
+            BENCHMARK("Alloc upload 256x256 RGBA8 with mips")
+            {
+                return deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Upload);
+            };
+
+            BENCHMARK("Alloc readback 256x256 RGBA8 with mips")
+            {
+                return deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+            };
+
+            BENCHMARK("Alloc CPU 256x256 RGBA8 with mips")
+            {
+                return deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::CpuReadWrite);
+            };
+
+            // Upload ring pages are recycled only with frames.
+            deviceContext.MoveToNextFrame(deviceContext.GetCommandQueue(GAPI::CommandQueueType::Graphics));
+        }
+
+        TEST_CASE("CopyBandwidth", "[Gapi][CopyCommandList][CopyBandwidth]")
+        {
+            auto& deviceContext = GetDeviceContext();
+
+            const auto& copyQueue = deviceContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "Benchmark");
+
+            constexpr uint32_t size = 1024;
+            const std::array<GAPI::GpuResourceFormat, 5> formats = {
+                GAPI::GpuResourceFormat::R8Unorm,
+                GAPI::GpuResourceFormat::RGBA8Unorm,
+                GAPI::GpuResourceFormat::RGBA16Float,
+                GAPI::GpuResourceFormat::RGBA32Float,
+                GAPI::GpuResourceFormat::BC1Unorm,
+            };
+
+            for (const auto format : formats)
+            {
+                const auto& description = GAPI::GpuResourceDescription::Texture2D(size, size, format, GAPI::GpuResourceBindFlags::ShaderResource, 1, 1);
+
+                const auto source = deviceContext.CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "Source");
+                const auto dest = deviceContext.CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "Dest");
+
+                const auto blockSize = GAPI::GpuResourceFormatInfo::GetBlockSize(format);
+                const auto blockWidth = GAPI::GpuResourceFormatInfo::GetCompressionBlockWidth(format);
+                const auto blockHeight = GAPI::GpuResourceFormatInfo::GetCompressionBlockHeight(format);
+                const uint64_t bytes = static_cast<uint64_t>(size / blockWidth) * (size / blockHeight) * blockSize;
+
+                const auto name = fmt::format("Copy 1024x1024 {}", GAPI::GpuResourceFormatInfo::ToString(format));
+                SetBytesProcessed(name, bytes);
+
+                BENCHMARK(name.c_str())
+                {
+                    const auto& commandList = deviceContext.AcquireCopyCommandList();
+                    commandList->CopyGpuResource(source, dest);
+                    commandList->Close();
+
+                    deviceContext.Submit(copyQueue, commandList).Wait();
+                };
+
+                deviceContext.MoveToNextFrame(copyQueue);
+            }
+
+            deviceContext.WaitForGpu(copyQueue);
+        }
+    }
+}
@@ -0,0 +1,364 @@
+#include <catch2/catch.hpp>
+
+#include "JsonReporter.hpp"
+
+#include "common/FastMath.hpp"
+#include "common/Math.hpp"
+#include "common/Simd.hpp"
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        namespace
+        {
+            // From fitting into L1 to streaming from memory.
+            constexpr std::array<size_t, 3> ObjectCounts = { 1024, 64 * 1024, 1024 * 1024 };
+
+            std::string countLabel(size_t count)
+            {
+                return count >= 1024 * 1024 ? fmt::format("{}M", count / (1024 * 1024)) : fmt::format("{}K", count / 1024);
+            }
+
+            // Column by column without SIMD, baseline for Matrix4::operator*.
+            Matrix4 multiplyScalar(const Matrix4& a, const Matrix4& b)
+            {
+                Matrix4 result;
+                const float* lhs = &a.e00;
+                const float* rhs = &b.e00;
+                float* dest = &result.e00;
+
+                for (uint32_t column = 0; column < 4; column++)
+                    for (uint32_t row = 0; row < 4; row++)
+                        dest[column * 4 + row] = lhs[row] * rhs[column * 4] + lhs[4 + row] * rhs[column * 4 + 1] +
+                                                 lhs[8 + row] * rhs[column * 4 + 2] + lhs[12 + row] * rhs[column * 4 + 3];
+
+                return result;
+            }
+
+            // Every matrix element in own array, as TransformBatch keeps components. Count is multiple of Simd width.
+            struct MatricesSoa
+            {
+                explicit MatricesSoa(size_t count)
+                {
+                    for (auto& element : elements)
+                        element.resize(count);
+                }
+
+                std::array<std::vector<float>, 16> elements;
+            };
+
+            MatricesSoa toSoa(const std::vector<Matrix4>& matrices)
+            {
+                MatricesSoa soa(matrices.size());
+
+                for (size_t index = 0; index < matrices.size(); index++)
+                    for (uint32_t element = 0; element < 16; element++)
+                        soa.elements[element][index] = (&matrices[index].e00)[element];
+
+                return soa;
+            }
+
+            // Four matrices per iteration, one per lane, same operation order as the scalar version.
+            void multiplySoa(const MatricesSoa& a, const MatricesSoa& b, MatricesSoa& result, size_t count)
+            {
+                for (size_t first = 0; first < count; first += 4)
+                {
+                    const auto load = [first](const MatricesSoa& matrices, uint32_t element) { return Simd::Load(matrices.elements[element].data() + first); };
+
+                    for (uint32_t column = 0; column < 4; column++)
+                    {
+                        const auto b0 = load(b, column * 4);
+                        const auto b1 = load(b, column * 4 + 1);
+                        const auto b2 = load(b, column * 4 + 2);
+                        const auto b3 = load(b, column * 4 + 3);
+
+                        for (uint32_t row = 0; row < 4; row++)
+                        {
+                            auto sum = Simd::Mul(load(a, row), b0);
+                            sum = Simd::Add(sum, Simd::Mul(load(a, 4 + row), b1));
+                            sum = Simd::Add(sum, Simd::Mul(load(a, 8 + row), b2));
+                            sum = Simd::Add(sum, Simd::Mul(load(a, 12 + row), b3));
+                            Simd::Store(result.elements[column * 4 + row].data() + first, sum);
+                        }
+                    }
+                }
+            }
+
+            std::vector<Matrix4> randomMatrices(size_t count)
+            {
+                std::vector<Matrix4> matrices(count);
+
+                for (auto& matrix : matrices)
+                    for (uint32_t index = 0; index < 16; index++)
+                        (&matrix.e00)[index] = FRandom() * 2.0f - 1.0f;
+
+                return matrices;
+            }
+
+            Quaternion randomRotation()
+            {
+                return Quaternion(FRandom() * 2.0f - 1.0f, FRandom() * 2.0f - 1.0f, FRandom() * 2.0f - 1.0f, FRandom() * 2.0f - 1.0f).Normal();
+            }
+
+            Vector3 randomVector()
+            {
+                return Vector3(FRandom() * 2.0f - 1.0f, FRandom() * 2.0f - 1.0f, FRandom() * 2.0f - 1.0f);
+            }
+
+            // Quaternion::Slerp for four pairs at once, angle from FastMath instead of acosf and sinf.
+            void slerpLanes(const float* const (&from)[4], const float* const (&to)[4], Simd::Float4 t, float* const (&result)[4], size_t first)
+            {
+                Simd::Float4 q0[4], q1[4];
+                for (uint32_t component = 0; component < 4; component++)
+                {
+                    q0[component] = Simd::Load(from[component] + first);
+                    q1[component] = Simd::Load(to[component] + first);
+                }
+
+                auto cosom = Simd::Mul(q0[0], q1[0]);
+                for (uint32_t component = 1; component < 4; component++)
+                    cosom = Simd::MulAdd(q0[component], q1[component], cosom);
+
+                // Shortest arc.
+                const auto sign = Simd::CopySign(Simd::Splat(1.0f), cosom);
+                cosom = Simd::Abs(cosom);
+
+                const auto one = Simd::Splat(1.0f);
+                const auto sinom = Simd::Sqrt(Simd::Max(Simd::Sub(one, Simd::Mul(cosom, cosom)), Simd::Splat(0.0f)));
+                const auto omega = FastMath::Atan2(sinom, cosom);
+
+                const auto isLinear = Simd::Less(Simd::Sub(one, cosom), Simd::Splat(EPS));
+                const auto invSinom = Simd::Div(one, Simd::Select(isLinear, one, sinom));
+                const auto scale0 = Simd::Select(isLinear, Simd::Sub(one, t), Simd::Mul(FastMath::Sin(Simd::Mul(Simd::Sub(one, t), omega)), invSinom));
+                const auto scale1 = Simd::Mul(Simd::Select(isLinear, t, Simd::Mul(FastMath::Sin(Simd::Mul(t, omega)), invSinom)), sign);
+
+                for (uint32_t component = 0; component < 4; component++)
+                    Simd::Store(result[component] + first, Simd::MulAdd(q0[component], scale0, Simd::Mul(q1[component], scale1)));
+            }
+        }
+
+        TEST_CASE("Matrix4 multiply", "[Common][Math][Matrix4]")
+        {
+            for (const auto count : ObjectCounts)
+            {
+                srand(42);
+                const auto a = randomMatrices(count);
+                const auto b = randomMatrices(count);
+                std::vector<Matrix4> result(count);
+
+                const auto aSoa = toSoa(a);
+                const auto bSoa = toSoa(b);
+                MatricesSoa resultSoa(count);
+
+                const auto label = countLabel(count);
+                const uint64_t bytes = static_cast<uint64_t>(count) * sizeof(Matrix4) * 3;
+                const auto scalarName = fmt::format("Scalar {}", label);
+                const auto simdName = fmt::format("SIMD {}", label);
+                const auto soaName = fmt::format("SoA {}", label);
+                SetBytesProcessed(scalarName, bytes);
+                SetBytesProcessed(simdName, bytes);
+                SetBytesProcessed(soaName, bytes);
+
+                BENCHMARK(scalarName.c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = multiplyScalar(a[index], b[index]);
+
+                    return result.back().e00;
+                };
+
+                BENCHMARK(simdName.c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = a[index] * b[index];
+
+                    return result.back().e00;
+                };
+
+                BENCHMARK(soaName.c_str())
+                {
+                    multiplySoa(aSoa, bSoa, resultSoa, count);
+                    return resultSoa.elements[0].back();
+                };
+            }
+        }
+
+        TEST_CASE("Transform matrices", "[Common][Math][TransformBatch]")
+        {
+            const Matrix4 viewProjection = Matrix4(Matrix4::PROJ_ZERO_POS, Radian(1.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+                                           Matrix4(Quaternion(Vector3(0.0f, 1.0f, 0.0f), Radian(0.5f)), Vector3(1.0f, 2.0f, 3.0f));
+
+            for (const auto count : ObjectCounts)
+            {
+                srand(42);
+                std::vector<Vector3> positions(count);
+                std::vector<Quaternion> rotations(count);
+                TransformBatch batch;
+                batch.Reserve(count);
+
+                for (size_t index = 0; index < count; index++)
+                {
+                    positions[index] = randomVector() * 100.0f;
+                    rotations[index] = randomRotation();
+                    batch.Add(positions[index], rotations[index]);
+                }
+
+                std::vector<Matrix4> result(count);
+                const auto label = countLabel(count);
+
+                // What Transform::GetMatrix does per object.
+                BENCHMARK(fmt::format("World AoS {}", label).c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = Matrix4(rotations[index], positions[index]);
+
+                    return result.back().e00;
+                };
+
+                // Spread over worker threads, as renderer calls it.
+                BENCHMARK(fmt::format("World SoA {}", label).c_str())
+                {
+                    batch.ComputeWorldMatrices(result.data());
+                    return result.back().e00;
+                };
+
+                BENCHMARK(fmt::format("WorldViewProjection AoS {}", label).c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = viewProjection * Matrix4(rotations[index], positions[index]);
+
+                    return result.back().e00;
+                };
+
+                BENCHMARK(fmt::format("WorldViewProjection SoA {}", label).c_str())
+                {
+                    batch.ComputeWorldViewProjectionMatrices(viewProjection, result.data());
+                    return result.back().e00;
+                };
+            }
+        }
+
+        TEST_CASE("Quaternion slerp", "[Common][Math][Quaternion]")
+        {
+            constexpr float t = 0.3f;
+
+            for (const auto count : ObjectCounts)
+            {
+                srand(42);
+                std::vector<Quaternion> from(count);
+                std::vector<Quaternion> to(count);
+                std::vector<Quaternion> result(count);
+
+                std::array<std::vector<float>, 4> fromSoa, toSoa, resultSoa;
+                for (uint32_t component = 0; component < 4; component++)
+                {
+                    fromSoa[component].resize(count);
+                    toSoa[component].resize(count);
+                    resultSoa[component].resize(count);
+                }
+
+                for (size_t index = 0; index < count; index++)
+                {
+                    from[index] = randomRotation();
+                    to[index] = randomRotation();
+
+                    for (uint32_t component = 0; component < 4; component++)
+                    {
+                        fromSoa[component][index] = (&from[index].x)[component];
+                        toSoa[component][index] = (&to[index].x)[component];
+                    }
+                }
+
+                const float* const fromComponents[4] = { fromSoa[0].data(), fromSoa[1].data(), fromSoa[2].data(), fromSoa[3].data() };
+                const float* const toComponents[4] = { toSoa[0].data(), toSoa[1].data(), toSoa[2].data(), toSoa[3].data() };
+                float* const resultComponents[4] = { resultSoa[0].data(), resultSoa[1].data(), resultSoa[2].data(), resultSoa[3].data() };
+                const auto label = countLabel(count);
+
+                BENCHMARK(fmt::format("Scalar {}", label).c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = from[index].Slerp(to[index], t);
+
+                    return result.back().w;
+                };
+
+                BENCHMARK(fmt::format("SoA {}", label).c_str())
+                {
+                    const auto lanesT = Simd::Splat(t);
+                    for (size_t first = 0; first < count; first += 4)
+                        slerpLanes(fromComponents, toComponents, lanesT, resultComponents, first);
+
+                    return resultSoa[3].back();
+                };
+            }
+        }
+
+        TEST_CASE("Vector3 normalize and dot", "[Common][Math][Vector]")
+        {
+            const Vector3 direction = Vector3(1.0f, 2.0f, 3.0f).Normal();
+
+            for (const auto count : ObjectCounts)
+            {
+                srand(42);
+                std::vector<Vector3> vectors(count);
+                std::array<std::vector<float>, 3> vectorsSoa;
+                for (auto& component : vectorsSoa)
+                    component.resize(count);
+
+                for (size_t index = 0; index < count; index++)
+                {
+                    vectors[index] = randomVector();
+                    vectorsSoa[0][index] = vectors[index].x;
+                    vectorsSoa[1][index] = vectors[index].y;
+                    vectorsSoa[2][index] = vectors[index].z;
+                }
+
+                std::vector<float> result(count);
+                const auto label = countLabel(count);
+
+                BENCHMARK(fmt::format("Scalar {}", label).c_str())
+                {
+                    for (size_t index = 0; index < count; index++)
+                        result[index] = vectors[index].Normal().Dot(direction);
+
+                    return result.back();
+                };
+
+                BENCHMARK(fmt::format("SoA {}", label).c_str())
+                {
+                    const auto dx = Simd::Splat(direction.x);
+                    const auto dy = Simd::Splat(direction.y);
+                    const auto dz = Simd::Splat(direction.z);
+
+                    for (size_t first = 0; first < count; first += 4)
+                    {
+                        const auto x = Simd::Load(vectorsSoa[0].data() + first);
+                        const auto y = Simd::Load(vectorsSoa[1].data() + first);
+                        const auto z = Simd::Load(vectorsSoa[2].data() + first);
+
+                        const auto lengthSqr = Simd::MulAdd(z, z, Simd::MulAdd(y, y, Simd::Mul(x, x)));
+                        const auto dot = Simd::MulAdd(z, dz, Simd::MulAdd(y, dy, Simd::Mul(x, dx)));
+                        Simd::Store(result.data() + first, Simd::Mul(dot, FastMath::Rsqrt(lengthSqr)));
+                    }
+
+                    return result.back();
+                };
+            }
+        }
+
+        TEST_CASE("Projection matrix", "[Common][Math][Matrix4]")
+        {
+            // Camera::calcProjectionMatrix builds one of these on every camera change.
+            BENCHMARK("Perspective")
+            {
+                return Matrix4(Matrix4::PROJ_ZERO_POS, Radian(1.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+            };
+
+            BENCHMARK("Orthographic")
+            {
+                return Matrix4(Matrix4::PROJ_ZERO_POS, -8.0f, 8.0f, -4.5f, 4.5f, 0.1f, 1000.0f);
+            };
+        }
+    }
+}
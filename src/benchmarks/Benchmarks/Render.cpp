@@ -0,0 +1,38 @@
+#include <catch2/catch.hpp>
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        TEST_CASE("Submission", "[Render][Submission]")
+        {
+            auto& deviceContext = GetDeviceContext();
+
+            BENCHMARK("ExecuteAwait round trip")
+            {
+                deviceContext.ExecuteAwait([](GAPI::Device&) {});
+            };
+
+            const auto& copyQueue = deviceContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "Benchmark");
+
+            // Includes GPU execution of empty list and fence signal.
+            BENCHMARK("Empty command list submit and wait")
+            {
+                const auto& commandList = deviceContext.AcquireCopyCommandList();
+                commandList->Close();
+
+                deviceContext.Submit(copyQueue, commandList).Wait();
+            };
+
+            deviceContext.MoveToNextFrame(copyQueue);
+            deviceContext.WaitForGpu(copyQueue);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include "JsonReporter.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        namespace
+        {
+            Threading::Mutex bytesProcessedMutex;
+            std::unordered_map<std::string, uint64_t> bytesProcessed;
+
+            std::string escape(const std::string& string)
+            {
+                std::string result;
+                result.reserve(string.size());
+
+                for (const auto character : string)
+                {
+                    if (character == '"' || character == '\\')
+                        result.push_back('\\');
+
+                    result.push_back(character);
+                }
+
+                return result;
+            }
+        }
+
+        void SetBytesProcessed(const std::string& benchmarkName, uint64_t bytes)
+        {
+            Threading::UniqueLock<Threading::Mutex> lock(bytesProcessedMutex);
+            bytesProcessed[benchmarkName] = bytes;
+        }
+
+        void JsonReporter::benchmarkEnded(const Catch::BenchmarkStats<>& stats)
+        {
+            Result result;
+            result.testCase = currentTestCaseInfo ? currentTestCaseInfo->name : "";
+            result.name = stats.info.name;
+            result.iterations = static_cast<uint64_t>(stats.info.iterations);
+            result.samples = stats.samples.size();
+            result.mean = stats.mean.point.count();
+            result.lowerBound = stats.mean.lower_bound.count();
+            result.upperBound = stats.mean.upper_bound.count();
+            result.standardDeviation = stats.standardDeviation.point.count();
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(bytesProcessedMutex);
+
+                const auto it = bytesProcessed.find(result.name);
+                result.bytesProcessed = it != bytesProcessed.end() ? it->second : 0;
+            }
+
+            results_.push_back(std::move(result));
+        }
+
+        void JsonReporter::testRunEnded(const Catch::TestRunStats& stats)
+        {
+            stream << "{\n  \"benchmarks\": [";
+
+            for (size_t index = 0; index < results_.size(); index++)
+            {
+                const auto& result = results_[index];
+
+                stream << (index ? ",\n" : "\n")
+                       << "    {\n"
+                       << "      \"test_case\": \"" << escape(result.testCase) << "\",\n"
+                       << "      \"name\": \"" << escape(result.name) << "\",\n"
+                       << "      \"iterations\": " << result.iterations << ",\n"
+                       << "      \"samples\": " << result.samples << ",\n"
+                       << "      \"mean_ns\": " << result.mean << ",\n"
+                       << "      \"lower_bound_ns\": " << result.lowerBound << ",\n"
+                       << "      \"upper_bound_ns\": " << result.upperBound << ",\n"
+                       << "      \"std_dev_ns\": " << result.standardDeviation;
+
+                if (result.bytesProcessed > 0)
+                    stream << ",\n      \"bytes_per_second\": " << static_cast<double>(result.bytesProcessed) * 1e9 / result.mean;
+
+                stream << "\n    }";
+            }
+
+            stream << "\n  ]\n}\n";
+
+            StreamingReporterBase::testRunEnded(stats);
+        }
+
+        CATCH_REGISTER_REPORTER("json", JsonReporter)
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <catch2/catch.hpp>
+
+namespace RR
+{
+    namespace Benchmarks
+    {
+        // Benchmarks with known amount of processed data report bandwidth as well. Call before BENCHMARK.
+        void SetBytesProcessed(const std::string& benchmarkName, uint64_t bytes);
+
+        // One object per benchmark with timings in nanoseconds, written once the run ends.
+        class JsonReporter final : public Catch::StreamingReporterBase<JsonReporter>
+        {
+        public:
+            using StreamingReporterBase::StreamingReporterBase;
+
+            static std::string getDescription() { return "Reports benchmark results as JSON"; }
+
+            void assertionStarting(const Catch::AssertionInfo&) override { }
+            bool assertionEnded(const Catch::AssertionStats&) override { return true; }
+
+            void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override;
+            void testRunEnded(const Catch::TestRunStats& stats) override;
+
+        private:
+            struct Result
+            {
+                std::string testCase;
+                std::string name;
+                uint64_t iterations;
+                size_t samples;
+                double mean;
+                double lowerBound;
+                double upperBound;
+                double standardDeviation;
+                uint64_t bytesProcessed;
+            };
+
+            std::vector<Result> results_;
+        };
+    }
+}
@@ -0,0 +1,33 @@
+#include "Benchmarks.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "common/threading/JobSystem.hpp"
+
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+namespace
+{
+    std::unique_ptr<RR::Render::DeviceContext> deviceContext;
+}
+
+RR::Render::DeviceContext& RR::Benchmarks::GetDeviceContext()
+{
+    ASSERT(deviceContext);
+    return *deviceContext;
+}
+
+// Benchmarks measure optimized builds, use "-r json -o results.json" for regression tracking.
+int main(int argc, char** argv)
+{
+    deviceContext = std::make_unique<RR::Render::DeviceContext>();
+    deviceContext->Init();
+
+    const auto result = Catch::Session().run(argc, argv);
+
+    deviceContext->Terminate();
+    deviceContext = nullptr;
+
+    return result;
+}
@@ -2,7 +2,12 @@
 
 #include "common/OnScopeExit.hpp"
 #include "common/Time.hpp"
+#include "common/debug/AllocationTracker.hpp"
 #include "common/debug/LeakDetector.hpp"
+#include "common/debug/MemoryStats.hpp"
+#include "common/debug/Profiler.hpp"
+#include "common/threading/JobSystem.hpp"
+#include "common/threading/TaskGraph.hpp"
 
 #include "gapi/CommandList.hpp"
 #include "gapi/CommandQueue.hpp"
@@ -10,20 +15,67 @@
 #include "gapi/GpuResourceViews.hpp"
 #include "gapi/MemoryAllocation.hpp"
 #include "gapi/SwapChain.hpp"
+#include "gapi/TexelKernels.hpp"
 #include "gapi/Texture.hpp"
 
 #include "render/DeviceContext.hpp"
+#include "render/FramePipeline.hpp"
 
 #include "windowing/Window.hpp"
 #include "windowing/WindowSystem.hpp"
 
+#include "filesystem/FileSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
 namespace RR
 {
     using namespace Common;
 
-    static uint32_t swindex = 0;
     static uint32_t frame = 0;
 
+    // Frames captured by CPU/GPU profiler, written to ProfileCapturePath once captured.
+    static constexpr uint32_t ProfileCaptureFirstFrame = 100;
+    static constexpr uint32_t ProfileCaptureFramesCount = 60;
+    static constexpr const char* ProfileCapturePath = "Profile.json";
+
+    // Frames simulation can run ahead of render thread.
+    static constexpr uint32_t FramePipelineDepth = 1;
+
+    // Frame clock is recalibrated against GPU clock periodically, they drift apart slowly.
+    static constexpr uint32_t ClockCalibrationIntervalFrames = 256;
+
+    // Headless benchmark target size and simulation step. Fixed step keeps camera path independent of frame rate.
+    static constexpr uint32_t BenchmarkWidth = 1920;
+    static constexpr uint32_t BenchmarkHeight = 1080;
+    static constexpr float BenchmarkTimeStep = 1.0f / 60.0f;
+
+    // Unfocused window keeps rendering at low rate, input still wakes it right away.
+    // Minimized one renders nothing, main thread sleeps on window events meanwhile.
+    static constexpr double BackgroundFrameInterval = 1.0 / 10.0;
+    static constexpr double MinimizedEventsTimeout = 0.25;
+
+    // Batch frames exported but not yet written, per job. Job skips node frames while it's reached.
+    static constexpr uint32_t BatchExportFramesInFlight = 4;
+
+    // Window key codes are GLFW ones, F1.
+    static constexpr int32_t HudToggleKey = 290;
+
+    // Scene state handed from simulation to render thread, immutable once submitted.
+    struct FrameSnapshot
+    {
+        uint32_t frameIndex = 0;
+        Vector3 cameraPosition;
+        Vector3 cameraTarget;
+    };
+
     namespace
     {
         template <typename T>
@@ -57,69 +109,28 @@ namespace RR
             return colors[std::min(level, 7u)];
         }
 
-        template <>
-        uint32_t checkerboardPattern(Vector3u texel, uint32_t level)
+        template <GAPI::GpuResourceFormat Format>
+        void fillTextureData(const GAPI::CpuResourceData::SharedPtr& textureData)
         {
-            const auto& value = checkerboardPattern<Vector4>(texel, level);
-            // TODO olor class
-            // RGBA format
-            return static_cast<uint32_t>(value.x * 255.0f) << 24 |
-                   static_cast<uint32_t>(value.y * 255.0f) << 16 |
-                   static_cast<uint32_t>(value.z * 255.0f) << 8 |
-                   static_cast<uint32_t>(value.w * 255.0f);
+            GAPI::TexelKernels::Fill<Format>(textureData, [](Vector3u texel, uint32_t subresourceIndex) {
+                return checkerboardPattern<Vector4>(texel, subresourceIndex);
+            });
         }
 
-        template <typename T>
-        void fillTextureData(const GAPI::GpuResourceDescription& description, const GAPI::CpuResourceData::SharedPtr& textureData)
+        // Format is resolved once per resource, kernels of every case are specialized at compile time.
+        void initTextureData(const GAPI::GpuResourceDescription& description, const GAPI::CpuResourceData::SharedPtr& textureData)
         {
-            ASSERT((std::is_same<T, uint32_t>::value && description.GetFormat() == GAPI::GpuResourceFormat::RGBA8Uint) ||
-                   (std::is_same<T, uint32_t>::value && description.GetFormat() == GAPI::GpuResourceFormat::BGRA8Unorm) ||
-                   (std::is_same<T, Vector4>::value && description.GetFormat() == GAPI::GpuResourceFormat::RGBA16Float) ||
-                   (std::is_same<T, Vector4>::value && description.GetFormat() == GAPI::GpuResourceFormat::RGBA32Float));
             ASSERT(textureData->GetFirstSubresource() == 0);
 
-            const auto& subresourceFootprints = textureData->GetSubresourceFootprints();
-            const auto dataPointer = static_cast<uint8_t*>(textureData->GetAllocation()->Map());
-
-            for (uint32_t index = 0; index < subresourceFootprints.size(); index++)
-            {
-                const auto& subresourceFootprint = subresourceFootprints[index];
-
-                for (uint32_t depth = 0; depth < subresourceFootprint.depth; depth++)
-                {
-                    const auto depthPointer = dataPointer + subresourceFootprint.offset +
-                                              depth * subresourceFootprint.depthPitch;
-                    for (uint32_t row = 0; row < subresourceFootprint.numRows; row++)
-                    {
-                        const auto rowPointer = depthPointer + row * subresourceFootprint.rowPitch;
-                        auto columnPointer = reinterpret_cast<T*>(rowPointer);
-
-                        for (uint32_t column = 0; column < subresourceFootprint.width; column++)
-                        {
-                            const auto texel = Vector3u(column, row, depth);
-
-                            *columnPointer = checkerboardPattern<T>(texel, index);
-                            columnPointer++;
-                        }
-                    }
-                }
-            }
-
-            textureData->GetAllocation()->Unmap();
-        }
-
-        void initTextureData(const GAPI::GpuResourceDescription& description, const GAPI::CpuResourceData::SharedPtr& textureData)
-        {
             switch (description.GetFormat())
             {
-                case GAPI::GpuResourceFormat::RGBA8Uint:
-                case GAPI::GpuResourceFormat::BGRA8Unorm:
-                    fillTextureData<uint32_t>(description, textureData);
-                    break;
-                case GAPI::GpuResourceFormat::RGBA16Float:
-                case GAPI::GpuResourceFormat::RGBA32Float:
-                    fillTextureData<Vector4>(description, textureData);
-                    break;
+                case GAPI::GpuResourceFormat::RGBA8Uint: fillTextureData<GAPI::GpuResourceFormat::RGBA8Uint>(textureData); break;
+                case GAPI::GpuResourceFormat::RGBA8Unorm: fillTextureData<GAPI::GpuResourceFormat::RGBA8Unorm>(textureData); break;
+                case GAPI::GpuResourceFormat::BGRA8Unorm: fillTextureData<GAPI::GpuResourceFormat::BGRA8Unorm>(textureData); break;
+                case GAPI::GpuResourceFormat::RGBA16Float: fillTextureData<GAPI::GpuResourceFormat::RGBA16Float>(textureData); break;
+                case GAPI::GpuResourceFormat::RGBA32Float: fillTextureData<GAPI::GpuResourceFormat::RGBA32Float>(textureData); break;
+                case GAPI::GpuResourceFormat::BC1Unorm: fillTextureData<GAPI::GpuResourceFormat::BC1Unorm>(textureData); break;
+                case GAPI::GpuResourceFormat::BC7Unorm: fillTextureData<GAPI::GpuResourceFormat::BC7Unorm>(textureData); break;
                 default:
                     LOG_FATAL("Unsupported format");
             }
@@ -179,24 +190,127 @@ namespace RR
             return true;
         }
 
+        // Orbit around the scene origin with bobbing height, fully defined by time.
+        void getScriptedCamera(float time, Vector3& position, Vector3& target)
+        {
+            constexpr float Radius = 10.0f;
+            constexpr float OrbitPeriod = 20.0f;
+            constexpr float Pi = 3.14159265358979f;
+
+            const float angle = 2.0f * Pi * time / OrbitPeriod;
+            position = Vector3(Radius * std::cos(angle), 3.0f + std::sin(angle * 3.0f), Radius * std::sin(angle));
+            target = Vector3(0.0f, 0.0f, 0.0f);
+        }
+
+        // Measured on render thread, one entry per frame.
+        struct BenchmarkSamples
+        {
+            // Interval between consecutive frame ends.
+            std::vector<double> cpuFrameMs;
+            // Span of top level GPU markers, frames without markers aren't sampled.
+            std::vector<double> gpuFrameMs;
+            std::vector<double> allocations;
+            uint64_t lastFrameEndNs = 0;
+            uint64_t lastGpuFrameIndex = 0;
+        };
+
+        U8String formatPercentiles(std::vector<double> samples)
+        {
+            if (samples.empty())
+                return "null";
+
+            std::sort(samples.begin(), samples.end());
+
+            // Nearest rank.
+            const auto percentile = [&samples](double rank) {
+                const auto index = static_cast<size_t>(std::ceil(rank / 100.0 * samples.size()));
+                return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+            };
+
+            double sum = 0.0;
+            for (const auto sample : samples)
+                sum += sample;
+
+            return fmt::format("{{\"count\":{},\"mean\":{:.4f},\"p50\":{:.4f},\"p90\":{:.4f},\"p95\":{:.4f},\"p99\":{:.4f},\"max\":{:.4f}}}",
+                               samples.size(), sum / samples.size(), percentile(50), percentile(90), percentile(95), percentile(99), samples.back());
+        }
+
+        bool writeBenchmarkReport(const U8String& path, const BenchmarkSamples& samples, const GAPI::MemoryBudget& memoryBudget)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                Log::Format::Error("Failed to open benchmark report file {}\n", path);
+                return false;
+            }
+
+            file << "{\n";
+            file << fmt::format("\"width\":{},\"height\":{},\n", BenchmarkWidth, BenchmarkHeight);
+            file << "\"cpuFrameMs\":" << formatPercentiles(samples.cpuFrameMs) << ",\n";
+            file << "\"gpuFrameMs\":" << formatPercentiles(samples.gpuFrameMs) << ",\n";
+            // Null unless built with allocation tracking.
+            file << "\"allocationsPerFrame\":" << (Debug::AllocationTracker::IsEnabled ? formatPercentiles(samples.allocations) : "null") << ",\n";
+            file << fmt::format("\"videoMemoryUsageBytes\":{},\n", memoryBudget.local.usageBytes);
+            file << "\"memory\":{";
+
+            bool first = true;
+            const auto& statistics = Debug::MemoryStats::Instance().GetStatistics();
+            for (size_t tag = 0; tag < statistics.size(); tag++)
+                for (size_t kind = 0; kind < statistics[tag].size(); kind++)
+                {
+                    const auto& counters = statistics[tag][kind];
+                    if (counters.peakBytes == 0)
+                        continue;
+
+                    file << (first ? "\n" : ",\n");
+                    file << fmt::format("\"{}.{}\":{{\"bytes\":{},\"peakBytes\":{},\"allocations\":{}}}",
+                                        Debug::AllocationTracker::GetTagName(static_cast<Debug::AllocationTag>(tag)),
+                                        Debug::MemoryStats::GetKindName(static_cast<Debug::MemoryKind>(kind)),
+                                        counters.bytes, counters.peakBytes, counters.allocations);
+                    first = false;
+                }
+
+            file << "\n}\n}\n";
+
+            return static_cast<bool>(file);
+        }
     }
-    void Application::OnWindowResize(uint32_t width, uint32_t height)
+
+    void Application::onWindowResize(uint32_t width, uint32_t height)
+    {
+        // Events are coalesced, render thread applies the latest size with the next Present.
+        if (swapChain_)
+            deviceContext_->ResizeSwapChain(swapChain_, width, height);
+    }
+
+    void Application::onKey(int32_t key, bool pressed)
     {
-        GAPI::SwapChainDescription desc = swapChain_->GetDescription();
-        desc.width = width;
-        desc.height = height;
+        if (key != HudToggleKey)
+            return;
 
-        auto& renderContext = Render::DeviceContext::Instance();
-        renderContext.ResetSwapChain(swapChain_, desc);
+        // Held key repeats presses.
+        if (pressed && !hudKeyDown_)
+            performanceHud_.ToggleVisible();
 
-        swindex = 0;
+        hudKeyDown_ = pressed;
     }
 
     void Application::Start()
     {
         Debug::LeakDetector::Instance();
+        Debug::Profiler::SetThreadName("Main");
+#ifdef DEBUG
+        Debug::MemoryStats::Instance().SetDumpInterval(600);
+#endif
         init();
 
+        if (batch_)
+        {
+            runBatch();
+            terminate();
+            return;
+        }
+
         /*    const auto cmdList = new GAPI::CommandList("asd");
         std::ignore = cmdList;
 
@@ -215,12 +329,14 @@ namespace RR
 
         time->Init();
 
-        auto& renderContext = Render::DeviceContext::Instance();
+        auto& renderContext = *deviceContext_;
 
         auto commandQueue = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Graphics, u8"Primary");
         auto commandList = renderContext.CreateGraphicsCommandList(u8"qwew");
 
-        const auto desc = GAPI::GpuResourceDescription::Texture2D(100, 100, GAPI::GpuResourceFormat::BGRA8Unorm, GAPI::GpuResourceBindFlags::RenderTarget, 1, 1);
+        auto desc = GAPI::GpuResourceDescription::Texture2D(100, 100, GAPI::GpuResourceFormat::BGRA8Unorm, GAPI::GpuResourceBindFlags::RenderTarget, 1, 1);
+        // Matches clear color of the frame loop, so the clear takes fast path.
+        desc.SetOptimizedClearValue({ { 0.0f, 0.0f, 1.0f, 1.0f } });
         auto texture = renderContext.CreateTexture(desc);
         //  ASSERT(commandList)
         // commandList->Close();
@@ -241,103 +357,285 @@ namespace RR
         desciption.isStereo = false;
         desciption.gpuResourceFormat = GAPI::GpuResourceFormat::BGRA8Unorm;
         desciption.window = _window;
+        desciption.maxFrameLatency = 1;
+        desciption.allowTearing = true;
 
-        swapChain_ = renderContext.CreateSwapchain(desciption, "Primary");
+        if (benchmark_)
+        {
+            const auto& targetDescription = GAPI::GpuResourceDescription::Texture2D(BenchmarkWidth, BenchmarkHeight, GAPI::GpuResourceFormat::BGRA8Unorm, GAPI::GpuResourceBindFlags::RenderTarget, 1, 1);
+            offscreenTarget_ = renderContext.CreateTexture(targetDescription, GAPI::GpuResourceCpuAccess::None, "BenchmarkTarget");
+
+            if (!benchmark_->exportPath.empty())
+            {
+                Render::FrameExporter::Description exportDescription;
+                exportDescription.directory = benchmark_->exportPath;
+                frameExporter_.Init(renderContext, exportDescription);
+            }
+        }
+        else
+        {
+            swapChain_ = renderContext.CreateSwapchain(desciption, "Primary");
+
+            Render::PerformanceHud::Description hudDescription;
+            hudDescription.renderTargetFormat = desciption.gpuResourceFormat;
+            performanceHud_.Init(renderContext, hudDescription);
+        }
+
+        if (metricsDescription_)
+            metricsExporter_.Init(renderContext, *metricsDescription_);
+
+        if (remoteProfilerDescription_)
+            remoteProfiler_.Init(*remoteProfilerDescription_);
 
         auto fence = renderContext.CreateFence("qwe");
 
         const auto& windowSystem = Windowing::WindowSystem::Instance();
 
-        while (!_quit)
+        BenchmarkSamples benchmarkSamples;
+        if (benchmark_)
         {
-            windowSystem.PoolEvents();
-            //Windowing::WindowSystem::PoolEvents();
+            benchmarkSamples.cpuFrameMs.reserve(benchmark_->framesCount);
+            benchmarkSamples.gpuFrameMs.reserve(benchmark_->framesCount);
+            benchmarkSamples.allocations.reserve(benchmark_->framesCount);
+        }
 
-            // renderContext.Submit(commandQueue, commandList);
+        Render::FramePipeline<FrameSnapshot> framePipeline;
+        framePipeline.Init(
+            [&](const FrameSnapshot& snapshot, uint64_t frameIndex) {
+                // Measured frames are captured for the replay tool.
+                if (benchmark_ && !benchmark_->capturePath.empty() && frameIndex == benchmark_->warmupFramesCount)
+                    renderContext.BeginCommandCapture(benchmark_->capturePath, benchmark_->framesCount);
 
-            //  renderPipeline->Collect(_scene);
-            //    renderPipeline->Draw();
+                // Headless frames are paced by MoveToNextFrame only.
+                if (swapChain_)
+                {
+                    PROFILE_SCOPE("Application::WaitForNextFrame");
+                    renderContext.WaitForNextFrame(swapChain_);
+                }
 
-            //   _scene->Update();
-            //device->Present();
-            //    render->SwapBuffers();
-            //  input->Update();
+                // Resize requested by the window is applied by Present, index is reset then.
+                const auto backBufferIndex = swapChain_ ? swapChain_->GetCurrentBackBufferIndex() : 0;
 
-            // renderContext.Present();
+                std::shared_ptr<GAPI::CpuResourceData> readbackData1;
 
-            // auto index2 = index;
+                renderContext.ExecuteAsync(
+                    [&renderContext, swapChain = swapChain_, offscreenTarget = offscreenTarget_, index2 = backBufferIndex, commandList, texture, testTexture, cpuData, readbackData, &readbackData1](GAPI::Device& device) {
+                        std::ignore = device;
 
-            std::shared_ptr<GAPI::CpuResourceData> readbackData1;
+                        auto swapChainTexture = swapChain ? swapChain->GetTexture(index2) : offscreenTarget;
+                        //Log::Print::Info("Texture %s\n", texture->GetName());
+                        {
+                            const auto& sourceDescription = GAPI::GpuResourceDescription::Texture3D(256, 256, 256, GAPI::GpuResourceFormat::RGBA8Uint);
+                            const auto sourceData = renderContext.AllocateIntermediateResourceData(sourceDescription, GAPI::MemoryAllocationType::CpuReadWrite);
+                            auto source = renderContext.CreateTexture(sourceDescription, GAPI::GpuResourceCpuAccess::None, "Source");
 
-            renderContext.ExecuteAsync(
-                [swapChain = swapChain_, index2 = swindex, commandList, texture, testTexture, cpuData, readbackData, &readbackData1](GAPI::Device& device) {
-                    std::ignore = device;
+                            initTextureData(sourceDescription, sourceData);
+                            commandList->UpdateGpuResource(source, sourceData);
 
-                    auto swapChainTexture = swapChain->GetTexture(index2);
-                    //Log::Print::Info("Texture %s\n", texture->GetName());
-                    {
-                        auto& renderContext = Render::DeviceContext::Instance();
+                            const auto& destDescription = GAPI::GpuResourceDescription::Texture3D(128, 128, 128, GAPI::GpuResourceFormat::RGBA8Uint);
+                            const auto destData = renderContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Upload);
+                            auto dest = renderContext.CreateTexture(destDescription, GAPI::GpuResourceCpuAccess::None, "Dest");
+
+                            initTextureData(destDescription, destData);
+                            commandList->UpdateGpuResource(dest, destData);
+
+                            commandList->CopyTextureSubresourceRegion(source, 1, Box3u(7, 42, 13, 64, 64, 64), dest, 0, Vector3u(32, 32, 32));
+                            commandList->CopyTextureSubresourceRegion(source, 2, Box3u(0, 0, 0, 32, 32, 32), dest, 1, Vector3u(16, 16, 16));
+                            commandList->CopyTextureSubresourceRegion(source, 0, Box3u(45, 128, 205, 16, 16, 16), dest, 2, Vector3u(0, 0, 0));
+
+                            readbackData1 = renderContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Readback);
+                            commandList->ReadbackGpuResource(dest, readbackData1);
+
+                            commandList->Close();
+                        }
+                        /*
+                        auto swapChainRtv = swapChainTexture->GetRTV();
+                        auto blueRtv = texture->GetRTV();
+
+                        commandList->ClearRenderTargetView(blueRtv, Vector4(0, 0, 1, 1));
+                        commandList->ClearRenderTargetView(swapChainRtv, Vector4(static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX), 0, 0, 0));
+                        // commandList->CopyTextureSubresourceRegion(texture, 0, Box3u(0, 0, 0, 50, 50, 1), swapChainTexture, 0, Vector3::ZERO);
+
+                        commandList->UpdateGpuResource(testTexture, cpuData);
+                        commandList->ReadbackGpuResource(testTexture, readbackData);
+                        //commandList->Close();
+
+                        // commandList->UpdateGpuResource(testTexture, cpuData);
+                        //commandList->CopyTextureSubresourceRegion(testTexture, 0, Box3u(0, 0, 0, 50, 50, 1), swapChainTexture, 0, Vector3::ZERO);
+                        //commandList->ReadbackGpuResource(testTexture, readbackData);
+
+                        commandList->Close();*/
+                    });
+
+                {
+                    PROFILE_SCOPE("Application::Submit");
+                    renderContext.Submit(commandQueue, commandList);
+                }
 
-                        const auto& sourceDescription = GAPI::GpuResourceDescription::Texture3D(256, 256, 256, GAPI::GpuResourceFormat::RGBA8Uint);
-                        const auto sourceData = renderContext.AllocateIntermediateResourceData(sourceDescription, GAPI::MemoryAllocationType::CpuReadWrite);
-                        auto source = renderContext.CreateTexture(sourceDescription, GAPI::GpuResourceCpuAccess::None, "Source");
+                {
+                    PROFILE_SCOPE("Application::WaitForGpu");
+                    renderContext.WaitForGpu(commandQueue);
+                }
 
-                        initTextureData(sourceDescription, sourceData);
-                        commandList->UpdateGpuResource(source, sourceData);
+                const auto pointer = readbackData1->GetAllocation()->Map();
 
-                        const auto& destDescription = GAPI::GpuResourceDescription::Texture3D(128, 128, 128, GAPI::GpuResourceFormat::RGBA8Uint);
-                        const auto destData = renderContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Upload);
-                        auto dest = renderContext.CreateTexture(destDescription, GAPI::GpuResourceCpuAccess::None, "Dest");
+                (void)pointer;
+                ON_SCOPE_EXIT(
+                    {
+                        readbackData1->GetAllocation()->Unmap();
+                    })
 
-                        initTextureData(destDescription, destData);
-                        commandList->UpdateGpuResource(dest, destData);
+                if (swapChain_)
+                {
+                    PROFILE_SCOPE("Application::PerformanceHud");
 
-                        commandList->CopyTextureSubresourceRegion(source, 1, Box3u(7, 42, 13, 64, 64, 64), dest, 0, Vector3u(32, 32, 32));
-                        commandList->CopyTextureSubresourceRegion(source, 2, Box3u(0, 0, 0, 32, 32, 32), dest, 1, Vector3u(16, 16, 16));
-                        commandList->CopyTextureSubresourceRegion(source, 0, Box3u(45, 128, 205, 16, 16, 16), dest, 2, Vector3u(0, 0, 0));
+                    performanceHud_.Update();
+                    if (performanceHud_.IsVisible())
+                    {
+                        const auto& backBuffer = swapChain_->GetTexture(backBufferIndex);
+                        const auto& backBufferDescription = backBuffer->GetDescription();
+                        const auto& backBufferRtv = renderContext.CreateRenderTargetView(backBuffer, GAPI::GpuResourceViewDescription::Texture(backBufferDescription.GetFormat(), 0, 1, 0, 1));
 
-                        readbackData1 = renderContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Readback);
-                        commandList->ReadbackGpuResource(dest, readbackData1);
+                        const auto& hudCommandList = renderContext.AcquireGraphicsCommandList();
+                        hudCommandList->SetRenderTargets({ backBufferRtv });
+                        performanceHud_.Draw(*hudCommandList, backBufferDescription.GetWidth(), backBufferDescription.GetHeight());
+                        hudCommandList->Close();
 
-                        commandList->Close();
+                        renderContext.Submit(commandQueue, hudCommandList);
                     }
-                    /*
-                    auto swapChainRtv = swapChainTexture->GetRTV();
-                    auto blueRtv = texture->GetRTV();
+                }
 
-                    commandList->ClearRenderTargetView(blueRtv, Vector4(0, 0, 1, 1));
-                    commandList->ClearRenderTargetView(swapChainRtv, Vector4(static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX), 0, 0, 0));
-                    // commandList->CopyTextureSubresourceRegion(texture, 0, Box3u(0, 0, 0, 50, 50, 1), swapChainTexture, 0, Vector3::ZERO);
+                // Measured frames only, numbered from zero.
+                if (benchmark_ && !benchmark_->exportPath.empty() &&
+                    frameIndex >= benchmark_->warmupFramesCount && frameIndex < benchmark_->warmupFramesCount + benchmark_->framesCount)
+                {
+                    PROFILE_SCOPE("Application::ExportFrame");
+                    frameExporter_.Capture(commandQueue, offscreenTarget_, frameIndex - benchmark_->warmupFramesCount);
+                }
 
-                    commandList->UpdateGpuResource(testTexture, cpuData);
-                    commandList->ReadbackGpuResource(testTexture, readbackData);
-                    //commandList->Close();
+                if (swapChain_)
+                {
+                    PROFILE_SCOPE("Application::Present");
+                    renderContext.Present(swapChain_);
+                }
 
-                    // commandList->UpdateGpuResource(testTexture, cpuData);
-                    //commandList->CopyTextureSubresourceRegion(testTexture, 0, Box3u(0, 0, 0, 50, 50, 1), swapChainTexture, 0, Vector3::ZERO);
-                    //commandList->ReadbackGpuResource(testTexture, readbackData);
+                renderContext.MoveToNextFrame(commandQueue);
 
-                    commandList->Close();*/
-                });
+                if (metricsDescription_)
+                    metricsExporter_.RecordFrame();
 
-            renderContext.Submit(commandQueue, commandList);
-            renderContext.WaitForGpu(commandQueue);
+                if (remoteProfilerDescription_)
+                    remoteProfiler_.OnFrame(frameIndex);
 
-            const auto pointer = readbackData1->GetAllocation()->Map();
+                if (benchmark_)
+                {
+                    const auto frameEndNs = Debug::Profiler::Now();
+                    const bool measured = frameIndex >= benchmark_->warmupFramesCount && frameIndex < benchmark_->warmupFramesCount + benchmark_->framesCount;
 
-            (void)pointer;
-            ON_SCOPE_EXIT(
+                    if (measured && benchmarkSamples.lastFrameEndNs != 0)
+                    {
+                        benchmarkSamples.cpuFrameMs.push_back((frameEndNs - benchmarkSamples.lastFrameEndNs) / 1e6);
+                        benchmarkSamples.allocations.push_back(static_cast<double>(Debug::AllocationTracker::Instance().GetLastFrame().total.count));
+
+                        // Latest frame completed on GPU, sampled once per frame index.
+                        const auto& gpuTimings = renderContext.GetGpuFrameTimings();
+                        if (gpuTimings.frameIndex > benchmarkSamples.lastGpuFrameIndex && !gpuTimings.markers.empty())
+                        {
+                            double gpuFrameMs = 0.0;
+                            for (const auto& marker : gpuTimings.markers)
+                                if (marker.parent == GAPI::GpuTimingMarker::InvalidParent)
+                                    gpuFrameMs = std::max(gpuFrameMs, marker.startMs + marker.durationMs);
+
+                            benchmarkSamples.gpuFrameMs.push_back(gpuFrameMs);
+                            benchmarkSamples.lastGpuFrameIndex = gpuTimings.frameIndex;
+                        }
+                    }
+
+                    benchmarkSamples.lastFrameEndNs = frameEndNs;
+                }
+            },
+            FramePipelineDepth);
+
+        float elapsedTime = 0.0f;
+        auto lastFrameStart = std::chrono::steady_clock::now();
+        while (!_quit)
+        {
+            auto& profiler = Debug::Profiler::Instance();
+            if (frame == ProfileCaptureFirstFrame)
+                profiler.BeginCapture();
+
+            PROFILE_SCOPE("Frame");
+
+            if (_window)
+            {
+                PROFILE_SCOPE("Application::PoolEvents");
+                windowSystem.PoolEvents();
+
+                while (windowMinimized_ && !_quit)
+                    windowSystem.WaitEvents(MinimizedEventsTimeout);
+
+                if (!windowFocused_)
                 {
-                    readbackData1->GetAllocation()->Unmap();
-                })
+                    const auto deadline = lastFrameStart + std::chrono::duration<double>(BackgroundFrameInterval);
+                    for (auto now = std::chrono::steady_clock::now(); now < deadline && !windowFocused_ && !_quit; now = std::chrono::steady_clock::now())
+                        windowSystem.WaitEvents(std::chrono::duration<double>(deadline - now).count());
+                }
+            }
+            lastFrameStart = std::chrono::steady_clock::now();
 
-            renderContext.Present(swapChain_);
-            renderContext.MoveToNextFrame(commandQueue);
+            // Waits for render thread to release the oldest snapshot.
+            auto& snapshot = framePipeline.BeginFrame();
+            snapshot.frameIndex = frame;
+
+            // Benchmark camera depends on frame index only, so every run renders the same frames.
+            const float cameraTime = benchmark_ ? frame * BenchmarkTimeStep : elapsedTime;
+            getScriptedCamera(cameraTime, snapshot.cameraPosition, snapshot.cameraTarget);
+
+            framePipeline.EndFrame();
 
-            swindex = (++swindex % swapChain_->GetDescription().bufferCount);
             frame++;
 
             time->Update();
+            elapsedTime += time->GetDeltaTime();
+
+            if (!time->IsCalibrated() || time->GetFrameIndex() % ClockCalibrationIntervalFrames == 0)
+            {
+                const auto& calibration = renderContext.GetGpuClockCalibration();
+                time->Calibrate(calibration.gpuTimestamp, calibration.gpuFrequency, calibration.cpuNs);
+            }
+
+            // Terminate drops pending snapshots, so the last measured frames are pushed through the pipeline. renders frames already submitted before terminating.
+            if (benchmark_ && frame >= benchmark_->warmupFramesCount + benchmark_->framesCount + FramePipelineDepth)
+                _quit = true;
+
+            if (frame == ProfileCaptureFirstFrame + ProfileCaptureFramesCount)
+            {
+                // Frames left in pipeline are rendered after export.
+                profiler.EndCapture();
+                profiler.ExportChromeTrace(ProfileCapturePath);
+            }
+        }
+
+        framePipeline.Terminate();
+
+        if (metricsDescription_)
+            metricsExporter_.Terminate();
+
+        if (remoteProfilerDescription_)
+            remoteProfiler_.Terminate();
+
+        if (swapChain_)
+            performanceHud_.Terminate();
+
+        if (benchmark_)
+        {
+            if (writeBenchmarkReport(benchmark_->outputPath, benchmarkSamples, renderContext.GetMemoryBudget()))
+                Log::Format::Info("Benchmark report written to {}\n", benchmark_->outputPath);
+
+            if (!benchmark_->exportPath.empty())
+                frameExporter_.Terminate();
+
+            offscreenTarget_ = nullptr;
         }
 
         commandQueue = nullptr;
@@ -352,7 +650,7 @@ namespace RR
         terminate();
     }
 
-    void Application::OnClose()
+    void Application::onClose()
     {
         _quit = true;
     }
@@ -364,17 +662,43 @@ namespace RR
         windowDesc.Height = 600;
         windowDesc.Title = "Demo";
 
-        auto& windowSystem = Windowing::WindowSystem::Instance();
-        windowSystem.Init();
+        Logger::InitAsync();
+        Threading::JobSystem::Instance().Init();
+
+        // Device doesn't need the window until swapchain creation, so adapter enumeration
+        // and cache loading overlap window creation.
+        Threading::TaskGraph startup("Startup");
+
+        // Window messages are pumped by the main thread. Headless benchmark and batch runs have no window at all.
+        if (!benchmark_ && !batch_)
+            startup.Add("Window", [this, &windowDesc] {
+            auto& windowSystem = Windowing::WindowSystem::Instance();
+            windowSystem.Init();
+
+            _window = windowSystem.Create(windowDesc);
+            ASSERT(_window);
+
+            closeHandle_ = _window->OnClose.Subscribe(Delegate<void()>::From<&Application::onClose>(this));
+            resizeHandle_ = _window->OnResize.Subscribe(Delegate<void(uint32_t, uint32_t)>::From<&Application::onWindowResize>(this));
+            keyHandle_ = _window->OnKey.Subscribe(Delegate<void(int32_t, bool)>::From<&Application::onKey>(this));
+            shownHandle_ = _window->OnShown.Subscribe(Delegate<void()>::From<&Application::onWindowShown>(this));
+            hiddenHandle_ = _window->OnHidden.Subscribe(Delegate<void()>::From<&Application::onWindowHidden>(this));
+            focusGainedHandle_ = _window->OnFocusGained.Subscribe(Delegate<void()>::From<&Application::onFocusGained>(this));
+            focusLostHandle_ = _window->OnFocusLost.Subscribe(Delegate<void()>::From<&Application::onFocusLost>(this));
 
-        _window = windowSystem.Create(this, windowDesc);
-        ASSERT(_window);
+            windowFocused_ = _window->IsFocused();
+            windowMinimized_ = _window->IsMinimized();
 
-        // Inputting::Instance()->Init();
-        // Inputting::Instance()->SubscribeToWindow(_window);
+            // Inputting::Instance()->Init();
+            // Inputting::Instance()->SubscribeToWindow(_window);
+        }, {}, Threading::TaskGraph::Affinity::CallingThread);
 
-        auto& renderContext = Render::DeviceContext::Instance();
-        renderContext.Init();
+        startup.Add("Device", [this] {
+            deviceContext_ = std::make_unique<Render::DeviceContext>();
+            deviceContext_->Init(Render::DeviceContext::DefaultGpuFramesBuffered, "PipelineCache.bin");
+        });
+
+        startup.Run();
 
         // auto& render = Rendering::Instance();
         // render->Init(_window);
@@ -384,21 +708,223 @@ namespace RR
     {
         swapChain_ = nullptr;
 
-        Render::DeviceContext::Instance().Terminate();
+        deviceContext_->Terminate();
+        deviceContext_ = nullptr;
 
         //_scene->Terminate();
 
-        _window.reset();
-        _window = nullptr;
+        if (_window)
+        {
+            _window->OnClose.Unsubscribe(closeHandle_);
+            _window->OnResize.Unsubscribe(resizeHandle_);
+            _window->OnKey.Unsubscribe(keyHandle_);
+            _window->OnShown.Unsubscribe(shownHandle_);
+            _window->OnHidden.Unsubscribe(hiddenHandle_);
+            _window->OnFocusGained.Unsubscribe(focusGainedHandle_);
+            _window->OnFocusLost.Unsubscribe(focusLostHandle_);
+            _window.reset();
+            _window = nullptr;
+        }
 
         // Inputting::Instance()->Terminate();
 
         // Rendering::Instance()->Terminate();
         // Windowing::WindowSystem::UnSubscribe(this);
+
+        Threading::JobSystem::Instance().Terminate();
+        Logger::TerminateAsync();
+    }
+
+    bool Application::LoadBatchJobs(const U8String& path, BatchDescription& description)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            Log::Format::Error("Failed to open batch jobs file {}\n", path);
+            return false;
+        }
+
+        U8String line;
+        for (uint32_t lineNumber = 1; std::getline(file, line); lineNumber++)
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            BatchJob job;
+            std::istringstream stream(line);
+            if (!(stream >> job.name >> job.scenePath >> job.outputDirectory >> job.width >> job.height >> job.framesCount) ||
+                job.width == 0 || job.height == 0)
+            {
+                Log::Format::Error("Malformed batch job at {}:{}\n", path, lineNumber);
+                return false;
+            }
+
+            // Optional camera path timing.
+            if (stream >> job.startTime)
+                stream >> job.timeStep;
+
+            if (job.scenePath == "-")
+                job.scenePath.clear();
+
+            description.jobs.push_back(std::move(job));
+        }
+
+        return true;
+    }
+
+    void Application::runBatch()
+    {
+        ASSERT(batch_);
+        ASSERT(batch_->maxConcurrentJobs > 0);
+
+        auto& renderContext = *deviceContext_;
+        const auto commandQueue = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Graphics, u8"Batch");
+
+        struct ActiveJob
+        {
+            const BatchJob* job;
+            uint32_t frame = 0;
+            std::shared_ptr<GAPI::Texture> target;
+            std::shared_ptr<GAPI::RenderTargetView> targetRtv;
+            std::unique_ptr<Render::FrameExporter> exporter;
+        };
+
+        // Kept across jobs: targets are pooled by size, scenes stay mapped.
+        std::unordered_map<uint64_t, std::vector<std::shared_ptr<GAPI::Texture>>> freeTargets;
+        std::unordered_map<U8String, std::shared_ptr<Common::Stream>> scenes;
+
+        const auto isSmall = [this](const BatchJob& job) { return uint64_t(job.width) * job.height <= batch_->smallJobPixels; };
+        const auto getTargetKey = [](const BatchJob& job) { return uint64_t(job.width) << 32 | job.height; };
+
+        std::deque<const BatchJob*> pending;
+        for (const auto& job : batch_->jobs)
+            pending.push_back(&job);
+
+        std::vector<ActiveJob> active;
+        // Finished rendering, last frames are still written by workers.
+        std::vector<ActiveJob> draining;
+
+        uint32_t failedJobsCount = 0;
+        const auto batchStart = std::chrono::steady_clock::now();
+
+        while (!pending.empty() || !active.empty() || !draining.empty())
+        {
+            // Large job runs alone, small ones share GPU up to the limit.
+            while (!pending.empty() && active.size() < batch_->maxConcurrentJobs)
+            {
+                const auto& job = *pending.front();
+                const bool canShare = isSmall(job) && std::all_of(active.begin(), active.end(), [&isSmall](const ActiveJob& other) { return isSmall(*other.job); });
+                if (!active.empty() && !canShare)
+                    break;
+
+                pending.pop_front();
+
+                if (!job.scenePath.empty() && scenes.find(job.scenePath) == scenes.end())
+                {
+                    auto scene = FileSystem::Instance()->Open(job.scenePath, FileSystem::Mode::MAP_READ);
+                    if (!scene)
+                    {
+                        Log::Format::Error("Batch job {} skipped, failed to open scene {}\n", job.name, job.scenePath);
+                        failedJobsCount++;
+                        continue;
+                    }
+
+                    scenes.emplace(job.scenePath, std::move(scene));
+                }
+
+                ActiveJob activeJob;
+                activeJob.job = &job;
+
+                auto& targets = freeTargets[getTargetKey(job)];
+                if (targets.empty())
+                {
+                    const auto& targetDescription = GAPI::GpuResourceDescription::Texture2D(job.width, job.height, GAPI::GpuResourceFormat::BGRA8Unorm, GAPI::GpuResourceBindFlags::RenderTarget, 1, 1);
+                    targets.push_back(renderContext.CreateTexture(targetDescription, GAPI::GpuResourceCpuAccess::None, "BatchTarget"));
+                }
+
+                activeJob.target = std::move(targets.back());
+                targets.pop_back();
+                activeJob.targetRtv = renderContext.CreateRenderTargetView(activeJob.target, GAPI::GpuResourceViewDescription::Texture(GAPI::GpuResourceFormat::BGRA8Unorm, 0, 1, 0, 1));
+
+                Render::FrameExporter::Description exportDescription;
+                exportDescription.directory = job.outputDirectory;
+                exportDescription.prefix = job.name + "_";
+                exportDescription.maxFramesInFlight = BatchExportFramesInFlight;
+
+                activeJob.exporter = std::make_unique<Render::FrameExporter>();
+                activeJob.exporter->Init(renderContext, exportDescription);
+
+                Log::Format::Info("Batch job {} started, {}x{}, {} frames\n", job.name, job.width, job.height, job.framesCount);
+                active.push_back(std::move(activeJob));
+            }
+
+            // Frame of every active job per node frame, so small jobs overlap on GPU.
+            for (auto& activeJob : active)
+            {
+                const auto& job = *activeJob.job;
+
+                // Offline output can't drop frames, job waits for its exporter instead.
+                if (activeJob.exporter->GetFramesInFlight() >= BatchExportFramesInFlight)
+                    continue;
+
+                // Demo frame is a clear to the color of scripted camera position.
+                Vector3 position, target;
+                getScriptedCamera(job.startTime + activeJob.frame * job.timeStep, position, target);
+
+                const auto& commandList = renderContext.AcquireGraphicsCommandList();
+                commandList->ClearRenderTargetView(activeJob.targetRtv, Vector4(0.5f + position.x / 20.0f, position.y / 4.0f, 0.5f + position.z / 20.0f, 1.0f));
+                commandList->Close();
+                renderContext.Submit(commandQueue, commandList);
+
+                const bool isCaptured = activeJob.exporter->Capture(commandQueue, activeJob.target, activeJob.frame);
+                ASSERT(isCaptured);
+                std::ignore = isCaptured;
+
+                activeJob.frame++;
+            }
+
+            // Finished jobs free their GPU slot for the next ones right away.
+            const auto finished = std::stable_partition(active.begin(), active.end(), [](const ActiveJob& activeJob) { return activeJob.frame < activeJob.job->framesCount; });
+            std::move(finished, active.end(), std::back_inserter(draining));
+            active.erase(finished, active.end());
+
+            // Dispatches completed readbacks to workers.
+            renderContext.MoveToNextFrame(commandQueue);
+
+            for (auto it = draining.begin(); it != draining.end();)
+            {
+                if (it->exporter->GetFramesInFlight() > 0)
+                {
+                    ++it;
+                    continue;
+                }
+
+                const auto& job = *it->job;
+                if (it->exporter->GetWrittenFramesCount() != job.framesCount)
+                    failedJobsCount++;
+
+                Log::Format::Info("Batch job {} finished, {} of {} frames written\n", job.name, it->exporter->GetWrittenFramesCount(), job.framesCount);
+
+                it->exporter->Terminate();
+                freeTargets[getTargetKey(job)].push_back(std::move(it->target));
+                it = draining.erase(it);
+            }
+
+            // Only exports are left, nothing to render meanwhile.
+            if (active.empty() && pending.empty() && !draining.empty())
+                std::this_thread::yield();
+        }
+
+        renderContext.WaitForGpu(commandQueue);
+
+        const auto batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+        Log::Format::Info("Batch of {} jobs done in {:.1f}s, {} failed\n", batch_->jobs.size(), batchSeconds, failedJobsCount);
     }
 
     void Application::loadResouces()
     {
+        PROFILE_SCOPE("Application::LoadResources");
+
         // _scene = std::make_shared<Scenes::Scene_2>();
         // _scene->Init();
     }
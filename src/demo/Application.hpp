@@ -1,34 +1,117 @@
 #pragma once
 
 #include "gapi/Device.hpp"
+#include "render/DeviceContext.hpp"
+#include "render/FrameExporter.hpp"
+#include "render/MetricsExporter.hpp"
+#include "render/PerformanceHud.hpp"
+#include "render/RemoteProfiler.hpp"
 #include "windowing/WindowSystem.hpp"
 
+#include <optional>
+
 namespace RR
 {
-    namespace Windowing
+    class Application
     {
-        class InputtingWindow;
-    }
+    public:
+        // Headless run for repeatable performance measurements: no window, frames go to offscreen target,
+        // camera follows scripted path, statistics are written as JSON once all frames are rendered.
+        struct BenchmarkDescription
+        {
+            // Not measured, caches and pools settle during them.
+            uint32_t warmupFramesCount = 60;
+            uint32_t framesCount = 600;
+            U8String outputPath = "Benchmark.json";
+            // Empty disables command capture of measured frames.
+            U8String capturePath;
+            // Empty disables export of measured frames to PNG files in that directory.
+            U8String exportPath;
+        };
+
+        // Offline render job, frames are exported as PNG files named <name>_<frame>.png.
+        struct BatchJob
+        {
+            U8String name;
+            // Mapped once and shared by all jobs of the process. Empty for jobs without scene.
+            U8String scenePath;
+            // Should exist.
+            U8String outputDirectory;
+            uint32_t width = 1920;
+            uint32_t height = 1080;
+            uint32_t framesCount = 1;
+            // Camera path time of the first frame and time between frames, in seconds.
+            float startTime = 0.0f;
+            float timeStep = 1.0f / 24.0f;
+        };
+
+        // Headless run over a queue of render jobs for farm nodes. Device, pipeline cache, render targets and mapped
+        // scenes stay warm across jobs of the process. Small jobs run concurrently, their frames interleave on GPU.
+        struct BatchDescription
+        {
+            std::vector<BatchJob> jobs;
+            uint32_t maxConcurrentJobs = 4;
+            // Jobs with at most that many pixels per frame share GPU, larger ones run alone.
+            uint64_t smallJobPixels = 1280 * 720;
+        };
 
-    class Application : public Windowing::Window::ICallbacks
-    {
     public:
         Application() = default;
+        explicit Application(const BenchmarkDescription& benchmark) : benchmark_(benchmark) { }
+        explicit Application(const BatchDescription& batch) : batch_(batch) { }
+
+        // Job per line: name scene output width height frames [startTime timeStep]. Scene "-" means none, # starts a comment.
+        static bool LoadBatchJobs(const U8String& path, BatchDescription& description);
+
+        // Optional endpoints, should be enabled before Start.
+        void EnableMetrics(const Render::MetricsExporter::Description& description) { metricsDescription_ = description; }
+        void EnableRemoteProfiler(const Render::RemoteProfiler::Description& description) { remoteProfilerDescription_ = description; }
 
         void Start();
-        virtual void OnClose() override;
 
     private:
         bool _quit = false;
 
+        std::optional<BenchmarkDescription> benchmark_;
+        std::optional<BatchDescription> batch_;
+
         std::shared_ptr<Windowing::Window> _window;
+        std::unique_ptr<Render::DeviceContext> deviceContext_;
         std::shared_ptr<GAPI::SwapChain> swapChain_;
+        // Replaces swapchain in headless mode.
+        std::shared_ptr<GAPI::Texture> offscreenTarget_;
+        // Benchmark mode only, when export path is set.
+        Render::FrameExporter frameExporter_;
+        // Windowed mode only, toggled by HudToggleKey.
+        Render::PerformanceHud performanceHud_;
+        bool hudKeyDown_ = false;
+        std::optional<Render::MetricsExporter::Description> metricsDescription_;
+        Render::MetricsExporter metricsExporter_;
+        std::optional<Render::RemoteProfiler::Description> remoteProfilerDescription_;
+        Render::RemoteProfiler remoteProfiler_;
+        // Rendering is throttled while window is in background and stopped while it's minimized.
+        bool windowFocused_ = true;
+        bool windowMinimized_ = false;
+        EventHandle closeHandle_;
+        EventHandle resizeHandle_;
+        EventHandle keyHandle_;
+        EventHandle shownHandle_;
+        EventHandle hiddenHandle_;
+        EventHandle focusGainedHandle_;
+        EventHandle focusLostHandle_;
 
         void init();
         void terminate();
 
         void loadResouces();
+        void runBatch();
 
-        void OnWindowResize(uint32_t width, uint32_t height) override;
+        void onClose();
+        void onWindowResize(uint32_t width, uint32_t height);
+        void onKey(int32_t key, bool pressed);
+        void onWindowShown() { windowMinimized_ = false; }
+        void onWindowHidden() { windowMinimized_ = true; }
+        void onFocusGained() { windowFocused_ = true; }
+        void onFocusLost() { windowFocused_ = false; }
     };
 }
\ No newline at end of file
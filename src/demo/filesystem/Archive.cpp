@@ -0,0 +1,242 @@
+#include "Archive.hpp"
+
+#include "MappedFileStream.hpp"
+
+#include <common/Exception.hpp>
+#include <common/debug/Profiler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <istream>
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        namespace
+        {
+            U8String normalizePath(const U8String& path)
+            {
+                U8String result = path;
+                std::replace(result.begin(), result.end(), '\\', '/');
+
+                size_t start = 0;
+                while (result.compare(start, 2, "./") == 0)
+                    start += 2;
+
+                return result.substr(start);
+            }
+
+            uint64_t alignUp(uint64_t value, uint64_t alignment)
+            {
+                return (value + alignment - 1) & ~(alignment - 1);
+            }
+        }
+
+        uint64_t Archive::HashPath(const U8String& path)
+        {
+            // FNV-1a
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (const char character : normalizePath(path))
+            {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 0x100000001b3ull;
+            }
+
+            // Zero is reserved for empty slots.
+            return hash ? hash : 1;
+        }
+
+        Archive::Archive(const std::shared_ptr<MappedFileStream>& file, const ArchiveFormat::Header& header)
+            : _file(file),
+              _table(reinterpret_cast<const ArchiveFormat::TableEntry*>(file->GetMappedView(
+                  static_cast<int64_t>(header.tableOffset), static_cast<int64_t>(header.tableCapacity * sizeof(ArchiveFormat::TableEntry))))),
+              _tableMask(header.tableCapacity - 1)
+        {
+        }
+
+        Archive::SharedPtr Archive::Mount(const U8String& archivePath)
+        {
+            PROFILE_SCOPE("Archive::Mount");
+
+            auto file = std::make_shared<MappedFileStream>(archivePath);
+            file->Open();
+
+            if (file->GetSize() < static_cast<int64_t>(sizeof(ArchiveFormat::Header)))
+                return nullptr;
+
+            ArchiveFormat::Header header;
+            std::memcpy(&header, file->GetMappedView(0, sizeof(header)), sizeof(header));
+
+            const bool isPowerOfTwo = header.tableCapacity && (header.tableCapacity & (header.tableCapacity - 1)) == 0;
+            if (header.magic != ArchiveFormat::Magic || header.version != ArchiveFormat::Version || !isPowerOfTwo)
+                return nullptr;
+
+            if (header.tableOffset + header.tableCapacity * sizeof(ArchiveFormat::TableEntry) > static_cast<uint64_t>(file->GetSize()))
+                return nullptr;
+
+            return SharedPtr(new Archive(file, header));
+        }
+
+        const ArchiveFormat::TableEntry* Archive::find(uint64_t pathHash) const
+        {
+            for (uint32_t probe = 0; probe <= _tableMask; probe++)
+            {
+                const auto& entry = _table[(pathHash + probe) & _tableMask];
+
+                if (entry.pathHash == pathHash)
+                    return &entry;
+
+                if (entry.pathHash == 0)
+                    return nullptr;
+            }
+
+            return nullptr;
+        }
+
+        std::shared_ptr<Common::Stream> Archive::Open(const U8String& path) const
+        {
+            const auto entry = find(HashPath(path));
+            if (!entry)
+                return nullptr;
+
+            if (entry->compression != ArchiveFormat::Compression::None)
+                throw Common::Exception(fmt::format(FMT_STRING("Unsupported compression of {} in archive {}"), path.c_str(), _file->GetName().c_str()));
+
+            const auto data = _file->GetMappedView(static_cast<int64_t>(entry->offset), static_cast<int64_t>(entry->size));
+            return std::make_shared<ArchiveEntryStream>(path, _file, data, static_cast<int64_t>(entry->size));
+        }
+
+        bool Archive::Locate(const U8String& path, int64_t& offset, int64_t& size) const
+        {
+            const auto entry = find(HashPath(path));
+            if (!entry || entry->compression != ArchiveFormat::Compression::None)
+                return false;
+
+            offset = static_cast<int64_t>(entry->offset);
+            size = static_cast<int64_t>(entry->size);
+            return true;
+        }
+
+        U8String Archive::GetPath() const
+        {
+            return _file->GetName();
+        }
+
+        bool Archive::Build(const std::vector<SourceFile>& files, const U8String& archivePath)
+        {
+            // Load factor stays at or below 0.5 so probe chains are short.
+            uint32_t tableCapacity = 16;
+            while (tableCapacity < files.size() * 2)
+                tableCapacity *= 2;
+
+            ArchiveFormat::Header header = {};
+            header.magic = ArchiveFormat::Magic;
+            header.version = ArchiveFormat::Version;
+            header.entriesCount = static_cast<uint32_t>(files.size());
+            header.tableCapacity = tableCapacity;
+            header.tableOffset = sizeof(ArchiveFormat::Header);
+
+            std::vector<ArchiveFormat::TableEntry> table(tableCapacity);
+            std::memset(table.data(), 0, table.size() * sizeof(ArchiveFormat::TableEntry));
+
+            std::ofstream archive(archivePath, std::ios::binary | std::ios::trunc);
+            if (!archive)
+                return false;
+
+            uint64_t offset = alignUp(header.tableOffset + tableCapacity * sizeof(ArchiveFormat::TableEntry), ArchiveFormat::DataAlignment);
+            archive.seekp(static_cast<std::streamoff>(offset));
+
+            std::vector<char> data;
+            for (const auto& file : files)
+            {
+                std::ifstream source(file.diskPath, std::ios::binary | std::ios::ate);
+                if (!source)
+                {
+                    Log::Print::Warning("Can't open %s\n", file.diskPath);
+                    return false;
+                }
+
+                data.resize(static_cast<size_t>(source.tellg()));
+                source.seekg(0);
+                source.read(data.data(), static_cast<std::streamsize>(data.size()));
+
+                const auto pathHash = HashPath(file.path);
+                uint32_t slot = static_cast<uint32_t>(pathHash) & (tableCapacity - 1);
+                while (table[slot].pathHash != 0)
+                {
+                    if (table[slot].pathHash == pathHash)
+                    {
+                        Log::Print::Warning("Duplicate or colliding path %s\n", file.path);
+                        return false;
+                    }
+
+                    slot = (slot + 1) & (tableCapacity - 1);
+                }
+
+                auto& entry = table[slot];
+                entry.pathHash = pathHash;
+                entry.offset = offset;
+                entry.size = data.size();
+                entry.storedSize = data.size();
+                entry.compression = ArchiveFormat::Compression::None;
+
+                archive.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+                const auto alignedEnd = alignUp(offset + data.size(), ArchiveFormat::DataAlignment);
+                const char padding[ArchiveFormat::DataAlignment] = {};
+                archive.write(padding, static_cast<std::streamsize>(alignedEnd - offset - data.size()));
+                offset = alignedEnd;
+            }
+
+            archive.seekp(0);
+            archive.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            archive.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(ArchiveFormat::TableEntry)));
+
+            return archive.good();
+        }
+
+        ArchiveEntryStream::ArchiveEntryStream(const U8String& name, const std::shared_ptr<MappedFileStream>& archive, const char* data, int64_t size)
+            : _name(name), _archive(archive), _data(data), _size(size)
+        {
+            _buffer.Reset(_data, _data + _size);
+        }
+
+        void ArchiveEntryStream::SetPosition(int64_t value)
+        {
+            if (value < 0 || value > _size)
+                throw Common::Exception(fmt::format(FMT_STRING("Position {} is out of file {}"), value, _name.c_str()));
+
+            _position = value;
+        }
+
+        int64_t ArchiveEntryStream::Read(char* data, int64_t length)
+        {
+            const auto readLength = std::min(length, _size - _position);
+            if (readLength <= 0)
+                return 0;
+
+            std::memcpy(data, _data + _position, static_cast<size_t>(readLength));
+            _position += readLength;
+
+            return readLength;
+        }
+
+        int64_t ArchiveEntryStream::Write(const char* data, int64_t length)
+        {
+            (void)data;
+            (void)length;
+
+            throw Common::Exception(fmt::format(FMT_STRING("File {} in archive is read only"), _name.c_str()));
+        }
+
+        std::istream* ArchiveEntryStream::GetNativeStream()
+        {
+            if (!_nativeStream)
+                _nativeStream = std::make_unique<std::istream>(&_buffer);
+
+            return _nativeStream.get();
+        }
+    }
+}
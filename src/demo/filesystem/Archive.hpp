@@ -0,0 +1,124 @@
+#pragma once
+
+#include "common/Stream.hpp"
+
+#include "MemoryStreamBuffer.hpp"
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        class MappedFileStream;
+
+        // Single file asset pack. Layout:
+        //   Header | TOC (open addressing hash table, power of two slots) | entries data, each 64 bytes aligned.
+        // Archive is memory mapped once, lookups hash the normalized path and probe linearly.
+        namespace ArchiveFormat
+        {
+            static constexpr uint32_t Magic = 0x4B505252; // 'RRPK'
+            static constexpr uint32_t Version = 1;
+            static constexpr uint64_t DataAlignment = 64;
+
+            enum class Compression : uint32_t
+            {
+                None,
+                // Reserved, no compressor in the tree yet.
+                LZ4,
+                Zstd,
+            };
+
+            struct Header final
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t entriesCount;
+                uint32_t tableCapacity;
+                uint64_t tableOffset;
+                uint8_t reserved[40];
+            };
+            static_assert(sizeof(Header) == 64);
+
+            struct TableEntry final
+            {
+                // Zero marks an empty slot.
+                uint64_t pathHash;
+                uint64_t offset;
+                uint64_t size;
+                uint64_t storedSize;
+                Compression compression;
+                uint32_t reserved[3];
+            };
+            static_assert(sizeof(TableEntry) == 48);
+        }
+
+        class Archive final : private NonCopyable
+        {
+        public:
+            using SharedPtr = std::shared_ptr<Archive>;
+
+            struct SourceFile final
+            {
+                // Path inside archive.
+                U8String path;
+                U8String diskPath;
+            };
+
+        public:
+            // Returns nullptr if file is not a valid archive.
+            static SharedPtr Mount(const U8String& archivePath);
+            static bool Build(const std::vector<SourceFile>& files, const U8String& archivePath);
+
+            static uint64_t HashPath(const U8String& path);
+
+            // Returns nullptr when path is not in archive.
+            std::shared_ptr<Common::Stream> Open(const U8String& path) const;
+            bool Contains(const U8String& path) const { return find(HashPath(path)) != nullptr; }
+            // Location of uncompressed entry inside archive file, for positional reads.
+            bool Locate(const U8String& path, int64_t& offset, int64_t& size) const;
+
+            U8String GetPath() const;
+
+        private:
+            Archive(const std::shared_ptr<MappedFileStream>& file, const ArchiveFormat::Header& header);
+
+            const ArchiveFormat::TableEntry* find(uint64_t pathHash) const;
+
+        private:
+            std::shared_ptr<MappedFileStream> _file;
+            const ArchiveFormat::TableEntry* _table;
+            uint32_t _tableMask;
+        };
+
+        // Stream over a stored entry, reads straight from archive mapping.
+        class ArchiveEntryStream final : public Common::Stream
+        {
+        public:
+            ArchiveEntryStream(const U8String& name, const std::shared_ptr<MappedFileStream>& archive, const char* data, int64_t size);
+
+            virtual inline U8String GetName() const override { return _name; }
+
+            virtual int64_t GetPosition() override { return _position; }
+            virtual void SetPosition(int64_t value) override;
+
+            virtual int64_t GetSize() override { return _size; }
+
+            virtual int64_t Read(char* data, int64_t length) override;
+            virtual int64_t Write(const char* data, int64_t length) override;
+
+            virtual std::istream* GetNativeStream() override;
+
+            // Zero-copy access, valid while stream is alive.
+            inline const char* GetMappedView() const { return _data; }
+
+        private:
+            U8String _name;
+            // Keeps mapping alive.
+            std::shared_ptr<MappedFileStream> _archive;
+            const char* _data;
+            int64_t _size;
+            int64_t _position = 0;
+            MemoryStreamBuffer _buffer;
+            std::unique_ptr<std::istream> _nativeStream;
+        };
+    }
+}
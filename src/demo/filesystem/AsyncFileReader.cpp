@@ -0,0 +1,237 @@
+#include "AsyncFileReader.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/debug/Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef OS_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        namespace
+        {
+            // Positional read without shared file pointer, safe to issue from several threads.
+            bool readFileRange(const U8String& path, int64_t offset, int64_t size, uint8_t* data)
+            {
+#ifdef OS_WINDOWS
+                const auto& wPath = StringConversions::UTF8ToWString(path);
+                const auto fileHandle = CreateFileW(wPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (fileHandle == INVALID_HANDLE_VALUE)
+                    return false;
+
+                bool succeeded = true;
+                while (size > 0 && succeeded)
+                {
+                    OVERLAPPED overlapped = {};
+                    overlapped.Offset = static_cast<DWORD>(offset);
+                    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+                    const auto chunkSize = static_cast<DWORD>(std::min<int64_t>(size, 64 * 1024 * 1024));
+                    DWORD bytesRead = 0;
+                    succeeded = ReadFile(fileHandle, data, chunkSize, &bytesRead, &overlapped) && bytesRead == chunkSize;
+
+                    offset += bytesRead;
+                    data += bytesRead;
+                    size -= bytesRead;
+                }
+
+                CloseHandle(fileHandle);
+                return succeeded;
+#else
+                const int fileDescriptor = open(path.c_str(), O_RDONLY);
+                if (fileDescriptor < 0)
+                    return false;
+
+                while (size > 0)
+                {
+                    const auto bytesRead = pread(fileDescriptor, data, static_cast<size_t>(size), offset);
+                    if (bytesRead <= 0)
+                        break;
+
+                    offset += bytesRead;
+                    data += bytesRead;
+                    size -= bytesRead;
+                }
+
+                close(fileDescriptor);
+                return size == 0;
+#endif
+            }
+        }
+
+        void ReadRequest::Wait() const
+        {
+            if (IsCompleted())
+                return;
+
+            Threading::UniqueLock<Threading::Mutex> lock(_mutex);
+            _completedCondition.wait(lock, [this]() { return IsCompleted(); });
+        }
+
+        void ReadRequest::complete(bool succeeded)
+        {
+            _succeeded = succeeded;
+            if (!succeeded)
+                _data.clear();
+
+            // Callback runs before waiters are released, so it may consume data (e.g. upload) first.
+            if (_callback)
+                _callback(*this);
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(_mutex);
+                _completed.store(true, std::memory_order_release);
+            }
+            _completedCondition.notify_all();
+        }
+
+        AsyncFileReader::AsyncFileReader(uint32_t threadsCount)
+        {
+            ASSERT(threadsCount > 0);
+
+            _threads.reserve(threadsCount);
+            for (uint32_t index = 0; index < threadsCount; index++)
+                _threads.emplace_back(fmt::sprintf("Async file reader %d", index), [this]() { threadFunc(); });
+        }
+
+        AsyncFileReader::~AsyncFileReader()
+        {
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(_mutex);
+                _stop = true;
+            }
+            _queueCondition.notify_all();
+
+            for (auto& thread : _threads)
+                thread.Join();
+
+            // Nobody will serve leftovers.
+            for (const auto& request : _queue)
+                request->complete(false);
+        }
+
+        std::shared_ptr<ReadRequest> AsyncFileReader::Read(const U8String& path, int64_t offset, int64_t size, ReadRequest::CompletionCallback callback)
+        {
+            ASSERT(offset >= 0 && size >= 0);
+
+            auto request = std::make_shared<ReadRequest>(path, offset, size, std::move(callback));
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(_mutex);
+                _queue.push_back(request);
+            }
+            _queueCondition.notify_one();
+
+            return request;
+        }
+
+        void AsyncFileReader::takeMergeableRequests(std::vector<std::shared_ptr<ReadRequest>>& batch)
+        {
+            // Called under lock, batch holds the first request.
+            int64_t begin = batch.front()->GetOffset();
+            int64_t end = begin + batch.front()->GetSize();
+
+            bool merged = true;
+            while (merged)
+            {
+                merged = false;
+
+                for (auto it = _queue.begin(); it != _queue.end(); ++it)
+                {
+                    const auto& request = *it;
+                    if (request->GetPath() != batch.front()->GetPath())
+                        continue;
+
+                    const int64_t requestBegin = request->GetOffset();
+                    const int64_t requestEnd = requestBegin + request->GetSize();
+
+                    const bool isNear = requestBegin <= end + MaxMergeGap && requestEnd + MaxMergeGap >= begin;
+                    const bool fits = std::max(end, requestEnd) - std::min(begin, requestBegin) <= MaxMergedSize;
+                    if (!isNear || !fits)
+                        continue;
+
+                    begin = std::min(begin, requestBegin);
+                    end = std::max(end, requestEnd);
+                    batch.push_back(request);
+                    _queue.erase(it);
+
+                    // Range grew, earlier skipped requests may be mergeable now.
+                    merged = true;
+                    break;
+                }
+            }
+        }
+
+        void AsyncFileReader::executeBatch(const std::vector<std::shared_ptr<ReadRequest>>& batch)
+        {
+            PROFILE_SCOPE("AsyncFileReader::ExecuteBatch");
+
+            if (batch.size() == 1)
+            {
+                auto& request = *batch.front();
+                request._data.resize(static_cast<size_t>(request.GetSize()));
+                request.complete(readFileRange(request.GetPath(), request.GetOffset(), request.GetSize(), request._data.data()));
+                return;
+            }
+
+            int64_t begin = batch.front()->GetOffset();
+            int64_t end = begin;
+            for (const auto& request : batch)
+            {
+                begin = std::min(begin, request->GetOffset());
+                end = std::max(end, request->GetOffset() + request->GetSize());
+            }
+
+            std::vector<uint8_t> merged(static_cast<size_t>(end - begin));
+            const bool succeeded = readFileRange(batch.front()->GetPath(), begin, end - begin, merged.data());
+
+            for (const auto& request : batch)
+            {
+                if (succeeded)
+                {
+                    const auto first = merged.begin() + (request->GetOffset() - begin);
+                    request->_data.assign(first, first + request->GetSize());
+                }
+
+                request->complete(succeeded);
+            }
+        }
+
+        void AsyncFileReader::threadFunc()
+        {
+            Debug::Profiler::SetThreadName("AsyncFileReader");
+            ALLOCATION_TAG_SCOPE(Assets);
+
+            std::vector<std::shared_ptr<ReadRequest>> batch;
+
+            while (true)
+            {
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(_mutex);
+                    _queueCondition.wait(lock, [this]() { return _stop || !_queue.empty(); });
+
+                    if (_stop)
+                        return;
+
+                    batch.push_back(_queue.front());
+                    _queue.pop_front();
+
+                    takeMergeableRequests(batch);
+                }
+
+                executeBatch(batch);
+                batch.clear();
+            }
+        }
+    }
+}
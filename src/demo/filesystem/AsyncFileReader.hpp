@@ -0,0 +1,78 @@
+#pragma once
+
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+#include <deque>
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        class ReadRequest final : private NonCopyable
+        {
+        public:
+            using CompletionCallback = std::function<void(const ReadRequest& request)>;
+
+            ReadRequest(const U8String& path, int64_t offset, int64_t size, CompletionCallback callback)
+                : _path(path), _offset(offset), _size(size), _callback(std::move(callback)) { }
+
+            inline const U8String& GetPath() const { return _path; }
+            inline int64_t GetOffset() const { return _offset; }
+            inline int64_t GetSize() const { return _size; }
+
+            inline bool IsCompleted() const { return _completed.load(std::memory_order_acquire); }
+            void Wait() const;
+
+            // Valid after completion.
+            inline bool IsSucceeded() const { return _succeeded; }
+            inline const std::vector<uint8_t>& GetData() const { return _data; }
+
+        private:
+            void complete(bool succeeded);
+
+        private:
+            U8String _path;
+            int64_t _offset;
+            int64_t _size;
+            CompletionCallback _callback;
+
+            std::vector<uint8_t> _data;
+            bool _succeeded = false;
+            std::atomic<bool> _completed = false;
+            mutable Threading::Mutex _mutex;
+            mutable Threading::ConditionVariable _completedCondition;
+
+            friend class AsyncFileReader;
+        };
+
+        // Worker pool serving positional reads. Queued requests to the same file whose ranges are
+        // adjacent or close are merged into a single read before being split back to requests.
+        class AsyncFileReader final : private NonCopyable
+        {
+        public:
+            AsyncFileReader(uint32_t threadsCount);
+            ~AsyncFileReader();
+
+            std::shared_ptr<ReadRequest> Read(const U8String& path, int64_t offset, int64_t size, ReadRequest::CompletionCallback callback);
+
+        private:
+            void threadFunc();
+            void takeMergeableRequests(std::vector<std::shared_ptr<ReadRequest>>& batch);
+            void executeBatch(const std::vector<std::shared_ptr<ReadRequest>>& batch);
+
+        private:
+            // Requests separated by smaller gap are read together, gap bytes are discarded.
+            static constexpr int64_t MaxMergeGap = 64 * 1024;
+            static constexpr int64_t MaxMergedSize = 16 * 1024 * 1024;
+
+            Threading::Mutex _mutex;
+            Threading::ConditionVariable _queueCondition;
+            std::deque<std::shared_ptr<ReadRequest>> _queue;
+            bool _stop = false;
+            std::vector<Threading::Thread> _threads;
+        };
+    }
+}
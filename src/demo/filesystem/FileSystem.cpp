@@ -1,6 +1,7 @@
 #include "FileSystem.hpp"
 
 #include "FileStream.hpp"
+#include "MappedFileStream.hpp"
 
 namespace RR
 {
@@ -10,11 +11,55 @@ namespace RR
 
         std::shared_ptr<Common::Stream> FileSystem::Open(const U8String& fileName, Mode RW) const
         {
+            if (RW == Mode::READ || RW == Mode::MAP_READ)
+            {
+                for (auto it = _archives.rbegin(); it != _archives.rend(); ++it)
+                    if (auto stream = (*it)->Open(fileName))
+                        return stream;
+            }
+
+            if (RW == Mode::MAP_READ)
+            {
+                auto* mappedFileStream = new MappedFileStream(fileName);
+                mappedFileStream->Open();
+
+                return std::shared_ptr<Common::Stream>(mappedFileStream);
+            }
+
             auto* fileStream = new FileStream(fileName);
 
             fileStream->Open(RW);
 
             return std::shared_ptr<Common::Stream>(fileStream);
         }
+
+        std::shared_ptr<ReadRequest> FileSystem::ReadAsync(const U8String& fileName, int64_t offset, int64_t size,
+                                                           ReadRequest::CompletionCallback callback) const
+        {
+            std::call_once(_asyncReaderInitFlag, [this]() { _asyncReader = std::make_unique<AsyncFileReader>(AsyncReadThreadsCount); });
+
+            for (auto it = _archives.rbegin(); it != _archives.rend(); ++it)
+            {
+                int64_t entryOffset;
+                int64_t entrySize;
+                if (!(*it)->Locate(fileName, entryOffset, entrySize))
+                    continue;
+
+                ASSERT(offset + size <= entrySize);
+                return _asyncReader->Read((*it)->GetPath(), entryOffset + offset, size, std::move(callback));
+            }
+
+            return _asyncReader->Read(fileName, offset, size, std::move(callback));
+        }
+
+        bool FileSystem::Mount(const U8String& archivePath)
+        {
+            auto archive = Archive::Mount(archivePath);
+            if (!archive)
+                return false;
+
+            _archives.push_back(std::move(archive));
+            return true;
+        }
     }
 }
\ No newline at end of file
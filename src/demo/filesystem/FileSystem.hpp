@@ -8,6 +8,11 @@ namespace fs = std::filesystem;
 namespace fs = ghc::filesystem;
 #endif
 
+#include "Archive.hpp"
+#include "AsyncFileReader.hpp"
+
+#include <mutex>
+
 namespace RR
 {
     namespace Common
@@ -24,7 +29,9 @@ namespace RR
             CLOSED,
             READ,
             WRITE,
-            APPEND
+            APPEND,
+            // Read only, returns MappedFileStream with zero-copy GetMappedView.
+            MAP_READ
         };
 
         class FileSystem
@@ -35,10 +42,27 @@ namespace RR
                 return instance;
             }
 
+            // Read modes look up mounted archives first, newest mount wins.
             std::shared_ptr<Common::Stream> Open(const U8String& fileName, Mode RW = Mode::READ) const;
 
+            // Not thread safe, mount archives before starting loads.
+            bool Mount(const U8String& archivePath);
+
+            // Reads on worker threads, doesn't block caller. Callback is called on worker thread before request
+            // is marked completed, so it can push data to upload directly.
+            std::shared_ptr<ReadRequest> ReadAsync(const U8String& fileName, int64_t offset, int64_t size,
+                                                   ReadRequest::CompletionCallback callback = nullptr) const;
+
         private:
+            static constexpr uint32_t AsyncReadThreadsCount = 2;
+
             static std::unique_ptr<FileSystem> instance;
+
+            // Started on first async read.
+            mutable std::once_flag _asyncReaderInitFlag;
+            mutable std::unique_ptr<AsyncFileReader> _asyncReader;
+
+            std::vector<Archive::SharedPtr> _archives;
         };
 
         inline static const std::unique_ptr<FileSystem>& Instance()
@@ -0,0 +1,180 @@
+#include "MappedFileStream.hpp"
+
+#include <common/Exception.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+
+#ifdef OS_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        MappedFileStream::MappedFileStream(const U8String& fileName)
+            : _fileName(fileName)
+        {
+        }
+
+        MappedFileStream::~MappedFileStream()
+        {
+            Close();
+        }
+
+        bool MappedFileStream::Open()
+        {
+            Close();
+
+#ifdef OS_WINDOWS
+            const auto& wFileName = StringConversions::UTF8ToWString(_fileName);
+            const auto fileHandle = CreateFileW(wFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+            if (fileHandle == INVALID_HANDLE_VALUE)
+                throw Common::Exception(fmt::format(FMT_STRING("Error while opening file {}"), _fileName.c_str()));
+
+            _fileHandle = fileHandle;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(fileHandle, &size))
+            {
+                Close();
+                throw Common::Exception(fmt::format(FMT_STRING("Error while reading size of file {}"), _fileName.c_str()));
+            }
+            _size = size.QuadPart;
+
+            // Empty files can't be mapped.
+            if (_size > 0)
+            {
+                _mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                _data = _mappingHandle ? static_cast<const char*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+                if (!_data)
+                {
+                    Close();
+                    throw Common::Exception(fmt::format(FMT_STRING("Error while mapping file {}"), _fileName.c_str()));
+                }
+            }
+#else
+            const int fileDescriptor = open(_fileName.c_str(), O_RDONLY);
+            if (fileDescriptor < 0)
+                throw Common::Exception(fmt::format(FMT_STRING("Error while opening file {}"), _fileName.c_str()));
+
+            struct stat fileStat;
+            if (fstat(fileDescriptor, &fileStat) != 0)
+            {
+                close(fileDescriptor);
+                throw Common::Exception(fmt::format(FMT_STRING("Error while reading size of file {}"), _fileName.c_str()));
+            }
+            _size = fileStat.st_size;
+
+            if (_size > 0)
+            {
+                void* data = mmap(nullptr, static_cast<size_t>(_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                if (data == MAP_FAILED)
+                {
+                    close(fileDescriptor);
+                    throw Common::Exception(fmt::format(FMT_STRING("Error while mapping file {}"), _fileName.c_str()));
+                }
+
+                _data = static_cast<const char*>(data);
+            }
+
+            // Mapping keeps file referenced.
+            close(fileDescriptor);
+#endif
+
+            _position = 0;
+            _buffer.Reset(_data, _data + _size);
+            return true;
+        }
+
+        void MappedFileStream::Close()
+        {
+#ifdef OS_WINDOWS
+            if (_data)
+                UnmapViewOfFile(_data);
+
+            if (_mappingHandle)
+                CloseHandle(_mappingHandle);
+
+            if (_fileHandle)
+                CloseHandle(_fileHandle);
+
+            _mappingHandle = nullptr;
+            _fileHandle = nullptr;
+#else
+            if (_data)
+                munmap(const_cast<char*>(_data), static_cast<size_t>(_size));
+#endif
+            _data = nullptr;
+            _size = 0;
+            _position = 0;
+            _nativeStream.reset();
+            _buffer.Reset(nullptr, nullptr);
+        }
+
+        int64_t MappedFileStream::GetPosition()
+        {
+            return _position;
+        }
+
+        void MappedFileStream::SetPosition(int64_t value)
+        {
+            if (value < 0 || value > _size)
+                throw Common::Exception(fmt::format(FMT_STRING("Position {} is out of file {}"), value, _fileName.c_str()));
+
+            _position = value;
+        }
+
+        int64_t MappedFileStream::GetSize()
+        {
+            return _size;
+        }
+
+        int64_t MappedFileStream::Read(char* data, int64_t length)
+        {
+            const auto readLength = std::min(length, _size - _position);
+            if (readLength <= 0)
+                return 0;
+
+            std::memcpy(data, _data + _position, static_cast<size_t>(readLength));
+            _position += readLength;
+
+            return readLength;
+        }
+
+        int64_t MappedFileStream::Write(const char* data, int64_t length)
+        {
+            (void)data;
+            (void)length;
+
+            throw Common::Exception(fmt::format(FMT_STRING("File {} is mapped read only"), _fileName.c_str()));
+        }
+
+        std::istream* MappedFileStream::GetNativeStream()
+        {
+            // Independent from GetPosition/Read, reads straight from mapped memory.
+            if (!_nativeStream)
+                _nativeStream = std::make_unique<std::istream>(&_buffer);
+
+            return _nativeStream.get();
+        }
+
+        const char* MappedFileStream::GetMappedView(int64_t offset, int64_t size) const
+        {
+            if (offset < 0 || size < 0 || offset + size > _size)
+                throw Common::Exception(fmt::format(FMT_STRING("View [{}, {}) is out of file {}"), offset, offset + size, _fileName.c_str()));
+
+            return _data + offset;
+        }
+    }
+}
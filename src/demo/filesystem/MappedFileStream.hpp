@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common/Stream.hpp"
+
+#include "MemoryStreamBuffer.hpp"
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        // Read only stream over a file mapped into address space.
+        // GetMappedView gives zero-copy access, Read still copies for Common::Stream consumers.
+        class MappedFileStream final : public Common::Stream
+        {
+        public:
+            MappedFileStream(const U8String& fileName);
+            virtual ~MappedFileStream() override;
+
+            bool Open();
+            void Close();
+
+            virtual inline U8String GetName() const override
+            {
+                return _fileName;
+            }
+
+            virtual int64_t GetPosition() override;
+            virtual void SetPosition(int64_t value) override;
+
+            virtual int64_t GetSize() override;
+
+            virtual int64_t Read(char* data, int64_t length) override;
+            virtual int64_t Write(const char* data, int64_t length) override;
+
+            virtual std::istream* GetNativeStream() override;
+
+            // Pointer stays valid until stream is closed.
+            const char* GetMappedView(int64_t offset, int64_t size) const;
+
+        private:
+            U8String _fileName;
+            const char* _data = nullptr;
+            int64_t _size = 0;
+            int64_t _position = 0;
+#ifdef OS_WINDOWS
+            void* _fileHandle = nullptr;
+            void* _mappingHandle = nullptr;
+#endif
+            MemoryStreamBuffer _buffer;
+            std::unique_ptr<std::istream> _nativeStream;
+        };
+    }
+}
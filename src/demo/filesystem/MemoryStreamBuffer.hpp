@@ -0,0 +1,39 @@
+#pragma once
+
+#include <streambuf>
+
+namespace RR
+{
+    namespace FileSystem
+    {
+        // Read only std::streambuf over external memory.
+        class MemoryStreamBuffer final : public std::streambuf
+        {
+        public:
+            void Reset(const char* begin, const char* end)
+            {
+                setg(const_cast<char*>(begin), const_cast<char*>(begin), const_cast<char*>(end));
+            }
+
+        protected:
+            pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override
+            {
+                (void)mode;
+
+                char* base = direction == std::ios_base::beg ? eback() : direction == std::ios_base::cur ? gptr() : egptr();
+                char* position = base + offset;
+
+                if (position < eback() || position > egptr())
+                    return pos_type(off_type(-1));
+
+                setg(eback(), position, egptr());
+                return pos_type(position - eback());
+            }
+
+            pos_type seekpos(pos_type position, std::ios_base::openmode mode) override
+            {
+                return seekoff(off_type(position), std::ios_base::beg, mode);
+            }
+        };
+    }
+}
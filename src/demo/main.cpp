@@ -1,5 +1,96 @@
 #include "Application.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // --benchmark [--frames N] [--warmup N] [--output path] [--capture path] [--export directory]
+    bool parseBenchmarkArguments(int argc, char** argv, RR::Application::BenchmarkDescription& description)
+    {
+        bool benchmark = false;
+
+        for (int index = 1; index < argc; index++)
+        {
+            const char* argument = argv[index];
+            const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+            if (strcmp(argument, "--benchmark") == 0)
+                benchmark = true;
+            else if (strcmp(argument, "--frames") == 0 && value)
+                description.framesCount = static_cast<uint32_t>(strtoul(argv[++index], nullptr, 10));
+            else if (strcmp(argument, "--warmup") == 0 && value)
+                description.warmupFramesCount = static_cast<uint32_t>(strtoul(argv[++index], nullptr, 10));
+            else if (strcmp(argument, "--output") == 0 && value)
+                description.outputPath = argv[++index];
+            else if (strcmp(argument, "--capture") == 0 && value)
+                description.capturePath = argv[++index];
+            else if (strcmp(argument, "--export") == 0 && value)
+                description.exportPath = argv[++index];
+        }
+
+        return benchmark;
+    }
+
+    // --batch jobs.txt [--concurrent N]
+    bool parseBatchArguments(int argc, char** argv, RR::Application::BatchDescription& description)
+    {
+        const char* jobsPath = nullptr;
+
+        for (int index = 1; index < argc; index++)
+        {
+            const char* argument = argv[index];
+            const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+            if (strcmp(argument, "--batch") == 0 && value)
+                jobsPath = argv[++index];
+            else if (strcmp(argument, "--concurrent") == 0 && value)
+                description.maxConcurrentJobs = std::max(1u, static_cast<uint32_t>(strtoul(argv[++index], nullptr, 10)));
+        }
+
+        return jobsPath && RR::Application::LoadBatchJobs(jobsPath, description);
+    }
+
+    // --metrics port|socket path, e.g. --metrics 9464 or --metrics /run/rr/metrics.sock
+    bool parseMetricsArguments(int argc, char** argv, RR::Render::MetricsExporter::Description& description)
+    {
+        for (int index = 1; index + 1 < argc; index++)
+        {
+            if (strcmp(argv[index], "--metrics") != 0)
+                continue;
+
+            const char* value = argv[index + 1];
+            if (isdigit(static_cast<unsigned char>(value[0])))
+                description.port = static_cast<uint16_t>(strtoul(value, nullptr, 10));
+            else
+                description.unixSocketPath = value;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // --remote-profiler [port]
+    bool parseRemoteProfilerArguments(int argc, char** argv, RR::Render::RemoteProfiler::Description& description)
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            if (strcmp(argv[index], "--remote-profiler") != 0)
+                continue;
+
+            if (index + 1 < argc && isdigit(static_cast<unsigned char>(argv[index + 1][0])))
+                description.port = static_cast<uint16_t>(strtoul(argv[index + 1], nullptr, 10));
+
+            return true;
+        }
+
+        return false;
+    }
+}
+
 #ifdef OS_WINDOWS
 #include <Windows.h>
 INT WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine, INT nCmdShow)
@@ -9,16 +100,36 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine, INT nC
     (void)lpCmdLine;
     (void)nCmdShow;
 
+    const int argc = __argc;
+    char** argv = __argv;
 #else
 int main(int argc, char** argv)
 {
-    (void)argc;
-    (void)argv;
 #endif
 
-    auto app = new RR::Application;
+    RR::Application::BenchmarkDescription benchmarkDescription;
+    const bool benchmark = parseBenchmarkArguments(argc, argv, benchmarkDescription);
+
+    RR::Render::MetricsExporter::Description metricsDescription;
+    const bool metrics = parseMetricsArguments(argc, argv, metricsDescription);
+
+    RR::Render::RemoteProfiler::Description remoteProfilerDescription;
+    const bool remoteProfiler = parseRemoteProfilerArguments(argc, argv, remoteProfilerDescription);
+
+    RR::Application::BatchDescription batchDescription;
+    const bool batch = !benchmark && parseBatchArguments(argc, argv, batchDescription);
+
+    auto app = benchmark ? new RR::Application(benchmarkDescription)
+               : batch   ? new RR::Application(batchDescription)
+                         : new RR::Application;
+
+    if (metrics)
+        app->EnableMetrics(metricsDescription);
+
+    if (remoteProfiler)
+        app->EnableRemoteProfiler(remoteProfilerDescription);
 
     app->Start();
 
     return 0;
-}
\ No newline at end of file
+}
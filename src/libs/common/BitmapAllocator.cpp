@@ -0,0 +1,283 @@
+#include "BitmapAllocator.hpp"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace
+        {
+            // Value must be non zero.
+            uint32_t countTrailingZeros(uint64_t value)
+            {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanForward64(&index, value);
+                return static_cast<uint32_t>(index);
+#else
+                return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+            }
+
+            // Value must be non zero.
+            uint32_t countLeadingZeros(uint64_t value)
+            {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanReverse64(&index, value);
+                return 63 - static_cast<uint32_t>(index);
+#else
+                return static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+            }
+
+            uint64_t getRunMask(uint32_t bit, uint32_t count)
+            {
+                ASSERT(count > 0 && bit + count <= 64);
+                return (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << bit;
+            }
+
+            // Bit i of result is set when bits [i, i + count) of value are all set.
+            uint64_t findRuns(uint64_t value, uint32_t count)
+            {
+                for (uint32_t length = 1; length < count && value;)
+                {
+                    const uint32_t shift = std::min(length, count - length);
+                    value &= value >> shift;
+                    length += shift;
+                }
+
+                return value;
+            }
+        }
+
+        void BitmapAllocator::Init(uint32_t capacity)
+        {
+            ASSERT(capacity > 0);
+            ASSERT(allocated_ == 0);
+
+            capacity_ = capacity;
+            wordsCount_ = (capacity + WordBits - 1) / WordBits;
+            summaryCount_ = (wordsCount_ + WordBits - 1) / WordBits;
+
+            words_ = std::make_unique<std::atomic<uint64_t>[]>(wordsCount_);
+            summary_ = std::make_unique<std::atomic<uint64_t>[]>(summaryCount_);
+
+            for (uint32_t word = 0; word < wordsCount_; word++)
+                words_[word] = 0;
+
+            // Indices past capacity are never handed out.
+            if (const uint32_t tailBits = capacity % WordBits)
+                words_[wordsCount_ - 1] = ~getRunMask(0, tailBits);
+
+            for (uint32_t summary = 0; summary < summaryCount_; summary++)
+            {
+                const uint32_t words = std::min(wordsCount_ - summary * WordBits, WordBits);
+                summary_[summary] = getRunMask(0, words);
+            }
+
+            allocated_ = 0;
+            searchStart_ = 0;
+        }
+
+        uint32_t BitmapAllocator::Allocate(uint32_t count)
+        {
+            ASSERT(words_);
+            ASSERT(count > 0);
+
+            if (count > capacity_)
+                return InvalidIndex;
+
+            uint32_t index = count <= WordBits ? allocateInWords(count) : InvalidIndex;
+
+            // Single index always fits in a word, longer ranges could also cross word boundary.
+            if (index == InvalidIndex && count > 1)
+                index = allocateSpanning(count);
+
+            if (index != InvalidIndex)
+                allocated_.fetch_add(count, std::memory_order_relaxed);
+
+            return index;
+        }
+
+        void BitmapAllocator::Free(uint32_t first, uint32_t count)
+        {
+            ASSERT(words_);
+            ASSERT(count > 0);
+            ASSERT(first < capacity_ && count <= capacity_ - first);
+
+            releaseRange(first, count);
+            allocated_.fetch_sub(count, std::memory_order_relaxed);
+        }
+
+        uint32_t BitmapAllocator::allocateInWords(uint32_t count)
+        {
+            const uint32_t start = searchStart_.load(std::memory_order_relaxed);
+
+            for (uint32_t i = 0; i < summaryCount_; i++)
+            {
+                const uint32_t summary = (start + i) % summaryCount_;
+                uint64_t candidates = summary_[summary].load();
+
+                while (candidates)
+                {
+                    const uint32_t word = summary * WordBits + countTrailingZeros(candidates);
+                    candidates &= candidates - 1;
+
+                    uint64_t value = words_[word].load(std::memory_order_relaxed);
+                    while (const uint64_t runs = findRuns(~value, count))
+                    {
+                        const uint32_t bit = countTrailingZeros(runs);
+                        const uint64_t claimed = value | getRunMask(bit, count);
+
+                        // Failed exchange reloads value and the word is searched again.
+                        if (!words_[word].compare_exchange_weak(value, claimed, std::memory_order_acquire, std::memory_order_relaxed))
+                            continue;
+
+                        if (summary != start)
+                            searchStart_.store(summary, std::memory_order_relaxed);
+
+                        if (claimed == FullWord)
+                            markFull(word);
+
+                        return word * WordBits + bit;
+                    }
+
+                    // Summary bit is stale, e.g. the word was filled by spanning allocation.
+                    if (value == FullWord)
+                        markFull(word);
+                }
+            }
+
+            return InvalidIndex;
+        }
+
+        uint32_t BitmapAllocator::allocateSpanning(uint32_t count)
+        {
+            // Free run is tracked from trailing free bits of one word through fully free words to leading free bits of another.
+            uint32_t runStart = 0;
+            uint32_t runLength = 0;
+
+            for (uint32_t word = 0; word < wordsCount_; word++)
+            {
+                const uint64_t value = words_[word].load(std::memory_order_relaxed);
+
+                if (value == 0)
+                {
+                    if (runLength == 0)
+                        runStart = word * WordBits;
+
+                    runLength += WordBits;
+                }
+                else
+                {
+                    const uint32_t leadingFree = countTrailingZeros(value);
+
+                    if (runLength == 0)
+                        runStart = word * WordBits;
+
+                    runLength += leadingFree;
+
+                    if (runLength < count)
+                    {
+                        const uint32_t trailingFree = countLeadingZeros(value);
+
+                        runStart = (word + 1) * WordBits - trailingFree;
+                        runLength = trailingFree;
+                    }
+                }
+
+                if (runLength < count)
+                    continue;
+
+                if (tryClaimRange(runStart, count))
+                    return runStart;
+
+                // Range was taken meanwhile, search goes on past the conflict.
+                runLength = 0;
+            }
+
+            return InvalidIndex;
+        }
+
+        bool BitmapAllocator::tryClaim(uint32_t word, uint64_t mask)
+        {
+            uint64_t value = words_[word].load(std::memory_order_relaxed);
+
+            while ((value & mask) == 0)
+            {
+                if (!words_[word].compare_exchange_weak(value, value | mask, std::memory_order_acquire, std::memory_order_relaxed))
+                    continue;
+
+                if ((value | mask) == FullWord)
+                    markFull(word);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void BitmapAllocator::release(uint32_t word, uint64_t mask)
+        {
+            [[maybe_unused]] const uint64_t previous = words_[word].fetch_and(~mask, std::memory_order_release);
+            ASSERT_MSG((previous & mask) == mask, "Index is freed twice");
+
+            summary_[word / WordBits].fetch_or(uint64_t(1) << (word % WordBits));
+        }
+
+        void BitmapAllocator::markFull(uint32_t word)
+        {
+            const uint64_t summaryBit = uint64_t(1) << (word % WordBits);
+            auto& summary = summary_[word / WordBits];
+
+            // Summary bit is cleared before the word is checked again, so bits freed by concurrent release are never hidden.
+            summary.fetch_and(~summaryBit);
+
+            if (words_[word].load() != FullWord)
+                summary.fetch_or(summaryBit);
+        }
+
+        bool BitmapAllocator::tryClaimRange(uint32_t first, uint32_t count)
+        {
+            const uint32_t end = first + count;
+
+            for (uint32_t index = first; index < end;)
+            {
+                const uint32_t bit = index % WordBits;
+                const uint32_t length = std::min(WordBits - bit, end - index);
+
+                if (!tryClaim(index / WordBits, getRunMask(bit, length)))
+                {
+                    if (index != first)
+                        releaseRange(first, index - first);
+
+                    return false;
+                }
+
+                index += length;
+            }
+
+            return true;
+        }
+
+        void BitmapAllocator::releaseRange(uint32_t first, uint32_t count)
+        {
+            const uint32_t end = first + count;
+
+            for (uint32_t index = first; index < end;)
+            {
+                const uint32_t bit = index % WordBits;
+                const uint32_t length = std::min(WordBits - bit, end - index);
+
+                release(index / WordBits, getRunMask(bit, length));
+                index += length;
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace RR
+{
+    namespace Common
+    {
+        // Lock-free allocator of indices in [0, capacity), e.g. descriptor heap slots. Every index is a bit of 64-bit words,
+        // set bits are allocated. Summary level keeps a bit per word that might have free bits, so search skips 64 full
+        // words at once and picks free bits with trailing zero count. Single and contiguous allocations are O(1) amortized
+        // while the bitmap isn't close to full, metadata is a bit per index and a bit per 64 indices.
+        class BitmapAllocator final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+            BitmapAllocator() = default;
+
+            void Init(uint32_t capacity);
+
+            // First of count contiguous indices, InvalidIndex when there is no free range that long.
+            uint32_t Allocate(uint32_t count = 1);
+            void Free(uint32_t first, uint32_t count = 1);
+
+            uint32_t GetCapacity() const { return capacity_; }
+            uint32_t GetAllocatedCount() const { return allocated_.load(std::memory_order_relaxed); }
+
+        private:
+            static constexpr uint32_t WordBits = 64;
+            static constexpr uint64_t FullWord = ~uint64_t(0);
+
+            // Range within single word, found with bit tricks on one value.
+            uint32_t allocateInWords(uint32_t count);
+            // Range crossing word boundaries, words are claimed one by one and rolled back on conflict.
+            uint32_t allocateSpanning(uint32_t count);
+
+            bool tryClaim(uint32_t word, uint64_t mask);
+            void release(uint32_t word, uint64_t mask);
+            // Word had its last free bit claimed, summary stops pointing to it.
+            void markFull(uint32_t word);
+            bool tryClaimRange(uint32_t first, uint32_t count);
+            void releaseRange(uint32_t first, uint32_t count);
+
+        private:
+            uint32_t capacity_ = 0;
+            uint32_t wordsCount_ = 0;
+            uint32_t summaryCount_ = 0;
+            std::unique_ptr<std::atomic<uint64_t>[]> words_;
+            std::unique_ptr<std::atomic<uint64_t>[]> summary_;
+            std::atomic<uint32_t> allocated_ = 0;
+            // Summary word of the last single word allocation, next search starts there.
+            std::atomic<uint32_t> searchStart_ = 0;
+        };
+    }
+}
@@ -1,84 +1,130 @@
 #pragma once
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace RR
 {
     namespace Common
     {
+        // Fixed capacity ring with in place construction, items are constructed on push and destroyed on pop.
+        // Running indices are wrapped with a mask, so capacity should be power of two.
+        // Checks are asserts only, callers on hot paths test full() or empty() themselves.
         template <typename T, std::size_t Capacity>
         class CircularBuffer
         {
-            using Pointer = T*;
-
             static_assert(Capacity > 0);
+            static_assert((Capacity & (Capacity - 1)) == 0, "Capacity should be power of two");
 
         public:
-            CircularBuffer() : front_(&buffer_[0]), back_(&buffer_[0]), size_(0) { }
+            CircularBuffer() = default;
+            ~CircularBuffer() { clear(); }
+
+            CircularBuffer(const CircularBuffer& other) noexcept(std::is_nothrow_copy_constructible<T>::value)
+            {
+                for (size_t index = 0; index < other.size(); index++)
+                    emplace_back(other.at(index));
+            }
 
-            inline void push_back(const T& item)
+            CircularBuffer& operator=(const CircularBuffer& other) noexcept(std::is_nothrow_copy_constructible<T>::value)
             {
-                if (full())
-                    throw std::out_of_range("CircularBuffer is full");
+                if (this == &other)
+                    return *this;
+
+                clear();
+                for (size_t index = 0; index < other.size(); index++)
+                    emplace_back(other.at(index));
 
-                *back_ = item;
-                increment(back_);
-                ++size_;
+                return *this;
             }
 
+            inline void push_back(const T& item) noexcept(std::is_nothrow_copy_constructible<T>::value) { emplace_back(item); }
+            inline void push_back(T&& item) noexcept(std::is_nothrow_move_constructible<T>::value) { emplace_back(std::move(item)); }
+
             template <typename... Args>
-            inline void emplace_back(Args&&... args)
+            inline T& emplace_back(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value)
             {
-                push_back(T(std::forward<Args>(args)...));
+                ASSERT(!full());
+
+                T* item = new (slot(tail_)) T(std::forward<Args>(args)...);
+                ++tail_;
+                return *item;
             }
 
-            void pop_front()
+            inline void pop_front() noexcept
             {
-                if (empty())
-                    throw std::out_of_range("CircularBuffer is empty");
+                ASSERT(!empty());
 
-                --size_;
-                increment(front_);
+                front().~T();
+                ++head_;
             }
 
-            T& front()
+            inline void clear() noexcept
             {
-                if (empty())
-                    throw std::out_of_range("CircularBuffer is empty");
-                return *front_;
+                if constexpr (!std::is_trivially_destructible<T>::value)
+                {
+                    while (!empty())
+                        pop_front();
+                }
+
+                head_ = tail_ = 0;
             }
 
-            inline const T& front() const
+            inline T& front() noexcept
             {
-                if (empty())
-                    throw std::out_of_range("CircularBuffer is empty");
-                return *front_;
+                ASSERT(!empty());
+                return *slot(head_);
             }
 
-            inline const T& back() const
+            inline const T& front() const noexcept
             {
-                if (empty())
-                    throw std::out_of_range("CircularBuffer is empty");
-                return *back_;
+                ASSERT(!empty());
+                return *slot(head_);
             }
 
-            inline size_t capacity() const { return Capacity; }
-            inline size_t size() const { return size_; }
-            inline bool empty() const { return size_ == 0; }
-            inline bool full() const { return size_ == Capacity; }
+            inline T& back() noexcept
+            {
+                ASSERT(!empty());
+                return *slot(tail_ - 1);
+            }
 
-        private:
-            void increment(Pointer& ptr)
+            inline const T& back() const noexcept
             {
-                ++ptr;
+                ASSERT(!empty());
+                return *slot(tail_ - 1);
+            }
+
+            // Index from the front.
+            inline T& at(size_t index) noexcept
+            {
+                ASSERT(index < size());
+                return *slot(head_ + index);
+            }
 
-                if (ptr == &buffer_[0] + Capacity)
-                    ptr = &buffer_[0];
+            inline const T& at(size_t index) const noexcept
+            {
+                ASSERT(index < size());
+                return *slot(head_ + index);
             }
 
+            inline size_t capacity() const noexcept { return Capacity; }
+            inline size_t size() const noexcept { return tail_ - head_; }
+            inline bool empty() const noexcept { return tail_ == head_; }
+            inline bool full() const noexcept { return size() == Capacity; }
+
+        private:
+            static constexpr size_t Mask = Capacity - 1;
+
+            inline T* slot(size_t position) noexcept { return std::launder(reinterpret_cast<T*>(&storage_[position & Mask])); }
+            inline const T* slot(size_t position) const noexcept { return std::launder(reinterpret_cast<const T*>(&storage_[position & Mask])); }
+
         private:
-            std::array<T, Capacity> buffer_;
-            Pointer front_;
-            Pointer back_;
-            size_t size_ = 0;
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage_[Capacity];
+            // Running positions, unsigned overflow keeps the difference valid.
+            size_t head_ = 0;
+            size_t tail_ = 0;
         };
     }
-}
\ No newline at end of file
+}
@@ -18,4 +18,16 @@
 #define INLINE inline
 #else
 #define INLINE
-#endif // ENABLE_INLINE
\ No newline at end of file
+#endif // ENABLE_INLINE
+// Vector instruction set used by math types, scalar fallback when none is available.
+#if !defined(DISABLE_SIMD)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SIMD_SSE 1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define SIMD_NEON 1
+#endif
+#endif
+
+// True during constant evaluation, so constexpr math can fall back from SIMD intrinsics to scalar code.
+// Builtin is provided by MSVC, GCC and Clang in C++17 mode as well.
+#define IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
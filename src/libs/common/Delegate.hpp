@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace RR
+{
+    namespace Common
+    {
+        template <typename Signature>
+        class Delegate;
+
+        // Non-owning reference to a function, a bound method or a callable. Two pointers in size, copying
+        // and calling never allocates. Bound object or callable has to outlive the delegate.
+        template <typename R, typename... Args>
+        class Delegate<R(Args...)> final
+        {
+        public:
+            Delegate() = default;
+
+            // Delegate::From<&Function>()
+            template <auto Function>
+            static Delegate From()
+            {
+                return Delegate(nullptr, [](void*, Args... args) -> R { return std::invoke(Function, std::forward<Args>(args)...); });
+            }
+
+            // Delegate::From<&Type::Method>(object)
+            template <auto Method, typename T>
+            static Delegate From(T* object)
+            {
+                ASSERT(object);
+
+                return Delegate(const_cast<std::remove_const_t<T>*>(object), [](void* object, Args... args) -> R {
+                    return std::invoke(Method, static_cast<T*>(object), std::forward<Args>(args)...);
+                });
+            }
+
+            // Callable is referenced, not copied.
+            template <typename F>
+            static Delegate FromCallable(F& callable)
+            {
+                return Delegate(const_cast<std::remove_const_t<F>*>(&callable), [](void* callable, Args... args) -> R {
+                    return (*static_cast<F*>(callable))(std::forward<Args>(args)...);
+                });
+            }
+
+            inline R operator()(Args... args) const
+            {
+                ASSERT(invoke_);
+                return invoke_(object_, std::forward<Args>(args)...);
+            }
+
+            inline explicit operator bool() const { return invoke_ != nullptr; }
+
+            inline bool operator==(const Delegate& other) const { return object_ == other.object_ && invoke_ == other.invoke_; }
+            inline bool operator!=(const Delegate& other) const { return !(*this == other); }
+
+        private:
+            using InvokeFunction = R (*)(void* object, Args... args);
+
+            Delegate(void* object, InvokeFunction invoke) : object_(object), invoke_(invoke) { }
+
+        private:
+            void* object_ = nullptr;
+            InvokeFunction invoke_ = nullptr;
+        };
+    }
+}
@@ -1,62 +1,153 @@
 #pragma once
 
-#include "common/EnumClassOperators.hpp"
-#include <map>
+#include "common/Delegate.hpp"
+
+#include <array>
+#include <vector>
 
 namespace RR
 {
     namespace Common
     {
-        // This class has problems: to unsubscribe need to provide the exact same lamba which we subscribe.
-        // So, we should hold all lambdas for subscribe and unsubscribe.
-        // This class is candidate to remove
-
-        template <typename EventEnumClass>
-        class EventProvider
+        // Identifies subscription. Generation makes handle of unsubscribed slot stale, so it can't remove slot's next owner.
+        struct EventHandle final
         {
-            static_assert(std::is_enum<EventEnumClass>::value, "Must be a scoped enum!");
-            static_assert(!std::is_convertible<EventEnumClass, typename std::underlying_type<EventEnumClass>::type>::value,
-                          "Must be a scoped enum!");
+            static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+            uint32_t index = InvalidIndex;
+            uint32_t generation = 0;
 
+            inline bool IsValid() const { return index != InvalidIndex; }
+        };
+
+        template <typename Signature>
+        class Event;
+
+        // Flat array of delegates. Subscribe and unsubscribe are O(1), firing walks the array and never allocates.
+        // Not thread safe.
+        template <typename... Args>
+        class Event<void(Args...)> final : private NonCopyable
+        {
         public:
-            using CallBackFunction = std::function<void()>;
+            using DelegateType = Delegate<void(Args...)>;
 
-            void Subscribe(EventEnumClass eventType, CallBackFunction function)
+            EventHandle Subscribe(const DelegateType& delegate)
             {
-                const size_t functionAdress = *reinterpret_cast<size_t*>(reinterpret_cast<char*>(&function));
-                Log::Print::Info("Adresss: %zx \n", functionAdress);
+                ASSERT(delegate);
+
+                uint32_t index;
+                if (!freeSlots_.empty())
+                {
+                    index = freeSlots_.back();
+                    freeSlots_.pop_back();
+                }
+                else
+                {
+                    index = static_cast<uint32_t>(slots_.size());
+                    slots_.emplace_back();
+                }
 
-                eventsCallbacks_.insert(std::make_pair(eventType, function));
+                auto& slot = slots_[index];
+                slot.delegate = delegate;
+                subscribersCount_++;
+
+                return { index, slot.generation };
             }
 
-            void Unsubscribe(EventEnumClass eventType, CallBackFunction function)
+            // Resets handle. Stale and invalid handles are ignored.
+            void Unsubscribe(EventHandle& handle)
             {
-                const size_t functionAdress = *reinterpret_cast<size_t*>(reinterpret_cast<char*>(&function));
-                const auto& subscribers = eventsCallbacks_.equal_range(eventType);
+                if (IsSubscribed(handle))
+                {
+                    auto& slot = slots_[handle.index];
+                    slot.delegate = {};
+                    slot.generation++;
 
-                Log::Print::Info("Adresss: %zx \n", functionAdress);
+                    freeSlots_.push_back(handle.index);
+                    subscribersCount_--;
+                }
+
+                handle = {};
+            }
 
-                for (auto it = subscribers.first; it != subscribers.second; it++)
+            inline bool IsSubscribed(const EventHandle& handle) const
+            {
+                return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation && slots_[handle.index].delegate;
+            }
+
+            // Subscribers may unsubscribe themselves or others while event is fired.
+            // Subscription made during firing may reuse freed slot and be called by the same Fire.
+            void Fire(Args... args) const
+            {
+                const auto size = slots_.size();
+                for (size_t index = 0; index < size; index++)
                 {
-                    const size_t subscriberAdress = *reinterpret_cast<long*>(reinterpret_cast<char*>(&(*it)));
-                    if (subscriberAdress == functionAdress)
-                        eventsCallbacks_.erase(it);
+                    // Copy, vector can reallocate if handler subscribes.
+                    const auto delegate = slots_[index].delegate;
+                    if (delegate)
+                        delegate(args...);
                 }
             }
 
+            inline size_t GetSubscribersCount() const { return subscribersCount_; }
+
+        private:
+            struct Slot
+            {
+                DelegateType delegate;
+                uint32_t generation = 0;
+            };
+
+            std::vector<Slot> slots_;
+            std::vector<uint32_t> freeSlots_;
+            size_t subscribersCount_ = 0;
+        };
+
+        // Event per value of scoped enum, the enum has to end with Count.
+        template <typename EventEnumClass, typename Signature = void()>
+        class EventProvider;
+
+        template <typename EventEnumClass, typename... Args>
+        class EventProvider<EventEnumClass, void(Args...)>
+        {
+            static_assert(std::is_enum<EventEnumClass>::value, "Must be a scoped enum!");
+            static_assert(!std::is_convertible<EventEnumClass, typename std::underlying_type<EventEnumClass>::type>::value,
+                          "Must be a scoped enum!");
+
+        public:
+            using EventType = Event<void(Args...)>;
+
+            EventHandle Subscribe(EventEnumClass eventType, const typename EventType::DelegateType& delegate)
+            {
+                return getEvent(eventType).Subscribe(delegate);
+            }
+
+            void Unsubscribe(EventEnumClass eventType, EventHandle& handle)
+            {
+                getEvent(eventType).Unsubscribe(handle);
+            }
+
         protected:
-            void FireEvent(EventEnumClass eventType)
+            void FireEvent(EventEnumClass eventType, Args... args) const
             {
-                const auto& equalRange = eventsCallbacks_.equal_range(eventType);
+                getEvent(eventType).Fire(args...);
+            }
 
-                for (auto it = equalRange.first; it != equalRange.second; it++)
-                {
-                    //it.second->();
-                }
+        private:
+            inline EventType& getEvent(EventEnumClass eventType)
+            {
+                ASSERT(eventType < EventEnumClass::Count);
+                return events_[static_cast<size_t>(eventType)];
+            }
+
+            inline const EventType& getEvent(EventEnumClass eventType) const
+            {
+                ASSERT(eventType < EventEnumClass::Count);
+                return events_[static_cast<size_t>(eventType)];
             }
 
         private:
-            std::multimap<EventEnumClass, CallBackFunction> eventsCallbacks_;
+            std::array<EventType, static_cast<size_t>(EventEnumClass::Count)> events_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,376 @@
+#pragma once
+
+#include "common/Simd.hpp"
+
+#include <cfloat>
+#include <cstring>
+
+namespace RR
+{
+    namespace Common
+    {
+        // Polynomial approximations for shader like CPU code: culling, animation and particles setup.
+        // Every function takes float or Simd::Float4, so SoA batches go through lanes of the same code.
+        // Precision is selected per call site, error bounds are documented next to every function.
+        namespace FastMath
+        {
+            enum class Precision
+            {
+                // Enough for visibility, LOD and effects, errors stay around 1e-4.
+                Low,
+                // Errors around 1e-6, close to float precision for arguments of the documented range.
+                Medium,
+                // Standard library, evaluated per lane for Simd::Float4.
+                Exact
+            };
+
+            namespace Details
+            {
+                constexpr float Pi = 3.14159265358979323846f;
+                constexpr float HalfPi = Pi / 2.0f;
+                constexpr float TwoOverPi = 2.0f / Pi;
+                // Pi / 2 split for Cody-Waite reduction, high part has 8 significant bits.
+                constexpr float HalfPiHigh = 1.5703125f;
+                constexpr float HalfPiLow = 4.83826794897e-4f;
+                constexpr float Sqrt2 = 1.41421356237f;
+                constexpr float Log2E = 1.44269504089f;
+                constexpr float Ln2 = 0.69314718056f;
+
+                inline uint32_t asUint(float value)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    return bits;
+                }
+
+                inline float asFloat(uint32_t bits)
+                {
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+
+                // Scalar counterparts of Simd functions, so approximations are written once for both types.
+                using Simd::Abs;
+                using Simd::Add;
+                using Simd::CopySign;
+                using Simd::Div;
+                using Simd::Exponent;
+                using Simd::Floor;
+                using Simd::Less;
+                using Simd::Mantissa;
+                using Simd::Max;
+                using Simd::Min;
+                using Simd::Mul;
+                using Simd::MulAdd;
+                using Simd::Pow2;
+                using Simd::RsqrtEstimate;
+                using Simd::Select;
+                using Simd::Sqrt;
+                using Simd::Sub;
+
+                inline float Abs(float a) { return std::abs(a); }
+                inline float Add(float a, float b) { return a + b; }
+                inline float CopySign(float a, float b) { return std::copysign(a, b); }
+                inline float Div(float a, float b) { return a / b; }
+                inline float Floor(float a) { return std::floor(a); }
+                inline bool Less(float a, float b) { return a < b; }
+                inline float Max(float a, float b) { return std::max(a, b); }
+                inline float Min(float a, float b) { return std::min(a, b); }
+                inline float Mul(float a, float b) { return a * b; }
+                inline float MulAdd(float a, float b, float c) { return a * b + c; }
+                inline float Select(bool mask, float a, float b) { return mask ? a : b; }
+                inline float Sqrt(float a) { return std::sqrt(a); }
+                inline float Sub(float a, float b) { return a - b; }
+
+                // Relative error below 3.5e-2.
+                inline float RsqrtEstimate(float a) { return asFloat(0x5F375A86 - (asUint(a) >> 1)); }
+                inline float Pow2(float n) { return asFloat(static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23); }
+                inline float Exponent(float a) { return static_cast<float>(static_cast<int32_t>(asUint(a) >> 23) - 127); }
+                inline float Mantissa(float a) { return asFloat((asUint(a) & 0x007FFFFF) | 0x3F800000); }
+
+                template <typename T>
+                T splat(float value);
+
+                template <>
+                inline float splat<float>(float value) { return value; }
+
+                template <>
+                inline Simd::Float4 splat<Simd::Float4>(float value) { return Simd::Splat(value); }
+
+                template <typename Function>
+                float perLane(float a, Function function) { return function(a); }
+
+                template <typename Function>
+                Simd::Float4 perLane(Simd::Float4 a, Function function)
+                {
+                    alignas(16) float lanes[4];
+                    Simd::StoreAligned(lanes, a);
+
+                    for (float& lane : lanes)
+                        lane = function(lane);
+
+                    return Simd::LoadAligned(lanes);
+                }
+
+                template <typename Function>
+                float perLane(float a, float b, Function function) { return function(a, b); }
+
+                template <typename Function>
+                Simd::Float4 perLane(Simd::Float4 a, Simd::Float4 b, Function function)
+                {
+                    alignas(16) float lanesA[4];
+                    alignas(16) float lanesB[4];
+                    Simd::StoreAligned(lanesA, a);
+                    Simd::StoreAligned(lanesB, b);
+
+                    for (int index = 0; index < 4; index++)
+                        lanesA[index] = function(lanesA[index], lanesB[index]);
+
+                    return Simd::LoadAligned(lanesA);
+                }
+
+                template <typename T>
+                T negate(T a) { return Sub(splat<T>(0.0f), a); }
+
+                template <Precision P, typename T>
+                T rsqrt(T x)
+                {
+                    if constexpr (P == Precision::Exact)
+                        return Div(splat<T>(1.0f), Sqrt(x));
+                    else
+                    {
+                        // Newton step squares relative error: y * (1.5 - 0.5 * x * y * y).
+                        const T halfX = Mul(x, splat<T>(0.5f));
+                        const auto refine = [&halfX](T y) { return Mul(y, Sub(splat<T>(1.5f), Mul(halfX, Mul(y, y)))); };
+
+                        T y = refine(RsqrtEstimate(x));
+                        if constexpr (P == Precision::Medium)
+                            y = refine(y);
+
+                        return y;
+                    }
+                }
+
+                template <Precision P, typename T>
+                void sinCos(T x, T& sine, T& cosine)
+                {
+                    // Quadrant q = round(x * 2 / pi), remainder r = x - q * pi / 2 is in [-pi / 4, pi / 4].
+                    // High part of pi / 2 has few bits, so q * HalfPiHigh and the first subtraction are exact for |x| below 1e5.
+                    const T quadrant = Floor(MulAdd(x, splat<T>(TwoOverPi), splat<T>(0.5f)));
+                    const T r = Sub(Sub(x, Mul(quadrant, splat<T>(HalfPiHigh))), Mul(quadrant, splat<T>(HalfPiLow)));
+                    const T z = Mul(r, r);
+
+                    // Least squares fits on Chebyshev nodes over [-pi / 4, pi / 4].
+                    T s, c;
+                    const T cosHead = MulAdd(z, splat<T>(-0.5f), splat<T>(1.0f));
+                    if constexpr (P == Precision::Low)
+                    {
+                        s = MulAdd(Mul(r, z), splat<T>(-0.16225884f), r);
+                        c = MulAdd(Mul(z, z), splat<T>(0.040908398f), cosHead);
+                    }
+                    else
+                    {
+                        s = MulAdd(Mul(r, z), MulAdd(z, splat<T>(0.0081529793f), splat<T>(-0.16662833f)), r);
+                        c = MulAdd(Mul(z, z), MulAdd(z, splat<T>(-0.0013652432f), splat<T>(0.041661278f)), cosHead);
+                    }
+
+                    // Odd quadrants swap sin and cos, quadrants 2 and 3 negate sin, quadrants 1 and 2 negate cos.
+                    const T half = Floor(Mul(quadrant, splat<T>(0.5f)));
+                    const T odd = Sub(quadrant, Add(half, half));
+                    const T upper = Sub(half, Mul(Floor(Mul(half, splat<T>(0.5f))), splat<T>(2.0f)));
+
+                    const auto isOdd = Less(splat<T>(0.5f), odd);
+                    const T sinQuadrant = Select(isOdd, c, s);
+                    const T cosQuadrant = Select(isOdd, s, c);
+
+                    sine = Select(Less(splat<T>(0.5f), upper), negate(sinQuadrant), sinQuadrant);
+                    cosine = Select(Less(splat<T>(0.5f), Abs(Sub(upper, odd))), negate(cosQuadrant), cosQuadrant);
+                }
+
+                template <Precision P, typename T>
+                T atan2(T y, T x)
+                {
+                    // Argument of the polynomial is in [0, 1], octant is restored afterwards.
+                    const T absX = Abs(x);
+                    const T absY = Abs(y);
+                    const auto isSteep = Less(absX, absY);
+                    const T numerator = Select(isSteep, absX, absY);
+                    // Zero vector gives zero instead of NaN.
+                    const T denominator = Max(Select(isSteep, absY, absX), splat<T>(FLT_MIN));
+
+                    const T t = Div(numerator, denominator);
+                    const T z = Mul(t, t);
+
+                    // Abramowitz and Stegun 4.4.47 and 4.4.49.
+                    T series;
+                    if constexpr (P == Precision::Low)
+                    {
+                        series = MulAdd(z, splat<T>(0.0208351f), splat<T>(-0.0851330f));
+                        series = MulAdd(z, series, splat<T>(0.1801410f));
+                        series = MulAdd(z, series, splat<T>(-0.3302995f));
+                        series = MulAdd(z, series, splat<T>(0.9998660f));
+                    }
+                    else
+                    {
+                        series = MulAdd(z, splat<T>(-0.0040540580f), splat<T>(0.0218612288f));
+                        series = MulAdd(z, series, splat<T>(-0.0559098861f));
+                        series = MulAdd(z, series, splat<T>(0.0964200441f));
+                        series = MulAdd(z, series, splat<T>(-0.1390853351f));
+                        series = MulAdd(z, series, splat<T>(0.1994653599f));
+                        series = MulAdd(z, series, splat<T>(-0.3332985605f));
+                        series = MulAdd(z, series, splat<T>(0.9999993329f));
+                    }
+
+                    T angle = Mul(t, series);
+                    angle = Select(isSteep, Sub(splat<T>(HalfPi), angle), angle);
+                    angle = Select(Less(x, splat<T>(0.0f)), Sub(splat<T>(Pi), angle), angle);
+
+                    return CopySign(angle, y);
+                }
+
+                template <Precision P, typename T>
+                T exp2(T x)
+                {
+                    // Integral part should stay within normal exponents.
+                    x = Min(Max(x, splat<T>(-126.0f)), splat<T>(127.99999f));
+
+                    const T integral = Floor(x);
+                    const T f = Sub(x, integral);
+
+                    // Least squares fits of 2^f on Chebyshev nodes over [0, 1], weighted for relative error.
+                    T series;
+                    if constexpr (P == Precision::Low)
+                    {
+                        series = MulAdd(f, splat<T>(0.077067364f), splat<T>(0.22764445f));
+                        series = MulAdd(f, series, splat<T>(0.69511700f));
+                    }
+                    else
+                    {
+                        series = MulAdd(f, splat<T>(0.0018671355f), splat<T>(0.0090170154f));
+                        series = MulAdd(f, series, splat<T>(0.055799928f));
+                        series = MulAdd(f, series, splat<T>(0.24016444f));
+                        series = MulAdd(f, series, splat<T>(0.69315131f));
+                    }
+
+                    return Mul(MulAdd(f, series, splat<T>(1.0f)), Pow2(integral));
+                }
+
+                template <Precision P, typename T>
+                T log2(T x)
+                {
+                    T exponent = Exponent(x);
+                    T mantissa = Mantissa(x);
+
+                    // Mantissa is moved into [sqrt(0.5), sqrt(2)), so series argument stays below 0.172.
+                    const auto isLarge = Less(splat<T>(Sqrt2), mantissa);
+                    mantissa = Select(isLarge, Mul(mantissa, splat<T>(0.5f)), mantissa);
+                    exponent = Select(isLarge, Add(exponent, splat<T>(1.0f)), exponent);
+
+                    // ln(m) = 2 * atanh(u) = 2 * (u + u^3 / 3 + u^5 / 5 + ...), where u = (m - 1) / (m + 1).
+                    const T u = Div(Sub(mantissa, splat<T>(1.0f)), Add(mantissa, splat<T>(1.0f)));
+                    const T z = Mul(u, u);
+
+                    T series;
+                    if constexpr (P == Precision::Low)
+                        series = MulAdd(z, splat<T>(1.0f / 3.0f), splat<T>(1.0f));
+                    else
+                    {
+                        series = MulAdd(z, splat<T>(1.0f / 9.0f), splat<T>(1.0f / 7.0f));
+                        series = MulAdd(z, series, splat<T>(1.0f / 5.0f));
+                        series = MulAdd(z, series, splat<T>(1.0f / 3.0f));
+                        series = MulAdd(z, series, splat<T>(1.0f));
+                    }
+
+                    return MulAdd(Mul(u, series), splat<T>(2.0f * Log2E), exponent);
+                }
+            }
+
+            // Positive normal x. Relative error: Low 2e-3, Medium 5e-6.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Rsqrt(T x)
+            {
+                return Details::rsqrt<P>(x);
+            }
+
+            // Absolute error for |x| below 1e4: Low 5e-4, Medium 2e-6.
+            template <Precision P = Precision::Medium, typename T>
+            inline void SinCos(T x, T& sine, T& cosine)
+            {
+                if constexpr (P == Precision::Exact)
+                {
+                    sine = Details::perLane(x, [](float lane) { return std::sin(lane); });
+                    cosine = Details::perLane(x, [](float lane) { return std::cos(lane); });
+                }
+                else
+                    Details::sinCos<P>(x, sine, cosine);
+            }
+
+            template <Precision P = Precision::Medium, typename T>
+            inline T Sin(T x)
+            {
+                T sine, cosine;
+                SinCos<P>(x, sine, cosine);
+                return sine;
+            }
+
+            template <Precision P = Precision::Medium, typename T>
+            inline T Cos(T x)
+            {
+                T sine, cosine;
+                SinCos<P>(x, sine, cosine);
+                return cosine;
+            }
+
+            // Absolute error in radians: Low 2e-5, Medium 5e-7. Negative zero x is treated as positive.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Atan2(T y, T x)
+            {
+                if constexpr (P == Precision::Exact)
+                    return Details::perLane(y, x, [](float laneY, float laneX) { return std::atan2(laneY, laneX); });
+                else
+                    return Details::atan2<P>(y, x);
+            }
+
+            // Relative error: Low 1e-4, Medium 5e-7. Results below 2^-126 are flushed to 2^-126.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Exp2(T x)
+            {
+                if constexpr (P == Precision::Exact)
+                    return Details::perLane(x, [](float lane) { return std::exp2(lane); });
+                else
+                    return Details::exp2<P>(x);
+            }
+
+            // As Exp2, rounding of scaled argument adds relative error of about |x| * 6e-8.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Exp(T x)
+            {
+                if constexpr (P == Precision::Exact)
+                    return Details::perLane(x, [](float lane) { return std::exp(lane); });
+                else
+                    return Details::exp2<P>(Details::Mul(x, Details::splat<T>(Details::Log2E)));
+            }
+
+            // Positive normal x. Error relative to max(1, |result|): Low 1e-4, Medium 5e-7.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Log2(T x)
+            {
+                if constexpr (P == Precision::Exact)
+                    return Details::perLane(x, [](float lane) { return std::log2(lane); });
+                else
+                    return Details::log2<P>(x);
+            }
+
+            // As Log2.
+            template <Precision P = Precision::Medium, typename T>
+            inline T Log(T x)
+            {
+                if constexpr (P == Precision::Exact)
+                    return Details::perLane(x, [](float lane) { return std::log(lane); });
+                else
+                    return Details::Mul(Details::log2<P>(x), Details::splat<T>(Details::Ln2));
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace RR
+{
+    namespace Common
+    {
+        // Index of pool slot and its generation. Tag makes handles of different pools incompatible.
+        template <typename Tag>
+        struct Handle final
+        {
+            static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+            uint32_t index = InvalidIndex;
+            uint32_t generation = 0;
+
+            inline bool IsValid() const { return index != InvalidIndex; }
+
+            inline bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+            inline bool operator!=(const Handle& other) const { return !(*this == other); }
+        };
+
+        // Objects stored inline in fixed size chunks, so they never move and are resolved without locks.
+        // Release bumps slot generation, stale handles resolve to nullptr until the generation wraps.
+        // Emplace and Release are thread safe, object released concurrently with Get is caller's bug.
+        template <typename HandleType, typename T, uint32_t ChunkSize = 256, uint32_t MaxChunks = 256>
+        class HandlePool final : private NonCopyable, NonMovable
+        {
+        public:
+            static constexpr uint32_t Capacity = ChunkSize * MaxChunks;
+
+            HandlePool() = default;
+
+            ~HandlePool()
+            {
+                for (uint32_t chunkIndex = 0; chunkIndex < chunksCount_; chunkIndex++)
+                {
+                    auto* chunk = chunks_[chunkIndex].load(std::memory_order_relaxed);
+
+                    for (uint32_t index = 0; index < ChunkSize; index++)
+                        if (chunk[index].alive)
+                            chunk[index].get()->~T();
+
+                    delete[] chunk;
+                }
+            }
+
+            // Returns invalid handle once pool is out of slots.
+            template <typename... Args>
+            HandleType Emplace(Args&&... args)
+            {
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                if (freeHead_ == HandleType::InvalidIndex && !grow())
+                    return {};
+
+                const auto index = freeHead_;
+                auto& slot = getSlot(index);
+                freeHead_ = slot.nextFree;
+
+                new (slot.storage) T(std::forward<Args>(args)...);
+                slot.alive = true;
+                size_++;
+
+                return { index, slot.generation.load(std::memory_order_relaxed) };
+            }
+
+            // Resets handle. Stale and invalid handles are ignored.
+            void Release(HandleType& handle)
+            {
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                if (!isAlive(handle))
+                    return;
+
+                auto& slot = getSlot(handle.index);
+                slot.get()->~T();
+                slot.alive = false;
+                slot.generation.fetch_add(1, std::memory_order_release);
+                slot.nextFree = freeHead_;
+                freeHead_ = handle.index;
+                size_--;
+
+                handle = {};
+            }
+
+            inline T* Get(const HandleType& handle) { return isAlive(handle) ? getSlot(handle.index).get() : nullptr; }
+            inline const T* Get(const HandleType& handle) const { return isAlive(handle) ? getSlot(handle.index).get() : nullptr; }
+
+            inline bool IsAlive(const HandleType& handle) const { return isAlive(handle); }
+            inline size_t GetSize() const { return size_; }
+
+        private:
+            struct Slot
+            {
+                inline T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+
+                alignas(T) std::byte storage[sizeof(T)];
+                std::atomic<uint32_t> generation = 0;
+                uint32_t nextFree = HandleType::InvalidIndex;
+                bool alive = false;
+            };
+
+            inline Slot& getSlot(uint32_t index) const
+            {
+                return chunks_[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+            }
+
+            bool isAlive(const HandleType& handle) const
+            {
+                if (!handle.IsValid() || handle.index / ChunkSize >= MaxChunks)
+                    return false;
+
+                const auto* chunk = chunks_[handle.index / ChunkSize].load(std::memory_order_acquire);
+                return chunk && chunk[handle.index % ChunkSize].generation.load(std::memory_order_acquire) == handle.generation;
+            }
+
+            bool grow()
+            {
+                if (chunksCount_ == MaxChunks)
+                    return false;
+
+                auto* chunk = new Slot[ChunkSize];
+                const auto firstIndex = chunksCount_ * ChunkSize;
+
+                for (uint32_t index = 0; index < ChunkSize; index++)
+                    chunk[index].nextFree = index + 1 < ChunkSize ? firstIndex + index + 1 : HandleType::InvalidIndex;
+
+                chunks_[chunksCount_++].store(chunk, std::memory_order_release);
+                freeHead_ = firstIndex;
+
+                return true;
+            }
+
+        private:
+            std::array<std::atomic<Slot*>, MaxChunks> chunks_ = {};
+            uint32_t chunksCount_ = 0;
+            uint32_t freeHead_ = HandleType::InvalidIndex;
+            std::atomic<size_t> size_ = 0;
+            mutable Threading::SpinLock spinlock_;
+        };
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace RR
+{
+    namespace Common
+    {
+        template <typename Signature, size_t Capacity>
+        class InplaceFunction;
+
+        // Move-only std::function replacement. Callable is stored inline and never allocates,
+        // captures over Capacity bytes rejected at compile time.
+        template <typename R, typename... Args, size_t Capacity>
+        class InplaceFunction<R(Args...), Capacity> final
+        {
+        public:
+            InplaceFunction() = default;
+            ~InplaceFunction() { reset(); }
+
+            template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InplaceFunction>::value>>
+            InplaceFunction(F&& function)
+            {
+                using Callable = std::decay_t<F>;
+
+                static_assert(sizeof(Callable) <= Capacity, "Callable captures exceed InplaceFunction capacity");
+                static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is overaligned");
+                static_assert(std::is_nothrow_move_constructible<Callable>::value, "Callable should be nothrow movable");
+
+                new (&storage_) Callable(std::forward<F>(function));
+                vtable_ = &VTableFor<Callable>;
+            }
+
+            InplaceFunction(InplaceFunction&& other) noexcept { moveFrom(other); }
+            InplaceFunction(const InplaceFunction&) = delete;
+
+            InplaceFunction& operator=(InplaceFunction&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    moveFrom(other);
+                }
+
+                return *this;
+            }
+            InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+            inline R operator()(Args... args) const
+            {
+                ASSERT(vtable_);
+                return vtable_->invoke(&storage_, std::forward<Args>(args)...);
+            }
+
+            inline explicit operator bool() const { return vtable_ != nullptr; }
+
+        private:
+            struct VTable
+            {
+                R (*invoke)(void* storage, Args&&... args);
+                void (*move)(void* dest, void* source);
+                void (*destroy)(void* storage);
+            };
+
+            template <typename Callable>
+            static constexpr VTable VTableFor = {
+                [](void* storage, Args&&... args) -> R { return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...); },
+                [](void* dest, void* source) { new (dest) Callable(std::move(*static_cast<Callable*>(source))); },
+                [](void* storage) { static_cast<Callable*>(storage)->~Callable(); }
+            };
+
+            inline void moveFrom(InplaceFunction& other)
+            {
+                if (!other.vtable_)
+                    return;
+
+                other.vtable_->move(&storage_, &other.storage_);
+                vtable_ = other.vtable_;
+                other.reset();
+            }
+
+            inline void reset()
+            {
+                if (!vtable_)
+                    return;
+
+                vtable_->destroy(&storage_);
+                vtable_ = nullptr;
+            }
+
+        private:
+            mutable std::aligned_storage_t<Capacity, alignof(std::max_align_t)> storage_;
+            const VTable* vtable_ = nullptr;
+        };
+    }
+}
@@ -1,5 +1,7 @@
 #include "Math.hpp"
 
+#include "common/threading/Parallel.hpp"
+
 namespace RR
 {
     namespace Common
@@ -22,4 +24,204 @@ namespace RR
             c = pi.ToDegree();
         }
     }
-}
\ No newline at end of file
+}
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace
+        {
+            // Groups of TransformBatch::Width transforms, job overhead isn't worth it below that.
+            constexpr size_t MinGroupsPerBatch = 256;
+
+            // Transposes lanes into per object columns and writes count matrices.
+            void storeLanes(Simd::Float4 (&lanes)[4][4], size_t count, Matrix4* matrices)
+            {
+                for (auto& column : lanes)
+                    Simd::Transpose(column[0], column[1], column[2], column[3]);
+
+                Matrix4 group[TransformBatch::Width];
+                Matrix4* dest = count == TransformBatch::Width ? matrices : group;
+
+                for (size_t object = 0; object < TransformBatch::Width; object++)
+                    for (size_t column = 0; column < 4; column++)
+                        Simd::StoreAligned(&dest[object].e00 + column * 4, lanes[column][object]);
+
+                if (dest == group)
+                    std::copy(group, group + count, matrices);
+            }
+        }
+
+        void TransformBatch::Reserve(size_t capacity)
+        {
+            detach();
+            capacity = (capacity + Width - 1) / Width * Width;
+
+            for (auto& component : components_)
+                component.reserve(capacity);
+        }
+
+        void TransformBatch::Clear()
+        {
+            size_ = 0;
+            isAttached_ = false;
+
+            for (auto& component : components_)
+                component.clear();
+        }
+
+        size_t TransformBatch::Add(const Vector<3, float>& position, const Quaternion& rotation, const Vector<3, float>& scale)
+        {
+            detach();
+
+            if (size_ % Width == 0)
+            {
+                const float identity[Component::Count] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+                for (uint32_t index = 0; index < Component::Count; index++)
+                    components_[index].resize(size_ + Width, identity[index]);
+            }
+
+            Set(size_, position, rotation, scale);
+            return size_++;
+        }
+
+        void TransformBatch::Set(size_t index, const Vector<3, float>& position, const Quaternion& rotation, const Vector<3, float>& scale)
+        {
+            detach();
+            ASSERT(index < components_[Component::PositionX].size());
+
+            components_[Component::PositionX][index] = position.x;
+            components_[Component::PositionY][index] = position.y;
+            components_[Component::PositionZ][index] = position.z;
+            components_[Component::RotationX][index] = rotation.x;
+            components_[Component::RotationY][index] = rotation.y;
+            components_[Component::RotationZ][index] = rotation.z;
+            components_[Component::RotationW][index] = rotation.w;
+            components_[Component::ScaleX][index] = scale.x;
+            components_[Component::ScaleY][index] = scale.y;
+            components_[Component::ScaleZ][index] = scale.z;
+        }
+
+        void TransformBatch::Attach(const float* const (&components)[Component::Count], size_t size)
+        {
+            for (uint32_t index = 0; index < Component::Count; index++)
+            {
+                ASSERT(components[index] || size == 0);
+                attached_[index] = components[index];
+                components_[index].clear();
+            }
+
+            size_ = size;
+            isAttached_ = true;
+        }
+
+        void TransformBatch::detach()
+        {
+            if (!isAttached_)
+                return;
+
+            const size_t paddedSize = (size_ + Width - 1) / Width * Width;
+            for (uint32_t index = 0; index < Component::Count; index++)
+                components_[index].assign(attached_[index], attached_[index] + paddedSize);
+
+            isAttached_ = false;
+        }
+
+        void TransformBatch::computeWorldLanes(size_t first, Simd::Float4 (&lanes)[4][4]) const
+        {
+            const auto load = [&](Component component) { return Simd::Load(GetComponent(component) + first); };
+
+            const auto x = load(Component::RotationX);
+            const auto y = load(Component::RotationY);
+            const auto z = load(Component::RotationZ);
+            const auto w = load(Component::RotationW);
+
+            // Same sequence of operations as Matrix4::SetRot.
+            const auto sx = Simd::Mul(x, x);
+            const auto sy = Simd::Mul(y, y);
+            const auto sz = Simd::Mul(z, z);
+            const auto sw = Simd::Mul(w, w);
+            const auto inv = Simd::Div(Simd::Splat(1.0f), Simd::Add(Simd::Add(Simd::Add(sx, sy), sz), sw));
+            const auto inv2 = Simd::Mul(inv, Simd::Splat(2.0f));
+
+            const auto scaleX = load(Component::ScaleX);
+            const auto scaleY = load(Component::ScaleY);
+            const auto scaleZ = load(Component::ScaleZ);
+
+            const auto xy = Simd::Mul(x, y);
+            const auto zw = Simd::Mul(z, w);
+            const auto xz = Simd::Mul(x, z);
+            const auto yw = Simd::Mul(y, w);
+            const auto yz = Simd::Mul(y, z);
+            const auto xw = Simd::Mul(x, w);
+
+            lanes[0][0] = Simd::Mul(Simd::Mul(Simd::Add(Simd::Sub(Simd::Sub(sx, sy), sz), sw), inv), scaleX);
+            lanes[0][1] = Simd::Mul(Simd::Mul(Simd::Add(xy, zw), inv2), scaleX);
+            lanes[0][2] = Simd::Mul(Simd::Mul(Simd::Sub(xz, yw), inv2), scaleX);
+            lanes[0][3] = Simd::Splat(0.0f);
+
+            lanes[1][0] = Simd::Mul(Simd::Mul(Simd::Sub(xy, zw), inv2), scaleY);
+            lanes[1][1] = Simd::Mul(Simd::Mul(Simd::Add(Simd::Sub(Simd::Sub(sy, sx), sz), sw), inv), scaleY);
+            lanes[1][2] = Simd::Mul(Simd::Mul(Simd::Add(yz, xw), inv2), scaleY);
+            lanes[1][3] = Simd::Splat(0.0f);
+
+            lanes[2][0] = Simd::Mul(Simd::Mul(Simd::Add(xz, yw), inv2), scaleZ);
+            lanes[2][1] = Simd::Mul(Simd::Mul(Simd::Sub(yz, xw), inv2), scaleZ);
+            lanes[2][2] = Simd::Mul(Simd::Mul(Simd::Add(Simd::Sub(sz, Simd::Add(sx, sy)), sw), inv), scaleZ);
+            lanes[2][3] = Simd::Splat(0.0f);
+
+            lanes[3][0] = load(Component::PositionX);
+            lanes[3][1] = load(Component::PositionY);
+            lanes[3][2] = load(Component::PositionZ);
+            lanes[3][3] = Simd::Splat(1.0f);
+        }
+
+        void TransformBatch::ComputeWorldMatrices(Matrix4* worldMatrices) const
+        {
+            ASSERT(worldMatrices || size_ == 0);
+
+            const size_t groupsCount = (size_ + Width - 1) / Width;
+            Threading::ParallelFor(0, groupsCount, MinGroupsPerBatch, [this, worldMatrices](size_t firstGroup, size_t lastGroup) {
+                for (size_t first = firstGroup * Width; first < lastGroup * Width; first += Width)
+                {
+                    Simd::Float4 lanes[4][4];
+                    computeWorldLanes(first, lanes);
+                    storeLanes(lanes, Min(Width, size_ - first), worldMatrices + first);
+                }
+            });
+        }
+
+        void TransformBatch::ComputeWorldViewProjectionMatrices(const Matrix4& viewProjection, Matrix4* matrices) const
+        {
+            ASSERT(matrices || size_ == 0);
+
+            Simd::Float4 viewProjectionLanes[4][4];
+            for (size_t column = 0; column < 4; column++)
+                for (size_t row = 0; row < 4; row++)
+                    viewProjectionLanes[column][row] = Simd::Splat((&viewProjection.e00)[column * 4 + row]);
+
+            const size_t groupsCount = (size_ + Width - 1) / Width;
+            Threading::ParallelFor(0, groupsCount, MinGroupsPerBatch, [this, matrices, &viewProjectionLanes](size_t firstGroup, size_t lastGroup) {
+                for (size_t first = firstGroup * Width; first < lastGroup * Width; first += Width)
+                {
+                    Simd::Float4 world[4][4];
+                    computeWorldLanes(first, world);
+
+                    Simd::Float4 lanes[4][4];
+                    for (size_t column = 0; column < 4; column++)
+                        for (size_t row = 0; row < 4; row++)
+                        {
+                            auto result = Simd::Mul(viewProjectionLanes[0][row], world[column][0]);
+                            result = Simd::MulAdd(viewProjectionLanes[1][row], world[column][1], result);
+                            result = Simd::MulAdd(viewProjectionLanes[2][row], world[column][2], result);
+                            lanes[column][row] = Simd::MulAdd(viewProjectionLanes[3][row], world[column][3], result);
+                        }
+
+                    storeLanes(lanes, Min(Width, size_ - first), matrices + first);
+                }
+            });
+        }
+    }
+}
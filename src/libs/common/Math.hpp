@@ -1,7 +1,12 @@
 #pragma once
 
+#include "common/Simd.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 #if defined(min) | defined(max)
 #undef min
@@ -12,16 +17,16 @@ namespace RR
 {
     namespace Common
     {
-        inline const float EPS = FLT_EPSILON;
-        inline const float INF = INFINITY;
-        inline const float PI = 3.14159265358979323846f;
-        inline const float PI2 = PI * 2.0f;
-        inline const float HALF_PI = PI / 2.0f;
-        inline const float DEG2RAD = PI / 180.0f;
-        inline const float RAD2DEG = 180.0f / PI;
-        inline const float COS30 = 0.86602540378f;
-        inline const float COS45 = 0.70710678118f;
-        inline const float COS60 = 0.50000000000f;
+        inline constexpr float EPS = FLT_EPSILON;
+        inline constexpr float INF = std::numeric_limits<float>::infinity();
+        inline constexpr float PI = 3.14159265358979323846f;
+        inline constexpr float PI2 = PI * 2.0f;
+        inline constexpr float HALF_PI = PI / 2.0f;
+        inline constexpr float DEG2RAD = PI / 180.0f;
+        inline constexpr float RAD2DEG = 180.0f / PI;
+        inline constexpr float COS30 = 0.86602540378f;
+        inline constexpr float COS45 = 0.70710678118f;
+        inline constexpr float COS60 = 0.50000000000f;
 
         template <typename T>
         inline constexpr T Sqr(T x) { return x * x; };
@@ -377,82 +382,82 @@ namespace RR
                     static_cast<U>(y));
             }
 
-            bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y; }
-            bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
-            bool operator==(T s) const { return x == s && y == s; }
-            bool operator!=(T s) const { return !(*this == s); }
-            bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y; }
-            bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y; }
+            constexpr bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y; }
+            constexpr bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
+            constexpr bool operator==(T s) const { return x == s && y == s; }
+            constexpr bool operator!=(T s) const { return !(*this == s); }
+            constexpr bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y; }
+            constexpr bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y; }
 
-            Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y); }
+            constexpr Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y); }
 
-            Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
             {
                 x += v.x;
                 y += v.y;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
             {
                 x -= v.x;
                 y -= v.y;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
             {
                 x *= v.x;
                 y *= v.y;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
             {
                 x /= v.x;
                 y /= v.y;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator+=(T s)
+            constexpr Vector<SIZE, T>& operator+=(T s)
             {
                 x += s;
                 y += s;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(T s)
+            constexpr Vector<SIZE, T>& operator-=(T s)
             {
                 x -= s;
                 y -= s;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(T s)
+            constexpr Vector<SIZE, T>& operator*=(T s)
             {
                 x *= s;
                 y *= s;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(T s)
+            constexpr Vector<SIZE, T>& operator/=(T s)
             {
                 x /= s;
                 y /= s;
                 return *this;
             }
 
-            Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y); }
-            Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y); }
-            Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y); }
-            Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y); }
-            Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s); }
-            Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s); }
-            Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s); }
-            Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s); }
+            constexpr Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y); }
+            constexpr Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y); }
+            constexpr Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y); }
+            constexpr Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y); }
+            constexpr Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s); }
+            constexpr Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s); }
+            constexpr Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s); }
+            constexpr Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s); }
 
-            T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y; }
-            T Cross(const Vector<SIZE, T>& v) const { return x * v.y - y * v.x; }
+            constexpr T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y; }
+            constexpr T Cross(const Vector<SIZE, T>& v) const { return x * v.y - y * v.x; }
             Vector<SIZE, T> Abs() const { return Vector<SIZE, T>(fabsf(x), fabsf(y)); }
 
             Vector<SIZE, T>& Rotate(Radian angle)
@@ -474,7 +479,7 @@ namespace RR
                 return ((T*)this)[index];
             }
 
-            const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
+            constexpr const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
             {
                 if (t <= 0.0f)
                     return *this;
@@ -483,7 +488,7 @@ namespace RR
                 return *this + (v - *this) * t;
             }
 
-            FloatFormat LengthSqr() const { return Dot(*this); }
+            constexpr FloatFormat LengthSqr() const { return Dot(*this); }
 
             FloatFormat Length() const { return sqrtf(LengthSqr()); }
 
@@ -558,16 +563,16 @@ namespace RR
                     static_cast<U>(z), );
             }
 
-            bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y && z == v.z; }
-            bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
-            bool operator==(T s) const { return x == s && y == s && z == s; }
-            bool operator!=(T s) const { return !(*this == s); }
-            bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y && z < v.z; }
-            bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y && z > v.z; }
+            constexpr bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y && z == v.z; }
+            constexpr bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
+            constexpr bool operator==(T s) const { return x == s && y == s && z == s; }
+            constexpr bool operator!=(T s) const { return !(*this == s); }
+            constexpr bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y && z < v.z; }
+            constexpr bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y && z > v.z; }
 
-            Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y, -z); }
+            constexpr Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y, -z); }
 
-            Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
             {
                 x += v.x;
                 y += v.y;
@@ -575,7 +580,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
             {
                 x -= v.x;
                 y -= v.y;
@@ -583,7 +588,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
             {
                 x *= v.x;
                 y *= v.y;
@@ -591,7 +596,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
             {
                 x /= v.x;
                 y /= v.y;
@@ -599,7 +604,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator+=(T s)
+            constexpr Vector<SIZE, T>& operator+=(T s)
             {
                 x += s;
                 y += s;
@@ -607,7 +612,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(T s)
+            constexpr Vector<SIZE, T>& operator-=(T s)
             {
                 x -= s;
                 y -= s;
@@ -615,7 +620,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(T s)
+            constexpr Vector<SIZE, T>& operator*=(T s)
             {
                 x *= s;
                 y *= s;
@@ -623,7 +628,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(T s)
+            constexpr Vector<SIZE, T>& operator/=(T s)
             {
                 x /= s;
                 y /= s;
@@ -631,20 +636,20 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y, z + v.z); }
-            Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y, z - v.z); }
-            Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y, z * v.z); }
-            Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y, z / v.z); }
-            Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s, z + s); }
-            Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s, z - s); }
-            Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s, z * s); }
-            Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s, z / s); }
+            constexpr Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y, z + v.z); }
+            constexpr Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y, z - v.z); }
+            constexpr Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y, z * v.z); }
+            constexpr Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y, z / v.z); }
+            constexpr Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s, z + s); }
+            constexpr Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s, z - s); }
+            constexpr Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s, z * s); }
+            constexpr Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s, z / s); }
 
-            T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y + z * v.z; }
-            Vector<SIZE, T> Cross(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+            constexpr T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y + z * v.z; }
+            constexpr Vector<SIZE, T> Cross(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
             Vector<SIZE, T> Abs() const { return Vector<SIZE, T>(fabsf(x), fabsf(y), fabsf(z)); }
             Vector<SIZE, T> AxisXZ() const { return (fabsf(x) > fabsf(z)) ? Vector<SIZE, T>(float(Sign(x)), 0, 0) : Vector<SIZE, T>(0, 0, float(Sign(z))); }
-            Vector<SIZE, T> Reflect(const Vector<SIZE, T>& n) const { return *this - n * (Dot(n) * 2.0f); }
+            constexpr Vector<SIZE, T> Reflect(const Vector<SIZE, T>& n) const { return *this - n * (Dot(n) * 2.0f); }
 
             const Vector<SIZE, T> RotateY(Radian angle) const
             {
@@ -678,7 +683,7 @@ namespace RR
                 return ((T*)this)[index];
             }
 
-            const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
+            constexpr const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
             {
                 if (t <= 0.0f)
                     return *this;
@@ -687,7 +692,7 @@ namespace RR
                 return *this + (v - *this) * t;
             }
 
-            FloatFormat LengthSqr() const { return Dot(*this); }
+            constexpr FloatFormat LengthSqr() const { return Dot(*this); }
 
             FloatFormat Length() const { return sqrtf(LengthSqr()); }
 
@@ -763,25 +768,25 @@ namespace RR
                     static_cast<U>(w));
             }
 
-            bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y && z == v.z && w == v.w; }
-            bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
-            bool operator==(T s) const { return x == s && y == s && z == s && w == s; }
-            bool operator!=(T s) const { return !(*this == s); }
-            bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y && z < v.z && w < v.w; }
-            bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y && z > v.z && w > v.w; }
+            constexpr bool operator==(const Vector<SIZE, T>& v) const { return x == v.x && y == v.y && z == v.z && w == v.w; }
+            constexpr bool operator!=(const Vector<SIZE, T>& v) const { return !(*this == v); }
+            constexpr bool operator==(T s) const { return x == s && y == s && z == s && w == s; }
+            constexpr bool operator!=(T s) const { return !(*this == s); }
+            constexpr bool operator<(const Vector<SIZE, T>& v) const { return x < v.x && y < v.y && z < v.z && w < v.w; }
+            constexpr bool operator>(const Vector<SIZE, T>& v) const { return x > v.x && y > v.y && z > v.z && w > v.w; }
 
-            Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y, -z, -w); }
+            constexpr Vector<SIZE, T> operator-() const { return Vector<SIZE, T>(-x, -y, -z, -w); }
 
-            Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator+=(const Vector<SIZE, T>& v)
             {
                 x += v.x;
                 y += v.y;
                 z += v.z;
-                w += w.z;
+                w += v.w;
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator-=(const Vector<SIZE, T>& v)
             {
                 x -= v.x;
                 y -= v.y;
@@ -790,7 +795,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator*=(const Vector<SIZE, T>& v)
             {
                 x *= v.x;
                 y *= v.y;
@@ -799,7 +804,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
+            constexpr Vector<SIZE, T>& operator/=(const Vector<SIZE, T>& v)
             {
                 x /= v.x;
                 y /= v.y;
@@ -808,7 +813,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator+=(T s)
+            constexpr Vector<SIZE, T>& operator+=(T s)
             {
                 x += s;
                 y += s;
@@ -817,7 +822,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator-=(T s)
+            constexpr Vector<SIZE, T>& operator-=(T s)
             {
                 x -= s;
                 y -= s;
@@ -826,7 +831,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator*=(T s)
+            constexpr Vector<SIZE, T>& operator*=(T s)
             {
                 x *= s;
                 y *= s;
@@ -835,7 +840,7 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T>& operator/=(T s)
+            constexpr Vector<SIZE, T>& operator/=(T s)
             {
                 x /= s;
                 y /= s;
@@ -844,16 +849,16 @@ namespace RR
                 return *this;
             }
 
-            Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y, z + v.z, w + v.w); }
-            Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y, z - v.z, w - v.w); }
-            Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y, z * v.z, w * v.w); }
-            Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y, z / v.z, w / v.w); }
-            Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s, z + s, w + s); }
-            Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s, z - s, w - s); }
-            Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s, z * s, w * s); }
-            Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s, z / s, w / s); }
+            constexpr Vector<SIZE, T> operator+(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x + v.x, y + v.y, z + v.z, w + v.w); }
+            constexpr Vector<SIZE, T> operator-(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x - v.x, y - v.y, z - v.z, w - v.w); }
+            constexpr Vector<SIZE, T> operator*(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x * v.x, y * v.y, z * v.z, w * v.w); }
+            constexpr Vector<SIZE, T> operator/(const Vector<SIZE, T>& v) const { return Vector<SIZE, T>(x / v.x, y / v.y, z / v.z, w / v.w); }
+            constexpr Vector<SIZE, T> operator+(T s) const { return Vector<SIZE, T>(x + s, y + s, z + s, w + s); }
+            constexpr Vector<SIZE, T> operator-(T s) const { return Vector<SIZE, T>(x - s, y - s, z - s, w - s); }
+            constexpr Vector<SIZE, T> operator*(T s) const { return Vector<SIZE, T>(x * s, y * s, z * s, w * s); }
+            constexpr Vector<SIZE, T> operator/(T s) const { return Vector<SIZE, T>(x / s, y / s, z / s, w / s); }
 
-            T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y + z * v.z + w * v.w; }
+            constexpr T Dot(const Vector<SIZE, T>& v) const { return x * v.x + y * v.y + z * v.z + w * v.w; }
             Vector<SIZE, T> Abs() const { return Vector<SIZE, T>(fabsf(x), fabsf(y), fabsf(z), fabsf(w)); }
 
             // Shared vectors functions
@@ -863,7 +868,7 @@ namespace RR
                 return ((T*)this)[index];
             }
 
-            const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
+            constexpr const Vector<SIZE, T> Lerp(const Vector<SIZE, T>& v, const float t) const
             {
                 if (t <= 0.0f)
                     return *this;
@@ -872,7 +877,7 @@ namespace RR
                 return *this + (v - *this) * t;
             }
 
-            FloatFormat LengthSqr() const { return Dot(*this); }
+            constexpr FloatFormat LengthSqr() const { return Dot(*this); }
 
             FloatFormat Length() const { return sqrtf(LengthSqr()); }
 
@@ -924,7 +929,7 @@ namespace RR
 
             Quaternion() = default;
 
-            Quaternion(FloatFormat x, FloatFormat y, FloatFormat z, FloatFormat w)
+            constexpr Quaternion(FloatFormat x, FloatFormat y, FloatFormat z, FloatFormat w)
                 : x(x), y(y), z(z), w(w)
             {
             }
@@ -1000,27 +1005,27 @@ namespace RR
                 }
             }
 
-            Quaternion operator-() const
+            constexpr Quaternion operator-() const
             {
                 return Quaternion(-x, -y, -z, -w);
             }
 
-            Quaternion operator+(const Quaternion& q) const
+            constexpr Quaternion operator+(const Quaternion& q) const
             {
                 return Quaternion(x + q.x, y + q.y, z + q.z, w + q.w);
             }
 
-            Quaternion operator-(const Quaternion& q) const
+            constexpr Quaternion operator-(const Quaternion& q) const
             {
                 return Quaternion(x - q.x, y - q.y, z - q.z, w - q.w);
             }
 
-            Quaternion operator*(const FloatFormat s) const
+            constexpr Quaternion operator*(const FloatFormat s) const
             {
                 return Quaternion(x * s, y * s, z * s, w * s);
             }
 
-            Quaternion operator*(const Quaternion& q) const
+            constexpr Quaternion operator*(const Quaternion& q) const
             {
                 return Quaternion(w * q.x + x * q.w + y * q.z - z * q.y,
                                   w * q.y + y * q.w + z * q.x - x * q.z,
@@ -1028,18 +1033,19 @@ namespace RR
                                   w * q.w - x * q.x - y * q.y - z * q.z);
             }
 
-            Vector<3, FloatFormat> operator*(const Vector<3, FloatFormat>& v) const
+            constexpr Vector<3, FloatFormat> operator*(const Vector<3, FloatFormat>& v) const
             {
                 //return v + xyz.cross(xyz.cross(v) + v * w) * 2.0f;
-                return (*this * Quaternion(v.x, v.y, v.z, 0) * Inverse()).xyz();
+                const Quaternion rotated = *this * Quaternion(v.x, v.y, v.z, 0) * Inverse();
+                return Vector<3, FloatFormat>(rotated.x, rotated.y, rotated.z);
             }
 
-            float Dot(const Quaternion& q) const
+            constexpr float Dot(const Quaternion& q) const
             {
                 return x * q.x + y * q.y + z * q.z + w * q.w;
             }
 
-            float LengthSqr() const
+            constexpr float LengthSqr() const
             {
                 return Dot(*this);
             }
@@ -1060,12 +1066,12 @@ namespace RR
                 return l == 0.0 ? (*this) : (*this) * (1.0f / l);
             }
 
-            Quaternion Conjugate() const
+            constexpr Quaternion Conjugate() const
             {
                 return Quaternion(-x, -y, -z, w);
             }
 
-            Quaternion Inverse() const
+            constexpr Quaternion Inverse() const
             {
                 const float l2 = LengthSqr();
                 const float l2inv = l2 == 0.0f ? 0.0f : (1.0f / l2);
@@ -1073,7 +1079,7 @@ namespace RR
                 return Conjugate() * l2inv;
             }
 
-            Quaternion Lerp(const Quaternion& q, float t) const
+            constexpr Quaternion Lerp(const Quaternion& q, float t) const
             {
                 if (t <= 0.0f)
                     return *this;
@@ -1128,8 +1134,9 @@ namespace RR
         template <size_t M, size_t K>
         struct Matrix;
 
+        // Columns are stored contiguously and aligned for SIMD loads.
         template <>
-        struct Matrix<4, 4>
+        struct alignas(16) Matrix<4, 4>
         {
             static inline constexpr size_t M = 4;
             static inline constexpr size_t K = 4;
@@ -1153,12 +1160,12 @@ namespace RR
 
             Matrix() = default;
 
-            Matrix(Initialization)
+            constexpr Matrix(Initialization)
+                : e00(1.0f), e10(0.0f), e20(0.0f), e30(0.0f), e01(0.0f), e11(1.0f), e21(0.0f), e31(0.0f), e02(0.0f), e12(0.0f), e22(1.0f), e32(0.0f), e03(0.0f), e13(0.0f), e23(0.0f), e33(1.0f)
             {
-                Identity();
             }
 
-            Matrix(FloatFormat e00, FloatFormat e10, FloatFormat e20, FloatFormat e30,
+            constexpr Matrix(FloatFormat e00, FloatFormat e10, FloatFormat e20, FloatFormat e30,
                    FloatFormat e01, FloatFormat e11, FloatFormat e21, FloatFormat e31,
                    FloatFormat e02, FloatFormat e12, FloatFormat e22, FloatFormat e32,
                    FloatFormat e03, FloatFormat e13, FloatFormat e23, FloatFormat e33)
@@ -1166,17 +1173,16 @@ namespace RR
             {
             }
 
-            Matrix(const Quaternion& rotation, const Vector<3, FloatFormat>& position)
+            constexpr Matrix(const Quaternion& rotation, const Vector<3, FloatFormat>& position)
+                : Matrix(Initialization::Identity)
             {
                 SetRot(rotation);
                 SetPos(position);
-                e30 = e31 = e32 = 0.0f;
-                e33 = 1.0f;
             }
 
-            Matrix(ProjRange range, FloatFormat l, FloatFormat r, FloatFormat b, FloatFormat t, FloatFormat znear, FloatFormat zfar)
+            constexpr Matrix(ProjRange range, FloatFormat l, FloatFormat r, FloatFormat b, FloatFormat t, FloatFormat znear, FloatFormat zfar)
+                : Matrix(Initialization::Identity)
             {
-                Identity();
                 e00 = 2.0f / (r - l);
                 e11 = 2.0f / (t - b);
                 e22 = 2.0f / (znear - zfar);
@@ -1236,77 +1242,74 @@ namespace RR
                 e30 = e31 = e32 = 0;
             }
 
-            Matrix(const Vector<4, FloatFormat>& reflectPlane)
+            constexpr Matrix(const Vector<4, FloatFormat>& reflectPlane)
+                : Matrix(1 - 2 * reflectPlane.x * reflectPlane.x, -2 * reflectPlane.y * reflectPlane.x, -2 * reflectPlane.z * reflectPlane.x, 0,
+                         -2 * reflectPlane.x * reflectPlane.y, 1 - 2 * reflectPlane.y * reflectPlane.y, -2 * reflectPlane.z * reflectPlane.y, 0,
+                         -2 * reflectPlane.x * reflectPlane.z, -2 * reflectPlane.y * reflectPlane.z, 1 - 2 * reflectPlane.z * reflectPlane.z, 0,
+                         -2 * reflectPlane.x * reflectPlane.w, -2 * reflectPlane.y * reflectPlane.w, -2 * reflectPlane.z * reflectPlane.w, 1)
             {
-                FloatFormat a = reflectPlane.x,
-                            b = reflectPlane.y,
-                            c = reflectPlane.z,
-                            d = reflectPlane.w;
-
-                Right() = Vector<3, FloatFormat>(1 - 2 * a * a, -2 * b * a, -2 * c * a);
-                Up() = Vector<3, FloatFormat>(-2 * a * b, 1 - 2 * b * b, -2 * c * b);
-                Forward() = Vector<3, FloatFormat>(-2 * a * c, -2 * b * c, 1 - 2 * c * c);
-                Offset() = Vector<4, FloatFormat>(-2 * a * d, -2 * b * d, -2 * c * d, 1);
-                e30 = e31 = e32 = 0;
             }
 
-            void Identity()
+            constexpr void Identity()
             {
                 e10 = e20 = e30 = e01 = e21 = e31 = e02 = e12 = e32 = e03 = e13 = e23 = 0.0f;
                 e00 = e11 = e22 = e33 = 1.0f;
             }
 
-            Matrix<M, K> operator*(const Matrix<M, K>& m) const
+            // SIMD at runtime, scalar code of same operation order during constant evaluation, so results are equal.
+            constexpr Matrix<M, K> operator*(const Matrix<M, K>& m) const
             {
-                Matrix<M, K> r;
-                r.e00 = e00 * m.e00 + e01 * m.e10 + e02 * m.e20 + e03 * m.e30;
-                r.e10 = e10 * m.e00 + e11 * m.e10 + e12 * m.e20 + e13 * m.e30;
-                r.e20 = e20 * m.e00 + e21 * m.e10 + e22 * m.e20 + e23 * m.e30;
-                r.e30 = e30 * m.e00 + e31 * m.e10 + e32 * m.e20 + e33 * m.e30;
-                r.e01 = e00 * m.e01 + e01 * m.e11 + e02 * m.e21 + e03 * m.e31;
-                r.e11 = e10 * m.e01 + e11 * m.e11 + e12 * m.e21 + e13 * m.e31;
-                r.e21 = e20 * m.e01 + e21 * m.e11 + e22 * m.e21 + e23 * m.e31;
-                r.e31 = e30 * m.e01 + e31 * m.e11 + e32 * m.e21 + e33 * m.e31;
-                r.e02 = e00 * m.e02 + e01 * m.e12 + e02 * m.e22 + e03 * m.e32;
-                r.e12 = e10 * m.e02 + e11 * m.e12 + e12 * m.e22 + e13 * m.e32;
-                r.e22 = e20 * m.e02 + e21 * m.e12 + e22 * m.e22 + e23 * m.e32;
-                r.e32 = e30 * m.e02 + e31 * m.e12 + e32 * m.e22 + e33 * m.e32;
-                r.e03 = e00 * m.e03 + e01 * m.e13 + e02 * m.e23 + e03 * m.e33;
-                r.e13 = e10 * m.e03 + e11 * m.e13 + e12 * m.e23 + e13 * m.e33;
-                r.e23 = e20 * m.e03 + e21 * m.e13 + e22 * m.e23 + e23 * m.e33;
-                r.e33 = e30 * m.e03 + e31 * m.e13 + e32 * m.e23 + e33 * m.e33;
-                return r;
+                if (IS_CONSTANT_EVALUATED())
+                {
+                    const auto column = [this](FloatFormat x, FloatFormat y, FloatFormat z, FloatFormat w) {
+                        return Vector<4, FloatFormat>(e00 * x + e01 * y + e02 * z + e03 * w,
+                                                      e10 * x + e11 * y + e12 * z + e13 * w,
+                                                      e20 * x + e21 * y + e22 * z + e23 * w,
+                                                      e30 * x + e31 * y + e32 * z + e33 * w);
+                    };
+
+                    const auto c0 = column(m.e00, m.e10, m.e20, m.e30);
+                    const auto c1 = column(m.e01, m.e11, m.e21, m.e31);
+                    const auto c2 = column(m.e02, m.e12, m.e22, m.e32);
+                    const auto c3 = column(m.e03, m.e13, m.e23, m.e33);
+
+                    return Matrix<M, K>(c0.x, c0.y, c0.z, c0.w, c1.x, c1.y, c1.z, c1.w, c2.x, c2.y, c2.z, c2.w, c3.x, c3.y, c3.z, c3.w);
+                }
+
+                return multiply(m);
             }
 
-            Vector<3, FloatFormat> operator*(const Vector<3, FloatFormat>& v) const
+            constexpr Vector<3, FloatFormat> operator*(const Vector<3, FloatFormat>& v) const
             {
-                return Vector<3, FloatFormat>(
-                    e00 * v.x + e01 * v.y + e02 * v.z + e03,
-                    e10 * v.x + e11 * v.y + e12 * v.z + e13,
-                    e20 * v.x + e21 * v.y + e22 * v.z + e23);
+                if (IS_CONSTANT_EVALUATED())
+                    return Vector<3, FloatFormat>(e00 * v.x + e01 * v.y + e02 * v.z + e03,
+                                                  e10 * v.x + e11 * v.y + e12 * v.z + e13,
+                                                  e20 * v.x + e21 * v.y + e22 * v.z + e23);
+
+                return multiply(v);
             }
 
-            Vector<4, FloatFormat> operator*(const Vector<4, FloatFormat>& v) const
+            constexpr Vector<4, FloatFormat> operator*(const Vector<4, FloatFormat>& v) const
             {
-                return Vector<4, FloatFormat>(
-                    e00 * v.x + e01 * v.y + e02 * v.z + e03 * v.w,
-                    e10 * v.x + e11 * v.y + e12 * v.z + e13 * v.w,
-                    e20 * v.x + e21 * v.y + e22 * v.z + e23 * v.w,
-                    e30 * v.x + e31 * v.y + e32 * v.z + e33 * v.w);
+                if (IS_CONSTANT_EVALUATED())
+                    return Vector<4, FloatFormat>(e00 * v.x + e01 * v.y + e02 * v.z + e03 * v.w,
+                                                  e10 * v.x + e11 * v.y + e12 * v.z + e13 * v.w,
+                                                  e20 * v.x + e21 * v.y + e22 * v.z + e23 * v.w,
+                                                  e30 * v.x + e31 * v.y + e32 * v.z + e33 * v.w);
+
+                return multiply(v);
             }
 
-            void Translate(const Vector<3, FloatFormat>& offset)
+            constexpr void Translate(const Vector<3, FloatFormat>& offset)
             {
-                Matrix<M, K> m;
-                m.Identity();
+                Matrix<M, K> m(Initialization::Identity);
                 m.SetPos(offset);
                 *this = *this * m;
             };
 
-            void Scale(const Vector<3, FloatFormat>& factor)
+            constexpr void Scale(const Vector<3, FloatFormat>& factor)
             {
-                Matrix<M, K> m;
-                m.Identity();
+                Matrix<M, K> m(Initialization::Identity);
                 m.e00 = factor.x;
                 m.e11 = factor.y;
                 m.e22 = factor.z;
@@ -1417,7 +1420,7 @@ namespace RR
                 }
             }
 
-            void Lerp(const Matrix<M, K>& m, float t)
+            constexpr void Lerp(const Matrix<M, K>& m, float t)
             {
                 e00 += (m.e00 - e00) * t;
                 e01 += (m.e01 - e01) * t;
@@ -1435,15 +1438,15 @@ namespace RR
                 e23 += (m.e23 - e23) * t;
             }
 
-            FloatFormat Det() const
+            constexpr FloatFormat Det() const
             {
                 return e00 * (e11 * (e22 * e33 - e32 * e23) - e21 * (e12 * e33 - e32 * e13) + e31 * (e12 * e23 - e22 * e13)) - e10 * (e01 * (e22 * e33 - e32 * e23) - e21 * (e02 * e33 - e32 * e03) + e31 * (e02 * e23 - e22 * e03)) + e20 * (e01 * (e12 * e33 - e32 * e13) - e11 * (e02 * e33 - e32 * e03) + e31 * (e02 * e13 - e12 * e03)) - e30 * (e01 * (e12 * e23 - e22 * e13) - e11 * (e02 * e23 - e22 * e03) + e21 * (e02 * e13 - e12 * e03));
             }
 
-            Matrix<M, K> Inverse() const
+            constexpr Matrix<M, K> Inverse() const
             {
                 FloatFormat idet = 1.0f / Det();
-                Matrix<M, K> r;
+                Matrix<M, K> r {};
                 r.e00 = (e11 * (e22 * e33 - e32 * e23) - e21 * (e12 * e33 - e32 * e13) + e31 * (e12 * e23 - e22 * e13)) * idet;
                 r.e01 = -(e01 * (e22 * e33 - e32 * e23) - e21 * (e02 * e33 - e32 * e03) + e31 * (e02 * e23 - e22 * e03)) * idet;
                 r.e02 = (e01 * (e12 * e33 - e32 * e13) - e11 * (e02 * e33 - e32 * e03) + e31 * (e02 * e13 - e12 * e03)) * idet;
@@ -1463,9 +1466,9 @@ namespace RR
                 return r;
             }
 
-            Matrix<M, K> InverseOrtho() const
+            constexpr Matrix<M, K> InverseOrtho() const
             {
-                Matrix<M, K> r;
+                Matrix<M, K> r {};
                 r.e00 = e00;
                 r.e10 = e01;
                 r.e20 = e02;
@@ -1485,26 +1488,12 @@ namespace RR
                 return r;
             }
 
-            Matrix<M, K> Transpose() const
+            constexpr Matrix<M, K> Transpose() const
             {
-                Matrix<M, K> r;
-                r.e00 = e00;
-                r.e10 = e01;
-                r.e20 = e02;
-                r.e30 = e03;
-                r.e01 = e10;
-                r.e11 = e11;
-                r.e21 = e12;
-                r.e31 = e13;
-                r.e02 = e20;
-                r.e12 = e21;
-                r.e22 = e22;
-                r.e32 = e23;
-                r.e03 = e30;
-                r.e13 = e31;
-                r.e23 = e32;
-                r.e33 = e33;
-                return r;
+                if (IS_CONSTANT_EVALUATED())
+                    return Matrix<M, K>(e00, e01, e02, e03, e10, e11, e12, e13, e20, e21, e22, e23, e30, e31, e32, e33);
+
+                return transpose();
             }
 
             Quaternion GetRot() const
@@ -1533,7 +1522,7 @@ namespace RR
                 }
             }
 
-            void SetRot(const Quaternion& rot)
+            constexpr void SetRot(const Quaternion& rot)
             {
                 FloatFormat sx = rot.x * rot.x,
                             sy = rot.y * rot.y,
@@ -1562,16 +1551,81 @@ namespace RR
                 e12 = (t1 - t2) * inv;
             }
 
-            Vector<3, FloatFormat> getPos() const
+            constexpr Vector<3, FloatFormat> getPos() const
             {
-                return Offset().xyz();
+                return Vector<3, FloatFormat>(e03, e13, e23);
             }
 
-            void SetPos(const Vector<3, FloatFormat>& pos)
+            constexpr void SetPos(const Vector<3, FloatFormat>& pos)
             {
-                Offset().xyz() = pos;
+                e03 = pos.x;
+                e13 = pos.y;
+                e23 = pos.z;
             }
 
+        private:
+            Matrix<M, K> multiply(const Matrix<M, K>& m) const
+            {
+                const Simd::Float4 c0 = Simd::LoadAligned(&e00);
+                const Simd::Float4 c1 = Simd::LoadAligned(&e01);
+                const Simd::Float4 c2 = Simd::LoadAligned(&e02);
+                const Simd::Float4 c3 = Simd::LoadAligned(&e03);
+
+                Matrix<M, K> r;
+                const FloatFormat* source = &m.e00;
+                FloatFormat* dest = &r.e00;
+                for (size_t column = 0; column < K; column++, source += M, dest += M)
+                {
+                    Simd::Float4 result = Simd::Mul(c0, Simd::Splat(source[0]));
+                    result = Simd::MulAdd(c1, Simd::Splat(source[1]), result);
+                    result = Simd::MulAdd(c2, Simd::Splat(source[2]), result);
+                    result = Simd::MulAdd(c3, Simd::Splat(source[3]), result);
+                    Simd::StoreAligned(dest, result);
+                }
+                return r;
+            }
+
+            Vector<3, FloatFormat> multiply(const Vector<3, FloatFormat>& v) const
+            {
+                Simd::Float4 result = Simd::Mul(Simd::LoadAligned(&e00), Simd::Splat(v.x));
+                result = Simd::MulAdd(Simd::LoadAligned(&e01), Simd::Splat(v.y), result);
+                result = Simd::MulAdd(Simd::LoadAligned(&e02), Simd::Splat(v.z), result);
+                result = Simd::Add(result, Simd::LoadAligned(&e03));
+
+                alignas(16) FloatFormat r[4];
+                Simd::StoreAligned(r, result);
+                return Vector<3, FloatFormat>(r[0], r[1], r[2]);
+            }
+
+            Vector<4, FloatFormat> multiply(const Vector<4, FloatFormat>& v) const
+            {
+                Simd::Float4 result = Simd::Mul(Simd::LoadAligned(&e00), Simd::Splat(v.x));
+                result = Simd::MulAdd(Simd::LoadAligned(&e01), Simd::Splat(v.y), result);
+                result = Simd::MulAdd(Simd::LoadAligned(&e02), Simd::Splat(v.z), result);
+                result = Simd::MulAdd(Simd::LoadAligned(&e03), Simd::Splat(v.w), result);
+
+                Vector<4, FloatFormat> r;
+                Simd::Store(&r.x, result);
+                return r;
+            }
+
+            Matrix<M, K> transpose() const
+            {
+                Simd::Float4 c0 = Simd::LoadAligned(&e00);
+                Simd::Float4 c1 = Simd::LoadAligned(&e01);
+                Simd::Float4 c2 = Simd::LoadAligned(&e02);
+                Simd::Float4 c3 = Simd::LoadAligned(&e03);
+                Simd::Transpose(c0, c1, c2, c3);
+
+                Matrix<M, K> r;
+                Simd::StoreAligned(&r.e00, c0);
+                Simd::StoreAligned(&r.e01, c1);
+                Simd::StoreAligned(&r.e02, c2);
+                Simd::StoreAligned(&r.e03, c3);
+                return r;
+            }
+
+        public:
             FloatFormat e00, e10, e20, e30,
                 e01, e11, e21, e31,
                 e02, e12, e22, e32,
@@ -1579,6 +1633,72 @@ namespace RR
         };
 
         using Matrix4 = Matrix<4, 4>;
+        static_assert(sizeof(Matrix4) == 16 * sizeof(float), "Matrix4 is expected to be tightly packed");
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////
+        // TransformBatch
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        // Position, rotation and scale of many objects in structure of arrays layout.
+        // Matrices are computed for four objects at once, one object per SIMD lane.
+        class TransformBatch final
+        {
+        public:
+            static inline constexpr size_t Width = 4;
+
+            enum Component : uint32_t
+            {
+                PositionX,
+                PositionY,
+                PositionZ,
+                RotationX,
+                RotationY,
+                RotationZ,
+                RotationW,
+                ScaleX,
+                ScaleY,
+                ScaleZ,
+                Count
+            };
+
+            TransformBatch() = default;
+
+            void Reserve(size_t capacity);
+            void Clear();
+
+            // Uses external component arrays in place, e.g. from memory mapped file, instead of copying them.
+            // Arrays hold size rounded up to Width floats with identity padding and should stay alive while attached.
+            // Next modification copies them into own storage.
+            void Attach(const float* const (&components)[Component::Count], size_t size);
+            bool IsAttached() const { return isAttached_; }
+
+            // Padded to multiple of Width.
+            const float* GetComponent(Component component) const { return isAttached_ ? attached_[component] : components_[component].data(); }
+
+            // Returns index of added transform.
+            size_t Add(const Vector<3, float>& position, const Quaternion& rotation, const Vector<3, float>& scale = Vector<3, float>(1.0f));
+            void Set(size_t index, const Vector<3, float>& position, const Quaternion& rotation, const Vector<3, float>& scale = Vector<3, float>(1.0f));
+
+            size_t GetSize() const { return size_; }
+
+            // Same as Matrix4(rotation, position) followed by Scale(scale), worldMatrices should hold GetSize() elements.
+            void ComputeWorldMatrices(Matrix4* worldMatrices) const;
+            // viewProjection * world for every transform.
+            void ComputeWorldViewProjectionMatrices(const Matrix4& viewProjection, Matrix4* matrices) const;
+
+        private:
+            void detach();
+
+            // World matrix elements of Width transforms starting at first, indexed by [column][row].
+            void computeWorldLanes(size_t first, Simd::Float4 (&lanes)[4][4]) const;
+
+        private:
+            size_t size_ = 0;
+            // Padded to multiple of Width with identity transforms.
+            std::array<std::vector<float>, Component::Count> components_;
+            std::array<const float*, Component::Count> attached_ = {};
+            bool isAttached_ = false;
+        };
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////
         // Rect
@@ -0,0 +1,99 @@
+#include "Name.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace
+        {
+            class NameTable final : private NonCopyable, NonMovable
+            {
+            public:
+                static NameTable& Instance()
+                {
+                    // Never destroyed, names may be resolved during static destruction.
+                    static NameTable* instance = new NameTable();
+                    return *instance;
+                }
+
+                uint32_t Intern(U8StringView string)
+                {
+                    if (string.empty())
+                        return 0;
+
+                    {
+                        std::shared_lock<Threading::SharedMutex> lock(mutex_);
+
+                        const auto it = ids_.find(string);
+                        if (it != ids_.end())
+                            return it->second;
+                    }
+
+                    Threading::UniqueLock<Threading::SharedMutex> lock(mutex_);
+
+                    const auto it = ids_.find(string);
+                    if (it != ids_.end())
+                        return it->second;
+
+                    const uint32_t id = count_.load(std::memory_order_relaxed);
+                    ASSERT_MSG(id < ChunkSize * MaxChunks, "Names table is full");
+
+                    auto* chunk = chunks_[id / ChunkSize].load(std::memory_order_relaxed);
+                    if (!chunk)
+                    {
+                        chunk = new U8String[ChunkSize];
+                        chunks_[id / ChunkSize].store(chunk, std::memory_order_release);
+                    }
+
+                    U8String& stored = chunk[id % ChunkSize];
+                    stored = U8String(string);
+
+                    // Key views stored string, which never moves.
+                    ids_.emplace(U8StringView(stored), id);
+                    count_.store(id + 1, std::memory_order_release);
+
+                    return id;
+                }
+
+                // Lock free, id was obtained from Intern by the caller or passed along with synchronization.
+                inline const U8String& Get(uint32_t id) const
+                {
+                    ASSERT(id < count_.load(std::memory_order_acquire));
+                    return chunks_[id / ChunkSize].load(std::memory_order_acquire)[id % ChunkSize];
+                }
+
+            private:
+                static constexpr uint32_t ChunkSize = 1024;
+                static constexpr uint32_t MaxChunks = 1024;
+
+                NameTable()
+                {
+                    // Empty string takes id zero, so default constructed names resolve without lookup.
+                    chunks_[0].store(new U8String[ChunkSize], std::memory_order_relaxed);
+                    count_.store(1, std::memory_order_relaxed);
+                }
+
+            private:
+                std::array<std::atomic<U8String*>, MaxChunks> chunks_ = {};
+                std::atomic<uint32_t> count_ = 0;
+                std::unordered_map<U8StringView, uint32_t> ids_;
+                Threading::SharedMutex mutex_;
+            };
+        }
+
+        const U8String& Name::GetString() const
+        {
+            return NameTable::Instance().Get(id_);
+        }
+
+        uint32_t Name::intern(U8StringView string)
+        {
+            return NameTable::Instance().Intern(string);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace RR
+{
+    namespace Common
+    {
+        // Interned string identified by a compact id. Equal strings share one id and one stored copy,
+        // so objects created again and again under the same name don't allocate or copy it.
+        // Stored strings live for process lifetime, GetString reference stays valid.
+        class Name final
+        {
+        public:
+            Name() = default;
+            Name(U8StringView string) : id_(intern(string)) { }
+            Name(const U8String& string) : id_(intern(string)) { }
+            Name(const char* string) : id_(intern(U8StringView(string))) { }
+
+            const U8String& GetString() const;
+            inline uint32_t GetId() const { return id_; }
+            inline bool IsEmpty() const { return id_ == 0; }
+
+            inline bool operator==(const Name& other) const { return id_ == other.id_; }
+            inline bool operator!=(const Name& other) const { return id_ != other.id_; }
+
+        private:
+            static uint32_t intern(U8StringView string);
+
+        private:
+            // Zero is the empty string.
+            uint32_t id_ = 0;
+        };
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Details
+        {
+            // Free list of fixed size blocks carved from chunks. Chunks are kept for process lifetime,
+            // so blocks of the same type stay close to each other and never go back to general heap.
+            // Pool is never destroyed, pooled objects may be released during static destruction.
+            template <std::size_t BlockSize, std::size_t BlockAlignment>
+            class BlockPool final : private NonCopyable, NonMovable
+            {
+            public:
+                static BlockPool& Instance()
+                {
+                    static BlockPool* instance = new BlockPool();
+                    return *instance;
+                }
+
+                void* Allocate()
+                {
+                    Threading::ReadWriteGuard lock(spinlock_);
+
+                    if (!freeList_)
+                        grow();
+
+                    FreeBlock* block = freeList_;
+                    freeList_ = block->next;
+                    return block;
+                }
+
+                void Deallocate(void* pointer) noexcept
+                {
+                    Threading::ReadWriteGuard lock(spinlock_);
+
+                    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+                    block->next = freeList_;
+                    freeList_ = block;
+                }
+
+            private:
+                struct FreeBlock
+                {
+                    FreeBlock* next;
+                };
+
+                static constexpr std::size_t Alignment = BlockAlignment > alignof(FreeBlock) ? BlockAlignment : alignof(FreeBlock);
+                static constexpr std::size_t Stride = (std::max(BlockSize, sizeof(FreeBlock)) + Alignment - 1) / Alignment * Alignment;
+                // Around a page per chunk, small objects amortize chunk allocation over many blocks.
+                static constexpr std::size_t BlocksPerChunk = Stride >= 4096 ? 1 : 4096 / Stride;
+
+                BlockPool() = default;
+
+                void grow()
+                {
+                    auto* chunk = static_cast<uint8_t*>(::operator new(Stride * BlocksPerChunk, std::align_val_t(Alignment)));
+
+                    // Linked in address order, so consecutive allocations are adjacent.
+                    for (std::size_t index = BlocksPerChunk; index > 0; index--)
+                    {
+                        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (index - 1) * Stride);
+                        block->next = freeList_;
+                        freeList_ = block;
+                    }
+                }
+
+            private:
+                FreeBlock* freeList_ = nullptr;
+                Threading::SpinLock spinlock_;
+            };
+        }
+
+        // Standard allocator drawing single objects from a pool per type. Intended for std::allocate_shared,
+        // which rebinds it to the control block type, so object and reference counts share one pooled block.
+        // Types with non public constructors make it a friend: template <typename> friend class Common::PoolAllocator.
+        template <typename T>
+        class PoolAllocator
+        {
+        public:
+            using value_type = T;
+
+            PoolAllocator() noexcept = default;
+
+            template <typename U>
+            PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+            T* allocate(std::size_t count)
+            {
+                if (count != 1)
+                    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+
+                return static_cast<T*>(Details::BlockPool<sizeof(T), alignof(T)>::Instance().Allocate());
+            }
+
+            void deallocate(T* pointer, std::size_t count) noexcept
+            {
+                if (count != 1)
+                {
+                    ::operator delete(pointer, std::align_val_t(alignof(T)));
+                    return;
+                }
+
+                Details::BlockPool<sizeof(T), alignof(T)>::Instance().Deallocate(pointer);
+            }
+
+            template <typename U, typename... Args>
+            void construct(U* pointer, Args&&... args)
+            {
+                ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+            }
+
+            template <typename U>
+            void destroy(U* pointer) noexcept
+            {
+                pointer->~U();
+            }
+
+            template <typename U>
+            inline bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+            template <typename U>
+            inline bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+        };
+
+        template <typename T, typename... Args>
+        inline std::shared_ptr<T> MakePooledShared(Args&&... args)
+        {
+            return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+        }
+    }
+}
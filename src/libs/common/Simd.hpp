@@ -0,0 +1,217 @@
+#pragma once
+
+#include "common/Config.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if SIMD_SSE
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif SIMD_NEON
+#include <arm_neon.h>
+#else
+#include <cstring>
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        // Thin wrapper over four wide float registers used by math types.
+        // Backend is selected at compile time, see SIMD_* defines in Config.hpp.
+        // Comparison results are lane masks, their representation is backend specific and only meaningful to Select.
+        namespace Simd
+        {
+#if SIMD_SSE
+            using Float4 = __m128;
+
+            inline Float4 Load(const float* data) { return _mm_loadu_ps(data); }
+            inline Float4 LoadAligned(const float* data) { return _mm_load_ps(data); }
+            inline void Store(float* data, Float4 value) { _mm_storeu_ps(data, value); }
+            inline void StoreAligned(float* data, Float4 value) { _mm_store_ps(data, value); }
+            inline Float4 Splat(float value) { return _mm_set1_ps(value); }
+
+            inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+            inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+            inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+            inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+            inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+            inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+            inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+            // Magnitude of a with sign of b.
+            inline Float4 CopySign(Float4 a, Float4 b)
+            {
+                const Float4 signMask = _mm_set1_ps(-0.0f);
+                return _mm_or_ps(_mm_andnot_ps(signMask, a), _mm_and_ps(signMask, b));
+            }
+            // False if any lane compares unordered.
+            inline bool AllLessEqual(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)) == 0xF; }
+            // a * b + c, not fused to stay bit exact with scalar code.
+            inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+            // Lanes should be within int32 range.
+            inline Float4 Floor(Float4 a)
+            {
+                // Truncation rounds negative fractions up, so one is subtracted where it went above a.
+                const Float4 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+                return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.0f)));
+            }
+            // Relative error below 1.5 * 2^-12.
+            inline Float4 RsqrtEstimate(Float4 a) { return _mm_rsqrt_ps(a); }
+            inline Float4 Less(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+            // Lanes of a where mask is set, lanes of b elsewhere.
+            inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+            // 2^n for integral n in [-126, 127].
+            inline Float4 Pow2(Float4 n) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23)); }
+            // Unbiased exponent of positive normal a.
+            inline Float4 Exponent(Float4 a) { return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(a), 23), _mm_set1_epi32(127))); }
+            // Mantissa of positive normal a in [1, 2).
+            inline Float4 Mantissa(Float4 a) { return _mm_or_ps(_mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.0f)); }
+
+            inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#elif SIMD_NEON
+            using Float4 = float32x4_t;
+
+            inline Float4 Load(const float* data) { return vld1q_f32(data); }
+            inline Float4 LoadAligned(const float* data) { return vld1q_f32(data); }
+            inline void Store(float* data, Float4 value) { vst1q_f32(data, value); }
+            inline void StoreAligned(float* data, Float4 value) { vst1q_f32(data, value); }
+            inline Float4 Splat(float value) { return vdupq_n_f32(value); }
+
+            inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+            inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+            inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+            inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+            inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+            inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+            inline Float4 Abs(Float4 a) { return vabsq_f32(a); }
+            inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+            // Magnitude of a with sign of b.
+            inline Float4 CopySign(Float4 a, Float4 b) { return vbslq_f32(vdupq_n_u32(0x80000000), b, a); }
+            // False if any lane compares unordered.
+            inline bool AllLessEqual(Float4 a, Float4 b)
+            {
+                const uint32x4_t mask = vcleq_f32(a, b);
+                const uint32x2_t halves = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+                return (vget_lane_u32(halves, 0) & vget_lane_u32(halves, 1)) != 0;
+            }
+            // a * b + c, not fused to stay bit exact with scalar code.
+            inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vaddq_f32(vmulq_f32(a, b), c); }
+
+            // Lanes should be within int32 range.
+            inline Float4 Floor(Float4 a) { return vrndmq_f32(a); }
+            // Relative error below 2^-8.
+            inline Float4 RsqrtEstimate(Float4 a) { return vrsqrteq_f32(a); }
+            inline Float4 Less(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+            // Lanes of a where mask is set, lanes of b elsewhere.
+            inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+            // 2^n for integral n in [-126, 127].
+            inline Float4 Pow2(Float4 n) { return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23)); }
+            // Unbiased exponent of positive normal a.
+            inline Float4 Exponent(Float4 a)
+            {
+                const int32x4_t biased = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(a), 23));
+                return vcvtq_f32_s32(vsubq_s32(biased, vdupq_n_s32(127)));
+            }
+            // Mantissa of positive normal a in [1, 2).
+            inline Float4 Mantissa(Float4 a)
+            {
+                const uint32x4_t mantissa = vandq_u32(vreinterpretq_u32_f32(a), vdupq_n_u32(0x007FFFFF));
+                return vreinterpretq_f32_u32(vorrq_u32(mantissa, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+            }
+
+            inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+            {
+                const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+                const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+                r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+                r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+                r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+                r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+            }
+#else
+            struct Float4
+            {
+                float v[4];
+            };
+
+            inline Float4 Load(const float* data) { return { { data[0], data[1], data[2], data[3] } }; }
+            inline Float4 LoadAligned(const float* data) { return Load(data); }
+            inline void Store(float* data, Float4 value)
+            {
+                for (int index = 0; index < 4; index++)
+                    data[index] = value.v[index];
+            }
+            inline void StoreAligned(float* data, Float4 value) { Store(data, value); }
+            inline Float4 Splat(float value) { return { { value, value, value, value } }; }
+
+            inline Float4 Add(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+            inline Float4 Sub(Float4 a, Float4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+            inline Float4 Mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+            inline Float4 Div(Float4 a, Float4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+            inline Float4 Min(Float4 a, Float4 b) { return { { std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3]) } }; }
+            inline Float4 Max(Float4 a, Float4 b) { return { { std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]) } }; }
+            inline Float4 Abs(Float4 a) { return { { std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]) } }; }
+            inline Float4 Sqrt(Float4 a) { return { { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) } }; }
+            // Magnitude of a with sign of b.
+            inline Float4 CopySign(Float4 a, Float4 b) { return { { std::copysign(a.v[0], b.v[0]), std::copysign(a.v[1], b.v[1]), std::copysign(a.v[2], b.v[2]), std::copysign(a.v[3], b.v[3]) } }; }
+            // False if any lane compares unordered.
+            inline bool AllLessEqual(Float4 a, Float4 b) { return a.v[0] <= b.v[0] && a.v[1] <= b.v[1] && a.v[2] <= b.v[2] && a.v[3] <= b.v[3]; }
+            inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+
+            inline Float4 Floor(Float4 a) { return { { std::floor(a.v[0]), std::floor(a.v[1]), std::floor(a.v[2]), std::floor(a.v[3]) } }; }
+            inline Float4 RsqrtEstimate(Float4 a) { return Div(Splat(1.0f), Sqrt(a)); }
+            // Mask lanes are one where set.
+            inline Float4 Less(Float4 a, Float4 b) { return { { float(a.v[0] < b.v[0]), float(a.v[1] < b.v[1]), float(a.v[2] < b.v[2]), float(a.v[3] < b.v[3]) } }; }
+            // Lanes of a where mask is set, lanes of b elsewhere.
+            inline Float4 Select(Float4 mask, Float4 a, Float4 b)
+            {
+                Float4 result;
+                for (int index = 0; index < 4; index++)
+                    result.v[index] = mask.v[index] != 0.0f ? a.v[index] : b.v[index];
+                return result;
+            }
+            // 2^n for integral n in [-126, 127].
+            inline Float4 Pow2(Float4 n)
+            {
+                Float4 result;
+                for (int index = 0; index < 4; index++)
+                    result.v[index] = std::ldexp(1.0f, static_cast<int>(n.v[index]));
+                return result;
+            }
+            // Unbiased exponent of positive normal a.
+            inline Float4 Exponent(Float4 a)
+            {
+                Float4 result;
+                for (int index = 0; index < 4; index++)
+                    result.v[index] = static_cast<float>(std::ilogb(a.v[index]));
+                return result;
+            }
+            // Mantissa of positive normal a in [1, 2).
+            inline Float4 Mantissa(Float4 a)
+            {
+                Float4 result;
+                for (int index = 0; index < 4; index++)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &a.v[index], sizeof(bits));
+                    bits = (bits & 0x007FFFFF) | 0x3F800000;
+                    std::memcpy(&result.v[index], &bits, sizeof(bits));
+                }
+                return result;
+            }
+
+            inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+            {
+                const Float4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+                r0 = { { t0.v[0], t1.v[0], t2.v[0], t3.v[0] } };
+                r1 = { { t0.v[1], t1.v[1], t2.v[1], t3.v[1] } };
+                r2 = { { t0.v[2], t1.v[2], t2.v[2], t3.v[2] } };
+                r3 = { { t0.v[3], t1.v[3], t2.v[3], t3.v[3] } };
+            }
+#endif
+        }
+    }
+}
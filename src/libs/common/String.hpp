@@ -9,14 +9,17 @@
 
 #include "dependencies/utfcpp/source/utf8.h"
 #include <string>
+#include <string_view>
 
 namespace RR
 {
 #if __cplusplus > 201703L
     // C++20
     using U8String = std::u8string;
+    using U8StringView = std::u8string_view;
 #else
     using U8String = std::string;
+    using U8StringView = std::string_view;
 #endif
 
     namespace StringConversions
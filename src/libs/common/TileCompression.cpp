@@ -0,0 +1,251 @@
+#include "TileCompression.hpp"
+
+#include "common/Math.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace TileCompression
+        {
+            namespace
+            {
+                constexpr uint32_t MinMatch = 4;
+                constexpr uint32_t MaxOffset = 0xFFFF;
+                // Tile always ends with literals, decoders detect the last sequence by output size.
+                constexpr uint32_t LastLiterals = 5;
+                constexpr uint32_t MatchSearchEnd = 12;
+                constexpr uint32_t HashBits = 12;
+
+                inline uint32_t read32(const uint8_t* data)
+                {
+                    uint32_t value;
+                    memcpy(&value, data, sizeof(value));
+                    return value;
+                }
+
+                inline uint32_t hash(uint32_t sequence)
+                {
+                    return (sequence * 2654435761u) >> (32 - HashBits);
+                }
+
+                void writeLength(std::vector<uint8_t>& output, uint32_t length)
+                {
+                    for (; length >= 255; length -= 255)
+                        output.push_back(255);
+
+                    output.push_back(static_cast<uint8_t>(length));
+                }
+
+                void writeSequence(std::vector<uint8_t>& output, const uint8_t* literals, uint32_t literalsLength, uint32_t offset, uint32_t matchLength)
+                {
+                    // Zero match length of the last sequence is not stored, tile end terminates it.
+                    const uint32_t extraMatchLength = matchLength > 0 ? matchLength - MinMatch : 0;
+
+                    output.push_back(static_cast<uint8_t>((std::min(literalsLength, 15u) << 4) | std::min(extraMatchLength, 15u)));
+
+                    if (literalsLength >= 15)
+                        writeLength(output, literalsLength - 15);
+
+                    output.insert(output.end(), literals, literals + literalsLength);
+
+                    if (matchLength == 0)
+                        return;
+
+                    output.push_back(static_cast<uint8_t>(offset & 0xFF));
+                    output.push_back(static_cast<uint8_t>(offset >> 8));
+
+                    if (extraMatchLength >= 15)
+                        writeLength(output, extraMatchLength - 15);
+                }
+
+                void compressTile(const uint8_t* data, uint32_t size, std::vector<uint8_t>& output)
+                {
+                    // Position + 1, zero is empty slot.
+                    std::array<uint32_t, 1 << HashBits> table = {};
+
+                    uint32_t anchor = 0;
+                    uint32_t position = 0;
+                    const uint32_t searchEnd = size > MatchSearchEnd ? size - MatchSearchEnd : 0;
+
+                    while (position < searchEnd)
+                    {
+                        const uint32_t sequence = read32(data + position);
+                        auto& slot = table[hash(sequence)];
+                        const uint32_t candidate = slot;
+                        slot = position + 1;
+
+                        if (candidate == 0 || position - (candidate - 1) > MaxOffset || read32(data + candidate - 1) != sequence)
+                        {
+                            position++;
+                            continue;
+                        }
+
+                        const uint32_t matchBegin = candidate - 1;
+                        const uint32_t maxLength = size - LastLiterals - position;
+
+                        uint32_t length = MinMatch;
+                        while (length < maxLength && data[matchBegin + length] == data[position + length])
+                            length++;
+
+                        writeSequence(output, data + anchor, position - anchor, position - matchBegin, length);
+
+                        position += length;
+                        anchor = position;
+                    }
+
+                    writeSequence(output, data + anchor, size - anchor, 0, 0);
+                }
+
+                bool readLength(const uint8_t*& input, const uint8_t* end, uint32_t& length)
+                {
+                    uint8_t value;
+                    do
+                    {
+                        if (input == end)
+                            return false;
+
+                        value = *input++;
+                        length += value;
+                    } while (value == 255);
+
+                    return true;
+                }
+
+                bool decompressTile(const uint8_t* input, const uint8_t* end, uint8_t* output, uint8_t* outputEnd)
+                {
+                    uint8_t* const outputBegin = output;
+
+                    while (input < end)
+                    {
+                        const uint8_t token = *input++;
+
+                        uint32_t literalsLength = token >> 4;
+                        if (literalsLength == 15 && !readLength(input, end, literalsLength))
+                            return false;
+
+                        if (literalsLength > static_cast<size_t>(end - input) || literalsLength > static_cast<size_t>(outputEnd - output))
+                            return false;
+
+                        memcpy(output, input, literalsLength);
+                        input += literalsLength;
+                        output += literalsLength;
+
+                        // The last sequence has no match. Tile data is padded, so its end is found by output size.
+                        if (output == outputEnd)
+                            return true;
+
+                        if (end - input < 2)
+                            return false;
+
+                        const uint32_t offset = input[0] | (input[1] << 8);
+                        input += 2;
+
+                        if (offset == 0 || offset > static_cast<size_t>(output - outputBegin))
+                            return false;
+
+                        uint32_t matchLength = token & 0xF;
+                        if (matchLength == 15 && !readLength(input, end, matchLength))
+                            return false;
+                        matchLength += MinMatch;
+
+                        if (matchLength > static_cast<size_t>(outputEnd - output))
+                            return false;
+
+                        // Overlapping match repeats the pattern, so copy goes byte by byte.
+                        const uint8_t* match = output - offset;
+                        for (uint32_t index = 0; index < matchLength; index++)
+                            *output++ = *match++;
+                    }
+
+                    return false;
+                }
+            }
+
+            std::vector<uint8_t> Compress(const void* data, size_t size)
+            {
+                ASSERT(data || size == 0);
+                ASSERT(size <= std::numeric_limits<uint32_t>::max());
+
+                const auto source = static_cast<const uint8_t*>(data);
+                const uint32_t tilesCount = GetTilesCount(size);
+                const size_t tileOffsetsSize = (tilesCount + 1) * sizeof(uint32_t);
+
+                std::vector<uint8_t> output(sizeof(Header) + tileOffsetsSize);
+                // Most data compresses, grows a bit otherwise.
+                output.reserve(output.size() + size);
+
+                const Header header = { Magic, static_cast<uint32_t>(size), tilesCount, 0 };
+                memcpy(output.data(), &header, sizeof(header));
+
+                std::vector<uint32_t> tileOffsets(tilesCount + 1);
+
+                for (uint32_t tile = 0; tile < tilesCount; tile++)
+                {
+                    output.resize(AlignTo(output.size(), sizeof(uint32_t)), 0);
+                    tileOffsets[tile] = static_cast<uint32_t>(output.size());
+
+                    const size_t tileBegin = static_cast<size_t>(tile) * TileSize;
+                    compressTile(source + tileBegin, static_cast<uint32_t>(std::min<size_t>(TileSize, size - tileBegin)), output);
+                }
+
+                tileOffsets[tilesCount] = static_cast<uint32_t>(output.size());
+                memcpy(output.data() + sizeof(Header), tileOffsets.data(), tileOffsetsSize);
+
+                // GPU reads stream by 32-bit values.
+                output.resize(AlignTo(output.size(), sizeof(uint32_t)), 0);
+
+                return output;
+            }
+
+            bool ReadHeader(const void* compressed, size_t compressedSize, Header& header)
+            {
+                ASSERT(compressed);
+
+                if (compressedSize < sizeof(Header))
+                    return false;
+
+                memcpy(&header, compressed, sizeof(header));
+
+                return header.magic == Magic &&
+                       header.tilesCount == GetTilesCount(header.uncompressedSize) &&
+                       sizeof(Header) + (header.tilesCount + 1) * sizeof(uint32_t) <= compressedSize;
+            }
+
+            bool Decompress(const void* compressed, size_t compressedSize, void* dest, size_t destSize)
+            {
+                ASSERT(dest || destSize == 0);
+
+                Header header;
+                if (!ReadHeader(compressed, compressedSize, header) || destSize < header.uncompressedSize)
+                    return false;
+
+                const auto input = static_cast<const uint8_t*>(compressed);
+                const auto output = static_cast<uint8_t*>(dest);
+
+                std::vector<uint32_t> tileOffsets(header.tilesCount + 1);
+                memcpy(tileOffsets.data(), input + sizeof(Header), tileOffsets.size() * sizeof(uint32_t));
+
+                for (uint32_t tile = 0; tile < header.tilesCount; tile++)
+                {
+                    const uint32_t begin = tileOffsets[tile];
+                    const uint32_t end = tileOffsets[tile + 1];
+
+                    if (begin > end || end > compressedSize)
+                        return false;
+
+                    const size_t tileBegin = static_cast<size_t>(tile) * TileSize;
+                    const size_t tileSize = std::min<size_t>(TileSize, header.uncompressedSize - tileBegin);
+
+                    if (!decompressTile(input + begin, input + end, output + tileBegin, output + tileBegin + tileSize))
+                        return false;
+                }
+
+                return true;
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace RR
+{
+    namespace Common
+    {
+        // LZ4 style compression of data split into independent tiles, so tiles are decompressed in parallel,
+        // e.g. by compute shader thread per tile (see shaders/Decompress.slang) or by several CPU jobs.
+        // Stream is Header, table of tilesCount + 1 tile offsets from stream begin, the last one is stream size, and tiles data.
+        // Tile is sequence of token, literals, 16-bit match offset and extra match length. Matches never reach previous tiles.
+        // Tile ends with literals once its output is complete, data after it up to the next tile is padding.
+        namespace TileCompression
+        {
+            static constexpr uint32_t Magic = 0x31504D43; // 'CMP1'
+            // Multiple of 4, so each tile output begins at 32-bit value, which is the unit of GPU writes.
+            static constexpr uint32_t TileSize = 64 * 1024;
+
+            struct Header final
+            {
+                uint32_t magic;
+                uint32_t uncompressedSize;
+                uint32_t tilesCount;
+                uint32_t reserved;
+            };
+
+            inline uint32_t GetTilesCount(size_t uncompressedSize) { return static_cast<uint32_t>((uncompressedSize + TileSize - 1) / TileSize); }
+
+            std::vector<uint8_t> Compress(const void* data, size_t size);
+
+            // False on malformed stream.
+            bool ReadHeader(const void* compressed, size_t compressedSize, Header& header);
+            // False on malformed stream or when destination is smaller than uncompressed size.
+            bool Decompress(const void* compressed, size_t compressedSize, void* dest, size_t destSize);
+        }
+    }
+}
@@ -1,18 +1,79 @@
 #include "Time.hpp"
 
+#include <algorithm>
+
 namespace RR
 {
     namespace Common
     {
         std::unique_ptr<Time> Time::_instance = std::unique_ptr<Time>(new Time());
 
+        void Time::Init()
+        {
+            deltaTime_ = 0;
+            smoothedDeltaTime_ = 0;
+            frameStartNs_ = 0;
+            frameIndex_ = 0;
+            historyCount_ = 0;
+
+            Update();
+        }
+
         void Time::Update()
         {
-            float static invSeconds = 1.0f / std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::seconds(1)).count();
+            const auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::steady_clock::now().time_since_epoch())
+                                                       .count());
+
+            // The first update only sets the origin.
+            if (frameStartNs_ == 0)
+            {
+                frameStartNs_ = now;
+                return;
+            }
+
+            deltaTime_ = static_cast<float>(now - frameStartNs_) * 1e-9f;
+            smoothedDeltaTime_ = historyCount_ == 0 ? deltaTime_ : smoothedDeltaTime_ + (deltaTime_ - smoothedDeltaTime_) * SmoothingFactor;
+            frameStartNs_ = now;
+
+            history_[frameIndex_ % HistorySize] = deltaTime_;
+            historyCount_ = std::min(historyCount_ + 1, HistorySize);
+            frameIndex_++;
+        }
+
+        float Time::GetDeltaTimePercentile(float percentile) const
+        {
+            if (historyCount_ == 0)
+                return 0.0f;
+
+            // Order of history doesn't matter, only the latest historyCount_ are valid and they fill the array from the start.
+            auto sorted = history_;
+            const auto begin = sorted.begin();
+            const auto end = begin + historyCount_;
+
+            const auto rank = static_cast<uint32_t>(std::clamp(percentile, 0.0f, 100.0f) * 0.01f * static_cast<float>(historyCount_ - 1) + 0.5f);
+            std::nth_element(begin, begin + rank, end);
+
+            return sorted[rank];
+        }
+
+        void Time::Calibrate(uint64_t gpuTimestamp, uint64_t gpuFrequency, uint64_t cpuNs)
+        {
+            gpuCalibrationTimestamp_ = gpuTimestamp;
+            gpuFrequency_ = gpuFrequency;
+            cpuCalibrationNs_ = cpuNs;
+        }
+
+        uint64_t Time::GpuToCpuNs(uint64_t gpuTimestamp) const
+        {
+            if (!IsCalibrated())
+                return 0;
+
+            // Signed, timestamps before calibration point are common.
+            const auto offsetTicks = static_cast<int64_t>(gpuTimestamp - gpuCalibrationTimestamp_);
+            const auto offsetNs = static_cast<int64_t>(static_cast<double>(offsetTicks) * 1e9 / static_cast<double>(gpuFrequency_));
 
-            auto const& now = std::chrono::high_resolution_clock::now();
-            _dt = (now - _lastUpdate).count() * invSeconds;
-            _lastUpdate = now;
+            return static_cast<uint64_t>(static_cast<int64_t>(cpuCalibrationNs_) + offsetNs);
         }
     }
-}
\ No newline at end of file
+}
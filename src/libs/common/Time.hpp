@@ -1,31 +1,65 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 
 namespace RR
 {
     namespace Common
     {
+        // Frame clock on steady clock timeline, the one of Profiler::Now, so frame starts line up with profiler scopes.
+        // GPU timestamps are mapped onto the same timeline by calibration. Updated and read by the main thread.
         class Time
         {
         public:
+            // Frames kept for percentiles, about 4 seconds at 60 Hz.
+            static constexpr uint32_t HistorySize = 256;
+
             inline Time() { Update(); }
 
-            inline void Init() { Update(); }
+            // Restarts the clock, time spent before isn't counted as a frame.
+            void Init();
+
+            // Seconds.
+            inline float GetDeltaTime() const { return deltaTime_; };
+            // Exponential moving average, steady enough for animation pacing and displays.
+            inline float GetSmoothedDeltaTime() const { return smoothedDeltaTime_; };
+            // Nearest rank percentile of deltas of up to HistorySize latest frames, percentile in [0, 100].
+            float GetDeltaTimePercentile(float percentile) const;
 
-            inline float GetDeltaTime() const { return _dt; };
+            // Nanoseconds of steady clock at the latest Update.
+            inline uint64_t GetFrameStartNs() const { return frameStartNs_; }
+            inline uint64_t GetFrameIndex() const { return frameIndex_; }
 
             void Update();
 
+            // GPU and CPU clocks sampled at the same moment, e.g. by ID3D12CommandQueue::GetClockCalibration.
+            // Clocks drift apart slowly, so calibration should be refreshed every few seconds.
+            void Calibrate(uint64_t gpuTimestamp, uint64_t gpuFrequency, uint64_t cpuNs);
+            inline bool IsCalibrated() const { return gpuFrequency_ != 0; }
+            // Steady clock nanoseconds of GPU timestamp, zero until calibrated.
+            uint64_t GpuToCpuNs(uint64_t gpuTimestamp) const;
+
             inline static const std::unique_ptr<Time>& Instance()
             {
                 return _instance;
             }
 
         private:
-            float _dt = 0;
-            std::chrono::time_point<std::chrono::high_resolution_clock> _lastUpdate;
+            static constexpr float SmoothingFactor = 0.1f;
+
+            float deltaTime_ = 0;
+            float smoothedDeltaTime_ = 0;
+            uint64_t frameStartNs_ = 0;
+            uint64_t frameIndex_ = 0;
+            std::array<float, HistorySize> history_ = {};
+            uint32_t historyCount_ = 0;
+
+            uint64_t gpuCalibrationTimestamp_ = 0;
+            uint64_t gpuFrequency_ = 0;
+            uint64_t cpuCalibrationNs_ = 0;
+
             static std::unique_ptr<Time> _instance;
         };
     }
-}
\ No newline at end of file
+}
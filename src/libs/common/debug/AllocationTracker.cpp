@@ -0,0 +1,244 @@
+#include "AllocationTracker.hpp"
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+#ifdef ENABLE_ALLOCATION_TRACKING
+            namespace Details
+            {
+                struct AllocationThreadState final
+                {
+                    static constexpr size_t TagsCount = static_cast<size_t>(AllocationTag::Count);
+
+                    // Written only by owning thread, read by EndFrame.
+                    std::array<std::atomic<uint64_t>, TagsCount> counts = {};
+                    std::array<std::atomic<uint64_t>, TagsCount> bytes = {};
+                    // Values at previous EndFrame, touched under registry lock only.
+                    AllocationTagCounters previous;
+
+                    uint32_t noAllocationsDepth = 0;
+                    U8String name;
+                    AllocationThreadState* next = nullptr;
+                };
+            }
+
+            namespace
+            {
+                // Allocations made by tracker itself aren't counted, registration allocates.
+                thread_local bool isInsideTracker = false;
+                thread_local Details::AllocationThreadState* threadState = nullptr;
+
+                // States are never freed, counters of finished threads stay valid for the frame they were in.
+                std::atomic<Details::AllocationThreadState*> threadStates = nullptr;
+                std::mutex& getRegistryMutex()
+                {
+                    static std::mutex* mutex = new std::mutex();
+                    return *mutex;
+                }
+
+                Details::AllocationThreadState* getThreadState()
+                {
+                    if (threadState)
+                        return threadState;
+
+                    isInsideTracker = true;
+
+                    auto* state = new Details::AllocationThreadState();
+                    state->next = threadStates.load(std::memory_order_relaxed);
+                    while (!threadStates.compare_exchange_weak(state->next, state, std::memory_order_release, std::memory_order_relaxed)) { }
+
+                    threadState = state;
+                    isInsideTracker = false;
+
+                    return state;
+                }
+
+                void recordAllocation(size_t size)
+                {
+                    if (isInsideTracker)
+                        return;
+
+                    auto* state = getThreadState();
+                    const auto tag = static_cast<size_t>(Details::currentAllocationTag);
+
+                    // Single writer, plain load and store are enough.
+                    state->counts[tag].store(state->counts[tag].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    state->bytes[tag].store(state->bytes[tag].load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+
+                    if (state->noAllocationsDepth > 0)
+                    {
+                        // Assert formats its message on heap.
+                        const auto depth = state->noAllocationsDepth;
+                        state->noAllocationsDepth = 0;
+                        ASSERT_MSG(false, "Heap allocation of %zu bytes inside no allocations scope", size);
+                        state->noAllocationsDepth = depth;
+                    }
+                }
+
+                // Unqualified, debug CRT maps malloc and free to their debug versions with macros.
+                void* allocate(size_t size, size_t alignment)
+                {
+                    recordAllocation(size);
+
+                    if (size == 0)
+                        size = 1;
+
+                    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                        return malloc(size);
+
+#ifdef OS_WINDOWS
+                    return _aligned_malloc(size, alignment);
+#else
+                    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+                }
+
+                void deallocate(void* pointer, size_t alignment)
+                {
+                    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                        return free(pointer);
+
+#ifdef OS_WINDOWS
+                    _aligned_free(pointer);
+#else
+                    free(pointer);
+#endif
+                }
+
+                void* allocateOrThrow(size_t size, size_t alignment)
+                {
+                    void* pointer = allocate(size, alignment);
+                    if (!pointer)
+                        throw std::bad_alloc();
+
+                    return pointer;
+                }
+            }
+
+            NoAllocationsScope::NoAllocationsScope()
+            {
+                getThreadState()->noAllocationsDepth++;
+            }
+
+            NoAllocationsScope::~NoAllocationsScope()
+            {
+                getThreadState()->noAllocationsDepth--;
+            }
+#endif
+
+            const char* AllocationTracker::GetTagName(AllocationTag tag)
+            {
+                switch (tag)
+                {
+                    case AllocationTag::Untagged: return "Untagged";
+                    case AllocationTag::Render: return "Render";
+                    case AllocationTag::Submission: return "Submission";
+                    case AllocationTag::Gapi: return "Gapi";
+                    case AllocationTag::Streaming: return "Streaming";
+                    case AllocationTag::Assets: return "Assets";
+                    case AllocationTag::Rfx: return "Rfx";
+                    case AllocationTag::Jobs: return "Jobs";
+                    case AllocationTag::Input: return "Input";
+                    default:
+                        ASSERT_MSG(false, "Unknown allocation tag");
+                        return "Unknown";
+                }
+            }
+
+            void AllocationTracker::SetThreadName(const U8String& name)
+            {
+#ifdef ENABLE_ALLOCATION_TRACKING
+                auto* state = getThreadState();
+
+                std::lock_guard<std::mutex> lock(getRegistryMutex());
+                state->name = name;
+#else
+                std::ignore = name;
+#endif
+            }
+
+            void AllocationTracker::EndFrame(uint64_t frameIndex)
+            {
+                FrameStatistics frame;
+                frame.frameIndex = frameIndex;
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+                {
+                    std::lock_guard<std::mutex> lock(getRegistryMutex());
+
+                    for (auto* state = threadStates.load(std::memory_order_acquire); state; state = state->next)
+                    {
+                        ThreadStatistics thread;
+
+                        for (size_t tag = 0; tag < thread.tags.size(); tag++)
+                        {
+                            const AllocationCounters current = { state->counts[tag].load(std::memory_order_relaxed),
+                                                                 state->bytes[tag].load(std::memory_order_relaxed) };
+
+                            thread.tags[tag] = { current.count - state->previous[tag].count, current.bytes - state->previous[tag].bytes };
+                            thread.total += thread.tags[tag];
+                            frame.tags[tag] += thread.tags[tag];
+
+                            state->previous[tag] = current;
+                        }
+
+                        if (thread.total.count == 0)
+                            continue;
+
+                        thread.threadName = state->name;
+                        frame.total += thread.total;
+                        frame.threads.push_back(std::move(thread));
+                    }
+                }
+#endif
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                lastFrame_ = std::move(frame);
+            }
+
+            AllocationTracker::FrameStatistics AllocationTracker::GetLastFrame() const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return lastFrame_;
+            }
+        }
+    }
+}
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+// Replaceable global allocation functions, every operator new of the process goes through the tracker.
+using RR::Common::Debug::allocate;
+using RR::Common::Debug::allocateOrThrow;
+using RR::Common::Debug::deallocate;
+
+void* operator new(size_t size) { return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, size_t) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer, size_t) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<size_t>(alignment)); }
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+#include "common/String.hpp"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#define ALLOCATION_SCOPE_NAME2(y) allocationScope_##y
+#define ALLOCATION_SCOPE_NAME(y) ALLOCATION_SCOPE_NAME2(y)
+// Allocations of the calling thread are attributed to tag until the end of the scope.
+#define ALLOCATION_TAG_SCOPE(tag) const RR::Common::Debug::AllocationTagScope ALLOCATION_SCOPE_NAME(__COUNTER__)(RR::Common::Debug::AllocationTag::tag);
+// Any heap allocation of the calling thread until the end of the scope is an assert.
+#define ASSERT_NO_ALLOCATIONS_SCOPE() const RR::Common::Debug::NoAllocationsScope ALLOCATION_SCOPE_NAME(__COUNTER__);
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+            enum class AllocationTag : uint8_t
+            {
+                Untagged,
+                Render,
+                Submission,
+                Gapi,
+                Streaming,
+                Assets,
+                Rfx,
+                Jobs,
+                Input,
+                Count
+            };
+
+            namespace Details
+            {
+                struct AllocationThreadState;
+
+                // Kept in every configuration, memory statistics attribute allocations by it as well.
+                inline thread_local AllocationTag currentAllocationTag = AllocationTag::Untagged;
+            }
+
+            struct AllocationCounters
+            {
+                uint64_t count = 0;
+                uint64_t bytes = 0;
+
+                inline AllocationCounters& operator+=(const AllocationCounters& other)
+                {
+                    count += other.count;
+                    bytes += other.bytes;
+                    return *this;
+                }
+            };
+
+            using AllocationTagCounters = std::array<AllocationCounters, static_cast<size_t>(AllocationTag::Count)>;
+
+            // Counts operator new calls per thread and tag, with ENABLE_ALLOCATION_TRACKING only.
+            // Counters are written by owning thread without atomic read-modify-write, EndFrame turns them into per frame deltas.
+            class AllocationTracker final : public Singleton<AllocationTracker>
+            {
+            public:
+                struct ThreadStatistics
+                {
+                    U8String threadName;
+                    AllocationTagCounters tags;
+                    AllocationCounters total;
+                };
+
+                struct FrameStatistics
+                {
+                    uint64_t frameIndex = 0;
+                    AllocationTagCounters tags;
+                    AllocationCounters total;
+                    // Only threads that allocated during the frame.
+                    std::vector<ThreadStatistics> threads;
+                };
+
+            public:
+#ifdef ENABLE_ALLOCATION_TRACKING
+                static constexpr bool IsEnabled = true;
+#else
+                static constexpr bool IsEnabled = false;
+#endif
+
+                static const char* GetTagName(AllocationTag tag);
+                // Tag of the innermost ALLOCATION_TAG_SCOPE of the calling thread.
+                static inline AllocationTag GetCurrentTag() { return Details::currentAllocationTag; }
+
+                // Names thread in statistics.
+                static void SetThreadName(const U8String& name);
+
+                // Closes the frame: statistics of allocations since previous call become available with GetLastFrame.
+                void EndFrame(uint64_t frameIndex);
+                FrameStatistics GetLastFrame() const;
+
+            private:
+                mutable std::mutex mutex_;
+                FrameStatistics lastFrame_;
+            };
+
+            class AllocationTagScope final : private NonCopyable, NonMovable
+            {
+            public:
+                explicit AllocationTagScope(AllocationTag tag) : previousTag_(Details::currentAllocationTag)
+                {
+                    Details::currentAllocationTag = tag;
+                }
+
+                ~AllocationTagScope() { Details::currentAllocationTag = previousTag_; }
+
+            private:
+                AllocationTag previousTag_;
+            };
+
+            // Hot paths expected to run from preallocated storage, so allocation regressions show up immediately.
+            class NoAllocationsScope final : private NonCopyable, NonMovable
+            {
+            public:
+#ifdef ENABLE_ALLOCATION_TRACKING
+                NoAllocationsScope();
+                ~NoAllocationsScope();
+#else
+                NoAllocationsScope() { }
+#endif
+            };
+        }
+    }
+}
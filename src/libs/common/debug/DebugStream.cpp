@@ -2,6 +2,12 @@
 
 #if defined(OS_WINDOWS)
 
+#include "common/debug/Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
 #include <windows.h>
 
 namespace RR
@@ -18,36 +24,100 @@ namespace RR
             template <class CharT, class TraitsT = std::char_traits<CharT>>
             class DebugStringBuffer : public std::basic_streambuf<CharT, TraitsT>
             {
+            public:
+                using int_type = typename TraitsT::int_type;
+
+                DebugStringBuffer()
+                {
+                    // Last character is reserved for terminator.
+                    this->setp(buffer_.data(), buffer_.data() + buffer_.size() - 1);
+                }
+
+                ~DebugStringBuffer() { flush(); }
+
+                void SetAsync(bool async) { isAsync_.store(async, std::memory_order_relaxed); }
+
             private:
-                inline std::streamsize xsputn(const CharT* s, std::streamsize n) override
+                std::streamsize xsputn(const CharT* s, std::streamsize n) override
                 {
-                    OutputDebugString(s);
+                    for (std::streamsize written = 0; written < n;)
+                    {
+                        if (this->pptr() == this->epptr())
+                            flush();
+
+                        const auto count = std::min<std::streamsize>(n - written, this->epptr() - this->pptr());
+                        const auto chunk = s + written;
+
+                        TraitsT::copy(this->pptr(), chunk, static_cast<size_t>(count));
+                        this->pbump(static_cast<int>(count));
+                        written += count;
+
+                        if (std::find(chunk, chunk + count, CharT('\n')) != chunk + count)
+                            flush();
+                    }
+
                     return n;
                 }
 
-                inline int_type overflow(int_type c) override
+                int_type overflow(int_type c) override
                 {
                     if (TraitsT::eq_int_type(c, TraitsT::eof()))
                         return TraitsT::not_eof(c);
 
-                    CharT str[] = { TraitsT::to_char_type(c), '\0' };
-                    OutputDebugString(&str[0]);
+                    // Put area is full.
+                    flush();
+
+                    *this->pptr() = TraitsT::to_char_type(c);
+                    this->pbump(1);
+
+                    if (TraitsT::eq(TraitsT::to_char_type(c), CharT('\n')))
+                        flush();
+
                     return c;
                 }
 
-                void OutputDebugString(const CharT* text) { }
+                int sync() override
+                {
+                    flush();
+                    return 0;
+                }
+
+                void flush()
+                {
+                    if (this->pptr() == this->pbase())
+                        return;
+
+                    *this->pptr() = CharT('\0');
+                    write(this->pbase());
+                    this->setp(buffer_.data(), buffer_.data() + buffer_.size() - 1);
+                }
+
+                void write(const CharT* text);
+
+            private:
+                static constexpr size_t BufferSize = 4096;
+
+                std::array<CharT, BufferSize> buffer_;
+                std::atomic<bool> isAsync_ = false;
             };
 
             template <>
-            void DebugStringBuffer<char>::OutputDebugString(const char* text)
+            void DebugStringBuffer<char>::write(const char* text)
             {
-                ::OutputDebugStringA(text);
+                // Logger writes back with WriteDebugOutput, so text doesn't come here again.
+                if (isAsync_.load(std::memory_order_relaxed))
+                    Logger::Push<Log::Details::FormatFormatter>(Logger::Level::Info, Log::Details::Literal { "{}" }, U8String(text));
+                else
+                    ::OutputDebugStringA(text);
             }
 
             template <>
-            void DebugStringBuffer<wchar_t>::OutputDebugString(const wchar_t* text)
+            void DebugStringBuffer<wchar_t>::write(const wchar_t* text)
             {
-                ::OutputDebugStringW(text);
+                if (isAsync_.load(std::memory_order_relaxed))
+                    Logger::Push<Log::Details::FormatFormatter>(Logger::Level::Info, Log::Details::Literal { "{}" }, StringConversions::WStringToUTF8(text));
+                else
+                    ::OutputDebugStringW(text);
             }
 
             template <class CharT, class TraitsT>
@@ -59,9 +129,23 @@ namespace RR
             template <class CharT, class TraitsT>
             DebugStream<CharT, TraitsT>::~DebugStream()
             {
-                delete rdbuf();
+                delete this->rdbuf();
+            }
+
+            template <class CharT, class TraitsT>
+            void DebugStream<CharT, TraitsT>::SetAsync(bool async)
+            {
+                static_cast<DebugStringBuffer<CharT, TraitsT>*>(this->rdbuf())->SetAsync(async);
+            }
+
+            template class DebugStream<char>;
+            template class DebugStream<wchar_t>;
+
+            void WriteDebugOutput(const wchar_t* text)
+            {
+                ::OutputDebugStringW(text);
             }
         }
     }
 }
-#endif
\ No newline at end of file
+#endif
@@ -10,14 +10,22 @@ namespace RR
         namespace Debug
         {
 #if defined(OS_WINDOWS)
+            // Output is buffered and goes to debugger in one call per line, per full buffer or per std::flush.
             template <class CharT, class TraitsT = std::char_traits<CharT>>
             class DebugStream : public std::basic_ostream<CharT, TraitsT>
             {
             public:
                 DebugStream();
                 ~DebugStream();
+
+                // Flushed text is queued to logger writer thread while it runs, instead of being written on calling thread.
+                // Such text is logged as Info and is filtered by logger level.
+                void SetAsync(bool async);
             };
 
+            // Writes text to debugger in one call, bypassing streams. For logger writer, which batches messages itself.
+            void WriteDebugOutput(const wchar_t* text);
+
             using ADebugStream = DebugStream<char>;
             using WDebugStream = DebugStream<wchar_t>;
 
@@ -2,6 +2,12 @@
 
 #include "common/debug/DebugStream.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #if defined(OS_WINDOWS)
 #include <windows.h>
 #endif
@@ -16,26 +22,279 @@ namespace RR
     {
         namespace Debug
         {
-            void debugBreak()
+            namespace
             {
+                constexpr size_t RingCapacity = 64 * 1024;
+                // Larger records are formatted on calling thread.
+                constexpr size_t MaxRecordSize = RingCapacity / 4;
+                constexpr auto WriteInterval = std::chrono::milliseconds(10);
+
+                constexpr size_t alignRecord(size_t size)
+                {
+                    return (size + Log::Details::RecordAlignment - 1) / Log::Details::RecordAlignment * Log::Details::RecordAlignment;
+                }
+
+                struct RecordHeader
+                {
+                    uint32_t size;
+                    // Null for padding at the end of ring.
+                    void (*process)(void* payload, U8String* output);
+                };
+                static_assert(sizeof(RecordHeader) <= Log::Details::RecordAlignment, "Every gap at the end of ring should fit padding header");
+
+                constexpr size_t HeaderSize = alignRecord(sizeof(RecordHeader));
+
+                void debugBreak()
+                {
 #if defined(OS_LINUX) || defined(OS_APPLE)
-                raise(SIGTRAP);
+                    raise(SIGTRAP);
 #elif _MSC_VER && !__INTEL_COMPILER
-                __debugbreak();
+                    __debugbreak();
 #else
-                __asm__("int3");
+                    __asm__("int3");
 #endif
-            }
+                }
 
-            void Logger::Log(Level level, const U8String& msg)
-            {
+                std::mutex writeMutex;
+
+                void write(const U8String& msg)
+                {
+                    std::lock_guard<std::mutex> lock(writeMutex);
 #if defined(OS_WINDOWS)
-                // No utf-8 support;
-                Debug::WStream << StringConversions::UTF8ToWString(msg).c_str();
-                std::wcerr << StringConversions::UTF8ToWString(msg).c_str();
+                    // No utf-8 support. Batch goes to debugger in one call, not line by line through the stream buffer.
+                    const auto wideMsg = StringConversions::UTF8ToWString(msg);
+                    Debug::WriteDebugOutput(wideMsg.c_str());
+                    std::wcerr << wideMsg.c_str();
 #else
-                Debug::Stream << msg.c_str();
+                    Debug::Stream << msg.c_str();
 #endif
+                }
+
+                // Single producer single consumer ring of records of one logging thread, drained by writer thread.
+                class Ring final : private NonCopyable, NonMovable
+                {
+                public:
+                    void* Allocate(size_t size, void (*process)(void*, U8String*))
+                    {
+                        const size_t recordSize = HeaderSize + alignRecord(size);
+                        if (recordSize > MaxRecordSize)
+                            return nullptr;
+
+                        uint64_t tail = tail_.load(std::memory_order_relaxed);
+                        size_t position = tail % RingCapacity;
+                        const size_t padding = position + recordSize > RingCapacity ? RingCapacity - position : 0;
+
+                        if (tail + padding + recordSize - head_.load(std::memory_order_acquire) > RingCapacity)
+                            return nullptr;
+
+                        if (padding > 0)
+                        {
+                            *reinterpret_cast<RecordHeader*>(buffer_ + position) = { static_cast<uint32_t>(padding), nullptr };
+                            tail += padding;
+                            position = 0;
+                        }
+
+                        *reinterpret_cast<RecordHeader*>(buffer_ + position) = { static_cast<uint32_t>(recordSize), process };
+                        pendingTail_ = tail + recordSize;
+
+                        return buffer_ + position + HeaderSize;
+                    }
+
+                    void Commit() { tail_.store(pendingTail_, std::memory_order_release); }
+
+                    // Formats committed records into output and releases them.
+                    void Drain(U8String* output)
+                    {
+                        uint64_t head = head_.load(std::memory_order_relaxed);
+                        const uint64_t tail = tail_.load(std::memory_order_acquire);
+
+                        while (head < tail)
+                        {
+                            uint8_t* record = buffer_ + head % RingCapacity;
+                            const auto& header = *reinterpret_cast<RecordHeader*>(record);
+
+                            if (header.process)
+                                header.process(record + HeaderSize, output);
+
+                            head += header.size;
+                        }
+
+                        head_.store(head, std::memory_order_release);
+                    }
+
+                    bool IsEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+                private:
+                    alignas(64) std::atomic<uint64_t> head_ = 0;
+                    alignas(64) std::atomic<uint64_t> tail_ = 0;
+                    uint64_t pendingTail_ = 0;
+                    alignas(Log::Details::RecordAlignment) uint8_t buffer_[RingCapacity];
+                };
+
+                // Uses std primitives directly, Threading locks may be profiled and log themselves.
+                class AsyncWriter final
+                {
+                public:
+                    ~AsyncWriter() { Terminate(); }
+
+                    void Init()
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (isRunning_)
+                            return;
+
+                        terminate_ = false;
+                        thread_ = std::thread([this]() { writerFunc(); });
+                        isRunning_.store(true, std::memory_order_release);
+                    }
+
+                    void Terminate()
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            if (!isRunning_)
+                                return;
+
+                            isRunning_.store(false, std::memory_order_seq_cst);
+                            terminate_ = true;
+                            wake_.notify_one();
+                        }
+
+                        thread_.join();
+
+                        // Producers that saw writer running commit their records before the final drain,
+                        // later ones see it stopped and write synchronously.
+                        while (activeProducers_.load(std::memory_order_acquire) != 0)
+                            std::this_thread::yield();
+
+                        // Records pushed while writer was stopping.
+                        U8String batch;
+                        for (const auto& ring : rings_)
+                            ring->Drain(&batch);
+
+                        if (!batch.empty())
+                            write(batch);
+                    }
+
+                    void Flush()
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        if (!isRunning_ || std::this_thread::get_id() == thread_.get_id())
+                            return;
+
+                        const uint64_t target = ++flushRequested_;
+                        wake_.notify_one();
+                        flushed_.wait(lock, [&]() { return flushCompleted_ >= target || !isRunning_; });
+                    }
+
+                    // Record is counted from before the running check until Commit, so Terminate waits for it.
+                    void* Allocate(size_t size, void (*process)(void*, U8String*))
+                    {
+                        activeProducers_.fetch_add(1, std::memory_order_seq_cst);
+
+                        if (!isRunning_.load(std::memory_order_seq_cst))
+                        {
+                            activeProducers_.fetch_sub(1, std::memory_order_release);
+                            return nullptr;
+                        }
+
+                        thread_local std::shared_ptr<Ring> threadRing;
+                        if (!threadRing)
+                        {
+                            threadRing = std::make_shared<Ring>();
+
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            rings_.push_back(threadRing);
+                        }
+
+                        ring_ = threadRing.get();
+                        if (void* storage = ring_->Allocate(size, process))
+                            return storage;
+
+                        // Full ring, wait for writer instead of reordering messages.
+                        Flush();
+                        if (void* storage = ring_->Allocate(size, process))
+                            return storage;
+
+                        activeProducers_.fetch_sub(1, std::memory_order_release);
+                        return nullptr;
+                    }
+
+                    void Commit()
+                    {
+                        ring_->Commit();
+                        activeProducers_.fetch_sub(1, std::memory_order_release);
+                    }
+
+                private:
+                    void writerFunc()
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+
+                        while (true)
+                        {
+                            wake_.wait_for(lock, WriteInterval, [&]() { return terminate_ || flushRequested_ != flushCompleted_; });
+
+                            const bool terminate = terminate_;
+                            const uint64_t flushTarget = flushRequested_;
+                            auto rings = rings_;
+                            lock.unlock();
+
+                            U8String batch;
+                            for (const auto& ring : rings)
+                                ring->Drain(&batch);
+
+                            if (!batch.empty())
+                                write(batch);
+
+                            rings.clear();
+                            lock.lock();
+
+                            // Owner thread is gone when registry holds the last reference.
+                            rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                                        [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 1 && ring->IsEmpty(); }),
+                                         rings_.end());
+
+                            flushCompleted_ = flushTarget;
+                            flushed_.notify_all();
+
+                            if (terminate)
+                                break;
+                        }
+                    }
+
+                private:
+                    static thread_local Ring* ring_;
+
+                    std::mutex mutex_;
+                    std::condition_variable wake_;
+                    std::condition_variable flushed_;
+                    std::vector<std::shared_ptr<Ring>> rings_;
+                    uint64_t flushRequested_ = 0;
+                    uint64_t flushCompleted_ = 0;
+                    bool terminate_ = false;
+                    std::atomic<bool> isRunning_ = false;
+                    // Records between Allocate and Commit, or rejected by stopped writer.
+                    std::atomic<uint32_t> activeProducers_ = 0;
+                    std::thread thread_;
+                };
+
+                thread_local Ring* AsyncWriter::ring_ = nullptr;
+
+                AsyncWriter asyncWriter;
+            }
+
+            std::atomic<Logger::Level> Logger::minLevel_ = Logger::Level::Info;
+
+            void Logger::Log(Level level, const U8String& msg)
+            {
+                if (!IsEnabled(level))
+                    return;
+
+                if (level == Level::Fatal)
+                    asyncWriter.Flush();
+
+                write(msg);
 
                 if (level == Level::Fatal)
                 {
@@ -44,6 +303,37 @@ namespace RR
                     exit(1);
                 }
             }
+
+            void Logger::SetLevel(Level level)
+            {
+                minLevel_.store(level, std::memory_order_relaxed);
+            }
+
+            void Logger::InitAsync()
+            {
+                asyncWriter.Init();
+            }
+
+            void Logger::TerminateAsync()
+            {
+                asyncWriter.Terminate();
+            }
+
+            void Logger::Flush()
+            {
+                asyncWriter.Flush();
+            }
+
+            void* Logger::allocateRecord(size_t size, Level level, ProcessFunction process)
+            {
+                (void)level;
+                return asyncWriter.Allocate(size, process);
+            }
+
+            void Logger::commitRecord()
+            {
+                asyncWriter.Commit();
+            }
         }
     }
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <new>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 
 #include "common/String.hpp"
 
@@ -24,17 +28,16 @@ namespace RR
 #define ASSERT_MSG(ignore) ((void)0);
 #endif
 
-#define LOG_INFO(...) \
-    Log::Format::Info("INFO:\n  {0}({1}):\n  {2}\n  {3}\n", __FILE__, __LINE__, __FUNCTION__, fmt::sprintf(__VA_ARGS__));
+// Source location and message are formatted by the writer thread, nothing is formatted when level is filtered out.
+#define LOG_SITE(level, kind, ...)                                                                                           \
+    if (Logger::IsEnabled(level))                                                                                            \
+        Logger::Push<Log::Details::SiteFormatter>(level, Log::Details::Literal { kind }, Log::Details::Literal { __FILE__ }, \
+                                                  __LINE__, Log::Details::Literal { __FUNCTION__ }, __VA_ARGS__);
 
-#define LOG_WARNING(...) \
-    Log::Format::Warning("WARNING:\n  {0}({1}):\n  {2}\n  {3}\n", __FILE__, __LINE__, __FUNCTION__, fmt::sprintf(__VA_ARGS__));
-
-#define LOG_ERROR(...) \
-    Log::Format::Error("ERROR:\n  {0}({1}):\n  {2}\n  {3}\n", __FILE__, __LINE__, __FUNCTION__, fmt::sprintf(__VA_ARGS__));
-
-#define LOG_FATAL(...) \
-    Log::Format::Fatal("FATAL:\n  {0}({1}):\n  {2}\n  {3}\n", __FILE__, __LINE__, __FUNCTION__, fmt::sprintf(__VA_ARGS__));
+#define LOG_INFO(...) LOG_SITE(Logger::Level::Info, "INFO", __VA_ARGS__)
+#define LOG_WARNING(...) LOG_SITE(Logger::Level::Warning, "WARNING", __VA_ARGS__)
+#define LOG_ERROR(...) LOG_SITE(Logger::Level::Error, "ERROR", __VA_ARGS__)
+#define LOG_FATAL(...) LOG_SITE(Logger::Level::Fatal, "FATAL", __VA_ARGS__)
 
             class Logger
             {
@@ -49,28 +52,133 @@ namespace RR
                 };
 
                 static void Log(Level level, const U8String& msg);
+
+                // Messages below level are dropped before formatting. Fatal messages always terminate.
+                static void SetLevel(Level level);
+                static inline bool IsEnabled(Level level)
+                {
+                    const auto minLevel = minLevel_.load(std::memory_order_relaxed);
+                    return level == Level::Fatal || (minLevel != Level::Disabled && level >= minLevel);
+                }
+
+                // Between InitAsync and TerminateAsync messages are queued in per thread rings and formatted
+                // and written in batches by writer thread. Otherwise, and for fatal messages, they are written on calling thread.
+                static void InitAsync();
+                static void TerminateAsync();
+                // Blocks until messages queued so far are written.
+                static void Flush();
+
+                // Queues Formatter::Format(args...) call. Strings arguments are copied, other arguments are stored by value.
+                template <typename Formatter, typename... Args>
+                static void Push(Level level, Args&&... args);
+
+            private:
+                using ProcessFunction = void (*)(void* payload, U8String* output);
+
+                // Returns storage in calling thread ring, nullptr if async writer isn't running or ring has no space.
+                static void* allocateRecord(size_t size, Level level, ProcessFunction process);
+                static void commitRecord();
+
+            private:
+                static std::atomic<Level> minLevel_;
             };
 
             namespace Log
             {
+                namespace Details
+                {
+                    static constexpr size_t RecordAlignment = alignof(std::max_align_t);
+
+                    // String with static storage duration, stored by pointer.
+                    struct Literal
+                    {
+                        const char* value;
+                    };
+
+                    template <typename T, typename Decayed = std::decay_t<T>>
+                    using IsString = std::disjunction<std::is_same<Decayed, const char*>, std::is_same<Decayed, char*>,
+                                                      std::is_same<Decayed, std::string_view>>;
+
+                    // Pointers and arrays may not outlive the call, so they are copied.
+                    template <typename T>
+                    using PackedType = std::conditional_t<IsString<T>::value, U8String, std::decay_t<T>>;
+
+                    template <typename T>
+                    inline const T& Unpack(const T& value) { return value; }
+                    inline const char* Unpack(const Literal& literal) { return literal.value; }
+
+                    template <typename Formatter, typename... Args>
+                    struct Record
+                    {
+                        template <typename... From>
+                        Record(From&&... from) : args(std::forward<From>(from)...) { }
+
+                        static void Process(void* payload, U8String* output)
+                        {
+                            auto record = static_cast<Record*>(payload);
+
+                            if (output)
+                                *output += std::apply([](const auto&... args) { return Formatter::Format(Unpack(args)...); }, record->args);
+
+                            record->~Record();
+                        }
+
+                        std::tuple<Args...> args;
+                    };
+
+                    struct PrintFormatter
+                    {
+                        template <typename S, typename... Args>
+                        static U8String Format(const S& format, const Args&... args) { return fmt::sprintf(format, args...); }
+                    };
+
+                    struct FormatFormatter
+                    {
+                        template <typename S, typename... Args>
+                        static U8String Format(const S& format, const Args&... args) { return fmt::format(format, args...); }
+                    };
+
+                    struct SiteFormatter
+                    {
+                        template <typename S, typename... Args>
+                        static U8String Format(const char* kind, const char* file, int line, const char* function, const S& format, const Args&... args)
+                        {
+                            return fmt::format("{0}:\n  {1}({2}):\n  {3}\n  {4}\n", kind, file, line, function, fmt::sprintf(format, args...));
+                        }
+                    };
+
+                    // Format strings given as arrays are literals, unlike other arrays they are safe to keep by pointer.
+                    template <typename S>
+                    inline auto FormatString(const S& format)
+                    {
+                        if constexpr (std::is_array<S>::value)
+                            return Literal { format };
+                        else
+                            return format;
+                    }
+                }
+
                 namespace Print
                 {
                     template <typename S, typename... Args>
                     inline void Info(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Info, fmt::sprintf(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Info))
+                            Logger::Push<Details::PrintFormatter>(Logger::Level::Info, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
                     inline void Warning(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Warning, fmt::sprintf(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Warning))
+                            Logger::Push<Details::PrintFormatter>(Logger::Level::Warning, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
                     inline void Error(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Error, fmt::sprintf(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Error))
+                            Logger::Push<Details::PrintFormatter>(Logger::Level::Error, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
@@ -84,19 +192,22 @@ namespace RR
                     template <typename S, typename... Args>
                     inline void Info(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Info, fmt::format(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Info))
+                            Logger::Push<Details::FormatFormatter>(Logger::Level::Info, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
                     inline void Warning(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Warning, fmt::format(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Warning))
+                            Logger::Push<Details::FormatFormatter>(Logger::Level::Warning, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
                     inline void Error(const S& format, Args&&... args)
                     {
-                        Logger::Log(Logger::Level::Error, fmt::format(format, args...));
+                        if (Logger::IsEnabled(Logger::Level::Error))
+                            Logger::Push<Details::FormatFormatter>(Logger::Level::Error, Details::FormatString(format), std::forward<Args>(args)...);
                     }
 
                     template <typename S, typename... Args>
@@ -106,6 +217,25 @@ namespace RR
                     }
                 }
             }
+
+            template <typename Formatter, typename... Args>
+            inline void Logger::Push(Level level, Args&&... args)
+            {
+                using Record = Log::Details::Record<Formatter, Log::Details::PackedType<Args>...>;
+                static_assert(alignof(Record) <= Log::Details::RecordAlignment, "Overaligned log arguments");
+
+                if (level != Level::Fatal)
+                {
+                    if (void* storage = allocateRecord(sizeof(Record), level, &Record::Process))
+                    {
+                        new (storage) Record(std::forward<Args>(args)...);
+                        commitRecord();
+                        return;
+                    }
+                }
+
+                Log(level, Formatter::Format(Log::Details::Unpack(args)...));
+            }
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "MemoryStats.hpp"
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+            const char* MemoryStats::GetKindName(MemoryKind kind)
+            {
+                switch (kind)
+                {
+                    case MemoryKind::Cpu: return "Cpu";
+                    case MemoryKind::Gpu: return "Gpu";
+                    default:
+                        ASSERT_MSG(false, "Unknown memory kind");
+                        return "Unknown";
+                }
+            }
+
+            MemoryStats::AtomicCounters& MemoryStats::getCounters(AllocationTag tag, MemoryKind kind)
+            {
+                ASSERT(tag < AllocationTag::Count);
+                ASSERT(kind < MemoryKind::Count);
+
+                return Instance().counters_[static_cast<size_t>(tag)][static_cast<size_t>(kind)];
+            }
+
+            void MemoryStats::OnAllocate(AllocationTag tag, MemoryKind kind, uint64_t size)
+            {
+                auto& counters = getCounters(tag, kind);
+
+                counters.allocations.fetch_add(1, std::memory_order_relaxed);
+                const auto bytes = counters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+                auto peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+                while (bytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, bytes, std::memory_order_relaxed)) { }
+            }
+
+            void MemoryStats::OnFree(AllocationTag tag, MemoryKind kind, uint64_t size)
+            {
+                auto& counters = getCounters(tag, kind);
+
+                ASSERT(counters.allocations.load(std::memory_order_relaxed) > 0);
+                ASSERT(counters.bytes.load(std::memory_order_relaxed) >= size);
+
+                counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+                counters.bytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            MemoryStats::Statistics MemoryStats::GetStatistics() const
+            {
+                Statistics statistics;
+
+                for (size_t tag = 0; tag < statistics.size(); tag++)
+                    for (size_t kind = 0; kind < statistics[tag].size(); kind++)
+                    {
+                        const auto& counters = counters_[tag][kind];
+                        statistics[tag][kind] = { counters.bytes.load(std::memory_order_relaxed),
+                                                  counters.peakBytes.load(std::memory_order_relaxed),
+                                                  counters.allocations.load(std::memory_order_relaxed) };
+                    }
+
+                return statistics;
+            }
+
+            void MemoryStats::EndFrame(uint64_t frameIndex) const
+            {
+                const auto dumpInterval = dumpInterval_.load(std::memory_order_relaxed);
+                if (dumpInterval == 0 || frameIndex % dumpInterval != 0)
+                    return;
+
+                Dump();
+            }
+
+            void MemoryStats::Dump() const
+            {
+                const auto statistics = GetStatistics();
+
+                for (size_t tag = 0; tag < statistics.size(); tag++)
+                    for (size_t kind = 0; kind < statistics[tag].size(); kind++)
+                    {
+                        const auto& counters = statistics[tag][kind];
+                        if (counters.peakBytes == 0)
+                            continue;
+
+                        Log::Print::Info("Memory %s %s: %.3fMB in %u allocations, peak %.3fMB\n",
+                                         AllocationTracker::GetTagName(static_cast<AllocationTag>(tag)),
+                                         GetKindName(static_cast<MemoryKind>(kind)),
+                                         counters.bytes / (1024.0 * 1024.0), counters.allocations,
+                                         counters.peakBytes / (1024.0 * 1024.0));
+                    }
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+#include "common/debug/AllocationTracker.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+            enum class MemoryKind : uint8_t
+            {
+                // System memory owned by engine allocators.
+                Cpu,
+                // Graphics API heaps.
+                Gpu,
+                Count
+            };
+
+            // Live memory per subsystem tag and kind, reported by allocators at page or heap granularity.
+            // Unlike AllocationTracker it's on in every configuration: counters are relaxed atomics, touched on allocator growth only.
+            class MemoryStats final : public Singleton<MemoryStats>
+            {
+            public:
+                struct Counters
+                {
+                    uint64_t bytes = 0;
+                    uint64_t peakBytes = 0;
+                    uint64_t allocations = 0;
+                };
+
+                using KindCounters = std::array<Counters, static_cast<size_t>(MemoryKind::Count)>;
+                using Statistics = std::array<KindCounters, static_cast<size_t>(AllocationTag::Count)>;
+
+            public:
+                static const char* GetKindName(MemoryKind kind);
+
+                // Tag should be the same for the allocation and its release, allocators keep it along with allocation.
+                static void OnAllocate(AllocationTag tag, MemoryKind kind, uint64_t size);
+                static void OnFree(AllocationTag tag, MemoryKind kind, uint64_t size);
+
+                Statistics GetStatistics() const;
+
+                // Dumps statistics every framesInterval frames from EndFrame, zero disables dumping.
+                void SetDumpInterval(uint32_t framesInterval) { dumpInterval_.store(framesInterval, std::memory_order_relaxed); }
+                void EndFrame(uint64_t frameIndex) const;
+                void Dump() const;
+
+            private:
+                struct AtomicCounters
+                {
+                    std::atomic<uint64_t> bytes = 0;
+                    std::atomic<uint64_t> peakBytes = 0;
+                    std::atomic<uint64_t> allocations = 0;
+                };
+
+                static AtomicCounters& getCounters(AllocationTag tag, MemoryKind kind);
+
+            private:
+                std::array<std::array<AtomicCounters, static_cast<size_t>(MemoryKind::Count)>, static_cast<size_t>(AllocationTag::Count)> counters_;
+                std::atomic<uint32_t> dumpInterval_ = 0;
+            };
+        }
+    }
+}
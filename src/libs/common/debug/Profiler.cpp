@@ -0,0 +1,352 @@
+#include "Profiler.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+            namespace Details
+            {
+                // Append only list of event chunks written by owning thread. Readers see events up to chunk count,
+                // published with release store, so exporting doesn't stop threads still closing scopes.
+                struct ProfilerThreadBuffer final : private NonCopyable, NonMovable
+                {
+                    static constexpr uint32_t ChunkSize = 4096;
+                    // Limits capture to ~24 MB per thread, later scopes are dropped.
+                    static constexpr uint32_t MaxChunks = 256;
+
+                    struct Event
+                    {
+                        const char* name;
+                        uint64_t startNs;
+                        uint64_t endNs;
+                    };
+
+                    struct Chunk
+                    {
+                        std::array<Event, ChunkSize> events;
+                        std::atomic<uint32_t> count = 0;
+                        std::atomic<Chunk*> next = nullptr;
+                    };
+
+                    ~ProfilerThreadBuffer()
+                    {
+                        auto chunk = head.next.load(std::memory_order_relaxed);
+                        while (chunk)
+                        {
+                            const auto next = chunk->next.load(std::memory_order_relaxed);
+                            delete chunk;
+                            chunk = next;
+                        }
+                    }
+
+                    // Written by owning thread only.
+                    void Reset(uint32_t newGeneration)
+                    {
+                        for (auto chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_relaxed))
+                            chunk->count.store(0, std::memory_order_relaxed);
+
+                        tail = &head;
+                        dropped.store(0, std::memory_order_relaxed);
+                        generation.store(newGeneration, std::memory_order_release);
+                    }
+
+                    void Push(const char* name, uint64_t startNs, uint64_t endNs)
+                    {
+                        auto count = tail->count.load(std::memory_order_relaxed);
+                        if (count == ChunkSize)
+                        {
+                            auto next = tail->next.load(std::memory_order_relaxed);
+                            if (!next)
+                            {
+                                if (chunksCount >= MaxChunks)
+                                {
+                                    dropped.fetch_add(1, std::memory_order_relaxed);
+                                    return;
+                                }
+
+                                next = new Chunk();
+                                chunksCount++;
+                                tail->next.store(next, std::memory_order_release);
+                            }
+
+                            tail = next;
+                            count = 0;
+                        }
+
+                        tail->events[count] = { name, startNs, endNs };
+                        tail->count.store(count + 1, std::memory_order_release);
+                    }
+
+                    template <typename Visitor>
+                    void ForEach(const Visitor& visitor) const
+                    {
+                        for (auto chunk = &head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+                        {
+                            const auto count = chunk->count.load(std::memory_order_acquire);
+                            for (uint32_t index = 0; index < count; index++)
+                                visitor(chunk->events[index]);
+                        }
+                    }
+
+                    // Visits events pushed since the previous call, read position restarts with new generation.
+                    template <typename Visitor>
+                    void ForEachNew(uint32_t currentGeneration, const Visitor& visitor)
+                    {
+                        if (readGeneration != currentGeneration)
+                        {
+                            readGeneration = currentGeneration;
+                            readChunk = &head;
+                            readIndex = 0;
+                        }
+
+                        for (;;)
+                        {
+                            const auto count = readChunk->count.load(std::memory_order_acquire);
+                            for (; readIndex < count; readIndex++)
+                                visitor(readChunk->events[readIndex]);
+
+                            // Owner is still filling the chunk.
+                            if (readIndex < ChunkSize)
+                                return;
+
+                            const auto next = readChunk->next.load(std::memory_order_acquire);
+                            if (!next)
+                                return;
+
+                            readChunk = next;
+                            readIndex = 0;
+                        }
+                    }
+
+                    uint32_t id = 0;
+                    // Guarded by profiler mutex.
+                    U8String name;
+                    // Read position of ReadNewScopes, guarded by profiler mutex.
+                    uint32_t readGeneration = 0;
+                    const Chunk* readChunk = nullptr;
+                    uint32_t readIndex = 0;
+
+                    std::atomic<uint32_t> generation = 0;
+                    std::atomic<uint64_t> dropped = 0;
+
+                    Chunk head;
+                    Chunk* tail = &head;
+                    uint32_t chunksCount = 1;
+                };
+            }
+
+            namespace
+            {
+                constexpr uint32_t CpuProcessId = 1;
+                constexpr uint32_t GpuProcessId = 2;
+
+                U8String escapeJson(const U8String& string)
+                {
+                    U8String result;
+                    result.reserve(string.size());
+
+                    for (const char symbol : string)
+                    {
+                        switch (symbol)
+                        {
+                            case '"': result += "\\\""; break;
+                            case '\\': result += "\\\\"; break;
+                            case '\n': result += "\\n"; break;
+                            case '\t': result += "\\t"; break;
+                            default:
+                                if (static_cast<unsigned char>(symbol) < 0x20)
+                                    result += fmt::format("\\u{:04x}", static_cast<uint32_t>(symbol));
+                                else
+                                    result += symbol;
+                        }
+                    }
+
+                    return result;
+                }
+            }
+
+            std::atomic<bool> Profiler::capturing_ = false;
+            std::atomic<uint32_t> Profiler::generation_ = 0;
+
+            Details::ProfilerThreadBuffer& Profiler::getThreadBuffer()
+            {
+                thread_local std::shared_ptr<Details::ProfilerThreadBuffer> buffer;
+
+                if (!buffer)
+                {
+                    buffer = std::make_shared<Details::ProfilerThreadBuffer>();
+
+                    auto& profiler = Profiler::Instance();
+                    std::lock_guard<std::mutex> lock(profiler.mutex_);
+
+                    static uint32_t nextId = 0;
+                    buffer->id = nextId++;
+                    buffer->name = fmt::format("Thread {}", buffer->id);
+                    profiler.threadBuffers_.push_back(buffer);
+                }
+
+                return *buffer;
+            }
+
+            void Profiler::BeginCapture()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                // Buffers of exited threads are owned by registry only.
+                threadBuffers_.erase(std::remove_if(threadBuffers_.begin(), threadBuffers_.end(),
+                                                    [](const auto& buffer) { return buffer.use_count() == 1; }),
+                                     threadBuffers_.end());
+                gpuScopes_.clear();
+                gpuScopesRead_ = 0;
+
+                // Buffers still holding previous generation are reset by their threads on next scope.
+                generation_.fetch_add(1, std::memory_order_release);
+                captureStartNs_ = Now();
+                captureEndNs_ = std::numeric_limits<uint64_t>::max();
+                capturing_.store(true, std::memory_order_release);
+            }
+
+            void Profiler::EndCapture()
+            {
+                capturing_.store(false, std::memory_order_release);
+                captureEndNs_ = Now();
+            }
+
+            void Profiler::SetThreadName(const U8String& name)
+            {
+                auto& buffer = getThreadBuffer();
+
+                std::lock_guard<std::mutex> lock(Profiler::Instance().mutex_);
+                buffer.name = name;
+
+                AllocationTracker::SetThreadName(name);
+            }
+
+            void Profiler::RecordScope(const char* name, uint64_t startNs, uint64_t endNs)
+            {
+                auto& buffer = getThreadBuffer();
+
+                const auto generation = generation_.load(std::memory_order_acquire);
+                if (buffer.generation.load(std::memory_order_relaxed) != generation)
+                    buffer.Reset(generation);
+
+                buffer.Push(name, startNs, endNs);
+            }
+
+            void Profiler::RecordGpuScope(const U8String& name, uint64_t startNs, uint64_t endNs, uint32_t depth)
+            {
+                if (!IsCapturing())
+                    return;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                gpuScopes_.push_back({ name, startNs, endNs, depth });
+            }
+
+            void Profiler::ReadNewScopes(StreamedScopes& scopes)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                const uint64_t captureStartNs = captureStartNs_;
+                const auto generation = generation_.load(std::memory_order_acquire);
+
+                for (const auto& buffer : threadBuffers_)
+                {
+                    // Thread recorded nothing since capture began.
+                    if (buffer->generation.load(std::memory_order_acquire) != generation)
+                        continue;
+
+                    if (buffer->readGeneration != generation)
+                        scopes.threads.push_back({ buffer->id, buffer->name });
+
+                    buffer->ForEachNew(generation, [&](const Details::ProfilerThreadBuffer::Event& event) {
+                        // Scope began before capture.
+                        if (event.startNs >= captureStartNs)
+                            scopes.cpuScopes.push_back({ event.name, buffer->id, event.startNs, event.endNs });
+                    });
+                }
+
+                scopes.gpuScopes.insert(scopes.gpuScopes.end(), gpuScopes_.begin() + gpuScopesRead_, gpuScopes_.end());
+                gpuScopesRead_ = gpuScopes_.size();
+            }
+
+            bool Profiler::ExportChromeTrace(const U8String& path) const
+            {
+                ASSERT(!IsCapturing());
+
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    Log::Format::Error("Failed to open profiler trace file {}\n", path);
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                const uint64_t captureStartNs = captureStartNs_;
+                const uint64_t captureEndNs = captureEndNs_;
+                const auto toUs = [captureStartNs](uint64_t ns) { return static_cast<double>(ns - captureStartNs) / 1000.0; };
+
+                bool first = true;
+                const auto writeEvent = [&file, &first](const U8String& event) {
+                    file << (first ? "\n" : ",\n") << event;
+                    first = false;
+                };
+
+                file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+                writeEvent(fmt::format("{{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":{},\"tid\":0,\"args\":{{\"name\":\"CPU\"}}}}", CpuProcessId));
+                writeEvent(fmt::format("{{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":{},\"tid\":0,\"args\":{{\"name\":\"GPU\"}}}}", GpuProcessId));
+
+                const auto generation = generation_.load(std::memory_order_acquire);
+                for (const auto& buffer : threadBuffers_)
+                {
+                    // Thread recorded nothing since capture began.
+                    if (buffer->generation.load(std::memory_order_acquire) != generation)
+                        continue;
+
+                    writeEvent(fmt::format("{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                                           CpuProcessId, buffer->id, escapeJson(buffer->name)));
+
+                    buffer->ForEach([&](const Details::ProfilerThreadBuffer::Event& event) {
+                        // Scope began before capture or closed after it ended.
+                        if (event.startNs < captureStartNs || event.endNs > captureEndNs)
+                            return;
+
+                        writeEvent(fmt::format("{{\"ph\":\"X\",\"name\":\"{}\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                               escapeJson(event.name), CpuProcessId, buffer->id, toUs(event.startNs),
+                                               static_cast<double>(event.endNs - event.startNs) / 1000.0));
+                    });
+
+                    if (const auto dropped = buffer->dropped.load(std::memory_order_relaxed))
+                        Log::Format::Warning("Profiler dropped {} scopes of thread {}, capture is too long\n", dropped, buffer->name);
+                }
+
+                writeEvent(fmt::format("{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":{},\"tid\":0,\"args\":{{\"name\":\"Timestamps\"}}}}", GpuProcessId));
+
+                for (const auto& scope : gpuScopes_)
+                {
+                    // GPU timeline is estimated from clock calibration and may start slightly before capture.
+                    const auto startNs = std::max(scope.startNs, captureStartNs);
+                    const auto endNs = std::max(scope.endNs, startNs);
+
+                    writeEvent(fmt::format("{{\"ph\":\"X\",\"name\":\"{}\",\"pid\":{},\"tid\":0,\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"depth\":{}}}}}",
+                                           escapeJson(scope.name), GpuProcessId, toUs(startNs),
+                                           static_cast<double>(endNs - startNs) / 1000.0, scope.depth));
+                }
+
+                file << "\n]}\n";
+
+                return file.good();
+            }
+        }
+    }
+}
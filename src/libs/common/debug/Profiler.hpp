@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+#include "common/String.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define PROFILE_SCOPE_NAME2(y) profileScope_##y
+#define PROFILE_SCOPE_NAME(y) PROFILE_SCOPE_NAME2(y)
+// Name has to have static storage duration, it's stored by pointer.
+#define PROFILE_SCOPE(name) const RR::Common::Debug::ProfileScope PROFILE_SCOPE_NAME(__COUNTER__)(name);
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Debug
+        {
+            namespace Details
+            {
+                struct ProfilerThreadBuffer;
+            }
+
+            // Collects CPU scopes of all threads and GPU markers between BeginCapture and EndCapture
+            // and exports them on one timeline. Scopes are written to per thread buffers without locks,
+            // scope outside of capture costs one relaxed load.
+            class Profiler final : public Singleton<Profiler>
+            {
+            public:
+                struct GpuScope
+                {
+                    U8String name;
+                    uint64_t startNs;
+                    uint64_t endNs;
+                    uint32_t depth;
+                };
+
+                struct StreamedThread
+                {
+                    uint32_t id;
+                    U8String name;
+                };
+
+                struct StreamedScope
+                {
+                    const char* name;
+                    uint32_t threadId;
+                    uint64_t startNs;
+                    uint64_t endNs;
+                };
+
+                struct StreamedScopes
+                {
+                    // Threads which recorded their first scopes of the capture.
+                    std::vector<StreamedThread> threads;
+                    std::vector<StreamedScope> cpuScopes;
+                    std::vector<GpuScope> gpuScopes;
+                };
+
+                // Nanoseconds of steady clock, the time base of every recorded event.
+                static inline uint64_t Now()
+                {
+                    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     std::chrono::steady_clock::now().time_since_epoch())
+                                                     .count());
+                }
+
+                static inline bool IsCapturing() { return capturing_.load(std::memory_order_relaxed); }
+
+                // Drops previous capture.
+                void BeginCapture();
+                void EndCapture();
+
+                // Names track of the calling thread in exported trace and in allocation statistics.
+                static void SetThreadName(const U8String& name);
+
+                static void RecordScope(const char* name, uint64_t startNs, uint64_t endNs);
+                // GPU markers go to separate track. Depth is nesting level of the marker.
+                void RecordGpuScope(const U8String& name, uint64_t startNs, uint64_t endNs, uint32_t depth);
+
+                // Writes captured events in Chrome trace event format, loadable by chrome://tracing and Perfetto.
+                // Has to be called after EndCapture.
+                bool ExportChromeTrace(const U8String& path) const;
+
+                // Appends scopes closed since the previous call, for streaming of capture in progress. Scopes of each thread
+                // come in order they closed. Any thread, but single reader: read positions are kept by profiler.
+                void ReadNewScopes(StreamedScopes& scopes);
+
+            private:
+                static Details::ProfilerThreadBuffer& getThreadBuffer();
+
+            private:
+                static std::atomic<bool> capturing_;
+                static std::atomic<uint32_t> generation_;
+
+                std::atomic<uint64_t> captureStartNs_ = 0;
+                std::atomic<uint64_t> captureEndNs_ = 0;
+
+                mutable std::mutex mutex_;
+                std::vector<std::shared_ptr<Details::ProfilerThreadBuffer>> threadBuffers_;
+                std::vector<GpuScope> gpuScopes_;
+                size_t gpuScopesRead_ = 0;
+            };
+
+            class ProfileScope final : private NonCopyable, NonMovable
+            {
+            public:
+                explicit ProfileScope(const char* name) : name_(name), startNs_(Profiler::IsCapturing() ? Profiler::Now() : 0) { }
+
+                ~ProfileScope()
+                {
+                    if (startNs_ != 0)
+                        Profiler::RecordScope(name_, startNs_, Profiler::Now());
+                }
+
+            private:
+                const char* name_;
+                uint64_t startNs_;
+            };
+        }
+    }
+}
@@ -1,8 +1,14 @@
 #pragma once
 
+#include "common/threading/Mutex.hpp"
+
 #include <mutex>
 #include <shared_mutex>
 
+#ifdef ENABLE_LOCK_PROFILING
+#include <typeinfo>
+#endif
+
 namespace RR
 {
     namespace Common
@@ -10,16 +16,17 @@ namespace RR
         namespace Threading
         {
             // Todo Threading::Mutex
+            // Read mostly data shared across threads should rather use Snapshot or SeqLock, readers there never block.
             template <typename T>
             class AccessGuard
             {
                 // std::shared_mutex does not guarantee that there will be no problems with unique look starvation. But we will hope the best.
                 // Might be it would be better to use this shared mutex https://github.com/AlexeyAB/object_threadsafe/blob/master/contfree_shared_mutex/safe_ptr.h
-                using SharedMutex = std::shared_mutex;
+                using SharedMutex = Threading::SharedMutex;
 
             public:
                 template <typename... Args>
-                AccessGuard(Args... args) : ptr_(std::make_shared<T>(args...)), mutex_(std::make_shared<SharedMutex>()) { }
+                AccessGuard(Args... args) : ptr_(std::make_shared<T>(args...)), mutex_(makeMutex()) { }
 
                 ~AccessGuard() = default;
 
@@ -36,6 +43,16 @@ namespace RR
                 }
 
             private:
+                static std::shared_ptr<SharedMutex> makeMutex()
+                {
+#ifdef ENABLE_LOCK_PROFILING
+                    // Construction site would be inside make_shared, guarded type names the site instead.
+                    return std::make_shared<SharedMutex>(typeid(T).name(), 0);
+#else
+                    return std::make_shared<SharedMutex>();
+#endif
+                }
+
                 template <typename LockType>
                 class Pointer
                 {
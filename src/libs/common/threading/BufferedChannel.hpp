@@ -1,8 +1,9 @@
 #pragma once
 
 #include "common/CircularBuffer.hpp"
-#include "common/threading/ConditionVariable.hpp"
 #include "common/threading/Mutex.hpp"
+#include "common/threading/Semaphore.hpp"
+#include "common/threading/SpinLock.hpp"
 
 #include <atomic>
 #include <optional>
@@ -13,83 +14,99 @@ namespace RR
     {
         namespace Threading
         {
+            // Bounded channel. Free slots and queued items are counted by semaphores, so blocked producer or consumer
+            // wakes without mutex handoff. Spin lock guards only buffer push and pop.
             template <typename T, std::size_t BufferSize>
             class BufferedChannel
             {
             public:
-                BufferedChannel() = default;
+                BufferedChannel() : freeSlots_(static_cast<uint32_t>(BufferSize)) { }
                 ~BufferedChannel() = default;
 
-                inline void Put(const T& obj)
-                {
-                    if (closed_)
-                        return;
+                inline void Put(const T& obj) { put(T(obj)); }
+                inline void Put(T&& obj) { put(std::move(obj)); }
 
-                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                inline std::optional<T> GetNext()
+                {
+                    items_.Acquire();
+                    return pop();
+                }
 
-                    if (buffer_.full())
-                    {
-                        outputWait_.wait(lock, [&]() { return !buffer_.full() || closed_; });
-                        if (closed_)
-                            return;
-                    }
+                inline std::optional<T> TryGetNext()
+                {
+                    if (!items_.TryAcquire())
+                        return std::nullopt;
 
-                    buffer_.push_back(obj);
-                    inputWait_.notify_one();
+                    return pop();
                 }
 
-                inline std::optional<T> GetNext()
+                // Consumers still get items put before close.
+                inline void Close()
                 {
-                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    closed_ = true;
 
-                    if (buffer_.empty())
-                    {
-                        if (closed_)
-                            return std::nullopt;
+                    // Extra count wakes one blocked thread of each side, which passes it to the next one.
+                    items_.Release();
+                    freeSlots_.Release();
+                }
 
-                        inputWait_.wait(lock, [&]() { return !buffer_.empty() || closed_; });
+                inline bool IsClosed() const { return closed_; }
 
-                        if (buffer_.empty() && closed_)
-                            return std::nullopt;
+            private:
+                inline void put(T&& obj)
+                {
+                    if (closed_)
+                        return;
+
+                    freeSlots_.Acquire();
+
+                    if (closed_)
+                    {
+                        freeSlots_.Release();
+                        return;
                     }
 
-                    const auto temp = std::make_optional<T>(std::move(buffer_.front()));
-                    buffer_.pop_front();
-                    outputWait_.notify_one();
+                    {
+                        UniqueLock<SpinLock> lock(lock_);
+                        buffer_.push_back(std::move(obj));
+                    }
 
-                    return std::move(temp);
+                    items_.Release();
                 }
 
-                inline std::optional<T> TryGetNext()
+                inline std::optional<T> pop()
                 {
-                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    std::optional<T> result;
 
-                    if (buffer_.empty())
-                        return std::nullopt;
+                    {
+                        UniqueLock<SpinLock> lock(lock_);
 
-                    auto temp = std::make_optional<T>(std::move(buffer_.front()));
-                    buffer_.pop_front();
-                    outputWait_.notify_one();
+                        if (!buffer_.empty())
+                        {
+                            result.emplace(std::move(buffer_.front()));
+                            buffer_.pop_front();
+                        }
+                    }
 
-                    return std::move(temp);
-                }
+                    if (!result)
+                    {
+                        // Count came from Close, buffer is drained.
+                        ASSERT(closed_);
+                        items_.Release();
+                        return std::nullopt;
+                    }
 
-                inline void Close()
-                {
-                    closed_ = true;
-                    inputWait_.notify_all();
-                    outputWait_.notify_all();
+                    freeSlots_.Release();
+                    return result;
                 }
 
-                inline bool IsClosed() const { return closed_; }
-
             private:
                 std::atomic<bool> closed_ = false;
-                Threading::ConditionVariable inputWait_;
-                Threading::ConditionVariable outputWait_;
-                Threading::Mutex mutex_;
+                Semaphore freeSlots_;
+                Semaphore items_;
+                SpinLock lock_;
                 CircularBuffer<T, BufferSize> buffer_;
             };
         }
     }
-}
\ No newline at end of file
+}
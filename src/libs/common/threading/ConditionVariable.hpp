@@ -9,7 +9,12 @@ namespace RR
         namespace Threading
         {
             // Type alias
+#ifdef ENABLE_LOCK_PROFILING
+            // Profiled mutex isn't std::mutex.
+            using ConditionVariable = std::condition_variable_any;
+#else
             using ConditionVariable = std::condition_variable;
+#endif
         }
     }
 }
\ No newline at end of file
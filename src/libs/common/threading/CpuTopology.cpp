@@ -0,0 +1,231 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef OS_WINDOWS
+#include <windows.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            namespace
+            {
+                // Masks hold 64 processors, the rest of larger systems isn't placed.
+                constexpr uint32_t MaxProcessors = 64;
+
+#if !defined(OS_WINDOWS) && defined(__linux__)
+                bool readFile(const std::string& path, std::string& value)
+                {
+                    std::ifstream file(path);
+                    return static_cast<bool>(std::getline(file, value));
+                }
+
+                // Kernel cpu list format, e.g. "0-3,8,10-11".
+                uint64_t parseCpuList(const std::string& list)
+                {
+                    uint64_t mask = 0;
+                    size_t position = 0;
+
+                    while (position < list.size())
+                    {
+                        size_t end = list.find(',', position);
+                        if (end == std::string::npos)
+                            end = list.size();
+
+                        const auto range = list.substr(position, end - position);
+                        const auto dash = range.find('-');
+                        const auto first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+                        const auto last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+
+                        for (uint32_t cpu = first; cpu <= last && cpu < MaxProcessors; cpu++)
+                            mask |= uint64_t(1) << cpu;
+
+                        position = end + 1;
+                    }
+
+                    return mask;
+                }
+#endif
+            }
+
+            const CpuTopology& CpuTopology::Get()
+            {
+                static const CpuTopology topology;
+                return topology;
+            }
+
+            CpuTopology::CpuTopology()
+            {
+                detect();
+
+                // Unknown platform or failed query, every logical processor is its own core.
+                if (cores_.empty())
+                {
+                    const uint32_t count = std::min(std::max(std::thread::hardware_concurrency(), 1u), MaxProcessors);
+                    for (uint32_t index = 0; index < count; index++)
+                        cores_.push_back({ { 0, uint64_t(1) << index }, 0, 0 });
+                }
+
+                finalize();
+            }
+
+#ifdef OS_WINDOWS
+            void CpuTopology::detect()
+            {
+                DWORD length = 0;
+                GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+                if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+                    return;
+
+                std::vector<uint8_t> buffer(length);
+                if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+                    return;
+
+                BYTE lastLevel = 0;
+
+                for (DWORD offset = 0; offset < length;)
+                {
+                    const auto info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+                    offset += info->Size;
+
+                    if (info->Relationship == RelationProcessorCore)
+                    {
+                        const auto& groupMask = info->Processor.GroupMask[0];
+                        cores_.push_back({ { groupMask.Group, static_cast<uint64_t>(groupMask.Mask) }, info->Processor.EfficiencyClass, 0 });
+                    }
+                    else if (info->Relationship == RelationCache && info->Cache.Type != CacheInstruction && info->Cache.Level >= lastLevel)
+                    {
+                        if (info->Cache.Level > lastLevel)
+                            lastLevelCaches_.clear();
+
+                        lastLevel = info->Cache.Level;
+                        lastLevelCaches_.push_back({ info->Cache.GroupMask.Group, static_cast<uint64_t>(info->Cache.GroupMask.Mask) });
+                    }
+                }
+            }
+#elif defined(__linux__)
+            void CpuTopology::detect()
+            {
+                // Intel hybrid CPUs list performance cores separately, other CPUs expose relative capacity per core.
+                std::string performanceCpus;
+                const bool hasPerformanceCpus = readFile("/sys/devices/cpu_core/cpus", performanceCpus);
+                const uint64_t performanceMask = hasPerformanceCpus ? parseCpuList(performanceCpus) : 0;
+
+                std::vector<uint32_t> capacities;
+                int lastLevel = 0;
+
+                for (uint32_t cpu = 0; cpu < MaxProcessors; cpu++)
+                {
+                    const auto cpuPath = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+
+                    std::string siblings;
+                    if (!readFile(cpuPath + "/topology/thread_siblings_list", siblings))
+                        continue;
+
+                    const uint64_t coreMask = parseCpuList(siblings);
+                    // Core is reported by each of its siblings.
+                    if ((coreMask & (uint64_t(1) << cpu)) == 0 || (coreMask & ((uint64_t(1) << cpu) - 1)) != 0)
+                        continue;
+
+                    uint32_t capacity = 0;
+                    std::string value;
+                    if (hasPerformanceCpus)
+                        capacity = (performanceMask & coreMask) ? 1 : 0;
+                    else if (readFile(cpuPath + "/cpu_capacity", value))
+                        capacity = static_cast<uint32_t>(std::stoul(value));
+
+                    cores_.push_back({ { 0, coreMask }, 0, 0 });
+                    capacities.push_back(capacity);
+
+                    for (uint32_t index = 0;; index++)
+                    {
+                        const auto cachePath = cpuPath + "/cache/index" + std::to_string(index);
+                        std::string type, level, shared;
+                        if (!readFile(cachePath + "/type", type) || !readFile(cachePath + "/level", level) || !readFile(cachePath + "/shared_cpu_list", shared))
+                            break;
+
+                        if (type == "Instruction" || std::stoi(level) < lastLevel)
+                            continue;
+
+                        if (std::stoi(level) > lastLevel)
+                            lastLevelCaches_.clear();
+
+                        lastLevel = std::stoi(level);
+
+                        const AffinityMask cacheMask = { 0, parseCpuList(shared) };
+                        const bool isKnown = std::any_of(lastLevelCaches_.begin(), lastLevelCaches_.end(),
+                                                         [&cacheMask](const AffinityMask& mask) { return mask.mask == cacheMask.mask; });
+                        if (!isKnown)
+                            lastLevelCaches_.push_back(cacheMask);
+                    }
+                }
+
+                // Capacities are ranked into efficiency classes, as on Windows.
+                auto distinct = capacities;
+                std::sort(distinct.begin(), distinct.end());
+                distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+                for (size_t index = 0; index < cores_.size(); index++)
+                    cores_[index].efficiencyClass = static_cast<uint8_t>(std::lower_bound(distinct.begin(), distinct.end(), capacities[index]) - distinct.begin());
+            }
+#else
+            void CpuTopology::detect()
+            {
+            }
+#endif
+
+            void CpuTopology::finalize()
+            {
+                if (lastLevelCaches_.empty())
+                {
+                    AffinityMask cache = { cores_.front().mask.group, 0 };
+                    for (const auto& core : cores_)
+                        cache.mask |= core.mask.group == cache.group ? core.mask.mask : 0;
+
+                    lastLevelCaches_.push_back(cache);
+                }
+
+                for (auto& core : cores_)
+                {
+                    const auto cache = std::find_if(lastLevelCaches_.begin(), lastLevelCaches_.end(), [&core](const AffinityMask& mask) {
+                        return mask.group == core.mask.group && (mask.mask & core.mask.mask) != 0;
+                    });
+
+                    core.lastLevelCache = cache != lastLevelCaches_.end() ? static_cast<uint32_t>(cache - lastLevelCaches_.begin()) : 0;
+                }
+
+                std::stable_sort(cores_.begin(), cores_.end(), [](const Core& a, const Core& b) {
+                    return a.efficiencyClass != b.efficiencyClass ? a.efficiencyClass > b.efficiencyClass : a.lastLevelCache < b.lastLevelCache;
+                });
+
+                const uint8_t performanceClass = cores_.front().efficiencyClass;
+                const uint16_t group = cores_.front().mask.group;
+
+                performanceCoresMask_ = { group, 0 };
+                allCoresMask_ = { group, 0 };
+                logicalProcessorsCount_ = 0;
+
+                for (const auto& core : cores_)
+                {
+                    logicalProcessorsCount_ += core.mask.GetCount();
+                    isHybrid_ |= core.efficiencyClass != performanceClass;
+
+                    if (core.mask.group != group)
+                        continue;
+
+                    allCoresMask_.mask |= core.mask.mask;
+                    if (core.efficiencyClass == performanceClass)
+                        performanceCoresMask_.mask |= core.mask.mask;
+                }
+            }
+        }
+    }
+}
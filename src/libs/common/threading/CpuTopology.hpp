@@ -0,0 +1,73 @@
+#pragma once
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Logical processors of one processor group, Windows splits systems with more than 64 of them into groups.
+            struct AffinityMask final
+            {
+                uint16_t group = 0;
+                uint64_t mask = 0;
+
+                inline bool IsEmpty() const { return mask == 0; }
+                inline uint32_t GetCount() const
+                {
+                    uint32_t count = 0;
+                    for (uint64_t bits = mask; bits; bits &= bits - 1)
+                        count++;
+
+                    return count;
+                }
+            };
+
+            // Detected once on first access. Aggregate masks cover processor group of first core only.
+            class CpuTopology final
+            {
+            public:
+                struct Core
+                {
+                    // SMT siblings of the core.
+                    AffinityMask mask;
+                    // Higher is faster. All cores share the same class on non hybrid CPUs.
+                    uint8_t efficiencyClass = 0;
+                    // Index into GetLastLevelCaches.
+                    uint32_t lastLevelCache = 0;
+                };
+
+                static const CpuTopology& Get();
+
+                // Ordered from fastest efficiency class, then by last level cache.
+                inline const std::vector<Core>& GetCores() const { return cores_; }
+                // Logical processors sharing each last level cache, CCXs of Zen or P/E core clusters.
+                inline const std::vector<AffinityMask>& GetLastLevelCaches() const { return lastLevelCaches_; }
+
+                inline uint32_t GetPhysicalCoresCount() const { return static_cast<uint32_t>(cores_.size()); }
+                inline uint32_t GetLogicalProcessorsCount() const { return logicalProcessorsCount_; }
+
+                // True when cores differ in efficiency class, e.g. P and E cores.
+                inline bool IsHybrid() const { return isHybrid_; }
+
+                // Logical processors of fastest efficiency class, all processors on non hybrid CPUs.
+                inline const AffinityMask& GetPerformanceCoresMask() const { return performanceCoresMask_; }
+                inline const AffinityMask& GetAllCoresMask() const { return allCoresMask_; }
+
+            private:
+                CpuTopology();
+
+                void detect();
+                void finalize();
+
+            private:
+                std::vector<Core> cores_;
+                std::vector<AffinityMask> lastLevelCaches_;
+                uint32_t logicalProcessorsCount_ = 0;
+                bool isHybrid_ = false;
+                AffinityMask performanceCoresMask_;
+                AffinityMask allCoresMask_;
+            };
+        }
+    }
+}
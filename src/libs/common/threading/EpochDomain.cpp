@@ -0,0 +1,140 @@
+#include "EpochDomain.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            struct ThreadSlot final
+            {
+                ~ThreadSlot()
+                {
+                    if (slot)
+                        EpochDomain::Instance().releaseSlot(slot);
+                }
+
+                EpochDomain::Slot* slot = nullptr;
+                uint32_t depth = 0;
+            };
+
+            namespace
+            {
+                thread_local ThreadSlot threadSlot;
+            }
+
+            EpochDomain::~EpochDomain()
+            {
+                // No readers left at static destruction.
+                for (const auto& retired : retired_)
+                    retired.deleter(retired.object);
+
+                for (Slot* slot = slots_.load(std::memory_order_acquire); slot;)
+                {
+                    Slot* next = slot->next;
+                    delete slot;
+                    slot = next;
+                }
+            }
+
+            void EpochDomain::enter()
+            {
+                if (threadSlot.depth++ > 0)
+                    return;
+
+                if (!threadSlot.slot)
+                    threadSlot.slot = acquireSlot();
+
+                // Reader that got an advanced epoch sees the version published before it. Sequentially consistent
+                // store, so reclaimer scanning after publishing either sees this reader or the reader sees the new version.
+                threadSlot.slot->epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            }
+
+            void EpochDomain::leave()
+            {
+                ASSERT(threadSlot.depth > 0);
+
+                if (--threadSlot.depth > 0)
+                    return;
+
+                threadSlot.slot->epoch.store(0, std::memory_order_release);
+            }
+
+            EpochDomain::Slot* EpochDomain::acquireSlot()
+            {
+                for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next)
+                {
+                    bool expected = false;
+                    if (!slot->inUse.load(std::memory_order_relaxed) && slot->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                        return slot;
+                }
+
+                // Slots are never unlinked, so push doesn't suffer from ABA.
+                Slot* slot = new Slot();
+                slot->inUse.store(true, std::memory_order_relaxed);
+                slot->next = slots_.load(std::memory_order_relaxed);
+                while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) { }
+
+                return slot;
+            }
+
+            void EpochDomain::releaseSlot(Slot* slot)
+            {
+                ASSERT(slot->epoch.load(std::memory_order_relaxed) == 0);
+                slot->inUse.store(false, std::memory_order_release);
+            }
+
+            void EpochDomain::Retire(void* object, Deleter deleter)
+            {
+                ASSERT(object);
+                ASSERT(deleter);
+
+                // Readers entered up to this epoch may hold the object, later ones can't reach it.
+                const uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+                std::vector<Retired> reclaimed;
+                {
+                    UniqueLock<Mutex> lock(retiredMutex_);
+                    retired_.push_back({ object, deleter, epoch });
+                    collect(reclaimed);
+                }
+
+                // Deleters run outside of the lock, destructors may retire nested objects.
+                for (const auto& retired : reclaimed)
+                    retired.deleter(retired.object);
+            }
+
+            void EpochDomain::Collect()
+            {
+                std::vector<Retired> reclaimed;
+                {
+                    UniqueLock<Mutex> lock(retiredMutex_);
+                    collect(reclaimed);
+                }
+
+                for (const auto& retired : reclaimed)
+                    retired.deleter(retired.object);
+            }
+
+            void EpochDomain::collect(std::vector<Retired>& reclaimed)
+            {
+                uint64_t oldestReader = std::numeric_limits<uint64_t>::max();
+                for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next)
+                {
+                    const uint64_t epoch = slot->epoch.load(std::memory_order_seq_cst);
+                    if (epoch != 0)
+                        oldestReader = std::min(oldestReader, epoch);
+                }
+
+                const auto reachable = std::partition(retired_.begin(), retired_.end(),
+                                                      [oldestReader](const Retired& retired) { return retired.epoch >= oldestReader; });
+
+                reclaimed.assign(reachable, retired_.end());
+                retired_.erase(reachable, retired_.end());
+            }
+        }
+    }
+}
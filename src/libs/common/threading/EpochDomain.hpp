@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Epoch based reclamation for read-copy-update structures.
+            // Readers publish the epoch they entered at, retired objects are deleted once every reader
+            // that could have seen them left. Entering and leaving is a load and a store, readers never wait.
+            class EpochDomain final : public Singleton<EpochDomain>
+            {
+            public:
+                using Deleter = void (*)(void*);
+
+                // Scoped read side critical section, nested sections are allowed.
+                class ReadSection final : private Common::NonCopyable, Common::NonMovable
+                {
+                public:
+                    ReadSection() { EpochDomain::Instance().enter(); }
+                    ~ReadSection() { EpochDomain::Instance().leave(); }
+                };
+
+            public:
+                EpochDomain() = default;
+                ~EpochDomain();
+
+                // Object must be already unreachable for new readers.
+                void Retire(void* object, Deleter deleter);
+
+                // Deletes retired objects no reader can reference anymore.
+                void Collect();
+
+                inline size_t GetRetiredCount() const
+                {
+                    UniqueLock<Mutex> lock(retiredMutex_);
+                    return retired_.size();
+                }
+
+            private:
+                // One per thread that ever read, reused after thread exit.
+                struct alignas(64) Slot
+                {
+                    // Zero when thread is outside of read section.
+                    std::atomic<uint64_t> epoch = 0;
+                    std::atomic<bool> inUse = false;
+                    Slot* next = nullptr;
+                };
+
+                struct Retired
+                {
+                    void* object;
+                    Deleter deleter;
+                    uint64_t epoch;
+                };
+
+                friend struct ThreadSlot;
+
+                void enter();
+                void leave();
+
+                Slot* acquireSlot();
+                void releaseSlot(Slot* slot);
+
+                void collect(std::vector<Retired>& reclaimed);
+
+            private:
+                std::atomic<uint64_t> epoch_ = 1;
+                std::atomic<Slot*> slots_ = nullptr;
+
+                mutable Mutex retiredMutex_;
+                std::vector<Retired> retired_;
+            };
+        }
+    }
+}
@@ -1,7 +1,8 @@
 #pragma once
 
-#include "common/threading/ConditionVariable.hpp"
-#include "common/threading/Mutex.hpp"
+#include "common/threading/Futex.hpp"
+
+#include <chrono>
 
 namespace RR
 {
@@ -9,59 +10,104 @@ namespace RR
     {
         namespace Threading
         {
-            const uint32_t INFINITE_WAIT = 0xFFFFFFFF;
-
+            // Waits spin briefly and then park on the state word (WaitOnAddress/futex).
+            // Notify makes a syscall only when some thread is parked.
             class Event final : private NonCopyable, NonMovable
             {
             public:
-                Event(bool manualReset = true, bool initialState = false) : manualReset_(manualReset), state_(initialState) { }
+                Event(bool manualReset = true, bool initialState = false) : state_(initialState ? Signaled : 0), manualReset_(manualReset) { }
                 ~Event() = default;
 
                 inline void Reset()
                 {
-                    UniqueLock<Mutex> lock(mutex_);
-                    state_ = false;
+                    state_.fetch_and(~Signaled, std::memory_order_relaxed);
                 }
 
                 inline void Notify()
                 {
+                    // Single read-modify-write, so waiter may destroy the event as soon as it's signaled.
+                    const uint32_t previous = state_.fetch_or(Signaled, std::memory_order_acq_rel);
+                    if (previous < ParkedWaiter)
+                        return;
+
+                    // Auto reset event releases a single waiter anyway.
+                    if (manualReset_)
+                        Details::WakeAll(state_);
+                    else
+                        Details::WakeOne(state_);
+                }
+
+                inline bool Wait(uint32_t milliseconds = INFINITE_WAIT)
+                {
+                    if (tryConsume())
+                        return true;
+
+                    if (milliseconds == 0)
+                        return false;
+
+                    if (Details::SpinUntil([this] { return tryConsume(); }))
+                        return true;
+
+                    return park(milliseconds);
+                }
+
+            private:
+                // Low bit is signaled state, the rest counts parked waiters.
+                static constexpr uint32_t Signaled = 1;
+                static constexpr uint32_t ParkedWaiter = 2;
+
+                inline bool tryConsume()
+                {
+                    uint32_t state = state_.load(std::memory_order_acquire);
+                    if (manualReset_)
+                        return (state & Signaled) != 0;
+
+                    while (state & Signaled)
                     {
-                        UniqueLock<Mutex> lock(mutex_);
-                        state_ = true;
+                        if (state_.compare_exchange_weak(state, state & ~Signaled, std::memory_order_acquire, std::memory_order_relaxed))
+                            return true;
                     }
 
-                    condition_.notify_all();
+                    return false;
                 }
 
-                inline bool Wait(uint32_t milliseconds = INFINITE_WAIT)
+                inline bool park(uint32_t milliseconds)
                 {
-                    UniqueLock<Mutex> lock(mutex_);
-                    bool result = true;
+                    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+                    state_.fetch_add(ParkedWaiter, std::memory_order_relaxed);
 
-                    if (state_ == false)
+                    bool result = true;
+                    while (!tryConsume())
                     {
-                        if (milliseconds == INFINITE_WAIT)
-                        {
-                            condition_.wait(lock, [&]() { return state_; });
-                        }
-                        else
+                        uint32_t timeout = INFINITE_WAIT;
+                        if (milliseconds != INFINITE_WAIT)
                         {
-                            result = condition_.wait_for(lock, std::chrono::milliseconds(milliseconds), [&]() { return state_; });
+                            // Rounded up, truncated remainder would return before the deadline.
+                            const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                            if (left <= 0)
+                            {
+                                result = false;
+                                break;
+                            }
+
+                            timeout = static_cast<uint32_t>(left);
                         }
-                    }
 
-                    if (!manualReset_)
-                        state_ = false;
+                        // Returns right away if word changed since, e.g. by notify or another waiter parking.
+                        const uint32_t state = state_.load(std::memory_order_relaxed);
+                        if ((state & Signaled) == 0)
+                            Details::WaitOnWord(state_, state, timeout);
+                    }
 
+                    state_.fetch_sub(ParkedWaiter, std::memory_order_relaxed);
                     return result;
                 }
 
             private:
-                Mutex mutex_;
-                ConditionVariable condition_;
-                bool state_ = false;
+                std::atomic<uint32_t> state_;
                 bool manualReset_ = true;
             };
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,89 @@
+#include "Futex.hpp"
+
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RR_SPIN_PAUSE() _mm_pause()
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#define RR_SPIN_PAUSE() __yield()
+#elif defined(__aarch64__)
+#define RR_SPIN_PAUSE() __asm__ __volatile__("yield")
+#else
+#define RR_SPIN_PAUSE()
+#endif
+
+#ifdef OS_WINDOWS
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            namespace Details
+            {
+                bool WaitOnWord(std::atomic<uint32_t>& word, uint32_t value, uint32_t milliseconds)
+                {
+#ifdef OS_WINDOWS
+                    const DWORD timeout = milliseconds == INFINITE_WAIT ? INFINITE : milliseconds;
+                    if (::WaitOnAddress(reinterpret_cast<volatile VOID*>(&word), &value, sizeof(value), timeout))
+                        return true;
+
+                    return GetLastError() != ERROR_TIMEOUT;
+#elif defined(__linux__)
+                    timespec timeout;
+                    timeout.tv_sec = milliseconds / 1000;
+                    timeout.tv_nsec = static_cast<long>(milliseconds % 1000) * 1000000;
+
+                    const auto result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, value,
+                                                milliseconds == INFINITE_WAIT ? nullptr : &timeout, nullptr, 0);
+                    return result == 0 || errno != ETIMEDOUT;
+#else
+                    (void)word;
+                    (void)value;
+                    (void)milliseconds;
+                    std::this_thread::yield();
+                    return true;
+#endif
+                }
+
+                void WakeOne(std::atomic<uint32_t>& word)
+                {
+#ifdef OS_WINDOWS
+                    WakeByAddressSingle(reinterpret_cast<PVOID>(&word));
+#elif defined(__linux__)
+                    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+                    (void)word;
+#endif
+                }
+
+                void WakeAll(std::atomic<uint32_t>& word)
+                {
+#ifdef OS_WINDOWS
+                    WakeByAddressAll(reinterpret_cast<PVOID>(&word));
+#elif defined(__linux__)
+                    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+                    (void)word;
+#endif
+                }
+
+                void SpinPause()
+                {
+                    RR_SPIN_PAUSE();
+                }
+            }
+        }
+    }
+}
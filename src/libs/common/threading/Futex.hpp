@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            const uint32_t INFINITE_WAIT = 0xFFFFFFFF;
+
+            namespace Details
+            {
+                // Blocks while word equals value, on WaitOnAddress or futex. Spurious wakes are allowed.
+                // Returns false only when timeout expired.
+                bool WaitOnWord(std::atomic<uint32_t>& word, uint32_t value, uint32_t milliseconds = INFINITE_WAIT);
+                void WakeOne(std::atomic<uint32_t>& word);
+                void WakeAll(std::atomic<uint32_t>& word);
+
+                // CPU spin wait hint, a few dozen cycles.
+                void SpinPause();
+
+                // Spins with exponential pause backoff, then yields. Cheaper than parking when condition turns true
+                // within a few microseconds, as on frame fences and job completion.
+                template <typename Predicate>
+                bool SpinUntil(Predicate&& predicate)
+                {
+                    // Pauses between attempts double up to this, roughly a microsecond on current cores.
+                    constexpr uint32_t MaxPauseBackoff = 64;
+                    constexpr uint32_t YieldsCount = 8;
+
+                    for (uint32_t backoff = 1; backoff <= MaxPauseBackoff; backoff *= 2)
+                    {
+                        for (uint32_t pause = 0; pause < backoff; pause++)
+                            SpinPause();
+
+                        if (predicate())
+                            return true;
+                    }
+
+                    for (uint32_t index = 0; index < YieldsCount; index++)
+                    {
+                        std::this_thread::yield();
+
+                        if (predicate())
+                            return true;
+                    }
+
+                    return false;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,378 @@
+#include "JobSystem.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/debug/Profiler.hpp"
+
+#include <random>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            namespace Details
+            {
+                struct Job
+                {
+                    JobSystem::JobFunction function;
+                    JobCounter* counter;
+                };
+
+                bool WorkStealingDeque::Push(Job* job)
+                {
+                    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+                    const int64_t top = top_.load(std::memory_order_acquire);
+
+                    if (bottom - top >= static_cast<int64_t>(Capacity))
+                        return false;
+
+                    buffer_[bottom & Mask].store(job, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    bottom_.store(bottom + 1, std::memory_order_relaxed);
+
+                    return true;
+                }
+
+                Job* WorkStealingDeque::Pop()
+                {
+                    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+                    bottom_.store(bottom, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    int64_t top = top_.load(std::memory_order_relaxed);
+
+                    if (top > bottom)
+                    {
+                        bottom_.store(bottom + 1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+
+                    Job* job = buffer_[bottom & Mask].load(std::memory_order_relaxed);
+
+                    // Last job, race against thieves for it.
+                    if (top == bottom)
+                    {
+                        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                            job = nullptr;
+
+                        bottom_.store(bottom + 1, std::memory_order_relaxed);
+                    }
+
+                    return job;
+                }
+
+                Job* WorkStealingDeque::Steal()
+                {
+                    int64_t top = top_.load(std::memory_order_acquire);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+                    if (top >= bottom)
+                        return nullptr;
+
+                    Job* job = buffer_[top & Mask].load(std::memory_order_relaxed);
+                    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        return nullptr;
+
+                    return job;
+                }
+            }
+
+            namespace
+            {
+                constexpr uint32_t SpinCount = 64;
+                constexpr size_t MaxCachedJobs = 1024;
+
+                // Jobs are freed on executing thread and reused by whatever it submits next.
+                struct JobCache
+                {
+                    ~JobCache()
+                    {
+                        for (auto job : jobs)
+                            delete job;
+                    }
+
+                    std::vector<Details::Job*> jobs;
+                };
+
+                thread_local JobCache jobCache;
+                thread_local const JobSystem* currentSystem = nullptr;
+                thread_local uint32_t currentWorker = 0;
+            }
+
+            struct JobSystem::Worker
+            {
+                Details::WorkStealingDeque deque;
+            };
+
+            JobSystem::JobSystem() = default;
+
+            JobSystem::~JobSystem()
+            {
+                Terminate();
+            }
+
+            void JobSystem::Init(uint32_t workersCount)
+            {
+                ASSERT(!isInited_);
+
+                if (workersCount == 0)
+                    workersCount = std::max(Thread::HardwareConcurrency(), 2u) - 1;
+
+                terminate_ = false;
+
+                workers_.reserve(workersCount);
+                for (uint32_t index = 0; index < workersCount; index++)
+                    workers_.push_back(std::make_unique<Worker>());
+
+                threads_.reserve(workersCount);
+                for (uint32_t index = 0; index < workersCount; index++)
+                {
+                    threads_.emplace_back(fmt::sprintf("JobSystem Worker %u", index), [this, index] { workerFunc(index); });
+                    // Frame jobs are latency bound, workers opt out of throttling which moves threads to efficiency cores.
+                    threads_.back().SetQoS(ThreadQoS::High);
+                }
+
+                isInited_ = true;
+            }
+
+            void JobSystem::Terminate()
+            {
+                if (!isInited_)
+                    return;
+
+                {
+                    UniqueLock<Mutex> lock(sleepMutex_);
+                    terminate_ = true;
+                    workAvailable_.notify_all();
+                }
+
+                for (auto& thread : threads_)
+                    thread.Join();
+
+                // Jobs left in queues are executed on calling thread, so their counters complete.
+                // Continuations they release go to the shared queue and are drained as well.
+                while (auto job = findJob())
+                    execute(job);
+
+                ASSERT(queuedJobs_ == 0);
+
+                threads_.clear();
+                workers_.clear();
+                isInited_ = false;
+            }
+
+            void JobSystem::Run(JobFunction&& function, JobCounter* counter)
+            {
+                auto job = allocateJob(std::move(function), counter);
+
+                if (!isInited_)
+                {
+                    execute(job);
+                    return;
+                }
+
+                submit(job);
+            }
+
+            void JobSystem::RunAfter(JobCounter& dependency, JobFunction&& function, JobCounter* counter)
+            {
+                auto job = allocateJob(std::move(function), counter);
+
+                {
+                    UniqueLock<SpinLock> lock(dependency.lock_);
+                    // Finishing job takes continuations under the same lock, so none is lost.
+                    if (dependency.value_.load(std::memory_order_acquire) != 0)
+                    {
+                        dependency.continuations_.push_back(job);
+                        return;
+                    }
+                }
+
+                if (!isInited_)
+                {
+                    execute(job);
+                    return;
+                }
+
+                submit(job);
+            }
+
+            void JobSystem::WaitFor(const JobCounter& counter)
+            {
+                while (!counter.IsDone())
+                {
+                    if (!TryRunOne())
+                        std::this_thread::yield();
+                }
+
+                // Finishing job may still hold the lock, counter can be destroyed only after it releases it.
+                UniqueLock<SpinLock> lock(counter.lock_);
+            }
+
+            Details::Job* JobSystem::allocateJob(JobFunction&& function, JobCounter* counter)
+            {
+                Details::Job* job;
+                if (!jobCache.jobs.empty())
+                {
+                    job = jobCache.jobs.back();
+                    jobCache.jobs.pop_back();
+                }
+                else
+                {
+                    job = new Details::Job();
+                }
+
+                job->function = std::move(function);
+                job->counter = counter;
+
+                if (counter)
+                    counter->value_.fetch_add(1, std::memory_order_relaxed);
+
+                return job;
+            }
+
+            void JobSystem::freeJob(Details::Job* job)
+            {
+                if (jobCache.jobs.size() >= MaxCachedJobs)
+                {
+                    delete job;
+                    return;
+                }
+
+                job->function = JobFunction();
+                jobCache.jobs.push_back(job);
+            }
+
+            void JobSystem::submit(Details::Job* job)
+            {
+                // Counted before push, so thread taking the job never decrements below zero.
+                queuedJobs_.fetch_add(1, std::memory_order_seq_cst);
+
+                const bool isWorker = currentSystem == this;
+                if (!isWorker || !workers_[currentWorker]->deque.Push(job))
+                {
+                    UniqueLock<SpinLock> lock(sharedQueueLock_);
+                    sharedQueue_.push_back(job);
+                }
+
+                if (sleepingWorkers_.load(std::memory_order_seq_cst) > 0)
+                {
+                    UniqueLock<Mutex> lock(sleepMutex_);
+                    workAvailable_.notify_one();
+                }
+            }
+
+            void JobSystem::execute(Details::Job* job)
+            {
+                job->function();
+
+                auto counter = job->counter;
+                freeJob(job);
+
+                if (!counter)
+                    return;
+
+                std::vector<Details::Job*> continuations;
+                {
+                    UniqueLock<SpinLock> lock(counter->lock_);
+                    if (counter->value_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                        return;
+
+                    continuations.swap(counter->continuations_);
+                }
+
+                for (auto continuation : continuations)
+                {
+                    if (isInited_)
+                        submit(continuation);
+                    else
+                        execute(continuation);
+                }
+            }
+
+            Details::Job* JobSystem::findJob()
+            {
+                Details::Job* job = nullptr;
+                const bool isWorker = currentSystem == this;
+
+                if (isWorker)
+                    job = workers_[currentWorker]->deque.Pop();
+
+                if (!job)
+                {
+                    UniqueLock<SpinLock> lock(sharedQueueLock_);
+                    if (!sharedQueue_.empty())
+                    {
+                        job = sharedQueue_.front();
+                        sharedQueue_.pop_front();
+                    }
+                }
+
+                if (!job && !workers_.empty())
+                {
+                    // Victims are visited round robin from random start, so thieves don't pile on one worker.
+                    thread_local std::minstd_rand random(std::random_device {}());
+                    const auto workersCount = static_cast<uint32_t>(workers_.size());
+                    const uint32_t first = static_cast<uint32_t>(random() % workersCount);
+
+                    for (uint32_t offset = 0; offset < workersCount && !job; offset++)
+                    {
+                        const uint32_t victim = (first + offset) % workersCount;
+                        if (!isWorker || victim != currentWorker)
+                            job = workers_[victim]->deque.Steal();
+                    }
+                }
+
+                if (job)
+                    queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+
+                return job;
+            }
+
+            bool JobSystem::TryRunOne()
+            {
+                if (!isInited_)
+                    return false;
+
+                auto job = findJob();
+                if (!job)
+                    return false;
+
+                execute(job);
+                return true;
+            }
+
+            void JobSystem::workerFunc(uint32_t workerIndex)
+            {
+                currentSystem = this;
+                currentWorker = workerIndex;
+                Debug::Profiler::SetThreadName(fmt::sprintf("JobSystem Worker %u", workerIndex));
+                ALLOCATION_TAG_SCOPE(Jobs);
+
+                while (!terminate_)
+                {
+                    bool found = false;
+                    for (uint32_t spin = 0; spin < SpinCount && !found; spin++)
+                    {
+                        found = TryRunOne();
+                        if (!found)
+                            std::this_thread::yield();
+                    }
+
+                    if (found)
+                        continue;
+
+                    sleepingWorkers_.fetch_add(1, std::memory_order_seq_cst);
+                    {
+                        UniqueLock<Mutex> lock(sleepMutex_);
+                        workAvailable_.wait(lock, [&]() { return queuedJobs_.load(std::memory_order_seq_cst) > 0 || terminate_; });
+                    }
+                    sleepingWorkers_.fetch_sub(1, std::memory_order_seq_cst);
+                }
+
+                currentSystem = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "common/InplaceFunction.hpp"
+#include "common/Singleton.hpp"
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+#include <deque>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            class JobSystem;
+
+            namespace Details
+            {
+                struct Job;
+
+                // Chase-Lev work stealing deque. Owner pushes and pops at bottom, other threads steal from top.
+                // Capacity is fixed, Push fails when deque is full.
+                class WorkStealingDeque final : private NonCopyable, NonMovable
+                {
+                public:
+                    bool Push(Job* job);
+                    Job* Pop();
+                    Job* Steal();
+
+                private:
+                    static constexpr size_t Capacity = 4096;
+                    static constexpr size_t Mask = Capacity - 1;
+                    static constexpr size_t CacheLineSize = 64;
+
+                    alignas(CacheLineSize) std::atomic<int64_t> top_ = 0;
+                    alignas(CacheLineSize) std::atomic<int64_t> bottom_ = 0;
+                    alignas(CacheLineSize) std::array<std::atomic<Job*>, Capacity> buffer_ = {};
+                };
+            }
+
+            // Number of unfinished jobs, jobs can be scheduled to start once counter reaches zero.
+            class JobCounter final : private NonCopyable, NonMovable
+            {
+            public:
+                JobCounter() = default;
+                ~JobCounter() { ASSERT(IsDone()); }
+
+                inline bool IsDone() const { return value_.load(std::memory_order_acquire) == 0; }
+
+            private:
+                friend class JobSystem;
+
+                std::atomic<uint32_t> value_ = 0;
+                // Jobs waiting for this counter, guarded by lock_.
+                std::vector<Details::Job*> continuations_;
+                mutable SpinLock lock_;
+            };
+
+            // Work stealing job scheduler. Every worker owns a deque, idle workers steal from others.
+            // Jobs submitted from non worker threads go to a shared queue.
+            // WaitFor never blocks the thread, it executes other jobs until the counter is done.
+            class JobSystem final : public Singleton<JobSystem>
+            {
+            public:
+                using JobFunction = InplaceFunction<void(), 64>;
+
+            public:
+                JobSystem();
+                ~JobSystem();
+
+                // Zero workersCount picks hardware concurrency minus one, calling thread helps in WaitFor.
+                void Init(uint32_t workersCount = 0);
+                void Terminate();
+
+                // Counter is incremented now and decremented when job finishes.
+                void Run(JobFunction&& function, JobCounter* counter = nullptr);
+                // Job is queued once dependency is done.
+                void RunAfter(JobCounter& dependency, JobFunction&& function, JobCounter* counter = nullptr);
+
+                void WaitFor(const JobCounter& counter);
+                // Runs single queued job on the calling thread, false if there was none.
+                // For threads waiting on something other than job counter.
+                bool TryRunOne();
+
+                inline uint32_t GetWorkersCount() const { return static_cast<uint32_t>(workers_.size()); }
+                inline bool IsInited() const { return isInited_; }
+
+            private:
+                struct Worker;
+
+                Details::Job* allocateJob(JobFunction&& function, JobCounter* counter);
+                void freeJob(Details::Job* job);
+
+                void submit(Details::Job* job);
+                void execute(Details::Job* job);
+                Details::Job* findJob();
+
+                void workerFunc(uint32_t workerIndex);
+
+            private:
+                std::vector<std::unique_ptr<Worker>> workers_;
+                std::vector<Thread> threads_;
+
+                // Queue for jobs submitted outside of workers.
+                std::deque<Details::Job*> sharedQueue_;
+                SpinLock sharedQueueLock_;
+
+                std::atomic<uint32_t> queuedJobs_ = 0;
+                std::atomic<uint32_t> sleepingWorkers_ = 0;
+                Mutex sleepMutex_;
+                ConditionVariable workAvailable_;
+
+                std::atomic<bool> terminate_ = false;
+                bool isInited_ = false;
+            };
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "LockProfiler.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            void LockSite::RecordContention(std::chrono::nanoseconds wait)
+            {
+                const auto waitNs = static_cast<uint64_t>(std::max<int64_t>(wait.count(), 0));
+
+                acquisitions_.fetch_add(1, std::memory_order_relaxed);
+                contentions_.fetch_add(1, std::memory_order_relaxed);
+                totalWaitNs_.fetch_add(waitNs, std::memory_order_relaxed);
+
+                auto maxWait = maxWaitNs_.load(std::memory_order_relaxed);
+                while (waitNs > maxWait && !maxWaitNs_.compare_exchange_weak(maxWait, waitNs, std::memory_order_relaxed))
+                    ;
+
+                size_t bucket = 0;
+                for (uint64_t waitUs = waitNs / 1000; waitUs > 0 && bucket < HistogramSize - 1; waitUs >>= 1)
+                    bucket++;
+
+                waitHistogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            LockSite::Statistics LockSite::GetStatistics() const
+            {
+                Statistics statistics;
+                statistics.file = file_;
+                statistics.line = line_;
+                statistics.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+                statistics.contentions = contentions_.load(std::memory_order_relaxed);
+                statistics.totalWait = std::chrono::nanoseconds(totalWaitNs_.load(std::memory_order_relaxed));
+                statistics.maxWait = std::chrono::nanoseconds(maxWaitNs_.load(std::memory_order_relaxed));
+
+                for (size_t index = 0; index < HistogramSize; index++)
+                    statistics.waitHistogram[index] = waitHistogram_[index].load(std::memory_order_relaxed);
+
+                return statistics;
+            }
+
+            void LockSite::Reset()
+            {
+                acquisitions_.store(0, std::memory_order_relaxed);
+                contentions_.store(0, std::memory_order_relaxed);
+                totalWaitNs_.store(0, std::memory_order_relaxed);
+                maxWaitNs_.store(0, std::memory_order_relaxed);
+
+                for (auto& bucket : waitHistogram_)
+                    bucket.store(0, std::memory_order_relaxed);
+            }
+
+            LockSite& LockProfiler::GetSite(const char* file, uint32_t line)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                auto& site = sites_[std::make_pair(std::string(file), line)];
+                if (!site)
+                    site = std::make_unique<LockSite>(file, line);
+
+                return *site;
+            }
+
+            std::vector<LockSite::Statistics> LockProfiler::GetStatistics() const
+            {
+                std::vector<LockSite::Statistics> statistics;
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+
+                    statistics.reserve(sites_.size());
+                    for (const auto& site : sites_)
+                        statistics.push_back(site.second->GetStatistics());
+                }
+
+                std::stable_sort(statistics.begin(), statistics.end(),
+                                 [](const LockSite::Statistics& a, const LockSite::Statistics& b) { return a.contentions > b.contentions; });
+
+                return statistics;
+            }
+
+            void LockProfiler::Reset()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                for (const auto& site : sites_)
+                    site.second->Reset();
+            }
+
+            void LockProfiler::Dump() const
+            {
+                for (const auto& site : GetStatistics())
+                {
+                    if (site.contentions == 0)
+                        break;
+
+                    U8String histogram;
+                    for (size_t index = 0; index < LockSite::HistogramSize; index++)
+                    {
+                        if (site.waitHistogram[index] == 0)
+                            continue;
+
+                        if (index + 1 < LockSite::HistogramSize)
+                            histogram += fmt::sprintf(" <%uus:%u", 1u << index, site.waitHistogram[index]);
+                        else
+                            histogram += fmt::sprintf(" >=%uus:%u", 1u << (index - 1), site.waitHistogram[index]);
+                    }
+
+                    Log::Print::Info("Lock %s(%u): %u acquisitions, %u contended, wait total %.3fms max %.3fms,%s\n",
+                                     site.file, site.line, site.acquisitions, site.contentions,
+                                     site.totalWait.count() / 1e6, site.maxWait.count() / 1e6, histogram);
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+// Source location of the caller when used as default argument.
+#if defined(__clang__) || defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define RR_CALLER_FILE __builtin_FILE()
+#define RR_CALLER_LINE __builtin_LINE()
+#else
+#define RR_CALLER_FILE "unknown"
+#define RR_CALLER_LINE 0
+#endif
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Acquisition statistics shared by all locks constructed at one source location.
+            class LockSite final : private NonCopyable, NonMovable
+            {
+            public:
+                // Bucket N counts waits shorter than 2^N microseconds, last one counts everything longer.
+                static constexpr size_t HistogramSize = 16;
+
+                struct Statistics
+                {
+                    const char* file = nullptr;
+                    uint32_t line = 0;
+
+                    uint64_t acquisitions = 0;
+                    uint64_t contentions = 0;
+                    std::chrono::nanoseconds totalWait = {};
+                    std::chrono::nanoseconds maxWait = {};
+                    std::array<uint64_t, HistogramSize> waitHistogram = {};
+                };
+
+            public:
+                LockSite(const char* file, uint32_t line) : file_(file), line_(line) { }
+
+                inline void RecordAcquisition() { acquisitions_.fetch_add(1, std::memory_order_relaxed); }
+                void RecordContention(std::chrono::nanoseconds wait);
+
+                Statistics GetStatistics() const;
+                void Reset();
+
+            private:
+                const char* file_;
+                uint32_t line_;
+
+                std::atomic<uint64_t> acquisitions_ = 0;
+                std::atomic<uint64_t> contentions_ = 0;
+                std::atomic<uint64_t> totalWaitNs_ = 0;
+                std::atomic<uint64_t> maxWaitNs_ = 0;
+                std::array<std::atomic<uint64_t>, HistogramSize> waitHistogram_ = {};
+            };
+
+            // Registry of lock sites. Locks register only when built with ENABLE_LOCK_PROFILING,
+            // otherwise Threading lock types are plain and the registry stays empty.
+            class LockProfiler final : public Singleton<LockProfiler>
+            {
+            public:
+                LockSite& GetSite(const char* file, uint32_t line);
+
+                // Sorted by number of contentions, most contended first.
+                std::vector<LockSite::Statistics> GetStatistics() const;
+                void Reset();
+
+                // Logs sites with at least one contention.
+                void Dump() const;
+
+            private:
+                mutable std::mutex mutex_;
+                std::map<std::pair<std::string, uint32_t>, std::unique_ptr<LockSite>> sites_;
+            };
+
+            // Lock wrapper that records acquisitions and time spent waiting on contended ones.
+            // Uncontended acquisition costs one try and one relaxed increment.
+            template <typename Lock>
+            class ProfiledLock final : private NonCopyable, NonMovable
+            {
+                using Clock = std::chrono::steady_clock;
+
+            public:
+                ProfiledLock(const char* file = RR_CALLER_FILE, uint32_t line = RR_CALLER_LINE)
+                    : site_(&LockProfiler::Instance().GetSite(file, line)) { }
+
+                void lock()
+                {
+                    if (lock_.try_lock())
+                    {
+                        site_->RecordAcquisition();
+                        return;
+                    }
+
+                    const auto start = Clock::now();
+                    lock_.lock();
+                    site_->RecordContention(Clock::now() - start);
+                }
+
+                void unlock() { lock_.unlock(); }
+
+                bool try_lock()
+                {
+                    if (!lock_.try_lock())
+                        return false;
+
+                    site_->RecordAcquisition();
+                    return true;
+                }
+
+                // Used by shared mutexes only.
+                void lock_shared()
+                {
+                    if (lock_.try_lock_shared())
+                    {
+                        site_->RecordAcquisition();
+                        return;
+                    }
+
+                    const auto start = Clock::now();
+                    lock_.lock_shared();
+                    site_->RecordContention(Clock::now() - start);
+                }
+
+                void unlock_shared() { lock_.unlock_shared(); }
+                bool try_lock_shared() { return lock_.try_lock_shared(); }
+
+            private:
+                Lock lock_;
+                LockSite* site_;
+            };
+        }
+    }
+}
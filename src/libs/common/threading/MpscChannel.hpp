@@ -0,0 +1,198 @@
+#pragma once
+
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <optional>
+#include <thread>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Bounded lock-free multi-producer/single-consumer channel.
+            // Producers claim cells with a single CAS and never take a lock. Consumer spins for a while
+            // and parks on a condition variable only when the channel stays empty.
+            template <typename T, std::size_t BufferSize>
+            class MpscChannel final : private NonCopyable, NonMovable
+            {
+                static_assert(BufferSize > 1);
+                static_assert((BufferSize & (BufferSize - 1)) == 0, "BufferSize should be power of two");
+
+            public:
+                MpscChannel()
+                {
+                    for (size_t index = 0; index < BufferSize; index++)
+                        buffer_[index].sequence.store(index, std::memory_order_relaxed);
+                }
+
+                ~MpscChannel() = default;
+
+                inline void Put(const T& obj) { put(T(obj), true); }
+                inline void Put(T&& obj) { put(std::move(obj), true); }
+
+                // Doesn't wait for consumer, returns false if channel is full or closed.
+                inline bool TryPut(const T& obj) { return put(T(obj), false); }
+                inline bool TryPut(T&& obj) { return put(std::move(obj), false); }
+
+                inline std::optional<T> GetNext()
+                {
+                    for (uint32_t spin = 0; spin < SpinCount; spin++)
+                    {
+                        if (auto result = tryPop())
+                            return result;
+
+                        if (closed_)
+                            return drainClosed();
+
+                        std::this_thread::yield();
+                    }
+
+                    {
+                        Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                        parked_.store(true, std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                        inputWait_.wait(lock, [&]() { return isReadable() || closed_; });
+                        parked_.store(false, std::memory_order_relaxed);
+                    }
+
+                    auto result = tryPop();
+                    if (!result && closed_)
+                        return drainClosed();
+
+                    return result;
+                }
+
+                inline std::optional<T> TryGetNext()
+                {
+                    return tryPop();
+                }
+
+                inline void Close()
+                {
+                    closed_ = true;
+
+                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    inputWait_.notify_all();
+                }
+
+                inline bool IsClosed() const { return closed_; }
+
+            private:
+                static constexpr size_t Mask = BufferSize - 1;
+                static constexpr uint32_t SpinCount = 64;
+                static constexpr size_t CacheLineSize = 64;
+
+                struct alignas(CacheLineSize) Cell
+                {
+                    std::atomic<size_t> sequence;
+                    T data;
+                };
+
+                inline bool put(T&& obj, bool wait)
+                {
+                    // Producer is counted before it checks closed flag, so consumer either sees it in flight or producer sees the channel closed.
+                    inFlightProducers_.fetch_add(1, std::memory_order_seq_cst);
+
+                    Cell* cell;
+                    size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+
+                    while (true)
+                    {
+                        if (closed_)
+                        {
+                            inFlightProducers_.fetch_sub(1, std::memory_order_release);
+                            return false;
+                        }
+
+                        cell = &buffer_[position & Mask];
+                        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                        if (diff == 0)
+                        {
+                            if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                                break;
+                        }
+                        else if (diff < 0)
+                        {
+                            if (!wait)
+                            {
+                                inFlightProducers_.fetch_sub(1, std::memory_order_release);
+                                return false;
+                            }
+
+                            // Channel is full, wait for consumer.
+                            std::this_thread::yield();
+                            position = enqueuePosition_.load(std::memory_order_relaxed);
+                        }
+                        else
+                        {
+                            position = enqueuePosition_.load(std::memory_order_relaxed);
+                        }
+                    }
+
+                    cell->data = std::move(obj);
+                    cell->sequence.store(position + 1, std::memory_order_release);
+                    inFlightProducers_.fetch_sub(1, std::memory_order_release);
+
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (parked_.load(std::memory_order_relaxed))
+                    {
+                        Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                        inputWait_.notify_one();
+                    }
+
+                    return true;
+                }
+
+                // Channel is closed, cells claimed before close are published shortly, so nothing put successfully is lost.
+                inline std::optional<T> drainClosed()
+                {
+                    while (inFlightProducers_.load(std::memory_order_acquire) != 0)
+                        std::this_thread::yield();
+
+                    return tryPop();
+                }
+
+                inline bool isReadable() const
+                {
+                    const auto& cell = buffer_[dequeuePosition_ & Mask];
+                    return cell.sequence.load(std::memory_order_acquire) == dequeuePosition_ + 1;
+                }
+
+                inline std::optional<T> tryPop()
+                {
+                    auto& cell = buffer_[dequeuePosition_ & Mask];
+
+                    if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1)
+                        return std::nullopt;
+
+                    auto result = std::make_optional<T>(std::move(cell.data));
+                    cell.data = T();
+                    cell.sequence.store(dequeuePosition_ + BufferSize, std::memory_order_release);
+                    dequeuePosition_++;
+
+                    return result;
+                }
+
+            private:
+                std::array<Cell, BufferSize> buffer_;
+                alignas(CacheLineSize) std::atomic<size_t> enqueuePosition_ = 0;
+                // Only touched by consumer thread.
+                alignas(CacheLineSize) size_t dequeuePosition_ = 0;
+                // Producers between claim of a cell and its publication, or rejected by closed channel.
+                std::atomic<uint32_t> inFlightProducers_ = 0;
+                std::atomic<bool> parked_ = false;
+                std::atomic<bool> closed_ = false;
+                Threading::ConditionVariable inputWait_;
+                Threading::Mutex mutex_;
+            };
+        }
+    }
+}
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mutex>
+#include <shared_mutex>
+
+#ifdef ENABLE_LOCK_PROFILING
+#include "common/threading/LockProfiler.hpp"
+#endif
 
 namespace RR
 {
@@ -9,8 +14,15 @@ namespace RR
         namespace Threading
         {
             // Type aliasing
+#ifdef ENABLE_LOCK_PROFILING
+            using Mutex = ProfiledLock<std::mutex>;
+            using RecursiveMutex = ProfiledLock<std::recursive_mutex>;
+            using SharedMutex = ProfiledLock<std::shared_mutex>;
+#else
             using Mutex = std::mutex;
             using RecursiveMutex = std::recursive_mutex;
+            using SharedMutex = std::shared_mutex;
+#endif
 
             template <class T>
             using UniqueLock = std::unique_lock<T>;
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "common/threading/JobSystem.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            static constexpr size_t CacheLineSize = 64;
+
+            // Number of T elements in one cache line, usable as batch alignment for loops writing arrays of T.
+            template <typename T>
+            constexpr size_t CacheLineElements()
+            {
+                return std::max<size_t>(1, CacheLineSize / sizeof(T));
+            }
+
+            namespace Details
+            {
+                // Several batches per thread let idle workers steal when batches take uneven time.
+                static constexpr size_t BatchesPerThread = 4;
+
+                // Returns batch size not smaller than minGrain, rounded up to multiple of alignment.
+                inline size_t BatchSize(size_t count, size_t minGrain, size_t alignment)
+                {
+                    ASSERT(alignment > 0);
+
+                    const auto& jobSystem = JobSystem::Instance();
+                    const size_t threadsCount = jobSystem.IsInited() ? jobSystem.GetWorkersCount() + 1 : 1;
+                    const size_t batchesCount = threadsCount * BatchesPerThread;
+
+                    const size_t batchSize = std::max({ minGrain, (count + batchesCount - 1) / batchesCount, size_t(1) });
+                    return (batchSize + alignment - 1) / alignment * alignment;
+                }
+
+                template <typename T>
+                struct alignas(CacheLineSize) ReduceSlot
+                {
+                    T value;
+                };
+            }
+
+            // Calls body(first, last) for consecutive batches covering [begin, end) and waits for all of them.
+            // Batch size adapts to workers count but never drops below minGrain. Batch bounds are multiples of alignment
+            // elements from begin, so batches writing adjacent elements don't share cache lines.
+            template <typename Body>
+            void ParallelFor(size_t begin, size_t end, size_t minGrain, const Body& body, size_t alignment = 1)
+            {
+                if (begin >= end)
+                    return;
+
+                auto& jobSystem = JobSystem::Instance();
+                const size_t count = end - begin;
+                const size_t batchSize = Details::BatchSize(count, minGrain, alignment);
+
+                if (count <= batchSize || !jobSystem.IsInited())
+                {
+                    body(begin, end);
+                    return;
+                }
+
+                JobCounter counter;
+                for (size_t first = begin; first < end; first += batchSize)
+                {
+                    const size_t last = std::min(first + batchSize, end);
+                    jobSystem.Run([&body, first, last]() { body(first, last); }, &counter);
+                }
+
+                jobSystem.WaitFor(counter);
+            }
+
+            // Reduces map(first, last) results of batches with combine(T&& accumulated, T&& batch).
+            // Batches are combined in ascending order on the calling thread, so combine needs no synchronization
+            // and order dependent results (like concatenation) are deterministic.
+            template <typename T, typename Map, typename Combine>
+            T ParallelReduce(size_t begin, size_t end, size_t minGrain, T identity, const Map& map, const Combine& combine, size_t alignment = 1)
+            {
+                if (begin >= end)
+                    return identity;
+
+                auto& jobSystem = JobSystem::Instance();
+                const size_t count = end - begin;
+                const size_t batchSize = Details::BatchSize(count, minGrain, alignment);
+
+                if (count <= batchSize || !jobSystem.IsInited())
+                    return combine(std::move(identity), map(begin, end));
+
+                // Every batch result owns its cache line, workers don't contend when storing them.
+                std::vector<Details::ReduceSlot<T>> slots((count + batchSize - 1) / batchSize);
+
+                JobCounter counter;
+                for (size_t index = 0; index < slots.size(); index++)
+                {
+                    const size_t first = begin + index * batchSize;
+                    const size_t last = std::min(first + batchSize, end);
+                    auto* slot = &slots[index];
+                    jobSystem.Run([&map, slot, first, last]() { slot->value = map(first, last); }, &counter);
+                }
+
+                jobSystem.WaitFor(counter);
+
+                T result = std::move(identity);
+                for (auto& slot : slots)
+                    result = combine(std::move(result), std::move(slot.value));
+
+                return result;
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "common/threading/Futex.hpp"
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Counting semaphore parking on the count word (WaitOnAddress/futex) after a short spin.
+            // Release makes a syscall only when some thread is parked.
+            class Semaphore final : private NonCopyable, NonMovable
+            {
+            public:
+                Semaphore(uint32_t initialCount = 0) : count_(initialCount) { }
+                ~Semaphore() = default;
+
+                inline void Release(uint32_t count = 1)
+                {
+                    ASSERT(count > 0);
+
+                    // Pairs with waiter publishing itself before checking count, one of them always sees the other.
+                    count_.fetch_add(count, std::memory_order_seq_cst);
+
+                    if (parkedWaiters_.load(std::memory_order_seq_cst) == 0)
+                        return;
+
+                    if (count == 1)
+                        Details::WakeOne(count_);
+                    else
+                        Details::WakeAll(count_);
+                }
+
+                inline bool TryAcquire()
+                {
+                    uint32_t count = count_.load(std::memory_order_relaxed);
+                    while (count > 0)
+                    {
+                        if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                            return true;
+                    }
+
+                    return false;
+                }
+
+                inline void Acquire()
+                {
+                    if (TryAcquire() || Details::SpinUntil([this] { return TryAcquire(); }))
+                        return;
+
+                    parkedWaiters_.fetch_add(1, std::memory_order_seq_cst);
+
+                    while (!TryAcquire())
+                        Details::WaitOnWord(count_, 0);
+
+                    parkedWaiters_.fetch_sub(1, std::memory_order_relaxed);
+                }
+
+            private:
+                std::atomic<uint32_t> count_;
+                std::atomic<uint32_t> parkedWaiters_ = 0;
+            };
+        }
+    }
+}
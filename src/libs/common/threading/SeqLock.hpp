@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common/threading/Futex.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Sequence lock for small trivially copyable state, such as camera or frame constants.
+            // Readers never write shared memory and retry only when copy overlapped a write.
+            // Writers are serialized by the sequence itself, odd value means write in progress.
+            template <typename T>
+            class SeqLock final : private NonCopyable, NonMovable
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "T should be trivially copyable");
+
+            public:
+                SeqLock(const T& value = T()) { write(value); }
+                ~SeqLock() = default;
+
+                T Load() const
+                {
+                    for (;;)
+                    {
+                        const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+                        if (sequence & 1)
+                        {
+                            Details::SpinPause();
+                            continue;
+                        }
+
+                        T value = read();
+
+                        // Copy loads are ordered before sequence recheck.
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (sequence_.load(std::memory_order_relaxed) == sequence)
+                            return value;
+                    }
+                }
+
+                void Store(const T& value)
+                {
+                    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+                    while ((sequence & 1) || !sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_relaxed))
+                    {
+                        Details::SpinPause();
+                        sequence = sequence_.load(std::memory_order_relaxed);
+                    }
+
+                    // Odd sequence is visible before any of the words.
+                    std::atomic_thread_fence(std::memory_order_release);
+                    write(value);
+                    sequence_.store(sequence + 2, std::memory_order_release);
+                }
+
+            private:
+                // Words are atomics, so torn reads are detected instead of being a data race.
+                using Word = uint64_t;
+                static constexpr size_t WordsCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+                inline T read() const
+                {
+                    std::array<Word, WordsCount> words;
+                    for (size_t index = 0; index < WordsCount; index++)
+                        words[index] = words_[index].load(std::memory_order_relaxed);
+
+                    T value;
+                    std::memcpy(&value, words.data(), sizeof(T));
+                    return value;
+                }
+
+                inline void write(const T& value)
+                {
+                    std::array<Word, WordsCount> words = {};
+                    std::memcpy(words.data(), &value, sizeof(T));
+
+                    for (size_t index = 0; index < WordsCount; index++)
+                        words_[index].store(words[index], std::memory_order_relaxed);
+                }
+
+            private:
+                std::atomic<uint32_t> sequence_ = 0;
+                std::array<std::atomic<Word>, WordsCount> words_;
+            };
+        }
+    }
+}
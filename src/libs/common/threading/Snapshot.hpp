@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common/threading/EpochDomain.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Read-copy-update holder for read mostly data, such as config and lookup tables.
+            // Readers get an immutable version without locks, writers publish a new version and the old one
+            // is deleted by EpochDomain once no reader holds it.
+            template <typename T>
+            class Snapshot final : private NonCopyable, NonMovable
+            {
+            public:
+                // Keeps the version alive, hold it for a short time only as it delays reclamation.
+                class ReadPointer final : private NonCopyable
+                {
+                public:
+                    ReadPointer() = delete;
+                    ~ReadPointer() = default;
+
+                    inline operator bool() const { return ptr_ != nullptr; }
+                    inline const T* operator->() const { return ptr_; }
+                    inline const T& operator*() const { return *ptr_; }
+
+                private:
+                    friend class Snapshot;
+
+                    ReadPointer(const std::atomic<const T*>& ptr) : ptr_(ptr.load(std::memory_order_seq_cst)) { }
+
+                private:
+                    // Entered before loading the pointer.
+                    EpochDomain::ReadSection section_;
+                    const T* ptr_;
+                };
+
+            public:
+                template <typename... Args>
+                Snapshot(Args&&... args) : ptr_(new T(std::forward<Args>(args)...)) { }
+
+                ~Snapshot() { delete ptr_.load(std::memory_order_relaxed); }
+
+                inline ReadPointer Read() const { return ReadPointer(ptr_); }
+
+                void Store(std::unique_ptr<T> value)
+                {
+                    ASSERT(value);
+
+                    UniqueLock<Mutex> lock(writeMutex_);
+                    publish(value.release());
+                }
+
+                // Copies current version, applies function to the copy and publishes it.
+                // Concurrent updates are serialized, none of them is lost.
+                template <typename Function>
+                void Update(Function&& function)
+                {
+                    UniqueLock<Mutex> lock(writeMutex_);
+
+                    auto value = std::make_unique<T>(*ptr_.load(std::memory_order_relaxed));
+                    function(*value);
+                    publish(value.release());
+                }
+
+            private:
+                void publish(const T* value)
+                {
+                    const T* previous = ptr_.exchange(value, std::memory_order_seq_cst);
+                    EpochDomain::Instance().Retire(const_cast<T*>(previous), [](void* object) { delete static_cast<T*>(object); });
+                }
+
+            private:
+                std::atomic<const T*> ptr_;
+                Mutex writeMutex_;
+            };
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#include "SpinLock.hpp"
+
+#include "common/threading/Futex.hpp"
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            void SpinLock::lockContended()
+            {
+                contentions_.fetch_add(1, std::memory_order_relaxed);
+
+                if (Details::SpinUntil([this] { return tryAcquire(); }))
+                    return;
+
+                parks_.fetch_add(1, std::memory_order_relaxed);
+
+                // Parked thread always takes lock as LockedParked, it can't know whether others are still parked,
+                // so its unlock wakes next one.
+                while (state_.exchange(State::LockedParked, std::memory_order_acquire) != State::Unlocked)
+                    Details::WaitOnWord(state_, State::LockedParked);
+            }
+
+            void SpinLock::wake()
+            {
+                Details::WakeOne(state_);
+            }
+        }
+    }
+}
\ No newline at end of file
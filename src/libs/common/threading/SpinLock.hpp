@@ -1,7 +1,10 @@
 #pragma once
 
 #include <atomic>
-#include <thread>
+
+#ifdef ENABLE_LOCK_PROFILING
+#include "common/threading/LockProfiler.hpp"
+#endif
 
 namespace RR
 {
@@ -9,10 +12,25 @@ namespace RR
     {
         namespace Threading
         {
+            // Test and test-and-set lock. Contended lock spins with exponential pause backoff, then yields,
+            // then parks the thread on the lock word (WaitOnAddress/futex) until unlock wakes it.
             class SpinLock final : private NonCopyable, NonMovable
             {
             public:
+                struct Statistics
+                {
+                    // Acquisitions that didn't succeed on first attempt.
+                    uint64_t contentions = 0;
+                    // Acquisitions that ran out of spin budget and parked.
+                    uint64_t parks = 0;
+                };
+
+            public:
+#ifdef ENABLE_LOCK_PROFILING
+                SpinLock(const char* file = RR_CALLER_FILE, uint32_t line = RR_CALLER_LINE);
+#else
                 SpinLock();
+#endif
                 ~SpinLock();
 
                 // Lockable requirements compatible
@@ -20,28 +38,95 @@ namespace RR
                 void unlock();
                 bool tryLock();
 
+                inline Statistics GetStatistics() const
+                {
+                    Statistics statistics;
+                    statistics.contentions = contentions_.load(std::memory_order_relaxed);
+                    statistics.parks = parks_.load(std::memory_order_relaxed);
+                    return statistics;
+                }
+
+                inline void ResetStatistics()
+                {
+                    contentions_.store(0, std::memory_order_relaxed);
+                    parks_.store(0, std::memory_order_relaxed);
+                }
+
             private:
-                std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+                enum State : uint32_t
+                {
+                    Unlocked,
+                    Locked,
+                    // Locked and some threads may be parked, unlock has to wake one.
+                    LockedParked
+                };
+
+                bool tryAcquire();
+                void lockContended();
+                void wake();
+
+            private:
+                std::atomic<uint32_t> state_ = State::Unlocked;
+                std::atomic<uint64_t> contentions_ = 0;
+                std::atomic<uint64_t> parks_ = 0;
+#ifdef ENABLE_LOCK_PROFILING
+                LockSite* site_;
+#endif
             };
 
+#ifdef ENABLE_LOCK_PROFILING
+            inline SpinLock::SpinLock(const char* file, uint32_t line) : site_(&LockProfiler::Instance().GetSite(file, line)) { }
+#else
             inline SpinLock::SpinLock() { }
+#endif
 
             inline SpinLock::~SpinLock() { }
 
             inline void SpinLock::lock()
             {
-                while (flag_.test_and_set(std::memory_order_acquire))
-                    std::this_thread::yield();
+                uint32_t expected = State::Unlocked;
+                if (state_.compare_exchange_strong(expected, State::Locked, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+#ifdef ENABLE_LOCK_PROFILING
+                    site_->RecordAcquisition();
+#endif
+                    return;
+                }
+
+#ifdef ENABLE_LOCK_PROFILING
+                const auto start = std::chrono::steady_clock::now();
+                lockContended();
+                site_->RecordContention(std::chrono::steady_clock::now() - start);
+#else
+                lockContended();
+#endif
             }
 
             inline void SpinLock::unlock()
             {
-                flag_.clear(std::memory_order_release);
+                if (state_.exchange(State::Unlocked, std::memory_order_release) == State::LockedParked)
+                    wake();
             }
 
             inline bool SpinLock::tryLock()
             {
-                return !flag_.test_and_set(std::memory_order_acquire);
+#ifdef ENABLE_LOCK_PROFILING
+                if (!tryAcquire())
+                    return false;
+
+                site_->RecordAcquisition();
+                return true;
+#else
+                return tryAcquire();
+#endif
+            }
+
+            inline bool SpinLock::tryAcquire()
+            {
+                // Plain load first, so failing attempt doesn't take cache line ownership from the owner.
+                uint32_t expected = State::Unlocked;
+                return state_.load(std::memory_order_relaxed) == State::Unlocked &&
+                       state_.compare_exchange_strong(expected, State::Locked, std::memory_order_acquire, std::memory_order_relaxed);
             }
         }
     }
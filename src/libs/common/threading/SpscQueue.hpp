@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // Bounded wait-free single-producer/single-consumer queue for thread handoff.
+            // Each side writes only its own position and caches the other one, so shared cache lines are
+            // read only when cached position says the queue looks full or empty.
+            template <typename T, std::size_t Capacity>
+            class SpscQueue final : private NonCopyable, NonMovable
+            {
+                static_assert(Capacity > 1);
+                static_assert((Capacity & (Capacity - 1)) == 0, "Capacity should be power of two");
+
+            public:
+                SpscQueue() = default;
+
+                ~SpscQueue()
+                {
+                    while (Front())
+                        Pop();
+                }
+
+                // Producer side, returns false if queue is full.
+                inline bool TryPush(const T& obj) { return TryEmplace(obj); }
+                inline bool TryPush(T&& obj) { return TryEmplace(std::move(obj)); }
+
+                template <typename... Args>
+                inline bool TryEmplace(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args...>::value)
+                {
+                    const size_t tail = producer_.tail.load(std::memory_order_relaxed);
+
+                    if (tail - producer_.cachedHead == Capacity)
+                    {
+                        producer_.cachedHead = consumer_.head.load(std::memory_order_acquire);
+                        if (tail - producer_.cachedHead == Capacity)
+                            return false;
+                    }
+
+                    new (slot(tail)) T(std::forward<Args>(args)...);
+                    producer_.tail.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+
+                // Consumer side, nullptr if queue is empty. Item stays valid until Pop.
+                inline T* Front() noexcept
+                {
+                    const size_t head = consumer_.head.load(std::memory_order_relaxed);
+
+                    if (head == consumer_.cachedTail)
+                    {
+                        consumer_.cachedTail = producer_.tail.load(std::memory_order_acquire);
+                        if (head == consumer_.cachedTail)
+                            return nullptr;
+                    }
+
+                    return slot(head);
+                }
+
+                // Should follow Front returned an item.
+                inline void Pop() noexcept
+                {
+                    const size_t head = consumer_.head.load(std::memory_order_relaxed);
+                    ASSERT(head != consumer_.cachedTail);
+
+                    slot(head)->~T();
+                    consumer_.head.store(head + 1, std::memory_order_release);
+                }
+
+                inline std::optional<T> TryPop()
+                {
+                    T* item = Front();
+                    if (!item)
+                        return std::nullopt;
+
+                    std::optional<T> result(std::move(*item));
+                    Pop();
+                    return result;
+                }
+
+                // Exact only on either side while the other one is idle.
+                inline size_t GetSize() const noexcept
+                {
+                    return producer_.tail.load(std::memory_order_acquire) - consumer_.head.load(std::memory_order_acquire);
+                }
+
+                inline size_t GetCapacity() const noexcept { return Capacity; }
+
+            private:
+                static constexpr size_t Mask = Capacity - 1;
+                static constexpr size_t CacheLineSize = 64;
+
+                struct alignas(CacheLineSize) Producer
+                {
+                    std::atomic<size_t> tail = 0;
+                    size_t cachedHead = 0;
+                };
+
+                struct alignas(CacheLineSize) Consumer
+                {
+                    std::atomic<size_t> head = 0;
+                    size_t cachedTail = 0;
+                };
+
+                inline T* slot(size_t position) noexcept { return std::launder(reinterpret_cast<T*>(&storage_[position & Mask])); }
+
+            private:
+                Producer producer_;
+                Consumer consumer_;
+                std::aligned_storage_t<sizeof(T), alignof(T)> storage_[Capacity];
+            };
+        }
+    }
+}
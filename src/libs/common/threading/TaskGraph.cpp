@@ -0,0 +1,127 @@
+#include "TaskGraph.hpp"
+
+#include "common/debug/Profiler.hpp"
+
+#include <optional>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            TaskGraph::StepId TaskGraph::Add(const char* name, std::function<void()>&& function,
+                                             std::initializer_list<StepId> dependencies, Affinity affinity)
+            {
+                ASSERT(name);
+                ASSERT(function);
+                ASSERT_MSG(startNs_ == 0, "Steps can't be added once graph is run");
+
+                const auto id = static_cast<StepId>(steps_.size());
+
+                auto step = std::make_unique<Step>();
+                step->name = name;
+                step->function = std::move(function);
+                step->affinity = affinity;
+                step->pendingDependencies.store(static_cast<uint32_t>(dependencies.size()), std::memory_order_relaxed);
+
+                for (const auto dependency : dependencies)
+                {
+                    ASSERT_MSG(dependency < id, "Dependency should be added before step %s", name);
+                    steps_[dependency]->dependents.push_back(id);
+                }
+
+                steps_.push_back(std::move(step));
+                return id;
+            }
+
+            void TaskGraph::Run()
+            {
+                ASSERT_MSG(startNs_ == 0, "Graph can be run once");
+
+                const auto& jobSystem = JobSystem::Instance();
+                useWorkers_ = jobSystem.IsInited() && jobSystem.GetWorkersCount() > 0;
+                startNs_ = Debug::Profiler::Now();
+
+                timings_.reserve(steps_.size());
+
+                // Roots are collected before any of them runs, counters of others are decremented concurrently.
+                std::vector<StepId> roots;
+                for (StepId id = 0; id < steps_.size(); id++)
+                    if (steps_[id]->pendingDependencies.load(std::memory_order_relaxed) == 0)
+                        roots.push_back(id);
+
+                for (const auto id : roots)
+                    schedule(id);
+
+                // Step schedules its dependents before its job finishes. So once no worker step is in flight
+                // and the queue is empty, every step is done. Calling thread steps made ready by workers
+                // are picked up when in flight worker steps finish.
+                for (;;)
+                {
+                    std::optional<StepId> id;
+                    {
+                        UniqueLock<Mutex> lock(mutex_);
+                        if (!callingThreadQueue_.empty())
+                        {
+                            id = callingThreadQueue_.front();
+                            callingThreadQueue_.pop_front();
+                        }
+                    }
+
+                    if (id)
+                    {
+                        execute(*id);
+                        continue;
+                    }
+
+                    // Also waits for finishing job to release the counter, it's destroyed with the graph.
+                    JobSystem::Instance().WaitFor(workerSteps_);
+
+                    UniqueLock<Mutex> lock(mutex_);
+                    if (callingThreadQueue_.empty())
+                        break;
+                }
+
+                ASSERT(timings_.size() == steps_.size());
+
+                const auto totalNs = Debug::Profiler::Now() - startNs_;
+
+                for (const auto& timing : timings_)
+                    Log::Print::Info("%s %s: %.3fms, started at %.3fms\n", name_, timing.name, timing.durationNs / 1e6, timing.startNs / 1e6);
+
+                Log::Print::Info("%s: %.3fms total\n", name_, totalNs / 1e6);
+            }
+
+            void TaskGraph::schedule(StepId id)
+            {
+                if (useWorkers_ && steps_[id]->affinity == Affinity::Any)
+                {
+                    JobSystem::Instance().Run([this, id] { execute(id); }, &workerSteps_);
+                    return;
+                }
+
+                UniqueLock<Mutex> lock(mutex_);
+                callingThreadQueue_.push_back(id);
+            }
+
+            void TaskGraph::execute(StepId id)
+            {
+                auto& step = *steps_[id];
+
+                const auto startNs = Debug::Profiler::Now();
+                step.function();
+                const auto endNs = Debug::Profiler::Now();
+
+                Debug::Profiler::RecordScope(step.name, startNs, endNs);
+
+                for (const auto dependent : step.dependents)
+                    if (steps_[dependent]->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        schedule(dependent);
+
+                UniqueLock<Mutex> lock(mutex_);
+                timings_.push_back({ step.name, startNs - startNs_, endNs - startNs });
+            }
+        }
+    }
+}
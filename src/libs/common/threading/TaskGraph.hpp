@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common/threading/JobSystem.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace RR
+{
+    namespace Common
+    {
+        namespace Threading
+        {
+            // One shot graph of named steps. Steps with completed dependencies run concurrently on JobSystem workers,
+            // steps bound to the calling thread (window creation, anything thread affine) are executed by Run itself.
+            // While waiting, Run executes jobs as JobSystem::WaitFor does, so a step blocked on another thread can't starve the graph.
+            // Every step is timed, Run logs the timings, so startup regressions are visible per step.
+            class TaskGraph final : private NonCopyable, NonMovable
+            {
+            public:
+                using StepId = uint32_t;
+
+                enum class Affinity : uint8_t
+                {
+                    Any,
+                    CallingThread
+                };
+
+                struct StepTiming
+                {
+                    const char* name;
+                    // Relative to the start of Run.
+                    uint64_t startNs;
+                    uint64_t durationNs;
+                };
+
+            public:
+                // Graph and step names have to have static storage duration, they're stored by pointer.
+                explicit TaskGraph(const char* name) : name_(name) { }
+
+                // Dependencies are added first, so graph can't have cycles.
+                StepId Add(const char* name, std::function<void()>&& function,
+                           std::initializer_list<StepId> dependencies = {}, Affinity affinity = Affinity::Any);
+
+                // Blocks until all steps are done. Without JobSystem workers every step runs on the calling thread in order.
+                void Run();
+
+                // Valid after Run, in order of steps completion.
+                const std::vector<StepTiming>& GetTimings() const { return timings_; }
+
+            private:
+                struct Step
+                {
+                    const char* name;
+                    std::function<void()> function;
+                    Affinity affinity;
+                    std::atomic<uint32_t> pendingDependencies = 0;
+                    std::vector<StepId> dependents;
+                };
+
+                void schedule(StepId id);
+                void execute(StepId id);
+
+            private:
+                const char* name_;
+                bool useWorkers_ = false;
+                uint64_t startNs_ = 0;
+                std::vector<std::unique_ptr<Step>> steps_;
+
+                // Steps given to workers and not finished yet.
+                JobCounter workerSteps_;
+
+                Mutex mutex_;
+                // Guarded by mutex_.
+                std::deque<StepId> callingThreadQueue_;
+                std::vector<StepTiming> timings_;
+            };
+        }
+    }
+}
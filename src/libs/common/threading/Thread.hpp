@@ -1,9 +1,15 @@
 #pragma once
 
+#include "common/threading/CpuTopology.hpp"
+
 #include <thread>
+#include <tuple>
 
 #ifdef OS_WINDOWS
 #include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
 #endif // OS_WINDOWS
 
 namespace RR
@@ -12,6 +18,26 @@ namespace RR
     {
         namespace Threading
         {
+            enum class ThreadPriority
+            {
+                Lowest,
+                BelowNormal,
+                Normal,
+                AboveNormal,
+                Highest
+            };
+
+            // Scheduler hint, decides between performance and efficiency cores of hybrid CPUs.
+            enum class ThreadQoS
+            {
+                // Left to OS heuristics.
+                Default,
+                // Never throttled, preferably scheduled on performance cores.
+                High,
+                // Background work, preferably scheduled on efficiency cores.
+                Eco
+            };
+
             class Thread : NonCopyable
             {
             public:
@@ -38,6 +64,55 @@ namespace RR
 #endif
                 }
 
+                // Placement setters return false when platform doesn't support them or call failed.
+                inline bool SetAffinity(const AffinityMask& affinityMask)
+                {
+                    ASSERT(!affinityMask.IsEmpty());
+#ifdef OS_WINDOWS
+                    GROUP_AFFINITY affinity = {};
+                    affinity.Group = affinityMask.group;
+                    affinity.Mask = static_cast<KAFFINITY>(affinityMask.mask);
+                    return SetThreadGroupAffinity(static_cast<HANDLE>(GetNativeHandle()), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+                    cpu_set_t cpuSet;
+                    CPU_ZERO(&cpuSet);
+                    for (uint32_t cpu = 0; cpu < 64; cpu++)
+                        if (affinityMask.mask & (uint64_t(1) << cpu))
+                            CPU_SET(cpu, &cpuSet);
+
+                    return pthread_setaffinity_np(GetNativeHandle(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+                    return false;
+#endif
+                }
+
+                inline bool SetPriority(ThreadPriority priority)
+                {
+#ifdef OS_WINDOWS
+                    static constexpr int priorities[] = { THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+                                                          THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST };
+                    return SetThreadPriority(static_cast<HANDLE>(GetNativeHandle()), priorities[static_cast<int>(priority)]) != 0;
+#else
+                    // Raising priority of SCHED_OTHER threads needs privileges on Linux.
+                    std::ignore = priority;
+                    return false;
+#endif
+                }
+
+                inline bool SetQoS(ThreadQoS qos)
+                {
+#ifdef OS_WINDOWS
+                    THREAD_POWER_THROTTLING_STATE state = {};
+                    state.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+                    state.ControlMask = qos == ThreadQoS::Default ? 0 : THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+                    state.StateMask = qos == ThreadQoS::Eco ? THREAD_POWER_THROTTLING_EXECUTION_SPEED : 0;
+                    return SetThreadInformation(static_cast<HANDLE>(GetNativeHandle()), ThreadPowerThrottling, &state, sizeof(state)) != 0;
+#else
+                    std::ignore = qos;
+                    return false;
+#endif
+                }
+
                 inline bool IsJoinable() const noexcept
                 {
                     return thread_.joinable();
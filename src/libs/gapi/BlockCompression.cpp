@@ -0,0 +1,782 @@
+#include "BlockCompression.hpp"
+
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/TexelConversion.hpp"
+
+#include "common/OnScopeExit.hpp"
+#include "common/threading/Parallel.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace BlockCompression
+        {
+            namespace
+            {
+                constexpr uint32_t BlockDimension = 4;
+                constexpr uint32_t BlockTexels = BlockDimension * BlockDimension;
+                constexpr uint32_t AllTexelsMask = 0xFFFF;
+                constexpr uint32_t RefineIterations = 2;
+
+                // Values are 0..255 for LDR formats and half float bits for BC6H.
+                using Color = std::array<float, 4>;
+                using Block = std::array<Color, BlockTexels>;
+                using BlockEncoder = void (*)(const Block& block, uint8_t* dest);
+
+                // BC7 and BC6H interpolation weights of 4-bit indices, symmetric: Weights[15 - i] == 64 - Weights[i].
+                constexpr std::array<uint32_t, 16> Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+                // Packs fields from the least significant bit of 128-bit block.
+                class BitWriter final
+                {
+                public:
+                    void Write(uint32_t value, uint32_t bitsCount)
+                    {
+                        for (uint32_t bit = 0; bit < bitsCount; bit++, position_++)
+                            data_[position_ / 64] |= static_cast<uint64_t>((value >> bit) & 1) << (position_ % 64);
+                    }
+
+                    void Store(uint8_t* dest) const
+                    {
+                        ASSERT(position_ == 128);
+                        std::memcpy(dest, data_.data(), sizeof(data_));
+                    }
+
+                private:
+                    std::array<uint64_t, 2> data_ = {};
+                    uint32_t position_ = 0;
+                };
+
+                inline bool isInMask(uint32_t mask, uint32_t texel) { return (mask >> texel) & 1; }
+
+                inline float distanceSquared(const Color& lhs, const Color& rhs, uint32_t channels)
+                {
+                    float distance = 0.0f;
+                    for (uint32_t channel = 0; channel < channels; channel++)
+                        distance += (lhs[channel] - rhs[channel]) * (lhs[channel] - rhs[channel]);
+
+                    return distance;
+                }
+
+                // Endpoints are extremes of masked texels projected on their principal axis.
+                void fitPrincipalAxis(const Block& block, uint32_t channels, uint32_t mask, Color& low, Color& high)
+                {
+                    Color mean = {};
+                    uint32_t count = 0;
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        if (!isInMask(mask, texel))
+                            continue;
+
+                        for (uint32_t channel = 0; channel < channels; channel++)
+                            mean[channel] += block[texel][channel];
+                        count++;
+                    }
+
+                    low = high = {};
+                    if (count == 0)
+                        return;
+
+                    for (uint32_t channel = 0; channel < channels; channel++)
+                        mean[channel] /= static_cast<float>(count);
+
+                    float covariance[4][4] = {};
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        if (!isInMask(mask, texel))
+                            continue;
+
+                        for (uint32_t row = 0; row < channels; row++)
+                            for (uint32_t column = 0; column < channels; column++)
+                                covariance[row][column] += (block[texel][row] - mean[row]) * (block[texel][column] - mean[column]);
+                    }
+
+                    // Power iteration starting from the channel of the largest variance.
+                    Color axis = {};
+                    uint32_t largest = 0;
+                    for (uint32_t channel = 1; channel < channels; channel++)
+                        if (covariance[channel][channel] > covariance[largest][largest])
+                            largest = channel;
+                    axis[largest] = 1.0f;
+
+                    for (uint32_t iteration = 0; iteration < 8; iteration++)
+                    {
+                        Color next = {};
+                        float scale = 0.0f;
+                        for (uint32_t row = 0; row < channels; row++)
+                        {
+                            for (uint32_t column = 0; column < channels; column++)
+                                next[row] += covariance[row][column] * axis[column];
+                            scale = std::max(scale, std::abs(next[row]));
+                        }
+
+                        if (scale <= std::numeric_limits<float>::epsilon())
+                            break;
+
+                        for (uint32_t channel = 0; channel < channels; channel++)
+                            axis[channel] = next[channel] / scale;
+                    }
+
+                    float lengthSquared = 0.0f;
+                    for (uint32_t channel = 0; channel < channels; channel++)
+                        lengthSquared += axis[channel] * axis[channel];
+
+                    float minProjection = std::numeric_limits<float>::max();
+                    float maxProjection = std::numeric_limits<float>::lowest();
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        if (!isInMask(mask, texel))
+                            continue;
+
+                        float projection = 0.0f;
+                        for (uint32_t channel = 0; channel < channels; channel++)
+                            projection += (block[texel][channel] - mean[channel]) * axis[channel];
+
+                        minProjection = std::min(minProjection, projection);
+                        maxProjection = std::max(maxProjection, projection);
+                    }
+
+                    for (uint32_t channel = 0; channel < channels; channel++)
+                    {
+                        low[channel] = mean[channel] + axis[channel] * minProjection / lengthSquared;
+                        high[channel] = mean[channel] + axis[channel] * maxProjection / lengthSquared;
+                    }
+                }
+
+                // Least squares endpoints for fixed interpolation weights of texels, false if weights are degenerate.
+                bool refineEndpoints(const Block& block, uint32_t channels, uint32_t mask, const std::array<float, BlockTexels>& weights,
+                                     Color& first, Color& second)
+                {
+                    float firstFirst = 0.0f, firstSecond = 0.0f, secondSecond = 0.0f;
+                    Color firstSum = {}, secondSum = {};
+
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        if (!isInMask(mask, texel))
+                            continue;
+
+                        const float weight = weights[texel];
+                        const float inverse = 1.0f - weight;
+
+                        firstFirst += inverse * inverse;
+                        firstSecond += inverse * weight;
+                        secondSecond += weight * weight;
+
+                        for (uint32_t channel = 0; channel < channels; channel++)
+                        {
+                            firstSum[channel] += inverse * block[texel][channel];
+                            secondSum[channel] += weight * block[texel][channel];
+                        }
+                    }
+
+                    const float determinant = firstFirst * secondSecond - firstSecond * firstSecond;
+                    if (std::abs(determinant) < 1e-6f)
+                        return false;
+
+                    for (uint32_t channel = 0; channel < channels; channel++)
+                    {
+                        first[channel] = (secondSecond * firstSum[channel] - firstSecond * secondSum[channel]) / determinant;
+                        second[channel] = (firstFirst * secondSum[channel] - firstSecond * firstSum[channel]) / determinant;
+                    }
+
+                    return true;
+                }
+
+                inline uint32_t quantize(float value, uint32_t maxValue, float range)
+                {
+                    return static_cast<uint32_t>(std::clamp(std::lround(value * maxValue / range), 0l, static_cast<long>(maxValue)));
+                }
+
+                // BC1 color block, also the color part of BC3.
+
+                struct ColorFit final
+                {
+                    uint16_t color0;
+                    uint16_t color1;
+                    uint32_t indices;
+                    float error;
+                };
+
+                uint16_t packRGB565(const Color& color)
+                {
+                    return static_cast<uint16_t>((quantize(color[0], 31, 255.0f) << 11) | (quantize(color[1], 63, 255.0f) << 5) | quantize(color[2], 31, 255.0f));
+                }
+
+                Color unpackRGB565(uint16_t packed)
+                {
+                    const uint32_t red = packed >> 11;
+                    const uint32_t green = (packed >> 5) & 0x3F;
+                    const uint32_t blue = packed & 0x1F;
+
+                    return { static_cast<float>((red << 3) | (red >> 2)), static_cast<float>((green << 2) | (green >> 4)), static_cast<float>((blue << 3) | (blue >> 2)), 0.0f };
+                }
+
+                // Endpoints order selects the mode: color0 > color1 is four color block, three color with transparent black otherwise.
+                // Texels out of mask get the transparent index.
+                ColorFit evaluateColor(const Block& block, uint32_t mask, bool isThreeColor, uint16_t first, uint16_t second)
+                {
+                    if (isThreeColor ? first > second : first < second)
+                        std::swap(first, second);
+
+                    ColorFit fit = { first, second, 0, 0.0f };
+
+                    std::array<Color, 4> palette = { unpackRGB565(first), unpackRGB565(second) };
+                    for (uint32_t channel = 0; channel < 3; channel++)
+                    {
+                        if (isThreeColor)
+                            palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2.0f;
+                        else
+                        {
+                            palette[2][channel] = (2.0f * palette[0][channel] + palette[1][channel]) / 3.0f;
+                            palette[3][channel] = (palette[0][channel] + 2.0f * palette[1][channel]) / 3.0f;
+                        }
+                    }
+
+                    // Equal endpoints decode as three color block, colors are equal anyway.
+                    const uint32_t paletteSize = (isThreeColor || first == second) ? 3 : 4;
+
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        uint32_t index = 3;
+
+                        if (isInMask(mask, texel))
+                        {
+                            float bestDistance = std::numeric_limits<float>::max();
+                            for (uint32_t entry = 0; entry < paletteSize; entry++)
+                            {
+                                const float distance = distanceSquared(block[texel], palette[entry], 3);
+                                if (distance < bestDistance)
+                                {
+                                    bestDistance = distance;
+                                    index = entry;
+                                }
+                            }
+
+                            fit.error += bestDistance;
+                        }
+
+                        fit.indices |= index << (texel * 2);
+                    }
+
+                    return fit;
+                }
+
+                void encodeColor(const Block& block, uint32_t mask, bool isThreeColor, uint8_t* dest)
+                {
+                    Color low, high;
+                    fitPrincipalAxis(block, 3, mask, low, high);
+
+                    ColorFit best = evaluateColor(block, mask, isThreeColor, packRGB565(high), packRGB565(low));
+
+                    for (uint32_t iteration = 0; iteration < RefineIterations && best.error > 0.0f; iteration++)
+                    {
+                        static constexpr std::array<float, 4> FourColorWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                        static constexpr std::array<float, 4> ThreeColorWeights = { 0.0f, 1.0f, 0.5f, 0.0f };
+                        const auto& indexWeights = isThreeColor ? ThreeColorWeights : FourColorWeights;
+
+                        std::array<float, BlockTexels> weights;
+                        for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                            weights[texel] = indexWeights[(best.indices >> (texel * 2)) & 3];
+
+                        Color first, second;
+                        if (!refineEndpoints(block, 3, mask, weights, first, second))
+                            break;
+
+                        const ColorFit fit = evaluateColor(block, mask, isThreeColor, packRGB565(first), packRGB565(second));
+                        if (fit.error >= best.error)
+                            break;
+
+                        best = fit;
+                    }
+
+                    std::memcpy(dest, &best.color0, sizeof(uint16_t));
+                    std::memcpy(dest + 2, &best.color1, sizeof(uint16_t));
+                    std::memcpy(dest + 4, &best.indices, sizeof(uint32_t));
+                }
+
+                // BC4 block of single channel, also alpha of BC3 and channels of BC5.
+                void encodeChannel(const Block& block, uint32_t channel, uint8_t* dest)
+                {
+                    float minValue = 255.0f, maxValue = 0.0f;
+                    for (const auto& texel : block)
+                    {
+                        minValue = std::min(minValue, texel[channel]);
+                        maxValue = std::max(maxValue, texel[channel]);
+                    }
+
+                    // Red0 > red1 selects eight interpolated values.
+                    const uint32_t red0 = quantize(maxValue, 255, 255.0f);
+                    const uint32_t red1 = quantize(minValue, 255, 255.0f);
+
+                    std::array<float, 8> palette = { static_cast<float>(red0), static_cast<float>(red1) };
+                    for (uint32_t entry = 2; entry < palette.size(); entry++)
+                        palette[entry] = ((8 - entry) * palette[0] + (entry - 1) * palette[1]) / 7.0f;
+
+                    uint64_t indices = 0;
+                    if (red0 != red1)
+                    {
+                        for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                        {
+                            uint64_t index = 0;
+                            float bestDistance = std::numeric_limits<float>::max();
+                            for (uint32_t entry = 0; entry < palette.size(); entry++)
+                            {
+                                const float distance = std::abs(block[texel][channel] - palette[entry]);
+                                if (distance < bestDistance)
+                                {
+                                    bestDistance = distance;
+                                    index = entry;
+                                }
+                            }
+
+                            indices |= index << (texel * 3);
+                        }
+                    }
+
+                    dest[0] = static_cast<uint8_t>(red0);
+                    dest[1] = static_cast<uint8_t>(red1);
+                    for (uint32_t byte = 0; byte < 6; byte++)
+                        dest[2 + byte] = static_cast<uint8_t>(indices >> (byte * 8));
+                }
+
+                // Single subset modes with 4-bit indices, shared by BC7 mode 6 and BC6H mode 11.
+
+                struct IndexFit final
+                {
+                    std::array<uint32_t, BlockTexels> indices;
+                    float error;
+                };
+
+                IndexFit fitIndices(const Block& block, uint32_t channels, const std::array<Color, 16>& palette)
+                {
+                    IndexFit fit = { {}, 0.0f };
+
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                    {
+                        float bestDistance = std::numeric_limits<float>::max();
+                        for (uint32_t entry = 0; entry < palette.size(); entry++)
+                        {
+                            const float distance = distanceSquared(block[texel], palette[entry], channels);
+                            if (distance < bestDistance)
+                            {
+                                bestDistance = distance;
+                                fit.indices[texel] = entry;
+                            }
+                        }
+
+                        fit.error += bestDistance;
+                    }
+
+                    return fit;
+                }
+
+                std::array<float, BlockTexels> getIndexWeights(const IndexFit& fit)
+                {
+                    std::array<float, BlockTexels> weights;
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                        weights[texel] = static_cast<float>(Weights[fit.indices[texel]]) / 64.0f;
+
+                    return weights;
+                }
+
+                // Anchor texel index is stored without the most significant bit, swapped endpoints invert indices.
+                template <typename Endpoint>
+                void fixAnchor(IndexFit& fit, Endpoint& first, Endpoint& second)
+                {
+                    if (fit.indices[0] < 8)
+                        return;
+
+                    std::swap(first, second);
+                    for (auto& index : fit.indices)
+                        index = 15 - index;
+                }
+
+                void writeIndices(BitWriter& writer, const IndexFit& fit)
+                {
+                    writer.Write(fit.indices[0], 3);
+                    for (uint32_t texel = 1; texel < BlockTexels; texel++)
+                        writer.Write(fit.indices[texel], 4);
+                }
+
+                // BC7 mode 6: RGBA 7-bit endpoints with per endpoint p-bit.
+
+                struct Endpoint7 final
+                {
+                    std::array<uint32_t, 4> values;
+                    uint32_t pBit;
+
+                    uint32_t Expand(uint32_t channel) const { return (values[channel] << 1) | pBit; }
+                };
+
+                Endpoint7 quantizeEndpoint7(const Color& color)
+                {
+                    Endpoint7 best = {};
+                    float bestError = std::numeric_limits<float>::max();
+
+                    for (uint32_t pBit = 0; pBit < 2; pBit++)
+                    {
+                        Endpoint7 endpoint = { {}, pBit };
+                        float error = 0.0f;
+
+                        for (uint32_t channel = 0; channel < 4; channel++)
+                        {
+                            endpoint.values[channel] = quantize((color[channel] - static_cast<float>(pBit)) / 2.0f, 127, 127.0f);
+
+                            const float difference = static_cast<float>(endpoint.Expand(channel)) - color[channel];
+                            error += difference * difference;
+                        }
+
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            best = endpoint;
+                        }
+                    }
+
+                    return best;
+                }
+
+                IndexFit evaluateBC7(const Block& block, const Endpoint7& first, const Endpoint7& second)
+                {
+                    std::array<Color, 16> palette;
+                    for (uint32_t entry = 0; entry < palette.size(); entry++)
+                        for (uint32_t channel = 0; channel < 4; channel++)
+                            palette[entry][channel] = static_cast<float>(((64 - Weights[entry]) * first.Expand(channel) + Weights[entry] * second.Expand(channel) + 32) >> 6);
+
+                    return fitIndices(block, 4, palette);
+                }
+
+                void encodeBC7(const Block& block, uint8_t* dest)
+                {
+                    Color low, high;
+                    fitPrincipalAxis(block, 4, AllTexelsMask, low, high);
+
+                    Endpoint7 first = quantizeEndpoint7(low);
+                    Endpoint7 second = quantizeEndpoint7(high);
+                    IndexFit best = evaluateBC7(block, first, second);
+
+                    for (uint32_t iteration = 0; iteration < RefineIterations && best.error > 0.0f; iteration++)
+                    {
+                        Color refinedFirst, refinedSecond;
+                        if (!refineEndpoints(block, 4, AllTexelsMask, getIndexWeights(best), refinedFirst, refinedSecond))
+                            break;
+
+                        const Endpoint7 candidateFirst = quantizeEndpoint7(refinedFirst);
+                        const Endpoint7 candidateSecond = quantizeEndpoint7(refinedSecond);
+                        const IndexFit fit = evaluateBC7(block, candidateFirst, candidateSecond);
+                        if (fit.error >= best.error)
+                            break;
+
+                        first = candidateFirst;
+                        second = candidateSecond;
+                        best = fit;
+                    }
+
+                    fixAnchor(best, first, second);
+
+                    BitWriter writer;
+                    writer.Write(1 << 6, 7);
+                    for (uint32_t channel = 0; channel < 4; channel++)
+                    {
+                        writer.Write(first.values[channel], 7);
+                        writer.Write(second.values[channel], 7);
+                    }
+                    writer.Write(first.pBit, 1);
+                    writer.Write(second.pBit, 1);
+                    writeIndices(writer, best);
+                    writer.Store(dest);
+                }
+
+                // BC6H mode 11: unsigned RGB 10-bit endpoints without transform. Fit works on half float bits,
+                // which are close to logarithmic, so error is relative to texel brightness.
+
+                using Endpoint10 = std::array<uint32_t, 3>;
+
+                constexpr uint32_t MaxHalf = 0x7BFF;
+
+                inline uint32_t unquantize10(uint32_t value)
+                {
+                    if (value == 0)
+                        return 0;
+
+                    if (value == 0x3FF)
+                        return 0xFFFF;
+
+                    return ((value << 16) + 0x8000) >> 10;
+                }
+
+                inline uint32_t finishUnquantize(uint32_t value) { return (value * 31) >> 6; }
+
+                Endpoint10 quantizeEndpoint10(const Color& color)
+                {
+                    Endpoint10 endpoint;
+                    for (uint32_t channel = 0; channel < 3; channel++)
+                    {
+                        const float half = std::clamp(color[channel], 0.0f, static_cast<float>(MaxHalf));
+                        // Unquantized value is close to 64 * quantized + 32, neighbour is checked against rounding.
+                        const uint32_t estimate = quantize((half * 64.0f / 31.0f - 32.0f) / 64.0f, 0x3FF, 1023.0f);
+
+                        uint32_t best = estimate;
+                        for (const uint32_t candidate : { estimate - 1, estimate + 1 })
+                            if (candidate <= 0x3FF &&
+                                std::abs(static_cast<float>(finishUnquantize(unquantize10(candidate))) - half) <
+                                    std::abs(static_cast<float>(finishUnquantize(unquantize10(best))) - half))
+                                best = candidate;
+
+                        endpoint[channel] = best;
+                    }
+
+                    return endpoint;
+                }
+
+                IndexFit evaluateBC6H(const Block& block, const Endpoint10& first, const Endpoint10& second)
+                {
+                    std::array<Color, 16> palette;
+                    for (uint32_t entry = 0; entry < palette.size(); entry++)
+                        for (uint32_t channel = 0; channel < 3; channel++)
+                            palette[entry][channel] = static_cast<float>(finishUnquantize(
+                                ((64 - Weights[entry]) * unquantize10(first[channel]) + Weights[entry] * unquantize10(second[channel]) + 32) >> 6));
+
+                    return fitIndices(block, 3, palette);
+                }
+
+                void encodeBC6H(const Block& block, uint8_t* dest)
+                {
+                    Color low, high;
+                    fitPrincipalAxis(block, 3, AllTexelsMask, low, high);
+
+                    Endpoint10 first = quantizeEndpoint10(low);
+                    Endpoint10 second = quantizeEndpoint10(high);
+                    IndexFit best = evaluateBC6H(block, first, second);
+
+                    for (uint32_t iteration = 0; iteration < RefineIterations && best.error > 0.0f; iteration++)
+                    {
+                        Color refinedFirst, refinedSecond;
+                        if (!refineEndpoints(block, 3, AllTexelsMask, getIndexWeights(best), refinedFirst, refinedSecond))
+                            break;
+
+                        const Endpoint10 candidateFirst = quantizeEndpoint10(refinedFirst);
+                        const Endpoint10 candidateSecond = quantizeEndpoint10(refinedSecond);
+                        const IndexFit fit = evaluateBC6H(block, candidateFirst, candidateSecond);
+                        if (fit.error >= best.error)
+                            break;
+
+                        first = candidateFirst;
+                        second = candidateSecond;
+                        best = fit;
+                    }
+
+                    fixAnchor(best, first, second);
+
+                    BitWriter writer;
+                    writer.Write(0x03, 5);
+                    for (const auto& endpoint : { first, second })
+                        for (uint32_t channel = 0; channel < 3; channel++)
+                            writer.Write(endpoint[channel], 10);
+                    writeIndices(writer, best);
+                    writer.Store(dest);
+                }
+
+                void encodeBC1(const Block& block, uint8_t* dest)
+                {
+                    uint32_t opaqueMask = 0;
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                        if (block[texel][3] >= 128.0f)
+                            opaqueMask |= 1 << texel;
+
+                    encodeColor(block, opaqueMask, opaqueMask != AllTexelsMask, dest);
+                }
+
+                void encodeBC3(const Block& block, uint8_t* dest)
+                {
+                    encodeChannel(block, 3, dest);
+                    encodeColor(block, AllTexelsMask, false, dest + 8);
+                }
+
+                void encodeBC4(const Block& block, uint8_t* dest)
+                {
+                    encodeChannel(block, 0, dest);
+                }
+
+                void encodeBC5(const Block& block, uint8_t* dest)
+                {
+                    encodeChannel(block, 0, dest);
+                    encodeChannel(block, 1, dest + 8);
+                }
+
+                // Negative values clamp to zero, infinities and NaNs to the largest finite half.
+                Color halfToColor(const uint16_t* half)
+                {
+                    Color color;
+                    for (uint32_t channel = 0; channel < 3; channel++)
+                        color[channel] = (half[channel] & 0x8000) ? 0.0f : static_cast<float>(std::min<uint32_t>(half[channel], MaxHalf));
+                    color[3] = 0.0f;
+
+                    return color;
+                }
+
+                BlockEncoder getEncoder(GpuResourceFormat format)
+                {
+                    switch (format)
+                    {
+                        case GpuResourceFormat::BC1Unorm:
+                        case GpuResourceFormat::BC1UnormSrgb: return &encodeBC1;
+                        case GpuResourceFormat::BC3Unorm:
+                        case GpuResourceFormat::BC3UnormSrgb: return &encodeBC3;
+                        case GpuResourceFormat::BC4Unorm: return &encodeBC4;
+                        case GpuResourceFormat::BC5Unorm: return &encodeBC5;
+                        case GpuResourceFormat::BC7Unorm:
+                        case GpuResourceFormat::BC7UnormSrgb: return &encodeBC7;
+                        case GpuResourceFormat::BC6HU16: return &encodeBC6H;
+                        default: return nullptr;
+                    }
+                }
+            }
+
+            bool IsSupported(GpuResourceFormat sourceFormat, GpuResourceFormat destFormat)
+            {
+                if (!getEncoder(destFormat))
+                    return false;
+
+                if (destFormat == GpuResourceFormat::BC6HU16)
+                    return sourceFormat == GpuResourceFormat::RGBA32Float;
+
+                return sourceFormat == GpuResourceFormat::RGBA8Unorm || sourceFormat == GpuResourceFormat::RGBA8UnormSrgb;
+            }
+
+            bool EncodeBlock(GpuResourceFormat destFormat, const float* texels, uint8_t* dest)
+            {
+                ASSERT(texels);
+                ASSERT(dest);
+
+                const auto encoder = getEncoder(destFormat);
+                if (!encoder)
+                    return false;
+
+                Block block;
+                if (destFormat == GpuResourceFormat::BC6HU16)
+                {
+                    std::array<uint16_t, BlockTexels * 4> halfs;
+                    TexelConversion::ConvertRowRGBA32FloatToRGBA16Float(texels, halfs.data(), BlockTexels);
+
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                        block[texel] = halfToColor(halfs.data() + texel * 4);
+                }
+                else
+                {
+                    // Same rounding as 8 bit unorm texels Compress takes.
+                    for (uint32_t texel = 0; texel < BlockTexels; texel++)
+                        for (uint32_t channel = 0; channel < 4; channel++)
+                            block[texel][channel] = std::floor(std::clamp(texels[texel * 4 + channel], 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+
+                encoder(block, dest);
+                return true;
+            }
+
+            bool Compress(const CpuResourceData::SharedPtr& source, const CpuResourceData::SharedPtr& dest)
+            {
+                ASSERT(source);
+                ASSERT(dest);
+                ASSERT(source->GetNumSubresources() == dest->GetNumSubresources());
+
+                const auto sourceFormat = source->GetResourceDescription().GetFormat();
+                const auto destFormat = dest->GetResourceDescription().GetFormat();
+
+                if (!IsSupported(sourceFormat, destFormat))
+                    return false;
+
+                const auto encoder = getEncoder(destFormat);
+                const bool isHdr = destFormat == GpuResourceFormat::BC6HU16;
+                const uint32_t blockSize = GpuResourceFormatInfo::GetBlockSize(destFormat);
+
+                // Block row of a subresource slice is the unit of work, rows of large mips spread across all workers.
+                struct BlockRow final
+                {
+                    uint32_t subresource;
+                    uint32_t slice;
+                    uint32_t row;
+                };
+
+                std::vector<BlockRow> blockRows;
+                for (uint32_t index = 0; index < source->GetNumSubresources(); index++)
+                {
+                    const auto& sourceFootprint = source->GetSubresourceFootprintAt(index);
+                    const auto& destFootprint = dest->GetSubresourceFootprintAt(index);
+                    ASSERT(destFootprint.numRows == (sourceFootprint.height + BlockDimension - 1) / BlockDimension);
+                    ASSERT(destFootprint.rowSizeInBytes >= (sourceFootprint.width + BlockDimension - 1) / BlockDimension * blockSize);
+                    ASSERT(destFootprint.depth == sourceFootprint.depth);
+
+                    for (uint32_t slice = 0; slice < destFootprint.depth; slice++)
+                        for (uint32_t row = 0; row < destFootprint.numRows; row++)
+                            blockRows.push_back({ index, slice, row });
+                }
+
+                const auto& sourceAllocation = source->GetAllocation();
+                const auto& destAllocation = dest->GetAllocation();
+                const auto sourcePointer = static_cast<const uint8_t*>(sourceAllocation->Map());
+                const auto destPointer = static_cast<uint8_t*>(destAllocation->Map());
+                ON_SCOPE_EXIT(sourceAllocation->Unmap());
+                ON_SCOPE_EXIT(destAllocation->Unmap());
+
+                const auto encodeBlockRow = [&](const BlockRow& blockRow, std::vector<uint16_t>& halfs) {
+                    const auto& sourceFootprint = source->GetSubresourceFootprintAt(blockRow.subresource);
+                    const auto& destFootprint = dest->GetSubresourceFootprintAt(blockRow.subresource);
+
+                    const uint32_t width = sourceFootprint.width;
+                    const uint8_t* sourceSlice = sourcePointer + sourceFootprint.offset + blockRow.slice * sourceFootprint.depthPitch;
+                    uint8_t* destRow = destPointer + destFootprint.offset + blockRow.slice * destFootprint.depthPitch + blockRow.row * destFootprint.rowPitch;
+
+                    // Rows past the edge replicate the last one.
+                    std::array<const uint8_t*, BlockDimension> texelRows;
+                    for (uint32_t y = 0; y < BlockDimension; y++)
+                        texelRows[y] = sourceSlice + std::min(blockRow.row * BlockDimension + y, sourceFootprint.height - 1) * sourceFootprint.rowPitch;
+
+                    if (isHdr)
+                    {
+                        halfs.resize(static_cast<size_t>(width) * 4 * BlockDimension);
+                        for (uint32_t y = 0; y < BlockDimension; y++)
+                            TexelConversion::ConvertRowRGBA32FloatToRGBA16Float(reinterpret_cast<const float*>(texelRows[y]), halfs.data() + y * width * 4, width);
+                    }
+
+                    Block block;
+                    for (uint32_t blockColumn = 0; blockColumn < (width + BlockDimension - 1) / BlockDimension; blockColumn++)
+                    {
+                        for (uint32_t y = 0; y < BlockDimension; y++)
+                        {
+                            for (uint32_t x = 0; x < BlockDimension; x++)
+                            {
+                                const uint32_t column = std::min(blockColumn * BlockDimension + x, width - 1);
+                                auto& texel = block[y * BlockDimension + x];
+
+                                if (isHdr)
+                                    texel = halfToColor(halfs.data() + (y * width + column) * 4);
+                                else
+                                {
+                                    const uint8_t* bytes = texelRows[y] + column * 4;
+                                    for (uint32_t channel = 0; channel < 4; channel++)
+                                        texel[channel] = static_cast<float>(bytes[channel]);
+                                }
+                            }
+                        }
+
+                        encoder(block, destRow + blockColumn * blockSize);
+                    }
+                };
+
+                Threading::ParallelFor(0, blockRows.size(), 1, [&blockRows, &encodeBlockRow](size_t first, size_t last) {
+                    std::vector<uint16_t> halfs;
+                    for (size_t index = first; index < last; index++)
+                        encodeBlockRow(blockRows[index], halfs);
+                });
+
+                return true;
+            }
+        }
+    }
+}
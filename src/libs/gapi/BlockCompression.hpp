@@ -0,0 +1,31 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Import time BC encoding of CpuResourceData, result is ready for Render::TextureContainer::Write.
+        // Blocks are encoded independently, so block rows of all subresources are split across job system workers.
+        // Encoders favor speed over quality: principal axis fit with a least squares refinement and single mode
+        // per format (BC7 mode 6, BC6H mode 11), which is enough for albedo, masks and environment maps.
+        namespace BlockCompression
+        {
+            // Supported:
+            // RGBA8Unorm/RGBA8UnormSrgb -> BC1, BC3, BC4Unorm (red), BC5Unorm (red, green), BC7 (Unorm and Srgb variants),
+            // RGBA32Float -> BC6HU16 (negative values are clamped to zero).
+            // BC1 switches blocks with alpha below half to three color mode with transparent black.
+            bool IsSupported(GpuResourceFormat sourceFormat, GpuResourceFormat destFormat);
+
+            // Returns false for unsupported format pair. Dest should match source dimensions and subresources.
+            // Partial edge blocks replicate the last texel column and row.
+            bool Compress(const CpuResourceData::SharedPtr& source, const CpuResourceData::SharedPtr& dest);
+
+            // Encodes single 4x4 block of RGBA32Float texels in row order, for generated content without a source resource.
+            // Values are normalized for LDR formats (stored as is, no sRGB encode) and linear for BC6HU16.
+            // Returns false for unsupported format.
+            bool EncodeBlock(GpuResourceFormat destFormat, const float* texels, uint8_t* dest);
+        }
+    }
+}
@@ -14,7 +14,7 @@ namespace RR
     {
         namespace
         {
-            const GpuResourceViewDescription& createViewDescription(const GpuResourceDescription& resourceDesc, GpuResourceFormat format, uint32_t firstElement, uint32_t numElements)
+            GpuResourceViewDescription createViewDescription(const GpuResourceDescription& resourceDesc, GpuResourceFormat format, uint32_t firstElement, uint32_t numElements)
             {
                 const auto elementSize = GpuResourceFormatInfo::GetBlockSize(format);
 
@@ -35,28 +35,16 @@ namespace RR
         {
             const auto viewDesc = createViewDescription(description_, format, firstElement, numElements);
 
-            if (srvs_.find(viewDesc) == srvs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                srvs_[viewDesc] = renderContext.CreateShaderResourceView(std::static_pointer_cast<Buffer>(shared_from_this()), viewDesc);
-            }
-
-            return srvs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateShaderResourceView(std::static_pointer_cast<Buffer>(shared_from_this()), viewDesc);
         }
 
         UnorderedAccessView::SharedPtr Buffer::GetUAV(GpuResourceFormat format, uint32_t firstElement, uint32_t numElements)
         {
             const auto viewDesc = createViewDescription(description_, format, firstElement, numElements);
 
-            if (uavs_.find(viewDesc) == uavs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                uavs_[viewDesc] = renderContext.CreateUnorderedAccessView(std::static_pointer_cast<Buffer>(shared_from_this()), viewDesc);
-            }
-
-            return uavs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateUnorderedAccessView(std::static_pointer_cast<Buffer>(shared_from_this()), viewDesc);
         }
     }
 }
\ No newline at end of file
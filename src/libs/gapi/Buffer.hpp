@@ -18,13 +18,21 @@ namespace RR
             std::shared_ptr<ShaderResourceView> GetSRV(GpuResourceFormat format, uint32_t firstElement = 0, uint32_t numElements = MaxPossible);
             std::shared_ptr<UnorderedAccessView> GetUAV(GpuResourceFormat format, uint32_t firstElement = 0, uint32_t numElements = MaxPossible);
 
+            // Buffer begin in memory mapped for the buffer lifetime, GpuUpload buffers only.
+            // GPU could still read ranges written for previous frames, so per frame data should be ring buffered.
+            inline void* GetMappedData() const
+            {
+                ASSERT(GetCpuAccess() == GpuResourceCpuAccess::GpuUpload);
+                return GetPrivateImpl()->GetMappedData();
+            }
+
         private:
             static SharedPtr Create(
                 const GpuResourceDescription& description,
                 GpuResourceCpuAccess cpuAccess,
                 const U8String& name)
             {
-                return SharedPtr(new Buffer(description, cpuAccess, name));
+                return MakePooledShared<Buffer>(description, cpuAccess, name);
             }
 
             Buffer(const GpuResourceDescription& description, GpuResourceCpuAccess cpuAccess, const U8String& name)
@@ -32,6 +40,8 @@ namespace RR
 
         private:
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "gapi/ForwardDeclarations.hpp"
+#include "gapi/RenderPass.hpp"
 #include "gapi/Resource.hpp"
+#include "gapi/ShadingRate.hpp"
+
+#include <initializer_list>
 
 namespace RR
 {
@@ -26,7 +30,50 @@ namespace RR
         {
             Copy,
             Compute,
-            Graphics
+            Graphics,
+            // Replayed by graphics command lists, never submitted to queues.
+            Bundle,
+            Count
+        };
+
+        // Whether list of type records commands of required type, e.g. graphics lists record copy commands.
+        // Bundles record only a subset of graphics commands, so they support no type.
+        constexpr bool SupportsCommands(CommandListType type, CommandListType required)
+        {
+            switch (type)
+            {
+                case CommandListType::Copy: return required == CommandListType::Copy;
+                case CommandListType::Compute: return required == CommandListType::Copy || required == CommandListType::Compute;
+                case CommandListType::Graphics: return required == CommandListType::Copy || required == CommandListType::Compute || required == CommandListType::Graphics;
+                default: return false;
+            }
+        }
+
+        // Layout of indirect dispatch arguments, matches D3D12_DISPATCH_ARGUMENTS.
+        struct DispatchArguments final
+        {
+            uint32_t threadGroupCountX;
+            uint32_t threadGroupCountY;
+            uint32_t threadGroupCountZ;
+        };
+
+        // Layout of indirect draw arguments, matches D3D12_DRAW_INDEXED_ARGUMENTS.
+        struct DrawIndexedArguments final
+        {
+            uint32_t indexCountPerInstance;
+            uint32_t instanceCount;
+            uint32_t startIndexLocation;
+            int32_t baseVertexLocation;
+            uint32_t startInstanceLocation;
+        };
+
+        // Small CPU payload copied into buffer range, data is read during UpdateBuffers call only.
+        struct BufferUpdate final
+        {
+            std::shared_ptr<Buffer> buffer;
+            uint32_t offset;
+            const void* data;
+            uint32_t size;
         };
 
         // https://docs.microsoft.com/en-us/windows/win32/direct3d12/recording-command-lists-and-bundles#command-list-api-restrictions
@@ -36,6 +83,10 @@ namespace RR
             virtual ~ICommandList() = default;
             virtual void Close() = 0;
 
+            // Scoped GPU timestamps. Markers could be nested, but should be closed in the same command list.
+            virtual void BeginMarker(const U8String& name) = 0;
+            virtual void EndMarker() = 0;
+
             // ---------------------------------------------------------------------------------------------
             // Copy command list
             // ---------------------------------------------------------------------------------------------
@@ -49,6 +100,7 @@ namespace RR
                                                       const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx, const Vector3u& destPoint) = 0;
 
             virtual void UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData) = 0;
+            virtual void UpdateBuffers(const BufferUpdate* updates, uint32_t count) = 0;
             virtual void ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData) = 0;
 
             // ---------------------------------------------------------------------------------------------
@@ -58,13 +110,93 @@ namespace RR
             virtual void ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue) = 0;
             virtual void ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue) = 0;
 
+            // Fills mips 1..N of texture by successively downsampling mip 0.
+            virtual void GenerateMips(const std::shared_ptr<Texture>& texture) = 0;
+
+            // Copies constants to per-frame upload ring. Returned GPU virtual address is valid until GPU completes the frame.
+            virtual uint64_t AllocateConstants(const void* data, size_t size) = 0;
+            // Binds constant buffer address to root CBV parameter of current root signature.
+            virtual void SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress) = 0;
+
+            // Root bindings are kept while consecutive pipelines share root signature. GenerateMips resets bound pipeline.
+            virtual void SetComputePipelineState(const PipelineState& pipelineState) = 0;
+            // Points descriptor table of current root signature to bindless heap slot, unbounded tables are bound to slot 0.
+            virtual void SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex) = 0;
+            // Shaders access views through bindless indices, so states of resources are declared before dispatch.
+            virtual void TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView) = 0;
+            // Starts split transition right after the last write, TransitionToShaderResource of the view ends it before the first read.
+            // Work recorded in between overlaps with the transition. Commands in between must not access the resource.
+            virtual void BeginTransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView) = 0;
+            virtual void TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView) = 0;
+            // Orders unordered accesses of consecutive dispatches to the same resource.
+            virtual void UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource) = 0;
+
+            virtual void Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) = 0;
+            // Argument buffer holds DispatchArguments at offset, e.g. written by GPU culling.
+            virtual void DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset) = 0;
+
             // ---------------------------------------------------------------------------------------------
             // Graphics command list
             // ---------------------------------------------------------------------------------------------
 
             virtual void ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color) = 0;
+            // Binds attachments as render targets with their load and store ops. Resource states can't change inside the pass,
+            // so shader resources are transitioned before it. Passes can't be nested or span command lists.
+            virtual void BeginRenderPass(const RenderPassAttachment* attachments, uint32_t attachmentCount) = 0;
+            virtual void EndRenderPass() = 0;
+            // Contents of the resource are undefined until fully overwritten, e.g. transient targets before reuse.
+            virtual void DiscardResource(const std::shared_ptr<GpuResource>& resource) = 0;
+            // Activates transient resource in memory shared with other transients, before its first use in the frame.
+            virtual void AliasingBarrier(const std::shared_ptr<GpuResource>& resource) = 0;
+            // Averages samples of multisampled subresource into single sampled one, outside of render pass.
+            virtual void ResolveSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                            const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx) = 0;
+            virtual void SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress) = 0;
+
+            // Triangle lists only. Root bindings are kept while consecutive pipelines share root signature.
+            virtual void SetGraphicsPipelineState(const PipelineState& pipelineState) = 0;
+            virtual void SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex) = 0;
+            // Viewport and scissor cover mip of the first target. Depth stencil views aren't supported by backends yet.
+            virtual void SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount) = 0;
+            virtual void SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format) = 0;
+            // Shading rate state is kept until changed or list is submitted, see IMultiThreadDevice::GetShadingRateSupport.
+            virtual void SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner) = 0;
+            // R8Uint texture of EncodeShadingRate values, one per tile. Null unbinds.
+            virtual void SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage) = 0;
+            // Executes up to maxCommandCount records laid out by PipelineStateDescription::GetIndirectCommandStride.
+            // Actual count is read from count buffer when it's set, e.g. written by GPU culling.
+            virtual void ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                         const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset) = 0;
+
+            // Root parameter 0 of pipelines with draw constants.
+            virtual void SetDrawConstants(const uint32_t* constants, uint32_t count) = 0;
+            virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) = 0;
+            // Resources referenced by bundle are transitioned to states it uses them in before replay.
+            // Pipeline and root bindings set by bundle leak into the list, so they are bound again after.
+            virtual void ExecuteBundle(const BundleCommandList& bundle) = 0;
+
+            // Query counts work of commands recorded between Begin and End in the same list.
+            virtual void BeginQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) = 0;
+            virtual void EndQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) = 0;
+            // Writes results of ended queries to result buffer of the pool, see QueryPool::GetResultBuffer.
+            virtual void ResolveQueries(const std::shared_ptr<QueryPool>& queryPool, uint32_t firstQuery, uint32_t count) = 0;
+            // Following draws, dispatches, copies and clears are skipped while resolved occlusion result is zero,
+            // e.g. the object wasn't visible in previous frame. Kept until list is closed. Null pool disables predication.
+            virtual void SetPredication(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) = 0;
         };
 
+#if GAPI_STATIC_BACKEND && GAPI_BACKEND_DX12
+        namespace DX12
+        {
+            class CommandListImpl;
+        }
+
+        // Only one backend is compiled in, wrappers call final implementation without virtual dispatch.
+        using CommandListImplType = DX12::CommandListImpl;
+#else
+        using CommandListImplType = ICommandList;
+#endif
+
         class CommandList : public Resource<ICommandList>
         {
         public:
@@ -72,10 +204,24 @@ namespace RR
             using SharedConstPtr = std::shared_ptr<const CommandList>;
 
             inline CommandListType GetCommandListType() const { return type_; };
+            // Draws, dispatches, copies, clears and resolves recorded before the last Close, e.g. for submission heuristics.
+            inline uint32_t GetWorkCommandsCount() const { return closedWorkCommandsCount_; }
 
-            inline void Close() { return GetPrivateImpl()->Close(); }
+            void Close();
+
+            void BeginMarker(const U8String& name);
+            void EndMarker();
+
+#ifdef ENABLE_COMMAND_CAPTURE
+            // Commands are mirrored into attached stream, so they could be serialized after recording. Null detaches.
+            inline void SetCaptureStream(const std::shared_ptr<CommandStream>& captureStream) { captureStream_ = captureStream; }
+            inline const std::shared_ptr<CommandStream>& GetCaptureStream() const { return captureStream_; }
+#endif
 
         protected:
+            // Backend implementation type is complete only in CommandList.inl.
+            CommandListImplType* getImpl();
+
             CommandList(CommandListType type, const U8String& name)
                 : Resource(Object::Type::CommandList, name),
                   type_(type)
@@ -83,6 +229,11 @@ namespace RR
             }
 
             CommandListType type_;
+            uint32_t workCommandsCount_ = 0;
+            uint32_t closedWorkCommandsCount_ = 0;
+#ifdef ENABLE_COMMAND_CAPTURE
+            std::shared_ptr<CommandStream> captureStream_;
+#endif
         };
 
         class CopyCommandList : public CommandList
@@ -101,12 +252,16 @@ namespace RR
                                               const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx, const Vector3u& destPoint);
 
             void UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData);
+            // Packs all payloads into shared upload memory and records copies with single barrier batch.
+            // Cheaper than UpdateGpuResource per buffer for many small updates.
+            void UpdateBuffers(std::initializer_list<BufferUpdate> updates);
+            void UpdateBuffers(const BufferUpdate* updates, uint32_t count);
             void ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData);
 
         private:
             static SharedPtr Create(const U8String& name)
             {
-                return SharedPtr(new CopyCommandList(CommandListType::Copy, name));
+                return MakePooledShared<CopyCommandList>(CommandListType::Copy, name);
             }
 
         protected:
@@ -117,6 +272,8 @@ namespace RR
 
         private:
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
 
         class ComputeCommandList : public CopyCommandList
@@ -125,13 +282,36 @@ namespace RR
             using SharedPtr = std::shared_ptr<ComputeCommandList>;
             using SharedConstPtr = std::shared_ptr<const ComputeCommandList>;
 
-            inline void ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue) { GetPrivateImpl()->ClearUnorderedAccessViewUint(unorderedAcessView, clearValue); }
-            inline void ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue) { GetPrivateImpl()->ClearUnorderedAccessViewFloat(unorderedAcessView, clearValue); };
+            void ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue);
+            void ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue);
+
+            void GenerateMips(const std::shared_ptr<Texture>& texture);
+
+            // Per-draw constants cost a copy to upload ring instead of resource creation.
+            template <typename T>
+            uint64_t AllocateConstants(const T& constants)
+            {
+                static_assert(std::is_trivially_copyable_v<T>, "Constants are copied to GPU memory as is.");
+                return AllocateConstants(&constants, sizeof(T));
+            }
+            uint64_t AllocateConstants(const void* data, size_t size);
+            void SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress);
+
+            // Binds resolved state, fallback one while async compilation is in flight. False means dispatches should be skipped.
+            bool SetComputePipelineState(const std::shared_ptr<PipelineState>& pipelineState);
+            void SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex);
+            void TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView);
+            void BeginTransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView);
+            void TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView);
+            void UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource);
+
+            void Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY = 1, uint32_t threadGroupCountZ = 1);
+            void DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset = 0);
 
         private:
             static SharedPtr Create(const U8String& name)
             {
-                return SharedPtr(new ComputeCommandList(CommandListType::Compute, name));
+                return MakePooledShared<ComputeCommandList>(CommandListType::Compute, name);
             }
 
         protected:
@@ -142,6 +322,8 @@ namespace RR
 
         private:
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
 
         class GraphicsCommandList final : public ComputeCommandList
@@ -150,12 +332,53 @@ namespace RR
             using SharedPtr = std::shared_ptr<GraphicsCommandList>;
             using SharedConstPtr = std::shared_ptr<const GraphicsCommandList>;
 
-            inline void ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color) { GetPrivateImpl()->ClearRenderTargetView(renderTargetView, color); }
+            // Fast clear needs color matching GpuResourceDescription::SetOptimizedClearValue of the target.
+            void ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color);
+            // Load and store ops let tile-based and compressing GPUs skip memory traffic, prefer them over clears.
+            void BeginRenderPass(std::initializer_list<RenderPassAttachment> attachments);
+            void BeginRenderPass(const RenderPassAttachment* attachments, uint32_t attachmentCount);
+            void EndRenderPass();
+            void DiscardResource(const std::shared_ptr<GpuResource>& resource);
+            // Issued by render graph in execution order, prior work on other transients in the memory completes first.
+            void AliasingBarrier(const std::shared_ptr<GpuResource>& resource);
+            // Fixed function box filter in destination format. HDR edges alias with it, Render::MsaaResolve weights samples instead.
+            void ResolveSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                    const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx);
+            void SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress);
+
+            // Binds resolved state, fallback one while async compilation is in flight. False means draws should be skipped.
+            bool SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState);
+            void SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex);
+            void SetRenderTargets(std::initializer_list<std::shared_ptr<RenderTargetView>> renderTargetViews);
+            void SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount);
+            void SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format);
+            // Coarse shading of following draws. Combiner applies only while shading rate image is bound, which needs tier 2.
+            void SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner = ShadingRateCombiner::Passthrough);
+            void SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage);
+            // Whole scene pass in one call: CPU cost doesn't depend on count of objects.
+            void ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                 const std::shared_ptr<Buffer>& countBuffer = nullptr, uint32_t countOffset = 0);
+
+            template <typename T>
+            void SetDrawConstants(const T& constants)
+            {
+                static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(uint32_t) == 0, "Constants are set as 32-bit values.");
+                SetDrawConstants(reinterpret_cast<const uint32_t*>(&constants), sizeof(T) / sizeof(uint32_t));
+            }
+            void SetDrawConstants(const uint32_t* constants, uint32_t count);
+            void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t startIndex = 0, int32_t baseVertex = 0, uint32_t startInstance = 0);
+            void ExecuteBundle(const std::shared_ptr<BundleCommandList>& bundle);
+
+            void BeginQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index);
+            void EndQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index);
+            void ResolveQueries(const std::shared_ptr<QueryPool>& queryPool, uint32_t firstQuery, uint32_t count);
+            // Occlusion and binary occlusion pools only, results should be resolved before.
+            void SetPredication(const std::shared_ptr<QueryPool>& queryPool, uint32_t index);
 
         private:
             static SharedPtr Create(const U8String& name)
             {
-                return SharedPtr(new GraphicsCommandList(name));
+                return MakePooledShared<GraphicsCommandList>(name);
             }
 
         protected:
@@ -166,6 +389,47 @@ namespace RR
 
         private:
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
+        };
+
+        // Draws recorded once and replayed by graphics command lists at near zero CPU cost, e.g. static geometry passes.
+        // Bundle is immutable after Close. It can't have barriers, render targets or clears, those are set by executing list.
+        class BundleCommandList final : public CommandList
+        {
+        public:
+            using SharedPtr = std::shared_ptr<BundleCommandList>;
+            using SharedConstPtr = std::shared_ptr<const BundleCommandList>;
+
+            // Binds resolved state, fallback one while async compilation is in flight. False means draws should be skipped.
+            bool SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState);
+            void SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex);
+            void SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format);
+
+            template <typename T>
+            void SetDrawConstants(const T& constants)
+            {
+                static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(uint32_t) == 0, "Constants are set as 32-bit values.");
+                SetDrawConstants(reinterpret_cast<const uint32_t*>(&constants), sizeof(T) / sizeof(uint32_t));
+            }
+            void SetDrawConstants(const uint32_t* constants, uint32_t count);
+            void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t startIndex = 0, int32_t baseVertex = 0, uint32_t startInstance = 0);
+
+        private:
+            static SharedPtr Create(const U8String& name)
+            {
+                return MakePooledShared<BundleCommandList>(name);
+            }
+
+            BundleCommandList(const U8String& name)
+                : CommandList(CommandListType::Bundle, name)
+            {
+            }
+
+        private:
+            friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
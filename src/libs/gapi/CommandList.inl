@@ -1,19 +1,67 @@
 #ifdef ENABLE_ASSERTS
 #include "common/Math.hpp"
+#include "gapi/Buffer.hpp"
 #include "gapi/Texture.hpp"
 #endif
 
+#include "gapi/Limits.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/QueryPool.hpp"
+
+#if GAPI_STATIC_BACKEND && GAPI_BACKEND_DX12
+#include "gapi_dx12/CommandListImpl.hpp"
+#endif
+
+#ifdef ENABLE_COMMAND_CAPTURE
+#include "gapi/CommandStream.hpp"
+// Mirrors command into capture stream when one is attached.
+#define CAPTURE_COMMAND(command) \
+    if (captureStream_)          \
+    captureStream_->command
+#else
+#define CAPTURE_COMMAND(command) (void)0
+#endif
+
 namespace RR
 {
     namespace GAPI
     {
+        INLINE CommandListImplType* CommandList::getImpl()
+        {
+            // Downcast is resolved at compile time, implementation is final.
+            return static_cast<CommandListImplType*>(GetPrivateImpl());
+        }
+
+        INLINE void CommandList::Close()
+        {
+            getImpl()->Close();
+
+            // Pooled lists are recorded again after submission, counting starts over.
+            closedWorkCommandsCount_ = workCommandsCount_;
+            workCommandsCount_ = 0;
+        }
+
+        INLINE void CommandList::BeginMarker(const U8String& name)
+        {
+            getImpl()->BeginMarker(name);
+            CAPTURE_COMMAND(BeginMarker(name));
+        }
+
+        INLINE void CommandList::EndMarker()
+        {
+            getImpl()->EndMarker();
+            CAPTURE_COMMAND(EndMarker());
+        }
+
         INLINE void CopyCommandList::CopyBufferRegion(const std::shared_ptr<Buffer>& sourceBuffer, uint32_t sourceOffset,
                                                       const std::shared_ptr<Buffer>& destBuffer, uint32_t destOffset, uint32_t numBytes)
         {
             ASSERT(sourceBuffer);
             ASSERT(destBuffer);
 
-            GetPrivateImpl()->CopyBufferRegion(sourceBuffer, sourceOffset, destBuffer, destOffset, numBytes);
+            workCommandsCount_++;
+            getImpl()->CopyBufferRegion(sourceBuffer, sourceOffset, destBuffer, destOffset, numBytes);
+            CAPTURE_COMMAND(CopyBufferRegion(sourceBuffer, sourceOffset, destBuffer, destOffset, numBytes));
         }
 
         INLINE void CopyCommandList::CopyGpuResource(const std::shared_ptr<GpuResource>& source, const std::shared_ptr<GpuResource>& dest)
@@ -21,7 +69,9 @@ namespace RR
             ASSERT(source);
             ASSERT(dest);
 
-            GetPrivateImpl()->CopyGpuResource(source, dest);
+            workCommandsCount_++;
+            getImpl()->CopyGpuResource(source, dest);
+            CAPTURE_COMMAND(CopyGpuResource(source, dest));
         }
 
         INLINE void CopyCommandList::CopyTextureSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
@@ -37,7 +87,9 @@ namespace RR
             ASSERT(destSubresourceIdx < destDesc.GetNumSubresources());
 #endif
 
-            GetPrivateImpl()->CopyTextureSubresource(sourceTexture, sourceSubresourceIdx, destTexture, destSubresourceIdx);
+            workCommandsCount_++;
+            getImpl()->CopyTextureSubresource(sourceTexture, sourceSubresourceIdx, destTexture, destSubresourceIdx);
+            CAPTURE_COMMAND(CopyTextureSubresource(sourceTexture, sourceSubresourceIdx, destTexture, destSubresourceIdx));
         }
 
         namespace
@@ -85,7 +137,9 @@ namespace RR
             ASSERT(checkTextureRegion(destDesc, destSubresourceIdx, Box3u(destPoint, sourceBox.GetSize())));
 #endif
 
-            GetPrivateImpl()->CopyTextureSubresourceRegion(sourceTexture, sourceSubresourceIdx, sourceBox, destTexture, destSubresourceIdx, destPoint);
+            workCommandsCount_++;
+            getImpl()->CopyTextureSubresourceRegion(sourceTexture, sourceSubresourceIdx, sourceBox, destTexture, destSubresourceIdx, destPoint);
+            CAPTURE_COMMAND(CopyTextureSubresourceRegion(sourceTexture, sourceSubresourceIdx, sourceBox, destTexture, destSubresourceIdx, destPoint));
         }
 
         INLINE void CopyCommandList::UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData)
@@ -93,7 +147,37 @@ namespace RR
             ASSERT(resource);
             ASSERT(resourceData);
 
-            GetPrivateImpl()->UpdateGpuResource(resource, resourceData);
+            workCommandsCount_++;
+            getImpl()->UpdateGpuResource(resource, resourceData);
+            CAPTURE_COMMAND(UpdateGpuResource(resource, resourceData));
+        }
+
+        INLINE void CopyCommandList::UpdateBuffers(std::initializer_list<BufferUpdate> updates)
+        {
+            UpdateBuffers(updates.begin(), static_cast<uint32_t>(updates.size()));
+        }
+
+        INLINE void CopyCommandList::UpdateBuffers(const BufferUpdate* updates, uint32_t count)
+        {
+            if (count == 0)
+                return;
+
+            ASSERT(updates);
+#ifdef ENABLE_ASSERTS
+            for (uint32_t index = 0; index < count; index++)
+            {
+                const auto& update = updates[index];
+                ASSERT(update.buffer);
+                ASSERT(update.data);
+                ASSERT(update.size > 0);
+                ASSERT(update.offset + update.size <= update.buffer->GetDescription().GetSize());
+            }
+#endif
+
+            workCommandsCount_++;
+            getImpl()->UpdateBuffers(updates, count);
+            // Payloads aren't owned by the list, so there is nothing to replay.
+            CAPTURE_COMMAND(SkipCommand());
         }
 
         INLINE void CopyCommandList::ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData)
@@ -101,7 +185,403 @@ namespace RR
             ASSERT(resource);
             ASSERT(resourceData);
 
-            GetPrivateImpl()->ReadbackGpuResource(resource, resourceData);
+            workCommandsCount_++;
+            getImpl()->ReadbackGpuResource(resource, resourceData);
+            CAPTURE_COMMAND(ReadbackGpuResource(resource, resourceData));
+        }
+
+        INLINE void ComputeCommandList::ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue)
+        {
+            ASSERT(unorderedAcessView);
+
+            workCommandsCount_++;
+            getImpl()->ClearUnorderedAccessViewUint(unorderedAcessView, clearValue);
+            CAPTURE_COMMAND(ClearUnorderedAccessViewUint(unorderedAcessView, clearValue));
+        }
+
+        INLINE void ComputeCommandList::ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue)
+        {
+            ASSERT(unorderedAcessView);
+
+            workCommandsCount_++;
+            getImpl()->ClearUnorderedAccessViewFloat(unorderedAcessView, clearValue);
+            CAPTURE_COMMAND(ClearUnorderedAccessViewFloat(unorderedAcessView, clearValue));
+        }
+
+        INLINE void ComputeCommandList::GenerateMips(const std::shared_ptr<Texture>& texture)
+        {
+            ASSERT(texture);
+
+            workCommandsCount_++;
+            getImpl()->GenerateMips(texture);
+            CAPTURE_COMMAND(GenerateMips(texture));
+        }
+
+        INLINE uint64_t ComputeCommandList::AllocateConstants(const void* data, size_t size)
+        {
+            ASSERT(data);
+            ASSERT(size > 0);
+
+            const auto gpuVirtualAddress = getImpl()->AllocateConstants(data, size);
+            CAPTURE_COMMAND(AllocateConstants(data, size, gpuVirtualAddress));
+            return gpuVirtualAddress;
+        }
+
+        INLINE void ComputeCommandList::SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+        {
+            ASSERT(gpuVirtualAddress);
+
+            getImpl()->SetComputeConstantBuffer(rootParameterIndex, gpuVirtualAddress);
+            CAPTURE_COMMAND(SetComputeConstantBuffer(rootParameterIndex, gpuVirtualAddress));
+        }
+
+        INLINE bool ComputeCommandList::SetComputePipelineState(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            ASSERT(pipelineState);
+            ASSERT(pipelineState->GetDescription().type == PipelineStateType::Compute);
+
+            const auto resolved = pipelineState->Resolve();
+            if (!resolved)
+                return false;
+
+            getImpl()->SetComputePipelineState(*resolved);
+            CAPTURE_COMMAND(SetComputePipelineState(pipelineState));
+            return true;
+        }
+
+        INLINE void ComputeCommandList::SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+        {
+            getImpl()->SetComputeDescriptorTable(rootParameterIndex, bindlessIndex);
+            CAPTURE_COMMAND(SetComputeDescriptorTable(rootParameterIndex, bindlessIndex));
+        }
+
+        INLINE void ComputeCommandList::TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView)
+        {
+            ASSERT(shaderResourceView);
+
+            getImpl()->TransitionToShaderResource(shaderResourceView);
+            CAPTURE_COMMAND(TransitionToShaderResource(shaderResourceView));
+        }
+
+        INLINE void ComputeCommandList::BeginTransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView)
+        {
+            ASSERT(shaderResourceView);
+
+            getImpl()->BeginTransitionToShaderResource(shaderResourceView);
+            // Replay ends up with regular transitions.
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void ComputeCommandList::TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView)
+        {
+            ASSERT(unorderedAcessView);
+
+            getImpl()->TransitionToUnorderedAccess(unorderedAcessView);
+            CAPTURE_COMMAND(TransitionToUnorderedAccess(unorderedAcessView));
+        }
+
+        INLINE void ComputeCommandList::UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource)
+        {
+            ASSERT(resource);
+
+            getImpl()->UnorderedAccessBarrier(resource);
+            CAPTURE_COMMAND(UnorderedAccessBarrier(resource));
+        }
+
+        INLINE void ComputeCommandList::Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ)
+        {
+            ASSERT(threadGroupCountX > 0 && threadGroupCountY > 0 && threadGroupCountZ > 0);
+            ASSERT(threadGroupCountX <= MAX_THREAD_GROUPS_PER_DIMENSION);
+            ASSERT(threadGroupCountY <= MAX_THREAD_GROUPS_PER_DIMENSION);
+            ASSERT(threadGroupCountZ <= MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            workCommandsCount_++;
+            getImpl()->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+            CAPTURE_COMMAND(Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ));
+        }
+
+        INLINE void ComputeCommandList::DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset)
+        {
+            ASSERT(argumentBuffer);
+            ASSERT(IsAlignedTo(argumentOffset, sizeof(uint32_t)));
+            ASSERT(argumentOffset + sizeof(DispatchArguments) <= argumentBuffer->GetDescription().GetSize());
+
+            workCommandsCount_++;
+            getImpl()->DispatchIndirect(argumentBuffer, argumentOffset);
+            CAPTURE_COMMAND(DispatchIndirect(argumentBuffer, argumentOffset));
+        }
+
+        INLINE void GraphicsCommandList::ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color)
+        {
+            ASSERT(renderTargetView);
+
+            workCommandsCount_++;
+            getImpl()->ClearRenderTargetView(renderTargetView, color);
+            CAPTURE_COMMAND(ClearRenderTargetView(renderTargetView, color));
+        }
+
+        INLINE void GraphicsCommandList::BeginRenderPass(std::initializer_list<RenderPassAttachment> attachments)
+        {
+            BeginRenderPass(attachments.begin(), static_cast<uint32_t>(attachments.size()));
+        }
+
+        INLINE void GraphicsCommandList::BeginRenderPass(const RenderPassAttachment* attachments, uint32_t attachmentCount)
+        {
+            ASSERT(attachments);
+            ASSERT(attachmentCount > 0);
+            ASSERT(attachmentCount <= PipelineStateDescription::MaxRenderTargets);
+#ifdef ENABLE_ASSERTS
+            for (uint32_t index = 0; index < attachmentCount; index++)
+            {
+                const auto& attachment = attachments[index];
+                ASSERT(attachment.renderTargetView);
+                ASSERT((attachment.storeOp == AttachmentStoreOp::Resolve) == static_cast<bool>(attachment.resolveTarget));
+                ASSERT(!attachment.resolveTarget || attachment.resolveTarget->GetDescription().GetSampleCount() == 1);
+            }
+#endif
+
+            getImpl()->BeginRenderPass(attachments, attachmentCount);
+            // Render pass structs aren't serialized yet.
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::EndRenderPass()
+        {
+            getImpl()->EndRenderPass();
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::DiscardResource(const std::shared_ptr<GpuResource>& resource)
+        {
+            ASSERT(resource);
+
+            getImpl()->DiscardResource(resource);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::AliasingBarrier(const std::shared_ptr<GpuResource>& resource)
+        {
+            ASSERT(resource);
+
+            getImpl()->AliasingBarrier(resource);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::ResolveSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                                            const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx)
+        {
+#ifdef ENABLE_ASSERTS
+            ASSERT(sourceTexture);
+            ASSERT(destTexture);
+
+            const auto& sourceDesc = sourceTexture->GetDescription();
+            const auto& destDesc = destTexture->GetDescription();
+            ASSERT(sourceSubresourceIdx < sourceDesc.GetNumSubresources());
+            ASSERT(destSubresourceIdx < destDesc.GetNumSubresources());
+            ASSERT(sourceDesc.GetSampleCount() > 1 && destDesc.GetSampleCount() == 1);
+            ASSERT(sourceDesc.GetFormat() == destDesc.GetFormat());
+            ASSERT(sourceDesc.GetWidth() == destDesc.GetWidth(destDesc.GetSubresourceMipLevel(destSubresourceIdx)));
+            ASSERT(sourceDesc.GetHeight() == destDesc.GetHeight(destDesc.GetSubresourceMipLevel(destSubresourceIdx)));
+#endif
+
+            workCommandsCount_++;
+            getImpl()->ResolveSubresource(sourceTexture, sourceSubresourceIdx, destTexture, destSubresourceIdx);
+            // Resolves aren't serialized yet, like render pass ones.
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+        {
+            ASSERT(gpuVirtualAddress);
+
+            getImpl()->SetGraphicsConstantBuffer(rootParameterIndex, gpuVirtualAddress);
+            CAPTURE_COMMAND(SetGraphicsConstantBuffer(rootParameterIndex, gpuVirtualAddress));
+        }
+
+        INLINE bool GraphicsCommandList::SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            ASSERT(pipelineState);
+            ASSERT(pipelineState->GetDescription().type == PipelineStateType::Graphics);
+
+            const auto resolved = pipelineState->Resolve();
+            if (!resolved)
+                return false;
+
+            getImpl()->SetGraphicsPipelineState(*resolved);
+            CAPTURE_COMMAND(SetGraphicsPipelineState(pipelineState));
+            return true;
+        }
+
+        INLINE void GraphicsCommandList::SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+        {
+            getImpl()->SetGraphicsDescriptorTable(rootParameterIndex, bindlessIndex);
+            CAPTURE_COMMAND(SetGraphicsDescriptorTable(rootParameterIndex, bindlessIndex));
+        }
+
+        INLINE void GraphicsCommandList::SetRenderTargets(std::initializer_list<std::shared_ptr<RenderTargetView>> renderTargetViews)
+        {
+            ASSERT(renderTargetViews.size() > 0);
+            ASSERT(renderTargetViews.size() <= PipelineStateDescription::MaxRenderTargets);
+
+            SetRenderTargets(renderTargetViews.begin(), static_cast<uint32_t>(renderTargetViews.size()));
+        }
+
+        INLINE void GraphicsCommandList::SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount)
+        {
+            ASSERT(renderTargetViews);
+            ASSERT(renderTargetCount > 0);
+            ASSERT(renderTargetCount <= PipelineStateDescription::MaxRenderTargets);
+
+            getImpl()->SetRenderTargets(renderTargetViews, renderTargetCount);
+            CAPTURE_COMMAND(SetRenderTargets(renderTargetViews, renderTargetCount));
+        }
+
+        INLINE void GraphicsCommandList::SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format)
+        {
+            ASSERT(indexBuffer);
+            ASSERT(format == GpuResourceFormat::R16Uint || format == GpuResourceFormat::R32Uint);
+
+            getImpl()->SetIndexBuffer(indexBuffer, format);
+            CAPTURE_COMMAND(SetIndexBuffer(indexBuffer, format));
+        }
+
+        INLINE void GraphicsCommandList::SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner)
+        {
+            ASSERT(baseRate < ShadingRate::Count);
+
+            getImpl()->SetShadingRate(baseRate, imageCombiner);
+            CAPTURE_COMMAND(SetShadingRate(baseRate, imageCombiner));
+        }
+
+        INLINE void GraphicsCommandList::SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage)
+        {
+#ifdef ENABLE_ASSERTS
+            ASSERT(!shadingRateImage || shadingRateImage->GetDescription().GetFormat() == GpuResourceFormat::R8Uint);
+#endif
+
+            getImpl()->SetShadingRateImage(shadingRateImage);
+            CAPTURE_COMMAND(SetShadingRateImage(shadingRateImage));
+        }
+
+        INLINE void GraphicsCommandList::ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                                         const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset)
+        {
+            ASSERT(argumentBuffer);
+            ASSERT(IsAlignedTo(argumentOffset, sizeof(uint32_t)));
+            ASSERT(!countBuffer || IsAlignedTo(countOffset, sizeof(uint32_t)));
+
+            if (maxCommandCount == 0)
+                return;
+
+            workCommandsCount_++;
+            getImpl()->ExecuteIndirect(argumentBuffer, argumentOffset, maxCommandCount, countBuffer, countOffset);
+            CAPTURE_COMMAND(ExecuteIndirect(argumentBuffer, argumentOffset, maxCommandCount, countBuffer, countOffset));
+        }
+
+        INLINE void GraphicsCommandList::SetDrawConstants(const uint32_t* constants, uint32_t count)
+        {
+            ASSERT(constants);
+            ASSERT(count > 0 && count <= PipelineStateDescription::MaxDrawConstants);
+
+            getImpl()->SetDrawConstants(constants, count);
+            CAPTURE_COMMAND(SetDrawConstants(constants, count));
+        }
+
+        INLINE void GraphicsCommandList::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+        {
+            workCommandsCount_++;
+            getImpl()->DrawIndexed(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+            CAPTURE_COMMAND(DrawIndexed(indexCount, instanceCount, startIndex, baseVertex, startInstance));
+        }
+
+        INLINE void GraphicsCommandList::ExecuteBundle(const std::shared_ptr<BundleCommandList>& bundle)
+        {
+            ASSERT(bundle);
+
+            workCommandsCount_++;
+            getImpl()->ExecuteBundle(*bundle);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        // Query pools aren't captured, streams with queries are replayed without them.
+        INLINE void GraphicsCommandList::BeginQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+        {
+            ASSERT(queryPool);
+            ASSERT(index < queryPool->GetDescription().count);
+
+            getImpl()->BeginQuery(queryPool, index);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::EndQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+        {
+            ASSERT(queryPool);
+            ASSERT(index < queryPool->GetDescription().count);
+
+            getImpl()->EndQuery(queryPool, index);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::ResolveQueries(const std::shared_ptr<QueryPool>& queryPool, uint32_t firstQuery, uint32_t count)
+        {
+            ASSERT(queryPool);
+            ASSERT(firstQuery + count <= queryPool->GetDescription().count);
+
+            if (count == 0)
+                return;
+
+            getImpl()->ResolveQueries(queryPool, firstQuery, count);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE void GraphicsCommandList::SetPredication(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+        {
+            ASSERT(!queryPool || queryPool->GetDescription().type != QueryType::PipelineStatistics);
+            ASSERT(!queryPool || index < queryPool->GetDescription().count);
+
+            getImpl()->SetPredication(queryPool, index);
+            CAPTURE_COMMAND(SkipCommand());
+        }
+
+        INLINE bool BundleCommandList::SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            ASSERT(pipelineState);
+            ASSERT(pipelineState->GetDescription().type == PipelineStateType::Graphics);
+
+            const auto resolved = pipelineState->Resolve();
+            if (!resolved)
+                return false;
+
+            getImpl()->SetGraphicsPipelineState(*resolved);
+            return true;
+        }
+
+        INLINE void BundleCommandList::SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+        {
+            getImpl()->SetGraphicsDescriptorTable(rootParameterIndex, bindlessIndex);
+        }
+
+        INLINE void BundleCommandList::SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format)
+        {
+            ASSERT(indexBuffer);
+            ASSERT(format == GpuResourceFormat::R16Uint || format == GpuResourceFormat::R32Uint);
+
+            getImpl()->SetIndexBuffer(indexBuffer, format);
+        }
+
+        INLINE void BundleCommandList::SetDrawConstants(const uint32_t* constants, uint32_t count)
+        {
+            ASSERT(constants);
+            ASSERT(count > 0 && count <= PipelineStateDescription::MaxDrawConstants);
+
+            getImpl()->SetDrawConstants(constants, count);
+        }
+
+        INLINE void BundleCommandList::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+        {
+            getImpl()->DrawIndexed(indexCount, instanceCount, startIndex, baseVertex, startInstance);
         }
     }
-}
\ No newline at end of file
+}
+
+#undef CAPTURE_COMMAND
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "gapi/Limits.hpp"
 #include "gapi/Resource.hpp"
 
+#include "common/threading/Mutex.hpp"
+
 namespace RR
 {
     namespace Render
@@ -12,6 +15,9 @@ namespace RR
     namespace GAPI
     {
         class CommandList;
+        class Fence;
+        struct GpuSyncPoint;
+        class Texture;
 
         enum class CommandQueueType : uint32_t
         {
@@ -21,12 +27,35 @@ namespace RR
             Count
         };
 
+        // GPU scheduling priority against other queues of the same type, of this and other processes.
+        // GlobalRealtime needs elevated process privileges, without them queue falls back to High.
+        enum class CommandQueuePriority : uint32_t
+        {
+            Normal,
+            High,
+            GlobalRealtime
+        };
+
+        // Residency change of a reserved texture mip. Packed tail mips share tiles, tail is mapped with any
+        // of its mips and unmapped only with the coarsest one.
+        struct TileMappingUpdate
+        {
+            std::shared_ptr<Texture> texture;
+            uint32_t mipLevel;
+            bool resident;
+        };
+
         class ICommandQueue
         {
         public:
             virtual ~ICommandQueue() = default;
 
             virtual void Submit(const std::shared_ptr<CommandList>& commandList) = 0;
+            virtual void Submit(const std::vector<std::shared_ptr<CommandList>>& commandLists) = 0;
+            // GPU side wait, following submissions won't start until sync point is reached.
+            virtual void Wait(const GpuSyncPoint& syncPoint) = 0;
+            // Ordered with submissions, following work sees new mappings.
+            virtual void UpdateTileMappings(const std::vector<TileMappingUpdate>& updates) = 0;
             virtual void WaitForGpu() = 0;
         };
 
@@ -39,18 +68,23 @@ namespace RR
             CommandQueue() = delete;
 
             inline void Submit(const std::shared_ptr<CommandList>& commandList) { return GetPrivateImpl()->Submit(commandList); }
+            inline void Submit(const std::vector<std::shared_ptr<CommandList>>& commandLists) { return GetPrivateImpl()->Submit(commandLists); }
+            inline void Wait(const GpuSyncPoint& syncPoint) { return GetPrivateImpl()->Wait(syncPoint); }
+            inline void UpdateTileMappings(const std::vector<TileMappingUpdate>& updates) { return GetPrivateImpl()->UpdateTileMappings(updates); }
 
             inline const CommandQueueType GetCommandQueueType() const { return type_; }
+            inline const CommandQueuePriority GetPriority() const { return priority_; }
 
         private:
-            static SharedPtr Create(CommandQueueType type, const U8String& name)
+            static SharedPtr Create(CommandQueueType type, CommandQueuePriority priority, const U8String& name)
             {
-                return SharedPtr(new CommandQueue(type, name));
+                return MakePooledShared<CommandQueue>(type, priority, name);
             }
 
-            CommandQueue(CommandQueueType type, const U8String& name)
+            CommandQueue(CommandQueueType type, CommandQueuePriority priority, const U8String& name)
                 : Resource(Object::Type::CommandQueue, name),
-                  type_(type)
+                  type_(type),
+                  priority_(priority)
             {
             }
 
@@ -58,8 +92,16 @@ namespace RR
 
         private:
             CommandQueueType type_;
+            CommandQueuePriority priority_;
+
+            // Submissions timeline, values assigned and signaled by DeviceContext.
+            std::shared_ptr<Fence> timelineFence_;
+            uint64_t timelineValue_ = 0;
+            Threading::Mutex timelineMutex_;
 
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,1058 @@
+#include "CommandStream.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/Texture.hpp"
+
+#include <cstring>
+#include <tuple>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace
+        {
+            // Optional object of packet, e.g. count buffer of indirect execution.
+            constexpr uint32_t InvalidReference = 0xFFFFFFFF;
+
+            struct MarkerPacket final
+            {
+                const char* name;
+                uint32_t length;
+            };
+
+            struct CopyGpuResourcePacket final
+            {
+                uint32_t source;
+                uint32_t dest;
+            };
+
+            struct CopyBufferRegionPacket final
+            {
+                uint32_t sourceBuffer;
+                uint32_t sourceOffset;
+                uint32_t destBuffer;
+                uint32_t destOffset;
+                uint32_t numBytes;
+            };
+
+            struct CopyTextureSubresourcePacket final
+            {
+                uint32_t sourceTexture;
+                uint32_t sourceSubresourceIdx;
+                uint32_t destTexture;
+                uint32_t destSubresourceIdx;
+            };
+
+            struct CopyTextureSubresourceRegionPacket final
+            {
+                uint32_t sourceTexture;
+                uint32_t sourceSubresourceIdx;
+                Box3u sourceBox;
+                uint32_t destTexture;
+                uint32_t destSubresourceIdx;
+                Vector3u destPoint;
+            };
+
+            struct ResourceDataPacket final
+            {
+                uint32_t resource;
+                uint32_t resourceData;
+            };
+
+            template <typename ValueType>
+            struct ClearViewPacket final
+            {
+                uint32_t view;
+                ValueType value;
+            };
+
+            struct GenerateMipsPacket final
+            {
+                uint32_t texture;
+            };
+
+            struct ConstantsPacket final
+            {
+                const void* data;
+                uint32_t size;
+            };
+
+            struct ConstantBufferPacket final
+            {
+                uint32_t rootParameterIndex;
+                // Index of AllocateConstants command in stream.
+                uint32_t constants;
+            };
+
+            // Pipeline state, transitioned view or resource.
+            struct ObjectPacket final
+            {
+                uint32_t object;
+            };
+
+            struct DescriptorTablePacket final
+            {
+                uint32_t rootParameterIndex;
+                uint32_t bindlessIndex;
+            };
+
+            struct DispatchPacket final
+            {
+                uint32_t threadGroupCountX;
+                uint32_t threadGroupCountY;
+                uint32_t threadGroupCountZ;
+            };
+
+            struct DispatchIndirectPacket final
+            {
+                uint32_t argumentBuffer;
+                uint32_t argumentOffset;
+            };
+
+            struct RenderTargetsPacket final
+            {
+                uint32_t renderTargetCount;
+                std::array<uint32_t, PipelineStateDescription::MaxRenderTargets> renderTargetViews;
+            };
+
+            struct IndexBufferPacket final
+            {
+                uint32_t indexBuffer;
+                GpuResourceFormat format;
+            };
+
+            struct ShadingRatePacket final
+            {
+                ShadingRate baseRate;
+                ShadingRateCombiner imageCombiner;
+            };
+
+            struct ExecuteIndirectPacket final
+            {
+                uint32_t argumentBuffer;
+                uint32_t argumentOffset;
+                uint32_t maxCommandCount;
+                uint32_t countBuffer;
+                uint32_t countOffset;
+            };
+
+            struct DrawConstantsPacket final
+            {
+                uint32_t count;
+                std::array<uint32_t, PipelineStateDescription::MaxDrawConstants> constants;
+            };
+
+            struct DrawIndexedPacket final
+            {
+                uint32_t indexCount;
+                uint32_t instanceCount;
+                uint32_t startIndex;
+                int32_t baseVertex;
+                uint32_t startInstance;
+            };
+
+            // Size of fixed size packets, packets with payload of variable size are handled separately.
+            template <typename Type>
+            constexpr size_t getPacketSize(Type type)
+            {
+                switch (type)
+                {
+                    case Type::EndMarker: return 0;
+                    case Type::CopyGpuResource: return sizeof(CopyGpuResourcePacket);
+                    case Type::CopyBufferRegion: return sizeof(CopyBufferRegionPacket);
+                    case Type::CopyTextureSubresource: return sizeof(CopyTextureSubresourcePacket);
+                    case Type::CopyTextureSubresourceRegion: return sizeof(CopyTextureSubresourceRegionPacket);
+                    case Type::UpdateGpuResource:
+                    case Type::ReadbackGpuResource: return sizeof(ResourceDataPacket);
+                    case Type::ClearUnorderedAccessViewUint: return sizeof(ClearViewPacket<Vector4u>);
+                    case Type::ClearUnorderedAccessViewFloat:
+                    case Type::ClearRenderTargetView: return sizeof(ClearViewPacket<Vector4>);
+                    case Type::GenerateMips: return sizeof(GenerateMipsPacket);
+                    case Type::SetComputeConstantBuffer:
+                    case Type::SetGraphicsConstantBuffer: return sizeof(ConstantBufferPacket);
+                    case Type::SetComputePipelineState:
+                    case Type::SetGraphicsPipelineState:
+                    case Type::TransitionToShaderResource:
+                    case Type::TransitionToUnorderedAccess:
+                    case Type::UnorderedAccessBarrier:
+                    case Type::SetShadingRateImage: return sizeof(ObjectPacket);
+                    case Type::SetComputeDescriptorTable:
+                    case Type::SetGraphicsDescriptorTable: return sizeof(DescriptorTablePacket);
+                    case Type::Dispatch: return sizeof(DispatchPacket);
+                    case Type::DispatchIndirect: return sizeof(DispatchIndirectPacket);
+                    case Type::SetRenderTargets: return sizeof(RenderTargetsPacket);
+                    case Type::SetIndexBuffer: return sizeof(IndexBufferPacket);
+                    case Type::SetShadingRate: return sizeof(ShadingRatePacket);
+                    case Type::ExecuteIndirect: return sizeof(ExecuteIndirectPacket);
+                    case Type::SetDrawConstants: return sizeof(DrawConstantsPacket);
+                    case Type::DrawIndexed: return sizeof(DrawIndexedPacket);
+                    default: return 0;
+                }
+            }
+
+            template <typename T>
+            void write(std::vector<uint8_t>& output, const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+                output.insert(output.end(), bytes, bytes + sizeof(T));
+            }
+
+            void write(std::vector<uint8_t>& output, const void* data, size_t size)
+            {
+                const auto bytes = static_cast<const uint8_t*>(data);
+                output.insert(output.end(), bytes, bytes + size);
+            }
+
+            // Bounds checked reading of serialized stream.
+            class Reader final
+            {
+            public:
+                Reader(const uint8_t* data, size_t size) : data_(data), remaining_(size) { }
+
+                template <typename T>
+                bool Read(T& value)
+                {
+                    static_assert(std::is_trivially_copyable_v<T>);
+                    return Read(&value, sizeof(T));
+                }
+
+                bool Read(void* data, size_t size)
+                {
+                    if (size > remaining_)
+                        return false;
+
+                    std::memcpy(data, data_, size);
+                    data_ += size;
+                    remaining_ -= size;
+                    return true;
+                }
+
+                bool IsEnd() const { return remaining_ == 0; }
+
+            private:
+                const uint8_t* data_;
+                size_t remaining_;
+            };
+        }
+
+        CommandStream::CommandStream(size_t baseSize)
+            : allocator_(baseSize)
+        {
+        }
+
+        template <typename T>
+        T& CommandStream::push(CommandType type, CommandListType commandListType)
+        {
+            auto packet = allocator_.Create<T>();
+            commands_.push_back({ type, packet });
+
+            ASSERT(commandListType != CommandListType::Bundle);
+
+            // Stream requires the most capable type among its commands.
+            if (SupportsCommands(commandListType, requiredType_))
+                requiredType_ = commandListType;
+
+            return *packet;
+        }
+
+        uint32_t CommandStream::reference(const std::shared_ptr<GpuResource>& resource)
+        {
+            return reference(ReferenceType::GpuResource, resource);
+        }
+
+        uint32_t CommandStream::reference(const std::shared_ptr<GpuResourceView>& view)
+        {
+            return reference(ReferenceType::GpuResourceView, view);
+        }
+
+        uint32_t CommandStream::reference(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            return reference(ReferenceType::PipelineState, pipelineState);
+        }
+
+        uint32_t CommandStream::reference(const std::shared_ptr<CpuResourceData>& resourceData)
+        {
+            return reference(ReferenceType::CpuResourceData, resourceData);
+        }
+
+        uint32_t CommandStream::reference(ReferenceType type, std::shared_ptr<void>&& object)
+        {
+            ASSERT(object);
+
+            // Consecutive commands mostly reference the same objects.
+            if (!references_.empty() && references_.back() == object)
+                return static_cast<uint32_t>(references_.size() - 1);
+
+            references_.push_back(std::move(object));
+            referenceTypes_.push_back(type);
+            return static_cast<uint32_t>(references_.size() - 1);
+        }
+
+        template <typename T>
+        std::shared_ptr<T> CommandStream::dereference(uint32_t index) const
+        {
+            ASSERT(index < references_.size());
+
+            if constexpr (std::is_base_of_v<GpuResource, T>)
+                return std::static_pointer_cast<T>(std::static_pointer_cast<GpuResource>(references_[index]));
+            else if constexpr (std::is_base_of_v<GpuResourceView, T>)
+                return std::static_pointer_cast<T>(std::static_pointer_cast<GpuResourceView>(references_[index]));
+            else
+                return std::static_pointer_cast<T>(references_[index]);
+        }
+
+        bool CommandStream::findConstants(uint64_t gpuVirtualAddress, uint32_t& constantsIndex)
+        {
+            // Constants are mostly bound right after allocation.
+            for (auto index = constantsAddresses_.size(); index > 0; index--)
+                if (constantsAddresses_[index - 1] == gpuVirtualAddress)
+                {
+                    constantsIndex = static_cast<uint32_t>(index - 1);
+                    return true;
+                }
+
+            // Allocated by other list, address can't be reproduced.
+            SkipCommand();
+            return false;
+        }
+
+        void CommandStream::BeginMarker(const U8String& name)
+        {
+            auto& packet = push<MarkerPacket>(CommandType::BeginMarker, CommandListType::Copy);
+            packet.length = static_cast<uint32_t>(name.size());
+            packet.name = nullptr;
+
+            if (packet.length > 0)
+            {
+                auto chars = static_cast<char*>(allocator_.Allocate(packet.length));
+                std::copy(name.begin(), name.end(), chars);
+                packet.name = chars;
+            }
+        }
+
+        void CommandStream::EndMarker()
+        {
+            commands_.push_back({ CommandType::EndMarker, nullptr });
+        }
+
+        void CommandStream::CopyGpuResource(const std::shared_ptr<GpuResource>& source, const std::shared_ptr<GpuResource>& dest)
+        {
+            auto& packet = push<CopyGpuResourcePacket>(CommandType::CopyGpuResource, CommandListType::Copy);
+            packet.source = reference(source);
+            packet.dest = reference(dest);
+        }
+
+        void CommandStream::CopyBufferRegion(const std::shared_ptr<Buffer>& sourceBuffer, uint32_t sourceOffset,
+                                             const std::shared_ptr<Buffer>& destBuffer, uint32_t destOffset, uint32_t numBytes)
+        {
+            auto& packet = push<CopyBufferRegionPacket>(CommandType::CopyBufferRegion, CommandListType::Copy);
+            packet.sourceBuffer = reference(sourceBuffer);
+            packet.sourceOffset = sourceOffset;
+            packet.destBuffer = reference(destBuffer);
+            packet.destOffset = destOffset;
+            packet.numBytes = numBytes;
+        }
+
+        void CommandStream::CopyTextureSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                                   const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx)
+        {
+            auto& packet = push<CopyTextureSubresourcePacket>(CommandType::CopyTextureSubresource, CommandListType::Copy);
+            packet.sourceTexture = reference(sourceTexture);
+            packet.sourceSubresourceIdx = sourceSubresourceIdx;
+            packet.destTexture = reference(destTexture);
+            packet.destSubresourceIdx = destSubresourceIdx;
+        }
+
+        void CommandStream::CopyTextureSubresourceRegion(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx, const Box3u& sourceBox,
+                                                         const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx, const Vector3u& destPoint)
+        {
+            auto& packet = push<CopyTextureSubresourceRegionPacket>(CommandType::CopyTextureSubresourceRegion, CommandListType::Copy);
+            packet.sourceTexture = reference(sourceTexture);
+            packet.sourceSubresourceIdx = sourceSubresourceIdx;
+            packet.sourceBox = sourceBox;
+            packet.destTexture = reference(destTexture);
+            packet.destSubresourceIdx = destSubresourceIdx;
+            packet.destPoint = destPoint;
+        }
+
+        void CommandStream::UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData)
+        {
+            auto& packet = push<ResourceDataPacket>(CommandType::UpdateGpuResource, CommandListType::Copy);
+            packet.resource = reference(resource);
+            packet.resourceData = reference(resourceData);
+        }
+
+        void CommandStream::ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData)
+        {
+            auto& packet = push<ResourceDataPacket>(CommandType::ReadbackGpuResource, CommandListType::Copy);
+            packet.resource = reference(resource);
+            packet.resourceData = reference(resourceData);
+        }
+
+        void CommandStream::ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue)
+        {
+            auto& packet = push<ClearViewPacket<Vector4u>>(CommandType::ClearUnorderedAccessViewUint, CommandListType::Compute);
+            packet.view = reference(unorderedAcessView);
+            packet.value = clearValue;
+        }
+
+        void CommandStream::ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue)
+        {
+            auto& packet = push<ClearViewPacket<Vector4>>(CommandType::ClearUnorderedAccessViewFloat, CommandListType::Compute);
+            packet.view = reference(unorderedAcessView);
+            packet.value = clearValue;
+        }
+
+        void CommandStream::GenerateMips(const std::shared_ptr<Texture>& texture)
+        {
+            auto& packet = push<GenerateMipsPacket>(CommandType::GenerateMips, CommandListType::Compute);
+            packet.texture = reference(texture);
+        }
+
+        void CommandStream::AllocateConstants(const void* data, size_t size, uint64_t gpuVirtualAddress)
+        {
+            ASSERT(data);
+            ASSERT(size > 0);
+
+            auto& packet = push<ConstantsPacket>(CommandType::AllocateConstants, CommandListType::Compute);
+            packet.size = static_cast<uint32_t>(size);
+
+            auto bytes = allocator_.Allocate(size);
+            std::memcpy(bytes, data, size);
+            packet.data = bytes;
+
+            constantsAddresses_.push_back(gpuVirtualAddress);
+        }
+
+        void CommandStream::SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+        {
+            uint32_t constantsIndex;
+            if (!findConstants(gpuVirtualAddress, constantsIndex))
+                return;
+
+            auto& packet = push<ConstantBufferPacket>(CommandType::SetComputeConstantBuffer, CommandListType::Compute);
+            packet.rootParameterIndex = rootParameterIndex;
+            packet.constants = constantsIndex;
+        }
+
+        void CommandStream::SetComputePipelineState(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::SetComputePipelineState, CommandListType::Compute);
+            packet.object = reference(pipelineState);
+        }
+
+        void CommandStream::SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+        {
+            auto& packet = push<DescriptorTablePacket>(CommandType::SetComputeDescriptorTable, CommandListType::Compute);
+            packet.rootParameterIndex = rootParameterIndex;
+            packet.bindlessIndex = bindlessIndex;
+        }
+
+        void CommandStream::TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::TransitionToShaderResource, CommandListType::Compute);
+            packet.object = reference(shaderResourceView);
+        }
+
+        void CommandStream::TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::TransitionToUnorderedAccess, CommandListType::Compute);
+            packet.object = reference(unorderedAcessView);
+        }
+
+        void CommandStream::UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::UnorderedAccessBarrier, CommandListType::Compute);
+            packet.object = reference(resource);
+        }
+
+        void CommandStream::Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ)
+        {
+            push<DispatchPacket>(CommandType::Dispatch, CommandListType::Compute) = { threadGroupCountX, threadGroupCountY, threadGroupCountZ };
+        }
+
+        void CommandStream::DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset)
+        {
+            auto& packet = push<DispatchIndirectPacket>(CommandType::DispatchIndirect, CommandListType::Compute);
+            packet.argumentBuffer = reference(argumentBuffer);
+            packet.argumentOffset = argumentOffset;
+        }
+
+        void CommandStream::ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color)
+        {
+            auto& packet = push<ClearViewPacket<Vector4>>(CommandType::ClearRenderTargetView, CommandListType::Graphics);
+            packet.view = reference(renderTargetView);
+            packet.value = color;
+        }
+
+        void CommandStream::SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+        {
+            uint32_t constantsIndex;
+            if (!findConstants(gpuVirtualAddress, constantsIndex))
+                return;
+
+            auto& packet = push<ConstantBufferPacket>(CommandType::SetGraphicsConstantBuffer, CommandListType::Graphics);
+            packet.rootParameterIndex = rootParameterIndex;
+            packet.constants = constantsIndex;
+        }
+
+        void CommandStream::SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::SetGraphicsPipelineState, CommandListType::Graphics);
+            packet.object = reference(pipelineState);
+        }
+
+        void CommandStream::SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+        {
+            auto& packet = push<DescriptorTablePacket>(CommandType::SetGraphicsDescriptorTable, CommandListType::Graphics);
+            packet.rootParameterIndex = rootParameterIndex;
+            packet.bindlessIndex = bindlessIndex;
+        }
+
+        void CommandStream::SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount)
+        {
+            ASSERT(renderTargetCount <= PipelineStateDescription::MaxRenderTargets);
+
+            auto& packet = push<RenderTargetsPacket>(CommandType::SetRenderTargets, CommandListType::Graphics);
+            packet.renderTargetCount = renderTargetCount;
+
+            for (uint32_t index = 0; index < renderTargetCount; index++)
+                packet.renderTargetViews[index] = reference(renderTargetViews[index]);
+        }
+
+        void CommandStream::SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format)
+        {
+            auto& packet = push<IndexBufferPacket>(CommandType::SetIndexBuffer, CommandListType::Graphics);
+            packet.indexBuffer = reference(indexBuffer);
+            packet.format = format;
+        }
+
+        void CommandStream::SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner)
+        {
+            push<ShadingRatePacket>(CommandType::SetShadingRate, CommandListType::Graphics) = { baseRate, imageCombiner };
+        }
+
+        void CommandStream::SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage)
+        {
+            auto& packet = push<ObjectPacket>(CommandType::SetShadingRateImage, CommandListType::Graphics);
+            packet.object = shadingRateImage ? reference(shadingRateImage) : InvalidReference;
+        }
+
+        void CommandStream::ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                            const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset)
+        {
+            auto& packet = push<ExecuteIndirectPacket>(CommandType::ExecuteIndirect, CommandListType::Graphics);
+            packet.argumentBuffer = reference(argumentBuffer);
+            packet.argumentOffset = argumentOffset;
+            packet.maxCommandCount = maxCommandCount;
+            packet.countBuffer = countBuffer ? reference(countBuffer) : InvalidReference;
+            packet.countOffset = countOffset;
+        }
+
+        void CommandStream::SetDrawConstants(const uint32_t* constants, uint32_t count)
+        {
+            ASSERT(count <= PipelineStateDescription::MaxDrawConstants);
+
+            auto& packet = push<DrawConstantsPacket>(CommandType::SetDrawConstants, CommandListType::Graphics);
+            packet.count = count;
+            std::copy(constants, constants + count, packet.constants.begin());
+        }
+
+        void CommandStream::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+        {
+            push<DrawIndexedPacket>(CommandType::DrawIndexed, CommandListType::Graphics) = { indexCount, instanceCount, startIndex, baseVertex, startInstance };
+        }
+
+        void CommandStream::Execute(CommandList& commandList) const
+        {
+            // Casts below are valid only for list types supporting the stream, bundles support none.
+            if (!SupportsCommands(commandList.GetCommandListType(), requiredType_))
+                LOG_FATAL("Command list type doesn't support commands of the stream");
+
+            // Every queue command list type supports copy commands, others are checked above.
+            auto& copyCommandList = static_cast<CopyCommandList&>(commandList);
+            auto& computeCommandList = static_cast<ComputeCommandList&>(commandList);
+            auto& graphicsCommandList = static_cast<GraphicsCommandList&>(commandList);
+
+            // Addresses of constants placed by this execution, indexed by AllocateConstants commands.
+            std::vector<uint64_t> constantsAddresses;
+
+            for (size_t index = 0; index < commands_.size(); index++)
+            {
+                const auto& command = commands_[index];
+
+                switch (command.type)
+                {
+                    case CommandType::BeginMarker:
+                    {
+                        const auto& packet = *static_cast<const MarkerPacket*>(command.packet);
+                        commandList.BeginMarker(packet.length > 0 ? U8String(packet.name, packet.length) : U8String());
+                        break;
+                    }
+                    case CommandType::EndMarker:
+                        commandList.EndMarker();
+                        break;
+                    case CommandType::CopyGpuResource:
+                    {
+                        const auto& packet = *static_cast<const CopyGpuResourcePacket*>(command.packet);
+                        copyCommandList.CopyGpuResource(dereference<GpuResource>(packet.source), dereference<GpuResource>(packet.dest));
+                        break;
+                    }
+                    case CommandType::CopyBufferRegion:
+                    {
+                        auto merged = *static_cast<const CopyBufferRegionPacket*>(command.packet);
+
+                        while (index + 1 < commands_.size() && commands_[index + 1].type == CommandType::CopyBufferRegion)
+                        {
+                            const auto& next = *static_cast<const CopyBufferRegionPacket*>(commands_[index + 1].packet);
+                            const auto contiguous = next.sourceOffset == merged.sourceOffset + merged.numBytes &&
+                                                    next.destOffset == merged.destOffset + merged.numBytes;
+
+                            if (!contiguous ||
+                                references_[next.sourceBuffer] != references_[merged.sourceBuffer] ||
+                                references_[next.destBuffer] != references_[merged.destBuffer])
+                                break;
+
+                            merged.numBytes += next.numBytes;
+                            index++;
+                        }
+
+                        copyCommandList.CopyBufferRegion(dereference<Buffer>(merged.sourceBuffer), merged.sourceOffset,
+                                                         dereference<Buffer>(merged.destBuffer), merged.destOffset, merged.numBytes);
+                        break;
+                    }
+                    case CommandType::CopyTextureSubresource:
+                    {
+                        const auto& packet = *static_cast<const CopyTextureSubresourcePacket*>(command.packet);
+                        copyCommandList.CopyTextureSubresource(dereference<Texture>(packet.sourceTexture), packet.sourceSubresourceIdx,
+                                                               dereference<Texture>(packet.destTexture), packet.destSubresourceIdx);
+                        break;
+                    }
+                    case CommandType::CopyTextureSubresourceRegion:
+                    {
+                        const auto& packet = *static_cast<const CopyTextureSubresourceRegionPacket*>(command.packet);
+                        copyCommandList.CopyTextureSubresourceRegion(dereference<Texture>(packet.sourceTexture), packet.sourceSubresourceIdx, packet.sourceBox,
+                                                                     dereference<Texture>(packet.destTexture), packet.destSubresourceIdx, packet.destPoint);
+                        break;
+                    }
+                    case CommandType::UpdateGpuResource:
+                    {
+                        const auto& packet = *static_cast<const ResourceDataPacket*>(command.packet);
+                        copyCommandList.UpdateGpuResource(dereference<GpuResource>(packet.resource), dereference<CpuResourceData>(packet.resourceData));
+                        break;
+                    }
+                    case CommandType::ReadbackGpuResource:
+                    {
+                        const auto& packet = *static_cast<const ResourceDataPacket*>(command.packet);
+                        copyCommandList.ReadbackGpuResource(dereference<GpuResource>(packet.resource), dereference<CpuResourceData>(packet.resourceData));
+                        break;
+                    }
+                    case CommandType::ClearUnorderedAccessViewUint:
+                    {
+                        const auto& packet = *static_cast<const ClearViewPacket<Vector4u>*>(command.packet);
+                        computeCommandList.ClearUnorderedAccessViewUint(dereference<UnorderedAccessView>(packet.view), packet.value);
+                        break;
+                    }
+                    case CommandType::ClearUnorderedAccessViewFloat:
+                    {
+                        const auto& packet = *static_cast<const ClearViewPacket<Vector4>*>(command.packet);
+                        computeCommandList.ClearUnorderedAccessViewFloat(dereference<UnorderedAccessView>(packet.view), packet.value);
+                        break;
+                    }
+                    case CommandType::GenerateMips:
+                    {
+                        const auto& packet = *static_cast<const GenerateMipsPacket*>(command.packet);
+                        computeCommandList.GenerateMips(dereference<Texture>(packet.texture));
+                        break;
+                    }
+                    case CommandType::AllocateConstants:
+                    {
+                        const auto& packet = *static_cast<const ConstantsPacket*>(command.packet);
+                        constantsAddresses.push_back(computeCommandList.AllocateConstants(packet.data, packet.size));
+                        break;
+                    }
+                    case CommandType::SetComputeConstantBuffer:
+                    {
+                        const auto& packet = *static_cast<const ConstantBufferPacket*>(command.packet);
+                        computeCommandList.SetComputeConstantBuffer(packet.rootParameterIndex, constantsAddresses[packet.constants]);
+                        break;
+                    }
+                    case CommandType::SetComputePipelineState:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        std::ignore = computeCommandList.SetComputePipelineState(dereference<PipelineState>(packet.object));
+                        break;
+                    }
+                    case CommandType::SetComputeDescriptorTable:
+                    {
+                        const auto& packet = *static_cast<const DescriptorTablePacket*>(command.packet);
+                        computeCommandList.SetComputeDescriptorTable(packet.rootParameterIndex, packet.bindlessIndex);
+                        break;
+                    }
+                    case CommandType::TransitionToShaderResource:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        computeCommandList.TransitionToShaderResource(dereference<ShaderResourceView>(packet.object));
+                        break;
+                    }
+                    case CommandType::TransitionToUnorderedAccess:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        computeCommandList.TransitionToUnorderedAccess(dereference<UnorderedAccessView>(packet.object));
+                        break;
+                    }
+                    case CommandType::UnorderedAccessBarrier:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        computeCommandList.UnorderedAccessBarrier(dereference<GpuResource>(packet.object));
+                        break;
+                    }
+                    case CommandType::Dispatch:
+                    {
+                        const auto& packet = *static_cast<const DispatchPacket*>(command.packet);
+                        computeCommandList.Dispatch(packet.threadGroupCountX, packet.threadGroupCountY, packet.threadGroupCountZ);
+                        break;
+                    }
+                    case CommandType::DispatchIndirect:
+                    {
+                        const auto& packet = *static_cast<const DispatchIndirectPacket*>(command.packet);
+                        computeCommandList.DispatchIndirect(dereference<Buffer>(packet.argumentBuffer), packet.argumentOffset);
+                        break;
+                    }
+                    case CommandType::ClearRenderTargetView:
+                    {
+                        const auto& packet = *static_cast<const ClearViewPacket<Vector4>*>(command.packet);
+                        graphicsCommandList.ClearRenderTargetView(dereference<RenderTargetView>(packet.view), packet.value);
+                        break;
+                    }
+                    case CommandType::SetGraphicsConstantBuffer:
+                    {
+                        const auto& packet = *static_cast<const ConstantBufferPacket*>(command.packet);
+                        graphicsCommandList.SetGraphicsConstantBuffer(packet.rootParameterIndex, constantsAddresses[packet.constants]);
+                        break;
+                    }
+                    case CommandType::SetGraphicsPipelineState:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        std::ignore = graphicsCommandList.SetGraphicsPipelineState(dereference<PipelineState>(packet.object));
+                        break;
+                    }
+                    case CommandType::SetGraphicsDescriptorTable:
+                    {
+                        const auto& packet = *static_cast<const DescriptorTablePacket*>(command.packet);
+                        graphicsCommandList.SetGraphicsDescriptorTable(packet.rootParameterIndex, packet.bindlessIndex);
+                        break;
+                    }
+                    case CommandType::SetRenderTargets:
+                    {
+                        const auto& packet = *static_cast<const RenderTargetsPacket*>(command.packet);
+
+                        std::array<std::shared_ptr<RenderTargetView>, PipelineStateDescription::MaxRenderTargets> renderTargetViews;
+                        for (uint32_t target = 0; target < packet.renderTargetCount; target++)
+                            renderTargetViews[target] = dereference<RenderTargetView>(packet.renderTargetViews[target]);
+
+                        graphicsCommandList.SetRenderTargets(renderTargetViews.data(), packet.renderTargetCount);
+                        break;
+                    }
+                    case CommandType::SetIndexBuffer:
+                    {
+                        const auto& packet = *static_cast<const IndexBufferPacket*>(command.packet);
+                        graphicsCommandList.SetIndexBuffer(dereference<Buffer>(packet.indexBuffer), packet.format);
+                        break;
+                    }
+                    case CommandType::SetShadingRate:
+                    {
+                        const auto& packet = *static_cast<const ShadingRatePacket*>(command.packet);
+                        graphicsCommandList.SetShadingRate(packet.baseRate, packet.imageCombiner);
+                        break;
+                    }
+                    case CommandType::SetShadingRateImage:
+                    {
+                        const auto& packet = *static_cast<const ObjectPacket*>(command.packet);
+                        graphicsCommandList.SetShadingRateImage(packet.object != InvalidReference ? dereference<Texture>(packet.object) : nullptr);
+                        break;
+                    }
+                    case CommandType::ExecuteIndirect:
+                    {
+                        const auto& packet = *static_cast<const ExecuteIndirectPacket*>(command.packet);
+                        graphicsCommandList.ExecuteIndirect(dereference<Buffer>(packet.argumentBuffer), packet.argumentOffset, packet.maxCommandCount,
+                                                            packet.countBuffer != InvalidReference ? dereference<Buffer>(packet.countBuffer) : nullptr, packet.countOffset);
+                        break;
+                    }
+                    case CommandType::SetDrawConstants:
+                    {
+                        const auto& packet = *static_cast<const DrawConstantsPacket*>(command.packet);
+                        graphicsCommandList.SetDrawConstants(packet.constants.data(), packet.count);
+                        break;
+                    }
+                    case CommandType::DrawIndexed:
+                    {
+                        const auto& packet = *static_cast<const DrawIndexedPacket*>(command.packet);
+                        graphicsCommandList.DrawIndexed(packet.indexCount, packet.instanceCount, packet.startIndex, packet.baseVertex, packet.startInstance);
+                        break;
+                    }
+                    default:
+                        LOG_FATAL("Unsupported command type");
+                }
+            }
+        }
+
+        // Layout: required list type | references count | (type, id) per reference | commands count | (type, size, payload) per command.
+        // Packets refer to objects by index in references, so they are written as is, except variable size payloads.
+        void CommandStream::Serialize(std::vector<uint8_t>& output, const ReferenceWriter& writeReference) const
+        {
+            ASSERT(writeReference);
+
+            write(output, requiredType_);
+            write(output, static_cast<uint32_t>(references_.size()));
+
+            for (size_t index = 0; index < references_.size(); index++)
+            {
+                write(output, referenceTypes_[index]);
+                write(output, writeReference(referenceTypes_[index], references_[index]));
+            }
+
+            write(output, static_cast<uint32_t>(commands_.size()));
+
+            for (const auto& command : commands_)
+            {
+                write(output, command.type);
+
+                switch (command.type)
+                {
+                    case CommandType::BeginMarker:
+                    {
+                        const auto& packet = *static_cast<const MarkerPacket*>(command.packet);
+                        write(output, packet.length);
+                        write(output, packet.name, packet.length);
+                        break;
+                    }
+                    case CommandType::AllocateConstants:
+                    {
+                        const auto& packet = *static_cast<const ConstantsPacket*>(command.packet);
+                        write(output, packet.size);
+                        write(output, packet.data, packet.size);
+                        break;
+                    }
+                    default:
+                    {
+                        const auto size = static_cast<uint32_t>(getPacketSize(command.type));
+                        write(output, size);
+                        write(output, command.packet, size);
+                    }
+                }
+            }
+        }
+
+        bool CommandStream::Deserialize(const uint8_t* data, size_t size, const ReferenceReader& readReference, const BindlessIndexRemap& remapBindlessIndex)
+        {
+            ASSERT(data);
+            ASSERT(readReference);
+            ASSERT(remapBindlessIndex);
+
+            Reset();
+
+            Reader reader(data, size);
+
+            // Graphics lists support every type streams may require, bundle and invalid types are rejected.
+            uint32_t referencesCount;
+            if (!reader.Read(requiredType_) || !SupportsCommands(CommandListType::Graphics, requiredType_) || !reader.Read(referencesCount))
+                return false;
+
+            references_.reserve(referencesCount);
+            referenceTypes_.reserve(referencesCount);
+
+            for (uint32_t index = 0; index < referencesCount; index++)
+            {
+                ReferenceType type;
+                uint32_t id;
+                if (!reader.Read(type) || !reader.Read(id))
+                    return false;
+
+                auto object = readReference(type, id);
+                if (!object)
+                    return false;
+
+                references_.push_back(std::move(object));
+                referenceTypes_.push_back(type);
+            }
+
+            uint32_t commandsCount;
+            if (!reader.Read(commandsCount))
+                return false;
+
+            commands_.reserve(commandsCount);
+
+            for (uint32_t index = 0; index < commandsCount; index++)
+            {
+                CommandType type;
+                uint32_t packetSize;
+                if (!reader.Read(type) || type >= CommandType::Count || !reader.Read(packetSize))
+                    return false;
+
+                switch (type)
+                {
+                    case CommandType::BeginMarker:
+                    {
+                        auto chars = packetSize > 0 ? static_cast<char*>(allocator_.Allocate(packetSize)) : nullptr;
+                        if (!reader.Read(chars, packetSize))
+                            return false;
+
+                        commands_.push_back({ type, allocator_.Create<MarkerPacket>(MarkerPacket { chars, packetSize }) });
+                        break;
+                    }
+                    case CommandType::AllocateConstants:
+                    {
+                        auto bytes = packetSize > 0 ? allocator_.Allocate(packetSize) : nullptr;
+                        if (!bytes || !reader.Read(bytes, packetSize))
+                            return false;
+
+                        commands_.push_back({ type, allocator_.Create<ConstantsPacket>(ConstantsPacket { bytes, packetSize }) });
+                        break;
+                    }
+                    case CommandType::EndMarker:
+                        if (packetSize != 0)
+                            return false;
+
+                        commands_.push_back({ type, nullptr });
+                        break;
+                    default:
+                    {
+                        if (packetSize != getPacketSize(type))
+                            return false;
+
+                        auto packet = allocator_.Allocate(packetSize);
+                        if (!reader.Read(packet, packetSize))
+                            return false;
+
+                        // Bindless heap slots are given in order of view creation, so they differ between devices.
+                        if (type == CommandType::SetComputeDescriptorTable || type == CommandType::SetGraphicsDescriptorTable)
+                        {
+                            auto& descriptorTable = *static_cast<DescriptorTablePacket*>(packet);
+                            descriptorTable.bindlessIndex = remapBindlessIndex(descriptorTable.bindlessIndex);
+                        }
+
+                        commands_.push_back({ type, packet });
+                    }
+                }
+            }
+
+            // Indices of packets are trusted by Execute.
+            uint32_t constantsCount = 0;
+            for (const auto& command : commands_)
+            {
+                const auto isValid = [this](uint32_t reference) { return reference < references_.size(); };
+                const auto isValidOptional = [this](uint32_t reference) { return reference == InvalidReference || reference < references_.size(); };
+
+                bool valid = true;
+                switch (command.type)
+                {
+                    case CommandType::CopyGpuResource:
+                    {
+                        const auto& packet = *static_cast<const CopyGpuResourcePacket*>(command.packet);
+                        valid = isValid(packet.source) && isValid(packet.dest);
+                        break;
+                    }
+                    case CommandType::CopyBufferRegion:
+                    {
+                        const auto& packet = *static_cast<const CopyBufferRegionPacket*>(command.packet);
+                        valid = isValid(packet.sourceBuffer) && isValid(packet.destBuffer);
+                        break;
+                    }
+                    case CommandType::CopyTextureSubresource:
+                    {
+                        const auto& packet = *static_cast<const CopyTextureSubresourcePacket*>(command.packet);
+                        valid = isValid(packet.sourceTexture) && isValid(packet.destTexture);
+                        break;
+                    }
+                    case CommandType::CopyTextureSubresourceRegion:
+                    {
+                        const auto& packet = *static_cast<const CopyTextureSubresourceRegionPacket*>(command.packet);
+                        valid = isValid(packet.sourceTexture) && isValid(packet.destTexture);
+                        break;
+                    }
+                    case CommandType::UpdateGpuResource:
+                    case CommandType::ReadbackGpuResource:
+                    {
+                        const auto& packet = *static_cast<const ResourceDataPacket*>(command.packet);
+                        valid = isValid(packet.resource) && isValid(packet.resourceData);
+                        break;
+                    }
+                    case CommandType::ClearUnorderedAccessViewUint:
+                        valid = isValid(static_cast<const ClearViewPacket<Vector4u>*>(command.packet)->view);
+                        break;
+                    case CommandType::ClearUnorderedAccessViewFloat:
+                    case CommandType::ClearRenderTargetView:
+                        valid = isValid(static_cast<const ClearViewPacket<Vector4>*>(command.packet)->view);
+                        break;
+                    case CommandType::GenerateMips:
+                        valid = isValid(static_cast<const GenerateMipsPacket*>(command.packet)->texture);
+                        break;
+                    case CommandType::AllocateConstants:
+                        constantsCount++;
+                        break;
+                    case CommandType::SetComputeConstantBuffer:
+                    case CommandType::SetGraphicsConstantBuffer:
+                        // Constants have to be allocated before they are bound.
+                        valid = static_cast<const ConstantBufferPacket*>(command.packet)->constants < constantsCount;
+                        break;
+                    case CommandType::SetComputePipelineState:
+                    case CommandType::SetGraphicsPipelineState:
+                    case CommandType::TransitionToShaderResource:
+                    case CommandType::TransitionToUnorderedAccess:
+                    case CommandType::UnorderedAccessBarrier:
+                        valid = isValid(static_cast<const ObjectPacket*>(command.packet)->object);
+                        break;
+                    case CommandType::SetShadingRateImage:
+                        valid = isValidOptional(static_cast<const ObjectPacket*>(command.packet)->object);
+                        break;
+                    case CommandType::DispatchIndirect:
+                        valid = isValid(static_cast<const DispatchIndirectPacket*>(command.packet)->argumentBuffer);
+                        break;
+                    case CommandType::SetRenderTargets:
+                    {
+                        const auto& packet = *static_cast<const RenderTargetsPacket*>(command.packet);
+                        valid = packet.renderTargetCount <= PipelineStateDescription::MaxRenderTargets &&
+                                std::all_of(packet.renderTargetViews.begin(), packet.renderTargetViews.begin() + packet.renderTargetCount, isValid);
+                        break;
+                    }
+                    case CommandType::SetIndexBuffer:
+                        valid = isValid(static_cast<const IndexBufferPacket*>(command.packet)->indexBuffer);
+                        break;
+                    case CommandType::ExecuteIndirect:
+                    {
+                        const auto& packet = *static_cast<const ExecuteIndirectPacket*>(command.packet);
+                        valid = isValid(packet.argumentBuffer) && isValidOptional(packet.countBuffer);
+                        break;
+                    }
+                    case CommandType::SetDrawConstants:
+                        valid = static_cast<const DrawConstantsPacket*>(command.packet)->count <= PipelineStateDescription::MaxDrawConstants;
+                        break;
+                    default:
+                        break;
+                }
+
+                if (!valid)
+                    return false;
+            }
+
+            return reader.IsEnd();
+        }
+
+        void CommandStream::Reset()
+        {
+            commands_.clear();
+            references_.clear();
+            referenceTypes_.clear();
+            constantsAddresses_.clear();
+            allocator_.Reset();
+            skippedCommandsCount_ = 0;
+            requiredType_ = CommandListType::Copy;
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "gapi/CommandList.hpp"
+#include "gapi/LinearAllocator.hpp"
+
+#include "common/Math.hpp"
+
+#include <functional>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // API agnostic recording of command list commands into POD packets.
+        // Recording doesn't touch native command lists, so streams are cheap to record from any thread
+        // and are translated to native commands later. Stream is kept until Reset and could be executed
+        // several times, e.g. identical streams across frames. Streams are serializable, which command capture relies on.
+        class CommandStream final : private NonCopyable
+        {
+        public:
+            static constexpr size_t DefaultBaseSize = 4096;
+
+            // Kinds of objects packets reference, serialized streams refer to them by ids given by the owner of serialized data.
+            enum class ReferenceType : uint32_t
+            {
+                GpuResource,
+                GpuResourceView,
+                PipelineState,
+                CpuResourceData
+            };
+
+            using ReferenceWriter = std::function<uint32_t(ReferenceType type, const std::shared_ptr<void>& object)>;
+            // Returns nullptr for unknown id.
+            using ReferenceReader = std::function<std::shared_ptr<void>(ReferenceType type, uint32_t id)>;
+            // Maps bindless index of recording device to the one of executing device.
+            using BindlessIndexRemap = std::function<uint32_t(uint32_t bindlessIndex)>;
+
+            CommandStream(size_t baseSize = DefaultBaseSize);
+            ~CommandStream() = default;
+
+            void BeginMarker(const U8String& name);
+            void EndMarker();
+
+            void CopyGpuResource(const std::shared_ptr<GpuResource>& source, const std::shared_ptr<GpuResource>& dest);
+            void CopyBufferRegion(const std::shared_ptr<Buffer>& sourceBuffer, uint32_t sourceOffset,
+                                  const std::shared_ptr<Buffer>& destBuffer, uint32_t destOffset, uint32_t numBytes);
+            void CopyTextureSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                        const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx);
+            void CopyTextureSubresourceRegion(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx, const Box3u& sourceBox,
+                                              const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx, const Vector3u& destPoint);
+
+            void UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData);
+            void ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData);
+
+            void ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue);
+            void ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue);
+            void GenerateMips(const std::shared_ptr<Texture>& texture);
+
+            // Constants are copied into stream and placed to upload ring on execution. Address is the one returned
+            // by recording command list, constant buffer commands refer to constants by it.
+            void AllocateConstants(const void* data, size_t size, uint64_t gpuVirtualAddress);
+            void SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress);
+            void SetComputePipelineState(const std::shared_ptr<PipelineState>& pipelineState);
+            void SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex);
+            void TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView);
+            void TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView);
+            void UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource);
+            void Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ);
+            void DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset);
+
+            void ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color);
+            void SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress);
+            void SetGraphicsPipelineState(const std::shared_ptr<PipelineState>& pipelineState);
+            void SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex);
+            void SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount);
+            void SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format);
+            void SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner);
+            void SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage);
+            void ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                 const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset);
+            void SetDrawConstants(const uint32_t* constants, uint32_t count);
+            void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance);
+
+            // Command which has no stream representation, e.g. bundle execution. Stream stays executable, but isn't complete.
+            inline void SkipCommand() { skippedCommandsCount_++; }
+
+            // Translates stream into native commands. Successive copies of contiguous buffer regions are merged into one.
+            void Execute(CommandList& commandList) const;
+
+            // Appends commands and referenced objects, object pointers are replaced by ids returned by writer.
+            void Serialize(std::vector<uint8_t>& output, const ReferenceWriter& writeReference) const;
+            // Replaces stream with serialized one. Returns false on malformed data or unknown references.
+            bool Deserialize(const uint8_t* data, size_t size, const ReferenceReader& readReference, const BindlessIndexRemap& remapBindlessIndex);
+
+            // Releases referenced objects, memory of packets is kept for next recording.
+            void Reset();
+
+            inline bool IsEmpty() const { return commands_.empty(); }
+            inline size_t GetCommandsCount() const { return commands_.size(); }
+            inline uint32_t GetSkippedCommandsCount() const { return skippedCommandsCount_; }
+            // The least capable command list type the stream could be executed on.
+            inline CommandListType GetRequiredCommandListType() const { return requiredType_; }
+
+        private:
+            enum class CommandType : uint32_t
+            {
+                BeginMarker,
+                EndMarker,
+                CopyGpuResource,
+                CopyBufferRegion,
+                CopyTextureSubresource,
+                CopyTextureSubresourceRegion,
+                UpdateGpuResource,
+                ReadbackGpuResource,
+                ClearUnorderedAccessViewUint,
+                ClearUnorderedAccessViewFloat,
+                GenerateMips,
+                AllocateConstants,
+                SetComputeConstantBuffer,
+                SetComputePipelineState,
+                SetComputeDescriptorTable,
+                TransitionToShaderResource,
+                TransitionToUnorderedAccess,
+                UnorderedAccessBarrier,
+                Dispatch,
+                DispatchIndirect,
+                ClearRenderTargetView,
+                SetGraphicsConstantBuffer,
+                SetGraphicsPipelineState,
+                SetGraphicsDescriptorTable,
+                SetRenderTargets,
+                SetIndexBuffer,
+                SetShadingRate,
+                SetShadingRateImage,
+                ExecuteIndirect,
+                SetDrawConstants,
+                DrawIndexed,
+                Count
+            };
+
+            // Objects used by packets are referenced by index, stream keeps them alive until reset.
+            struct Command final
+            {
+                CommandType type;
+                const void* packet;
+            };
+
+            template <typename T>
+            T& push(CommandType type, CommandListType commandListType);
+
+            // Resources are stored as GpuResource and views as GpuResourceView, so references of the object are equal whatever type it's passed as.
+            uint32_t reference(const std::shared_ptr<GpuResource>& resource);
+            uint32_t reference(const std::shared_ptr<GpuResourceView>& view);
+            uint32_t reference(const std::shared_ptr<PipelineState>& pipelineState);
+            uint32_t reference(const std::shared_ptr<CpuResourceData>& resourceData);
+            uint32_t reference(ReferenceType type, std::shared_ptr<void>&& object);
+
+            template <typename T>
+            std::shared_ptr<T> dereference(uint32_t index) const;
+
+            // Index of constants allocation recorded with the address, skips the command if there is none.
+            bool findConstants(uint64_t gpuVirtualAddress, uint32_t& constantsIndex);
+
+        private:
+            LinearAllocator allocator_;
+            std::vector<Command> commands_;
+            std::vector<std::shared_ptr<void>> references_;
+            std::vector<ReferenceType> referenceTypes_;
+            // Addresses given to recording command list, in order of AllocateConstants commands.
+            std::vector<uint64_t> constantsAddresses_;
+            uint32_t skippedCommandsCount_ = 0;
+            CommandListType requiredType_ = CommandListType::Copy;
+        };
+    }
+}
@@ -2,13 +2,28 @@
 
 #include "common/Math.hpp"
 
+#include "gapi/DeviceStatistics.hpp"
 #include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/GpuTimings.hpp"
+#include "gapi/Handles.hpp"
+#include "gapi/MemoryBudget.hpp"
 #include "gapi/Resource.hpp"
+#include "gapi/ShadingRate.hpp"
 
 namespace RR
 {
     namespace GAPI
     {
+        struct AdapterDescription final
+        {
+            uint32_t index;
+            U8String name;
+            uint32_t vendorId;
+            uint32_t deviceId;
+            uint64_t dedicatedVideoMemory;
+        };
+
         class ISingleThreadDevice
         {
         public:
@@ -22,23 +37,33 @@ namespace RR
             struct Description final
             {
             public:
+                static constexpr uint32_t AnyAdapter = 0xFFFFFFFF;
+
                 Description() = default;
 
-                Description(uint32_t gpuFramesBuffered, DebugMode debugMode)
+                Description(uint32_t gpuFramesBuffered, DebugMode debugMode, const U8String& pipelineCachePath = "")
                     : gpuFramesBuffered(gpuFramesBuffered),
-                      debugMode(debugMode)
+                      debugMode(debugMode),
+                      pipelineCachePath(pipelineCachePath)
                 {
                 }
 
             public:
                 uint32_t gpuFramesBuffered = 0;
                 DebugMode debugMode = DebugMode::Retail;
+                // Pipeline states are loaded from and stored to this file. Empty path disables persistence.
+                U8String pipelineCachePath;
+                // Bytes of pooled textures moved per frame to compact sparse heaps. Zero disables defragmentation.
+                uint64_t defragmentationFrameBudget = 32 * 1024 * 1024;
+                // Index of adapter enumeration. AnyAdapter picks the first hardware adapter supporting D3D12.
+                uint32_t adapterIndex = AnyAdapter;
             };
 
         public:
             //   virtual void Submit(const std::shared_ptr<CommandList>& CommandList) = 0;
             virtual void Present(const std::shared_ptr<SwapChain>& swapChain) = 0;
-            virtual void MoveToNextFrame(uint64_t frameIndex) = 0;
+            // Sync points mark end of the previous frame on every queue, memory released during it is reused only after all of them.
+            virtual void MoveToNextFrame(uint64_t frameIndex, const std::vector<GpuSyncPoint>& frameEndSyncPoints) = 0;
         };
 
         class IMultiThreadDevice
@@ -57,8 +82,51 @@ namespace RR
             virtual void InitCommandQueue(CommandQueue& resource) const = 0;
             virtual void InitCommandList(CommandList& resource) const = 0;
             virtual void InitTexture(Texture& resource) const = 0;
+            virtual void InitTransientTexture(Texture& resource, uint32_t firstUse, uint32_t lastUse) const = 0;
             virtual void InitBuffer(Buffer& resource) const = 0;
+            // Buffer memory is visible to all adapters of the node, so results are copied between devices through it.
+            virtual void InitSharedBuffer(Buffer& resource) const = 0;
+            virtual void InitSharedFence(Fence& resource) const = 0;
+            // Shared object created by another device of the process, opened on this one.
+            virtual void OpenSharedBuffer(Buffer& resource, const Buffer& source) const = 0;
+            virtual void OpenSharedFence(Fence& resource, const Fence& source) const = 0;
             virtual void InitGpuResourceView(GpuResourceView& view) const = 0;
+            virtual void InitPipelineState(PipelineState& pipelineState) const = 0;
+            virtual void InitQueryPool(QueryPool& queryPool) const = 0;
+            // State is compiled in memory or stored in pipeline cache by previous runs, so its creation is cheap.
+            virtual bool IsPipelineStateCached(const PipelineStateDescription& description) const = 0;
+
+            // Timings of the latest frame completed on GPU.
+            virtual GpuFrameTimings GetGpuFrameTimings() const = 0;
+            // Samples graphics queue clock, costs a kernel call.
+            virtual GpuClockCalibration GetGpuClockCalibration() const = 0;
+            // Variable rate shading capabilities, queried once on device creation.
+            virtual ShadingRateSupport GetShadingRateSupport() const = 0;
+
+            // Segment usage covers the whole process, heap statistics only memory allocator allocations.
+            virtual MemoryBudget GetMemoryBudget() const = 0;
+            virtual MemoryStatistics GetMemoryStatistics() const = 0;
+            // Descriptor heaps occupancy and deferred releases backlog.
+            virtual DeviceStatistics GetDeviceStatistics() const = 0;
+            virtual void SetResidencyPriority(const std::vector<std::shared_ptr<GpuResource>>& resources, ResidencyPriority priority) const = 0;
+            // Content of evicted resources is kept, they should be made resident before GPU uses them again.
+            virtual void Evict(const std::vector<std::shared_ptr<GpuResource>>& resources) const = 0;
+            // Blocks until resources are paged in.
+            virtual void MakeResident(const std::vector<std::shared_ptr<GpuResource>>& resources) const = 0;
+
+            // Pooled objects without per object allocations. Invalid handle is returned once pool is exhausted.
+            virtual BufferHandle CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const = 0;
+            virtual TextureHandle CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const = 0;
+            virtual ViewHandle CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const = 0;
+            virtual ViewHandle CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const = 0;
+            // Views should be released before their resource. Handles are reset, stale handles are ignored.
+            virtual void Release(BufferHandle& buffer) const = 0;
+            virtual void Release(TextureHandle& texture) const = 0;
+            virtual void Release(ViewHandle& view) const = 0;
+            virtual uint32_t GetBindlessIndex(ViewHandle view) const = 0;
+
+            // Index in shader visible sampler heap, equal descriptions share one descriptor.
+            virtual uint32_t GetSamplerIndex(const SamplerDescription& description) const = 0;
         };
 
         class IDevice : public ISingleThreadDevice, public IMultiThreadDevice
@@ -80,7 +148,7 @@ namespace RR
 
             //   virtual void Submit(const std::shared_ptr<CommandList>& CommandList) = 0;
             void Present(const std::shared_ptr<SwapChain>& swapChain) override { GetPrivateImpl()->Present(swapChain); }
-            void MoveToNextFrame(uint64_t frameIndex) override { GetPrivateImpl()->MoveToNextFrame(frameIndex); }
+            void MoveToNextFrame(uint64_t frameIndex, const std::vector<GpuSyncPoint>& frameEndSyncPoints) override { GetPrivateImpl()->MoveToNextFrame(frameIndex, frameEndSyncPoints); }
 
             std::shared_ptr<CpuResourceData> const AllocateIntermediateResourceData(
                 const GpuResourceDescription& desc,
@@ -96,8 +164,37 @@ namespace RR
             void InitCommandQueue(CommandQueue& resource) const override { GetPrivateImpl()->InitCommandQueue(resource); };
             void InitCommandList(CommandList& resource) const override { GetPrivateImpl()->InitCommandList(resource); };
             void InitTexture(Texture& resource) const override { GetPrivateImpl()->InitTexture(resource); };
+            void InitTransientTexture(Texture& resource, uint32_t firstUse, uint32_t lastUse) const override { GetPrivateImpl()->InitTransientTexture(resource, firstUse, lastUse); };
             void InitBuffer(Buffer& resource) const override { GetPrivateImpl()->InitBuffer(resource); };
+            void InitSharedBuffer(Buffer& resource) const override { GetPrivateImpl()->InitSharedBuffer(resource); };
+            void InitSharedFence(Fence& resource) const override { GetPrivateImpl()->InitSharedFence(resource); };
+            void OpenSharedBuffer(Buffer& resource, const Buffer& source) const override { GetPrivateImpl()->OpenSharedBuffer(resource, source); };
+            void OpenSharedFence(Fence& resource, const Fence& source) const override { GetPrivateImpl()->OpenSharedFence(resource, source); };
             void InitGpuResourceView(GpuResourceView& view) const override { GetPrivateImpl()->InitGpuResourceView(view); };
+            void InitPipelineState(PipelineState& pipelineState) const override { GetPrivateImpl()->InitPipelineState(pipelineState); };
+            void InitQueryPool(QueryPool& queryPool) const override { GetPrivateImpl()->InitQueryPool(queryPool); };
+            bool IsPipelineStateCached(const PipelineStateDescription& description) const override { return GetPrivateImpl()->IsPipelineStateCached(description); };
+
+            GpuFrameTimings GetGpuFrameTimings() const override { return GetPrivateImpl()->GetGpuFrameTimings(); };
+            GpuClockCalibration GetGpuClockCalibration() const override { return GetPrivateImpl()->GetGpuClockCalibration(); };
+            ShadingRateSupport GetShadingRateSupport() const override { return GetPrivateImpl()->GetShadingRateSupport(); };
+
+            MemoryBudget GetMemoryBudget() const override { return GetPrivateImpl()->GetMemoryBudget(); };
+            MemoryStatistics GetMemoryStatistics() const override { return GetPrivateImpl()->GetMemoryStatistics(); };
+            DeviceStatistics GetDeviceStatistics() const override { return GetPrivateImpl()->GetDeviceStatistics(); };
+            void SetResidencyPriority(const std::vector<std::shared_ptr<GpuResource>>& resources, ResidencyPriority priority) const override { GetPrivateImpl()->SetResidencyPriority(resources, priority); };
+            void Evict(const std::vector<std::shared_ptr<GpuResource>>& resources) const override { GetPrivateImpl()->Evict(resources); };
+            void MakeResident(const std::vector<std::shared_ptr<GpuResource>>& resources) const override { GetPrivateImpl()->MakeResident(resources); };
+
+            BufferHandle CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const override { return GetPrivateImpl()->CreateBuffer(desc, cpuAccess); };
+            TextureHandle CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const override { return GetPrivateImpl()->CreateTexture(desc, cpuAccess); };
+            ViewHandle CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const override { return GetPrivateImpl()->CreateView(buffer, viewType, desc); };
+            ViewHandle CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const override { return GetPrivateImpl()->CreateView(texture, viewType, desc); };
+            void Release(BufferHandle& buffer) const override { GetPrivateImpl()->Release(buffer); };
+            void Release(TextureHandle& texture) const override { GetPrivateImpl()->Release(texture); };
+            void Release(ViewHandle& view) const override { GetPrivateImpl()->Release(view); };
+            uint32_t GetBindlessIndex(ViewHandle view) const override { return GetPrivateImpl()->GetBindlessIndex(view); };
+            uint32_t GetSamplerIndex(const SamplerDescription& description) const override { return GetPrivateImpl()->GetSamplerIndex(description); };
 
         private:
             static SharedPtr Create(const Description& description, const U8String& name)
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class DescriptorHeapType : uint32_t
+        {
+            // CPU only views, copied to bindless heap. Grow by pages.
+            CbvSrvUav,
+            RenderTarget,
+            // Shader visible, fixed size.
+            Bindless,
+            Count
+        };
+
+        struct DescriptorHeapOccupancy final
+        {
+            uint32_t allocatedCount = 0;
+            uint32_t capacity = 0;
+        };
+
+        // Cheap to query, suitable for every frame.
+        struct DeviceStatistics final
+        {
+            std::array<DescriptorHeapOccupancy, static_cast<size_t>(DescriptorHeapType::Count)> descriptorHeaps;
+            // Objects and bindless slots waiting for GPU to finish frames which could still reference them.
+            uint32_t pendingReleasesCount = 0;
+        };
+    }
+}
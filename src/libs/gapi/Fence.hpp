@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gapi/Resource.hpp"
+
+#include "common/threading/Mutex.hpp"
+
 #include <optional>
 
 namespace RR
@@ -13,9 +16,11 @@ namespace RR
             virtual ~IFence() {};
 
             virtual void Signal(const std::shared_ptr<CommandQueue>& queue) = 0;
+            // Signal explicit timeline value, should be greater than any value signaled before.
+            virtual void Signal(CommandQueue& queue, uint64_t value) = 0;
 
             virtual void SyncCPU(std::optional<uint64_t> value, uint32_t timeout) const = 0;
-            virtual void SyncGPU(const std::shared_ptr<CommandQueue>& queue) const = 0;
+            virtual void SyncGPU(const std::shared_ptr<CommandQueue>& queue, std::optional<uint64_t> value) const = 0;
 
             virtual uint64_t GetGpuValue() const = 0;
             virtual uint64_t GetCpuValue() const = 0;
@@ -28,8 +33,9 @@ namespace RR
             using SharedConstPtr = std::shared_ptr<const Fence>;
 
             inline void Signal(const std::shared_ptr<CommandQueue>& queue) { return GetPrivateImpl()->Signal(queue); }
+            inline void Signal(CommandQueue& queue, uint64_t value) { return GetPrivateImpl()->Signal(queue, value); }
             inline void SyncCPU(std::optional<uint64_t> value, uint32_t timeout) const { return GetPrivateImpl()->SyncCPU(value, timeout); }
-            inline void SyncGPU(const std::shared_ptr<CommandQueue>& queue) const { return GetPrivateImpl()->SyncGPU(queue); }
+            inline void SyncGPU(const std::shared_ptr<CommandQueue>& queue, std::optional<uint64_t> value = std::nullopt) const { return GetPrivateImpl()->SyncGPU(queue, value); }
 
             inline uint64_t GetGpuValue() const { return GetPrivateImpl()->GetGpuValue(); }
             inline uint64_t GetCpuValue() const { return GetPrivateImpl()->GetCpuValue(); }
@@ -37,7 +43,7 @@ namespace RR
         private:
             static SharedPtr Create(const U8String& name)
             {
-                return SharedPtr(new Fence(name));
+                return MakePooledShared<Fence>(name);
             }
 
             Fence(const U8String& name)
@@ -46,7 +52,34 @@ namespace RR
             }
 
         private:
+            // Shared fences only, values assigned and signaled by DeviceContext of the creating device.
+            uint64_t timelineValue_ = 0;
+            Threading::Mutex timelineMutex_;
+
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
+        };
+
+        // Point on queue timeline. Completed once GPU executed all work submitted before it.
+        struct GpuSyncPoint final
+        {
+            std::shared_ptr<Fence> fence;
+            uint64_t value = 0;
+
+            inline bool IsValid() const { return fence != nullptr; }
+
+            inline bool IsComplete() const
+            {
+                ASSERT(fence);
+                return fence->GetGpuValue() >= value;
+            }
+
+            inline void Wait(uint32_t timeout = 0xFFFFFF) const
+            {
+                ASSERT(fence);
+                fence->SyncCPU(value, timeout);
+            }
         };
     }
 }
\ No newline at end of file
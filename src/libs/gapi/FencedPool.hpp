@@ -1 +1,151 @@
-#pragma once
\ No newline at end of file
+#pragma once
+
+#include "gapi/Fence.hpp"
+
+#include "common/NonCopyableMovable.hpp"
+
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Recycles objects GPU could still use. Released object is handed out again once the fence of the queue
+        // it was used on reached release value. Release is lock-free and could be called from any thread,
+        // Acquire is owner thread only: it takes the whole pending list at once, so there is no ABA.
+        template <typename T>
+        class FencedPool final : private Common::NonCopyable
+        {
+        public:
+            FencedPool() = default;
+            ~FencedPool()
+            {
+                collectPending();
+            }
+
+            // Returns completed object, or std::nullopt when every released one is still in flight.
+            std::optional<T> TryAcquire()
+            {
+                collectPending();
+
+                for (auto& timeline : timelines_)
+                {
+                    if (timeline.entries.empty())
+                        continue;
+
+                    // Values of one fence complete in order, so only the oldest entry has to be checked.
+                    auto& entry = timeline.entries.front();
+                    if (timeline.fence->GetGpuValue() < entry.fenceValue)
+                        continue;
+
+                    auto object = std::move(entry.object);
+                    timeline.entries.pop_front();
+
+                    return object;
+                }
+
+                return std::nullopt;
+            }
+
+            template <typename CreateCallback>
+            T Acquire(CreateCallback&& create)
+            {
+                auto object = TryAcquire();
+                if (object)
+                    return std::move(*object);
+
+                return create();
+            }
+
+            // Object is free once fence GPU value is at least fenceValue.
+            void Release(T&& object, const IFence& fence, uint64_t fenceValue)
+            {
+                auto node = new Node { { std::move(object), fenceValue }, &fence, pendingHead_.load(std::memory_order_relaxed) };
+
+                while (!pendingHead_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+            }
+
+            // Hands out every object regardless of fence, e.g. to deferred release on shutdown.
+            template <typename Callback>
+            void Drain(Callback&& callback)
+            {
+                collectPending();
+
+                for (auto& timeline : timelines_)
+                    for (auto& entry : timeline.entries)
+                        callback(std::move(entry.object));
+
+                timelines_.clear();
+            }
+
+        private:
+            struct Entry
+            {
+                T object;
+                uint64_t fenceValue;
+            };
+
+            struct Node
+            {
+                Entry entry;
+                const IFence* fence;
+                Node* next;
+            };
+
+            // Entries released against the same fence, only touched by owner.
+            struct Timeline
+            {
+                const IFence* fence;
+                std::deque<Entry> entries;
+            };
+
+            void collectPending()
+            {
+                Node* head = pendingHead_.exchange(nullptr, std::memory_order_acquire);
+
+                // Restore release order.
+                Node* reversed = nullptr;
+                while (head)
+                {
+                    const auto next = head->next;
+                    head->next = reversed;
+                    reversed = head;
+                    head = next;
+                }
+
+                while (reversed)
+                {
+                    const auto node = reversed;
+                    reversed = node->next;
+
+                    auto& entries = getTimeline(node->fence).entries;
+
+                    // Releasing threads could race on the same fence, keeping entries sorted preserves in order completion.
+                    auto it = entries.end();
+                    while (it != entries.begin() && std::prev(it)->fenceValue > node->entry.fenceValue)
+                        --it;
+
+                    entries.insert(it, std::move(node->entry));
+                    delete node;
+                }
+            }
+
+            Timeline& getTimeline(const IFence* fence)
+            {
+                for (auto& timeline : timelines_)
+                    if (timeline.fence == fence)
+                        return timeline;
+
+                return timelines_.emplace_back(Timeline { fence, {} });
+            }
+
+        private:
+            std::atomic<Node*> pendingHead_ = nullptr;
+            std::vector<Timeline> timelines_;
+        };
+    }
+}
@@ -9,14 +9,27 @@ namespace RR
         class CopyCommandList;
         class ComputeCommandList;
         class GraphicsCommandList;
+        class BundleCommandList;
+        class CommandStream;
 
         struct PresentOptions;
 
         class CommandQueue;
         enum class CommandQueueType : uint32_t;
+        struct TileMappingUpdate;
         class Fence;
+        struct GpuSyncPoint;
+        class LinearAllocator;
         class Object;
 
+        class PipelineState;
+        struct PipelineStateDescription;
+
+        class QueryPool;
+        struct QueryPoolDescription;
+
+        struct SamplerDescription;
+
         template <typename T, bool IsNamed>
         class Resource;
 
@@ -27,6 +40,8 @@ namespace RR
         enum class GpuResourceFormat : uint32_t;
         enum class GpuResourceCpuAccess : uint32_t;
 
+        struct GpuFrameTimings;
+
         class GpuResourceView;
         struct GpuResourceViewDescription;
 
@@ -1,11 +1,18 @@
 #pragma once
 
 #include "common/EnumClassOperators.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/SpinLock.hpp"
 
+#include "gapi/Fence.hpp"
 #include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceFootprint.hpp"
+#include "gapi/GpuResourceFormat.hpp"
 #include "gapi/GpuResourceViews.hpp"
 #include "gapi/Resource.hpp"
 
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 
 namespace RR
@@ -19,127 +26,31 @@ namespace RR
             UnorderedAccess = 0x02,
             RenderTarget = 0x04,
             DepthStencil = 0x08,
+            // Not a binding. Texture gets no memory on creation, mips are made resident with tile mappings.
+            Reserved = 0x10,
         };
         ENUM_CLASS_OPERATORS(GpuResourceBindFlags)
 
-        enum class GpuResourceFormat : uint32_t
-        {
-            Unknown,
-
-            RGBA32Float,
-            RGBA32Uint,
-            RGBA32Sint,
-            RGB32Float,
-            RGB32Uint,
-            RGB32Sint,
-            RGBA16Float,
-            RGBA16Unorm,
-            RGBA16Uint,
-            RGBA16Snorm,
-            RGBA16Sint,
-            RG32Float,
-            RG32Uint,
-            RG32Sint,
-
-            RGB10A2Unorm,
-            RGB10A2Uint,
-            R11G11B10Float,
-            RGBA8Unorm,
-            RGBA8UnormSrgb,
-            RGBA8Uint,
-            RGBA8Snorm,
-            RGBA8Sint,
-            RG16Float,
-            RG16Unorm,
-            RG16Uint,
-            RG16Snorm,
-            RG16Sint,
-
-            R32Float,
-            R32Uint,
-            R32Sint,
-
-            RG8Unorm,
-            RG8Uint,
-            RG8Snorm,
-            RG8Sint,
-
-            R16Float,
-            R16Unorm,
-            R16Uint,
-            R16Snorm,
-            R16Sint,
-            R8Unorm,
-            R8Uint,
-            R8Snorm,
-            R8Sint,
-            A8Unorm,
-
-            // Depth-stencil
-            D32FloatS8X24Uint,
-            D32Float,
-            D24UnormS8Uint,
-            D16Unorm,
-
-            // SRV formats for depth/stencil binding
-            R32FloatX8X24,
-            X32G8Uint,
-            R24UnormX8,
-            X24G8Uint,
-
-            // Compressed
-            BC1Unorm,
-            BC1UnormSrgb,
-            BC2Unorm,
-            BC2UnormSrgb,
-            BC3Unorm,
-            BC3UnormSrgb,
-            BC4Unorm,
-            BC4Snorm,
-            BC5Unorm,
-            BC5Snorm,
-            BC6HU16,
-            BC6HS16,
-            BC7Unorm,
-            BC7UnormSrgb,
-
-            RGB16Float,
-            RGB16Unorm,
-            RGB16Uint,
-            RGB16Snorm,
-            RGB16Sint,
-
-            RGB5A1Unorm,
-            RGB9E5Float,
-
-            BGRA8Unorm,
-            BGRA8UnormSrgb,
-            BGRX8Unorm,
-            BGRX8UnormSrgb,
-
-            R5G6B5Unorm,
-
-            Count
-        };
-
-        namespace GpuResourceFormatInfo
-        {
-            bool IsDepth(GpuResourceFormat format);
-            bool IsStencil(GpuResourceFormat format);
-            bool IsCompressed(GpuResourceFormat format);
-
-            uint32_t GetBlockSize(GpuResourceFormat format);
-            uint32_t GetCompressionBlockWidth(GpuResourceFormat format);
-            uint32_t GetCompressionBlockHeight(GpuResourceFormat format);
-
-            U8String ToString(GpuResourceFormat format);
-        };
-
         enum class GpuResourceCpuAccess : uint32_t
         {
             None,
             Read,
-            Write
+            Write,
+            // Buffers only. CPU writes persistently mapped memory which GPU reads in place, e.g. per frame constants and
+            // instance data skip copy commands. Video memory when device supports GPU upload heaps (resizable BAR),
+            // upload heap otherwise. Memory is write-combined, so it should be written sequentially and never read.
+            GpuUpload
+        };
+
+        // Memory pool texture is placed into, so resource classes don't fragment heaps of each other.
+        enum class GpuResourceAllocationHint : uint32_t
+        {
+            // Dedicated allocation.
+            Default,
+            RenderTarget,
+            Streamed,
+            // Icons, LUTs and the like. Placed with 4KB alignment where format and size allow it.
+            Small
         };
 
         enum class GpuResourceDimension : uint32_t
@@ -152,6 +63,20 @@ namespace RR
             TextureCube
         };
 
+        // Clears with the value resource was created with take fast path, other values fall back to full clear.
+        struct GpuResourceClearValue final
+        {
+            std::array<float, 4> color = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float depth = 1.0f;
+            uint8_t stencil = 0;
+
+            inline friend bool operator==(const GpuResourceClearValue& lhs, const GpuResourceClearValue& rhs)
+            {
+                return lhs.color == rhs.color && lhs.depth == rhs.depth && lhs.stencil == rhs.stencil;
+            }
+            inline friend bool operator!=(const GpuResourceClearValue& lhs, const GpuResourceClearValue& rhs) { return !(lhs == rhs); }
+        };
+
         struct GpuResourceDescription
         {
             static constexpr uint32_t MaxPossible = 0xFFFFFF;
@@ -303,6 +228,15 @@ namespace RR
                 return dimension_ == GpuResourceDimension::Buffer ? 1 : 1 + static_cast<uint32_t>(log2(static_cast<float>(maxDimension)));
             }
 
+            // Render targets and depth stencils only.
+            GpuResourceDescription& SetOptimizedClearValue(const GpuResourceClearValue& clearValue)
+            {
+                ASSERT(IsAny(bindflags_, GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil));
+                clearValue_ = clearValue;
+                return *this;
+            }
+            const GpuResourceClearValue& GetOptimizedClearValue() const { return clearValue_; }
+
             bool IsValid() const;
 
             inline friend bool operator==(const GpuResourceDescription& lhs, const GpuResourceDescription& rhs)
@@ -316,10 +250,27 @@ namespace RR
                        lhs.sampleCount_ == rhs.sampleCount_ &&
                        lhs.arraySize_ == rhs.arraySize_ &&
                        lhs.structSize_ == rhs.structSize_ &&
-                       lhs.mipLevels_ == rhs.mipLevels_;
+                       lhs.mipLevels_ == rhs.mipLevels_ &&
+                       lhs.clearValue_ == rhs.clearValue_;
             }
             inline friend bool operator!=(const GpuResourceDescription& lhs, const GpuResourceDescription& rhs) { return !(lhs == rhs); }
 
+            struct HashFunc
+            {
+                std::size_t operator()(const GpuResourceDescription& desc) const
+                {
+                    // Clear value is left out, descriptions differing only by it are rare.
+                    static_assert(sizeof(GpuResourceDescription) == 64);
+                    return (std::hash<uint32_t>()(desc.width_)) ^
+                           (std::hash<uint32_t>()(desc.height_) << 1) ^
+                           (std::hash<uint32_t>()(desc.depth_) << 3) ^
+                           (std::hash<uint32_t>()(desc.mipLevels_ | desc.sampleCount_ << 8 | static_cast<uint32_t>(desc.dimension_) << 16) << 5) ^
+                           (std::hash<uint32_t>()(desc.arraySize_) << 7) ^
+                           (std::hash<uint32_t>()(desc.structSize_) << 9) ^
+                           (std::hash<uint32_t>()(static_cast<uint32_t>(desc.format_) | static_cast<uint32_t>(desc.bindflags_) << 16) << 11);
+                }
+            };
+
         private:
             GpuResourceDescription(GpuResourceDimension dimension, uint32_t width, uint32_t height, uint32_t depth, GpuResourceFormat format, GpuResourceBindFlags bindFlags, uint32_t sampleCount, uint32_t arraySize, uint32_t mipLevels, uint32_t structSize = 0)
                 : dimension_(dimension),
@@ -348,6 +299,7 @@ namespace RR
             GpuResourceFormat format_;
             GpuResourceDimension dimension_;
             GpuResourceBindFlags bindflags_;
+            GpuResourceClearValue clearValue_;
 
         private:
             friend class GpuResource;
@@ -361,52 +313,36 @@ namespace RR
             using SharedPtr = std::shared_ptr<CpuResourceData>;
             using SharedConstPtr = std::shared_ptr<const CpuResourceData>;
 
-            struct SubresourceFootprint
-            {
-                SubresourceFootprint() = default;
-                SubresourceFootprint(size_t offset, uint32_t width, uint32_t height, uint32_t depth, uint32_t numRows, uint32_t rowSizeInBytes, size_t rowPitch, size_t depthPitch)
-                    : offset(offset), width(width), height(height), depth(depth), numRows(numRows), rowSizeInBytes(rowSizeInBytes), rowPitch(rowPitch), depthPitch(depthPitch) { }
-
-                bool isComplatable(const SubresourceFootprint& other) const
-                {
-                    return (numRows == other.numRows) &&
-                           (rowSizeInBytes == other.rowSizeInBytes);
-                }
-
-                size_t offset;
-                uint32_t width;
-                uint32_t height;
-                uint32_t depth;
-                uint32_t numRows;
-                size_t rowSizeInBytes;
-                size_t rowPitch;
-                size_t depthPitch;
-            };
+            using SubresourceFootprint = GpuResourceFootprint::SubresourceFootprint;
 
-            CpuResourceData(const std::shared_ptr<MemoryAllocation>& allocation, const GpuResourceDescription& description, const std::vector<SubresourceFootprint>& subresourceFootprints, uint32_t firstSubresource)
+            CpuResourceData(const std::shared_ptr<MemoryAllocation>& allocation, const GpuResourceDescription& description, const GpuResourceFootprint::SharedConstPtr& footprint, uint32_t firstSubresource)
                 : allocation_(allocation),
+                  footprint_(footprint),
                   description_(description),
-                  subresourceFootprints_(subresourceFootprints),
                   firstSubresource_(firstSubresource)
             {
                 ASSERT(allocation);
-                ASSERT(subresourceFootprints.size() > 0);
+                ASSERT(footprint);
                 ASSERT(firstSubresource < description.GetNumSubresources());
-                ASSERT(firstSubresource + subresourceFootprints.size() <= description.GetNumSubresources());
+                ASSERT(firstSubresource + footprint->subresourceFootprints.size() <= description.GetNumSubresources());
             };
 
             inline std::shared_ptr<MemoryAllocation> GetAllocation() const { return allocation_; }
             inline uint32_t GetFirstSubresource() const { return firstSubresource_; }
-            inline size_t GetNumSubresources() const { return subresourceFootprints_.size(); }
+            inline size_t GetNumSubresources() const { return footprint_->subresourceFootprints.size(); }
             inline const GpuResourceDescription& GetResourceDescription() const { return description_; }
-            inline const SubresourceFootprint& GetSubresourceFootprintAt(uint32_t index) const { return subresourceFootprints_[index]; }
-            inline const std::vector<SubresourceFootprint>& GetSubresourceFootprints() const { return subresourceFootprints_; }
+            inline const SubresourceFootprint& GetSubresourceFootprintAt(uint32_t index) const { return footprint_->subresourceFootprints[index]; }
+            inline const std::vector<SubresourceFootprint>& GetSubresourceFootprints() const { return footprint_->subresourceFootprints; }
+            inline const GpuResourceFootprint::SharedConstPtr& GetFootprint() const { return footprint_; }
 
             void CopyDataFrom(const GAPI::CpuResourceData::SharedPtr& source);
+            // Copies rows of subresource from tightly or arbitrarily pitched source, slices follow each other.
+            // Rows are written with non-temporal stores into upload memory, so write-combined memory isn't read or partially flushed.
+            void WriteSubresource(uint32_t index, const void* sourceRows, size_t sourcePitch);
 
         private:
             std::shared_ptr<MemoryAllocation> allocation_;
-            std::vector<SubresourceFootprint> subresourceFootprints_;
+            GpuResourceFootprint::SharedConstPtr footprint_;
             GpuResourceDescription description_;
             uint32_t firstSubresource_;
         };
@@ -415,6 +351,9 @@ namespace RR
         {
         public:
             virtual ~IGpuResource() = default;
+
+            // Null unless resource is persistently mapped.
+            virtual void* GetMappedData() const = 0;
         };
 
         class GpuResource : public Resource<IGpuResource>
@@ -433,6 +372,23 @@ namespace RR
             inline const GpuResourceDescription& GetDescription() const { return description_; }
             inline GpuResourceCpuAccess GetCpuAccess() const { return cpuAccess_; }
 
+            // Visits every cached view, e.g. to re-create descriptors after backing memory moved.
+            template <typename Callback>
+            void ForEachView(Callback&& callback)
+            {
+                Threading::ReadWriteGuard lock(viewsMutex_);
+
+                const auto visit = [&callback](auto& views) {
+                    for (auto& view : views)
+                        callback(static_cast<GpuResourceView&>(*view.second));
+                };
+
+                visit(srvs_);
+                visit(rtvs_);
+                visit(dsvs_);
+                visit(uavs_);
+            }
+
         protected:
             GpuResource(GpuResourceDescription description, GpuResourceCpuAccess cpuAccess, const U8String& name)
                 : Resource(Object::Type::GpuResource, name),
@@ -444,11 +400,79 @@ namespace RR
 
             GpuResourceDescription description_;
             GpuResourceCpuAccess cpuAccess_;
+            // Context resource was created by, views are created on the same device.
+            const Render::DeviceContext* deviceContext_ = nullptr;
+
+        private:
+            template <typename ViewType>
+            using ViewsCache = std::unordered_map<GpuResourceViewDescription, std::shared_ptr<ViewType>, GpuResourceViewDescription::HashFunc>;
+
+            // Views live as long as resource, so the same view is returned for each request with equal description.
+            template <typename ViewType, typename CreateCallback>
+            std::shared_ptr<ViewType> getOrCreateView(ViewsCache<ViewType>& views, const GpuResourceViewDescription& desc, CreateCallback&& create)
+            {
+                Threading::ReadWriteGuard lock(viewsMutex_);
+
+                const auto it = views.find(desc);
+                if (it != views.end())
+                    return it->second;
+
+                auto view = create();
+                views.emplace(desc, view);
+
+                return view;
+            }
+
+            // Resource written on one queue is handed to other queues with sync point of the writing submission.
+            void releaseQueueOwnership(const GpuSyncPoint& syncPoint)
+            {
+                ASSERT(syncPoint.IsValid());
 
-            std::unordered_map<GpuResourceViewDescription, std::shared_ptr<ShaderResourceView>, GpuResourceViewDescription::HashFunc> srvs_;
-            std::unordered_map<GpuResourceViewDescription, std::shared_ptr<RenderTargetView>, GpuResourceViewDescription::HashFunc> rtvs_;
-            std::unordered_map<GpuResourceViewDescription, std::shared_ptr<DepthStencilView>, GpuResourceViewDescription::HashFunc> dsvs_;
-            std::unordered_map<GpuResourceViewDescription, std::shared_ptr<UnorderedAccessView>, GpuResourceViewDescription::HashFunc> uavs_;
+                Threading::ReadWriteGuard lock(ownershipSpinlock_);
+
+                ownershipSyncPoint_ = syncPoint;
+                ownershipAcquiredBy_.clear();
+            }
+
+            // Returns sync point queue with the timeline fence has to wait for before the first use of resource.
+            // Each queue gets it once, transfer is dropped once completed on GPU.
+            GpuSyncPoint acquireQueueOwnership(const Fence& queueTimeline)
+            {
+                Threading::ReadWriteGuard lock(ownershipSpinlock_);
+
+                if (!ownershipSyncPoint_.IsValid())
+                    return {};
+
+                if (ownershipSyncPoint_.IsComplete())
+                {
+                    ownershipSyncPoint_ = {};
+                    ownershipAcquiredBy_.clear();
+                    return {};
+                }
+
+                // Releasing queue executes own work in order.
+                if (ownershipSyncPoint_.fence.get() == &queueTimeline)
+                    return {};
+
+                if (std::find(ownershipAcquiredBy_.begin(), ownershipAcquiredBy_.end(), &queueTimeline) != ownershipAcquiredBy_.end())
+                    return {};
+
+                ownershipAcquiredBy_.push_back(&queueTimeline);
+                return ownershipSyncPoint_;
+            }
+
+            friend class Render::DeviceContext;
+
+        private:
+            Threading::Mutex viewsMutex_;
+            ViewsCache<ShaderResourceView> srvs_;
+            ViewsCache<RenderTargetView> rtvs_;
+            ViewsCache<DepthStencilView> dsvs_;
+            ViewsCache<UnorderedAccessView> uavs_;
+
+            Threading::SpinLock ownershipSpinlock_;
+            GpuSyncPoint ownershipSyncPoint_;
+            std::vector<const Fence*> ownershipAcquiredBy_;
         };
 
         template <>
@@ -1 +0,0 @@
-#include "GpuResourceFootprint.hpp"
\ No newline at end of file
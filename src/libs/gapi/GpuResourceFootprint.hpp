@@ -1,12 +1,46 @@
 #pragma once
 
-namespace OpenDemo
+namespace RR
 {
     namespace GAPI
     {
-        namespace DX12
+        // Layout of subresources range in intermediate CPU memory.
+        // Immutable once built, so resource data of equal descriptions share one instance.
+        struct GpuResourceFootprint final
         {
+            using SharedConstPtr = std::shared_ptr<const GpuResourceFootprint>;
 
-        }
+            struct SubresourceFootprint
+            {
+                SubresourceFootprint() = default;
+                SubresourceFootprint(size_t offset, uint32_t width, uint32_t height, uint32_t depth, uint32_t numRows, uint32_t rowSizeInBytes, size_t rowPitch, size_t depthPitch)
+                    : offset(offset), width(width), height(height), depth(depth), numRows(numRows), rowSizeInBytes(rowSizeInBytes), rowPitch(rowPitch), depthPitch(depthPitch) { }
+
+                bool isComplatable(const SubresourceFootprint& other) const
+                {
+                    return (numRows == other.numRows) &&
+                           (rowSizeInBytes == other.rowSizeInBytes);
+                }
+
+                size_t offset;
+                uint32_t width;
+                uint32_t height;
+                uint32_t depth;
+                uint32_t numRows;
+                size_t rowSizeInBytes;
+                size_t rowPitch;
+                size_t depthPitch;
+            };
+
+            GpuResourceFootprint(std::vector<SubresourceFootprint>&& subresourceFootprints, size_t totalSize)
+                : subresourceFootprints(std::move(subresourceFootprints)),
+                  totalSize(totalSize)
+            {
+                ASSERT(!this->subresourceFootprints.empty());
+            }
+
+            const std::vector<SubresourceFootprint> subresourceFootprints;
+            const size_t totalSize;
+        };
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class GpuResourceFormat : uint32_t
+        {
+            Unknown,
+
+            RGBA32Float,
+            RGBA32Uint,
+            RGBA32Sint,
+            RGB32Float,
+            RGB32Uint,
+            RGB32Sint,
+            RGBA16Float,
+            RGBA16Unorm,
+            RGBA16Uint,
+            RGBA16Snorm,
+            RGBA16Sint,
+            RG32Float,
+            RG32Uint,
+            RG32Sint,
+
+            RGB10A2Unorm,
+            RGB10A2Uint,
+            R11G11B10Float,
+            RGBA8Unorm,
+            RGBA8UnormSrgb,
+            RGBA8Uint,
+            RGBA8Snorm,
+            RGBA8Sint,
+            RG16Float,
+            RG16Unorm,
+            RG16Uint,
+            RG16Snorm,
+            RG16Sint,
+
+            R32Float,
+            R32Uint,
+            R32Sint,
+
+            RG8Unorm,
+            RG8Uint,
+            RG8Snorm,
+            RG8Sint,
+
+            R16Float,
+            R16Unorm,
+            R16Uint,
+            R16Snorm,
+            R16Sint,
+            R8Unorm,
+            R8Uint,
+            R8Snorm,
+            R8Sint,
+            A8Unorm,
+
+            // Depth-stencil
+            D32FloatS8X24Uint,
+            D32Float,
+            D24UnormS8Uint,
+            D16Unorm,
+
+            // SRV formats for depth/stencil binding
+            R32FloatX8X24,
+            X32G8Uint,
+            R24UnormX8,
+            X24G8Uint,
+
+            // Compressed
+            BC1Unorm,
+            BC1UnormSrgb,
+            BC2Unorm,
+            BC2UnormSrgb,
+            BC3Unorm,
+            BC3UnormSrgb,
+            BC4Unorm,
+            BC4Snorm,
+            BC5Unorm,
+            BC5Snorm,
+            BC6HU16,
+            BC6HS16,
+            BC7Unorm,
+            BC7UnormSrgb,
+
+            RGB16Float,
+            RGB16Unorm,
+            RGB16Uint,
+            RGB16Snorm,
+            RGB16Sint,
+
+            RGB5A1Unorm,
+            RGB9E5Float,
+
+            BGRA8Unorm,
+            BGRA8UnormSrgb,
+            BGRX8Unorm,
+            BGRX8UnormSrgb,
+
+            R5G6B5Unorm,
+
+            Count
+        };
+
+        namespace Details
+        {
+            enum class FormatType
+            {
+                Unknown, ///< Unknown format Type
+                Float, ///< Floating-point formats
+                Unorm, ///< Unsigned normalized formats
+                UnormSrgb, ///< Unsigned normalized SRGB formats
+                Snorm, ///< Signed normalized formats
+                Uint, ///< Unsigned integer formats
+                Sint ///< Signed integer formats
+            };
+
+            struct FormatInfo
+            {
+                GpuResourceFormat format;
+                U8StringView name;
+
+                FormatType type;
+
+                uint32_t blockSize;
+                uint32_t channelCount;
+
+                struct
+                {
+                    uint32_t width;
+                    uint32_t height;
+                } compressionBlock;
+
+                uint32_t channelBits[4];
+
+                bool isDepth;
+                bool isStencil;
+                bool isCompressed;
+            };
+
+            // clang-format off
+            constexpr FormatInfo FormatInfos[] = {
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w] isDepth isStencil isCompressed
+                    GpuResourceFormat::Unknown,           u8"Unknown",           FormatType::Unknown,   0,         0,                      {1, 1},            0,   0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::RGBA32Float,       u8"RGBA32Float",       FormatType::Float,     16,        4,                      {1, 1},            32,  32, 32, 32, false,  false,    false,
+                    GpuResourceFormat::RGBA32Uint,        u8"RGBA32Uint",        FormatType::Uint,      16,        4,                      {1, 1},            32,  32, 32, 32, false,  false,    false,
+                    GpuResourceFormat::RGBA32Sint,        u8"RGBA32Sint",        FormatType::Sint,      16,        4,                      {1, 1},            32,  32, 32, 32, false,  false,    false,
+                    GpuResourceFormat::RGB32Float,        u8"RGB32Float",        FormatType::Float,     12,        3,                      {1, 1},            32,  32, 32, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB32Uint,         u8"RGB32Uint",         FormatType::Uint,      12,        3,                      {1, 1},            32,  32, 32, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB32Sint,         u8"RGB32Sint",         FormatType::Sint,      12,        3,                      {1, 1},            32,  32, 32, 0,  false,  false,    false,
+                    GpuResourceFormat::RGBA16Float,       u8"RGBA16Float",       FormatType::Float,     8,         4,                      {1, 1},            16,  16, 16, 16, false,  false,    false,
+                    GpuResourceFormat::RGBA16Unorm,       u8"RGBA16Unorm",       FormatType::Unorm,     8,         4,                      {1, 1},            16,  16, 16, 16, false,  false,    false,
+                    GpuResourceFormat::RGBA16Uint,        u8"RGBA16Uint",        FormatType::Uint,      8,         4,                      {1, 1},            16,  16, 16, 16, false,  false,    false,
+                    GpuResourceFormat::RGBA16Snorm,       u8"RGBA16Snorm",       FormatType::Snorm,     8,         4,                      {1, 1},            16,  16, 16, 16, false,  false,    false,
+                    GpuResourceFormat::RGBA16Sint,        u8"RGBA16Sint",        FormatType::Sint,      8,         4,                      {1, 1},            16,  16, 16, 16, false,  false,    false,
+                    GpuResourceFormat::RG32Float,         u8"RG32Float",         FormatType::Float,     8,         2,                      {1, 1},            32,  32, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG32Uint,          u8"RG32Uint",          FormatType::Uint,      8,         2,                      {1, 1},            32,  32, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG32Sint,          u8"RG32Sint",          FormatType::Sint,      8,         2,                      {1, 1},            32,  32, 0,  0,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::RGB10A2Unorm,      u8"RGB10A2Unorm",      FormatType::Unorm,     4,         4,                      {1, 1},            10,  10, 10, 2,  false,  false,    false,
+                    GpuResourceFormat::RGB10A2Uint,       u8"RGB10A2Uint",       FormatType::Uint,      4,         4,                      {1, 1},            10,  10, 10, 2,  false,  false,    false,
+                    GpuResourceFormat::R11G11B10Float,    u8"R11G11B10Float",    FormatType::Float,     4,         3,                      {1, 1},            11,  11, 10, 0,  false,  false,    false,
+                    GpuResourceFormat::RGBA8Unorm,        u8"RGBA8Unorm",        FormatType::Unorm,     4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::RGBA8UnormSrgb,    u8"RGBA8UnormSrgb",    FormatType::UnormSrgb, 4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::RGBA8Uint,         u8"RGBA8Uint",         FormatType::Uint,      4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::RGBA8Snorm,        u8"RGBA8Snorm",        FormatType::Snorm,     4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::RGBA8Sint,         u8"RGBA8Sint",         FormatType::Sint,      4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::RG16Float,         u8"RG16Float",         FormatType::Float,     4,         2,                      {1, 1},            16,  16, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG16Unorm,         u8"RG16Unorm",         FormatType::Unorm,     4,         2,                      {1, 1},            16,  16, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG16Uint,          u8"RG16Uint",          FormatType::Uint,      4,         2,                      {1, 1},            16,  16, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG16Snorm,         u8"RG16Snorm",         FormatType::Snorm,     4,         2,                      {1, 1},            16,  16, 0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG16Sint,          u8"RG16Sint",          FormatType::Sint,      4,         2,                      {1, 1},            16,  16, 0,  0,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::R32Float,          u8"R32Float",          FormatType::Float,     4,         1,                      {1, 1},            32,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R32Uint,           u8"R32Uint",           FormatType::Uint,      4,         1,                      {1, 1},            32,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R32Sint,           u8"R32Sint",           FormatType::Sint,      4,         1,                      {1, 1},            32,  0,  0,  0,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::RG8Unorm,          u8"RG8Unorm",          FormatType::Unorm,     2,         2,                      {1, 1},            8,   8,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG8Uint,           u8"RG8Uint",           FormatType::Uint,      2,         2,                      {1, 1},            8,   8,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG8Snorm,          u8"RG8Snorm",          FormatType::Snorm,     2,         2,                      {1, 1},            8,   8,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::RG8Sint,           u8"RG8Sint",           FormatType::Sint,      2,         2,                      {1, 1},            8,   8,  0,  0,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::R16Float,          u8"R16Float",          FormatType::Float,     2,         1,                      {1, 1},            16,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R16Unorm,          u8"R16Unorm",          FormatType::Unorm,     2,         1,                      {1, 1},            16,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R16Uint,           u8"R16Uint",           FormatType::Uint,      2,         1,                      {1, 1},            16,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R16Snorm,          u8"R16Snorm",          FormatType::Snorm,     2,         1,                      {1, 1},            16,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R16Sint,           u8"R16Sint",           FormatType::Sint,      2,         1,                      {1, 1},            16,  0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R8Unorm,           u8"R8Unorm",           FormatType::Unorm,     1,         1,                      {1, 1},            8,   0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R8Uint,            u8"R8Uint",            FormatType::Uint,      1,         1,                      {1, 1},            8,   0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R8Snorm,           u8"R8Snorm",           FormatType::Snorm,     1,         1,                      {1, 1},            8,   0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R8Sint,            u8"R8Sint",            FormatType::Sint,      1,         1,                      {1, 1},            8,   0,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::A8Unorm,           u8"A8Unorm",           FormatType::Unorm,     1,         1,                      {1, 1},            0,   0,  0,  8,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::D32FloatS8X24Uint, u8"D32FloatS8X24Uint", FormatType::Float,     8,         2,                      {1, 1},            32,  8,  24, 0,  true,   true,     false,
+                    GpuResourceFormat::D32Float,          u8"D32Float",          FormatType::Float,     4,         1,                      {1, 1},            32,  0,  0,  0,  true,   false,    false,
+                    GpuResourceFormat::D24UnormS8Uint,    u8"D24UnormS8Uint",    FormatType::Unorm,     4,         2,                      {1, 1},            24,  8,  0,  0,  true,   true,     false,
+                    GpuResourceFormat::D16Unorm,          u8"D16Unorm",          FormatType::Unorm,     2,         1,                      {1, 1},            16,  0,  0,  0,  true,   false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::R32FloatX8X24,     u8"R32FloatX8X24",     FormatType::Float,     8,         2,                      {1, 1},            32,  8, 24,  0,  false,  false,    false,
+                    GpuResourceFormat::X32G8Uint,         u8"X32G8Uint",         FormatType::Uint,      8,         2,                      {1, 1},            32,  8,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::R24UnormX8,        u8"R24UnormX8",        FormatType::Unorm,     4,         2,                      {1, 1},            24,  8,  0,  0,  false,  false,    false,
+                    GpuResourceFormat::X24G8Uint,         u8"X24G8Uint",         FormatType::Uint,      4,         2,                      {1, 1},            24,  8,  0,  0,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::BC1Unorm,          u8"BC1Unorm",          FormatType::Unorm,     8,         3,                      {4, 4},            64,  0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC1UnormSrgb,      u8"BC1UnormSrgb",      FormatType::UnormSrgb, 8,         3,                      {4, 4},            64,  0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC2Unorm,          u8"BC2Unorm",          FormatType::Unorm,     16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC2UnormSrgb,      u8"BC2UnormSrgb",      FormatType::UnormSrgb, 16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC3Unorm,          u8"BC3Unorm",          FormatType::Unorm,     16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC3UnormSrgb,      u8"BC3UnormSrgb",      FormatType::UnormSrgb, 16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC4Unorm,          u8"BC4Unorm",          FormatType::Unorm,     8,         1,                      {4, 4},            64,  0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC4Snorm,          u8"BC4Snorm",          FormatType::Snorm,     8,         1,                      {4, 4},            64,  0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC5Unorm,          u8"BC5Unorm",          FormatType::Unorm,     16,        2,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC5Snorm,          u8"BC5Snorm",          FormatType::Snorm,     16,        2,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC6HU16,           u8"BC6HU16",           FormatType::Float,     16,        3,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC6HS16,           u8"BC6HS16",           FormatType::Float,     16,        3,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC7Unorm,          u8"BC7Unorm",          FormatType::Unorm,     16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    GpuResourceFormat::BC7UnormSrgb,      u8"BC7UnormSrgb",      FormatType::UnormSrgb, 16,        4,                      {4, 4},            128, 0,  0,  0,  false,  false,    true,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::RGB16Float,        u8"RGB16Float",        FormatType::Float,     6,         3,                      {1, 1},            16,  16, 16, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB16Unorm,        u8"RGB16Unorm",        FormatType::Unorm,     6,         3,                      {1, 1},            16,  16, 16, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB16Uint,         u8"RGB16Uint",         FormatType::Uint,      6,         3,                      {1, 1},            16,  16, 16, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB16Snorm,        u8"RGB16Snorm",        FormatType::Snorm,     6,         3,                      {1, 1},            16,  16, 16, 0,  false,  false,    false,
+                    GpuResourceFormat::RGB16Sint,         u8"RGB16Sint",         FormatType::Sint,      6,         3,                      {1, 1},            16,  16, 16, 0,  false,  false,    false,
+                     //Format                             Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::RGB5A1Unorm,       u8"RGB5A1Unorm",       FormatType::Unorm,     2,         4,                      {1, 1},            5,   5,  5,  1,  false,  false,    false,
+                    GpuResourceFormat::RGB9E5Float,       u8"RGB9E5Float",       FormatType::Float,     4,         3,                      {1, 1},            9,   9,  9,  5,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::BGRA8Unorm,        u8"BGRA8Unorm",        FormatType::Unorm,     4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::BGRA8UnormSrgb,    u8"BGRA8UnormSrgb",    FormatType::UnormSrgb, 4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::BGRX8Unorm,        u8"BGRX8Unorm",        FormatType::Unorm,     4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    GpuResourceFormat::BGRX8UnormSrgb,    u8"BGRX8UnormSrgb",    FormatType::UnormSrgb, 4,         4,                      {1, 1},            8,   8,  8,  8,  false,  false,    false,
+                    //Format                              Name                   Type               BlockSize ChannelCount CompressionBlock{w, h} ChannelBits[x,   y,  z,  w]  isDepth isStencil isCompressed
+                    GpuResourceFormat::R5G6B5Unorm,       u8"R5G6B5Unorm",       FormatType::Unorm,     2,         3,                      {1, 1},            5,   6,  5,  0,  false,  false,    false,
+            };
+            // clang-format on
+
+            constexpr const FormatInfo& GetFormatInfo(GpuResourceFormat format)
+            {
+                return FormatInfos[static_cast<uint32_t>(format)];
+            }
+
+            constexpr bool IsFormatInfoValid()
+            {
+                for (uint32_t index = 0; index < std::size(FormatInfos); index++)
+                {
+                    const auto& info = FormatInfos[index];
+
+                    if (static_cast<uint32_t>(info.format) != index || info.name.empty())
+                        return false;
+
+                    if (info.isCompressed != (info.compressionBlock.width > 1 || info.compressionBlock.height > 1))
+                        return false;
+
+                    if (info.isStencil && !info.isDepth)
+                        return false;
+                }
+
+                return true;
+            }
+
+            static_assert(std::is_same<std::underlying_type<GpuResourceFormat>::type, uint32_t>::value);
+            static_assert(std::size(FormatInfos) == static_cast<uint32_t>(GpuResourceFormat::Count));
+            static_assert(IsFormatInfoValid(), "Format info table is inconsistent with GpuResourceFormat");
+        }
+
+        // Lookups are constexpr and fold at compile time for constant formats.
+        namespace GpuResourceFormatInfo
+        {
+            constexpr bool IsDepth(GpuResourceFormat format) { return Details::GetFormatInfo(format).isDepth; }
+            constexpr bool IsStencil(GpuResourceFormat format) { return Details::GetFormatInfo(format).isStencil; }
+            constexpr bool IsCompressed(GpuResourceFormat format) { return Details::GetFormatInfo(format).isCompressed; }
+
+            constexpr uint32_t GetBlockSize(GpuResourceFormat format) { return Details::GetFormatInfo(format).blockSize; }
+            constexpr uint32_t GetCompressionBlockWidth(GpuResourceFormat format) { return Details::GetFormatInfo(format).compressionBlock.width; }
+            constexpr uint32_t GetCompressionBlockHeight(GpuResourceFormat format) { return Details::GetFormatInfo(format).compressionBlock.height; }
+
+            constexpr U8StringView GetName(GpuResourceFormat format) { return Details::GetFormatInfo(format).name; }
+            inline U8String ToString(GpuResourceFormat format) { return U8String(GetName(format)); }
+        };
+    }
+}
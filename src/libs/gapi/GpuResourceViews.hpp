@@ -73,6 +73,8 @@ namespace RR
         {
         public:
             virtual ~IGpuResourceView() {};
+
+            virtual uint32_t GetBindlessIndex() const = 0;
         };
 
         class GpuResourceView : public Resource<IGpuResourceView, false>
@@ -89,7 +91,11 @@ namespace RR
                 UnorderedAccessView,
             };
 
+            static constexpr uint32_t InvalidBindlessIndex = 0xFFFFFFFF;
+
             ViewType GetViewType() const { return viewType_; }
+            // Stable index of view in shader visible bindless heap. Valid only for SRV and UAV.
+            uint32_t GetBindlessIndex() const { return GetPrivateImpl()->GetBindlessIndex(); }
             const GpuResourceViewDescription& GetDescription() const { return description_; }
             std::weak_ptr<GpuResource> GetGpuResource() const { return gpuResource_; }
 
@@ -120,11 +126,13 @@ namespace RR
                 const std::weak_ptr<GpuResource>& gpuResource,
                 const GpuResourceViewDescription& desc)
             {
-                return SharedPtr(new ShaderResourceView(gpuResource, desc));
+                return MakePooledShared<ShaderResourceView>(gpuResource, desc);
             };
 
             ShaderResourceView(const std::weak_ptr<GpuResource>& gpuResource, const GpuResourceViewDescription& desc);
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
 
         class DepthStencilView final : public GpuResourceView
@@ -138,12 +146,14 @@ namespace RR
                 const std::weak_ptr<Texture>& texture,
                 const GpuResourceViewDescription& desc)
             {
-                return SharedPtr(new DepthStencilView(texture, desc));
+                return MakePooledShared<DepthStencilView>(texture, desc);
             };
 
             DepthStencilView(const std::weak_ptr<Texture>& texture, const GpuResourceViewDescription& desc);
 
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
 
         class RenderTargetView final : public GpuResourceView
@@ -157,12 +167,14 @@ namespace RR
                 const std::shared_ptr<Texture>& texture,
                 const GpuResourceViewDescription& desc)
             {
-                return SharedPtr(new RenderTargetView(texture, desc));
+                return MakePooledShared<RenderTargetView>(texture, desc);
             };
 
             RenderTargetView(const std::weak_ptr<Texture>& texture, const GpuResourceViewDescription& desc);
 
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
 
         class UnorderedAccessView final : public GpuResourceView
@@ -176,12 +188,14 @@ namespace RR
                 const std::shared_ptr<GpuResource>& gpuResource,
                 const GpuResourceViewDescription& desc)
             {
-                return SharedPtr(new UnorderedAccessView(gpuResource, desc));
+                return MakePooledShared<UnorderedAccessView>(gpuResource, desc);
             };
 
             UnorderedAccessView(const std::weak_ptr<GpuResource>& gpuResource, const GpuResourceViewDescription& desc);
 
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace RR
+{
+    namespace GAPI
+    {
+        struct GpuTimingMarker final
+        {
+            static constexpr uint32_t InvalidParent = 0xFFFFFFFF;
+
+            U8String name;
+            // Index of parent marker in frame markers list.
+            uint32_t parent = InvalidParent;
+            uint32_t depth = 0;
+            // Relative to the earliest marker in the frame.
+            double startMs = 0.0;
+            double durationMs = 0.0;
+        };
+
+        // GPU timestamp and CPU steady clock sampled at the same moment, see Common::Time::Calibrate.
+        struct GpuClockCalibration final
+        {
+            uint64_t gpuTimestamp = 0;
+            // Ticks per second, zero if clocks couldn't be sampled.
+            uint64_t gpuFrequency = 0;
+            uint64_t cpuNs = 0;
+        };
+
+        // Markers stored in order they begun, children always follow their parent.
+        struct GpuFrameTimings final
+        {
+            uint64_t frameIndex = 0;
+            // CPU steady clock time of markers origin in nanoseconds, zero if GPU clock couldn't be calibrated.
+            uint64_t cpuStartNs = 0;
+            std::vector<GpuTimingMarker> markers;
+        };
+    }
+}
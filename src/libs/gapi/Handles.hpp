@@ -0,0 +1,14 @@
+#pragma once
+
+#include "common/HandlePool.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Lightweight alternative to shared_ptr objects, owner releases handle explicitly.
+        using BufferHandle = Common::Handle<struct BufferHandleTag>;
+        using TextureHandle = Common::Handle<struct TextureHandleTag>;
+        using ViewHandle = Common::Handle<struct ViewHandleTag>;
+    }
+}
@@ -4,7 +4,10 @@ namespace RR
 {
     namespace GAPI
     {
-        constexpr int MAX_GPU_FRAMES_BUFFERED = 3;
+        // Upper bound of Device::Description::gpuFramesBuffered, which is set at runtime.
+        constexpr int MAX_GPU_FRAMES_BUFFERED = 4;
         constexpr int MAX_BACK_BUFFER_COUNT = 3;
+        constexpr int MAX_SUBMIT_BATCH_SIZE = 16;
+        constexpr uint32_t MAX_THREAD_GROUPS_PER_DIMENSION = 65535;
     }
 }
\ No newline at end of file
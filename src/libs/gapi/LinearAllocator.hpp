@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/debug/MemoryStats.hpp"
+
 namespace RR
 {
     namespace GAPI
@@ -14,13 +16,17 @@ namespace RR
             struct Page final : private NonCopyable
             {
                 Page() = delete;
-                ~Page() = default;
+                ~Page()
+                {
+                    Common::Debug::MemoryStats::OnFree(tag_, Common::Debug::MemoryKind::Cpu, size_);
+                }
 
-                Page(size_t size)
-                    : size_(size)
+                Page(size_t size, Common::Debug::AllocationTag tag)
+                    : size_(size), tag_(tag)
                 {
                     ASSERT(size);
                     buffer_.reset(new uint8_t[size]);
+                    Common::Debug::MemoryStats::OnAllocate(tag_, Common::Debug::MemoryKind::Cpu, size_);
                 }
 
                 void* Allocate(size_t size, size_t aligment,
@@ -42,7 +48,7 @@ namespace RR
 
                 inline size_t GetAllocated() const
                 {
-                    return size_;
+                    return allocated_;
                 }
 
                 inline size_t GetSize() const
@@ -52,8 +58,9 @@ namespace RR
 
             private:
                 size_t size_;
+                Common::Debug::AllocationTag tag_;
                 size_t allocated_ = 0;
-                std::unique_ptr<uint8_t> buffer_;
+                std::unique_ptr<uint8_t[]> buffer_;
             };
 
         public:
@@ -64,12 +71,17 @@ namespace RR
                 size_t baseSize,
 #ifdef CACHE_LINE_ALIGN
                 size_t cacheLineSize = 128)
-                : cacheLineSize_(cacheLineSize)
 #else
                 size_t = 0)
+#endif
+                : baseSize_(baseSize),
+                  // Pages may be added from other threads, memory is attributed to the owner.
+                  tag_(Common::Debug::AllocationTracker::GetCurrentTag())
+#ifdef CACHE_LINE_ALIGN
+                  , cacheLineSize_(cacheLineSize)
 #endif
             {
-                addNewPage(baseSize);
+                addNewPage(baseSize_);
             }
 
             void* Allocate(const size_t size);
@@ -84,12 +96,24 @@ namespace RR
                 return new (ptr) T(std::forward<Args>(args)...);
             }
 
+            // Coalesces pages into single one of high-water size, so steady-state frames don't touch heap.
             void Reset();
 
+            // Releases all memory except base page.
             inline void Free()
             {
-                const size_t baseCapasity = pages_.front()->GetSize();
                 pages_.clear();
+                addNewPage(baseSize_);
+            }
+
+            inline size_t GetCapacity() const
+            {
+                size_t capacity = 0;
+
+                for (const auto& page : pages_)
+                    capacity += page->GetSize();
+
+                return capacity;
             }
 
         private:
@@ -100,6 +124,8 @@ namespace RR
 
             inline void addNewPage(size_t size);
 
+            size_t baseSize_;
+            Common::Debug::AllocationTag tag_;
             std::vector<std::unique_ptr<Page>> pages_;
             static constexpr inline size_t alignment_ = 16;
 #ifdef CACHE_LINE_ALIGN
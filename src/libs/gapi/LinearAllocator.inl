@@ -60,7 +60,7 @@ namespace RR
                 // No enough space. Allocate new page
                 if (result == nullptr)
                 {
-                    size_t nextSize = page->GetSize() << 1;
+                    size_t nextSize = std::max(page->GetSize() << 1, Common::RoundUpToPowerOfTwo(size));
                     nextSize = std::min(nextSize, MAX_PAGE_SIZE);
                     addNewPage(nextSize);
 
@@ -73,13 +73,16 @@ namespace RR
 
         INLINE void LinearAllocator::Reset()
         {
-            size_t totalCapasity = 0;
+            if (pages_.size() == 1)
+            {
+                currentPage()->Reset();
+                return;
+            }
 
-            for (const auto& page : pages_)
-                totalCapasity += page->GetSize();
+            const size_t totalCapasity = std::min(Common::RoundUpToPowerOfTwo(GetCapacity()), MAX_PAGE_SIZE);
 
-            Free();
-            addNewPage(Common::RoundUpToPowerOfTwo(totalCapasity));
+            pages_.clear();
+            addNewPage(totalCapasity);
         }
 
         INLINE void LinearAllocator::addNewPage(size_t size)
@@ -88,7 +91,7 @@ namespace RR
             ASSERT(size <= MAX_PAGE_SIZE)
             ASSERT(Common::IsPowerOfTwo(size))
 
-            pages_.push_back(std::move(std::make_unique<Page>(size)));
+            pages_.push_back(std::make_unique<Page>(size, tag_));
         }
     }
 }
\ No newline at end of file
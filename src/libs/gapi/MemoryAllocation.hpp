@@ -6,12 +6,19 @@ namespace RR
 {
     namespace GAPI
     {
+        // Memory is mapped for the whole allocation lifetime, so Map returns the same pointer for any number of users.
         class IMemoryAllocation
         {
         public:
             virtual ~IMemoryAllocation() = default;
             virtual void* Map() const = 0;
+            // Kept for scoped access, memory stays mapped.
             virtual void Unmap() const = 0;
+
+            // Makes GPU writes to readback memory visible to CPU. Call once GPU finished writing.
+            virtual void Invalidate(size_t offset, size_t size) const = 0;
+            // Makes CPU writes to upload memory visible to GPU. Call before submitting commands reading it.
+            virtual void Flush(size_t offset, size_t size) const = 0;
         };
 
         enum class MemoryAllocationType : uint32_t
@@ -36,6 +43,10 @@ namespace RR
             inline size_t GetSize() const { return size_; }
             inline void* Map() const { return GetPrivateImpl()->Map(); }
             inline void Unmap() const { GetPrivateImpl()->Unmap(); }
+            inline void Invalidate(size_t offset, size_t size) const { GetPrivateImpl()->Invalidate(offset, size); }
+            inline void Invalidate() const { Invalidate(0, size_); }
+            inline void Flush(size_t offset, size_t size) const { GetPrivateImpl()->Flush(offset, size); }
+            inline void Flush() const { Flush(0, size_); }
             inline MemoryAllocationType GetMemoryType() const { return type_; }
 
         private:
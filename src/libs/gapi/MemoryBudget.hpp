@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class MemoryHeapType : uint32_t
+        {
+            Default,
+            Upload,
+            Readback,
+            Count
+        };
+
+        // Higher priority resources are the last to be paged out by OS on memory pressure.
+        enum class ResidencyPriority : uint32_t
+        {
+            Minimum,
+            Low,
+            Normal,
+            High,
+            Maximum
+        };
+
+        struct MemoryHeapStatistics final
+        {
+            uint32_t allocationsCount = 0;
+            // Memory of heaps reserved by allocator, allocations occupy part of it.
+            uint64_t blockBytes = 0;
+            uint64_t allocationBytes = 0;
+        };
+
+        struct MemorySegmentBudget final
+        {
+            // Whole process usage as reported by OS, includes resources not created by the allocator.
+            uint64_t usageBytes = 0;
+            // Process usage above it pages memory out and stalls GPU.
+            uint64_t budgetBytes = 0;
+
+            inline bool IsOverBudget() const { return usageBytes > budgetBytes; }
+        };
+
+        // Cheap to query, suitable for every frame.
+        struct MemoryBudget final
+        {
+            // Video memory, system memory on UMA adapters.
+            MemorySegmentBudget local;
+            // System memory visible to GPU.
+            MemorySegmentBudget nonLocal;
+            // Incremented each time OS reports budget change.
+            uint64_t changesCount = 0;
+        };
+
+        // Walks all allocator blocks, should be queried occasionally.
+        struct MemoryStatistics final
+        {
+            std::array<MemoryHeapStatistics, static_cast<size_t>(MemoryHeapType::Count)> heaps;
+        };
+    }
+}
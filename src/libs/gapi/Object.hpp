@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/PoolAllocator.hpp"
+
 namespace RR
 {
     namespace GAPI
@@ -17,6 +19,8 @@ namespace RR
                 GpuResource,
                 GpuResourceView,
                 MemoryAllocation,
+                PipelineState,
+                QueryPool,
                 SwapChain,
             };
 
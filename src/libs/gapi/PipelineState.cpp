@@ -0,0 +1,86 @@
+#include "PipelineState.hpp"
+
+#include "gapi/CommandList.hpp"
+
+#include <fstream>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace
+        {
+            // FNV-1a
+            constexpr uint64_t HashOffsetBasis = 0xcbf29ce484222325ull;
+            constexpr uint64_t HashPrime = 0x100000001b3ull;
+
+            inline void hashBytes(uint64_t& hash, const void* data, size_t size)
+            {
+                const auto bytes = static_cast<const uint8_t*>(data);
+
+                for (size_t index = 0; index < size; index++)
+                {
+                    hash ^= bytes[index];
+                    hash *= HashPrime;
+                }
+            }
+
+            template <typename T>
+            inline void hashValue(uint64_t& hash, const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value);
+                hashBytes(hash, &value, sizeof(T));
+            }
+
+            inline void hashBlob(uint64_t& hash, const std::vector<uint8_t>& blob)
+            {
+                hashValue(hash, blob.size());
+                hashBytes(hash, blob.data(), blob.size());
+            }
+        }
+
+        uint64_t PipelineStateDescription::GetHash() const
+        {
+            uint64_t hash = HashOffsetBasis;
+
+            hashValue(hash, type);
+            hashBlob(hash, vertexShader);
+            hashBlob(hash, pixelShader);
+            hashBlob(hash, computeShader);
+            hashBlob(hash, reflection);
+
+            hashValue(hash, staticSamplers.size());
+            for (const auto& staticSampler : staticSamplers)
+                hashValue(hash, staticSampler);
+            hashValue(hash, renderTargetCount);
+
+            for (uint32_t index = 0; index < renderTargetCount; index++)
+                hashValue(hash, renderTargetFormats[index]);
+
+            hashValue(hash, depthStencilFormat);
+            hashValue(hash, drawConstantsCount);
+
+            return hash;
+        }
+
+        uint32_t PipelineStateDescription::GetIndirectCommandStride() const
+        {
+            return drawConstantsCount * sizeof(uint32_t) + sizeof(DrawIndexedArguments);
+        }
+
+        bool PipelineStateDescription::ReadShader(const char* path, std::vector<uint8_t>& bytecode)
+        {
+            ASSERT(path);
+
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+                return false;
+
+            bytecode.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+
+            return !bytecode.empty() && file.good();
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+#include "gapi/Limits.hpp"
+#include "gapi/Resource.hpp"
+#include "gapi/Sampler.hpp"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class PipelineStateType : uint32_t
+        {
+            Graphics,
+            Compute
+        };
+
+        struct StaticSampler
+        {
+            // Hash of sampler name in shader, matches Rfx::Reflection::HashName.
+            uint32_t nameHash;
+            SamplerDescription description;
+        };
+
+        // Root signature is built from rfx reflection of shaders, bytecode is expected to embed it when reflection is empty.
+        // Vertex input is not supported, vertices are pulled from buffers.
+        struct PipelineStateDescription
+        {
+            static constexpr uint32_t MaxRenderTargets = 8;
+            // Constant buffer declared in this space is bound as root constants, changed per draw by ExecuteIndirect.
+            static constexpr uint32_t DrawConstantsSpace = 100;
+            static constexpr uint32_t MaxDrawConstants = 16;
+
+            PipelineStateType type = PipelineStateType::Graphics;
+
+            std::vector<uint8_t> vertexShader;
+            std::vector<uint8_t> pixelShader;
+            std::vector<uint8_t> computeShader;
+            // Rfx reflection blob with binding layout shared by all stages.
+            std::vector<uint8_t> reflection;
+            // Reflected samplers with matching names are baked into root signature instead of sampler heap.
+            std::vector<StaticSampler> staticSamplers;
+
+            uint32_t renderTargetCount = 0;
+            std::array<GpuResourceFormat, MaxRenderTargets> renderTargetFormats = {};
+            GpuResourceFormat depthStencilFormat = GpuResourceFormat::Unknown;
+
+            // Count of 32-bit draw constants, they take root parameter 0 and descriptor tables follow.
+            uint32_t drawConstantsCount = 0;
+
+            // Stride of ExecuteIndirect argument records: draw constants followed by DrawIndexedArguments.
+            uint32_t GetIndirectCommandStride() const;
+
+            // Cache key. Stable between runs, so it's used for persistent cache as well.
+            uint64_t GetHash() const;
+
+            // Bytecode compiled by rfx from bin/shaders, false when file is missing or empty.
+            static bool ReadShader(const char* path, std::vector<uint8_t>& bytecode);
+        };
+
+        class IPipelineState
+        {
+        public:
+            virtual ~IPipelineState() {};
+        };
+
+        class PipelineState final : public Resource<IPipelineState>
+        {
+        public:
+            using SharedPtr = std::shared_ptr<PipelineState>;
+            using SharedConstPtr = std::shared_ptr<const PipelineState>;
+
+            const PipelineStateDescription& GetDescription() const { return description_; }
+
+            // False while asynchronous compilation is in flight.
+            inline bool IsReady() const { return isReady_.load(std::memory_order_acquire); }
+            // State to bind: itself once ready, fallback until then. Nullptr means draw should be skipped.
+            inline const PipelineState* Resolve() const
+            {
+                if (IsReady())
+                    return this;
+
+                return fallback_ && fallback_->IsReady() ? fallback_.get() : nullptr;
+            }
+
+        private:
+            static SharedPtr Create(const PipelineStateDescription& description, const U8String& name, const SharedPtr& fallback = nullptr)
+            {
+                return MakePooledShared<PipelineState>(description, name, fallback);
+            }
+
+            PipelineState(const PipelineStateDescription& description, const U8String& name, const SharedPtr& fallback)
+                : Resource(Object::Type::PipelineState, name),
+                  description_(description),
+                  fallback_(fallback)
+            {
+            }
+
+        private:
+            PipelineStateDescription description_;
+            SharedPtr fallback_;
+            // Set after private impl is initialized, so impl is visible to threads which observed it.
+            std::atomic<bool> isReady_ = false;
+
+            friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
+        };
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "gapi/Resource.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class QueryType : uint32_t
+        {
+            // Count of samples passed depth and stencil tests.
+            Occlusion,
+            // Zero or one, could be cheaper than counting samples. Enough for visibility tests.
+            BinaryOcclusion,
+            // Result is PipelineStatistics.
+            PipelineStatistics,
+            Count
+        };
+
+        // Layout of pipeline statistics query result, matches D3D12_QUERY_DATA_PIPELINE_STATISTICS.
+        struct PipelineStatistics final
+        {
+            uint64_t inputAssemblerVertices;
+            uint64_t inputAssemblerPrimitives;
+            uint64_t vertexShaderInvocations;
+            uint64_t geometryShaderInvocations;
+            uint64_t geometryShaderPrimitives;
+            uint64_t clipperInvocations;
+            uint64_t clipperPrimitives;
+            uint64_t pixelShaderInvocations;
+            uint64_t hullShaderInvocations;
+            uint64_t domainShaderInvocations;
+            uint64_t computeShaderInvocations;
+        };
+
+        struct QueryPoolDescription final
+        {
+            QueryType type = QueryType::Occlusion;
+            uint32_t count = 0;
+
+            // Occlusion results are single uint64_t.
+            inline uint32_t GetResultSize() const
+            {
+                return type == QueryType::PipelineStatistics ? sizeof(PipelineStatistics) : sizeof(uint64_t);
+            }
+        };
+
+        class IQueryPool
+        {
+        public:
+            virtual ~IQueryPool() = default;
+        };
+
+        // Queries are resolved by command lists into result buffer owned by the pool, laid out by query index.
+        // Result buffer stays on GPU: it's the source of predication and is read back with DeviceContext::ReadbackAsync,
+        // so results of the previous frames are read without stalls.
+        class QueryPool final : public Resource<IQueryPool>
+        {
+        public:
+            using SharedPtr = std::shared_ptr<QueryPool>;
+            using SharedConstPtr = std::shared_ptr<const QueryPool>;
+
+            inline const QueryPoolDescription& GetDescription() const { return description_; }
+            inline const std::shared_ptr<Buffer>& GetResultBuffer() const { return resultBuffer_; }
+
+        private:
+            static SharedPtr Create(const QueryPoolDescription& description, const std::shared_ptr<Buffer>& resultBuffer, const U8String& name)
+            {
+                return MakePooledShared<QueryPool>(description, resultBuffer, name);
+            }
+
+            QueryPool(const QueryPoolDescription& description, const std::shared_ptr<Buffer>& resultBuffer, const U8String& name)
+                : Resource(Object::Type::QueryPool, name),
+                  description_(description),
+                  resultBuffer_(resultBuffer)
+            {
+            }
+
+        private:
+            friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
+
+            QueryPoolDescription description_;
+            std::shared_ptr<Buffer> resultBuffer_;
+        };
+    }
+}
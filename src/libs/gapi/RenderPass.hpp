@@ -0,0 +1,42 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+
+#include <array>
+#include <memory>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // What happens to attachment contents when render pass begins.
+        enum class AttachmentLoadOp : uint32_t
+        {
+            Load,
+            Clear,
+            // Previous contents aren't needed, e.g. every pixel is overwritten. Saves the load on tile-based GPUs.
+            Discard
+        };
+
+        // What happens to attachment contents when render pass ends.
+        enum class AttachmentStoreOp : uint32_t
+        {
+            Store,
+            // Multisampled attachment is resolved to resolve target, attachment itself isn't stored.
+            Resolve,
+            // Contents aren't needed after the pass, e.g. transient depth or MSAA targets.
+            Discard
+        };
+
+        struct RenderPassAttachment final
+        {
+            std::shared_ptr<RenderTargetView> renderTargetView;
+            AttachmentLoadOp loadOp = AttachmentLoadOp::Load;
+            AttachmentStoreOp storeOp = AttachmentStoreOp::Store;
+            // Used by Clear load op.
+            std::array<float, 4> clearColor = {};
+            // Single sampled texture of the same format, used by Resolve store op.
+            std::shared_ptr<Texture> resolveTarget;
+        };
+    }
+}
@@ -2,6 +2,8 @@
 
 #include "gapi/Object.hpp"
 
+#include "common/Name.hpp"
+
 namespace RR
 {
     namespace GAPI
@@ -25,14 +27,18 @@ namespace RR
             template <typename T1>
             inline T1* GetPrivateImpl()
             {
+#if !GAPI_STATIC_BACKEND
                 ASSERT(dynamic_cast<T1*>(privateImpl_.get()));
+#endif
                 return static_cast<T1*>(privateImpl_.get());
             }
 
             template <typename T1>
             inline const T1* GetPrivateImpl() const
             {
+#if !GAPI_STATIC_BACKEND
                 ASSERT(dynamic_cast<T1*>(privateImpl_.get()));
+#endif
                 return static_cast<const T1*>(privateImpl_.get());
             }
 
@@ -42,7 +48,7 @@ namespace RR
             }
 
             template <typename = std::enable_if_t<IsNamed>>
-            inline U8String GetName() const { return name_; }
+            inline const U8String& GetName() const { return name_.GetString(); }
 
         protected:
             template <typename = std::enable_if_t<IsNamed>>
@@ -63,7 +69,8 @@ namespace RR
             // clang-format on
 
             std::unique_ptr<T> privateImpl_ = nullptr;
-            std::conditional_t<IsNamed, U8String, monostate> name_;
+            // Interned, transient objects reuse a handful of names.
+            std::conditional_t<IsNamed, Common::Name, monostate> name_;
         };
     }
 }
\ No newline at end of file
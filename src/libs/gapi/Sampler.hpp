@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cfloat>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        enum class SamplerFilter : uint32_t
+        {
+            Point,
+            Linear,
+            Anisotropic
+        };
+
+        enum class SamplerAddressMode : uint32_t
+        {
+            Wrap,
+            Mirror,
+            Clamp,
+            Border,
+            MirrorOnce
+        };
+
+        enum class SamplerComparison : uint32_t
+        {
+            None,
+            Never,
+            Less,
+            Equal,
+            LessEqual,
+            Greater,
+            NotEqual,
+            GreaterEqual,
+            Always
+        };
+
+        // Fixed border colors only, so any sampler could be promoted to static one.
+        enum class SamplerBorderColor : uint32_t
+        {
+            TransparentBlack,
+            OpaqueBlack,
+            OpaqueWhite
+        };
+
+        struct SamplerDescription
+        {
+            static SamplerDescription Point(SamplerAddressMode addressMode = SamplerAddressMode::Wrap)
+            {
+                return SamplerDescription(SamplerFilter::Point, addressMode);
+            }
+
+            static SamplerDescription Linear(SamplerAddressMode addressMode = SamplerAddressMode::Wrap)
+            {
+                return SamplerDescription(SamplerFilter::Linear, addressMode);
+            }
+
+            static SamplerDescription Anisotropic(uint32_t maxAnisotropy, SamplerAddressMode addressMode = SamplerAddressMode::Wrap)
+            {
+                auto description = SamplerDescription(SamplerFilter::Anisotropic, addressMode);
+                description.maxAnisotropy = maxAnisotropy;
+                return description;
+            }
+
+            SamplerDescription() = default;
+
+            SamplerFilter minFilter = SamplerFilter::Linear;
+            SamplerFilter magFilter = SamplerFilter::Linear;
+            SamplerFilter mipFilter = SamplerFilter::Linear;
+            SamplerAddressMode addressU = SamplerAddressMode::Wrap;
+            SamplerAddressMode addressV = SamplerAddressMode::Wrap;
+            SamplerAddressMode addressW = SamplerAddressMode::Wrap;
+            SamplerComparison comparison = SamplerComparison::None;
+            SamplerBorderColor borderColor = SamplerBorderColor::OpaqueBlack;
+            uint32_t maxAnisotropy = 1;
+            float mipLodBias = 0.0f;
+            float minLod = 0.0f;
+            float maxLod = FLT_MAX;
+
+            struct HashFunc
+            {
+                std::size_t operator()(const SamplerDescription& desc) const
+                {
+                    static_assert(sizeof(SamplerDescription) == 48);
+                    return (std::hash<uint32_t>()(static_cast<uint32_t>(desc.minFilter) |
+                                                  static_cast<uint32_t>(desc.magFilter) << 2 |
+                                                  static_cast<uint32_t>(desc.mipFilter) << 4 |
+                                                  static_cast<uint32_t>(desc.addressU) << 6 |
+                                                  static_cast<uint32_t>(desc.addressV) << 9 |
+                                                  static_cast<uint32_t>(desc.addressW) << 12 |
+                                                  static_cast<uint32_t>(desc.comparison) << 15 |
+                                                  static_cast<uint32_t>(desc.borderColor) << 19 |
+                                                  desc.maxAnisotropy << 21)) ^
+                           (std::hash<float>()(desc.mipLodBias) << 1) ^
+                           (std::hash<float>()(desc.minLod) << 3) ^
+                           (std::hash<float>()(desc.maxLod) << 5);
+                }
+            };
+
+            inline friend bool operator==(const SamplerDescription& lhs, const SamplerDescription& rhs)
+            {
+                return lhs.minFilter == rhs.minFilter &&
+                       lhs.magFilter == rhs.magFilter &&
+                       lhs.mipFilter == rhs.mipFilter &&
+                       lhs.addressU == rhs.addressU &&
+                       lhs.addressV == rhs.addressV &&
+                       lhs.addressW == rhs.addressW &&
+                       lhs.comparison == rhs.comparison &&
+                       lhs.borderColor == rhs.borderColor &&
+                       lhs.maxAnisotropy == rhs.maxAnisotropy &&
+                       lhs.mipLodBias == rhs.mipLodBias &&
+                       lhs.minLod == rhs.minLod &&
+                       lhs.maxLod == rhs.maxLod;
+            }
+            inline friend bool operator!=(const SamplerDescription& lhs, const SamplerDescription& rhs) { return !(lhs == rhs); }
+
+        private:
+            SamplerDescription(SamplerFilter filter, SamplerAddressMode addressMode)
+                : minFilter(filter),
+                  magFilter(filter),
+                  mipFilter(filter == SamplerFilter::Point ? SamplerFilter::Point : SamplerFilter::Linear),
+                  addressU(addressMode),
+                  addressV(addressMode),
+                  addressW(addressMode)
+            {
+            }
+        };
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Pixels covered by one pixel shader invocation, width by height.
+        enum class ShadingRate : uint32_t
+        {
+            Rate1x1,
+            Rate1x2,
+            Rate2x1,
+            Rate2x2,
+            // Rates below need ShadingRateSupport::additionalRates.
+            Rate2x4,
+            Rate4x2,
+            Rate4x4,
+            Count
+        };
+
+        // How rate of shading rate image is combined with base rate of command list.
+        enum class ShadingRateCombiner : uint32_t
+        {
+            // Base rate, image is ignored.
+            Passthrough,
+            // Image rate.
+            Override,
+            // Finer of two.
+            Min,
+            // Coarser of two.
+            Max,
+            Sum
+        };
+
+        enum class ShadingRateTier : uint32_t
+        {
+            NotSupported,
+            // Base rate per draw only.
+            Tier1,
+            // Adds shading rate image and per primitive rates.
+            Tier2
+        };
+
+        struct ShadingRateSupport final
+        {
+            ShadingRateTier tier = ShadingRateTier::NotSupported;
+            // Width and height in pixels of tile covered by one shading rate image texel, zero below tier 2.
+            uint32_t imageTileSize = 0;
+            bool additionalRates = false;
+        };
+
+        // Texel value of R8Uint shading rate image, log2 of width in bits 2-3 and log2 of height in bits 0-1.
+        inline constexpr uint8_t EncodeShadingRate(uint32_t widthLog2, uint32_t heightLog2)
+        {
+            return static_cast<uint8_t>((widthLog2 << 2) | heightLog2);
+        }
+    }
+}
@@ -21,21 +21,31 @@ namespace RR
             ASSERT(description.window);
         }
 
-        void SwapChain::Reset(const SwapChainDescription& description)
+        void SwapChain::beginReset(const SwapChainDescription& description)
         {
+            ASSERT(description.width > 0);
+            ASSERT(description.height > 0);
             ASSERT(description.isStereo == description_.isStereo);
             ASSERT(description.bufferCount == description_.bufferCount);
             ASSERT(description.gpuResourceFormat == description_.gpuResourceFormat);
             ASSERT(description.window == description_.window);
 
-            GetPrivateImpl()->Reset(description, backBuffers_);
+            // Previous reset should be done before its retired back buffers are overwritten.
+            backBuffersReady_.Wait();
+            backBuffersReady_.Reset();
 
+            retiredBackBuffers_ = std::exchange(backBuffers_, {});
             description_ = description;
-            for (auto& backBuffer : backBuffers_)
-            {
-                //TODO assert
-                backBuffer = nullptr;
-            }
+            currentBackBuffer_ = 0;
+        }
+
+        void SwapChain::reset()
+        {
+            GetPrivateImpl()->Reset(description_, retiredBackBuffers_);
+
+            // Wrappers could still be referenced by the application, they are left without native resource.
+            retiredBackBuffers_ = {};
+            backBuffersReady_.Notify();
         }
 
         Texture::SharedPtr SwapChain::GetTexture(uint32_t backBufferIndex)
@@ -45,10 +55,13 @@ namespace RR
             if (backBuffers_[backBufferIndex])
                 return backBuffers_[backBufferIndex];
 
+            // Native back buffers are recreated by resize.
+            backBuffersReady_.Wait();
+
             const GpuResourceDescription desc = GpuResourceDescription::Texture2D(description_.width, description_.height, description_.gpuResourceFormat, GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::ShaderResource, 1, 1);
-            auto& renderContext = Render::DeviceContext::Instance();
+            ASSERT(deviceContext_);
 
-            backBuffers_[backBufferIndex] = renderContext.CreateSwapChainBackBuffer(
+            backBuffers_[backBufferIndex] = deviceContext_->CreateSwapChainBackBuffer(
                 std::static_pointer_cast<SwapChain>(shared_from_this()),
                 backBufferIndex,
                 desc,
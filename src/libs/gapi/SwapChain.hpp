@@ -4,6 +4,10 @@
 #include "gapi/Limits.hpp"
 #include "gapi/Resource.hpp"
 
+#include "common/threading/Event.hpp"
+
+#include <atomic>
+
 namespace RR
 {
     namespace Windowing
@@ -24,6 +28,11 @@ namespace RR
             GpuResourceFormat gpuResourceFormat;
             bool isStereo;
 
+            // Frames queued for presentation before WaitForNextFrame blocks. Zero disables latency waitable mode.
+            uint32_t maxFrameLatency = 0;
+            // Present without vsync tears, when supported, instead of blocking. Intended for VRR displays.
+            bool allowTearing = false;
+
         public:
             SwapChainDescription() = default;
             SwapChainDescription(const std::shared_ptr<Windowing::Window>& window, uint32_t width, uint32_t height, uint32_t bufferCount, GpuResourceFormat gpuResourceFormat, bool isStereo = false)
@@ -44,7 +53,11 @@ namespace RR
 
             virtual void InitBackBufferTexture(uint32_t backBufferIndex, const std::shared_ptr<Texture>& resource) = 0;
 
+            // Back buffers are detached from the swap chain already, their native references are released before resize.
             virtual void Reset(const SwapChainDescription& description, const std::array<std::shared_ptr<Texture>, MAX_BACK_BUFFER_COUNT>& backBuffers) = 0;
+
+            // Blocks until swap chain is ready to accept new frame. Returns immediately if latency waitable mode is disabled.
+            virtual void WaitForNextFrame(uint32_t timeout) = 0;
         };
 
         class SwapChain final : public Resource<ISwapChain>
@@ -53,27 +66,45 @@ namespace RR
             using SharedPtr = std::shared_ptr<SwapChain>;
             using SharedConstPtr = std::shared_ptr<const SwapChain>;
 
+            // Blocks while resize of back buffers is in flight on submission thread.
             std::shared_ptr<Texture> GetTexture(uint32_t backBufferIndex);
 
             const SwapChainDescription& GetDescription() const { return description_; }
+            // Back buffer the next frame renders to. Advanced by DeviceContext::Present, reset to zero by resize.
+            inline uint32_t GetCurrentBackBufferIndex() const { return currentBackBuffer_; }
+
+            inline void WaitForNextFrame(uint32_t timeout = 0xFFFFFFFF) { GetPrivateImpl()->WaitForNextFrame(timeout); }
 
         private:
             static SharedPtr Create(const SwapChainDescription& description, const U8String& name)
             {
-                return SharedPtr(new SwapChain(description, name));
+                return MakePooledShared<SwapChain>(description, name);
             }
 
             SwapChain(const SwapChainDescription& description, const U8String& name);
 
-            void Reset(const SwapChainDescription& description);
+            // Called by presenting thread. Switches to new description and retires back buffers, following GetTexture
+            // waits until reset is done. Only one reset is in flight.
+            void beginReset(const SwapChainDescription& description);
+            // Called by submission thread once frames queued before are submitted.
+            void reset();
 
             inline void InitBackBufferTexture(uint32_t backBufferIndex, const std::shared_ptr<Texture>& resource) { return GetPrivateImpl()->InitBackBufferTexture(backBufferIndex, resource); }
 
         private:
             SwapChainDescription description_;
             std::array<std::shared_ptr<Texture>, MAX_BACK_BUFFER_COUNT> backBuffers_;
+            // Detached by beginReset, their native references are dropped by reset.
+            std::array<std::shared_ptr<Texture>, MAX_BACK_BUFFER_COUNT> retiredBackBuffers_;
+            uint32_t currentBackBuffer_ = 0;
+            // Latest size requested by DeviceContext::ResizeSwapChain as width << 32 | height, zero if none.
+            std::atomic<uint64_t> pendingSize_ = 0;
+            Common::Threading::Event backBuffersReady_ { true, true };
+            const Render::DeviceContext* deviceContext_ = nullptr;
 
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
\ No newline at end of file
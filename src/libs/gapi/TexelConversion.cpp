@@ -0,0 +1,350 @@
+#include "TexelConversion.hpp"
+
+#include "gapi/MemoryAllocation.hpp"
+
+#include "common/OnScopeExit.hpp"
+#include "common/threading/Parallel.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define RR_TEXEL_CONVERSION_SSE
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace TexelConversion
+        {
+            namespace
+            {
+                // Parallel split isn't worth job overhead below that.
+                constexpr size_t MinParallelSize = 1024 * 1024;
+
+                uint16_t floatToHalf(float value)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+
+                    const uint32_t sign = (bits >> 16) & 0x8000;
+                    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+                    uint32_t mantissa = bits & 0x7FFFFF;
+
+                    if (((bits >> 23) & 0xFF) == 0xFF)
+                        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+                    if (exponent >= 31)
+                        return static_cast<uint16_t>(sign | 0x7C00);
+
+                    if (exponent <= 0)
+                    {
+                        if (exponent < -10)
+                            return static_cast<uint16_t>(sign);
+
+                        mantissa |= 0x800000;
+                        const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+                        const uint32_t rounded = mantissa + (1u << (shift - 1)) - 1 + ((mantissa >> shift) & 1);
+                        return static_cast<uint16_t>(sign | (rounded >> shift));
+                    }
+
+                    // Round to nearest even, carry into exponent is correct.
+                    const uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+                    const uint32_t remainder = mantissa & 0x1FFF;
+                    return static_cast<uint16_t>(half + ((remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ? 1 : 0));
+                }
+
+                float halfToFloat(uint16_t value)
+                {
+                    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+                    const uint32_t exponent = (value >> 10) & 0x1F;
+                    uint32_t mantissa = value & 0x3FF;
+                    uint32_t bits;
+
+                    if (exponent == 0x1F)
+                        bits = sign | 0x7F800000 | (mantissa << 13);
+                    else if (exponent != 0)
+                        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+                    else if (mantissa == 0)
+                        bits = sign;
+                    else
+                    {
+                        // Denormal half is a normal float, shift mantissa up to the implicit bit.
+                        uint32_t shift = 0;
+                        for (; (mantissa & 0x400) == 0; shift++)
+                            mantissa <<= 1;
+
+                        bits = sign | ((127 - 15 + 1 - shift) << 23) | ((mantissa & 0x3FF) << 13);
+                    }
+
+                    float result;
+                    std::memcpy(&result, &bits, sizeof(result));
+                    return result;
+                }
+
+                float linearToSrgb(float value)
+                {
+                    value = std::min(std::max(value, 0.0f), 1.0f);
+                    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                }
+
+                uint32_t swizzleRedBlue(uint32_t texel)
+                {
+                    return (texel & 0xFF00FF00) | ((texel >> 16) & 0xFF) | ((texel & 0xFF) << 16);
+                }
+
+#ifdef RR_TEXEL_CONVERSION_SSE
+                bool isF16CSupported()
+                {
+                    static const bool supported = []() {
+#ifdef _MSC_VER
+                        int info[4];
+                        __cpuid(info, 1);
+                        return (info[2] & (1 << 29)) != 0;
+#else
+                        unsigned int eax, ebx, ecx, edx;
+                        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 29)) != 0;
+#endif
+                    }();
+                    return supported;
+                }
+
+#ifndef _MSC_VER
+                __attribute__((target("f16c")))
+#endif
+                void convertRowF16C(const float* source, uint16_t* dest, size_t valuesCount)
+                {
+                    size_t index = 0;
+                    for (; index + 8 <= valuesCount; index += 8)
+                    {
+                        const __m128 low = _mm_loadu_ps(source + index);
+                        const __m128 high = _mm_loadu_ps(source + index + 4);
+                        const __m128i halfs = _mm_unpacklo_epi64(_mm_cvtps_ph(low, _MM_FROUND_TO_NEAREST_INT),
+                                                                 _mm_cvtps_ph(high, _MM_FROUND_TO_NEAREST_INT));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + index), halfs);
+                    }
+
+                    for (; index < valuesCount; index++)
+                        dest[index] = floatToHalf(source[index]);
+                }
+
+#ifndef _MSC_VER
+                __attribute__((target("f16c")))
+#endif
+                void convertRowF16CToFloat(const uint16_t* source, float* dest, size_t valuesCount)
+                {
+                    size_t index = 0;
+                    for (; index + 4 <= valuesCount; index += 4)
+                    {
+                        const __m128i halfs = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + index));
+                        _mm_storeu_ps(dest + index, _mm_cvtph_ps(halfs));
+                    }
+
+                    for (; index < valuesCount; index++)
+                        dest[index] = halfToFloat(source[index]);
+                }
+#endif
+            }
+
+            void ConvertRowRGBA32FloatToRGBA16Float(const float* source, uint16_t* dest, size_t texelsCount)
+            {
+                const size_t valuesCount = texelsCount * 4;
+
+#ifdef RR_TEXEL_CONVERSION_SSE
+                if (isF16CSupported())
+                {
+                    convertRowF16C(source, dest, valuesCount);
+                    return;
+                }
+#endif
+
+                for (size_t index = 0; index < valuesCount; index++)
+                    dest[index] = floatToHalf(source[index]);
+            }
+
+            void ConvertRowRGBA16FloatToRGBA32Float(const uint16_t* source, float* dest, size_t texelsCount)
+            {
+                const size_t valuesCount = texelsCount * 4;
+
+#ifdef RR_TEXEL_CONVERSION_SSE
+                if (isF16CSupported())
+                {
+                    convertRowF16CToFloat(source, dest, valuesCount);
+                    return;
+                }
+#endif
+
+                for (size_t index = 0; index < valuesCount; index++)
+                    dest[index] = halfToFloat(source[index]);
+            }
+
+            void SwizzleRowRGBA8ToBGRA8(const uint32_t* source, uint32_t* dest, size_t texelsCount)
+            {
+                size_t index = 0;
+
+#ifdef RR_TEXEL_CONVERSION_SSE
+                const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+                const __m128i lowByteMask = _mm_set1_epi32(0xFF);
+
+                for (; index + 4 <= texelsCount; index += 4)
+                {
+                    const __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+                    const __m128i greenAlpha = _mm_and_si128(texels, greenAlphaMask);
+                    const __m128i blue = _mm_and_si128(_mm_srli_epi32(texels, 16), lowByteMask);
+                    const __m128i red = _mm_slli_epi32(_mm_and_si128(texels, lowByteMask), 16);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + index), _mm_or_si128(greenAlpha, _mm_or_si128(red, blue)));
+                }
+#endif
+
+                for (; index < texelsCount; index++)
+                    dest[index] = swizzleRedBlue(source[index]);
+            }
+
+            void EncodeRowRGBA32FloatToRGBA8Srgb(const float* source, uint32_t* dest, size_t texelsCount, bool swapRedBlue)
+            {
+                size_t index = 0;
+
+#ifdef RR_TEXEL_CONVERSION_SSE
+                // pow(x, 1 / 2.4) approximated by a sqrt series, error is below half of 8 bit step.
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 threshold = _mm_set1_ps(0.0031308f);
+                const __m128 linearScale = _mm_set1_ps(12.92f);
+                const __m128 scale = _mm_set1_ps(255.0f);
+                const __m128 half = _mm_set1_ps(0.5f);
+                // Alpha lane is passed through linearly.
+                const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+                for (; index < texelsCount; index++)
+                {
+                    const __m128 linear = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + index * 4), zero), one);
+
+                    const __m128 s1 = _mm_sqrt_ps(linear);
+                    const __m128 s2 = _mm_sqrt_ps(s1);
+                    const __m128 s3 = _mm_sqrt_ps(s2);
+                    const __m128 curve = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.585122381f), s1),
+                                                               _mm_mul_ps(_mm_set1_ps(0.783140355f), s2)),
+                                                    _mm_mul_ps(_mm_set1_ps(0.368262736f), s3));
+
+                    const __m128 isLinear = _mm_cmple_ps(linear, threshold);
+                    __m128 srgb = _mm_or_ps(_mm_and_ps(isLinear, _mm_mul_ps(linear, linearScale)), _mm_andnot_ps(isLinear, curve));
+                    srgb = _mm_or_ps(_mm_and_ps(alphaMask, linear), _mm_andnot_ps(alphaMask, srgb));
+                    srgb = _mm_min_ps(srgb, one);
+
+                    const __m128i values = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(srgb, scale), half));
+                    const __m128i packed16 = _mm_packs_epi32(values, values);
+                    const uint32_t texel = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed16, packed16)));
+
+                    dest[index] = swapRedBlue ? swizzleRedBlue(texel) : texel;
+                }
+#endif
+
+                for (; index < texelsCount; index++)
+                {
+                    const float* texel = source + index * 4;
+                    const auto toByte = [](float value) { return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+
+                    const uint32_t red = toByte(linearToSrgb(texel[0]));
+                    const uint32_t green = toByte(linearToSrgb(texel[1]));
+                    const uint32_t blue = toByte(linearToSrgb(texel[2]));
+                    const uint32_t alpha = toByte(texel[3]);
+
+                    const uint32_t packed = red | (green << 8) | (blue << 16) | (alpha << 24);
+                    dest[index] = swapRedBlue ? swizzleRedBlue(packed) : packed;
+                }
+            }
+
+            void ForEachSubresource(const CpuResourceData::SharedPtr& data, const SubresourceFunction& function)
+            {
+                ASSERT(data);
+                ASSERT(function);
+
+                const auto& allocation = data->GetAllocation();
+                const auto& footprints = data->GetSubresourceFootprints();
+                const auto dataPointer = static_cast<uint8_t*>(allocation->Map());
+                ON_SCOPE_EXIT(allocation->Unmap());
+
+                const auto processSubresource = [&](uint32_t index) {
+                    const auto& footprint = footprints[index];
+                    function(dataPointer + footprint.offset, footprint, index);
+                };
+
+                const auto subresourcesCount = static_cast<uint32_t>(footprints.size());
+
+                if (allocation->GetSize() < MinParallelSize)
+                {
+                    for (uint32_t index = 0; index < subresourcesCount; index++)
+                        processSubresource(index);
+
+                    return;
+                }
+
+                // Mips shrink fast, so every subresource is a separate job and idle workers steal remaining ones.
+                Threading::ParallelFor(0, subresourcesCount, 1, [&processSubresource](size_t first, size_t last) {
+                    for (size_t index = first; index < last; index++)
+                        processSubresource(static_cast<uint32_t>(index));
+                });
+            }
+
+            void ForEachRow(const CpuResourceData::SharedPtr& data, const RowFunction& function)
+            {
+                ASSERT(function);
+
+                ForEachSubresource(data, [&function](uint8_t* subresource, const CpuResourceData::SubresourceFootprint& footprint, uint32_t index) {
+                    for (uint32_t slice = 0; slice < footprint.depth; slice++)
+                        for (uint32_t row = 0; row < footprint.numRows; row++)
+                            function(subresource + slice * footprint.depthPitch + row * footprint.rowPitch, footprint, index, row, slice);
+                });
+            }
+
+            bool Convert(const CpuResourceData::SharedPtr& source, const CpuResourceData::SharedPtr& dest)
+            {
+                ASSERT(source);
+                ASSERT(dest);
+                ASSERT(source->GetNumSubresources() == dest->GetNumSubresources());
+
+                const auto sourceFormat = source->GetResourceDescription().GetFormat();
+                const auto destFormat = dest->GetResourceDescription().GetFormat();
+
+                const auto isRGBA8 = [](GpuResourceFormat format) { return format == GpuResourceFormat::RGBA8Unorm || format == GpuResourceFormat::RGBA8UnormSrgb; };
+                const auto isBGRA8 = [](GpuResourceFormat format) { return format == GpuResourceFormat::BGRA8Unorm || format == GpuResourceFormat::BGRA8UnormSrgb; };
+
+                std::function<void(const uint8_t*, uint8_t*, size_t)> kernel;
+
+                if (sourceFormat == GpuResourceFormat::RGBA32Float && destFormat == GpuResourceFormat::RGBA16Float)
+                    kernel = [](const uint8_t* from, uint8_t* to, size_t count) { ConvertRowRGBA32FloatToRGBA16Float(reinterpret_cast<const float*>(from), reinterpret_cast<uint16_t*>(to), count); };
+                else if ((isRGBA8(sourceFormat) && isBGRA8(destFormat)) || (isBGRA8(sourceFormat) && isRGBA8(destFormat)))
+                    kernel = [](const uint8_t* from, uint8_t* to, size_t count) { SwizzleRowRGBA8ToBGRA8(reinterpret_cast<const uint32_t*>(from), reinterpret_cast<uint32_t*>(to), count); };
+                else if (sourceFormat == GpuResourceFormat::RGBA32Float && (destFormat == GpuResourceFormat::RGBA8UnormSrgb || destFormat == GpuResourceFormat::BGRA8UnormSrgb))
+                {
+                    const bool swapRedBlue = destFormat == GpuResourceFormat::BGRA8UnormSrgb;
+                    kernel = [swapRedBlue](const uint8_t* from, uint8_t* to, size_t count) { EncodeRowRGBA32FloatToRGBA8Srgb(reinterpret_cast<const float*>(from), reinterpret_cast<uint32_t*>(to), count, swapRedBlue); };
+                }
+                else
+                    return false;
+
+                const auto& sourceAllocation = source->GetAllocation();
+                const auto sourcePointer = static_cast<const uint8_t*>(sourceAllocation->Map());
+                ON_SCOPE_EXIT(sourceAllocation->Unmap());
+
+                ForEachRow(
+                    dest, [&](uint8_t* row, const CpuResourceData::SubresourceFootprint& footprint, uint32_t subresourceIndex, uint32_t rowIndex, uint32_t depthSlice) {
+                        const auto& sourceFootprint = source->GetSubresourceFootprintAt(subresourceIndex);
+                        ASSERT(sourceFootprint.width == footprint.width && sourceFootprint.numRows == footprint.numRows);
+
+                        kernel(sourcePointer + sourceFootprint.offset + depthSlice * sourceFootprint.depthPitch + rowIndex * sourceFootprint.rowPitch,
+                               row, footprint.width);
+                    });
+
+                return true;
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Row based fill and format conversion for CpuResourceData.
+        // Kernels use SSE2 (F16C for half floats, checked at runtime) with scalar tails,
+        // large resources are split across job system workers by subresources.
+        namespace TexelConversion
+        {
+            // Called for every row of every depth slice. Rows of one subresource are processed by a single thread.
+            using RowFunction = std::function<void(uint8_t* row, const CpuResourceData::SubresourceFootprint& footprint,
+                                                   uint32_t subresourceIndex, uint32_t rowIndex, uint32_t depthSlice)>;
+
+            // Called once per subresource with pointer to its first row, for kernels that walk rows themselves.
+            using SubresourceFunction = std::function<void(uint8_t* data, const CpuResourceData::SubresourceFootprint& footprint,
+                                                           uint32_t subresourceIndex)>;
+
+            // Small resources are processed on calling thread.
+            void ForEachRow(const CpuResourceData::SharedPtr& data, const RowFunction& function);
+            void ForEachSubresource(const CpuResourceData::SharedPtr& data, const SubresourceFunction& function);
+
+            // Returns false for unsupported format pair. Supported:
+            // RGBA32Float -> RGBA16Float, RGBA8Unorm <-> BGRA8Unorm (and Srgb variants),
+            // RGBA32Float -> RGBA8UnormSrgb/BGRA8UnormSrgb (sRGB encode, alpha stays linear).
+            bool Convert(const CpuResourceData::SharedPtr& source, const CpuResourceData::SharedPtr& dest);
+
+            void ConvertRowRGBA32FloatToRGBA16Float(const float* source, uint16_t* dest, size_t texelsCount);
+            void ConvertRowRGBA16FloatToRGBA32Float(const uint16_t* source, float* dest, size_t texelsCount);
+            void SwizzleRowRGBA8ToBGRA8(const uint32_t* source, uint32_t* dest, size_t texelsCount);
+            void EncodeRowRGBA32FloatToRGBA8Srgb(const float* source, uint32_t* dest, size_t texelsCount, bool swapRedBlue);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "gapi/BlockCompression.hpp"
+#include "gapi/TexelConversion.hpp"
+
+#include "common/Math.hpp"
+
+#include <cstring>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        // Texel kernels specialized by GpuResourceFormat at compile time. Format is resolved once per resource,
+        // kernels then encode and decode whole rows with the layout known, instead of branching per texel.
+        // Rows of block compressed formats are block rows: BlockHeight texel rows go into one EncodeRow call.
+        namespace TexelKernels
+        {
+            using Vector4 = Common::Vector4;
+            using Vector3u = Common::Vector3u;
+
+            // Primary template is left undefined, unsupported format fails to compile.
+            template <GpuResourceFormat Format, typename Enable = void>
+            struct Kernel;
+
+            template <>
+            struct Kernel<GpuResourceFormat::RGBA32Float>
+            {
+                static void EncodeRow(const Vector4* texels, uint32_t width, uint8_t* dest) { std::memcpy(dest, texels, width * sizeof(Vector4)); }
+                static void DecodeRow(const uint8_t* source, uint32_t width, Vector4* texels) { std::memcpy(texels, source, width * sizeof(Vector4)); }
+            };
+
+            template <>
+            struct Kernel<GpuResourceFormat::RGBA16Float>
+            {
+                static void EncodeRow(const Vector4* texels, uint32_t width, uint8_t* dest)
+                {
+                    TexelConversion::ConvertRowRGBA32FloatToRGBA16Float(&texels->x, reinterpret_cast<uint16_t*>(dest), width);
+                }
+
+                static void DecodeRow(const uint8_t* source, uint32_t width, Vector4* texels)
+                {
+                    TexelConversion::ConvertRowRGBA16FloatToRGBA32Float(reinterpret_cast<const uint16_t*>(source), &texels->x, width);
+                }
+            };
+
+            // 8 bit formats with normalized values, Uint one stores the same 0..255 codes.
+            template <GpuResourceFormat Format>
+            struct Kernel<Format, std::enable_if_t<Format == GpuResourceFormat::RGBA8Unorm || Format == GpuResourceFormat::RGBA8Uint ||
+                                                   Format == GpuResourceFormat::BGRA8Unorm>>
+            {
+                static constexpr bool SwapRedBlue = Format == GpuResourceFormat::BGRA8Unorm;
+
+                static void EncodeRow(const Vector4* texels, uint32_t width, uint8_t* dest)
+                {
+                    const auto toByte = [](float value) { return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+
+                    auto texel = reinterpret_cast<uint32_t*>(dest);
+                    for (uint32_t column = 0; column < width; column++, texels++)
+                    {
+                        const uint32_t red = toByte(SwapRedBlue ? texels->z : texels->x);
+                        const uint32_t blue = toByte(SwapRedBlue ? texels->x : texels->z);
+                        *texel++ = red | (toByte(texels->y) << 8) | (blue << 16) | (toByte(texels->w) << 24);
+                    }
+                }
+
+                static void DecodeRow(const uint8_t* source, uint32_t width, Vector4* texels)
+                {
+                    constexpr float Scale = 1.0f / 255.0f;
+
+                    for (uint32_t column = 0; column < width; column++, source += 4)
+                    {
+                        const float red = source[SwapRedBlue ? 2 : 0] * Scale;
+                        const float blue = source[SwapRedBlue ? 0 : 2] * Scale;
+                        texels[column] = Vector4(red, source[1] * Scale, blue, source[3] * Scale);
+                    }
+                }
+            };
+
+            // Encoded from linear values, alpha stays linear.
+            template <GpuResourceFormat Format>
+            struct Kernel<Format, std::enable_if_t<Format == GpuResourceFormat::RGBA8UnormSrgb || Format == GpuResourceFormat::BGRA8UnormSrgb>>
+            {
+                static void EncodeRow(const Vector4* texels, uint32_t width, uint8_t* dest)
+                {
+                    TexelConversion::EncodeRowRGBA32FloatToRGBA8Srgb(&texels->x, reinterpret_cast<uint32_t*>(dest), width,
+                                                                    Format == GpuResourceFormat::BGRA8UnormSrgb);
+                }
+            };
+
+            // Encode only, there is no CPU decoder for block compressed formats.
+            template <GpuResourceFormat Format>
+            struct Kernel<Format, std::enable_if_t<Format == GpuResourceFormat::BC1Unorm || Format == GpuResourceFormat::BC3Unorm ||
+                                                   Format == GpuResourceFormat::BC4Unorm || Format == GpuResourceFormat::BC5Unorm ||
+                                                   Format == GpuResourceFormat::BC6HU16 || Format == GpuResourceFormat::BC7Unorm>>
+            {
+                static constexpr uint32_t BlockWidth = GpuResourceFormatInfo::GetCompressionBlockWidth(Format);
+                static constexpr uint32_t BlockHeight = GpuResourceFormatInfo::GetCompressionBlockHeight(Format);
+                static constexpr uint32_t BlockSize = GpuResourceFormatInfo::GetBlockSize(Format);
+
+                // Texels hold BlockHeight rows of width texels, width is a multiple of BlockWidth.
+                static void EncodeRow(const Vector4* texels, uint32_t width, uint8_t* dest)
+                {
+                    ASSERT(width % BlockWidth == 0);
+
+                    std::array<Vector4, BlockWidth * BlockHeight> block;
+                    for (uint32_t column = 0; column < width; column += BlockWidth, dest += BlockSize)
+                    {
+                        for (uint32_t y = 0; y < BlockHeight; y++)
+                            std::copy_n(texels + y * width + column, BlockWidth, block.data() + y * BlockWidth);
+
+                        const bool isEncoded = BlockCompression::EncodeBlock(Format, &block[0].x, dest);
+                        ASSERT(isEncoded);
+                        std::ignore = isEncoded;
+                    }
+                }
+            };
+
+            // Generator is called as Vector4(Vector3u texel, uint32_t subresourceIndex) for every texel of the subresource.
+            template <GpuResourceFormat Format, typename Generator>
+            void FillSubresource(uint8_t* data, const CpuResourceData::SubresourceFootprint& footprint, uint32_t subresourceIndex, const Generator& generator)
+            {
+                static_assert(sizeof(Vector4) == 4 * sizeof(float));
+
+                constexpr uint32_t BlockWidth = GpuResourceFormatInfo::GetCompressionBlockWidth(Format);
+                constexpr uint32_t BlockHeight = GpuResourceFormatInfo::GetCompressionBlockHeight(Format);
+
+                // Footprint dimensions are aligned to block size, so blocks never cross the row end.
+                const uint32_t width = footprint.width;
+                ASSERT(width % BlockWidth == 0);
+                ASSERT(footprint.numRows * BlockHeight >= footprint.height);
+
+                // Reused by the worker across subresources and resources.
+                thread_local std::vector<Vector4> texels;
+                texels.resize(static_cast<size_t>(width) * BlockHeight);
+
+                for (uint32_t slice = 0; slice < footprint.depth; slice++)
+                {
+                    uint8_t* row = data + slice * footprint.depthPitch;
+                    for (uint32_t blockRow = 0; blockRow < footprint.numRows; blockRow++, row += footprint.rowPitch)
+                    {
+                        for (uint32_t y = 0; y < BlockHeight; y++)
+                            for (uint32_t column = 0; column < width; column++)
+                                texels[y * width + column] = generator(Vector3u(column, blockRow * BlockHeight + y, slice), subresourceIndex);
+
+                        Kernel<Format>::EncodeRow(texels.data(), width, row);
+                    }
+                }
+            }
+
+            // Fills whole resource, format is dispatched at compile time. Subresources are split across job system workers.
+            template <GpuResourceFormat Format, typename Generator>
+            void Fill(const CpuResourceData::SharedPtr& data, const Generator& generator)
+            {
+                ASSERT(data);
+                ASSERT(data->GetResourceDescription().GetFormat() == Format);
+
+                TexelConversion::ForEachSubresource(data, [&generator](uint8_t* subresource, const CpuResourceData::SubresourceFootprint& footprint, uint32_t index) {
+                    FillSubresource<Format>(subresource, footprint, index, generator);
+                });
+            }
+
+            // Calls function(Vector4* row, uint32_t width, Vector3u texel, uint32_t subresourceIndex) per decoded row of the resource.
+            template <GpuResourceFormat Format, typename Function>
+            void Decode(const CpuResourceData::SharedPtr& data, const Function& function)
+            {
+                ASSERT(data);
+                ASSERT(data->GetResourceDescription().GetFormat() == Format);
+                static_assert(!GpuResourceFormatInfo::IsCompressed(Format), "Block compressed formats can't be decoded");
+
+                TexelConversion::ForEachRow(data, [&function](uint8_t* row, const CpuResourceData::SubresourceFootprint& footprint, uint32_t index, uint32_t rowIndex, uint32_t depthSlice) {
+                    thread_local std::vector<Vector4> texels;
+                    texels.resize(footprint.width);
+
+                    Kernel<Format>::DecodeRow(row, footprint.width, texels.data());
+                    function(texels.data(), footprint.width, Vector3u(0, rowIndex, depthSlice), index);
+                });
+            }
+        }
+    }
+}
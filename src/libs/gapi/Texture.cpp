@@ -10,12 +10,55 @@
 #include "common/Math.hpp"
 #include "common/OnScopeExit.hpp"
 
+#if SIMD_SSE
+#include <immintrin.h>
+#endif
+
 namespace RR
 {
     namespace GAPI
     {
         namespace
         {
+            // Streaming stores bypass caches, destination lines are never read into write-combined memory.
+            void copyNonTemporal(uint8_t* dest, const uint8_t* source, size_t size)
+            {
+#if SIMD_SSE
+#if defined(__AVX__)
+                constexpr size_t alignment = 32;
+#else
+                constexpr size_t alignment = 16;
+#endif
+                const auto head = std::min(size, (alignment - reinterpret_cast<uintptr_t>(dest) % alignment) % alignment);
+                std::memcpy(dest, source, head);
+                dest += head;
+                source += head;
+                size -= head;
+
+                const auto body = size - size % alignment;
+                for (size_t offset = 0; offset < body; offset += alignment)
+                {
+#if defined(__AVX__)
+                    _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + offset), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset)));
+#else
+                    _mm_stream_si128(reinterpret_cast<__m128i*>(dest + offset), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset)));
+#endif
+                }
+
+                std::memcpy(dest + body, source + body, size - body);
+#else
+                std::memcpy(dest, source, size);
+#endif
+            }
+
+            // Streaming stores are weakly ordered, fence them before memory is handed to GPU.
+            void fenceNonTemporal()
+            {
+#if SIMD_SSE
+                _mm_sfence();
+#endif
+            }
+
             GpuResourceFormat getViewFormat(GpuResourceFormat resourceFormat, GpuResourceFormat viewFormat)
             {
                 if (viewFormat == GpuResourceFormat::Unknown)
@@ -29,7 +72,7 @@ namespace RR
                 return viewFormat;
             }
 
-            const GpuResourceViewDescription& createViewDesctiption(const GpuResourceDescription& resDesctiption, GpuResourceFormat viewFormat, uint32_t mipLevel, uint32_t mipCount, uint32_t firstArraySlice, uint32_t arraySliceCount)
+            GpuResourceViewDescription createViewDesctiption(const GpuResourceDescription& resDesctiption, GpuResourceFormat viewFormat, uint32_t mipLevel, uint32_t mipCount, uint32_t firstArraySlice, uint32_t arraySliceCount)
             {
                 const auto resArraySize = resDesctiption.GetArraySize();
                 const auto resMipLevels = resDesctiption.GetMipCount();
@@ -53,59 +96,35 @@ namespace RR
 
         ShaderResourceView::SharedPtr Texture::GetSRV(uint32_t mipLevel, uint32_t mipCount, uint32_t firstArraySlice, uint32_t numArraySlices, GpuResourceFormat format)
         {
-            const const auto& viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
+            const auto viewDesc = createViewDesctiption(description_, format, mipLevel, mipCount, firstArraySlice, numArraySlices);
 
-            if (srvs_.find(viewDesc) == srvs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                srvs_[viewDesc] = renderContext.CreateShaderResourceView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
-            }
-
-            return srvs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateShaderResourceView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
         }
 
         DepthStencilView::SharedPtr Texture::GetDSV(uint32_t mipLevel, uint32_t firstArraySlice, uint32_t numArraySlices, GpuResourceFormat format)
         {
-            const auto& viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
+            const auto viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
             // TODO VALIDATION VIEW DESC FORMAT
 
-            if (dsvs_.find(viewDesc) == dsvs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                dsvs_[viewDesc] = renderContext.CreateDepthStencilView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
-            }
-
-            return dsvs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateDepthStencilView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
         }
 
         RenderTargetView::SharedPtr Texture::GetRTV(uint32_t mipLevel, uint32_t firstArraySlice, uint32_t numArraySlices, GpuResourceFormat format)
         {
-            const auto& viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
-
-            if (rtvs_.find(viewDesc) == rtvs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                rtvs_[viewDesc] = renderContext.CreateRenderTargetView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
-            }
+            const auto viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
 
-            return rtvs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateRenderTargetView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
         }
 
         UnorderedAccessView::SharedPtr Texture::GetUAV(uint32_t mipLevel, uint32_t firstArraySlice, uint32_t numArraySlices, GpuResourceFormat format)
         {
-            const auto& viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
+            const auto viewDesc = createViewDesctiption(description_, format, mipLevel, 1, firstArraySlice, numArraySlices);
 
-            if (uavs_.find(viewDesc) == uavs_.end())
-            {
-                auto& renderContext = Render::DeviceContext::Instance();
-                // TODO static_pointer_cast; name_
-                uavs_[viewDesc] = renderContext.CreateUnorderedAccessView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
-            }
-
-            return uavs_[viewDesc];
+            ASSERT(deviceContext_);
+            return deviceContext_->CreateUnorderedAccessView(std::static_pointer_cast<Texture>(shared_from_this()), viewDesc);
         }
 
         void CpuResourceData::CopyDataFrom(const GAPI::CpuResourceData::SharedPtr& source)
@@ -127,6 +146,8 @@ namespace RR
                     allocation_->Unmap();
                 });
 
+            const bool isUpload = allocation_->GetMemoryType() == MemoryAllocationType::Upload;
+
             const auto numSubresources = source->GetNumSubresources();
             for (uint32_t index = 0; index < numSubresources; index++)
             {
@@ -142,13 +163,53 @@ namespace RR
 
                     for (uint32_t row = 0; row < sourceFootprint.numRows; row++)
                     {
-                        std::memcpy(destRowPointer, sourceRowPointer, sourceFootprint.rowSizeInBytes);
+                        if (isUpload)
+                            copyNonTemporal(destRowPointer, sourceRowPointer, sourceFootprint.rowSizeInBytes);
+                        else
+                            std::memcpy(destRowPointer, sourceRowPointer, sourceFootprint.rowSizeInBytes);
 
                         sourceRowPointer += sourceFootprint.rowPitch;
                         destRowPointer += destFootprint.rowPitch;
                     }
                 }
             }
+
+            if (isUpload)
+                fenceNonTemporal();
+        }
+
+        void CpuResourceData::WriteSubresource(uint32_t index, const void* sourceRows, size_t sourcePitch)
+        {
+            ASSERT(sourceRows);
+            ASSERT(index < GetNumSubresources());
+            ASSERT(allocation_->GetMemoryType() != MemoryAllocationType::Readback);
+
+            const auto& footprint = GetSubresourceFootprintAt(index);
+            ASSERT(sourcePitch >= footprint.rowSizeInBytes);
+
+            const bool isUpload = allocation_->GetMemoryType() == MemoryAllocationType::Upload;
+
+            auto sourceRowPointer = static_cast<const uint8_t*>(sourceRows);
+            const auto destDataPointer = static_cast<uint8_t*>(allocation_->Map()) + footprint.offset;
+
+            for (uint32_t depth = 0; depth < footprint.depth; depth++)
+            {
+                auto destRowPointer = destDataPointer + footprint.depthPitch * depth;
+
+                for (uint32_t row = 0; row < footprint.numRows; row++)
+                {
+                    if (isUpload)
+                        copyNonTemporal(destRowPointer, sourceRowPointer, footprint.rowSizeInBytes);
+                    else
+                        std::memcpy(destRowPointer, sourceRowPointer, footprint.rowSizeInBytes);
+
+                    sourceRowPointer += sourcePitch;
+                    destRowPointer += footprint.rowPitch;
+                }
+            }
+
+            if (isUpload)
+                fenceNonTemporal();
         }
     }
 }
\ No newline at end of file
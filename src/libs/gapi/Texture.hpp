@@ -15,6 +15,8 @@ namespace RR
             static constexpr uint32_t MaxPossible = 0xFFFFFF;
 
         public:
+            inline GpuResourceAllocationHint GetAllocationHint() const { return allocationHint_; }
+
             std::shared_ptr<ShaderResourceView> GetSRV(uint32_t mipLevel = 0, uint32_t mipCount = MaxPossible, uint32_t firstArraySlice = 0, uint32_t numArraySlices = MaxPossible, GpuResourceFormat format = GpuResourceFormat::Unknown);
             std::shared_ptr<RenderTargetView> GetRTV(uint32_t mipLevel = 0, uint32_t firstArraySlice = 0, uint32_t numArraySlices = MaxPossible, GpuResourceFormat format = GpuResourceFormat::Unknown);
             std::shared_ptr<DepthStencilView> GetDSV(uint32_t mipLevel = 0, uint32_t firstArraySlice = 0, uint32_t numArraySlices = MaxPossible, GpuResourceFormat format = GpuResourceFormat::Unknown);
@@ -24,16 +26,21 @@ namespace RR
             static SharedPtr Create(
                 const GpuResourceDescription& description,
                 GpuResourceCpuAccess cpuAccess,
-                const U8String& name)
+                const U8String& name,
+                GpuResourceAllocationHint allocationHint = GpuResourceAllocationHint::Default)
             {
-                return SharedPtr(new Texture(description, cpuAccess, name));
+                return MakePooledShared<Texture>(description, cpuAccess, name, allocationHint);
             }
 
-            Texture(const GpuResourceDescription& description, GpuResourceCpuAccess cpuAccess, const U8String& name)
-                : GpuResource(description, cpuAccess, name) {};
+            Texture(const GpuResourceDescription& description, GpuResourceCpuAccess cpuAccess, const U8String& name, GpuResourceAllocationHint allocationHint)
+                : GpuResource(description, cpuAccess, name), allocationHint_(allocationHint) {};
 
         private:
+            GpuResourceAllocationHint allocationHint_;
+
             friend class Render::DeviceContext;
+            template <typename>
+            friend class Common::PoolAllocator;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "BindlessDescriptorHeap.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            BindlessDescriptorHeap::~BindlessDescriptorHeap()
+            {
+                ASSERT(!d3d12Heap_);
+            }
+
+            void BindlessDescriptorHeap::Init(uint32_t numDescriptors)
+            {
+                ASSERT(!d3d12Heap_);
+                ASSERT(numDescriptors > 0 && numDescriptors < InvalidIndex);
+
+                const auto& device = deviceContext_.GetDevice();
+
+                numDescriptors_ = numDescriptors;
+                descriptorSize_ = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+                D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+                heapDesc.NumDescriptors = numDescriptors_;
+                heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+                heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+                D3DCall(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(d3d12Heap_.put())));
+                D3DUtils::SetAPIName(d3d12Heap_.get(), "Bindless");
+
+                cpuHeapStart_ = d3d12Heap_->GetCPUDescriptorHandleForHeapStart();
+                gpuHeapStart_ = d3d12Heap_->GetGPUDescriptorHandleForHeapStart();
+
+                freeListNext_ = std::make_unique<std::atomic<uint32_t>[]>(numDescriptors_);
+                cursor_ = 0;
+                allocated_ = 0;
+                freeListHead_ = InvalidIndex;
+            }
+
+            void BindlessDescriptorHeap::Terminate()
+            {
+                ASSERT(d3d12Heap_);
+
+                // Views outlived device are leaked, their slots are never returned.
+                if (allocated_ != 0)
+                    LOG_WARNING("Bindless descriptor heap leaked %u slots", allocated_.load());
+
+                freeListNext_ = nullptr;
+                d3d12Heap_ = nullptr;
+            }
+
+            uint32_t BindlessDescriptorHeap::Allocate()
+            {
+                ASSERT(d3d12Heap_);
+
+                auto head = freeListHead_.load(std::memory_order_acquire);
+                while (static_cast<uint32_t>(head & IndexMask) != InvalidIndex)
+                {
+                    const auto index = static_cast<uint32_t>(head & IndexMask);
+                    const auto next = freeListNext_[index].load(std::memory_order_relaxed);
+                    const auto newHead = ((head >> 32) + 1) << 32 | next;
+
+                    if (freeListHead_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+                    {
+                        allocated_++;
+                        return index;
+                    }
+                }
+
+                const auto index = cursor_.fetch_add(1, std::memory_order_relaxed);
+                if (index >= numDescriptors_)
+                    LOG_FATAL("Not enough memory in bindless descriptor heap");
+
+                allocated_++;
+                return index;
+            }
+
+            void BindlessDescriptorHeap::Free(uint32_t index)
+            {
+                ASSERT(d3d12Heap_);
+                ASSERT(index < numDescriptors_);
+
+                auto head = freeListHead_.load(std::memory_order_relaxed);
+                uint64_t newHead;
+
+                do
+                {
+                    freeListNext_[index].store(static_cast<uint32_t>(head & IndexMask), std::memory_order_relaxed);
+                    newHead = ((head >> 32) + 1) << 32 | index;
+                } while (!freeListHead_.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+
+                allocated_--;
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Shader visible CBV/SRV/UAV heap with stable per view slot index.
+            // Slots allocation and freeing are lock-free, freed slots reused only after GPU is done with them.
+            class BindlessDescriptorHeap final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+                BindlessDescriptorHeap(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~BindlessDescriptorHeap();
+
+                void Init(uint32_t numDescriptors);
+                void Terminate();
+
+                uint32_t Allocate();
+                void Free(uint32_t index);
+
+                CD3DX12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index) const
+                {
+                    ASSERT(d3d12Heap_);
+                    ASSERT(index < numDescriptors_);
+                    return CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuHeapStart_, index, descriptorSize_);
+                }
+
+                CD3DX12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const
+                {
+                    ASSERT(d3d12Heap_);
+                    ASSERT(index < numDescriptors_);
+                    return CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuHeapStart_, index, descriptorSize_);
+                }
+
+                const ComSharedPtr<ID3D12DescriptorHeap>& GetD3DObject() const { return d3d12Heap_; }
+                // Slots held by deferred releases are still counted as allocated.
+                uint32_t GetAllocatedCount() const { return allocated_.load(std::memory_order_relaxed); }
+                uint32_t GetCapacity() const { return numDescriptors_; }
+
+            private:
+                DeviceContext& deviceContext_;
+                static constexpr uint64_t IndexMask = 0xFFFFFFFF;
+
+                uint32_t numDescriptors_ = 0;
+                uint32_t descriptorSize_ = 0;
+                D3D12_CPU_DESCRIPTOR_HANDLE cpuHeapStart_ = {};
+                D3D12_GPU_DESCRIPTOR_HANDLE gpuHeapStart_ = {};
+
+                // Never used slots are taken by bump cursor first.
+                std::atomic<uint32_t> cursor_ = 0;
+                std::atomic<uint32_t> allocated_ = 0;
+                // Tagged head of free slots stack: low 32 bits - index, high 32 bits - ABA tag.
+                std::atomic<uint64_t> freeListHead_ = InvalidIndex;
+                std::unique_ptr<std::atomic<uint32_t>[]> freeListNext_;
+
+                ComSharedPtr<ID3D12DescriptorHeap> d3d12Heap_;
+            };
+        }
+    }
+}
@@ -0,0 +1,203 @@
+#include "BufferSubAllocator.hpp"
+
+#include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/ResourceImpl.hpp"
+
+#include "common/Math.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            BufferSubAllocator::~BufferSubAllocator()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void BufferSubAllocator::Init()
+            {
+                ASSERT(!isInited_);
+
+                fence_ = std::make_unique<FenceImpl>(deviceContext_);
+                fence_->Init("BufferSubAllocator");
+
+                isInited_ = true;
+            }
+
+            void BufferSubAllocator::Terminate()
+            {
+                ASSERT(isInited_);
+
+                // Pooled buffers are released deferred by their ResourceImpl.
+                pools_.clear();
+                retiredRanges_.clear();
+                fence_ = nullptr;
+
+                isInited_ = false;
+            }
+
+            bool BufferSubAllocator::IsSuitable(const GpuResourceDescription& description)
+            {
+                if (description.GetDimension() != GpuResourceDimension::Buffer)
+                    return false;
+
+                if (description.GetSize() > MaxAllocationSize || IsAny(description.GetBindFlags(), GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil))
+                    return false;
+
+                // Raw views address 32 bit words.
+                const uint32_t elementSize = description.GetStructSize() > 0 ? description.GetStructSize()
+                                             : description.IsTyped()         ? GpuResourceFormatInfo::GetBlockSize(description.GetFormat())
+                                                                             : sizeof(uint32_t);
+
+                return elementSize > 0 && Alignment % elementSize == 0;
+            }
+
+            BufferSubAllocator::Allocation BufferSubAllocator::Allocate(const GpuResourceDescription& description, GpuResourceCpuAccess cpuAccess)
+            {
+                ASSERT(isInited_);
+                ASSERT(IsSuitable(description));
+
+                const uint64_t size = AlignTo(static_cast<uint64_t>(description.GetSize()), Alignment);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                reclaimRetiredRanges();
+
+                const auto poolIndex = getPoolIndex(description.GetBindFlags(), cpuAccess);
+                auto& pool = pools_[poolIndex];
+
+                uint64_t offset = 0;
+                uint32_t pageIndex = 0;
+
+                // Most recent pages are likely to have free space.
+                for (pageIndex = static_cast<uint32_t>(pool.pages.size()); pageIndex > 0; pageIndex--)
+                    if (tryAllocate(pool.pages[pageIndex - 1], size, offset))
+                        break;
+
+                if (pageIndex == 0)
+                {
+                    pool.pages.push_back(createPage(pool, poolIndex, static_cast<uint32_t>(pool.pages.size())));
+                    pageIndex = static_cast<uint32_t>(pool.pages.size());
+
+                    const bool allocated = tryAllocate(pool.pages.back(), size, offset);
+                    ASSERT(allocated);
+                    std::ignore = allocated;
+                }
+
+                Allocation allocation;
+                allocation.resource = pool.pages[pageIndex - 1].resource->GetD3DObject();
+                allocation.offset = offset;
+                allocation.size = size;
+                if (const auto pageData = pool.pages[pageIndex - 1].resource->GetMappedData())
+                    allocation.mappedData = static_cast<uint8_t*>(pageData) + offset;
+                allocation.poolIndex = poolIndex;
+                allocation.pageIndex = pageIndex - 1;
+
+                return allocation;
+            }
+
+            void BufferSubAllocator::Release(Allocation& allocation)
+            {
+                ASSERT(isInited_);
+                ASSERT(allocation.IsValid());
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                // Range could still be used by frames in flight, it's free once GPU passed current fence value.
+                retiredRanges_.push_back({ allocation.poolIndex, allocation.pageIndex, { allocation.offset, allocation.size }, fence_->GetCpuValue() });
+
+                allocation = {};
+            }
+
+            void BufferSubAllocator::MoveToNextFrame(CommandQueueImpl& queue)
+            {
+                ASSERT(isInited_);
+                fence_->Signal(queue);
+            }
+
+            void BufferSubAllocator::reclaimRetiredRanges()
+            {
+                const auto gpuFenceValue = fence_->GetGpuValue();
+
+                while (!retiredRanges_.empty() && retiredRanges_.front().fenceValue < gpuFenceValue)
+                {
+                    const auto& retired = retiredRanges_.front();
+                    freeRange(pools_[retired.poolIndex].pages[retired.pageIndex], retired.range);
+                    retiredRanges_.pop_front();
+                }
+            }
+
+            uint32_t BufferSubAllocator::getPoolIndex(GpuResourceBindFlags bindFlags, GpuResourceCpuAccess cpuAccess)
+            {
+                for (uint32_t index = 0; index < pools_.size(); index++)
+                    if (pools_[index].bindFlags == bindFlags && pools_[index].cpuAccess == cpuAccess)
+                        return index;
+
+                pools_.push_back({ bindFlags, cpuAccess, {} });
+                return static_cast<uint32_t>(pools_.size() - 1);
+            }
+
+            bool BufferSubAllocator::tryAllocate(Page& page, uint64_t size, uint64_t& offset) const
+            {
+                // First fit keeps low offsets dense and large ranges at the page end.
+                for (auto it = page.freeRanges.begin(); it != page.freeRanges.end(); ++it)
+                {
+                    if (it->size < size)
+                        continue;
+
+                    offset = it->offset;
+                    it->offset += size;
+                    it->size -= size;
+
+                    if (it->size == 0)
+                        page.freeRanges.erase(it);
+
+                    return true;
+                }
+
+                return false;
+            }
+
+            void BufferSubAllocator::freeRange(Page& page, const Range& range) const
+            {
+                auto& freeRanges = page.freeRanges;
+
+                auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), range.offset,
+                                             [](const Range& freeRange, uint64_t offset) { return freeRange.offset < offset; });
+
+                const bool mergePrev = next != freeRanges.begin() && std::prev(next)->offset + std::prev(next)->size == range.offset;
+                const bool mergeNext = next != freeRanges.end() && range.offset + range.size == next->offset;
+
+                if (mergePrev && mergeNext)
+                {
+                    std::prev(next)->size += range.size + next->size;
+                    freeRanges.erase(next);
+                }
+                else if (mergePrev)
+                    std::prev(next)->size += range.size;
+                else if (mergeNext)
+                {
+                    next->offset = range.offset;
+                    next->size += range.size;
+                }
+                else
+                    freeRanges.insert(next, range);
+            }
+
+            BufferSubAllocator::Page BufferSubAllocator::createPage(const Pool& pool, uint32_t poolIndex, uint32_t pageIndex) const
+            {
+                // Page size is over sub-allocation threshold, so it gets committed resource.
+                const auto description = GpuResourceDescription::Buffer(static_cast<uint32_t>(PageSize), pool.bindFlags);
+
+                Page page;
+                page.resource = std::make_unique<ResourceImpl>(deviceContext_);
+                page.resource->Init(description, pool.cpuAccess, fmt::sprintf("Buffer pool %u page %u", poolIndex, pageIndex));
+                page.freeRanges.push_back({ 0, PageSize });
+
+                return page;
+            }
+        }
+    }
+}
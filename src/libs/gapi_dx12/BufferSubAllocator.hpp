@@ -0,0 +1,104 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+#include "common/threading/SpinLock.hpp"
+
+#include <deque>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class CommandQueueImpl;
+            class DeviceContext;
+            class FenceImpl;
+            class ResourceImpl;
+
+            // Small buffers are offset ranges of large pooled buffers, one pool per bind flags and cpu access.
+            // Committed resources are at least 64KB, so this saves memory and creation cost for constant sized data.
+            // Released ranges are reused once GPU completed the frame they were released at.
+            class BufferSubAllocator final : private NonCopyable
+            {
+            public:
+                struct Allocation
+                {
+                    ComSharedPtr<ID3D12Resource> resource;
+                    uint64_t offset = 0;
+                    uint64_t size = 0;
+                    // Allocation begin in persistently mapped page, null unless page is GpuUpload.
+                    void* mappedData = nullptr;
+                    uint32_t poolIndex = 0;
+                    uint32_t pageIndex = 0;
+
+                    inline bool IsValid() const { return resource != nullptr; }
+                };
+
+                BufferSubAllocator(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~BufferSubAllocator();
+
+                void Init();
+                void Terminate();
+
+                // Views address sub-allocated buffer in whole elements from the pooled buffer begin,
+                // so element size should divide allocation alignment.
+                static bool IsSuitable(const GpuResourceDescription& description);
+
+                Allocation Allocate(const GpuResourceDescription& description, GpuResourceCpuAccess cpuAccess);
+                void Release(Allocation& allocation);
+
+                void MoveToNextFrame(CommandQueueImpl& queue);
+
+            private:
+                static constexpr uint64_t PageSize = 4 * 1024 * 1024;
+                static constexpr uint64_t MaxAllocationSize = 64 * 1024;
+                // Satisfies constant buffer placement, so any element size up to 256 bytes lands on element boundary.
+                static constexpr uint64_t Alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+                struct Range
+                {
+                    uint64_t offset;
+                    uint64_t size;
+                };
+
+                struct Page
+                {
+                    std::unique_ptr<ResourceImpl> resource;
+                    // Sorted by offset, adjacent ranges are merged.
+                    std::vector<Range> freeRanges;
+                };
+
+                struct Pool
+                {
+                    GpuResourceBindFlags bindFlags;
+                    GpuResourceCpuAccess cpuAccess;
+                    std::vector<Page> pages;
+                };
+
+                struct RetiredRange
+                {
+                    uint32_t poolIndex;
+                    uint32_t pageIndex;
+                    Range range;
+                    uint64_t fenceValue;
+                };
+
+                void reclaimRetiredRanges();
+                uint32_t getPoolIndex(GpuResourceBindFlags bindFlags, GpuResourceCpuAccess cpuAccess);
+                bool tryAllocate(Page& page, uint64_t size, uint64_t& offset) const;
+                void freeRange(Page& page, const Range& range) const;
+                Page createPage(const Pool& pool, uint32_t poolIndex, uint32_t pageIndex) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                std::unique_ptr<FenceImpl> fence_;
+                std::vector<Pool> pools_;
+                std::deque<RetiredRange> retiredRanges_;
+                Threading::SpinLock spinlock_;
+            };
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include "CommandAllocatorPool.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                // Upper bounds of work commands in recordings of size classes, the last class is unbounded.
+                constexpr std::array<uint32_t, CommandAllocatorPool::SizeClassesCount - 1> SizeClassLimits = { 256, 2048, 16384 };
+
+                // Every list submission acquires one allocator, so that's on the order of a hundred frames.
+                constexpr uint64_t TrimAfterAcquires = 2048;
+
+                const char* getListTypeName(D3D12_COMMAND_LIST_TYPE type)
+                {
+                    switch (type)
+                    {
+                        case D3D12_COMMAND_LIST_TYPE_DIRECT: return "Direct";
+                        case D3D12_COMMAND_LIST_TYPE_BUNDLE: return "Bundle";
+                        case D3D12_COMMAND_LIST_TYPE_COMPUTE: return "Compute";
+                        case D3D12_COMMAND_LIST_TYPE_COPY: return "Copy";
+                        default: LOG_FATAL("Unsupported command list type");
+                    }
+
+                    return "";
+                }
+            }
+
+            CommandAllocatorPool::~CommandAllocatorPool()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void CommandAllocatorPool::Init()
+            {
+                ASSERT(!isInited_);
+
+                isInited_ = true;
+            }
+
+            void CommandAllocatorPool::Terminate()
+            {
+                ASSERT(isInited_);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                for (auto& typeBuckets : buckets_)
+                    for (auto& bucket : typeBuckets)
+                        bucket.allocators.Drain([](ComSharedPtr<ID3D12CommandAllocator>&& allocator) {
+                            deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(allocator);
+                        });
+
+                fences_.clear();
+                isInited_ = false;
+            }
+
+            uint32_t CommandAllocatorPool::GetSizeClass(uint32_t workCommandsCount)
+            {
+                const auto it = std::upper_bound(SizeClassLimits.begin(), SizeClassLimits.end(), workCommandsCount);
+                return static_cast<uint32_t>(std::distance(SizeClassLimits.begin(), it));
+            }
+
+            CommandAllocatorPool::Bucket& CommandAllocatorPool::getBucket(D3D12_COMMAND_LIST_TYPE type, uint32_t sizeClass)
+            {
+                ASSERT(static_cast<uint32_t>(type) < ListTypesCount);
+                ASSERT(sizeClass < SizeClassesCount);
+
+                return buckets_[static_cast<uint32_t>(type)][sizeClass];
+            }
+
+            CommandAllocatorPool::Allocator CommandAllocatorPool::Acquire(D3D12_COMMAND_LIST_TYPE type, uint32_t sizeClass)
+            {
+                ASSERT(isInited_);
+                ASSERT(sizeClass < SizeClassesCount);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                acquiresCount_++;
+                getBucket(type, sizeClass).lastAcquire = acquiresCount_;
+
+                Allocator result;
+                const auto tryAcquire = [this, type, &result](uint32_t candidate) {
+                    if (auto allocator = getBucket(type, candidate).allocators.TryAcquire())
+                        result = { std::move(*allocator), candidate };
+
+                    return result.allocator != nullptr;
+                };
+
+                // Requested class first, then smaller ones growing into it, then larger ones.
+                bool isFound = false;
+                for (uint32_t candidate = sizeClass + 1; candidate-- > 0 && !isFound;)
+                    isFound = tryAcquire(candidate);
+
+                for (uint32_t candidate = sizeClass + 1; candidate < SizeClassesCount && !isFound; candidate++)
+                    isFound = tryAcquire(candidate);
+
+                if (!isFound)
+                {
+                    D3DCall(deviceContext_.GetDevice()->CreateCommandAllocator(type, IID_PPV_ARGS(result.allocator.put())));
+                    D3DUtils::SetAPIName(result.allocator.get(), "CommandAllocator_%s_%03d", getListTypeName(type), createdCount_++);
+                }
+
+                if (acquiresCount_ % TrimAfterAcquires == 0)
+                    trimIdleBuckets();
+
+                lock.unlock();
+
+                D3DCall(result.allocator->Reset());
+                result.sizeClass = std::max(result.sizeClass, sizeClass);
+
+                return result;
+            }
+
+            void CommandAllocatorPool::Release(D3D12_COMMAND_LIST_TYPE type, Allocator&& allocator, uint32_t workCommandsCount,
+                                               const std::shared_ptr<FenceImpl>& fence, uint64_t fenceValue)
+            {
+                ASSERT(isInited_);
+                ASSERT(allocator.allocator);
+                ASSERT(fence);
+
+                const auto sizeClass = std::max(allocator.sizeClass, GetSizeClass(workCommandsCount));
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                if (std::find(fences_.begin(), fences_.end(), fence) == fences_.end())
+                    fences_.push_back(fence);
+
+                getBucket(type, sizeClass).allocators.Release(std::move(allocator.allocator), *fence, fenceValue);
+            }
+
+            void CommandAllocatorPool::Discard(Allocator&& allocator)
+            {
+                if (allocator.allocator)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(allocator.allocator);
+            }
+
+            void CommandAllocatorPool::trimIdleBuckets()
+            {
+                for (auto& typeBuckets : buckets_)
+                    for (auto& bucket : typeBuckets)
+                    {
+                        if (acquiresCount_ - bucket.lastAcquire < TrimAfterAcquires)
+                            continue;
+
+                        // Allocators still executed by GPU stay, they are trimmed next time.
+                        while (auto allocator = bucket.allocators.TryAcquire())
+                            deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(*allocator);
+                    }
+            }
+        }
+    }
+}
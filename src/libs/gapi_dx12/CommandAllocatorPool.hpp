@@ -0,0 +1,77 @@
+#pragma once
+
+#include "gapi/FencedPool.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+            class FenceImpl;
+
+            // Command allocators shared by all command lists of the device. Allocator keeps the memory of its largest
+            // recording, so free allocators are bucketed by list type and size class of the largest recording they held.
+            // List checks out allocator of the class it recorded last time and returns it on submit, allocator is handed
+            // out again once the queue fence passes. Buckets not asked for a while are released, so a list that once
+            // recorded a huge pass doesn't pin that memory forever and rarely used lists don't hold spare allocators.
+            class CommandAllocatorPool final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t SizeClassesCount = 4;
+
+                struct Allocator
+                {
+                    ComSharedPtr<ID3D12CommandAllocator> allocator;
+                    uint32_t sizeClass = 0;
+                };
+
+            public:
+                CommandAllocatorPool(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~CommandAllocatorPool();
+
+                void Init();
+                void Terminate();
+
+                // Size class of recording with that many work commands, see CommandList::GetWorkCommandsCount.
+                static uint32_t GetSizeClass(uint32_t workCommandsCount);
+
+                // Any thread. Returned allocator is reset. Without free allocator of the class a smaller one is preferred,
+                // it grows into the class, then a larger one, then a new one is created.
+                Allocator Acquire(D3D12_COMMAND_LIST_TYPE type, uint32_t sizeClass);
+                // Any thread. Allocator is free once fence reached fenceValue, it's filed under the largest class it recorded.
+                void Release(D3D12_COMMAND_LIST_TYPE type, Allocator&& allocator, uint32_t workCommandsCount,
+                             const std::shared_ptr<FenceImpl>& fence, uint64_t fenceValue);
+                // Allocator of never submitted recording, e.g. of destroyed command list. Released deferred, not reused.
+                void Discard(Allocator&& allocator);
+
+            private:
+                static constexpr uint32_t ListTypesCount = 4;
+
+                struct Bucket
+                {
+                    FencedPool<ComSharedPtr<ID3D12CommandAllocator>> allocators;
+                    // Value of acquiresCount_ when allocator of the class was last asked for.
+                    uint64_t lastAcquire = 0;
+                };
+
+                Bucket& getBucket(D3D12_COMMAND_LIST_TYPE type, uint32_t sizeClass);
+                void trimIdleBuckets();
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+
+                Threading::Mutex mutex_;
+                std::array<std::array<Bucket, SizeClassesCount>, ListTypesCount> buckets_;
+                // Signaled fences referenced by pending allocators, they could outlive their queues.
+                std::vector<std::shared_ptr<FenceImpl>> fences_;
+                uint64_t acquiresCount_ = 0;
+                uint32_t createdCount_ = 0;
+            };
+        }
+    }
+}
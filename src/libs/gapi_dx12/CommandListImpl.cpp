@@ -1,15 +1,33 @@
 #include "CommandListImpl.hpp"
 
+#include "gapi/Buffer.hpp"
 #include "gapi/GpuResource.hpp"
 #include "gapi/GpuResourceViews.hpp"
 #include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/QueryPool.hpp"
+#include "gapi/Texture.hpp"
 
+#include "gapi_dx12/BindlessDescriptorHeap.hpp"
 #include "gapi_dx12/CpuResourceDataAllocator.hpp"
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/IndirectCommandSignatures.hpp"
+#include "gapi_dx12/MipGenerator.hpp"
+#include "gapi_dx12/PipelineStateImpl.hpp"
+#include "gapi_dx12/QueryPoolImpl.hpp"
+#include "gapi_dx12/ResourceCreator.hpp"
 #include "gapi_dx12/ResourceImpl.hpp"
 #include "gapi_dx12/ResourceReleaseContext.hpp"
 #include "gapi_dx12/ResourceViewsImpl.hpp"
+#include "gapi_dx12/SamplerDescriptorHeap.hpp"
+#include "gapi_dx12/TimestampQueryPool.hpp"
+
+#include "common/Math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
 
 namespace RR
 {
@@ -26,65 +44,102 @@ namespace RR
 
                     // Allow copy (gpu->gpu || cpuWrite->gpu)
                     ASSERT(source->GetCpuAccess() == GpuResourceCpuAccess::Write ||
+                           source->GetCpuAccess() == GpuResourceCpuAccess::GpuUpload ||
                            source->GetCpuAccess() == GpuResourceCpuAccess::None);
                     ASSERT(dest->GetCpuAccess() == GpuResourceCpuAccess::None);
                 }
-            }
 
-            void CommandListImpl::CommandAllocatorsPool::createAllocator(
-                const U8String& name,
-                const uint32_t index,
-                ComSharedPtr<ID3D12CommandAllocator>& allocator) const
-            {
-                ASSERT(!allocator);
+                bool isWriteState(D3D12_RESOURCE_STATES state)
+                {
+                    const auto writeStates = D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_UNORDERED_ACCESS |
+                                                 D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE |
+                                                 D3D12_RESOURCE_STATE_RESOLVE_DEST;
 
-                D3DCall(DeviceContext::GetDevice()->CreateCommandAllocator(type_, IID_PPV_ARGS(allocator.put())));
+                    return (state & writeStates) != 0;
+                }
 
-                D3DUtils::SetAPIName(allocator.get(), name, index);
-            }
+                D3D12_SHADING_RATE getD3DShadingRate(ShadingRate rate)
+                {
+                    static constexpr D3D12_SHADING_RATE rates[] = {
+                        D3D12_SHADING_RATE_1X1,
+                        D3D12_SHADING_RATE_1X2,
+                        D3D12_SHADING_RATE_2X1,
+                        D3D12_SHADING_RATE_2X2,
+                        D3D12_SHADING_RATE_2X4,
+                        D3D12_SHADING_RATE_4X2,
+                        D3D12_SHADING_RATE_4X4,
+                    };
+                    static_assert(std::size(rates) == static_cast<size_t>(ShadingRate::Count));
+
+                    return rates[static_cast<size_t>(rate)];
+                }
 
-            CommandListImpl::CommandAllocatorsPool::~CommandAllocatorsPool()
-            {
-                for (auto& allocatorData : allocators_)
-                    ResourceReleaseContext::DeferredD3DResourceRelease(allocatorData.allocator);
-            }
+                D3D12_SHADING_RATE_COMBINER getD3DShadingRateCombiner(ShadingRateCombiner combiner)
+                {
+                    switch (combiner)
+                    {
+                        case ShadingRateCombiner::Passthrough: return D3D12_SHADING_RATE_COMBINER_PASSTHROUGH;
+                        case ShadingRateCombiner::Override: return D3D12_SHADING_RATE_COMBINER_OVERRIDE;
+                        case ShadingRateCombiner::Min: return D3D12_SHADING_RATE_COMBINER_MIN;
+                        case ShadingRateCombiner::Max: return D3D12_SHADING_RATE_COMBINER_MAX;
+                        case ShadingRateCombiner::Sum: return D3D12_SHADING_RATE_COMBINER_SUM;
+                    }
 
-            void CommandListImpl::CommandAllocatorsPool::Init(
-                D3D12_COMMAND_LIST_TYPE type,
-                const U8String& name)
-            {
-                type_ = type;
-                fence_ = std::make_unique<FenceImpl>();
-                fence_->Init(name);
+                    ASSERT_MSG(false, "Unknown shading rate combiner");
+                    return D3D12_SHADING_RATE_COMBINER_PASSTHROUGH;
+                }
 
-                for (uint32_t index = 0; index < allocators_.size(); index++)
+                D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE getD3DBeginningAccess(AttachmentLoadOp loadOp)
                 {
-                    auto& allocatorData = allocators_[index];
-                    createAllocator(name, index, allocatorData.allocator);
-                    allocatorData.cpuFenceValue = 0;
-                }
-            }
+                    switch (loadOp)
+                    {
+                        case AttachmentLoadOp::Load: return D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_PRESERVE;
+                        case AttachmentLoadOp::Clear: return D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR;
+                        case AttachmentLoadOp::Discard: return D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD;
+                    }
 
-            const ComSharedPtr<ID3D12CommandAllocator>& CommandListImpl::CommandAllocatorsPool::GetNextAllocator()
-            {
-                auto& data = allocators_[ringBufferIndex_];
+                    ASSERT_MSG(false, "Unknown attachment load op");
+                    return D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_PRESERVE;
+                }
 
-                auto gpu = fence_->GetGpuValue();
+                D3D12_RENDER_PASS_ENDING_ACCESS_TYPE getD3DEndingAccess(AttachmentStoreOp storeOp)
+                {
+                    switch (storeOp)
+                    {
+                        case AttachmentStoreOp::Store: return D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_PRESERVE;
+                        case AttachmentStoreOp::Resolve: return D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_RESOLVE;
+                        case AttachmentStoreOp::Discard: return D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_DISCARD;
+                    }
 
-                ASSERT(data.cpuFenceValue < fence_->GetGpuValue());
-                data.cpuFenceValue = fence_->GetCpuValue();
-                data.allocator->Reset();
+                    ASSERT_MSG(false, "Unknown attachment store op");
+                    return D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_PRESERVE;
+                }
 
-                return data.allocator;
-            }
+                // Debug builds report clears which miss the fast path, once per resource.
+                void validateClearColor(GpuResource& resource, const float* color)
+                {
+#ifdef ENABLE_ASSERTS
+                    const auto& clearValue = resource.GetDescription().GetOptimizedClearValue();
+                    if (std::equal(clearValue.color.begin(), clearValue.color.end(), color))
+                        return;
+
+                    if (resource.GetPrivateImpl<ResourceImpl>()->ConsumeSlowClearWarning())
+                        LOG_WARNING("Clear color of %s doesn't match its optimized clear value, clear takes slow path", resource.GetName());
+#else
+                    std::ignore = resource;
+                    std::ignore = color;
+#endif
+                }
 
-            void CommandListImpl::CommandAllocatorsPool::ResetAfterSubmit(CommandQueueImpl& commandQueue)
-            {
-                ringBufferIndex_ = (++ringBufferIndex_ % AllocatorsCount);
-                return fence_->Signal(commandQueue);
+                uint32_t getSubresourceIndex(const RenderTargetView& renderTargetView, const GpuResourceDescription& description)
+                {
+                    const auto& viewDescription = renderTargetView.GetDescription();
+                    return description.GetSubresourceIndex(viewDescription.texture.firstArraySlice, viewDescription.texture.mipLevel, 0);
+                }
             }
 
-            CommandListImpl::CommandListImpl(const CommandListType commandListType)
+            CommandListImpl::CommandListImpl(DeviceContext& deviceContext, const CommandListType commandListType)
+                : deviceContext_(deviceContext)
             {
                 switch (commandListType)
                 {
@@ -97,6 +152,9 @@ namespace RR
                     case CommandListType::Copy:
                         type_ = D3D12_COMMAND_LIST_TYPE_COPY;
                         break;
+                    case CommandListType::Bundle:
+                        type_ = D3D12_COMMAND_LIST_TYPE_BUNDLE;
+                        break;
                     default:
                         ASSERT_MSG(false, "Unsuported command list type");
                 }
@@ -104,28 +162,276 @@ namespace RR
 
             CommandListImpl::~CommandListImpl()
             {
-                ResourceReleaseContext::DeferredD3DResourceRelease(D3DCommandList_);
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DCommandList_);
+                deviceContext_.GetCommandAllocatorPool().Discard(std::move(allocator_));
+
+                for (auto& buffer : scratchBuffers_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(buffer.resource);
             }
 
             void CommandListImpl::Init(const U8String& name)
             {
                 ASSERT(!D3DCommandList_);
 
-                commandAllocatorsPool_.Init(type_, name);
-                const auto allocator = commandAllocatorsPool_.GetNextAllocator();
+                allocator_ = deviceContext_.GetCommandAllocatorPool().Acquire(type_, 0);
 
-                D3DCall(DeviceContext::GetDevice()->CreateCommandList(0, type_, allocator.get(), nullptr, IID_PPV_ARGS(D3DCommandList_.put())));
+                D3DCall(deviceContext_.GetDevice()->CreateCommandList(0, type_, allocator_.allocator.get(), nullptr, IID_PPV_ARGS(D3DCommandList_.put())));
 
                 D3DUtils::SetAPIName(D3DCommandList_.get(), name);
+
+                if (type_ == D3D12_COMMAND_LIST_TYPE_DIRECT)
+                {
+                    std::ignore = D3DCommandList_->QueryInterface(IID_PPV_ARGS(D3DCommandList4_.put()));
+                    std::ignore = D3DCommandList_->QueryInterface(IID_PPV_ARGS(D3DCommandList5_.put()));
+                }
+
+#ifdef ENABLE_ENHANCED_BARRIERS
+                // Bundles can't record barriers.
+                if (type_ != D3D12_COMMAND_LIST_TYPE_BUNDLE && deviceContext_.IsEnhancedBarriersSupported() &&
+                    SUCCEEDED(D3DCommandList_->QueryInterface(IID_PPV_ARGS(D3DCommandList7_.put()))))
+                    stateTracker_.EnableEnhancedBarriers();
+#endif
+
+                bindDescriptorHeaps();
+            }
+
+            void CommandListImpl::bindDescriptorHeaps()
+            {
+                ASSERT(D3DCommandList_);
+
+                // Copy lists can't have descriptor heaps bound.
+                if (type_ == D3D12_COMMAND_LIST_TYPE_COPY)
+                    return;
+
+                ID3D12DescriptorHeap* descriptorHeaps[] = {
+                    deviceContext_.GetBindlessDescriptorHeap().GetD3DObject().get(),
+                    deviceContext_.GetSamplerDescriptorHeap().GetD3DObject().get(),
+                };
+                D3DCommandList_->SetDescriptorHeaps(static_cast<UINT>(std::size(descriptorHeaps)), descriptorHeaps);
             }
 
-            void CommandListImpl::ResetAfterSubmit(CommandQueueImpl& commandQueue)
+            void CommandListImpl::setComputeRootSignature(ID3D12RootSignature* rootSignature)
             {
                 ASSERT(D3DCommandList_);
+                ASSERT(rootSignature);
 
-                commandAllocatorsPool_.ResetAfterSubmit(commandQueue);
-                const auto& allocator = commandAllocatorsPool_.GetNextAllocator();
-                D3DCall(D3DCommandList_->Reset(allocator.get(), nullptr));
+                if (computeRootSignature_ == rootSignature)
+                    return;
+
+                D3DCommandList_->SetComputeRootSignature(rootSignature);
+                computeRootSignature_ = rootSignature;
+            }
+
+            void CommandListImpl::setGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(rootSignature);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT || type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE);
+
+                if (graphicsRootSignature_ == rootSignature)
+                    return;
+
+                D3DCommandList_->SetGraphicsRootSignature(rootSignature);
+                graphicsRootSignature_ = rootSignature;
+            }
+
+            void CommandListImpl::setPipelineState(ID3D12PipelineState* pipelineState)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(pipelineState);
+
+                if (pipelineState_ == pipelineState)
+                    return;
+
+                D3DCommandList_->SetPipelineState(pipelineState);
+                pipelineState_ = pipelineState;
+            }
+
+            void CommandListImpl::ResetAfterSubmit(uint32_t workCommandsCount, const std::shared_ptr<FenceImpl>& fence, uint64_t fenceValue)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_BUNDLE);
+                ASSERT(pendingCopies_.empty());
+
+                for (const auto& page : ringPages_)
+                    page->AddSyncPoint(fence, fenceValue);
+                ringPages_.clear();
+
+                for (auto& buffer : scratchBuffers_)
+                {
+                    if (!buffer.isRecorded)
+                        continue;
+
+                    buffer.fence = fence;
+                    buffer.fenceValue = fenceValue;
+                    buffer.isRecorded = false;
+                }
+
+                stateTracker_.Reset();
+                markersStack_.clear();
+                isInRenderPass_ = false;
+                pendingResolves_.clear();
+                computeRootSignature_ = nullptr;
+                graphicsRootSignature_ = nullptr;
+                pipelineState_ = nullptr;
+                graphicsPipelineState_ = nullptr;
+                indirectCommandStride_ = 0;
+
+                // Next recording is expected to be about as large as this one.
+                auto& allocatorPool = deviceContext_.GetCommandAllocatorPool();
+                allocatorPool.Release(type_, std::move(allocator_), workCommandsCount, fence, fenceValue);
+                allocator_ = allocatorPool.Acquire(type_, CommandAllocatorPool::GetSizeClass(workCommandsCount));
+                D3DCall(D3DCommandList_->Reset(allocator_.allocator.get(), nullptr));
+
+                bindDescriptorHeaps();
+            }
+
+            void CommandListImpl::transitionResource(const std::shared_ptr<GpuResource>& resource, D3D12_RESOURCE_STATES state, uint32_t subresource)
+            {
+                ASSERT(resource);
+
+                // Upload and readback heap resources can't leave their initial state.
+                if (resource->GetCpuAccess() != GpuResourceCpuAccess::None)
+                {
+                    ASSERT(resource->GetCpuAccess() == GpuResourceCpuAccess::Read || !isWriteState(state));
+                    return;
+                }
+
+                if (type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE)
+                {
+                    ASSERT(subresource == ResourceStateTracker::AllSubresources);
+                    bundleResourceStates_.emplace_back(resource, state);
+                    return;
+                }
+
+                const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+
+                ASSERT_MSG(!resourceImpl->IsTransientExpired(), "Transient resource %s is used after heaps of its frame were recycled", resource->GetName());
+
+                const auto d3dResource = resourceImpl->GetD3DObject().get();
+
+                // Barriers are issued ahead of deferred copies, so resources they use keep their state until copies are issued.
+                if (isUsedByPendingCopy(d3dResource) && !stateTracker_.IsInState(d3dResource, state, subresource))
+                    flushCopies();
+
+                if (isWriteState(state))
+                    resourceImpl->MarkWritten();
+
+                stateTracker_.TransitionResource(d3dResource, resource->GetDescription().GetNumSubresources(), state, subresource);
+            }
+
+            void CommandListImpl::flushBarriers()
+            {
+                ASSERT(D3DCommandList_);
+
+#ifdef ENABLE_ENHANCED_BARRIERS
+                if (D3DCommandList7_)
+                    stateTracker_.FlushBarriers(D3DCommandList7_.get());
+                else
+#endif
+                    stateTracker_.FlushBarriers(D3DCommandList_.get());
+
+                for (const auto& copy : pendingCopies_)
+                {
+                    switch (copy.type)
+                    {
+                        case PendingCopy::Type::Resource:
+                            D3DCommandList_->CopyResource(copy.dest.pResource, copy.source.pResource);
+                            break;
+                        case PendingCopy::Type::BufferRegion:
+                            D3DCommandList_->CopyBufferRegion(copy.dest.pResource, copy.destOffset, copy.source.pResource, copy.sourceOffset, copy.numBytes);
+                            break;
+                        case PendingCopy::Type::TextureRegion:
+                            D3DCommandList_->CopyTextureRegion(&copy.dest, copy.destPoint.x, copy.destPoint.y, copy.destPoint.z, &copy.source,
+                                                               copy.hasSourceBox ? &copy.sourceBox : nullptr);
+                            break;
+                    }
+                }
+
+                pendingCopies_.clear();
+            }
+
+            void CommandListImpl::deferCopy(const PendingCopy& copy)
+            {
+                ASSERT(copy.dest.pResource);
+                ASSERT(copy.source.pResource);
+
+                pendingCopies_.push_back(copy);
+            }
+
+            void CommandListImpl::flushCopies()
+            {
+                if (!pendingCopies_.empty())
+                    flushBarriers();
+            }
+
+            bool CommandListImpl::isUsedByPendingCopy(ID3D12Resource* resource) const
+            {
+                return std::any_of(pendingCopies_.begin(), pendingCopies_.end(), [resource](const PendingCopy& copy) {
+                    return copy.dest.pResource == resource || copy.source.pResource == resource;
+                });
+            }
+
+            void CommandListImpl::trackRingPage(const std::shared_ptr<HeapRingAllocator::Page>& page)
+            {
+                // Dedicated heaps have no page, their lifetime is up to resource data owner.
+                if (!page)
+                    return;
+
+                // List uses a few pages, so duplicates are skipped with linear search.
+                if (std::find(ringPages_.begin(), ringPages_.end(), page) == ringPages_.end())
+                    ringPages_.push_back(page);
+            }
+
+            void CommandListImpl::writeTimestamp(uint32_t query)
+            {
+                ASSERT(D3DCommandList_);
+
+                // Timestamp measures copies recorded before it.
+                flushCopies();
+
+                const auto& queryPool = deviceContext_.GetTimestampQueryPool();
+                const auto queryHeap = queryPool.GetD3DObject().get();
+
+                D3DCommandList_->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, query);
+                D3DCommandList_->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, query, 1, queryPool.GetReadbackResource(), query * sizeof(uint64_t));
+            }
+
+            void CommandListImpl::BeginMarker(const U8String& name)
+            {
+                ASSERT(D3DCommandList_);
+
+                // Copy queue timestamps are optional feature and bundles can't have queries, markers are ignored.
+                if (type_ == D3D12_COMMAND_LIST_TYPE_COPY || type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE)
+                {
+                    markersStack_.push_back({});
+                    return;
+                }
+
+                const auto parent = markersStack_.empty() ? TimestampQueryPool::Marker() : markersStack_.back();
+                const auto marker = deviceContext_.GetTimestampQueryPool().BeginMarker(name, parent, static_cast<uint32_t>(markersStack_.size()));
+                markersStack_.push_back(marker);
+
+                if (marker.query != TimestampQueryPool::InvalidIndex)
+                    writeTimestamp(marker.query);
+            }
+
+            void CommandListImpl::EndMarker()
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT_MSG(!markersStack_.empty(), "EndMarker without BeginMarker");
+
+                const auto marker = markersStack_.back();
+                markersStack_.pop_back();
+
+                if (marker.index == TimestampQueryPool::InvalidIndex)
+                    return;
+
+                const auto query = deviceContext_.GetTimestampQueryPool().EndMarker(marker);
+
+                if (query != TimestampQueryPool::InvalidIndex)
+                    writeTimestamp(query);
             }
 
             // ---------------------------------------------------------------------------------------------
@@ -148,17 +454,18 @@ namespace RR
                 // Actually we can copy textures with different format with restrictions. So reconsider this assert
                 ASSERT(sourceDesc == destDesc);
 
-                /* // TODO ????????????
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(sourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
-
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(destImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-                D3DCommandList_->ResourceBarrier(1, &barrier);*/
+                // CopyResource would copy whole pooled resource.
+                if (sourceImpl->IsSubAllocated() || destImpl->IsSubAllocated())
+                    return copyBufferRegion(source, 0, dest, 0, sourceDesc.GetSize());
 
-                D3DCommandList_->CopyResource(destImpl->GetD3DObject().get(), sourceImpl->GetD3DObject().get());
+                transitionResource(source, D3D12_RESOURCE_STATE_COPY_SOURCE);
+                transitionResource(dest, D3D12_RESOURCE_STATE_COPY_DEST);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(destImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                PendingCopy copy = {};
+                copy.type = PendingCopy::Type::Resource;
+                copy.dest.pResource = destImpl->GetD3DObject().get();
+                copy.source.pResource = sourceImpl->GetD3DObject().get();
+                deferCopy(copy);
             }
 
             void CommandListImpl::CopyBufferRegion(const std::shared_ptr<Buffer>& sourceBuffer, uint32_t sourceOffset,
@@ -166,19 +473,103 @@ namespace RR
             {
                 CheckIsCopyAllowed(sourceBuffer, destBuffer);
 
-                const auto sourceImpl = sourceBuffer->GetPrivateImpl<ResourceImpl>();
+                copyBufferRegion(sourceBuffer, sourceOffset, destBuffer, destOffset, numBytes);
+            }
+
+            void CommandListImpl::copyBufferRegion(const std::shared_ptr<GpuResource>& source, uint64_t sourceOffset,
+                                                   const std::shared_ptr<GpuResource>& dest, uint64_t destOffset, uint64_t numBytes)
+            {
+                const auto sourceImpl = source->GetPrivateImpl<ResourceImpl>();
                 ASSERT(sourceImpl);
 
-                const auto destImpl = destBuffer->GetPrivateImpl<ResourceImpl>();
+                const auto destImpl = dest->GetPrivateImpl<ResourceImpl>();
                 ASSERT(destImpl);
 
-                D3DCommandList_->CopyBufferRegion(destImpl->GetD3DObject().get(), destOffset, sourceImpl->GetD3DObject().get(), sourceOffset, numBytes);
+                const auto sourceD3DResource = sourceImpl->GetD3DObject().get();
+                const auto destD3DResource = destImpl->GetD3DObject().get();
+                sourceOffset += sourceImpl->GetOffset();
+                destOffset += destImpl->GetOffset();
+
+                PendingCopy copy = {};
+                copy.type = PendingCopy::Type::BufferRegion;
+                copy.numBytes = numBytes;
+
+                if (sourceD3DResource != destD3DResource)
+                {
+                    transitionResource(source, D3D12_RESOURCE_STATE_COPY_SOURCE);
+                    transitionResource(dest, D3D12_RESOURCE_STATE_COPY_DEST);
+
+                    copy.dest.pResource = destD3DResource;
+                    copy.destOffset = destOffset;
+                    copy.source.pResource = sourceD3DResource;
+                    copy.sourceOffset = sourceOffset;
+                    deferCopy(copy);
+                    return;
+                }
+
+                // Buffers sub-allocated from the same pooled resource can't be copy source and dest at once, so data bounces through scratch buffer.
+                const auto scratch = acquireScratchBuffer(numBytes);
+
+                // Previous bounce reading scratch buffer has to be issued before its transition.
+                if (isUsedByPendingCopy(scratch))
+                    flushCopies();
+
+                transitionResource(source, D3D12_RESOURCE_STATE_COPY_SOURCE);
+                stateTracker_.TransitionResource(scratch, 1, D3D12_RESOURCE_STATE_COPY_DEST);
+
+                copy.dest.pResource = scratch;
+                copy.source.pResource = sourceD3DResource;
+                copy.sourceOffset = sourceOffset;
+                deferCopy(copy);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(destImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                // Scratch becomes copy source right away, copy into it has to be issued before its transition.
+                flushBarriers();
 
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(sourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                stateTracker_.TransitionResource(scratch, 1, D3D12_RESOURCE_STATE_COPY_SOURCE);
+                transitionResource(dest, D3D12_RESOURCE_STATE_COPY_DEST);
+
+                copy.dest.pResource = destD3DResource;
+                copy.destOffset = destOffset;
+                copy.source.pResource = scratch;
+                copy.sourceOffset = 0;
+                deferCopy(copy);
+            }
+
+            ID3D12Resource* CommandListImpl::acquireScratchBuffer(uint64_t size)
+            {
+                const auto isIdle = [](const ScratchBuffer& buffer) {
+                    return !buffer.isRecorded && (!buffer.fence || buffer.fence->GetGpuValue() >= buffer.fenceValue);
+                };
+
+                for (auto& buffer : scratchBuffers_)
+                {
+                    if (buffer.size >= size && (buffer.isRecorded || isIdle(buffer)))
+                    {
+                        buffer.isRecorded = true;
+                        return buffer.resource.get();
+                    }
+                }
+
+                // Idle buffers are too small, they are replaced by the new one.
+                scratchBuffers_.erase(std::remove_if(scratchBuffers_.begin(), scratchBuffers_.end(), [&isIdle](ScratchBuffer& buffer) {
+                    if (!isIdle(buffer))
+                        return false;
+
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(buffer.resource);
+                    return true;
+                }), scratchBuffers_.end());
+
+                ScratchBuffer buffer;
+                buffer.size = AlignTo(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+                buffer.isRecorded = true;
+
+                const auto scratchDesc = CD3DX12_RESOURCE_DESC::Buffer(buffer.size);
+                D3DCall(deviceContext_.GetDevice()->CreateCommittedResource(
+                    &DefaultHeapProps, D3D12_HEAP_FLAG_NONE, &scratchDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(buffer.resource.put())));
+                D3DUtils::SetAPIName(buffer.resource.get(), "CommandList scratch buffer");
+
+                scratchBuffers_.push_back(std::move(buffer));
+                return scratchBuffers_.back().resource.get();
             }
 
             void CommandListImpl::CopyTextureSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
@@ -192,12 +583,14 @@ namespace RR
                 const auto destImpl = destTexture->GetPrivateImpl<ResourceImpl>();
                 ASSERT(destImpl);
 
-                CD3DX12_TEXTURE_COPY_LOCATION dst(destImpl->GetD3DObject().get(), destSubresourceIdx);
-                CD3DX12_TEXTURE_COPY_LOCATION src(sourceImpl->GetD3DObject().get(), sourceSubresourceIdx);
-                D3DCommandList_->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+                transitionResource(sourceTexture, D3D12_RESOURCE_STATE_COPY_SOURCE, sourceSubresourceIdx);
+                transitionResource(destTexture, D3D12_RESOURCE_STATE_COPY_DEST, destSubresourceIdx);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(destImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                PendingCopy copy = {};
+                copy.type = PendingCopy::Type::TextureRegion;
+                copy.dest = CD3DX12_TEXTURE_COPY_LOCATION(destImpl->GetD3DObject().get(), destSubresourceIdx);
+                copy.source = CD3DX12_TEXTURE_COPY_LOCATION(sourceImpl->GetD3DObject().get(), sourceSubresourceIdx);
+                deferCopy(copy);
             }
 
             void CommandListImpl::CopyTextureSubresourceRegion(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx, const Box3u& sourceBox,
@@ -211,7 +604,15 @@ namespace RR
                 const auto destImpl = destTexture->GetPrivateImpl<ResourceImpl>();
                 ASSERT(destImpl);
 
-                const D3D12_BOX box = {
+                transitionResource(sourceTexture, D3D12_RESOURCE_STATE_COPY_SOURCE, sourceSubresourceIdx);
+                transitionResource(destTexture, D3D12_RESOURCE_STATE_COPY_DEST, destSubresourceIdx);
+
+                PendingCopy copy = {};
+                copy.type = PendingCopy::Type::TextureRegion;
+                copy.dest = CD3DX12_TEXTURE_COPY_LOCATION(destImpl->GetD3DObject().get(), destSubresourceIdx);
+                copy.source = CD3DX12_TEXTURE_COPY_LOCATION(sourceImpl->GetD3DObject().get(), sourceSubresourceIdx);
+                copy.destPoint = destPoint;
+                copy.sourceBox = {
                     sourceBox.left,
                     sourceBox.top,
                     sourceBox.front,
@@ -219,23 +620,15 @@ namespace RR
                     sourceBox.top + sourceBox.height,
                     sourceBox.front + sourceBox.depth,
                 };
-
-                CD3DX12_TEXTURE_COPY_LOCATION src(sourceImpl->GetD3DObject().get(), sourceSubresourceIdx);
-                CD3DX12_TEXTURE_COPY_LOCATION dst(destImpl->GetD3DObject().get(), destSubresourceIdx);
-                D3DCommandList_->CopyTextureRegion(&dst, destPoint.x, destPoint.y, destPoint.z, &src, &box);
-
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(destImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
-
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(sourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                copy.hasSourceBox = true;
+                deferCopy(copy);
             }
 
-            void CommandListImpl::copyIntermediate(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData, bool readback) const
+            void CommandListImpl::copyIntermediate(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData, bool readback)
             {
                 ASSERT(resource);
                 ASSERT(resourceData);
-                ASSERT(resource->GetDescription().GetNumSubresources() == resourceData->GetNumSubresources() - resourceData->GetFirstSubresource());
+                ASSERT(resourceData->GetFirstSubresource() + resourceData->GetNumSubresources() <= resource->GetDescription().GetNumSubresources());
                 // Todo add copy checks and move up to rendercontext;
 
                 const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
@@ -249,8 +642,10 @@ namespace RR
 
                 const auto isTextureResource = resource->IsTexture();
 
-                const auto& device = DeviceContext::GetDevice();
-                auto desc = d3dResource->GetDesc();
+                const auto& device = deviceContext_.GetDevice();
+                // Pooled resource of sub-allocated buffer is larger than the buffer.
+                auto desc = isTextureResource ? d3dResource->GetDesc() : D3DUtils::GetResourceDesc(resource->GetDescription());
+                const auto resourceOffset = resourceImpl->GetOffset();
 
                 static_assert(static_cast<int>(MemoryAllocationType::Count) == 3);
                 ASSERT(
@@ -272,7 +667,7 @@ namespace RR
                     // Alloc intermediate resource in upload/readback heap.
                     auto memoryType = readback ? MemoryAllocationType::Readback : MemoryAllocationType::Upload;
 
-                    CpuResourceData = CpuResourceDataAllocator::Alloc(
+                    CpuResourceData = deviceContext_.GetCpuResourceDataAllocator().Alloc(
                         resourceData->GetResourceDescription(),
                         memoryType,
                         resourceData->GetFirstSubresource(),
@@ -288,6 +683,8 @@ namespace RR
                     gpuHeapAlloc = allocation->GetPrivateImpl<HeapAllocation>();
                 }
 
+                trackRingPage(gpuHeapAlloc->GetPage());
+
                 intermediateDataOffset = gpuHeapAlloc->GetOffset();
                 intermediateResource = gpuHeapAlloc->GetD3DResouce();
 
@@ -300,6 +697,17 @@ namespace RR
                 device->GetCopyableFootprints(&desc, firstResource, numSubresources, intermediateDataOffset, &layouts[0], &numRowsVector[0], &rowSizeInBytesVector[0], &itermediateSize);
                 ASSERT(allocation->GetSize() == itermediateSize);
 
+                const auto copyState = readback ? D3D12_RESOURCE_STATE_COPY_SOURCE : D3D12_RESOURCE_STATE_COPY_DEST;
+                if (firstResource == 0 && numSubresources == resource->GetDescription().GetNumSubresources())
+                {
+                    transitionResource(resource, copyState);
+                }
+                else
+                {
+                    for (uint32_t index = 0; index < numSubresources; index++)
+                        transitionResource(resource, copyState, firstResource + index);
+                }
+
                 for (uint32_t index = 0; index < resourceData->GetNumSubresources(); index++)
                 {
                     const auto subresourceIndex = firstResource + index;
@@ -315,29 +723,28 @@ namespace RR
                     ASSERT(footprint.depthPitch == depthPitch);
                     ASSERT(footprint.rowPitch == layout.Footprint.RowPitch);
 
-                    D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(d3dResource.get(), D3D12_RESOURCE_STATE_COMMON, readback ? D3D12_RESOURCE_STATE_COPY_SOURCE : D3D12_RESOURCE_STATE_COPY_DEST);
-                    D3DCommandList_->ResourceBarrier(1, &barrier);
+                    PendingCopy copy = {};
 
                     if (isTextureResource)
                     {
-                        CD3DX12_TEXTURE_COPY_LOCATION resourceLocation(d3dResource.get(), subresourceIndex);
-                        CD3DX12_TEXTURE_COPY_LOCATION intermediateLocation(intermediateResource.get(), layout);
-
-                        const auto src = readback ? &resourceLocation : &intermediateLocation;
-                        const auto dst = readback ? &intermediateLocation : &resourceLocation;
+                        const CD3DX12_TEXTURE_COPY_LOCATION resourceLocation(d3dResource.get(), subresourceIndex);
+                        const CD3DX12_TEXTURE_COPY_LOCATION intermediateLocation(intermediateResource.get(), layout);
 
-                        D3DCommandList_->CopyTextureRegion(dst, 0, 0, 0, src, nullptr);
+                        copy.type = PendingCopy::Type::TextureRegion;
+                        copy.source = readback ? resourceLocation : intermediateLocation;
+                        copy.dest = readback ? intermediateLocation : resourceLocation;
                     }
                     else
                     {
-                        const auto src = readback ? d3dResource.get() : intermediateResource.get();
-                        const auto dst = readback ? intermediateResource.get() : d3dResource.get();
-
-                        D3DCommandList_->CopyBufferRegion(dst, 0, src, 0, rowSizeInBytes);
+                        copy.type = PendingCopy::Type::BufferRegion;
+                        copy.source.pResource = readback ? d3dResource.get() : intermediateResource.get();
+                        copy.dest.pResource = readback ? intermediateResource.get() : d3dResource.get();
+                        copy.sourceOffset = readback ? resourceOffset : layout.Offset;
+                        copy.destOffset = readback ? layout.Offset : resourceOffset;
+                        copy.numBytes = rowSizeInBytes;
                     }
 
-                    barrier = CD3DX12_RESOURCE_BARRIER::Transition(d3dResource.get(), readback ? D3D12_RESOURCE_STATE_COPY_SOURCE : D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
-                    D3DCommandList_->ResourceBarrier(1, &barrier);
+                    deferCopy(copy);
                 }
             }
 
@@ -346,6 +753,68 @@ namespace RR
                 copyIntermediate(resource, resourceData, false);
             }
 
+            void CommandListImpl::UpdateBuffers(const BufferUpdate* updates, uint32_t count)
+            {
+                ASSERT(updates);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_BUNDLE);
+
+                // Copies into the same D3D resource go back to back. Sort is stable, so overlapping ranges keep call order.
+                std::vector<uint32_t> order(count);
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [updates](uint32_t lhs, uint32_t rhs) {
+                    return updates[lhs].buffer->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get() <
+                           updates[rhs].buffer->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get();
+                });
+
+                for (uint32_t index = 0; index < count; index++)
+                    transitionResource(updates[order[index]].buffer, D3D12_RESOURCE_STATE_COPY_DEST);
+
+                // Payloads are packed into single upload range, unless they don't fit into one ring page.
+                constexpr size_t payloadAlignment = D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT;
+                uint32_t first = 0;
+                while (first < count)
+                {
+                    size_t packedSize = 0;
+                    uint32_t last = first;
+                    for (; last < count; last++)
+                    {
+                        const auto alignedSize = AlignTo(static_cast<size_t>(updates[order[last]].size), payloadAlignment);
+                        if (packedSize + alignedSize > CpuResourceDataAllocator::UploadPageSize)
+                            break;
+
+                        packedSize += alignedSize;
+                    }
+                    // Single update larger than ring page should go through UpdateGpuResource.
+                    ASSERT(last > first);
+
+                    const auto allocation = deviceContext_.GetCpuResourceDataAllocator().AllocateUpload(packedSize);
+                    trackRingPage(allocation.page);
+                    const auto uploadD3DResource = allocation.page->resource->GetD3DObject().get();
+                    auto uploadOffset = allocation.offset;
+
+                    for (uint32_t index = first; index < last; index++)
+                    {
+                        const auto& update = updates[order[index]];
+                        memcpy(allocation.page->cpuData + uploadOffset, update.data, update.size);
+
+                        const auto destImpl = update.buffer->GetPrivateImpl<ResourceImpl>();
+
+                        PendingCopy copy = {};
+                        copy.type = PendingCopy::Type::BufferRegion;
+                        copy.dest.pResource = destImpl->GetD3DObject().get();
+                        copy.destOffset = destImpl->GetOffset() + update.offset;
+                        copy.source.pResource = uploadD3DResource;
+                        copy.sourceOffset = uploadOffset;
+                        copy.numBytes = update.size;
+                        deferCopy(copy);
+
+                        uploadOffset += AlignTo(static_cast<size_t>(update.size), payloadAlignment);
+                    }
+
+                    first = last;
+                }
+            }
+
             void CommandListImpl::ReadbackGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData)
             {
                 copyIntermediate(resource, resourceData, true);
@@ -368,13 +837,10 @@ namespace RR
                 const auto resourceViewImpl = unorderedAcessView->GetPrivateImpl<DescriptorHeap::Allocation>();
                 ASSERT(resourceViewImpl);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                transitionResource(resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                flushBarriers();
 
                 D3DCommandList_->ClearUnorderedAccessViewUint(resourceViewImpl->GetGPUHandle(), resourceViewImpl->GetCPUHandle(), resourceImpl->GetD3DObject().get(), &clearValue.x, 0, nullptr);
-
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
             }
 
             void CommandListImpl::ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue)
@@ -390,13 +856,193 @@ namespace RR
                 const auto resourceViewImpl = unorderedAcessView->GetPrivateImpl<DescriptorHeap::Allocation>();
                 ASSERT(resourceViewImpl);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                transitionResource(resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                flushBarriers();
 
                 D3DCommandList_->ClearUnorderedAccessViewFloat(resourceViewImpl->GetGPUHandle(), resourceViewImpl->GetCPUHandle(), resourceImpl->GetD3DObject().get(), &clearValue.x, 0, nullptr);
+            }
+
+            void CommandListImpl::GenerateMips(const std::shared_ptr<Texture>& texture)
+            {
+                ASSERT(texture);
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+
+                const auto& description = texture->GetDescription();
+                ASSERT(description.GetDimension() == GpuResourceDimension::Texture2D);
+                ASSERT(description.GetArraySize() == 1);
+                ASSERT(IsSet(description.GetBindFlags(), GpuResourceBindFlags::ShaderResource | GpuResourceBindFlags::UnorderedAccess));
+                // Block compressed formats have no typed UAV stores.
+                ASSERT(!GpuResourceFormatInfo::IsCompressed(description.GetFormat()));
+
+                const auto& mipGenerator = deviceContext_.GetMipGenerator();
+                if (!mipGenerator.IsAvailable() || description.GetMipCount() < 2)
+                    return;
+
+                const auto heapStart = deviceContext_.GetBindlessDescriptorHeap().GetGpuHandle(0);
+
+                setComputeRootSignature(mipGenerator.GetRootSignature().get());
+                setPipelineState(mipGenerator.GetPipelineState().get());
+                D3DCommandList_->SetComputeRootDescriptorTable(MipGenerator::RootParameter::Textures, heapStart);
+                D3DCommandList_->SetComputeRootDescriptorTable(MipGenerator::RootParameter::RWTextures, heapStart);
+
+                for (uint32_t sourceMip = 0; sourceMip + 1 < description.GetMipCount();)
+                {
+                    const uint32_t mipsCount = Min(MipGenerator::MaxMipsPerDispatch, description.GetMipCount() - sourceMip - 1);
+                    const uint32_t destWidth = description.GetWidth(sourceMip + 1);
+                    const uint32_t destHeight = description.GetHeight(sourceMip + 1);
+
+                    MipGenerator::DispatchConstants constants = {};
+                    constants.sourceIndex = texture->GetSRV(sourceMip, 1)->GetBindlessIndex();
+                    constants.mipsCount = mipsCount;
+                    constants.texelSize[0] = 1.0f / destWidth;
+                    constants.texelSize[1] = 1.0f / destHeight;
+
+                    transitionResource(texture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, description.GetSubresourceIndex(0, sourceMip, 0));
+                    for (uint32_t index = 0; index < MipGenerator::MaxMipsPerDispatch; index++)
+                    {
+                        // Unused slots alias last written mip, shader never stores to them.
+                        const uint32_t destMip = sourceMip + 1 + Min(index, mipsCount - 1);
+                        constants.destIndices[index] = texture->GetUAV(destMip)->GetBindlessIndex();
+
+                        if (index < mipsCount)
+                            transitionResource(texture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, description.GetSubresourceIndex(0, destMip, 0));
+                    }
+                    flushBarriers();
+
+                    D3DCommandList_->SetComputeRoot32BitConstants(MipGenerator::RootParameter::Constants, sizeof(constants) / sizeof(uint32_t), &constants, 0);
+                    D3DCommandList_->Dispatch(Max(1u, (destWidth + MipGenerator::ThreadGroupSize - 1) / MipGenerator::ThreadGroupSize),
+                                              Max(1u, (destHeight + MipGenerator::ThreadGroupSize - 1) / MipGenerator::ThreadGroupSize), 1);
+
+                    sourceMip += mipsCount;
+                }
+            }
+
+            uint64_t CommandListImpl::AllocateConstants(const void* data, size_t size)
+            {
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+
+                const auto allocation = deviceContext_.GetCpuResourceDataAllocator().AllocateConstants(data, size);
+                trackRingPage(allocation.page);
+
+                return allocation.page->resource->GetD3DObject()->GetGPUVirtualAddress() + allocation.offset;
+            }
+
+            void CommandListImpl::SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+                ASSERT(IsAlignedTo(gpuVirtualAddress, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
+
+                D3DCommandList_->SetComputeRootConstantBufferView(rootParameterIndex, gpuVirtualAddress);
+            }
+
+            void CommandListImpl::SetComputePipelineState(const PipelineState& pipelineState)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+                ASSERT(pipelineState.GetDescription().type == PipelineStateType::Compute);
 
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                const auto pipelineStateImpl = pipelineState.GetPrivateImpl<PipelineStateImpl>();
+                ASSERT(pipelineStateImpl);
+
+                setComputeRootSignature(pipelineStateImpl->GetRootSignature().get());
+                setPipelineState(pipelineStateImpl->GetD3DObject().get());
+            }
+
+            void CommandListImpl::SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(computeRootSignature_);
+
+                D3DCommandList_->SetComputeRootDescriptorTable(rootParameterIndex, deviceContext_.GetBindlessDescriptorHeap().GetGpuHandle(bindlessIndex));
+            }
+
+            void CommandListImpl::TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView)
+            {
+                ASSERT(shaderResourceView);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+
+                const auto& resource = shaderResourceView->GetGpuResource().lock();
+                ASSERT(resource);
+
+                // Graphics lists don't know which stages read the view.
+                const auto state = type_ == D3D12_COMMAND_LIST_TYPE_DIRECT ? D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE : D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+                transitionResource(resource, state);
+            }
+
+            void CommandListImpl::BeginTransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView)
+            {
+                ASSERT(shaderResourceView);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+
+                const auto& resource = shaderResourceView->GetGpuResource().lock();
+                ASSERT(resource);
+
+                // Bundles only declare states, there is nothing to split.
+                if (type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE)
+                    return;
+
+                const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+
+                const auto state = type_ == D3D12_COMMAND_LIST_TYPE_DIRECT ? D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE : D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+                // Begin is issued right away, copies into the resource go first.
+                flushCopies();
+
+                stateTracker_.BeginTransition(resourceImpl->GetD3DObject().get(), resource->GetDescription().GetNumSubresources(), state);
+
+                // Begin is issued right away, so the following work overlaps with it.
+                flushBarriers();
+            }
+
+            void CommandListImpl::TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView)
+            {
+                ASSERT(unorderedAcessView);
+                ASSERT(type_ != D3D12_COMMAND_LIST_TYPE_COPY);
+
+                const auto& resource = unorderedAcessView->GetGpuResource().lock();
+                ASSERT(resource);
+
+                transitionResource(resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            }
+
+            void CommandListImpl::UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource)
+            {
+                ASSERT(resource);
+
+                const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+
+                stateTracker_.UnorderedAccessBarrier(resourceImpl->GetD3DObject().get());
+            }
+
+            void CommandListImpl::Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(pipelineState_);
+
+                flushBarriers();
+                D3DCommandList_->Dispatch(threadGroupCountX, threadGroupCountY, threadGroupCountZ);
+            }
+
+            void CommandListImpl::DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(argumentBuffer);
+                ASSERT(pipelineState_);
+
+                const auto argumentBufferImpl = argumentBuffer->GetPrivateImpl<ResourceImpl>();
+                ASSERT(argumentBufferImpl);
+
+                transitionResource(argumentBuffer, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                flushBarriers();
+
+                // Sub-allocated buffers are shifted to their range of pooled resource.
+                D3DCommandList_->ExecuteIndirect(deviceContext_.GetIndirectCommandSignatures().GetDispatch().get(), 1,
+                                                 argumentBufferImpl->GetD3DObject().get(), argumentBufferImpl->GetOffset() + argumentOffset,
+                                                 nullptr, 0);
             }
 
             // ---------------------------------------------------------------------------------------------
@@ -418,17 +1064,517 @@ namespace RR
                 const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
                 ASSERT(resourceImpl);
 
-                D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                validateClearColor(*resource, &color.x);
+
+                transitionResource(resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+                flushBarriers();
 
                 D3DCommandList_->ClearRenderTargetView(allocation->GetCPUHandle(), &color.x, 0, nullptr);
+            }
+
+            void CommandListImpl::BeginRenderPass(const RenderPassAttachment* attachments, uint32_t attachmentCount)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT(attachments);
+                ASSERT(attachmentCount > 0 && attachmentCount <= D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+                ASSERT_MSG(!isInRenderPass_, "Render passes can't be nested");
+
+                // Barriers aren't allowed inside the pass, so resolve targets are transitioned ahead too.
+                for (uint32_t index = 0; index < attachmentCount; index++)
+                {
+                    const auto& attachment = attachments[index];
+
+                    const auto& resource = attachment.renderTargetView->GetGpuResource().lock();
+                    ASSERT(resource);
+                    ASSERT(resource->IsTexture());
+
+                    if (attachment.loadOp == AttachmentLoadOp::Clear)
+                        validateClearColor(*resource, attachment.clearColor.data());
+
+                    transitionResource(resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+                    if (attachment.storeOp == AttachmentStoreOp::Resolve && D3DCommandList4_)
+                        transitionResource(attachment.resolveTarget, D3D12_RESOURCE_STATE_RESOLVE_DEST);
+                }
+                flushBarriers();
+
+                if (!D3DCommandList4_)
+                {
+                    // Discards are kept as loads and stores, contents are undefined either way.
+                    std::array<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> handles;
+
+                    for (uint32_t index = 0; index < attachmentCount; index++)
+                    {
+                        const auto& attachment = attachments[index];
+
+                        const auto allocation = attachment.renderTargetView->GetPrivateImpl<DescriptorHeap::Allocation>();
+                        ASSERT(allocation);
+                        handles[index] = allocation->GetCPUHandle();
+
+                        if (attachment.loadOp == AttachmentLoadOp::Clear)
+                            D3DCommandList_->ClearRenderTargetView(handles[index], attachment.clearColor.data(), 0, nullptr);
+
+                        if (attachment.storeOp == AttachmentStoreOp::Resolve)
+                            pendingResolves_.emplace_back(attachment.renderTargetView, attachment.resolveTarget);
+                    }
+
+                    D3DCommandList_->OMSetRenderTargets(attachmentCount, handles.data(), FALSE, nullptr);
+                }
+                else
+                {
+                    std::array<D3D12_RENDER_PASS_RENDER_TARGET_DESC, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> renderTargets;
+                    std::array<D3D12_RENDER_PASS_ENDING_ACCESS_RESOLVE_SUBRESOURCE_PARAMETERS, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> resolveSubresources;
+
+                    for (uint32_t index = 0; index < attachmentCount; index++)
+                    {
+                        const auto& attachment = attachments[index];
+                        const auto& renderTargetView = *attachment.renderTargetView;
+
+                        const auto allocation = renderTargetView.GetPrivateImpl<DescriptorHeap::Allocation>();
+                        ASSERT(allocation);
+
+                        const auto format = D3DUtils::GetDxgiResourceFormat(renderTargetView.GetDescription().format);
+
+                        auto& renderTarget = renderTargets[index];
+                        renderTarget = {};
+                        renderTarget.cpuDescriptor = allocation->GetCPUHandle();
+                        renderTarget.BeginningAccess.Type = getD3DBeginningAccess(attachment.loadOp);
+                        renderTarget.EndingAccess.Type = getD3DEndingAccess(attachment.storeOp);
+
+                        if (attachment.loadOp == AttachmentLoadOp::Clear)
+                        {
+                            renderTarget.BeginningAccess.Clear.ClearValue.Format = format;
+                            std::copy(attachment.clearColor.begin(), attachment.clearColor.end(), renderTarget.BeginningAccess.Clear.ClearValue.Color);
+                        }
+
+                        if (attachment.storeOp == AttachmentStoreOp::Resolve)
+                        {
+                            const auto& resource = renderTargetView.GetGpuResource().lock();
+                            const auto& description = resource->GetDescription();
+                            const auto mipLevel = renderTargetView.GetDescription().texture.mipLevel;
+
+                            auto& subresource = resolveSubresources[index];
+                            subresource.SrcSubresource = getSubresourceIndex(renderTargetView, description);
+                            subresource.DstSubresource = 0;
+                            subresource.DstX = 0;
+                            subresource.DstY = 0;
+                            subresource.SrcRect = CD3DX12_RECT(0, 0, static_cast<LONG>(description.GetWidth(mipLevel)), static_cast<LONG>(description.GetHeight(mipLevel)));
+
+                            auto& resolve = renderTarget.EndingAccess.Resolve;
+                            resolve.pSrcResource = resource->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get();
+                            resolve.pDstResource = attachment.resolveTarget->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get();
+                            resolve.SubresourceCount = 1;
+                            resolve.pSubresourceParameters = &subresource;
+                            resolve.Format = format;
+                            resolve.ResolveMode = D3D12_RESOLVE_MODE_AVERAGE;
+                            resolve.PreserveResolveSource = FALSE;
+                        }
+                    }
+
+                    D3DCommandList4_->BeginRenderPass(attachmentCount, renderTargets.data(), nullptr, D3D12_RENDER_PASS_FLAG_NONE);
+                }
+
+                setViewport(*attachments[0].renderTargetView);
+                isInRenderPass_ = true;
+            }
+
+            void CommandListImpl::EndRenderPass()
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT_MSG(isInRenderPass_, "No render pass to end");
+
+                isInRenderPass_ = false;
+
+                if (D3DCommandList4_)
+                {
+                    D3DCommandList4_->EndRenderPass();
+                    return;
+                }
+
+                if (pendingResolves_.empty())
+                    return;
+
+                for (const auto& [renderTargetView, resolveTarget] : pendingResolves_)
+                {
+                    transitionResource(renderTargetView->GetGpuResource().lock(), D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
+                    transitionResource(resolveTarget, D3D12_RESOURCE_STATE_RESOLVE_DEST);
+                }
+                flushBarriers();
+
+                for (const auto& [renderTargetView, resolveTarget] : pendingResolves_)
+                {
+                    const auto& resource = renderTargetView->GetGpuResource().lock();
+                    const auto format = D3DUtils::GetDxgiResourceFormat(renderTargetView->GetDescription().format);
+
+                    D3DCommandList_->ResolveSubresource(resolveTarget->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get(), 0,
+                                                        resource->GetPrivateImpl<ResourceImpl>()->GetD3DObject().get(),
+                                                        getSubresourceIndex(*renderTargetView, resource->GetDescription()), format);
+                }
+
+                pendingResolves_.clear();
+            }
+
+            void CommandListImpl::DiscardResource(const std::shared_ptr<GpuResource>& resource)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT(resource);
+                ASSERT_MSG(!isInRenderPass_, "Discard inside render pass, use discard load op instead");
+
+                const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+
+                // Discard needs render target, depth write or unordered access state, matching resource bindings.
+                const auto bindFlags = resource->GetDescription().GetBindFlags();
+                ASSERT_MSG(IsAny(bindFlags, GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil | GpuResourceBindFlags::UnorderedAccess),
+                           "Only render targets, depth stencils and UAVs could be discarded");
+
+                if (IsSet(bindFlags, GpuResourceBindFlags::RenderTarget))
+                    transitionResource(resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+                else if (IsSet(bindFlags, GpuResourceBindFlags::DepthStencil))
+                    transitionResource(resource, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+                else
+                    transitionResource(resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                flushBarriers();
+
+                D3DCommandList_->DiscardResource(resourceImpl->GetD3DObject().get(), nullptr);
+            }
+
+            void CommandListImpl::AliasingBarrier(const std::shared_ptr<GpuResource>& resource)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT(resource);
+
+                const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+                ASSERT_MSG(resourceImpl->IsTransient(), "Only transient resources share memory");
+                ASSERT_MSG(!resourceImpl->IsTransientExpired(), "Transient resource %s is used after heaps of its frame were recycled", resource->GetName());
+
+                // Barrier covers every resource in the memory, deferred copies of previous resources go first.
+                flushCopies();
+                stateTracker_.AliasResource(resourceImpl->GetD3DObject().get());
+            }
+
+            void CommandListImpl::ResolveSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                                     const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT_MSG(!isInRenderPass_, "Resolve inside render pass, use resolve store op instead");
+
+                const auto sourceImpl = sourceTexture->GetPrivateImpl<ResourceImpl>();
+                ASSERT(sourceImpl);
+
+                const auto destImpl = destTexture->GetPrivateImpl<ResourceImpl>();
+                ASSERT(destImpl);
+
+                transitionResource(sourceTexture, D3D12_RESOURCE_STATE_RESOLVE_SOURCE, sourceSubresourceIdx);
+                transitionResource(destTexture, D3D12_RESOURCE_STATE_RESOLVE_DEST, destSubresourceIdx);
+                flushBarriers();
+
+                const auto format = D3DUtils::GetDxgiResourceFormat(destTexture->GetDescription().GetFormat());
+                D3DCommandList_->ResolveSubresource(destImpl->GetD3DObject().get(), destSubresourceIdx,
+                                                    sourceImpl->GetD3DObject().get(), sourceSubresourceIdx, format);
+            }
+
+            void CommandListImpl::SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT(IsAlignedTo(gpuVirtualAddress, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
+
+                D3DCommandList_->SetGraphicsRootConstantBufferView(rootParameterIndex, gpuVirtualAddress);
+            }
+
+            void CommandListImpl::SetGraphicsPipelineState(const PipelineState& pipelineState)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT || type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE);
+
+                const auto& description = pipelineState.GetDescription();
+                ASSERT(description.type == PipelineStateType::Graphics);
+
+                const auto pipelineStateImpl = pipelineState.GetPrivateImpl<PipelineStateImpl>();
+                ASSERT(pipelineStateImpl);
+
+                setGraphicsRootSignature(pipelineStateImpl->GetRootSignature().get());
+                setPipelineState(pipelineStateImpl->GetD3DObject().get());
+
+                if (!graphicsPipelineState_)
+                    D3DCommandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+                graphicsPipelineState_ = pipelineStateImpl;
+                indirectCommandStride_ = description.GetIndirectCommandStride();
+            }
+
+            void CommandListImpl::SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(graphicsRootSignature_);
+
+                D3DCommandList_->SetGraphicsRootDescriptorTable(rootParameterIndex, deviceContext_.GetBindlessDescriptorHeap().GetGpuHandle(bindlessIndex));
+            }
+
+            void CommandListImpl::SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT(renderTargetViews);
+                ASSERT(renderTargetCount > 0 && renderTargetCount <= D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+
+                std::array<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> handles;
+
+                for (uint32_t index = 0; index < renderTargetCount; index++)
+                {
+                    const auto& renderTargetView = renderTargetViews[index];
+                    ASSERT(renderTargetView);
+
+                    const auto allocation = renderTargetView->GetPrivateImpl<DescriptorHeap::Allocation>();
+                    ASSERT(allocation);
+
+                    const auto& resource = renderTargetView->GetGpuResource().lock();
+                    ASSERT(resource);
+                    ASSERT(resource->IsTexture());
+
+                    transitionResource(resource, D3D12_RESOURCE_STATE_RENDER_TARGET);
+                    handles[index] = allocation->GetCPUHandle();
+                }
+
+                D3DCommandList_->OMSetRenderTargets(renderTargetCount, handles.data(), FALSE, nullptr);
+                setViewport(*renderTargetViews[0]);
+            }
+
+            void CommandListImpl::setViewport(const RenderTargetView& renderTargetView)
+            {
+                const auto& resource = renderTargetView.GetGpuResource().lock();
+                const auto& description = resource->GetDescription();
+                const auto mipLevel = renderTargetView.GetDescription().texture.mipLevel;
+
+                const CD3DX12_VIEWPORT viewport(0.0f, 0.0f, static_cast<float>(description.GetWidth(mipLevel)), static_cast<float>(description.GetHeight(mipLevel)));
+                const CD3DX12_RECT scissor(0, 0, static_cast<LONG>(description.GetWidth(mipLevel)), static_cast<LONG>(description.GetHeight(mipLevel)));
+                D3DCommandList_->RSSetViewports(1, &viewport);
+                D3DCommandList_->RSSetScissorRects(1, &scissor);
+            }
+
+            void CommandListImpl::SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT || type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE);
+                ASSERT(indexBuffer);
+
+                const auto indexBufferImpl = indexBuffer->GetPrivateImpl<ResourceImpl>();
+                ASSERT(indexBufferImpl);
+
+                transitionResource(indexBuffer, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+                // Sub-allocated buffers are shifted to their range of pooled resource.
+                D3D12_INDEX_BUFFER_VIEW view;
+                view.BufferLocation = indexBufferImpl->GetD3DObject()->GetGPUVirtualAddress() + indexBufferImpl->GetOffset();
+                view.SizeInBytes = indexBuffer->GetDescription().GetSize();
+                view.Format = D3DUtils::GetDxgiResourceFormat(format);
+
+                D3DCommandList_->IASetIndexBuffer(&view);
+            }
+
+            void CommandListImpl::SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner)
+            {
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT_MSG(D3DCommandList5_, "Variable rate shading isn't supported by runtime");
+
+                // Per primitive rates aren't exposed, base rate passes through to image combiner.
+                const D3D12_SHADING_RATE_COMBINER combiners[D3D12_RS_SET_SHADING_RATE_COMBINER_COUNT] = {
+                    D3D12_SHADING_RATE_COMBINER_PASSTHROUGH,
+                    getD3DShadingRateCombiner(imageCombiner),
+                };
+
+                D3DCommandList5_->RSSetShadingRate(getD3DShadingRate(baseRate), combiners);
+            }
+
+            void CommandListImpl::SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage)
+            {
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+                ASSERT_MSG(D3DCommandList5_, "Variable rate shading isn't supported by runtime");
+
+                if (!shadingRateImage)
+                {
+                    D3DCommandList5_->RSSetShadingRateImage(nullptr);
+                    return;
+                }
+
+                const auto resourceImpl = shadingRateImage->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourceImpl);
+
+                // Image is read by rasterizer of following draws, which flush barriers.
+                transitionResource(shadingRateImage, D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
+                D3DCommandList5_->RSSetShadingRateImage(resourceImpl->GetD3DObject().get());
+            }
+
+            void CommandListImpl::ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                                  const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(argumentBuffer);
+                ASSERT(graphicsPipelineState_);
+                ASSERT(argumentOffset + static_cast<uint64_t>(maxCommandCount) * indirectCommandStride_ <= argumentBuffer->GetDescription().GetSize());
+
+                const auto argumentBufferImpl = argumentBuffer->GetPrivateImpl<ResourceImpl>();
+                ASSERT(argumentBufferImpl);
+
+                transitionResource(argumentBuffer, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
 
-                barrier = CD3DX12_RESOURCE_BARRIER::Transition(resourceImpl->GetD3DObject().get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
-                D3DCommandList_->ResourceBarrier(1, &barrier);
+                ID3D12Resource* countD3DResource = nullptr;
+                uint64_t countBufferOffset = 0;
+
+                if (countBuffer)
+                {
+                    const auto countBufferImpl = countBuffer->GetPrivateImpl<ResourceImpl>();
+                    ASSERT(countBufferImpl);
+
+                    transitionResource(countBuffer, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                    countD3DResource = countBufferImpl->GetD3DObject().get();
+                    countBufferOffset = countBufferImpl->GetOffset() + countOffset;
+                }
+
+                flushBarriers();
+
+                D3DCommandList_->ExecuteIndirect(graphicsPipelineState_->GetCommandSignature().get(), maxCommandCount,
+                                                 argumentBufferImpl->GetD3DObject().get(), argumentBufferImpl->GetOffset() + argumentOffset,
+                                                 countD3DResource, countBufferOffset);
+            }
+
+            void CommandListImpl::SetDrawConstants(const uint32_t* constants, uint32_t count)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(constants);
+                ASSERT(graphicsPipelineState_);
+                ASSERT(count * sizeof(uint32_t) + sizeof(DrawIndexedArguments) <= indirectCommandStride_);
+
+                D3DCommandList_->SetGraphicsRoot32BitConstants(0, count, constants, 0);
+            }
+
+            void CommandListImpl::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(graphicsPipelineState_);
+
+                flushBarriers();
+                D3DCommandList_->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+            }
+
+            void CommandListImpl::ExecuteBundle(const BundleCommandList& bundle)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+                const auto bundleImpl = bundle.GetPrivateImpl<CommandListImpl>();
+                ASSERT(bundleImpl);
+                ASSERT(bundleImpl->type_ == D3D12_COMMAND_LIST_TYPE_BUNDLE);
+
+                for (const auto& resourceState : bundleImpl->bundleResourceStates_)
+                    transitionResource(resourceState.first, resourceState.second);
+
+                // Bundle could be executed many times, pages are released with the bundle.
+                for (const auto& page : bundleImpl->ringPages_)
+                    trackRingPage(page);
+
+                flushBarriers();
+
+                D3DCommandList_->ExecuteBundle(bundleImpl->GetD3DObject().get());
+
+                // Bindings set by bundle are inherited, cached ones are stale now.
+                graphicsRootSignature_ = nullptr;
+                pipelineState_ = nullptr;
+                graphicsPipelineState_ = nullptr;
+                indirectCommandStride_ = 0;
+            }
+
+            void CommandListImpl::BeginQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+                const auto queryPoolImpl = queryPool->GetPrivateImpl<QueryPoolImpl>();
+                ASSERT(queryPoolImpl);
+
+                flushCopies();
+                D3DCommandList_->BeginQuery(queryPoolImpl->GetD3DObject().get(), queryPoolImpl->GetQueryType(), index);
+            }
+
+            void CommandListImpl::EndQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+                const auto queryPoolImpl = queryPool->GetPrivateImpl<QueryPoolImpl>();
+                ASSERT(queryPoolImpl);
+
+                flushCopies();
+                D3DCommandList_->EndQuery(queryPoolImpl->GetD3DObject().get(), queryPoolImpl->GetQueryType(), index);
+            }
+
+            void CommandListImpl::ResolveQueries(const std::shared_ptr<QueryPool>& queryPool, uint32_t firstQuery, uint32_t count)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+                const auto queryPoolImpl = queryPool->GetPrivateImpl<QueryPoolImpl>();
+                ASSERT(queryPoolImpl);
+
+                const auto& resultBuffer = queryPool->GetResultBuffer();
+                const auto resultBufferImpl = resultBuffer->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resultBufferImpl);
+
+                transitionResource(resultBuffer, D3D12_RESOURCE_STATE_COPY_DEST);
+                flushBarriers();
+
+                const uint64_t offset = resultBufferImpl->GetOffset() + static_cast<uint64_t>(firstQuery) * queryPool->GetDescription().GetResultSize();
+                D3DCommandList_->ResolveQueryData(queryPoolImpl->GetD3DObject().get(), queryPoolImpl->GetQueryType(), firstQuery, count,
+                                                  resultBufferImpl->GetD3DObject().get(), offset);
+            }
+
+            void CommandListImpl::SetPredication(const std::shared_ptr<QueryPool>& queryPool, uint32_t index)
+            {
+                ASSERT(D3DCommandList_);
+                ASSERT(type_ == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+                if (!queryPool)
+                {
+                    // Copies recorded while predicated stay predicated.
+                    flushCopies();
+
+                    D3DCommandList_->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+                    isPredicated_ = false;
+                    return;
+                }
+
+                const auto& resultBuffer = queryPool->GetResultBuffer();
+                const auto resultBufferImpl = resultBuffer->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resultBufferImpl);
+
+                // Barriers aren't predicated, so the transition is flushed even if following commands are skipped.
+                transitionResource(resultBuffer, D3D12_RESOURCE_STATE_PREDICATION);
+                flushBarriers();
+
+                const uint64_t offset = resultBufferImpl->GetOffset() + static_cast<uint64_t>(index) * sizeof(uint64_t);
+                D3DCommandList_->SetPredication(resultBufferImpl->GetD3DObject().get(), offset, D3D12_PREDICATION_OP_EQUAL_ZERO);
+                isPredicated_ = true;
             }
 
             void CommandListImpl::Close()
             {
+                ASSERT_MSG(markersStack_.empty(), "Unclosed marker in command list");
+                ASSERT_MSG(!isInRenderPass_, "Unclosed render pass in command list");
+
+                // Predicate buffer leaves PREDICATION state with barriers restoring COMMON state below.
+                if (isPredicated_)
+                    SetPredication(nullptr, 0);
+
+                // Return all tracked resources to COMMON state with single barrier batch, after copies still using them.
+                flushCopies();
+                stateTracker_.RestoreCommonState();
+                flushBarriers();
+
                 D3DCall(D3DCommandList_->Close());
             }
         };
@@ -1,28 +1,40 @@
 #pragma once
 
+// Compiled outside of backend with static gapi backend, see CommandList.inl.
+#include "gapi_dx12/pch.hpp"
+
 #include "common/Math.hpp"
 
 #include "gapi/CommandList.hpp"
 
+#include "gapi_dx12/CommandAllocatorPool.hpp"
+#include "gapi_dx12/CpuResourceDataAllocator.hpp"
+#include "gapi_dx12/ResourceStateTracker.hpp"
+#include "gapi_dx12/TimestampQueryPool.hpp"
+
 namespace RR
 {
     namespace GAPI
     {
         namespace DX12
         {
+            class DeviceContext;
             class FenceImpl;
-            class CommandQueueImpl;
+            class PipelineStateImpl;
 
             class CommandListImpl final : public ICommandList
             {
             public:
-                CommandListImpl(const CommandListType commandListType);
+                CommandListImpl(DeviceContext& deviceContext, const CommandListType commandListType);
                 ~CommandListImpl();
 
                 void Init(const U8String& name);
 
                 void Close() override;
 
+                void BeginMarker(const U8String& name) override;
+                void EndMarker() override;
+
                 // ---------------------------------------------------------------------------------------------
                 // Copy command list
                 // ---------------------------------------------------------------------------------------------
@@ -36,6 +48,7 @@ namespace RR
                                                   const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx, const Vector3u& destPoint) override;
 
                 void UpdateGpuResource(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData) override;
+                void UpdateBuffers(const BufferUpdate* updates, uint32_t count) override;
                 void ReadbackGpuResource(const std::shared_ptr<GpuResource>& texture, const std::shared_ptr<CpuResourceData>& textureData) override;
 
                 // ---------------------------------------------------------------------------------------------
@@ -45,59 +58,151 @@ namespace RR
                 void ClearUnorderedAccessViewUint(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4u& clearValue) override;
                 void ClearUnorderedAccessViewFloat(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView, const Vector4& clearValue) override;
 
+                void GenerateMips(const std::shared_ptr<Texture>& texture) override;
+
+                uint64_t AllocateConstants(const void* data, size_t size) override;
+                void SetComputeConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress) override;
+
+                void SetComputePipelineState(const PipelineState& pipelineState) override;
+                void SetComputeDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex) override;
+                void TransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView) override;
+                void BeginTransitionToShaderResource(const std::shared_ptr<ShaderResourceView>& shaderResourceView) override;
+                void TransitionToUnorderedAccess(const std::shared_ptr<UnorderedAccessView>& unorderedAcessView) override;
+                void UnorderedAccessBarrier(const std::shared_ptr<GpuResource>& resource) override;
+
+                void Dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ) override;
+                void DispatchIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset) override;
+
                 // ---------------------------------------------------------------------------------------------
                 // Graphics command list
                 // ---------------------------------------------------------------------------------------------
 
                 void ClearRenderTargetView(const std::shared_ptr<RenderTargetView>& renderTargetView, const Vector4& color) override;
+                void BeginRenderPass(const RenderPassAttachment* attachments, uint32_t attachmentCount) override;
+                void EndRenderPass() override;
+                void DiscardResource(const std::shared_ptr<GpuResource>& resource) override;
+                void AliasingBarrier(const std::shared_ptr<GpuResource>& resource) override;
+                void ResolveSubresource(const std::shared_ptr<Texture>& sourceTexture, uint32_t sourceSubresourceIdx,
+                                        const std::shared_ptr<Texture>& destTexture, uint32_t destSubresourceIdx) override;
+                void SetGraphicsConstantBuffer(uint32_t rootParameterIndex, uint64_t gpuVirtualAddress) override;
+
+                void SetGraphicsPipelineState(const PipelineState& pipelineState) override;
+                void SetGraphicsDescriptorTable(uint32_t rootParameterIndex, uint32_t bindlessIndex) override;
+                void SetRenderTargets(const std::shared_ptr<RenderTargetView>* renderTargetViews, uint32_t renderTargetCount) override;
+                void SetIndexBuffer(const std::shared_ptr<Buffer>& indexBuffer, GpuResourceFormat format) override;
+                void SetShadingRate(ShadingRate baseRate, ShadingRateCombiner imageCombiner) override;
+                void SetShadingRateImage(const std::shared_ptr<Texture>& shadingRateImage) override;
+                void ExecuteIndirect(const std::shared_ptr<Buffer>& argumentBuffer, uint32_t argumentOffset, uint32_t maxCommandCount,
+                                     const std::shared_ptr<Buffer>& countBuffer, uint32_t countOffset) override;
+
+                void SetDrawConstants(const uint32_t* constants, uint32_t count) override;
+                void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+                void ExecuteBundle(const BundleCommandList& bundle) override;
+
+                void BeginQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) override;
+                void EndQuery(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) override;
+                void ResolveQueries(const std::shared_ptr<QueryPool>& queryPool, uint32_t firstQuery, uint32_t count) override;
+                void SetPredication(const std::shared_ptr<QueryPool>& queryPool, uint32_t index) override;
 
                 // ---------------------------------------------------------------------------------------------
 
-                void ResetAfterSubmit(CommandQueueImpl& commandQueue);
+                // Returns allocator of submitted recording to the pool, it's reused once fence reaches fenceValue.
+                void ResetAfterSubmit(uint32_t workCommandsCount, const std::shared_ptr<FenceImpl>& fence, uint64_t fenceValue);
 
                 const ComSharedPtr<ID3D12GraphicsCommandList>& GetD3DObject() const { return D3DCommandList_; }
 
             private:
-                // One frame executing on GPU
-                // TODO allow dynamic allocators list size.
-                static constexpr int AllocatorsCount = MAX_GPU_FRAMES_BUFFERED + 1;
-
-                void copyIntermediate(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData, bool readback) const;
-
-                class CommandAllocatorsPool final
+                // Copy recorded once barriers of its batch are issued, consecutive copies share single barrier batch.
+                struct PendingCopy
                 {
-                public:
-                    ~CommandAllocatorsPool();
-
-                    void Init(D3D12_COMMAND_LIST_TYPE type, const U8String& name);
-
-                    const ComSharedPtr<ID3D12CommandAllocator>& GetNextAllocator();
-                    void ResetAfterSubmit(CommandQueueImpl& commandQueue);
-
-                private:
-                    struct AllocatorData final
+                    enum class Type : uint8_t
                     {
-                        uint64_t cpuFenceValue;
-                        ComSharedPtr<ID3D12CommandAllocator> allocator;
+                        Resource,
+                        BufferRegion,
+                        TextureRegion,
                     };
 
-                    void createAllocator(
-                        const U8String& name,
-                        const uint32_t index,
-                        ComSharedPtr<ID3D12CommandAllocator>& allocator) const;
-
-                private:
-                    U8String name_;
-                    D3D12_COMMAND_LIST_TYPE type_;
-                    std::unique_ptr<FenceImpl> fence_;
-                    std::array<AllocatorData, AllocatorsCount> allocators_;
-                    uint32_t ringBufferIndex_ = 0;
+                    Type type;
+                    // Only resources are set for whole resource and buffer region copies.
+                    D3D12_TEXTURE_COPY_LOCATION dest;
+                    D3D12_TEXTURE_COPY_LOCATION source;
+                    uint64_t destOffset = 0;
+                    uint64_t sourceOffset = 0;
+                    uint64_t numBytes = 0;
+                    Vector3u destPoint;
+                    D3D12_BOX sourceBox;
+                    bool hasSourceBox = false;
+                };
+
+                // Bounce buffer of copies within one resource, reused once submit using it completes on GPU.
+                struct ScratchBuffer
+                {
+                    ComSharedPtr<ID3D12Resource> resource;
+                    uint64_t size = 0;
+                    std::shared_ptr<FenceImpl> fence;
+                    uint64_t fenceValue = 0;
+                    // Used by current recording, it gets sync point of the submit.
+                    bool isRecorded = false;
                 };
 
             private:
+                void copyIntermediate(const std::shared_ptr<GpuResource>& resource, const std::shared_ptr<CpuResourceData>& resourceData, bool readback);
+                // Offsets are relative to buffers, sub-allocated buffers are shifted to their range of pooled resource.
+                void copyBufferRegion(const std::shared_ptr<GpuResource>& source, uint64_t sourceOffset,
+                                      const std::shared_ptr<GpuResource>& dest, uint64_t destOffset, uint64_t numBytes);
+
+                void bindDescriptorHeaps();
+                // Viewport and scissor cover mip of the view.
+                void setViewport(const RenderTargetView& renderTargetView);
+                // Root signatures are shared by layouts, so switching pipelines with the same layout keeps root bindings.
+                void setComputeRootSignature(ID3D12RootSignature* rootSignature);
+                void setGraphicsRootSignature(ID3D12RootSignature* rootSignature);
+                void setPipelineState(ID3D12PipelineState* pipelineState);
+                void transitionResource(const std::shared_ptr<GpuResource>& resource, D3D12_RESOURCE_STATES state, uint32_t subresource = ResourceStateTracker::AllSubresources);
+                // Issues pending barriers and then copies deferred since the last flush.
+                void flushBarriers();
+                void deferCopy(const PendingCopy& copy);
+                // Issues deferred copies before a command that has to follow them.
+                void flushCopies();
+                bool isUsedByPendingCopy(ID3D12Resource* resource) const;
+                // Ring page can't be reused until submit of this list completes.
+                void trackRingPage(const std::shared_ptr<HeapRingAllocator::Page>& page);
+                // Copies of one recording are ordered by barriers and share buffers, new buffer is created only when none is large and idle.
+                ID3D12Resource* acquireScratchBuffer(uint64_t size);
+                void writeTimestamp(uint32_t query);
+
+            private:
+                DeviceContext& deviceContext_;
                 D3D12_COMMAND_LIST_TYPE type_;
                 ComSharedPtr<ID3D12GraphicsCommandList> D3DCommandList_;
-                CommandAllocatorsPool commandAllocatorsPool_;
+                // Null when runtime doesn't expose variable rate shading.
+                ComSharedPtr<ID3D12GraphicsCommandList5> D3DCommandList5_;
+                // Null when runtime doesn't expose render passes, they are emulated with clears and resolves then.
+                ComSharedPtr<ID3D12GraphicsCommandList4> D3DCommandList4_;
+#ifdef ENABLE_ENHANCED_BARRIERS
+                // Null unless device supports enhanced barriers, barriers are legacy then.
+                ComSharedPtr<ID3D12GraphicsCommandList7> D3DCommandList7_;
+#endif
+                CommandAllocatorPool::Allocator allocator_;
+                ResourceStateTracker stateTracker_;
+                std::vector<PendingCopy> pendingCopies_;
+                // Upload and readback ring pages used by recorded commands, they get sync point of the submit.
+                std::vector<std::shared_ptr<HeapRingAllocator::Page>> ringPages_;
+                std::vector<ScratchBuffer> scratchBuffers_;
+                ID3D12RootSignature* computeRootSignature_ = nullptr;
+                ID3D12RootSignature* graphicsRootSignature_ = nullptr;
+                ID3D12PipelineState* pipelineState_ = nullptr;
+                // Provides command signature and record stride for ExecuteIndirect.
+                const PipelineStateImpl* graphicsPipelineState_ = nullptr;
+                uint32_t indirectCommandStride_ = 0;
+                // Bundles can't have barriers, states are set by executing list. Keeps referenced resources alive as well.
+                std::vector<std::pair<std::shared_ptr<GpuResource>, D3D12_RESOURCE_STATES>> bundleResourceStates_;
+                // Currently open markers, they could span frames when list is recorded across MoveToNextFrame.
+                std::vector<TimestampQueryPool::Marker> markersStack_;
+                bool isPredicated_ = false;
+                bool isInRenderPass_ = false;
+                // Resolves of emulated render pass, done when it ends.
+                std::vector<std::pair<std::shared_ptr<RenderTargetView>, std::shared_ptr<Texture>>> pendingResolves_;
             };
         };
     }
@@ -2,10 +2,13 @@
 
 #include "gapi/CommandList.hpp"
 #include "gapi/Fence.hpp"
+#include "gapi/Texture.hpp"
 
 #include "gapi_dx12/CommandListImpl.hpp"
+#include "gapi_dx12/DescriptorAllocator.hpp"
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/ResourceImpl.hpp"
 #include "gapi_dx12/ResourceReleaseContext.hpp"
 
 namespace RR
@@ -22,11 +25,24 @@ namespace RR
                            (commandQueueType == CommandQueueType::Compute && commandListType == CommandListType::Compute) ||
                            (commandQueueType == CommandQueueType::Graphics && commandListType == CommandListType::Graphics);
                 }
+
+                D3D12_COMMAND_QUEUE_PRIORITY getD3DPriority(CommandQueuePriority priority)
+                {
+                    switch (priority)
+                    {
+                        case CommandQueuePriority::Normal: return D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+                        case CommandQueuePriority::High: return D3D12_COMMAND_QUEUE_PRIORITY_HIGH;
+                        case CommandQueuePriority::GlobalRealtime: return D3D12_COMMAND_QUEUE_PRIORITY_GLOBAL_REALTIME;
+                    }
+
+                    LOG_FATAL("Unsupported command queue priority");
+                    return D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+                }
             }
 
             CommandQueueImpl::~CommandQueueImpl()
             {
-                ResourceReleaseContext::DeferredD3DResourceRelease(D3DCommandQueue_);
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DCommandQueue_);
             }
 
             void CommandQueueImpl::ImmediateD3DObjectRelease()
@@ -38,7 +54,7 @@ namespace RR
             {
                 ASSERT(!D3DCommandQueue_)
 
-                const auto& device = DeviceContext::GetDevice();
+                const auto& device = deviceContext_.GetDevice();
 
                 D3D12_COMMAND_QUEUE_DESC desc = {};
                 desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
@@ -58,10 +74,22 @@ namespace RR
                     LOG_FATAL( "Unsuported command queue type");
                 }
 
-                D3DCall(device->CreateCommandQueue(&desc, IID_PPV_ARGS(D3DCommandQueue_.put())));
+                desc.Priority = getD3DPriority(priority_);
+
+                // Global realtime priority is refused without SeIncreaseBasePriorityPrivilege.
+                if (priority_ == CommandQueuePriority::GlobalRealtime &&
+                    FAILED(device->CreateCommandQueue(&desc, IID_PPV_ARGS(D3DCommandQueue_.put()))))
+                {
+                    Log::Format::Warning("Global realtime priority isn't allowed for command queue {}, falling back to high priority\n", name);
+                    priority_ = CommandQueuePriority::High;
+                    desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_HIGH;
+                }
+
+                if (!D3DCommandQueue_)
+                    D3DCall(device->CreateCommandQueue(&desc, IID_PPV_ARGS(D3DCommandQueue_.put())));
                 D3DUtils::SetAPIName(D3DCommandQueue_.get(), name);
 
-                fence_ = std::make_shared<FenceImpl>();
+                fence_ = std::make_shared<FenceImpl>(deviceContext_);
                 fence_->Init(name);
             }
 
@@ -77,10 +105,44 @@ namespace RR
                 const auto& d3dCommandList = commandListImpl->GetD3DObject();
                 ASSERT(d3dCommandList);
 
+                deviceContext_.GetDescriptorAllocator().FlushBindlessCopies();
+
                 ID3D12CommandList* commandLists[] = { d3dCommandList.get() };
                 D3DCommandQueue_->ExecuteCommandLists(1, commandLists);
 
-                commandListImpl->ResetAfterSubmit(*this);
+                // Allocator is reused once the fence passes.
+                fence_->Signal(*this);
+                commandListImpl->ResetAfterSubmit(commandList->GetWorkCommandsCount(), fence_, fence_->GetCpuValue());
+            }
+
+            void CommandQueueImpl::Submit(const std::vector<std::shared_ptr<CommandList>>& commandLists)
+            {
+                ASSERT(D3DCommandQueue_);
+                ASSERT(!commandLists.empty());
+                ASSERT(commandLists.size() <= MAX_SUBMIT_BATCH_SIZE);
+
+                std::array<ID3D12CommandList*, MAX_SUBMIT_BATCH_SIZE> d3dCommandLists;
+
+                for (size_t index = 0; index < commandLists.size(); index++)
+                {
+                    const auto& commandList = commandLists[index];
+                    ASSERT(commandList);
+                    ASSERT(isListTypeCompatable(type_, commandList->GetCommandListType()));
+
+                    const auto& commandListImpl = commandList->GetPrivateImpl<CommandListImpl>();
+                    ASSERT(commandListImpl);
+                    ASSERT(commandListImpl->GetD3DObject());
+
+                    d3dCommandLists[index] = commandListImpl->GetD3DObject().get();
+                }
+
+                deviceContext_.GetDescriptorAllocator().FlushBindlessCopies();
+                D3DCommandQueue_->ExecuteCommandLists(static_cast<UINT>(commandLists.size()), d3dCommandLists.data());
+
+                // Single signal covers allocators of the whole batch.
+                fence_->Signal(*this);
+                for (const auto& commandList : commandLists)
+                    commandList->GetPrivateImpl<CommandListImpl>()->ResetAfterSubmit(commandList->GetWorkCommandsCount(), fence_, fence_->GetCpuValue());
             }
 
             void CommandQueueImpl::Signal(const ComSharedPtr<ID3D12Fence>& fence, uint64_t value)
@@ -97,6 +159,32 @@ namespace RR
                 D3DCall(D3DCommandQueue_->Wait(fence.get(), value));
             }
 
+            void CommandQueueImpl::Wait(const GpuSyncPoint& syncPoint)
+            {
+                ASSERT(syncPoint.IsValid());
+
+                const auto fenceImpl = syncPoint.fence->GetPrivateImpl<FenceImpl>();
+                ASSERT(fenceImpl);
+
+                Wait(fenceImpl->GetD3DObject(), syncPoint.value);
+            }
+
+            void CommandQueueImpl::UpdateTileMappings(const std::vector<TileMappingUpdate>& updates)
+            {
+                ASSERT(D3DCommandQueue_);
+
+                for (const auto& update : updates)
+                {
+                    ASSERT(update.texture);
+                    ASSERT(IsSet(update.texture->GetDescription().GetBindFlags(), GpuResourceBindFlags::Reserved));
+
+                    const auto resourceImpl = update.texture->GetPrivateImpl<ResourceImpl>();
+                    ASSERT(resourceImpl);
+
+                    resourceImpl->UpdateTileMapping(*D3DCommandQueue_, update.mipLevel, update.resident);
+                }
+            }
+
             void CommandQueueImpl::WaitForGpu()
             {
                 ASSERT(fence_);
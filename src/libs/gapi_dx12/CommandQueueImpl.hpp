@@ -9,6 +9,7 @@ namespace RR
         namespace DX12
         {
             class CommandListImpl;
+            class DeviceContext;
             class FenceImpl;
 
             class CommandQueueImpl final : public ICommandQueue
@@ -16,16 +17,21 @@ namespace RR
             public:
                 CommandQueueImpl() = delete;
                 CommandQueueImpl(const CommandQueueImpl& other) : 
+                    deviceContext_(other.deviceContext_), 
                     type_(other.type_), 
+                    priority_(other.priority_), 
                     D3DCommandQueue_(other.D3DCommandQueue_), 
                     fence_(other.fence_) {};
-                CommandQueueImpl(CommandQueueType type) : type_(type) {};
+                CommandQueueImpl(DeviceContext& deviceContext, CommandQueueType type, CommandQueuePriority priority = CommandQueuePriority::Normal) : deviceContext_(deviceContext), type_(type), priority_(priority) {};
                 ~CommandQueueImpl();
 
                 void ImmediateD3DObjectRelease();
 
                 void Init(const U8String& name);
                 void Submit(const std::shared_ptr<CommandList>& commandList) override;
+                void Submit(const std::vector<std::shared_ptr<CommandList>>& commandLists) override;
+                void Wait(const GpuSyncPoint& syncPoint) override;
+                void UpdateTileMappings(const std::vector<TileMappingUpdate>& updates) override;
 
                 // Todo private?
                 void Signal(const ComSharedPtr<ID3D12Fence>& fence, uint64_t value);
@@ -36,7 +42,9 @@ namespace RR
                 const ComSharedPtr<ID3D12CommandQueue>& GetD3DObject() const { return D3DCommandQueue_; }
 
             private:
+                DeviceContext& deviceContext_;
                 CommandQueueType type_;
+                CommandQueuePriority priority_;
                 ComSharedPtr<ID3D12CommandQueue> D3DCommandQueue_ = nullptr;
                 std::shared_ptr<FenceImpl> fence_;
             };
@@ -3,68 +3,209 @@
 #include "gapi/Texture.hpp"
 
 #include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/FenceImpl.hpp"
 #include "gapi_dx12/ResourceImpl.hpp"
 #include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
 
+#include "common/Math.hpp"
+#include "common/threading/Mutex.hpp"
+
+#include <algorithm>
+
 namespace RR
 {
     namespace GAPI
     {
         namespace DX12
         {
-            HeapAllocation::HeapAllocation(D3D12_HEAP_TYPE heapType, size_t size)
-                : heapType_(heapType),
-                  size_(size)
+            namespace
             {
-                const auto& resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size_);
+                std::shared_ptr<ResourceImpl> createHeapResource(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t size, const U8String& name)
+                {
+                    const auto& resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
 
-                D3D12MA::ALLOCATION_DESC allocationDesc = {};
-                allocationDesc.HeapType = heapType_;
+                    D3D12MA::ALLOCATION_DESC allocationDesc = {};
+                    allocationDesc.HeapType = heapType;
 
-                ASSERT(heapType == D3D12_HEAP_TYPE_READBACK || heapType == D3D12_HEAP_TYPE_UPLOAD);
-                const auto defaultState = (heapType == D3D12_HEAP_TYPE_UPLOAD) ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COPY_DEST;
+                    ASSERT(heapType == D3D12_HEAP_TYPE_READBACK || heapType == D3D12_HEAP_TYPE_UPLOAD);
+                    const auto defaultState = (heapType == D3D12_HEAP_TYPE_UPLOAD) ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COPY_DEST;
+
+                    ComSharedPtr<ID3D12Resource> d3dresource;
+                    D3D12MA::Allocation* allocation;
+                    D3DCall(deviceContext.GetAllocator()->CreateResource(
+                        &allocationDesc,
+                        &resourceDesc,
+                        defaultState,
+                        NULL,
+                        &allocation,
+                        IID_PPV_ARGS(d3dresource.put())));
 
-                ComSharedPtr<ID3D12Resource> d3dresource;
-                D3D12MA::Allocation* allocation;
-                HRESULT hr = DeviceContext::GetAllocator()->CreateResource(
-                    &allocationDesc,
-                    &resourceDesc,
-                    defaultState,
-                    NULL,
-                    &allocation,
-                    IID_PPV_ARGS(d3dresource.put()));
+                    auto resource = std::make_shared<ResourceImpl>(deviceContext);
+                    resource->Init(d3dresource, allocation, name);
 
-                resource_ = std::make_shared<ResourceImpl>();
-                resource_->Init(d3dresource, allocation, "heapAlloc");
+                    return resource;
+                }
             }
 
-            HeapAllocation::~HeapAllocation()
+            HeapRingAllocator::Page::Page(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t size)
+                : heapType(heapType),
+                  size(size)
+            {
+                // Ring is shared by all subsystems.
+                ALLOCATION_TAG_SCOPE(Gapi);
+                resource = createHeapResource(deviceContext, heapType, size, heapType == D3D12_HEAP_TYPE_UPLOAD ? "UploadRingPage" : "ReadbackRingPage");
+
+                // We never read upload memory on CPU, readback ranges are invalidated by allocations.
+                void* mappedData;
+                resource->Map(0, { 0, 0 }, mappedData);
+                cpuData = static_cast<uint8_t*>(mappedData);
+            }
+
+            HeapRingAllocator::Page::~Page()
             {
-                if (isMapped_)
-                    Unmap();
+                resource->Unmap(0, { 0, heapType == D3D12_HEAP_TYPE_UPLOAD ? size : 0 });
             }
 
-            void* HeapAllocation::Map() const
+            void HeapRingAllocator::Page::AddSyncPoint(const std::shared_ptr<FenceImpl>& fence, uint64_t value)
             {
-                ASSERT(!isMapped_);
-                D3D12_RANGE readRange { 0, heapType_ == D3D12_HEAP_TYPE_READBACK ? size_ : 0 };
+                ASSERT(fence);
+
+                Threading::ReadWriteGuard lock(spinlock_);
 
-                isMapped_ = true;
+                const auto it = std::find_if(syncPoints_.begin(), syncPoints_.end(), [&fence](const auto& syncPoint) { return syncPoint.first == fence; });
+                if (it == syncPoints_.end())
+                {
+                    syncPoints_.emplace_back(fence, value);
+                    return;
+                }
+
+                it->second = std::max(it->second, value);
+            }
+
+            bool HeapRingAllocator::Page::IsUsedByGpu() const
+            {
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                return std::any_of(syncPoints_.begin(), syncPoints_.end(), [](const auto& syncPoint) { return syncPoint.first->GetGpuValue() < syncPoint.second; });
+            }
+
+            HeapRingAllocator::HeapRingAllocator(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t pageSize)
+                : deviceContext_(deviceContext),
+                  heapType_(heapType),
+                  pageSize_(pageSize)
+            {
+                ASSERT(heapType == D3D12_HEAP_TYPE_READBACK || heapType == D3D12_HEAP_TYPE_UPLOAD);
+            }
+
+            std::optional<HeapRingAllocator::Allocation> HeapRingAllocator::Allocate(size_t size, size_t alignment)
+            {
+                ASSERT(IsPowerOfTwo(alignment));
+
+                if (size > pageSize_)
+                    return std::nullopt;
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                auto offset = AlignTo(offset_, alignment);
+
+                if (!currentPage_ || offset + size > pageSize_)
+                {
+                    if (currentPage_)
+                        retiredPages_.push_back(std::move(currentPage_));
+
+                    currentPage_ = acquirePage();
+                    offset = 0;
+                }
+
+                offset_ = offset + size;
+
+                return Allocation { currentPage_, offset };
+            }
+
+            std::shared_ptr<HeapRingAllocator::Page> HeapRingAllocator::acquirePage()
+            {
+                std::shared_ptr<Page> result;
+                size_t freePages = 0;
+
+                for (auto it = retiredPages_.begin(); it != retiredPages_.end();)
+                {
+                    // Page is referenced by allocation or command list which isn't submitted yet, or still used by GPU.
+                    if (it->use_count() > 1 || (*it)->IsUsedByGpu())
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    if (!result)
+                    {
+                        result = std::move(*it);
+                        it = retiredPages_.erase(it);
+                        continue;
+                    }
+
+                    // Trim excess of idle pages.
+                    if (++freePages > MaxFreePages)
+                    {
+                        it = retiredPages_.erase(it);
+                        continue;
+                    }
+
+                    ++it;
+                }
+
+                return result ? result : std::make_shared<Page>(deviceContext_, heapType_, pageSize_);
+            }
+
+            HeapAllocation::HeapAllocation(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t size)
+                : heapType_(heapType),
+                  size_(size)
+            {
+                resource_ = createHeapResource(deviceContext, heapType_, size_, "heapAlloc");
 
                 void* mappedData;
-                resource_->Map(0, readRange, mappedData);
+                resource_->Map(0, { 0, 0 }, mappedData);
+                mappedData_ = static_cast<uint8_t*>(mappedData);
+            }
 
-                return mappedData;
+            HeapAllocation::HeapAllocation(const HeapRingAllocator::Allocation& allocation, size_t size)
+                : heapType_(allocation.page->heapType),
+                  size_(size),
+                  offset_(allocation.offset),
+                  resource_(allocation.page->resource),
+                  page_(allocation.page)
+            {
+                ASSERT(offset_ + size_ <= page_->size);
+                ASSERT(page_->cpuData);
+
+                mappedData_ = page_->cpuData + offset_;
             }
 
-            void HeapAllocation::Unmap() const
+            HeapAllocation::~HeapAllocation()
             {
-                ASSERT(isMapped_);
+                // Pages are unmapped with the page itself.
+                if (!page_)
+                    resource_->Unmap(0, { 0, heapType_ == D3D12_HEAP_TYPE_UPLOAD ? size_ : 0 });
+            }
 
-                D3D12_RANGE writtenRange { 0, heapType_ == D3D12_HEAP_TYPE_UPLOAD ? size_ : 0 };
-                resource_->Unmap(0, writtenRange);
+            void HeapAllocation::Invalidate(size_t offset, size_t size) const
+            {
+                ASSERT(heapType_ == D3D12_HEAP_TYPE_READBACK);
+                ASSERT(offset + size <= size_);
 
-                isMapped_ = false;
+                // Nested map with read range invalidates CPU caches of the range, pointer stays the same.
+                void* mappedData;
+                resource_->Map(0, { offset_ + offset, offset_ + offset + size }, mappedData);
+                resource_->Unmap(0, { 0, 0 });
+            }
+
+            void HeapAllocation::Flush(size_t offset, size_t size) const
+            {
+                ASSERT(heapType_ == D3D12_HEAP_TYPE_UPLOAD);
+                ASSERT(offset + size <= size_);
+
+                void* mappedData;
+                resource_->Map(0, { 0, 0 }, mappedData);
+                resource_->Unmap(0, { offset_ + offset, offset_ + offset + size });
             }
 
             ComSharedPtr<ID3D12Resource> HeapAllocation::GetD3DResouce() const
@@ -72,7 +213,75 @@ namespace RR
                 return resource_->GetD3DObject();
             }
 
-            std::shared_ptr<CpuResourceData> const CpuResourceDataAllocator::Alloc(
+            CpuResourceDataAllocator::~CpuResourceDataAllocator()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void CpuResourceDataAllocator::Init()
+            {
+                ASSERT(!isInited_);
+
+                uploadRing_ = std::make_unique<HeapRingAllocator>(deviceContext_, D3D12_HEAP_TYPE_UPLOAD, UploadPageSize);
+                readbackRing_ = std::make_unique<HeapRingAllocator>(deviceContext_, D3D12_HEAP_TYPE_READBACK, ReadbackPageSize);
+
+                isInited_ = true;
+            }
+
+            void CpuResourceDataAllocator::Terminate()
+            {
+                ASSERT(isInited_);
+
+                uploadRing_ = nullptr;
+                readbackRing_ = nullptr;
+
+                isInited_ = false;
+            }
+
+            IMemoryAllocation* CpuResourceDataAllocator::allocateHeap(D3D12_HEAP_TYPE heapType, size_t size)
+            {
+                ASSERT(isInited_);
+
+                const auto& ring = (heapType == D3D12_HEAP_TYPE_UPLOAD) ? uploadRing_ : readbackRing_;
+                const auto& allocation = ring->Allocate(size);
+
+                // Large allocations get dedicated heap.
+                if (!allocation)
+                    return new HeapAllocation(deviceContext_, heapType, size);
+
+                return new HeapAllocation(allocation.value(), size);
+            }
+
+            HeapRingAllocator::Allocation CpuResourceDataAllocator::AllocateConstants(const void* data, size_t size)
+            {
+                ASSERT(isInited_);
+                ASSERT(data);
+                // Constant buffer view is limited to 4096 float4 elements.
+                ASSERT(size <= D3D12_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16);
+
+                const auto alignedSize = AlignTo(size, static_cast<size_t>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
+                const auto& allocation = uploadRing_->Allocate(alignedSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+                ASSERT(allocation);
+                ASSERT(allocation->page->cpuData);
+
+                memcpy(allocation->page->cpuData + allocation->offset, data, size);
+
+                return *allocation;
+            }
+
+            HeapRingAllocator::Allocation CpuResourceDataAllocator::AllocateUpload(size_t size)
+            {
+                ASSERT(isInited_);
+                ASSERT(size > 0 && size <= UploadPageSize);
+
+                const auto& allocation = uploadRing_->Allocate(size, D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT);
+                ASSERT(allocation);
+                ASSERT(allocation->page->cpuData);
+
+                return *allocation;
+            }
+
+            std::shared_ptr<CpuResourceData> CpuResourceDataAllocator::Alloc(
                 const GpuResourceDescription& resourceDesc,
                 MemoryAllocationType memoryType,
                 uint32_t firstSubresourceIndex,
@@ -81,26 +290,24 @@ namespace RR
                 if (numSubresources == Texture::MaxPossible)
                     numSubresources = resourceDesc.GetNumSubresources();
 
-                ASSERT(resourceDesc.GetDimension() != GpuResourceDimension::Texture2DMS);
+                // Copies between buffers and textures don't support multisampled textures, resolve them first.
+                ASSERT_MSG(resourceDesc.GetDimension() != GpuResourceDimension::Texture2DMS, "Multisampled textures should be resolved before upload or readback");
                 ASSERT((resourceDesc.GetSampleCount() == 1) || (resourceDesc.GetDimension() != GpuResourceDimension::Buffer));
                 ASSERT(firstSubresourceIndex + numSubresources <= resourceDesc.GetNumSubresources());
-                D3D12_RESOURCE_DESC desc = D3DUtils::GetResourceDesc(resourceDesc);
 
-                const auto& device = DeviceContext::GetDevice();
+                const auto& footprint = footprintCache_.GetOrCreate(resourceDesc, firstSubresourceIndex, numSubresources);
+                const auto intermediateSize = footprint->totalSize;
 
-                UINT64 intermediateSize;
-                device->GetCopyableFootprints(&desc, 0, numSubresources, 0, nullptr, nullptr, nullptr, &intermediateSize);
-
-                const auto& allocation = std::make_shared<MemoryAllocation>(memoryType, intermediateSize);
+                const auto& allocation = MakePooledShared<MemoryAllocation>(memoryType, intermediateSize);
 
                 IMemoryAllocation* memoryAllocation;
                 switch (memoryType)
                 {
                     case MemoryAllocationType::Upload:
-                        memoryAllocation = new HeapAllocation(D3D12_HEAP_TYPE_UPLOAD, intermediateSize);
+                        memoryAllocation = allocateHeap(D3D12_HEAP_TYPE_UPLOAD, intermediateSize);
                         break;
                     case MemoryAllocationType::Readback:
-                        memoryAllocation = new HeapAllocation(D3D12_HEAP_TYPE_READBACK, intermediateSize);
+                        memoryAllocation = allocateHeap(D3D12_HEAP_TYPE_READBACK, intermediateSize);
                         break;
                     case MemoryAllocationType::CpuReadWrite:
                         memoryAllocation = new CpuAllocation(intermediateSize);
@@ -112,30 +319,7 @@ namespace RR
                 ASSERT(memoryAllocation);
                 allocation->SetPrivateImpl(memoryAllocation);
 
-                std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(numSubresources);
-                std::vector<UINT> numRowsVector(numSubresources);
-                std::vector<UINT64> rowSizeInBytesVector(numSubresources);
-
-                device->GetCopyableFootprints(&desc, firstSubresourceIndex, numSubresources, 0, &layouts[0], &numRowsVector[0], &rowSizeInBytesVector[0], nullptr);
-
-                std::vector<CpuResourceData::SubresourceFootprint> subresourceFootprints(numSubresources);
-                for (uint32_t index = 0; index < numSubresources; index++)
-                {
-                    const auto& layout = layouts[index];
-                    const auto numRows = numRowsVector[index];
-                    const auto rowSizeInBytes = rowSizeInBytesVector[index];
-                    const auto rowPitch = layout.Footprint.RowPitch;
-                    const auto depthPitch = numRows * rowPitch;
-
-                    subresourceFootprints[index] = CpuResourceData::SubresourceFootprint(
-                        layout.Offset,
-                        (resourceDesc.GetDimension() == GpuResourceDimension::Buffer) ? resourceDesc.GetNumElements() : layout.Footprint.Width,
-                        layout.Footprint.Height,
-                        layout.Footprint.Depth,
-                        numRows, rowSizeInBytes, rowPitch, depthPitch);
-                }
-
-                return std::make_shared<CpuResourceData>(allocation, resourceDesc, subresourceFootprints, firstSubresourceIndex);
+                return MakePooledShared<CpuResourceData>(allocation, resourceDesc, footprint, firstSubresourceIndex);
             }
         }
     }
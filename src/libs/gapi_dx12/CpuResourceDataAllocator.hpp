@@ -2,54 +2,164 @@
 
 #include "gapi/MemoryAllocation.hpp"
 
+#include "gapi_dx12/ResourceFootprintCache.hpp"
+
+#include "common/debug/MemoryStats.hpp"
+#include "common/threading/SpinLock.hpp"
+
+#include <deque>
+#include <optional>
+
 namespace RR
 {
     namespace GAPI
     {
         namespace DX12
         {
+            class DeviceContext;
+            class FenceImpl;
             class ResourceImpl;
 
             class CpuAllocation final : public IMemoryAllocation
             {
             public:
-                CpuAllocation(size_t size) { memory_ = operator new(size); };
-                ~CpuAllocation() { operator delete(memory_); }
+                CpuAllocation(size_t size) : size_(size), tag_(Common::Debug::AllocationTracker::GetCurrentTag())
+                {
+                    memory_ = operator new(size);
+                    Common::Debug::MemoryStats::OnAllocate(tag_, Common::Debug::MemoryKind::Cpu, size_);
+                };
+
+                ~CpuAllocation()
+                {
+                    operator delete(memory_);
+                    Common::Debug::MemoryStats::OnFree(tag_, Common::Debug::MemoryKind::Cpu, size_);
+                }
 
                 void* Map() const override { return memory_; }
                 void Unmap() const override { }
+                void Invalidate(size_t, size_t) const override { }
+                void Flush(size_t, size_t) const override { }
 
             private:
                 void* memory_;
+                size_t size_;
+                Common::Debug::AllocationTag tag_;
+            };
+
+            // Persistent upload/readback heap sub-allocated with pointer bump.
+            // Pages are recycled once no allocations reference them and GPU completed every submit which used them.
+            class HeapRingAllocator final : private NonCopyable
+            {
+            public:
+                struct Page final : private NonCopyable
+                {
+                    Page(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t size);
+                    ~Page();
+
+                    // Submit of command list which used the page. Submits to one queue complete in order,
+                    // so only the last one is kept per queue fence.
+                    void AddSyncPoint(const std::shared_ptr<FenceImpl>& fence, uint64_t value);
+                    bool IsUsedByGpu() const;
+
+                    D3D12_HEAP_TYPE heapType;
+                    size_t size;
+                    // Persistently mapped for page lifetime.
+                    uint8_t* cpuData = nullptr;
+                    std::shared_ptr<ResourceImpl> resource;
+
+                private:
+                    std::vector<std::pair<std::shared_ptr<FenceImpl>, uint64_t>> syncPoints_;
+                    mutable Threading::SpinLock spinlock_;
+                };
+
+                struct Allocation
+                {
+                    std::shared_ptr<Page> page;
+                    size_t offset;
+                };
+
+                HeapRingAllocator(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t pageSize);
+                ~HeapRingAllocator() = default;
+
+                // Returns nullopt when request doesn't fit into page.
+                std::optional<Allocation> Allocate(size_t size, size_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+            private:
+                std::shared_ptr<Page> acquirePage();
+
+            private:
+                static constexpr size_t MaxFreePages = 8;
+
+                DeviceContext& deviceContext_;
+                D3D12_HEAP_TYPE heapType_;
+                size_t pageSize_;
+                size_t offset_ = 0;
+                std::shared_ptr<Page> currentPage_;
+                std::deque<std::shared_ptr<Page>> retiredPages_;
+                Threading::SpinLock spinlock_;
             };
 
+            // Upload or readback memory mapped once on creation, either dedicated heap or ring page range.
             class HeapAllocation final : public IMemoryAllocation
             {
             public:
-                HeapAllocation(D3D12_HEAP_TYPE heapType, size_t size);
+                HeapAllocation(DeviceContext& deviceContext, D3D12_HEAP_TYPE heapType, size_t size);
+                HeapAllocation(const HeapRingAllocator::Allocation& allocation, size_t size);
                 ~HeapAllocation();
 
-                void* Map() const override;
-                void Unmap() const override;
+                void* Map() const override { return mappedData_; }
+                void Unmap() const override { }
+                void Invalidate(size_t offset, size_t size) const override;
+                void Flush(size_t offset, size_t size) const override;
 
                 ComSharedPtr<ID3D12Resource> GetD3DResouce() const;
-                size_t GetOffset() const { return 0; }
+                size_t GetOffset() const { return offset_; }
+                // Null for dedicated heap.
+                const std::shared_ptr<HeapRingAllocator::Page>& GetPage() const { return page_; }
 
             private:
-                mutable bool isMapped_ = false;
+                uint8_t* mappedData_ = nullptr;
                 size_t size_;
+                size_t offset_ = 0;
                 D3D12_HEAP_TYPE heapType_;
                 std::shared_ptr<ResourceImpl> resource_;
+                std::shared_ptr<HeapRingAllocator::Page> page_;
             };
 
-            class CpuResourceDataAllocator
+            class CpuResourceDataAllocator final : private NonCopyable
             {
             public:
-                static std::shared_ptr<CpuResourceData> const CpuResourceDataAllocator::Alloc(
+                static constexpr size_t UploadPageSize = 4 * 1024 * 1024;
+
+                CpuResourceDataAllocator(DeviceContext& deviceContext) : deviceContext_(deviceContext), footprintCache_(deviceContext) { }
+                ~CpuResourceDataAllocator();
+
+                void Init();
+                void Terminate();
+
+                std::shared_ptr<CpuResourceData> Alloc(
                     const GpuResourceDescription& resourceDesc,
                     MemoryAllocationType memoryType,
                     uint32_t firstSubresourceIndex,
                     uint32_t numSubresources);
+
+                // Constants are copied into upload ring range. Command list using them keeps the page until its submit.
+                HeapRingAllocator::Allocation AllocateConstants(const void* data, size_t size);
+
+                // Raw upload ring range, same lifetime rules as constants. Size is limited by UploadPageSize.
+                HeapRingAllocator::Allocation AllocateUpload(size_t size);
+
+            private:
+                IMemoryAllocation* allocateHeap(D3D12_HEAP_TYPE heapType, size_t size);
+
+            private:
+                static constexpr size_t ReadbackPageSize = 4 * 1024 * 1024;
+
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                std::unique_ptr<HeapRingAllocator> uploadRing_;
+                std::unique_ptr<HeapRingAllocator> readbackRing_;
+                ResourceFootprintCache footprintCache_;
             };
         }
     }
@@ -2,9 +2,11 @@
 
 #include "gapi/Buffer.hpp"
 #include "gapi/Device.hpp"
+#include "gapi/Sampler.hpp"
 #include "gapi/SwapChain.hpp"
 #include "gapi/Texture.hpp"
 
+#include <algorithm>
 #include <comdef.h>
 
 namespace RR
@@ -122,6 +124,31 @@ namespace RR
                     return desc;
                 }
 
+                bool GetOptimizedClearValue(const GpuResourceDescription& resourceDesc, D3D12_CLEAR_VALUE& value)
+                {
+                    const auto bindFlags = resourceDesc.GetBindFlags();
+                    if (!IsAny(bindFlags, GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil))
+                        return false;
+
+                    const auto& clearValue = resourceDesc.GetOptimizedClearValue();
+                    value.Format = GetDxgiResourceFormat(resourceDesc.GetFormat());
+
+                    if (IsSet(bindFlags, GpuResourceBindFlags::DepthStencil))
+                    {
+                        value.DepthStencil.Depth = clearValue.depth;
+                        value.DepthStencil.Stencil = clearValue.stencil;
+                    }
+                    else
+                    {
+                        value.Color[0] = clearValue.color[0];
+                        value.Color[1] = clearValue.color[1];
+                        value.Color[2] = clearValue.color[2];
+                        value.Color[3] = clearValue.color[3];
+                    }
+
+                    return true;
+                }
+
                 /*
                 * TODO BUFFER SUPPORT
                 D3D12_RESOURCE_DESC GetResourceDesc(const BufferDescription& resourceDesc)
@@ -135,6 +162,96 @@ namespace RR
                     return desc;
                 }*/
 
+                D3D12_FILTER GetFilter(const SamplerDescription& description)
+                {
+                    const auto isComparison = description.comparison != SamplerComparison::None;
+
+                    if (description.minFilter == SamplerFilter::Anisotropic || description.magFilter == SamplerFilter::Anisotropic)
+                        return isComparison ? D3D12_FILTER_COMPARISON_ANISOTROPIC : D3D12_FILTER_ANISOTROPIC;
+
+                    const auto getFilterType = [](SamplerFilter filter) {
+                        return filter == SamplerFilter::Point ? D3D12_FILTER_TYPE_POINT : D3D12_FILTER_TYPE_LINEAR;
+                    };
+
+                    return D3D12_ENCODE_BASIC_FILTER(getFilterType(description.minFilter),
+                                                     getFilterType(description.magFilter),
+                                                     getFilterType(description.mipFilter),
+                                                     isComparison ? D3D12_FILTER_REDUCTION_TYPE_COMPARISON : D3D12_FILTER_REDUCTION_TYPE_STANDARD);
+                }
+
+                D3D12_TEXTURE_ADDRESS_MODE GetAddressMode(SamplerAddressMode addressMode)
+                {
+                    switch (addressMode)
+                    {
+                        case SamplerAddressMode::Wrap: return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+                        case SamplerAddressMode::Mirror: return D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
+                        case SamplerAddressMode::Clamp: return D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+                        case SamplerAddressMode::Border: return D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+                        case SamplerAddressMode::MirrorOnce: return D3D12_TEXTURE_ADDRESS_MODE_MIRROR_ONCE;
+                        default: LOG_FATAL("Unsupported address mode");
+                    }
+
+                    return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+                }
+
+                D3D12_COMPARISON_FUNC GetComparisonFunc(SamplerComparison comparison)
+                {
+                    static_assert(static_cast<uint32_t>(SamplerComparison::Always) == D3D12_COMPARISON_FUNC_ALWAYS);
+                    return comparison == SamplerComparison::None ? D3D12_COMPARISON_FUNC_NEVER : static_cast<D3D12_COMPARISON_FUNC>(comparison);
+                }
+
+                D3D12_SAMPLER_DESC GetSamplerDesc(const SamplerDescription& description)
+                {
+                    ASSERT(description.maxAnisotropy >= 1 && description.maxAnisotropy <= D3D12_MAX_MAXANISOTROPY);
+
+                    D3D12_SAMPLER_DESC output = {};
+                    output.Filter = GetFilter(description);
+                    output.AddressU = GetAddressMode(description.addressU);
+                    output.AddressV = GetAddressMode(description.addressV);
+                    output.AddressW = GetAddressMode(description.addressW);
+                    output.MipLODBias = description.mipLodBias;
+                    output.MaxAnisotropy = description.maxAnisotropy;
+                    output.ComparisonFunc = GetComparisonFunc(description.comparison);
+                    output.MinLOD = description.minLod;
+                    output.MaxLOD = description.maxLod;
+
+                    const float white = description.borderColor == SamplerBorderColor::OpaqueWhite ? 1.0f : 0.0f;
+                    const float alpha = description.borderColor == SamplerBorderColor::TransparentBlack ? 0.0f : 1.0f;
+                    output.BorderColor[0] = output.BorderColor[1] = output.BorderColor[2] = white;
+                    output.BorderColor[3] = alpha;
+
+                    return output;
+                }
+
+                D3D12_STATIC_SAMPLER_DESC GetStaticSamplerDesc(const SamplerDescription& description, uint32_t shaderRegister, uint32_t registerSpace)
+                {
+                    const auto& samplerDesc = GetSamplerDesc(description);
+
+                    D3D12_STATIC_SAMPLER_DESC output = {};
+                    output.Filter = samplerDesc.Filter;
+                    output.AddressU = samplerDesc.AddressU;
+                    output.AddressV = samplerDesc.AddressV;
+                    output.AddressW = samplerDesc.AddressW;
+                    output.MipLODBias = samplerDesc.MipLODBias;
+                    output.MaxAnisotropy = samplerDesc.MaxAnisotropy;
+                    output.ComparisonFunc = samplerDesc.ComparisonFunc;
+                    output.MinLOD = samplerDesc.MinLOD;
+                    output.MaxLOD = samplerDesc.MaxLOD;
+                    output.ShaderRegister = shaderRegister;
+                    output.RegisterSpace = registerSpace;
+                    output.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+                    static_assert(static_cast<uint32_t>(SamplerBorderColor::OpaqueWhite) == 2);
+                    constexpr D3D12_STATIC_BORDER_COLOR borderColors[] = {
+                        D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK,
+                        D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK,
+                        D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE,
+                    };
+                    output.BorderColor = borderColors[static_cast<uint32_t>(description.borderColor)];
+
+                    return output;
+                }
+
                 bool SwapChainDesc1MatchesForReset(const DXGI_SWAP_CHAIN_DESC1& left, const DXGI_SWAP_CHAIN_DESC1& right)
                 {
                     return (left.Stereo == right.Stereo &&
@@ -163,38 +280,63 @@ namespace RR
                     output.SwapEffect = swapEffect;
                     output.AlphaMode = DXGI_ALPHA_MODE_IGNORE;
                     output.Flags = 0;
+
+                    if (description.maxFrameLatency > 0)
+                        output.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+                    if (description.allowTearing)
+                        output.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+
                     return output;
                 }
 
-                // Todo replace to void
-                HRESULT GetAdapter(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel, ComSharedPtr<IDXGIAdapter1>& adapter)
+                std::vector<AdapterDescription> EnumerateAdapters(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel)
                 {
-                    HRESULT result = E_FAIL;
+                    std::vector<AdapterDescription> adapters;
 
-                    for (uint32_t adapterIndex = 0;; ++adapterIndex)
+                    ComSharedPtr<IDXGIAdapter1> adapter;
+                    for (uint32_t adapterIndex = 0; SUCCEEDED(dxgiFactory->EnumAdapters1(adapterIndex, adapter.put())); ++adapterIndex)
                     {
-                        if (FAILED(result = dxgiFactory->EnumAdapters1(adapterIndex, adapter.put())))
-                            break;
-
                         DXGI_ADAPTER_DESC1 desc;
-                        if (FAILED(result = adapter->GetDesc1(&desc)))
-                            break;
+                        if (FAILED(adapter->GetDesc1(&desc)))
+                            continue;
 
+                        // Don't select the software adapter.
                         if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
-                        {
-                            // Don't select the software adapter.
                             continue;
-                        }
 
                         // Check to see if the adapter supports Direct3D 12, but don't create the actual device yet.
-                        if (SUCCEEDED(result = D3D12CreateDevice(adapter.get(), minimumFeatureLevel, _uuidof(ID3D12Device), nullptr)))
-                        {
-                            Log::Print::Info("Direct3D Adapter (%u): VID:%04X, PID:%04X - %ls\n", adapterIndex, desc.VendorId, desc.DeviceId, StringConversions::WStringToUTF8(desc.Description));
-                            break;
-                        }
+                        if (FAILED(D3D12CreateDevice(adapter.get(), minimumFeatureLevel, _uuidof(ID3D12Device), nullptr)))
+                            continue;
+
+                        adapters.push_back({ adapterIndex,
+                                             StringConversions::WStringToUTF8(desc.Description),
+                                             desc.VendorId,
+                                             desc.DeviceId,
+                                             desc.DedicatedVideoMemory });
                     }
 
-                    return result;
+                    return adapters;
+                }
+
+                // Todo replace to void
+                HRESULT GetAdapter(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel, uint32_t adapterIndex, ComSharedPtr<IDXGIAdapter1>& adapter)
+                {
+                    const auto& adapters = EnumerateAdapters(dxgiFactory, minimumFeatureLevel);
+
+                    const auto it = std::find_if(adapters.begin(), adapters.end(), [adapterIndex](const AdapterDescription& description) {
+                        return adapterIndex == IDevice::Description::AnyAdapter || description.index == adapterIndex;
+                    });
+
+                    if (it == adapters.end())
+                        return DXGI_ERROR_NOT_FOUND;
+
+                    HRESULT result;
+                    if (FAILED(result = dxgiFactory->EnumAdapters1(it->index, adapter.put())))
+                        return result;
+
+                    Log::Print::Info("Direct3D Adapter (%u): VID:%04X, PID:%04X - %s\n", it->index, it->vendorId, it->deviceId, it->name.c_str());
+                    return S_OK;
                 }
             }
         }
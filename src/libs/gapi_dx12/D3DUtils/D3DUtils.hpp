@@ -10,6 +10,7 @@ namespace RR
 {
     namespace GAPI
     {
+        struct AdapterDescription;
         struct PresentOptions;
 
         namespace DX12
@@ -28,43 +29,55 @@ namespace RR
     }
 
 #ifdef ENABLE_API_OBJECT_NAMES
-                template <typename T>
-                struct D3D12TypeName
+                template <typename Type>
+                constexpr const char* GetD3D12TypeName()
                 {
-                    static U8String name;
-                };
-
-                template <>
-                U8String D3D12TypeName<ID3D12Fence>::name = "Fence";
-                U8String D3D12TypeName<ID3D12Device>::name = "Device";
-                U8String D3D12TypeName<ID3D12GraphicsCommandList>::name = "CommandList";
-                U8String D3D12TypeName<ID3D12CommandAllocator>::name = "Allocator";
-                U8String D3D12TypeName<ID3D12Resource>::name = "Resource";
-                U8String D3D12TypeName<ID3D12DescriptorHeap>::name = "DescriptorHeap";
-                U8String D3D12TypeName<ID3D12CommandQueue>::name = "CommandQueue";
+                    // Base interfaces, so newer revisions like ID3D12Device5 resolve as well.
+                    if constexpr (std::is_base_of_v<ID3D12Fence, Type>)
+                        return "Fence";
+                    else if constexpr (std::is_base_of_v<ID3D12Device, Type>)
+                        return "Device";
+                    else if constexpr (std::is_base_of_v<ID3D12GraphicsCommandList, Type>)
+                        return "CommandList";
+                    else if constexpr (std::is_base_of_v<ID3D12CommandAllocator, Type>)
+                        return "Allocator";
+                    else if constexpr (std::is_base_of_v<ID3D12Resource, Type>)
+                        return "Resource";
+                    else if constexpr (std::is_base_of_v<ID3D12DescriptorHeap, Type>)
+                        return "DescriptorHeap";
+                    else if constexpr (std::is_base_of_v<ID3D12CommandQueue, Type>)
+                        return "CommandQueue";
+                    else if constexpr (std::is_base_of_v<ID3D12Heap, Type>)
+                        return "Heap";
+                    else if constexpr (std::is_base_of_v<ID3D12PipelineState, Type>)
+                        return "PipelineState";
+                    else if constexpr (std::is_base_of_v<ID3D12RootSignature, Type>)
+                        return "RootSignature";
+                    else
+                        return "Object";
+                }
 
                 template <typename T>
                 inline void SetAPIName(const T& apiObject, const U8String& name)
                 {
                     using Type = std::remove_pointer<T>::type;
                     static_assert(std::is_base_of<ID3D12Object, Type>::value, "Wrong type for FormatAPIName");
-                    apiObject->SetName(StringConversions::UTF8ToWString(fmt::format(FMT_STRING("{}::{}"), D3D12TypeName<Type>::name, name)).c_str());
+                    apiObject->SetName(StringConversions::UTF8ToWString(fmt::format(FMT_STRING("{}::{}"), GetD3D12TypeName<Type>(), name)).c_str());
                 }
 
-                template <typename T>
-                inline void SetAPIName(const T& apiObject, const U8String& name, int index)
+                // Name is formatted only when names are enabled, call sites don't pay for it in shipping builds.
+                template <typename T, typename Arg, typename... Args>
+                inline void SetAPIName(const T& apiObject, const char* format, const Arg& arg, const Args&... args)
                 {
-                    using Type = std::remove_pointer<T>::type;
-                    static_assert(std::is_base_of<ID3D12Object, Type>::value, "Wrong type for FormatAPIName");
-                    apiObject->SetName(StringConversions::UTF8ToWString(fmt::format(FMT_STRING("{}::{}_{:02}"), D3D12TypeName<Type>::name, name, index)).c_str());
+                    SetAPIName(apiObject, fmt::sprintf(format, arg, args...));
                 }
 #else
                 template <typename T>
                 inline void SetAPIName(const T&, const U8String&)
                 {
                 }
-                template <typename T>
-                inline void SetAPIName(const T&, const U8String&, int)
+                template <typename T, typename Arg, typename... Args>
+                inline void SetAPIName(const T&, const char*, const Arg&, const Args&...)
                 {
                 }
 #endif
@@ -72,12 +85,20 @@ namespace RR
 
                 D3D12_RESOURCE_FLAGS GetResourceFlags(GpuResourceBindFlags flags);
                 D3D12_RESOURCE_DESC GetResourceDesc(const GpuResourceDescription& resourceDesc);
+                // False for resources without render target or depth stencil bindings, they have no clear value.
+                bool GetOptimizedClearValue(const GpuResourceDescription& resourceDesc, D3D12_CLEAR_VALUE& value);
+
+                D3D12_SAMPLER_DESC GetSamplerDesc(const SamplerDescription& description);
+                D3D12_STATIC_SAMPLER_DESC GetStaticSamplerDesc(const SamplerDescription& description, uint32_t shaderRegister, uint32_t registerSpace);
 
                 bool SwapChainDesc1MatchesForReset(const DXGI_SWAP_CHAIN_DESC1& left, const DXGI_SWAP_CHAIN_DESC1& right);
                 DXGI_SWAP_CHAIN_DESC1 GetDxgiSwapChainDesc1(const PresentOptions& presentOptions, DXGI_SWAP_EFFECT swapEffect);
                 DXGI_SWAP_CHAIN_DESC1 GetDxgiSwapChainDesc1(const SwapChainDescription& description, DXGI_SWAP_EFFECT swapEffect);
 
-                HRESULT GetAdapter(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel, ComSharedPtr<IDXGIAdapter1>& Adapter);
+                // Hardware adapters supporting D3D12 in enumeration order.
+                std::vector<AdapterDescription> EnumerateAdapters(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel);
+                // Adapter with enumeration index or the first suitable one for IDevice::Description::AnyAdapter.
+                HRESULT GetAdapter(const ComSharedPtr<IDXGIFactory1>& dxgiFactory, D3D_FEATURE_LEVEL minimumFeatureLevel, uint32_t adapterIndex, ComSharedPtr<IDXGIAdapter1>& Adapter);
             }
         }
     }
@@ -2,8 +2,12 @@
 
 #include "gapi/GpuResource.hpp"
 
+#include "gapi_dx12/BindlessDescriptorHeap.hpp"
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/ResourceImpl.hpp"
+#include "gapi_dx12/SamplerDescriptorHeap.hpp"
+
+#include <algorithm>
 
 namespace RR
 {
@@ -13,6 +17,15 @@ namespace RR
         {
             namespace
             {
+                // Raw views address 32 bit words.
+                uint32_t getBufferElementSize(const GpuResourceDescription& gpuResDesc, const GpuResourceViewDescription& viewDesc)
+                {
+                    if (gpuResDesc.GetStructSize() > 0)
+                        return gpuResDesc.GetStructSize();
+
+                    return gpuResDesc.IsTyped() ? GpuResourceFormatInfo::GetBlockSize(viewDesc.format) : sizeof(uint32_t);
+                }
+
                 template <typename DescType>
                 DescType getViewDimension(GpuResourceDimension dimension, bool isTextureArray);
 
@@ -147,8 +160,7 @@ namespace RR
                                 result.Texture2D.MipSlice = viewDesc.texture.mipLevel;
                             break;
                         case GpuResourceDimension::Texture2DMS:
-                            LOG_FATAL("Unsupported resource view type");
-                            //ASSERT(std::is_same<DescType, D3D12_DEPTH_STENCIL_VIEW_DESC>::value || std::is_same<DescType, D3D12_RENDER_TARGET_VIEW_DESC>::value)
+                            // No mips, array range is set by createDsvRtvDesc. Multisampled UAVs fail at view dimension already.
                             break;
                         default:
                             LOG_FATAL("Unsupported resource view type");
@@ -167,35 +179,226 @@ namespace RR
                     if ((GpuResourceDescription.GetDimension() == GpuResourceDimension::Texture2DMS) &&
                         (GpuResourceDescription.GetArraySize() > 1))
                     {
-                        result.Texture2DMSArray.ArraySize = description.texture.firstArraySlice;
-                        result.Texture2DMSArray.FirstArraySlice = description.texture.arraySliceCount;
+                        result.Texture2DMSArray.FirstArraySlice = description.texture.firstArraySlice;
+                        result.Texture2DMSArray.ArraySize = description.texture.arraySliceCount;
                     }
 
                     return result;
                 }
 
-                D3D12_DEPTH_STENCIL_VIEW_DESC createDsvDesc(const GpuResource::SharedPtr& resource, const GpuResourceViewDescription& description)
+                D3D12_DEPTH_STENCIL_VIEW_DESC createDsvDesc(const GpuResourceDescription& resourceDesc, const GpuResourceViewDescription& description)
                 {
-                    return createDsvRtvDesc<D3D12_DEPTH_STENCIL_VIEW_DESC>(resource->GetDescription(), description);
+                    return createDsvRtvDesc<D3D12_DEPTH_STENCIL_VIEW_DESC>(resourceDesc, description);
                 }
 
-                D3D12_RENDER_TARGET_VIEW_DESC createRtvDesc(const GpuResource::SharedPtr& resource, const GpuResourceViewDescription& description)
+                D3D12_RENDER_TARGET_VIEW_DESC createRtvDesc(const GpuResourceDescription& resourceDesc, const GpuResourceViewDescription& description)
                 {
-                    return createDsvRtvDesc<D3D12_RENDER_TARGET_VIEW_DESC>(resource->GetDescription(), description);
+                    return createDsvRtvDesc<D3D12_RENDER_TARGET_VIEW_DESC>(resourceDesc, description);
                 }
 
-                D3D12_UNORDERED_ACCESS_VIEW_DESC createUavDesc(const GpuResource::SharedPtr& resource, const GpuResourceViewDescription& description)
+                D3D12_SHADER_RESOURCE_VIEW_DESC createSrvDesc(const GpuResourceDescription& gpuResDesc, const GpuResourceViewDescription& viewDesc)
                 {
-                    return createDsvRtvUavDescCommon<D3D12_UNORDERED_ACCESS_VIEW_DESC>(resource->GetDescription(), description);
+
+                    D3D12_SHADER_RESOURCE_VIEW_DESC result = {};
+                    result.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+
+                    const uint32_t arraySize = (gpuResDesc.GetDimension() == GpuResourceDimension::Buffer) ? 1 : gpuResDesc.GetArraySize();
+                    const bool isTextureArray = arraySize > 1;
+
+                    switch (gpuResDesc.GetDimension())
+                    {
+                        case GpuResourceDimension::Buffer:
+                            result.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+                            result.Buffer.FirstElement = viewDesc.buffer.firstElement;
+                            result.Buffer.NumElements = viewDesc.buffer.elementCount;
+                            result.Buffer.StructureByteStride = gpuResDesc.GetStructSize();
+
+                            if (!gpuResDesc.IsTyped() && gpuResDesc.GetStructSize() == 0)
+                            {
+                                result.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
+                                result.Format = D3DUtils::GetDxgiTypelessFormat(viewDesc.format);
+                            }
+                            else
+                            {
+                                result.Format = gpuResDesc.GetStructSize() > 0 ? DXGI_FORMAT_UNKNOWN : D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            }
+                            break;
+                        case GpuResourceDimension::Texture1D:
+                            result.Format = D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            if (isTextureArray)
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
+                                result.Texture1DArray.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.Texture1DArray.MipLevels = viewDesc.texture.mipCount;
+                                result.Texture1DArray.FirstArraySlice = viewDesc.texture.firstArraySlice;
+                                result.Texture1DArray.ArraySize = viewDesc.texture.arraySliceCount;
+                            }
+                            else
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1D;
+                                result.Texture1D.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.Texture1D.MipLevels = viewDesc.texture.mipCount;
+                            }
+                            break;
+                        case GpuResourceDimension::Texture2D:
+                            result.Format = D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            if (isTextureArray)
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                                result.Texture2DArray.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.Texture2DArray.MipLevels = viewDesc.texture.mipCount;
+                                result.Texture2DArray.FirstArraySlice = viewDesc.texture.firstArraySlice;
+                                result.Texture2DArray.ArraySize = viewDesc.texture.arraySliceCount;
+                            }
+                            else
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+                                result.Texture2D.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.Texture2D.MipLevels = viewDesc.texture.mipCount;
+                            }
+                            break;
+                        case GpuResourceDimension::Texture2DMS:
+                            result.Format = D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            if (isTextureArray)
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY;
+                                result.Texture2DMSArray.FirstArraySlice = viewDesc.texture.firstArraySlice;
+                                result.Texture2DMSArray.ArraySize = viewDesc.texture.arraySliceCount;
+                            }
+                            else
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMS;
+                            }
+                            break;
+                        case GpuResourceDimension::Texture3D:
+                            result.Format = D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+                            result.Texture3D.MostDetailedMip = viewDesc.texture.mipLevel;
+                            result.Texture3D.MipLevels = viewDesc.texture.mipCount;
+                            break;
+                        case GpuResourceDimension::TextureCube:
+                            result.Format = D3DUtils::GetDxgiResourceFormat(viewDesc.format);
+                            if (isTextureArray)
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
+                                result.TextureCubeArray.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.TextureCubeArray.MipLevels = viewDesc.texture.mipCount;
+                                result.TextureCubeArray.First2DArrayFace = viewDesc.texture.firstArraySlice * 6;
+                                result.TextureCubeArray.NumCubes = viewDesc.texture.arraySliceCount;
+                            }
+                            else
+                            {
+                                result.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+                                result.TextureCube.MostDetailedMip = viewDesc.texture.mipLevel;
+                                result.TextureCube.MipLevels = viewDesc.texture.mipCount;
+                            }
+                            break;
+                        default:
+                            LOG_FATAL("Unsupported resource view type");
+                    }
+
+                    return result;
                 }
 
-                std::shared_ptr<DescriptorHeap> createDescpriptiorHeap(const DescriptorHeap::DescriptorHeapDesc& desc)
+                D3D12_UNORDERED_ACCESS_VIEW_DESC createUavDesc(const GpuResourceDescription& resourceDesc, const GpuResourceViewDescription& description)
                 {
-                    const auto& heap = std::make_shared<DescriptorHeap>();
-                    heap->Init(desc);
+                    return createDsvRtvUavDescCommon<D3D12_UNORDERED_ACCESS_VIEW_DESC>(resourceDesc, description);
+                }
+            }
+
+            DescriptorHeapChain::DescriptorHeapChain(DeviceContext& deviceContext, const DescriptorHeap::DescriptorHeapDesc& pageDesc)
+                : deviceContext_(deviceContext),
+                  pageDesc_(pageDesc)
+            {
+                ASSERT(pageDesc_.numDescriptors_ > 0);
+            }
+
+            std::shared_ptr<DescriptorHeapChain::Page> DescriptorHeapChain::createPage(size_t index) const
+            {
+                auto desc = pageDesc_;
+                desc.name = fmt::sprintf("%s Page:%u", pageDesc_.name, index);
 
-                    return heap;
+                auto page = std::make_shared<Page>();
+                page->heap = std::make_shared<DescriptorHeap>(deviceContext_);
+                page->heap->Init(desc);
+                page->lastUsedFrame = frameIndex_.load(std::memory_order_relaxed);
+
+                return page;
+            }
+
+            bool DescriptorHeapChain::tryAllocate(const Pages& pages, DescriptorHeap::Allocation& allocation, uint32_t count) const
+            {
+                // Most recent pages are likely to have free space.
+                for (auto it = pages.rbegin(); it != pages.rend(); ++it)
+                {
+                    if ((*it)->heap->TryAllocate(allocation, count))
+                    {
+                        (*it)->lastUsedFrame.store(frameIndex_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void DescriptorHeapChain::Allocate(DescriptorHeap::Allocation& allocation, uint32_t count)
+            {
+                ASSERT(count > 0 && count <= pageDesc_.numDescriptors_);
+
+                if (tryAllocate(*pages_.Read(), allocation, count))
+                    return;
+
+                // Growing is serialized, pages added by other threads meanwhile are tried first.
+                pages_.Update([this, &allocation, count](Pages& pages) {
+                    if (tryAllocate(pages, allocation, count))
+                        return;
+
+                    pages.push_back(createPage(pages.size()));
+                    pages.back()->heap->Allocate(allocation, count);
+                });
+            }
+
+            void DescriptorHeapChain::ReleaseEmptyPages(uint64_t frameIndex)
+            {
+                frameIndex_.store(frameIndex, std::memory_order_relaxed);
+
+                const auto isExpired = [frameIndex](const std::shared_ptr<Page>& page) {
+                    return page->heap->GetAllocatedCount() == 0 && page->lastUsedFrame.load(std::memory_order_relaxed) + EmptyPageGracePeriod < frameIndex;
+                };
+
+                bool hasExpired = false;
+                {
+                    const auto pages = pages_.Read();
+                    for (size_t index = 0; index < pages->size(); index++)
+                    {
+                        const auto& page = (*pages)[index];
+                        if (page->heap->GetAllocatedCount() > 0)
+                            page->lastUsedFrame.store(frameIndex, std::memory_order_relaxed);
+
+                        // Always keep first page.
+                        hasExpired |= index > 0 && isExpired(page);
+                    }
                 }
+
+                // Pages list is copied only when there is something to release. Expired page could be allocated from
+                // by thread still reading previous list, allocation holds the heap alive then.
+                if (hasExpired)
+                    pages_.Update([&isExpired](Pages& pages) {
+                        if (pages.size() > 1)
+                            pages.erase(std::remove_if(pages.begin() + 1, pages.end(), isExpired), pages.end());
+                    });
+            }
+
+            DescriptorHeapOccupancy DescriptorHeapChain::GetOccupancy() const
+            {
+                const auto pages = pages_.Read();
+
+                DescriptorHeapOccupancy occupancy;
+                for (const auto& page : *pages)
+                    occupancy.allocatedCount += page->heap->GetAllocatedCount();
+
+                occupancy.capacity = static_cast<uint32_t>(pages->size()) * pageDesc_.numDescriptors_;
+                return occupancy;
             }
 
             void DescriptorAllocator::Init()
@@ -205,25 +408,30 @@ namespace RR
                 {
                     DescriptorHeap::DescriptorHeapDesc desription;
 
-                    desription.numDescriptors_ = 1000;
+                    desription.numDescriptors_ = HeapPageSize;
                     desription.name = "CpuCvbUavSrv";
                     desription.type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
                     desription.flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
-                    cbvUavSrvDescriptorHeap_ = createDescpriptiorHeap(desription);
+                    cbvUavSrvDescriptorHeapChain_ = std::make_unique<DescriptorHeapChain>(deviceContext_, desription);
                 }
 
                 {
                     DescriptorHeap::DescriptorHeapDesc desription;
 
-                    desription.numDescriptors_ = 1000;
+                    desription.numDescriptors_ = HeapPageSize;
                     desription.name = "CpuRtv";
                     desription.type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
                     desription.flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
-                    rtvDescriptorHeap_ = createDescpriptiorHeap(desription);
+                    rtvDescriptorHeapChain_ = std::make_unique<DescriptorHeapChain>(deviceContext_, desription);
                 }
 
+                deviceContext_.GetBindlessDescriptorHeap().Init(BindlessHeapSize);
+                deviceContext_.GetSamplerDescriptorHeap().Init();
+
+                descriptorSize_ = deviceContext_.GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
                 isInited_ = true;
             }
 
@@ -231,12 +439,25 @@ namespace RR
             {
                 ASSERT(isInited_);
 
-                cbvUavSrvDescriptorHeap_ = nullptr;
-                rtvDescriptorHeap_ = nullptr;
+                // Views are released already, pending copies have no readers.
+                pendingCopies_.clear();
+
+                cbvUavSrvDescriptorHeapChain_ = nullptr;
+                rtvDescriptorHeapChain_ = nullptr;
+
+                deviceContext_.GetBindlessDescriptorHeap().Terminate();
+                deviceContext_.GetSamplerDescriptorHeap().Terminate();
 
                 isInited_ = false;
             }
 
+            uint32_t DescriptorAllocator::AllocateSampler(const SamplerDescription& description)
+            {
+                ASSERT(isInited_);
+
+                return deviceContext_.GetSamplerDescriptorHeap().GetOrCreate(description);
+            }
+
             void DescriptorAllocator::Allocate(GpuResourceView& resourceView)
             {
                 ASSERT(isInited_);
@@ -247,33 +468,194 @@ namespace RR
                 const auto resourcePrivateImpl = resourceSharedPtr->GetPrivateImpl<ResourceImpl>();
                 ASSERT(resourcePrivateImpl);
 
-                const auto& resourceD3dObject = resourcePrivateImpl->GetD3DObject();
-                ASSERT(resourceD3dObject);
-
                 auto allocation = std::make_unique<DescriptorHeap::Allocation>();
+                Allocate(*resourcePrivateImpl, resourceSharedPtr->GetDescription(), resourceView.GetViewType(), resourceView.GetDescription(), *allocation);
+
+                resourceView.SetPrivateImpl(allocation.release());
+            }
+
+            void DescriptorAllocator::Allocate(
+                const ResourceImpl& resourceImpl,
+                const GpuResourceDescription& resourceDesc,
+                GpuResourceView::ViewType viewType,
+                const GpuResourceViewDescription& viewDesc,
+                DescriptorHeap::Allocation& allocation)
+            {
+                ASSERT(isInited_);
+
+                switch (viewType)
+                {
+                    case GpuResourceView::ViewType::RenderTargetView:
+                        rtvDescriptorHeapChain_->Allocate(allocation);
+                        break;
+                    case GpuResourceView::ViewType::ShaderResourceView:
+                    case GpuResourceView::ViewType::UnorderedAccessView:
+                        cbvUavSrvDescriptorHeapChain_->Allocate(allocation);
+                        // Shader visible copy of view descriptor.
+                        allocation.SetBindlessIndex(deviceContext_.GetBindlessDescriptorHeap().Allocate());
+                        break;
+                    default:
+                        LOG_FATAL("Unsupported resource view type");
+                }
+
+                writeDescriptor(resourceImpl, resourceDesc, viewType, viewDesc, allocation);
+            }
+
+            void DescriptorAllocator::Rewrite(GpuResourceView& resourceView)
+            {
+                ASSERT(isInited_);
+
+                const auto& resourceSharedPtr = resourceView.GetGpuResource().lock();
+                ASSERT(resourceSharedPtr);
+
+                const auto resourcePrivateImpl = resourceSharedPtr->GetPrivateImpl<ResourceImpl>();
+                ASSERT(resourcePrivateImpl);
+
+                const auto allocation = resourceView.GetPrivateImpl<DescriptorHeap::Allocation>();
+                ASSERT(allocation);
+
+                writeDescriptor(*resourcePrivateImpl, resourceSharedPtr->GetDescription(), resourceView.GetViewType(), resourceView.GetDescription(), *allocation);
+            }
+
+            void DescriptorAllocator::writeDescriptor(
+                const ResourceImpl& resourceImpl,
+                const GpuResourceDescription& resourceDesc,
+                GpuResourceView::ViewType viewType,
+                const GpuResourceViewDescription& description,
+                const DescriptorHeap::Allocation& allocation) const
+            {
+                const auto d3dResource = resourceImpl.GetD3DObject();
+                const auto resource = d3dResource.get();
+                ASSERT(resource);
+
+                auto viewDesc = description;
+                if (resourceImpl.IsSubAllocated())
+                {
+                    const auto elementSize = getBufferElementSize(resourceDesc, viewDesc);
+                    ASSERT(resourceImpl.GetOffset() % elementSize == 0);
+
+                    viewDesc.buffer.firstElement += static_cast<uint32_t>(resourceImpl.GetOffset() / elementSize);
+                }
 
-                cbvUavSrvDescriptorHeap_->Allocate(*allocation);
+                const auto& device = deviceContext_.GetDevice();
 
-                switch (resourceView.GetViewType())
+                switch (viewType)
                 {
                     case GpuResourceView::ViewType::RenderTargetView:
                     {
-                        const auto& desc = createRtvDesc(resourceSharedPtr, resourceView.GetDescription());
-                        DeviceContext::GetDevice()->CreateRenderTargetView(resourceD3dObject.get(), &desc, allocation->GetCPUHandle());
+                        const auto& desc = createRtvDesc(resourceDesc, viewDesc);
+                        device->CreateRenderTargetView(resource, &desc, allocation.GetCPUHandle());
+                    }
+                    break;
+                    case GpuResourceView::ViewType::ShaderResourceView:
+                    {
+                        const auto& desc = createSrvDesc(resourceDesc, viewDesc);
+                        device->CreateShaderResourceView(resource, &desc, allocation.GetCPUHandle());
                     }
                     break;
                     case GpuResourceView::ViewType::UnorderedAccessView:
                     {
-                        const auto& desc = createUavDesc(resourceSharedPtr, resourceView.GetDescription());
-                        DeviceContext::GetDevice()->CreateUnorderedAccessView(resourceD3dObject.get(), nullptr, &desc, allocation->GetCPUHandle());
+                        const auto& desc = createUavDesc(resourceDesc, viewDesc);
+                        device->CreateUnorderedAccessView(resource, nullptr, &desc, allocation.GetCPUHandle());
                     }
                     break;
                     default:
                         LOG_FATAL("Unsupported resource view type");
                 }
 
-                resourceView.SetPrivateImpl(allocation.release());
+                const auto bindlessIndex = allocation.GetBindlessIndex();
+                if (bindlessIndex != BindlessDescriptorHeap::InvalidIndex)
+                    queueBindlessCopy(bindlessIndex, allocation.GetCPUHandle());
+            }
+
+            void DescriptorAllocator::queueBindlessCopy(uint32_t bindlessIndex, D3D12_CPU_DESCRIPTOR_HANDLE source)
+            {
+                Threading::ReadWriteGuard lock(pendingCopiesLock_);
+                pendingCopies_.push_back({ bindlessIndex, source });
+            }
+
+            void DescriptorAllocator::FlushBindlessCopies()
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard flushLock(flushLock_);
+
+                {
+                    Threading::ReadWriteGuard lock(pendingCopiesLock_);
+                    if (pendingCopies_.empty())
+                        return;
+
+                    std::swap(pendingCopies_, flushedCopies_);
+                }
+
+                // Source of released view could be already rewritten by another view, the copy lands
+                // into bindless slot which is pending release and is never read.
+                const auto& bindlessHeap = deviceContext_.GetBindlessDescriptorHeap();
+
+                destinationStarts_.clear();
+                sourceStarts_.clear();
+                rangeSizes_.clear();
+
+                // Views created in a row usually take adjacent slots in both heaps.
+                for (size_t index = 0; index < flushedCopies_.size(); index++)
+                {
+                    const auto& copy = flushedCopies_[index];
+
+                    if (index > 0)
+                    {
+                        const auto& previous = flushedCopies_[index - 1];
+                        if (copy.bindlessIndex == previous.bindlessIndex + 1 && copy.source.ptr == previous.source.ptr + descriptorSize_)
+                        {
+                            rangeSizes_.back()++;
+                            continue;
+                        }
+                    }
+
+                    destinationStarts_.push_back(bindlessHeap.GetCpuHandle(copy.bindlessIndex));
+                    sourceStarts_.push_back(copy.source);
+                    rangeSizes_.push_back(1);
+                }
+
+                const auto rangesCount = static_cast<UINT>(rangeSizes_.size());
+                deviceContext_.GetDevice()->CopyDescriptors(rangesCount, destinationStarts_.data(), rangeSizes_.data(),
+                                                            rangesCount, sourceStarts_.data(), rangeSizes_.data(),
+                                                            D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+                flushedCopies_.clear();
+            }
+
+            void DescriptorAllocator::MoveToNextFrame(uint64_t frameIndex)
+            {
+                ASSERT(isInited_);
+
+                // Frames without submits still make views created during them visible.
+                FlushBindlessCopies();
+
+                cbvUavSrvDescriptorHeapChain_->ReleaseEmptyPages(frameIndex);
+                rtvDescriptorHeapChain_->ReleaseEmptyPages(frameIndex);
+            }
+
+            DescriptorHeapOccupancy DescriptorAllocator::GetOccupancy(DescriptorHeapType type) const
+            {
+                ASSERT(isInited_);
+
+                switch (type)
+                {
+                    case DescriptorHeapType::CbvSrvUav:
+                        return cbvUavSrvDescriptorHeapChain_->GetOccupancy();
+                    case DescriptorHeapType::RenderTarget:
+                        return rtvDescriptorHeapChain_->GetOccupancy();
+                    case DescriptorHeapType::Bindless:
+                    {
+                        const auto& bindlessHeap = deviceContext_.GetBindlessDescriptorHeap();
+                        return { bindlessHeap.GetAllocatedCount(), bindlessHeap.GetCapacity() };
+                    }
+                    default:
+                        LOG_FATAL("Unsupported descriptor heap type");
+                }
+
+                return {};
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,32 +1,121 @@
 #pragma once
 
-#include "common/Singleton.hpp"
+#include "gapi/DeviceStatistics.hpp"
+
+#include "common/threading/Snapshot.hpp"
+#include "common/threading/SpinLock.hpp"
 
 #include "DescriptorHeap.hpp"
 
+#include <vector>
+
 namespace RR
 {
     namespace GAPI
     {
         namespace DX12
         {
-            class DescriptorAllocator final : public Singleton<DescriptorAllocator>
+            class ResourceImpl;
+
+            // Chain of same type descriptor heap pages. Grows on demand,
+            // pages that stay empty for grace period are released.
+            // Allocation is lock-free: pages list is read-copy-update, only growing and releasing pages copy it.
+            class DescriptorHeapChain final : private NonCopyable
             {
             public:
-                DescriptorAllocator() = default;
+                DescriptorHeapChain(DeviceContext& deviceContext, const DescriptorHeap::DescriptorHeapDesc& pageDesc);
+                ~DescriptorHeapChain() = default;
+
+                // Count contiguous descriptors, no more than page size.
+                void Allocate(DescriptorHeap::Allocation& allocation, uint32_t count = 1);
+                void ReleaseEmptyPages(uint64_t frameIndex);
+                DescriptorHeapOccupancy GetOccupancy() const;
+
+            private:
+                struct Page
+                {
+                    DescriptorHeap::SharedPtr heap;
+                    std::atomic<uint64_t> lastUsedFrame;
+                };
+
+                using Pages = std::vector<std::shared_ptr<Page>>;
+
+                std::shared_ptr<Page> createPage(size_t index) const;
+                bool tryAllocate(const Pages& pages, DescriptorHeap::Allocation& allocation, uint32_t count) const;
+
+            private:
+                static constexpr uint64_t EmptyPageGracePeriod = 120;
+
+                DeviceContext& deviceContext_;
+                DescriptorHeap::DescriptorHeapDesc pageDesc_;
+                std::atomic<uint64_t> frameIndex_ = 0;
+                Threading::Snapshot<Pages> pages_;
+            };
+
+            // Owned by device, reached through DeviceContext::GetDescriptorAllocator.
+            // Views are written into CPU only staging heaps. Their shader visible bindless copies are queued and written
+            // by FlushBindlessCopies with single CopyDescriptors call over coalesced ranges, so write-combined shader visible
+            // heap memory is written in batches rather than once per view.
+            class DescriptorAllocator final : private NonCopyable
+            {
+            public:
+                DescriptorAllocator(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
 
                 void Init();
                 void Terminate();
 
                 void Allocate(GpuResourceView& resourceView);
+                // Views of sub-allocated buffer are shifted by its offset in pooled resource.
+                void Allocate(const ResourceImpl& resource,
+                              const GpuResourceDescription& resourceDesc,
+                              GpuResourceView::ViewType viewType,
+                              const GpuResourceViewDescription& viewDesc,
+                              DescriptorHeap::Allocation& allocation);
+                // Re-creates view descriptors in place after resource backing changed, bindless index is kept.
+                void Rewrite(GpuResourceView& resourceView);
+                // Index in shader visible sampler heap.
+                uint32_t AllocateSampler(const SamplerDescription& description);
+                void MoveToNextFrame(uint64_t frameIndex);
+                // Called before command lists are executed, bindless slots of views created so far are valid then.
+                void FlushBindlessCopies();
+                DescriptorHeapOccupancy GetOccupancy(DescriptorHeapType type) const;
+
+            private:
+                void writeDescriptor(const ResourceImpl& resource,
+                                     const GpuResourceDescription& resourceDesc,
+                                     GpuResourceView::ViewType viewType,
+                                     const GpuResourceViewDescription& viewDesc,
+                                     const DescriptorHeap::Allocation& allocation) const;
 
-                const DescriptorHeap::SharedPtr& GetRtvDescriptorHeap() const { return rtvDescriptorHeap_; }
+                void queueBindlessCopy(uint32_t bindlessIndex, D3D12_CPU_DESCRIPTOR_HANDLE source);
 
             private:
+                static constexpr uint32_t BindlessHeapSize = 1 << 16;
+                static constexpr uint32_t HeapPageSize = 1024;
+
+                struct BindlessCopy
+                {
+                    uint32_t bindlessIndex;
+                    D3D12_CPU_DESCRIPTOR_HANDLE source;
+                };
+
+                DeviceContext& deviceContext_;
                 bool isInited_ = false;
-                DescriptorHeap::SharedPtr rtvDescriptorHeap_;
-                DescriptorHeap::SharedPtr cbvUavSrvDescriptorHeap_;
+                uint32_t descriptorSize_ = 0;
+
+                // Applied in queue order, so the latest write into reused slot wins.
+                Threading::SpinLock pendingCopiesLock_;
+                std::vector<BindlessCopy> pendingCopies_;
+                // Used by flushing thread only, kept to reuse storage.
+                Threading::SpinLock flushLock_;
+                std::vector<BindlessCopy> flushedCopies_;
+                std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> destinationStarts_;
+                std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sourceStarts_;
+                std::vector<UINT> rangeSizes_;
+
+                std::unique_ptr<DescriptorHeapChain> rtvDescriptorHeapChain_;
+                std::unique_ptr<DescriptorHeapChain> cbvUavSrvDescriptorHeapChain_;
             };
         }
     }
-}
\ No newline at end of file
+}
@@ -11,7 +11,7 @@ namespace RR
             DescriptorHeap::~DescriptorHeap()
             {
                 // No any leaks
-                ASSERT(allocated_ == 0);
+                ASSERT(GetAllocatedCount() == 0);
             }
 
             void DescriptorHeap::Init(const DescriptorHeapDesc& desc)
@@ -19,16 +19,15 @@ namespace RR
                 ASSERT(!d3d12Heap_);
                 ASSERT(desc.numDescriptors_ > 0);
 
-                const auto& device = DeviceContext::GetDevice();
+                const auto& device = deviceContext_.GetDevice();
 
                 name_ = desc.name;
                 numDescriptors_ = desc.numDescriptors_;
 
                 descriptorSize_ = device->GetDescriptorHandleIncrementSize(desc.type);
-                uint32_t chunkCount = (numDescriptors_ + Chunk::SIZE - 1) / Chunk::SIZE;
 
                 D3D12_DESCRIPTOR_HEAP_DESC rtvDescriptorHeapDesc = {};
-                rtvDescriptorHeapDesc.NumDescriptors = chunkCount * Chunk::SIZE;
+                rtvDescriptorHeapDesc.NumDescriptors = numDescriptors_;
                 rtvDescriptorHeapDesc.Type = desc.type;
                 rtvDescriptorHeapDesc.Flags = desc.flags;
 
@@ -36,12 +35,30 @@ namespace RR
 
                 D3DUtils::SetAPIName(d3d12Heap_.get(), name_);
 
-                for (uint32_t i = 0; i < chunkCount; i++)
-                {
-                    uint32_t offset = i * Chunk::SIZE;
-                    chunks_.emplace_back(std::make_unique<Chunk>(offset));
-                    freeChunks_.emplace_back(chunks_[i].get());
-                }
+                allocator_.Init(numDescriptors_);
+            }
+
+            bool DescriptorHeap::TryAllocate(Allocation& allocation, uint32_t count)
+            {
+                ASSERT(d3d12Heap_);
+                ASSERT(count > 0);
+
+                // Unlike bindless heap, full page isn't fatal, chain tries the next one.
+                const auto index = allocator_.Allocate(count);
+                if (index == BitmapAllocator::InvalidIndex)
+                    return false;
+
+                allocation = Allocation(shared_from_this(), index, count, getCpuHandle(index), getGpuHandle(index));
+
+                return true;
+            }
+
+            void DescriptorHeap::Free(uint32_t index, uint32_t count)
+            {
+                ASSERT(d3d12Heap_);
+                ASSERT(index < numDescriptors_);
+
+                allocator_.Free(index, count);
             }
         }
     }
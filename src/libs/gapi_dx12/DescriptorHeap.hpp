@@ -1,10 +1,13 @@
 #pragma once
 
-#include <deque>
-#include <limits>
+#include "common/BitmapAllocator.hpp"
 
 #include "gapi/GpuResourceViews.hpp"
 
+#include "gapi_dx12/BindlessDescriptorHeap.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
 namespace RR
 {
     namespace GAPI
@@ -20,50 +23,25 @@ namespace RR
                 struct Allocation;
                 struct DescriptorHeapDesc;
 
-                DescriptorHeap() = default;
+                DescriptorHeap(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
                 ~DescriptorHeap();
 
                 void Init(const DescriptorHeapDesc& desc);
 
-                void Allocate(Allocation& allocation)
+                void Allocate(Allocation& allocation, uint32_t count = 1)
                 {
-                    ASSERT(d3d12Heap_);
-
-                    if (allocated_ >= numDescriptors_)
+                    if (!TryAllocate(allocation, count))
                         LOG_FATAL("Not enough memory in descriptorHeap: %s", name_);
-
-                    ASSERT(!freeChunks_.empty())
-
-                    Chunk* currentChunk = freeChunks_.front();
-
-                    const auto indexInChunk = currentChunk->Alloc();
-                    const auto indexInHeap = indexInChunk + currentChunk->Offset;
-
-                    // Chunk is exhausted
-                    if (currentChunk->GetNumAvailable() == 0)
-                        freeChunks_.pop_front();
-
-                    allocation = Allocation(shared_from_this(), indexInHeap, getCpuHandle(indexInHeap), getGpuHandle(indexInHeap));
-
-                    allocated_++;
                 }
 
-                void Free(uint32_t index)
-                {
-                    ASSERT(d3d12Heap_);
-
-                    const auto chunkIndex = index / Chunk::SIZE;
-                    ASSERT(chunkIndex < chunks_.size());
-
-                    auto& chunk = chunks_[chunkIndex];
-                    chunk->Free(index);
+                // Lock-free, allocating threads don't serialize on the page.
+                // Count descriptors are contiguous, e.g. to be copied into descriptor table with single call.
+                bool TryAllocate(Allocation& allocation, uint32_t count = 1);
+                void Free(uint32_t index, uint32_t count = 1);
 
-                    // Chunk was exhausted
-                    if (chunk->GetNumAvailable() == 1)
-                        freeChunks_.push_back(chunk.get());
-
-                    allocated_--;
-                }
+                uint32_t GetAllocatedCount() const { return allocator_.GetAllocatedCount(); }
+                uint32_t GetCapacity() const { return numDescriptors_; }
+                const U8String& GetName() const { return name_; }
 
             public:
                 struct DescriptorHeapDesc
@@ -82,17 +60,19 @@ namespace RR
 
                     bool operator==(const Allocation& alloc) const
                     {
-                        return (cpuHandle_.ptr == alloc.cpuHandle_.ptr) && (heap_ == alloc.heap_) && (indexInHeap_ == alloc.indexInHeap_);
+                        return (cpuHandle_.ptr == alloc.cpuHandle_.ptr) && (heap_ == alloc.heap_) && (indexInHeap_ == alloc.indexInHeap_) && (count_ == alloc.count_) && (bindlessIndex_ == alloc.bindlessIndex_);
                     }
 
                     bool operator!=(const Allocation& alloc) const { return !(*this == alloc); }
 
                     Allocation& operator=(Allocation&& alloc) noexcept
                     {
-                        static_assert(sizeof(Allocation) == 48);
+                        static_assert(sizeof(Allocation) == 56);
 
                         std::swap(heap_, alloc.heap_);
                         std::swap(indexInHeap_, alloc.indexInHeap_);
+                        std::swap(count_, alloc.count_);
+                        std::swap(bindlessIndex_, alloc.bindlessIndex_);
                         std::swap(cpuHandle_, alloc.cpuHandle_);
                         std::swap(gpuHandle_, alloc.gpuHandle_);
 
@@ -107,18 +87,41 @@ namespace RR
                         return cpuHandle_;
                     }
 
+                    // Handle of descriptor at offset within contiguous allocation.
+                    CD3DX12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(uint32_t offset) const
+                    {
+                        ASSERT(heap_)
+                        ASSERT(offset < count_);
+                        return CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuHandle_, offset, heap_->descriptorSize_);
+                    }
+
+                    uint32_t GetCount() const { return count_; }
+
+                    // Shader visible handle. Points to bindless heap slot when allocation have one.
                     CD3DX12_GPU_DESCRIPTOR_HANDLE GetGPUHandle() const
                     {
                         ASSERT(heap_)
                         return gpuHandle_;
                     }
 
+                    uint32_t GetBindlessIndex() const override { return bindlessIndex_; }
+
+                    void SetBindlessIndex(uint32_t bindlessIndex)
+                    {
+                        ASSERT(heap_);
+                        ASSERT(bindlessIndex_ == BindlessDescriptorHeap::InvalidIndex);
+
+                        bindlessIndex_ = bindlessIndex;
+                        gpuHandle_ = heap_->deviceContext_.GetBindlessDescriptorHeap().GetGpuHandle(bindlessIndex);
+                    }
+
                 private:
                     friend DescriptorHeap;
 
-                    Allocation(const DescriptorHeap::SharedPtr& heap, uint32_t indexInHeap, CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle, CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle)
+                    Allocation(const DescriptorHeap::SharedPtr& heap, uint32_t indexInHeap, uint32_t count, CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle, CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle)
                         : heap_(heap),
                           indexInHeap_(indexInHeap),
+                          count_(count),
                           cpuHandle_(cpuHandle),
                           gpuHandle_(gpuHandle)
                     {
@@ -128,10 +131,19 @@ namespace RR
                     void release()
                     {
                         if (heap_)
-                            heap_->Free(indexInHeap_);
+                            heap_->Free(indexInHeap_, count_);
+
+                        // Slot could be still referenced by GPU.
+                        if (bindlessIndex_ != BindlessDescriptorHeap::InvalidIndex)
+                        {
+                            ASSERT(heap_);
+                            heap_->deviceContext_.GetResourceReleaseContext().DeferredBindlessSlotRelease(bindlessIndex_);
+                        }
 
                         heap_ = nullptr;
                         indexInHeap_ = 0;
+                        count_ = 0;
+                        bindlessIndex_ = BindlessDescriptorHeap::InvalidIndex;
                         cpuHandle_ = CD3DX12_DEFAULT();
                         gpuHandle_ = CD3DX12_DEFAULT();
                     }
@@ -139,47 +151,13 @@ namespace RR
                 private:
                     DescriptorHeap::SharedPtr heap_ = nullptr;
                     uint32_t indexInHeap_ = 0;
+                    uint32_t count_ = 0;
+                    uint32_t bindlessIndex_ = BindlessDescriptorHeap::InvalidIndex;
                     CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle_ = CD3DX12_DEFAULT();
                     CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle_ = CD3DX12_DEFAULT();
                 };
 
             private:
-                struct Chunk
-                {
-                    static constexpr uint32_t SIZE = std::numeric_limits<uint8_t>::max() + 1; // 256
-                    uint32_t Offset;
-
-                    Chunk(uint32_t offset) : Offset(offset)
-                    {
-                        for (int i = 0; i < SIZE; i++)
-                            indices_[i] = i;
-                    }
-
-                    inline uint32_t Alloc()
-                    {
-                        ASSERT(cursor_ < SIZE)
-                        return static_cast<uint32_t>(indices_[cursor_++]);
-                    }
-
-                    inline void Free(uint32_t index)
-                    {
-                        ASSERT(index < Chunk::SIZE)
-                        ASSERT(index >= Offset && index < Offset + Chunk::SIZE)
-                        const uint8_t indexInChunk = static_cast<uint8_t>(index - Offset);
-
-                        indices_[--cursor_] = indexInChunk;
-                    }
-
-                    inline uint32_t GetNumAvailable() const
-                    {
-                        return SIZE - cursor_;
-                    }
-
-                private:
-                    std::array<uint8_t, SIZE> indices_;
-                    uint32_t cursor_ = 0;
-                };
-
                 CD3DX12_CPU_DESCRIPTOR_HANDLE getCpuHandle(uint32_t index) const
                 {
                     ASSERT(d3d12Heap_)
@@ -193,14 +171,14 @@ namespace RR
                 }
 
             private:
+                DeviceContext& deviceContext_;
                 U8String name_;
 
                 uint32_t numDescriptors_ = 0;
                 uint32_t descriptorSize_ = 0;
-                uint32_t allocated_ = 0;
 
-                std::vector<std::unique_ptr<Chunk>> chunks_;
-                std::deque<Chunk*> freeChunks_;
+                // CPU only descriptors are consumed at API calls, so freed ones are reused right away.
+                BitmapAllocator allocator_;
 
                 ComSharedPtr<ID3D12DescriptorHeap> d3d12Heap_;
             };
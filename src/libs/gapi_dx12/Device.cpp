@@ -20,6 +20,15 @@ namespace RR
                 device.SetPrivateImpl(deviceImpl.release());
                 return true;
             }
+
+            std::vector<AdapterDescription> EnumerateAdapters()
+            {
+                ComSharedPtr<IDXGIFactory1> dxgiFactory;
+                if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(dxgiFactory.put()))))
+                    return {};
+
+                return D3DUtils::EnumerateAdapters(dxgiFactory, D3D_FEATURE_LEVEL_11_0);
+            }
         }
     }
 }
\ No newline at end of file
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <vector>
+
 namespace RR
 {
     namespace GAPI
     {
         class Device;
+        struct AdapterDescription;
 
         namespace DX12
         {
             bool InitDevice(Device& device);
+            // Could be called before any device is created.
+            std::vector<AdapterDescription> EnumerateAdapters();
         }
     }
 }
\ No newline at end of file
@@ -1,5 +1,24 @@
 #include "DeviceContext.hpp"
 
+#include "gapi_dx12/BindlessDescriptorHeap.hpp"
+#include "gapi_dx12/BufferSubAllocator.hpp"
+#include "gapi_dx12/CommandAllocatorPool.hpp"
+#include "gapi_dx12/CommandQueueImpl.hpp"
+#include "gapi_dx12/CpuResourceDataAllocator.hpp"
+#include "gapi_dx12/DescriptorAllocator.hpp"
+#include "gapi_dx12/GpuObjectPools.hpp"
+#include "gapi_dx12/IndirectCommandSignatures.hpp"
+#include "gapi_dx12/MemoryBudgetTracker.hpp"
+#include "gapi_dx12/MipGenerator.hpp"
+#include "gapi_dx12/PipelineStateCache.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/RootSignatureCache.hpp"
+#include "gapi_dx12/SamplerDescriptorHeap.hpp"
+#include "gapi_dx12/TextureDefragmenter.hpp"
+#include "gapi_dx12/TexturePools.hpp"
+#include "gapi_dx12/TilePool.hpp"
+#include "gapi_dx12/TimestampQueryPool.hpp"
+#include "gapi_dx12/TransientResourceAllocator.hpp"
 #include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
 
 namespace RR
@@ -8,19 +27,51 @@ namespace RR
     {
         namespace DX12
         {
-            D3D12MA::Allocator* DeviceContext::allocator_;
-            ComSharedPtr<ID3D12Device> DeviceContext::device_;
-            ComSharedPtr<IDXGIFactory2> DeviceContext::dxgiFactory_;
-            std::shared_ptr<CommandQueueImpl> DeviceContext::graphicsCommandQueue_;
-
-            void DeviceContext::Init(const ComSharedPtr<ID3D12Device>& device,
-                                     const ComSharedPtr<IDXGIFactory2>& dxgiFactory)
+            DeviceContext::DeviceContext(const ComSharedPtr<ID3D12Device>& device,
+                                         const ComSharedPtr<IDXGIFactory2>& dxgiFactory,
+                                         uint32_t gpuFramesBuffered)
+                : device_(device),
+                  dxgiFactory_(dxgiFactory),
+                  gpuFramesBuffered_(gpuFramesBuffered)
             {
                 ASSERT(device);
                 ASSERT(dxgiFactory);
+                ASSERT(gpuFramesBuffered > 0 && gpuFramesBuffered <= MAX_GPU_FRAMES_BUFFERED);
+
+#ifdef ENABLE_ENHANCED_BARRIERS
+                D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12 = {};
+                enhancedBarriersSupported_ = SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12))) &&
+                                             options12.EnhancedBarriersSupported;
+#endif
+#ifdef ENABLE_GPU_UPLOAD_HEAP
+                D3D12_FEATURE_DATA_D3D12_OPTIONS16 options16 = {};
+                gpuUploadHeapSupported_ = SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS16, &options16, sizeof(options16))) &&
+                                          options16.GPUUploadHeapSupported;
+#endif
 
-                device_ = device;
-                dxgiFactory_ = dxgiFactory;
+                resourceReleaseContext_ = std::make_unique<ResourceReleaseContext>(*this);
+                descriptorAllocator_ = std::make_unique<DescriptorAllocator>(*this);
+                bindlessDescriptorHeap_ = std::make_unique<BindlessDescriptorHeap>(*this);
+                samplerDescriptorHeap_ = std::make_unique<SamplerDescriptorHeap>(*this);
+                commandAllocatorPool_ = std::make_unique<CommandAllocatorPool>(*this);
+                cpuResourceDataAllocator_ = std::make_unique<CpuResourceDataAllocator>(*this);
+                memoryBudgetTracker_ = std::make_unique<MemoryBudgetTracker>(*this);
+                timestampQueryPool_ = std::make_unique<TimestampQueryPool>(*this);
+                transientResourceAllocator_ = std::make_unique<TransientResourceAllocator>(*this);
+                tilePool_ = std::make_unique<TilePool>(*this);
+                bufferSubAllocator_ = std::make_unique<BufferSubAllocator>(*this);
+                texturePools_ = std::make_unique<TexturePools>(*this);
+                textureDefragmenter_ = std::make_unique<TextureDefragmenter>(*this);
+                rootSignatureCache_ = std::make_unique<RootSignatureCache>(*this);
+                pipelineStateCache_ = std::make_unique<PipelineStateCache>(*this);
+                mipGenerator_ = std::make_unique<MipGenerator>(*this);
+                indirectCommandSignatures_ = std::make_unique<IndirectCommandSignatures>(*this);
+                gpuObjectPools_ = std::make_unique<GpuObjectPools>(*this);
+            }
+
+            DeviceContext::~DeviceContext()
+            {
+                ASSERT(!allocator_);
             }
 
             void DeviceContext::Init(D3D12MA::Allocator* allocator,
@@ -37,10 +88,8 @@ namespace RR
             {
                 allocator_->Release();
                 allocator_ = nullptr;
-                device_ = nullptr;
-                dxgiFactory_ = nullptr;
                 graphicsCommandQueue_ = nullptr;
             }
         }
     }
-}
\ No newline at end of file
+}
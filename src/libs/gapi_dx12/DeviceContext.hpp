@@ -11,51 +11,130 @@ namespace RR
     {
         namespace DX12
         {
-            class DescriptorHeapSet;
+            class BindlessDescriptorHeap;
+            class BufferSubAllocator;
+            class CommandAllocatorPool;
             class CommandQueueImpl;
+            class CpuResourceDataAllocator;
+            class DescriptorAllocator;
+            class GpuObjectPools;
+            class IndirectCommandSignatures;
+            class MemoryBudgetTracker;
+            class MipGenerator;
+            class PipelineStateCache;
+            class ResourceReleaseContext;
+            class RootSignatureCache;
+            class SamplerDescriptorHeap;
+            class TextureDefragmenter;
+            class TexturePools;
+            class TilePool;
+            class TimestampQueryPool;
+            class TransientResourceAllocator;
 
-            class DeviceContext
+            // Per device state of the backend. Owned by DeviceImpl, backend objects keep reference to context of the device
+            // they were created by, so several devices live side by side. Subsystems are created with the context,
+            // DeviceImpl initializes and terminates them in dependency order.
+            class DeviceContext final : private NonCopyable
             {
             public:
-                static void Init(const ComSharedPtr<ID3D12Device>& device,
-                                 const ComSharedPtr<IDXGIFactory2>& dxgiFactory);
+                DeviceContext(const ComSharedPtr<ID3D12Device>& device,
+                              const ComSharedPtr<IDXGIFactory2>& dxgiFactory,
+                              uint32_t gpuFramesBuffered);
+                ~DeviceContext();
 
-                static void Init(D3D12MA::Allocator* allocator,
-                                 const std::shared_ptr<CommandQueueImpl>& graphicsCommandQueue);
+                void Init(D3D12MA::Allocator* allocator,
+                          const std::shared_ptr<CommandQueueImpl>& graphicsCommandQueue);
 
-                static void Terminate();
+                void Terminate();
 
-                static D3D12MA::Allocator* GetAllocator()
+                D3D12MA::Allocator* GetAllocator() const
                 {
                     ASSERT(allocator_);
                     return allocator_;
                 }
 
-                static ComSharedPtr<ID3D12Device> GetDevice()
+                const ComSharedPtr<ID3D12Device>& GetDevice() const
                 {
                     ASSERT(device_);
                     return device_;
                 }
 
-                static ComSharedPtr<IDXGIFactory2> GetDxgiFactory()
+                const ComSharedPtr<IDXGIFactory2>& GetDxgiFactory() const
                 {
                     ASSERT(dxgiFactory_);
                     return dxgiFactory_;
                 }
 
-                static std::shared_ptr<CommandQueueImpl> GetGraphicsCommandQueue()
+                const std::shared_ptr<CommandQueueImpl>& GetGraphicsCommandQueue() const
                 {
                     ASSERT(graphicsCommandQueue_);
                     return graphicsCommandQueue_;
                 }
 
+                // Device creates graphics queue itself, the only graphics GAPI queue of the device shares it.
+                const std::shared_ptr<CommandQueueImpl>& ShareGraphicsCommandQueue()
+                {
+                    ASSERT_MSG(!isGraphicsCommandQueueShared_, "Only one graphics command queue is allowed");
+                    isGraphicsCommandQueueShared_ = true;
+                    return GetGraphicsCommandQueue();
+                }
+
+                uint32_t GetGpuFramesBuffered() const { return gpuFramesBuffered_; }
+
+                // Both SDK headers and driver support D3D12 Barrier API.
+                bool IsEnhancedBarriersSupported() const { return enhancedBarriersSupported_; }
+
+                // CPU visible video memory is exposed with resizable BAR enabled.
+                bool IsGpuUploadHeapSupported() const { return gpuUploadHeapSupported_; }
+
+                ResourceReleaseContext& GetResourceReleaseContext() const { return *resourceReleaseContext_; }
+                DescriptorAllocator& GetDescriptorAllocator() const { return *descriptorAllocator_; }
+                BindlessDescriptorHeap& GetBindlessDescriptorHeap() const { return *bindlessDescriptorHeap_; }
+                SamplerDescriptorHeap& GetSamplerDescriptorHeap() const { return *samplerDescriptorHeap_; }
+                CommandAllocatorPool& GetCommandAllocatorPool() const { return *commandAllocatorPool_; }
+                CpuResourceDataAllocator& GetCpuResourceDataAllocator() const { return *cpuResourceDataAllocator_; }
+                MemoryBudgetTracker& GetMemoryBudgetTracker() const { return *memoryBudgetTracker_; }
+                TimestampQueryPool& GetTimestampQueryPool() const { return *timestampQueryPool_; }
+                TransientResourceAllocator& GetTransientResourceAllocator() const { return *transientResourceAllocator_; }
+                TilePool& GetTilePool() const { return *tilePool_; }
+                BufferSubAllocator& GetBufferSubAllocator() const { return *bufferSubAllocator_; }
+                TexturePools& GetTexturePools() const { return *texturePools_; }
+                TextureDefragmenter& GetTextureDefragmenter() const { return *textureDefragmenter_; }
+                RootSignatureCache& GetRootSignatureCache() const { return *rootSignatureCache_; }
+                PipelineStateCache& GetPipelineStateCache() const { return *pipelineStateCache_; }
+                MipGenerator& GetMipGenerator() const { return *mipGenerator_; }
+                IndirectCommandSignatures& GetIndirectCommandSignatures() const { return *indirectCommandSignatures_; }
+                GpuObjectPools& GetGpuObjectPools() const { return *gpuObjectPools_; }
 
             private:
-                static D3D12MA::Allocator* allocator_;
-                static ComSharedPtr<ID3D12Device> device_;
-                static ComSharedPtr<IDXGIFactory2> dxgiFactory_;
-                static std::shared_ptr<CommandQueueImpl> graphicsCommandQueue_;
+                D3D12MA::Allocator* allocator_ = nullptr;
+                ComSharedPtr<ID3D12Device> device_;
+                ComSharedPtr<IDXGIFactory2> dxgiFactory_;
+                std::shared_ptr<CommandQueueImpl> graphicsCommandQueue_;
+                uint32_t gpuFramesBuffered_ = 0;
+                bool enhancedBarriersSupported_ = false;
+                bool gpuUploadHeapSupported_ = false;
+                bool isGraphicsCommandQueueShared_ = false;
+
+                std::unique_ptr<ResourceReleaseContext> resourceReleaseContext_;
+                std::unique_ptr<DescriptorAllocator> descriptorAllocator_;
+                std::unique_ptr<BindlessDescriptorHeap> bindlessDescriptorHeap_;
+                std::unique_ptr<SamplerDescriptorHeap> samplerDescriptorHeap_;
+                std::unique_ptr<CommandAllocatorPool> commandAllocatorPool_;
+                std::unique_ptr<CpuResourceDataAllocator> cpuResourceDataAllocator_;
+                std::unique_ptr<MemoryBudgetTracker> memoryBudgetTracker_;
+                std::unique_ptr<TimestampQueryPool> timestampQueryPool_;
+                std::unique_ptr<TransientResourceAllocator> transientResourceAllocator_;
+                std::unique_ptr<TilePool> tilePool_;
+                std::unique_ptr<BufferSubAllocator> bufferSubAllocator_;
+                std::unique_ptr<TexturePools> texturePools_;
+                std::unique_ptr<TextureDefragmenter> textureDefragmenter_;
+                std::unique_ptr<RootSignatureCache> rootSignatureCache_;
+                std::unique_ptr<PipelineStateCache> pipelineStateCache_;
+                std::unique_ptr<MipGenerator> mipGenerator_;
+                std::unique_ptr<IndirectCommandSignatures> indirectCommandSignatures_;
+                std::unique_ptr<GpuObjectPools> gpuObjectPools_;
             };
         }
     }
-}
\ No newline at end of file
+}
@@ -6,9 +6,12 @@
 #include "gapi/Fence.hpp"
 #include "gapi/Frame.hpp"
 #include "gapi/Object.hpp"
+#include "gapi/PipelineState.hpp"
 #include "gapi/SwapChain.hpp"
 #include "gapi/Texture.hpp"
 
+#include "gapi_dx12/BufferSubAllocator.hpp"
+#include "gapi_dx12/CommandAllocatorPool.hpp"
 #include "gapi_dx12/CommandListImpl.hpp"
 #include "gapi_dx12/CommandQueueImpl.hpp"
 #include "gapi_dx12/CpuResourceDataAllocator.hpp"
@@ -16,12 +19,25 @@
 #include "gapi_dx12/DescriptorHeap.hpp"
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/GpuObjectPools.hpp"
+#include "gapi_dx12/IndirectCommandSignatures.hpp"
+#include "gapi_dx12/MemoryBudgetTracker.hpp"
+#include "gapi_dx12/MipGenerator.hpp"
+#include "gapi_dx12/PipelineStateCache.hpp"
 #include "gapi_dx12/ResourceCreator.hpp"
 #include "gapi_dx12/ResourceImpl.hpp"
 #include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/RootSignatureCache.hpp"
 #include "gapi_dx12/SwapChainImpl.hpp"
+#include "gapi_dx12/TextureDefragmenter.hpp"
+#include "gapi_dx12/TexturePools.hpp"
+#include "gapi_dx12/TilePool.hpp"
+#include "gapi_dx12/TimestampQueryPool.hpp"
+#include "gapi_dx12/TransientResourceAllocator.hpp"
 #include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
 
+#include "common/threading/TaskGraph.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <iterator>
@@ -46,6 +62,46 @@ namespace RR
             template <typename T>
             void ThrowIfFailed(T c) { std::ignore = c; };
 
+            namespace
+            {
+                std::vector<ID3D12Pageable*> getPageables(const std::vector<std::shared_ptr<GpuResource>>& resources)
+                {
+                    std::vector<ID3D12Pageable*> pageables;
+                    pageables.reserve(resources.size());
+
+                    for (const auto& resource : resources)
+                    {
+                        ASSERT(resource);
+
+                        const auto resourceImpl = resource->GetPrivateImpl<ResourceImpl>();
+                        ASSERT(resourceImpl);
+
+                        // Pooled buffer is shared with other buffers, it always stays resident.
+                        if (resourceImpl->IsSubAllocated())
+                            continue;
+
+                        pageables.push_back(resourceImpl->GetD3DObject().get());
+                    }
+
+                    return pageables;
+                }
+
+                D3D12_RESIDENCY_PRIORITY getResidencyPriority(ResidencyPriority priority)
+                {
+                    switch (priority)
+                    {
+                        case ResidencyPriority::Minimum: return D3D12_RESIDENCY_PRIORITY_MINIMUM;
+                        case ResidencyPriority::Low: return D3D12_RESIDENCY_PRIORITY_LOW;
+                        case ResidencyPriority::Normal: return D3D12_RESIDENCY_PRIORITY_NORMAL;
+                        case ResidencyPriority::High: return D3D12_RESIDENCY_PRIORITY_HIGH;
+                        case ResidencyPriority::Maximum: return D3D12_RESIDENCY_PRIORITY_MAXIMUM;
+                        default: LOG_FATAL("Unsupported residency priority");
+                    }
+
+                    return D3D12_RESIDENCY_PRIORITY_NORMAL;
+                }
+            }
+
             DeviceImpl::DeviceImpl()
                 : creationThreadID_(std::this_thread::get_id())
             {
@@ -58,16 +114,37 @@ namespace RR
                 if (!inited_)
                     return;
 
+                deviceContext_->GetGpuObjectPools().Terminate();
+                deviceContext_->GetMemoryBudgetTracker().Terminate();
+                deviceContext_->GetTimestampQueryPool().Terminate();
+                deviceContext_->GetTransientResourceAllocator().Terminate();
+                deviceContext_->GetBufferSubAllocator().Terminate();
+                deviceContext_->GetTextureDefragmenter().Terminate();
+                deviceContext_->GetTilePool().Terminate();
+                deviceContext_->GetPipelineStateCache().Terminate();
+                deviceContext_->GetRootSignatureCache().Terminate();
+                deviceContext_->GetMipGenerator().Terminate();
+                deviceContext_->GetIndirectCommandSignatures().Terminate();
+
                 // Todo need wait all queries
                 waitForGpu();
                 waitForGpu();
 
-                DeviceContext::GetGraphicsCommandQueue()->ImmediateD3DObjectRelease();
-                DeviceContext::Terminate();
+                // After the waits every pooled allocator and ring page is idle.
+                deviceContext_->GetCommandAllocatorPool().Terminate();
+                deviceContext_->GetCpuResourceDataAllocator().Terminate();
+
+                deviceContext_->GetGraphicsCommandQueue()->ImmediateD3DObjectRelease();
                 gpuWaitFence_ = nullptr;
+                frameJoinQueue_ = nullptr;
 
-                ResourceReleaseContext::Instance().Terminate();
-                DescriptorAllocator::Instance().Terminate();
+                // Allocations are returned to pools and allocator, so both are released after deferred deletions.
+                deviceContext_->GetResourceReleaseContext().Terminate();
+                deviceContext_->GetTexturePools().Terminate();
+                deviceContext_->GetDescriptorAllocator().Terminate();
+                deviceContext_->Terminate();
+
+                deviceContext_ = nullptr;
 
                 dxgiFactory_ = nullptr;
                 dxgiAdapter_ = nullptr;
@@ -96,18 +173,35 @@ namespace RR
                 ASSERT_IS_CREATION_THREAD;
                 ASSERT(!inited_);
 
-                ASSERT(description.gpuFramesBuffered <= MAX_BACK_BUFFER_COUNT);
+                ASSERT(description.gpuFramesBuffered > 0 && description.gpuFramesBuffered <= MAX_GPU_FRAMES_BUFFERED);
 
                 description_ = description;
 
                 if (!createDevice())
                     return false;
 
-                DeviceContext::Init(d3dDevice_, dxgiFactory_);
+                deviceContext_ = std::make_unique<DeviceContext>(d3dDevice_, dxgiFactory_, description.gpuFramesBuffered);
+
+                // Pipeline caches only read files and need device, so they load concurrently with the rest.
+                Threading::TaskGraph graph("Device init");
+                graph.Add("Root signature cache", [this, &description] { deviceContext_->GetRootSignatureCache().Init(description.pipelineCachePath); });
+                graph.Add("Pipeline state cache", [this, &description] { deviceContext_->GetPipelineStateCache().Init(description.pipelineCachePath); });
+                graph.Add("Device subsystems", [this, &description] { initSubsystems(description); }, {}, Threading::TaskGraph::Affinity::CallingThread);
+                graph.Run();
 
-                gpuWaitFence_ = std::make_unique<FenceImpl>();
+                inited_ = true;
+
+                return true;
+            }
+
+            void DeviceImpl::initSubsystems(const IDevice::Description& description)
+            {
+                gpuWaitFence_ = std::make_unique<FenceImpl>(*deviceContext_);
                 gpuWaitFence_->Init("GpuWait");
 
+                frameJoinQueue_ = std::make_shared<CommandQueueImpl>(*deviceContext_, CommandQueueType::Copy);
+                frameJoinQueue_->Init("Frame join");
+
                 D3D12MA::ALLOCATOR_DESC allocatorDesc = {};
                 allocatorDesc.pDevice = d3dDevice_.get();
                 allocatorDesc.pAdapter = dxgiAdapter_.get();
@@ -115,28 +209,37 @@ namespace RR
                 D3D12MA::Allocator* allocator;
                 D3D12MA::CreateAllocator(&allocatorDesc, &allocator);
 
-                auto& graphicsCommandQueue = std::make_shared<CommandQueueImpl>(CommandQueueType::Graphics);
+                auto& graphicsCommandQueue = std::make_shared<CommandQueueImpl>(*deviceContext_, CommandQueueType::Graphics);
                 graphicsCommandQueue->Init("Primary");
 
-                ResourceReleaseContext::Instance().Init();
-                DescriptorAllocator::Instance().Init();
+                deviceContext_->GetResourceReleaseContext().Init();
+                deviceContext_->GetDescriptorAllocator().Init();
 
-                DeviceContext::Init(
+                deviceContext_->Init(
                     allocator,
                     graphicsCommandQueue);
 
-                inited_ = true;
-
-                return true;
+                deviceContext_->GetCommandAllocatorPool().Init();
+                deviceContext_->GetCpuResourceDataAllocator().Init();
+                deviceContext_->GetMemoryBudgetTracker().Init(dxgiAdapter_);
+                deviceContext_->GetTimestampQueryPool().Init(*deviceContext_->GetGraphicsCommandQueue());
+                deviceContext_->GetTransientResourceAllocator().Init();
+                deviceContext_->GetTilePool().Init();
+                deviceContext_->GetBufferSubAllocator().Init();
+                deviceContext_->GetTexturePools().Init();
+                deviceContext_->GetTextureDefragmenter().Init(description.defragmentationFrameBudget);
+                deviceContext_->GetMipGenerator().Init();
+                deviceContext_->GetIndirectCommandSignatures().Init();
+                deviceContext_->GetGpuObjectPools().Init();
             }
 
             void DeviceImpl::waitForGpu()
             {
                 ASSERT_IS_DEVICE_INITED;
 
-                gpuWaitFence_->Signal(*DeviceContext::GetGraphicsCommandQueue().get());
+                gpuWaitFence_->Signal(*deviceContext_->GetGraphicsCommandQueue());
                 gpuWaitFence_->SyncCPU(std::nullopt);
-                ResourceReleaseContext::ExecuteDeferredDeletions(DeviceContext::GetGraphicsCommandQueue());
+                deviceContext_->GetResourceReleaseContext().ExecuteAllDeferredDeletions(deviceContext_->GetGraphicsCommandQueue());
             }
 
             std::shared_ptr<CpuResourceData> const DeviceImpl::AllocateIntermediateResourceData(
@@ -146,40 +249,54 @@ namespace RR
                 uint32_t numSubresources) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return CpuResourceDataAllocator::Alloc(resourceDesc, memoryType, firstSubresourceIndex, numSubresources);
+                return deviceContext_->GetCpuResourceDataAllocator().Alloc(resourceDesc, memoryType, firstSubresourceIndex, numSubresources);
             }
 
             void DeviceImpl::InitSwapChain(SwapChain& resource) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return ResourceCreator::InitSwapChain(resource);
+                return ResourceCreator::InitSwapChain(*deviceContext_, resource);
             }
 
             void DeviceImpl::InitFence(Fence& resource) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return ResourceCreator::InitFence(resource);
+                return ResourceCreator::InitFence(*deviceContext_, resource);
             }
 
             void DeviceImpl::InitCommandQueue(CommandQueue& resource) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return ResourceCreator::InitCommandQueue(resource);
+                return ResourceCreator::InitCommandQueue(*deviceContext_, resource);
             }
 
             void DeviceImpl::InitCommandList(CommandList& resource) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return ResourceCreator::InitCommandList(resource);
+                return ResourceCreator::InitCommandList(*deviceContext_, resource);
             }
 
             void DeviceImpl::InitTexture(Texture& resource) const
             {
                 ASSERT_IS_DEVICE_INITED;
 
-                auto impl = std::make_unique<ResourceImpl>();
+                auto impl = std::make_unique<ResourceImpl>(*deviceContext_);
                 impl->Init(resource);
 
+                const bool isMovable = impl->IsPooled() && resource.GetAllocationHint() != GpuResourceAllocationHint::RenderTarget;
+                resource.SetPrivateImpl(impl.release());
+
+                if (isMovable)
+                    deviceContext_->GetTextureDefragmenter().Register(std::static_pointer_cast<Texture>(resource.shared_from_this()));
+            }
+
+            void DeviceImpl::InitTransientTexture(Texture& resource, uint32_t firstUse, uint32_t lastUse) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                auto impl = std::make_unique<ResourceImpl>(*deviceContext_);
+                impl->InitTransient(resource, firstUse, lastUse);
+
                 resource.SetPrivateImpl(impl.release());
             }
 
@@ -187,16 +304,227 @@ namespace RR
             {
                 ASSERT_IS_DEVICE_INITED;
 
-                auto impl = std::make_unique<ResourceImpl>();
+                auto impl = std::make_unique<ResourceImpl>(*deviceContext_);
                 impl->Init(resource);
 
                 resource.SetPrivateImpl(impl.release());
             }
 
+            void DeviceImpl::InitSharedBuffer(Buffer& resource) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                auto impl = std::make_unique<ResourceImpl>(*deviceContext_);
+                impl->InitShared(resource);
+
+                resource.SetPrivateImpl(impl.release());
+            }
+
+            void DeviceImpl::InitSharedFence(Fence& resource) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                auto impl = std::make_unique<FenceImpl>(*deviceContext_);
+                impl->InitShared(resource.GetName());
+
+                resource.SetPrivateImpl(impl.release());
+            }
+
+            void DeviceImpl::OpenSharedBuffer(Buffer& resource, const Buffer& source) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                const auto sourceImpl = source.GetPrivateImpl<ResourceImpl>();
+                ASSERT(sourceImpl);
+
+                auto impl = std::make_unique<ResourceImpl>(*deviceContext_);
+                impl->OpenShared(resource, *sourceImpl);
+
+                resource.SetPrivateImpl(impl.release());
+            }
+
+            void DeviceImpl::OpenSharedFence(Fence& resource, const Fence& source) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                const auto sourceImpl = source.GetPrivateImpl<FenceImpl>();
+                ASSERT(sourceImpl);
+
+                auto impl = std::make_unique<FenceImpl>(*deviceContext_);
+                impl->OpenShared(resource.GetName(), *sourceImpl);
+
+                resource.SetPrivateImpl(impl.release());
+            }
+
+            void DeviceImpl::InitPipelineState(PipelineState& pipelineState) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return ResourceCreator::InitPipelineState(*deviceContext_, pipelineState);
+            }
+
+            void DeviceImpl::InitQueryPool(QueryPool& queryPool) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return ResourceCreator::InitQueryPool(*deviceContext_, queryPool);
+            }
+
+            bool DeviceImpl::IsPipelineStateCached(const PipelineStateDescription& description) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetPipelineStateCache().IsCached(description.GetHash());
+            }
+
             void DeviceImpl::InitGpuResourceView(GpuResourceView& view) const
             {
                 ASSERT_IS_DEVICE_INITED;
-                return ResourceCreator::InitGpuResourceView(view);
+                return ResourceCreator::InitGpuResourceView(*deviceContext_, view);
+            }
+
+            GpuFrameTimings DeviceImpl::GetGpuFrameTimings() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetTimestampQueryPool().GetFrameTimings();
+            }
+
+            GpuClockCalibration DeviceImpl::GetGpuClockCalibration() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetTimestampQueryPool().GetClockCalibration();
+            }
+
+            ShadingRateSupport DeviceImpl::GetShadingRateSupport() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return shadingRateSupport_;
+            }
+
+            MemoryBudget DeviceImpl::GetMemoryBudget() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetMemoryBudgetTracker().GetMemoryBudget();
+            }
+
+            MemoryStatistics DeviceImpl::GetMemoryStatistics() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetMemoryBudgetTracker().GetMemoryStatistics();
+            }
+
+            DeviceStatistics DeviceImpl::GetDeviceStatistics() const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                DeviceStatistics statistics;
+                for (size_t type = 0; type < statistics.descriptorHeaps.size(); type++)
+                    statistics.descriptorHeaps[type] = deviceContext_->GetDescriptorAllocator().GetOccupancy(static_cast<DescriptorHeapType>(type));
+
+                statistics.pendingReleasesCount = deviceContext_->GetResourceReleaseContext().GetPendingReleasesCount();
+                return statistics;
+            }
+
+            void DeviceImpl::SetResidencyPriority(const std::vector<std::shared_ptr<GpuResource>>& resources, ResidencyPriority priority) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                if (resources.empty())
+                    return;
+
+                ComSharedPtr<ID3D12Device1> device1;
+                if (!d3dDevice_.try_as(device1))
+                    return;
+
+                const auto& pageables = getPageables(resources);
+                if (pageables.empty())
+                    return;
+
+                const std::vector<D3D12_RESIDENCY_PRIORITY> priorities(pageables.size(), getResidencyPriority(priority));
+
+                D3DCall(device1->SetResidencyPriority(static_cast<UINT>(pageables.size()), pageables.data(), priorities.data()));
+            }
+
+            void DeviceImpl::Evict(const std::vector<std::shared_ptr<GpuResource>>& resources) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                if (resources.empty())
+                    return;
+
+                // Resources shouldn't be referenced by frames in flight.
+                const auto& pageables = getPageables(resources);
+                if (pageables.empty())
+                    return;
+
+                D3DCall(d3dDevice_->Evict(static_cast<UINT>(pageables.size()), pageables.data()));
+            }
+
+            void DeviceImpl::MakeResident(const std::vector<std::shared_ptr<GpuResource>>& resources) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                if (resources.empty())
+                    return;
+
+                const auto& pageables = getPageables(resources);
+                if (pageables.empty())
+                    return;
+
+                D3DCall(d3dDevice_->MakeResident(static_cast<UINT>(pageables.size()), pageables.data()));
+            }
+
+            BufferHandle DeviceImpl::CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetGpuObjectPools().CreateBuffer(desc, cpuAccess);
+            }
+
+            TextureHandle DeviceImpl::CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetGpuObjectPools().CreateTexture(desc, cpuAccess);
+            }
+
+            ViewHandle DeviceImpl::CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetGpuObjectPools().CreateView(buffer, viewType, desc);
+            }
+
+            ViewHandle DeviceImpl::CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetGpuObjectPools().CreateView(texture, viewType, desc);
+            }
+
+            void DeviceImpl::Release(BufferHandle& buffer) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                deviceContext_->GetGpuObjectPools().Release(buffer);
+            }
+
+            void DeviceImpl::Release(TextureHandle& texture) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                deviceContext_->GetGpuObjectPools().Release(texture);
+            }
+
+            void DeviceImpl::Release(ViewHandle& view) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                deviceContext_->GetGpuObjectPools().Release(view);
+            }
+
+            uint32_t DeviceImpl::GetBindlessIndex(ViewHandle view) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+
+                const auto pooledView = deviceContext_->GetGpuObjectPools().Get(view);
+                return pooledView ? pooledView->allocation.GetBindlessIndex() : GpuResourceView::InvalidBindlessIndex;
+            }
+
+            uint32_t DeviceImpl::GetSamplerIndex(const SamplerDescription& description) const
+            {
+                ASSERT_IS_DEVICE_INITED;
+                return deviceContext_->GetDescriptorAllocator().AllocateSampler(description);
             }
 
             void DeviceImpl::Submit(const CommandList::SharedPtr& commandList)
@@ -219,35 +547,16 @@ namespace RR
                 */
             }
 
+            // Called by submission thread, or by present thread which is the only one presenting then.
             void DeviceImpl::Present(const SwapChain::SharedPtr& swapChain)
             {
-                ASSERT_IS_CREATION_THREAD;
                 ASSERT_IS_DEVICE_INITED;
                 ASSERT(swapChain);
 
-                HRESULT hr;
-                /*  if (m_options & c_AllowTearing)
-                {
-                    // Recommended to always use tearing if supported when using a sync interval of 0.
-                    // Note this will fail if in true 'fullscreen' mode.
-                    hr = m_swapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
-                }
-                else
-                {*/
-                // The first argument instructs DXGI to block until VSync, putting the application
-                // to sleep until the next VSync. This ensures we don't waste any cycles rendering
-                // frames that will never be displayed to the screen.
-                //  hr = swapChain->Present(0, 0);
-                //  }
-
-                // The first argument instructs DXGI to block until VSync, putting the application
-                // to sleep until the next VSync. This ensures we don't waste any cycles rendering
-                // frames that will never be displayed to the screen.
-                DXGI_PRESENT_PARAMETERS parameters = {};
-
                 ASSERT(dynamic_cast<SwapChainImpl*>(swapChain->GetPrivateImpl()));
                 auto swapChainImpl = static_cast<SwapChainImpl*>(swapChain->GetPrivateImpl());
 
+                // Sync interval 0 doesn't block on vsync, swap chain tears if it was created with allowTearing.
                 auto result = swapChainImpl->Present(0);
 
                 // If the device was reset we must completely reinitialize the renderer.
@@ -316,7 +625,7 @@ namespace RR
                 }
 
                 D3D_FEATURE_LEVEL minimumFeatureLevel = D3D_FEATURE_LEVEL_11_0;
-                if (FAILED(result = D3DUtils::GetAdapter(dxgiFactory_, minimumFeatureLevel, dxgiAdapter_)))
+                if (FAILED(result = D3DUtils::GetAdapter(dxgiFactory_, minimumFeatureLevel, description_.adapterIndex, dxgiAdapter_)))
                 {
                     LOG_WARNING("Failed to get adapter. Error: %s", D3DUtils::HResultToString(result));
                     return false;
@@ -375,16 +684,48 @@ namespace RR
                     d3dFeatureLevel_ = minimumFeatureLevel;
                 }
 
+                // Older runtimes don't know options 6, variable rate shading is unsupported then.
+                D3D12_FEATURE_DATA_D3D12_OPTIONS6 options6 = {};
+                if (SUCCEEDED(d3dDevice_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &options6, sizeof(options6))))
+                {
+                    switch (options6.VariableShadingRateTier)
+                    {
+                        case D3D12_VARIABLE_SHADING_RATE_TIER_1:
+                            shadingRateSupport_.tier = ShadingRateTier::Tier1;
+                            break;
+                        case D3D12_VARIABLE_SHADING_RATE_TIER_2:
+                            shadingRateSupport_.tier = ShadingRateTier::Tier2;
+                            shadingRateSupport_.imageTileSize = options6.ShadingRateImageTileSize;
+                            break;
+                        default:
+                            break;
+                    }
+
+                    shadingRateSupport_.additionalRates = options6.AdditionalShadingRatesSupported;
+                }
+
                 return true;
             }
 
-            void DeviceImpl::MoveToNextFrame(uint64_t frameIndex)
+            void DeviceImpl::MoveToNextFrame(uint64_t frameIndex, const std::vector<GpuSyncPoint>& frameEndSyncPoints)
             {
                 ASSERT_IS_CREATION_THREAD;
                 ASSERT_IS_DEVICE_INITED;
 
-                ResourceReleaseContext::ExecuteDeferredDeletions(DeviceContext::GetGraphicsCommandQueue());
-                DeviceContext::GetAllocator()->SetCurrentFrameIndex(frameIndex);
+                // Resources may be last used by async compute or copy queues, so frame fences are signaled once every queue
+                // finished the frame. Waits are on a separate queue, graphics work doesn't stall on other queues.
+                for (const auto& syncPoint : frameEndSyncPoints)
+                    frameJoinQueue_->Wait(syncPoint);
+
+                deviceContext_->GetResourceReleaseContext().ExecuteDeferredDeletions(frameJoinQueue_);
+                deviceContext_->GetDescriptorAllocator().MoveToNextFrame(frameIndex);
+                deviceContext_->GetTimestampQueryPool().MoveToNextFrame(frameIndex);
+                deviceContext_->GetMemoryBudgetTracker().MoveToNextFrame();
+                deviceContext_->GetTransientResourceAllocator().MoveToNextFrame();
+                deviceContext_->GetTilePool().MoveToNextFrame(*frameJoinQueue_);
+                deviceContext_->GetBufferSubAllocator().MoveToNextFrame(*frameJoinQueue_);
+                deviceContext_->GetTextureDefragmenter().MoveToNextFrame(*frameJoinQueue_);
+                deviceContext_->GetAllocator()->SetCurrentFrameIndex(frameIndex);
             }
 
             /*
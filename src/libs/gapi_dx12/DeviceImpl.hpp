@@ -8,6 +8,8 @@ namespace RR
     {
         namespace DX12
         {
+            class CommandQueueImpl;
+            class DeviceContext;
             class FenceImpl;
 
             class DeviceImpl final : public IDevice
@@ -19,7 +21,7 @@ namespace RR
                 bool Init(const IDevice::Description& description);
                 void Submit(const std::shared_ptr<CommandList>& commandList);
                 void Present(const std::shared_ptr<SwapChain>& swapChain) override;
-                void MoveToNextFrame(uint64_t frameIndex) override;
+                void MoveToNextFrame(uint64_t frameIndex, const std::vector<GpuSyncPoint>& frameEndSyncPoints) override;
 
                 std::shared_ptr<CpuResourceData> const AllocateIntermediateResourceData(
                     const GpuResourceDescription& desc,
@@ -32,17 +34,53 @@ namespace RR
                 void InitCommandQueue(CommandQueue& resource) const override;
                 void InitCommandList(CommandList& resource) const override;
                 void InitTexture(Texture& resource) const override;
+                void InitTransientTexture(Texture& resource, uint32_t firstUse, uint32_t lastUse) const override;
                 void InitBuffer(Buffer& resource) const override;
+                void InitSharedBuffer(Buffer& resource) const override;
+                void InitSharedFence(Fence& resource) const override;
+                void OpenSharedBuffer(Buffer& resource, const Buffer& source) const override;
+                void OpenSharedFence(Fence& resource, const Fence& source) const override;
                 void InitGpuResourceView(GpuResourceView& view) const override;
+                void InitPipelineState(PipelineState& pipelineState) const override;
+                void InitQueryPool(QueryPool& queryPool) const override;
+                bool IsPipelineStateCached(const PipelineStateDescription& description) const override;
+
+                GpuFrameTimings GetGpuFrameTimings() const override;
+                GpuClockCalibration GetGpuClockCalibration() const override;
+                ShadingRateSupport GetShadingRateSupport() const override;
+
+                MemoryBudget GetMemoryBudget() const override;
+                MemoryStatistics GetMemoryStatistics() const override;
+                DeviceStatistics GetDeviceStatistics() const override;
+                void SetResidencyPriority(const std::vector<std::shared_ptr<GpuResource>>& resources, ResidencyPriority priority) const override;
+                void Evict(const std::vector<std::shared_ptr<GpuResource>>& resources) const override;
+                void MakeResident(const std::vector<std::shared_ptr<GpuResource>>& resources) const override;
+
+                BufferHandle CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const override;
+                TextureHandle CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess) const override;
+                ViewHandle CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const override;
+                ViewHandle CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc) const override;
+                void Release(BufferHandle& buffer) const override;
+                void Release(TextureHandle& texture) const override;
+                void Release(ViewHandle& view) const override;
+                uint32_t GetBindlessIndex(ViewHandle view) const override;
+                uint32_t GetSamplerIndex(const SamplerDescription& description) const override;
 
                 ID3D12Device* GetDevice() const
                 {
                     return d3dDevice_.get();
                 }
 
+                DeviceContext& GetDeviceContext() const
+                {
+                    ASSERT(deviceContext_);
+                    return *deviceContext_;
+                }
+
             private:
                 void waitForGpu();
                 bool createDevice();
+                void initSubsystems(const IDevice::Description& description);
 
             private:
                 IDevice::Description description_ = {};
@@ -50,11 +88,15 @@ namespace RR
                 std::atomic_bool inited_ = false;
                 std::thread::id creationThreadID_;
                 D3D_FEATURE_LEVEL d3dFeatureLevel_ = D3D_FEATURE_LEVEL_1_0_CORE;
+                ShadingRateSupport shadingRateSupport_;
 
                 ComSharedPtr<IDXGIFactory2> dxgiFactory_;
                 ComSharedPtr<IDXGIAdapter1> dxgiAdapter_;
                 ComSharedPtr<ID3D12Device> d3dDevice_;
                 std::shared_ptr<FenceImpl> gpuWaitFence_;
+                // Only waits for frame end on every queue and signals frame fences of releases and allocators.
+                std::shared_ptr<CommandQueueImpl> frameJoinQueue_;
+                std::unique_ptr<DeviceContext> deviceContext_;
             };
         }
     }
@@ -14,6 +14,9 @@ namespace RR
         {
             FenceImpl::~FenceImpl()
             {
+                if (sharedHandle_)
+                    CloseHandle(sharedHandle_);
+
                 if (!event_)
                     return;
 
@@ -24,7 +27,7 @@ namespace RR
             {
                 ASSERT(!D3DFence_);
 
-                const auto& device = DeviceContext::GetDevice();
+                const auto& device = deviceContext_.GetDevice();
 
                 D3DCall(device->CreateFence(cpuValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(D3DFence_.put())));
                 D3DUtils::SetAPIName(D3DFence_.get(), name);
@@ -33,6 +36,38 @@ namespace RR
                 ASSERT(event_);
             }
 
+            void FenceImpl::InitShared(const U8String& name)
+            {
+                ASSERT(!D3DFence_);
+
+                const auto& device = deviceContext_.GetDevice();
+
+                D3DCall(device->CreateFence(cpuValue_, D3D12_FENCE_FLAG_SHARED | D3D12_FENCE_FLAG_SHARED_CROSS_ADAPTER, IID_PPV_ARGS(D3DFence_.put())));
+                // Unnamed, handle is passed to other devices of the process directly.
+                D3DCall(device->CreateSharedHandle(D3DFence_.get(), nullptr, GENERIC_ALL, nullptr, &sharedHandle_));
+                D3DUtils::SetAPIName(D3DFence_.get(), name);
+
+                event_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+                ASSERT(event_);
+            }
+
+            void FenceImpl::OpenShared(const U8String& name, const FenceImpl& source)
+            {
+                ASSERT(!D3DFence_);
+                ASSERT(source.sharedHandle_);
+                ASSERT(&source.deviceContext_ != &deviceContext_);
+
+                D3DCall(deviceContext_.GetDevice()->OpenSharedHandle(source.sharedHandle_, IID_PPV_ARGS(D3DFence_.put())));
+                D3DUtils::SetAPIName(D3DFence_.get(), name);
+
+                // Values are signaled by the creating device, so CPU value is only known to the source.
+                cpuValue_ = source.GetCpuValue();
+                isOpened_ = true;
+
+                event_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+                ASSERT(event_);
+            }
+
             void FenceImpl::Signal(const std::shared_ptr<CommandQueue>& queue)
             {
                 ASSERT(queue);
@@ -43,21 +78,36 @@ namespace RR
                 Signal(*queueImpl);
             }
 
+            void FenceImpl::Signal(CommandQueue& queue, uint64_t value)
+            {
+                ASSERT(D3DFence_);
+                ASSERT(!isOpened_);
+                ASSERT(value > cpuValue_);
+
+                const auto queueImpl = queue.GetPrivateImpl<CommandQueueImpl>();
+                ASSERT(queueImpl);
+
+                cpuValue_ = value;
+                queueImpl->Signal(D3DFence_, value);
+            }
+
             void FenceImpl::Signal(CommandQueueImpl& queue)
             {
                 ASSERT(D3DFence_);
+                ASSERT(!isOpened_);
 
-                cpuValue_++;
+                const auto value = ++cpuValue_;
 
-                queue.Signal(D3DFence_, cpuValue_);
+                queue.Signal(D3DFence_, value);
             }
 
             void FenceImpl::SyncCPU(std::optional<uint64_t> value, uint32_t timeout) const
             {
                 ASSERT(D3DFence_);
 
-                uint64_t syncVal = value ? value.value() : cpuValue_;
-                ASSERT(syncVal <= cpuValue_);
+                // Value could be not signaled yet, when it's scheduled on submission thread.
+                ASSERT(value || !isOpened_);
+                uint64_t syncVal = value ? value.value() : cpuValue_.load();
 
                 uint64_t gpuVal = GetGpuValue();
                 if (gpuVal < syncVal)
@@ -67,14 +117,18 @@ namespace RR
                 }
             }
 
-            void FenceImpl::SyncGPU(const std::shared_ptr<CommandQueue>& queue) const
+            void FenceImpl::SyncGPU(const std::shared_ptr<CommandQueue>& queue, std::optional<uint64_t> value) const
             {
                 ASSERT(D3DFence_);
                 ASSERT(queue);
                 ASSERT(dynamic_cast<CommandQueueImpl*>(queue->GetPrivateImpl()));
 
+                ASSERT(value || !isOpened_);
+                uint64_t syncVal = value ? value.value() : cpuValue_.load();
+                ASSERT(isOpened_ || syncVal <= cpuValue_);
+
                 const auto& queueImpl = static_cast<CommandQueueImpl*>(queue->GetPrivateImpl());
-                queueImpl->Wait(D3DFence_, cpuValue_);
+                queueImpl->Wait(D3DFence_, syncVal);
             }
         }
     }
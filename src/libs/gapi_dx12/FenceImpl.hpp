@@ -1,5 +1,6 @@
 #pragma once
 
+#include "gapi/Device.hpp"
 #include "gapi/Fence.hpp"
 
 namespace RR
@@ -9,21 +10,27 @@ namespace RR
         namespace DX12
         {
             class CommandQueueImpl;
+            class DeviceContext;
 
             class FenceImpl final : public IFence
             {
             public:
-                FenceImpl() = default;
+                FenceImpl(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
                 ~FenceImpl();
                 
                 void Init(const U8String& name);
+                // Cross adapter fence, values signaled by creating device are waited on by others.
+                void InitShared(const U8String& name);
+                // Opens cross adapter fence created by another device of the process. Opened fence is only waited on.
+                void OpenShared(const U8String& name, const FenceImpl& source);
 
                 void Signal(const std::shared_ptr<CommandQueue>& queue) override;
+                void Signal(CommandQueue& queue, uint64_t value) override;
                 void Signal(CommandQueueImpl& queue);
 
                 // TODO infinity
                 void SyncCPU(std::optional<uint64_t> value, uint32_t timeout = 0xFFFFFF) const override;
-                void SyncGPU(const std::shared_ptr<CommandQueue>& queue) const override;
+                void SyncGPU(const std::shared_ptr<CommandQueue>& queue, std::optional<uint64_t> value) const override;
 
                 uint64_t GetGpuValue() const override
                 {
@@ -35,9 +42,12 @@ namespace RR
                 const ComSharedPtr<ID3D12Fence>& GetD3DObject() const { return D3DFence_; }
 
             private:
+                DeviceContext& deviceContext_;
                 HANDLE event_ = 0;
+                HANDLE sharedHandle_ = nullptr;
                 ComSharedPtr<ID3D12Fence> D3DFence_ = nullptr;
-                uint64_t cpuValue_ = 1;
+                std::atomic<uint64_t> cpuValue_ = 1;
+                bool isOpened_ = false;
             };
         }
     }
@@ -0,0 +1,129 @@
+#include "GpuObjectPools.hpp"
+
+#include "gapi_dx12/DescriptorAllocator.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            GpuObjectPools::~GpuObjectPools()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void GpuObjectPools::Init()
+            {
+                ASSERT(!isInited_);
+
+                buffers_ = std::make_unique<ResourcePool<BufferHandle>>();
+                textures_ = std::make_unique<ResourcePool<TextureHandle>>();
+                views_ = std::make_unique<ViewPool>();
+
+                isInited_ = true;
+            }
+
+            void GpuObjectPools::Terminate()
+            {
+                ASSERT(isInited_);
+
+                const auto leaked = views_->GetSize() + buffers_->GetSize() + textures_->GetSize();
+                if (leaked > 0)
+                    Log::Format::Warning("{} pooled gpu objects weren't released.\n", leaked);
+
+                // Views first, descriptors are created for pooled resources.
+                views_ = nullptr;
+                buffers_ = nullptr;
+                textures_ = nullptr;
+
+                isInited_ = false;
+            }
+
+            BufferHandle GpuObjectPools::CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess)
+            {
+                ASSERT(desc.GetDimension() == GpuResourceDimension::Buffer);
+                return createResource(*buffers_, desc, cpuAccess);
+            }
+
+            TextureHandle GpuObjectPools::CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess)
+            {
+                ASSERT(desc.GetDimension() != GpuResourceDimension::Buffer);
+                return createResource(*textures_, desc, cpuAccess);
+            }
+
+            ViewHandle GpuObjectPools::CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc)
+            {
+                ASSERT(isInited_);
+
+                const auto resource = buffers_->Get(buffer);
+                ASSERT_MSG(resource, "Stale buffer handle");
+
+                return createView(*resource, viewType, desc);
+            }
+
+            ViewHandle GpuObjectPools::CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc)
+            {
+                ASSERT(isInited_);
+
+                const auto resource = textures_->Get(texture);
+                ASSERT_MSG(resource, "Stale texture handle");
+
+                return createView(*resource, viewType, desc);
+            }
+
+            void GpuObjectPools::Release(BufferHandle& buffer)
+            {
+                ASSERT(isInited_);
+                buffers_->Release(buffer);
+            }
+
+            void GpuObjectPools::Release(TextureHandle& texture)
+            {
+                ASSERT(isInited_);
+                textures_->Release(texture);
+            }
+
+            void GpuObjectPools::Release(ViewHandle& view)
+            {
+                ASSERT(isInited_);
+                views_->Release(view);
+            }
+
+            template <typename HandleType>
+            HandleType GpuObjectPools::createResource(ResourcePool<HandleType>& pool, const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess)
+            {
+                ASSERT(isInited_);
+
+                auto handle = pool.Emplace(desc);
+                if (!handle.IsValid())
+                {
+                    Log::Print::Warning("Gpu resource pool is exhausted.\n");
+                    return handle;
+                }
+
+                // Slot isn't visible to other threads until handle is returned.
+                auto resource = pool.Get(handle);
+                resource->impl.Init(desc, cpuAccess, "");
+
+                return handle;
+            }
+
+            ViewHandle GpuObjectPools::createView(const PooledResource& resource, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc)
+            {
+                auto handle = views_->Emplace();
+                if (!handle.IsValid())
+                {
+                    Log::Print::Warning("Gpu resource view pool is exhausted.\n");
+                    return handle;
+                }
+
+                auto view = views_->Get(handle);
+                deviceContext_.GetDescriptorAllocator().Allocate(resource.impl, resource.description, viewType, desc, view->allocation);
+
+                return handle;
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Handles.hpp"
+
+#include "gapi_dx12/DescriptorHeap.hpp"
+#include "gapi_dx12/ResourceImpl.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Backing storage of handle objects. Resources and descriptors are released deferred as for regular objects.
+            class GpuObjectPools final : private NonCopyable
+            {
+            public:
+                struct PooledResource final
+                {
+                    PooledResource(const GpuResourceDescription& description) : description(description) { }
+
+                    GpuResourceDescription description;
+                    ResourceImpl impl;
+                };
+
+                struct PooledView final
+                {
+                    DescriptorHeap::Allocation allocation;
+                };
+
+            public:
+                GpuObjectPools(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~GpuObjectPools();
+
+                void Init();
+                void Terminate();
+
+                BufferHandle CreateBuffer(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess);
+                TextureHandle CreateTexture(const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess);
+                ViewHandle CreateView(BufferHandle buffer, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc);
+                ViewHandle CreateView(TextureHandle texture, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc);
+
+                void Release(BufferHandle& buffer);
+                void Release(TextureHandle& texture);
+                void Release(ViewHandle& view);
+
+                // Nullptr for stale handles.
+                const PooledResource* Get(BufferHandle buffer) const { return buffers_->Get(buffer); }
+                const PooledResource* Get(TextureHandle texture) const { return textures_->Get(texture); }
+                const PooledView* Get(ViewHandle view) const { return views_->Get(view); }
+
+            private:
+                template <typename HandleType>
+                using ResourcePool = Common::HandlePool<HandleType, PooledResource>;
+                using ViewPool = Common::HandlePool<ViewHandle, PooledView>;
+
+                template <typename HandleType>
+                HandleType createResource(ResourcePool<HandleType>& pool, const GpuResourceDescription& desc, GpuResourceCpuAccess cpuAccess);
+                ViewHandle createView(const PooledResource& resource, GpuResourceView::ViewType viewType, const GpuResourceViewDescription& desc);
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                std::unique_ptr<ResourcePool<BufferHandle>> buffers_;
+                std::unique_ptr<ResourcePool<TextureHandle>> textures_;
+                std::unique_ptr<ViewPool> views_;
+            };
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "IndirectCommandSignatures.hpp"
+
+#include "gapi/CommandList.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            static_assert(sizeof(DispatchArguments) == sizeof(D3D12_DISPATCH_ARGUMENTS));
+            static_assert(sizeof(DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
+
+            namespace
+            {
+                ComSharedPtr<ID3D12CommandSignature> createCommandSignature(const ComSharedPtr<ID3D12Device>& device, D3D12_INDIRECT_ARGUMENT_TYPE type, uint32_t stride, const U8String& name)
+                {
+                    D3D12_INDIRECT_ARGUMENT_DESC argumentDesc = {};
+                    argumentDesc.Type = type;
+
+                    D3D12_COMMAND_SIGNATURE_DESC desc = {};
+                    desc.ByteStride = stride;
+                    desc.NumArgumentDescs = 1;
+                    desc.pArgumentDescs = &argumentDesc;
+
+                    ComSharedPtr<ID3D12CommandSignature> commandSignature;
+                    D3DCall(device->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(commandSignature.put())));
+                    D3DUtils::SetAPIName(commandSignature.get(), name);
+
+                    return commandSignature;
+                }
+            }
+
+            IndirectCommandSignatures::~IndirectCommandSignatures()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void IndirectCommandSignatures::Init()
+            {
+                ASSERT(!isInited_);
+
+                dispatch_ = createCommandSignature(deviceContext_.GetDevice(), D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, sizeof(D3D12_DISPATCH_ARGUMENTS), "DispatchCommandSignature");
+                drawIndexed_ = createCommandSignature(deviceContext_.GetDevice(), D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), "DrawIndexedCommandSignature");
+
+                isInited_ = true;
+            }
+
+            void IndirectCommandSignatures::Terminate()
+            {
+                ASSERT(isInited_);
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(dispatch_);
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(drawIndexed_);
+
+                isInited_ = false;
+            }
+        }
+    }
+}
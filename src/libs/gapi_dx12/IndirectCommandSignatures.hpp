@@ -0,0 +1,43 @@
+#pragma once
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Command signatures of indirect commands which don't change root arguments, so they don't depend on root signature.
+            class IndirectCommandSignatures final : private NonCopyable
+            {
+            public:
+                IndirectCommandSignatures(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~IndirectCommandSignatures();
+
+                void Init();
+                void Terminate();
+
+                // Single dispatch with DispatchArguments layout.
+                const ComSharedPtr<ID3D12CommandSignature>& GetDispatch() const
+                {
+                    ASSERT(isInited_);
+                    return dispatch_;
+                }
+
+                // Single indexed draw with DrawIndexedArguments layout, pipelines with draw constants own their signatures.
+                const ComSharedPtr<ID3D12CommandSignature>& GetDrawIndexed() const
+                {
+                    ASSERT(isInited_);
+                    return drawIndexed_;
+                }
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                ComSharedPtr<ID3D12CommandSignature> dispatch_;
+                ComSharedPtr<ID3D12CommandSignature> drawIndexed_;
+            };
+        }
+    }
+}
@@ -1,28 +0,0 @@
-#pragma once
-
-#include "common/threading/Mutex.hpp"
-
-namespace OpenDemo
-{
-    namespace GAPI
-    {
-        namespace DX12
-        {
-            class CommandListImpl;
-
-            class InitialUploadsManager final
-            {
-            public:
-                void Init();
-                void DefferedUploadTexture(const std::shared_ptr<Texture>& texture, const std::shared_ptr<IntermediateMemory>& textureData);
-
-                void PerformUploads();
-
-            private:
-                std::unique_ptr<CommandListImpl> commandList_;
-                std::atomic_bool isWaitingDefferdCommands;
-                Threading::Mutex mutex_;
-            };
-        }
-    }
-}
\ No newline at end of file
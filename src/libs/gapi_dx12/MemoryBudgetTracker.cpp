@@ -0,0 +1,136 @@
+#include "MemoryBudgetTracker.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                MemorySegmentBudget getSegmentBudget(const DXGI_QUERY_VIDEO_MEMORY_INFO& info)
+                {
+                    MemorySegmentBudget budget;
+                    budget.usageBytes = info.CurrentUsage;
+                    budget.budgetBytes = info.Budget;
+                    return budget;
+                }
+
+                MemorySegmentBudget getSegmentBudget(const D3D12MA::Budget& info)
+                {
+                    MemorySegmentBudget budget;
+                    budget.usageBytes = info.UsageBytes;
+                    budget.budgetBytes = info.BudgetBytes;
+                    return budget;
+                }
+            }
+
+            MemoryBudgetTracker::~MemoryBudgetTracker()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void MemoryBudgetTracker::Init(const ComSharedPtr<IDXGIAdapter1>& adapter)
+            {
+                ASSERT(!isInited_);
+                ASSERT(adapter);
+
+                // Budget notifications came with DXGI 1.4, allocator estimation is used without them.
+                if (adapter.try_as(adapter_))
+                {
+                    budgetChangedEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+                    ASSERT(budgetChangedEvent_);
+
+                    D3DCall(adapter_->RegisterVideoMemoryBudgetChangeNotificationEvent(budgetChangedEvent_, &budgetChangedCookie_));
+                }
+                else
+                    Log::Print::Warning("IDXGIAdapter3 isn't supported, memory budget changes won't be reported.\n");
+
+                isInited_ = true;
+            }
+
+            void MemoryBudgetTracker::Terminate()
+            {
+                ASSERT(isInited_);
+
+                if (adapter_)
+                {
+                    adapter_->UnregisterVideoMemoryBudgetChangeNotification(budgetChangedCookie_);
+                    CloseHandle(budgetChangedEvent_);
+
+                    budgetChangedEvent_ = 0;
+                    budgetChangedCookie_ = 0;
+                    adapter_ = nullptr;
+                }
+
+                isInited_ = false;
+            }
+
+            void MemoryBudgetTracker::MoveToNextFrame()
+            {
+                ASSERT(isInited_);
+
+                // Auto reset event, several notifications between frames are reported once.
+                if (budgetChangedEvent_ && WaitForSingleObject(budgetChangedEvent_, 0) == WAIT_OBJECT_0)
+                    changesCount_++;
+            }
+
+            MemoryBudget MemoryBudgetTracker::GetMemoryBudget() const
+            {
+                ASSERT(isInited_);
+
+                MemoryBudget budget;
+                budget.changesCount = changesCount_.load();
+
+                if (adapter_)
+                {
+                    DXGI_QUERY_VIDEO_MEMORY_INFO local = {};
+                    DXGI_QUERY_VIDEO_MEMORY_INFO nonLocal = {};
+                    D3DCall(adapter_->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &local));
+                    D3DCall(adapter_->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL, &nonLocal));
+
+                    budget.local = getSegmentBudget(local);
+                    budget.nonLocal = getSegmentBudget(nonLocal);
+                }
+                else
+                {
+                    D3D12MA::Budget gpuBudget = {};
+                    D3D12MA::Budget cpuBudget = {};
+                    deviceContext_.GetAllocator()->GetBudget(&gpuBudget, &cpuBudget);
+
+                    budget.local = getSegmentBudget(gpuBudget);
+                    budget.nonLocal = getSegmentBudget(cpuBudget);
+                }
+
+                return budget;
+            }
+
+            MemoryStatistics MemoryBudgetTracker::GetMemoryStatistics() const
+            {
+                ASSERT(isInited_);
+
+                // Allocator heap types order matches MemoryHeapType.
+                static_assert(static_cast<size_t>(MemoryHeapType::Count) == D3D12MA::HEAP_TYPE_COUNT);
+
+                D3D12MA::Stats stats;
+                deviceContext_.GetAllocator()->CalculateStats(&stats);
+
+                MemoryStatistics statistics;
+                for (size_t index = 0; index < statistics.heaps.size(); index++)
+                {
+                    const auto& heapStats = stats.HeapType[index];
+                    auto& heap = statistics.heaps[index];
+
+                    heap.allocationsCount = heapStats.AllocationCount;
+                    heap.blockBytes = heapStats.UsedBytes + heapStats.UnusedBytes;
+                    heap.allocationBytes = heapStats.UsedBytes;
+                }
+
+                return statistics;
+            }
+        }
+    }
+}
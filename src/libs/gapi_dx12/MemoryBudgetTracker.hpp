@@ -0,0 +1,40 @@
+#pragma once
+
+#include "gapi/MemoryBudget.hpp"
+
+#include <atomic>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Polls OS budget change notifications once per frame. Statistics come from memory allocator.
+            class MemoryBudgetTracker final : private NonCopyable
+            {
+            public:
+                MemoryBudgetTracker(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~MemoryBudgetTracker();
+
+                void Init(const ComSharedPtr<IDXGIAdapter1>& adapter);
+                void Terminate();
+
+                void MoveToNextFrame();
+
+                MemoryBudget GetMemoryBudget() const;
+                MemoryStatistics GetMemoryStatistics() const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                ComSharedPtr<IDXGIAdapter3> adapter_;
+                HANDLE budgetChangedEvent_ = 0;
+                DWORD budgetChangedCookie_ = 0;
+                std::atomic<uint64_t> changesCount_ = 0;
+            };
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "MipGenerator.hpp"
+
+#include "gapi/PipelineState.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            MipGenerator::~MipGenerator()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void MipGenerator::Init()
+            {
+                ASSERT(!isInited_);
+
+                const auto& device = deviceContext_.GetDevice();
+
+                // Unbounded tables start at bindless heap start, so root constants index views directly.
+                CD3DX12_DESCRIPTOR_RANGE texturesRange;
+                texturesRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1, 0);
+                CD3DX12_DESCRIPTOR_RANGE rwTexturesRange;
+                rwTexturesRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 2, 0);
+
+                CD3DX12_ROOT_PARAMETER rootParameters[RootParameter::Count];
+                rootParameters[RootParameter::Constants].InitAsConstants(sizeof(DispatchConstants) / sizeof(uint32_t), 0);
+                rootParameters[RootParameter::Textures].InitAsDescriptorTable(1, &texturesRange);
+                rootParameters[RootParameter::RWTextures].InitAsDescriptorTable(1, &rwTexturesRange);
+
+                const CD3DX12_STATIC_SAMPLER_DESC linearClampSampler(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR,
+                                                                     D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
+                                                                     D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
+                                                                     D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
+
+                const CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc(RootParameter::Count, rootParameters, 1, &linearClampSampler);
+
+                ComSharedPtr<ID3DBlob> signature;
+                ComSharedPtr<ID3DBlob> error;
+                D3DCall(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, signature.put(), error.put()));
+                D3DCall(device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(rootSignature_.put())));
+                D3DUtils::SetAPIName(rootSignature_.get(), "GenerateMips");
+
+                std::vector<uint8_t> bytecode;
+                if (PipelineStateDescription::ReadShader(ShaderPath, bytecode))
+                {
+                    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+                    desc.pRootSignature = rootSignature_.get();
+                    desc.CS = { bytecode.data(), bytecode.size() };
+
+                    D3DCall(device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pipelineState_.put())));
+                    D3DUtils::SetAPIName(pipelineState_.get(), "GenerateMips");
+                }
+                else
+                {
+                    Log::Print::Warning("Mip generation shader \"%s\" not found, GenerateMips is disabled.\n", ShaderPath);
+                }
+
+                isInited_ = true;
+            }
+
+            void MipGenerator::Terminate()
+            {
+                ASSERT(isInited_);
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(pipelineState_);
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(rootSignature_);
+
+                isInited_ = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Root signature and pipeline of compute mip downsampler.
+            // Every dispatch produces up to MaxMipsPerDispatch mips, views are addressed through bindless heap indices.
+            class MipGenerator final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t MaxMipsPerDispatch = 4;
+                static constexpr uint32_t ThreadGroupSize = 8;
+
+                enum RootParameter : uint32_t
+                {
+                    Constants,
+                    Textures,
+                    RWTextures,
+                    Count
+                };
+
+                // Matches cbuffer layout in shaders/GenerateMips.slang.
+                struct DispatchConstants final
+                {
+                    uint32_t sourceIndex;
+                    uint32_t mipsCount;
+                    float texelSize[2];
+                    uint32_t destIndices[MaxMipsPerDispatch];
+                };
+
+            public:
+                MipGenerator(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~MipGenerator();
+
+                void Init();
+                void Terminate();
+
+                // False when shader bytecode wasn't found, mip generation is skipped then.
+                bool IsAvailable() const { return pipelineState_ != nullptr; }
+
+                const ComSharedPtr<ID3D12RootSignature>& GetRootSignature() const { return rootSignature_; }
+                const ComSharedPtr<ID3D12PipelineState>& GetPipelineState() const { return pipelineState_; }
+
+            private:
+                DeviceContext& deviceContext_;
+                // Compiled by rfx from bin/shaders/GenerateMips.slang.
+                static constexpr const char* ShaderPath = "shaders/GenerateMips_main.bin";
+
+                bool isInited_ = false;
+                ComSharedPtr<ID3D12RootSignature> rootSignature_;
+                ComSharedPtr<ID3D12PipelineState> pipelineState_;
+            };
+        }
+    }
+}
@@ -0,0 +1,275 @@
+#include "PipelineStateCache.hpp"
+
+#include "gapi/PipelineState.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+#include <fstream>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                constexpr uint32_t HintsVersion = 1;
+
+                D3D12_SHADER_BYTECODE getShaderBytecode(const std::vector<uint8_t>& bytecode)
+                {
+                    return { bytecode.data(), bytecode.size() };
+                }
+
+                D3D12_GRAPHICS_PIPELINE_STATE_DESC getGraphicsPipelineStateDesc(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature)
+                {
+                    ASSERT(!description.vertexShader.empty());
+                    ASSERT(description.renderTargetCount <= PipelineStateDescription::MaxRenderTargets);
+
+                    D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
+                    desc.pRootSignature = rootSignature;
+                    desc.VS = getShaderBytecode(description.vertexShader);
+                    desc.PS = getShaderBytecode(description.pixelShader);
+                    desc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+                    desc.SampleMask = UINT_MAX;
+                    desc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+                    desc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+                    desc.DepthStencilState.DepthEnable = description.depthStencilFormat != GpuResourceFormat::Unknown;
+                    desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+                    desc.NumRenderTargets = description.renderTargetCount;
+
+                    for (uint32_t index = 0; index < description.renderTargetCount; index++)
+                        desc.RTVFormats[index] = D3DUtils::GetDxgiResourceFormat(description.renderTargetFormats[index]);
+
+                    desc.DSVFormat = D3DUtils::GetDxgiResourceFormat(description.depthStencilFormat);
+                    desc.SampleDesc = { 1, 0 };
+
+                    return desc;
+                }
+
+                D3D12_COMPUTE_PIPELINE_STATE_DESC getComputePipelineStateDesc(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature)
+                {
+                    ASSERT(!description.computeShader.empty());
+
+                    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+                    desc.pRootSignature = rootSignature;
+                    desc.CS = getShaderBytecode(description.computeShader);
+
+                    return desc;
+                }
+            }
+
+            PipelineStateCache::~PipelineStateCache()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void PipelineStateCache::Init(const U8String& cachePath)
+            {
+                ASSERT(!isInited_);
+
+                cachePath_ = cachePath;
+                loadLibrary();
+
+                isInited_ = true;
+            }
+
+            void PipelineStateCache::Terminate()
+            {
+                ASSERT(isInited_);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                storeLibrary();
+
+                // Library isn't used by GPU.
+                library_ = nullptr;
+                libraryData_.clear();
+
+                for (auto& pipelineState : pipelineStates_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(pipelineState.second);
+
+                pipelineStates_.clear();
+
+                isInited_ = false;
+            }
+
+            ComSharedPtr<ID3D12PipelineState> PipelineStateCache::GetOrCreate(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature, const U8String& name)
+            {
+                ASSERT(isInited_);
+
+                const auto hash = description.GetHash();
+
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                    const auto it = pipelineStates_.find(hash);
+                    if (it != pipelineStates_.end())
+                        return it->second;
+                }
+
+                // Compile outside of the lock, several threads could compile the same state, only first one is kept.
+                const auto& libraryName = StringConversions::UTF8ToWString(fmt::sprintf("%016llx", hash));
+                auto pipelineState = loadOrCompile(description, rootSignature, libraryName);
+                D3DUtils::SetAPIName(pipelineState.get(), name);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                const auto result = pipelineStates_.emplace(hash, pipelineState);
+                if (!result.second)
+                    return result.first->second;
+
+                if (library_ && SUCCEEDED(library_->StorePipeline(libraryName.c_str(), pipelineState.get())))
+                {
+                    libraryHashes_.insert(hash);
+                    isLibraryDirty_ = true;
+                }
+
+                return pipelineState;
+            }
+
+            bool PipelineStateCache::IsCached(uint64_t hash) const
+            {
+                ASSERT(isInited_);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                return pipelineStates_.count(hash) > 0 || libraryHashes_.count(hash) > 0;
+            }
+
+            ComSharedPtr<ID3D12PipelineState> PipelineStateCache::loadOrCompile(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature, const std::wstring& libraryName)
+            {
+                const auto& device = deviceContext_.GetDevice();
+
+                ComSharedPtr<ID3D12PipelineState> pipelineState;
+
+                switch (description.type)
+                {
+                    case PipelineStateType::Graphics:
+                    {
+                        const auto& desc = getGraphicsPipelineStateDesc(description, rootSignature);
+
+                        if (library_ && SUCCEEDED(library_->LoadGraphicsPipeline(libraryName.c_str(), &desc, IID_PPV_ARGS(pipelineState.put()))))
+                            return pipelineState;
+
+                        D3DCall(device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipelineState.put())));
+                        break;
+                    }
+                    case PipelineStateType::Compute:
+                    {
+                        const auto& desc = getComputePipelineStateDesc(description, rootSignature);
+
+                        if (library_ && SUCCEEDED(library_->LoadComputePipeline(libraryName.c_str(), &desc, IID_PPV_ARGS(pipelineState.put()))))
+                            return pipelineState;
+
+                        D3DCall(device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pipelineState.put())));
+                        break;
+                    }
+                    default:
+                        LOG_FATAL("Unsupported pipeline state type");
+                }
+
+                return pipelineState;
+            }
+
+            void PipelineStateCache::loadLibrary()
+            {
+                ComSharedPtr<ID3D12Device1> device1;
+                if (!deviceContext_.GetDevice().try_as(device1))
+                {
+                    Log::Print::Warning("Pipeline library isn't supported, pipeline states won't be persisted.\n");
+                    return;
+                }
+
+                if (!cachePath_.empty())
+                {
+                    std::ifstream file(cachePath_, std::ios::binary | std::ios::ate);
+                    if (file)
+                    {
+                        libraryData_.resize(static_cast<size_t>(file.tellg()));
+                        file.seekg(0);
+                        file.read(reinterpret_cast<char*>(libraryData_.data()), libraryData_.size());
+
+                        if (!file)
+                            libraryData_.clear();
+                    }
+                }
+
+                if (!libraryData_.empty())
+                {
+                    // Fails on driver or adapter change, cache is rebuilt in that case.
+                    if (SUCCEEDED(device1->CreatePipelineLibrary(libraryData_.data(), libraryData_.size(), IID_PPV_ARGS(library_.put()))))
+                    {
+                        loadHints();
+                        return;
+                    }
+
+                    Log::Print::Warning("Pipeline cache \"%s\" is outdated, rebuilding.\n", cachePath_);
+                    libraryData_.clear();
+                }
+
+                D3DCall(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(library_.put())));
+            }
+
+            void PipelineStateCache::storeLibrary()
+            {
+                if (!library_ || !isLibraryDirty_ || cachePath_.empty())
+                    return;
+
+                std::vector<uint8_t> data(library_->GetSerializedSize());
+                D3DCall(library_->Serialize(data.data(), data.size()));
+
+                std::ofstream file(cachePath_, std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    Log::Print::Warning("Can't write pipeline cache \"%s\".\n", cachePath_);
+                    return;
+                }
+
+                file.write(reinterpret_cast<const char*>(data.data()), data.size());
+                isLibraryDirty_ = false;
+
+                storeHints();
+            }
+
+            void PipelineStateCache::loadHints()
+            {
+                std::ifstream file(cachePath_ + ".hints", std::ios::binary);
+                if (!file)
+                    return;
+
+                uint32_t version = 0;
+                uint32_t count = 0;
+                file.read(reinterpret_cast<char*>(&version), sizeof(version));
+                file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+                if (!file || version != HintsVersion)
+                    return;
+
+                std::vector<uint64_t> hashes(count);
+                file.read(reinterpret_cast<char*>(hashes.data()), hashes.size() * sizeof(uint64_t));
+
+                // Hints without library entry only make creation synchronous, but they should match anyway.
+                if (file)
+                    libraryHashes_.insert(hashes.begin(), hashes.end());
+            }
+
+            void PipelineStateCache::storeHints() const
+            {
+                std::ofstream file(cachePath_ + ".hints", std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    Log::Print::Warning("Can't write pipeline cache hints \"%s.hints\".\n", cachePath_);
+                    return;
+                }
+
+                const std::vector<uint64_t> hashes(libraryHashes_.begin(), libraryHashes_.end());
+                const auto count = static_cast<uint32_t>(hashes.size());
+
+                file.write(reinterpret_cast<const char*>(&HintsVersion), sizeof(HintsVersion));
+                file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+                file.write(reinterpret_cast<const char*>(hashes.data()), hashes.size() * sizeof(uint64_t));
+            }
+        }
+    }
+}
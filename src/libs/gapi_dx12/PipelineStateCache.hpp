@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        struct PipelineStateDescription;
+
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // In-memory pipeline states cache keyed by description hash, backed by pipeline library.
+            // Library is loaded from disk on init and serialized back on terminate, so warm starts skip compilation.
+            // Library content can't be enumerated, hashes of stored states are kept in sidecar hints file.
+            class PipelineStateCache final : private NonCopyable
+            {
+            public:
+                PipelineStateCache(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~PipelineStateCache();
+
+                // Empty cache path disables persistence.
+                void Init(const U8String& cachePath);
+                void Terminate();
+
+                // Root signature is expected to be derived from description, so it isn't part of the key.
+                ComSharedPtr<ID3D12PipelineState> GetOrCreate(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature, const U8String& name);
+
+                // In memory or stored in library, so GetOrCreate doesn't compile.
+                bool IsCached(uint64_t hash) const;
+
+            private:
+                void loadLibrary();
+                void storeLibrary();
+                void loadHints();
+                void storeHints() const;
+                ComSharedPtr<ID3D12PipelineState> loadOrCompile(const PipelineStateDescription& description, ID3D12RootSignature* rootSignature, const std::wstring& libraryName);
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                bool isLibraryDirty_ = false;
+                U8String cachePath_;
+
+                // Library references serialized data, it should outlive library.
+                std::vector<uint8_t> libraryData_;
+                ComSharedPtr<ID3D12PipelineLibrary> library_;
+
+                std::unordered_map<uint64_t, ComSharedPtr<ID3D12PipelineState>> pipelineStates_;
+                std::unordered_set<uint64_t> libraryHashes_;
+                mutable Threading::Mutex mutex_;
+            };
+        }
+    }
+}
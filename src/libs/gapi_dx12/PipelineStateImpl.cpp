@@ -0,0 +1,71 @@
+#include "PipelineStateImpl.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/IndirectCommandSignatures.hpp"
+#include "gapi_dx12/PipelineStateCache.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/RootSignatureCache.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            PipelineStateImpl::~PipelineStateImpl()
+            {
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DPipelineState_);
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(rootSignature_);
+
+                if (commandSignature_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(commandSignature_);
+            }
+
+            void PipelineStateImpl::Init(const PipelineState& resource)
+            {
+                ASSERT(!D3DPipelineState_);
+
+                const auto& description = resource.GetDescription();
+
+                rootSignature_ = deviceContext_.GetRootSignatureCache().GetOrCreate(description.reflection, description.staticSamplers, description.drawConstantsCount);
+
+                // Command lists bind root signature explicitly, so embedded one is extracted from bytecode.
+                if (!rootSignature_)
+                {
+                    const auto& bytecode = description.type == PipelineStateType::Compute ? description.computeShader : description.vertexShader;
+                    ASSERT(!bytecode.empty());
+
+                    D3DCall(deviceContext_.GetDevice()->CreateRootSignature(0, bytecode.data(), bytecode.size(), IID_PPV_ARGS(rootSignature_.put())));
+                }
+                D3DPipelineState_ = deviceContext_.GetPipelineStateCache().GetOrCreate(description, rootSignature_.get(), resource.GetName());
+                ASSERT(D3DPipelineState_);
+
+                if (description.type == PipelineStateType::Graphics && description.drawConstantsCount > 0)
+                {
+                    ASSERT(description.drawConstantsCount <= PipelineStateDescription::MaxDrawConstants);
+
+                    std::array<D3D12_INDIRECT_ARGUMENT_DESC, 2> argumentDescs = {};
+                    argumentDescs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+                    argumentDescs[0].Constant.RootParameterIndex = 0;
+                    argumentDescs[0].Constant.DestOffsetIn32BitValues = 0;
+                    argumentDescs[0].Constant.Num32BitValuesToSet = description.drawConstantsCount;
+                    argumentDescs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+                    D3D12_COMMAND_SIGNATURE_DESC desc = {};
+                    desc.ByteStride = description.GetIndirectCommandStride();
+                    desc.NumArgumentDescs = static_cast<UINT>(argumentDescs.size());
+                    desc.pArgumentDescs = argumentDescs.data();
+
+                    D3DCall(deviceContext_.GetDevice()->CreateCommandSignature(&desc, rootSignature_.get(), IID_PPV_ARGS(commandSignature_.put())));
+                    D3DUtils::SetAPIName(commandSignature_.get(), resource.GetName());
+                }
+            }
+
+            const ComSharedPtr<ID3D12CommandSignature>& PipelineStateImpl::GetCommandSignature() const
+            {
+                return commandSignature_ ? commandSignature_ : deviceContext_.GetIndirectCommandSignatures().GetDrawIndexed();
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "gapi/PipelineState.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            class PipelineStateImpl final : public IPipelineState
+            {
+            public:
+                PipelineStateImpl(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~PipelineStateImpl();
+
+                void Init(const PipelineState& resource);
+
+                const ComSharedPtr<ID3D12PipelineState>& GetD3DObject() const { return D3DPipelineState_; }
+                // Shared by pipelines with identical binding layout, created from bytecode when root signature is embedded.
+                const ComSharedPtr<ID3D12RootSignature>& GetRootSignature() const { return rootSignature_; }
+                // ExecuteIndirect signature of graphics pipeline, records match PipelineStateDescription::GetIndirectCommandStride.
+                const ComSharedPtr<ID3D12CommandSignature>& GetCommandSignature() const;
+
+            private:
+                DeviceContext& deviceContext_;
+                ComSharedPtr<ID3D12PipelineState> D3DPipelineState_;
+                ComSharedPtr<ID3D12RootSignature> rootSignature_;
+                // Set only when draw constants change root arguments, shared signature is used otherwise.
+                ComSharedPtr<ID3D12CommandSignature> commandSignature_;
+            };
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include "QueryPoolImpl.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            static_assert(sizeof(PipelineStatistics) == sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS));
+
+            namespace
+            {
+                D3D12_QUERY_HEAP_TYPE getQueryHeapType(QueryType type)
+                {
+                    switch (type)
+                    {
+                        case QueryType::Occlusion:
+                        case QueryType::BinaryOcclusion: return D3D12_QUERY_HEAP_TYPE_OCCLUSION;
+                        case QueryType::PipelineStatistics: return D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+                        default: LOG_FATAL("Unsupported query type");
+                    }
+
+                    return D3D12_QUERY_HEAP_TYPE_OCCLUSION;
+                }
+
+                D3D12_QUERY_TYPE getQueryType(QueryType type)
+                {
+                    switch (type)
+                    {
+                        case QueryType::Occlusion: return D3D12_QUERY_TYPE_OCCLUSION;
+                        case QueryType::BinaryOcclusion: return D3D12_QUERY_TYPE_BINARY_OCCLUSION;
+                        case QueryType::PipelineStatistics: return D3D12_QUERY_TYPE_PIPELINE_STATISTICS;
+                        default: LOG_FATAL("Unsupported query type");
+                    }
+
+                    return D3D12_QUERY_TYPE_OCCLUSION;
+                }
+            }
+
+            QueryPoolImpl::~QueryPoolImpl()
+            {
+                if (!D3DQueryHeap_)
+                    return;
+
+                // Queries could be referenced by command lists in flight.
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DQueryHeap_);
+            }
+
+            void QueryPoolImpl::Init(const QueryPoolDescription& description, const U8String& name)
+            {
+                ASSERT(!D3DQueryHeap_);
+                ASSERT(description.count > 0);
+
+                queryType_ = getQueryType(description.type);
+
+                D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+                queryHeapDesc.Type = getQueryHeapType(description.type);
+                queryHeapDesc.Count = description.count;
+
+                D3DCall(deviceContext_.GetDevice()->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(D3DQueryHeap_.put())));
+                D3DUtils::SetAPIName(D3DQueryHeap_.get(), name);
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "gapi/QueryPool.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            class QueryPoolImpl final : public IQueryPool
+            {
+            public:
+                QueryPoolImpl(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~QueryPoolImpl();
+
+                void Init(const QueryPoolDescription& description, const U8String& name);
+
+                D3D12_QUERY_TYPE GetQueryType() const { return queryType_; }
+                const ComSharedPtr<ID3D12QueryHeap>& GetD3DObject() const { return D3DQueryHeap_; }
+
+            private:
+                DeviceContext& deviceContext_;
+                D3D12_QUERY_TYPE queryType_ = D3D12_QUERY_TYPE_OCCLUSION;
+                ComSharedPtr<ID3D12QueryHeap> D3DQueryHeap_;
+            };
+        }
+    }
+}
@@ -5,6 +5,8 @@
 #include "gapi_dx12/DescriptorAllocator.hpp"
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/PipelineStateImpl.hpp"
+#include "gapi_dx12/QueryPoolImpl.hpp"
 #include "gapi_dx12/ResourceImpl.hpp"
 #include "gapi_dx12/ResourceViewsImpl.hpp"
 #include "gapi_dx12/SwapChainImpl.hpp"
@@ -15,6 +17,8 @@
 #include "gapi/GpuResource.hpp"
 #include "gapi/GpuResourceViews.hpp"
 #include "gapi/Object.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/QueryPool.hpp"
 #include "gapi/SwapChain.hpp"
 #include "gapi/Texture.hpp"
 
@@ -25,56 +29,68 @@ namespace RR
         namespace DX12
         {
 
-            void ResourceCreator::InitSwapChain(SwapChain& resource)
+            void ResourceCreator::InitSwapChain(DeviceContext& deviceContext, SwapChain& resource)
             {
-                auto impl = std::make_unique<SwapChainImpl>();
-                impl->Init(DeviceContext::GetDevice(), DeviceContext::GetDxgiFactory(), DeviceContext::GetGraphicsCommandQueue()->GetD3DObject(), resource.GetDescription(), resource.GetName());
+                auto impl = std::make_unique<SwapChainImpl>(deviceContext);
+                impl->Init(deviceContext.GetDevice(), deviceContext.GetDxgiFactory(), deviceContext.GetGraphicsCommandQueue()->GetD3DObject(), resource.GetDescription(), resource.GetName());
 
                 resource.SetPrivateImpl(impl.release());
             }
 
-            void ResourceCreator::InitFence(Fence& resource)
+            void ResourceCreator::InitFence(DeviceContext& deviceContext, Fence& resource)
             {
-                auto impl = std::make_unique<FenceImpl>();
+                auto impl = std::make_unique<FenceImpl>(deviceContext);
                 impl->Init(resource.GetName());
 
                 resource.SetPrivateImpl(impl.release());
             }
 
-            void ResourceCreator::InitCommandQueue(CommandQueue& resource)
+            void ResourceCreator::InitCommandQueue(DeviceContext& deviceContext, CommandQueue& resource)
             {
                 std::unique_ptr<CommandQueueImpl> impl;
 
                 if (resource.GetCommandQueueType() == CommandQueueType::Graphics)
                 {
-                    static bool alreadyInited = false;
-                    ASSERT(!alreadyInited); // Only one graphics command queue are alloved.
-                    alreadyInited = true;
-
                     // Graphics command queue already initialized internally in device,
                     // so make copy to prevent d3d object leaking.
-                    impl.reset(new CommandQueueImpl(*DeviceContext::GetGraphicsCommandQueue()));
+                    impl.reset(new CommandQueueImpl(*deviceContext.ShareGraphicsCommandQueue()));
                 }
                 else
                 {
-                    impl.reset(new CommandQueueImpl(resource.GetCommandQueueType()));
+                    impl.reset(new CommandQueueImpl(deviceContext, resource.GetCommandQueueType(), resource.GetPriority()));
                     impl->Init(resource.GetName());
                 }
 
                 resource.SetPrivateImpl(impl.release());
             }
 
-            void ResourceCreator::InitCommandList(CommandList& resource)
+            void ResourceCreator::InitCommandList(DeviceContext& deviceContext, CommandList& resource)
             {
-                auto impl = std::make_unique<CommandListImpl>(resource.GetCommandListType());
+                auto impl = std::make_unique<CommandListImpl>(deviceContext, resource.GetCommandListType());
                 impl->Init(resource.GetName());
 
                 resource.SetPrivateImpl(static_cast<ICommandList*>(impl.release()));
             }
 
-            void ResourceCreator::InitGpuResourceView(GpuResourceView& object)
+            void ResourceCreator::InitGpuResourceView(DeviceContext& deviceContext, GpuResourceView& object)
+            {
+                deviceContext.GetDescriptorAllocator().Allocate(object);
+            }
+
+            void ResourceCreator::InitPipelineState(DeviceContext& deviceContext, PipelineState& resource)
             {
-                DescriptorAllocator::Instance().Allocate(object);
+                auto impl = std::make_unique<PipelineStateImpl>(deviceContext);
+                impl->Init(resource);
+
+                resource.SetPrivateImpl(impl.release());
+            }
+
+            void ResourceCreator::InitQueryPool(DeviceContext& deviceContext, QueryPool& resource)
+            {
+                auto impl = std::make_unique<QueryPoolImpl>(deviceContext);
+                impl->Init(resource.GetDescription(), resource.GetName());
+
+                resource.SetPrivateImpl(impl.release());
             }
         }
     }
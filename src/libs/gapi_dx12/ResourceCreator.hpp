@@ -30,13 +30,27 @@ namespace RR
                 0
             };
 
+#ifdef ENABLE_GPU_UPLOAD_HEAP
+            static constexpr D3D12_HEAP_PROPERTIES GpuUploadHeapProps = {
+                D3D12_HEAP_TYPE_GPU_UPLOAD,
+                D3D12_CPU_PAGE_PROPERTY_UNKNOWN,
+                D3D12_MEMORY_POOL_UNKNOWN,
+                0,
+                0
+            };
+#endif
+
+            class DeviceContext;
+
             namespace ResourceCreator
             {
-                void InitSwapChain(SwapChain& resource);
-                void InitFence(Fence& resource);
-                void InitCommandQueue(CommandQueue& resource);
-                void InitCommandList(CommandList& resource);
-                void InitGpuResourceView(GpuResourceView& view);
+                void InitSwapChain(DeviceContext& deviceContext, SwapChain& resource);
+                void InitFence(DeviceContext& deviceContext, Fence& resource);
+                void InitCommandQueue(DeviceContext& deviceContext, CommandQueue& resource);
+                void InitCommandList(DeviceContext& deviceContext, CommandList& resource);
+                void InitGpuResourceView(DeviceContext& deviceContext, GpuResourceView& view);
+                void InitPipelineState(DeviceContext& deviceContext, PipelineState& resource);
+                void InitQueryPool(DeviceContext& deviceContext, QueryPool& resource);
             }
         }
     }
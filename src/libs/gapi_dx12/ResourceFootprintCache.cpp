@@ -0,0 +1,68 @@
+#include "ResourceFootprintCache.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+
+#include <shared_mutex>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            GpuResourceFootprint::SharedConstPtr ResourceFootprintCache::GetOrCreate(const GpuResourceDescription& description, uint32_t firstSubresource, uint32_t numSubresources)
+            {
+                const Key key { description, firstSubresource, numSubresources };
+
+                {
+                    std::shared_lock<Threading::SharedMutex> lock(mutex_);
+
+                    const auto it = footprints_.find(key);
+                    if (it != footprints_.end())
+                        return it->second;
+                }
+
+                // Computed outside of the lock, concurrent misses of the same key build equal footprints.
+                auto footprint = create(description, firstSubresource, numSubresources);
+
+                Threading::UniqueLock<Threading::SharedMutex> lock(mutex_);
+
+                if (footprints_.size() >= MaxEntries)
+                    footprints_.clear();
+
+                return footprints_.emplace(key, std::move(footprint)).first->second;
+            }
+
+            GpuResourceFootprint::SharedConstPtr ResourceFootprintCache::create(const GpuResourceDescription& description, uint32_t firstSubresource, uint32_t numSubresources) const
+            {
+                const D3D12_RESOURCE_DESC desc = D3DUtils::GetResourceDesc(description);
+
+                std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(numSubresources);
+                std::vector<UINT> numRowsVector(numSubresources);
+                std::vector<UINT64> rowSizeInBytesVector(numSubresources);
+                UINT64 totalSize;
+
+                deviceContext_.GetDevice()->GetCopyableFootprints(&desc, firstSubresource, numSubresources, 0, &layouts[0], &numRowsVector[0], &rowSizeInBytesVector[0], &totalSize);
+
+                std::vector<GpuResourceFootprint::SubresourceFootprint> subresourceFootprints(numSubresources);
+                for (uint32_t index = 0; index < numSubresources; index++)
+                {
+                    const auto& layout = layouts[index];
+                    const auto numRows = numRowsVector[index];
+                    const auto rowSizeInBytes = rowSizeInBytesVector[index];
+                    const auto rowPitch = layout.Footprint.RowPitch;
+                    const auto depthPitch = numRows * rowPitch;
+
+                    subresourceFootprints[index] = GpuResourceFootprint::SubresourceFootprint(
+                        layout.Offset,
+                        (description.GetDimension() == GpuResourceDimension::Buffer) ? description.GetNumElements() : layout.Footprint.Width,
+                        layout.Footprint.Height,
+                        layout.Footprint.Depth,
+                        numRows, rowSizeInBytes, rowPitch, depthPitch);
+                }
+
+                return std::make_shared<const GpuResourceFootprint>(std::move(subresourceFootprints), totalSize);
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <unordered_map>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Copyable footprints computed once per description and subresources range.
+            // Footprints are immutable and shared by all resource data allocated with the same key.
+            class ResourceFootprintCache final : private NonCopyable
+            {
+            public:
+                ResourceFootprintCache(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~ResourceFootprintCache() = default;
+
+                GpuResourceFootprint::SharedConstPtr GetOrCreate(const GpuResourceDescription& description, uint32_t firstSubresource, uint32_t numSubresources);
+
+            private:
+                struct Key
+                {
+                    GpuResourceDescription description;
+                    uint32_t firstSubresource;
+                    uint32_t numSubresources;
+
+                    inline bool operator==(const Key& other) const
+                    {
+                        return description == other.description && firstSubresource == other.firstSubresource && numSubresources == other.numSubresources;
+                    }
+
+                    struct HashFunc
+                    {
+                        std::size_t operator()(const Key& key) const
+                        {
+                            return GpuResourceDescription::HashFunc()(key.description) ^
+                                   (std::hash<uint32_t>()(key.firstSubresource | key.numSubresources << 16) << 1);
+                        }
+                    };
+                };
+
+                GpuResourceFootprint::SharedConstPtr create(const GpuResourceDescription& description, uint32_t firstSubresource, uint32_t numSubresources) const;
+
+            private:
+                // Table is dropped once it grows over the limit, footprints stay alive in resource data referencing them.
+                static constexpr size_t MaxEntries = 4096;
+
+                DeviceContext& deviceContext_;
+                std::unordered_map<Key, GpuResourceFootprint::SharedConstPtr, Key::HashFunc> footprints_;
+                Threading::SharedMutex mutex_;
+            };
+        }
+    }
+}
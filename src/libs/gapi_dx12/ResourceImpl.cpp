@@ -4,6 +4,9 @@
 #include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/ResourceCreator.hpp"
 #include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/TexturePools.hpp"
+#include "gapi_dx12/TransientResourceAllocator.hpp"
+#include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
 
 namespace RR
 {
@@ -13,33 +16,7 @@ namespace RR
         {
             namespace
             {
-                void getOptimizedClearValue(GpuResourceBindFlags bindFlags, DXGI_FORMAT format, D3D12_CLEAR_VALUE*& value)
-                {
-                    if (!IsAny(bindFlags, GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil))
-                    {
-                        value = nullptr;
-                        return;
-                    }
-
-                    if (IsSet(bindFlags, GpuResourceBindFlags::RenderTarget))
-                    {
-                        value->Format = format;
-
-                        value->Color[0] = 0.0f;
-                        value->Color[1] = 0.0f;
-                        value->Color[2] = 0.0f;
-                        value->Color[3] = 0.0f;
-                    }
-
-                    if (IsSet(bindFlags, GpuResourceBindFlags::DepthStencil))
-                    {
-                        value->Format = format;
-
-                        value->DepthStencil.Depth = 1.0f;
-                    }
-                }
-
-                const D3D12_HEAP_PROPERTIES* getHeapProperties(GpuResourceCpuAccess cpuAccess)
+                const D3D12_HEAP_PROPERTIES* getHeapProperties(const DeviceContext& deviceContext, GpuResourceCpuAccess cpuAccess)
                 {
                     switch (cpuAccess)
                     {
@@ -49,6 +26,13 @@ namespace RR
                         return &UploadHeapProps;
                     case GpuResourceCpuAccess::Read:
                         return &ReadbackHeapProps;
+                    case GpuResourceCpuAccess::GpuUpload:
+#ifdef ENABLE_GPU_UPLOAD_HEAP
+                        if (deviceContext.IsGpuUploadHeapSupported())
+                            return &GpuUploadHeapProps;
+#endif
+                        // GPU reads system memory over PCIe, still no copies.
+                        return &UploadHeapProps;
                     default:
                         LOG_FATAL("Unsupported cpuAcess");
                     }
@@ -61,6 +45,7 @@ namespace RR
                     case GpuResourceCpuAccess::None:
                         return D3D12_RESOURCE_STATE_COMMON;
                     case GpuResourceCpuAccess::Write:
+                    case GpuResourceCpuAccess::GpuUpload:
                         return D3D12_RESOURCE_STATE_GENERIC_READ;
                     case GpuResourceCpuAccess::Read:
                         return D3D12_RESOURCE_STATE_COPY_DEST;
@@ -72,33 +57,95 @@ namespace RR
 
             ResourceImpl::~ResourceImpl()
             {
-                ResourceReleaseContext::DeferredD3DResourceRelease(D3DResource_, allocation_);
+                // Pooled resource is owned by allocator.
+                if (subAllocation_.IsValid())
+                {
+                    deviceContext_.GetBufferSubAllocator().Release(subAllocation_);
+                    D3DResource_ = nullptr;
+                    return;
+                }
+
+                for (const auto& tiles : mipTiles_)
+                    if (!tiles.empty())
+                        deviceContext_.GetTilePool().Release(tiles);
+
+                if (sharedHandle_)
+                    CloseHandle(sharedHandle_);
+
+                releaseAllocation();
+            }
+
+            void ResourceImpl::setAllocation(D3D12MA::Allocation* allocation)
+            {
+                ASSERT(!allocation_);
+
+                allocation_ = allocation;
+                if (allocation_)
+                    Common::Debug::MemoryStats::OnAllocate(memoryTag_, Common::Debug::MemoryKind::Gpu, allocation_->GetSize());
+            }
+
+            void ResourceImpl::releaseAllocation()
+            {
+                if (allocation_)
+                    Common::Debug::MemoryStats::OnFree(memoryTag_, Common::Debug::MemoryKind::Gpu, allocation_->GetSize());
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DResource_, allocation_);
+                allocation_ = nullptr;
             }
 
             void ResourceImpl::Init(const Texture& resource)
             {
-                return Init(resource.GetDescription(), resource.GetCpuAccess(), resource.GetName());
+                return Init(resource.GetDescription(), resource.GetCpuAccess(), resource.GetName(), resource.GetAllocationHint());
             }
 
             void ResourceImpl::Init(
                 const GpuResourceDescription& resourceDesc,
                 GpuResourceCpuAccess cpuAccess,
-                const U8String& name)
+                const U8String& name,
+                GpuResourceAllocationHint allocationHint)
             {
                 // TextureDesc ASSERT checks done on Texture initialization;
                 ASSERT(!D3DResource_);
 
-                const DXGI_FORMAT format = D3DUtils::GetDxgiResourceFormat(resourceDesc.GetFormat());
+                // Upload heaps are GPU read only.
+                ASSERT(cpuAccess != GpuResourceCpuAccess::GpuUpload ||
+                       (resourceDesc.GetDimension() == GpuResourceDimension::Buffer &&
+                        !IsAny(resourceDesc.GetBindFlags(), GpuResourceBindFlags::UnorderedAccess | GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil)));
+
+                if (IsSet(resourceDesc.GetBindFlags(), GpuResourceBindFlags::Reserved))
+                {
+                    ASSERT(cpuAccess == GpuResourceCpuAccess::None);
+                    return initReserved(resourceDesc, name);
+                }
+
+                if (BufferSubAllocator::IsSuitable(resourceDesc))
+                {
+                    subAllocation_ = deviceContext_.GetBufferSubAllocator().Allocate(resourceDesc, cpuAccess);
+                    D3DResource_ = subAllocation_.resource;
+                    mappedData_ = subAllocation_.mappedData;
+                    return;
+                }
 
                 D3D12_CLEAR_VALUE optimizedClearValue;
-                D3D12_CLEAR_VALUE* pOptimizedClearValue = &optimizedClearValue;
-                getOptimizedClearValue(resourceDesc.GetBindFlags(), format, pOptimizedClearValue);
+                const D3D12_CLEAR_VALUE* pOptimizedClearValue = D3DUtils::GetOptimizedClearValue(resourceDesc, optimizedClearValue) ? &optimizedClearValue : nullptr;
 
                 const D3D12_RESOURCE_DESC& desc = D3DUtils::GetResourceDesc(resourceDesc);
 
+                if (allocationHint != GpuResourceAllocationHint::Default)
+                {
+                    ASSERT(cpuAccess == GpuResourceCpuAccess::None);
+
+                    D3D12MA::Allocation* allocation;
+                    deviceContext_.GetTexturePools().CreateResource(allocationHint, desc, D3D12_RESOURCE_STATE_COMMON, pOptimizedClearValue, D3DResource_, allocation);
+                    setAllocation(allocation);
+                    D3DUtils::SetAPIName(D3DResource_.get(), name);
+                    isPooled_ = true;
+                    return;
+                }
+
                 D3DCall(
-                    DeviceContext::GetDevice()->CreateCommittedResource(
-                        getHeapProperties(cpuAccess),
+                    deviceContext_.GetDevice()->CreateCommittedResource(
+                        getHeapProperties(deviceContext_, cpuAccess),
                         D3D12_HEAP_FLAG_NONE,
                         &desc,
                         getDefaultResourceState(cpuAccess),
@@ -106,6 +153,65 @@ namespace RR
                         IID_PPV_ARGS(D3DResource_.put())));
 
                 D3DUtils::SetAPIName(D3DResource_.get(), name);
+
+                // Mapping is kept until release, CPU never reads.
+                if (cpuAccess == GpuResourceCpuAccess::GpuUpload)
+                {
+                    const D3D12_RANGE readRange = { 0, 0 };
+                    D3DCall(D3DResource_->Map(0, &readRange, &mappedData_));
+                }
+            }
+
+            void ResourceImpl::initReserved(const GpuResourceDescription& resourceDesc, const U8String& name)
+            {
+                // Reserved textures are never render targets, so no optimized clear value.
+                const D3D12_RESOURCE_DESC& desc = D3DUtils::GetResourceDesc(resourceDesc);
+
+                const auto& device = deviceContext_.GetDevice();
+                D3DCall(device->CreateReservedResource(&desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(D3DResource_.put())));
+
+                D3DUtils::SetAPIName(D3DResource_.get(), name);
+
+                UINT numSubresourceTilings = resourceDesc.GetMipCount();
+                subresourceTilings_.resize(numSubresourceTilings);
+                device->GetResourceTiling(D3DResource_.get(), nullptr, &packedMipInfo_, nullptr, &numSubresourceTilings, 0, subresourceTilings_.data());
+
+                mipTiles_.resize(packedMipInfo_.NumStandardMips + (packedMipInfo_.NumPackedMips > 0 ? 1 : 0));
+            }
+
+            void ResourceImpl::InitTransient(const Texture& resource, uint32_t firstUse, uint32_t lastUse)
+            {
+                ASSERT(!D3DResource_);
+                ASSERT(resource.GetCpuAccess() == GpuResourceCpuAccess::None);
+
+                const auto& resourceDesc = resource.GetDescription();
+                D3D12_CLEAR_VALUE optimizedClearValue;
+                const D3D12_CLEAR_VALUE* pOptimizedClearValue = D3DUtils::GetOptimizedClearValue(resourceDesc, optimizedClearValue) ? &optimizedClearValue : nullptr;
+
+                const D3D12_RESOURCE_DESC& desc = D3DUtils::GetResourceDesc(resourceDesc);
+                const auto allocationInfo = deviceContext_.GetDevice()->GetResourceAllocationInfo(0, 1, &desc);
+
+                const bool isRenderTarget = IsAny(resourceDesc.GetBindFlags(), GpuResourceBindFlags::RenderTarget | GpuResourceBindFlags::DepthStencil);
+                const auto placement = deviceContext_.GetTransientResourceAllocator().Allocate(allocationInfo, isRenderTarget, firstUse, lastUse);
+
+                D3DCall(
+                    deviceContext_.GetDevice()->CreatePlacedResource(
+                        placement.heap,
+                        placement.offset,
+                        &desc,
+                        D3D12_RESOURCE_STATE_COMMON,
+                        pOptimizedClearValue,
+                        IID_PPV_ARGS(D3DResource_.put())));
+
+                D3DUtils::SetAPIName(D3DResource_.get(), resource.GetName());
+
+                isTransient_ = true;
+                transientGeneration_ = placement.generation;
+            }
+
+            bool ResourceImpl::IsTransientExpired() const
+            {
+                return isTransient_ && deviceContext_.GetTransientResourceAllocator().IsExpired(transientGeneration_);
             }
 
             void ResourceImpl::Init(const ComSharedPtr<ID3D12Resource>& resource, D3D12MA::Allocation* allocation, const U8String& name)
@@ -113,45 +219,176 @@ namespace RR
                 ASSERT(resource);
                 ASSERT(!D3DResource_);
 
-                allocation_ = allocation;
+                setAllocation(allocation);
                 D3DResource_ = resource;
                 D3DUtils::SetAPIName(D3DResource_.get(), name);
             }
 
-            void ResourceImpl::Init(const Buffer& resource)
-            {
-                return Init(resource.GetDescription(), resource.GetCpuAccess(), resource.GetName());
-            }
-            /*
-            * //TODO buffer support
-            void ResourceImpl::Init(
-                const BufferDescription& resourceDesc,
-                GpuResourceCpuAccess cpuAccess,
-                const U8String& name)
+            void ResourceImpl::InitShared(const Buffer& resource)
             {
                 ASSERT(!D3DResource_);
-                ASSERT(resourceDesc.width > 0);
+                ASSERT(resource.GetCpuAccess() == GpuResourceCpuAccess::None);
 
-                const D3D12_RESOURCE_DESC& desc = D3DUtils::GetResourceDesc(resourceDesc);
+                const auto& device = deviceContext_.GetDevice();
+
+                D3D12_RESOURCE_DESC desc = D3DUtils::GetResourceDesc(resource.GetDescription());
+                desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER;
 
                 D3DCall(
-                    DeviceContext::GetDevice()->CreateCommittedResource(
-                        GetHeapProperties(cpuAccess),
-                        D3D12_HEAP_FLAG_NONE,
+                    device->CreateCommittedResource(
+                        &DefaultHeapProps,
+                        D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER,
                         &desc,
-                        GetDefaultResourceState(cpuAccess),
+                        D3D12_RESOURCE_STATE_COMMON,
                         nullptr,
                         IID_PPV_ARGS(D3DResource_.put())));
 
-                D3DUtils::SetAPIName(D3DResource_.get(), name);
-            }*/
+                // Unnamed, handle is passed to other devices of the process directly.
+                D3DCall(device->CreateSharedHandle(D3DResource_.get(), nullptr, GENERIC_ALL, nullptr, &sharedHandle_));
+
+                D3DUtils::SetAPIName(D3DResource_.get(), resource.GetName());
+            }
+
+            void ResourceImpl::OpenShared(const Buffer& resource, const ResourceImpl& source)
+            {
+                ASSERT(!D3DResource_);
+                ASSERT(source.sharedHandle_);
+                ASSERT(&source.deviceContext_ != &deviceContext_);
+
+                D3DCall(deviceContext_.GetDevice()->OpenSharedHandle(source.sharedHandle_, IID_PPV_ARGS(D3DResource_.put())));
+
+                D3DUtils::SetAPIName(D3DResource_.get(), resource.GetName());
+            }
+
+            void ResourceImpl::Rebind(const ComSharedPtr<ID3D12Resource>& resource, D3D12MA::Allocation* allocation)
+            {
+                ASSERT(resource);
+                ASSERT(allocation);
+                ASSERT(isPooled_);
+
+                releaseAllocation();
+
+                D3DResource_ = resource;
+                setAllocation(allocation);
+            }
+
+            void ResourceImpl::ReleaseImmediately()
+            {
+                ASSERT(!allocation_);
+                ASSERT(!subAllocation_.IsValid());
+
+                D3DResource_ = nullptr;
+            }
+
+            void ResourceImpl::Init(const Buffer& resource)
+            {
+                return Init(resource.GetDescription(), resource.GetCpuAccess(), resource.GetName());
+            }
+
+            void ResourceImpl::UpdateTileMapping(ID3D12CommandQueue& queue, uint32_t mipLevel, bool resident)
+            {
+                ASSERT(D3DResource_);
+                ASSERT(!mipTiles_.empty());
+                ASSERT(mipLevel < subresourceTilings_.size());
+
+                const uint32_t firstPackedMip = packedMipInfo_.NumStandardMips;
+                const bool isPacked = mipLevel >= firstPackedMip;
+
+                // Tail is shared by packed mips and stays resident while the coarsest of them is needed.
+                if (isPacked && !resident && mipLevel + 1 != subresourceTilings_.size())
+                    return;
+
+                auto& tiles = mipTiles_[isPacked ? firstPackedMip : mipLevel];
+                if (resident == !tiles.empty())
+                    return;
+
+                const auto& tiling = subresourceTilings_[mipLevel];
+                const uint32_t subresource = isPacked ? firstPackedMip : mipLevel;
+                const uint32_t numTiles = isPacked ? packedMipInfo_.NumTilesForPackedMips
+                                                   : tiling.WidthInTiles * tiling.HeightInTiles * tiling.DepthInTiles;
+
+                if (!resident)
+                {
+                    const D3D12_TILED_RESOURCE_COORDINATE coordinate = { 0, 0, 0, subresource };
+                    const D3D12_TILE_REGION_SIZE regionSize = { numTiles, FALSE, 0, 0, 0 };
+                    const D3D12_TILE_RANGE_FLAGS rangeFlags = D3D12_TILE_RANGE_FLAG_NULL;
+
+                    queue.UpdateTileMappings(D3DResource_.get(), 1, &coordinate, &regionSize, nullptr, 1, &rangeFlags, nullptr, &numTiles, D3D12_TILE_MAPPING_FLAG_NONE);
+
+                    deviceContext_.GetTilePool().Release(tiles);
+                    tiles.clear();
+                    return;
+                }
+
+                auto& tilePool = deviceContext_.GetTilePool();
+                tilePool.Allocate(numTiles, tiles);
+
+                // Runs of tiles contiguous in the heap are mapped as single region, one call per heap.
+                struct HeapBatch
+                {
+                    uint32_t heapIndex;
+                    std::vector<D3D12_TILED_RESOURCE_COORDINATE> coordinates;
+                    std::vector<D3D12_TILE_REGION_SIZE> regionSizes;
+                    std::vector<UINT> rangeOffsets;
+                    std::vector<UINT> rangeTileCounts;
+                };
+                std::vector<HeapBatch> batches;
+
+                for (uint32_t runBegin = 0, runEnd = 1; runBegin < numTiles; runBegin = runEnd++)
+                {
+                    const auto& first = tiles[runBegin];
+
+                    while (runEnd < numTiles && tiles[runEnd].heapIndex == first.heapIndex && tiles[runEnd].offset == first.offset + (runEnd - runBegin))
+                        runEnd++;
+
+                    auto batch = std::find_if(batches.begin(), batches.end(), [&first](const HeapBatch& candidate) { return candidate.heapIndex == first.heapIndex; });
+                    if (batch == batches.end())
+                        batch = batches.insert(batches.end(), HeapBatch { first.heapIndex });
+
+                    // Untiled regions address tiles linearly, packed tail tiles are addressed by x only.
+                    D3D12_TILED_RESOURCE_COORDINATE coordinate = { runBegin, 0, 0, subresource };
+                    if (!isPacked)
+                    {
+                        coordinate.X = runBegin % tiling.WidthInTiles;
+                        coordinate.Y = (runBegin / tiling.WidthInTiles) % tiling.HeightInTiles;
+                        coordinate.Z = runBegin / (tiling.WidthInTiles * tiling.HeightInTiles);
+                    }
+
+                    batch->coordinates.push_back(coordinate);
+                    batch->regionSizes.push_back({ runEnd - runBegin, FALSE, 0, 0, 0 });
+                    batch->rangeOffsets.push_back(first.offset);
+                    batch->rangeTileCounts.push_back(runEnd - runBegin);
+                }
+
+                for (const auto& batch : batches)
+                {
+                    const auto numRegions = static_cast<UINT>(batch.coordinates.size());
+
+                    queue.UpdateTileMappings(
+                        D3DResource_.get(),
+                        numRegions,
+                        batch.coordinates.data(),
+                        batch.regionSizes.data(),
+                        tilePool.GetHeap(batch.heapIndex),
+                        numRegions,
+                        nullptr,
+                        batch.rangeOffsets.data(),
+                        batch.rangeTileCounts.data(),
+                        D3D12_TILE_MAPPING_FLAG_NONE);
+                }
+            }
 
             void ResourceImpl::Map(uint32_t subresource, const D3D12_RANGE& readRange, void*& memory)
             {
                 ASSERT(D3DResource_);
                 // todo subresource readRange asserts
 
-                D3DCall(D3DResource_->Map(subresource, &readRange, &memory));
+                // Sub-allocated buffer ranges are relative to its begin.
+                const uint64_t offset = subAllocation_.offset;
+                const D3D12_RANGE range = { readRange.Begin + offset, readRange.End + offset };
+
+                D3DCall(D3DResource_->Map(subresource, &range, &memory));
+                memory = static_cast<uint8_t*>(memory) + offset;
             }
 
             void ResourceImpl::Unmap(uint32_t subresource, const D3D12_RANGE& writtenRange)
@@ -159,7 +396,10 @@ namespace RR
                 ASSERT(D3DResource_);
                 // todo subresource readRange asserts
 
-                D3DResource_->Unmap(subresource, & writtenRange);
+                const uint64_t offset = subAllocation_.offset;
+                const D3D12_RANGE range = { writtenRange.Begin + offset, writtenRange.End + offset };
+
+                D3DResource_->Unmap(subresource, &range);
             }
         }
     }
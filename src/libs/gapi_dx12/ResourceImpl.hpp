@@ -1,8 +1,16 @@
 #pragma once
 
 #include "gapi/Buffer.hpp"
+#include "gapi/Device.hpp"
 #include "gapi/Texture.hpp"
 
+#include "gapi_dx12/BufferSubAllocator.hpp"
+#include "gapi_dx12/TilePool.hpp"
+
+#include "common/debug/MemoryStats.hpp"
+
+#include <atomic>
+
 namespace D3D12MA
 {
     class Allocation;
@@ -14,26 +22,85 @@ namespace RR
     {
         namespace DX12
         {
+            class DeviceContext;
+
             class ResourceImpl final : public IGpuResource
             {
             public:
-                ResourceImpl() = default;
+                ResourceImpl(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
                 ~ResourceImpl();
 
                 void Init(const Buffer& resource);
                 void Init(const Texture& resource);
-                void Init(const GpuResourceDescription& resourceDesc, GpuResourceCpuAccess cpuAccess, const U8String& name);
+                // Placed into transient heap, memory is shared with resources of non-overlapping lifetime.
+                void InitTransient(const Texture& resource, uint32_t firstUse, uint32_t lastUse);
+                void Init(const GpuResourceDescription& resourceDesc, GpuResourceCpuAccess cpuAccess, const U8String& name,
+                          GpuResourceAllocationHint allocationHint = GpuResourceAllocationHint::Default);
 
                 void Init(const ComSharedPtr<ID3D12Resource>& resource, D3D12MA::Allocation* allocation, const U8String& name);
+                // Committed into cross adapter heap. Creator keeps shared handle open while resource lives.
+                void InitShared(const Buffer& resource);
+                // Opens cross adapter resource created by another device of the process.
+                void OpenShared(const Buffer& resource, const ResourceImpl& source);
+
+                // Maps mip tiles to tile pool memory or unmaps them. Mip already in requested state is skipped.
+                void UpdateTileMapping(ID3D12CommandQueue& queue, uint32_t mipLevel, bool resident);
 
                 const ComSharedPtr<ID3D12Resource>& GetD3DObject() const { return D3DResource_; }
+                // Offset of sub-allocated buffer in pooled D3D resource, zero for dedicated resources.
+                uint64_t GetOffset() const { return subAllocation_.offset; }
+                bool IsSubAllocated() const { return subAllocation_.IsValid(); }
+                // Placed into texture pool by allocation hint.
+                bool IsPooled() const { return isPooled_; }
+                D3D12MA::Allocation* GetAllocation() const { return allocation_; }
+
+                // Swaps backing of pooled texture moved by defragmenter, previous one is released deferred.
+                // Should be called between frames only, recorded command lists keep referencing the previous backing.
+                void Rebind(const ComSharedPtr<ID3D12Resource>& resource, D3D12MA::Allocation* allocation);
+                // Drops native reference bypassing deferred release, GPU should be done with the resource.
+                // Swap chain buffers should have no references left before the swap chain is resized.
+                void ReleaseImmediately();
+
+                // Counts command list writes, so defragmenter could drop copies invalidated while in flight.
+                void MarkWritten() { writeCount_.fetch_add(1, std::memory_order_relaxed); }
+                uint32_t GetWriteCount() const { return writeCount_.load(std::memory_order_relaxed); }
+
+                void* GetMappedData() const override { return mappedData_; }
 
                 void Map(uint32_t subresource, const D3D12_RANGE& readRange, void*& memory);
                 void Unmap(uint32_t subresource, const D3D12_RANGE& writtenRange);
 
+                bool IsTransient() const { return isTransient_; }
+                // Transient memory is reused by later frames once heaps of the frame are recycled.
+                bool IsTransientExpired() const;
+                // True only for the first call, so clears mismatching optimized clear value are reported once per resource.
+                bool ConsumeSlowClearWarning() { return !slowClearReported_.exchange(true, std::memory_order_relaxed); }
+
             private:
+                void initReserved(const GpuResourceDescription& resourceDesc, const U8String& name);
+                void setAllocation(D3D12MA::Allocation* allocation);
+                void releaseAllocation();
+
+            private:
+                DeviceContext& deviceContext_;
                 ComSharedPtr<ID3D12Resource> D3DResource_;
-                D3D12MA::Allocation* allocation_;
+                D3D12MA::Allocation* allocation_ = nullptr;
+                // Subsystem of the creator, pooled allocations rebound by defragmenter stay attributed to it.
+                Common::Debug::AllocationTag memoryTag_ = Common::Debug::AllocationTracker::GetCurrentTag();
+                BufferSubAllocator::Allocation subAllocation_;
+                HANDLE sharedHandle_ = nullptr;
+                // GpuUpload resources only, points to sub-allocation begin for pooled buffers.
+                void* mappedData_ = nullptr;
+                bool isTransient_ = false;
+                uint64_t transientGeneration_ = 0;
+                bool isPooled_ = false;
+                std::atomic<uint32_t> writeCount_ = 0;
+                std::atomic<bool> slowClearReported_ = false;
+
+                // Mapped tiles of reserved resource per standard mip, packed tail is the last entry.
+                std::vector<std::vector<TilePool::Tile>> mipTiles_;
+                std::vector<D3D12_SUBRESOURCE_TILING> subresourceTilings_;
+                D3D12_PACKED_MIP_INFO packedMipInfo_ = {};
             };
         }
     }
@@ -1,6 +1,7 @@
 #include "ResourceReleaseContext.hpp"
 
-#include "common/threading/Mutex.hpp"
+#include "gapi_dx12/BindlessDescriptorHeap.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
 #include "gapi_dx12/FenceImpl.hpp"
 #include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
 
@@ -12,22 +13,95 @@ namespace RR
         {
             ResourceReleaseContext::~ResourceReleaseContext()
             {
-                Threading::ReadWriteGuard lock(spinlock_);
                 ASSERT(!fence_);
-                ASSERT(queue_.size() == 0);
+                ASSERT(!pendingHead_);
+                ASSERT(buckets_.empty());
             }
 
             void ResourceReleaseContext::Init()
             {
-                fence_ = std::make_unique<FenceImpl>();
+                fence_ = std::make_unique<FenceImpl>(deviceContext_);
                 fence_->Init("ResourceRelease");
             }
 
             void ResourceReleaseContext::Terminate()
             {
+                // GPU is idle at this point, everything left could be released.
+                collectPending();
+
+                for (auto& bucket : buckets_)
+                    for (auto& item : bucket.releases)
+                        release(item);
+
+                buckets_.clear();
+                freeBucketStorage_.clear();
                 fence_ = nullptr;
             }
 
+            void ResourceReleaseContext::push(ResourceRelease&& release)
+            {
+                pendingReleasesCount_.fetch_add(1, std::memory_order_relaxed);
+
+                auto node = new Node { std::move(release), pendingHead_.load(std::memory_order_relaxed) };
+
+                while (!pendingHead_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+                    ;
+            }
+
+            void ResourceReleaseContext::collectPending()
+            {
+                Node* head = pendingHead_.exchange(nullptr, std::memory_order_acquire);
+
+                // Restore submission order.
+                Node* reversed = nullptr;
+                while (head)
+                {
+                    const auto next = head->next;
+                    head->next = reversed;
+                    reversed = head;
+                    head = next;
+                }
+
+                while (reversed)
+                {
+                    const auto node = reversed;
+                    reversed = node->next;
+
+                    const auto fenceValue = node->release.cpuFrameIndex;
+
+                    // Producer could be preempted between reading fence value and push.
+                    // Keeping such release in newer bucket is conservative and safe.
+                    if (buckets_.empty() || buckets_.back().fenceValue < fenceValue)
+                    {
+                        std::vector<ResourceRelease> storage;
+                        if (!freeBucketStorage_.empty())
+                        {
+                            storage = std::move(freeBucketStorage_.back());
+                            freeBucketStorage_.pop_back();
+                        }
+
+                        buckets_.push_back({ fenceValue, std::move(storage) });
+                    }
+
+                    buckets_.back().releases.push_back(std::move(node->release));
+                    delete node;
+                }
+            }
+
+            void ResourceReleaseContext::release(ResourceRelease& release)
+            {
+                pendingReleasesCount_.fetch_sub(1, std::memory_order_relaxed);
+
+                if (release.allocation)
+                    release.allocation->Release();
+
+                release.allocation = nullptr;
+                release.resource = nullptr;
+
+                if (release.bindlessIndex != BindlessDescriptorHeap::InvalidIndex)
+                    deviceContext_.GetBindlessDescriptorHeap().Free(release.bindlessIndex);
+            }
+
             void ResourceReleaseContext::deferredD3DResourceRelease(const ComSharedPtr<IUnknown>& resource, D3D12MA::Allocation* allocation)
             {
                 if (!resource)
@@ -36,33 +110,49 @@ namespace RR
                 //Resource might be leaked. Ignore it
                 if (!fence_)
                     return;
-                    
-                Threading::ReadWriteGuard lock(spinlock_);
-                queue_.push({ fence_->GetCpuValue(), resource, allocation });
+
+                push({ fence_->GetCpuValue(), resource, allocation, BindlessDescriptorHeap::InvalidIndex });
             }
 
-            void ResourceReleaseContext::executeDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue)
+            void ResourceReleaseContext::DeferredBindlessSlotRelease(uint32_t bindlessIndex)
             {
-                Threading::ReadWriteGuard lock(spinlock_);
+                ASSERT(bindlessIndex != BindlessDescriptorHeap::InvalidIndex);
+
+                //Heap might be already terminated. Ignore it
+                if (!fence_)
+                    return;
 
+                push({ fence_->GetCpuValue(), nullptr, nullptr, bindlessIndex });
+            }
+
+            void ResourceReleaseContext::ExecuteDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue, uint32_t releaseBudget)
+            {
                 ASSERT(fence_);
                 ASSERT(queue);
 
+                collectPending();
+
                 const auto gpuFenceValue = fence_->GetGpuValue();
-                while (queue_.size() && queue_.front().cpuFrameIndex < gpuFenceValue)
+                while (releaseBudget > 0 && !buckets_.empty() && buckets_.front().fenceValue < gpuFenceValue)
                 {
-                    auto& allocation = queue_.front().allocation;
+                    auto& releases = buckets_.front().releases;
 
-                    if (allocation)
-                        allocation->Release();
+                    while (releaseBudget > 0 && !releases.empty())
+                    {
+                        release(releases.back());
+                        releases.pop_back();
+                        releaseBudget--;
+                    }
 
-                    allocation = nullptr;
+                    if (!releases.empty())
+                        break;
 
-                    queue_.pop();
+                    freeBucketStorage_.push_back(std::move(releases));
+                    buckets_.pop_front();
                 }
 
                 fence_->Signal(*queue.get());
             }
         }
     }
-}
\ No newline at end of file
+}
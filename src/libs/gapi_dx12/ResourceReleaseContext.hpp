@@ -1,9 +1,9 @@
 #pragma once
 
-#include "common/Singleton.hpp"
-#include "common/threading/SpinLock.hpp"
-
-#include <queue>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <vector>
 
 namespace D3D12MA
 {
@@ -16,10 +16,12 @@ namespace RR
     {
         namespace DX12
         {
-            class FenceImpl;
             class CommandQueueImpl;
+            class DeviceContext;
+            class FenceImpl;
 
-            class ResourceReleaseContext final : public Singleton<ResourceReleaseContext>
+            // Owned by device context, objects are released once GPU is done with frames which could use them.
+            class ResourceReleaseContext final : private NonCopyable
             {
             public:
                 struct ResourceRelease
@@ -27,35 +29,66 @@ namespace RR
                     uint64_t cpuFrameIndex;
                     ComSharedPtr<IUnknown> resource;
                     D3D12MA::Allocation* allocation;
+                    uint32_t bindlessIndex;
                 };
 
             public:
-                ResourceReleaseContext() = default;
+                ResourceReleaseContext(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
                 ~ResourceReleaseContext();
 
                 void Init();
                 void Terminate();
 
                 template <class T>
-                void static DeferredD3DResourceRelease(ComSharedPtr<T>& resource, D3D12MA::Allocation* allocation = nullptr)
+                void DeferredD3DResourceRelease(ComSharedPtr<T>& resource, D3D12MA::Allocation* allocation = nullptr)
                 {
-                    Instance().deferredD3DResourceRelease(resource.as<IUnknown>(), allocation);
+                    deferredD3DResourceRelease(resource.as<IUnknown>(), allocation);
                     resource = nullptr;
                 }
 
-                void static ExecuteDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue)
+                void DeferredBindlessSlotRelease(uint32_t bindlessIndex);
+
+                // Releases at most releaseBudget objects, the rest are carried over to the next frames to avoid release spikes.
+                void ExecuteDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue, uint32_t releaseBudget = ReleasesPerFrameBudget);
+
+                void ExecuteAllDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue)
                 {
-                    Instance().executeDeferredDeletions(queue);
+                    ExecuteDeferredDeletions(queue, std::numeric_limits<uint32_t>::max());
                 }
 
+                // Scheduled releases not executed yet, including ones waiting for GPU. Any thread.
+                uint32_t GetPendingReleasesCount() const { return pendingReleasesCount_.load(std::memory_order_relaxed); }
+
+            private:
+                static constexpr uint32_t ReleasesPerFrameBudget = 2048;
+
+                // Producers push with a single CAS, consumer takes the whole list at once, so there is no ABA.
+                struct Node
+                {
+                    ResourceRelease release;
+                    Node* next;
+                };
+
+                // Releases scheduled at same fence value. Only touched by consumer.
+                struct Bucket
+                {
+                    uint64_t fenceValue;
+                    std::vector<ResourceRelease> releases;
+                };
+
             private:
+                void push(ResourceRelease&& release);
+                void collectPending();
+                void release(ResourceRelease& release);
                 void deferredD3DResourceRelease(const ComSharedPtr<IUnknown>& resource, D3D12MA::Allocation* allocation);
-                void executeDeferredDeletions(const std::shared_ptr<CommandQueueImpl>& queue);
 
             private:
+                DeviceContext& deviceContext_;
                 std::unique_ptr<FenceImpl> fence_;
-                std::queue<ResourceRelease> queue_;
-                Threading::SpinLock spinlock_;
+                std::atomic<Node*> pendingHead_ = nullptr;
+                std::atomic<uint32_t> pendingReleasesCount_ = 0;
+                std::deque<Bucket> buckets_;
+                std::vector<std::vector<ResourceRelease>> freeBucketStorage_;
             };
         }
     }
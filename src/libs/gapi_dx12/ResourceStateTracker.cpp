@@ -0,0 +1,412 @@
+#include "ResourceStateTracker.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+#ifdef ENABLE_ENHANCED_BARRIERS
+            namespace
+            {
+                struct EnhancedState final
+                {
+                    D3D12_BARRIER_SYNC sync;
+                    D3D12_BARRIER_ACCESS access;
+                    // Undefined for buffer only states.
+                    D3D12_BARRIER_LAYOUT layout;
+                };
+
+                EnhancedState getEnhancedState(D3D12_RESOURCE_STATES state)
+                {
+                    if (state == D3D12_RESOURCE_STATE_COMMON)
+                        return { D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_ACCESS_NO_ACCESS, D3D12_BARRIER_LAYOUT_COMMON };
+
+                    static constexpr std::pair<D3D12_RESOURCE_STATES, EnhancedState> states[] = {
+                        { D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, { D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_VERTEX_BUFFER | D3D12_BARRIER_ACCESS_CONSTANT_BUFFER, D3D12_BARRIER_LAYOUT_UNDEFINED } },
+                        { D3D12_RESOURCE_STATE_INDEX_BUFFER, { D3D12_BARRIER_SYNC_INDEX_INPUT, D3D12_BARRIER_ACCESS_INDEX_BUFFER, D3D12_BARRIER_LAYOUT_UNDEFINED } },
+                        { D3D12_RESOURCE_STATE_RENDER_TARGET, { D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET, D3D12_BARRIER_LAYOUT_RENDER_TARGET } },
+                        { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, { D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS } },
+                        { D3D12_RESOURCE_STATE_DEPTH_WRITE, { D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE } },
+                        { D3D12_RESOURCE_STATE_DEPTH_READ, { D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ } },
+                        { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, { D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE } },
+                        { D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, { D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE } },
+                        // Same state bit as predication.
+                        { D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, { D3D12_BARRIER_SYNC_EXECUTE_INDIRECT | D3D12_BARRIER_SYNC_PREDICATION, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT | D3D12_BARRIER_ACCESS_PREDICATION, D3D12_BARRIER_LAYOUT_UNDEFINED } },
+                        { D3D12_RESOURCE_STATE_COPY_DEST, { D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST, D3D12_BARRIER_LAYOUT_COPY_DEST } },
+                        { D3D12_RESOURCE_STATE_COPY_SOURCE, { D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE, D3D12_BARRIER_LAYOUT_COPY_SOURCE } },
+                        { D3D12_RESOURCE_STATE_RESOLVE_DEST, { D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_DEST, D3D12_BARRIER_LAYOUT_RESOLVE_DEST } },
+                        { D3D12_RESOURCE_STATE_RESOLVE_SOURCE, { D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_SOURCE, D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE } },
+                        { D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE, { D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE, D3D12_BARRIER_LAYOUT_SHADING_RATE_SOURCE } },
+                    };
+
+                    EnhancedState result = { D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_ACCESS_COMMON, D3D12_BARRIER_LAYOUT_UNDEFINED };
+                    auto remainingState = state;
+
+                    for (const auto& [legacyState, enhancedState] : states)
+                    {
+                        if ((state & legacyState) == 0)
+                            continue;
+
+                        result.sync |= enhancedState.sync;
+                        result.access |= enhancedState.access;
+                        remainingState &= ~legacyState;
+
+                        if (enhancedState.layout == D3D12_BARRIER_LAYOUT_UNDEFINED || result.layout == enhancedState.layout)
+                            continue;
+
+                        // Combined read states, e.g. shader resource and copy source.
+                        result.layout = result.layout == D3D12_BARRIER_LAYOUT_UNDEFINED ? enhancedState.layout : D3D12_BARRIER_LAYOUT_GENERIC_READ;
+                    }
+
+                    ASSERT_MSG(remainingState == 0, "Resource state 0x%x has no enhanced barrier equivalent", static_cast<uint32_t>(remainingState));
+                    return result;
+                }
+            }
+#endif
+
+            ResourceStateTracker::ResourceState& ResourceStateTracker::getResourceState(ID3D12Resource* resource)
+            {
+                const auto [it, inserted] = states_.try_emplace(resource);
+                auto& resourceState = it->second;
+
+                if (inserted)
+                {
+                    const auto desc = resource->GetDesc();
+                    resourceState.promotableToAnyState = desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ||
+                                                         (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS) != 0;
+                }
+
+                return resourceState;
+            }
+
+            void ResourceStateTracker::TransitionResource(ID3D12Resource* resource, uint32_t numSubresources, D3D12_RESOURCE_STATES state, uint32_t subresource)
+            {
+                ASSERT(resource);
+                ASSERT(numSubresources > 0);
+                ASSERT(subresource == AllSubresources || subresource < numSubresources);
+
+                auto& resourceState = getResourceState(resource);
+                auto& subresourceStates = resourceState.subresourceStates;
+
+                if (resourceState.isSplitPending)
+                    endSplitTransition(resource, resourceState);
+
+                if (subresource == AllSubresources)
+                {
+                    if (subresourceStates.empty())
+                    {
+                        if (resourceState.state != state)
+                            transition(resource, resourceState, resourceState.state, state, AllSubresources);
+                    }
+                    else
+                    {
+                        ASSERT(subresourceStates.size() == numSubresources);
+
+                        for (uint32_t index = 0; index < numSubresources; index++)
+                            if (subresourceStates[index] != state)
+                                transition(resource, resourceState, subresourceStates[index], state, index);
+
+                        subresourceStates.clear();
+                    }
+
+                    resourceState.state = state;
+                    return;
+                }
+
+                if (subresourceStates.empty())
+                {
+                    if (resourceState.state == state)
+                        return;
+
+                    if (numSubresources == 1)
+                    {
+                        transition(resource, resourceState, resourceState.state, state, AllSubresources);
+                        resourceState.state = state;
+                        return;
+                    }
+
+                    subresourceStates.assign(numSubresources, resourceState.state);
+                }
+
+                ASSERT(subresourceStates.size() == numSubresources);
+
+                if (subresourceStates[subresource] != state)
+                {
+                    transition(resource, resourceState, subresourceStates[subresource], state, subresource);
+                    subresourceStates[subresource] = state;
+                }
+            }
+
+            void ResourceStateTracker::BeginTransition(ID3D12Resource* resource, uint32_t numSubresources, D3D12_RESOURCE_STATES state)
+            {
+                ASSERT(resource);
+
+                auto& resourceState = getResourceState(resource);
+
+                if (resourceState.isSplitPending || !resourceState.subresourceStates.empty() ||
+                    isPromotion(resourceState, resourceState.state, state))
+                {
+                    TransitionResource(resource, numSubresources, state);
+                    return;
+                }
+
+                if (resourceState.state == state)
+                    return;
+
+                addBarrier(resource, resourceState.state, state, AllSubresources, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+
+                resourceState.splitBefore = resourceState.state;
+                resourceState.state = state;
+                resourceState.isSplitPending = true;
+            }
+
+            void ResourceStateTracker::RestoreCommonState()
+            {
+                for (auto& [resource, resourceState] : states_)
+                {
+                    if (resourceState.isSplitPending)
+                        endSplitTransition(resource, resourceState);
+
+                    if (resourceState.subresourceStates.empty())
+                    {
+                        if (resourceState.state != D3D12_RESOURCE_STATE_COMMON)
+                            addBarrier(resource, resourceState.state, D3D12_RESOURCE_STATE_COMMON, AllSubresources);
+
+                        continue;
+                    }
+
+                    const auto& subresourceStates = resourceState.subresourceStates;
+                    for (uint32_t index = 0; index < subresourceStates.size(); index++)
+                        if (subresourceStates[index] != D3D12_RESOURCE_STATE_COMMON)
+                            addBarrier(resource, subresourceStates[index], D3D12_RESOURCE_STATE_COMMON, index);
+                }
+
+                states_.clear();
+            }
+
+            bool ResourceStateTracker::IsInState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, uint32_t subresource) const
+            {
+                ASSERT(resource);
+
+                const auto it = states_.find(resource);
+                if (it == states_.end())
+                    return state == D3D12_RESOURCE_STATE_COMMON;
+
+                const auto& resourceState = it->second;
+                if (resourceState.isSplitPending)
+                    return false;
+
+                const auto& subresourceStates = resourceState.subresourceStates;
+                if (subresourceStates.empty())
+                    return resourceState.state == state;
+
+                if (subresource != AllSubresources)
+                    return subresourceStates[subresource] == state;
+
+                return std::all_of(subresourceStates.begin(), subresourceStates.end(), [state](D3D12_RESOURCE_STATES subresourceState) { return subresourceState == state; });
+            }
+
+            void ResourceStateTracker::FlushBarriers(ID3D12GraphicsCommandList* commandList)
+            {
+                ASSERT(commandList);
+
+                if (pendingBarriers_.empty())
+                    return;
+
+                commandList->ResourceBarrier(static_cast<UINT>(pendingBarriers_.size()), pendingBarriers_.data());
+                pendingBarriers_.clear();
+            }
+
+#ifdef ENABLE_ENHANCED_BARRIERS
+            void ResourceStateTracker::FlushBarriers(ID3D12GraphicsCommandList7* commandList)
+            {
+                ASSERT(commandList);
+
+                if (!enhancedBarriers_)
+                {
+                    FlushBarriers(static_cast<ID3D12GraphicsCommandList*>(commandList));
+                    return;
+                }
+
+                if (pendingBarriers_.empty())
+                    return;
+
+                for (const auto& barrier : pendingBarriers_)
+                {
+                    if (barrier.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+                    {
+                        legacyBarriers_.push_back(barrier);
+                        continue;
+                    }
+
+                    const auto& transition = barrier.Transition;
+                    auto before = getEnhancedState(transition.StateBefore);
+                    auto after = getEnhancedState(transition.StateAfter);
+
+                    // Split barrier keeps accesses and layouts of both halves, only sync scope of the gap is split.
+                    if (barrier.Flags & D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                        after.sync = D3D12_BARRIER_SYNC_SPLIT;
+                    if (barrier.Flags & D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+                        before.sync = D3D12_BARRIER_SYNC_SPLIT;
+
+                    const auto desc = transition.pResource->GetDesc();
+                    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+                    {
+                        bufferBarriers_.push_back({ before.sync, after.sync, before.access, after.access, transition.pResource, 0, UINT64_MAX });
+                        continue;
+                    }
+
+                    // Simultaneous access textures are always in common layout.
+                    const bool isCommonLayout = (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS) != 0;
+
+                    D3D12_TEXTURE_BARRIER textureBarrier = {};
+                    textureBarrier.SyncBefore = before.sync;
+                    textureBarrier.SyncAfter = after.sync;
+                    textureBarrier.AccessBefore = before.access;
+                    textureBarrier.AccessAfter = after.access;
+                    textureBarrier.LayoutBefore = isCommonLayout ? D3D12_BARRIER_LAYOUT_COMMON : before.layout;
+                    textureBarrier.LayoutAfter = isCommonLayout ? D3D12_BARRIER_LAYOUT_COMMON : after.layout;
+                    textureBarrier.pResource = transition.pResource;
+                    // All subresources are selected by index 0xFFFFFFFF, single one by index with zero mip count.
+                    textureBarrier.Subresources.IndexOrFirstMipLevel = transition.Subresource;
+                    textureBarriers_.push_back(textureBarrier);
+                }
+
+                // Aliasing and UAV barriers precede transitions they were recorded with, as in legacy batch.
+                if (!legacyBarriers_.empty())
+                    commandList->ResourceBarrier(static_cast<UINT>(legacyBarriers_.size()), legacyBarriers_.data());
+
+                std::array<D3D12_BARRIER_GROUP, 2> groups;
+                uint32_t groupsCount = 0;
+
+                if (!bufferBarriers_.empty())
+                {
+                    auto& group = groups[groupsCount++];
+                    group.Type = D3D12_BARRIER_TYPE_BUFFER;
+                    group.NumBarriers = static_cast<UINT32>(bufferBarriers_.size());
+                    group.pBufferBarriers = bufferBarriers_.data();
+                }
+
+                if (!textureBarriers_.empty())
+                {
+                    auto& group = groups[groupsCount++];
+                    group.Type = D3D12_BARRIER_TYPE_TEXTURE;
+                    group.NumBarriers = static_cast<UINT32>(textureBarriers_.size());
+                    group.pTextureBarriers = textureBarriers_.data();
+                }
+
+                if (groupsCount > 0)
+                    commandList->Barrier(groupsCount, groups.data());
+
+                pendingBarriers_.clear();
+                legacyBarriers_.clear();
+                bufferBarriers_.clear();
+                textureBarriers_.clear();
+            }
+#endif
+
+            void ResourceStateTracker::AliasResource(ID3D12Resource* resource)
+            {
+                ASSERT(resource);
+
+                pendingBarriers_.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource));
+            }
+
+            void ResourceStateTracker::UnorderedAccessBarrier(ID3D12Resource* resource)
+            {
+                ASSERT(resource);
+
+                const auto it = states_.find(resource);
+                if (it != states_.end() && it->second.isSplitPending)
+                    endSplitTransition(resource, it->second);
+
+                pendingBarriers_.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            }
+
+            void ResourceStateTracker::Reset()
+            {
+                ASSERT(pendingBarriers_.empty());
+
+                states_.clear();
+                pendingBarriers_.clear();
+            }
+
+            bool ResourceStateTracker::isPromotion(const ResourceState& resourceState, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) const
+            {
+                // Resources are shared by queues in COMMON state and promoted on the first access in command list,
+                // e.g. resources uploaded on copy queue are consumed on graphics queue without extra barriers.
+                constexpr auto promotableStates = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+                                                  D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+                if (before != D3D12_RESOURCE_STATE_COMMON)
+                    return false;
+
+                if (resourceState.promotableToAnyState)
+                    return true;
+
+                // Texture layouts of enhanced barriers aren't promoted.
+                return !enhancedBarriers_ && (after & ~promotableStates) == 0;
+            }
+
+            void ResourceStateTracker::transition(ID3D12Resource* resource, const ResourceState& resourceState, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, uint32_t subresource)
+            {
+                if (isPromotion(resourceState, before, after))
+                    return;
+
+                addBarrier(resource, before, after, subresource);
+            }
+
+            void ResourceStateTracker::endSplitTransition(ID3D12Resource* resource, ResourceState& resourceState)
+            {
+                ASSERT(resourceState.isSplitPending);
+                resourceState.isSplitPending = false;
+
+                // Begin which isn't flushed yet becomes regular transition, there is no work to overlap with.
+                for (auto& barrier : pendingBarriers_)
+                {
+                    if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION && barrier.Transition.pResource == resource &&
+                        barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                    {
+                        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                        return;
+                    }
+                }
+
+                addBarrier(resource, resourceState.splitBefore, resourceState.state, AllSubresources, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+            }
+
+            void ResourceStateTracker::addBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, uint32_t subresource,
+                                                  D3D12_RESOURCE_BARRIER_FLAGS flags)
+            {
+                ASSERT(before != after);
+
+                if (flags != D3D12_RESOURCE_BARRIER_FLAG_NONE)
+                {
+                    pendingBarriers_.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, before, after, subresource, flags));
+                    return;
+                }
+
+                // Elide transition pair which cancels out before flush.
+                for (auto it = pendingBarriers_.begin(); it != pendingBarriers_.end(); ++it)
+                {
+                    if (it->Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION || it->Flags != D3D12_RESOURCE_BARRIER_FLAG_NONE)
+                        continue;
+
+                    const auto& transition = it->Transition;
+
+                    if (transition.pResource == resource && transition.Subresource == subresource &&
+                        transition.StateBefore == after && transition.StateAfter == before)
+                    {
+                        pendingBarriers_.erase(it);
+                        return;
+                    }
+                }
+
+                pendingBarriers_.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, before, after, subresource));
+            }
+        }
+    }
+}
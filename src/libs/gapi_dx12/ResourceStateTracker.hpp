@@ -0,0 +1,80 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            // Tracks resource states within single command list.
+            // Resources are expected to be in COMMON state between command lists, so queue ownership could be transferred
+            // without barriers. Transitions from COMMON which GPU does by implicit promotion aren't recorded.
+            // With enhanced barriers transitions are translated to layouts and sync scopes on flush. Textures have
+            // no implicit promotion then, so their transitions from COMMON are recorded too.
+            class ResourceStateTracker final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t AllSubresources = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+                ResourceStateTracker() = default;
+                ~ResourceStateTracker() = default;
+
+                // Called before any transitions are recorded.
+                void EnableEnhancedBarriers() { enhancedBarriers_ = true; }
+
+                void TransitionResource(ID3D12Resource* resource, uint32_t numSubresources, D3D12_RESOURCE_STATES state, uint32_t subresource = AllSubresources);
+                // Starts split transition of the whole resource, next transition or barrier of the resource ends it.
+                // GPU overlaps the transition with work recorded in between. Subresources in different states transition right away.
+                void BeginTransition(ID3D12Resource* resource, uint32_t numSubresources, D3D12_RESOURCE_STATES state);
+                void RestoreCommonState();
+                // Untracked resources are in COMMON state. Whole resource is in state when all its subresources are.
+                bool IsInState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, uint32_t subresource = AllSubresources) const;
+                // Activates placed resource in memory shared with other resources.
+                void AliasResource(ID3D12Resource* resource);
+                // Waits for unordered accesses recorded so far, state stays UNORDERED_ACCESS.
+                void UnorderedAccessBarrier(ID3D12Resource* resource);
+
+                void FlushBarriers(ID3D12GraphicsCommandList* commandList);
+#ifdef ENABLE_ENHANCED_BARRIERS
+                // Transitions are issued as enhanced barriers when they are enabled, aliasing and UAV barriers stay legacy.
+                void FlushBarriers(ID3D12GraphicsCommandList7* commandList);
+#endif
+                void Reset();
+
+            private:
+                struct ResourceState
+                {
+                    // Valid only if subresourceStates is empty.
+                    D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+                    std::vector<D3D12_RESOURCE_STATES> subresourceStates;
+                    // Buffers and simultaneous access textures.
+                    bool promotableToAnyState = false;
+                    // State is the target of split transition begun from splitBefore.
+                    bool isSplitPending = false;
+                    D3D12_RESOURCE_STATES splitBefore = D3D12_RESOURCE_STATE_COMMON;
+                };
+
+                ResourceState& getResourceState(ID3D12Resource* resource);
+                bool isPromotion(const ResourceState& resourceState, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) const;
+                void transition(ID3D12Resource* resource, const ResourceState& resourceState, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, uint32_t subresource);
+                void endSplitTransition(ID3D12Resource* resource, ResourceState& resourceState);
+
+                void addBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, uint32_t subresource,
+                                D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE);
+
+            private:
+                bool enhancedBarriers_ = false;
+                std::unordered_map<ID3D12Resource*, ResourceState> states_;
+                std::vector<D3D12_RESOURCE_BARRIER> pendingBarriers_;
+#ifdef ENABLE_ENHANCED_BARRIERS
+                // Reused between flushes.
+                std::vector<D3D12_RESOURCE_BARRIER> legacyBarriers_;
+                std::vector<D3D12_BUFFER_BARRIER> bufferBarriers_;
+                std::vector<D3D12_TEXTURE_BARRIER> textureBarriers_;
+#endif
+            };
+        }
+    }
+}
@@ -0,0 +1,340 @@
+#include "RootSignatureCache.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+#include "include/rfx.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                // FNV-1a
+                constexpr uint64_t HashOffsetBasis = 0xcbf29ce484222325ull;
+                constexpr uint64_t HashPrime = 0x100000001b3ull;
+
+                template <typename T>
+                inline void hashValue(uint64_t& hash, const T& value)
+                {
+                    static_assert(std::is_trivially_copyable<T>::value);
+
+                    const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+                    for (size_t index = 0; index < sizeof(T); index++)
+                    {
+                        hash ^= bytes[index];
+                        hash *= HashPrime;
+                    }
+                }
+
+                D3D12_DESCRIPTOR_RANGE_TYPE getDescriptorRangeType(Rfx::Reflection::ResourceType type)
+                {
+                    switch (type)
+                    {
+                        case Rfx::Reflection::ResourceType::ConstantBuffer: return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+                        case Rfx::Reflection::ResourceType::Texture:
+                        case Rfx::Reflection::ResourceType::Buffer: return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                        case Rfx::Reflection::ResourceType::RWTexture:
+                        case Rfx::Reflection::ResourceType::RWBuffer: return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+                        case Rfx::Reflection::ResourceType::Sampler: return D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+                        default: LOG_FATAL("Unsupported resource type");
+                    }
+
+                    return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+                }
+
+                // Returns nullptr for samplers kept in sampler table.
+                const StaticSampler* findStaticSampler(const Rfx::Reflection::Resource& resource, const std::vector<StaticSampler>& staticSamplers)
+                {
+                    if (resource.type != Rfx::Reflection::ResourceType::Sampler || resource.count != 1)
+                        return nullptr;
+
+                    const auto it = std::find_if(staticSamplers.begin(), staticSamplers.end(),
+                                                 [&resource](const StaticSampler& sampler) { return sampler.nameHash == resource.nameHash; });
+
+                    return it != staticSamplers.end() ? &*it : nullptr;
+                }
+
+                bool isDrawConstants(const Rfx::Reflection::Resource& resource, uint32_t drawConstantsCount)
+                {
+                    return drawConstantsCount > 0 && resource.space == PipelineStateDescription::DrawConstantsSpace &&
+                           resource.type == Rfx::Reflection::ResourceType::ConstantBuffer;
+                }
+
+                template <typename T>
+                inline void writeValue(std::ofstream& file, const T& value)
+                {
+                    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+
+                template <typename T>
+                inline bool readValue(std::ifstream& file, T& value)
+                {
+                    return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+                }
+            }
+
+            RootSignatureCache::~RootSignatureCache()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void RootSignatureCache::Init(const U8String& pipelineCachePath)
+            {
+                ASSERT(!isInited_);
+
+                if (!pipelineCachePath.empty())
+                    cachePath_ = pipelineCachePath + CacheExtension;
+
+                load();
+
+                isInited_ = true;
+            }
+
+            void RootSignatureCache::Terminate()
+            {
+                ASSERT(isInited_);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                store();
+
+                for (auto& rootSignature : rootSignatures_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(rootSignature.second);
+
+                rootSignatures_.clear();
+                serializedRootSignatures_.clear();
+
+                isInited_ = false;
+            }
+
+            uint64_t RootSignatureCache::GetLayoutHash(const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount)
+            {
+                ASSERT(reflection.IsValid());
+
+                uint64_t hash = HashOffsetBasis;
+                hashValue(hash, drawConstantsCount);
+                hashValue(hash, reflection.GetRootParametersCount());
+
+                for (uint32_t parameterIndex = 0; parameterIndex < reflection.GetRootParametersCount(); parameterIndex++)
+                {
+                    const auto& parameter = reflection.GetRootParameter(parameterIndex);
+                    hashValue(hash, parameter.type);
+                    hashValue(hash, parameter.resourcesCount);
+
+                    for (uint32_t index = 0; index < parameter.resourcesCount; index++)
+                    {
+                        const auto& resource = reflection.GetResource(parameter.firstResource + index);
+                        if (isDrawConstants(resource, drawConstantsCount))
+                            continue;
+
+                        hashValue(hash, getDescriptorRangeType(resource.type));
+                        hashValue(hash, resource.space);
+                        hashValue(hash, resource.binding);
+                        hashValue(hash, resource.count);
+
+                        const auto staticSampler = findStaticSampler(resource, staticSamplers);
+                        hashValue(hash, staticSampler != nullptr);
+
+                        if (staticSampler)
+                            hashValue(hash, staticSampler->description);
+                    }
+                }
+
+                return hash;
+            }
+
+            ComSharedPtr<ID3D12RootSignature> RootSignatureCache::GetOrCreate(const std::vector<uint8_t>& reflectionBlob, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount)
+            {
+                ASSERT(isInited_);
+
+                if (reflectionBlob.empty())
+                    return nullptr;
+
+                const Rfx::Reflection::View reflection(reflectionBlob.data(), reflectionBlob.size());
+                if (!reflection.IsValid())
+                {
+                    Log::Print::Warning("Invalid shader reflection, embedded root signature is used.\n");
+                    return nullptr;
+                }
+
+                const auto hash = GetLayoutHash(reflection, staticSamplers, drawConstantsCount);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                const auto it = rootSignatures_.find(hash);
+                if (it != rootSignatures_.end())
+                    return it->second;
+
+                auto rootSignature = create(hash, reflection, staticSamplers, drawConstantsCount);
+                if (rootSignature)
+                    rootSignatures_.emplace(hash, rootSignature);
+
+                return rootSignature;
+            }
+
+            ComSharedPtr<ID3D12RootSignature> RootSignatureCache::create(uint64_t hash, const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount)
+            {
+                const auto& device = deviceContext_.GetDevice();
+                ComSharedPtr<ID3D12RootSignature> rootSignature;
+
+                const auto it = serializedRootSignatures_.find(hash);
+                if (it != serializedRootSignatures_.end())
+                {
+                    const auto& blob = it->second;
+
+                    // Stale blob from another runtime version is serialized again.
+                    if (SUCCEEDED(device->CreateRootSignature(0, blob.data(), blob.size(), IID_PPV_ARGS(rootSignature.put()))))
+                        return rootSignature;
+
+                    serializedRootSignatures_.erase(it);
+                }
+
+                std::vector<uint8_t> blob;
+                if (!serialize(reflection, staticSamplers, drawConstantsCount, blob))
+                    return nullptr;
+
+                D3DCall(device->CreateRootSignature(0, blob.data(), blob.size(), IID_PPV_ARGS(rootSignature.put())));
+                D3DUtils::SetAPIName(rootSignature.get(), "RootSignature_%016llx", hash);
+
+                serializedRootSignatures_.emplace(hash, std::move(blob));
+                isDirty_ = true;
+
+                return rootSignature;
+            }
+
+            bool RootSignatureCache::serialize(const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount, std::vector<uint8_t>& blob) const
+            {
+                const auto& device = deviceContext_.GetDevice();
+
+                D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = { D3D_ROOT_SIGNATURE_VERSION_1_1 };
+                if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &featureData, sizeof(featureData))))
+                    featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+
+                const auto parametersCount = reflection.GetRootParametersCount();
+
+                // Ranges are referenced by root parameters until serialization.
+                std::vector<std::vector<CD3DX12_DESCRIPTOR_RANGE1>> ranges(parametersCount);
+                std::vector<CD3DX12_ROOT_PARAMETER1> rootParameters;
+                std::vector<D3D12_STATIC_SAMPLER_DESC> staticSamplerDescs;
+
+                if (drawConstantsCount > 0)
+                    rootParameters.emplace_back().InitAsConstants(drawConstantsCount, 0, PipelineStateDescription::DrawConstantsSpace);
+
+                for (uint32_t parameterIndex = 0; parameterIndex < parametersCount; parameterIndex++)
+                {
+                    const auto& parameter = reflection.GetRootParameter(parameterIndex);
+                    auto& parameterRanges = ranges[parameterIndex];
+                    parameterRanges.reserve(parameter.resourcesCount);
+
+                    for (uint32_t index = 0; index < parameter.resourcesCount; index++)
+                    {
+                        const auto& resource = reflection.GetResource(parameter.firstResource + index);
+                        if (isDrawConstants(resource, drawConstantsCount))
+                            continue;
+
+                        if (const auto staticSampler = findStaticSampler(resource, staticSamplers))
+                        {
+                            staticSamplerDescs.push_back(D3DUtils::GetStaticSamplerDesc(staticSampler->description, resource.binding, resource.space));
+                            continue;
+                        }
+
+                        const auto isUnbounded = resource.count == 0;
+
+                        // Unbounded arrays are bindless tables, descriptors are updated while table is bound.
+                        auto& range = parameterRanges.emplace_back();
+                        range.Init(getDescriptorRangeType(resource.type),
+                                   isUnbounded ? UINT_MAX : resource.count,
+                                   resource.binding,
+                                   resource.space,
+                                   isUnbounded ? D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE : D3D12_DESCRIPTOR_RANGE_FLAG_NONE);
+                    }
+
+                    if (parameterRanges.empty())
+                        continue;
+
+                    auto& rootParameter = rootParameters.emplace_back();
+                    rootParameter.InitAsDescriptorTable(static_cast<UINT>(parameterRanges.size()), parameterRanges.data());
+                }
+
+                CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC desc;
+                desc.Init_1_1(static_cast<UINT>(rootParameters.size()), rootParameters.data(),
+                              static_cast<UINT>(staticSamplerDescs.size()), staticSamplerDescs.data(),
+                              D3D12_ROOT_SIGNATURE_FLAG_NONE);
+
+                ComSharedPtr<ID3DBlob> signature;
+                ComSharedPtr<ID3DBlob> error;
+                if (FAILED(D3DX12SerializeVersionedRootSignature(&desc, featureData.HighestVersion, signature.put(), error.put())))
+                {
+                    Log::Format::Warning("Root signature serialization failed: {}\n", error ? static_cast<const char*>(error->GetBufferPointer()) : "");
+                    return false;
+                }
+
+                const auto data = static_cast<const uint8_t*>(signature->GetBufferPointer());
+                blob.assign(data, data + signature->GetBufferSize());
+
+                return true;
+            }
+
+            void RootSignatureCache::load()
+            {
+                if (cachePath_.empty())
+                    return;
+
+                std::ifstream file(cachePath_, std::ios::binary);
+                if (!file)
+                    return;
+
+                uint32_t version = 0;
+                uint32_t count = 0;
+                if (!readValue(file, version) || version != CacheVersion || !readValue(file, count))
+                    return;
+
+                for (uint32_t index = 0; index < count; index++)
+                {
+                    uint64_t hash;
+                    uint32_t size;
+                    if (!readValue(file, hash) || !readValue(file, size))
+                        break;
+
+                    std::vector<uint8_t> blob(size);
+                    if (!file.read(reinterpret_cast<char*>(blob.data()), size))
+                        break;
+
+                    serializedRootSignatures_.emplace(hash, std::move(blob));
+                }
+            }
+
+            void RootSignatureCache::store()
+            {
+                if (!isDirty_ || cachePath_.empty())
+                    return;
+
+                std::ofstream file(cachePath_, std::ios::binary | std::ios::trunc);
+                if (!file)
+                {
+                    Log::Print::Warning("Can't write root signature cache \"%s\".\n", cachePath_);
+                    return;
+                }
+
+                writeValue(file, CacheVersion);
+                writeValue(file, static_cast<uint32_t>(serializedRootSignatures_.size()));
+
+                for (const auto& [hash, blob] : serializedRootSignatures_)
+                {
+                    writeValue(file, hash);
+                    writeValue(file, static_cast<uint32_t>(blob.size()));
+                    file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+                }
+
+                isDirty_ = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+
+#include "gapi/PipelineState.hpp"
+
+#include <unordered_map>
+
+namespace Rfx
+{
+    namespace Reflection
+    {
+        class View;
+    }
+}
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Root signatures built from binding layout of rfx reflection, keyed by layout hash.
+            // Shaders with identical layouts share one root signature, so command lists skip rebinding it.
+            // Serialized root signatures are stored next to pipeline cache and reused on warm starts.
+            class RootSignatureCache final : private NonCopyable
+            {
+            public:
+                RootSignatureCache(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~RootSignatureCache();
+
+                // Empty cache path disables persistence.
+                void Init(const U8String& pipelineCachePath);
+                void Terminate();
+
+                // Returns nullptr for empty or invalid reflection, root signature embedded in bytecode is used then.
+                // Single samplers with static description are promoted to static samplers, sampler tables left empty are dropped.
+                // Draw constants are root parameter 0, resources of PipelineStateDescription::DrawConstantsSpace are left out of tables.
+                ComSharedPtr<ID3D12RootSignature> GetOrCreate(const std::vector<uint8_t>& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount);
+
+                // Only bindings and promoted samplers are hashed, names and constant buffers layout don't affect root signature.
+                static uint64_t GetLayoutHash(const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount);
+
+            private:
+                bool serialize(const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount, std::vector<uint8_t>& blob) const;
+                ComSharedPtr<ID3D12RootSignature> create(uint64_t hash, const Rfx::Reflection::View& reflection, const std::vector<StaticSampler>& staticSamplers, uint32_t drawConstantsCount);
+
+                void load();
+                void store();
+
+            private:
+                DeviceContext& deviceContext_;
+                static constexpr uint32_t CacheVersion = 2;
+                static constexpr const char* CacheExtension = ".rootsig";
+
+                bool isInited_ = false;
+                bool isDirty_ = false;
+                U8String cachePath_;
+
+                std::unordered_map<uint64_t, std::vector<uint8_t>> serializedRootSignatures_;
+                std::unordered_map<uint64_t, ComSharedPtr<ID3D12RootSignature>> rootSignatures_;
+                Threading::Mutex mutex_;
+            };
+        }
+    }
+}
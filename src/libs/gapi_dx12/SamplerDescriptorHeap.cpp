@@ -0,0 +1,67 @@
+#include "SamplerDescriptorHeap.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            SamplerDescriptorHeap::~SamplerDescriptorHeap()
+            {
+                ASSERT(!d3d12Heap_);
+            }
+
+            void SamplerDescriptorHeap::Init()
+            {
+                ASSERT(!d3d12Heap_);
+
+                const auto& device = deviceContext_.GetDevice();
+
+                descriptorSize_ = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+                D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+                heapDesc.NumDescriptors = MaxSamplers;
+                heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+                heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+                D3DCall(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(d3d12Heap_.put())));
+                D3DUtils::SetAPIName(d3d12Heap_.get(), "Samplers");
+
+                cpuHeapStart_ = d3d12Heap_->GetCPUDescriptorHandleForHeapStart();
+                gpuHeapStart_ = d3d12Heap_->GetGPUDescriptorHandleForHeapStart();
+            }
+
+            void SamplerDescriptorHeap::Terminate()
+            {
+                ASSERT(d3d12Heap_);
+
+                indices_.clear();
+                d3d12Heap_ = nullptr;
+            }
+
+            uint32_t SamplerDescriptorHeap::GetOrCreate(const SamplerDescription& description)
+            {
+                ASSERT(d3d12Heap_);
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                const auto it = indices_.find(description);
+                if (it != indices_.end())
+                    return it->second;
+
+                const auto index = static_cast<uint32_t>(indices_.size());
+                if (index >= MaxSamplers)
+                    LOG_FATAL("Not enough memory in sampler descriptor heap");
+
+                const auto& samplerDesc = D3DUtils::GetSamplerDesc(description);
+                deviceContext_.GetDevice()->CreateSampler(&samplerDesc, CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuHeapStart_, index, descriptorSize_));
+
+                indices_.emplace(description, index);
+
+                return index;
+            }
+        }
+    }
+}
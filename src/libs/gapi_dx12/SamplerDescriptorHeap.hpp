@@ -0,0 +1,55 @@
+#pragma once
+
+#include "gapi/Sampler.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <unordered_map>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Shader visible sampler heap. Samplers are deduplicated by description and never freed,
+            // so the heap size limit applies to distinct descriptions only.
+            class SamplerDescriptorHeap final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t MaxSamplers = D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE;
+
+                SamplerDescriptorHeap(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~SamplerDescriptorHeap();
+
+                void Init();
+                void Terminate();
+
+                // Index of sampler in heap, equal descriptions share one descriptor.
+                uint32_t GetOrCreate(const SamplerDescription& description);
+
+                CD3DX12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const
+                {
+                    ASSERT(d3d12Heap_);
+                    ASSERT(index < MaxSamplers);
+                    return CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuHeapStart_, index, descriptorSize_);
+                }
+
+                const ComSharedPtr<ID3D12DescriptorHeap>& GetD3DObject() const { return d3d12Heap_; }
+
+            private:
+                DeviceContext& deviceContext_;
+                uint32_t descriptorSize_ = 0;
+                D3D12_CPU_DESCRIPTOR_HANDLE cpuHeapStart_ = {};
+                D3D12_GPU_DESCRIPTOR_HANDLE gpuHeapStart_ = {};
+
+                std::unordered_map<SamplerDescription, uint32_t, SamplerDescription::HashFunc> indices_;
+                Threading::Mutex mutex_;
+
+                ComSharedPtr<ID3D12DescriptorHeap> d3d12Heap_;
+            };
+        }
+    }
+}
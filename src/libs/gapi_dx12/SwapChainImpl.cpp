@@ -27,7 +27,10 @@ namespace RR
 
             SwapChainImpl::~SwapChainImpl()
             {
-                ResourceReleaseContext::DeferredD3DResourceRelease(D3DSwapChain_);
+                if (frameLatencyWaitableObject_)
+                    CloseHandle(frameLatencyWaitableObject_);
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(D3DSwapChain_);
             }
 
             void SwapChainImpl::Init(const ComSharedPtr<ID3D12Device>& device, const ComSharedPtr<IDXGIFactory2>& dxgiFactory, const ComSharedPtr<ID3D12CommandQueue>& commandQueue, const SwapChainDescription& description, const U8String& name)
@@ -40,7 +43,15 @@ namespace RR
                 // Swapchain don't have name
                 std::ignore = name;
 
-                const auto& targetSwapChainDesc = D3DUtils::GetDxgiSwapChainDesc1(description, DXGI_SWAP_EFFECT_FLIP_DISCARD);
+                ComSharedPtr<IDXGIFactory5> dxgiFactory5;
+                if (description.allowTearing && dxgiFactory.try_as(dxgiFactory5))
+                {
+                    BOOL allowTearing = FALSE;
+                    if (SUCCEEDED(dxgiFactory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+                        isTearingSupported_ = (allowTearing == TRUE);
+                }
+
+                const auto& targetSwapChainDesc = getTargetSwapChainDesc(description);
 
                 ComSharedPtr<IDXGISwapChain1> swapChain1;
                 // Create a swap chain for the window.
@@ -56,6 +67,13 @@ namespace RR
                     LOG_FATAL("Failed to cast swapchain");
 
                 swapChain1.as(D3DSwapChain_);
+
+                if (description.maxFrameLatency > 0)
+                {
+                    D3DCall(D3DSwapChain_->SetMaximumFrameLatency(description.maxFrameLatency));
+                    frameLatencyWaitableObject_ = D3DSwapChain_->GetFrameLatencyWaitableObject();
+                    ASSERT(frameLatencyWaitableObject_);
+                }
             }
 
             void SwapChainImpl::Reset(const SwapChainDescription& description, const std::array<std::shared_ptr<Texture>, MAX_BACK_BUFFER_COUNT>& backBuffers)
@@ -66,32 +84,35 @@ namespace RR
                 DXGI_SWAP_CHAIN_DESC1 currentSwapChainDesc;
                 D3DCall(D3DSwapChain_->GetDesc1(&currentSwapChainDesc));
 
-                const auto& targetSwapChainDesc = D3DUtils::GetDxgiSwapChainDesc1(description, DXGI_SWAP_EFFECT_FLIP_DISCARD);
+                const auto& targetSwapChainDesc = getTargetSwapChainDesc(description);
                 const auto swapChainCompatable = D3DUtils::SwapChainDesc1MatchesForReset(currentSwapChainDesc, targetSwapChainDesc);
 
                 if (!swapChainCompatable)
                     LOG_FATAL("SwapChains incompatible");
 
-                DeviceContext().GetGraphicsCommandQueue()->WaitForGpu();
+                // Back buffers are referenced by frames submitted before the reset, which are on graphics queue only.
+                // Work of other queues isn't waited for.
+                deviceContext_.GetGraphicsCommandQueue()->WaitForGpu();
 
-                // Clear api references
+                // Deferred release would keep references past ResizeBuffers, so they are dropped right away.
                 for (const auto& backBuffer : backBuffers)
                 {
-                    if (!backBuffer)
+                    if (!backBuffer || !backBuffer->GetPrivateImpl())
                         continue;
 
+                    backBuffer->GetPrivateImpl<ResourceImpl>()->ReleaseImmediately();
                     backBuffer->SetPrivateImpl(nullptr);
                 }
 
-                Log::Print::Info("W:%d,H:%d\n", targetSwapChainDesc.Width,
-                                 targetSwapChainDesc.Height);
-
-                HRESULT hr = D3DSwapChain_->ResizeBuffers(
+                D3DCall(D3DSwapChain_->ResizeBuffers(
                     targetSwapChainDesc.BufferCount,
                     targetSwapChainDesc.Width,
                     targetSwapChainDesc.Height,
                     targetSwapChainDesc.Format,
-                    targetSwapChainDesc.Flags);
+                    targetSwapChainDesc.Flags));
+
+                if (frameLatencyWaitableObject_)
+                    D3DCall(D3DSwapChain_->SetMaximumFrameLatency(description.maxFrameLatency));
 
                 // This class does not support exclusive full-screen mode and prevents DXGI from responding to the ALT+ENTER shortcut
                 //   if (voidU::Failure(dxgiFactory->MakeWindowAssociation(m_window, DXGI_MWA_NO_ALT_ENTER)))
@@ -117,17 +138,40 @@ namespace RR
                 D3DCall(D3DSwapChain_->GetBuffer(backBufferIndex, IID_PPV_ARGS(backBuffer_.put())));
                 ASSERT(backBuffer_);
 
-                auto impl = new ResourceImpl();
+                auto impl = new ResourceImpl(deviceContext_);
                 impl->Init(backBuffer_, nullptr, resource->GetName());
                 resource->SetPrivateImpl(impl);
             }
 
+            void SwapChainImpl::WaitForNextFrame(uint32_t timeout)
+            {
+                ASSERT(D3DSwapChain_);
+
+                if (!frameLatencyWaitableObject_)
+                    return;
+
+                WaitForSingleObjectEx(frameLatencyWaitableObject_, timeout, TRUE);
+            }
+
             HRESULT SwapChainImpl::Present(uint32_t interval)
             {
                 ASSERT(D3DSwapChain_);
 
+                // Tearing is allowed only without vsync.
+                const UINT flags = (interval == 0 && isTearingSupported_) ? DXGI_PRESENT_ALLOW_TEARING : 0;
+
                 DXGI_PRESENT_PARAMETERS params = {};
-                return D3DSwapChain_->Present1(interval, 0, &params);
+                return D3DSwapChain_->Present1(interval, flags, &params);
+            }
+
+            DXGI_SWAP_CHAIN_DESC1 SwapChainImpl::getTargetSwapChainDesc(const SwapChainDescription& description) const
+            {
+                auto desc = D3DUtils::GetDxgiSwapChainDesc1(description, DXGI_SWAP_EFFECT_FLIP_DISCARD);
+
+                if (!isTearingSupported_)
+                    desc.Flags &= ~DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+
+                return desc;
             }
         }
     }
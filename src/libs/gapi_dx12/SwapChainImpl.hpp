@@ -9,22 +9,31 @@ namespace RR
     {
         namespace DX12
         {
+            class DeviceContext;
+
             class SwapChainImpl final : public ISwapChain
             {
             public:
-                SwapChainImpl() = default;
+                SwapChainImpl(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
                 ~SwapChainImpl();
 
                 void Init(const ComSharedPtr<ID3D12Device>& device, const ComSharedPtr<IDXGIFactory2>& dxgiFactory, const ComSharedPtr<ID3D12CommandQueue>& commandQueue, const SwapChainDescription& description, const U8String& name);
                 void Reset(const SwapChainDescription& description, const std::array<std::shared_ptr<Texture>, MAX_BACK_BUFFER_COUNT>& backBuffers);
 
                 void InitBackBufferTexture(uint32_t backBufferIndex, const std::shared_ptr<Texture>& resource) override;
+                void WaitForNextFrame(uint32_t timeout) override;
 
                 HRESULT Present(uint32_t interval);
 
                 const ComSharedPtr<IDXGISwapChain3>& GetD3DObject() const { return D3DSwapChain_; }
 
             private:
+                DXGI_SWAP_CHAIN_DESC1 getTargetSwapChainDesc(const SwapChainDescription& description) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isTearingSupported_ = false;
+                HANDLE frameLatencyWaitableObject_ = nullptr;
                 ComSharedPtr<IDXGISwapChain3> D3DSwapChain_;
             };
         }
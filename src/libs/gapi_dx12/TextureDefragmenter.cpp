@@ -0,0 +1,243 @@
+#include "TextureDefragmenter.hpp"
+
+#include "gapi_dx12/CommandQueueImpl.hpp"
+#include "gapi_dx12/DescriptorAllocator.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/ResourceCreator.hpp"
+#include "gapi_dx12/ResourceImpl.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/TexturePools.hpp"
+#include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            TextureDefragmenter::~TextureDefragmenter()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void TextureDefragmenter::Init(uint64_t frameBudget)
+            {
+                ASSERT(!isInited_);
+
+                frameBudget_ = frameBudget;
+
+                const auto& device = deviceContext_.GetDevice();
+
+                copyQueue_ = std::make_unique<CommandQueueImpl>(deviceContext_, CommandQueueType::Copy);
+                copyQueue_->Init("TextureDefragmenter");
+
+                D3DCall(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(commandAllocator_.put())));
+                D3DUtils::SetAPIName(commandAllocator_.get(), "TextureDefragmenter");
+
+                D3DCall(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, commandAllocator_.get(), nullptr, IID_PPV_ARGS(commandList_.put())));
+                D3DUtils::SetAPIName(commandList_.get(), "TextureDefragmenter");
+                D3DCall(commandList_->Close());
+
+                frameFence_ = std::make_unique<FenceImpl>(deviceContext_);
+                frameFence_->Init("TextureDefragmenter frame");
+
+                copyFence_ = std::make_unique<FenceImpl>(deviceContext_);
+                copyFence_->Init("TextureDefragmenter copy");
+
+                isInited_ = true;
+            }
+
+            void TextureDefragmenter::Terminate()
+            {
+                ASSERT(isInited_);
+
+                if (!moves_.empty())
+                {
+                    copyFence_->SyncCPU(std::nullopt);
+                    discardBatch();
+                }
+
+                textures_.clear();
+
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(commandList_);
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(commandAllocator_);
+                copyQueue_ = nullptr;
+                frameFence_ = nullptr;
+                copyFence_ = nullptr;
+
+                isInited_ = false;
+            }
+
+            void TextureDefragmenter::Register(const Texture::SharedPtr& texture)
+            {
+                ASSERT(isInited_);
+                ASSERT(texture);
+
+                if (frameBudget_ == 0)
+                    return;
+
+                Threading::ReadWriteGuard lock(spinlock_);
+                textures_.push_back(texture);
+            }
+
+            void TextureDefragmenter::MoveToNextFrame(CommandQueueImpl& frameJoinQueue)
+            {
+                ASSERT(isInited_);
+
+                if (frameBudget_ == 0)
+                    return;
+
+                frameFence_->Signal(frameJoinQueue);
+
+                if (moves_.empty())
+                    return startBatch();
+
+                if (copyFence_->GetGpuValue() >= copyFence_->GetCpuValue())
+                    finishBatch();
+            }
+
+            void TextureDefragmenter::startBatch()
+            {
+                struct HeapUsage
+                {
+                    GpuResourceAllocationHint hint;
+                    uint64_t usedSize = 0;
+                    std::vector<Texture::SharedPtr> textures;
+                };
+
+                std::unordered_map<ID3D12Heap*, HeapUsage> heaps;
+                std::array<uint32_t, 3> heapsPerHint = {};
+
+                {
+                    Threading::ReadWriteGuard lock(spinlock_);
+
+                    const auto isExpired = [](const std::weak_ptr<Texture>& texture) { return texture.expired(); };
+                    textures_.erase(std::remove_if(textures_.begin(), textures_.end(), isExpired), textures_.end());
+
+                    for (const auto& weakTexture : textures_)
+                    {
+                        auto texture = weakTexture.lock();
+                        if (!texture)
+                            continue;
+
+                        const auto allocation = texture->GetPrivateImpl<ResourceImpl>()->GetAllocation();
+                        ASSERT(allocation);
+
+                        // Committed allocations have no heap to compact.
+                        if (!allocation->GetHeap())
+                            continue;
+
+                        auto& usage = heaps[allocation->GetHeap()];
+                        if (usage.textures.empty())
+                            heapsPerHint[static_cast<uint32_t>(texture->GetAllocationHint()) - 1]++;
+
+                        usage.hint = texture->GetAllocationHint();
+                        usage.usedSize += allocation->GetSize();
+                        usage.textures.push_back(std::move(texture));
+                    }
+                }
+
+                // Sparsest heap of pool with other heaps to move its textures into.
+                ID3D12Heap* sourceHeap = nullptr;
+                float sourceUsage = MaxHeapUsage;
+
+                for (const auto& [heap, usage] : heaps)
+                {
+                    if (heapsPerHint[static_cast<uint32_t>(usage.hint) - 1] < 2)
+                        continue;
+
+                    const float heapUsage = static_cast<float>(usage.usedSize) / static_cast<float>(heap->GetDesc().SizeInBytes);
+                    if (heapUsage < sourceUsage)
+                    {
+                        sourceHeap = heap;
+                        sourceUsage = heapUsage;
+                    }
+                }
+
+                if (!sourceHeap)
+                    return;
+
+                const auto& sourceTextures = heaps[sourceHeap].textures;
+                uint64_t movedSize = 0;
+
+                D3DCall(commandAllocator_->Reset());
+                D3DCall(commandList_->Reset(commandAllocator_.get(), nullptr));
+
+                for (const auto& texture : sourceTextures)
+                {
+                    const auto resourceImpl = texture->GetPrivateImpl<ResourceImpl>();
+                    if (movedSize + resourceImpl->GetAllocation()->GetSize() > frameBudget_)
+                        break;
+
+                    // Render targets keep their fast clear value in the new place.
+                    D3D12_CLEAR_VALUE optimizedClearValue;
+                    const auto pOptimizedClearValue = D3DUtils::GetOptimizedClearValue(texture->GetDescription(), optimizedClearValue) ? &optimizedClearValue : nullptr;
+
+                    Move move = { texture, nullptr, nullptr, resourceImpl->GetWriteCount() };
+                    deviceContext_.GetTexturePools().CreateResource(
+                        texture->GetAllocationHint(), D3DUtils::GetResourceDesc(texture->GetDescription()), D3D12_RESOURCE_STATE_COMMON, pOptimizedClearValue, move.resource, move.allocation);
+
+                    // Pool has no room elsewhere, moving would only churn the same heap.
+                    if (move.allocation->GetHeap() == sourceHeap)
+                    {
+                        deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(move.resource, move.allocation);
+                        break;
+                    }
+
+                    D3DUtils::SetAPIName(move.resource.get(), texture->GetName());
+
+                    // Both resources are in common state, copy queue promotes them implicitly.
+                    commandList_->CopyResource(move.resource.get(), resourceImpl->GetD3DObject().get());
+
+                    movedSize += move.allocation->GetSize();
+                    moves_.push_back(std::move(move));
+                }
+
+                D3DCall(commandList_->Close());
+
+                if (moves_.empty())
+                    return;
+
+                copyQueue_->Wait(frameFence_->GetD3DObject(), frameFence_->GetCpuValue());
+
+                ID3D12CommandList* commandLists[] = { commandList_.get() };
+                copyQueue_->GetD3DObject()->ExecuteCommandLists(1, commandLists);
+
+                copyFence_->Signal(*copyQueue_);
+            }
+
+            void TextureDefragmenter::finishBatch()
+            {
+                auto& descriptorAllocator = deviceContext_.GetDescriptorAllocator();
+
+                for (auto& move : moves_)
+                {
+                    const auto resourceImpl = move.texture->GetPrivateImpl<ResourceImpl>();
+
+                    if (resourceImpl->GetWriteCount() != move.writeCount)
+                    {
+                        deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(move.resource, move.allocation);
+                        continue;
+                    }
+
+                    resourceImpl->Rebind(move.resource, move.allocation);
+                    move.texture->ForEachView([&descriptorAllocator](GpuResourceView& view) { descriptorAllocator.Rewrite(view); });
+                }
+
+                moves_.clear();
+            }
+
+            void TextureDefragmenter::discardBatch()
+            {
+                for (auto& move : moves_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(move.resource, move.allocation);
+
+                moves_.clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "gapi/Texture.hpp"
+
+#include "common/threading/SpinLock.hpp"
+
+namespace D3D12MA
+{
+    class Allocation;
+}
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class CommandQueueImpl;
+            class DeviceContext;
+            class FenceImpl;
+
+            // Compacts streamed and small texture pools of long running sessions. Each frame textures of the sparsest heap
+            // are copied into new pool allocations on own copy queue within byte budget. Once copies are complete,
+            // texture backing is swapped and views are re-created in place, so bindless indices stay valid.
+            // Render targets aren't moved, they are rewritten every frame and would be mostly discarded.
+            class TextureDefragmenter final : private NonCopyable
+            {
+            public:
+                TextureDefragmenter(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~TextureDefragmenter();
+
+                // Zero frame budget disables defragmentation.
+                void Init(uint64_t frameBudget);
+                void Terminate();
+
+                void Register(const Texture::SharedPtr& texture);
+
+                // Frame join queue reaches the frame end once every queue finished the frame.
+                void MoveToNextFrame(CommandQueueImpl& frameJoinQueue);
+
+            private:
+                // Heap filled less than this is compacted.
+                static constexpr float MaxHeapUsage = 0.5f;
+
+                struct Move
+                {
+                    Texture::SharedPtr texture;
+                    ComSharedPtr<ID3D12Resource> resource;
+                    D3D12MA::Allocation* allocation;
+                    // Texture written after copy was recorded keeps its backing.
+                    uint32_t writeCount;
+                };
+
+                void startBatch();
+                void finishBatch();
+                void discardBatch();
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                uint64_t frameBudget_ = 0;
+
+                std::unique_ptr<CommandQueueImpl> copyQueue_;
+                ComSharedPtr<ID3D12CommandAllocator> commandAllocator_;
+                ComSharedPtr<ID3D12GraphicsCommandList> commandList_;
+                // Copy queue waits for frame end on every queue, so sources aren't written while copied.
+                std::unique_ptr<FenceImpl> frameFence_;
+                std::unique_ptr<FenceImpl> copyFence_;
+
+                std::vector<std::weak_ptr<Texture>> textures_;
+                std::vector<Move> moves_;
+                Threading::SpinLock spinlock_;
+            };
+        }
+    }
+}
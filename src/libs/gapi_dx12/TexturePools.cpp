@@ -0,0 +1,112 @@
+#include "TexturePools.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                uint32_t getPoolIndex(GpuResourceAllocationHint hint)
+                {
+                    ASSERT(hint != GpuResourceAllocationHint::Default);
+                    return static_cast<uint32_t>(hint) - 1;
+                }
+            }
+
+            TexturePools::~TexturePools()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void TexturePools::Init()
+            {
+                ASSERT(!isInited_);
+
+                const auto createPool = [](D3D12_HEAP_FLAGS heapFlags, uint64_t blockSize) {
+                    D3D12MA::POOL_DESC desc = {};
+                    desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+                    // Resource heap tier 1 doesn't allow to mix render targets with other textures.
+                    desc.HeapFlags = heapFlags;
+                    desc.BlockSize = blockSize;
+
+                    D3D12MA::Pool* pool = nullptr;
+                    D3DCall(deviceContext_.GetAllocator()->CreatePool(&desc, &pool));
+
+                    return pool;
+                };
+
+                static_assert(static_cast<uint32_t>(GpuResourceAllocationHint::Small) == PoolsCount);
+                pools_[getPoolIndex(GpuResourceAllocationHint::RenderTarget)] = createPool(D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES, RenderTargetBlockSize);
+                pools_[getPoolIndex(GpuResourceAllocationHint::Streamed)] = createPool(D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, StreamedBlockSize);
+                pools_[getPoolIndex(GpuResourceAllocationHint::Small)] = createPool(D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, SmallBlockSize);
+
+                isInited_ = true;
+            }
+
+            void TexturePools::Terminate()
+            {
+                ASSERT(isInited_);
+
+                for (auto& pool : pools_)
+                {
+                    pool->Release();
+                    pool = nullptr;
+                }
+
+                isInited_ = false;
+            }
+
+            void TexturePools::CreateResource(
+                GpuResourceAllocationHint hint,
+                D3D12_RESOURCE_DESC desc,
+                D3D12_RESOURCE_STATES initialState,
+                const D3D12_CLEAR_VALUE* optimizedClearValue,
+                ComSharedPtr<ID3D12Resource>& resource,
+                D3D12MA::Allocation*& allocation) const
+            {
+                ASSERT(isInited_);
+                ASSERT(desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER);
+
+                const bool isRenderTarget = (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+                ASSERT_MSG(isRenderTarget == (hint == GpuResourceAllocationHint::RenderTarget), "Allocation hint doesn't match texture bind flags");
+
+                if (hint == GpuResourceAllocationHint::Small)
+                    trySmallAlignment(desc);
+
+                D3D12MA::ALLOCATION_DESC allocationDesc = {};
+                allocationDesc.CustomPool = pools_[getPoolIndex(hint)];
+
+                D3DCall(deviceContext_.GetAllocator()->CreateResource(
+                    &allocationDesc,
+                    &desc,
+                    initialState,
+                    optimizedClearValue,
+                    &allocation,
+                    IID_PPV_ARGS(resource.put())));
+            }
+
+            void TexturePools::trySmallAlignment(D3D12_RESOURCE_DESC& desc) const
+            {
+                // MSAA textures have 64KB small alignment, which is the default for others anyway.
+                if (desc.SampleDesc.Count > 1)
+                    return;
+
+                const auto& device = deviceContext_.GetDevice();
+
+                // Size with default alignment is checked first, so the runtime isn't asked for alignment it surely rejects.
+                desc.Alignment = 0;
+                if (device->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+                    return;
+
+                desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+                if (device->GetResourceAllocationInfo(0, 1, &desc).Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+                    desc.Alignment = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+#include <array>
+
+namespace D3D12MA
+{
+    class Allocation;
+    class Pool;
+}
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // D3D12MA pool per resource class picked by allocation hint. Render targets, streamed and small textures
+            // live in separate heaps, so short lived streaming allocations don't fragment long lived ones.
+            class TexturePools final : private NonCopyable
+            {
+            public:
+                TexturePools(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~TexturePools();
+
+                void Init();
+                // Pools could be released only after all their allocations are.
+                void Terminate();
+
+                void CreateResource(GpuResourceAllocationHint hint,
+                                    D3D12_RESOURCE_DESC desc,
+                                    D3D12_RESOURCE_STATES initialState,
+                                    const D3D12_CLEAR_VALUE* optimizedClearValue,
+                                    ComSharedPtr<ID3D12Resource>& resource,
+                                    D3D12MA::Allocation*& allocation) const;
+
+            private:
+                static constexpr uint64_t RenderTargetBlockSize = 64 * 1024 * 1024;
+                static constexpr uint64_t StreamedBlockSize = 64 * 1024 * 1024;
+                static constexpr uint64_t SmallBlockSize = 4 * 1024 * 1024;
+                static constexpr uint32_t PoolsCount = 3;
+
+                // 4KB alignment is granted only to textures which fit into 64KB with it.
+                void trySmallAlignment(D3D12_RESOURCE_DESC& desc) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                // Indexed by allocation hint, Default isn't pooled.
+                std::array<D3D12MA::Pool*, PoolsCount> pools_ = {};
+            };
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#include "TilePool.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/FenceImpl.hpp"
+#include "gapi_dx12/ResourceCreator.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            TilePool::~TilePool()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void TilePool::Init()
+            {
+                ASSERT(!isInited_);
+
+                fence_ = std::make_unique<FenceImpl>(deviceContext_);
+                fence_->Init("TilePool");
+
+                isInited_ = true;
+            }
+
+            void TilePool::Terminate()
+            {
+                ASSERT(isInited_);
+
+                for (auto& heap : heaps_)
+                    deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(heap.heap);
+
+                heaps_.clear();
+                retiredTiles_.clear();
+                fence_ = nullptr;
+
+                isInited_ = false;
+            }
+
+            void TilePool::Allocate(uint32_t count, std::vector<Tile>& tiles)
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                reclaimRetiredTiles();
+
+                tiles.reserve(tiles.size() + count);
+
+                for (uint32_t heapIndex = 0; count > 0; heapIndex++)
+                {
+                    if (heapIndex == heaps_.size())
+                        heaps_.push_back(createHeap(heapIndex));
+
+                    auto& freeTiles = heaps_[heapIndex].freeTiles;
+
+                    for (; count > 0 && !freeTiles.empty(); count--)
+                    {
+                        tiles.push_back({ heapIndex, freeTiles.back() });
+                        freeTiles.pop_back();
+                    }
+                }
+            }
+
+            void TilePool::Release(const std::vector<Tile>& tiles)
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                // Unmapping is issued before the frame end, so tiles are free once GPU passed current fence value.
+                const auto fenceValue = fence_->GetCpuValue();
+
+                for (const auto& tile : tiles)
+                    retiredTiles_.push_back({ tile, fenceValue });
+            }
+
+            ID3D12Heap* TilePool::GetHeap(uint32_t heapIndex) const
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                ASSERT(heapIndex < heaps_.size());
+                return heaps_[heapIndex].heap.get();
+            }
+
+            void TilePool::MoveToNextFrame(CommandQueueImpl& queue)
+            {
+                ASSERT(isInited_);
+                fence_->Signal(queue);
+            }
+
+            void TilePool::reclaimRetiredTiles()
+            {
+                const auto gpuFenceValue = fence_->GetGpuValue();
+
+                while (!retiredTiles_.empty() && retiredTiles_.front().fenceValue < gpuFenceValue)
+                {
+                    const auto& tile = retiredTiles_.front().tile;
+                    auto& freeTiles = heaps_[tile.heapIndex].freeTiles;
+
+                    freeTiles.insert(std::upper_bound(freeTiles.begin(), freeTiles.end(), tile.offset, std::greater<uint32_t>()), tile.offset);
+                    retiredTiles_.pop_front();
+                }
+            }
+
+            TilePool::Heap TilePool::createHeap(uint32_t heapIndex) const
+            {
+                D3D12_HEAP_DESC desc = {};
+                desc.SizeInBytes = static_cast<uint64_t>(TilesPerHeap) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+                desc.Properties = DefaultHeapProps;
+                desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+                // Resource heap tier 1 requires tiles of non render target textures to live in dedicated heaps.
+                desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+                Heap heap;
+                D3DCall(deviceContext_.GetDevice()->CreateHeap(&desc, IID_PPV_ARGS(heap.heap.put())));
+
+                D3DUtils::SetAPIName(heap.heap.get(), "Tile pool heap %u", heapIndex);
+
+                heap.freeTiles.resize(TilesPerHeap);
+                for (uint32_t index = 0; index < TilesPerHeap; index++)
+                    heap.freeTiles[index] = TilesPerHeap - 1 - index;
+
+                return heap;
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common/threading/SpinLock.hpp"
+
+#include <deque>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class CommandQueueImpl;
+            class DeviceContext;
+            class FenceImpl;
+
+            // Default heap memory for reserved resources handed out in 64KB tiles.
+            // Released tiles are reused once GPU completed the frame they were released at.
+            class TilePool final : private NonCopyable
+            {
+            public:
+                struct Tile
+                {
+                    uint32_t heapIndex;
+                    // In tiles from the heap begin.
+                    uint32_t offset;
+                };
+
+                TilePool(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~TilePool();
+
+                void Init();
+                void Terminate();
+
+                // Tiles of the same heap are handed out in ascending order, so mapped runs are mostly contiguous.
+                void Allocate(uint32_t count, std::vector<Tile>& tiles);
+                void Release(const std::vector<Tile>& tiles);
+
+                ID3D12Heap* GetHeap(uint32_t heapIndex) const;
+
+                void MoveToNextFrame(CommandQueueImpl& queue);
+
+            private:
+                static constexpr uint32_t TilesPerHeap = 256;
+
+                struct Heap
+                {
+                    ComSharedPtr<ID3D12Heap> heap;
+                    // Sorted descending, the lowest offset is taken first.
+                    std::vector<uint32_t> freeTiles;
+                };
+
+                struct RetiredTile
+                {
+                    Tile tile;
+                    uint64_t fenceValue;
+                };
+
+                void reclaimRetiredTiles();
+                Heap createHeap(uint32_t heapIndex) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                std::unique_ptr<FenceImpl> fence_;
+                std::vector<Heap> heaps_;
+                std::deque<RetiredTile> retiredTiles_;
+                mutable Threading::SpinLock spinlock_;
+            };
+        }
+    }
+}
@@ -0,0 +1,249 @@
+#include "TimestampQueryPool.hpp"
+
+#include "gapi_dx12/CommandQueueImpl.hpp"
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceImpl.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+#include "gapi_dx12/third_party/d3d12_memory_allocator/D3D12MemAlloc.h"
+
+#include "common/threading/Mutex.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            TimestampQueryPool::~TimestampQueryPool()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void TimestampQueryPool::Init(const CommandQueueImpl& commandQueue)
+            {
+                ASSERT(!isInited_);
+
+                D3DCall(commandQueue.GetD3DObject()->GetTimestampFrequency(&timestampFrequency_));
+                ASSERT(timestampFrequency_ > 0);
+                calibrationQueue_ = commandQueue.GetD3DObject();
+
+                framesCount_ = deviceContext_.GetGpuFramesBuffered();
+                const auto queriesCount = MaxQueriesPerFrame * framesCount_;
+
+                D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+                queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+                queryHeapDesc.Count = queriesCount;
+
+                D3DCall(deviceContext_.GetDevice()->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(queryHeap_.put())));
+                D3DUtils::SetAPIName(queryHeap_.get(), "TimestampQueryHeap");
+
+                const auto& resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(queriesCount * sizeof(uint64_t));
+
+                D3D12MA::ALLOCATION_DESC allocationDesc = {};
+                allocationDesc.HeapType = D3D12_HEAP_TYPE_READBACK;
+
+                ComSharedPtr<ID3D12Resource> d3dresource;
+                D3D12MA::Allocation* allocation;
+                D3DCall(deviceContext_.GetAllocator()->CreateResource(
+                    &allocationDesc,
+                    &resourceDesc,
+                    D3D12_RESOURCE_STATE_COPY_DEST,
+                    NULL,
+                    &allocation,
+                    IID_PPV_ARGS(d3dresource.put())));
+
+                readbackResource_ = std::make_shared<ResourceImpl>(deviceContext_);
+                readbackResource_->Init(d3dresource, allocation, "TimestampReadback");
+
+                // Zero generation is left for invalid markers.
+                frames_[currentFrame_].generation = ++generation_;
+
+                isInited_ = true;
+            }
+
+            void TimestampQueryPool::Terminate()
+            {
+                ASSERT(isInited_);
+
+                for (auto& frame : frames_)
+                {
+                    frame.markers.clear();
+                    frame.allocatedQueries = 0;
+                }
+
+                frameTimings_ = {};
+                calibrationQueue_ = nullptr;
+                readbackResource_ = nullptr;
+                deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(queryHeap_);
+
+                isInited_ = false;
+            }
+
+            ID3D12Resource* TimestampQueryPool::GetReadbackResource() const
+            {
+                ASSERT(readbackResource_);
+                return readbackResource_->GetD3DObject().get();
+            }
+
+            uint32_t TimestampQueryPool::allocateQuery()
+            {
+                auto& frame = frames_[currentFrame_];
+
+                const auto query = frame.allocatedQueries++;
+                if (query >= MaxQueriesPerFrame)
+                {
+                    frame.allocatedQueries = MaxQueriesPerFrame;
+                    return InvalidIndex;
+                }
+
+                return currentFrame_ * MaxQueriesPerFrame + query;
+            }
+
+            TimestampQueryPool::Marker TimestampQueryPool::BeginMarker(const U8String& name, const Marker& parent, uint32_t depth)
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                auto& frame = frames_[currentFrame_];
+
+                const auto query = allocateQuery();
+                if (query == InvalidIndex)
+                    return {};
+
+                // Index of parent begun in another frame points to unrelated marker of this one.
+                const auto parentIndex = parent.generation == frame.generation ? parent.index : InvalidIndex;
+
+                frame.markers.push_back({ name, parentIndex, depth, query, InvalidIndex });
+
+                return { static_cast<uint32_t>(frame.markers.size() - 1), query, frame.generation };
+            }
+
+            uint32_t TimestampQueryPool::EndMarker(const Marker& marker)
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                auto& frame = frames_[currentFrame_];
+
+                // Marker begun in another frame, its slot could be reused by a marker of this one.
+                if (marker.generation != frame.generation)
+                    return InvalidIndex;
+
+                ASSERT(marker.index < frame.markers.size());
+
+                const auto query = allocateQuery();
+                frame.markers[marker.index].endQuery = query;
+
+                return query;
+            }
+
+            GpuClockCalibration TimestampQueryPool::GetClockCalibration() const
+            {
+                ASSERT(isInited_);
+
+                uint64_t gpuCalibration;
+                uint64_t cpuCalibration;
+                if (FAILED(calibrationQueue_->GetClockCalibration(&gpuCalibration, &cpuCalibration)))
+                    return {};
+
+                LARGE_INTEGER qpcFrequency;
+                QueryPerformanceFrequency(&qpcFrequency);
+                const auto frequency = static_cast<uint64_t>(qpcFrequency.QuadPart);
+
+                GpuClockCalibration calibration;
+                calibration.gpuTimestamp = gpuCalibration;
+                calibration.gpuFrequency = timestampFrequency_;
+                // Steady clock counts QPC ticks, convert them the same way to stay on its timeline.
+                calibration.cpuNs = cpuCalibration / frequency * 1000000000 + cpuCalibration % frequency * 1000000000 / frequency;
+
+                return calibration;
+            }
+
+            uint64_t TimestampQueryPool::toCpuTime(uint64_t timestamp) const
+            {
+                const auto calibration = GetClockCalibration();
+                if (calibration.gpuFrequency == 0)
+                    return 0;
+
+                const double offsetNs = static_cast<double>(static_cast<int64_t>(timestamp - calibration.gpuTimestamp)) * 1e9 / static_cast<double>(calibration.gpuFrequency);
+
+                return static_cast<uint64_t>(static_cast<int64_t>(calibration.cpuNs) + static_cast<int64_t>(offsetNs));
+            }
+
+            void TimestampQueryPool::readbackFrame(FrameData& frame)
+            {
+                const auto queriesCount = std::min(frame.allocatedQueries.load(), MaxQueriesPerFrame);
+                const auto frameOffset = currentFrame_ * MaxQueriesPerFrame * sizeof(uint64_t);
+
+                void* mappedData;
+                readbackResource_->Map(0, { frameOffset, frameOffset + queriesCount * sizeof(uint64_t) }, mappedData);
+                const auto timestamps = reinterpret_cast<const uint64_t*>(static_cast<const uint8_t*>(mappedData) + frameOffset);
+
+                const auto toLocalQuery = [this](uint32_t query) { return query - currentFrame_ * MaxQueriesPerFrame; };
+
+                uint64_t frameStart = std::numeric_limits<uint64_t>::max();
+                for (const auto& marker : frame.markers)
+                    frameStart = std::min(frameStart, timestamps[toLocalQuery(marker.beginQuery)]);
+
+                const double ticksToMs = 1000.0 / static_cast<double>(timestampFrequency_);
+
+                frameTimings_.frameIndex = frame.frameIndex;
+                frameTimings_.cpuStartNs = toCpuTime(frameStart);
+                frameTimings_.markers.clear();
+                frameTimings_.markers.reserve(frame.markers.size());
+
+                for (const auto& marker : frame.markers)
+                {
+                    GpuTimingMarker timing;
+                    timing.name = marker.name;
+                    timing.parent = marker.parent;
+                    timing.depth = marker.depth;
+
+                    const auto begin = timestamps[toLocalQuery(marker.beginQuery)];
+                    timing.startMs = (begin - frameStart) * ticksToMs;
+
+                    // Unclosed or out of queries marker reported with zero duration.
+                    if (marker.endQuery != InvalidIndex)
+                    {
+                        const auto end = timestamps[toLocalQuery(marker.endQuery)];
+                        timing.durationMs = (std::max(end, begin) - begin) * ticksToMs;
+                    }
+
+                    frameTimings_.markers.push_back(std::move(timing));
+                }
+
+                readbackResource_->Unmap(0, { 0, 0 });
+            }
+
+            void TimestampQueryPool::MoveToNextFrame(uint64_t frameIndex)
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                // Next frame range was used framesCount_ frames ago and completed on GPU.
+                currentFrame_ = (currentFrame_ + 1) % framesCount_;
+                auto& frame = frames_[currentFrame_];
+
+                if (!frame.markers.empty())
+                    readbackFrame(frame);
+
+                frame.markers.clear();
+                frame.allocatedQueries = 0;
+                frame.frameIndex = frameIndex;
+                frame.generation = ++generation_;
+            }
+
+            GpuFrameTimings TimestampQueryPool::GetFrameTimings() const
+            {
+                Threading::ReadWriteGuard lock(spinlock_);
+                return frameTimings_;
+            }
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "gapi/GpuTimings.hpp"
+
+#include "common/threading/SpinLock.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class CommandQueueImpl;
+            class DeviceContext;
+            class ResourceImpl;
+
+            // Timestamp query heap split into per frame ranges. Frame range resolved into readback buffer
+            // by command lists and read on CPU once GPU completed the frame.
+            class TimestampQueryPool final : private NonCopyable
+            {
+            public:
+                static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+                // Handle is valid only within the frame it was begun in, frame ranges are reused once GPU completed them.
+                struct Marker
+                {
+                    uint32_t index = InvalidIndex;
+                    uint32_t query = InvalidIndex;
+                    uint64_t generation = 0;
+                };
+
+                TimestampQueryPool(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~TimestampQueryPool();
+
+                void Init(const CommandQueueImpl& commandQueue);
+                void Terminate();
+
+                // Returns invalid marker if frame is out of queries. Parent of another frame is dropped.
+                Marker BeginMarker(const U8String& name, const Marker& parent, uint32_t depth);
+                // Returns end query, invalid if marker was begun in another frame.
+                uint32_t EndMarker(const Marker& marker);
+
+                void MoveToNextFrame(uint64_t frameIndex);
+
+                GpuFrameTimings GetFrameTimings() const;
+                GpuClockCalibration GetClockCalibration() const;
+
+                const ComSharedPtr<ID3D12QueryHeap>& GetD3DObject() const { return queryHeap_; }
+                ID3D12Resource* GetReadbackResource() const;
+
+            private:
+                static constexpr uint32_t MaxQueriesPerFrame = 1024;
+
+                struct MarkerRecord
+                {
+                    U8String name;
+                    uint32_t parent;
+                    uint32_t depth;
+                    uint32_t beginQuery;
+                    uint32_t endQuery;
+                };
+
+                struct FrameData
+                {
+                    uint64_t frameIndex = 0;
+                    // Unique per use of the range, unlike frame index it's never repeated by reinit.
+                    uint64_t generation = 0;
+                    std::atomic<uint32_t> allocatedQueries = 0;
+                    std::vector<MarkerRecord> markers;
+                };
+
+                uint32_t allocateQuery();
+                void readbackFrame(FrameData& frame);
+                // Converts GPU timestamp to CPU steady clock nanoseconds, zero if calibration failed.
+                uint64_t toCpuTime(uint64_t timestamp) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                uint64_t timestampFrequency_ = 0;
+                uint32_t currentFrame_ = 0;
+                uint32_t framesCount_ = 0;
+                uint64_t generation_ = 0;
+                std::array<FrameData, MAX_GPU_FRAMES_BUFFERED> frames_;
+                GpuFrameTimings frameTimings_;
+
+                ComSharedPtr<ID3D12CommandQueue> calibrationQueue_;
+                ComSharedPtr<ID3D12QueryHeap> queryHeap_;
+                std::shared_ptr<ResourceImpl> readbackResource_;
+
+                // Guards markers of current frame and frame timings.
+                mutable Threading::SpinLock spinlock_;
+            };
+        }
+    }
+}
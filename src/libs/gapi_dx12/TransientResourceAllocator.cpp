@@ -0,0 +1,167 @@
+#include "TransientResourceAllocator.hpp"
+
+#include "gapi_dx12/DeviceContext.hpp"
+#include "gapi_dx12/ResourceCreator.hpp"
+#include "gapi_dx12/ResourceReleaseContext.hpp"
+
+#include "common/Math.hpp"
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            namespace
+            {
+                inline bool isLifetimeOverlapped(uint32_t firstUse, uint32_t lastUse, uint32_t otherFirstUse, uint32_t otherLastUse)
+                {
+                    return firstUse <= otherLastUse && otherFirstUse <= lastUse;
+                }
+
+                inline bool isMemoryOverlapped(uint64_t offset, uint64_t size, uint64_t otherOffset, uint64_t otherSize)
+                {
+                    return offset < otherOffset + otherSize && otherOffset < offset + size;
+                }
+            }
+
+            TransientResourceAllocator::~TransientResourceAllocator()
+            {
+                ASSERT(!isInited_);
+            }
+
+            void TransientResourceAllocator::Init()
+            {
+                ASSERT(!isInited_);
+
+                framesCount_ = deviceContext_.GetGpuFramesBuffered();
+                isInited_ = true;
+            }
+
+            void TransientResourceAllocator::Terminate()
+            {
+                ASSERT(isInited_);
+
+                for (auto& frame : frames_)
+                {
+                    for (auto& heap : frame.renderTargetHeaps)
+                        deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(heap.heap);
+
+                    for (auto& heap : frame.textureHeaps)
+                        deviceContext_.GetResourceReleaseContext().DeferredD3DResourceRelease(heap.heap);
+
+                    frame.renderTargetHeaps.clear();
+                    frame.textureHeaps.clear();
+                }
+
+                isInited_ = false;
+            }
+
+            TransientResourceAllocator::Placement TransientResourceAllocator::Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo, bool isRenderTarget, uint32_t firstUse, uint32_t lastUse)
+            {
+                ASSERT(isInited_);
+                ASSERT(firstUse <= lastUse);
+                ASSERT(allocationInfo.SizeInBytes > 0);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                auto& frame = frames_[currentFrame_];
+                auto& heaps = isRenderTarget ? frame.renderTargetHeaps : frame.textureHeaps;
+
+                uint64_t offset;
+                for (auto& heap : heaps)
+                {
+                    if (tryPlace(heap, allocationInfo, firstUse, lastUse, offset))
+                        return { heap.heap.get(), offset, generation_.load(std::memory_order_relaxed) };
+                }
+
+                const auto heapSize = std::max(HeapSize, AlignTo(allocationInfo.SizeInBytes, D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT));
+                heaps.push_back(createHeap(heapSize, isRenderTarget));
+
+                auto& heap = heaps.back();
+                if (!tryPlace(heap, allocationInfo, firstUse, lastUse, offset))
+                    LOG_FATAL("Can't place transient resource into empty heap");
+
+                return { heap.heap.get(), offset, generation_.load(std::memory_order_relaxed) };
+            }
+
+            void TransientResourceAllocator::MoveToNextFrame()
+            {
+                ASSERT(isInited_);
+
+                Threading::ReadWriteGuard lock(spinlock_);
+
+                // Next frame heaps were used framesCount_ frames ago and completed on GPU.
+                currentFrame_ = (currentFrame_ + 1) % framesCount_;
+                generation_.fetch_add(1, std::memory_order_relaxed);
+                auto& frame = frames_[currentFrame_];
+
+                for (auto& heap : frame.renderTargetHeaps)
+                    heap.ranges.clear();
+
+                for (auto& heap : frame.textureHeaps)
+                    heap.ranges.clear();
+            }
+
+            bool TransientResourceAllocator::tryPlace(Heap& heap, const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo, uint32_t firstUse, uint32_t lastUse, uint64_t& offset) const
+            {
+                const auto size = allocationInfo.SizeInBytes;
+                const auto alignment = static_cast<size_t>(allocationInfo.Alignment);
+
+                const auto isFree = [&](uint64_t candidate) {
+                    if (candidate + size > heap.size)
+                        return false;
+
+                    for (const auto& range : heap.ranges)
+                    {
+                        if (isLifetimeOverlapped(firstUse, lastUse, range.firstUse, range.lastUse) &&
+                            isMemoryOverlapped(candidate, size, range.offset, range.size))
+                            return false;
+                    }
+
+                    return true;
+                };
+
+                // First fit: candidates are heap begin and ends of ranges alive at the same time.
+                bool found = isFree(0);
+                offset = 0;
+
+                for (const auto& range : heap.ranges)
+                {
+                    if (!isLifetimeOverlapped(firstUse, lastUse, range.firstUse, range.lastUse))
+                        continue;
+
+                    const auto candidate = AlignTo(range.offset + range.size, alignment);
+                    if ((!found || candidate < offset) && isFree(candidate))
+                    {
+                        offset = candidate;
+                        found = true;
+                    }
+                }
+
+                if (!found)
+                    return false;
+
+                heap.ranges.push_back({ offset, size, firstUse, lastUse });
+                return true;
+            }
+
+            TransientResourceAllocator::Heap TransientResourceAllocator::createHeap(uint64_t size, bool isRenderTarget) const
+            {
+                D3D12_HEAP_DESC desc = {};
+                desc.SizeInBytes = size;
+                desc.Properties = DefaultHeapProps;
+                desc.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+                desc.Flags = isRenderTarget ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+                Heap heap;
+                heap.size = size;
+                D3DCall(deviceContext_.GetDevice()->CreateHeap(&desc, IID_PPV_ARGS(heap.heap.put())));
+
+                D3DUtils::SetAPIName(heap.heap.get(), "Transient %s heap", isRenderTarget ? "RT/DS" : "texture");
+
+                return heap;
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/threading/SpinLock.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace RR
+{
+    namespace GAPI
+    {
+        namespace DX12
+        {
+            class DeviceContext;
+
+            // Places frame-local resources into shared heaps. Resources with non-overlapping lifetimes
+            // (in pass indices of the frame) share memory. Frame heaps are reused once GPU completed the frame.
+            class TransientResourceAllocator final : private NonCopyable
+            {
+            public:
+                struct Placement
+                {
+                    ID3D12Heap* heap;
+                    uint64_t offset;
+                    // Frame the placement belongs to.
+                    uint64_t generation;
+                };
+
+                TransientResourceAllocator(DeviceContext& deviceContext) : deviceContext_(deviceContext) { }
+                ~TransientResourceAllocator();
+
+                void Init();
+                void Terminate();
+
+                Placement Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo, bool isRenderTarget, uint32_t firstUse, uint32_t lastUse);
+
+                void MoveToNextFrame();
+
+                // Any thread. Heaps of the frame were recycled, so memory of its placements is reused.
+                bool IsExpired(uint64_t generation) const { return generation_.load(std::memory_order_relaxed) >= generation + framesCount_; }
+
+            private:
+                static constexpr uint64_t HeapSize = 256 * 1024 * 1024;
+
+                struct Range
+                {
+                    uint64_t offset;
+                    uint64_t size;
+                    uint32_t firstUse;
+                    uint32_t lastUse;
+                };
+
+                struct Heap
+                {
+                    ComSharedPtr<ID3D12Heap> heap;
+                    uint64_t size;
+                    std::vector<Range> ranges;
+                };
+
+                struct FrameData
+                {
+                    // Resource heap tier 1 doesn't allow to mix render targets with other textures.
+                    std::vector<Heap> renderTargetHeaps;
+                    std::vector<Heap> textureHeaps;
+                };
+
+                bool tryPlace(Heap& heap, const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo, uint32_t firstUse, uint32_t lastUse, uint64_t& offset) const;
+                Heap createHeap(uint64_t size, bool isRenderTarget) const;
+
+            private:
+                DeviceContext& deviceContext_;
+                bool isInited_ = false;
+                uint32_t currentFrame_ = 0;
+                uint32_t framesCount_ = 0;
+                // Incremented by every frame, heaps of a frame are recycled framesCount_ frames later.
+                std::atomic<uint64_t> generation_ = 0;
+                std::array<FrameData, MAX_GPU_FRAMES_BUFFERED> frames_;
+                Threading::SpinLock spinlock_;
+            };
+        }
+    }
+}
@@ -10,6 +10,17 @@
 #include <dxgi1_4.h>
 #include <dxgidebug.h>
 
+// Enhanced barriers need headers of Windows SDK 10.0.22621 or newer.
+#ifdef __ID3D12GraphicsCommandList7_INTERFACE_DEFINED__
+#define ENABLE_ENHANCED_BARRIERS
+#endif
+
+// GPU upload heap type and OPTIONS16 feature data shipped in D3D12 SDK 613 (Agility SDK 1.613).
+// Driver support is checked on device creation, see DeviceContext::IsGpuUploadHeapSupported.
+#if defined(D3D12_SDK_VERSION) && D3D12_SDK_VERSION >= 613
+#define ENABLE_GPU_UPLOAD_HEAP
+#endif
+
 #include "gapi/Limits.hpp"
 #include "gapi_dx12/ComSharedPtr.hpp"
 #include "gapi_dx12/D3DUtils/D3DUtils.hpp"
\ No newline at end of file
@@ -1,17 +1,65 @@
 #include "Input.hpp"
 
+#include "inputting/RawInput.hpp"
+
 #include "common/Math.hpp"
+#include "common/debug/Profiler.hpp"
 
 #include "windowing/Window.hpp"
 
+#include <GLFW/glfw3.h>
+
+#include <tuple>
+
 namespace RR
 {
     using namespace Common;
 
     namespace Inputting
     {
+        namespace
+        {
+            InputKey toInputKey(int32_t key)
+            {
+                if (key >= GLFW_KEY_A && key <= GLFW_KEY_Z)
+                    return static_cast<InputKey>(ikA + (key - GLFW_KEY_A));
+
+                if (key >= GLFW_KEY_0 && key <= GLFW_KEY_9)
+                    return static_cast<InputKey>(ik0 + (key - GLFW_KEY_0));
+
+                switch (key)
+                {
+                    case GLFW_KEY_LEFT: return ikLeft;
+                    case GLFW_KEY_RIGHT: return ikRight;
+                    case GLFW_KEY_UP: return ikUp;
+                    case GLFW_KEY_DOWN: return ikDown;
+                    case GLFW_KEY_SPACE: return ikSpace;
+                    case GLFW_KEY_TAB: return ikTab;
+                    case GLFW_KEY_ENTER: return ikEnter;
+                    case GLFW_KEY_ESCAPE: return ikEscape;
+                    case GLFW_KEY_LEFT_SHIFT: return ikShift;
+                    case GLFW_KEY_LEFT_CONTROL: return ikCtrl;
+                    case GLFW_KEY_LEFT_ALT: return ikAlt;
+                    default: return ikNone;
+                }
+            }
+
+            InputKey toInputButton(int32_t button)
+            {
+                switch (button)
+                {
+                    case GLFW_MOUSE_BUTTON_LEFT: return ikMouseL;
+                    case GLFW_MOUSE_BUTTON_RIGHT: return ikMouseR;
+                    case GLFW_MOUSE_BUTTON_MIDDLE: return ikMouseM;
+                    default: return ikNone;
+                }
+            }
+        }
+
         std::unique_ptr<Input> Inputting::Input::_instance = std::unique_ptr<Input>(new Input());
 
+        Input::Input() = default;
+
         Input::~Input()
         {
             Terminate();
@@ -21,34 +69,121 @@ namespace RR
         {
             memset(_down, 0, sizeof(_down));
             memset(&Mouse, 0, sizeof(Mouse));
+            _mouseVelocity = Vector2(0.0f, 0.0f);
         }
 
-        void Input::Init()
+        void Input::Init(bool useRawInput)
         {
             Reset();
+            _sampleTimestampNs = Debug::Profiler::Now();
+
+            if (!useRawInput)
+                return;
+
+            _rawInput = std::make_unique<RawInputThread>();
+            if (!_rawInput->Start(RawInputThread::EventCallback::From<&Input::onRawInput>(this)))
+            {
+                Log::Format::Warning("Raw input is unavailable, falling back to window events\n");
+                _rawInput = nullptr;
+            }
         }
 
         void Input::Terminate()
         {
-            if (_inputtingWindow.get() != nullptr)
+            if (_rawInput)
+            {
+                _rawInput->Stop();
+                _rawInput = nullptr;
+            }
+
+            if (_window.get() != nullptr)
             {
-                _inputtingWindow->UnSubscribeOnKeyboardEvents(this);
-                _inputtingWindow->UnSubscribeOnMouseEvents(this);
+                _window->OnKey.Unsubscribe(_keyHandle);
+                _window->OnMouseButton.Unsubscribe(_mouseButtonHandle);
+                _window->OnMouseMove.Unsubscribe(_mouseMoveHandle);
+                _window->OnFocusGained.Unsubscribe(_focusGainedHandle);
+                _window->OnFocusLost.Unsubscribe(_focusLostHandle);
 
-                _inputtingWindow = nullptr;
+                _window = nullptr;
             }
         }
 
-        void Input::SubscribeToWindow(const std::shared_ptr<WindowSystem::InputtingWindow>& inputtingWindow_)
+        void Input::SubscribeToWindow(const std::shared_ptr<Windowing::Window>& window)
         {
-            _inputtingWindow = inputtingWindow_;
-            _inputtingWindow->SubscribeOnKeyboardEvents(this);
-            _inputtingWindow->SubscribeOnMouseEvents(this);
+            ASSERT(window);
+            ASSERT(!_window);
+
+            _window = window;
+            _focused = true;
+            _keyHandle = _window->OnKey.Subscribe(Delegate<void(int32_t, bool)>::From<&Input::onKey>(this));
+            _mouseButtonHandle = _window->OnMouseButton.Subscribe(Delegate<void(int32_t, bool)>::From<&Input::onMouseButton>(this));
+            _mouseMoveHandle = _window->OnMouseMove.Subscribe(Delegate<void(const Vector2i&)>::From<&Input::onMouseMove>(this));
+            _focusGainedHandle = _window->OnFocusGained.Subscribe(Delegate<void()>::From<&Input::onFocusGained>(this));
+            _focusLostHandle = _window->OnFocusLost.Subscribe(Delegate<void()>::From<&Input::onFocusLost>(this));
         }
 
-        void Input::Update()
+        void Input::Sample()
         {
+            const auto sampleTimestampNs = Debug::Profiler::Now();
             Mouse.relative = Vector2i(0, 0);
+
+            // Both streams are ordered by time, merged to apply events in order they happened.
+            auto windowEvent = _events.TryGetNext();
+            const InputEvent* rawEvent = _rawEvents.Front();
+
+            while (windowEvent || rawEvent)
+            {
+                if (rawEvent && (!windowEvent || rawEvent->timestampNs <= windowEvent->timestampNs))
+                {
+                    apply(*rawEvent);
+                    _rawEvents.Pop();
+                    rawEvent = _rawEvents.Front();
+                }
+                else
+                {
+                    apply(*windowEvent);
+                    windowEvent = _events.TryGetNext();
+                }
+            }
+
+            const auto elapsedSeconds = static_cast<float>(sampleTimestampNs - _sampleTimestampNs) * 1e-9f;
+            _mouseVelocity = elapsedSeconds > 0.0f
+                                 ? Vector2(static_cast<float>(Mouse.relative.x) / elapsedSeconds, static_cast<float>(Mouse.relative.y) / elapsedSeconds)
+                                 : Vector2(0.0f, 0.0f);
+            _sampleTimestampNs = sampleTimestampNs;
+        }
+
+        void Input::apply(const InputEvent& event)
+        {
+            switch (event.type)
+            {
+                case InputEvent::Type::Key:
+                    SetDown(event.key, event.pressed);
+                    break;
+                case InputEvent::Type::MousePosition:
+                {
+                    auto relative = event.value;
+                    relative -= Mouse.pos;
+                    Mouse.pos = event.value;
+
+                    // Raw deltas are more precise, cursor is used only for position then.
+                    if (!_rawInput)
+                    {
+                        Mouse.relative += relative;
+                        OnMouseMove.Fire(Mouse.pos, relative);
+                    }
+                    break;
+                }
+                case InputEvent::Type::MouseDelta:
+                    Mouse.relative += event.value;
+                    OnMouseMove.Fire(Mouse.pos, event.value);
+                    break;
+                case InputEvent::Type::FocusLost:
+                    // Releases won't be reported by unfocused window.
+                    for (int key = ikNone + 1; key < ikMAX; key++)
+                        SetDown(static_cast<InputKey>(key), false);
+                    break;
+            }
         }
 
         void Input::SetDown(InputKey key, bool value)
@@ -79,6 +214,11 @@ namespace RR
             {
                 _lastKey = key;
             }
+
+            if (value)
+                OnKeyDown.Fire(key);
+            else
+                OnKeyUp.Fire(key);
         }
 
         void Input::SetPos(InputKey key, const Vector2i& pos)
@@ -96,30 +236,74 @@ namespace RR
             }
         }
 
-        void Input::OnKeyUp(InputKey inputKey)
+        void Input::push(const InputEvent& event)
+        {
+            // Dropped if game doesn't sample input for a long time.
+            std::ignore = _events.TryPut(event);
+        }
+
+        void Input::onRawInput(const InputEvent& event)
         {
-            SetDown(inputKey, false);
+            // Dropped if game doesn't sample input for a long time.
+            if (_focused.load(std::memory_order_relaxed))
+                std::ignore = _rawEvents.TryPush(event);
+        }
+
+        void Input::onKey(int32_t key, bool pressed)
+        {
+            // Raw input thread reports keyboard and mouse buttons.
+            if (_rawInput)
+                return;
+
+            InputEvent event;
+            event.type = InputEvent::Type::Key;
+            event.key = toInputKey(key);
+            event.pressed = pressed;
+            event.timestampNs = Debug::Profiler::Now();
+
+            if (event.key != ikNone)
+                push(event);
         }
 
-        void Input::OnKeyDown(InputKey inputKey)
+        void Input::onMouseButton(int32_t button, bool pressed)
         {
-            SetDown(inputKey, true);
+            if (_rawInput)
+                return;
+
+            InputEvent event;
+            event.type = InputEvent::Type::Key;
+            event.key = toInputButton(button);
+            event.pressed = pressed;
+            event.timestampNs = Debug::Profiler::Now();
+
+            if (event.key != ikNone)
+                push(event);
         }
 
-        void Input::OnMouseMove(const Vector2i& position, const Vector2i& relative)
+        void Input::onMouseMove(const Vector2i& position)
         {
-            Mouse.pos = position;
-            Mouse.relative = relative;
+            InputEvent event;
+            event.type = InputEvent::Type::MousePosition;
+            event.value = position;
+            event.timestampNs = Debug::Profiler::Now();
+
+            push(event);
         }
 
-        void Input::OnButtonUp(InputKey inputKey)
+        void Input::onFocusGained()
         {
-            SetDown(inputKey, false);
+            _focused = true;
         }
 
-        void Input::OnButtonDown(InputKey inputKey)
+        void Input::onFocusLost()
         {
-            SetDown(inputKey, true);
+            _focused = false;
+
+            InputEvent event;
+            event.type = InputEvent::Type::FocusLost;
+            event.timestampNs = Debug::Profiler::Now();
+
+            push(event);
         }
     }
 }
\ No newline at end of file
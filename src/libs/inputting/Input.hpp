@@ -1,13 +1,17 @@
 #pragma once
 
-#include <map>
-
+#include "common/EventProvider.hpp"
 #include "common/Math.hpp"
-
-#include "windowing/InputtingWindow.hpp"
+#include "common/threading/MpscChannel.hpp"
+#include "common/threading/SpscQueue.hpp"
 
 namespace RR
 {
+    namespace Windowing
+    {
+        class Window;
+    }
+
     namespace Inputting
     {
         enum InputKey
@@ -68,26 +72,33 @@ namespace RR
             ikMAX
         };
 
-        class IKeyboardListener
-        {
-        public:
-            virtual void OnKeyUp(InputKey inputKey) { (void)inputKey; }
-            virtual void OnKeyDown(InputKey inputKey) { (void)inputKey; }
-        };
-
-        class IMouseListener
+        // Input change, timestamped when it's received in Debug::Profiler::Now() nanoseconds.
+        struct InputEvent
         {
-        public:
-            virtual void OnMouseMove(const Vector2i& position, const Vector2i& relative)
+            enum class Type : uint8_t
             {
-                (void)position;
-                (void)relative;
-            }
-            virtual void OnButtonUp(InputKey inputKey) { (void)inputKey; }
-            virtual void OnButtonDown(InputKey inputKey) { (void)inputKey; }
+                // Key or mouse button state change.
+                Key,
+                // Cursor position in window client area.
+                MousePosition,
+                // Raw mouse motion, not affected by cursor acceleration and screen edges.
+                MouseDelta,
+                // Window lost focus, pressed keys are released.
+                FocusLost
+            };
+
+            Type type = Type::Key;
+            InputKey key = ikNone;
+            bool pressed = false;
+            Vector2i value;
+            uint64_t timestampNs = 0;
         };
 
-        class Input final : public IMouseListener, IKeyboardListener
+        class RawInputThread;
+
+        // Window and raw input events are queued with timestamps from any thread and applied by Sample.
+        // Raw input thread receives keyboard and mouse as soon as OS delivers them, not when main loop polls window events.
+        class Input final
         {
         public:
             struct Mouse
@@ -100,12 +111,26 @@ namespace RR
                 } start;
             } Mouse;
 
+            Input();
             ~Input();
 
+            // Mouse buttons are reported as keys.
+            Event<void(InputKey inputKey)> OnKeyDown;
+            Event<void(InputKey inputKey)> OnKeyUp;
+            Event<void(const Vector2i& position, const Vector2i& relative)> OnMouseMove;
+
             void Reset();
-            void Init();
+            // Without raw input, or if it isn't supported, keyboard and mouse come from window events.
+            void Init(bool useRawInput = true);
             void Terminate();
-            void Update();
+            // Applies events received so far and fires input events. Call right before state is used,
+            // e.g. before camera update of rendered frame, to reduce latency.
+            void Sample();
+
+            // Mouse motion of the last sample divided by time since previous sample, in units per second.
+            // Allows to extrapolate camera movement to presentation time.
+            inline const Vector2& GetMouseVelocity() const { return _mouseVelocity; }
+            inline uint64_t GetSampleTimestamp() const { return _sampleTimestampNs; }
 
             inline bool IsDown(InputKey inputKey) const
             {
@@ -119,22 +144,42 @@ namespace RR
                 return _instance;
             }
 
-            void SubscribeToWindow(const std::shared_ptr<WindowSystem::InputtingWindow>& inputtingWindow);
+            void SubscribeToWindow(const std::shared_ptr<Windowing::Window>& window);
 
         private:
             static std::unique_ptr<Input> _instance;
 
-            std::shared_ptr<WindowSystem::InputtingWindow> _inputtingWindow;
+            static constexpr size_t EventsChannelSize = 4096;
+            static constexpr size_t RawEventsQueueSize = 4096;
 
-            InputKey _lastKey;
-            bool _down[ikMAX];
+            std::shared_ptr<Windowing::Window> _window;
+            EventHandle _keyHandle;
+            EventHandle _mouseButtonHandle;
+            EventHandle _mouseMoveHandle;
+            EventHandle _focusGainedHandle;
+            EventHandle _focusLostHandle;
 
-            virtual void OnKeyUp(InputKey inputKey) override;
-            virtual void OnKeyDown(InputKey inputKey) override;
+            std::unique_ptr<RawInputThread> _rawInput;
+            // Raw input is received by background windows as well, dropped unless window has focus.
+            std::atomic<bool> _focused = true;
+            Threading::MpscChannel<InputEvent, EventsChannelSize> _events;
+            // Raw input thread is the only producer, handoff doesn't contend with window events.
+            Threading::SpscQueue<InputEvent, RawEventsQueueSize> _rawEvents;
 
-            virtual void OnMouseMove(const Vector2i& position, const Vector2i& relative) override;
-            virtual void OnButtonUp(InputKey inputKey) override;
-            virtual void OnButtonDown(InputKey inputKey) override;
+            InputKey _lastKey;
+            bool _down[ikMAX];
+            Vector2 _mouseVelocity;
+            uint64_t _sampleTimestampNs = 0;
+
+            void push(const InputEvent& event);
+            void apply(const InputEvent& event);
+            void onRawInput(const InputEvent& event);
+
+            void onKey(int32_t key, bool pressed);
+            void onMouseButton(int32_t button, bool pressed);
+            void onMouseMove(const Vector2i& position);
+            void onFocusGained();
+            void onFocusLost();
 
             void SetDown(InputKey key, bool value);
             void SetPos(InputKey key, const Vector2i& pos);
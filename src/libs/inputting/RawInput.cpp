@@ -0,0 +1,217 @@
+#include "RawInput.hpp"
+
+#include "inputting/Input.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/debug/Profiler.hpp"
+
+#include <iterator>
+#include <utility>
+
+#ifdef OS_WINDOWS
+#include <Windows.h>
+#endif
+
+namespace RR
+{
+    namespace Inputting
+    {
+#ifdef OS_WINDOWS
+        namespace
+        {
+            constexpr wchar_t RawInputWindowClassName[] = L"RedRavenRawInput";
+
+            constexpr USHORT HidUsagePageGeneric = 0x01;
+            constexpr USHORT HidUsageGenericMouse = 0x02;
+            constexpr USHORT HidUsageGenericKeyboard = 0x06;
+
+            InputKey toInputKey(USHORT virtualKey)
+            {
+                if (virtualKey >= 'A' && virtualKey <= 'Z')
+                    return static_cast<InputKey>(ikA + (virtualKey - 'A'));
+
+                if (virtualKey >= '0' && virtualKey <= '9')
+                    return static_cast<InputKey>(ik0 + (virtualKey - '0'));
+
+                switch (virtualKey)
+                {
+                    case VK_LEFT: return ikLeft;
+                    case VK_RIGHT: return ikRight;
+                    case VK_UP: return ikUp;
+                    case VK_DOWN: return ikDown;
+                    case VK_SPACE: return ikSpace;
+                    case VK_TAB: return ikTab;
+                    case VK_RETURN: return ikEnter;
+                    case VK_ESCAPE: return ikEscape;
+                    case VK_SHIFT: return ikShift;
+                    case VK_CONTROL: return ikCtrl;
+                    case VK_MENU: return ikAlt;
+                    default: return ikNone;
+                }
+            }
+
+            bool registerDevices(HWND target, DWORD flags)
+            {
+                const RAWINPUTDEVICE devices[] = {
+                    { HidUsagePageGeneric, HidUsageGenericMouse, flags, target },
+                    { HidUsagePageGeneric, HidUsageGenericKeyboard, flags, target },
+                };
+
+                return RegisterRawInputDevices(devices, static_cast<UINT>(std::size(devices)), sizeof(RAWINPUTDEVICE)) == TRUE;
+            }
+        }
+#endif
+
+        RawInputThread::~RawInputThread()
+        {
+            Stop();
+        }
+
+        bool RawInputThread::Start(const EventCallback& callback)
+        {
+            ASSERT(callback);
+            ASSERT(!thread_.IsJoinable());
+
+#ifdef OS_WINDOWS
+            callback_ = callback;
+            started_ = false;
+            startedEvent_.Reset();
+
+            thread_ = Threading::Thread("RawInput", [this] { threadFunc(); });
+            startedEvent_.Wait();
+
+            if (!started_)
+                thread_.Join();
+
+            return started_;
+#else
+            return false;
+#endif
+        }
+
+        void RawInputThread::Stop()
+        {
+            if (!thread_.IsJoinable())
+                return;
+
+#ifdef OS_WINDOWS
+            PostThreadMessageW(threadId_, WM_QUIT, 0, 0);
+#endif
+            thread_.Join();
+        }
+
+        void RawInputThread::threadFunc()
+        {
+#ifdef OS_WINDOWS
+            Debug::Profiler::SetThreadName("RawInput");
+            ALLOCATION_TAG_SCOPE(Input);
+            threadId_ = GetCurrentThreadId();
+
+            const auto instance = GetModuleHandleW(nullptr);
+
+            WNDCLASSEXW windowClass = {};
+            windowClass.cbSize = sizeof(windowClass);
+            windowClass.lpfnWndProc = DefWindowProcW;
+            windowClass.hInstance = instance;
+            windowClass.lpszClassName = RawInputWindowClassName;
+            // Fails harmlessly when class is left registered by previous start.
+            RegisterClassExW(&windowClass);
+
+            const auto window = CreateWindowExW(0, RawInputWindowClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, instance, nullptr);
+
+            // Input sink delivers input while application is in background as well, owner filters by focus itself.
+            started_ = window && registerDevices(window, RIDEV_INPUTSINK);
+            if (!started_)
+            {
+                Log::Format::Error("Failed to register raw input devices, error: {}\n", GetLastError());
+
+                if (window)
+                    DestroyWindow(window);
+
+                startedEvent_.Notify();
+                return;
+            }
+
+            // Creates message queue, so WM_QUIT of Stop can't be lost.
+            MSG message;
+            PeekMessageW(&message, nullptr, 0, 0, PM_NOREMOVE);
+            startedEvent_.Notify();
+
+            while (GetMessageW(&message, nullptr, 0, 0) > 0)
+            {
+                if (message.message == WM_INPUT)
+                    processInput(reinterpret_cast<void*>(message.lParam));
+
+                // DefWindowProc releases WM_INPUT data.
+                DispatchMessageW(&message);
+            }
+
+            registerDevices(nullptr, RIDEV_REMOVE);
+            DestroyWindow(window);
+#endif
+        }
+
+        void RawInputThread::processInput(void* rawInputHandle)
+        {
+#ifdef OS_WINDOWS
+            InputEvent event;
+            event.timestampNs = Debug::Profiler::Now();
+
+            RAWINPUT input;
+            UINT size = sizeof(input);
+            if (GetRawInputData(static_cast<HRAWINPUT>(rawInputHandle), RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1))
+                return;
+
+            if (input.header.dwType == RIM_TYPEKEYBOARD)
+            {
+                const auto& keyboard = input.data.keyboard;
+
+                event.type = InputEvent::Type::Key;
+                event.key = toInputKey(keyboard.VKey);
+                event.pressed = (keyboard.Flags & RI_KEY_BREAK) == 0;
+
+                if (event.key != ikNone)
+                    callback_(event);
+
+                return;
+            }
+
+            if (input.header.dwType != RIM_TYPEMOUSE)
+                return;
+
+            const auto& mouse = input.data.mouse;
+
+            // Absolute positions come from tablets and remote desktop, cursor position covers them.
+            if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) == 0 && (mouse.lLastX != 0 || mouse.lLastY != 0))
+            {
+                event.type = InputEvent::Type::MouseDelta;
+                event.value = Vector2i(mouse.lLastX, mouse.lLastY);
+                callback_(event);
+            }
+
+            const std::pair<USHORT, InputKey> buttons[] = {
+                { RI_MOUSE_LEFT_BUTTON_DOWN, ikMouseL },
+                { RI_MOUSE_RIGHT_BUTTON_DOWN, ikMouseR },
+                { RI_MOUSE_MIDDLE_BUTTON_DOWN, ikMouseM },
+            };
+
+            event.type = InputEvent::Type::Key;
+            event.value = Vector2i(0, 0);
+
+            for (const auto& [downFlag, key] : buttons)
+            {
+                // Up flag of every button is the next bit after down one.
+                const auto upFlag = static_cast<USHORT>(downFlag << 1);
+                if ((mouse.usButtonFlags & (downFlag | upFlag)) == 0)
+                    continue;
+
+                event.key = key;
+                event.pressed = (mouse.usButtonFlags & downFlag) != 0;
+                callback_(event);
+            }
+#else
+            (void)rawInputHandle;
+#endif
+        }
+    }
+}
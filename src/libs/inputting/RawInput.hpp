@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common/Delegate.hpp"
+#include "common/threading/Event.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+
+namespace RR
+{
+    namespace Inputting
+    {
+        struct InputEvent;
+
+        // Receives keyboard and mouse WM_INPUT on a message-only window owned by a dedicated thread.
+        // Raw input devices are registered per process, so window library shouldn't register its own.
+        class RawInputThread final : private NonCopyable, NonMovable
+        {
+        public:
+            // Called on raw input thread.
+            using EventCallback = Delegate<void(const InputEvent&)>;
+
+            ~RawInputThread();
+
+            // Returns false if raw input isn't supported on the platform or devices registration failed.
+            bool Start(const EventCallback& callback);
+            void Stop();
+
+        private:
+            void threadFunc();
+            void processInput(void* rawInputHandle);
+
+        private:
+            EventCallback callback_;
+            Threading::Thread thread_;
+            std::atomic<uint32_t> threadId_ = 0;
+            // Signaled by the thread once devices registration finished.
+            Threading::Event startedEvent_;
+            bool started_ = false;
+        };
+    }
+}
@@ -0,0 +1,48 @@
+#include "BundleCache.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        BundleCache::BundleCache(DeviceContext& deviceContext)
+            : deviceContext_(deviceContext)
+        {
+        }
+
+        std::shared_ptr<GAPI::BundleCommandList> BundleCache::GetOrRecord(uint64_t passKey, uint64_t sceneRevision, const RecordCallback& record)
+        {
+            ASSERT(record);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            auto& entry = entries_[passKey];
+            if (entry.bundle && entry.sceneRevision == sceneRevision)
+                return entry.bundle;
+
+            auto bundle = deviceContext_.CreateBundleCommandList(fmt::sprintf("Bundle %016llx", passKey));
+            record(*bundle);
+            bundle->Close();
+
+            entry.sceneRevision = sceneRevision;
+            entry.bundle = bundle;
+
+            return bundle;
+        }
+
+        void BundleCache::Invalidate(uint64_t passKey)
+        {
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            entries_.erase(passKey);
+        }
+
+        void BundleCache::Clear()
+        {
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            entries_.clear();
+        }
+    }
+}
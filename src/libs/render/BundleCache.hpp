@@ -0,0 +1,44 @@
+#pragma once
+
+#include "gapi/CommandList.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <functional>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Bundles of static passes keyed by pass. Bundle is recorded again only when scene revision of the pass changes,
+        // unchanged passes replay pre-recorded draws. Replaced bundles are released after GPU is done with them.
+        class BundleCache final : private NonCopyable
+        {
+        public:
+            using RecordCallback = std::function<void(GAPI::BundleCommandList& bundle)>;
+
+            explicit BundleCache(DeviceContext& deviceContext);
+            ~BundleCache() = default;
+
+            // Callback records draws, bundle is closed after it. Callback is called under lock, so it shouldn't use the cache.
+            std::shared_ptr<GAPI::BundleCommandList> GetOrRecord(uint64_t passKey, uint64_t sceneRevision, const RecordCallback& record);
+
+            void Invalidate(uint64_t passKey);
+            void Clear();
+
+        private:
+            struct Entry
+            {
+                uint64_t sceneRevision;
+                std::shared_ptr<GAPI::BundleCommandList> bundle;
+            };
+
+            DeviceContext& deviceContext_;
+            std::unordered_map<uint64_t, Entry> entries_;
+            Threading::Mutex mutex_;
+        };
+    }
+}
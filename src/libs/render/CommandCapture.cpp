@@ -0,0 +1,327 @@
+#include "CommandCapture.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+
+#include "common/OnScopeExit.hpp"
+
+#include <cstring>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            template <typename T>
+            void write(std::vector<uint8_t>& output, const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+                output.insert(output.end(), bytes, bytes + sizeof(T));
+            }
+
+            template <typename T>
+            void writeArray(std::vector<uint8_t>& output, const std::vector<T>& values)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                write(output, static_cast<uint64_t>(values.size()));
+                const auto bytes = reinterpret_cast<const uint8_t*>(values.data());
+                output.insert(output.end(), bytes, bytes + values.size() * sizeof(T));
+            }
+
+            template <typename T>
+            bool read(const uint8_t*& data, size_t& remaining, T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                if (sizeof(T) > remaining)
+                    return false;
+
+                std::memcpy(&value, data, sizeof(T));
+                data += sizeof(T);
+                remaining -= sizeof(T);
+                return true;
+            }
+
+            template <typename T>
+            bool readArray(const uint8_t*& data, size_t& remaining, std::vector<T>& values)
+            {
+                uint64_t count;
+                if (!read(data, remaining, count) || count > remaining / sizeof(T))
+                    return false;
+
+                values.resize(count);
+                if (count > 0)
+                    std::memcpy(values.data(), data, count * sizeof(T));
+                data += count * sizeof(T);
+                remaining -= count * sizeof(T);
+                return true;
+            }
+        }
+
+#ifdef ENABLE_COMMAND_CAPTURE
+        bool CommandCapture::Arm()
+        {
+            bool expected = false;
+            return active_.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+        }
+
+        void CommandCapture::Begin(const U8String& path, uint32_t framesCount)
+        {
+            ASSERT(IsActive());
+            ASSERT(state_ == State::Idle);
+            ASSERT(framesCount > 0);
+
+            file_.open(path, std::ios::binary | std::ios::trunc);
+            if (!file_)
+            {
+                Log::Format::Error("Failed to open command capture file {}\n", path);
+                active_.store(false, std::memory_order_release);
+                return;
+            }
+
+            const FileHeader header = { Magic, Version };
+            file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            path_ = path;
+            framesCount_ = framesCount;
+            recordedFrames_ = 0;
+            recordedSubmits_ = 0;
+            incompleteLists_ = 0;
+            nextId_ = 0;
+            state_ = State::Arming;
+        }
+
+        void CommandCapture::OnSubmit(GAPI::CommandQueueType queueType, const std::shared_ptr<GAPI::CommandList>* commandLists, size_t count)
+        {
+            ASSERT(commandLists);
+
+            if (state_ == State::Recording)
+            {
+                std::vector<uint8_t> payload;
+                write(payload, queueType);
+                write(payload, static_cast<uint32_t>(count));
+
+                const auto writeReference = [this](GAPI::CommandStream::ReferenceType type, const std::shared_ptr<void>& object) {
+                    return writeObject(type, object);
+                };
+
+                for (size_t index = 0; index < count; index++)
+                {
+                    const auto& commandList = commandLists[index];
+                    const auto& stream = commandList->GetCaptureStream();
+
+                    // Recorded before capture was armed, replayed as empty list.
+                    if (!stream || stream->GetSkippedCommandsCount() > 0)
+                        incompleteLists_++;
+
+                    write(payload, commandList->GetCommandListType());
+
+                    const auto sizeOffset = payload.size();
+                    write(payload, uint64_t(0));
+
+                    if (stream)
+                        stream->Serialize(payload, writeReference);
+
+                    const uint64_t streamSize = payload.size() - sizeOffset - sizeof(uint64_t);
+                    std::memcpy(payload.data() + sizeOffset, &streamSize, sizeof(streamSize));
+                }
+
+                // Referenced objects are written by serialization, submit follows them.
+                writeRecord(RecordType::Submit, 0, payload);
+                recordedSubmits_++;
+            }
+
+            // Lists are recorded again only after submission, so stream could be swapped here.
+            for (size_t index = 0; index < count; index++)
+            {
+                const auto& commandList = commandLists[index];
+
+                if (!IsActive())
+                {
+                    commandList->SetCaptureStream(nullptr);
+                    continue;
+                }
+
+                if (const auto& stream = commandList->GetCaptureStream())
+                    stream->Reset();
+                else
+                    commandList->SetCaptureStream(std::make_shared<GAPI::CommandStream>());
+            }
+        }
+
+        void CommandCapture::OnFrameEnd()
+        {
+            switch (state_)
+            {
+                case State::Arming:
+                    state_ = State::Recording;
+                    break;
+                case State::Recording:
+                    writeRecord(RecordType::FrameEnd, 0, {});
+
+                    if (++recordedFrames_ == framesCount_)
+                        end();
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void CommandCapture::end()
+        {
+            file_.close();
+
+            if (file_.fail())
+                Log::Format::Error("Failed to write command capture file {}\n", path_);
+            else
+                Log::Format::Info("Command capture of {} frames, {} submits and {} objects written to {}\n", recordedFrames_, recordedSubmits_, nextId_, path_);
+
+            if (incompleteLists_ > 0)
+                Log::Format::Warning("{} captured command lists are incomplete, they were recorded before capture or had commands without stream representation\n", incompleteLists_);
+
+            ids_.clear();
+            writtenObjects_.clear();
+            state_ = State::Idle;
+            active_.store(false, std::memory_order_release);
+        }
+
+        uint32_t CommandCapture::writeObject(GAPI::CommandStream::ReferenceType type, const std::shared_ptr<void>& object)
+        {
+            ASSERT(object);
+
+            const auto it = ids_.find(object.get());
+            if (it != ids_.end())
+                return it->second;
+
+            std::vector<uint8_t> payload;
+            RecordType recordType;
+
+            switch (type)
+            {
+                case GAPI::CommandStream::ReferenceType::GpuResource:
+                {
+                    const auto& resource = *static_cast<const GAPI::GpuResource*>(object.get());
+                    const auto& name = resource.GetName();
+
+                    recordType = RecordType::Resource;
+                    write(payload, resource.GetDescription());
+                    write(payload, resource.GetCpuAccess());
+                    write(payload, static_cast<uint32_t>(name.size()));
+                    payload.insert(payload.end(), name.begin(), name.end());
+                    break;
+                }
+                case GAPI::CommandStream::ReferenceType::GpuResourceView:
+                {
+                    const auto& view = *static_cast<const GAPI::GpuResourceView*>(object.get());
+                    const auto viewType = view.GetViewType();
+
+                    const auto resource = view.GetGpuResource().lock();
+                    ASSERT(resource);
+                    // Resource record has to precede the view.
+                    const auto resourceId = writeObject(GAPI::CommandStream::ReferenceType::GpuResource, resource);
+
+                    const auto bindless = viewType == GAPI::GpuResourceView::ViewType::ShaderResourceView ||
+                                          viewType == GAPI::GpuResourceView::ViewType::UnorderedAccessView;
+
+                    recordType = RecordType::View;
+                    write(payload, resourceId);
+                    write(payload, viewType);
+                    write(payload, view.GetDescription());
+                    write(payload, bindless ? view.GetBindlessIndex() : GAPI::GpuResourceView::InvalidBindlessIndex);
+                    break;
+                }
+                case GAPI::CommandStream::ReferenceType::PipelineState:
+                {
+                    recordType = RecordType::PipelineState;
+                    WritePipelineStateDescription(payload, static_cast<const GAPI::PipelineState*>(object.get())->GetDescription());
+                    break;
+                }
+                case GAPI::CommandStream::ReferenceType::CpuResourceData:
+                {
+                    const auto& resourceData = *static_cast<const GAPI::CpuResourceData*>(object.get());
+                    const auto& allocation = resourceData.GetAllocation();
+                    const auto memoryType = allocation->GetMemoryType();
+
+                    recordType = RecordType::ResourceData;
+                    write(payload, resourceData.GetResourceDescription());
+                    write(payload, resourceData.GetFirstSubresource());
+                    write(payload, static_cast<uint32_t>(resourceData.GetNumSubresources()));
+                    write(payload, memoryType);
+
+                    // Readback destination content is produced by GPU.
+                    if (memoryType == GAPI::MemoryAllocationType::Readback)
+                    {
+                        write(payload, uint64_t(0));
+                        break;
+                    }
+
+                    write(payload, static_cast<uint64_t>(allocation->GetSize()));
+
+                    const auto data = static_cast<const uint8_t*>(allocation->Map());
+                    ON_SCOPE_EXIT(allocation->Unmap());
+                    payload.insert(payload.end(), data, data + allocation->GetSize());
+                    break;
+                }
+                default:
+                    LOG_FATAL("Unsupported reference type");
+            }
+
+            const auto id = nextId_++;
+            writeRecord(recordType, id, payload);
+
+            ids_.emplace(object.get(), id);
+            writtenObjects_.push_back(object);
+
+            return id;
+        }
+
+        void CommandCapture::writeRecord(RecordType type, uint32_t id, const std::vector<uint8_t>& payload)
+        {
+            const RecordHeader header = { type, id, payload.size() };
+            file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file_.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        }
+
+#endif
+
+        void CommandCapture::WritePipelineStateDescription(std::vector<uint8_t>& output, const GAPI::PipelineStateDescription& description)
+        {
+            write(output, description.type);
+            writeArray(output, description.vertexShader);
+            writeArray(output, description.pixelShader);
+            writeArray(output, description.computeShader);
+            writeArray(output, description.reflection);
+            writeArray(output, description.staticSamplers);
+            write(output, description.renderTargetCount);
+            write(output, description.renderTargetFormats);
+            write(output, description.depthStencilFormat);
+            write(output, description.drawConstantsCount);
+        }
+
+        bool CommandCapture::ReadPipelineStateDescription(const uint8_t* data, size_t size, GAPI::PipelineStateDescription& description)
+        {
+            ASSERT(data);
+
+            return read(data, size, description.type) &&
+                   readArray(data, size, description.vertexShader) &&
+                   readArray(data, size, description.pixelShader) &&
+                   readArray(data, size, description.computeShader) &&
+                   readArray(data, size, description.reflection) &&
+                   readArray(data, size, description.staticSamplers) &&
+                   read(data, size, description.renderTargetCount) &&
+                   read(data, size, description.renderTargetFormats) &&
+                   read(data, size, description.depthStencilFormat) &&
+                   read(data, size, description.drawConstantsCount) &&
+                   description.renderTargetCount <= GAPI::PipelineStateDescription::MaxRenderTargets &&
+                   description.drawConstantsCount <= GAPI::PipelineStateDescription::MaxDrawConstants &&
+                   size == 0;
+        }
+    }
+}
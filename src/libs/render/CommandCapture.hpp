@@ -0,0 +1,102 @@
+#pragma once
+
+#include "gapi/CommandStream.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace RR
+{
+    namespace Render
+    {
+        // Records command lists submitted during several frames together with resources, views, pipeline states
+        // and uploads they reference, so the frames could be executed again by CommandReplay without the application.
+        // Objects are written once, on the first submit referencing them. Content of resources written before capture isn't recorded.
+        // Layout: FileHeader | (RecordHeader | payload)*. Every record is preceded by records of objects it references.
+        class CommandCapture final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t Magic = 0x50435252; // 'RRCP'
+            // 2: GpuResourceDescription carries optimized clear value.
+            static constexpr uint32_t Version = 2;
+
+            enum class RecordType : uint32_t
+            {
+                // GpuResourceDescription | GpuResourceCpuAccess | name length | name
+                Resource,
+                // resource id | ViewType | GpuResourceViewDescription | bindless index of capturing device
+                View,
+                // PipelineStateDescription, blobs are written as size | bytes
+                PipelineState,
+                // GpuResourceDescription | first subresource | subresources count | MemoryAllocationType | size | bytes, readback data has no bytes
+                ResourceData,
+                // CommandQueueType | lists count | (CommandListType | stream size | CommandStream)*
+                Submit,
+                FrameEnd
+            };
+
+            struct FileHeader final
+            {
+                uint32_t magic;
+                uint32_t version;
+            };
+
+            // Objects are referenced by id of their record.
+            struct RecordHeader final
+            {
+                RecordType type;
+                uint32_t id;
+                uint64_t size;
+            };
+
+        public:
+            CommandCapture() = default;
+
+            // Capture hooks exist only with ENABLE_COMMAND_CAPTURE, replay needs just the format.
+            // Any thread. Capture becomes active right away, so command lists acquired from now on record streams.
+            bool Arm();
+            // Following calls are made by submission thread only.
+            // Starts recording with the next frame, current one is already in flight.
+            void Begin(const U8String& path, uint32_t framesCount);
+            void OnSubmit(GAPI::CommandQueueType queueType, const std::shared_ptr<GAPI::CommandList>* commandLists, size_t count);
+            void OnFrameEnd();
+
+            inline bool IsActive() const { return active_.load(std::memory_order_acquire); }
+
+            static void WritePipelineStateDescription(std::vector<uint8_t>& output, const GAPI::PipelineStateDescription& description);
+            static bool ReadPipelineStateDescription(const uint8_t* data, size_t size, GAPI::PipelineStateDescription& description);
+
+        private:
+            enum class State : uint32_t
+            {
+                Idle,
+                // Lists recorded in the frame Begin landed in may have missed commands, they get streams for the next frame.
+                Arming,
+                Recording
+            };
+
+            uint32_t writeObject(GAPI::CommandStream::ReferenceType type, const std::shared_ptr<void>& object);
+            void writeRecord(RecordType type, uint32_t id, const std::vector<uint8_t>& payload);
+            void end();
+
+        private:
+            std::atomic<bool> active_ = false;
+            State state_ = State::Idle;
+            std::ofstream file_;
+            U8String path_;
+            uint32_t framesCount_ = 0;
+            uint32_t recordedFrames_ = 0;
+            uint32_t recordedSubmits_ = 0;
+            // Lists recorded without stream and streams with commands which have no stream representation.
+            uint32_t incompleteLists_ = 0;
+
+            uint32_t nextId_ = 0;
+            std::unordered_map<const void*, uint32_t> ids_;
+            // Written objects are kept alive, so their addresses aren't reused by new objects during capture.
+            std::vector<std::shared_ptr<void>> writtenObjects_;
+        };
+    }
+}
@@ -0,0 +1,54 @@
+#include "CommandListPool.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        CommandListPool::CommandListPool(DeviceContext& deviceContext, const U8String& name)
+            : deviceContext_(deviceContext),
+              name_(name)
+        {
+        }
+
+        std::shared_ptr<GAPI::CommandList> CommandListPool::Acquire(GAPI::CommandListType type, uint64_t frameIndex, uint64_t completedFrames)
+        {
+            ASSERT(type != GAPI::CommandListType::Count);
+
+            auto& entries = entries_[static_cast<size_t>(type)];
+
+            // Entries are ordered by frame, so oldest one is always in front.
+            if (!entries.empty() && entries.front().frameIndex < completedFrames)
+            {
+                auto entry = std::move(entries.front());
+                entries.pop_front();
+
+                entry.frameIndex = frameIndex;
+                entries.push_back(entry);
+
+                return entry.commandList;
+            }
+
+            const auto& commandList = createCommandList(type, static_cast<uint32_t>(entries.size()));
+            entries.push_back({ frameIndex, commandList });
+
+            return commandList;
+        }
+
+        std::shared_ptr<GAPI::CommandList> CommandListPool::createCommandList(GAPI::CommandListType type, uint32_t index) const
+        {
+            const auto& name = fmt::sprintf("%s %u", name_, index);
+
+            switch (type)
+            {
+                case GAPI::CommandListType::Copy: return deviceContext_.CreateCopyCommandList(name);
+                case GAPI::CommandListType::Compute: return deviceContext_.CreateComputeCommandList(name);
+                case GAPI::CommandListType::Graphics: return deviceContext_.CreateGraphicsCommandList(name);
+                default: LOG_FATAL("Unsupported command list type");
+            }
+
+            return nullptr;
+        }
+    }
+}
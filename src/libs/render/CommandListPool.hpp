@@ -0,0 +1,39 @@
+#pragma once
+
+#include "gapi/CommandList.hpp"
+
+#include <deque>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Per thread pool of command lists ready to record.
+        // Lists are recycled once GPU completed frame they were acquired in.
+        // Every acquired list expected to be closed and submitted within the same frame.
+        class CommandListPool final : private NonCopyable
+        {
+        public:
+            CommandListPool(DeviceContext& deviceContext, const U8String& name);
+            ~CommandListPool() = default;
+
+            std::shared_ptr<GAPI::CommandList> Acquire(GAPI::CommandListType type, uint64_t frameIndex, uint64_t completedFrames);
+
+        private:
+            struct Entry
+            {
+                uint64_t frameIndex;
+                std::shared_ptr<GAPI::CommandList> commandList;
+            };
+
+            std::shared_ptr<GAPI::CommandList> createCommandList(GAPI::CommandListType type, uint32_t index) const;
+
+        private:
+            DeviceContext& deviceContext_;
+            U8String name_;
+            std::array<std::deque<Entry>, static_cast<size_t>(GAPI::CommandListType::Count)> entries_;
+        };
+    }
+}
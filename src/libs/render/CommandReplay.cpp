@@ -0,0 +1,365 @@
+#include "CommandReplay.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/Texture.hpp"
+
+#include "common/OnScopeExit.hpp"
+#include "common/debug/Profiler.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            // Bounds checked reading of record payload.
+            class Reader final
+            {
+            public:
+                Reader(const uint8_t* data, size_t size) : data_(data), remaining_(size) { }
+
+                template <typename T>
+                bool Read(T& value)
+                {
+                    static_assert(std::is_trivially_copyable_v<T>);
+
+                    if (sizeof(T) > remaining_)
+                        return false;
+
+                    std::memcpy(&value, data_, sizeof(T));
+                    return Skip(sizeof(T));
+                }
+
+                bool Skip(size_t size)
+                {
+                    if (size > remaining_)
+                        return false;
+
+                    data_ += size;
+                    remaining_ -= size;
+                    return true;
+                }
+
+                const uint8_t* GetData() const { return data_; }
+                size_t GetRemaining() const { return remaining_; }
+
+            private:
+                const uint8_t* data_;
+                size_t remaining_;
+            };
+
+            std::shared_ptr<GAPI::CommandList> acquireCommandList(DeviceContext& deviceContext, GAPI::CommandListType type)
+            {
+                switch (type)
+                {
+                    case GAPI::CommandListType::Copy: return deviceContext.AcquireCopyCommandList();
+                    case GAPI::CommandListType::Compute: return deviceContext.AcquireComputeCommandList();
+                    case GAPI::CommandListType::Graphics: return deviceContext.AcquireGraphicsCommandList();
+                    default: LOG_FATAL("Unsupported command list type");
+                }
+            }
+        }
+
+        bool CommandReplay::Load(DeviceContext& deviceContext, const U8String& path)
+        {
+            frames_.clear();
+            objects_.clear();
+            bindlessIndices_.clear();
+            unknownBindlessIndices_ = 0;
+
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file)
+            {
+                Log::Format::Error("Failed to open command capture file {}\n", path);
+                return false;
+            }
+
+            std::vector<uint8_t> content(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(content.size())))
+                return false;
+
+            Reader reader(content.data(), content.size());
+
+            CommandCapture::FileHeader header;
+            if (!reader.Read(header) || header.magic != CommandCapture::Magic || header.version != CommandCapture::Version)
+            {
+                Log::Format::Error("{} is not a command capture of version {}\n", path, CommandCapture::Version);
+                return false;
+            }
+
+            Frame frame;
+
+            while (reader.GetRemaining() > 0)
+            {
+                CommandCapture::RecordHeader record;
+                if (!reader.Read(record) || record.size > reader.GetRemaining())
+                    break;
+
+                const auto payload = reader.GetData();
+                reader.Skip(static_cast<size_t>(record.size));
+
+                switch (record.type)
+                {
+                    case CommandCapture::RecordType::Submit:
+                    {
+                        Submit submit;
+                        if (!loadSubmit(payload, static_cast<size_t>(record.size), submit))
+                        {
+                            Log::Format::Error("Malformed submit in command capture {}\n", path);
+                            return false;
+                        }
+
+                        frame.push_back(std::move(submit));
+                        break;
+                    }
+                    case CommandCapture::RecordType::FrameEnd:
+                        frames_.push_back(std::move(frame));
+                        frame.clear();
+                        break;
+                    default:
+                        if (!loadRecord(deviceContext, record.type, record.id, payload, static_cast<size_t>(record.size)))
+                        {
+                            Log::Format::Error("Malformed object {} in command capture {}\n", record.id, path);
+                            return false;
+                        }
+                }
+            }
+
+            if (reader.GetRemaining() > 0 || frames_.empty())
+            {
+                Log::Format::Error("Command capture {} is truncated\n", path);
+                return false;
+            }
+
+            if (unknownBindlessIndices_ > 0)
+                Log::Format::Warning("{} descriptor tables refer to views unknown to capture, they are left as is\n", unknownBindlessIndices_);
+
+            return true;
+        }
+
+        bool CommandReplay::loadRecord(DeviceContext& deviceContext, CommandCapture::RecordType type, uint32_t id, const uint8_t* data, size_t size)
+        {
+            using ReferenceType = GAPI::CommandStream::ReferenceType;
+
+            Reader reader(data, size);
+
+            switch (type)
+            {
+                case CommandCapture::RecordType::Resource:
+                {
+                    auto description = GAPI::GpuResourceDescription::Buffer(1);
+                    GAPI::GpuResourceCpuAccess cpuAccess;
+                    uint32_t nameLength;
+                    if (!reader.Read(description) || !reader.Read(cpuAccess) || !reader.Read(nameLength) || nameLength != reader.GetRemaining())
+                        return false;
+
+                    const U8String name(reinterpret_cast<const char*>(reader.GetData()), nameLength);
+
+                    std::shared_ptr<GAPI::GpuResource> resource;
+                    if (description.GetDimension() == GAPI::GpuResourceDimension::Buffer)
+                        resource = deviceContext.CreateBuffer(description, cpuAccess, name);
+                    else
+                        resource = deviceContext.CreateTexture(description, cpuAccess, name);
+
+                    objects_[id] = { ReferenceType::GpuResource, std::move(resource) };
+                    return true;
+                }
+                case CommandCapture::RecordType::View:
+                {
+                    uint32_t resourceId;
+                    GAPI::GpuResourceView::ViewType viewType;
+                    auto description = GAPI::GpuResourceViewDescription::Buffer(GAPI::GpuResourceFormat::Unknown, 0, 0);
+                    uint32_t bindlessIndex;
+                    if (!reader.Read(resourceId) || !reader.Read(viewType) || !reader.Read(description) || !reader.Read(bindlessIndex) || reader.GetRemaining() > 0)
+                        return false;
+
+                    const auto it = objects_.find(resourceId);
+                    if (it == objects_.end() || it->second.first != ReferenceType::GpuResource)
+                        return false;
+
+                    const auto resource = std::static_pointer_cast<GAPI::GpuResource>(it->second.second);
+
+                    std::shared_ptr<GAPI::GpuResourceView> view;
+                    switch (viewType)
+                    {
+                        case GAPI::GpuResourceView::ViewType::ShaderResourceView:
+                            view = deviceContext.CreateShaderResourceView(resource, description);
+                            break;
+                        case GAPI::GpuResourceView::ViewType::UnorderedAccessView:
+                            view = deviceContext.CreateUnorderedAccessView(resource, description);
+                            break;
+                        case GAPI::GpuResourceView::ViewType::RenderTargetView:
+                            if (!resource->IsTexture())
+                                return false;
+                            view = deviceContext.CreateRenderTargetView(resource->GetTyped<GAPI::Texture>(), description);
+                            break;
+                        case GAPI::GpuResourceView::ViewType::DepthStencilView:
+                            if (!resource->IsTexture())
+                                return false;
+                            view = deviceContext.CreateDepthStencilView(resource->GetTyped<GAPI::Texture>(), description);
+                            break;
+                        default:
+                            return false;
+                    }
+
+                    if (bindlessIndex != GAPI::GpuResourceView::InvalidBindlessIndex)
+                        bindlessIndices_[bindlessIndex] = view->GetBindlessIndex();
+
+                    objects_[id] = { ReferenceType::GpuResourceView, std::move(view) };
+                    return true;
+                }
+                case CommandCapture::RecordType::PipelineState:
+                {
+                    GAPI::PipelineStateDescription description;
+                    if (!CommandCapture::ReadPipelineStateDescription(data, size, description))
+                        return false;
+
+                    objects_[id] = { ReferenceType::PipelineState, deviceContext.CreatePipelineState(description) };
+                    return true;
+                }
+                case CommandCapture::RecordType::ResourceData:
+                {
+                    auto description = GAPI::GpuResourceDescription::Buffer(1);
+                    uint32_t firstSubresource;
+                    uint32_t numSubresources;
+                    GAPI::MemoryAllocationType memoryType;
+                    uint64_t dataSize;
+                    if (!reader.Read(description) || !reader.Read(firstSubresource) || !reader.Read(numSubresources) ||
+                        !reader.Read(memoryType) || !reader.Read(dataSize) || dataSize != reader.GetRemaining())
+                        return false;
+
+                    if (!description.IsValid() || firstSubresource + numSubresources > description.GetNumSubresources())
+                        return false;
+
+                    auto resourceData = deviceContext.AllocateIntermediateResourceData(description, memoryType, firstSubresource, numSubresources);
+
+                    if (dataSize > 0)
+                    {
+                        // Footprints are device specific, capture is replayed on the same kind of device.
+                        const auto& allocation = resourceData->GetAllocation();
+                        if (allocation->GetSize() != dataSize)
+                            return false;
+
+                        const auto mapped = allocation->Map();
+                        ON_SCOPE_EXIT(allocation->Unmap());
+                        std::memcpy(mapped, reader.GetData(), static_cast<size_t>(dataSize));
+                    }
+
+                    objects_[id] = { ReferenceType::CpuResourceData, std::move(resourceData) };
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        bool CommandReplay::loadSubmit(const uint8_t* data, size_t size, Submit& submit)
+        {
+            Reader reader(data, size);
+
+            uint32_t listsCount;
+            if (!reader.Read(submit.queueType) || submit.queueType >= GAPI::CommandQueueType::Count || !reader.Read(listsCount))
+                return false;
+
+            const auto readReference = [this](GAPI::CommandStream::ReferenceType type, uint32_t id) -> std::shared_ptr<void> {
+                const auto it = objects_.find(id);
+                return it != objects_.end() && it->second.first == type ? it->second.second : nullptr;
+            };
+
+            const auto remapBindlessIndex = [this](uint32_t bindlessIndex) {
+                const auto it = bindlessIndices_.find(bindlessIndex);
+                if (it != bindlessIndices_.end())
+                    return it->second;
+
+                unknownBindlessIndices_++;
+                return bindlessIndex;
+            };
+
+            for (uint32_t index = 0; index < listsCount; index++)
+            {
+                List list;
+                uint64_t streamSize;
+                if (!reader.Read(list.type) || list.type >= GAPI::CommandListType::Bundle ||
+                    !reader.Read(streamSize) || streamSize > reader.GetRemaining())
+                    return false;
+
+                list.stream = std::make_unique<GAPI::CommandStream>();
+
+                // Lists recorded before capture have empty stream.
+                if (streamSize > 0 && !list.stream->Deserialize(reader.GetData(), static_cast<size_t>(streamSize), readReference, remapBindlessIndex))
+                    return false;
+
+                if (!GAPI::SupportsCommands(list.type, list.stream->GetRequiredCommandListType()))
+                    return false;
+
+                reader.Skip(static_cast<size_t>(streamSize));
+                submit.lists.push_back(std::move(list));
+            }
+
+            return reader.GetRemaining() == 0;
+        }
+
+        std::vector<CommandReplay::FrameTiming> CommandReplay::Replay(DeviceContext& deviceContext, uint32_t iterations)
+        {
+            ASSERT(!frames_.empty());
+
+            const auto& graphicsQueue = deviceContext.GetCommandQueue(GAPI::CommandQueueType::Graphics);
+
+            std::vector<FrameTiming> timings;
+            timings.reserve(frames_.size() * iterations);
+
+            std::vector<std::shared_ptr<GAPI::CommandList>> commandLists;
+
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+                for (const auto& frame : frames_)
+                {
+                    const auto startNs = Profiler::Now();
+
+                    GAPI::GpuSyncPoint previous;
+                    for (const auto& submit : frame)
+                    {
+                        if (submit.lists.empty())
+                            continue;
+
+                        commandLists.clear();
+                        for (const auto& list : submit.lists)
+                        {
+                            auto commandList = acquireCommandList(deviceContext, list.type);
+                            list.stream->Execute(*commandList);
+                            commandList->Close();
+                            commandLists.push_back(std::move(commandList));
+                        }
+
+                        const auto& commandQueue = deviceContext.GetCommandQueue(submit.queueType);
+                        if (previous.IsValid())
+                            previous = deviceContext.Submit(commandQueue, commandLists, { previous });
+                        else
+                            previous = deviceContext.Submit(commandQueue, commandLists);
+                    }
+
+                    const auto submittedNs = Profiler::Now();
+
+                    deviceContext.MoveToNextFrame(graphicsQueue);
+
+                    if (previous.IsValid())
+                        previous.Wait();
+
+                    const auto endNs = Profiler::Now();
+                    timings.push_back({ (submittedNs - startNs) / 1e6, (endNs - startNs) / 1e6 });
+                }
+
+            return timings;
+        }
+    }
+}
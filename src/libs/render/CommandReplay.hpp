@@ -0,0 +1,65 @@
+#pragma once
+
+#include "render/CommandCapture.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Executes frames written by CommandCapture, isolating cost of gapi and GPU driver from the application.
+        // Captured objects are created again, bindless indices of descriptor tables are remapped to views of the replaying device.
+        // Submits are executed in captured order, each one waits on GPU for the previous, so cross queue dependencies hold.
+        class CommandReplay final : private NonCopyable
+        {
+        public:
+            struct FrameTiming final
+            {
+                // Recording and submission of command lists.
+                double cpuMs;
+                // Until GPU finished the frame.
+                double frameMs;
+            };
+
+        public:
+            CommandReplay() = default;
+
+            // Creates captured objects on the device. False on malformed or incompatible file.
+            bool Load(DeviceContext& deviceContext, const U8String& path);
+            // Executes captured frames iterations times, blocks until GPU finished each frame.
+            std::vector<FrameTiming> Replay(DeviceContext& deviceContext, uint32_t iterations);
+
+            inline size_t GetFramesCount() const { return frames_.size(); }
+
+        private:
+            struct List final
+            {
+                GAPI::CommandListType type;
+                std::unique_ptr<GAPI::CommandStream> stream;
+            };
+
+            struct Submit final
+            {
+                GAPI::CommandQueueType queueType;
+                std::vector<List> lists;
+            };
+
+            using Frame = std::vector<Submit>;
+
+            bool loadRecord(DeviceContext& deviceContext, CommandCapture::RecordType type, uint32_t id, const uint8_t* data, size_t size);
+            bool loadSubmit(const uint8_t* data, size_t size, Submit& submit);
+
+        private:
+            std::vector<Frame> frames_;
+            // Stored as types streams reference them by, see GAPI::CommandStream::ReferenceType.
+            std::unordered_map<uint32_t, std::pair<GAPI::CommandStream::ReferenceType, std::shared_ptr<void>>> objects_;
+            std::unordered_map<uint32_t, uint32_t> bindlessIndices_;
+            uint32_t unknownBindlessIndices_ = 0;
+        };
+    }
+}
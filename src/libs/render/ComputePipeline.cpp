@@ -0,0 +1,50 @@
+#include "ComputePipeline.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/PipelineState.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        ComputePipeline::~ComputePipeline()
+        {
+            ASSERT(!pipeline_);
+        }
+
+        bool ComputePipeline::Init(DeviceContext& deviceContext, const char* shaderPath, const U8String& name, const char* fallback)
+        {
+            ASSERT(!pipeline_);
+            ASSERT(fallback);
+
+            GAPI::PipelineStateDescription pipelineDescription;
+            pipelineDescription.type = GAPI::PipelineStateType::Compute;
+
+            if (!GAPI::PipelineStateDescription::ReadShader(shaderPath, pipelineDescription.computeShader))
+            {
+                Log::Print::Warning("%s shader \"%s\" not found, %s.\n", name.c_str(), shaderPath, fallback);
+                return false;
+            }
+
+            pipeline_ = deviceContext.CreatePipelineState(pipelineDescription, name);
+            return true;
+        }
+
+        void ComputePipeline::Terminate()
+        {
+            pipeline_ = nullptr;
+        }
+
+        void ComputePipeline::Bind(GAPI::ComputeCommandList& commandList) const
+        {
+            ASSERT(pipeline_);
+
+            // Pipeline isn't compiled asynchronously, so it's always resolved.
+            const bool isBound = commandList.SetComputePipelineState(pipeline_);
+            ASSERT(isBound);
+            std::ignore = isBound;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Compute pipeline of a render pass. Shader is compiled by rfx from bin/shaders with embedded root signature,
+        // pipeline is unavailable when bytecode isn't found and the pass falls back or skips its work then.
+        class ComputePipeline final : private NonCopyable
+        {
+        public:
+            ComputePipeline() = default;
+            ~ComputePipeline();
+
+            // Warns with fallback description when shader isn't found, returns availability.
+            bool Init(DeviceContext& deviceContext, const char* shaderPath, const U8String& name, const char* fallback);
+            void Terminate();
+
+            bool IsAvailable() const { return pipeline_ != nullptr; }
+
+            void Bind(GAPI::ComputeCommandList& commandList) const;
+
+        private:
+            std::shared_ptr<GAPI::PipelineState> pipeline_;
+        };
+    }
+}
@@ -6,19 +6,48 @@
 #include "gapi/Device.hpp"
 #include "gapi/Fence.hpp"
 #include "gapi/GpuResourceViews.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+#include "gapi/QueryPool.hpp"
 #include "gapi/SwapChain.hpp"
 #include "gapi/Texture.hpp"
 
 #include "gapi_dx12/Device.hpp"
 
+#include "render/CommandCapture.hpp"
+#include "render/CommandListPool.hpp"
 #include "render/Submission.hpp"
 
+#include "common/debug/AllocationTracker.hpp"
+#include "common/debug/MemoryStats.hpp"
+#include "common/debug/Profiler.hpp"
 #include "common/threading/Event.hpp"
+#include "common/threading/Futex.hpp"
+#include "common/threading/JobSystem.hpp"
+
+#include <algorithm>
 
 namespace RR
 {
     namespace Render
     {
+        namespace
+        {
+            // Shared by all contexts, so thread caches never match pools of another or re-created context.
+            std::atomic<uint64_t> nextCommandListPoolsGeneration = 1;
+
+            GAPI::CommandListType getCommandListType(GAPI::CommandQueueType type)
+            {
+                switch (type)
+                {
+                    case GAPI::CommandQueueType::Graphics: return GAPI::CommandListType::Graphics;
+                    case GAPI::CommandQueueType::Compute: return GAPI::CommandListType::Compute;
+                    case GAPI::CommandQueueType::Copy: return GAPI::CommandListType::Copy;
+                    default: LOG_FATAL("Unsupported command queue type");
+                }
+            }
+        }
+
         DeviceContext::DeviceContext()
             : submission_(new Submission())
         {
@@ -26,9 +55,18 @@ namespace RR
 
         DeviceContext::~DeviceContext() { }
 
-        void DeviceContext::Init()
+        std::vector<GAPI::AdapterDescription> DeviceContext::EnumerateAdapters()
+        {
+            return GAPI::DX12::EnumerateAdapters();
+        }
+
+        void DeviceContext::Init(uint32_t gpuFramesBuffered, const U8String& pipelineCachePath, uint32_t adapterIndex, bool enablePresentThread)
         {
             ASSERT(!inited_);
+            ASSERT(gpuFramesBuffered > 0 && gpuFramesBuffered <= GAPI::MAX_GPU_FRAMES_BUFFERED);
+
+            gpuFramesBuffered_ = gpuFramesBuffered;
+            maxFramesAhead_ = gpuFramesBuffered;
 
             auto debugMode = GAPI::Device::DebugMode::Retail;
 #ifdef DEBUG
@@ -36,10 +74,12 @@ namespace RR
             debugMode = GAPI::Device::DebugMode::Debug;
 #endif
 
-            GAPI::Device::Description description(GpuFramesBuffered, debugMode);
+            GAPI::Device::Description description(gpuFramesBuffered_, debugMode, pipelineCachePath);
+            description.adapterIndex = adapterIndex;
 
             const auto& device = GAPI::Device::Create(description, "Primary");
-            submission_->Start(device);
+            submission_->Start(device, enablePresentThread);
+            multiThreadDevice_ = device.get();
 
             // Init Device
             submission_->ExecuteAwait([&description](GAPI::Device& device) {
@@ -47,9 +87,13 @@ namespace RR
                     LOG_FATAL("Can't init device");
             });
 
+            commandListPoolsGeneration_ = nextCommandListPoolsGeneration++;
             inited_ = true;
 
-            fence_ = CreateFence("Frame sync fence");
+            commandQueues_[static_cast<size_t>(GAPI::CommandQueueType::Graphics)] = CreteCommandQueue(GAPI::CommandQueueType::Graphics, "Graphics");
+            commandQueues_[static_cast<size_t>(GAPI::CommandQueueType::Compute)] = CreteCommandQueue(GAPI::CommandQueueType::Compute, "Async compute");
+            commandQueues_[static_cast<size_t>(GAPI::CommandQueueType::Copy)] = CreteCommandQueue(GAPI::CommandQueueType::Copy, "Copy");
+            commandQueues_[HighPriorityComputeQueueIndex] = CreteCommandQueue(GAPI::CommandQueueType::Compute, "High priority compute", GAPI::CommandQueuePriority::High);
         }
 
         void DeviceContext::Terminate()
@@ -57,87 +101,410 @@ namespace RR
             ASSERT(inited_);
 
             //Release resources before termination;
-            fence_.reset();
+            for (const auto& commandQueue : commandQueues_)
+                WaitForGpu(commandQueue);
+
+            // Queues are idle, so every pending readback is complete.
+            dispatchReadbacks();
 
+            for (auto& syncPoints : frameSyncPoints_)
+                syncPoints.clear();
+
+            for (auto& commandQueue : commandQueues_)
+                commandQueue = nullptr;
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(commandListPoolsMutex_);
+                commandListPoolsGeneration_ = nextCommandListPoolsGeneration++;
+                commandListPools_.clear();
+            }
+
+            multiThreadDevice_ = nullptr;
             submission_->Terminate();
             inited_ = false;
         }
 
-        void DeviceContext::Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList)
+        GAPI::GpuSyncPoint DeviceContext::Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList)
         {
             ASSERT(inited_);
+            ASSERT(commandQueue);
 
-            submission_->Submit(commandQueue, commandList);
+            // Timeline values should reach submission thread in order they are assigned.
+            Threading::UniqueLock<Threading::Mutex> lock(commandQueue->timelineMutex_);
+
+            const GAPI::GpuSyncPoint syncPoint { commandQueue->timelineFence_, ++commandQueue->timelineValue_ };
+            submission_->Submit(commandQueue, commandList, syncPoint);
+
+            return syncPoint;
         }
 
-        void DeviceContext::Present(const std::shared_ptr<GAPI::SwapChain>& swapChain)
+        GAPI::GpuSyncPoint DeviceContext::Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::vector<std::shared_ptr<GAPI::CommandList>>& commandLists)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+
+            Threading::UniqueLock<Threading::Mutex> lock(commandQueue->timelineMutex_);
+
+            const GAPI::GpuSyncPoint syncPoint { commandQueue->timelineFence_, ++commandQueue->timelineValue_ };
+            submission_->Submit(commandQueue, commandLists, syncPoint);
+
+            return syncPoint;
+        }
+
+        GAPI::GpuSyncPoint DeviceContext::Submit(
+            const std::shared_ptr<GAPI::CommandQueue>& commandQueue,
+            const std::vector<std::shared_ptr<GAPI::CommandList>>& commandLists,
+            const std::vector<GAPI::GpuSyncPoint>& dependencies)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+
+            for (const auto& dependency : dependencies)
+            {
+                ASSERT(dependency.IsValid());
+
+                // Queue executes own work in order.
+                if (dependency.fence == commandQueue->timelineFence_)
+                    continue;
+
+                Wait(commandQueue, dependency);
+            }
+
+            return Submit(commandQueue, commandLists);
+        }
+
+        GAPI::GpuSyncPoint DeviceContext::Signal(const std::shared_ptr<GAPI::CommandQueue>& commandQueue)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+
+            Threading::UniqueLock<Threading::Mutex> lock(commandQueue->timelineMutex_);
+
+            const GAPI::GpuSyncPoint syncPoint { commandQueue->timelineFence_, ++commandQueue->timelineValue_ };
+            submission_->Signal(commandQueue, syncPoint);
+
+            return syncPoint;
+        }
+
+        GAPI::GpuSyncPoint DeviceContext::Signal(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Fence>& sharedFence)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+            ASSERT(sharedFence);
+
+            Threading::UniqueLock<Threading::Mutex> lock(sharedFence->timelineMutex_);
+
+            const GAPI::GpuSyncPoint syncPoint { sharedFence, ++sharedFence->timelineValue_ };
+            submission_->Signal(commandQueue, syncPoint);
+
+            return syncPoint;
+        }
+
+        void DeviceContext::Wait(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const GAPI::GpuSyncPoint& syncPoint)
         {
             ASSERT(inited_);
+            ASSERT(commandQueue);
 
-            submission_->ExecuteAsync([swapChain](GAPI::Device& device) {
-                device.Present(swapChain);
+            if (syncPoint.IsComplete())
+                return;
+
+            submission_->Wait(commandQueue, syncPoint);
+        }
+
+        void DeviceContext::UpdateTileMappings(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, std::vector<GAPI::TileMappingUpdate>&& updates)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+
+            if (updates.empty())
+                return;
+
+            submission_->ExecuteAsync([commandQueue, updates = std::move(updates)](GAPI::Device&) {
+                commandQueue->UpdateTileMappings(updates);
             });
         }
 
+        void DeviceContext::ReleaseQueueOwnership(const std::shared_ptr<GAPI::GpuResource>& resource, const GAPI::GpuSyncPoint& syncPoint)
+        {
+            ASSERT(inited_);
+            ASSERT(resource);
+
+            resource->releaseQueueOwnership(syncPoint);
+        }
+
+        void DeviceContext::AcquireQueueOwnership(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::GpuResource>& resource)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+            ASSERT(resource);
+
+            const auto syncPoint = resource->acquireQueueOwnership(*commandQueue->timelineFence_);
+
+            if (syncPoint.IsValid())
+                Wait(commandQueue, syncPoint);
+        }
+
+        void DeviceContext::Present(const std::shared_ptr<GAPI::SwapChain>& swapChain)
+        {
+            ASSERT(inited_);
+
+            submission_->Present(swapChain);
+            advanceSwapChain(swapChain);
+        }
+
+        void DeviceContext::Present(const std::vector<std::shared_ptr<GAPI::SwapChain>>& swapChains)
+        {
+            ASSERT(inited_);
+
+            submission_->Present(swapChains);
+
+            for (const auto& swapChain : swapChains)
+                advanceSwapChain(swapChain);
+        }
+
+        void DeviceContext::advanceSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain)
+        {
+            swapChain->currentBackBuffer_ = (swapChain->currentBackBuffer_ + 1) % swapChain->GetDescription().bufferCount;
+
+            const auto pendingSize = swapChain->pendingSize_.exchange(0, std::memory_order_acquire);
+            if (pendingSize == 0)
+                return;
+
+            auto description = swapChain->GetDescription();
+            description.width = static_cast<uint32_t>(pendingSize >> 32);
+            description.height = static_cast<uint32_t>(pendingSize);
+
+            if (description.width != swapChain->GetDescription().width || description.height != swapChain->GetDescription().height)
+                ResetSwapChain(swapChain, description);
+        }
+
+        void DeviceContext::WaitForNextFrame(const std::shared_ptr<GAPI::SwapChain>& swapChain)
+        {
+            ASSERT(inited_);
+            ASSERT(swapChain);
+
+            // Waitable object is thread safe, no need to go through submission thread.
+            swapChain->WaitForNextFrame();
+        }
+
         void DeviceContext::WaitForGpu(const std::shared_ptr<GAPI::CommandQueue>& commandQueue)
         {
             ASSERT(inited_);
 
-            submission_->ExecuteAwait([commandQueue](GAPI::Device& device) {
-                commandQueue->WaitForGpu();
-            });
+            Signal(commandQueue).Wait();
         }
 
         void DeviceContext::MoveToNextFrame(const std::shared_ptr<GAPI::CommandQueue>& commandQueue)
         {
             ASSERT(inited_);
 
-            static uint32_t submissionFrame = 0;
+            ASSERT(commandQueue);
 
-            // TODO this is not valid. We should sync all command list with primary command list.
-            submission_->ExecuteAsync([fence = fence_, commandQueue](GAPI::Device& device) {
-                submissionFrame++;
+            PROFILE_SCOPE("DeviceContext::MoveToNextFrame");
 
-                // Schedule a Signal command in the queue.
-                fence->Signal(commandQueue);
+            if (memoryBudgetChanged_.exchange(false))
+                OnMemoryBudgetChanged.Fire(GetMemoryBudget());
 
-                if (fence->GetCpuValue() >= GpuFramesBuffered)
-                {
-                    uint64_t syncFenceValue = fence->GetCpuValue() - GpuFramesBuffered;
+            const auto frameIndex = frameIndex_++;
+            AllocationTracker::Instance().EndFrame(frameIndex);
+            MemoryStats::Instance().EndFrame(frameIndex);
+
+            // End of the frame on every queue, so frame completion covers async work as well.
+            auto& syncPoints = frameSyncPoints_[frameIndex % (gpuFramesBuffered_ * 2)];
+            syncPoints.clear();
+
+            for (const auto& ownedQueue : commandQueues_)
+                syncPoints.push_back(Signal(ownedQueue));
+
+            if (std::find(commandQueues_.begin(), commandQueues_.end(), commandQueue) == commandQueues_.end())
+                syncPoints.push_back(Signal(commandQueue));
 
-                    // We shoud had at least one completed frame in ringbuffer.
-                    syncFenceValue++;
+            submission_->ExecuteAsync([this, frameIndex](GAPI::Device& device) {
+                // All tasks of the frame are processed.
+                submittedFrames_ = frameIndex + 1;
+                submittedFramesWord_.fetch_add(1, std::memory_order_release);
+                Threading::Details::WakeAll(submittedFramesWord_);
+
+                // We shoud had at least one completed frame in ringbuffer.
+                if (frameIndex + 1 >= gpuFramesBuffered_)
+                {
+                    const auto syncFrameIndex = frameIndex + 1 - gpuFramesBuffered_;
 
                     // Throttle cpu if gpu behind
-                    fence->SyncCPU(syncFenceValue, INFINITE);
+                    for (const auto& syncPoint : frameSyncPoints_[syncFrameIndex % (gpuFramesBuffered_ * 2)])
+                        syncPoint.Wait(INFINITE);
+
+                    completedFrames_ = syncFrameIndex + 1;
                 }
 
-                device.MoveToNextFrame(submissionFrame);
+                device.MoveToNextFrame(frameIndex + 1, frameSyncPoints_[frameIndex % (gpuFramesBuffered_ * 2)]);
+#ifdef ENABLE_COMMAND_CAPTURE
+                submission_->GetCommandCapture().OnFrameEnd();
+#endif
+                checkMemoryBudget(device);
+                dispatchReadbacks();
+
+                if (Profiler::IsCapturing())
+                    profileGpuFrame(device);
+            });
+
+            // Next frame reuses submission storage of the frame gpuFramesBuffered_ ago, limit is never above it.
+            const auto nextFrameIndex = frameIndex + 1;
+            const auto maxFramesAhead = maxFramesAhead_.load(std::memory_order_relaxed);
+            if (nextFrameIndex >= maxFramesAhead)
+                waitForSubmittedFrames(nextFrameIndex + 1 - maxFramesAhead);
+
+            submission_->ResetFrameAllocator(nextFrameIndex);
+        }
+
+        void DeviceContext::SetMaxFramesAhead(uint32_t framesCount)
+        {
+            ASSERT(inited_);
+
+            maxFramesAhead_.store(std::clamp(framesCount, 1u, gpuFramesBuffered_), std::memory_order_relaxed);
+        }
+
+        void DeviceContext::waitForSubmittedFrames(uint64_t framesCount)
+        {
+            const auto isSubmitted = [this, framesCount] { return submittedFrames_.load(std::memory_order_acquire) >= framesCount; };
+
+            if (isSubmitted())
+                return;
+
+            PROFILE_SCOPE("DeviceContext::WaitForSubmittedFrames");
+
+            if (Threading::Details::SpinUntil(isSubmitted))
+                return;
+
+            auto& jobSystem = Threading::JobSystem::Instance();
+            while (true)
+            {
+                // Read word before the check, so the wake between them isn't lost.
+                const auto word = submittedFramesWord_.load(std::memory_order_acquire);
+                if (isSubmitted())
+                    return;
+
+                if (jobSystem.TryRunOne())
+                    continue;
+
+                Threading::Details::WaitOnWord(submittedFramesWord_, word);
+            }
+        }
+
+        bool DeviceContext::BeginCommandCapture(const U8String& path, uint32_t framesCount)
+        {
+            ASSERT(inited_);
+            ASSERT(framesCount > 0);
+
+#ifdef ENABLE_COMMAND_CAPTURE
+            auto& commandCapture = submission_->GetCommandCapture();
+            if (!commandCapture.Arm())
+            {
+                Log::Print::Warning("Command capture is already in progress\n");
+                return false;
+            }
+
+            // Ordered with frame ends, so capture starts at the frame boundary.
+            submission_->ExecuteAsync([&commandCapture, path, framesCount](GAPI::Device&) {
+                commandCapture.Begin(path, framesCount);
             });
 
-            // Todo throttle main thread?
+            return true;
+#else
+            (void)path;
+            Log::Print::Warning("Command capture is disabled, build with ENABLE_COMMAND_CAPTURE\n");
+            return false;
+#endif
         }
 
-        void DeviceContext::ExecuteAsync(const Submission::CallbackFunction&& function)
+        void DeviceContext::ExecuteAsync(Submission::CallbackFunction&& function)
         {
             ASSERT(inited_);
 
             submission_->ExecuteAsync(std::move(function));
         }
 
-        void DeviceContext::ExecuteAwait(const Submission::CallbackFunction&& function)
+        void DeviceContext::ExecuteAwait(Submission::CallbackFunction&& function)
         {
             ASSERT(inited_);
 
             submission_->ExecuteAwait(std::move(function));
         }
 
-        void DeviceContext::ResetSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapchain, GAPI::SwapChainDescription& description)
+        void DeviceContext::ReadbackAsync(const std::shared_ptr<GAPI::CommandQueue>& commandQueue,
+                                          const std::shared_ptr<GAPI::GpuResource>& resource,
+                                          ReadbackCallback&& callback,
+                                          uint32_t firstSubresource,
+                                          uint32_t numSubresources)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+            ASSERT(resource);
+            ASSERT(callback);
+
+            auto readback = std::make_shared<PendingReadback>();
+            readback->data = AllocateIntermediateResourceData(resource->GetDescription(), GAPI::MemoryAllocationType::Readback, firstSubresource, numSubresources);
+            readback->callback = std::move(callback);
+
+            // Copy commands are supported by any list type, list should match the queue.
+            const auto& commandList = std::static_pointer_cast<GAPI::CopyCommandList>(acquireCommandList(getCommandListType(commandQueue->GetCommandQueueType())));
+            commandList->ReadbackGpuResource(resource, readback->data);
+            commandList->Close();
+
+            readback->syncPoint = Submit(commandQueue, commandList);
+
+            Threading::UniqueLock<Threading::Mutex> lock(readbacksMutex_);
+            pendingReadbacks_.push_back(std::move(readback));
+        }
+
+        void DeviceContext::dispatchReadbacks()
+        {
+            std::vector<std::shared_ptr<PendingReadback>> completed;
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(readbacksMutex_);
+
+                const auto it = std::stable_partition(pendingReadbacks_.begin(), pendingReadbacks_.end(),
+                                                      [](const auto& readback) { return !readback->syncPoint.IsComplete(); });
+
+                completed.assign(std::make_move_iterator(it), std::make_move_iterator(pendingReadbacks_.end()));
+                pendingReadbacks_.erase(it, pendingReadbacks_.end());
+            }
+
+            for (auto& readback : completed)
+                Threading::JobSystem::Instance().Run([readback = std::move(readback)] {
+                    const auto& allocation = readback->data->GetAllocation();
+                    if (allocation->GetMemoryType() == GAPI::MemoryAllocationType::Readback)
+                        allocation->Invalidate();
+
+                    readback->callback(readback->data);
+                });
+        }
+
+        void DeviceContext::ResizeSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain, uint32_t width, uint32_t height)
+        {
+            ASSERT(inited_);
+            ASSERT(swapChain);
+
+            // Minimized window, swap chain keeps its size until restored.
+            if (width == 0 || height == 0)
+                return;
+
+            swapChain->pendingSize_.store(static_cast<uint64_t>(width) << 32 | height, std::memory_order_release);
+        }
+
+        void DeviceContext::ResetSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain, const GAPI::SwapChainDescription& description)
         {
             ASSERT(inited_);
+            ASSERT(swapChain);
 
-            submission_->ExecuteAwait([&swapchain, &description](GAPI::Device& device) {
-                swapchain->Reset(description);
+            swapChain->beginReset(description);
+
+            submission_->ExecuteAsync([submission = submission_.get(), swapChain](GAPI::Device& device) {
+                std::ignore = device;
+                // Back buffers can't be resized while present thread holds them.
+                submission->WaitForPresent();
+                swapChain->reset();
             });
         }
 
@@ -149,7 +516,247 @@ namespace RR
         {
             ASSERT(inited_);
 
-            return submission_->GetIMultiThreadDevice().lock()->AllocateIntermediateResourceData(desc, memoryType, firstSubresourceIndex, numSubresources);
+            return multiThreadDevice_->AllocateIntermediateResourceData(desc, memoryType, firstSubresourceIndex, numSubresources);
+        }
+
+        const GAPI::CommandQueue::SharedPtr& DeviceContext::GetCommandQueue(GAPI::CommandQueueType type, GAPI::CommandQueuePriority priority) const
+        {
+            ASSERT(inited_);
+            ASSERT(type != GAPI::CommandQueueType::Count);
+
+            if (priority == GAPI::CommandQueuePriority::Normal)
+                return commandQueues_[static_cast<size_t>(type)];
+
+            ASSERT_MSG(type == GAPI::CommandQueueType::Compute && priority == GAPI::CommandQueuePriority::High,
+                       "Only compute has owned high priority queue, create others with CreteCommandQueue");
+            return commandQueues_[HighPriorityComputeQueueIndex];
+        }
+
+        GAPI::GpuFrameTimings DeviceContext::GetGpuFrameTimings() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetGpuFrameTimings();
+        }
+
+        GAPI::GpuClockCalibration DeviceContext::GetGpuClockCalibration() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetGpuClockCalibration();
+        }
+
+        GAPI::ShadingRateSupport DeviceContext::GetShadingRateSupport() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetShadingRateSupport();
+        }
+
+        GAPI::MemoryBudget DeviceContext::GetMemoryBudget() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetMemoryBudget();
+        }
+
+        GAPI::MemoryStatistics DeviceContext::GetMemoryStatistics() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetMemoryStatistics();
+        }
+
+        GAPI::DeviceStatistics DeviceContext::GetDeviceStatistics() const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetDeviceStatistics();
+        }
+
+        uint32_t DeviceContext::GetSubmissionQueueDepth() const
+        {
+            ASSERT(inited_);
+
+            return submission_->GetPendingTasksCount();
+        }
+
+        void DeviceContext::SetResidencyPriority(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources, GAPI::ResidencyPriority priority) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->SetResidencyPriority(resources, priority);
+        }
+
+        void DeviceContext::Evict(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->Evict(resources);
+        }
+
+        void DeviceContext::MakeResident(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->MakeResident(resources);
+        }
+
+        GAPI::BufferHandle DeviceContext::CreateBufferHandle(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->CreateBuffer(desc, cpuAccess);
+        }
+
+        GAPI::TextureHandle DeviceContext::CreateTextureHandle(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->CreateTexture(desc, cpuAccess);
+        }
+
+        GAPI::ViewHandle DeviceContext::CreateViewHandle(GAPI::BufferHandle buffer, GAPI::GpuResourceView::ViewType viewType, const GAPI::GpuResourceViewDescription& desc) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->CreateView(buffer, viewType, desc);
+        }
+
+        GAPI::ViewHandle DeviceContext::CreateViewHandle(GAPI::TextureHandle texture, GAPI::GpuResourceView::ViewType viewType, const GAPI::GpuResourceViewDescription& desc) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->CreateView(texture, viewType, desc);
+        }
+
+        void DeviceContext::Release(GAPI::BufferHandle& buffer) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->Release(buffer);
+        }
+
+        void DeviceContext::Release(GAPI::TextureHandle& texture) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->Release(texture);
+        }
+
+        void DeviceContext::Release(GAPI::ViewHandle& view) const
+        {
+            ASSERT(inited_);
+
+            multiThreadDevice_->Release(view);
+        }
+
+        uint32_t DeviceContext::GetBindlessIndex(GAPI::ViewHandle view) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetBindlessIndex(view);
+        }
+
+        uint32_t DeviceContext::GetSamplerIndex(const GAPI::SamplerDescription& description) const
+        {
+            ASSERT(inited_);
+
+            return multiThreadDevice_->GetSamplerIndex(description);
+        }
+
+        void DeviceContext::checkMemoryBudget(const GAPI::Device& device)
+        {
+            const auto& budget = device.GetMemoryBudget();
+            const bool overBudget = budget.local.IsOverBudget();
+
+            if (budget.changesCount == memoryBudgetChanges_ && overBudget == overMemoryBudget_)
+                return;
+
+            if (overBudget && !overMemoryBudget_)
+                Log::Format::Warning("Video memory is over budget, usage: {} MiB, budget: {} MiB\n", budget.local.usageBytes >> 20, budget.local.budgetBytes >> 20);
+
+            memoryBudgetChanges_ = budget.changesCount;
+            overMemoryBudget_ = overBudget;
+            memoryBudgetChanged_ = true;
+        }
+
+        void DeviceContext::profileGpuFrame(const GAPI::Device& device)
+        {
+            const auto& timings = device.GetGpuFrameTimings();
+
+            // Timings stay the same until next frame with markers is read back.
+            if (timings.cpuStartNs == 0 || timings.frameIndex < profiledGpuFrames_)
+                return;
+
+            profiledGpuFrames_ = timings.frameIndex + 1;
+
+            auto& profiler = Profiler::Instance();
+            for (const auto& marker : timings.markers)
+            {
+                const auto startNs = timings.cpuStartNs + static_cast<uint64_t>(marker.startMs * 1e6);
+                profiler.RecordGpuScope(marker.name, startNs, startNs + static_cast<uint64_t>(marker.durationMs * 1e6), marker.depth);
+            }
+        }
+
+        CommandListPool& DeviceContext::getThreadCommandListPool()
+        {
+            struct ThreadPoolCache
+            {
+                const DeviceContext* context = nullptr;
+                CommandListPool* pool = nullptr;
+                uint64_t generation = 0;
+            };
+            // Entry per context used by the thread, there are only a few of them.
+            thread_local std::vector<ThreadPoolCache> caches;
+
+            const auto generation = commandListPoolsGeneration_.load();
+            auto cache = std::find_if(caches.begin(), caches.end(), [this](const ThreadPoolCache& entry) { return entry.context == this; });
+            if (cache != caches.end() && cache->generation == generation)
+                return *cache->pool;
+
+            if (cache == caches.end())
+                cache = caches.insert(caches.end(), ThreadPoolCache { this });
+
+            Threading::UniqueLock<Threading::Mutex> lock(commandListPoolsMutex_);
+
+            const auto& name = fmt::sprintf("Pooled CommandList %u", commandListPools_.size());
+            commandListPools_.push_back(std::make_unique<CommandListPool>(*this, name));
+
+            cache->pool = commandListPools_.back().get();
+            cache->generation = generation;
+
+            return *cache->pool;
+        }
+
+        std::shared_ptr<GAPI::CommandList> DeviceContext::acquireCommandList(GAPI::CommandListType type)
+        {
+            ASSERT(inited_);
+
+            auto commandList = getThreadCommandListPool().Acquire(type, frameIndex_, completedFrames_);
+
+#ifdef ENABLE_COMMAND_CAPTURE
+            // Lists recorded while capture is active are mirrored into streams, submission serializes them.
+            if (submission_->GetCommandCapture().IsActive() && !commandList->GetCaptureStream())
+                commandList->SetCaptureStream(std::make_shared<GAPI::CommandStream>());
+#endif
+
+            return commandList;
+        }
+
+        GAPI::CopyCommandList::SharedPtr DeviceContext::AcquireCopyCommandList()
+        {
+            return std::static_pointer_cast<GAPI::CopyCommandList>(acquireCommandList(GAPI::CommandListType::Copy));
+        }
+
+        GAPI::ComputeCommandList::SharedPtr DeviceContext::AcquireComputeCommandList()
+        {
+            return std::static_pointer_cast<GAPI::ComputeCommandList>(acquireCommandList(GAPI::CommandListType::Compute));
+        }
+
+        GAPI::GraphicsCommandList::SharedPtr DeviceContext::AcquireGraphicsCommandList()
+        {
+            return std::static_pointer_cast<GAPI::GraphicsCommandList>(acquireCommandList(GAPI::CommandListType::Graphics));
         }
 
         GAPI::CopyCommandList::SharedPtr DeviceContext::CreateCopyCommandList(const U8String& name) const
@@ -157,7 +764,7 @@ namespace RR
             ASSERT(inited_);
 
             auto& resource = GAPI::CopyCommandList::Create(name);
-            submission_->GetIMultiThreadDevice().lock()->InitCommandList(*resource.get());
+            multiThreadDevice_->InitCommandList(*resource.get());
 
             return resource;
         }
@@ -167,7 +774,7 @@ namespace RR
             ASSERT(inited_);
 
             auto& resource = GAPI::ComputeCommandList::Create(name);
-            submission_->GetIMultiThreadDevice().lock()->InitCommandList(*resource.get());
+            multiThreadDevice_->InitCommandList(*resource.get());
 
             return resource;
         }
@@ -177,17 +784,30 @@ namespace RR
             ASSERT(inited_);
 
             auto& resource = GAPI::GraphicsCommandList::Create(name);
-            submission_->GetIMultiThreadDevice().lock()->InitCommandList(*resource.get());
+            multiThreadDevice_->InitCommandList(*resource.get());
+
+            return resource;
+        }
+
+        GAPI::BundleCommandList::SharedPtr DeviceContext::CreateBundleCommandList(const U8String& name) const
+        {
+            ASSERT(inited_);
+
+            auto& resource = GAPI::BundleCommandList::Create(name);
+            multiThreadDevice_->InitCommandList(*resource.get());
 
             return resource;
         }
 
-        GAPI::CommandQueue::SharedPtr DeviceContext::CreteCommandQueue(GAPI::CommandQueueType type, const U8String& name) const
+        GAPI::CommandQueue::SharedPtr DeviceContext::CreteCommandQueue(GAPI::CommandQueueType type, const U8String& name, GAPI::CommandQueuePriority priority) const
         {
             ASSERT(inited_)
 
-            auto& resource = GAPI::CommandQueue::Create(type, name);
-            submission_->GetIMultiThreadDevice().lock()->InitCommandQueue(*resource.get());
+            auto& resource = GAPI::CommandQueue::Create(type, priority, name);
+            multiThreadDevice_->InitCommandQueue(*resource.get());
+
+            resource->timelineFence_ = CreateFence(fmt::sprintf("%s timeline", name));
+            resource->timelineValue_ = resource->timelineFence_->GetCpuValue();
 
             return resource;
         }
@@ -197,7 +817,53 @@ namespace RR
             ASSERT(inited_);
 
             auto& resource = GAPI::Fence::Create(name);
-            submission_->GetIMultiThreadDevice().lock()->InitFence(*resource.get());
+            multiThreadDevice_->InitFence(*resource.get());
+
+            return resource;
+        }
+
+        GAPI::Fence::SharedPtr DeviceContext::CreateSharedFence(const U8String& name) const
+        {
+            ASSERT(inited_);
+
+            auto& resource = GAPI::Fence::Create(name);
+            multiThreadDevice_->InitSharedFence(*resource.get());
+            resource->timelineValue_ = resource->GetCpuValue();
+
+            return resource;
+        }
+
+        GAPI::Fence::SharedPtr DeviceContext::OpenSharedFence(const GAPI::Fence::SharedPtr& sharedFence, const U8String& name) const
+        {
+            ASSERT(inited_);
+            ASSERT(sharedFence);
+
+            auto& resource = GAPI::Fence::Create(name);
+            multiThreadDevice_->OpenSharedFence(*resource.get(), *sharedFence);
+
+            return resource;
+        }
+
+        GAPI::Buffer::SharedPtr DeviceContext::CreateSharedBuffer(const GAPI::GpuResourceDescription& desc, const U8String& name) const
+        {
+            ASSERT(inited_);
+
+            auto& resource = GAPI::Buffer::Create(desc, GAPI::GpuResourceCpuAccess::None, name);
+            resource->deviceContext_ = this;
+            multiThreadDevice_->InitSharedBuffer(*resource.get());
+
+            return resource;
+        }
+
+        GAPI::Buffer::SharedPtr DeviceContext::OpenSharedBuffer(const GAPI::Buffer::SharedPtr& sharedBuffer, const U8String& name) const
+        {
+            ASSERT(inited_);
+            ASSERT(sharedBuffer);
+            ASSERT(sharedBuffer->deviceContext_ != this);
+
+            auto& resource = GAPI::Buffer::Create(sharedBuffer->GetDescription(), GAPI::GpuResourceCpuAccess::None, name);
+            resource->deviceContext_ = this;
+            multiThreadDevice_->OpenSharedBuffer(*resource.get(), *sharedBuffer);
 
             return resource;
         }
@@ -210,7 +876,8 @@ namespace RR
             ASSERT(inited_);
 
             auto& resource = GAPI::Buffer::Create(desc, cpuAccess, name);
-            submission_->GetIMultiThreadDevice().lock()->InitBuffer(*resource.get());
+            resource->deviceContext_ = this;
+            multiThreadDevice_->InitBuffer(*resource.get());
 
             return resource;
         }
@@ -218,12 +885,30 @@ namespace RR
         GAPI::Texture::SharedPtr DeviceContext::CreateTexture(
             const GAPI::GpuResourceDescription& desc,
             GAPI::GpuResourceCpuAccess cpuAccess,
+            const U8String& name,
+            GAPI::GpuResourceAllocationHint allocationHint) const
+        {
+            ASSERT(inited_);
+
+            auto& resource = GAPI::Texture::Create(desc, cpuAccess, name, allocationHint);
+            resource->deviceContext_ = this;
+            multiThreadDevice_->InitTexture(*resource.get());
+
+            return resource;
+        }
+
+        GAPI::Texture::SharedPtr DeviceContext::CreateTransientTexture(
+            const GAPI::GpuResourceDescription& desc,
+            uint32_t firstUse,
+            uint32_t lastUse,
             const U8String& name) const
         {
             ASSERT(inited_);
+            ASSERT(firstUse <= lastUse);
 
-            auto& resource = GAPI::Texture::Create(desc, cpuAccess, name);
-            submission_->GetIMultiThreadDevice().lock()->InitTexture(*resource.get());
+            auto& resource = GAPI::Texture::Create(desc, GAPI::GpuResourceCpuAccess::None, name);
+            resource->deviceContext_ = this;
+            multiThreadDevice_->InitTransientTexture(*resource.get(), firstUse, lastUse);
 
             return resource;
         }
@@ -240,6 +925,7 @@ namespace RR
             ASSERT(desc.GetNumSubresources() == 1);
 
             auto& resource = GAPI::Texture::Create(desc, GAPI::GpuResourceCpuAccess::None, name);
+            resource->deviceContext_ = this;
             swapchain->InitBackBufferTexture(backBufferIndex, resource);
 
             return resource;
@@ -250,11 +936,14 @@ namespace RR
             const GAPI::GpuResourceViewDescription& desc) const
         {
             ASSERT(inited_);
+            ASSERT(gpuResource);
 
-            auto& resource = GAPI::ShaderResourceView::Create(gpuResource, desc);
-            submission_->GetIMultiThreadDevice().lock()->InitGpuResourceView(*resource.get());
+            return gpuResource->getOrCreateView(gpuResource->srvs_, desc, [&] {
+                auto& resource = GAPI::ShaderResourceView::Create(gpuResource, desc);
+                multiThreadDevice_->InitGpuResourceView(*resource.get());
 
-            return resource;
+                return resource;
+            });
         }
 
         GAPI::DepthStencilView::SharedPtr DeviceContext::CreateDepthStencilView(
@@ -262,11 +951,14 @@ namespace RR
             const GAPI::GpuResourceViewDescription& desc) const
         {
             ASSERT(inited_);
+            ASSERT(texture);
 
-            auto& resource = GAPI::DepthStencilView::Create(texture, desc);
-            submission_->GetIMultiThreadDevice().lock()->InitGpuResourceView(*resource.get());
+            return texture->getOrCreateView(texture->dsvs_, desc, [&] {
+                auto& resource = GAPI::DepthStencilView::Create(texture, desc);
+                multiThreadDevice_->InitGpuResourceView(*resource.get());
 
-            return resource;
+                return resource;
+            });
         }
 
         GAPI::RenderTargetView::SharedPtr DeviceContext::CreateRenderTargetView(
@@ -274,11 +966,14 @@ namespace RR
             const GAPI::GpuResourceViewDescription& desc) const
         {
             ASSERT(inited_);
+            ASSERT(texture);
 
-            auto& resource = GAPI::RenderTargetView::Create(texture, desc);
-            submission_->GetIMultiThreadDevice().lock()->InitGpuResourceView(*resource.get());
+            return texture->getOrCreateView(texture->rtvs_, desc, [&] {
+                auto& resource = GAPI::RenderTargetView::Create(texture, desc);
+                multiThreadDevice_->InitGpuResourceView(*resource.get());
 
-            return resource;
+                return resource;
+            });
         }
 
         GAPI::UnorderedAccessView::SharedPtr DeviceContext::CreateUnorderedAccessView(
@@ -286,19 +981,91 @@ namespace RR
             const GAPI::GpuResourceViewDescription& desc) const
         {
             ASSERT(inited_);
+            ASSERT(gpuResource);
+
+            return gpuResource->getOrCreateView(gpuResource->uavs_, desc, [&] {
+                auto& resource = GAPI::UnorderedAccessView::Create(gpuResource, desc);
+                multiThreadDevice_->InitGpuResourceView(*resource.get());
+
+                return resource;
+            });
+        }
+
+        GAPI::PipelineState::SharedPtr DeviceContext::CreatePipelineState(const GAPI::PipelineStateDescription& desc, const U8String& name) const
+        {
+            ASSERT(inited_);
+
+            auto& resource = GAPI::PipelineState::Create(desc, name);
+            multiThreadDevice_->InitPipelineState(*resource.get());
+            resource->isReady_.store(true, std::memory_order_release);
+
+            return resource;
+        }
+
+        GAPI::PipelineState::SharedPtr DeviceContext::CreatePipelineStateAsync(const GAPI::PipelineStateDescription& desc, const GAPI::PipelineState::SharedPtr& fallback, const U8String& name) const
+        {
+            ASSERT(inited_);
+
+            auto resource = GAPI::PipelineState::Create(desc, name, fallback);
+            const auto device = submission_->GetIMultiThreadDevice();
+
+            // Library load is cheap, so cached states are never drawn with fallback.
+            if (multiThreadDevice_->IsPipelineStateCached(desc))
+            {
+                multiThreadDevice_->InitPipelineState(*resource.get());
+                resource->isReady_.store(true, std::memory_order_release);
+
+                return resource;
+            }
 
-            auto& resource = GAPI::UnorderedAccessView::Create(gpuResource, desc);
-            submission_->GetIMultiThreadDevice().lock()->InitGpuResourceView(*resource.get());
+            Threading::JobSystem::Instance().Run([device, resource] {
+                // Device could be terminated while job was queued.
+                const auto& lockedDevice = device.lock();
+                if (!lockedDevice)
+                    return;
+
+                lockedDevice->InitPipelineState(*resource.get());
+                resource->isReady_.store(true, std::memory_order_release);
+            });
 
             return resource;
         }
 
+        std::vector<GAPI::PipelineState::SharedPtr> DeviceContext::PrecompilePipelineStates(const std::vector<GAPI::PipelineStateDescription>& descriptions) const
+        {
+            ASSERT(inited_);
+
+            std::vector<GAPI::PipelineState::SharedPtr> pipelineStates;
+            pipelineStates.reserve(descriptions.size());
+
+            for (const auto& description : descriptions)
+                pipelineStates.push_back(CreatePipelineStateAsync(description));
+
+            return pipelineStates;
+        }
+
         GAPI::SwapChain::SharedPtr DeviceContext::CreateSwapchain(const GAPI::SwapChainDescription& description, const U8String& name) const
         {
             ASSERT(inited_);
 
             auto& resource = GAPI::SwapChain::Create(description, name);
-            submission_->GetIMultiThreadDevice().lock()->InitSwapChain(*resource.get());
+            resource->deviceContext_ = this;
+            multiThreadDevice_->InitSwapChain(*resource.get());
+
+            return resource;
+        }
+
+        GAPI::QueryPool::SharedPtr DeviceContext::CreateQueryPool(const GAPI::QueryPoolDescription& description, const U8String& name) const
+        {
+            ASSERT(inited_);
+            ASSERT(description.count > 0);
+
+            // Resolve target, never bound to shaders.
+            const auto resultBufferDesc = GAPI::GpuResourceDescription::Buffer(description.count * description.GetResultSize(), GAPI::GpuResourceBindFlags::None);
+            const auto& resultBuffer = CreateBuffer(resultBufferDesc, GAPI::GpuResourceCpuAccess::None, fmt::sprintf("%s results", name));
+
+            auto& resource = GAPI::QueryPool::Create(description, resultBuffer, name);
+            multiThreadDevice_->InitQueryPool(*resource.get());
 
             return resource;
         }
@@ -1,38 +1,100 @@
 #pragma once
 
+#include "gapi/Device.hpp"
+#include "gapi/Fence.hpp"
 #include "gapi/ForwardDeclarations.hpp"
 #include "gapi/GpuResource.hpp"
+#include "gapi/Handles.hpp"
+#include "gapi/MemoryBudget.hpp"
 
-// TODO remove
-#include "common/Singleton.hpp"
+#include "common/EventProvider.hpp"
+
+#include "common/threading/Mutex.hpp"
 #include "render/Submission.hpp"
 
+#include <array>
+#include <atomic>
+#include <functional>
+
 namespace RR
 {
     namespace Render
     {
         class Submission;
+        class CommandListPool;
 
-        // Todo thread safety?
-        class DeviceContext final : public Singleton<DeviceContext>
+        // Owns device and its submission thread. Contexts are independent of each other, resources and
+        // command lists should be used only with the context created them.
+        // Create* and handle methods are safe to call from any number of threads concurrently: they bypass submission
+        // thread, descriptor allocation is lock-free and D3D12MA allocator is internally synchronized.
+        class DeviceContext final : private NonCopyable, NonMovable
         {
         public:
+            using ReadbackCallback = std::function<void(const std::shared_ptr<GAPI::CpuResourceData>&)>;
+
             DeviceContext();
             ~DeviceContext();
 
             static constexpr uint32_t MaxPossible = 0xFFFFFF;
+            static constexpr uint32_t DefaultGpuFramesBuffered = 3;
 
-            void Init();
+            // Adapters device context could be created on. Multi GPU nodes run one context per adapter side by side.
+            static std::vector<GAPI::AdapterDescription> EnumerateAdapters();
+
+            // More frames in flight trade input latency for throughput. Limited by GAPI::MAX_GPU_FRAMES_BUFFERED.
+            // Empty pipeline cache path disables on-disk pipeline states persistence.
+            // Present thread takes blocking presents off the submission thread, swap chains need 3 back buffers then.
+            void Init(uint32_t gpuFramesBuffered = DefaultGpuFramesBuffered, const U8String& pipelineCachePath = "",
+                      uint32_t adapterIndex = GAPI::Device::Description::AnyAdapter, bool enablePresentThread = false);
             void Terminate();
 
-            void Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& CommandList);
+            // Returned sync point is reached once GPU executed submitted command lists.
+            GAPI::GpuSyncPoint Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& CommandList);
+            GAPI::GpuSyncPoint Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::vector<std::shared_ptr<GAPI::CommandList>>& commandLists);
+            // Queue waits on GPU for dependencies from other queues before executing command lists.
+            GAPI::GpuSyncPoint Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::vector<std::shared_ptr<GAPI::CommandList>>& commandLists, const std::vector<GAPI::GpuSyncPoint>& dependencies);
+            // Sync point after all work submitted to the queue so far.
+            GAPI::GpuSyncPoint Signal(const std::shared_ptr<GAPI::CommandQueue>& commandQueue);
+            // Next value of shared fence created by this context. Other contexts wait for it on their opened fence.
+            GAPI::GpuSyncPoint Signal(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Fence>& sharedFence);
+            // GPU side wait of the queue for sync point, CPU isn't blocked.
+            void Wait(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const GAPI::GpuSyncPoint& syncPoint);
+            // Reserved textures residency changes, ordered with work submitted to the queue.
+            void UpdateTileMappings(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, std::vector<GAPI::TileMappingUpdate>&& updates);
+            // Resources are in COMMON state between command lists, so they are shared by queues without barriers.
+            // Writer records sync point of its submission, the first use on any other queue inserts single GPU wait for it.
+            void ReleaseQueueOwnership(const std::shared_ptr<GAPI::GpuResource>& resource, const GAPI::GpuSyncPoint& syncPoint);
+            // Call before submitting work which uses resource to the queue.
+            void AcquireQueueOwnership(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::GpuResource>& resource);
             void Present(const std::shared_ptr<GAPI::SwapChain>& swapChain);
+            // Multiple windows rendered within one frame on the same queue share its render graph and transient resources,
+            // only their presents are issued together at the end of the frame.
+            void Present(const std::vector<std::shared_ptr<GAPI::SwapChain>>& swapChains);
+            // Blocks until swap chain is ready for the next frame. Call before input sampling to minimize latency.
+            void WaitForNextFrame(const std::shared_ptr<GAPI::SwapChain>& swapChain);
             void WaitForGpu(const std::shared_ptr<GAPI::CommandQueue>& commandQueue);
+            // Frame is completed once all owned queues and commandQueue reached the end of the frame.
             void MoveToNextFrame(const std::shared_ptr<GAPI::CommandQueue>& commandQueue);
-            void ResetSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapchain, GAPI::SwapChainDescription& description);
+            // Any thread, e.g. from window resize events. Requests are coalesced, only the latest size is applied by the next Present.
+            void ResizeSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain, uint32_t width, uint32_t height);
+            // Called by presenting thread. Doesn't block: swap chain is resized on submission thread after frames queued before,
+            // back buffers are available once it's done. Waits only if previous reset is still in flight.
+            void ResetSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain, const GAPI::SwapChainDescription& description);
+
+            // Writes command lists, resources and uploads of next framesCount frames to file for CommandReplay.
+            // Capture starts with the next frame. Requires ENABLE_COMMAND_CAPTURE, false if it's off or capture is in progress.
+            bool BeginCommandCapture(const U8String& path, uint32_t framesCount);
 
-            void ExecuteAsync(const Submission::CallbackFunction&& function);
-            void ExecuteAwait(const Submission::CallbackFunction&& function);
+            void ExecuteAsync(Submission::CallbackFunction&& function);
+            void ExecuteAwait(Submission::CallbackFunction&& function);
+
+            // Copies subresources to readback ring after work already submitted to the queue. Never blocks the caller.
+            // Callback is run on job system worker by the first MoveToNextFrame after GPU is done with the copy.
+            void ReadbackAsync(const std::shared_ptr<GAPI::CommandQueue>& commandQueue,
+                               const std::shared_ptr<GAPI::GpuResource>& resource,
+                               ReadbackCallback&& callback,
+                               uint32_t firstSubresource = 0,
+                               uint32_t numSubresources = MaxPossible);
 
             std::shared_ptr<GAPI::CpuResourceData> AllocateIntermediateResourceData(
                 const GAPI::GpuResourceDescription& desc,
@@ -40,29 +102,157 @@ namespace RR
                 uint32_t firstSubresourceIndex = 0,
                 uint32_t numSubresources = MaxPossible) const;
 
+            // Hierarchical GPU markers timings of the latest frame completed on GPU.
+            GAPI::GpuFrameTimings GetGpuFrameTimings() const;
+            // Maps GPU timestamps onto CPU steady clock, see Common::Time::Calibrate.
+            GAPI::GpuClockCalibration GetGpuClockCalibration() const;
+            // Tier and tile size of variable rate shading, see GraphicsCommandList::SetShadingRate.
+            GAPI::ShadingRateSupport GetShadingRateSupport() const;
+
+            // Current process usage against OS budget, safe to query every frame.
+            GAPI::MemoryBudget GetMemoryBudget() const;
+            GAPI::MemoryStatistics GetMemoryStatistics() const;
+            // Descriptor heaps occupancy and deferred releases backlog, safe to query every frame.
+            GAPI::DeviceStatistics GetDeviceStatistics() const;
+            // Tasks queued for submission thread, grows when the thread falls behind producers.
+            uint32_t GetSubmissionQueueDepth() const;
+            // Streamed resources with lower priority are paged out first on memory pressure.
+            void SetResidencyPriority(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources, GAPI::ResidencyPriority priority) const;
+            // Resources shouldn't be referenced by frames in flight. Evicted resources should be made resident before next use.
+            void Evict(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources) const;
+            // Blocks until resources are paged in.
+            void MakeResident(const std::vector<std::shared_ptr<GAPI::GpuResource>>& resources) const;
+
+            // Queues owned by device context. Throttled against frames in flight together with frame queue.
+            // Compute has a high priority queue as well, for latency critical work consumed by the same frame, e.g. culling,
+            // so it isn't delayed by long running background compute on the normal one. Other types have normal priority only.
+            const std::shared_ptr<GAPI::CommandQueue>& GetCommandQueue(GAPI::CommandQueueType type,
+                                                                       GAPI::CommandQueuePriority priority = GAPI::CommandQueuePriority::Normal) const;
+
+            uint32_t GetGpuFramesBuffered() const { return gpuFramesBuffered_; }
+            // Frames the caller of MoveToNextFrame records ahead of submission thread, clamped to [1, gpuFramesBuffered].
+            // Lower limit trades throughput for input latency and memory of queued tasks. Any thread, applied by the next MoveToNextFrame.
+            void SetMaxFramesAhead(uint32_t framesCount);
+            uint32_t GetMaxFramesAhead() const { return maxFramesAhead_.load(std::memory_order_relaxed); }
+
+            // Ready to record command lists from calling thread pool. Should be submitted in current frame.
+            std::shared_ptr<GAPI::CopyCommandList> AcquireCopyCommandList();
+            std::shared_ptr<GAPI::ComputeCommandList> AcquireComputeCommandList();
+            std::shared_ptr<GAPI::GraphicsCommandList> AcquireGraphicsCommandList();
+
             std::shared_ptr<GAPI::CopyCommandList> CreateCopyCommandList(const U8String& name) const;
             std::shared_ptr<GAPI::ComputeCommandList> CreateComputeCommandList(const U8String& name) const;
             std::shared_ptr<GAPI::GraphicsCommandList> CreateGraphicsCommandList(const U8String& name) const;
-            std::shared_ptr<GAPI::CommandQueue> CreteCommandQueue(GAPI::CommandQueueType type, const U8String& name) const;
+            // Bundles outlive frames, so they aren't pooled. See BundleCache.
+            std::shared_ptr<GAPI::BundleCommandList> CreateBundleCommandList(const U8String& name) const;
+            std::shared_ptr<GAPI::CommandQueue> CreteCommandQueue(GAPI::CommandQueueType type, const U8String& name,
+                                                                  GAPI::CommandQueuePriority priority = GAPI::CommandQueuePriority::Normal) const;
             std::shared_ptr<GAPI::Fence> CreateFence(const U8String& name = "") const;
+            // Cross adapter objects are created by one context and opened by other contexts of the process, e.g. to exchange
+            // results of work split between GPUs. Producer copies into shared buffer and signals shared fence,
+            // consumer waits for signaled value on its opened fence and copies out of its opened buffer.
+            std::shared_ptr<GAPI::Fence> CreateSharedFence(const U8String& name = "") const;
+            std::shared_ptr<GAPI::Fence> OpenSharedFence(const std::shared_ptr<GAPI::Fence>& sharedFence, const U8String& name = "") const;
+            std::shared_ptr<GAPI::Buffer> CreateSharedBuffer(const GAPI::GpuResourceDescription& desc, const U8String& name = "") const;
+            std::shared_ptr<GAPI::Buffer> OpenSharedBuffer(const std::shared_ptr<GAPI::Buffer>& sharedBuffer, const U8String& name = "") const;
             std::shared_ptr<GAPI::Buffer> CreateBuffer(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess = GAPI::GpuResourceCpuAccess::None, const U8String& name = "") const;
-            std::shared_ptr<GAPI::Texture> CreateTexture(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess = GAPI::GpuResourceCpuAccess::None, const U8String& name = "") const;
+            std::shared_ptr<GAPI::Texture> CreateTexture(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess = GAPI::GpuResourceCpuAccess::None, const U8String& name = "",
+                                                         GAPI::GpuResourceAllocationHint allocationHint = GAPI::GpuResourceAllocationHint::Default) const;
+            // Frame-local texture aliased in memory with transient textures of non-overlapping [firstUse, lastUse] pass range.
+            // Valid only within current frame. Content is undefined on first use, render targets should be cleared first.
+            std::shared_ptr<GAPI::Texture> CreateTransientTexture(const GAPI::GpuResourceDescription& desc, uint32_t firstUse, uint32_t lastUse, const U8String& name = "") const;
             std::shared_ptr<GAPI::Texture> CreateSwapChainBackBuffer(const std::shared_ptr<GAPI::SwapChain>& swapchain, uint32_t backBufferIndex, const GAPI::GpuResourceDescription& desc, const U8String& name = "") const;
+            // Views are cached per resource, requests with equal description return the same view.
             std::shared_ptr<GAPI::ShaderResourceView> CreateShaderResourceView(const std::shared_ptr<GAPI::GpuResource>& resource, const GAPI::GpuResourceViewDescription& desc) const;
             std::shared_ptr<GAPI::DepthStencilView> CreateDepthStencilView(const std::shared_ptr<GAPI::Texture>& texture, const GAPI::GpuResourceViewDescription& desc) const;
             std::shared_ptr<GAPI::RenderTargetView> CreateRenderTargetView(const std::shared_ptr<GAPI::Texture>& texture, const GAPI::GpuResourceViewDescription& desc) const;
             std::shared_ptr<GAPI::UnorderedAccessView> CreateUnorderedAccessView(const std::shared_ptr<GAPI::GpuResource>& resource, const GAPI::GpuResourceViewDescription& desc) const;
+            // Pipeline states with the same description share compiled state.
+            std::shared_ptr<GAPI::PipelineState> CreatePipelineState(const GAPI::PipelineStateDescription& desc, const U8String& name = "") const;
+            // Doesn't block on compilation unless state is in pipeline cache, job system compiles it instead.
+            // Until then PipelineState::Resolve returns the fallback if it's ready, otherwise draws should be skipped.
+            std::shared_ptr<GAPI::PipelineState> CreatePipelineStateAsync(const GAPI::PipelineStateDescription& desc, const std::shared_ptr<GAPI::PipelineState>& fallback = nullptr, const U8String& name = "") const;
+            // Startup warm up. States stored in pipeline cache are loaded right away, others are compiled in background.
+            std::vector<std::shared_ptr<GAPI::PipelineState>> PrecompilePipelineStates(const std::vector<GAPI::PipelineStateDescription>& descriptions) const;
             std::shared_ptr<GAPI::SwapChain> CreateSwapchain(const GAPI::SwapChainDescription& description, const U8String& name = "") const;
+            // Results are read back from QueryPool::GetResultBuffer with ReadbackAsync once command lists resolved them.
+            std::shared_ptr<GAPI::QueryPool> CreateQueryPool(const GAPI::QueryPoolDescription& description, const U8String& name = "") const;
+
+            // Pooled unnamed objects for hot paths creating many resources per frame. Handles should be released explicitly.
+            GAPI::BufferHandle CreateBufferHandle(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess = GAPI::GpuResourceCpuAccess::None) const;
+            GAPI::TextureHandle CreateTextureHandle(const GAPI::GpuResourceDescription& desc, GAPI::GpuResourceCpuAccess cpuAccess = GAPI::GpuResourceCpuAccess::None) const;
+            GAPI::ViewHandle CreateViewHandle(GAPI::BufferHandle buffer, GAPI::GpuResourceView::ViewType viewType, const GAPI::GpuResourceViewDescription& desc) const;
+            GAPI::ViewHandle CreateViewHandle(GAPI::TextureHandle texture, GAPI::GpuResourceView::ViewType viewType, const GAPI::GpuResourceViewDescription& desc) const;
+            void Release(GAPI::BufferHandle& buffer) const;
+            void Release(GAPI::TextureHandle& texture) const;
+            void Release(GAPI::ViewHandle& view) const;
+            uint32_t GetBindlessIndex(GAPI::ViewHandle view) const;
+            // Sampler binding is an index lookup, samplers are created once per distinct description.
+            uint32_t GetSamplerIndex(const GAPI::SamplerDescription& description) const;
+
+        public:
+            // Fired from MoveToNextFrame once OS changed budget or local memory went over or back under it.
+            Event<void(const GAPI::MemoryBudget&)> OnMemoryBudgetChanged;
 
         private:
-            // TODO sync with GPU_MAX
-            static constexpr int GpuFramesBuffered = 3;
+            // Forwards GPU markers of the latest read back frame to CPU profiler. Called on submission thread.
+            void profileGpuFrame(const GAPI::Device& device);
+            // Flags budget change to be reported by next MoveToNextFrame. Called on submission thread.
+            void checkMemoryBudget(const GAPI::Device& device);
+            // Hands readbacks completed on GPU over to job system. Called on submission thread.
+            void dispatchReadbacks();
+            // Moves to the next back buffer and applies requested resize once present is queued.
+            void advanceSwapChain(const std::shared_ptr<GAPI::SwapChain>& swapChain);
+            // Runs queued jobs while waiting, parks once there are none.
+            void waitForSubmittedFrames(uint64_t framesCount);
+            CommandListPool& getThreadCommandListPool();
+            std::shared_ptr<GAPI::CommandList> acquireCommandList(GAPI::CommandListType type);
+
+        private:
+            // Written by caller of MoveToNextFrame, read by submission thread gpuFramesBuffered_ - 1 frames later.
+            // Double amount of slots guarantees slot isn't overwritten while being read.
+            static constexpr int MaxFrameSyncSlotsCount = GAPI::MAX_GPU_FRAMES_BUFFERED * 2;
 
             bool inited_ = false;
-            uint32_t frameIndex_ = 0;
+            uint32_t gpuFramesBuffered_ = 0;
+            std::atomic<uint64_t> frameIndex_ = 0;
+            // Frames with index below are completed on GPU.
+            std::atomic<uint64_t> completedFrames_ = 0;
+            // Frames with index below are processed by submission thread.
+            std::atomic<uint64_t> submittedFrames_ = 0;
+            // Bumped along with submittedFrames_, caller of MoveToNextFrame parks on it.
+            std::atomic<uint32_t> submittedFramesWord_ = 0;
+            std::atomic<uint32_t> maxFramesAhead_ = 0;
+            // Frames with index below are forwarded to profiler, accessed by submission thread only.
+            uint64_t profiledGpuFrames_ = 0;
+            // Budget state reported last time, accessed by submission thread only.
+            uint64_t memoryBudgetChanges_ = 0;
+            bool overMemoryBudget_ = false;
+            std::atomic<bool> memoryBudgetChanged_ = false;
+
+            struct PendingReadback final
+            {
+                GAPI::GpuSyncPoint syncPoint;
+                std::shared_ptr<GAPI::CpuResourceData> data;
+                ReadbackCallback callback;
+            };
+
+            Threading::Mutex readbacksMutex_;
+            std::vector<std::shared_ptr<PendingReadback>> pendingReadbacks_;
+
+            Threading::Mutex commandListPoolsMutex_;
+            // Unique across contexts, changes on Init and Terminate to invalidate thread caches of pools.
+            std::atomic<uint64_t> commandListPoolsGeneration_ = 0;
+            std::vector<std::unique_ptr<CommandListPool>> commandListPools_;
 
-            std::shared_ptr<GAPI::Fence> fence_;
+            // Queue per type, followed by high priority compute queue.
+            static constexpr size_t HighPriorityComputeQueueIndex = static_cast<size_t>(GAPI::CommandQueueType::Count);
+            std::array<std::shared_ptr<GAPI::CommandQueue>, HighPriorityComputeQueueIndex + 1> commandQueues_;
+            std::array<std::vector<GAPI::GpuSyncPoint>, MaxFrameSyncSlotsCount> frameSyncPoints_;
             std::unique_ptr<Submission> submission_;
+            // Owned by submission, valid between Init and Terminate. Creation calls use it directly,
+            // so concurrent creating threads don't contend on weak pointer reference count.
+            GAPI::IMultiThreadDevice* multiThreadDevice_ = nullptr;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "FrameExporter.hpp"
+
+#include "gapi/CommandQueue.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/TexelConversion.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            using Image = std::vector<uint8_t>;
+
+            class ImageBuilder final
+            {
+            public:
+                explicit ImageBuilder(Image& image) : image_(image) { }
+
+                template <typename T>
+                void Write(T value)
+                {
+                    static_assert(std::is_trivially_copyable<T>::value);
+
+                    // Little endian, same as every file format below except PNG chunk fields.
+                    const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+                    image_.insert(image_.end(), bytes, bytes + sizeof(T));
+                }
+
+                void WriteBigEndian(uint32_t value)
+                {
+                    for (int32_t shift = 24; shift >= 0; shift -= 8)
+                        image_.push_back(static_cast<uint8_t>(value >> shift));
+                }
+
+                void Write(const void* data, size_t size)
+                {
+                    const auto bytes = static_cast<const uint8_t*>(data);
+                    image_.insert(image_.end(), bytes, bytes + size);
+                }
+
+                void WriteString(const char* string) { Write(string, std::strlen(string) + 1); }
+
+                size_t GetSize() const { return image_.size(); }
+                uint8_t* GetData() { return image_.data(); }
+
+            private:
+                Image& image_;
+            };
+
+            bool isRGBA8(GAPI::GpuResourceFormat format) { return format == GAPI::GpuResourceFormat::RGBA8Unorm || format == GAPI::GpuResourceFormat::RGBA8UnormSrgb; }
+            bool isBGRA8(GAPI::GpuResourceFormat format) { return format == GAPI::GpuResourceFormat::BGRA8Unorm || format == GAPI::GpuResourceFormat::BGRA8UnormSrgb; }
+            bool isFloat(GAPI::GpuResourceFormat format) { return format == GAPI::GpuResourceFormat::RGBA16Float || format == GAPI::GpuResourceFormat::RGBA32Float; }
+
+            const char* getExtension(FrameExporter::ImageFormat imageFormat)
+            {
+                switch (imageFormat)
+                {
+                    case FrameExporter::ImageFormat::Png: return "png";
+                    case FrameExporter::ImageFormat::Exr: return "exr";
+                    case FrameExporter::ImageFormat::Dds: return "dds";
+                    default: ASSERT_MSG(false, "Unknown image format"); return "";
+                }
+            }
+
+            uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+            {
+                static const auto table = []() {
+                    std::array<uint32_t, 256> result;
+                    for (uint32_t index = 0; index < 256; index++)
+                    {
+                        uint32_t value = index;
+                        for (uint32_t bit = 0; bit < 8; bit++)
+                            value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+                        result[index] = value;
+                    }
+                    return result;
+                }();
+
+                crc = ~crc;
+                for (size_t index = 0; index < size; index++)
+                    crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+
+                return ~crc;
+            }
+
+            uint32_t adler32(const uint8_t* data, size_t size)
+            {
+                // Largest count of bytes sums can't overflow before modulo.
+                constexpr size_t ChunkSize = 5552;
+                uint32_t a = 1, b = 0;
+
+                while (size > 0)
+                {
+                    const size_t count = std::min(size, ChunkSize);
+                    for (size_t index = 0; index < count; index++)
+                    {
+                        a += data[index];
+                        b += a;
+                    }
+
+                    a %= 65521;
+                    b %= 65521;
+                    data += count;
+                    size -= count;
+                }
+
+                return (b << 16) | a;
+            }
+
+            // Source row converted to RGBA8, texels are stored as is, float ones get sRGB encoded.
+            void convertRowToRGBA8(GAPI::GpuResourceFormat format, const uint8_t* source, uint32_t width, uint8_t* dest, std::vector<float>& scratch)
+            {
+                if (isRGBA8(format))
+                    std::memcpy(dest, source, width * sizeof(uint32_t));
+                else if (isBGRA8(format))
+                    GAPI::TexelConversion::SwizzleRowRGBA8ToBGRA8(reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(dest), width);
+                else
+                {
+                    const float* texels = reinterpret_cast<const float*>(source);
+                    if (format == GAPI::GpuResourceFormat::RGBA16Float)
+                    {
+                        scratch.resize(width * 4);
+                        GAPI::TexelConversion::ConvertRowRGBA16FloatToRGBA32Float(reinterpret_cast<const uint16_t*>(source), scratch.data(), width);
+                        texels = scratch.data();
+                    }
+
+                    GAPI::TexelConversion::EncodeRowRGBA32FloatToRGBA8Srgb(texels, reinterpret_cast<uint32_t*>(dest), width, false);
+                }
+            }
+
+            void encodePng(const GAPI::CpuResourceData::SubresourceFootprint& footprint, GAPI::GpuResourceFormat format, const uint8_t* data, Image& image)
+            {
+                const uint32_t width = footprint.width;
+                const uint32_t height = footprint.height;
+
+                // Filter type byte starts every row, filtering is skipped as stored blocks don't benefit from it.
+                const size_t rowSize = 1 + width * sizeof(uint32_t);
+                std::vector<uint8_t> raw(rowSize * height);
+                std::vector<float> scratch;
+                for (uint32_t row = 0; row < height; row++)
+                {
+                    raw[row * rowSize] = 0;
+                    convertRowToRGBA8(format, data + row * footprint.rowPitch, width, raw.data() + row * rowSize + 1, scratch);
+                }
+
+                ImageBuilder builder(image);
+                const auto writeChunk = [&builder](const char* type, const auto& writeData) {
+                    const size_t lengthOffset = builder.GetSize();
+                    builder.WriteBigEndian(0);
+                    builder.Write(type, 4);
+
+                    writeData();
+
+                    const size_t dataOffset = lengthOffset + 8;
+                    const uint32_t length = static_cast<uint32_t>(builder.GetSize() - dataOffset);
+                    for (uint32_t index = 0; index < 4; index++)
+                        builder.GetData()[lengthOffset + index] = static_cast<uint8_t>(length >> (24 - index * 8));
+
+                    builder.WriteBigEndian(crc32(builder.GetData() + lengthOffset + 4, length + 4));
+                };
+
+                constexpr std::array<uint8_t, 8> Signature = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+                builder.Write(Signature.data(), Signature.size());
+
+                writeChunk("IHDR", [&]() {
+                    builder.WriteBigEndian(width);
+                    builder.WriteBigEndian(height);
+                    // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlace.
+                    const std::array<uint8_t, 5> fields = { 8, 6, 0, 0, 0 };
+                    builder.Write(fields.data(), fields.size());
+                });
+
+                writeChunk("IDAT", [&]() {
+                    // Zlib stream of stored deflate blocks, fastest window and no preset dictionary.
+                    builder.Write<uint8_t>(0x78);
+                    builder.Write<uint8_t>(0x01);
+
+                    constexpr size_t MaxStoredBlockSize = 0xFFFF;
+                    size_t offset = 0;
+                    do
+                    {
+                        const auto size = static_cast<uint16_t>(std::min(raw.size() - offset, MaxStoredBlockSize));
+                        const bool isLast = offset + size == raw.size();
+
+                        builder.Write<uint8_t>(isLast ? 1 : 0);
+                        builder.Write<uint16_t>(size);
+                        builder.Write<uint16_t>(static_cast<uint16_t>(~size));
+                        builder.Write(raw.data() + offset, size);
+
+                        offset += size;
+                    } while (offset < raw.size());
+
+                    builder.WriteBigEndian(adler32(raw.data(), raw.size()));
+                });
+
+                writeChunk("IEND", []() { });
+            }
+
+            void encodeExr(const GAPI::CpuResourceData::SubresourceFootprint& footprint, GAPI::GpuResourceFormat format, const uint8_t* data, Image& image)
+            {
+                ASSERT(isFloat(format));
+
+                const uint32_t width = footprint.width;
+                const uint32_t height = footprint.height;
+
+                ImageBuilder builder(image);
+
+                // Magic and version 2, single part scanline file.
+                builder.Write<uint32_t>(20000630);
+                builder.Write<uint32_t>(2);
+
+                const auto writeAttribute = [&builder](const char* name, const char* type, uint32_t size) {
+                    builder.WriteString(name);
+                    builder.WriteString(type);
+                    builder.Write<uint32_t>(size);
+                };
+
+                // Channels are sorted by name, pixel type 1 is half.
+                constexpr std::array<const char*, 4> Channels = { "A", "B", "G", "R" };
+                constexpr std::array<uint32_t, 4> ChannelSourceIndices = { 3, 2, 1, 0 };
+                constexpr uint32_t ChannelSize = 2 + 4 + 1 + 3 + 4 + 4;
+
+                writeAttribute("channels", "chlist", ChannelSize * static_cast<uint32_t>(Channels.size()) + 1);
+                for (const auto channel : Channels)
+                {
+                    builder.WriteString(channel);
+                    builder.Write<int32_t>(1);
+                    builder.Write<uint32_t>(0); // pLinear and reserved
+                    builder.Write<int32_t>(1);
+                    builder.Write<int32_t>(1);
+                }
+                builder.Write<uint8_t>(0);
+
+                writeAttribute("compression", "compression", 1);
+                builder.Write<uint8_t>(0);
+
+                for (const auto window : { "dataWindow", "displayWindow" })
+                {
+                    writeAttribute(window, "box2i", 16);
+                    builder.Write<int32_t>(0);
+                    builder.Write<int32_t>(0);
+                    builder.Write<int32_t>(static_cast<int32_t>(width) - 1);
+                    builder.Write<int32_t>(static_cast<int32_t>(height) - 1);
+                }
+
+                writeAttribute("lineOrder", "lineOrder", 1);
+                builder.Write<uint8_t>(0);
+
+                writeAttribute("pixelAspectRatio", "float", 4);
+                builder.Write<float>(1.0f);
+
+                writeAttribute("screenWindowCenter", "v2f", 8);
+                builder.Write<float>(0.0f);
+                builder.Write<float>(0.0f);
+
+                writeAttribute("screenWindowWidth", "float", 4);
+                builder.Write<float>(1.0f);
+
+                builder.Write<uint8_t>(0);
+
+                // Every scanline is a chunk: y, data size, then channels one after another.
+                const uint32_t lineDataSize = width * static_cast<uint32_t>(Channels.size()) * sizeof(uint16_t);
+                const uint64_t firstChunkOffset = builder.GetSize() + uint64_t(height) * sizeof(uint64_t);
+                for (uint32_t row = 0; row < height; row++)
+                    builder.Write<uint64_t>(firstChunkOffset + uint64_t(row) * (8 + lineDataSize));
+
+                std::vector<uint16_t> halfs(width * 4);
+                std::vector<uint16_t> line(width);
+                for (uint32_t row = 0; row < height; row++)
+                {
+                    const uint8_t* source = data + row * footprint.rowPitch;
+                    if (format == GAPI::GpuResourceFormat::RGBA32Float)
+                        GAPI::TexelConversion::ConvertRowRGBA32FloatToRGBA16Float(reinterpret_cast<const float*>(source), halfs.data(), width);
+                    else
+                        std::memcpy(halfs.data(), source, width * 4 * sizeof(uint16_t));
+
+                    builder.Write<int32_t>(static_cast<int32_t>(row));
+                    builder.Write<uint32_t>(lineDataSize);
+
+                    for (const auto channel : ChannelSourceIndices)
+                    {
+                        for (uint32_t column = 0; column < width; column++)
+                            line[column] = halfs[column * 4 + channel];
+
+                        builder.Write(line.data(), width * sizeof(uint16_t));
+                    }
+                }
+            }
+
+            void encodeDds(const GAPI::CpuResourceData::SubresourceFootprint& footprint, GAPI::GpuResourceFormat format, const uint8_t* data, Image& image)
+            {
+                // Legacy header describes all supported formats, so DX10 extension isn't needed.
+                constexpr uint32_t HeaderSize = 124;
+                constexpr uint32_t PixelFormatSize = 32;
+                constexpr uint32_t FlagsCapsHeightWidthPitchPixelFormat = 0x100F;
+                constexpr uint32_t PixelFormatFourCC = 0x4;
+                constexpr uint32_t PixelFormatRGBA = 0x41;
+                constexpr uint32_t CapsTexture = 0x1000;
+                // D3DFMT_A16B16G16R16F and D3DFMT_A32B32G32R32F.
+                constexpr uint32_t FourCCRGBA16Float = 113;
+                constexpr uint32_t FourCCRGBA32Float = 116;
+
+                const uint32_t rowSize = footprint.width * GAPI::GpuResourceFormatInfo::GetBlockSize(format);
+
+                ImageBuilder builder(image);
+                builder.Write("DDS ", 4);
+                builder.Write<uint32_t>(HeaderSize);
+                builder.Write<uint32_t>(FlagsCapsHeightWidthPitchPixelFormat);
+                builder.Write<uint32_t>(footprint.height);
+                builder.Write<uint32_t>(footprint.width);
+                builder.Write<uint32_t>(rowSize);
+                builder.Write<uint32_t>(0); // depth
+                builder.Write<uint32_t>(0); // mips
+                for (uint32_t index = 0; index < 11; index++)
+                    builder.Write<uint32_t>(0);
+
+                builder.Write<uint32_t>(PixelFormatSize);
+                if (isFloat(format))
+                {
+                    builder.Write<uint32_t>(PixelFormatFourCC);
+                    builder.Write<uint32_t>(format == GAPI::GpuResourceFormat::RGBA16Float ? FourCCRGBA16Float : FourCCRGBA32Float);
+                    for (uint32_t index = 0; index < 5; index++)
+                        builder.Write<uint32_t>(0);
+                }
+                else
+                {
+                    const bool isBGRA = isBGRA8(format);
+                    builder.Write<uint32_t>(PixelFormatRGBA);
+                    builder.Write<uint32_t>(0);
+                    builder.Write<uint32_t>(32);
+                    builder.Write<uint32_t>(isBGRA ? 0x00FF0000 : 0x000000FF);
+                    builder.Write<uint32_t>(0x0000FF00);
+                    builder.Write<uint32_t>(isBGRA ? 0x000000FF : 0x00FF0000);
+                    builder.Write<uint32_t>(0xFF000000);
+                }
+
+                builder.Write<uint32_t>(CapsTexture);
+                for (uint32_t index = 0; index < 4; index++)
+                    builder.Write<uint32_t>(0); // caps2, caps3, caps4, reserved
+
+                for (uint32_t row = 0; row < footprint.height; row++)
+                    builder.Write(data + row * footprint.rowPitch, rowSize);
+            }
+        }
+
+        FrameExporter::~FrameExporter()
+        {
+            ASSERT(!inited_);
+        }
+
+        void FrameExporter::Init(DeviceContext& deviceContext, const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.maxFramesInFlight > 0);
+
+            deviceContext_ = &deviceContext;
+            state_ = std::make_shared<State>();
+            state_->description = description;
+            droppedFramesCount_ = 0;
+
+            if (description.convertOnGpu && description.imageFormat == ImageFormat::Png)
+                converter_.Init(deviceContext);
+
+            inited_ = true;
+        }
+
+        void FrameExporter::Terminate()
+        {
+            ASSERT(inited_);
+
+            if (droppedFramesCount_ > 0)
+                Log::Format::Warning("Frame export dropped {} frames, encoding doesn't keep up with rendering\n", droppedFramesCount_);
+
+            if (state_->description.convertOnGpu && state_->description.imageFormat == ImageFormat::Png)
+                converter_.Terminate();
+
+            state_ = nullptr;
+            deviceContext_ = nullptr;
+
+            inited_ = false;
+        }
+
+        bool FrameExporter::IsSupported(GAPI::GpuResourceFormat format, ImageFormat imageFormat)
+        {
+            if (imageFormat == ImageFormat::Exr)
+                return isFloat(format);
+
+            return isRGBA8(format) || isBGRA8(format) || isFloat(format);
+        }
+
+        bool FrameExporter::Capture(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Texture>& texture, uint64_t frameIndex)
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+            ASSERT(IsSupported(texture->GetDescription().GetFormat(), state_->description.imageFormat));
+
+            // Only the capturing thread increments, so check and increment don't race.
+            if (state_->framesInFlight.load(std::memory_order_acquire) >= state_->description.maxFramesInFlight)
+            {
+                droppedFramesCount_++;
+                return false;
+            }
+
+            state_->framesInFlight.fetch_add(1, std::memory_order_relaxed);
+
+            auto writeFrame = [state = state_, frameIndex](const GAPI::CpuResourceData::SharedPtr& data) {
+                const auto& description = state->description;
+                const auto& footprint = data->GetSubresourceFootprintAt(0);
+                const auto format = data->GetResourceDescription().GetFormat();
+
+                const auto& allocation = data->GetAllocation();
+                const auto* pointer = static_cast<const uint8_t*>(allocation->Map()) + footprint.offset;
+
+                Image image;
+                switch (description.imageFormat)
+                {
+                    case ImageFormat::Png: encodePng(footprint, format, pointer, image); break;
+                    case ImageFormat::Exr: encodeExr(footprint, format, pointer, image); break;
+                    case ImageFormat::Dds: encodeDds(footprint, format, pointer, image); break;
+                }
+
+                allocation->Unmap();
+
+                const auto path = fmt::format("{}/{}{:06}.{}", description.directory, description.prefix, frameIndex, getExtension(description.imageFormat));
+
+                std::ofstream file(path, std::ios::binary);
+                file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+
+                if (file.good())
+                    state->writtenFramesCount.fetch_add(1, std::memory_order_relaxed);
+                else
+                    Log::Format::Error("Failed to write frame {}\n", path);
+
+                state->framesInFlight.fetch_sub(1, std::memory_order_release);
+            };
+
+            // Readback data is RGBA8 then, encoded as is.
+            if (converter_.IsAvailable() && isFloat(texture->GetDescription().GetFormat()) &&
+                commandQueue->GetCommandQueueType() != GAPI::CommandQueueType::Copy)
+            {
+                ReadbackConverter::Conversion conversion;
+                conversion.format = GAPI::GpuResourceFormat::RGBA8Unorm;
+                conversion.encodeSrgb = true;
+
+                converter_.ReadbackAsync(commandQueue, texture, conversion, std::move(writeFrame));
+                return true;
+            }
+
+            deviceContext_->ReadbackAsync(commandQueue, texture, std::move(writeFrame), 0, 1);
+            return true;
+        }
+
+        uint32_t FrameExporter::GetFramesInFlight() const
+        {
+            ASSERT(inited_);
+            return state_->framesInFlight.load(std::memory_order_relaxed);
+        }
+
+        uint64_t FrameExporter::GetWrittenFramesCount() const
+        {
+            ASSERT(inited_);
+            return state_->writtenFramesCount.load(std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceFormat.hpp"
+
+#include "render/ReadbackConverter.hpp"
+
+#include <atomic>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Writes frames of a texture to numbered image files without stalling rendering, e.g. frame sequences of production runs.
+        // Capture only queues a copy into the async readback ring of DeviceContext. Once GPU is done with it, texel conversion
+        // and encoding run on job system workers. Frames in flight are bounded: capture beyond the bound drops the frame
+        // instead of waiting, so rendering at 60 fps never blocks on disk or encoder.
+        class FrameExporter final : private NonCopyable
+        {
+        public:
+            enum class ImageFormat : uint32_t
+            {
+                // RGBA8, stored deflate blocks: larger files, but encoding is a copy.
+                Png,
+                // Half float RGBA, uncompressed scanlines.
+                Exr,
+                // Texels as they are read back, no conversion.
+                Dds,
+            };
+
+            struct Description
+            {
+                // Should exist, files are named <prefix><frame index>.<extension>.
+                U8String directory;
+                U8String prefix = "frame";
+                ImageFormat imageFormat = ImageFormat::Png;
+                // Covers readback latency of a few frames plus encoding time of a worker.
+                uint32_t maxFramesInFlight = 8;
+                // Png of float frames: sRGB encoding to RGBA8 runs on GPU before readback, which reads back a half or a quarter
+                // of the bytes and skips CPU conversion. Applies to captures from graphics and compute queues.
+                bool convertOnGpu = false;
+            };
+
+            FrameExporter() = default;
+            ~FrameExporter();
+
+            void Init(DeviceContext& deviceContext, const Description& description);
+            // Doesn't wait, frames in flight are still written by workers.
+            void Terminate();
+
+            // RGBA8Unorm, BGRA8Unorm (and Srgb variants), RGBA16Float and RGBA32Float. Exr takes float formats only.
+            static bool IsSupported(GAPI::GpuResourceFormat format, ImageFormat imageFormat);
+
+            // Call after frame work is submitted to the queue, exports first subresource of the texture.
+            // Returns false when frame is dropped, as maxFramesInFlight frames are still pending.
+            bool Capture(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Texture>& texture, uint64_t frameIndex);
+
+            uint32_t GetFramesInFlight() const;
+            uint64_t GetWrittenFramesCount() const;
+            uint64_t GetDroppedFramesCount() const { return droppedFramesCount_; }
+
+        private:
+            // Shared with readback callbacks, which could outlive exporter.
+            struct State final
+            {
+                Description description;
+                std::atomic<uint32_t> framesInFlight = 0;
+                std::atomic<uint64_t> writtenFramesCount = 0;
+            };
+
+        private:
+            bool inited_ = false;
+            DeviceContext* deviceContext_ = nullptr;
+            std::shared_ptr<State> state_;
+            ReadbackConverter converter_;
+            uint64_t droppedFramesCount_ = 0;
+        };
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/debug/Profiler.hpp"
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace RR
+{
+    namespace Render
+    {
+        // Runs rendering of frame N on render thread while caller thread simulates frames after it.
+        // Caller fills FrameData snapshot between BeginFrame and EndFrame, render thread gets it as immutable.
+        // Snapshot storage is recycled, so FrameData should keep its allocations between frames.
+        template <typename FrameData>
+        class FramePipeline final : private NonCopyable, NonMovable
+        {
+        public:
+            static constexpr uint32_t DefaultDepth = 1;
+
+            using RenderFunction = std::function<void(const FrameData& frameData, uint64_t frameIndex)>;
+
+            ~FramePipeline() { ASSERT(!renderThread_.IsJoinable()); }
+
+            // Depth is how many frames simulation can run ahead of the frame being rendered.
+            void Init(RenderFunction&& render, uint32_t depth = DefaultDepth)
+            {
+                ASSERT(!renderThread_.IsJoinable());
+                ASSERT(depth > 0);
+                ASSERT(render);
+
+                render_ = std::move(render);
+                // Slot per frame in flight and one being filled.
+                frames_.resize(depth + 1);
+                depth_ = depth;
+                submittedFrames_ = 0;
+                renderedFrames_ = 0;
+                terminate_ = false;
+
+                renderThread_ = Threading::Thread("Render", [this] { renderThreadFunc(); });
+            }
+
+            // Renders all submitted frames and stops render thread.
+            void Terminate()
+            {
+                if (!renderThread_.IsJoinable())
+                    return;
+
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    terminate_ = true;
+                }
+                frameSubmitted_.notify_one();
+
+                renderThread_.Join();
+                frames_.clear();
+            }
+
+            // Blocks while simulation is more than depth frames ahead of rendering. Returned snapshot
+            // still holds data of the frame submitted depth + 1 frames ago.
+            FrameData& BeginFrame()
+            {
+                ASSERT(renderThread_.IsJoinable());
+                PROFILE_SCOPE("FramePipeline::BeginFrame");
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                frameRendered_.wait(lock, [this] { return submittedFrames_ - renderedFrames_ <= depth_; });
+
+                return frames_[submittedFrames_ % frames_.size()];
+            }
+
+            void EndFrame()
+            {
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    submittedFrames_++;
+                }
+                frameSubmitted_.notify_one();
+            }
+
+            // Blocks until every submitted frame is rendered.
+            void WaitIdle()
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                frameRendered_.wait(lock, [this] { return renderedFrames_ == submittedFrames_; });
+            }
+
+            inline uint32_t GetDepth() const { return depth_; }
+
+        private:
+            void renderThreadFunc()
+            {
+                Debug::Profiler::SetThreadName("Render");
+                ALLOCATION_TAG_SCOPE(Render);
+
+                while (true)
+                {
+                    uint64_t frameIndex;
+                    {
+                        Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                        frameSubmitted_.wait(lock, [this] { return submittedFrames_ > renderedFrames_ || terminate_; });
+
+                        if (submittedFrames_ == renderedFrames_)
+                            return;
+
+                        frameIndex = renderedFrames_;
+                    }
+
+                    {
+                        PROFILE_SCOPE("FramePipeline::Render");
+                        // Caller writes other slots only, no lock needed while rendering.
+                        render_(frames_[frameIndex % frames_.size()], frameIndex);
+                    }
+
+                    {
+                        Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                        renderedFrames_++;
+                    }
+                    frameRendered_.notify_all();
+                }
+            }
+
+        private:
+            RenderFunction render_;
+            std::vector<FrameData> frames_;
+            uint32_t depth_ = DefaultDepth;
+
+            Threading::Mutex mutex_;
+            Threading::ConditionVariable frameSubmitted_;
+            Threading::ConditionVariable frameRendered_;
+            uint64_t submittedFrames_ = 0;
+            uint64_t renderedFrames_ = 0;
+            bool terminate_ = false;
+
+            Threading::Thread renderThread_;
+        };
+    }
+}
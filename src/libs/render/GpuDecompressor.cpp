@@ -0,0 +1,142 @@
+#include "GpuDecompressor.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Limits.hpp"
+#include "gapi/MemoryAllocation.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            constexpr const char* ShaderPath = "shaders/Decompress_main.bin";
+        }
+
+        GpuDecompressor::~GpuDecompressor()
+        {
+            ASSERT(!inited_);
+        }
+
+        void GpuDecompressor::Init(DeviceContext& deviceContext)
+        {
+            ASSERT(!inited_);
+
+            deviceContext_ = &deviceContext;
+            inited_ = true;
+
+            pipeline_.Init(deviceContext, ShaderPath, "GpuDecompressor", "compressed uploads are decompressed on CPU");
+        }
+
+        void GpuDecompressor::Terminate()
+        {
+            ASSERT(inited_);
+
+            pipeline_.Terminate();
+            deviceContext_ = nullptr;
+
+            inited_ = false;
+        }
+
+        void GpuDecompressor::Decompress(GAPI::ComputeCommandList& commandList,
+                                         const std::shared_ptr<GAPI::Buffer>& source, uint32_t sourceOffset,
+                                         const Common::TileCompression::Header& header,
+                                         const std::shared_ptr<GAPI::Buffer>& dest, uint32_t destOffset)
+        {
+            ASSERT(inited_);
+            ASSERT(IsAvailable());
+            ASSERT(source);
+            ASSERT(dest);
+            ASSERT(header.magic == Common::TileCompression::Magic);
+            ASSERT(sourceOffset % sizeof(uint32_t) == 0 && destOffset % sizeof(uint32_t) == 0);
+            ASSERT(IsSet(dest->GetDescription().GetBindFlags(), GAPI::GpuResourceBindFlags::UnorderedAccess));
+            ASSERT(destOffset + AlignTo(header.uncompressedSize, sizeof(uint32_t)) <= dest->GetDescription().GetSize());
+
+            const uint32_t threadGroupsCount = (header.tilesCount + ThreadGroupSize - 1) / ThreadGroupSize;
+            ASSERT(threadGroupsCount <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            if (header.tilesCount == 0)
+                return;
+
+            // Raw views address 32-bit values.
+            const auto& sourceSrv = source->GetSRV(GAPI::GpuResourceFormat::R32Uint);
+            const auto& destUav = dest->GetUAV(GAPI::GpuResourceFormat::R32Uint);
+
+            Constants constants;
+            constants.sourceIndex = sourceSrv->GetBindlessIndex();
+            constants.destIndex = destUav->GetBindlessIndex();
+            constants.sourceOffset = sourceOffset;
+            constants.destOffset = destOffset;
+            constants.uncompressedSize = header.uncompressedSize;
+            constants.tilesCount = header.tilesCount;
+
+            pipeline_.Bind(commandList);
+
+            commandList.BeginMarker("Decompress");
+
+            commandList.TransitionToShaderResource(sourceSrv);
+            commandList.TransitionToUnorderedAccess(destUav);
+
+            commandList.SetComputeConstantBuffer(RootParameter::Constants, commandList.AllocateConstants(constants));
+            commandList.SetComputeDescriptorTable(RootParameter::Buffers, 0);
+            commandList.SetComputeDescriptorTable(RootParameter::ReadOnlyBuffers, 0);
+            commandList.Dispatch(threadGroupsCount);
+
+            commandList.EndMarker();
+        }
+
+        GAPI::GpuSyncPoint GpuDecompressor::Upload(const std::shared_ptr<GAPI::Buffer>& dest, const std::vector<uint8_t>& compressed)
+        {
+            ASSERT(inited_);
+            ASSERT(dest);
+
+            Common::TileCompression::Header header;
+            const bool isValid = Common::TileCompression::ReadHeader(compressed.data(), compressed.size(), header);
+            ASSERT_MSG(isValid, "Malformed compressed stream");
+            std::ignore = isValid;
+
+            auto& deviceContext = *deviceContext_;
+            const auto& commandQueue = deviceContext.GetCommandQueue(GAPI::CommandQueueType::Compute);
+            const auto& commandList = deviceContext.AcquireComputeCommandList();
+
+            if (IsAvailable())
+            {
+                // Scratch buffer is released deferred, after GPU is done with it.
+                const auto& scratchDescription = GAPI::GpuResourceDescription::Buffer(static_cast<uint32_t>(compressed.size()), GAPI::GpuResourceBindFlags::ShaderResource);
+                const auto& scratch = deviceContext.CreateBuffer(scratchDescription, GAPI::GpuResourceCpuAccess::None, "Decompression scratch");
+
+                const auto scratchData = deviceContext.AllocateIntermediateResourceData(scratchDescription, GAPI::MemoryAllocationType::Upload);
+                scratchData->WriteSubresource(0, compressed.data(), compressed.size());
+
+                commandList->UpdateGpuResource(scratch, scratchData);
+                Decompress(*commandList, scratch, 0, header, dest);
+            }
+            else
+            {
+                const auto& destDescription = dest->GetDescription();
+                const auto destData = deviceContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Upload);
+                ASSERT(header.uncompressedSize <= destDescription.GetSize());
+
+                const bool decompressed = Common::TileCompression::Decompress(compressed.data(), compressed.size(),
+                                                                              destData->GetAllocation()->Map(), destDescription.GetSize());
+                destData->GetAllocation()->Unmap();
+                ASSERT(decompressed);
+                std::ignore = decompressed;
+
+                commandList->UpdateGpuResource(dest, destData);
+            }
+
+            commandList->Close();
+
+            const auto syncPoint = deviceContext.Submit(commandQueue, commandList);
+            deviceContext.ReleaseQueueOwnership(dest, syncPoint);
+
+            return syncPoint;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "gapi/Fence.hpp"
+#include "gapi/ForwardDeclarations.hpp"
+
+#include "render/ComputePipeline.hpp"
+
+#include "common/TileCompression.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Decompresses Common::TileCompression streams on GPU, so streamed payloads cross PCIe compressed and CPU cores
+        // aren't spent on decompression. Thread per tile, destination is written through raw UAV, so it should be created
+        // with UnorderedAccess binding and span uncompressed size rounded up to 4 bytes.
+        class GpuDecompressor final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t ThreadGroupSize = 64;
+
+            GpuDecompressor() = default;
+            ~GpuDecompressor();
+
+            void Init(DeviceContext& deviceContext);
+            void Terminate();
+
+            // False when shader bytecode wasn't found, Upload decompresses on CPU then.
+            bool IsAvailable() const { return pipeline_.IsAvailable(); }
+
+            // Source holds the stream at 4 bytes aligned offset, destOffset should be 4 bytes aligned too.
+            void Decompress(GAPI::ComputeCommandList& commandList,
+                            const std::shared_ptr<GAPI::Buffer>& source, uint32_t sourceOffset,
+                            const Common::TileCompression::Header& header,
+                            const std::shared_ptr<GAPI::Buffer>& dest, uint32_t destOffset = 0);
+
+            // Uploads the stream into scratch buffer and decompresses it into dest on async compute queue.
+            // Dest is released from the queue, so consumers acquire it as resources of UploadStreamer.
+            GAPI::GpuSyncPoint Upload(const std::shared_ptr<GAPI::Buffer>& dest, const std::vector<uint8_t>& compressed);
+
+        private:
+            enum RootParameter : uint32_t
+            {
+                Constants,
+                Buffers,
+                ReadOnlyBuffers
+            };
+
+            // Matches layout in shaders/Decompress.slang.
+            struct Constants final
+            {
+                uint32_t sourceIndex;
+                uint32_t destIndex;
+                uint32_t sourceOffset;
+                uint32_t destOffset;
+                uint32_t uncompressedSize;
+                uint32_t tilesCount;
+            };
+
+        private:
+            bool inited_ = false;
+            DeviceContext* deviceContext_ = nullptr;
+            ComputePipeline pipeline_;
+        };
+    }
+}
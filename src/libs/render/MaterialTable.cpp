@@ -0,0 +1,177 @@
+#include "MaterialTable.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/GpuResourceViews.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            inline uint32_t getBindlessIndex(const std::shared_ptr<GAPI::ShaderResourceView>& view)
+            {
+                return view ? view->GetBindlessIndex() : MaterialTable::NoTexture;
+            }
+        }
+
+        MaterialTable::~MaterialTable()
+        {
+            ASSERT(!inited_);
+        }
+
+        void MaterialTable::Init(DeviceContext& deviceContext)
+        {
+            ASSERT(!inited_);
+
+            constexpr uint32_t tableSize = MaxMaterials * sizeof(GpuMaterial);
+
+            buffer_ = deviceContext.CreateBuffer(GAPI::GpuResourceDescription::Buffer(tableSize), GAPI::GpuResourceCpuAccess::None, "Material table");
+            // Raw view addresses 32-bit values.
+            shaderResourceView_ = deviceContext.CreateShaderResourceView(buffer_, GAPI::GpuResourceViewDescription::Buffer(GAPI::GpuResourceFormat::R32Uint, 0, tableSize / sizeof(uint32_t)));
+
+            materials_.resize(MaxMaterials);
+            records_.resize(MaxMaterials);
+            isDirty_.assign(MaxMaterials, false);
+
+            // Lowest indices are taken first, so uploads of loaded materials stay contiguous.
+            freeIndices_.resize(MaxMaterials);
+            for (uint32_t index = 0; index < MaxMaterials; index++)
+                freeIndices_[index] = MaxMaterials - 1 - index;
+
+            inited_ = true;
+        }
+
+        void MaterialTable::Terminate()
+        {
+            ASSERT(inited_);
+
+            shaderResourceView_ = nullptr;
+            buffer_ = nullptr;
+            materials_.clear();
+            records_.clear();
+            freeIndices_.clear();
+            dirtyIndices_.clear();
+            isDirty_.clear();
+
+            inited_ = false;
+        }
+
+        uint32_t MaterialTable::Allocate(const Material& material)
+        {
+            ASSERT(inited_);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (freeIndices_.empty())
+                return InvalidMaterial;
+
+            const auto index = freeIndices_.back();
+            freeIndices_.pop_back();
+
+            materials_[index] = material;
+            records_[index] = makeGpuMaterial(material);
+            markDirty(index);
+
+            return index;
+        }
+
+        void MaterialTable::Update(uint32_t index, const Material& material)
+        {
+            ASSERT(inited_);
+            ASSERT(index < MaxMaterials);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            materials_[index] = material;
+            records_[index] = makeGpuMaterial(material);
+            markDirty(index);
+        }
+
+        void MaterialTable::Release(uint32_t index)
+        {
+            ASSERT(inited_);
+            ASSERT(index < MaxMaterials);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            // Views are released deferred by device, record still points to valid descriptors for frames in flight.
+            materials_[index] = {};
+            records_[index] = makeGpuMaterial(materials_[index]);
+            markDirty(index);
+
+            freeIndices_.push_back(index);
+        }
+
+        void MaterialTable::Flush(GAPI::ComputeCommandList& commandList)
+        {
+            ASSERT(inited_);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (!dirtyIndices_.empty())
+            {
+                std::sort(dirtyIndices_.begin(), dirtyIndices_.end());
+
+                // Consecutive records are uploaded as one range.
+                std::vector<GAPI::BufferUpdate> updates;
+                for (size_t first = 0; first < dirtyIndices_.size();)
+                {
+                    size_t last = first + 1;
+                    while (last < dirtyIndices_.size() && dirtyIndices_[last] == dirtyIndices_[last - 1] + 1)
+                        last++;
+
+                    const uint32_t firstIndex = dirtyIndices_[first];
+                    const auto count = static_cast<uint32_t>(last - first);
+                    updates.push_back({ buffer_, firstIndex * static_cast<uint32_t>(sizeof(GpuMaterial)), &records_[firstIndex], count * static_cast<uint32_t>(sizeof(GpuMaterial)) });
+
+                    first = last;
+                }
+
+                commandList.UpdateBuffers(updates.data(), static_cast<uint32_t>(updates.size()));
+
+                for (const auto index : dirtyIndices_)
+                    isDirty_[index] = false;
+                dirtyIndices_.clear();
+            }
+
+            commandList.TransitionToShaderResource(shaderResourceView_);
+        }
+
+        uint32_t MaterialTable::GetBindlessIndex() const
+        {
+            ASSERT(inited_);
+            return shaderResourceView_->GetBindlessIndex();
+        }
+
+        MaterialTable::GpuMaterial MaterialTable::makeGpuMaterial(const Material& material) const
+        {
+            GpuMaterial record;
+            record.albedoIndex = getBindlessIndex(material.albedoMap);
+            record.normalIndex = getBindlessIndex(material.normalMap);
+            record.metallicIndex = getBindlessIndex(material.metallicMap);
+            record.roughnessIndex = getBindlessIndex(material.roughnessMap);
+            record.baseColor = material.baseColor;
+            record.metallic = material.metallic;
+            record.roughness = material.roughness;
+            record.alphaCutoff = material.alphaCutoff;
+            record.padding = 0;
+
+            return record;
+        }
+
+        void MaterialTable::markDirty(uint32_t index)
+        {
+            if (isDirty_[index])
+                return;
+
+            isDirty_[index] = true;
+            dirtyIndices_.push_back(index);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+
+#include "common/Math.hpp"
+#include "common/threading/Mutex.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Materials packed into GPU buffer of GpuMaterial records: bindless indices of material maps and scalar params.
+        // Draws pass only material index in draw constants and shaders load the record from the table at its bindless
+        // index, so material changes bind nothing and don't split batches sharing pipeline and mesh.
+        class MaterialTable final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t MaxMaterials = 4096;
+            static constexpr uint32_t InvalidMaterial = 0xFFFFFFFF;
+            // Bindless index of missing map, shaders use scalar params instead.
+            static constexpr uint32_t NoTexture = 0xFFFFFFFF;
+
+            struct Material
+            {
+                std::shared_ptr<GAPI::ShaderResourceView> albedoMap;
+                std::shared_ptr<GAPI::ShaderResourceView> normalMap;
+                std::shared_ptr<GAPI::ShaderResourceView> metallicMap;
+                std::shared_ptr<GAPI::ShaderResourceView> roughnessMap;
+                // Multiplies albedo map.
+                Vector4 baseColor = Vector4(1.0f);
+                float metallic = 0.0f;
+                float roughness = 1.0f;
+                // Texels with alpha below are discarded, zero disables alpha test.
+                float alphaCutoff = 0.0f;
+            };
+
+            // Record layout, shaders load it from raw buffer at index * sizeof(GpuMaterial).
+            struct GpuMaterial
+            {
+                uint32_t albedoIndex;
+                uint32_t normalIndex;
+                uint32_t metallicIndex;
+                uint32_t roughnessIndex;
+                Vector4 baseColor;
+                float metallic;
+                float roughness;
+                float alphaCutoff;
+                uint32_t padding;
+            };
+            static_assert(sizeof(GpuMaterial) == 48);
+
+        public:
+            MaterialTable() = default;
+            ~MaterialTable();
+
+            void Init(DeviceContext& deviceContext);
+            void Terminate();
+
+            // Returns InvalidMaterial once table is full. Table keeps map views alive until material is released or updated.
+            uint32_t Allocate(const Material& material);
+            void Update(uint32_t index, const Material& material);
+            // Index is reused by later Allocate, record is rewritten by Flush ordered after frames which could read it.
+            void Release(uint32_t index);
+
+            // Uploads records changed since last flush and transitions table for shader reads.
+            // Call once per frame before draws reading the table.
+            void Flush(GAPI::ComputeCommandList& commandList);
+
+            // Index of table SRV in bindless heap.
+            uint32_t GetBindlessIndex() const;
+
+        private:
+            GpuMaterial makeGpuMaterial(const Material& material) const;
+            void markDirty(uint32_t index);
+
+        private:
+            bool inited_ = false;
+            std::shared_ptr<GAPI::Buffer> buffer_;
+            std::shared_ptr<GAPI::ShaderResourceView> shaderResourceView_;
+            // Keep map views referenced by records alive.
+            std::vector<Material> materials_;
+            std::vector<GpuMaterial> records_;
+            std::vector<uint32_t> freeIndices_;
+            std::vector<uint32_t> dirtyIndices_;
+            std::vector<bool> isDirty_;
+            Threading::Mutex mutex_;
+        };
+    }
+}
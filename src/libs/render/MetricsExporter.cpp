@@ -0,0 +1,326 @@
+#include "MetricsExporter.hpp"
+
+#include "render/DeviceContext.hpp"
+#include "render/Network.hpp"
+#include "render/UploadStreamer.hpp"
+
+#include "common/debug/MemoryStats.hpp"
+#include "common/debug/Profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <string_view>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            // Scrapers send a short GET, anything longer is cut.
+            constexpr size_t MaxRequestSize = 4096;
+            // Slow or stuck client shouldn't stall sampling for long.
+            constexpr uint32_t ClientTimeoutMs = 1000;
+            // Upload rate is averaged over at least that window.
+            constexpr uint64_t UploadRateWindowNs = 1'000'000'000;
+
+            // Label values escape backslash, quote and line feed.
+            U8String escapeLabel(const U8String& value)
+            {
+                U8String result;
+                result.reserve(value.size());
+
+                for (const auto character : value)
+                {
+                    if (character == '\n')
+                    {
+                        result += "\\n";
+                        continue;
+                    }
+
+                    if (character == '\\' || character == '"')
+                        result += '\\';
+
+                    result += character;
+                }
+
+                return result;
+            }
+        }
+
+        void MetricsExporter::Histogram::Observe(double seconds)
+        {
+            const auto bucket = std::lower_bound(FrameTimeBuckets.begin(), FrameTimeBuckets.end(), seconds) - FrameTimeBuckets.begin();
+            counts[bucket]++;
+            sum += seconds;
+            count++;
+        }
+
+        MetricsExporter::~MetricsExporter()
+        {
+            ASSERT(!inited_);
+        }
+
+        void MetricsExporter::Init(DeviceContext& deviceContext, const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.samplingIntervalMs > 0);
+
+            deviceContext_ = &deviceContext;
+            description_ = description;
+            inited_ = true;
+
+            listenSocket_ = Network::Listen(description.port, description.unixSocketPath);
+            if (listenSocket_ == Network::InvalidSocket)
+            {
+                if (description.unixSocketPath.empty())
+                    Log::Format::Warning("Metrics exporter failed to listen on port {}, metrics are disabled\n", description.port);
+                else
+                    Log::Format::Warning("Metrics exporter failed to listen on {}, metrics are disabled\n", description.unixSocketPath);
+
+                return;
+            }
+
+            quit_ = false;
+            uploadRateStartNs_ = Profiler::Now();
+            uploadRateStartBytes_ = description.uploadStreamer ? description.uploadStreamer->GetUploadedBytes() : 0;
+
+            thread_ = Threading::Thread("Metrics Thread", [this] { threadFunc(); });
+            thread_.SetPriority(Threading::ThreadPriority::BelowNormal);
+            thread_.SetQoS(Threading::ThreadQoS::Eco);
+
+            isAvailable_ = true;
+        }
+
+        void MetricsExporter::Terminate()
+        {
+            ASSERT(inited_);
+
+            if (isAvailable_)
+            {
+                // Thread notices within sampling interval.
+                quit_ = true;
+                thread_.Join();
+
+                Network::Close(listenSocket_);
+                listenSocket_ = Network::InvalidSocket;
+
+                if (!description_.unixSocketPath.empty())
+                    std::remove(description_.unixSocketPath.c_str());
+            }
+
+            while (frameTimestamps_.Front())
+                frameTimestamps_.Pop();
+
+            cpuFrameTime_ = {};
+            gpuFrameTime_ = {};
+            passesCount_ = 0;
+            lastFrameNs_ = 0;
+            lastGpuFrameIndex_ = 0;
+            uploadBytesPerSecond_ = 0.0;
+            deviceContext_ = nullptr;
+            isAvailable_ = false;
+            inited_ = false;
+        }
+
+        void MetricsExporter::RecordFrame()
+        {
+            ASSERT(inited_);
+
+            if (!isAvailable_)
+                return;
+
+            if (!frameTimestamps_.TryPush(Profiler::Now()))
+                skippedFramesCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void MetricsExporter::threadFunc()
+        {
+            const uint64_t intervalNs = uint64_t(description_.samplingIntervalMs) * 1'000'000;
+            uint64_t nextSampleNs = Profiler::Now() + intervalNs;
+
+            while (!quit_.load(std::memory_order_relaxed))
+            {
+                const auto nowNs = Profiler::Now();
+                if (nowNs >= nextSampleNs)
+                {
+                    sample();
+                    nextSampleNs = nowNs + intervalNs;
+                    continue;
+                }
+
+                if (!Network::WaitReadable(listenSocket_, nextSampleNs - nowNs))
+                    continue;
+
+                const auto connection = Network::Accept(listenSocket_);
+                if (connection == Network::InvalidSocket)
+                    continue;
+
+                // Scrape sees frames up to this moment.
+                sample();
+                serve(connection);
+                Network::Close(connection);
+            }
+        }
+
+        void MetricsExporter::sample()
+        {
+            for (auto timestamp = frameTimestamps_.Front(); timestamp; timestamp = frameTimestamps_.Front())
+            {
+                // Skipped frames merge into the next interval, which is still a valid frame time sample.
+                if (lastFrameNs_ != 0)
+                    cpuFrameTime_.Observe((*timestamp - lastFrameNs_) / 1e9);
+
+                lastFrameNs_ = *timestamp;
+                frameTimestamps_.Pop();
+            }
+
+            // Frames completed on GPU between samples are missed, GPU histogram is sampled rather than complete.
+            const auto& gpuTimings = deviceContext_->GetGpuFrameTimings();
+            if (gpuTimings.frameIndex > lastGpuFrameIndex_ && !gpuTimings.markers.empty())
+            {
+                double gpuFrameMs = 0.0;
+                passesCount_ = 0;
+
+                for (const auto& marker : gpuTimings.markers)
+                {
+                    if (marker.parent != GAPI::GpuTimingMarker::InvalidParent)
+                        continue;
+
+                    gpuFrameMs = std::max(gpuFrameMs, marker.startMs + marker.durationMs);
+
+                    if (passesCount_ < MaxPasses)
+                        passes_[passesCount_++] = { marker.name, marker.durationMs / 1e3 };
+                }
+
+                gpuFrameTime_.Observe(gpuFrameMs / 1e3);
+                lastGpuFrameIndex_ = gpuTimings.frameIndex;
+            }
+
+            if (description_.uploadStreamer)
+            {
+                const auto nowNs = Profiler::Now();
+                if (nowNs - uploadRateStartNs_ >= UploadRateWindowNs)
+                {
+                    const auto uploadedBytes = description_.uploadStreamer->GetUploadedBytes();
+                    uploadBytesPerSecond_ = (uploadedBytes - uploadRateStartBytes_) * 1e9 / (nowNs - uploadRateStartNs_);
+                    uploadRateStartBytes_ = uploadedBytes;
+                    uploadRateStartNs_ = nowNs;
+                }
+            }
+        }
+
+        void MetricsExporter::serve(uintptr_t connection) const
+        {
+            Network::SetTimeout(connection, ClientTimeoutMs);
+
+            // Request line is all that matters, headers are read to the end so client doesn't get reset.
+            std::array<char, MaxRequestSize> request;
+            size_t requestSize = 0;
+            while (requestSize < request.size())
+            {
+                const auto received = Network::Receive(connection, request.data() + requestSize, request.size() - requestSize);
+                if (received <= 0)
+                    return;
+
+                requestSize += static_cast<size_t>(received);
+                if (std::string_view(request.data(), requestSize).find("\r\n\r\n") != std::string_view::npos)
+                    break;
+            }
+
+            const std::string_view requestLine(request.data(), requestSize);
+            const bool isMetrics = requestLine.rfind("GET /metrics ", 0) == 0 || requestLine.rfind("GET / ", 0) == 0;
+
+            const auto& body = isMetrics ? formatMetrics() : U8String("Not found\n");
+            const auto& response = fmt::format("HTTP/1.1 {}\r\n"
+                                               "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                               "Content-Length: {}\r\n"
+                                               "Connection: close\r\n\r\n{}",
+                                               isMetrics ? "200 OK" : "404 Not Found", body.size(), body);
+
+            for (size_t sent = 0; sent < response.size();)
+            {
+                const auto result = Network::Send(connection, response.data() + sent, response.size() - sent);
+                if (result <= 0)
+                    return;
+
+                sent += static_cast<size_t>(result);
+            }
+        }
+
+        U8String MetricsExporter::formatMetrics() const
+        {
+            fmt::memory_buffer buffer;
+            const auto out = std::back_inserter(buffer);
+
+            const auto formatHistogram = [&out](const char* name, const char* help, const Histogram& histogram) {
+                fmt::format_to(out, "# HELP {} {}\n# TYPE {} histogram\n", name, help, name);
+
+                uint64_t cumulative = 0;
+                for (size_t bucket = 0; bucket < FrameTimeBuckets.size(); bucket++)
+                {
+                    cumulative += histogram.counts[bucket];
+                    fmt::format_to(out, "{}_bucket{{le=\"{}\"}} {}\n", name, FrameTimeBuckets[bucket], cumulative);
+                }
+
+                fmt::format_to(out, "{}_bucket{{le=\"+Inf\"}} {}\n{}_sum {}\n{}_count {}\n", name, histogram.count, name, histogram.sum, name, histogram.count);
+            };
+
+            formatHistogram("rr_cpu_frame_time_seconds", "Interval between frames on the thread calling MoveToNextFrame.", cpuFrameTime_);
+            formatHistogram("rr_gpu_frame_time_seconds", "GPU time of sampled completed frames.", gpuFrameTime_);
+
+            fmt::format_to(out, "# HELP rr_frames_skipped_total Frames not recorded, as metrics thread fell behind.\n"
+                                "# TYPE rr_frames_skipped_total counter\n"
+                                "rr_frames_skipped_total {}\n",
+                           skippedFramesCount_.load(std::memory_order_relaxed));
+
+            fmt::format_to(out, "# HELP rr_gpu_pass_time_seconds GPU time of top level markers of the latest sampled frame.\n"
+                                "# TYPE rr_gpu_pass_time_seconds gauge\n");
+            for (uint32_t index = 0; index < passesCount_; index++)
+                fmt::format_to(out, "rr_gpu_pass_time_seconds{{pass=\"{}\"}} {}\n", escapeLabel(passes_[index].name), passes_[index].seconds);
+
+            const auto& budget = deviceContext_->GetMemoryBudget();
+            fmt::format_to(out, "# HELP rr_gpu_memory_usage_bytes Process usage of memory segment as reported by OS.\n"
+                                "# TYPE rr_gpu_memory_usage_bytes gauge\n"
+                                "rr_gpu_memory_usage_bytes{{segment=\"local\"}} {}\n"
+                                "rr_gpu_memory_usage_bytes{{segment=\"non_local\"}} {}\n"
+                                "# HELP rr_gpu_memory_budget_bytes OS budget of memory segment.\n"
+                                "# TYPE rr_gpu_memory_budget_bytes gauge\n"
+                                "rr_gpu_memory_budget_bytes{{segment=\"local\"}} {}\n"
+                                "rr_gpu_memory_budget_bytes{{segment=\"non_local\"}} {}\n",
+                           budget.local.usageBytes, budget.nonLocal.usageBytes, budget.local.budgetBytes, budget.nonLocal.budgetBytes);
+
+            const auto& memoryStatistics = Common::Debug::MemoryStats::Instance().GetStatistics();
+            fmt::format_to(out, "# HELP rr_memory_bytes Live memory of engine allocators per tag and kind.\n"
+                                "# TYPE rr_memory_bytes gauge\n");
+            for (size_t tag = 0; tag < memoryStatistics.size(); tag++)
+                for (size_t kind = 0; kind < memoryStatistics[tag].size(); kind++)
+                    if (memoryStatistics[tag][kind].peakBytes > 0)
+                        fmt::format_to(out, "rr_memory_bytes{{tag=\"{}\",kind=\"{}\"}} {}\n",
+                                       Common::Debug::AllocationTracker::GetTagName(static_cast<Common::Debug::AllocationTag>(tag)),
+                                       Common::Debug::MemoryStats::GetKindName(static_cast<Common::Debug::MemoryKind>(kind)),
+                                       memoryStatistics[tag][kind].bytes);
+
+            if (description_.uploadStreamer)
+                fmt::format_to(out, "# HELP rr_upload_bytes_total Resource data submitted for upload.\n"
+                                    "# TYPE rr_upload_bytes_total counter\n"
+                                    "rr_upload_bytes_total {}\n"
+                                    "# HELP rr_upload_bytes_per_second Upload rate over the latest second.\n"
+                                    "# TYPE rr_upload_bytes_per_second gauge\n"
+                                    "rr_upload_bytes_per_second {}\n",
+                               description_.uploadStreamer->GetUploadedBytes(), uploadBytesPerSecond_);
+
+            const auto& deviceStatistics = deviceContext_->GetDeviceStatistics();
+            fmt::format_to(out, "# HELP rr_submission_queue_depth Tasks queued for submission thread.\n"
+                                "# TYPE rr_submission_queue_depth gauge\n"
+                                "rr_submission_queue_depth {}\n"
+                                "# HELP rr_pending_releases Objects waiting for GPU to finish frames referencing them.\n"
+                                "# TYPE rr_pending_releases gauge\n"
+                                "rr_pending_releases {}\n",
+                           deviceContext_->GetSubmissionQueueDepth(), deviceStatistics.pendingReleasesCount);
+
+            return fmt::to_string(buffer);
+        }
+    }
+}
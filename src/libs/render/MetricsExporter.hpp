@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common/threading/SpscQueue.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+        class UploadStreamer;
+
+        // Publishes live counters in Prometheus text format for fleet scraping: CPU and GPU frame time histograms,
+        // GPU time per top level marker, memory budget and per tag GPU memory, upload bytes and queue depths.
+        // Sampling and serving run on the exporter thread. The only work left to render thread is RecordFrame,
+        // a push of a timestamp into wait-free queue.
+        class MetricsExporter final : private NonCopyable
+        {
+        public:
+            struct Description
+            {
+                // TCP port on all interfaces, e.g. scraped as http://node:9464/metrics.
+                uint16_t port = 9464;
+                // Unix domain socket is used instead of TCP port when not empty, for scraping by local agent.
+                U8String unixSocketPath;
+                // Device counters are sampled at this interval, frame times are binned at the same time.
+                uint32_t samplingIntervalMs = 100;
+                // Optional, upload throughput isn't exported without it. Should outlive exporter.
+                const UploadStreamer* uploadStreamer = nullptr;
+            };
+
+            MetricsExporter() = default;
+            ~MetricsExporter();
+
+            void Init(DeviceContext& deviceContext, const Description& description);
+            // Joins exporter thread, before DeviceContext is terminated.
+            void Terminate();
+
+            // False when endpoint couldn't be opened, exporter does nothing then.
+            bool IsAvailable() const { return isAvailable_; }
+
+            // Once per frame by the thread calling MoveToNextFrame. Frame is skipped if exporter thread fell behind.
+            void RecordFrame();
+
+        private:
+            // Upper bounds in seconds, the last bucket is +Inf.
+            static constexpr std::array<double, 11> FrameTimeBuckets = { 0.004, 0.008, 0.0111, 0.0167, 0.02, 0.025, 0.0333, 0.05, 0.0667, 0.1, 0.25 };
+            static constexpr uint32_t MaxPasses = 32;
+
+            struct Histogram final
+            {
+                std::array<uint64_t, FrameTimeBuckets.size() + 1> counts = {};
+                double sum = 0.0;
+                uint64_t count = 0;
+
+                void Observe(double seconds);
+            };
+
+            struct Pass final
+            {
+                U8String name;
+                double seconds;
+            };
+
+            void threadFunc();
+            void sample();
+            void serve(uintptr_t connection) const;
+            U8String formatMetrics() const;
+
+        private:
+            bool inited_ = false;
+            bool isAvailable_ = false;
+            Description description_;
+            DeviceContext* deviceContext_ = nullptr;
+
+            uintptr_t listenSocket_ = ~uintptr_t(0);
+            std::atomic<bool> quit_ = false;
+            Threading::Thread thread_;
+            // Frame end timestamps from render thread.
+            Threading::SpscQueue<uint64_t, 256> frameTimestamps_;
+            std::atomic<uint64_t> skippedFramesCount_ = 0;
+
+            // Owned by exporter thread from here on.
+            uint64_t lastFrameNs_ = 0;
+            uint64_t lastGpuFrameIndex_ = 0;
+            Histogram cpuFrameTime_;
+            Histogram gpuFrameTime_;
+            // Top level markers of the latest frame completed on GPU.
+            std::array<Pass, MaxPasses> passes_;
+            uint32_t passesCount_ = 0;
+
+            uint64_t uploadRateStartBytes_ = 0;
+            uint64_t uploadRateStartNs_ = 0;
+            double uploadBytesPerSecond_ = 0.0;
+        };
+    }
+}
@@ -0,0 +1,125 @@
+#include "MipFeedback.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "common/Math.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        MipFeedback::~MipFeedback()
+        {
+            ASSERT(!inited_);
+        }
+
+        void MipFeedback::Init(DeviceContext& deviceContext, Callback&& callback)
+        {
+            ASSERT(!inited_);
+            ASSERT(callback);
+
+            deviceContext_ = &deviceContext;
+
+            const auto& description = GAPI::GpuResourceDescription::Texture2D(MaxSlots, 1, GAPI::GpuResourceFormat::R32Uint, GAPI::GpuResourceBindFlags::UnorderedAccess, 1, 1);
+            texture_ = deviceContext.CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "Mip feedback");
+            unorderedAccessView_ = deviceContext.CreateUnorderedAccessView(texture_, GAPI::GpuResourceViewDescription::Texture(GAPI::GpuResourceFormat::R32Uint, 0, 1, 0, 1));
+
+            callback_ = std::make_shared<Callback>(std::move(callback));
+
+            // Lowest slots are taken first.
+            freeSlots_.resize(MaxSlots);
+            for (uint32_t index = 0; index < MaxSlots; index++)
+                freeSlots_[index] = MaxSlots - 1 - index;
+
+            clear(deviceContext.GetCommandQueue(GAPI::CommandQueueType::Graphics));
+
+            inited_ = true;
+        }
+
+        void MipFeedback::Terminate()
+        {
+            ASSERT(inited_);
+
+            // Readbacks in flight keep callback alive, owner should ignore feedback arriving after terminate.
+            callback_ = nullptr;
+
+            unorderedAccessView_ = nullptr;
+            texture_ = nullptr;
+            freeSlots_.clear();
+            deviceContext_ = nullptr;
+
+            inited_ = false;
+        }
+
+        uint32_t MipFeedback::AllocateSlot()
+        {
+            ASSERT(inited_);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (freeSlots_.empty())
+                return InvalidSlot;
+
+            const auto slot = freeSlots_.back();
+            freeSlots_.pop_back();
+
+            return slot;
+        }
+
+        void MipFeedback::ReleaseSlot(uint32_t slot)
+        {
+            ASSERT(inited_);
+            ASSERT(slot < MaxSlots);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+            freeSlots_.push_back(slot);
+        }
+
+        uint32_t MipFeedback::GetBindlessIndex() const
+        {
+            ASSERT(inited_);
+            return unorderedAccessView_->GetBindlessIndex();
+        }
+
+        void MipFeedback::Resolve(const GAPI::CommandQueue::SharedPtr& commandQueue)
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+
+            deviceContext_->ReadbackAsync(commandQueue, texture_, [callback = callback_](const GAPI::CpuResourceData::SharedPtr& data) {
+                const auto& allocation = data->GetAllocation();
+                const auto* feedback = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(allocation->Map()) + data->GetSubresourceFootprintAt(0).offset);
+
+                for (uint32_t slot = 0; slot < MaxSlots; slot++)
+                    if (feedback[slot] != NoFeedback)
+                        (*callback)(slot, feedback[slot]);
+
+                allocation->Unmap();
+            });
+
+            clear(commandQueue);
+        }
+
+        void MipFeedback::clear(const GAPI::CommandQueue::SharedPtr& commandQueue) const
+        {
+            ASSERT(commandQueue->GetCommandQueueType() != GAPI::CommandQueueType::Copy);
+
+            auto& deviceContext = *deviceContext_;
+
+            const auto& commandList = commandQueue->GetCommandQueueType() == GAPI::CommandQueueType::Graphics
+                                          ? std::static_pointer_cast<GAPI::ComputeCommandList>(deviceContext.AcquireGraphicsCommandList())
+                                          : deviceContext.AcquireComputeCommandList();
+
+            commandList->ClearUnorderedAccessViewUint(unorderedAccessView_, Vector4u(NoFeedback));
+            commandList->Close();
+
+            deviceContext.Submit(commandQueue, commandList);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <functional>
+
+namespace RR
+{
+    namespace Render
+    {
+        // GPU driven mip feedback. Shaders InterlockedMin the finest sampled mip into the texel of texture slot
+        // of R32Uint UAV, which is read back through async readback ring every frame and reset.
+        // Single feedback texture is used instead of D3D12 sampler feedback maps, which need shader model 6.5
+        // and paired feedback resource per streamed texture.
+        class MipFeedback final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t MaxSlots = 4096;
+            static constexpr uint32_t InvalidSlot = 0xFFFFFFFF;
+            static constexpr uint32_t NoFeedback = 0xFFFFFFFF;
+
+            // Called from job system worker for every slot sampled in the resolved frame.
+            using Callback = std::function<void(uint32_t slot, uint32_t finestMip)>;
+
+            MipFeedback() = default;
+            ~MipFeedback();
+
+            void Init(DeviceContext& deviceContext, Callback&& callback);
+            void Terminate();
+
+            // Returns InvalidSlot once all slots are taken. Released slot could still get feedback of frames in flight.
+            uint32_t AllocateSlot();
+            void ReleaseSlot(uint32_t slot);
+
+            // Index of feedback UAV in bindless heap.
+            uint32_t GetBindlessIndex() const;
+
+            // Call after frame work is submitted. Readback and reset follow frame work on the queue.
+            void Resolve(const std::shared_ptr<GAPI::CommandQueue>& commandQueue);
+
+        private:
+            void clear(const std::shared_ptr<GAPI::CommandQueue>& commandQueue) const;
+
+        private:
+            bool inited_ = false;
+            DeviceContext* deviceContext_ = nullptr;
+            // Shared with readback callbacks, which could outlive feedback.
+            std::shared_ptr<Callback> callback_;
+            std::shared_ptr<GAPI::Texture> texture_;
+            std::shared_ptr<GAPI::UnorderedAccessView> unorderedAccessView_;
+            std::vector<uint32_t> freeSlots_;
+            Threading::Mutex mutex_;
+        };
+    }
+}
@@ -0,0 +1,113 @@
+#include "MsaaResolve.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Limits.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            constexpr const char* ShaderPath = "shaders/MsaaResolve_Resolve.bin";
+        }
+
+        MsaaResolve::~MsaaResolve()
+        {
+            ASSERT(!inited_);
+        }
+
+        void MsaaResolve::Init(DeviceContext& deviceContext)
+        {
+            ASSERT(!inited_);
+
+            inited_ = true;
+
+            pipeline_.Init(deviceContext, ShaderPath, "MsaaResolve", "compute resolve is disabled");
+        }
+
+        void MsaaResolve::Terminate()
+        {
+            ASSERT(inited_);
+
+            pipeline_.Terminate();
+
+            inited_ = false;
+        }
+
+        void MsaaResolve::Resolve(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                                  const std::shared_ptr<GAPI::UnorderedAccessView>& output, float exposure)
+        {
+            ASSERT(exposure > 0.0f);
+
+            Constants constants = {};
+            constants.exposure = exposure;
+
+            dispatch(commandList, source, output, constants);
+        }
+
+        void MsaaResolve::ResolveTonemapped(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                                           const std::shared_ptr<GAPI::UnorderedAccessView>& output, const PostDescription& post)
+        {
+            ASSERT(post.exposure > 0.0f);
+
+            Constants constants = {};
+            constants.isTonemapped = 1;
+            constants.isAces = post.tonemap ? 1 : 0;
+            constants.exposure = post.exposure;
+            std::copy(&post.tint.x, &post.tint.x + 3, constants.tint);
+            constants.saturation = post.saturation;
+            constants.dither = post.dither;
+
+            dispatch(commandList, source, output, constants);
+        }
+
+        void MsaaResolve::dispatch(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                                   const std::shared_ptr<GAPI::UnorderedAccessView>& output, Constants& constants)
+        {
+            ASSERT(inited_);
+            ASSERT(source);
+            ASSERT(output);
+
+            if (!IsAvailable())
+                return;
+
+            const auto& sourceResource = source->GetGpuResource().lock();
+            ASSERT(sourceResource);
+
+            const auto& sourceDescription = sourceResource->GetDescription();
+            ASSERT(sourceDescription.GetSampleCount() > 1);
+            ASSERT(sourceDescription.GetArraySize() == 1);
+
+            constants.sourceIndex = source->GetBindlessIndex();
+            constants.outputIndex = output->GetBindlessIndex();
+            constants.size[0] = sourceDescription.GetWidth();
+            constants.size[1] = sourceDescription.GetHeight();
+            constants.sampleCount = sourceDescription.GetSampleCount();
+
+            const uint32_t groupsX = (constants.size[0] + ThreadGroupSize - 1) / ThreadGroupSize;
+            const uint32_t groupsY = (constants.size[1] + ThreadGroupSize - 1) / ThreadGroupSize;
+            ASSERT(groupsX <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION && groupsY <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            pipeline_.Bind(commandList);
+
+            commandList.BeginMarker("MsaaResolve");
+
+            commandList.TransitionToShaderResource(source);
+            commandList.TransitionToUnorderedAccess(output);
+
+            commandList.SetComputeConstantBuffer(RootParameter::Constants, commandList.AllocateConstants(constants));
+            commandList.SetComputeDescriptorTable(RootParameter::Textures, 0);
+            commandList.SetComputeDescriptorTable(RootParameter::Images, 0);
+
+            commandList.Dispatch(groupsX, groupsY);
+
+            commandList.EndMarker();
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+
+#include "render/ComputePipeline.hpp"
+
+#include "common/Math.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Compute resolve of multisampled HDR color, for MSAA at lower internal resolution instead of supersampling.
+        // Box filter of fixed function resolve lets a single bright sample dominate the edge pixel, so samples are
+        // weighted by 1 / (1 + luminance) of their exposed color, which averages them as if they were tonemapped.
+        // ResolveTonemapped goes further and fuses exposure, tonemapping, grading and dithering of the post chain,
+        // so the multisampled image is read once and averaged in display space.
+        class MsaaResolve final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t ThreadGroupSize = 8;
+
+            // Matches post chain of RenderPassPostProcess.
+            struct PostDescription
+            {
+                float exposure = 1.0f;
+                // ACES filmic curve.
+                bool tonemap = true;
+                Vector3 tint = Vector3(1.0f, 1.0f, 1.0f);
+                float saturation = 1.0f;
+                // Amplitude in 8 bit quantization steps, zero disables dithering.
+                float dither = 1.0f;
+            };
+
+            MsaaResolve() = default;
+            ~MsaaResolve();
+
+            void Init(DeviceContext& deviceContext);
+            void Terminate();
+
+            // False when shader bytecode wasn't found, resolves are skipped then.
+            bool IsAvailable() const { return pipeline_.IsAvailable(); }
+
+            // Source is multisampled float color, output is float UAV of the same size. Output stays linear HDR,
+            // exposure only weights samples and should match the one tonemapping the output later.
+            void Resolve(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                         const std::shared_ptr<GAPI::UnorderedAccessView>& output, float exposure);
+            // Output is UNORM UAV of the same size, gamma is applied in shader as sRGB formats can't be written as UAVs.
+            void ResolveTonemapped(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                                   const std::shared_ptr<GAPI::UnorderedAccessView>& output, const PostDescription& post);
+
+        private:
+            enum RootParameter : uint32_t
+            {
+                Constants,
+                Textures,
+                Images
+            };
+
+            // Matches layout in shaders/MsaaResolve.slang.
+            struct Constants final
+            {
+                uint32_t sourceIndex;
+                uint32_t outputIndex;
+                uint32_t size[2];
+                uint32_t sampleCount;
+                uint32_t isTonemapped;
+                uint32_t isAces;
+                float exposure;
+                float tint[3];
+                float saturation;
+                float dither;
+                uint32_t padding[3];
+            };
+
+            void dispatch(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& source,
+                          const std::shared_ptr<GAPI::UnorderedAccessView>& output, Constants& constants);
+
+        private:
+            bool inited_ = false;
+
+            ComputePipeline pipeline_;
+        };
+    }
+}
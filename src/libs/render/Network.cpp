@@ -0,0 +1,197 @@
+#include "Network.hpp"
+
+#ifdef OS_WINDOWS
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace Network
+        {
+            namespace
+            {
+#ifdef OS_WINDOWS
+                using NativeSocket = SOCKET;
+                using TransferSize = int;
+
+                void closeSocket(NativeSocket socket) { closesocket(socket); }
+                bool isWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK || WSAGetLastError() == WSAETIMEDOUT; }
+
+                // Winsock is initialized once per process and stays up until exit.
+                bool initNetwork()
+                {
+                    static const bool inited = []() {
+                        WSADATA data;
+                        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+                    }();
+
+                    return inited;
+                }
+#else
+                using NativeSocket = int;
+                using TransferSize = size_t;
+
+                void closeSocket(NativeSocket socket) { close(socket); }
+                bool isWouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+                bool initNetwork() { return true; }
+#endif
+
+                // Single transfer is limited by int on Windows.
+                constexpr size_t MaxTransferSize = 1 << 30;
+
+#ifdef MSG_NOSIGNAL
+                // Lost connection is reported by send result, not by SIGPIPE.
+                constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+                constexpr int SendFlags = 0;
+#endif
+
+                NativeSocket toNative(uintptr_t handle) { return static_cast<NativeSocket>(handle); }
+            }
+
+            uintptr_t Listen(uint16_t port, const U8String& unixSocketPath)
+            {
+                if (!initNetwork())
+                    return InvalidSocket;
+
+                const bool isUnix = !unixSocketPath.empty();
+                const auto handle = ::socket(isUnix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+                if (static_cast<uintptr_t>(handle) == InvalidSocket)
+                    return InvalidSocket;
+
+                int result;
+                if (isUnix)
+                {
+                    sockaddr_un address = {};
+                    address.sun_family = AF_UNIX;
+                    if (unixSocketPath.size() >= sizeof(address.sun_path))
+                    {
+                        closeSocket(handle);
+                        return InvalidSocket;
+                    }
+
+                    std::memcpy(address.sun_path, unixSocketPath.c_str(), unixSocketPath.size());
+
+                    // Left over by previous run of the process.
+                    std::remove(unixSocketPath.c_str());
+                    result = bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+                }
+                else
+                {
+                    int reuseAddress = 1;
+                    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+
+                    sockaddr_in address = {};
+                    address.sin_family = AF_INET;
+                    address.sin_addr.s_addr = htonl(INADDR_ANY);
+                    address.sin_port = htons(port);
+
+                    result = bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+                }
+
+                if (result != 0 || listen(handle, SOMAXCONN) != 0)
+                {
+                    closeSocket(handle);
+                    return InvalidSocket;
+                }
+
+                return static_cast<uintptr_t>(handle);
+            }
+
+            uintptr_t Accept(uintptr_t listenSocket)
+            {
+                ASSERT(listenSocket != InvalidSocket);
+
+                const auto handle = accept(toNative(listenSocket), nullptr, nullptr);
+                return static_cast<uintptr_t>(handle);
+            }
+
+            void Close(uintptr_t socket)
+            {
+                if (socket != InvalidSocket)
+                    closeSocket(toNative(socket));
+            }
+
+            void SetTimeout(uintptr_t socket, uint32_t timeoutMs)
+            {
+                ASSERT(socket != InvalidSocket);
+
+#ifdef OS_WINDOWS
+                const DWORD timeout = timeoutMs;
+#else
+                const timeval timeout = { static_cast<time_t>(timeoutMs / 1000), static_cast<suseconds_t>(timeoutMs % 1000 * 1000) };
+#endif
+                setsockopt(toNative(socket), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+                setsockopt(toNative(socket), SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+            }
+
+            void SetNonBlocking(uintptr_t socket)
+            {
+                ASSERT(socket != InvalidSocket);
+
+#ifdef OS_WINDOWS
+                u_long nonBlocking = 1;
+                ioctlsocket(toNative(socket), FIONBIO, &nonBlocking);
+#else
+                fcntl(toNative(socket), F_SETFL, fcntl(toNative(socket), F_GETFL, 0) | O_NONBLOCK);
+#endif
+            }
+
+            bool WaitReadable(uintptr_t socket, uint64_t timeoutNs)
+            {
+                ASSERT(socket != InvalidSocket);
+
+                fd_set readSet;
+                FD_ZERO(&readSet);
+                FD_SET(toNative(socket), &readSet);
+
+                timeval timeout;
+                timeout.tv_sec = static_cast<long>(timeoutNs / 1'000'000'000);
+                timeout.tv_usec = static_cast<long>(timeoutNs % 1'000'000'000 / 1000);
+
+                // First argument is ignored on Windows.
+                return select(static_cast<int>(toNative(socket)) + 1, &readSet, nullptr, nullptr, &timeout) > 0;
+            }
+
+            int64_t Send(uintptr_t socket, const void* data, size_t size)
+            {
+                ASSERT(socket != InvalidSocket);
+
+                const auto chunk = static_cast<TransferSize>(std::min(size, MaxTransferSize));
+                const auto sent = send(toNative(socket), static_cast<const char*>(data), chunk, SendFlags);
+                if (sent < 0)
+                    return isWouldBlock() ? 0 : -1;
+
+                return sent;
+            }
+
+            int64_t Receive(uintptr_t socket, void* data, size_t size)
+            {
+                ASSERT(socket != InvalidSocket);
+
+                const auto chunk = static_cast<TransferSize>(std::min(size, MaxTransferSize));
+                const auto received = recv(toNative(socket), static_cast<char*>(data), chunk, 0);
+                if (received < 0)
+                    return isWouldBlock() ? 0 : -1;
+
+                // Orderly shutdown by peer.
+                return received == 0 ? -1 : received;
+            }
+        }
+    }
+}
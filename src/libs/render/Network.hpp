@@ -0,0 +1,31 @@
+#pragma once
+
+namespace RR
+{
+    namespace Render
+    {
+        // Sockets of debug endpoints, metrics and remote profiling. Handles are uintptr_t, as SOCKET is pointer sized on Windows.
+        namespace Network
+        {
+            static constexpr uintptr_t InvalidSocket = ~uintptr_t(0);
+
+            // TCP port on all interfaces, or Unix domain socket when path isn't empty. InvalidSocket on failure.
+            uintptr_t Listen(uint16_t port, const U8String& unixSocketPath);
+            // Doesn't block if WaitReadable reported the listening socket. InvalidSocket on failure.
+            uintptr_t Accept(uintptr_t listenSocket);
+            void Close(uintptr_t socket);
+
+            // Blocking calls on the socket fail after timeout instead of waiting forever.
+            void SetTimeout(uintptr_t socket, uint32_t timeoutMs);
+            void SetNonBlocking(uintptr_t socket);
+
+            // True when socket has data or listening socket has a connection before timeout.
+            bool WaitReadable(uintptr_t socket, uint64_t timeoutNs);
+
+            // Partial transfers. Bytes transferred, zero when non-blocking socket isn't ready or timeout expired,
+            // negative when connection is closed or lost.
+            int64_t Send(uintptr_t socket, const void* data, size_t size);
+            int64_t Receive(uintptr_t socket, void* data, size_t size);
+        }
+    }
+}
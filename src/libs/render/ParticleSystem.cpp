@@ -0,0 +1,342 @@
+#include "ParticleSystem.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Limits.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            // Compiled by rfx from bin/shaders/Particles.slang. Root signature is embedded, all passes share it.
+            constexpr std::array<const char*, 5> ComputeShaderPaths = {
+                "shaders/Particles_Reset.bin",
+                "shaders/Particles_Emit.bin",
+                "shaders/Particles_WriteDispatchArguments.bin",
+                "shaders/Particles_Simulate.bin",
+                "shaders/Particles_WriteDrawArguments.bin",
+            };
+            constexpr const char* VertexShaderPath = "shaders/Particles_DrawVertex.bin";
+            constexpr const char* PixelShaderPath = "shaders/Particles_DrawPixel.bin";
+
+            // Particle is position, age, velocity, lifetime, color and size packed into four float4.
+            constexpr uint32_t ParticleSize = 64;
+
+            inline uint32_t getThreadGroupsCount(uint32_t threadsCount)
+            {
+                return (threadsCount + ParticleSystem::ThreadGroupSize - 1) / ParticleSystem::ThreadGroupSize;
+            }
+        }
+
+        ParticleSystem::~ParticleSystem()
+        {
+            ASSERT(!inited_);
+        }
+
+        void ParticleSystem::Init(DeviceContext& deviceContext, const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.maxParticles > 0);
+            ASSERT(getThreadGroupsCount(description.maxParticles) <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            deviceContext_ = &deviceContext;
+            description_ = description;
+            currentAliveList_ = 0;
+            frameIndex_ = 0;
+            inited_ = true;
+
+            GAPI::PipelineStateDescription drawDescription;
+            drawDescription.type = GAPI::PipelineStateType::Graphics;
+            drawDescription.renderTargetCount = 1;
+            drawDescription.renderTargetFormats[0] = description.renderTargetFormat;
+            drawDescription.depthStencilFormat = description.depthStencilFormat;
+
+            if (!GAPI::PipelineStateDescription::ReadShader(VertexShaderPath, drawDescription.vertexShader) ||
+                !GAPI::PipelineStateDescription::ReadShader(PixelShaderPath, drawDescription.pixelShader))
+            {
+                Log::Print::Warning("Particle shaders not found, particles are disabled.\n");
+                return;
+            }
+
+            for (uint32_t pass = 0; pass < Pass::Count; pass++)
+            {
+                GAPI::PipelineStateDescription computeDescription;
+                computeDescription.type = GAPI::PipelineStateType::Compute;
+
+                if (!GAPI::PipelineStateDescription::ReadShader(ComputeShaderPaths[pass], computeDescription.computeShader))
+                {
+                    Log::Print::Warning("Particle shader \"%s\" not found, particles are disabled.\n", ComputeShaderPaths[pass]);
+                    return;
+                }
+
+                computePipelines_[pass] = deviceContext.CreatePipelineState(computeDescription, "Particles");
+            }
+
+            drawPipeline_ = deviceContext.CreatePipelineState(drawDescription, "Particles");
+
+            const auto bindFlags = GAPI::GpuResourceBindFlags::ShaderResource | GAPI::GpuResourceBindFlags::UnorderedAccess;
+            const auto createBuffer = [&](uint32_t size, const U8String& name) {
+                return deviceContext.CreateBuffer(GAPI::GpuResourceDescription::Buffer(size, bindFlags), GAPI::GpuResourceCpuAccess::None, name);
+            };
+            // Raw views address 32-bit values.
+            const auto createUav = [&](const std::shared_ptr<GAPI::Buffer>& buffer, uint32_t firstValue, uint32_t valuesCount) {
+                return deviceContext.CreateUnorderedAccessView(buffer, GAPI::GpuResourceViewDescription::Buffer(GAPI::GpuResourceFormat::R32Uint, firstValue, valuesCount));
+            };
+            const auto createSrv = [&](const std::shared_ptr<GAPI::Buffer>& buffer, uint32_t valuesCount) {
+                return deviceContext.CreateShaderResourceView(buffer, GAPI::GpuResourceViewDescription::Buffer(GAPI::GpuResourceFormat::R32Uint, 0, valuesCount));
+            };
+
+            const auto maxParticles = description.maxParticles;
+            const auto particleValues = ParticleSize / sizeof(uint32_t);
+
+            particles_ = createBuffer(maxParticles * ParticleSize, "Particles");
+            deadList_ = createBuffer(maxParticles * sizeof(uint32_t), "Particles dead list");
+            counters_ = createBuffer(CountersCount * sizeof(uint32_t), "Particles counters");
+            arguments_ = createBuffer(DrawArgumentsOffset + sizeof(GAPI::DrawIndexedArguments), "Particles arguments");
+
+            particlesUav_ = createUav(particles_, 0, maxParticles * particleValues);
+            particlesSrv_ = createSrv(particles_, maxParticles * particleValues);
+            deadListUav_ = createUav(deadList_, 0, maxParticles);
+            countersUav_ = createUav(counters_, 0, CountersCount);
+            argumentsUav_ = createUav(arguments_, 0, (DrawArgumentsOffset + sizeof(GAPI::DrawIndexedArguments)) / sizeof(uint32_t));
+
+            for (uint32_t list = 0; list < 2; list++)
+            {
+                aliveLists_[list] = createBuffer(maxParticles * sizeof(uint32_t), "Particles alive list");
+                aliveListUavs_[list] = createUav(aliveLists_[list], 0, maxParticles);
+                aliveListSrvs_[list] = createSrv(aliveLists_[list], maxParticles);
+                aliveCounterUavs_[list] = createUav(counters_, AliveCounters + list, 1);
+            }
+
+            // Two triangles of camera facing quad, instanced per live particle.
+            static constexpr uint16_t QuadIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+            const auto& indicesDescription = GAPI::GpuResourceDescription::Buffer(sizeof(QuadIndices));
+            quadIndices_ = deviceContext.CreateBuffer(indicesDescription, GAPI::GpuResourceCpuAccess::None, "Particles quad indices");
+
+            const auto indicesData = deviceContext.AllocateIntermediateResourceData(indicesDescription, GAPI::MemoryAllocationType::CpuReadWrite);
+            indicesData->WriteSubresource(0, QuadIndices, sizeof(QuadIndices));
+
+            const auto& commandList = deviceContext.AcquireGraphicsCommandList();
+            commandList->UpdateGpuResource(quadIndices_, indicesData);
+
+            SimulationConstants constants = {};
+            fillSimulationConstants(constants);
+            reset(*commandList, constants);
+
+            commandList->Close();
+            deviceContext.Submit(deviceContext.GetCommandQueue(GAPI::CommandQueueType::Graphics), commandList);
+
+            isAvailable_ = true;
+        }
+
+        void ParticleSystem::Terminate()
+        {
+            ASSERT(inited_);
+
+            aliveListSrvs_ = {};
+            particlesSrv_ = nullptr;
+            argumentsUav_ = nullptr;
+            aliveCounterUavs_ = {};
+            countersUav_ = nullptr;
+            aliveListUavs_ = {};
+            deadListUav_ = nullptr;
+            particlesUav_ = nullptr;
+
+            quadIndices_ = nullptr;
+            arguments_ = nullptr;
+            counters_ = nullptr;
+            aliveLists_ = {};
+            deadList_ = nullptr;
+            particles_ = nullptr;
+
+            drawPipeline_ = nullptr;
+            computePipelines_ = {};
+            spawnRemainders_.clear();
+            deviceContext_ = nullptr;
+
+            isAvailable_ = false;
+            inited_ = false;
+        }
+
+        void ParticleSystem::Simulate(GAPI::ComputeCommandList& commandList, float deltaTime, const std::vector<ParticleEmitter>& emitters)
+        {
+            ASSERT(inited_);
+            ASSERT(emitters.size() <= MaxEmitters);
+
+            if (!isAvailable_)
+                return;
+
+            const uint32_t previousAliveList = currentAliveList_;
+            currentAliveList_ ^= 1;
+            frameIndex_++;
+
+            SimulationConstants constants = {};
+            fillSimulationConstants(constants);
+            // Emission appends to alive list of the previous frame, so new particles are simulated right away.
+            constants.aliveListIndex = aliveListUavs_[previousAliveList]->GetBindlessIndex();
+            constants.nextAliveListIndex = aliveListUavs_[currentAliveList_]->GetBindlessIndex();
+            constants.aliveCounter = AliveCounters + previousAliveList;
+            constants.nextAliveCounter = AliveCounters + currentAliveList_;
+            constants.deltaTime = deltaTime;
+            constants.emittersCount = static_cast<uint32_t>(emitters.size());
+
+            spawnRemainders_.resize(emitters.size(), 0.0f);
+
+            uint32_t emittedCount = 0;
+            for (uint32_t index = 0; index < emitters.size(); index++)
+            {
+                const auto& emitter = emitters[index];
+                auto& emitterConstants = constants.emitters[index];
+
+                const float spawnCount = spawnRemainders_[index] + Max(emitter.spawnRate, 0.0f) * deltaTime;
+                // GPU drops what doesn't fit into dead list, so count is only bounded by pool size.
+                const uint32_t particlesCount = Min(static_cast<uint32_t>(spawnCount), description_.maxParticles - emittedCount);
+                spawnRemainders_[index] = spawnCount - static_cast<float>(static_cast<uint32_t>(spawnCount));
+
+                std::copy(&emitter.position.x, &emitter.position.x + 3, emitterConstants.position);
+                std::copy(&emitter.velocity.x, &emitter.velocity.x + 3, emitterConstants.velocity);
+                std::copy(&emitter.color.x, &emitter.color.x + 4, emitterConstants.color);
+                emitterConstants.firstParticle = emittedCount;
+                emitterConstants.particlesCount = particlesCount;
+                emitterConstants.lifetime = emitter.lifetime;
+                emitterConstants.size = emitter.size;
+                emitterConstants.positionSpread = emitter.positionSpread;
+                emitterConstants.velocitySpread = emitter.velocitySpread;
+
+                emittedCount += particlesCount;
+            }
+
+            constants.emittedCount = emittedCount;
+
+            commandList.BeginMarker("Particles");
+
+            const auto constantsAddress = commandList.AllocateConstants(constants);
+
+            commandList.TransitionToUnorderedAccess(particlesUav_);
+            commandList.TransitionToUnorderedAccess(deadListUav_);
+            commandList.TransitionToUnorderedAccess(aliveListUavs_[0]);
+            commandList.TransitionToUnorderedAccess(aliveListUavs_[1]);
+            commandList.TransitionToUnorderedAccess(countersUav_);
+            commandList.TransitionToUnorderedAccess(argumentsUav_);
+
+            // Survivors of this frame are appended from zero.
+            commandList.ClearUnorderedAccessViewUint(aliveCounterUavs_[currentAliveList_], Vector4u(0));
+
+            if (emittedCount > 0)
+            {
+                bindPass(commandList, Pass::Emit, constantsAddress);
+                commandList.Dispatch(getThreadGroupsCount(emittedCount));
+            }
+            unorderedAccessBarrier(commandList);
+
+            bindPass(commandList, Pass::WriteDispatchArguments, constantsAddress);
+            commandList.Dispatch(1);
+            unorderedAccessBarrier(commandList);
+
+            bindPass(commandList, Pass::Simulate, constantsAddress);
+            commandList.DispatchIndirect(arguments_, DispatchArgumentsOffset);
+            unorderedAccessBarrier(commandList);
+
+            // Draw reads them, transitions overlap with the rest of simulation.
+            commandList.BeginTransitionToShaderResource(particlesSrv_);
+            commandList.BeginTransitionToShaderResource(aliveListSrvs_[currentAliveList_]);
+
+            bindPass(commandList, Pass::WriteDrawArguments, constantsAddress);
+            commandList.Dispatch(1);
+
+            commandList.EndMarker();
+        }
+
+        void ParticleSystem::Draw(GAPI::GraphicsCommandList& commandList, const Matrix4& viewProjection, const Vector3& cameraRight, const Vector3& cameraUp)
+        {
+            ASSERT(inited_);
+
+            if (!isAvailable_)
+                return;
+
+            DrawConstants constants;
+            std::copy(&viewProjection.e00, &viewProjection.e00 + 16, constants.viewProjection);
+            std::copy(&cameraRight.x, &cameraRight.x + 3, constants.cameraRight);
+            std::copy(&cameraUp.x, &cameraUp.x + 3, constants.cameraUp);
+            constants.particlesIndex = particlesSrv_->GetBindlessIndex();
+            constants.aliveListIndex = aliveListSrvs_[currentAliveList_]->GetBindlessIndex();
+
+            if (!commandList.SetGraphicsPipelineState(drawPipeline_))
+                return;
+
+            commandList.BeginMarker("Particles");
+
+            commandList.TransitionToShaderResource(particlesSrv_);
+            commandList.TransitionToShaderResource(aliveListSrvs_[currentAliveList_]);
+
+            commandList.SetGraphicsConstantBuffer(RootParameter::Constants, commandList.AllocateConstants(constants));
+            commandList.SetGraphicsDescriptorTable(RootParameter::Buffers, 0);
+            commandList.SetGraphicsDescriptorTable(RootParameter::ReadOnlyBuffers, 0);
+            commandList.SetIndexBuffer(quadIndices_, GAPI::GpuResourceFormat::R16Uint);
+            commandList.ExecuteIndirect(arguments_, DrawArgumentsOffset, 1, nullptr, 0);
+
+            commandList.EndMarker();
+        }
+
+        void ParticleSystem::reset(GAPI::ComputeCommandList& commandList, const SimulationConstants& constants)
+        {
+            commandList.TransitionToUnorderedAccess(deadListUav_);
+            commandList.TransitionToUnorderedAccess(countersUav_);
+            commandList.TransitionToUnorderedAccess(argumentsUav_);
+
+            // Draw arguments stay valid until the first simulation writes them.
+            commandList.ClearUnorderedAccessViewUint(argumentsUav_, Vector4u(0));
+
+            bindPass(commandList, Pass::Reset, commandList.AllocateConstants(constants));
+            commandList.Dispatch(getThreadGroupsCount(description_.maxParticles));
+        }
+
+        void ParticleSystem::bindPass(GAPI::ComputeCommandList& commandList, Pass pass, uint64_t constantsAddress) const
+        {
+            // Pipelines aren't compiled asynchronously, so they are always resolved.
+            const bool isBound = commandList.SetComputePipelineState(computePipelines_[pass]);
+            ASSERT(isBound);
+            std::ignore = isBound;
+
+            commandList.SetComputeConstantBuffer(RootParameter::Constants, constantsAddress);
+            commandList.SetComputeDescriptorTable(RootParameter::Buffers, 0);
+            commandList.SetComputeDescriptorTable(RootParameter::ReadOnlyBuffers, 0);
+        }
+
+        void ParticleSystem::unorderedAccessBarrier(GAPI::ComputeCommandList& commandList) const
+        {
+            commandList.UnorderedAccessBarrier(particles_);
+            commandList.UnorderedAccessBarrier(deadList_);
+            commandList.UnorderedAccessBarrier(aliveLists_[0]);
+            commandList.UnorderedAccessBarrier(aliveLists_[1]);
+            commandList.UnorderedAccessBarrier(counters_);
+            commandList.UnorderedAccessBarrier(arguments_);
+        }
+
+        void ParticleSystem::fillSimulationConstants(SimulationConstants& constants) const
+        {
+            constants.particlesIndex = particlesUav_->GetBindlessIndex();
+            constants.deadListIndex = deadListUav_->GetBindlessIndex();
+            constants.countersIndex = countersUav_->GetBindlessIndex();
+            constants.argumentsIndex = argumentsUav_->GetBindlessIndex();
+            constants.aliveListIndex = aliveListUavs_[currentAliveList_]->GetBindlessIndex();
+            constants.nextAliveListIndex = aliveListUavs_[currentAliveList_ ^ 1]->GetBindlessIndex();
+            constants.aliveCounter = AliveCounters + currentAliveList_;
+            constants.nextAliveCounter = AliveCounters + (currentAliveList_ ^ 1);
+            std::copy(&description_.gravity.x, &description_.gravity.x + 3, constants.gravity);
+            constants.maxParticles = description_.maxParticles;
+            constants.seed = frameIndex_;
+        }
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceFormat.hpp"
+
+#include "common/Math.hpp"
+
+#include <array>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        struct ParticleEmitter
+        {
+            Vector3 position = Vector3(0.0f);
+            // Radius of sphere particles are spawned in.
+            float positionSpread = 0.0f;
+            Vector3 velocity = Vector3(0.0f);
+            float velocitySpread = 0.0f;
+            Vector4 color = Vector4(1.0f);
+            // Particles per second, fractions are carried over to the next frame.
+            float spawnRate = 0.0f;
+            // Seconds.
+            float lifetime = 1.0f;
+            float size = 0.1f;
+        };
+
+        // Particles are emitted, simulated and compacted entirely on GPU, CPU only uploads emitter constants per frame.
+        // Free particles are kept in dead list, live ones in pair of alive lists swapped every frame: simulation appends
+        // survivors to the next list and returns expired ones to dead list. Append buffers are raw buffers with counters
+        // in separate buffer, since backend doesn't expose UAV counter resources. Indirect arguments of simulation dispatch
+        // and draw are written by GPU from counters, so live particles count is never read back.
+        class ParticleSystem final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t MaxEmitters = 32;
+            static constexpr uint32_t ThreadGroupSize = 64;
+
+            struct Description
+            {
+                uint32_t maxParticles = 65536;
+                Vector3 gravity = Vector3(0.0f, -9.8f, 0.0f);
+                GAPI::GpuResourceFormat renderTargetFormat = GAPI::GpuResourceFormat::Unknown;
+                GAPI::GpuResourceFormat depthStencilFormat = GAPI::GpuResourceFormat::Unknown;
+            };
+
+            ParticleSystem() = default;
+            ~ParticleSystem();
+
+            // Buffers are reset on graphics queue of the context.
+            void Init(DeviceContext& deviceContext, const Description& description);
+            void Terminate();
+
+            // False when shader bytecode wasn't found, simulation and draws are skipped then.
+            bool IsAvailable() const { return isAvailable_; }
+
+            // Once per frame, records emission and simulation. Emitters are matched with previous frame by index.
+            void Simulate(GAPI::ComputeCommandList& commandList, float deltaTime, const std::vector<ParticleEmitter>& emitters);
+            // Camera facing quads into render targets set by the caller. Opaque, sprites are cut out to discs.
+            void Draw(GAPI::GraphicsCommandList& commandList, const Matrix4& viewProjection, const Vector3& cameraRight, const Vector3& cameraUp);
+
+        private:
+            enum Pass : uint32_t
+            {
+                Reset,
+                Emit,
+                WriteDispatchArguments,
+                Simulate,
+                WriteDrawArguments,
+                Count
+            };
+
+            enum RootParameter : uint32_t
+            {
+                Constants,
+                Buffers,
+                ReadOnlyBuffers
+            };
+
+            // Matches layout in shaders/Particles.slang.
+            struct EmitterConstants final
+            {
+                float position[3];
+                uint32_t firstParticle;
+                float velocity[3];
+                uint32_t particlesCount;
+                float color[4];
+                float lifetime;
+                float size;
+                float positionSpread;
+                float velocitySpread;
+            };
+
+            struct SimulationConstants final
+            {
+                uint32_t particlesIndex;
+                uint32_t deadListIndex;
+                uint32_t aliveListIndex;
+                uint32_t nextAliveListIndex;
+                uint32_t countersIndex;
+                uint32_t argumentsIndex;
+                uint32_t aliveCounter;
+                uint32_t nextAliveCounter;
+                float gravity[3];
+                float deltaTime;
+                uint32_t maxParticles;
+                uint32_t emittersCount;
+                uint32_t emittedCount;
+                uint32_t seed;
+                EmitterConstants emitters[MaxEmitters];
+            };
+
+            struct DrawConstants final
+            {
+                float viewProjection[16];
+                float cameraRight[3];
+                uint32_t particlesIndex;
+                float cameraUp[3];
+                uint32_t aliveListIndex;
+            };
+
+            // Counters buffer layout in 32-bit values.
+            static constexpr uint32_t DeadCounter = 0;
+            static constexpr uint32_t AliveCounters = 1;
+            static constexpr uint32_t CountersCount = 4;
+            // Arguments buffer holds DispatchArguments of simulation followed by DrawIndexedArguments.
+            static constexpr uint32_t DispatchArgumentsOffset = 0;
+            static constexpr uint32_t DrawArgumentsOffset = 16;
+
+            void reset(GAPI::ComputeCommandList& commandList, const SimulationConstants& constants);
+            void bindPass(GAPI::ComputeCommandList& commandList, Pass pass, uint64_t constantsAddress) const;
+            void unorderedAccessBarrier(GAPI::ComputeCommandList& commandList) const;
+            void fillSimulationConstants(SimulationConstants& constants) const;
+
+        private:
+            bool inited_ = false;
+            bool isAvailable_ = false;
+            Description description_;
+            DeviceContext* deviceContext_ = nullptr;
+            // Alive list filled by the latest simulation.
+            uint32_t currentAliveList_ = 0;
+            uint32_t frameIndex_ = 0;
+            // Fractional particles not emitted yet, per emitter.
+            std::vector<float> spawnRemainders_;
+
+            std::array<std::shared_ptr<GAPI::PipelineState>, Pass::Count> computePipelines_;
+            std::shared_ptr<GAPI::PipelineState> drawPipeline_;
+
+            std::shared_ptr<GAPI::Buffer> particles_;
+            std::shared_ptr<GAPI::Buffer> deadList_;
+            std::array<std::shared_ptr<GAPI::Buffer>, 2> aliveLists_;
+            std::shared_ptr<GAPI::Buffer> counters_;
+            std::shared_ptr<GAPI::Buffer> arguments_;
+            std::shared_ptr<GAPI::Buffer> quadIndices_;
+
+            std::shared_ptr<GAPI::UnorderedAccessView> particlesUav_;
+            std::shared_ptr<GAPI::UnorderedAccessView> deadListUav_;
+            std::array<std::shared_ptr<GAPI::UnorderedAccessView>, 2> aliveListUavs_;
+            std::shared_ptr<GAPI::UnorderedAccessView> countersUav_;
+            // Single counter views, cleared before alive list is refilled.
+            std::array<std::shared_ptr<GAPI::UnorderedAccessView>, 2> aliveCounterUavs_;
+            std::shared_ptr<GAPI::UnorderedAccessView> argumentsUav_;
+            std::shared_ptr<GAPI::ShaderResourceView> particlesSrv_;
+            std::array<std::shared_ptr<GAPI::ShaderResourceView>, 2> aliveListSrvs_;
+        };
+    }
+}
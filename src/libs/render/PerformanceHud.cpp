@@ -0,0 +1,352 @@
+#include "PerformanceHud.hpp"
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "common/debug/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            // Compiled by rfx from bin/shaders/PerformanceHud.slang, root signature is embedded.
+            constexpr const char* VertexShaderPath = "shaders/PerformanceHud_DrawVertex.bin";
+            constexpr const char* PixelShaderPath = "shaders/PerformanceHud_DrawPixel.bin";
+
+            // Screen pixels between target corner and panel.
+            constexpr uint32_t Margin = 8;
+            // Columns of GPU marker bar at whole GPU frame time.
+            constexpr uint32_t BarColumns = 16;
+            constexpr uint32_t PassNameColumns = 20;
+            constexpr uint32_t QueueDepthWarning = 16;
+            constexpr double OccupancyWarning = 0.75;
+            constexpr double OccupancyBad = 0.9;
+            constexpr uint64_t BytesPerMegabyte = 1024 * 1024;
+
+            constexpr std::array<const char*, static_cast<size_t>(GAPI::DescriptorHeapType::Count)> DescriptorHeapNames = {
+                "CBV/SRV/UAV",
+                "RTV",
+                "Bindless",
+            };
+
+            // 3x5 glyphs, rows top to bottom, the most significant bit is top left pixel. Lower case is drawn as upper case.
+            constexpr std::array<uint16_t, 128> makeFont()
+            {
+                std::array<uint16_t, 128> font = {};
+
+                // Unknown characters.
+                for (auto& glyph : font)
+                    glyph = 0b111'001'011'000'010;
+
+                font[' '] = 0;
+                font['0'] = 0b111'101'101'101'111;
+                font['1'] = 0b010'110'010'010'111;
+                font['2'] = 0b111'001'111'100'111;
+                font['3'] = 0b111'001'111'001'111;
+                font['4'] = 0b101'101'111'001'001;
+                font['5'] = 0b111'100'111'001'111;
+                font['6'] = 0b111'100'111'101'111;
+                font['7'] = 0b111'001'001'001'001;
+                font['8'] = 0b111'101'111'101'111;
+                font['9'] = 0b111'101'111'001'111;
+                font['A'] = 0b010'101'111'101'101;
+                font['B'] = 0b110'101'110'101'110;
+                font['C'] = 0b011'100'100'100'011;
+                font['D'] = 0b110'101'101'101'110;
+                font['E'] = 0b111'100'110'100'111;
+                font['F'] = 0b111'100'110'100'100;
+                font['G'] = 0b011'100'101'101'011;
+                font['H'] = 0b101'101'111'101'101;
+                font['I'] = 0b111'010'010'010'111;
+                font['J'] = 0b001'001'001'101'010;
+                font['K'] = 0b101'101'110'101'101;
+                font['L'] = 0b100'100'100'100'111;
+                font['M'] = 0b101'111'111'101'101;
+                font['N'] = 0b110'101'101'101'101;
+                font['O'] = 0b010'101'101'101'010;
+                font['P'] = 0b110'101'110'100'100;
+                font['Q'] = 0b010'101'101'110'011;
+                font['R'] = 0b110'101'110'101'101;
+                font['S'] = 0b011'100'010'001'110;
+                font['T'] = 0b111'010'010'010'010;
+                font['U'] = 0b101'101'101'101'111;
+                font['V'] = 0b101'101'101'101'010;
+                font['W'] = 0b101'101'111'111'101;
+                font['X'] = 0b101'101'010'101'101;
+                font['Y'] = 0b101'101'010'010'010;
+                font['Z'] = 0b111'001'010'100'111;
+                font['.'] = 0b000'000'000'000'010;
+                font[','] = 0b000'000'000'010'100;
+                font[':'] = 0b000'010'000'010'000;
+                font['%'] = 0b101'001'010'100'101;
+                font['/'] = 0b001'001'010'100'100;
+                font['-'] = 0b000'000'111'000'000;
+                font['+'] = 0b000'010'111'010'000;
+                font['='] = 0b000'111'000'111'000;
+                font['_'] = 0b000'000'000'000'111;
+                font['|'] = 0b010'010'010'010'010;
+                font['('] = 0b001'010'010'010'001;
+                font[')'] = 0b100'010'010'010'100;
+                font['['] = 0b011'010'010'010'011;
+                font[']'] = 0b110'010'010'010'110;
+                font['<'] = 0b001'010'100'010'001;
+                font['>'] = 0b100'010'001'010'100;
+                // Bars are drawn with full cells.
+                font['#'] = 0b111'111'111'111'111;
+
+                for (char character = 'a'; character <= 'z'; character++)
+                    font[character] = font[character - 'a' + 'A'];
+
+                return font;
+            }
+
+            constexpr std::array<uint16_t, 128> Font = makeFont();
+
+            // Glyph bits | color << 15 | column << 18 | row << 25, see DrawVertex.
+            inline uint32_t packGlyph(char character, uint32_t color, uint32_t column, uint32_t row)
+            {
+                static_assert(PerformanceHud::MaxColumns <= 128 && PerformanceHud::MaxRows <= 128);
+
+                const auto glyph = Font[static_cast<uint8_t>(character) & 0x7F];
+                return glyph | (color << 15) | (column << 18) | (row << 25);
+            }
+        }
+
+        PerformanceHud::~PerformanceHud()
+        {
+            ASSERT(!inited_);
+        }
+
+        void PerformanceHud::Init(DeviceContext& deviceContext, const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.scale > 0);
+            ASSERT(description.smoothing > 0.0f && description.smoothing <= 1.0f);
+
+            deviceContext_ = &deviceContext;
+            description_ = description;
+            visible_.store(description.visible, std::memory_order_relaxed);
+            inited_ = true;
+
+            GAPI::PipelineStateDescription pipelineDescription;
+            pipelineDescription.type = GAPI::PipelineStateType::Graphics;
+            pipelineDescription.renderTargetCount = 1;
+            pipelineDescription.renderTargetFormats[0] = description.renderTargetFormat;
+
+            if (!GAPI::PipelineStateDescription::ReadShader(VertexShaderPath, pipelineDescription.vertexShader) ||
+                !GAPI::PipelineStateDescription::ReadShader(PixelShaderPath, pipelineDescription.pixelShader))
+            {
+                Log::Print::Warning("Performance HUD shaders not found, HUD is disabled.\n");
+                return;
+            }
+
+            pipeline_ = deviceContext.CreatePipelineState(pipelineDescription, "PerformanceHud");
+
+            // Two triangles of glyph cell, instanced per glyph.
+            static constexpr uint16_t QuadIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+            const auto& indicesDescription = GAPI::GpuResourceDescription::Buffer(sizeof(QuadIndices));
+            quadIndices_ = deviceContext.CreateBuffer(indicesDescription, GAPI::GpuResourceCpuAccess::None, "PerformanceHud quad indices");
+
+            const auto indicesData = deviceContext.AllocateIntermediateResourceData(indicesDescription, GAPI::MemoryAllocationType::CpuReadWrite);
+            indicesData->WriteSubresource(0, QuadIndices, sizeof(QuadIndices));
+
+            const auto& commandList = deviceContext.AcquireGraphicsCommandList();
+            commandList->UpdateGpuResource(quadIndices_, indicesData);
+            commandList->Close();
+            deviceContext.Submit(deviceContext.GetCommandQueue(GAPI::CommandQueueType::Graphics), commandList);
+
+            isAvailable_ = true;
+        }
+
+        void PerformanceHud::Terminate()
+        {
+            ASSERT(inited_);
+
+            quadIndices_ = nullptr;
+            pipeline_ = nullptr;
+            passes_ = {};
+            passesCount_ = 0;
+            linesCount_ = 0;
+            lastUpdateNs_ = 0;
+            lastGpuFrameIndex_ = 0;
+            deviceContext_ = nullptr;
+
+            isAvailable_ = false;
+            inited_ = false;
+        }
+
+        void PerformanceHud::ToggleVisible()
+        {
+            bool visible = visible_.load(std::memory_order_relaxed);
+            while (!visible_.compare_exchange_weak(visible, !visible, std::memory_order_relaxed))
+                ;
+        }
+
+        double PerformanceHud::smooth(double value, double sample) const
+        {
+            return value == 0.0 ? sample : value + (sample - value) * description_.smoothing;
+        }
+
+        template <typename... Args>
+        void PerformanceHud::addLine(Color color, const char* format, const Args&... args)
+        {
+            if (linesCount_ == MaxRows)
+                return;
+
+            auto& line = lines_[linesCount_++];
+            const auto result = fmt::format_to_n(line.text.data(), line.text.size(), format, args...);
+
+            // Longer lines are cut.
+            line.length = static_cast<uint32_t>(std::min<size_t>(result.size, line.text.size()));
+            line.color = color;
+        }
+
+        void PerformanceHud::Update()
+        {
+            ASSERT(inited_);
+
+            if (!isAvailable_ || !IsVisible())
+            {
+                // Interval spanning hidden frames isn't a frame time.
+                lastUpdateNs_ = 0;
+                return;
+            }
+
+            PROFILE_SCOPE("PerformanceHud::Update");
+
+            const auto nowNs = Profiler::Now();
+            if (lastUpdateNs_ != 0)
+                cpuFrameMs_ = smooth(cpuFrameMs_, (nowNs - lastUpdateNs_) / 1e6);
+            lastUpdateNs_ = nowNs;
+
+            // Latest frame completed on GPU, sampled once per frame index.
+            const auto& gpuTimings = deviceContext_->GetGpuFrameTimings();
+            if (gpuTimings.frameIndex > lastGpuFrameIndex_ && !gpuTimings.markers.empty())
+            {
+                double gpuFrameMs = 0.0;
+                uint32_t passesCount = 0;
+
+                for (const auto& marker : gpuTimings.markers)
+                {
+                    if (marker.parent == GAPI::GpuTimingMarker::InvalidParent)
+                        gpuFrameMs = std::max(gpuFrameMs, marker.startMs + marker.durationMs);
+
+                    // Top markers and their children only, deeper ones don't fit.
+                    if (marker.depth > 1 || passesCount == MaxPasses)
+                        continue;
+
+                    auto& pass = passes_[passesCount];
+                    if (passesCount >= passesCount_ || pass.name != marker.name)
+                    {
+                        pass.name = marker.name;
+                        pass.depth = marker.depth;
+                        pass.durationMs = marker.durationMs;
+                    }
+                    else
+                        pass.durationMs = smooth(pass.durationMs, marker.durationMs);
+
+                    passesCount++;
+                }
+
+                gpuFrameMs_ = smooth(gpuFrameMs_, gpuFrameMs);
+                passesCount_ = passesCount;
+                lastGpuFrameIndex_ = gpuTimings.frameIndex;
+            }
+
+            linesCount_ = 0;
+
+            addLine(Color::Default, "CPU {:7.2f} ms {:7.1f} FPS", cpuFrameMs_, cpuFrameMs_ > 0.0 ? 1000.0 / cpuFrameMs_ : 0.0);
+            addLine(Color::Default, "GPU {:7.2f} ms", gpuFrameMs_);
+
+            for (uint32_t index = 0; index < passesCount_; index++)
+            {
+                const auto& pass = passes_[index];
+                const auto nameColumns = PassNameColumns - pass.depth;
+                const auto barLength = gpuFrameMs_ > 0.0 ? std::min(BarColumns, static_cast<uint32_t>(std::lround(pass.durationMs / gpuFrameMs_ * BarColumns))) : 0;
+
+                addLine(Color::Dim, "{:{}}{:<{}.{}} {:6.2f} {:#<{}}", "", pass.depth, pass.name, nameColumns, nameColumns, pass.durationMs, "", barLength);
+            }
+
+            const auto queueDepth = deviceContext_->GetSubmissionQueueDepth();
+            addLine(queueDepth > QueueDepthWarning ? Color::Warning : Color::Default, "Submission queue {:>6}", queueDepth);
+
+            const auto& statistics = deviceContext_->GetDeviceStatistics();
+            for (size_t type = 0; type < statistics.descriptorHeaps.size(); type++)
+            {
+                const auto& occupancy = statistics.descriptorHeaps[type];
+                const auto ratio = occupancy.capacity > 0 ? static_cast<double>(occupancy.allocatedCount) / occupancy.capacity : 0.0;
+                const auto color = ratio > OccupancyBad ? Color::Bad : (ratio > OccupancyWarning ? Color::Warning : Color::Default);
+
+                addLine(color, "{:<11} {:>6}/{:<6} {:3.0f}%", DescriptorHeapNames[type], occupancy.allocatedCount, occupancy.capacity, ratio * 100.0);
+            }
+
+            addLine(Color::Default, "Deferred releases {:>5}", statistics.pendingReleasesCount);
+
+            const auto& budget = deviceContext_->GetMemoryBudget();
+            const auto addSegmentLine = [this](const char* name, const GAPI::MemorySegmentBudget& segment) {
+                const auto ratio = segment.budgetBytes > 0 ? static_cast<double>(segment.usageBytes) / segment.budgetBytes : 0.0;
+                const auto color = segment.IsOverBudget() ? Color::Bad : (ratio > OccupancyBad ? Color::Warning : Color::Good);
+
+                addLine(color, "{:<11} {:>6}/{:<6} MB {:3.0f}%", name, segment.usageBytes / BytesPerMegabyte, segment.budgetBytes / BytesPerMegabyte, ratio * 100.0);
+            };
+
+            addSegmentLine("Local", budget.local);
+            addSegmentLine("Non-local", budget.nonLocal);
+        }
+
+        void PerformanceHud::Draw(GAPI::GraphicsCommandList& commandList, uint32_t width, uint32_t height)
+        {
+            ASSERT(inited_);
+            ASSERT(width > 0 && height > 0);
+
+            if (!isAvailable_ || !IsVisible() || linesCount_ == 0)
+                return;
+
+            // Panel is rectangular, lines are padded to the longest one.
+            uint32_t columns = 0;
+            for (uint32_t row = 0; row < linesCount_; row++)
+                columns = std::max(columns, lines_[row].length);
+
+            Constants constants;
+            constants.screenSize[0] = width;
+            constants.screenSize[1] = height;
+            constants.origin[0] = Margin;
+            constants.origin[1] = Margin;
+            constants.scale = description_.scale;
+
+            uint32_t glyphsCount = 0;
+            for (uint32_t row = 0; row < linesCount_; row++)
+            {
+                const auto& line = lines_[row];
+                for (uint32_t column = 0; column < columns; column++)
+                    constants.glyphs[glyphsCount++] = packGlyph(column < line.length ? line.text[column] : ' ', static_cast<uint32_t>(line.color), column, row);
+            }
+            constants.glyphsCount = glyphsCount;
+
+            if (!commandList.SetGraphicsPipelineState(pipeline_))
+                return;
+
+            commandList.BeginMarker("PerformanceHud");
+
+            // Only used glyphs are uploaded.
+            const auto constantsSize = offsetof(Constants, glyphs) + glyphsCount * sizeof(uint32_t);
+            commandList.SetGraphicsConstantBuffer(RootParameter::Constants, commandList.AllocateConstants(&constants, constantsSize));
+            commandList.SetIndexBuffer(quadIndices_, GAPI::GpuResourceFormat::R16Uint);
+            commandList.DrawIndexed(6, glyphsCount);
+
+            commandList.EndMarker();
+        }
+    }
+}
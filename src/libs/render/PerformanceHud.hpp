@@ -0,0 +1,122 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceFormat.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Text overlay of live counters: CPU and GPU frame time, top GPU markers of the latest completed frame,
+        // submission queue depth, descriptor heaps occupancy, deferred releases and memory budget.
+        // Text is laid out on CPU into glyph instances passed through constants. Font is 3x5 bitmap packed into
+        // glyph bits, so the pass has no textures and no uploads. Hidden HUD neither samples counters nor draws.
+        class PerformanceHud final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t MaxColumns = 48;
+            static constexpr uint32_t MaxRows = 40;
+            static constexpr uint32_t MaxPasses = 16;
+
+            struct Description
+            {
+                GAPI::GpuResourceFormat renderTargetFormat = GAPI::GpuResourceFormat::Unknown;
+                // Screen pixels per font pixel.
+                uint32_t scale = 2;
+                // Weight of the latest frame in smoothed timings.
+                float smoothing = 0.1f;
+                bool visible = false;
+            };
+
+            PerformanceHud() = default;
+            ~PerformanceHud();
+
+            void Init(DeviceContext& deviceContext, const Description& description);
+            void Terminate();
+
+            // False when shader bytecode wasn't found, Update and Draw are skipped then.
+            bool IsAvailable() const { return isAvailable_; }
+
+            // Any thread, e.g. from key handler. Takes effect with the next Update.
+            void SetVisible(bool visible) { visible_.store(visible, std::memory_order_relaxed); }
+            void ToggleVisible();
+            bool IsVisible() const { return visible_.load(std::memory_order_relaxed); }
+
+            // Once per frame by the thread calling MoveToNextFrame. Samples counters and lays out text.
+            void Update();
+            // Over render targets set by the caller, anchored to top left corner of target of width x height.
+            void Draw(GAPI::GraphicsCommandList& commandList, uint32_t width, uint32_t height);
+
+        private:
+            enum class Color : uint32_t
+            {
+                Default,
+                Dim,
+                Good,
+                Warning,
+                Bad
+            };
+
+            enum RootParameter : uint32_t
+            {
+                Constants
+            };
+
+            // Matches layout in shaders/PerformanceHud.slang.
+            struct Constants final
+            {
+                uint32_t screenSize[2];
+                uint32_t origin[2];
+                uint32_t scale;
+                uint32_t glyphsCount;
+                uint32_t padding[2];
+                // Packed by packGlyph, one instance per cell.
+                uint32_t glyphs[MaxColumns * MaxRows];
+            };
+
+            struct Line final
+            {
+                std::array<char, MaxColumns> text;
+                uint32_t length;
+                Color color;
+            };
+
+            struct Pass final
+            {
+                U8String name;
+                uint32_t depth;
+                double durationMs;
+            };
+
+            template <typename... Args>
+            void addLine(Color color, const char* format, const Args&... args);
+            double smooth(double value, double sample) const;
+
+        private:
+            bool inited_ = false;
+            bool isAvailable_ = false;
+            Description description_;
+            DeviceContext* deviceContext_ = nullptr;
+            std::atomic<bool> visible_ = false;
+
+            uint64_t lastUpdateNs_ = 0;
+            uint64_t lastGpuFrameIndex_ = 0;
+            double cpuFrameMs_ = 0.0;
+            double gpuFrameMs_ = 0.0;
+            // Smoothed while marker at the same position keeps its name.
+            std::array<Pass, MaxPasses> passes_;
+            uint32_t passesCount_ = 0;
+
+            std::array<Line, MaxRows> lines_;
+            uint32_t linesCount_ = 0;
+
+            std::shared_ptr<GAPI::PipelineState> pipeline_;
+            std::shared_ptr<GAPI::Buffer> quadIndices_;
+        };
+    }
+}
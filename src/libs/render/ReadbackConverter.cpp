@@ -0,0 +1,176 @@
+#include "ReadbackConverter.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Limits.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            constexpr const char* ShaderPath = "shaders/ReadbackConvert_Convert.bin";
+
+            bool isSingleChannel(GAPI::GpuResourceFormat format)
+            {
+                return format == GAPI::GpuResourceFormat::R8Unorm || format == GAPI::GpuResourceFormat::R16Float || format == GAPI::GpuResourceFormat::R32Float;
+            }
+        }
+
+        ReadbackConverter::~ReadbackConverter()
+        {
+            ASSERT(!inited_);
+        }
+
+        void ReadbackConverter::Init(DeviceContext& deviceContext)
+        {
+            ASSERT(!inited_);
+
+            deviceContext_ = &deviceContext;
+            pool_ = std::make_shared<Pool>();
+            inited_ = true;
+
+            pipeline_.Init(deviceContext, ShaderPath, "ReadbackConverter", "textures are read back in native format");
+        }
+
+        void ReadbackConverter::Terminate()
+        {
+            ASSERT(inited_);
+
+            // Stagings in flight are released by their callbacks.
+            pool_ = nullptr;
+            pipeline_.Terminate();
+            deviceContext_ = nullptr;
+
+            inited_ = false;
+        }
+
+        bool ReadbackConverter::IsSupported(GAPI::GpuResourceFormat format)
+        {
+            switch (format)
+            {
+                case GAPI::GpuResourceFormat::RGBA8Unorm:
+                case GAPI::GpuResourceFormat::RG8Unorm:
+                case GAPI::GpuResourceFormat::R8Unorm:
+                case GAPI::GpuResourceFormat::RGBA16Float:
+                case GAPI::GpuResourceFormat::R16Float:
+                case GAPI::GpuResourceFormat::R32Float:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        ReadbackConverter::Staging ReadbackConverter::acquireStaging(uint32_t width, uint32_t height, GAPI::GpuResourceFormat format)
+        {
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(pool_->mutex);
+
+                const auto it = std::find_if(pool_->free.begin(), pool_->free.end(), [&](const Staging& staging) {
+                    const auto& description = staging.texture->GetDescription();
+                    return description.GetWidth() == width && description.GetHeight() == height && description.GetFormat() == format;
+                });
+
+                if (it != pool_->free.end())
+                {
+                    auto staging = std::move(*it);
+                    pool_->free.erase(it);
+                    return staging;
+                }
+            }
+
+            const auto& description = GAPI::GpuResourceDescription::Texture2D(width, height, format, GAPI::GpuResourceBindFlags::UnorderedAccess, 1, 1);
+
+            Staging staging;
+            staging.texture = deviceContext_->CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "ReadbackConverter staging");
+            staging.view = deviceContext_->CreateUnorderedAccessView(staging.texture, GAPI::GpuResourceViewDescription::Texture(format, 0, 1, 0, 1));
+
+            return staging;
+        }
+
+        void ReadbackConverter::ReadbackAsync(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Texture>& texture,
+                                              const Conversion& conversion, Callback&& callback, uint32_t mipLevel)
+        {
+            ASSERT(inited_);
+            ASSERT(IsAvailable());
+            ASSERT(commandQueue);
+            ASSERT(commandQueue->GetCommandQueueType() != GAPI::CommandQueueType::Copy);
+            ASSERT(texture);
+            ASSERT(callback);
+            ASSERT(IsSupported(conversion.format));
+            ASSERT(conversion.downsampleFactor > 0);
+            ASSERT(conversion.channel <= LuminanceChannel);
+
+            const auto& sourceDescription = texture->GetDescription();
+            ASSERT(sourceDescription.GetDimension() == GAPI::GpuResourceDimension::Texture2D);
+            ASSERT(mipLevel < sourceDescription.GetMipCount());
+
+            const uint32_t sourceWidth = sourceDescription.GetWidth(mipLevel);
+            const uint32_t sourceHeight = sourceDescription.GetHeight(mipLevel);
+            const uint32_t width = (sourceWidth + conversion.downsampleFactor - 1) / conversion.downsampleFactor;
+            const uint32_t height = (sourceHeight + conversion.downsampleFactor - 1) / conversion.downsampleFactor;
+
+            const uint32_t groupsX = (width + ThreadGroupSize - 1) / ThreadGroupSize;
+            const uint32_t groupsY = (height + ThreadGroupSize - 1) / ThreadGroupSize;
+            ASSERT(groupsX <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION && groupsY <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            auto staging = acquireStaging(width, height, conversion.format);
+            const auto& sourceView = deviceContext_->CreateShaderResourceView(
+                texture, GAPI::GpuResourceViewDescription::Texture(sourceDescription.GetFormat(), mipLevel, 1, 0, 1));
+
+            Constants constants = {};
+            constants.sourceIndex = sourceView->GetBindlessIndex();
+            constants.outputIndex = staging.view->GetBindlessIndex();
+            constants.sourceSize[0] = sourceWidth;
+            constants.sourceSize[1] = sourceHeight;
+            constants.outputSize[0] = width;
+            constants.outputSize[1] = height;
+            constants.downsampleFactor = conversion.downsampleFactor;
+            constants.channel = conversion.channel;
+            constants.isSingleChannel = isSingleChannel(conversion.format) ? 1 : 0;
+            constants.encodeSrgb = conversion.encodeSrgb ? 1 : 0;
+
+            // List type should match the queue, compute commands are recorded by graphics lists as well.
+            const auto& commandList = commandQueue->GetCommandQueueType() == GAPI::CommandQueueType::Graphics
+                                          ? std::static_pointer_cast<GAPI::ComputeCommandList>(deviceContext_->AcquireGraphicsCommandList())
+                                          : deviceContext_->AcquireComputeCommandList();
+
+            pipeline_.Bind(*commandList);
+
+            commandList->BeginMarker("ReadbackConverter");
+
+            commandList->TransitionToShaderResource(sourceView);
+            commandList->TransitionToUnorderedAccess(staging.view);
+
+            commandList->SetComputeConstantBuffer(RootParameter::Constants, commandList->AllocateConstants(constants));
+            commandList->SetComputeDescriptorTable(RootParameter::Textures, 0);
+            commandList->SetComputeDescriptorTable(RootParameter::Images, 0);
+
+            commandList->Dispatch(groupsX, groupsY);
+
+            commandList->EndMarker();
+            commandList->Close();
+
+            deviceContext_->Submit(commandQueue, commandList);
+
+            const auto stagingTexture = staging.texture;
+            deviceContext_->ReadbackAsync(
+                commandQueue, stagingTexture,
+                [pool = pool_, staging = std::move(staging), sourceView, callback = std::move(callback)](const std::shared_ptr<GAPI::CpuResourceData>& data) mutable {
+                    callback(data);
+
+                    Threading::UniqueLock<Threading::Mutex> lock(pool->mutex);
+                    if (pool->free.size() < MaxPooledStagings)
+                        pool->free.push_back(std::move(staging));
+                },
+                0, 1);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResourceFormat.hpp"
+
+#include "render/ComputePipeline.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <functional>
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Converts and downsamples texture into compact staging texture on GPU before readback, e.g. captures and
+        // telemetry that need RGBA8 or a single channel of RGBA32Float target. Fewer bytes cross PCIe and CPU side
+        // conversion is gone. Staging textures are pooled by size and format, and return to pool once read back.
+        class ReadbackConverter final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t ThreadGroupSize = 8;
+            // Channel value selecting luminance of RGB instead of a single channel.
+            static constexpr uint32_t LuminanceChannel = 4;
+
+            using Callback = std::function<void(const std::shared_ptr<GAPI::CpuResourceData>&)>;
+
+            struct Conversion
+            {
+                // RGBA8Unorm, RG8Unorm, R8Unorm, RGBA16Float, R16Float or R32Float.
+                GAPI::GpuResourceFormat format = GAPI::GpuResourceFormat::RGBA8Unorm;
+                // Source channel, or LuminanceChannel, written to single channel formats.
+                uint32_t channel = 0;
+                // Box filter of factor x factor source texels per staging texel.
+                uint32_t downsampleFactor = 1;
+                // Encodes gamma for unorm formats, sRGB formats can't be written as UAVs.
+                bool encodeSrgb = false;
+            };
+
+            ReadbackConverter() = default;
+            ~ReadbackConverter();
+
+            void Init(DeviceContext& deviceContext);
+            void Terminate();
+
+            // False when shader bytecode wasn't found, callers should read back source texture as is then.
+            bool IsAvailable() const { return pipeline_.IsAvailable(); }
+            static bool IsSupported(GAPI::GpuResourceFormat format);
+
+            // Like DeviceContext::ReadbackAsync, after work already submitted to the queue, which shouldn't be a copy queue.
+            // Source is a mip of non multisampled 2D texture. Callback gets single subresource of Conversion::format.
+            void ReadbackAsync(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::Texture>& texture,
+                               const Conversion& conversion, Callback&& callback, uint32_t mipLevel = 0);
+
+        private:
+            enum RootParameter : uint32_t
+            {
+                Constants,
+                Textures,
+                Images
+            };
+
+            // Matches layout in shaders/ReadbackConvert.slang.
+            struct Constants final
+            {
+                uint32_t sourceIndex;
+                uint32_t outputIndex;
+                uint32_t sourceSize[2];
+                uint32_t outputSize[2];
+                uint32_t downsampleFactor;
+                uint32_t channel;
+                uint32_t isSingleChannel;
+                uint32_t encodeSrgb;
+                uint32_t padding[2];
+            };
+
+            struct Staging final
+            {
+                std::shared_ptr<GAPI::Texture> texture;
+                std::shared_ptr<GAPI::UnorderedAccessView> view;
+            };
+
+            // Shared with readback callbacks, which could outlive converter.
+            struct Pool final
+            {
+                Threading::Mutex mutex;
+                std::vector<Staging> free;
+            };
+
+            Staging acquireStaging(uint32_t width, uint32_t height, GAPI::GpuResourceFormat format);
+
+        private:
+            static constexpr size_t MaxPooledStagings = 16;
+
+            bool inited_ = false;
+            DeviceContext* deviceContext_ = nullptr;
+
+            ComputePipeline pipeline_;
+            std::shared_ptr<Pool> pool_;
+        };
+    }
+}
@@ -0,0 +1,387 @@
+#include "RemoteProfiler.hpp"
+
+#include "render/Network.hpp"
+
+#include "common/TileCompression.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            // Latency of commands and of sending, the thread waits on the socket in between.
+            constexpr uint64_t PollIntervalNs = 2'000'000;
+            constexpr size_t MaxCommandLength = 256;
+            constexpr size_t MaxSendSize = 256 * 1024;
+
+            template <typename T>
+            void write(std::vector<uint8_t>& records, T value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value);
+
+                const auto offset = records.size();
+                records.resize(offset + sizeof(T));
+                std::memcpy(records.data() + offset, &value, sizeof(T));
+            }
+
+            void writeRecord(std::vector<uint8_t>& records, RemoteProfiler::Record record)
+            {
+                write(records, static_cast<uint8_t>(record));
+            }
+
+            void writeString(std::vector<uint8_t>& records, const char* string)
+            {
+                const auto length = static_cast<uint16_t>(std::min<size_t>(std::strlen(string), std::numeric_limits<uint16_t>::max()));
+
+                write(records, length);
+                records.insert(records.end(), string, string + length);
+            }
+
+            uint32_t toDurationNs(uint64_t startNs, uint64_t endNs)
+            {
+                return static_cast<uint32_t>(std::min<uint64_t>(endNs - startNs, std::numeric_limits<uint32_t>::max()));
+            }
+        }
+
+        RemoteProfiler::~RemoteProfiler()
+        {
+            ASSERT(!inited_);
+        }
+
+        void RemoteProfiler::Init(const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.maxCaptureFrames > 0);
+
+            description_ = description;
+            inited_ = true;
+
+            listenSocket_ = Network::Listen(description.port, {});
+            if (listenSocket_ == Network::InvalidSocket)
+            {
+                Log::Format::Warning("Remote profiler failed to listen on port {}, remote profiling is disabled\n", description.port);
+                return;
+            }
+
+            quit_ = false;
+            thread_ = Threading::Thread("Remote Profiler Thread", [this] { threadFunc(); });
+            thread_.SetPriority(Threading::ThreadPriority::BelowNormal);
+            thread_.SetQoS(Threading::ThreadQoS::Eco);
+
+            isAvailable_ = true;
+        }
+
+        void RemoteProfiler::Terminate()
+        {
+            ASSERT(inited_);
+
+            if (isAvailable_)
+            {
+                quit_ = true;
+                thread_.Join();
+
+                disconnect();
+                Network::Close(listenSocket_);
+                listenSocket_ = Network::InvalidSocket;
+            }
+
+            if (captureFramesLeft_ > 0)
+                Profiler::Instance().EndCapture();
+
+            while (captureEvents_.Front())
+                captureEvents_.Pop();
+
+            captureFramesLeft_ = 0;
+            requestedFrames_ = 0;
+            isAvailable_ = false;
+            inited_ = false;
+        }
+
+        void RemoteProfiler::RequestCapture(uint32_t framesCount)
+        {
+            ASSERT(inited_);
+            ASSERT(framesCount > 0);
+
+            if (isAvailable_)
+                requestedFrames_.store(std::min(framesCount, description_.maxCaptureFrames), std::memory_order_relaxed);
+        }
+
+        void RemoteProfiler::OnFrame(uint64_t frameIndex)
+        {
+            ASSERT(inited_);
+
+            // Queue is drained every poll interval, it's full only while the thread is starved. Boundaries can't be lost.
+            const auto pushEvent = [this](const CaptureEvent& event) {
+                while (!captureEvents_.TryPush(event))
+                    std::this_thread::yield();
+            };
+
+            auto& profiler = Profiler::Instance();
+
+            if (captureFramesLeft_ > 0)
+            {
+                pushEvent({ CaptureEvent::Type::Frame, frameIndex, Profiler::Now(), 0 });
+
+                if (--captureFramesLeft_ == 0)
+                {
+                    profiler.EndCapture();
+                    pushEvent({ CaptureEvent::Type::End, frameIndex, Profiler::Now(), 0 });
+                }
+
+                return;
+            }
+
+            const auto framesCount = requestedFrames_.exchange(0, std::memory_order_relaxed);
+            if (framesCount == 0)
+                return;
+
+            // Local capture, e.g. of benchmark, owns the profiler.
+            if (Profiler::IsCapturing())
+            {
+                Log::Print::Warning("Remote profiler capture is skipped, profiler is already capturing\n");
+                return;
+            }
+
+            profiler.BeginCapture();
+            captureFramesLeft_ = framesCount;
+            pushEvent({ CaptureEvent::Type::Begin, frameIndex, Profiler::Now(), framesCount });
+        }
+
+        void RemoteProfiler::threadFunc()
+        {
+            while (!quit_.load(std::memory_order_relaxed))
+            {
+                const auto socket = connection_ != Network::InvalidSocket ? connection_ : listenSocket_;
+                const bool isReadable = Network::WaitReadable(socket, PollIntervalNs);
+
+                if (connection_ == Network::InvalidSocket)
+                {
+                    if (isReadable)
+                    {
+                        connection_ = Network::Accept(listenSocket_);
+                        if (connection_ != Network::InvalidSocket)
+                        {
+                            Network::SetNonBlocking(connection_);
+                            // Viewer could connect in the middle of capture.
+                            resendDefinitions_ = true;
+
+                            writeRecord(records_, Record::Hello);
+                            write(records_, Magic);
+                            write(records_, Version);
+                            pushPacket();
+                        }
+                    }
+                }
+                else if (isReadable && !processCommands())
+                    disconnect();
+
+                for (auto event = captureEvents_.Front(); event; event = captureEvents_.Front())
+                {
+                    // Nobody to send capture to, scopes are left in profiler.
+                    if (connection_ != Network::InvalidSocket)
+                        encode(*event);
+
+                    captureEvents_.Pop();
+                }
+
+                if (connection_ != Network::InvalidSocket && !sendPackets())
+                    disconnect();
+            }
+        }
+
+        bool RemoteProfiler::processCommands()
+        {
+            std::array<char, MaxCommandLength> buffer;
+            const auto received = Network::Receive(connection_, buffer.data(), buffer.size());
+            if (received < 0)
+                return false;
+
+            command_.append(buffer.data(), static_cast<size_t>(received));
+
+            for (auto end = command_.find('\n'); end != U8String::npos; end = command_.find('\n'))
+            {
+                const auto line = command_.substr(0, end);
+                command_.erase(0, end + 1);
+
+                constexpr std::string_view CaptureCommand = "capture ";
+                const auto framesCount = line.rfind(CaptureCommand, 0) == 0 ? std::strtoul(line.c_str() + CaptureCommand.size(), nullptr, 10) : 0;
+                if (framesCount > 0)
+                    RequestCapture(static_cast<uint32_t>(std::min<unsigned long>(framesCount, description_.maxCaptureFrames)));
+                else
+                    Log::Format::Warning("Remote profiler got unknown command: {}\n", line);
+            }
+
+            // Garbage without line feeds.
+            return command_.size() < MaxCommandLength;
+        }
+
+        uint32_t RemoteProfiler::defineName(const char* name)
+        {
+            const auto id = namesCount_++;
+
+            writeRecord(records_, Record::Name);
+            write(records_, id);
+            writeString(records_, name);
+
+            return id;
+        }
+
+        void RemoteProfiler::encode(const CaptureEvent& event)
+        {
+            if (event.type == CaptureEvent::Type::Begin)
+            {
+                // Every capture is self contained.
+                threads_.clear();
+                cpuNameIds_.clear();
+                gpuNameIds_.clear();
+                namesCount_ = 0;
+
+                writeRecord(records_, Record::Begin);
+                write(records_, event.timeNs);
+                write(records_, event.framesCount);
+                pushPacket();
+                return;
+            }
+
+            if (event.type == CaptureEvent::Type::End)
+            {
+                writeRecord(records_, Record::End);
+                pushPacket();
+                return;
+            }
+
+            scopes_.threads.clear();
+            scopes_.cpuScopes.clear();
+            scopes_.gpuScopes.clear();
+            Profiler::Instance().ReadNewScopes(scopes_);
+
+            threads_.insert(threads_.end(), scopes_.threads.begin(), scopes_.threads.end());
+
+            // Definitions went with dropped packet.
+            const bool resendDefinitions = resendDefinitions_;
+            if (resendDefinitions)
+            {
+                cpuNameIds_.clear();
+                gpuNameIds_.clear();
+                namesCount_ = 0;
+                resendDefinitions_ = false;
+            }
+
+            for (const auto& thread : resendDefinitions ? threads_ : scopes_.threads)
+            {
+                writeRecord(records_, Record::Thread);
+                write(records_, thread.id);
+                writeString(records_, thread.name.c_str());
+            }
+
+            for (const auto& scope : scopes_.cpuScopes)
+            {
+                auto it = cpuNameIds_.find(scope.name);
+                if (it == cpuNameIds_.end())
+                    it = cpuNameIds_.emplace(scope.name, defineName(scope.name)).first;
+
+                writeRecord(records_, Record::CpuScope);
+                write(records_, scope.threadId);
+                write(records_, it->second);
+                write(records_, scope.startNs);
+                write(records_, toDurationNs(scope.startNs, scope.endNs));
+            }
+
+            for (const auto& scope : scopes_.gpuScopes)
+            {
+                auto it = gpuNameIds_.find(scope.name);
+                if (it == gpuNameIds_.end())
+                    it = gpuNameIds_.emplace(scope.name, defineName(scope.name.c_str())).first;
+
+                writeRecord(records_, Record::GpuScope);
+                write(records_, it->second);
+                write(records_, scope.depth);
+                write(records_, scope.startNs);
+                write(records_, toDurationNs(scope.startNs, std::max(scope.endNs, scope.startNs)));
+            }
+
+            writeRecord(records_, Record::Frame);
+            write(records_, event.frameIndex);
+            write(records_, event.timeNs);
+            pushPacket();
+        }
+
+        void RemoteProfiler::pushPacket()
+        {
+            ASSERT(!records_.empty());
+
+            if (droppedPacketsCount_ > 0)
+            {
+                std::vector<uint8_t> dropped;
+                writeRecord(dropped, Record::Dropped);
+                write(dropped, droppedPacketsCount_);
+                records_.insert(records_.begin(), dropped.begin(), dropped.end());
+            }
+
+            const auto& compressed = Common::TileCompression::Compress(records_.data(), records_.size());
+            records_.clear();
+
+            const auto packetSize = sizeof(uint32_t) + compressed.size();
+            if (packets_.full() || packetsBytes_ + packetSize > description_.ringBufferBytes)
+            {
+                droppedPacketsCount_++;
+                resendDefinitions_ = true;
+                return;
+            }
+
+            auto& packet = packets_.emplace_back();
+            packet.reserve(packetSize);
+            write(packet, static_cast<uint32_t>(compressed.size()));
+            packet.insert(packet.end(), compressed.begin(), compressed.end());
+
+            packetsBytes_ += packetSize;
+            droppedPacketsCount_ = 0;
+        }
+
+        bool RemoteProfiler::sendPackets()
+        {
+            while (!packets_.empty())
+            {
+                const auto& packet = packets_.front();
+                const auto sent = Network::Send(connection_, packet.data() + sentBytes_, std::min(packet.size() - sentBytes_, MaxSendSize));
+                if (sent < 0)
+                    return false;
+
+                // Socket buffer is full, the rest waits for the next poll.
+                if (sent == 0)
+                    return true;
+
+                sentBytes_ += static_cast<size_t>(sent);
+                if (sentBytes_ < packet.size())
+                    continue;
+
+                packetsBytes_ -= packet.size();
+                sentBytes_ = 0;
+                packets_.pop_front();
+            }
+
+            return true;
+        }
+
+        void RemoteProfiler::disconnect()
+        {
+            Network::Close(connection_);
+            connection_ = Network::InvalidSocket;
+
+            command_.clear();
+            packets_.clear();
+            packetsBytes_ = 0;
+            sentBytes_ = 0;
+            droppedPacketsCount_ = 0;
+            resendDefinitions_ = false;
+            records_.clear();
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "common/CircularBuffer.hpp"
+#include "common/debug/Profiler.hpp"
+#include "common/threading/SpscQueue.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Render
+    {
+        // Streams profiler captures to a remote viewer over TCP, for machines without local profiler access.
+        // Viewer sends text commands terminated by line feed: "capture <frames>" captures that many frames on demand.
+        // Capture is sent frame by frame while it runs, as packets of u32 size followed by TileCompression stream.
+        // Uncompressed packet is a sequence of records, u8 type followed by little endian fields:
+        //   Hello       u32 magic 'RRPS', u32 version          (first packet of connection)
+        //   Begin       u64 startNs, u32 framesCount
+        //   Thread      u32 id, u16 length, name
+        //   Name        u32 id, u16 length, name              (before the first scope using it)
+        //   CpuScope    u32 threadId, u32 nameId, u64 startNs, u32 durationNs
+        //   GpuScope    u32 nameId, u32 depth, u64 startNs, u32 durationNs
+        //   Frame       u64 frameIndex, u64 endNs
+        //   Dropped     u32 packetsCount                       (lost to ring buffer overflow since previous packet)
+        //   End
+        // Scopes are read and encoded on the remote profiler thread. Ring buffer of encoded packets absorbs bursts while
+        // connection is slower than capture, packets beyond it are dropped and reported.
+        class RemoteProfiler final : private NonCopyable
+        {
+        public:
+            enum class Record : uint8_t
+            {
+                Hello,
+                Begin,
+                Thread,
+                Name,
+                CpuScope,
+                GpuScope,
+                Frame,
+                Dropped,
+                End
+            };
+
+            static constexpr uint32_t Magic = 0x53505252; // 'RRPS'
+            static constexpr uint32_t Version = 1;
+
+            struct Description
+            {
+                uint16_t port = 28077;
+                // Encoded packets waiting for the connection.
+                size_t ringBufferBytes = 64 * 1024 * 1024;
+                // Longer captures are clamped.
+                uint32_t maxCaptureFrames = 1000;
+            };
+
+            RemoteProfiler() = default;
+            ~RemoteProfiler();
+
+            void Init(const Description& description);
+            // Ends capture in progress, drops packets not sent yet.
+            void Terminate();
+
+            // False when port couldn't be opened, requests are ignored then.
+            bool IsAvailable() const { return isAvailable_; }
+
+            // Any thread, e.g. from key handler. Capture starts with the next frame and is sent to the connected viewer.
+            void RequestCapture(uint32_t framesCount);
+
+            // Once per frame by the thread calling MoveToNextFrame, after it. Begins and ends requested captures.
+            void OnFrame(uint64_t frameIndex);
+
+        private:
+            // Capture boundaries, from the thread calling OnFrame.
+            struct CaptureEvent final
+            {
+                enum class Type : uint8_t
+                {
+                    Begin,
+                    Frame,
+                    End
+                };
+
+                Type type;
+                uint64_t frameIndex;
+                uint64_t timeNs;
+                uint32_t framesCount;
+            };
+
+            void threadFunc();
+            bool processCommands();
+            void encode(const CaptureEvent& event);
+            void pushPacket();
+            bool sendPackets();
+            void disconnect();
+
+            // Appends Name record, returns its id.
+            uint32_t defineName(const char* name);
+
+        private:
+            static constexpr size_t MaxPackets = 1024;
+
+            bool inited_ = false;
+            bool isAvailable_ = false;
+            Description description_;
+
+            std::atomic<bool> quit_ = false;
+            std::atomic<uint32_t> requestedFrames_ = 0;
+            Threading::Thread thread_;
+            uintptr_t listenSocket_ = ~uintptr_t(0);
+
+            // Owned by the thread calling OnFrame.
+            uint32_t captureFramesLeft_ = 0;
+            Threading::SpscQueue<CaptureEvent, 256> captureEvents_;
+
+            // Owned by profiler thread from here on.
+            uintptr_t connection_ = ~uintptr_t(0);
+            U8String command_;
+            Common::Debug::Profiler::StreamedScopes scopes_;
+            std::vector<Common::Debug::Profiler::StreamedThread> threads_;
+            // Name ids are local to the stream, they restart when definitions are lost with dropped packet.
+            std::unordered_map<const char*, uint32_t> cpuNameIds_;
+            std::unordered_map<U8String, uint32_t> gpuNameIds_;
+            uint32_t namesCount_ = 0;
+            bool resendDefinitions_ = false;
+            std::vector<uint8_t> records_;
+
+            Common::CircularBuffer<std::vector<uint8_t>, MaxPackets> packets_;
+            size_t packetsBytes_ = 0;
+            // Bytes of the front packet already sent.
+            size_t sentBytes_ = 0;
+            uint32_t droppedPacketsCount_ = 0;
+        };
+    }
+}
@@ -0,0 +1,395 @@
+#include "RenderGraph.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            constexpr uint32_t MaxWorkers = 4;
+        }
+
+        RenderGraphResource RenderGraphBuilder::CreateTexture(const GAPI::GpuResourceDescription& desc, const U8String& name)
+        {
+            RenderGraph::Resource resource;
+            resource.name = name;
+            resource.description = desc;
+
+            return { graph_.addResource(std::move(resource)) };
+        }
+
+        RenderGraphResource RenderGraphBuilder::Read(RenderGraphResource resource)
+        {
+            ASSERT(resource.IsValid());
+            ASSERT(resource.index < graph_.resources_.size());
+
+            graph_.passes_[passIndex_].reads.push_back(resource.index);
+            return resource;
+        }
+
+        RenderGraphResource RenderGraphBuilder::Write(RenderGraphResource resource)
+        {
+            ASSERT(resource.IsValid());
+            ASSERT(resource.index < graph_.resources_.size());
+
+            graph_.passes_[passIndex_].writes.push_back(resource.index);
+            return resource;
+        }
+
+        void RenderGraphBuilder::SetSideEffect()
+        {
+            graph_.passes_[passIndex_].hasSideEffect = true;
+        }
+
+        void RenderGraphBuilder::SetSubmitCheckpoint()
+        {
+            graph_.passes_[passIndex_].isSubmitCheckpoint = true;
+        }
+
+        RenderGraph::RenderGraph(DeviceContext& deviceContext)
+            : deviceContext_(deviceContext)
+        {
+            const auto workersCount = std::min(MaxWorkers, std::max(Threading::Thread::HardwareConcurrency(), 2u) - 1);
+
+            for (uint32_t index = 0; index < workersCount; index++)
+                workers_.emplace_back(fmt::sprintf("RenderGraph Worker %u", index), [this] { workerFunc(); });
+        }
+
+        RenderGraph::~RenderGraph()
+        {
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                terminateWorkers_ = true;
+                workAvailable_.notify_all();
+            }
+
+            for (auto& worker : workers_)
+                worker.Join();
+        }
+
+        RenderGraphResource RenderGraph::ImportTexture(const std::shared_ptr<GAPI::Texture>& texture)
+        {
+            ASSERT(texture);
+            ASSERT(!isCompiled_);
+
+            Resource resource;
+            resource.name = texture->GetName();
+            resource.description = texture->GetDescription();
+            resource.texture = texture;
+            resource.isImported = true;
+
+            return { addResource(std::move(resource)) };
+        }
+
+        void RenderGraph::AddPass(const U8String& name, const SetupFunction& setup, ExecuteFunction&& execute)
+        {
+            ASSERT(!isCompiled_);
+            ASSERT(execute);
+
+            const auto passIndex = static_cast<uint32_t>(passes_.size());
+
+            Pass pass;
+            pass.name = name;
+            pass.execute = std::move(execute);
+            passes_.push_back(std::move(pass));
+
+            RenderGraphBuilder builder(*this, passIndex);
+            setup(builder);
+        }
+
+        void RenderGraph::Compile()
+        {
+            ASSERT(!isCompiled_);
+
+            cullPasses();
+            buildLevels();
+            computeLifetimes();
+
+            isCompiled_ = true;
+        }
+
+        GAPI::GpuSyncPoint RenderGraph::Execute(const std::shared_ptr<GAPI::CommandQueue>& commandQueue)
+        {
+            ASSERT(isCompiled_);
+            ASSERT(commandQueue);
+
+            auto& deviceContext = deviceContext_;
+
+            for (auto& resource : resources_)
+            {
+                if (resource.isImported || resource.firstUse == InvalidLevel)
+                    continue;
+
+                resource.texture = deviceContext.CreateTransientTexture(resource.description, resource.firstUse, resource.lastUse, resource.name);
+            }
+
+            commandLists_.clear();
+            commandLists_.resize(passes_.size());
+
+            // Submitted in level order, culled passes have no command lists. Early submissions let GPU start
+            // on recorded levels while the following ones are recorded.
+            std::vector<std::shared_ptr<GAPI::CommandList>> pendingLists;
+            pendingLists.reserve(passes_.size());
+            uint32_t pendingWorkCommands = 0;
+            GAPI::GpuSyncPoint syncPoint;
+
+            for (size_t levelIndex = 0; levelIndex < levels_.size(); levelIndex++)
+            {
+                const auto& level = levels_[levelIndex];
+                recordLevel(level);
+
+                bool isCheckpoint = false;
+                for (const auto passIndex : level)
+                {
+                    pendingLists.push_back(commandLists_[passIndex]);
+                    pendingWorkCommands += commandLists_[passIndex]->GetWorkCommandsCount();
+                    isCheckpoint = isCheckpoint || passes_[passIndex].isSubmitCheckpoint;
+                }
+
+                const bool isLastLevel = levelIndex + 1 == levels_.size();
+                const bool isOverThreshold = submitThreshold_ > 0 && pendingWorkCommands >= submitThreshold_;
+                if (!isLastLevel && !isCheckpoint && !isOverThreshold)
+                    continue;
+
+                syncPoint = deviceContext.Submit(commandQueue, pendingLists);
+                pendingLists.clear();
+                pendingWorkCommands = 0;
+            }
+
+            // Graph without alive passes still advances queue timeline.
+            if (levels_.empty())
+                syncPoint = deviceContext.Submit(commandQueue, pendingLists);
+
+            return syncPoint;
+        }
+
+        void RenderGraph::Reset()
+        {
+            resources_.clear();
+            passes_.clear();
+            levels_.clear();
+            commandLists_.clear();
+            isCompiled_ = false;
+        }
+
+        const std::shared_ptr<GAPI::Texture>& RenderGraph::GetTexture(RenderGraphResource resource) const
+        {
+            ASSERT(resource.IsValid());
+            ASSERT(resource.index < resources_.size());
+            ASSERT(resources_[resource.index].texture);
+
+            return resources_[resource.index].texture;
+        }
+
+        uint32_t RenderGraph::addResource(Resource&& resource)
+        {
+            resources_.push_back(std::move(resource));
+            return static_cast<uint32_t>(resources_.size() - 1);
+        }
+
+        void RenderGraph::cullPasses()
+        {
+            std::vector<bool> isNeeded(resources_.size(), false);
+
+            for (auto it = passes_.rbegin(); it != passes_.rend(); ++it)
+            {
+                auto& pass = *it;
+
+                pass.isAlive = pass.hasSideEffect;
+                for (const auto resource : pass.writes)
+                    pass.isAlive = pass.isAlive || resources_[resource].isImported || isNeeded[resource];
+
+                if (!pass.isAlive)
+                    continue;
+
+                for (const auto resource : pass.reads)
+                    isNeeded[resource] = true;
+            }
+        }
+
+        void RenderGraph::buildLevels()
+        {
+            // Last alive writer and readers since it, in declaration order.
+            std::vector<uint32_t> lastWriter(resources_.size(), InvalidLevel);
+            std::vector<std::vector<uint32_t>> readersSinceWrite(resources_.size());
+
+            uint32_t levelsCount = 0;
+
+            for (uint32_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+            {
+                auto& pass = passes_[passIndex];
+                if (!pass.isAlive)
+                    continue;
+
+                for (const auto resource : pass.reads)
+                    if (lastWriter[resource] != InvalidLevel)
+                        pass.dependencies.push_back(lastWriter[resource]);
+
+                for (const auto resource : pass.writes)
+                {
+                    if (lastWriter[resource] != InvalidLevel)
+                        pass.dependencies.push_back(lastWriter[resource]);
+
+                    for (const auto reader : readersSinceWrite[resource])
+                        if (reader != passIndex)
+                            pass.dependencies.push_back(reader);
+                }
+
+                pass.level = 0;
+                for (const auto dependency : pass.dependencies)
+                    pass.level = std::max(pass.level, passes_[dependency].level + 1);
+
+                levelsCount = std::max(levelsCount, pass.level + 1);
+
+                for (const auto resource : pass.reads)
+                    readersSinceWrite[resource].push_back(passIndex);
+
+                for (const auto resource : pass.writes)
+                {
+                    lastWriter[resource] = passIndex;
+                    readersSinceWrite[resource].clear();
+                }
+            }
+
+            levels_.resize(levelsCount);
+            for (uint32_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+                if (passes_[passIndex].isAlive)
+                    levels_[passes_[passIndex].level].push_back(passIndex);
+        }
+
+        void RenderGraph::computeLifetimes()
+        {
+            // Passes of the same level execute concurrently, so lifetimes are measured in levels.
+            for (const auto& pass : passes_)
+            {
+                if (!pass.isAlive)
+                    continue;
+
+                const auto extend = [&](uint32_t resourceIndex) {
+                    auto& resource = resources_[resourceIndex];
+                    resource.firstUse = std::min(resource.firstUse, pass.level);
+                    resource.lastUse = std::max(resource.lastUse, pass.level);
+                };
+
+                std::for_each(pass.reads.begin(), pass.reads.end(), extend);
+                std::for_each(pass.writes.begin(), pass.writes.end(), extend);
+            }
+
+            for (uint32_t resourceIndex = 0; resourceIndex < resources_.size(); resourceIndex++)
+            {
+                const auto& resource = resources_[resourceIndex];
+                if (resource.isImported || resource.firstUse == InvalidLevel)
+                    continue;
+
+                // Passes of level are sorted by index, which is their submission order.
+                for (const auto passIndex : levels_[resource.firstUse])
+                {
+                    auto& pass = passes_[passIndex];
+                    const auto isUsed = [resourceIndex](const std::vector<uint32_t>& resources) {
+                        return std::find(resources.begin(), resources.end(), resourceIndex) != resources.end();
+                    };
+
+                    if (isUsed(pass.reads) || isUsed(pass.writes))
+                    {
+                        pass.aliasedResources.push_back(resourceIndex);
+                        break;
+                    }
+                }
+            }
+        }
+
+        void RenderGraph::recordPass(uint32_t passIndex)
+        {
+            auto& pass = passes_[passIndex];
+
+            const auto commandList = deviceContext_.AcquireGraphicsCommandList();
+
+            commandList->BeginMarker(pass.name);
+
+            for (const auto resourceIndex : pass.aliasedResources)
+                commandList->AliasingBarrier(resources_[resourceIndex].texture);
+
+            pass.execute(*commandList, *this);
+            commandList->EndMarker();
+            commandList->Close();
+
+            commandLists_[passIndex] = commandList;
+        }
+
+        void RenderGraph::recordLevel(const std::vector<uint32_t>& passes)
+        {
+            if (passes.size() == 1 || workers_.empty())
+            {
+                for (const auto passIndex : passes)
+                    recordPass(passIndex);
+
+                return;
+            }
+
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                levelPasses_ = &passes;
+                nextPass_ = 0;
+                recordedPasses_ = 0;
+                levelGeneration_++;
+                workAvailable_.notify_all();
+            }
+
+            // Calling thread records as well.
+            uint32_t index;
+            while ((index = nextPass_.fetch_add(1)) < passes.size())
+            {
+                recordPass(passes[index]);
+                recordedPasses_++;
+            }
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+            levelRecorded_.wait(lock, [&] { return recordedPasses_ == passes.size() && activeWorkers_ == 0; });
+            levelPasses_ = nullptr;
+        }
+
+        void RenderGraph::workerFunc()
+        {
+            uint64_t generation = 0;
+
+            while (true)
+            {
+                const std::vector<uint32_t>* passes;
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                    workAvailable_.wait(lock, [&] { return terminateWorkers_ || levelGeneration_ != generation; });
+
+                    if (terminateWorkers_)
+                        return;
+
+                    generation = levelGeneration_;
+                    passes = levelPasses_;
+
+                    // Level is already recorded.
+                    if (!passes)
+                        continue;
+
+                    activeWorkers_++;
+                }
+
+                uint32_t index;
+                while ((index = nextPass_.fetch_add(1)) < passes->size())
+                {
+                    recordPass((*passes)[index]);
+                    recordedPasses_++;
+                }
+
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+                activeWorkers_--;
+                levelRecorded_.notify_one();
+            }
+        }
+    }
+}
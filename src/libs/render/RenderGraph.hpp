@@ -0,0 +1,157 @@
+#pragma once
+
+#include "gapi/Fence.hpp"
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/GpuResource.hpp"
+
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+#include <functional>
+
+namespace RR
+{
+    namespace Render
+    {
+        struct RenderGraphResource
+        {
+            static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+            bool IsValid() const { return index != InvalidIndex; }
+
+            uint32_t index = InvalidIndex;
+        };
+
+        class RenderGraph;
+
+        // Declares resource dependencies of the pass during setup.
+        class RenderGraphBuilder final : private NonCopyable
+        {
+        public:
+            // Transient texture, lives only between first and last pass using it.
+            RenderGraphResource CreateTexture(const GAPI::GpuResourceDescription& desc, const U8String& name);
+
+            RenderGraphResource Read(RenderGraphResource resource);
+            RenderGraphResource Write(RenderGraphResource resource);
+
+            // Pass is never culled.
+            void SetSideEffect();
+            // Work recorded up to the level of the pass is submitted once the level is recorded, e.g. after shadows and
+            // depth prepass, so GPU starts on it while the rest of the frame is recorded.
+            void SetSubmitCheckpoint();
+
+        private:
+            RenderGraphBuilder(RenderGraph& graph, uint32_t passIndex) : graph_(graph), passIndex_(passIndex) { }
+
+        private:
+            RenderGraph& graph_;
+            uint32_t passIndex_;
+
+            friend class RenderGraph;
+        };
+
+        // Passes declared with read/write dependencies. Compile culls passes not contributing to imported resources
+        // or side effects, groups independent passes into levels and computes transient textures lifetimes.
+        // Passes of level are recorded in parallel into separate command lists. Recorded levels are submitted at pass
+        // checkpoints and whenever pending work exceeds submit threshold, the rest is submitted at the end of Execute.
+        // Resource state transitions are resolved by GAPI command lists. Graph orders passes and issues aliasing barriers
+        // of transient textures, see Pass::aliasedResources.
+        class RenderGraph final : private NonCopyable
+        {
+        public:
+            using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+            using ExecuteFunction = std::function<void(GAPI::GraphicsCommandList&, const RenderGraph&)>;
+
+        public:
+            // Transient textures and command lists come from the device context.
+            explicit RenderGraph(DeviceContext& deviceContext);
+            ~RenderGraph();
+
+            // External resources are kept alive and treated as graph outputs.
+            RenderGraphResource ImportTexture(const std::shared_ptr<GAPI::Texture>& texture);
+
+            void AddPass(const U8String& name, const SetupFunction& setup, ExecuteFunction&& execute);
+
+            // Pending work commands, see CommandList::GetWorkCommandsCount, after which recorded levels are submitted
+            // without waiting for checkpoint. Zero submits only at checkpoints and at the end.
+            void SetSubmitThreshold(uint32_t workCommandsCount) { submitThreshold_ = workCommandsCount; }
+
+            void Compile();
+            // Returns sync point of the last submission.
+            GAPI::GpuSyncPoint Execute(const std::shared_ptr<GAPI::CommandQueue>& commandQueue);
+
+            // Clears passes and resources, recording could start for next frame.
+            void Reset();
+
+            // Valid only during pass execution.
+            const std::shared_ptr<GAPI::Texture>& GetTexture(RenderGraphResource resource) const;
+
+        private:
+            static constexpr uint32_t InvalidLevel = 0xFFFFFFFF;
+            // Roughly a millisecond of GPU work on typical scenes, large enough not to fragment submissions of small frames.
+            static constexpr uint32_t DefaultSubmitThreshold = 2000;
+
+            struct Resource
+            {
+                U8String name;
+                GAPI::GpuResourceDescription description;
+                std::shared_ptr<GAPI::Texture> texture;
+                bool isImported = false;
+                uint32_t firstUse = InvalidLevel;
+                uint32_t lastUse = 0;
+            };
+
+            struct Pass
+            {
+                U8String name;
+                ExecuteFunction execute;
+                std::vector<uint32_t> reads;
+                std::vector<uint32_t> writes;
+                std::vector<uint32_t> dependencies;
+                // Transient textures first used by the level of the pass. Barriers go into the first pass of the level
+                // using them, it's submitted ahead of the rest of the level.
+                std::vector<uint32_t> aliasedResources;
+                bool hasSideEffect = false;
+                bool isSubmitCheckpoint = false;
+                bool isAlive = false;
+                uint32_t level = InvalidLevel;
+            };
+
+            uint32_t addResource(Resource&& resource);
+            void cullPasses();
+            void buildLevels();
+            void computeLifetimes();
+
+            void recordPass(uint32_t passIndex);
+            void recordLevel(const std::vector<uint32_t>& passes);
+            void workerFunc();
+
+        private:
+            DeviceContext& deviceContext_;
+            bool isCompiled_ = false;
+            uint32_t submitThreshold_ = DefaultSubmitThreshold;
+            std::vector<Resource> resources_;
+            std::vector<Pass> passes_;
+            std::vector<std::vector<uint32_t>> levels_;
+            std::vector<std::shared_ptr<GAPI::CommandList>> commandLists_;
+
+            // Level recording state shared with workers.
+            const std::vector<uint32_t>* levelPasses_ = nullptr;
+            std::atomic<uint32_t> nextPass_ = 0;
+            std::atomic<uint32_t> recordedPasses_ = 0;
+            uint64_t levelGeneration_ = 0;
+            uint32_t activeWorkers_ = 0;
+            bool terminateWorkers_ = false;
+
+            Threading::Mutex mutex_;
+            Threading::ConditionVariable workAvailable_;
+            Threading::ConditionVariable levelRecorded_;
+            // Command list pools are per thread, so workers persist between frames.
+            std::vector<Threading::Thread> workers_;
+
+            friend class RenderGraphBuilder;
+        };
+    }
+}
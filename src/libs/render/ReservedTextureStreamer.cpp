@@ -0,0 +1,243 @@
+#include "ReservedTextureStreamer.hpp"
+
+#include "gapi/CommandQueue.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/UploadStreamer.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        ReservedTextureStreamer::~ReservedTextureStreamer()
+        {
+            ASSERT(!inited_);
+        }
+
+        void ReservedTextureStreamer::Init(DeviceContext& deviceContext, UploadStreamer& uploadStreamer)
+        {
+            ASSERT(!inited_);
+
+            uploadStreamer_ = &uploadStreamer;
+
+            slotTextures_.resize(MipFeedback::MaxSlots, nullptr);
+            feedback_.Init(deviceContext, [this](uint32_t slot, uint32_t finestMip) { onSlotFeedback(slot, finestMip); });
+
+            inited_ = true;
+        }
+
+        void ReservedTextureStreamer::Terminate()
+        {
+            ASSERT(inited_);
+
+            feedback_.Terminate();
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+            entries_.clear();
+            slotTextures_.clear();
+            uploadStreamer_ = nullptr;
+
+            inited_ = false;
+        }
+
+        void ReservedTextureStreamer::Register(const GAPI::Texture::SharedPtr& texture, MipLoader&& loader)
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+            ASSERT(loader);
+            ASSERT(IsSet(texture->GetDescription().GetBindFlags(), GAPI::GpuResourceBindFlags::Reserved));
+
+            const auto mipCount = texture->GetDescription().GetMipCount();
+
+            Entry entry;
+            entry.texture = texture;
+            entry.loader = std::move(loader);
+            entry.mipCount = mipCount;
+            entry.residentMip = mipCount;
+            entry.requestedMip = mipCount - 1;
+            entry.loadingMip = mipCount;
+            entry.lastRequestFrame.resize(mipCount, 0);
+            entry.feedbackSlot = feedback_.AllocateSlot();
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (entry.feedbackSlot != MipFeedback::InvalidSlot)
+                slotTextures_[entry.feedbackSlot] = texture.get();
+
+            const auto inserted = entries_.emplace(texture.get(), std::move(entry)).second;
+            ASSERT_MSG(inserted, "Texture is already registered");
+            std::ignore = inserted;
+        }
+
+        void ReservedTextureStreamer::Unregister(const GAPI::Texture::SharedPtr& texture)
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+
+            // Tiles are returned to the pool with the texture release.
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            const auto it = entries_.find(texture.get());
+            if (it == entries_.end())
+                return;
+
+            if (it->second.feedbackSlot != MipFeedback::InvalidSlot)
+            {
+                slotTextures_[it->second.feedbackSlot] = nullptr;
+                feedback_.ReleaseSlot(it->second.feedbackSlot);
+            }
+
+            entries_.erase(it);
+        }
+
+        void ReservedTextureStreamer::ReportFeedback(const GAPI::Texture::SharedPtr& texture, uint32_t finestMip)
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            const auto it = entries_.find(texture.get());
+            if (it == entries_.end())
+                return;
+
+            reportFeedback(it->second, finestMip);
+        }
+
+        uint32_t ReservedTextureStreamer::GetFeedbackSlot(const GAPI::Texture::SharedPtr& texture) const
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            const auto it = entries_.find(texture.get());
+            ASSERT(it != entries_.end());
+
+            return it->second.feedbackSlot;
+        }
+
+        void ReservedTextureStreamer::reportFeedback(Entry& entry, uint32_t finestMip) const
+        {
+            entry.requestedMip = std::min(entry.requestedMip, std::min(finestMip, entry.mipCount - 1));
+        }
+
+        void ReservedTextureStreamer::onSlotFeedback(uint32_t slot, uint32_t finestMip)
+        {
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            // Slot could be released while frame was in flight.
+            const auto* texture = slot < slotTextures_.size() ? slotTextures_[slot] : nullptr;
+            if (!texture)
+                return;
+
+            const auto it = entries_.find(texture);
+            ASSERT(it != entries_.end());
+
+            reportFeedback(it->second, finestMip);
+        }
+
+        uint32_t ReservedTextureStreamer::GetResidentMip(const GAPI::Texture::SharedPtr& texture) const
+        {
+            ASSERT(inited_);
+            ASSERT(texture);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            const auto it = entries_.find(texture.get());
+            ASSERT(it != entries_.end());
+
+            return it->second.residentMip;
+        }
+
+        void ReservedTextureStreamer::Update()
+        {
+            ASSERT(inited_);
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            struct LoadCandidate
+            {
+                Entry* entry;
+                uint32_t requestedMip;
+            };
+
+            std::vector<GAPI::TileMappingUpdate> updates;
+            std::vector<LoadCandidate> candidates;
+            std::vector<Entry*> loadingEntries;
+
+            for (auto& [_, entry] : entries_)
+            {
+                if (entry.loadingSyncPoint.IsValid() && entry.loadingSyncPoint.IsComplete())
+                {
+                    entry.residentMip = entry.loadingMip;
+                    entry.loadingSyncPoint = {};
+                }
+
+                const auto coarsestMip = entry.mipCount - 1;
+                const auto requestedMip = entry.requestedMip;
+                entry.requestedMip = coarsestMip;
+
+                for (uint32_t mipLevel = requestedMip; mipLevel < entry.mipCount; mipLevel++)
+                    entry.lastRequestFrame[mipLevel] = frameIndex_;
+
+                if (entry.loadingSyncPoint.IsValid())
+                    continue;
+
+                if (requestedMip < entry.residentMip)
+                {
+                    candidates.push_back({ &entry, requestedMip });
+                    continue;
+                }
+
+                // Evicted mip is out of the clamp before unmapping, frames in flight didn't request it for a long time.
+                while (entry.residentMip < coarsestMip && frameIndex_ - entry.lastRequestFrame[entry.residentMip] > EvictionDelay)
+                {
+                    updates.push_back({ entry.texture, entry.residentMip, false });
+                    entry.residentMip++;
+                }
+            }
+
+            // Priority is the count of missing mips, so the most blurry textures on screen are loaded first.
+            std::sort(candidates.begin(), candidates.end(), [](const LoadCandidate& lhs, const LoadCandidate& rhs) {
+                return lhs.entry->residentMip - lhs.requestedMip > rhs.entry->residentMip - rhs.requestedMip;
+            });
+
+            uint32_t budget = MaxMipsLoadedPerUpdate;
+            for (const auto& candidate : candidates)
+            {
+                if (budget == 0)
+                    break;
+
+                auto& entry = *candidate.entry;
+                const auto mipsCount = std::min({ entry.residentMip - candidate.requestedMip, MaxMipsLoadedPerTexture, budget });
+
+                entry.loadingMip = entry.residentMip - mipsCount;
+                budget -= mipsCount;
+
+                for (uint32_t mipLevel = entry.loadingMip; mipLevel < entry.residentMip; mipLevel++)
+                    updates.push_back({ entry.texture, mipLevel, true });
+
+                loadingEntries.push_back(&entry);
+            }
+
+            auto& uploadStreamer = *uploadStreamer_;
+            uploadStreamer.UpdateTileMappings(std::move(updates));
+
+            // Uploads follow mappings on the copy queue, the latest sync point covers all mips of the entry.
+            for (auto* entry : loadingEntries)
+            {
+                for (uint32_t mipLevel = entry->loadingMip; mipLevel < entry->residentMip; mipLevel++)
+                {
+                    const auto& resourceData = entry->loader(entry->texture, mipLevel);
+                    ASSERT(resourceData);
+                    ASSERT(resourceData->GetFirstSubresource() == mipLevel && resourceData->GetNumSubresources() == 1);
+
+                    entry->loadingSyncPoint = uploadStreamer.Upload(entry->texture, resourceData);
+                }
+            }
+
+            frameIndex_++;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "gapi/Fence.hpp"
+#include "gapi/ForwardDeclarations.hpp"
+
+#include "render/MipFeedback.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <functional>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Render
+    {
+        class UploadStreamer;
+
+        // Keeps only mips sampled on GPU resident in reserved textures. Feedback is the finest sampled mip,
+        // written by shaders into MipFeedback slot of the texture or reported from CPU. Mips are loaded from coarse
+        // to fine and evicted from fine to coarse, so resident mips are always a contiguous tail of the chain.
+        // Textures furthest from requested detail are loaded first, so upload bandwidth goes to what's on screen.
+        class ReservedTextureStreamer final : private NonCopyable
+        {
+        public:
+            // Returns upload data of the single mip level.
+            using MipLoader = std::function<std::shared_ptr<GAPI::CpuResourceData>(const std::shared_ptr<GAPI::Texture>& texture, uint32_t mipLevel)>;
+
+            ReservedTextureStreamer() = default;
+            ~ReservedTextureStreamer();
+
+            // Mips are uploaded by upload streamer of the same device context.
+            void Init(DeviceContext& deviceContext, UploadStreamer& uploadStreamer);
+            void Terminate();
+
+            // Coarsest mip is loaded by the next Update and stays resident until texture is unregistered.
+            void Register(const std::shared_ptr<GAPI::Texture>& texture, MipLoader&& loader);
+            void Unregister(const std::shared_ptr<GAPI::Texture>& texture);
+
+            // Thread safe. Feedback of the frame could come from several readbacks.
+            void ReportFeedback(const std::shared_ptr<GAPI::Texture>& texture, uint32_t finestMip);
+            // MipFeedback::InvalidSlot when all slots are taken, feedback should be reported from CPU then.
+            uint32_t GetFeedbackSlot(const std::shared_ptr<GAPI::Texture>& texture) const;
+            uint32_t GetFeedbackBindlessIndex() const { return feedback_.GetBindlessIndex(); }
+            // Call after frame work is submitted to the queue, feedback arrives once GPU completed the frame.
+            void ResolveFeedback(const std::shared_ptr<GAPI::CommandQueue>& commandQueue) { feedback_.Resolve(commandQueue); }
+            // Finest mip with uploaded data, sampling should be clamped to it. Mip count while nothing is resident.
+            uint32_t GetResidentMip(const std::shared_ptr<GAPI::Texture>& texture) const;
+
+            // Once per frame. Maps and uploads requested mips, unmaps mips not requested for EvictionDelay frames.
+            void Update();
+
+        private:
+            struct Entry
+            {
+                std::shared_ptr<GAPI::Texture> texture;
+                MipLoader loader;
+                uint32_t mipCount;
+                uint32_t residentMip;
+                uint32_t requestedMip;
+                // Mips being uploaded, resident once sync point is reached. Single load in flight per texture.
+                uint32_t loadingMip;
+                GAPI::GpuSyncPoint loadingSyncPoint;
+                std::vector<uint64_t> lastRequestFrame;
+                uint32_t feedbackSlot;
+            };
+
+            void reportFeedback(Entry& entry, uint32_t finestMip) const;
+            void onSlotFeedback(uint32_t slot, uint32_t finestMip);
+
+        private:
+            static constexpr uint32_t EvictionDelay = 60;
+            // Limit upload memory and copy queue work per frame.
+            static constexpr uint32_t MaxMipsLoadedPerUpdate = 8;
+            static constexpr uint32_t MaxMipsLoadedPerTexture = 2;
+
+            bool inited_ = false;
+            UploadStreamer* uploadStreamer_ = nullptr;
+            uint64_t frameIndex_ = 0;
+            std::unordered_map<const GAPI::Texture*, Entry> entries_;
+            MipFeedback feedback_;
+            std::vector<const GAPI::Texture*> slotTextures_;
+            mutable Threading::Mutex mutex_;
+        };
+    }
+}
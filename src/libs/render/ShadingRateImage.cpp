@@ -0,0 +1,102 @@
+#include "ShadingRateImage.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Limits.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            constexpr const char* ShaderPath = "shaders/ShadingRate_Generate.bin";
+        }
+
+        ShadingRateImage::~ShadingRateImage()
+        {
+            ASSERT(!inited_);
+        }
+
+        void ShadingRateImage::Init(DeviceContext& deviceContext, const Description& description)
+        {
+            ASSERT(!inited_);
+            ASSERT(description.width > 0 && description.height > 0);
+
+            description_ = description;
+            support_ = deviceContext.GetShadingRateSupport();
+            inited_ = true;
+
+            if (support_.tier != GAPI::ShadingRateTier::Tier2)
+                return;
+
+            ASSERT(support_.imageTileSize > 0);
+
+            if (!pipeline_.Init(deviceContext, ShaderPath, "ShadingRateImage", "variable rate shading image is disabled"))
+                return;
+
+            const uint32_t tileSize = support_.imageTileSize;
+            const uint32_t width = (description.width + tileSize - 1) / tileSize;
+            const uint32_t height = (description.height + tileSize - 1) / tileSize;
+            ASSERT(width <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION && height <= GAPI::MAX_THREAD_GROUPS_PER_DIMENSION);
+
+            const auto& textureDescription = GAPI::GpuResourceDescription::Texture2D(width, height, GAPI::GpuResourceFormat::R8Uint,
+                                                                                     GAPI::GpuResourceBindFlags::UnorderedAccess, 1, 1);
+            texture_ = deviceContext.CreateTexture(textureDescription, GAPI::GpuResourceCpuAccess::None, "ShadingRateImage");
+            textureUav_ = deviceContext.CreateUnorderedAccessView(texture_, GAPI::GpuResourceViewDescription::Texture(GAPI::GpuResourceFormat::R8Uint, 0, 1, 0, 1));
+        }
+
+        void ShadingRateImage::Terminate()
+        {
+            ASSERT(inited_);
+
+            textureUav_ = nullptr;
+            texture_ = nullptr;
+            pipeline_.Terminate();
+
+            inited_ = false;
+        }
+
+        void ShadingRateImage::Generate(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& color,
+                                        const std::shared_ptr<GAPI::ShaderResourceView>& motion)
+        {
+            ASSERT(inited_);
+            ASSERT(color);
+
+            if (!IsAvailable())
+                return;
+
+            Constants constants;
+            constants.colorIndex = color->GetBindlessIndex();
+            constants.motionIndex = motion ? motion->GetBindlessIndex() : GAPI::GpuResourceView::InvalidBindlessIndex;
+            constants.outputIndex = textureUav_->GetBindlessIndex();
+            constants.tileSize = support_.imageTileSize;
+            constants.size[0] = description_.width;
+            constants.size[1] = description_.height;
+            constants.maxRateLog2 = support_.additionalRates ? 2 : 1;
+            constants.contrastThreshold = description_.contrastThreshold;
+            constants.motionThreshold = description_.motionThreshold;
+
+            pipeline_.Bind(commandList);
+
+            commandList.BeginMarker("ShadingRateImage");
+
+            commandList.TransitionToShaderResource(color);
+            if (motion)
+                commandList.TransitionToShaderResource(motion);
+            commandList.TransitionToUnorderedAccess(textureUav_);
+
+            commandList.SetComputeConstantBuffer(RootParameter::Constants, commandList.AllocateConstants(constants));
+            commandList.SetComputeDescriptorTable(RootParameter::Textures, 0);
+            commandList.SetComputeDescriptorTable(RootParameter::Images, 0);
+
+            const auto& textureDescription = texture_->GetDescription();
+            commandList.Dispatch(textureDescription.GetWidth(), textureDescription.GetHeight());
+
+            commandList.EndMarker();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "gapi/ForwardDeclarations.hpp"
+#include "gapi/ShadingRate.hpp"
+
+#include "render/ComputePipeline.hpp"
+
+#include "common/Math.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        class DeviceContext;
+
+        // Builds variable rate shading image from color and motion of a frame, usually the previous one. Tiles of low
+        // contrast or fast motion don't show lost detail, so they are shaded coarser, each axis independently.
+        // Bind GetTexture with GraphicsCommandList::SetShadingRateImage and Override or Max combiner.
+        class ShadingRateImage final : private NonCopyable
+        {
+        public:
+            static constexpr uint32_t ThreadGroupSize = 8;
+
+            struct Description
+            {
+                // Size of shaded render target in pixels.
+                uint32_t width = 0;
+                uint32_t height = 0;
+                // Weber contrast of neighbour pixels below which axis is shaded at half rate, quarter rate below quarter of it.
+                float contrastThreshold = 0.05f;
+                // Pixels per frame above which tile is coarsened one more step.
+                float motionThreshold = 4.0f;
+            };
+
+            ShadingRateImage() = default;
+            ~ShadingRateImage();
+
+            void Init(DeviceContext& deviceContext, const Description& description);
+            void Terminate();
+
+            // False below variable rate shading tier 2 or when shader bytecode wasn't found, Generate is skipped then.
+            bool IsAvailable() const { return pipeline_.IsAvailable(); }
+
+            // Color is any float format of description size. Motion holds pixel offsets in xy, null treats scene as static.
+            void Generate(GAPI::ComputeCommandList& commandList, const std::shared_ptr<GAPI::ShaderResourceView>& color,
+                          const std::shared_ptr<GAPI::ShaderResourceView>& motion);
+
+            // R8Uint, one texel per tile of ShadingRateSupport::imageTileSize. Null unless available.
+            const std::shared_ptr<GAPI::Texture>& GetTexture() const { return texture_; }
+
+        private:
+            enum RootParameter : uint32_t
+            {
+                Constants,
+                Textures,
+                Images
+            };
+
+            // Matches layout in shaders/ShadingRate.slang.
+            struct Constants final
+            {
+                uint32_t colorIndex;
+                uint32_t motionIndex;
+                uint32_t outputIndex;
+                uint32_t tileSize;
+                uint32_t size[2];
+                uint32_t maxRateLog2;
+                float contrastThreshold;
+                float motionThreshold;
+            };
+
+        private:
+            bool inited_ = false;
+            Description description_;
+            GAPI::ShadingRateSupport support_;
+
+            ComputePipeline pipeline_;
+            std::shared_ptr<GAPI::Texture> texture_;
+            std::shared_ptr<GAPI::UnorderedAccessView> textureUav_;
+        };
+    }
+}
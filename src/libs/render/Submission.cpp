@@ -2,14 +2,22 @@
 
 #include "gapi/CommandList.hpp"
 #include "gapi/CommandQueue.hpp"
+#include "gapi/Fence.hpp"
+#include "gapi/LinearAllocator.hpp"
 #include "gapi/SwapChain.hpp"
 
+#include "render/CommandCapture.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
 #include "common/debug/DebugStream.hpp"
+#include "common/debug/Profiler.hpp"
 #include "common/threading/BufferedChannel.hpp"
-#include "common/threading/ConditionVariable.hpp"
-#include "common/threading/Mutex.hpp"
+#include "common/threading/CpuTopology.hpp"
+#include "common/threading/Event.hpp"
+#include "common/threading/MpscChannel.hpp"
 
 #include <chrono>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <variant>
@@ -38,10 +46,15 @@ namespace RR
                        (commandQueueType == GAPI::CommandQueueType::Graphics && commandListType == GAPI::CommandListType::Graphics);
             }
 
+            // Move only. Command queue referenced by raw pointer and should outlive submission of the task.
             struct Task final
             {
             public:
                 Task() = default;
+                Task(Task&&) = default;
+                Task(const Task&) = delete;
+                Task& operator=(Task&&) = default;
+                Task& operator=(const Task&) = delete;
 
                 struct Terminate
                 {
@@ -52,13 +65,46 @@ namespace RR
                     Submission::CallbackFunction function;
                 };
 
+                // Signal fence is owned by command queue and lives as long as queue.
                 struct Submit
                 {
-                    std::shared_ptr<GAPI::CommandQueue> commandQueue;
+                    GAPI::CommandQueue* commandQueue;
                     std::shared_ptr<GAPI::CommandList> commandList;
+                    GAPI::Fence* signalFence;
+                    uint64_t signalValue;
                 };
 
-                using TaskVariant = std::variant<Terminate, Callback, Submit>;
+                // Command lists live in frame allocator and should be destroyed by consumer.
+                struct SubmitBatch
+                {
+                    GAPI::CommandQueue* commandQueue;
+                    std::shared_ptr<GAPI::CommandList>* commandLists;
+                    uint32_t count;
+                    GAPI::Fence* signalFence;
+                    uint64_t signalValue;
+                };
+
+                struct Signal
+                {
+                    GAPI::CommandQueue* commandQueue;
+                    GAPI::Fence* signalFence;
+                    uint64_t signalValue;
+                };
+
+                struct Wait
+                {
+                    GAPI::CommandQueue* commandQueue;
+                    GAPI::GpuSyncPoint syncPoint;
+                };
+
+                // Swap chains live in frame allocator and should be destroyed by consumer.
+                struct Present
+                {
+                    std::shared_ptr<GAPI::SwapChain>* swapChains;
+                    uint32_t count;
+                };
+
+                using TaskVariant = std::variant<Terminate, Callback, Submit, SubmitBatch, Signal, Wait, Present>;
 
             public:
                 TaskVariant taskVariant;
@@ -69,9 +115,22 @@ namespace RR
             };
         }
 
-        Submission::Submission()
-            : inputTaskChannel_(std::make_unique<BufferedChannel>())
+        Submission::Submission(uint32_t submitBatchSize)
+            : submitBatchSize_(submitBatchSize),
+              inputTaskChannel_(std::make_unique<TaskChannel>())
         {
+#ifdef ENABLE_COMMAND_CAPTURE
+            commandCapture_ = std::make_unique<CommandCapture>();
+#endif
+
+            ASSERT(submitBatchSize_ > 0 && submitBatchSize_ <= GAPI::MAX_SUBMIT_BATCH_SIZE);
+
+            for (auto& frameAllocator : frameAllocators_)
+                frameAllocator = std::make_unique<GAPI::LinearAllocator>(FrameAllocatorBaseSize);
+
+#if ENABLE_SUBMISSION_THREAD
+            batchCommandLists_.reserve(submitBatchSize_);
+#endif
         }
 
         Submission::~Submission()
@@ -82,19 +141,42 @@ namespace RR
 #endif
         }
 
-        void Submission::Start(const GAPI::Device::SharedPtr& device)
+        void Submission::Start(const GAPI::Device::SharedPtr& device, bool enablePresentThread)
         {
             ASSERT(device);
             ASSERT(!inputTaskChannel_->IsClosed());
 
             device_ = device;
 
+            // Frame storage is reused once frame gpuFramesBuffered ago is processed.
+            frameAllocatorsCount_ = device->GetDescription().gpuFramesBuffered;
+            ASSERT(frameAllocatorsCount_ > 0 && frameAllocatorsCount_ <= GAPI::MAX_GPU_FRAMES_BUFFERED);
+
 #if ENABLE_SUBMISSION_THREAD
             ASSERT(!submissionThread_.IsJoinable());
 
             submissionThread_ = Threading::Thread("Submission Thread", [this] {
                 this->threadFunc();
             });
+
+            // Every frame waits for submission, efficiency cores of hybrid CPUs show up as frame time spikes.
+            const auto& topology = Threading::CpuTopology::Get();
+            submissionThread_.SetPriority(Threading::ThreadPriority::AboveNormal);
+            submissionThread_.SetQoS(Threading::ThreadQoS::High);
+            if (topology.IsHybrid())
+                submissionThread_.SetAffinity(topology.GetPerformanceCoresMask());
+
+            if (enablePresentThread)
+            {
+                ASSERT(!presentThread_.IsJoinable());
+
+                presentChannel_ = std::make_unique<Threading::BufferedChannel<uint32_t, 2>>();
+                presentThread_ = Threading::Thread("Present Thread", [this] {
+                    this->presentThreadFunc();
+                });
+            }
+#else
+            std::ignore = enablePresentThread;
 #endif
         }
 
@@ -105,75 +187,158 @@ namespace RR
             ASSERT(submissionThread_.IsJoinable())
 
             Task task;
-            task.taskVariant = std::move(taskVariant);
+            task.taskVariant = std::forward<T>(taskVariant);
 
 #ifdef DEBUG
             //  constexpr int STACK_SIZE = 32;
             //  task.stackTrace.load_here(STACK_SIZE);
 #endif
 
-            inputTaskChannel_->Put(task);
+            pendingTasksCount_.fetch_add(1, std::memory_order_relaxed);
+            inputTaskChannel_->Put(std::move(task));
 #else
             ASSERT(device_);
             doTask(taskVariant);
 #endif
         }
 
-        void Submission::Submit(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::CommandList::SharedPtr& commandList)
+        template <typename T>
+        T* Submission::allocateTransient(size_t count)
+        {
+            ASSERT(count > 0);
+
+            Threading::ReadWriteGuard lock(frameAllocatorSpinlock_);
+            return static_cast<T*>(frameAllocators_[frameAllocatorIndex_]->Allocate(sizeof(T) * count));
+        }
+
+        void Submission::ResetFrameAllocator(uint64_t frameIndex)
+        {
+            Threading::ReadWriteGuard lock(frameAllocatorSpinlock_);
+
+            frameAllocatorIndex_ = frameIndex % frameAllocatorsCount_;
+            frameAllocators_[frameAllocatorIndex_]->Reset();
+        }
+
+        void Submission::Submit(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::CommandList::SharedPtr& commandList, const GAPI::GpuSyncPoint& syncPoint)
         {
             ASSERT(commandQueue);
             ASSERT(commandList);
+            ASSERT(syncPoint.IsValid());
             ASSERT(isListTypeCompatable(commandQueue->GetCommandQueueType(), commandList->GetCommandListType()));
 
             Task::Submit task;
-            task.commandQueue = commandQueue;
+            task.commandQueue = commandQueue.get();
             task.commandList = commandList;
+            task.signalFence = syncPoint.fence.get();
+            task.signalValue = syncPoint.value;
 
-            putTask(task);
+            putTask(std::move(task));
         }
 
-        void Submission::ExecuteAsync(const CallbackFunction&& function)
+        void Submission::Submit(const GAPI::CommandQueue::SharedPtr& commandQueue, const std::vector<GAPI::CommandList::SharedPtr>& commandLists, const GAPI::GpuSyncPoint& syncPoint)
         {
-            //  Task::Callback task;
-            // task.function = function;
+            ASSERT(commandQueue);
+            ASSERT(!commandLists.empty());
+            ASSERT(syncPoint.IsValid());
+
+            for (const auto& commandList : commandLists)
+            {
+                ASSERT(commandList);
+                ASSERT(isListTypeCompatable(commandQueue->GetCommandQueueType(), commandList->GetCommandListType()));
+            }
+
+            Task::SubmitBatch task;
+            task.commandQueue = commandQueue.get();
+            task.count = static_cast<uint32_t>(commandLists.size());
+            task.commandLists = allocateTransient<GAPI::CommandList::SharedPtr>(task.count);
+            std::uninitialized_copy(commandLists.begin(), commandLists.end(), task.commandLists);
+            task.signalFence = syncPoint.fence.get();
+            task.signalValue = syncPoint.value;
+
+            putTask(std::move(task));
+        }
+
+        void Submission::Signal(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::GpuSyncPoint& syncPoint)
+        {
+            ASSERT(commandQueue);
+            ASSERT(syncPoint.IsValid());
+
+            putTask(Task::Signal { commandQueue.get(), syncPoint.fence.get(), syncPoint.value });
+        }
+
+        void Submission::Wait(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::GpuSyncPoint& syncPoint)
+        {
+            ASSERT(commandQueue);
+            ASSERT(syncPoint.IsValid());
+
+            putTask(Task::Wait { commandQueue.get(), syncPoint });
+        }
 
-            putTask(std::move(Task::Callback { function }));
+        void Submission::ExecuteAsync(CallbackFunction&& function)
+        {
+            putTask(Task::Callback { std::move(function) });
         }
 
-        void Submission::ExecuteAwait(const CallbackFunction&& function)
+        void Submission::ExecuteAwait(CallbackFunction&& function)
         {
             Task::Callback task;
 
 #if ENABLE_SUBMISSION_THREAD
-            Threading::Mutex mutex;
-            Threading::UniqueLock<Threading::Mutex> lock(mutex);
-            Threading::ConditionVariable condition;
+            // Caller is blocked for a whole round trip to submission thread, wake latency adds to it directly.
+            Threading::Event done;
 
-            task.function = [&condition, &function, &mutex](GAPI::Device& device) {
-                Threading::UniqueLock<Threading::Mutex> lock(mutex);
+            task.function = [&done, &function](GAPI::Device& device) {
                 function(device);
-                condition.notify_one();
+                done.Notify();
             };
 
-            putTask(task);
+            putTask(std::move(task));
 
-            condition.wait(lock);
+            done.Wait();
 #else
-            GAPI::void result = GAPI::void ::Fail;
+            task.function = std::move(function);
+            putTask(std::move(task));
+#endif
+        }
 
-            task.function = [&function, &result](GAPI::Device& device) {
-                result = function(device);
-                return result;
-            };
+        void Submission::Present(const std::shared_ptr<GAPI::SwapChain>& swapChain)
+        {
+            ASSERT(swapChain);
+
+            Task::Present task;
+            task.count = 1;
+            task.swapChains = allocateTransient<GAPI::SwapChain::SharedPtr>(task.count);
+            new (task.swapChains) GAPI::SwapChain::SharedPtr(swapChain);
+
+            putTask(std::move(task));
+        }
 
-            putTask(task);
+        void Submission::Present(const std::vector<std::shared_ptr<GAPI::SwapChain>>& swapChains)
+        {
+            ASSERT(!swapChains.empty());
+
+            for (const auto& swapChain : swapChains)
+                ASSERT(swapChain);
+
+            Task::Present task;
+            task.count = static_cast<uint32_t>(swapChains.size());
+            task.swapChains = allocateTransient<GAPI::SwapChain::SharedPtr>(task.count);
+            std::uninitialized_copy(swapChains.begin(), swapChains.end(), task.swapChains);
+
+            putTask(std::move(task));
+        }
+
+        void Submission::WaitForPresent()
+        {
+#if ENABLE_SUBMISSION_THREAD
+            if (presentChannel_)
+                presentIdle_.Wait();
 #endif
         }
 
         void Submission::Terminate()
         {
-            Task::Terminate task;
-            putTask(task);
+            putTask(Task::Terminate {});
 
             inputTaskChannel_->Close();
 
@@ -183,13 +348,46 @@ namespace RR
 #endif
 
             //Reset channel to allow reuse submission after terminate
-            inputTaskChannel_ = std::make_unique<BufferedChannel>();
+            inputTaskChannel_ = std::make_unique<TaskChannel>();
         }
 
         template <>
         inline void Submission::doTask(const Task::Submit& task)
         {
+#ifdef ENABLE_COMMAND_CAPTURE
+            commandCapture_->OnSubmit(task.commandQueue->GetCommandQueueType(), &task.commandList, 1);
+#endif
             task.commandQueue->Submit(task.commandList);
+            task.signalFence->Signal(*task.commandQueue, task.signalValue);
+        }
+
+        template <>
+        inline void Submission::doTask(const Task::SubmitBatch& task)
+        {
+#ifdef ENABLE_COMMAND_CAPTURE
+            commandCapture_->OnSubmit(task.commandQueue->GetCommandQueueType(), task.commandLists, task.count);
+#endif
+
+            for (size_t offset = 0; offset < task.count; offset += submitBatchSize_)
+            {
+                const auto last = std::min<size_t>(offset + submitBatchSize_, task.count);
+                task.commandQueue->Submit(std::vector<GAPI::CommandList::SharedPtr>(task.commandLists + offset, task.commandLists + last));
+            }
+
+            std::destroy_n(task.commandLists, task.count);
+            task.signalFence->Signal(*task.commandQueue, task.signalValue);
+        }
+
+        template <>
+        inline void Submission::doTask(const Task::Signal& task)
+        {
+            task.signalFence->Signal(*task.commandQueue, task.signalValue);
+        }
+
+        template <>
+        inline void Submission::doTask(const Task::Wait& task)
+        {
+            task.commandQueue->Wait(task.syncPoint);
         }
 
         template <>
@@ -198,9 +396,41 @@ namespace RR
             task.function(*device_);
         }
 
+        template <>
+        inline void Submission::doTask(const Task::Present& task)
+        {
+#if ENABLE_SUBMISSION_THREAD
+            if (presentChannel_)
+            {
+                // Frame's command lists are submitted already, so the present is ordered after them on the queue.
+                WaitForPresent();
+                presentIdle_.Reset();
+
+                presentBatch_.assign(std::make_move_iterator(task.swapChains), std::make_move_iterator(task.swapChains + task.count));
+                std::destroy_n(task.swapChains, task.count);
+
+                presentChannel_->Put(task.count);
+                return;
+            }
+#endif
+            for (uint32_t index = 0; index < task.count; index++)
+                device_->Present(task.swapChains[index]);
+
+            std::destroy_n(task.swapChains, task.count);
+        }
+
         template <>
         inline void Submission::doTask(const Task::Terminate& task)
         {
+#if ENABLE_SUBMISSION_THREAD
+            // Present thread uses the device.
+            if (presentChannel_)
+            {
+                presentChannel_->Close();
+                presentThread_.Join();
+                presentChannel_ = nullptr;
+            }
+#endif
             device_.reset();
             Log::Print::Info("Device terminated.\n");
         }
@@ -216,30 +446,136 @@ namespace RR
         overloaded(Ts...) -> overloaded<Ts...>;
 
 #if ENABLE_SUBMISSION_THREAD
+        void Submission::flushSubmitBatch()
+        {
+            if (batchCommandLists_.empty())
+                return;
+
+            PROFILE_SCOPE("Submission::FlushSubmitBatch");
+
+            ASSERT(batchCommandQueue_);
+
+#ifdef ENABLE_COMMAND_CAPTURE
+            commandCapture_->OnSubmit(batchCommandQueue_->GetCommandQueueType(), batchCommandLists_.data(), batchCommandLists_.size());
+#endif
+
+            if (batchCommandLists_.size() == 1)
+                batchCommandQueue_->Submit(batchCommandLists_.front());
+            else
+                batchCommandQueue_->Submit(batchCommandLists_);
+
+            if (batchSignalFence_)
+                batchSignalFence_->Signal(*batchCommandQueue_, batchSignalValue_);
+
+            batchCommandLists_.clear();
+            batchCommandQueue_ = nullptr;
+            batchSignalFence_ = nullptr;
+        }
+
         void Submission::threadFunc()
         {
+            Profiler::SetThreadName("Submission");
+            ALLOCATION_TAG_SCOPE(Submission);
+
+            const auto appendToBatch = [this](GAPI::CommandQueue* commandQueue, GAPI::CommandList::SharedPtr&& commandList) {
+                if (batchCommandQueue_ != commandQueue || batchCommandLists_.size() >= submitBatchSize_)
+                    flushSubmitBatch();
+
+                // Batch storage is reserved for submitBatchSize_ lists.
+                ASSERT_NO_ALLOCATIONS_SCOPE();
+                batchCommandQueue_ = commandQueue;
+                batchCommandLists_.push_back(std::move(commandList));
+            };
+
+            // Values on queue timeline are increasing, so only latest one have to be signaled.
+            const auto setBatchSignal = [this](GAPI::Fence* signalFence, uint64_t signalValue) {
+                ASSERT(!batchSignalFence_ || batchSignalFence_ == signalFence);
+                ASSERT(signalValue > batchSignalValue_ || !batchSignalFence_);
+
+                batchSignalFence_ = signalFence;
+                batchSignalValue_ = signalValue;
+            };
+
             while (true)
             {
-                auto inputTaskOptional = inputTaskChannel_->GetNext();
-                // Channel was closed and no task
+                // Block only when there is nothing left to submit,
+                // otherwise drain available tasks and coalesce consecutive submits.
+                auto inputTaskOptional = [this] {
+                    // Tasks are passed by value through preallocated channel.
+                    ASSERT_NO_ALLOCATIONS_SCOPE();
+                    return batchCommandLists_.empty() ? inputTaskChannel_->GetNext() : inputTaskChannel_->TryGetNext();
+                }();
+
                 if (!inputTaskOptional.has_value())
+                {
+                    if (!batchCommandLists_.empty())
+                    {
+                        flushSubmitBatch();
+                        continue;
+                    }
+
+                    // Channel was closed and no task
                     return;
+                }
 
-                const auto& inputTask = inputTaskOptional.value();
+                auto& inputTask = inputTaskOptional.value();
 
                 ASSERT(device_)
 
+                PROFILE_SCOPE("Submission::Task");
+
                 std::visit(
                     overloaded {
-                        [this](const Task::Submit& task) { return doTask(task); },
-                        [this](const Task::Callback& task) { return doTask(task); },
-                        [this](const Task::Terminate& task) { return doTask(task); },
+                        [&appendToBatch, &setBatchSignal](Task::Submit& task) {
+                            appendToBatch(task.commandQueue, std::move(task.commandList));
+                            setBatchSignal(task.signalFence, task.signalValue);
+                        },
+                        [&appendToBatch, &setBatchSignal](Task::SubmitBatch& task) {
+                            for (uint32_t index = 0; index < task.count; index++)
+                                appendToBatch(task.commandQueue, std::move(task.commandLists[index]));
+
+                            // Batch could be flushed in the middle, signal only after the last list.
+                            setBatchSignal(task.signalFence, task.signalValue);
+                            std::destroy_n(task.commandLists, task.count);
+                        },
+                        [this](const Task::Signal& task) { flushSubmitBatch(); return doTask(task); },
+                        [this](const Task::Wait& task) { flushSubmitBatch(); return doTask(task); },
+                        [this](const Task::Callback& task) { flushSubmitBatch(); return doTask(task); },
+                        [this](const Task::Present& task) { flushSubmitBatch(); return doTask(task); },
+                        [this](const Task::Terminate& task) { flushSubmitBatch(); return doTask(task); },
                     },
                     inputTask.taskVariant);
 
+                pendingTasksCount_.fetch_sub(1, std::memory_order_relaxed);
+
                 //std::this_thread::sleep_for(50ms);
             }
         }
+
+        void Submission::presentThreadFunc()
+        {
+            Profiler::SetThreadName("Present");
+
+            while (true)
+            {
+                const auto count = presentChannel_->GetNext();
+                if (!count.has_value())
+                    return;
+
+                {
+                    PROFILE_SCOPE("Submission::Present");
+
+                    ASSERT(count.value() == presentBatch_.size());
+                    for (const auto& swapChain : presentBatch_)
+                        device_->Present(swapChain);
+                }
+
+                // Swap chains are released here, not by submission thread refilling the batch.
+                presentBatch_.clear();
+
+                presentIdle_.Notify();
+            }
+        }
 #endif
     }
 };
\ No newline at end of file
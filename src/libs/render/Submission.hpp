@@ -4,9 +4,16 @@
 #include "gapi/ForwardDeclarations.hpp"
 #include "gapi/SwapChain.hpp"
 
+#include "common/InplaceFunction.hpp"
+#include "common/threading/Event.hpp"
+#include "common/threading/SpinLock.hpp"
 #include "common/threading/Thread.hpp"
 
+#include <array>
+#include <atomic>
+
 #define ENABLE_SUBMISSION_THREAD true
+#define ENABLE_LOCKFREE_SUBMISSION_CHANNEL true
 
 namespace RR
 {
@@ -16,6 +23,9 @@ namespace RR
         {
             template <typename T, std::size_t BufferSize>
             class BufferedChannel;
+
+            template <typename T, std::size_t BufferSize>
+            class MpscChannel;
         }
     }
 
@@ -26,22 +36,48 @@ namespace RR
             struct Task;
         }
 
+        class CommandCapture;
+
         class Submission final
         {
         public:
-            using CallbackFunction = std::function<void(GAPI::Device& device)>;
+            // Callback captures stored inline in task, no allocations on submission.
+            static constexpr size_t CallbackCaptureSize = 128;
+            using CallbackFunction = Common::InplaceFunction<void(GAPI::Device& device), CallbackCaptureSize>;
 
-            Submission();
+            Submission(uint32_t submitBatchSize = GAPI::MAX_SUBMIT_BATCH_SIZE);
             ~Submission();
 
-            void Start(const GAPI::Device::SharedPtr& device);
+            // Present thread takes blocking presents off submission thread, see Present.
+            void Start(const GAPI::Device::SharedPtr& device, bool enablePresentThread = false);
             void Terminate();
-            void Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList);
+            // Sync point fence would be signaled with sync point value once command lists are submitted.
+            void Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList, const GAPI::GpuSyncPoint& syncPoint);
+            void Submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::vector<std::shared_ptr<GAPI::CommandList>>& commandLists, const GAPI::GpuSyncPoint& syncPoint);
+            void Signal(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const GAPI::GpuSyncPoint& syncPoint);
+            void Wait(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const GAPI::GpuSyncPoint& syncPoint);
 
-            void ExecuteAsync(const CallbackFunction&& function);
-            void ExecuteAwait(const CallbackFunction&& function);
+            void ExecuteAsync(CallbackFunction&& function);
+            void ExecuteAwait(CallbackFunction&& function);
+            // Presents after command lists submitted before. With present thread enabled, submission thread hands swap chain
+            // over once they are submitted and runs ahead, so blocked present delays only the next present.
+            // Swap chain should have at least 3 back buffers then: the next frame is rendered before previous one is presented.
+            void Present(const std::shared_ptr<GAPI::SwapChain>& swapChain);
+            // Presents swap chains back to back as single task, e.g. viewports rendered within one frame.
+            void Present(const std::vector<std::shared_ptr<GAPI::SwapChain>>& swapChains);
+            // Blocks until swap chain handed to present thread is presented. Called on submission thread, e.g. before resize.
+            void WaitForPresent();
+
+            // Switch transient task storage to the frame. Storage should not be referenced by unprocessed tasks.
+            void ResetFrameAllocator(uint64_t frameIndex);
 
             inline std::weak_ptr<GAPI::IMultiThreadDevice> GetIMultiThreadDevice() { return device_; }
+            // Tasks put but not processed by submission thread yet. Submits coalesced into pending batch aren't counted.
+            inline uint32_t GetPendingTasksCount() const { return pendingTasksCount_.load(std::memory_order_relaxed); }
+#ifdef ENABLE_COMMAND_CAPTURE
+            // Sees every submitted command list, touched by submission thread except CommandCapture::Arm and IsActive.
+            inline CommandCapture& GetCommandCapture() { return *commandCapture_; }
+#endif
 
         private:
             template <typename T>
@@ -50,20 +86,55 @@ namespace RR
             template <typename T>
             inline void doTask(const T& task);
 
+            template <typename T>
+            T* allocateTransient(size_t count);
+
 #if ENABLE_SUBMISSION_THREAD
             void threadFunc();
+            void presentThreadFunc();
+            void flushSubmitBatch();
 #endif
         private:
             // Queue of 64 task should be enough.
             static constexpr size_t TaskBufferSize = 64;
-            using BufferedChannel = Threading::BufferedChannel<Task, TaskBufferSize>;
+            static constexpr size_t FrameAllocatorBaseSize = 16 * 1024;
+#if ENABLE_LOCKFREE_SUBMISSION_CHANNEL
+            using TaskChannel = Threading::MpscChannel<Task, TaskBufferSize>;
+#else
+            using TaskChannel = Threading::BufferedChannel<Task, TaskBufferSize>;
+#endif
 
             std::shared_ptr<GAPI::Device> device_;
+            uint32_t submitBatchSize_;
+#ifdef ENABLE_COMMAND_CAPTURE
+            std::unique_ptr<CommandCapture> commandCapture_;
+#endif
+#if ENABLE_SUBMISSION_THREAD
+            // Consecutive submits to the same queue coalesced into one call. Touched only by submission thread.
+            GAPI::CommandQueue* batchCommandQueue_ = nullptr;
+            std::vector<std::shared_ptr<GAPI::CommandList>> batchCommandLists_;
+            // Latest timeline value of coalesced submits, signaled right after batch.
+            GAPI::Fence* batchSignalFence_ = nullptr;
+            uint64_t batchSignalValue_ = 0;
+#endif
             //   std::unique_ptr<AccessGuard<GAPI::Device>> device_;
 #if ENABLE_SUBMISSION_THREAD
             Threading::Thread submissionThread_;
+            Threading::Thread presentThread_;
+            // Carries count of swap chains in presentBatch_, which is owned by present thread until presentIdle_ is set.
+            std::unique_ptr<Threading::BufferedChannel<uint32_t, 2>> presentChannel_;
+            std::vector<std::shared_ptr<GAPI::SwapChain>> presentBatch_;
+            // Set while present thread has nothing to present. Only one present is in flight.
+            Threading::Event presentIdle_ { true, true };
 #endif
-            std::unique_ptr<BufferedChannel> inputTaskChannel_;
+            std::unique_ptr<TaskChannel> inputTaskChannel_;
+            std::atomic<uint32_t> pendingTasksCount_ = 0;
+
+            // Per frame storage for task payloads. Buffered since producers run ahead of submission thread.
+            uint32_t frameAllocatorIndex_ = 0;
+            std::array<std::unique_ptr<GAPI::LinearAllocator>, GAPI::MAX_GPU_FRAMES_BUFFERED> frameAllocators_;
+            uint32_t frameAllocatorsCount_ = GAPI::MAX_GPU_FRAMES_BUFFERED;
+            Threading::SpinLock frameAllocatorSpinlock_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "TextureContainer.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include "gapi/MemoryAllocation.hpp"
+
+#include "common/OnScopeExit.hpp"
+#include "common/Stream.hpp"
+
+#include <cstring>
+
+namespace RR
+{
+    namespace Render
+    {
+        namespace
+        {
+            bool isFootprintEqual(const TextureContainer::Footprint& stored, const GAPI::CpuResourceData::SubresourceFootprint& footprint)
+            {
+                return stored.offset == footprint.offset &&
+                       stored.numRows == footprint.numRows &&
+                       stored.rowSizeInBytes == footprint.rowSizeInBytes &&
+                       stored.rowPitch == footprint.rowPitch &&
+                       stored.depthPitch == footprint.depthPitch;
+            }
+
+            bool makeDescription(const TextureContainer::Header& header, GAPI::GpuResourceBindFlags bindFlags, GAPI::GpuResourceDescription& description)
+            {
+                switch (header.dimension)
+                {
+                    case GAPI::GpuResourceDimension::Texture1D:
+                        description = GAPI::GpuResourceDescription::Texture1D(header.width, header.format, bindFlags, header.arraySize, header.mipLevels);
+                        return true;
+                    case GAPI::GpuResourceDimension::Texture2D:
+                        description = GAPI::GpuResourceDescription::Texture2D(header.width, header.height, header.format, bindFlags, header.arraySize, header.mipLevels);
+                        return true;
+                    case GAPI::GpuResourceDimension::Texture3D:
+                        description = GAPI::GpuResourceDescription::Texture3D(header.width, header.height, header.depth, header.format, bindFlags, header.mipLevels);
+                        return true;
+                    case GAPI::GpuResourceDimension::TextureCube:
+                        description = GAPI::GpuResourceDescription::TextureCube(header.width, header.height, header.format, bindFlags, header.arraySize, header.mipLevels);
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        bool TextureContainer::Write(Common::Stream& stream, const std::shared_ptr<GAPI::CpuResourceData>& textureData)
+        {
+            ASSERT(textureData);
+
+            const auto& description = textureData->GetResourceDescription();
+            ASSERT(description.GetDimension() != GAPI::GpuResourceDimension::Buffer);
+            ASSERT(description.GetDimension() != GAPI::GpuResourceDimension::Texture2DMS);
+            ASSERT(textureData->GetFirstSubresource() == 0);
+            ASSERT(textureData->GetNumSubresources() == description.GetNumSubresources());
+
+            const auto& allocation = textureData->GetAllocation();
+            ASSERT(allocation->GetMemoryType() != GAPI::MemoryAllocationType::Readback);
+
+            Header header = {};
+            header.magic = Magic;
+            header.version = Version;
+            header.dimension = description.GetDimension();
+            header.format = description.GetFormat();
+            header.width = description.GetWidth();
+            header.height = description.GetHeight();
+            header.depth = description.GetDepth();
+            header.arraySize = description.GetArraySize();
+            header.mipLevels = description.GetMipCount();
+            header.subresourcesCount = description.GetNumSubresources();
+            header.payloadSize = allocation->GetSize();
+
+            std::vector<Footprint> footprints;
+            footprints.reserve(header.subresourcesCount);
+            for (const auto& footprint : textureData->GetSubresourceFootprints())
+                footprints.push_back({ footprint.offset, footprint.width, footprint.height, footprint.depth, footprint.numRows,
+                                       footprint.rowSizeInBytes, footprint.rowPitch, footprint.depthPitch });
+
+            const auto data = static_cast<const char*>(allocation->Map());
+            ON_SCOPE_EXIT(allocation->Unmap());
+
+            const auto footprintsSize = static_cast<int64_t>(footprints.size() * sizeof(Footprint));
+            return stream.Write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header) &&
+                   stream.Write(reinterpret_cast<const char*>(footprints.data()), footprintsSize) == footprintsSize &&
+                   stream.Write(data, static_cast<int64_t>(header.payloadSize)) == static_cast<int64_t>(header.payloadSize);
+        }
+
+        std::shared_ptr<GAPI::CpuResourceData> TextureContainer::Read(const DeviceContext& deviceContext, Common::Stream& stream, GAPI::GpuResourceBindFlags bindFlags)
+        {
+            Header header;
+            if (stream.Read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header))
+                return nullptr;
+
+            if (header.magic != Magic || header.version != Version)
+                return nullptr;
+
+            GAPI::GpuResourceDescription description = GAPI::GpuResourceDescription::Buffer(1);
+            if (!makeDescription(header, bindFlags, description) || description.GetNumSubresources() != header.subresourcesCount)
+                return nullptr;
+
+            const auto footprintsSize = static_cast<int64_t>(header.subresourcesCount * sizeof(Footprint));
+            std::vector<Footprint> storedFootprints(header.subresourcesCount);
+            if (stream.Read(reinterpret_cast<char*>(storedFootprints.data()), footprintsSize) != footprintsSize)
+                return nullptr;
+
+            const auto textureData = deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Upload);
+            const auto& allocation = textureData->GetAllocation();
+            const auto& footprints = textureData->GetSubresourceFootprints();
+
+            bool isLayoutEqual = header.payloadSize <= allocation->GetSize();
+            for (uint32_t index = 0; index < header.subresourcesCount && isLayoutEqual; index++)
+                isLayoutEqual = isFootprintEqual(storedFootprints[index], footprints[index]);
+
+            const auto data = static_cast<char*>(allocation->Map());
+            ON_SCOPE_EXIT(allocation->Unmap());
+
+            const auto payloadSize = static_cast<int64_t>(header.payloadSize);
+
+            if (isLayoutEqual)
+                return stream.Read(data, payloadSize) == payloadSize ? textureData : nullptr;
+
+            // Baked on device with other alignment rules, repack rows.
+            std::vector<char> payload(header.payloadSize);
+            if (stream.Read(payload.data(), payloadSize) != payloadSize)
+                return nullptr;
+
+            for (uint32_t index = 0; index < header.subresourcesCount; index++)
+            {
+                const auto& source = storedFootprints[index];
+                const auto& dest = footprints[index];
+
+                if (source.numRows != dest.numRows || source.rowSizeInBytes != dest.rowSizeInBytes || source.depth != dest.depth)
+                    return nullptr;
+
+                for (uint32_t slice = 0; slice < source.depth; slice++)
+                    for (uint32_t row = 0; row < source.numRows; row++)
+                        std::memcpy(data + dest.offset + slice * dest.depthPitch + row * dest.rowPitch,
+                                    payload.data() + source.offset + slice * source.depthPitch + row * source.rowPitch,
+                                    source.rowSizeInBytes);
+            }
+
+            return textureData;
+        }
+    }
+}
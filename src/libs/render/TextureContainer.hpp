@@ -0,0 +1,61 @@
+#pragma once
+
+#include "gapi/GpuResource.hpp"
+
+namespace RR
+{
+    namespace Common
+    {
+        class Stream;
+    }
+
+    namespace Render
+    {
+        // Offline baked texture. Payload is stored in D3D12 copyable footprint layout (aligned row pitches,
+        // block rows for BC formats), so loading is a single read into upload memory without decode or repacking.
+        // Layout: Header | Footprint[subresourcesCount] | payload.
+        class TextureContainer final
+        {
+        public:
+            static constexpr uint32_t Magic = 0x58545252; // 'RRTX'
+            static constexpr uint32_t Version = 1;
+
+            struct Header final
+            {
+                uint32_t magic;
+                uint32_t version;
+                GAPI::GpuResourceDimension dimension;
+                GAPI::GpuResourceFormat format;
+                uint32_t width;
+                uint32_t height;
+                uint32_t depth;
+                uint32_t arraySize;
+                uint32_t mipLevels;
+                uint32_t subresourcesCount;
+                uint64_t payloadSize;
+            };
+
+            struct Footprint final
+            {
+                uint64_t offset;
+                uint32_t width;
+                uint32_t height;
+                uint32_t depth;
+                uint32_t numRows;
+                uint64_t rowSizeInBytes;
+                uint64_t rowPitch;
+                uint64_t depthPitch;
+            };
+
+        public:
+            // Data should cover all subresources. Memory of allocation is written as is.
+            static bool Write(Common::Stream& stream, const std::shared_ptr<GAPI::CpuResourceData>& textureData);
+
+            // Returns upload data ready for UploadStreamer, nullptr on malformed stream.
+            // Falls back to per-row copy if footprints of the device don't match baked ones.
+            static std::shared_ptr<GAPI::CpuResourceData> Read(const DeviceContext& deviceContext,
+                                                                Common::Stream& stream,
+                                                                GAPI::GpuResourceBindFlags bindFlags = GAPI::GpuResourceBindFlags::ShaderResource);
+        };
+    }
+}
@@ -0,0 +1,131 @@
+#include "UploadStreamer.hpp"
+
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResource.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Render
+    {
+        UploadStreamer::~UploadStreamer()
+        {
+            ASSERT(!inited_);
+        }
+
+        void UploadStreamer::Init(DeviceContext& deviceContext)
+        {
+            ASSERT(!inited_);
+
+            deviceContext_ = &deviceContext;
+            copyQueue_ = deviceContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "Upload streaming");
+
+            inited_ = true;
+        }
+
+        void UploadStreamer::Terminate()
+        {
+            ASSERT(inited_);
+
+            deviceContext_->WaitForGpu(copyQueue_);
+
+            copyQueue_ = nullptr;
+            deviceContext_ = nullptr;
+
+            inited_ = false;
+        }
+
+        GAPI::GpuSyncPoint UploadStreamer::submitChunk(const GAPI::GpuResource::SharedPtr& resource,
+                                                       const GAPI::CpuResourceData::SharedPtr& resourceData,
+                                                       uint32_t firstIndex, uint32_t numSubresources) const
+        {
+            auto chunkData = resourceData;
+
+            if (numSubresources != resourceData->GetNumSubresources())
+            {
+                chunkData = deviceContext_->AllocateIntermediateResourceData(resourceData->GetResourceDescription(), GAPI::MemoryAllocationType::Upload,
+                                                                             resourceData->GetFirstSubresource() + firstIndex, numSubresources);
+
+                const auto& sourceAllocation = resourceData->GetAllocation();
+                const auto sourceData = static_cast<const uint8_t*>(sourceAllocation->Map());
+
+                for (uint32_t index = 0; index < numSubresources; index++)
+                {
+                    const auto& footprint = resourceData->GetSubresourceFootprintAt(firstIndex + index);
+                    chunkData->WriteSubresource(index, sourceData + footprint.offset, footprint.rowPitch);
+                }
+
+                sourceAllocation->Unmap();
+            }
+
+            const auto& commandList = deviceContext_->AcquireCopyCommandList();
+            commandList->UpdateGpuResource(resource, chunkData);
+            commandList->Close();
+
+            return deviceContext_->Submit(copyQueue_, commandList);
+        }
+
+        GAPI::GpuSyncPoint UploadStreamer::Upload(const GAPI::GpuResource::SharedPtr& resource, const GAPI::CpuResourceData::SharedPtr& resourceData)
+        {
+            ASSERT(inited_);
+            ASSERT(resource);
+            ASSERT(resourceData);
+
+            const auto numSubresources = static_cast<uint32_t>(resourceData->GetNumSubresources());
+            uint32_t chunkBegin = 0;
+            size_t chunkSize = 0;
+            uint64_t totalSize = 0;
+
+            for (uint32_t index = 0; index < numSubresources; index++)
+            {
+                const auto& footprint = resourceData->GetSubresourceFootprintAt(index);
+                const auto subresourceSize = footprint.rowPitch * footprint.numRows * footprint.depth;
+
+                if (chunkSize > 0 && chunkSize + subresourceSize > MaxChunkSize)
+                {
+                    submitChunk(resource, resourceData, chunkBegin, index - chunkBegin);
+
+                    chunkBegin = index;
+                    chunkSize = 0;
+                }
+
+                chunkSize += subresourceSize;
+                totalSize += subresourceSize;
+            }
+
+            // Copy queue executes chunks in order, so the last sync point covers the whole upload.
+            const auto syncPoint = submitChunk(resource, resourceData, chunkBegin, numSubresources - chunkBegin);
+            deviceContext_->ReleaseQueueOwnership(resource, syncPoint);
+            uploadedBytes_.fetch_add(totalSize, std::memory_order_relaxed);
+
+            return syncPoint;
+        }
+
+        void UploadStreamer::UpdateTileMappings(std::vector<GAPI::TileMappingUpdate>&& updates)
+        {
+            ASSERT(inited_);
+
+            deviceContext_->UpdateTileMappings(copyQueue_, std::move(updates));
+        }
+
+        void UploadStreamer::WaitOnGpu(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::GpuSyncPoint& syncPoint) const
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+            ASSERT(commandQueue != copyQueue_);
+
+            deviceContext_->Wait(commandQueue, syncPoint);
+        }
+
+        void UploadStreamer::AcquireOnGpu(const GAPI::CommandQueue::SharedPtr& commandQueue, const GAPI::GpuResource::SharedPtr& resource) const
+        {
+            ASSERT(inited_);
+            ASSERT(commandQueue);
+            ASSERT(commandQueue != copyQueue_);
+
+            deviceContext_->AcquireQueueOwnership(commandQueue, resource);
+        }
+    }
+}
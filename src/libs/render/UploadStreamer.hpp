@@ -0,0 +1,53 @@
+#pragma once
+
+#include "gapi/Fence.hpp"
+#include "gapi/ForwardDeclarations.hpp"
+
+#include <atomic>
+
+namespace RR
+{
+    namespace Render
+    {
+        // Records resource uploads on dedicated copy queue, so graphics work isn't stalled by them.
+        // Consumer queue waits for returned sync point on GPU only when it actually uses the data.
+        // Uploaded resources are released from copy queue, so consumers could acquire them instead of tracking sync points.
+        class UploadStreamer final : private NonCopyable
+        {
+        public:
+            UploadStreamer() = default;
+            ~UploadStreamer();
+
+            void Init(DeviceContext& deviceContext);
+            void Terminate();
+
+            // Large textures are split into chunks of subresources. Every chunk is staged into upload ring range and submitted
+            // separately, so ring pages are reused as soon as their chunk is copied. Resource data is best kept in CPU memory then.
+            GAPI::GpuSyncPoint Upload(const std::shared_ptr<GAPI::GpuResource>& resource, const std::shared_ptr<GAPI::CpuResourceData>& resourceData);
+            // Mappings precede following uploads on copy queue, so mapped mips could be filled right away.
+            void UpdateTileMappings(std::vector<GAPI::TileMappingUpdate>&& updates);
+
+            // Make queue wait on GPU until uploads are done. CPU is never blocked.
+            void WaitOnGpu(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const GAPI::GpuSyncPoint& syncPoint) const;
+            // Waits only for the latest upload of the resource and only on its first use by the queue.
+            void AcquireOnGpu(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::GpuResource>& resource) const;
+
+            // Any thread. Resource data submitted for upload since Init, including row padding.
+            uint64_t GetUploadedBytes() const { return uploadedBytes_.load(std::memory_order_relaxed); }
+
+        private:
+            GAPI::GpuSyncPoint submitChunk(const std::shared_ptr<GAPI::GpuResource>& resource,
+                                           const std::shared_ptr<GAPI::CpuResourceData>& resourceData,
+                                           uint32_t firstIndex, uint32_t numSubresources) const;
+
+        private:
+            // Matches upload ring page size.
+            static constexpr size_t MaxChunkSize = 4 * 1024 * 1024;
+
+            bool inited_ = false;
+            DeviceContext* deviceContext_ = nullptr;
+            std::shared_ptr<GAPI::CommandQueue> copyQueue_;
+            std::atomic<uint64_t> uploadedBytes_ = 0;
+        };
+    }
+}
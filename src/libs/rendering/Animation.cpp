@@ -0,0 +1,145 @@
+#include "Animation.hpp"
+
+#include "common/FastMath.hpp"
+
+#include <cmath>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        void Pose::Resize(size_t jointsCount)
+        {
+            static constexpr float Identity[Component::Count] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+            const size_t paddedCount = (jointsCount + Width - 1) / Width * Width;
+
+            // Shrinking resets padding lanes, so they stay identity.
+            for (uint32_t component = 0; component < Component::Count; component++)
+            {
+                auto& values = _components[component];
+                values.resize(Min(values.size(), jointsCount));
+                values.resize(paddedCount, Identity[component]);
+            }
+
+            _jointsCount = jointsCount;
+        }
+
+        void Pose::SetJoint(size_t joint, const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+        {
+            ASSERT(joint < _jointsCount);
+
+            _components[PositionX][joint] = position.x;
+            _components[PositionY][joint] = position.y;
+            _components[PositionZ][joint] = position.z;
+            _components[RotationX][joint] = rotation.x;
+            _components[RotationY][joint] = rotation.y;
+            _components[RotationZ][joint] = rotation.z;
+            _components[RotationW][joint] = rotation.w;
+            _components[ScaleX][joint] = scale.x;
+            _components[ScaleY][joint] = scale.y;
+            _components[ScaleZ][joint] = scale.z;
+        }
+
+        Matrix4 Pose::GetLocalMatrix(size_t joint) const
+        {
+            ASSERT(joint < _jointsCount);
+
+            const Quaternion rotation(_components[RotationX][joint], _components[RotationY][joint], _components[RotationZ][joint], _components[RotationW][joint]);
+            const Vector3 position(_components[PositionX][joint], _components[PositionY][joint], _components[PositionZ][joint]);
+
+            Matrix4 matrix(rotation, position);
+            matrix.Scale(Vector3(_components[ScaleX][joint], _components[ScaleY][joint], _components[ScaleZ][joint]));
+            return matrix;
+        }
+
+        void BlendPoses(const Pose& from, const Pose& to, float weight, Pose& result)
+        {
+            ASSERT(from.GetJointsCount() == to.GetJointsCount());
+
+            if (&result != &from && &result != &to)
+                result.Resize(from.GetJointsCount());
+
+            const size_t paddedCount = (from.GetJointsCount() + Pose::Width - 1) / Pose::Width * Pose::Width;
+
+            const Simd::Float4 toWeight = Simd::Splat(weight);
+            const Simd::Float4 fromWeight = Simd::Splat(1.0f - weight);
+
+            const auto lerp = [&](Pose::Component component, size_t lane) {
+                const Simd::Float4 a = Simd::Load(from.GetComponent(component) + lane);
+                const Simd::Float4 b = Simd::Load(to.GetComponent(component) + lane);
+                Simd::Store(result.GetComponent(component) + lane, Simd::MulAdd(a, fromWeight, Simd::Mul(b, toWeight)));
+            };
+
+            for (size_t lane = 0; lane < paddedCount; lane += Pose::Width)
+            {
+                lerp(Pose::PositionX, lane);
+                lerp(Pose::PositionY, lane);
+                lerp(Pose::PositionZ, lane);
+                lerp(Pose::ScaleX, lane);
+                lerp(Pose::ScaleY, lane);
+                lerp(Pose::ScaleZ, lane);
+
+                Simd::Float4 a[4], b[4];
+                for (uint32_t component = 0; component < 4; component++)
+                {
+                    a[component] = Simd::Load(from.GetComponent(static_cast<Pose::Component>(Pose::RotationX + component)) + lane);
+                    b[component] = Simd::Load(to.GetComponent(static_cast<Pose::Component>(Pose::RotationX + component)) + lane);
+                }
+
+                // Target rotation is negated where it lies in opposite hemisphere, so blend takes shorter arc.
+                const Simd::Float4 dot = Simd::MulAdd(a[0], b[0], Simd::MulAdd(a[1], b[1], Simd::MulAdd(a[2], b[2], Simd::Mul(a[3], b[3]))));
+                const Simd::Float4 signedWeight = Simd::CopySign(toWeight, dot);
+
+                Simd::Float4 blended[4];
+                for (uint32_t component = 0; component < 4; component++)
+                    blended[component] = Simd::MulAdd(a[component], fromWeight, Simd::Mul(b[component], signedWeight));
+
+                const Simd::Float4 lengthSquared = Simd::MulAdd(blended[0], blended[0], Simd::MulAdd(blended[1], blended[1], Simd::MulAdd(blended[2], blended[2], Simd::Mul(blended[3], blended[3]))));
+                // Blended rotations are close to unit length, so approximate inverse length is enough to renormalize.
+                const Simd::Float4 invLength = FastMath::Rsqrt(lengthSquared);
+
+                for (uint32_t component = 0; component < 4; component++)
+                    Simd::Store(result.GetComponent(static_cast<Pose::Component>(Pose::RotationX + component)) + lane, Simd::Mul(blended[component], invLength));
+            }
+        }
+
+        void AnimationClip::Sample(float time, Pose& pose) const
+        {
+            ASSERT(!frames.empty());
+
+            const size_t framesCount = frames.size();
+            float position = Max(time, 0.0f) * frameRate;
+
+            if (isLooping)
+                position = fmodf(position, static_cast<float>(framesCount));
+            else
+                position = Min(position, static_cast<float>(framesCount - 1));
+
+            const size_t frame = Min(static_cast<size_t>(position), framesCount - 1);
+            const size_t nextFrame = isLooping ? (frame + 1) % framesCount : Min(frame + 1, framesCount - 1);
+
+            BlendPoses(frames[frame], frames[nextFrame], position - frame, pose);
+        }
+
+        void ComputeSkinningPalette(const Skeleton& skeleton, const Pose& pose, std::vector<Matrix4>& modelMatrices, std::vector<Matrix4>& palette)
+        {
+            const size_t jointsCount = skeleton.GetJointsCount();
+            ASSERT(jointsCount <= Skeleton::MaxJoints);
+            ASSERT(pose.GetJointsCount() == jointsCount && skeleton.inverseBindMatrices.size() == jointsCount);
+
+            modelMatrices.resize(jointsCount);
+            palette.resize(jointsCount);
+
+            for (size_t joint = 0; joint < jointsCount; joint++)
+            {
+                const int32_t parent = skeleton.parents[joint];
+                ASSERT(parent < static_cast<int32_t>(joint));
+
+                const Matrix4 local = pose.GetLocalMatrix(joint);
+                modelMatrices[joint] = parent < 0 ? local : modelMatrices[parent] * local;
+                palette[joint] = modelMatrices[joint] * skeleton.inverseBindMatrices[joint];
+            }
+        }
+    }
+}
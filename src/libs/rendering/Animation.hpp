@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include <array>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        // Parents always precede children, so model space transforms are resolved in a single forward pass.
+        struct Skeleton
+        {
+            static constexpr uint32_t MaxJoints = 128;
+
+            inline size_t GetJointsCount() const { return parents.size(); }
+
+            // Negative for root joints.
+            std::vector<int32_t> parents;
+            // Model space to joint space in bind pose.
+            std::vector<Matrix4> inverseBindMatrices;
+        };
+
+        // Local joint transforms in structure of arrays layout, so poses are blended four joints at once.
+        class Pose final
+        {
+        public:
+            static constexpr size_t Width = 4;
+
+            enum Component : uint32_t
+            {
+                PositionX,
+                PositionY,
+                PositionZ,
+                RotationX,
+                RotationY,
+                RotationZ,
+                RotationW,
+                ScaleX,
+                ScaleY,
+                ScaleZ,
+                Count
+            };
+
+        public:
+            // New joints are identity.
+            void Resize(size_t jointsCount);
+            inline size_t GetJointsCount() const { return _jointsCount; }
+
+            void SetJoint(size_t joint, const Vector3& position, const Quaternion& rotation, const Vector3& scale = Vector3(1.0f));
+            // Local matrix of joint, rotation is expected normalized.
+            Matrix4 GetLocalMatrix(size_t joint) const;
+
+            // Padded to multiple of Width with identity joints.
+            inline float* GetComponent(Component component) { return _components[component].data(); }
+            inline const float* GetComponent(Component component) const { return _components[component].data(); }
+
+        private:
+            size_t _jointsCount = 0;
+            std::array<std::vector<float>, Component::Count> _components;
+        };
+
+        // Linear blend of translation and scale, normalized lerp of rotation along shorter arc. Result can alias either source.
+        void BlendPoses(const Pose& from, const Pose& to, float weight, Pose& result);
+
+        // Key poses sampled at fixed rate.
+        struct AnimationClip
+        {
+            float frameRate = 30.0f;
+            bool isLooping = true;
+            std::vector<Pose> frames;
+
+            inline float GetDuration() const { return frames.empty() ? 0.0f : (frames.size() - (isLooping ? 0 : 1)) / frameRate; }
+
+            // Interpolates neighbouring key poses, looping clips wrap around to first one.
+            void Sample(float time, Pose& pose) const;
+        };
+
+        // Model space joint matrices multiplied by inverse bind matrices, ready for skinning.
+        void ComputeSkinningPalette(const Skeleton& skeleton, const Pose& pose, std::vector<Matrix4>& modelMatrices, std::vector<Matrix4>& palette);
+    }
+}
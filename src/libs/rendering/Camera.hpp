@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Culling.hpp"
 #include "Transform.hpp"
 
 namespace OpenDemo
@@ -88,18 +89,62 @@ namespace OpenDemo
                 calcProjectionMatrix();
             }
 
+            inline bool IsOrtho() const { return _isOrtho; }
+            inline float GetAspect() const { return _aspect; }
+            inline float GetFov() const { return _fov; }
+            inline float GetOrthoSize() const { return _orthoSize; }
+            inline float GetZNear() const { return _zNear; }
+            inline float GetZFar() const { return _zFar; }
+
+            // Sub-pixel offset of projection in NDC units, used by temporal upscaling. Culling uses unjittered projection.
+            inline void SetJitter(const Vector2& value)
+            {
+                if (_jitter == value)
+                {
+                    return;
+                }
+
+                _jitter = value;
+                calcProjectionMatrix();
+            }
+
+            // Offset of frame in Halton(2, 3) sequence of given length, in pixels within [-0.5, 0.5).
+            static constexpr Vector2 GetHaltonJitter(uint32_t frameIndex, uint32_t sequenceLength = 8)
+            {
+                const auto halton = [](uint32_t index, uint32_t base) {
+                    float result = 0.0f;
+                    float fraction = 1.0f / base;
+
+                    for (; index > 0; index /= base, fraction /= base)
+                        result += fraction * (index % base);
+
+                    return result;
+                };
+
+                // Sequence starts from one, zero index is origin in both bases.
+                const uint32_t index = frameIndex % sequenceLength + 1;
+                return Vector2(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+            }
+
             inline void SetTransform(const Transform& value) { _transform = value; }
             inline Transform GetTransform() const { return _transform; }
 
             inline Matrix4 GetViewMatrix() const { return _transform.GetMatrix(); }
             inline Matrix4 GetViewProjectionMatrix() const
             {
-                ASSERT(false)
-                return GetProjectionMatrix();
-                // *GetViewMatrix().inverseOrtho();
+                return GetProjectionMatrix() * GetViewMatrix().InverseOrtho();
             }
 
+            inline Matrix4 GetUnjitteredViewProjectionMatrix() const
+            {
+                return GetUnjitteredProjectionMatrix() * GetViewMatrix().InverseOrtho();
+            }
+
+            inline Frustum GetFrustum() const { return Frustum::FromViewProjection(GetUnjitteredViewProjectionMatrix()); }
+
             inline Matrix4 GetProjectionMatrix() const { return _projectionMatrix; }
+            inline Matrix4 GetUnjitteredProjectionMatrix() const { return _unjitteredProjectionMatrix; }
+            inline Vector2 GetJitter() const { return _jitter; }
 
             inline void LookAt(Vector3 eyePosition, Vector3 targetPosition)
             {
@@ -118,23 +163,33 @@ namespace OpenDemo
             float _zNear;
             float _zFar;
 
+            Vector2 _jitter = Vector2(0.0f);
+
             Transform _transform;
             Matrix4 _projectionMatrix;
+            Matrix4 _unjitteredProjectionMatrix;
 
-            inline void calcProjectionMatrix() {
-                ASSERT(false)
-                /*
-                    if (_isOrtho)
+            inline void calcProjectionMatrix()
+            {
+                if (_isOrtho)
                 {
                     const float width = _orthoSize * _aspect;
                     const float height = _orthoSize;
 
-                    _projectionMatrix = Matrix4(mat4::PROJ_ZERO_POS, -width * 0.5f, width * 0.5f, -height * 0.5f, height * 0.5f, _zNear, _zFar);
+                    _projectionMatrix = Matrix4(Matrix4::PROJ_ZERO_POS, -width * 0.5f, width * 0.5f, -height * 0.5f, height * 0.5f, _zNear, _zFar);
                 }
                 else
                 {
-                    _projectionMatrix = Matrix4(mat4::PROJ_ZERO_POS, _fov, _aspect, _zNear, _zFar);
-                }*/
+                    _projectionMatrix = Matrix4(Matrix4::PROJ_ZERO_POS, Radian(_fov), _aspect, _zNear, _zFar);
+                }
+
+                _unjitteredProjectionMatrix = _projectionMatrix;
+
+                // Translates clip space by jitter times w, so image shifts by same NDC offset at any depth.
+                _projectionMatrix.e03 += _jitter.x * _projectionMatrix.e33;
+                _projectionMatrix.e13 += _jitter.y * _projectionMatrix.e33;
+                _projectionMatrix.e02 += _jitter.x * _projectionMatrix.e32;
+                _projectionMatrix.e12 += _jitter.y * _projectionMatrix.e32;
             };
         };
     }
@@ -0,0 +1,194 @@
+#include "Culling.hpp"
+
+#include "common/threading/Parallel.hpp"
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            constexpr size_t SimdWidth = 4;
+            // Job overhead isn't worth it below that.
+            constexpr size_t MinGroupsPerBatch = 1024;
+
+            Vector4 normalizePlane(const Vector4& plane)
+            {
+                const float invLength = 1.0f / sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+                return plane * invLength;
+            }
+        }
+
+        void BoundingSpheres::Reserve(size_t capacity)
+        {
+            detach();
+            capacity = (capacity + SimdWidth - 1) / SimdWidth * SimdWidth;
+
+            _centerX.reserve(capacity);
+            _centerY.reserve(capacity);
+            _centerZ.reserve(capacity);
+            _radius.reserve(capacity);
+        }
+
+        void BoundingSpheres::Clear()
+        {
+            _size = 0;
+            _isAttached = false;
+
+            _centerX.clear();
+            _centerY.clear();
+            _centerZ.clear();
+            _radius.clear();
+        }
+
+        size_t BoundingSpheres::Add(const Vector3& center, float radius)
+        {
+            detach();
+
+            // Padding spheres have negative infinite radius and never pass the test.
+            if (_size % SimdWidth == 0)
+            {
+                _centerX.resize(_size + SimdWidth, 0.0f);
+                _centerY.resize(_size + SimdWidth, 0.0f);
+                _centerZ.resize(_size + SimdWidth, 0.0f);
+                _radius.resize(_size + SimdWidth, -INF);
+            }
+
+            _centerX[_size] = center.x;
+            _centerY[_size] = center.y;
+            _centerZ[_size] = center.z;
+            _radius[_size] = radius;
+
+            return _size++;
+        }
+
+        void BoundingSpheres::Set(size_t index, const Vector3& center, float radius)
+        {
+            ASSERT(index < _size);
+            detach();
+
+            _centerX[index] = center.x;
+            _centerY[index] = center.y;
+            _centerZ[index] = center.z;
+            _radius[index] = radius;
+        }
+
+        void BoundingSpheres::Attach(const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t size)
+        {
+            ASSERT((centerX && centerY && centerZ && radius) || size == 0);
+
+            _centerX.clear();
+            _centerY.clear();
+            _centerZ.clear();
+            _radius.clear();
+
+            _attachedCenterX = centerX;
+            _attachedCenterY = centerY;
+            _attachedCenterZ = centerZ;
+            _attachedRadius = radius;
+            _size = size;
+            _isAttached = true;
+        }
+
+        void BoundingSpheres::detach()
+        {
+            if (!_isAttached)
+                return;
+
+            const size_t paddedSize = (_size + SimdWidth - 1) / SimdWidth * SimdWidth;
+            _centerX.assign(_attachedCenterX, _attachedCenterX + paddedSize);
+            _centerY.assign(_attachedCenterY, _attachedCenterY + paddedSize);
+            _centerZ.assign(_attachedCenterZ, _attachedCenterZ + paddedSize);
+            _radius.assign(_attachedRadius, _attachedRadius + paddedSize);
+
+            _isAttached = false;
+        }
+
+        Frustum Frustum::FromViewProjection(const Matrix4& m)
+        {
+            const Vector4 row0(m.e00, m.e01, m.e02, m.e03);
+            const Vector4 row1(m.e10, m.e11, m.e12, m.e13);
+            const Vector4 row2(m.e20, m.e21, m.e22, m.e23);
+            const Vector4 row3(m.e30, m.e31, m.e32, m.e33);
+
+            Frustum frustum;
+            frustum.planes[PLANE_LEFT] = normalizePlane(row3 + row0);
+            frustum.planes[PLANE_RIGHT] = normalizePlane(row3 - row0);
+            frustum.planes[PLANE_BOTTOM] = normalizePlane(row3 + row1);
+            frustum.planes[PLANE_TOP] = normalizePlane(row3 - row1);
+            // Depth range is [0, 1].
+            frustum.planes[PLANE_NEAR] = normalizePlane(row2);
+            frustum.planes[PLANE_FAR] = normalizePlane(row3 - row2);
+
+            return frustum;
+        }
+
+        bool Frustum::IsVisible(const Vector3& center, float radius) const
+        {
+            for (const auto& plane : planes)
+                if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+                    return false;
+
+            return true;
+        }
+
+        void CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, std::vector<uint32_t>& visible)
+        {
+            visible.clear();
+
+            const size_t groupsCount = (spheres.GetSize() + SimdWidth - 1) / SimdWidth;
+            if (groupsCount == 0)
+                return;
+
+            Simd::Float4 planes[Frustum::PLANE_COUNT][4];
+            for (uint32_t index = 0; index < Frustum::PLANE_COUNT; index++)
+            {
+                planes[index][0] = Simd::Splat(frustum.planes[index].x);
+                planes[index][1] = Simd::Splat(frustum.planes[index].y);
+                planes[index][2] = Simd::Splat(frustum.planes[index].z);
+                planes[index][3] = Simd::Splat(frustum.planes[index].w);
+            }
+
+            const auto cullRange = [&](size_t firstGroup, size_t lastGroup, std::vector<uint32_t>& result) {
+                for (size_t group = firstGroup; group < lastGroup; group++)
+                {
+                    const size_t first = group * SimdWidth;
+                    const auto x = Simd::Load(spheres.GetCenterX() + first);
+                    const auto y = Simd::Load(spheres.GetCenterY() + first);
+                    const auto z = Simd::Load(spheres.GetCenterZ() + first);
+                    const auto radius = Simd::Load(spheres.GetRadius() + first);
+
+                    // Smallest signed distance to any plane, offset by radius.
+                    auto distance = Simd::Splat(INF);
+                    for (const auto& plane : planes)
+                    {
+                        auto planeDistance = Simd::MulAdd(plane[0], x, plane[3]);
+                        planeDistance = Simd::MulAdd(plane[1], y, planeDistance);
+                        planeDistance = Simd::MulAdd(plane[2], z, planeDistance);
+                        distance = Simd::Min(distance, Simd::Add(planeDistance, radius));
+                    }
+
+                    alignas(16) float distances[SimdWidth];
+                    Simd::StoreAligned(distances, distance);
+
+                    for (size_t lane = 0; lane < SimdWidth; lane++)
+                        if (distances[lane] >= 0.0f)
+                            result.push_back(static_cast<uint32_t>(first + lane));
+                }
+            };
+
+            // Batches are concatenated in ascending order, so output stays ordered.
+            visible = Threading::ParallelReduce(
+                0, groupsCount, MinGroupsPerBatch, std::move(visible),
+                [&cullRange](size_t firstGroup, size_t lastGroup) {
+                    std::vector<uint32_t> result;
+                    cullRange(firstGroup, lastGroup, result);
+                    return result;
+                },
+                [](std::vector<uint32_t>&& accumulated, std::vector<uint32_t>&& batch) {
+                    accumulated.insert(accumulated.end(), batch.begin(), batch.end());
+                    return std::move(accumulated);
+                });
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        // World space bounding spheres in structure of arrays layout, padded to multiple of four.
+        class BoundingSpheres final
+        {
+        public:
+            void Reserve(size_t capacity);
+            void Clear();
+
+            // Returns index of added sphere.
+            size_t Add(const Vector3& center, float radius);
+            void Set(size_t index, const Vector3& center, float radius);
+
+            // Uses external arrays in place, same contract as TransformBatch::Attach.
+            // Padding spheres should have negative infinite radius.
+            void Attach(const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t size);
+            inline bool IsAttached() const { return _isAttached; }
+
+            inline size_t GetSize() const { return _size; }
+
+            inline const float* GetCenterX() const { return _isAttached ? _attachedCenterX : _centerX.data(); }
+            inline const float* GetCenterY() const { return _isAttached ? _attachedCenterY : _centerY.data(); }
+            inline const float* GetCenterZ() const { return _isAttached ? _attachedCenterZ : _centerZ.data(); }
+            inline const float* GetRadius() const { return _isAttached ? _attachedRadius : _radius.data(); }
+
+        private:
+            void detach();
+
+        private:
+            size_t _size = 0;
+            std::vector<float> _centerX;
+            std::vector<float> _centerY;
+            std::vector<float> _centerZ;
+            std::vector<float> _radius;
+            const float* _attachedCenterX = nullptr;
+            const float* _attachedCenterY = nullptr;
+            const float* _attachedCenterZ = nullptr;
+            const float* _attachedRadius = nullptr;
+            bool _isAttached = false;
+        };
+
+        struct Frustum final
+        {
+            enum Plane : uint32_t
+            {
+                PLANE_LEFT,
+                PLANE_RIGHT,
+                PLANE_BOTTOM,
+                PLANE_TOP,
+                PLANE_NEAR,
+                PLANE_FAR,
+                PLANE_COUNT
+            };
+
+            // Extracts normalized planes pointing inside from PROJ_ZERO_POS view projection matrix.
+            static Frustum FromViewProjection(const Matrix4& viewProjection);
+
+            bool IsVisible(const Vector3& center, float radius) const;
+
+            Vector4 planes[PLANE_COUNT];
+        };
+
+        // Writes indices of spheres intersecting frustum in ascending order.
+        // Large sets are split across job system workers, small ones are culled on calling thread.
+        void CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, std::vector<uint32_t>& visible);
+    }
+}
@@ -0,0 +1,72 @@
+#include "DynamicResolution.hpp"
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        namespace
+        {
+            // Largest scale change per adjustment, avoids visible resolution pops.
+            constexpr float MaxScaleStep = 0.1f;
+        }
+
+        DynamicResolution::DynamicResolution(const Description& description)
+        {
+            SetDescription(description);
+        }
+
+        void DynamicResolution::SetDescription(const Description& description)
+        {
+            ASSERT(description.frameTimeBudget > 0.0f);
+            ASSERT(description.minScale > 0.0f && description.minScale <= description.maxScale);
+            ASSERT(description.smoothing > 0.0f && description.smoothing <= 1.0f);
+
+            _description = description;
+            Reset();
+        }
+
+        void DynamicResolution::Reset()
+        {
+            _scale = _description.maxScale;
+            _frameTime = 0.0f;
+            _framesSinceChange = 0;
+        }
+
+        void DynamicResolution::Update(float gpuFrameTime)
+        {
+            if (gpuFrameTime < 0.0f)
+                return;
+
+            _frameTime = (_frameTime == 0.0f) ? gpuFrameTime : _frameTime + (gpuFrameTime - _frameTime) * _description.smoothing;
+
+            if (++_framesSinceChange < _description.cooldownFrames)
+                return;
+
+            const float budget = _description.frameTimeBudget;
+            const bool overBudget = _frameTime > budget;
+            const bool underHeadroom = _frameTime < budget * _description.headroom;
+
+            if (!overBudget && !underHeadroom)
+                return;
+
+            // GPU time is proportional to pixel count, so pick scale that would hit target time.
+            const float targetTime = overBudget ? budget : budget * _description.headroom;
+            const float desiredScale = _scale * sqrtf(targetTime / Max(_frameTime, 0.001f));
+
+            const float step = Clamp(desiredScale - _scale, -MaxScaleStep, MaxScaleStep);
+            const float scale = Clamp(_scale + step, _description.minScale, _description.maxScale);
+
+            if (scale == _scale)
+                return;
+
+            _scale = scale;
+            _framesSinceChange = 0;
+            // Measurements taken at old scale are no longer representative.
+            _frameTime = 0.0f;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        // Picks render scale from measured GPU frame time, so GPU bound frames trade resolution instead of being dropped.
+        class DynamicResolution final
+        {
+        public:
+            struct Description
+            {
+                float frameTimeBudget = 1000.0f / 60.0f;
+                float minScale = 0.5f;
+                float maxScale = 1.0f;
+                // Scale is only raised while frame time stays below this fraction of budget.
+                float headroom = 0.85f;
+                // Exponential smoothing factor of measured frame time.
+                float smoothing = 0.1f;
+                // Scale can't be changed more often than that to let measurements catch up with latency.
+                uint32_t cooldownFrames = 4;
+            };
+
+        public:
+            DynamicResolution() = default;
+            DynamicResolution(const Description& description);
+
+            void SetDescription(const Description& description);
+            inline const Description& GetDescription() const { return _description; }
+
+            // Negative frame time means there is no new measurement yet.
+            void Update(float gpuFrameTime);
+            void Reset();
+
+            inline float GetScale() const { return _scale; }
+            inline float GetFrameTime() const { return _frameTime; }
+
+        private:
+            Description _description;
+            float _scale = 1.0f;
+            float _frameTime = 0.0f;
+            uint32_t _framesSinceChange = 0;
+        };
+    }
+}
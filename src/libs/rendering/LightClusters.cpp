@@ -0,0 +1,179 @@
+#include "LightClusters.hpp"
+
+#include "common/threading/Parallel.hpp"
+
+#include "rendering/Camera.hpp"
+
+#include <cstring>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            constexpr size_t MinLightsPerBatch = 64;
+
+            // Maps normalized device coordinate to tile, clamped to grid.
+            uint8_t ndcToTile(float ndc, uint32_t tilesCount)
+            {
+                const float tile = floorf((ndc * 0.5f + 0.5f) * tilesCount);
+                return static_cast<uint8_t>(Clamp(tile, 0.0f, static_cast<float>(tilesCount - 1)));
+            }
+        }
+
+        uint32_t LightClusters::depthToSlice(float depth) const
+        {
+            const float slice = floorf(logf(Max(depth, _zNear)) * _sliceScale + _sliceBias);
+            return static_cast<uint32_t>(Clamp(slice, 0.0f, static_cast<float>(Slices - 1)));
+        }
+
+        LightClusters::LightBounds LightClusters::computeBounds(const Camera& camera, const Matrix4& view, const PointLight& light) const
+        {
+            // Camera looks along negative z.
+            const Vector3 position = view * light.position;
+            const float depth = -position.z;
+            const float radius = light.radius;
+
+            const LightBounds emptyBounds = { 1, 0, 1, 0, 1, 0 };
+
+            const float minDepth = Max(depth - radius, _zNear);
+            const float maxDepth = Min(depth + radius, _zFar);
+
+            if (minDepth > maxDepth)
+                return emptyBounds;
+
+            const Matrix4 projection = camera.GetProjectionMatrix();
+
+            // Conservative extents of sphere bounding box, positive edge is widest at nearest depth and negative at farthest.
+            const auto project = [&](float minEdge, float maxEdge, float scale, float offset, Vector2& range) {
+                if (camera.IsOrtho())
+                {
+                    range = Vector2(minEdge * scale + offset, maxEdge * scale + offset);
+                    return;
+                }
+
+                range.x = scale * minEdge / (minEdge < 0.0f ? minDepth : maxDepth);
+                range.y = scale * maxEdge / (maxEdge > 0.0f ? minDepth : maxDepth);
+            };
+
+            Vector2 rangeX, rangeY;
+            project(position.x - radius, position.x + radius, projection.e00, projection.e03, rangeX);
+            project(position.y - radius, position.y + radius, projection.e11, projection.e13, rangeY);
+
+            if (rangeX.x > 1.0f || rangeX.y < -1.0f || rangeY.x > 1.0f || rangeY.y < -1.0f)
+                return emptyBounds;
+
+            LightBounds bounds;
+            bounds.minX = ndcToTile(rangeX.x, TilesX);
+            bounds.maxX = ndcToTile(rangeX.y, TilesX);
+            bounds.minY = ndcToTile(rangeY.x, TilesY);
+            bounds.maxY = ndcToTile(rangeY.y, TilesY);
+            bounds.minSlice = static_cast<uint8_t>(depthToSlice(minDepth));
+            bounds.maxSlice = static_cast<uint8_t>(depthToSlice(maxDepth));
+            return bounds;
+        }
+
+        void LightClusters::Build(const Camera& camera, const std::vector<PointLight>& lights)
+        {
+            _revision++;
+            _lightsCount = static_cast<uint32_t>(Min<size_t>(lights.size(), MaxLights));
+
+            _zNear = camera.GetZNear();
+            _zFar = camera.GetZFar();
+            ASSERT(_zNear > 0.0f && _zFar > _zNear);
+
+            const float logDepthRange = logf(_zFar / _zNear);
+            _sliceScale = Slices / logDepthRange;
+            _sliceBias = -(Slices * logf(_zNear)) / logDepthRange;
+
+            const Matrix4 view = camera.GetViewMatrix().InverseOrtho();
+
+            _bounds.resize(_lightsCount);
+            _lightData.resize(_lightsCount * 2);
+            _clusterData.resize(ClustersCount * 2);
+
+            Threading::ParallelFor(0, _lightsCount, MinLightsPerBatch, [&](size_t first, size_t last) {
+                for (size_t index = first; index < last; index++)
+                {
+                    const auto& light = lights[index];
+                    _bounds[index] = computeBounds(camera, view, light);
+                    _lightData[index * 2] = Vector4(light.position, light.radius);
+                    _lightData[index * 2 + 1] = Vector4(light.color, 0.0f);
+                }
+            });
+
+            // Each slice owns its clusters and index list, so slices are filled without synchronization.
+            Threading::ParallelFor(0, Slices, 1, [&](size_t firstSlice, size_t lastSlice) {
+                for (size_t slice = firstSlice; slice < lastSlice; slice++)
+                {
+                    uint32_t* sliceClusters = _clusterData.data() + slice * TilesX * TilesY * 2;
+                    auto& sliceIndices = _sliceIndices[slice];
+
+                    for (uint32_t cluster = 0; cluster < TilesX * TilesY; cluster++)
+                        sliceClusters[cluster * 2 + 1] = 0;
+
+                    const auto overlaps = [slice](const LightBounds& bounds) {
+                        return slice >= bounds.minSlice && slice <= bounds.maxSlice;
+                    };
+
+                    for (uint32_t light = 0; light < _lightsCount; light++)
+                    {
+                        const auto& bounds = _bounds[light];
+                        if (!overlaps(bounds))
+                            continue;
+
+                        for (uint32_t y = bounds.minY; y <= bounds.maxY; y++)
+                            for (uint32_t x = bounds.minX; x <= bounds.maxX; x++)
+                                sliceClusters[(y * TilesX + x) * 2 + 1]++;
+                    }
+
+                    uint32_t offset = 0;
+                    for (uint32_t cluster = 0; cluster < TilesX * TilesY; cluster++)
+                    {
+                        sliceClusters[cluster * 2] = offset;
+                        offset += sliceClusters[cluster * 2 + 1];
+                        // Count is rebuilt as write cursor below.
+                        sliceClusters[cluster * 2 + 1] = 0;
+                    }
+
+                    sliceIndices.resize(offset);
+
+                    for (uint32_t light = 0; light < _lightsCount; light++)
+                    {
+                        const auto& bounds = _bounds[light];
+                        if (!overlaps(bounds))
+                            continue;
+
+                        for (uint32_t y = bounds.minY; y <= bounds.maxY; y++)
+                            for (uint32_t x = bounds.minX; x <= bounds.maxX; x++)
+                            {
+                                uint32_t* cluster = sliceClusters + (y * TilesX + x) * 2;
+                                sliceIndices[cluster[0] + cluster[1]++] = light;
+                            }
+                    }
+                }
+            });
+
+            size_t indicesCount = 0;
+            for (const auto& sliceIndices : _sliceIndices)
+                indicesCount += sliceIndices.size();
+
+            _lightIndices.resize(indicesCount);
+
+            uint32_t sliceOffset = 0;
+            for (uint32_t slice = 0; slice < Slices; slice++)
+            {
+                const auto& sliceIndices = _sliceIndices[slice];
+                if (!sliceIndices.empty())
+                    std::memcpy(_lightIndices.data() + sliceOffset, sliceIndices.data(), sliceIndices.size() * sizeof(uint32_t));
+
+                uint32_t* sliceClusters = _clusterData.data() + slice * TilesX * TilesY * 2;
+                for (uint32_t cluster = 0; cluster < TilesX * TilesY; cluster++)
+                    sliceClusters[cluster * 2] += sliceOffset;
+
+                sliceOffset += static_cast<uint32_t>(sliceIndices.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include <array>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Camera;
+
+        struct PointLight
+        {
+            Vector3 position;
+            // Light has no influence beyond radius.
+            float radius;
+            // Linear color premultiplied by intensity.
+            Vector3 color;
+        };
+
+        // Point lights assigned to froxel grid over camera frustum. Tiles split viewport uniformly and depth slices are
+        // exponential, so fragment shades only lights overlapping its cluster instead of all lights in scene.
+        class LightClusters final
+        {
+        public:
+            static constexpr uint32_t TilesX = 16;
+            static constexpr uint32_t TilesY = 8;
+            static constexpr uint32_t Slices = 24;
+            static constexpr uint32_t ClustersCount = TilesX * TilesY * Slices;
+            // Lights beyond that are dropped.
+            static constexpr uint32_t MaxLights = 1024;
+
+        public:
+            // Camera projection should already match viewport aspect. Slices are assigned in parallel on job system.
+            void Build(const Camera& camera, const std::vector<PointLight>& lights);
+
+            inline uint32_t GetLightsCount() const { return _lightsCount; }
+            // Two texels per light: world space position with radius, then color.
+            inline const std::vector<Vector4>& GetLightData() const { return _lightData; }
+            // Offset into light indices and lights count for each cluster, cluster index is (slice * TilesY + y) * TilesX + x.
+            inline const std::vector<uint32_t>& GetClusterData() const { return _clusterData; }
+            inline const std::vector<uint32_t>& GetLightIndices() const { return _lightIndices; }
+
+            // Slice of view depth is log(depth) * sliceScale + sliceBias.
+            inline float GetSliceScale() const { return _sliceScale; }
+            inline float GetSliceBias() const { return _sliceBias; }
+
+            // Changes on every build, so backend uploads lists once no matter how many passes use them.
+            inline uint32_t GetRevision() const { return _revision; }
+
+        private:
+            // Inclusive cluster ranges covered by light, empty when minSlice > maxSlice.
+            struct LightBounds
+            {
+                uint8_t minX, maxX;
+                uint8_t minY, maxY;
+                uint8_t minSlice, maxSlice;
+            };
+
+            LightBounds computeBounds(const Camera& camera, const Matrix4& view, const PointLight& light) const;
+            uint32_t depthToSlice(float depth) const;
+
+        private:
+            uint32_t _lightsCount = 0;
+            uint32_t _revision = 0;
+            float _sliceScale = 0.0f;
+            float _sliceBias = 0.0f;
+            float _zNear = 0.0f;
+            float _zFar = 0.0f;
+
+            std::vector<LightBounds> _bounds;
+            std::vector<Vector4> _lightData;
+            std::vector<uint32_t> _clusterData;
+            std::vector<uint32_t> _lightIndices;
+            // Light lists of each slice, concatenated into _lightIndices after parallel build.
+            std::array<std::vector<uint32_t>, Slices> _sliceIndices;
+        };
+    }
+}
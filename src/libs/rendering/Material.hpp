@@ -12,6 +12,12 @@ namespace OpenDemo
             std::shared_ptr<Rendering::CommonTexture> normalMap;
             std::shared_ptr<Rendering::CommonTexture> metallicMap;
             std::shared_ptr<Rendering::CommonTexture> roughnessMap;
+
+            // Layers of maps which are texture arrays, passed to shaders per instance. Zero for plain 2D textures.
+            uint32_t albedoLayer = 0;
+            uint32_t normalLayer = 0;
+            uint32_t metallicLayer = 0;
+            uint32_t roughnessLayer = 0;
         };
     }
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "common/Math.hpp"
 
+#include "rendering/Meshlets.hpp"
+#include "rendering/VertexFormat.hpp"
+
 namespace OpenDemo
 {
     namespace Rendering
@@ -28,9 +31,25 @@ namespace OpenDemo
 
             virtual void Init(const std::vector<Vertex>& vertices) = 0;
             virtual void Init(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes) = 0;
+            // Vertices produced by EncodeVertices, index buffer can be empty.
+            virtual void Init(const EncodedVertices& vertices, const std::vector<int32_t>& indexes) = 0;
 
             virtual void Bind() const = 0;
             virtual void Draw() const = 0; //TODO: remove
+
+            inline VertexFormat GetVertexFormat() const { return _vertexFormat; }
+            inline bool HasQuantizedPositions() const { return _vertexFormat == VERTEX_FORMAT_COMPACT_QUANTIZED; }
+            // Should be applied before model matrix when positions are quantized.
+            inline const Matrix4& GetPositionDequantization() const { return _positionDequantization; }
+
+            // Meshes with meshlets are culled and drawn per meshlet, meshlets should cover uploaded index data.
+            inline void SetMeshlets(std::vector<Meshlet>&& meshlets) { _meshlets = std::move(meshlets); }
+            inline const std::vector<Meshlet>& GetMeshlets() const { return _meshlets; }
+
+        protected:
+            VertexFormat _vertexFormat = VERTEX_FORMAT_FULL;
+            Matrix4 _positionDequantization = Matrix4(Common::Identity);
+            std::vector<Meshlet> _meshlets;
         };
     }
 }
\ No newline at end of file
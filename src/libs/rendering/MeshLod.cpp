@@ -0,0 +1,139 @@
+#include "MeshLod.hpp"
+
+#include "rendering/Camera.hpp"
+#include "rendering/Mesh.hpp"
+#include "rendering/MeshOptimizer.hpp"
+#include "rendering/Render.hpp"
+
+#include <limits>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            // Cell size is grown by that factor until level reaches target triangle count.
+            constexpr float CellSizeGrowth = 1.5f;
+            constexpr uint32_t MaxSimplifyIterations = 32;
+            // Levels below that aren't worth a draw call of their own.
+            constexpr size_t MinLodTriangles = 16;
+        }
+
+        std::vector<LodMeshData> GenerateLods(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes, uint32_t maxLods, float reduction)
+        {
+            ASSERT(maxLods > 0 && maxLods <= LodChain::MaxLods);
+            ASSERT(reduction > 0.0f && reduction < 1.0f);
+
+            std::vector<LodMeshData> lods;
+            lods.push_back({ vertices, indexes, 0.0f });
+            OptimizeMesh(lods.back().vertices, lods.back().indexes);
+
+            if (vertices.empty())
+                return lods;
+
+            Vector3 boundsMin = vertices[0].position;
+            Vector3 boundsMax = vertices[0].position;
+            for (const auto& vertex : vertices)
+            {
+                boundsMin = Vector3(Min(boundsMin.x, vertex.position.x), Min(boundsMin.y, vertex.position.y), Min(boundsMin.z, vertex.position.z));
+                boundsMax = Vector3(Max(boundsMax.x, vertex.position.x), Max(boundsMax.y, vertex.position.y), Max(boundsMax.z, vertex.position.z));
+            }
+
+            // Grid of 256 cells along diagonal barely touches dense meshes, so search starts from there.
+            float cellSize = Max((boundsMax - boundsMin).Length() / 256.0f, std::numeric_limits<float>::epsilon());
+            size_t triangles = indexes.size() / 3;
+
+            while (lods.size() < maxLods)
+            {
+                const size_t targetTriangles = static_cast<size_t>(triangles * reduction);
+                if (targetTriangles < MinLodTriangles)
+                    break;
+
+                // Each level simplifies the source, so errors don't accumulate between levels.
+                std::vector<int32_t> lodIndexes;
+                float error = 0.0f;
+                for (uint32_t iteration = 0; iteration < MaxSimplifyIterations; iteration++)
+                {
+                    lodIndexes = indexes;
+                    error = SimplifyMesh(lodIndexes, vertices, cellSize);
+
+                    if (lodIndexes.size() / 3 <= targetTriangles)
+                        break;
+
+                    cellSize *= CellSizeGrowth;
+                }
+
+                if (lodIndexes.size() / 3 > targetTriangles || lodIndexes.size() / 3 < MinLodTriangles)
+                    break;
+
+                triangles = lodIndexes.size() / 3;
+                // Coarser grid can still happen to land closer to some vertices, chain errors are kept ascending.
+                error = Max(error, lods.back().error);
+
+                lods.push_back({ vertices, std::move(lodIndexes), error });
+                OptimizeMesh(lods.back().vertices, lods.back().indexes);
+            }
+
+            return lods;
+        }
+
+        void LodChain::Init(const std::vector<LodMeshData>& lods)
+        {
+            ASSERT(lods.size() <= MaxLods);
+
+            _lodsCount = 0;
+            for (const auto& lod : lods)
+            {
+                const auto& mesh = Render::Instance()->CreateMesh();
+                mesh->Init(lod.vertices, lod.indexes);
+                AddLod(mesh, lod.error);
+            }
+        }
+
+        void LodChain::AddLod(const std::shared_ptr<Mesh>& mesh, float error)
+        {
+            ASSERT(_lodsCount < MaxLods);
+            ASSERT(_lodsCount == 0 || error >= _errors[_lodsCount - 1]);
+
+            _meshes[_lodsCount] = mesh;
+            _errors[_lodsCount] = error;
+            _lodsCount++;
+        }
+
+        void LodSelector::SetView(const Camera& camera, int viewportHeight)
+        {
+            const float halfHeight = viewportHeight * 0.5f;
+
+            _cameraPosition = camera.GetTransform().Position;
+            _isOrtho = camera.IsOrtho();
+            _zNear = camera.GetZNear();
+            _pixelScale = halfHeight * camera.GetProjectionMatrix().e11;
+        }
+
+        const std::shared_ptr<Mesh>& LodSelector::Select(uint32_t objectId, const LodChain& lodChain, const Vector3& position, float scale)
+        {
+            ASSERT(lodChain.GetLodsCount() > 0);
+
+            if (objectId >= _objectLods.size())
+                _objectLods.resize(objectId + 1, 0);
+
+            const float pixelsPerUnit = scale * (_isOrtho ? _pixelScale : _pixelScale / Max((position - _cameraPosition).Length(), _zNear));
+            const auto projectedError = [&](uint32_t lod) { return lodChain.GetError(lod) * pixelsPerUnit; };
+
+            const float refineThreshold = _description.maxPixelError * (1.0f + _description.hysteresis);
+            const float coarsenThreshold = _description.maxPixelError * (1.0f - _description.hysteresis);
+
+            uint32_t lod = Min<uint32_t>(_objectLods[objectId], lodChain.GetLodsCount() - 1);
+
+            while (lod > 0 && projectedError(lod) > refineThreshold)
+                lod--;
+
+            while (lod + 1 < lodChain.GetLodsCount() && projectedError(lod + 1) <= coarsenThreshold)
+                lod++;
+
+            _objectLods[objectId] = static_cast<uint8_t>(lod);
+            return lodChain.GetMesh(lod);
+        }
+    }
+}
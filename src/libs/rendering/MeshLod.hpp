@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include <array>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Camera;
+        class Mesh;
+        struct Vertex;
+
+        struct LodMeshData
+        {
+            std::vector<Vertex> vertices;
+            std::vector<int32_t> indexes;
+            // Max object space distance vertices were moved by compared to the source mesh.
+            float error;
+        };
+
+        // Simplifies mesh into chain of levels, each with at most reduction times triangles of the previous one. First level is
+        // the source mesh. Chain stops early once simplification can't reach the target. Intended to run once at import.
+        std::vector<LodMeshData> GenerateLods(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes, uint32_t maxLods, float reduction = 0.5f);
+
+        // Levels of detail of single mesh ordered from finest to coarsest.
+        class LodChain final
+        {
+        public:
+            static constexpr uint32_t MaxLods = 8;
+
+        public:
+            // Creates level meshes through Render::Instance().
+            void Init(const std::vector<LodMeshData>& lods);
+            // Errors should grow with level.
+            void AddLod(const std::shared_ptr<Mesh>& mesh, float error);
+
+            inline uint32_t GetLodsCount() const { return _lodsCount; }
+            inline const std::shared_ptr<Mesh>& GetMesh(uint32_t lod) const { return _meshes[lod]; }
+            inline float GetError(uint32_t lod) const { return _errors[lod]; }
+
+        private:
+            uint32_t _lodsCount = 0;
+            std::array<std::shared_ptr<Mesh>, MaxLods> _meshes;
+            std::array<float, MaxLods> _errors;
+        };
+
+        // Picks coarsest level whose error projects below pixel threshold. Level of each object is kept between frames and
+        // switched only once projected error leaves hysteresis band around threshold, so objects near threshold don't pop.
+        // Instances of same level share mesh, so backend batches them as any other instances.
+        class LodSelector final
+        {
+        public:
+            struct Description
+            {
+                float maxPixelError = 1.0f;
+                // Relative width of band around threshold.
+                float hysteresis = 0.25f;
+            };
+
+        public:
+            inline void SetDescription(const Description& description) { _description = description; }
+            inline const Description& GetDescription() const { return _description; }
+
+            void SetView(const Camera& camera, int viewportHeight);
+            // Object id should be stable between frames, it indexes kept level. Scale converts object space errors to world space.
+            const std::shared_ptr<Mesh>& Select(uint32_t objectId, const LodChain& lodChain, const Vector3& position, float scale = 1.0f);
+
+        private:
+            Description _description;
+            Vector3 _cameraPosition = Vector3(0.0f);
+            // Pixels per unit at unit distance for perspective camera, or at any distance for ortho one.
+            float _pixelScale = 0.0f;
+            bool _isOrtho = false;
+            float _zNear = 0.0f;
+            std::vector<uint8_t> _objectLods;
+        };
+    }
+}
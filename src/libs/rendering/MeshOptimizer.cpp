@@ -0,0 +1,466 @@
+#include "MeshOptimizer.hpp"
+
+#include "rendering/Mesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            // Forsyth's tuning constants, modelled cache is larger than real one on purpose.
+            constexpr uint32_t ModelledCacheSize = 32;
+            constexpr float CacheDecayPower = 1.5f;
+            constexpr float LastTriangleScore = 0.75f;
+            constexpr float ValenceBoostScale = 2.0f;
+            constexpr float ValenceBoostPower = 0.5f;
+
+            // FIFO cache size of typical hardware, used by overdraw clustering.
+            constexpr uint32_t FifoCacheSize = 16;
+
+            float vertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+            {
+                if (remainingTriangles == 0)
+                    return -1.0f;
+
+                float score = 0.0f;
+                if (cachePosition >= 0)
+                {
+                    // Vertices of last triangle get fixed score, so the next one doesn't reuse same edge too eagerly.
+                    if (cachePosition < 3)
+                        score = LastTriangleScore;
+                    else
+                        score = std::pow(1.0f - float(cachePosition - 3) / float(ModelledCacheSize - 3), CacheDecayPower);
+                }
+
+                // Vertices with few triangles left are preferred, so they leave the working set early.
+                return score + ValenceBoostScale * std::pow(float(remainingTriangles), -ValenceBoostPower);
+            }
+
+            // FIFO cache simulated with timestamps, vertex is cached while less than cacheSize misses happened after it was loaded.
+            class FifoCache
+            {
+            public:
+                FifoCache(int32_t vCount, uint32_t cacheSize)
+                    : _timestamps(vCount, 0), _cacheSize(cacheSize), _time(cacheSize + 1)
+                {
+                }
+
+                inline bool IsCached(int32_t vertex) const { return _time - _timestamps[vertex] < _cacheSize; }
+
+                uint32_t Peek(const int32_t* triangle) const
+                {
+                    return uint32_t(!IsCached(triangle[0])) + uint32_t(!IsCached(triangle[1])) + uint32_t(!IsCached(triangle[2]));
+                }
+
+                uint32_t Process(const int32_t* triangle)
+                {
+                    uint32_t misses = 0;
+                    for (uint32_t corner = 0; corner < 3; corner++)
+                    {
+                        if (IsCached(triangle[corner]))
+                            continue;
+
+                        _timestamps[triangle[corner]] = _time++;
+                        misses++;
+                    }
+                    return misses;
+                }
+
+                inline void Reset() { _time += _cacheSize + 1; }
+
+            private:
+                std::vector<uint32_t> _timestamps;
+                uint32_t _cacheSize;
+                uint32_t _time;
+            };
+        }
+
+        void OptimizeVertexCache(std::vector<int32_t>& indexes, int32_t vCount)
+        {
+            const size_t triangleCount = indexes.size() / 3;
+            if (triangleCount == 0 || vCount <= 0)
+                return;
+
+            // Triangles adjacent to each vertex, live ones are kept in front of each range.
+            std::vector<uint32_t> remaining(vCount, 0);
+            for (size_t index = 0; index < triangleCount * 3; index++)
+                remaining[indexes[index]]++;
+
+            std::vector<uint32_t> offsets(vCount + 1, 0);
+            for (int32_t vertex = 0; vertex < vCount; vertex++)
+                offsets[vertex + 1] = offsets[vertex] + remaining[vertex];
+
+            std::vector<uint32_t> adjacency(triangleCount * 3);
+            {
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t index = 0; index < triangleCount * 3; index++)
+                    adjacency[cursor[indexes[index]]++] = static_cast<uint32_t>(index / 3);
+            }
+
+            std::vector<int32_t> cachePositions(vCount, -1);
+            std::vector<float> vertexScores(vCount);
+            for (int32_t vertex = 0; vertex < vCount; vertex++)
+                vertexScores[vertex] = vertexScore(-1, remaining[vertex]);
+
+            const auto triangleScore = [&](size_t triangle) {
+                const int32_t* corners = &indexes[triangle * 3];
+                return vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+            };
+
+            std::vector<float> triangleScores(triangleCount);
+            std::vector<bool> emitted(triangleCount, false);
+
+            int64_t best = -1;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            {
+                triangleScores[triangle] = triangleScore(triangle);
+                if (triangleScores[triangle] > bestScore)
+                {
+                    bestScore = triangleScores[triangle];
+                    best = static_cast<int64_t>(triangle);
+                }
+            }
+
+            std::vector<int32_t> result;
+            result.reserve(triangleCount * 3);
+
+            std::array<int32_t, ModelledCacheSize + 3> cache;
+            std::array<int32_t, ModelledCacheSize + 3> nextCache;
+            size_t cacheCount = 0;
+            size_t searchCursor = 0;
+
+            while (best >= 0)
+            {
+                const int32_t* corners = &indexes[best * 3];
+                result.insert(result.end(), corners, corners + 3);
+                emitted[best] = true;
+
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    const int32_t vertex = corners[corner];
+                    uint32_t* begin = &adjacency[offsets[vertex]];
+                    uint32_t* end = begin + remaining[vertex];
+
+                    // Degenerate triangles reference the vertex several times, each corner removes one entry.
+                    auto found = std::find(begin, end, static_cast<uint32_t>(best));
+                    if (found != end)
+                    {
+                        std::swap(*found, *(end - 1));
+                        remaining[vertex]--;
+                    }
+                }
+
+                size_t nextCount = 0;
+                for (uint32_t corner = 0; corner < 3; corner++)
+                    nextCache[nextCount++] = corners[corner];
+
+                for (size_t index = 0; index < cacheCount; index++)
+                {
+                    const int32_t vertex = cache[index];
+                    if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+                        nextCache[nextCount++] = vertex;
+                }
+
+                for (size_t index = 0; index < nextCount; index++)
+                {
+                    const int32_t vertex = nextCache[index];
+                    cachePositions[vertex] = index < ModelledCacheSize ? static_cast<int32_t>(index) : -1;
+                    vertexScores[vertex] = vertexScore(cachePositions[vertex], remaining[vertex]);
+                }
+
+                // Only triangles touching the cache changed score, best candidate is searched among them.
+                best = -1;
+                bestScore = -std::numeric_limits<float>::max();
+                for (size_t index = 0; index < nextCount; index++)
+                {
+                    const int32_t vertex = nextCache[index];
+                    for (uint32_t adjacent = 0; adjacent < remaining[vertex]; adjacent++)
+                    {
+                        const uint32_t triangle = adjacency[offsets[vertex] + adjacent];
+                        triangleScores[triangle] = triangleScore(triangle);
+
+                        if (triangleScores[triangle] > bestScore)
+                        {
+                            bestScore = triangleScores[triangle];
+                            best = triangle;
+                        }
+                    }
+                }
+
+                cacheCount = std::min<size_t>(nextCount, ModelledCacheSize);
+                std::copy(nextCache.begin(), nextCache.begin() + cacheCount, cache.begin());
+
+                if (best < 0)
+                {
+                    while (searchCursor < triangleCount && emitted[searchCursor])
+                        searchCursor++;
+
+                    best = searchCursor < triangleCount ? static_cast<int64_t>(searchCursor) : -1;
+                }
+            }
+
+            indexes.swap(result);
+        }
+
+        void OptimizeOverdraw(std::vector<int32_t>& indexes, const std::vector<Vertex>& vertices, float threshold)
+        {
+            const size_t triangleCount = indexes.size() / 3;
+            const auto vCount = static_cast<int32_t>(vertices.size());
+            if (triangleCount == 0)
+                return;
+
+            FifoCache cache(vCount, FifoCacheSize);
+
+            // Hard boundaries are where fresh strip starts, reordering there doesn't cost cache efficiency.
+            std::vector<size_t> hardClusters;
+            for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            {
+                if (cache.Process(&indexes[triangle * 3]) == 3 || triangle == 0)
+                    hardClusters.push_back(triangle);
+            }
+            hardClusters.push_back(triangleCount);
+
+            std::vector<size_t> clusters;
+            for (size_t cluster = 0; cluster + 1 < hardClusters.size(); cluster++)
+            {
+                const size_t start = hardClusters[cluster];
+                const size_t end = hardClusters[cluster + 1];
+
+                cache.Reset();
+                uint32_t clusterMisses = 0;
+                for (size_t triangle = start; triangle < end; triangle++)
+                    clusterMisses += cache.Process(&indexes[triangle * 3]);
+
+                const float thresholdMisses = float(clusterMisses) / float(end - start) * threshold;
+
+                cache.Reset();
+                size_t softStart = start;
+                uint32_t runningMisses = 0;
+
+                clusters.push_back(start);
+                for (size_t triangle = start; triangle + 1 < end; triangle++)
+                {
+                    runningMisses += cache.Process(&indexes[triangle * 3]);
+
+                    const bool goodEnough = float(runningMisses) <= thresholdMisses * float(triangle + 1 - softStart);
+                    if (goodEnough && cache.Peek(&indexes[(triangle + 1) * 3]) >= 2)
+                    {
+                        softStart = triangle + 1;
+                        runningMisses = 0;
+                        clusters.push_back(softStart);
+                        cache.Reset();
+                    }
+                }
+            }
+            clusters.push_back(triangleCount);
+
+            const auto triangleGeometry = [&](size_t triangle, Vector3& centroid, Vector3& normal) {
+                const auto& p0 = vertices[indexes[triangle * 3 + 0]].position;
+                const auto& p1 = vertices[indexes[triangle * 3 + 1]].position;
+                const auto& p2 = vertices[indexes[triangle * 3 + 2]].position;
+
+                centroid = (p0 + p1 + p2) / 3.0f;
+                // Length is doubled area, so sums are area weighted.
+                normal = (p1 - p0).Cross(p2 - p0);
+            };
+
+            Vector3 meshCentroid(0.0f);
+            float meshArea = 0.0f;
+            for (size_t triangle = 0; triangle < triangleCount; triangle++)
+            {
+                Vector3 centroid, normal;
+                triangleGeometry(triangle, centroid, normal);
+
+                const float area = normal.Length();
+                meshCentroid = meshCentroid + centroid * area;
+                meshArea += area;
+            }
+
+            if (meshArea > 0.0f)
+                meshCentroid = meshCentroid / meshArea;
+
+            struct ClusterSortItem
+            {
+                float key;
+                size_t cluster;
+            };
+
+            std::vector<ClusterSortItem> sortItems;
+            sortItems.reserve(clusters.size() - 1);
+
+            for (size_t cluster = 0; cluster + 1 < clusters.size(); cluster++)
+            {
+                Vector3 clusterCentroid(0.0f);
+                Vector3 clusterNormal(0.0f);
+                float clusterArea = 0.0f;
+
+                for (size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; triangle++)
+                {
+                    Vector3 centroid, normal;
+                    triangleGeometry(triangle, centroid, normal);
+
+                    const float area = normal.Length();
+                    clusterCentroid = clusterCentroid + centroid * area;
+                    clusterNormal = clusterNormal + normal;
+                    clusterArea += area;
+                }
+
+                float key = 0.0f;
+                const float normalLength = clusterNormal.Length();
+                if (clusterArea > 0.0f && normalLength > 0.0f)
+                    key = (clusterCentroid / clusterArea - meshCentroid).Dot(clusterNormal / normalLength);
+
+                sortItems.push_back({ key, cluster });
+            }
+
+            // Clusters facing away from mesh center are likely occluders, so they go first.
+            std::stable_sort(sortItems.begin(), sortItems.end(), [](const ClusterSortItem& a, const ClusterSortItem& b) { return a.key > b.key; });
+
+            std::vector<int32_t> result;
+            result.reserve(indexes.size());
+            for (const auto& item : sortItems)
+            {
+                const auto begin = indexes.begin() + clusters[item.cluster] * 3;
+                const auto end = indexes.begin() + clusters[item.cluster + 1] * 3;
+                result.insert(result.end(), begin, end);
+            }
+
+            indexes.swap(result);
+        }
+
+        void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<int32_t>& indexes)
+        {
+            std::vector<int32_t> remap(vertices.size(), -1);
+            std::vector<Vertex> result;
+            result.reserve(vertices.size());
+
+            for (auto& index : indexes)
+            {
+                if (remap[index] < 0)
+                {
+                    remap[index] = static_cast<int32_t>(result.size());
+                    result.push_back(vertices[index]);
+                }
+
+                index = remap[index];
+            }
+
+            vertices.swap(result);
+        }
+
+        void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<int32_t>& indexes)
+        {
+            OptimizeVertexCache(indexes, static_cast<int32_t>(vertices.size()));
+            OptimizeOverdraw(indexes, vertices);
+            OptimizeVertexFetch(vertices, indexes);
+        }
+
+        float SimplifyMesh(std::vector<int32_t>& indexes, const std::vector<Vertex>& vertices, float cellSize)
+        {
+            ASSERT(cellSize > 0.0f);
+
+            if (vertices.empty())
+                return 0.0f;
+
+            Vector3 boundsMin = vertices[0].position;
+            for (const auto& vertex : vertices)
+                boundsMin = Vector3(Min(boundsMin.x, vertex.position.x), Min(boundsMin.y, vertex.position.y), Min(boundsMin.z, vertex.position.z));
+
+            const auto cellKey = [&](const Vector3& position) {
+                const auto coordinate = [&](float value, float origin) {
+                    return static_cast<uint64_t>((value - origin) / cellSize) & 0x1FFFFF;
+                };
+                return coordinate(position.x, boundsMin.x) | coordinate(position.y, boundsMin.y) << 21 | coordinate(position.z, boundsMin.z) << 42;
+            };
+
+            struct Cell
+            {
+                Vector3 positionSum = Vector3(0.0f);
+                uint32_t count = 0;
+                int32_t representative = -1;
+                float representativeDistance = std::numeric_limits<float>::max();
+            };
+
+            // Only referenced vertices take part, so unused ones don't pull cell average.
+            std::vector<int32_t> vertexCells(vertices.size(), -1);
+            std::unordered_map<uint64_t, int32_t> cellIndexes;
+            std::vector<Cell> cells;
+
+            for (const auto index : indexes)
+            {
+                if (vertexCells[index] >= 0)
+                    continue;
+
+                const auto& position = vertices[index].position;
+                const auto inserted = cellIndexes.emplace(cellKey(position), static_cast<int32_t>(cells.size()));
+                if (inserted.second)
+                    cells.emplace_back();
+
+                auto& cell = cells[inserted.first->second];
+                cell.positionSum = cell.positionSum + position;
+                cell.count++;
+                vertexCells[index] = inserted.first->second;
+            }
+
+            for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+            {
+                if (vertexCells[vertex] < 0)
+                    continue;
+
+                auto& cell = cells[vertexCells[vertex]];
+                const float distance = (vertices[vertex].position - cell.positionSum / static_cast<float>(cell.count)).Length();
+                if (distance < cell.representativeDistance)
+                {
+                    cell.representative = static_cast<int32_t>(vertex);
+                    cell.representativeDistance = distance;
+                }
+            }
+
+            float error = 0.0f;
+            for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+                if (vertexCells[vertex] >= 0)
+                    error = Max(error, (vertices[vertex].position - vertices[cells[vertexCells[vertex]].representative].position).Length());
+
+            size_t writeIndex = 0;
+            for (size_t triangle = 0; triangle < indexes.size() / 3; triangle++)
+            {
+                const int32_t a = cells[vertexCells[indexes[triangle * 3]]].representative;
+                const int32_t b = cells[vertexCells[indexes[triangle * 3 + 1]]].representative;
+                const int32_t c = cells[vertexCells[indexes[triangle * 3 + 2]]].representative;
+
+                if (a == b || b == c || a == c)
+                    continue;
+
+                indexes[writeIndex++] = a;
+                indexes[writeIndex++] = b;
+                indexes[writeIndex++] = c;
+            }
+            indexes.resize(writeIndex);
+
+            return error;
+        }
+
+        float ComputeACMR(const std::vector<int32_t>& indexes, int32_t vCount, uint32_t cacheSize)
+        {
+            const size_t triangleCount = indexes.size() / 3;
+            if (triangleCount == 0)
+                return 0.0f;
+
+            FifoCache cache(vCount, cacheSize);
+
+            uint32_t misses = 0;
+            for (size_t triangle = 0; triangle < triangleCount; triangle++)
+                misses += cache.Process(&indexes[triangle * 3]);
+
+            return float(misses) / float(triangleCount);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        struct Vertex;
+
+        // Reorders triangles to maximize post transform vertex cache hits, uses Forsyth's linear speed algorithm.
+        void OptimizeVertexCache(std::vector<int32_t>& indexes, int32_t vCount);
+
+        // Splits cache optimized triangles into clusters and orders them outward facing first to reduce overdraw.
+        // Clusters are split further while their cache miss ratio stays within threshold of the unsplit one.
+        void OptimizeOverdraw(std::vector<int32_t>& indexes, const std::vector<Vertex>& vertices, float threshold = 1.05f);
+
+        // Orders vertices by first reference and drops the unreferenced ones.
+        void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<int32_t>& indexes);
+
+        // Runs vertex cache, overdraw and vertex fetch optimizations in that order.
+        void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<int32_t>& indexes);
+
+        // Vertex clustering simplification, vertices sharing cell of uniform grid are collapsed into the one closest to cell average
+        // and degenerate triangles are dropped. Indexes keep referencing original vertices. Returns max distance a vertex was moved by.
+        float SimplifyMesh(std::vector<int32_t>& indexes, const std::vector<Vertex>& vertices, float cellSize);
+
+        // Average number of vertex shader invocations per triangle for FIFO cache of cacheSize entries.
+        float ComputeACMR(const std::vector<int32_t>& indexes, int32_t vCount, uint32_t cacheSize = 16);
+    }
+}
@@ -0,0 +1,173 @@
+#include "Meshlets.hpp"
+
+#include "rendering/Culling.hpp"
+#include "rendering/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            // Cones wider than this are almost never culled, test is skipped for them.
+            constexpr float MinConeDot = 0.1f;
+
+            inline Vector3 transformDirection(const Matrix4& m, const Vector3& direction)
+            {
+                return Vector3(m.e00 * direction.x + m.e01 * direction.y + m.e02 * direction.z,
+                               m.e10 * direction.x + m.e11 * direction.y + m.e12 * direction.z,
+                               m.e20 * direction.x + m.e21 * direction.y + m.e22 * direction.z);
+            }
+
+            Meshlet finalizeMeshlet(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes,
+                                    size_t firstIndex, size_t indexCount, const std::vector<int32_t>& meshletVertices)
+            {
+                Meshlet meshlet;
+                meshlet.firstIndex = static_cast<uint32_t>(firstIndex);
+                meshlet.indexCount = static_cast<uint32_t>(indexCount);
+
+                Vector3 boundsMin = vertices[meshletVertices[0]].position;
+                Vector3 boundsMax = boundsMin;
+                for (const auto vertex : meshletVertices)
+                {
+                    const auto& position = vertices[vertex].position;
+                    boundsMin = Vector3(std::min(boundsMin.x, position.x), std::min(boundsMin.y, position.y), std::min(boundsMin.z, position.z));
+                    boundsMax = Vector3(std::max(boundsMax.x, position.x), std::max(boundsMax.y, position.y), std::max(boundsMax.z, position.z));
+                }
+
+                meshlet.center = (boundsMin + boundsMax) * 0.5f;
+                meshlet.radius = 0.0f;
+                for (const auto vertex : meshletVertices)
+                    meshlet.radius = std::max(meshlet.radius, (vertices[vertex].position - meshlet.center).Length());
+
+                std::vector<Vector3> normals;
+                normals.reserve(indexCount / 3);
+
+                Vector3 axis(0.0f);
+                for (size_t index = firstIndex; index < firstIndex + indexCount; index += 3)
+                {
+                    const auto& p0 = vertices[indexes[index + 0]].position;
+                    const auto& p1 = vertices[indexes[index + 1]].position;
+                    const auto& p2 = vertices[indexes[index + 2]].position;
+
+                    const Vector3 normal = (p1 - p0).Cross(p2 - p0);
+                    const float length = normal.Length();
+                    if (length == 0.0f)
+                        continue;
+
+                    normals.push_back(normal / length);
+                    axis = axis + normals.back();
+                }
+
+                meshlet.coneAxis = Vector3(0.0f);
+                meshlet.coneCutoff = 1.0f;
+
+                const float axisLength = axis.Length();
+                if (normals.empty() || axisLength == 0.0f)
+                    return meshlet;
+
+                axis = axis / axisLength;
+
+                float minDot = 1.0f;
+                for (const auto& normal : normals)
+                    minDot = std::min(minDot, normal.Dot(axis));
+
+                if (minDot <= MinConeDot)
+                    return meshlet;
+
+                meshlet.coneAxis = axis;
+                meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+
+                return meshlet;
+            }
+        }
+
+        std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes,
+                                           uint32_t maxVertices, uint32_t maxTriangles)
+        {
+            ASSERT(maxVertices >= 3 && maxTriangles >= 1);
+
+            std::vector<Meshlet> meshlets;
+
+            // Stamp of meshlet that last referenced vertex, so membership test doesn't need clearing.
+            std::vector<uint32_t> vertexStamps(vertices.size(), 0);
+            std::vector<int32_t> meshletVertices;
+            meshletVertices.reserve(maxVertices);
+
+            uint32_t stamp = 1;
+            size_t firstIndex = 0;
+
+            for (size_t index = 0; index + 2 < indexes.size(); index += 3)
+            {
+                const auto a = indexes[index + 0];
+                const auto b = indexes[index + 1];
+                const auto c = indexes[index + 2];
+
+                // Degenerate triangles reference same vertex several times.
+                const uint32_t newVertices = uint32_t(vertexStamps[a] != stamp) +
+                                             uint32_t(b != a && vertexStamps[b] != stamp) +
+                                             uint32_t(c != a && c != b && vertexStamps[c] != stamp);
+
+                const size_t triangles = (index - firstIndex) / 3;
+                if (meshletVertices.size() + newVertices > maxVertices || triangles >= maxTriangles)
+                {
+                    meshlets.push_back(finalizeMeshlet(vertices, indexes, firstIndex, index - firstIndex, meshletVertices));
+
+                    meshletVertices.clear();
+                    firstIndex = index;
+                    stamp++;
+                }
+
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    const auto vertex = indexes[index + corner];
+                    if (vertexStamps[vertex] == stamp)
+                        continue;
+
+                    vertexStamps[vertex] = stamp;
+                    meshletVertices.push_back(vertex);
+                }
+            }
+
+            if (!meshletVertices.empty())
+                meshlets.push_back(finalizeMeshlet(vertices, indexes, firstIndex, indexes.size() / 3 * 3 - firstIndex, meshletVertices));
+
+            return meshlets;
+        }
+
+        void CullMeshlets(const std::vector<Meshlet>& meshlets, const Matrix4& modelMatrix, const Frustum& frustum,
+                          const Vector3& cameraPosition, std::vector<uint32_t>& visible)
+        {
+            visible.clear();
+
+            // Largest axis scale keeps transformed spheres conservative.
+            const float scale = std::sqrt(std::max({ modelMatrix.Right().LengthSqr(), modelMatrix.Up().LengthSqr(), modelMatrix.Forward().LengthSqr() }));
+
+            for (uint32_t index = 0; index < meshlets.size(); index++)
+            {
+                const auto& meshlet = meshlets[index];
+
+                const Vector3 center = modelMatrix * meshlet.center;
+                const float radius = meshlet.radius * scale;
+
+                if (!frustum.IsVisible(center, radius))
+                    continue;
+
+                if (meshlet.coneCutoff < 1.0f)
+                {
+                    const Vector3 axis = transformDirection(modelMatrix, meshlet.coneAxis).Normal();
+                    const Vector3 view = center - cameraPosition;
+
+                    // Every triangle faces away when whole sphere is inside negative cone.
+                    if (view.Dot(axis) >= meshlet.coneCutoff * view.Length() + radius)
+                        continue;
+                }
+
+                visible.push_back(index);
+            }
+        }
+    }
+}
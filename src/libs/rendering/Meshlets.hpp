@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        struct Frustum;
+        struct Vertex;
+
+        // Contiguous range of mesh triangles with mesh space bounds.
+        struct Meshlet
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+
+            Vector3 center;
+            float radius;
+
+            // Backface cone, cutoff is sine of cone spread. Zero axis with cutoff one is never culled.
+            Vector3 coneAxis;
+            float coneCutoff;
+        };
+
+        constexpr uint32_t MaxMeshletVertices = 64;
+        constexpr uint32_t MaxMeshletTriangles = 124;
+
+        // Greedily splits triangles in index order, run OptimizeVertexCache first to get compact meshlets.
+        std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes,
+                                           uint32_t maxVertices = MaxMeshletVertices, uint32_t maxTriangles = MaxMeshletTriangles);
+
+        // Writes indices of meshlets intersecting world space frustum and facing camera.
+        void CullMeshlets(const std::vector<Meshlet>& meshlets, const Matrix4& modelMatrix, const Frustum& frustum,
+                          const Vector3& cameraPosition, std::vector<uint32_t>& visible);
+    }
+}
@@ -0,0 +1,191 @@
+#include "PrefetchScheduler.hpp"
+
+#include "Camera.hpp"
+#include "SceneBvh.hpp"
+
+#include <algorithm>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        namespace
+        {
+            // Extrapolated rotation is limited, prediction of faster turns is mostly noise.
+            constexpr float MaxPredictedAngle = HALF_PI;
+        }
+
+        PrefetchScheduler::PrefetchScheduler(const Description& description)
+        {
+            SetDescription(description);
+        }
+
+        void PrefetchScheduler::SetDescription(const Description& description)
+        {
+            ASSERT(description.lookahead >= 0.0f);
+            ASSERT(description.smoothing > 0.0f && description.smoothing <= 1.0f);
+            ASSERT(description.maxInFlight > 0);
+
+            _description = description;
+        }
+
+        void PrefetchScheduler::SetCallbacks(RequestCallback request, EvictCallback evict)
+        {
+            _requestCallback = std::move(request);
+            _evictCallback = std::move(evict);
+        }
+
+        void PrefetchScheduler::Reset()
+        {
+            _hasPreviousPose = false;
+            _velocity = Vector3(0.0f);
+            _angularVelocity = Vector3(0.0f);
+            _time = 0.0f;
+            _inFlightCount = 0;
+            _entries.clear();
+        }
+
+        void PrefetchScheduler::OnLoaded(uint32_t object)
+        {
+            const auto it = _entries.find(object);
+            if (it == _entries.end() || it->second.state != State::Requested)
+                return;
+
+            ASSERT(_inFlightCount > 0);
+            _inFlightCount--;
+
+            it->second.state = State::Prefetched;
+            // Expiration counts from the moment data is resident.
+            it->second.lastPredictedTime = _time;
+        }
+
+        void PrefetchScheduler::Forget(uint32_t object)
+        {
+            const auto it = _entries.find(object);
+            if (it == _entries.end())
+                return;
+
+            if (it->second.state == State::Requested)
+            {
+                ASSERT(_inFlightCount > 0);
+                _inFlightCount--;
+            }
+
+            _entries.erase(it);
+        }
+
+        void PrefetchScheduler::updateMotion(const Vector3& position, const Quaternion& rotation, float deltaTime)
+        {
+            if (!_hasPreviousPose || deltaTime <= 0.0f)
+            {
+                _hasPreviousPose = true;
+                _previousPosition = position;
+                _previousRotation = rotation;
+                return;
+            }
+
+            const Vector3 velocity = (position - _previousPosition) * (1.0f / deltaTime);
+
+            // Rotation since previous update as axis and angle along the shortest arc.
+            Quaternion delta = (rotation * _previousRotation.Inverse()).Normal();
+            if (delta.w < 0.0f)
+                delta = -delta;
+
+            const float sinHalfAngle = sqrtf(Max(1.0f - delta.w * delta.w, 0.0f));
+            const float angle = 2.0f * acosf(Min(delta.w, 1.0f));
+            const Vector3 angularVelocity = sinHalfAngle > EPS ? Vector3(delta.x, delta.y, delta.z) * (angle / (sinHalfAngle * deltaTime)) : Vector3(0.0f);
+
+            _velocity = _velocity + (velocity - _velocity) * _description.smoothing;
+            _angularVelocity = _angularVelocity + (angularVelocity - _angularVelocity) * _description.smoothing;
+
+            _previousPosition = position;
+            _previousRotation = rotation;
+        }
+
+        void PrefetchScheduler::addCandidates(const std::vector<uint32_t>& objects, const SceneBvh& bvh, const Vector3& position, float timeToVisible)
+        {
+            for (const uint32_t object : objects)
+            {
+                const auto it = _entries.find(object);
+                if (it != _entries.end())
+                {
+                    it->second.lastPredictedTime = _time;
+
+                    if (timeToVisible == 0.0f && it->second.state == State::Prefetched)
+                        it->second.state = State::Visible;
+
+                    continue;
+                }
+
+                _candidates.push_back({ object, timeToVisible, (bvh.GetCenter(object) - position).Length() });
+            }
+        }
+
+        void PrefetchScheduler::Update(const Camera& camera, const SceneBvh& bvh, float deltaTime)
+        {
+            const Transform transform = camera.GetTransform();
+            updateMotion(transform.Position, transform.Rotation, deltaTime);
+            _time += Max(deltaTime, 0.0f);
+
+            _candidates.clear();
+
+            _queried.clear();
+            bvh.QueryFrustum(camera.GetFrustum(), _queried);
+            addCandidates(_queried, bvh, transform.Position, 0.0f);
+
+            const float angularSpeed = _angularVelocity.Length();
+            const Vector3 axis = angularSpeed > EPS ? _angularVelocity * (1.0f / angularSpeed) : Vector3(0.0f, 0.0f, 1.0f);
+
+            Camera predictedCamera = camera;
+            for (uint32_t step = 1; step <= _description.predictionSteps; step++)
+            {
+                const float time = _description.lookahead * step / _description.predictionSteps;
+
+                Transform predicted;
+                predicted.Position = transform.Position + _velocity * time;
+                predicted.Rotation = Quaternion(axis, Radian(Min(angularSpeed * time, MaxPredictedAngle))) * transform.Rotation;
+                predictedCamera.SetTransform(predicted);
+
+                _queried.clear();
+                bvh.QueryFrustum(predictedCamera.GetFrustum(), _queried);
+                addCandidates(_queried, bvh, predicted.Position, time);
+            }
+
+            // Candidates are appended in order of time, so stable sort keeps the earliest sighting of each object first.
+            std::stable_sort(_candidates.begin(), _candidates.end(), [](const Request& a, const Request& b) { return a.object < b.object; });
+            _candidates.erase(std::unique(_candidates.begin(), _candidates.end(), [](const Request& a, const Request& b) { return a.object == b.object; }), _candidates.end());
+
+            std::sort(_candidates.begin(), _candidates.end(), [](const Request& a, const Request& b) {
+                return a.timeToVisible != b.timeToVisible ? a.timeToVisible < b.timeToVisible : a.distance < b.distance;
+            });
+
+            // The rest is reconsidered next update from fresh prediction.
+            for (const auto& candidate : _candidates)
+            {
+                if (_inFlightCount >= _description.maxInFlight)
+                    break;
+
+                _entries.emplace(candidate.object, Entry { State::Requested, _time });
+                _inFlightCount++;
+
+                if (_requestCallback)
+                    _requestCallback(candidate);
+            }
+
+            _expired.clear();
+            for (const auto& [object, entry] : _entries)
+                if (entry.state == State::Prefetched && _time - entry.lastPredictedTime > _description.expireTime)
+                    _expired.push_back(object);
+
+            for (const uint32_t object : _expired)
+            {
+                _entries.erase(object);
+
+                if (_evictCallback)
+                    _evictCallback(object);
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Camera;
+        class SceneBvh;
+
+        // Requests object data before it becomes visible. Camera motion is measured every update and extrapolated a short
+        // time ahead, objects entering frustums of predicted poses are requested ordered by time until they are expected
+        // to be visible. Reading and uploading is left to request callback, e.g. file jobs feeding TextureStreamer.
+        // Prefetched objects the camera never turned to are handed back for eviction, so resident set doesn't grow.
+        class PrefetchScheduler final
+        {
+        public:
+            struct Description
+            {
+                // Seconds of motion extrapolated, should cover typical read and upload latency.
+                float lookahead = 0.3f;
+                // Predicted poses between now and lookahead, each costs one BVH frustum query.
+                uint32_t predictionSteps = 3;
+                // Exponential smoothing factor of measured velocities, lower values ignore jitter of input.
+                float smoothing = 0.3f;
+                // Requests not loaded yet, bounds IO queue depth and memory held by data waiting for upload.
+                uint32_t maxInFlight = 32;
+                // Loaded objects that stay out of current and predicted frustums for that many seconds are evicted.
+                float expireTime = 2.0f;
+            };
+
+            struct Request
+            {
+                uint32_t object;
+                // Zero for objects already visible.
+                float timeToVisible;
+                float distance;
+            };
+
+            // Called from Update, objects are BVH object ids.
+            using RequestCallback = std::function<void(const Request& request)>;
+            using EvictCallback = std::function<void(uint32_t object)>;
+
+        public:
+            PrefetchScheduler() = default;
+            PrefetchScheduler(const Description& description);
+
+            void SetDescription(const Description& description);
+            inline const Description& GetDescription() const { return _description; }
+
+            void SetCallbacks(RequestCallback request, EvictCallback evict);
+
+            // Once per frame after camera is moved, delta time in seconds.
+            void Update(const Camera& camera, const SceneBvh& bvh, float deltaTime);
+            // Forgets motion history and all objects, nothing is evicted.
+            void Reset();
+
+            // Same thread as Update. Reads and uploads of requested object are done.
+            void OnLoaded(uint32_t object);
+            // Same thread as Update. Object was evicted by other means and could be requested again.
+            void Forget(uint32_t object);
+
+            inline Vector3 GetVelocity() const { return _velocity; }
+            // Axis scaled by radians per second.
+            inline Vector3 GetAngularVelocity() const { return _angularVelocity; }
+            inline uint32_t GetInFlightCount() const { return _inFlightCount; }
+
+        private:
+            enum class State : uint8_t
+            {
+                Requested,
+                // Loaded ahead of time, evicted unless camera gets to it.
+                Prefetched,
+                // Was seen by camera, regular streaming owns it from now on.
+                Visible
+            };
+
+            struct Entry
+            {
+                State state;
+                float lastPredictedTime;
+            };
+
+            void updateMotion(const Vector3& position, const Quaternion& rotation, float deltaTime);
+            void addCandidates(const std::vector<uint32_t>& objects, const SceneBvh& bvh, const Vector3& position, float timeToVisible);
+
+        private:
+            Description _description;
+            RequestCallback _requestCallback;
+            EvictCallback _evictCallback;
+
+            bool _hasPreviousPose = false;
+            Vector3 _previousPosition;
+            Quaternion _previousRotation;
+            Vector3 _velocity = Vector3(0.0f);
+            Vector3 _angularVelocity = Vector3(0.0f);
+
+            float _time = 0.0f;
+            uint32_t _inFlightCount = 0;
+            std::unordered_map<uint32_t, Entry> _entries;
+
+            // Scratch storage reused by updates.
+            std::vector<uint32_t> _queried;
+            std::vector<Request> _candidates;
+            std::vector<uint32_t> _expired;
+        };
+    }
+}
@@ -3,21 +3,37 @@
 #include "common/Math.hpp"
 
 #include "rendering/Mesh.hpp"
+#include "rendering/MeshOptimizer.hpp"
 #include "rendering/Render.hpp"
 
+#include <unordered_map>
+
 namespace OpenDemo
 {
     using namespace Common;
 
     namespace Rendering
     {
+        namespace
+        {
+            // Meshes are created on render thread only, so caches aren't guarded.
+            std::unordered_map<uint32_t, std::shared_ptr<Mesh>> sphereMeshes;
+            std::shared_ptr<Mesh> fullScreenQuad;
+        }
+
         std::shared_ptr<Mesh> Primitives::GetSphereMesh(uint32_t segments)
         {
+            ASSERT(segments >= 2);
+
+            auto& cached = sphereMeshes[segments];
+            if (cached)
+                return cached;
+
             const auto& render = Rendering::Instance();
             const auto& mesh = render->CreateMesh();
 
             const uint32_t vertexCount = segments * (segments - 1) + 2;
-            auto vertices = new Vertex[vertexCount];
+            std::vector<Vertex> vertices(vertexCount);
 
             uint32_t index = 0;
             vertices[index].position = Vector3(0.0f, 1.0f, 0.0f);
@@ -48,16 +64,16 @@ namespace OpenDemo
             vertices[index].position = Vector3(0.0f, -1.0f, 0.0f);
             vertices[index].normal = Vector3(0.0f, -1.0f, 0.0f);
 
-            std::vector<int32_t>* indexes = new std::vector<int32_t>();
+            std::vector<int32_t> indexes;
 
             for (uint32_t i = 0; i < segments; ++i)
             {
                 uint32_t const a = i + 1;
                 uint32_t const b = (i + 1) % segments + 1;
 
-                indexes->emplace_back(0);
-                indexes->emplace_back(b);
-                indexes->emplace_back(a);
+                indexes.emplace_back(0);
+                indexes.emplace_back(b);
+                indexes.emplace_back(a);
             }
 
             for (uint32_t j = 0; j < segments - 2; ++j)
@@ -71,13 +87,13 @@ namespace OpenDemo
                     const uint32_t b = bStart + i;
                     const uint32_t b1 = bStart + (i + 1) % segments;
 
-                    indexes->emplace_back(a);
-                    indexes->emplace_back(a1);
-                    indexes->emplace_back(b1);
+                    indexes.emplace_back(a);
+                    indexes.emplace_back(a1);
+                    indexes.emplace_back(b1);
 
-                    indexes->emplace_back(a);
-                    indexes->emplace_back(b1);
-                    indexes->emplace_back(b);
+                    indexes.emplace_back(a);
+                    indexes.emplace_back(b1);
+                    indexes.emplace_back(b);
                 }
             }
 
@@ -86,23 +102,25 @@ namespace OpenDemo
                 uint32_t const a = i + segments * (segments - 2) + 1;
                 uint32_t const b = (i + 1) % segments + segments * (segments - 2) + 1;
 
-                indexes->emplace_back(vertexCount - 1);
-                indexes->emplace_back(a);
-                indexes->emplace_back(b);
+                indexes.emplace_back(vertexCount - 1);
+                indexes.emplace_back(a);
+                indexes.emplace_back(b);
             }
 
-            mesh->Init(vertices, vertexCount, indexes->data(), static_cast<int32_t>(indexes->size()));
+            OptimizeMesh(vertices, indexes);
+            mesh->Init(vertices, indexes);
 
-            delete indexes;
-            delete[] vertices;
+            // Per object culling is coarse enough for small spheres.
+            constexpr size_t MeshletsMinTriangles = 4096;
+            if (indexes.size() / 3 >= MeshletsMinTriangles)
+                mesh->SetMeshlets(BuildMeshlets(vertices, indexes));
 
+            cached = mesh;
             return mesh;
         }
 
         std::shared_ptr<Mesh> Primitives::GetFullScreenQuad()
         {
-            static std::shared_ptr<Mesh> fullScreenQuad;
-
             if (fullScreenQuad == nullptr)
             {
                 const auto& render = Rendering::Instance();
@@ -131,5 +149,11 @@ namespace OpenDemo
 
             return fullScreenQuad;
         }
+
+        void Primitives::ReleaseCache()
+        {
+            sphereMeshes.clear();
+            fullScreenQuad.reset();
+        }
     }
 }
\ No newline at end of file
@@ -6,11 +6,17 @@ namespace OpenDemo
     {
         class Mesh;
 
+        // Built-in meshes are generated once per parameter set and shared by all callers, they live in geometry arena
+        // of the render like any other mesh. Full screen passes should prefer Render::DrawFullScreenTriangle,
+        // which needs no vertex data at all.
         class Primitives
         {
         public:
             static std::shared_ptr<Mesh> GetSphereMesh(unsigned int segments);
             static std::shared_ptr<Mesh> GetFullScreenQuad();
+
+            // Called by render on Terminate, cached meshes can't outlive its geometry arena.
+            static void ReleaseCache();
         };
     }
 }
\ No newline at end of file
@@ -14,8 +14,10 @@ namespace OpenDemo
     namespace Rendering
     {
         class Texture2D;
+        class Texture2DArray;
         class Shader;
         class Mesh;
+        class SkinnedMesh;
         class RenderContext;
         class RenderTargetContext;
 
@@ -30,6 +32,11 @@ namespace OpenDemo
             RGBA32F,
             RGBA16F,
             D16,
+            R32F,
+            // Unsigned float without alpha, half the size of RGBA16F.
+            R11G11B10F,
+            // Motion vectors.
+            RG16F,
             PIXEL_FORMAT_MAX
         };
 
@@ -41,6 +48,13 @@ namespace OpenDemo
             TANGENT,
             BINORMAL,
             COLOR,
+            // Per instance model matrix, occupies four consecutive locations.
+            INSTANCE_MODEL,
+            // Inputs of skinning pass only.
+            SKIN_JOINTS = INSTANCE_MODEL + 4,
+            SKIN_WEIGHTS,
+            // Per instance material layers of texture array maps, ordered as Sampler: albedo, normal, roughness, metallic.
+            INSTANCE_LAYERS,
             MAX_ATTRIBUTES
         };
 
@@ -50,6 +64,8 @@ namespace OpenDemo
             Matrix4 modelMatrix;
             Rendering::Material material;
             std::shared_ptr<Mesh> mesh;
+            // Static elements are expected not to move, caches built from them are kept until scene static revision changes.
+            bool isStatic = false;
         };
 
         class Render
@@ -66,6 +82,8 @@ namespace OpenDemo
             virtual void Terminate() = 0;
 
             virtual void SwapBuffers() const = 0;
+            // GPU time in milliseconds of the latest frame with resolved timings, negative if none resolved since last call.
+            virtual float GetGpuFrameTime() = 0;
 
             virtual void Clear(const Common::Vector4& color, float depth) const = 0;
             virtual void ClearColor(const Common::Vector4& color) const = 0;
@@ -73,12 +91,38 @@ namespace OpenDemo
 
             virtual void Begin(const std::shared_ptr<RenderContext>& CommandContext) = 0;
             virtual void DrawElement(const RenderElement& renderElement) const = 0;
+            // Backends may reorder elements to minimize state changes.
+            virtual void DrawElements(const std::vector<RenderElement>& renderElements)
+            {
+                for (const auto& renderElement : renderElements)
+                    DrawElement(renderElement);
+            }
             virtual void End() const = 0;
 
             virtual std::shared_ptr<Texture2D> CreateTexture2D() const = 0;
+            virtual std::shared_ptr<Texture2DArray> CreateTexture2DArray() const = 0;
             virtual std::shared_ptr<Shader> CreateShader() const = 0;
             virtual std::shared_ptr<Mesh> CreateMesh() const = 0;
             virtual std::shared_ptr<RenderTargetContext> CreateRenderTargetContext() const = 0;
+            virtual std::shared_ptr<SkinnedMesh> CreateSkinnedMesh() const = 0;
+
+            virtual bool IsRenderTargetFormatSupported(PixelFormat format) const = 0;
+            // Uploads first mip over following frames without stalling, data layout matches Texture2D::Init.
+            // Texture should be initialized with null data. Can be called from any thread, e.g. by jobs loading files.
+            virtual void StreamTexture2D(const std::shared_ptr<Texture2D>& texture, std::vector<uint8_t>&& data) = 0;
+            // Copies whole depth target, both contexts should be of same size.
+            virtual void CopyDepth(const std::shared_ptr<RenderTargetContext>& source, const std::shared_ptr<RenderTargetContext>& target) = 0;
+
+            // Draws single triangle covering viewport with bound render context, no vertex buffer is bound.
+            // Vertex shader derives clip position and texture coordinate from vertex index, see postProcess.shader.
+            virtual void DrawFullScreenTriangle() const = 0;
+            // Draws full screen triangle with shader into mip of target. Source is bound as AlbedoMap with only source mip visible,
+            // so source and target can be different mips of same texture. Params are passed as Uniform::BLIT_PARAMS.
+            virtual void Blit(const std::shared_ptr<Texture2D>& source, int sourceLevel, const std::shared_ptr<Texture2D>& target, int targetLevel,
+                              const std::shared_ptr<Shader>& shader, const Common::Vector4& params, bool additive) = 0;
+            // Skins bind pose into output mesh on GPU with palette of at most Skeleton::MaxJoints matrices,
+            // palette is passed as UniformBlock::SKINNING.
+            virtual void Skin(const SkinnedMesh& skinnedMesh, const std::vector<Common::Matrix4>& palette, const std::shared_ptr<Shader>& shader) = 0;
 
         protected:
             static std::unique_ptr<Render> instance;
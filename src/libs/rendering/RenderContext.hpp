@@ -2,8 +2,11 @@
 
 #include "common/Math.hpp"
 
+#include "rendering/Culling.hpp"
 #include "rendering/BlendingDescription.hpp"
 #include "rendering/DepthDescription.hpp"
+#include "rendering/LightClusters.hpp"
+#include "rendering/MeshLod.hpp"
 
 namespace OpenDemo
 {
@@ -26,6 +29,8 @@ namespace OpenDemo
             RenderContext();
 
             inline void SetDepthWrite(bool value) { _depthWrite = value; }
+            // Color writes are disabled and materials ignored, elements are drawn roughly front to back.
+            inline void SetDepthOnly(bool value) { _depthOnly = value; }
             inline void SetDepthTestFunction(DepthTestFunction value) { _depthTestFunction = value; }
 
             inline void SetBlending(bool value) { _blending = value; }
@@ -35,8 +40,31 @@ namespace OpenDemo
             inline void SetRenderTarget(const std::shared_ptr<RenderTargetContext>& value) { _renderTargetContext = value; }
             inline void SetShader(const std::shared_ptr<Shader>& value) { _shader = value; }
             inline void SetLightDirection(const Vector3& value) { _lightDirection = value; }
+            inline void SetLightClusters(const std::shared_ptr<LightClusters>& value) { _lightClusters = value; }
+            // Scene bumps it whenever static elements change.
+            inline void SetStaticRevision(uint32_t value) { _staticRevision = value; }
+            // Slope scaled and constant depth offset, used by shadow casters.
+            inline void SetDepthBias(float slopeScale, float constant)
+            {
+                _depthBiasSlopeScale = slopeScale;
+                _depthBiasConstant = constant;
+            }
+            // Unjittered view projection of previous frame, motion vectors are zero until it's set.
+            inline void SetPreviousViewProjection(const Matrix4& value)
+            {
+                _previousViewProjection = value;
+                _hasPreviousViewProjection = true;
+            }
+            inline void ResetPreviousViewProjection() { _hasPreviousViewProjection = false; }
+            // Renders into top left corner of render target, zero size covers whole target.
+            inline void SetViewport(int width, int height)
+            {
+                _viewportWidth = width;
+                _viewportHeight = height;
+            }
 
             inline bool GetDepthWrite() const { return _depthWrite; }
+            inline bool GetDepthOnly() const { return _depthOnly; }
             inline DepthTestFunction GetDepthTestFunction() const { return _depthTestFunction; }
 
             inline bool GetBlending() const { return _blending; }
@@ -46,17 +74,47 @@ namespace OpenDemo
             inline std::shared_ptr<RenderTargetContext> GetRenderTarget() const { return _renderTargetContext; }
             inline std::shared_ptr<Shader> GetShader() const { return _shader; }
             inline RenderQuery& GetRenderQuery() const { return *_renderQuery; }
+            // Per render element transforms, resolved into model matrices after collection.
+            inline TransformBatch& GetTransformBatch() { return _transformBatch; }
+            // Optional world space bounds, one per render element. Elements outside camera frustum are dropped.
+            inline BoundingSpheres& GetBoundingSpheres() { return _boundingSpheres; }
             inline Vector3 GetLightDirection() const { return _lightDirection; }
+            // Point lights collected with render elements, assigned to clusters by pass.
+            inline std::vector<PointLight>& GetLights() { return _lights; }
+            // Prepared for current view before SceneGraph::Collect.
+            inline LodSelector& GetLodSelector() { return _lodSelector; }
+            inline std::shared_ptr<LightClusters> GetLightClusters() const { return _lightClusters; }
+            inline uint32_t GetStaticRevision() const { return _staticRevision; }
+            inline float GetDepthBiasSlopeScale() const { return _depthBiasSlopeScale; }
+            inline float GetDepthBiasConstant() const { return _depthBiasConstant; }
+            inline bool HasPreviousViewProjection() const { return _hasPreviousViewProjection; }
+            inline const Matrix4& GetPreviousViewProjection() const { return _previousViewProjection; }
+            inline int GetViewportWidth() const { return _viewportWidth; }
+            inline int GetViewportHeight() const { return _viewportHeight; }
 
         private:
             bool _depthWrite = true;
+            bool _depthOnly = false;
             DepthTestFunction _depthTestFunction = DepthTestFunction::LEQUAL;
 
             bool _blending = false;
             BlendingDescription _blendingDescription;
 
+            int _viewportWidth = 0;
+            int _viewportHeight = 0;
+            uint32_t _staticRevision = 0;
+            float _depthBiasSlopeScale = 0.0f;
+            float _depthBiasConstant = 0.0f;
+            bool _hasPreviousViewProjection = false;
+            Matrix4 _previousViewProjection;
+
             Vector3 _lightDirection;
             std::unique_ptr<RenderQuery> _renderQuery;
+            TransformBatch _transformBatch;
+            BoundingSpheres _boundingSpheres;
+            std::vector<PointLight> _lights;
+            LodSelector _lodSelector;
+            std::shared_ptr<LightClusters> _lightClusters;
             std::shared_ptr<Camera> _camera;
             std::shared_ptr<RenderTargetContext> _renderTargetContext;
             std::shared_ptr<Shader> _shader;
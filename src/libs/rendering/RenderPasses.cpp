@@ -5,14 +5,16 @@
 #include "resource_manager/ResourceManager.hpp"
 
 #include "rendering/Camera.hpp"
+#include "rendering/Culling.hpp"
 #include "rendering/Mesh.hpp"
-#include "rendering/Primitives.hpp"
 #include "rendering/Render.hpp"
 #include "rendering/RenderContext.hpp"
 #include "rendering/RenderTarget.hpp"
 #include "rendering/RenderTargetContext.hpp"
 #include "rendering/SceneGraph.hpp"
+#include "rendering/SceneSnapshot.hpp"
 #include "rendering/Shader.hpp"
+#include "rendering/Texture.hpp"
 
 namespace OpenDemo
 {
@@ -20,22 +22,35 @@ namespace OpenDemo
 
     namespace Rendering
     {
-        RenderPassOpaque::RenderPassOpaque(Rendering::Render& render, const std::shared_ptr<RenderTargetContext>& hdrRenderTargetContext)
-            : _render(&render), _hdrRenderTargetContext(hdrRenderTargetContext), _renderContext(new RenderContext())
+        RenderPassOpaque::RenderPassOpaque(Rendering::Render& render, const std::shared_ptr<RenderTargetContext>& hdrRenderTargetContext, bool depthPrepass)
+            : _render(&render), _hdrRenderTargetContext(hdrRenderTargetContext), _renderContext(new RenderContext()), _lightClusters(new LightClusters())
         {
             auto* resourceManager = ResourceManager::Instance().get();
             _pbrShader = resourceManager->LoadShader("../../assets/shaders/pbr.shader");
 
             _renderContext->SetShader(_pbrShader);
             _renderContext->SetRenderTarget(hdrRenderTargetContext);
+            _renderContext->SetLightClusters(_lightClusters);
 
-            _renderContext->SetDepthWrite(true);
+            // Prepass depth is final, shading pass only tests against it.
+            _renderContext->SetDepthWrite(!depthPrepass);
             _renderContext->SetDepthTestFunction(LEQUAL);
 
             BlendingDescription blendingDescription(BlendingMode::ADDITIVE);
 
             _renderContext->SetBlending(false);
             _renderContext->SetBlendingDescription(blendingDescription);
+
+            if (depthPrepass)
+            {
+                _depthRenderContext.reset(new RenderContext());
+                _depthRenderContext->SetShader(resourceManager->LoadShader("../../assets/shaders/depthOnly.shader"));
+                _depthRenderContext->SetRenderTarget(hdrRenderTargetContext);
+                _depthRenderContext->SetDepthWrite(true);
+                _depthRenderContext->SetDepthTestFunction(LEQUAL);
+                _depthRenderContext->SetDepthOnly(true);
+                _depthRenderContext->SetBlending(false);
+            }
         }
 
         void RenderPassOpaque::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
@@ -43,8 +58,89 @@ namespace OpenDemo
             auto const& camera = sceneGraph->GetMainCamera();
             camera->SetAspect(1024, 768);
 
+            auto& transformBatch = _renderContext->GetTransformBatch();
+            auto& boundingSpheres = _renderContext->GetBoundingSpheres();
+            transformBatch.Clear();
+            boundingSpheres.Clear();
+            _renderContext->GetLights().clear();
+            _renderContext->GetLodSelector().SetView(*camera, getViewportHeight());
+
             sceneGraph->Collect(*_renderContext);
 
+            resolveRenderQuery(camera, transformBatch, boundingSpheres);
+        }
+
+        void RenderPassOpaque::Collect(const SceneSnapshot& snapshot)
+        {
+            ASSERT(snapshot.camera);
+            snapshot.camera->SetAspect(1024, 768);
+
+            auto& renderQuery = _renderContext->GetRenderQuery();
+            renderQuery.resize(snapshot.GetSize());
+
+            for (size_t index = 0; index < renderQuery.size(); index++)
+            {
+                renderQuery[index].mesh = snapshot.meshes[index];
+                renderQuery[index].material = snapshot.materials[index];
+            }
+
+            _renderContext->GetLights() = snapshot.lights;
+
+            resolveRenderQuery(snapshot.camera, snapshot.transforms, snapshot.bounds);
+
+            // Levels are picked after culling, so hidden objects don't pay for selection.
+            auto& lodSelector = _renderContext->GetLodSelector();
+            lodSelector.SetView(*snapshot.camera, getViewportHeight());
+
+            for (size_t index = 0; index < renderQuery.size(); index++)
+            {
+                const size_t id = snapshot.bounds.GetSize() > 0 ? _visibleElements[index] : index;
+                const auto& lodChain = snapshot.lodChains[id];
+                if (!lodChain)
+                    continue;
+
+                auto& renderElement = renderQuery[index];
+                const auto& modelMatrix = renderElement.modelMatrix;
+                const Vector3 position(modelMatrix.e03, modelMatrix.e13, modelMatrix.e23);
+                const float scale = Vector3(modelMatrix.e00, modelMatrix.e10, modelMatrix.e20).Length();
+                renderElement.mesh = lodSelector.Select(static_cast<uint32_t>(id), *lodChain, position, scale);
+            }
+        }
+
+        int RenderPassOpaque::getViewportHeight() const
+        {
+            return _renderContext->GetViewportHeight() > 0 ? _renderContext->GetViewportHeight() : _hdrRenderTargetContext->GetHeight();
+        }
+
+        void RenderPassOpaque::resolveRenderQuery(const std::shared_ptr<Camera>& camera, const TransformBatch& transforms, const BoundingSpheres& bounds)
+        {
+            auto& renderQuery = _renderContext->GetRenderQuery();
+
+            if (transforms.GetSize() > 0)
+            {
+                ASSERT(transforms.GetSize() == renderQuery.size());
+
+                std::vector<Matrix4> modelMatrices(transforms.GetSize());
+                transforms.ComputeWorldMatrices(modelMatrices.data());
+
+                for (size_t index = 0; index < renderQuery.size(); index++)
+                    renderQuery[index].modelMatrix = modelMatrices[index];
+            }
+
+            if (bounds.GetSize() > 0)
+            {
+                ASSERT(bounds.GetSize() == renderQuery.size());
+
+                CullSpheres(camera->GetFrustum(), bounds, _visibleElements);
+
+                // Visible indices are ascending, so compaction is done in place.
+                for (size_t index = 0; index < _visibleElements.size(); index++)
+                    if (_visibleElements[index] != index)
+                        renderQuery[index] = std::move(renderQuery[_visibleElements[index]]);
+
+                renderQuery.resize(_visibleElements.size());
+            }
+
             _renderContext->SetCamera(camera);
         }
 
@@ -71,19 +167,233 @@ namespace OpenDemo
 
             _renderContext->SetLightDirection(lightDirection);
 
-            _render->Begin(_renderContext);
+            // Clusters are built against final projection, so aspect Begin would set is applied upfront.
+            const auto& camera = _renderContext->GetCamera();
+            const int viewportWidth = _renderContext->GetViewportWidth() > 0 ? _renderContext->GetViewportWidth() : _hdrRenderTargetContext->GetWidth();
+            const int viewportHeight = getViewportHeight();
+            camera->SetAspect(viewportWidth, viewportHeight);
+            // Pixel offset into NDC, which spans two units across viewport.
+            camera->SetJitter(Vector2(2.0f * _jitter.x / viewportWidth, 2.0f * _jitter.y / viewportHeight));
 
-            _render->ClearDepthStencil(true);
-            _render->Clear(Vector4(0.0, 0.0, 0.0, 0), 1.0);
-            //render->Clear(Vector4(0.25, 0.25, 0.25, 0), 1.0);
+            _lightClusters->Build(*camera, _renderContext->GetLights());
 
-            const auto& renderQuery = _renderContext->GetRenderQuery();
-            for (const auto& item : renderQuery)
+            if (_depthRenderContext)
             {
-                _render->DrawElement(item);
+                _depthRenderContext->SetCamera(camera);
+                _depthRenderContext->SetViewport(_renderContext->GetViewportWidth(), _renderContext->GetViewportHeight());
+
+                _render->Begin(_depthRenderContext);
+                _render->ClearDepthStencil(1.0f);
+                _render->DrawElements(_renderContext->GetRenderQuery());
+                _render->End();
             }
 
+            _render->Begin(_renderContext);
+
+            if (_depthRenderContext)
+            {
+                _render->ClearColor(Vector4(0.0, 0.0, 0.0, 0));
+            }
+            else
+            {
+                _render->ClearDepthStencil(true);
+                _render->Clear(Vector4(0.0, 0.0, 0.0, 0), 1.0);
+                //render->Clear(Vector4(0.25, 0.25, 0.25, 0), 1.0);
+            }
+
+            _render->DrawElements(_renderContext->GetRenderQuery());
+
             _render->End();
+
+            // Jitter isn't left on shared camera, culling and other passes see stable projection.
+            camera->SetJitter(Vector2(0.0f));
+            _jitter = Vector2(0.0f);
+            _renderContext->SetPreviousViewProjection(camera->GetUnjitteredViewProjectionMatrix());
+        }
+
+        void RenderPassOpaque::SetViewport(int width, int height)
+        {
+            _renderContext->SetViewport(width, height);
+        }
+
+        RenderPassShadows::RenderPassShadows(Rendering::Render& render, const ShadowCache::Description& description)
+            : _shadowCache(render, description), _collectContext(new RenderContext())
+        {
+        }
+
+        void RenderPassShadows::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
+        {
+            _camera = sceneGraph->GetMainCamera();
+
+            auto& transformBatch = _collectContext->GetTransformBatch();
+            transformBatch.Clear();
+            _collectContext->GetBoundingSpheres().Clear();
+            _collectContext->GetRenderQuery().clear();
+            _collectContext->GetLights().clear();
+
+            sceneGraph->Collect(*_collectContext);
+
+            _staticRevision = _collectContext->GetStaticRevision();
+            resolveCasters(transformBatch);
+        }
+
+        void RenderPassShadows::Collect(const SceneSnapshot& snapshot)
+        {
+            ASSERT(snapshot.camera);
+            _camera = snapshot.camera;
+
+            auto& renderQuery = _collectContext->GetRenderQuery();
+            renderQuery.resize(snapshot.GetSize());
+
+            for (size_t index = 0; index < renderQuery.size(); index++)
+            {
+                renderQuery[index].mesh = snapshot.meshes[index];
+                renderQuery[index].material = snapshot.materials[index];
+                renderQuery[index].isStatic = snapshot.isStatic[index] != 0;
+            }
+
+            _staticRevision = snapshot.staticRevision;
+            resolveCasters(snapshot.transforms);
+        }
+
+        void RenderPassShadows::resolveCasters(const TransformBatch& transforms)
+        {
+            auto& renderQuery = _collectContext->GetRenderQuery();
+
+            if (transforms.GetSize() > 0)
+            {
+                ASSERT(transforms.GetSize() == renderQuery.size());
+
+                std::vector<Matrix4> modelMatrices(transforms.GetSize());
+                transforms.ComputeWorldMatrices(modelMatrices.data());
+
+                for (size_t index = 0; index < renderQuery.size(); index++)
+                    renderQuery[index].modelMatrix = modelMatrices[index];
+            }
+
+            _staticCasters.clear();
+            _dynamicCasters.clear();
+
+            for (const auto& renderElement : renderQuery)
+                (renderElement.isStatic ? _staticCasters : _dynamicCasters).push_back(renderElement);
+        }
+
+        void RenderPassShadows::Draw()
+        {
+            ASSERT(_camera);
+            _shadowCache.Update(*_camera, _lightDirection, _spotLights, _staticRevision, _staticCasters, _dynamicCasters);
+        }
+
+        RenderPassDepthPyramid::RenderPassDepthPyramid(Rendering::Render& render, const std::shared_ptr<Texture2D>& depthTexture, const std::shared_ptr<Texture2D>& depthPyramid)
+            : _render(&render), _depthTexture(depthTexture), _depthPyramid(depthPyramid)
+        {
+            auto* resourceManager = ResourceManager::Instance().get();
+            _reduceShader = resourceManager->LoadShader("../../assets/shaders/depthPyramid.shader");
+        }
+
+        void RenderPassDepthPyramid::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
+        {
+            (void)sceneGraph;
+        }
+
+        void RenderPassDepthPyramid::Draw()
+        {
+            int sourceWidth = _depthTexture->GetWidth();
+            int sourceHeight = _depthTexture->GetHeight();
+
+            // First mip is copy of depth, every next one keeps max depth of 2x2 texels of previous mip.
+            for (int level = 0; level < _depthPyramid->GetMipLevels(); level++)
+            {
+                const auto& source = (level == 0) ? _depthTexture : _depthPyramid;
+                const Vector4 params(level == 0 ? 0.0f : 1.0f, static_cast<float>(sourceWidth - 1), static_cast<float>(sourceHeight - 1), 0.0f);
+
+                _render->Blit(source, Max(0, level - 1), _depthPyramid, level, _reduceShader, params, false);
+
+                sourceWidth = Max(1, _depthPyramid->GetWidth() >> level);
+                sourceHeight = Max(1, _depthPyramid->GetHeight() >> level);
+            }
+        }
+
+        RenderPassTemporalUpscale::RenderPassTemporalUpscale(Rendering::Render& render, const std::shared_ptr<Texture2D>& hdrTexture,
+                                                             const std::shared_ptr<Texture2D>& motionTexture, PixelFormat historyFormat)
+            : _render(&render), _hdrTexture(hdrTexture), _motionTexture(motionTexture), _historyFormat(historyFormat)
+        {
+            _resolveShader = ResourceManager::Instance()->LoadShader("../../assets/shaders/temporalResolve.shader");
+
+            SetDescription(Description());
+        }
+
+        void RenderPassTemporalUpscale::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
+        {
+            (void)sceneGraph;
+        }
+
+        void RenderPassTemporalUpscale::SetDescription(const Description& description)
+        {
+            ASSERT(description.renderScale > 0.0f && description.renderScale <= 1.0f);
+            ASSERT(description.currentWeight > 0.0f && description.currentWeight <= 1.0f);
+            ASSERT(description.jitterPhases > 0);
+
+            _description = description;
+        }
+
+        Vector2 RenderPassTemporalUpscale::NextJitter()
+        {
+            _jitter = Camera::GetHaltonJitter(_frameIndex++, _description.jitterPhases);
+            return _jitter;
+        }
+
+        void RenderPassTemporalUpscale::SetViewport(int sourceWidth, int sourceHeight, int outputWidth, int outputHeight)
+        {
+            ASSERT(sourceWidth > 0 && sourceWidth <= _hdrTexture->GetWidth());
+            ASSERT(sourceHeight > 0 && sourceHeight <= _hdrTexture->GetHeight());
+
+            _sourceWidth = sourceWidth;
+            _sourceHeight = sourceHeight;
+
+            if (_history[0] && _history[0]->GetWidth() == outputWidth && _history[0]->GetHeight() == outputHeight)
+                return;
+
+            Texture2D::Description description;
+            description.width = outputWidth;
+            description.height = outputHeight;
+            description.pixelFormat = _historyFormat;
+
+            for (auto& history : _history)
+            {
+                if (!history)
+                    history = _render->CreateTexture2D();
+
+                history->Init(description, nullptr);
+            }
+
+            _historyValid = false;
+        }
+
+        void RenderPassTemporalUpscale::Draw()
+        {
+            ASSERT(_history[0]);
+
+            const auto& history = _history[_historyIndex];
+            _historyIndex ^= 1;
+            const auto& output = _history[_historyIndex];
+
+            const float textureWidth = static_cast<float>(_hdrTexture->GetWidth());
+            const float textureHeight = static_cast<float>(_hdrTexture->GetHeight());
+
+            // Same clamp to center of last rendered texel as post process upscale.
+            _resolveShader->Bind();
+            _resolveShader->SetParam(Uniform::UV_SCALE, Vector4(_sourceWidth / textureWidth, _sourceHeight / textureHeight,
+                                                                (_sourceWidth - 0.5f) / textureWidth, (_sourceHeight - 0.5f) / textureHeight));
+
+            history->Bind(Sampler::HISTORY);
+            _motionTexture->Bind(Sampler::MOTION);
+
+            // Without valid history current frame is taken as is.
+            const Vector4 params(_jitter.x / _sourceWidth, _jitter.y / _sourceHeight, _historyValid ? _description.currentWeight : 1.0f, 0.0f);
+            _render->Blit(_hdrTexture, 0, output, 0, _resolveShader, params, false);
+
+            _historyValid = true;
         }
 
         RenderPassPostProcess::RenderPassPostProcess(Rendering::Render& render, const std::shared_ptr<Texture2D>& hdrTexture)
@@ -92,12 +402,14 @@ namespace OpenDemo
             (void)render;
             auto* resourceManager = ResourceManager::Instance().get();
             _postProcessShader = resourceManager->LoadShader("../../assets/shaders/postProcess.shader");
+            _bloomDownsampleShader = resourceManager->LoadShader("../../assets/shaders/bloomDownsample.shader");
+            _bloomUpsampleShader = resourceManager->LoadShader("../../assets/shaders/bloomUpsample.shader");
 
             _renderContext->SetShader(_postProcessShader);
             _renderContext->SetDepthWrite(false);
             _renderContext->SetDepthTestFunction(DepthTestFunction::ALWAYS);
 
-            _fullScreenQuad = Primitives::GetFullScreenQuad();
+            SetDescription(Description());
         }
 
         void RenderPassPostProcess::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
@@ -105,14 +417,85 @@ namespace OpenDemo
             (void)sceneGraph;
         }
 
+        void RenderPassPostProcess::SetDescription(const Description& description)
+        {
+            ASSERT(description.bloomMips >= 0);
+            _description = description;
+
+            const auto bloomFormat = _render->IsRenderTargetFormatSupported(description.bloomFormat) ? description.bloomFormat : PixelFormat::RGBA16F;
+            if (bloomFormat != _bloomFormat)
+            {
+                _bloomFormat = bloomFormat;
+                _bloomTexture.reset();
+            }
+        }
+
+        void RenderPassPostProcess::drawBloom()
+        {
+            const int width = Max(1, _hdrTexture->GetWidth() / 2);
+            const int height = Max(1, _hdrTexture->GetHeight() / 2);
+
+            int mipLevels = 1;
+            while (mipLevels < _description.bloomMips && (Min(width, height) >> mipLevels) > 0)
+                mipLevels++;
+
+            if (!_bloomTexture || _bloomTexture->GetWidth() != width || _bloomTexture->GetHeight() != height || _bloomTexture->GetMipLevels() != mipLevels)
+            {
+                Texture2D::Description description;
+                description.width = width;
+                description.height = height;
+                description.pixelFormat = _bloomFormat;
+                description.mipLevels = mipLevels;
+
+                if (!_bloomTexture)
+                    _bloomTexture = _render->CreateTexture2D();
+
+                _bloomTexture->Init(description, nullptr);
+            }
+
+            // First downsample stretches rendered region of hdr texture over whole bloom texture.
+            _render->Blit(_hdrTexture, 0, _bloomTexture, 0, _bloomDownsampleShader, _uvScale, false);
+
+            for (int level = 1; level < mipLevels; level++)
+                _render->Blit(_bloomTexture, level - 1, _bloomTexture, level, _bloomDownsampleShader, Vector4(1.0f, 1.0f, 1.0f, 1.0f), false);
+
+            for (int level = mipLevels - 2; level >= 0; level--)
+                _render->Blit(_bloomTexture, level + 1, _bloomTexture, level, _bloomUpsampleShader, Vector4(_description.bloomRadius, 0.0f, 0.0f, 0.0f), true);
+        }
+
         void RenderPassPostProcess::Draw()
         {
+            const bool bloom = _description.bloomMips > 0 && _description.bloomIntensity > 0.0f;
+
+            if (bloom)
+                drawBloom();
+
             _render->Begin(_renderContext);
-            _hdrTexture->Bind(0);
+            _postProcessShader->SetParam(Uniform::UV_SCALE, _uvScale);
+            _postProcessShader->SetParam(Uniform::POST_PARAMS, Vector4(bloom ? _description.bloomIntensity : 0.0f, _description.exposure,
+                                                                       _description.dither, _description.tonemap ? 1.0f : 0.0f));
+            _postProcessShader->SetParam(Uniform::COLOR_GRADING, Vector4(_description.tint, _description.saturation));
+            _hdrTexture->Bind(Sampler::ALBEDO);
 
-            _fullScreenQuad->Draw();
+            if (bloom)
+                _bloomTexture->Bind(Sampler::BLOOM);
+
+            _render->DrawFullScreenTriangle();
 
             _render->End();
         }
+
+        void RenderPassPostProcess::SetSourceViewport(int width, int height)
+        {
+            const float textureWidth = static_cast<float>(_hdrTexture->GetWidth());
+            const float textureHeight = static_cast<float>(_hdrTexture->GetHeight());
+
+            ASSERT(width > 0 && width <= _hdrTexture->GetWidth());
+            ASSERT(height > 0 && height <= _hdrTexture->GetHeight());
+
+            // Clamp to center of last rendered texel.
+            _uvScale = Vector4(width / textureWidth, height / textureHeight,
+                               (width - 0.5f) / textureWidth, (height - 0.5f) / textureHeight);
+        }
     }
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "rendering/RenderContext.hpp"
+#include "rendering/Shadows.hpp"
 
+#include <array>
 #include <tuple>
 
 namespace OpenDemo
@@ -10,10 +12,10 @@ namespace OpenDemo
     {
         class Render;
         class SceneGraph;
+        struct SceneSnapshot;
         class Shader;
         class Texture2D;
         class RenderContext;
-        class Mesh;
 
         enum class RenderPassType
         {
@@ -31,32 +33,185 @@ namespace OpenDemo
         class RenderPassOpaque final : public RenderPass
         {
         public:
-            RenderPassOpaque(Rendering::Render& render, const std::shared_ptr<RenderTargetContext>& hdrRenderTargetContext);
+            // Depth prepass lays down depth first, so heavy shading runs only for visible fragments.
+            RenderPassOpaque(Rendering::Render& render, const std::shared_ptr<RenderTargetContext>& hdrRenderTargetContext, bool depthPrepass);
 
             virtual void Collect(const std::shared_ptr<SceneGraph>& sceneGraph) override;
+            // Reads snapshot arrays directly instead of collecting live scene.
+            void Collect(const SceneSnapshot& snapshot);
             virtual void Draw() override;
 
+            // Scene is rendered into top left corner of hdr target of that size.
+            void SetViewport(int width, int height);
+            // Subpixel offset of projection in pixels, applied for single frame and reset after drawing.
+            inline void SetJitter(const Vector2& pixelOffset) { _jitter = pixelOffset; }
+            inline void SetLodSelection(const LodSelector::Description& description) { _renderContext->GetLodSelector().SetDescription(description); }
+
+        private:
+            void resolveRenderQuery(const std::shared_ptr<Camera>& camera, const TransformBatch& transforms, const BoundingSpheres& bounds);
+            int getViewportHeight() const;
+
         private:
             Render* _render;
             std::shared_ptr<RenderTargetContext> _hdrRenderTargetContext;
             std::shared_ptr<RenderContext> _renderContext;
+            // Null without depth prepass.
+            std::shared_ptr<RenderContext> _depthRenderContext;
             std::shared_ptr<Shader> _pbrShader;
+            std::shared_ptr<LightClusters> _lightClusters;
+            std::vector<uint32_t> _visibleElements;
+            Vector2 _jitter = Vector2(0.0f);
+        };
+
+        // Renders shadow maps of static and dynamic casters through shadow cache. Casters aren't culled by main camera,
+        // since elements outside of view still cast into it.
+        class RenderPassShadows final : public RenderPass
+        {
+        public:
+            RenderPassShadows(Rendering::Render& render, const ShadowCache::Description& description);
+
+            virtual void Collect(const std::shared_ptr<SceneGraph>& sceneGraph) override;
+            void Collect(const SceneSnapshot& snapshot);
+            virtual void Draw() override;
+
+            // Direction from light into scene, zero disables cascades.
+            inline void SetDirectionalLight(const Vector3& direction) { _lightDirection = direction; }
+            inline void SetSpotLights(const std::vector<SpotShadowDescription>& spotLights) { _spotLights = spotLights; }
+
+            inline const ShadowCache& GetShadowCache() const { return _shadowCache; }
+
+        private:
+            void resolveCasters(const TransformBatch& transforms);
+
+        private:
+            ShadowCache _shadowCache;
+            std::shared_ptr<RenderContext> _collectContext;
+            std::shared_ptr<Camera> _camera;
+            uint32_t _staticRevision = 0;
+            Vector3 _lightDirection = Vector3(0, 0, 0);
+            std::vector<SpotShadowDescription> _spotLights;
+            std::vector<RenderElement> _staticCasters;
+            std::vector<RenderElement> _dynamicCasters;
+        };
+
+        // Builds max depth mip pyramid of scene depth for occlusion culling and screen space effects.
+        class RenderPassDepthPyramid final : public RenderPass
+        {
+        public:
+            RenderPassDepthPyramid(Rendering::Render& render, const std::shared_ptr<Texture2D>& depthTexture, const std::shared_ptr<Texture2D>& depthPyramid);
+
+            virtual void Collect(const std::shared_ptr<SceneGraph>& sceneGraph) override;
+            virtual void Draw() override;
+
+        private:
+            Render* _render;
+            std::shared_ptr<Texture2D> _depthTexture;
+            std::shared_ptr<Texture2D> _depthPyramid;
+            std::shared_ptr<Shader> _reduceShader;
         };
 
+        // Accumulates jittered frames rendered at reduced resolution into output sized history, so internal resolution
+        // drops without losing detail. History is reprojected with motion vectors of opaque pass and clamped to color
+        // range of current frame neighborhood, which rejects disoccluded and shaded differently texels.
+        class RenderPassTemporalUpscale final : public RenderPass
+        {
+        public:
+            struct Description
+            {
+                // Internal resolution relative to output, applied on top of dynamic resolution.
+                float renderScale = 0.67f;
+                // Weight of current frame in resolved color, lower accumulates more frames but reacts slower.
+                float currentWeight = 0.1f;
+                // Length of Halton jitter sequence.
+                uint32_t jitterPhases = 8;
+            };
+
+        public:
+            // History is allocated in history format, motion texture holds UV offsets to previous frame.
+            RenderPassTemporalUpscale(Rendering::Render& render, const std::shared_ptr<Texture2D>& hdrTexture,
+                                      const std::shared_ptr<Texture2D>& motionTexture, PixelFormat historyFormat);
+
+            virtual void Collect(const std::shared_ptr<SceneGraph>& sceneGraph) override;
+            virtual void Draw() override;
+
+            // Rendered region of hdr and motion textures and size of resolved image. Output size change drops history.
+            void SetViewport(int sourceWidth, int sourceHeight, int outputWidth, int outputHeight);
+            // Jitter of frame about to be rendered in pixels, advances sequence.
+            Vector2 NextJitter();
+            // Next resolve ignores history, e.g. after camera cut.
+            inline void ResetHistory() { _historyValid = false; }
+
+            void SetDescription(const Description& description);
+            inline const Description& GetDescription() const { return _description; }
+            // Latest resolved frame, covers whole texture.
+            inline const std::shared_ptr<Texture2D>& GetOutput() const { return _history[_historyIndex]; }
+
+        private:
+            Render* _render;
+            Description _description;
+            std::shared_ptr<Texture2D> _hdrTexture;
+            std::shared_ptr<Texture2D> _motionTexture;
+            // Ping-pong pair, resolve reads previous output and writes the other one.
+            std::array<std::shared_ptr<Texture2D>, 2> _history;
+            uint32_t _historyIndex = 0;
+            bool _historyValid = false;
+            PixelFormat _historyFormat;
+            int _sourceWidth = 1;
+            int _sourceHeight = 1;
+            uint32_t _frameIndex = 0;
+            Vector2 _jitter = Vector2(0.0f);
+            std::shared_ptr<Shader> _resolveShader;
+        };
+
+        // Bloom is built as downsample and upsample chain over half resolution mip pyramid. Upscale, bloom composite,
+        // tonemapping, color grading and dithering run fused in single final pass into back buffer.
         class RenderPassPostProcess final : public RenderPass
         {
+        public:
+            struct Description
+            {
+                // Downsample steps of bloom chain, zero disables bloom.
+                int bloomMips = 5;
+                float bloomIntensity = 0.04f;
+                // Upsample filter radius in texels.
+                float bloomRadius = 1.0f;
+                // Falls back to RGBA16F when not renderable.
+                PixelFormat bloomFormat = PixelFormat::R11G11B10F;
+                float exposure = 1.0f;
+                bool tonemap = true;
+                Vector3 tint = Vector3(1.0f, 1.0f, 1.0f);
+                float saturation = 1.0f;
+                // Amplitude in 8 bit quantization steps, zero disables dithering.
+                float dither = 1.0f;
+            };
+
         public:
             RenderPassPostProcess(Rendering::Render& render, const std::shared_ptr<Texture2D>& hdrTexture);
 
             virtual void Collect(const std::shared_ptr<SceneGraph>& sceneGraph) override;
             virtual void Draw() override;
 
+            // Size of rendered region of hdr texture, upscaled into back buffer.
+            void SetSourceViewport(int width, int height);
+            // Replaces hdr texture, e.g. with temporal upscale output. Source viewport is set again afterwards.
+            inline void SetSourceTexture(const std::shared_ptr<Texture2D>& texture) { _hdrTexture = texture; }
+            void SetDescription(const Description& description);
+
+        private:
+            void drawBloom();
+
         private:
             Render* _render;
+            Description _description;
+            Vector4 _uvScale = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
             std::shared_ptr<Texture2D> _hdrTexture;
+            // Half resolution of hdr texture, allocated lazily and reallocated when hdr texture grows or format changes.
+            std::shared_ptr<Texture2D> _bloomTexture;
+            PixelFormat _bloomFormat = PIXEL_FORMAT_MAX;
             std::shared_ptr<RenderContext> _renderContext;
             std::shared_ptr<Shader> _postProcessShader;
-            std::shared_ptr<Mesh> _fullScreenQuad;
+            std::shared_ptr<Shader> _bloomDownsampleShader;
+            std::shared_ptr<Shader> _bloomUpsampleShader;
         };
     }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "rendering/RenderTarget.hpp"
 #include "rendering/RenderTargetContext.hpp"
+#include "rendering/SceneSnapshot.hpp"
 #include "rendering/Texture.hpp"
 
 #include "rendering/Render.hpp"
@@ -14,6 +15,26 @@ namespace OpenDemo
 {
     namespace Rendering
     {
+        namespace
+        {
+            PixelFormat selectHdrFormat(const Render& render, const RenderPipeline::Description& description)
+            {
+                if (description.hdrFormat != PIXEL_FORMAT_MAX)
+                {
+                    ASSERT(render.IsRenderTargetFormatSupported(description.hdrFormat));
+                    return description.hdrFormat;
+                }
+
+                if (!description.hdrAlpha && !description.hdrNegativeValues && render.IsRenderTargetFormatSupported(PixelFormat::R11G11B10F))
+                    return PixelFormat::R11G11B10F;
+
+                if (render.IsRenderTargetFormatSupported(PixelFormat::RGBA16F))
+                    return PixelFormat::RGBA16F;
+
+                return PixelFormat::RGBA32F;
+            }
+        }
+
         RenderPipeline::RenderPipeline(const std::shared_ptr<Windowing::Window>& window)
             : _window(window)
         {
@@ -26,13 +47,19 @@ namespace OpenDemo
         }
 
         void RenderPipeline::Init()
+        {
+            Init(Description());
+        }
+
+        void RenderPipeline::Init(const Description& description)
         {
             const auto& render = Render::Instance();
 
             Texture2D::Description textureDescription;
             textureDescription.height = _window->GetHeight();
             textureDescription.width = _window->GetWidth();
-            textureDescription.pixelFormat = PixelFormat::RGBA32F;
+            const auto hdrFormat = selectHdrFormat(*render, description);
+            textureDescription.pixelFormat = hdrFormat;
 
             auto const& hdrTexture = render->CreateTexture2D();
             hdrTexture->Init(textureDescription, nullptr);
@@ -52,30 +79,184 @@ namespace OpenDemo
             _hdrRenderTargetContext->SetColorTarget(RenderTargetIndex::INDEX_0, colorTarget);
             _hdrRenderTargetContext->SetDepthStencilTarget(depthTarget);
 
+            std::shared_ptr<Texture2D> motionTexture;
+            if (description.temporalUpscale)
+            {
+                textureDescription.pixelFormat = PixelFormat::RG16F;
+                motionTexture = render->CreateTexture2D();
+                motionTexture->Init(textureDescription, nullptr);
+
+                RenderTarget::RenderTargetDescription motionTarget;
+                motionTarget.texture = motionTexture;
+                _hdrRenderTargetContext->SetColorTarget(RenderTargetIndex::INDEX_1, motionTarget);
+            }
+
             _hdrRenderTargetContext->Bind();
             render->ClearColor(Vector4(0, 0, 0, 0));
 
-            initPass<RenderPassOpaque>(*render, _hdrRenderTargetContext);
+            if (description.shadows)
+                initPass<RenderPassShadows>(*render, description.shadowCache);
+
+            initPass<RenderPassOpaque>(*render, _hdrRenderTargetContext, description.depthPrepass);
+
+            if (description.depthPyramid)
+            {
+                _depthPyramid = render->CreateTexture2D();
+                initDepthPyramid(textureDescription.width, textureDescription.height);
+                initPass<RenderPassDepthPyramid>(*render, depthTexture, _depthPyramid);
+            }
+
+            if (description.temporalUpscale)
+            {
+                initPass<RenderPassTemporalUpscale>(*render, hdrTexture, motionTexture, hdrFormat);
+                getPass<RenderPassTemporalUpscale>()->SetDescription(description.temporalUpscaleDescription);
+            }
+
             initPass<RenderPassPostProcess>(*render, hdrTexture);
+
+            _incrementalRedraw = description.incrementalRedraw;
+            // Nothing else converges over frames.
+            _settleFrames = description.temporalUpscale ? description.settleFrames : 0;
+            Invalidate();
+        }
+
+        void RenderPipeline::initDepthPyramid(int width, int height)
+        {
+            Texture2D::Description description;
+            description.width = width;
+            description.height = height;
+            description.pixelFormat = PixelFormat::R32F;
+            description.mipLevels = 1;
+
+            // Full chain down to single texel.
+            while ((Max(width, height) >> description.mipLevels) > 0)
+                description.mipLevels++;
+
+            _depthPyramid->Init(description, nullptr);
         }
 
         void RenderPipeline::Collect(const std::shared_ptr<SceneGraph>& sceneGraph)
         {
+            if (const auto shadowsPass = getPass<RenderPassShadows>())
+                shadowsPass->Collect(sceneGraph);
+
             getPass<RenderPassOpaque>()->Collect(sceneGraph);
             getPass<RenderPassPostProcess>()->Collect(sceneGraph);
+
+            // Scene graph has no change tracking.
+            Invalidate();
         }
 
-        void RenderPipeline::Draw()
+        void RenderPipeline::Collect(const SceneSnapshot& snapshot)
         {
+            if (const auto shadowsPass = getPass<RenderPassShadows>())
+                shadowsPass->Collect(snapshot);
+
+            // Post process doesn't read scene.
+            getPass<RenderPassOpaque>()->Collect(snapshot);
+
+            if (!_hasSceneRevision || snapshot.revision != _sceneRevision)
+                Invalidate();
+
+            _hasSceneRevision = true;
+            _sceneRevision = snapshot.revision;
+        }
+
+        void RenderPipeline::SetPostProcess(const RenderPassPostProcess::Description& description)
+        {
+            getPass<RenderPassPostProcess>()->SetDescription(description);
+            Invalidate();
+        }
+
+        bool RenderPipeline::shouldDraw()
+        {
+            if (!_incrementalRedraw)
+                return true;
+
+            if (_isDirty)
+            {
+                _isDirty = false;
+                _settleFramesLeft = _settleFrames;
+                return true;
+            }
+
+            if (_settleFramesLeft == 0)
+                return false;
+
+            _settleFramesLeft--;
+            return true;
+        }
+
+        bool RenderPipeline::Draw()
+        {
+            // Skipped frames don't feed dynamic resolution, their GPU time says nothing about rendering cost.
+            if (!shouldDraw())
+                return false;
+
+            _dynamicResolution.Update(Render::Instance()->GetGpuFrameTime());
+
+            const auto temporalUpscalePass = getPass<RenderPassTemporalUpscale>();
+
+            float scale = _dynamicResolution.GetScale();
+            if (temporalUpscalePass)
+                scale *= temporalUpscalePass->GetDescription().renderScale;
+
+            const int width = Clamp(static_cast<int>(_window->GetWidth() * scale + 0.5f), 1, _hdrRenderTargetContext->GetWidth());
+            const int height = Clamp(static_cast<int>(_window->GetHeight() * scale + 0.5f), 1, _hdrRenderTargetContext->GetHeight());
+
+            getPass<RenderPassOpaque>()->SetViewport(width, height);
+
+            if (temporalUpscalePass)
+            {
+                temporalUpscalePass->SetViewport(width, height, _window->GetWidth(), _window->GetHeight());
+                getPass<RenderPassOpaque>()->SetJitter(temporalUpscalePass->NextJitter());
+            }
+            else
+            {
+                getPass<RenderPassPostProcess>()->SetSourceViewport(width, height);
+            }
+
+            if (const auto shadowsPass = getPass<RenderPassShadows>())
+                shadowsPass->Draw();
+
             getPass<RenderPassOpaque>()->Draw();
+
+            if (const auto depthPyramidPass = getPass<RenderPassDepthPyramid>())
+                depthPyramidPass->Draw();
+
+            if (temporalUpscalePass)
+            {
+                temporalUpscalePass->Draw();
+
+                // Post process reads resolved frame, which already is at window resolution.
+                getPass<RenderPassPostProcess>()->SetSourceTexture(temporalUpscalePass->GetOutput());
+                getPass<RenderPassPostProcess>()->SetSourceViewport(_window->GetWidth(), _window->GetHeight());
+            }
+
             getPass<RenderPassPostProcess>()->Draw();
+
+            return true;
         }
 
         void RenderPipeline::OnWindowResize(const Windowing::Window& window_)
         {
-            int width = window_.GetWidth();
-            int height = window_.GetHeight();
-            _hdrRenderTargetContext->Resize(width, height);
+            const int width = window_.GetWidth();
+            const int height = window_.GetHeight();
+
+            // Viewport follows window size even when targets aren't reallocated.
+            Invalidate();
+
+            // Shrinking window only shrinks viewport, targets are reallocated only to grow.
+            if (width <= _hdrRenderTargetContext->GetWidth() && height <= _hdrRenderTargetContext->GetHeight())
+                return;
+
+            _hdrRenderTargetContext->Resize(Max(width, _hdrRenderTargetContext->GetWidth()),
+                                            Max(height, _hdrRenderTargetContext->GetHeight()));
+            _dynamicResolution.Reset();
+
+            // Mip count depends on size, so pyramid is reinitialized instead of resized.
+            if (_depthPyramid)
+                initDepthPyramid(_hdrRenderTargetContext->GetWidth(), _hdrRenderTargetContext->GetHeight());
         }
     }
 }
\ No newline at end of file
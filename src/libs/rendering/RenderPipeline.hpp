@@ -1,28 +1,95 @@
 #pragma once
 
-//#include "rendering/RenderPasses.hpp"
+#include "rendering/RenderPasses.hpp"
+#include "rendering/DynamicResolution.hpp"
 #include "windowing/Windowing.hpp"
 
 namespace OpenDemo
 {
     namespace Rendering
     {
+        struct SceneSnapshot;
+
         class RenderPipeline final : Windowing::IListener
         {
+        public:
+            struct Description
+            {
+                // Depth only pass before opaque shading, removes overdraw of expensive shaders.
+                bool depthPrepass = false;
+                // Max depth mip pyramid built after opaque pass, see GetDepthPyramid.
+                bool depthPyramid = false;
+                // Explicit hdr target format, PIXEL_FORMAT_MAX picks smallest supported format covering features below.
+                PixelFormat hdrFormat = PIXEL_FORMAT_MAX;
+                // Either rules out R11G11B10F.
+                bool hdrAlpha = false;
+                bool hdrNegativeValues = false;
+                // Cached shadow maps rendered before opaque pass, see GetShadows.
+                bool shadows = false;
+                ShadowCache::Description shadowCache;
+                // Opaque pass renders jittered frames at reduced resolution with motion vectors, temporal resolve
+                // accumulates them at window resolution before post process.
+                bool temporalUpscale = false;
+                RenderPassTemporalUpscale::Description temporalUpscaleDescription;
+                // Frames are rendered only after changes, e.g. for editor viewports. Scene snapshot revision, window size
+                // and settings are tracked, anything else, like UI drawn over the frame, is reported by Invalidate.
+                bool incrementalRedraw = false;
+                // Frames rendered after the last change while temporal upscale converges, should cover its jitter phases.
+                uint32_t settleFrames = 16;
+            };
+
         public:
             RenderPipeline(const std::shared_ptr<Windowing::Window>& window);
             ~RenderPipeline();
 
             void Init();
+            void Init(const Description& description);
             void Collect(const std::shared_ptr<SceneGraph>& sceneGraph);
-            void Draw();
+            void Collect(const SceneSnapshot& snapshot);
+            // Returns false when incremental redraw skipped the frame. Back buffer wasn't touched then and presenting it
+            // could show an older frame of swap chain, so present should be skipped too.
+            bool Draw();
+            // Next frame is rendered even in incremental redraw mode.
+            inline void Invalidate() { _isDirty = true; }
+
+            inline void SetDynamicResolution(const DynamicResolution::Description& description)
+            {
+                _dynamicResolution.SetDescription(description);
+                Invalidate();
+            }
+            inline const DynamicResolution& GetDynamicResolution() const { return _dynamicResolution; }
+            void SetPostProcess(const RenderPassPostProcess::Description& description);
+            inline void SetLodSelection(const LodSelector::Description& description)
+            {
+                getPass<RenderPassOpaque>()->SetLodSelection(description);
+                Invalidate();
+            }
+            // R32F texture with full mip chain, null unless enabled by Description::depthPyramid.
+            inline std::shared_ptr<Texture2D> GetDepthPyramid() const { return _depthPyramid; }
+            // Null unless enabled by Description::shadows.
+            inline RenderPassShadows* GetShadows() const { return getPass<RenderPassShadows>(); }
+            // Null unless enabled by Description::temporalUpscale.
+            inline RenderPassTemporalUpscale* GetTemporalUpscale() const { return getPass<RenderPassTemporalUpscale>(); }
 
         private:
             std::shared_ptr<Windowing::Window> _window;
+            // Allocated at max resolution, frames are rendered into scaled viewport and upscaled by post process.
             std::shared_ptr<RenderTargetContext> _hdrRenderTargetContext;
+            std::shared_ptr<Texture2D> _depthPyramid;
+            DynamicResolution _dynamicResolution;
+
+            bool _incrementalRedraw = false;
+            uint32_t _settleFrames = 0;
+            bool _isDirty = true;
+            uint32_t _settleFramesLeft = 0;
+            bool _hasSceneRevision = false;
+            uint32_t _sceneRevision = 0;
 
             std::tuple<
+                std::unique_ptr<RenderPassShadows>,
                 std::unique_ptr<RenderPassOpaque>,
+                std::unique_ptr<RenderPassDepthPyramid>,
+                std::unique_ptr<RenderPassTemporalUpscale>,
                 std::unique_ptr<RenderPassPostProcess>>
                 _renderPasses;
 
@@ -39,6 +106,10 @@ namespace OpenDemo
                 return std::get<std::unique_ptr<PassType>>(_renderPasses).get();
             }
 
+            void initDepthPyramid(int width, int height);
+            // Consumes dirty state and settle budget of incremental redraw.
+            bool shouldDraw();
+
             virtual void OnWindowResize(const Windowing::Window& window) override;
         };
     }
@@ -14,6 +14,7 @@ namespace OpenDemo
             {
                 bool isDepthTarget;
                 std::shared_ptr<CommonTexture> texture;
+                int mipLevel = 0;
             };
 
             //        virtual ~RenderTarget() {};
@@ -2,6 +2,8 @@
 
 #include "rendering/RenderTarget.hpp"
 
+#include <algorithm>
+
 namespace OpenDemo
 {
     namespace Rendering
@@ -35,14 +37,20 @@ namespace OpenDemo
 
             virtual inline void SetColorTarget(RenderTargetIndex index, const RenderTarget::RenderTargetDescription& renderTargetDescription)
             {
+                const auto& texture = renderTargetDescription.texture;
+                ASSERT(renderTargetDescription.mipLevel < texture->GetMipLevels())
+
+                const int width = std::max(1, texture->GetWidth() >> renderTargetDescription.mipLevel);
+                const int height = std::max(1, texture->GetHeight() >> renderTargetDescription.mipLevel);
+
                 if (_width == -1 && _height == -1)
                 {
-                    _width = renderTargetDescription.texture->GetWidth();
-                    _height = renderTargetDescription.texture->GetHeight();
+                    _width = width;
+                    _height = height;
                 }
 
-                ASSERT(renderTargetDescription.texture->GetHeight() == _height)
-                ASSERT(renderTargetDescription.texture->GetWidth() == _width)
+                ASSERT(height == _height)
+                ASSERT(width == _width)
 
                 _colorTargets[index] = renderTargetDescription;
             }
@@ -72,6 +80,10 @@ namespace OpenDemo
 
             virtual void Bind() = 0;
 
+        protected:
+            inline const RenderTarget::RenderTargetDescription& getDepthStencilTarget() const { return _depthStencil; }
+            inline const RenderTarget::RenderTargetDescription& getColorTarget(RenderTargetIndex index) const { return _colorTargets[index]; }
+
         private:
             int _width = -1, _height = -1;
             RenderTarget::RenderTargetDescription _depthStencil;
@@ -0,0 +1,407 @@
+#include "SceneBvh.hpp"
+
+#include "rendering/Culling.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            constexpr uint32_t BinsCount = 16;
+            // Splits past that depth fall back to median, so depth and traversal stack stay bounded.
+            constexpr uint32_t MedianSplitDepth = 48;
+
+            inline float component(const Vector3& vector, uint32_t axis)
+            {
+                return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+            }
+
+            inline Vector3 min3(const Vector3& a, const Vector3& b)
+            {
+                return Vector3(Min(a.x, b.x), Min(a.y, b.y), Min(a.z, b.z));
+            }
+
+            inline Vector3 max3(const Vector3& a, const Vector3& b)
+            {
+                return Vector3(Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z));
+            }
+
+            inline float surfaceArea(const Vector3& min, const Vector3& max)
+            {
+                const Vector3 extent = max - min;
+                return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+            }
+
+            struct Bin
+            {
+                Vector3 min = Vector3(std::numeric_limits<float>::max());
+                Vector3 max = Vector3(-std::numeric_limits<float>::max());
+                uint32_t count = 0;
+            };
+        }
+
+        void SceneBvh::Build(const BoundingSpheres& bounds)
+        {
+            const size_t count = bounds.GetSize();
+
+            _centers.resize(count);
+            _radii.resize(count);
+            _objects.resize(count);
+
+            for (size_t index = 0; index < count; index++)
+            {
+                _centers[index] = Vector3(bounds.GetCenterX()[index], bounds.GetCenterY()[index], bounds.GetCenterZ()[index]);
+                _radii[index] = bounds.GetRadius()[index];
+                _objects[index] = static_cast<uint32_t>(index);
+            }
+
+            _nodes.resize(count > 0 ? count * 2 - 1 : 0);
+            _builtAreas.resize(_nodes.size());
+
+            if (count > 0)
+                buildNode(0, 0, static_cast<uint32_t>(count), 0);
+
+            _isDirty = false;
+        }
+
+        void SceneBvh::Update(uint32_t object, const Vector3& center, float radius)
+        {
+            ASSERT(object < _centers.size());
+
+            _centers[object] = center;
+            _radii[object] = radius;
+            _isDirty = true;
+        }
+
+        void SceneBvh::buildNode(uint32_t node, uint32_t first, uint32_t count, uint32_t depth)
+        {
+            ASSERT(depth < MaxDepth);
+
+            Vector3 centroidMin(std::numeric_limits<float>::max());
+            Vector3 centroidMax(-std::numeric_limits<float>::max());
+
+            for (uint32_t index = first; index < first + count; index++)
+            {
+                const auto& center = _centers[_objects[index]];
+                centroidMin = min3(centroidMin, center);
+                centroidMax = max3(centroidMax, center);
+            }
+
+            auto& bvhNode = _nodes[node];
+            bvhNode.first = first;
+            bvhNode.count = count;
+
+            if (count == 1)
+            {
+                refitNode(node);
+                _builtAreas[node] = surfaceArea(bvhNode.min, bvhNode.max);
+                return;
+            }
+
+            const Vector3 centroidExtent = centroidMax - centroidMin;
+            uint32_t axis = centroidExtent.x > centroidExtent.y ? 0 : 1;
+            if (centroidExtent.z > component(centroidExtent, axis))
+                axis = 2;
+
+            const float extent = component(centroidExtent, axis);
+            const float origin = component(centroidMin, axis);
+            const auto begin = _objects.begin() + first;
+            const auto end = begin + count;
+
+            uint32_t leftCount = 0;
+
+            if (extent > 0.0f && depth < MedianSplitDepth)
+            {
+                const float binScale = BinsCount / extent;
+                const auto binIndex = [&](uint32_t object) {
+                    return Min(static_cast<uint32_t>((component(_centers[object], axis) - origin) * binScale), BinsCount - 1);
+                };
+
+                std::array<Bin, BinsCount> bins;
+                for (auto it = begin; it != end; ++it)
+                {
+                    const float radius = Max(_radii[*it], 0.0f);
+                    auto& bin = bins[binIndex(*it)];
+                    bin.min = min3(bin.min, _centers[*it] - Vector3(radius));
+                    bin.max = max3(bin.max, _centers[*it] + Vector3(radius));
+                    bin.count++;
+                }
+
+                // Cost of split before bin is area weighted count of both sides.
+                std::array<float, BinsCount> leftCosts;
+                Bin accumulated;
+                for (uint32_t split = 1; split < BinsCount; split++)
+                {
+                    const auto& bin = bins[split - 1];
+                    accumulated.min = min3(accumulated.min, bin.min);
+                    accumulated.max = max3(accumulated.max, bin.max);
+                    accumulated.count += bin.count;
+                    leftCosts[split] = accumulated.count > 0 ? surfaceArea(accumulated.min, accumulated.max) * accumulated.count : 0.0f;
+                }
+
+                float bestCost = std::numeric_limits<float>::max();
+                uint32_t bestSplit = 0;
+                accumulated = Bin();
+                for (uint32_t split = BinsCount - 1; split > 0; split--)
+                {
+                    const auto& bin = bins[split];
+                    accumulated.min = min3(accumulated.min, bin.min);
+                    accumulated.max = max3(accumulated.max, bin.max);
+                    accumulated.count += bin.count;
+
+                    const float rightCost = accumulated.count > 0 ? surfaceArea(accumulated.min, accumulated.max) * accumulated.count : 0.0f;
+                    if (leftCosts[split] + rightCost < bestCost)
+                    {
+                        bestCost = leftCosts[split] + rightCost;
+                        bestSplit = split;
+                    }
+                }
+
+                const auto middle = std::partition(begin, end, [&](uint32_t object) { return binIndex(object) < bestSplit; });
+                leftCount = static_cast<uint32_t>(middle - begin);
+            }
+
+            if (leftCount == 0 || leftCount == count)
+            {
+                leftCount = count / 2;
+                std::nth_element(begin, begin + leftCount, end, [&](uint32_t a, uint32_t b) {
+                    return component(_centers[a], axis) < component(_centers[b], axis);
+                });
+            }
+
+            buildNode(node + 1, first, leftCount, depth + 1);
+            buildNode(node + 2 * leftCount, first + leftCount, count - leftCount, depth + 1);
+
+            refitNode(node);
+            _builtAreas[node] = surfaceArea(bvhNode.min, bvhNode.max);
+        }
+
+        void SceneBvh::refitNode(uint32_t node)
+        {
+            auto& bvhNode = _nodes[node];
+
+            if (bvhNode.count == 1)
+            {
+                const uint32_t object = _objects[bvhNode.first];
+                const float radius = Max(_radii[object], 0.0f);
+                bvhNode.min = _centers[object] - Vector3(radius);
+                bvhNode.max = _centers[object] + Vector3(radius);
+                return;
+            }
+
+            const auto& left = _nodes[node + 1];
+            const auto& right = _nodes[getRightChild(node)];
+            bvhNode.min = min3(left.min, right.min);
+            bvhNode.max = max3(left.max, right.max);
+        }
+
+        void SceneBvh::Refit(uint32_t maxRebuildObjects)
+        {
+            if (!_isDirty)
+                return;
+
+            _isDirty = false;
+
+            // Children follow their parents, so reverse order refits bottom up.
+            for (size_t node = _nodes.size(); node-- > 0;)
+                refitNode(static_cast<uint32_t>(node));
+
+            if (_nodes.empty())
+                return;
+
+            // Topmost degraded subtrees are rebuilt, the ones over budget are searched for smaller degraded subtrees.
+            // Rebuilt subtree keeps its objects, so bounds of nodes above stay valid.
+            std::array<std::pair<uint32_t, uint32_t>, MaxDepth * 2> stack;
+            uint32_t stackSize = 0;
+            stack[stackSize++] = { 0, 0 };
+
+            while (stackSize > 0)
+            {
+                const auto [node, depth] = stack[--stackSize];
+                const auto& bvhNode = _nodes[node];
+
+                if (bvhNode.count == 1)
+                    continue;
+
+                if (surfaceArea(bvhNode.min, bvhNode.max) > _builtAreas[node] * _rebuildAreaRatio && bvhNode.count <= maxRebuildObjects)
+                {
+                    maxRebuildObjects -= bvhNode.count;
+                    buildNode(node, bvhNode.first, bvhNode.count, depth);
+                    continue;
+                }
+
+                stack[stackSize++] = { getRightChild(node), depth + 1 };
+                stack[stackSize++] = { node + 1, depth + 1 };
+            }
+        }
+
+        void SceneBvh::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const
+        {
+            if (_nodes.empty())
+                return;
+
+            std::array<uint32_t, MaxDepth * 2> stack;
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const uint32_t node = stack[--stackSize];
+                const auto& bvhNode = _nodes[node];
+
+                bool isOutside = false;
+                bool isIntersecting = false;
+                for (const auto& plane : frustum.planes)
+                {
+                    // Box corners farthest along and against plane normal.
+                    const Vector3 positive(plane.x > 0.0f ? bvhNode.max.x : bvhNode.min.x, plane.y > 0.0f ? bvhNode.max.y : bvhNode.min.y, plane.z > 0.0f ? bvhNode.max.z : bvhNode.min.z);
+                    const Vector3 negative(plane.x > 0.0f ? bvhNode.min.x : bvhNode.max.x, plane.y > 0.0f ? bvhNode.min.y : bvhNode.max.y, plane.z > 0.0f ? bvhNode.min.z : bvhNode.max.z);
+
+                    if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f)
+                    {
+                        isOutside = true;
+                        break;
+                    }
+
+                    if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f)
+                        isIntersecting = true;
+                }
+
+                if (isOutside)
+                    continue;
+
+                if (!isIntersecting || bvhNode.count == 1)
+                {
+                    // Subtree objects are contiguous, so fully visible subtree is appended without descending.
+                    for (uint32_t index = bvhNode.first; index < bvhNode.first + bvhNode.count; index++)
+                    {
+                        const uint32_t object = _objects[index];
+                        if (_radii[object] < 0.0f)
+                            continue;
+
+                        if (isIntersecting && !frustum.IsVisible(_centers[object], _radii[object]))
+                            continue;
+
+                        result.push_back(object);
+                    }
+                    continue;
+                }
+
+                stack[stackSize++] = getRightChild(node);
+                stack[stackSize++] = node + 1;
+            }
+        }
+
+        void SceneBvh::QuerySphere(const Vector3& center, float radius, std::vector<uint32_t>& result) const
+        {
+            if (_nodes.empty())
+                return;
+
+            std::array<uint32_t, MaxDepth * 2> stack;
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const uint32_t node = stack[--stackSize];
+                const auto& bvhNode = _nodes[node];
+
+                const Vector3 closest = min3(max3(center, bvhNode.min), bvhNode.max);
+                const Vector3 offset = closest - center;
+                if (offset.Dot(offset) > radius * radius)
+                    continue;
+
+                if (bvhNode.count == 1)
+                {
+                    const uint32_t object = _objects[bvhNode.first];
+                    const float objectRadius = _radii[object];
+                    const Vector3 distance = _centers[object] - center;
+
+                    if (objectRadius >= 0.0f && distance.Dot(distance) <= (radius + objectRadius) * (radius + objectRadius))
+                        result.push_back(object);
+                    continue;
+                }
+
+                stack[stackSize++] = getRightChild(node);
+                stack[stackSize++] = node + 1;
+            }
+        }
+
+        bool SceneBvh::Raycast(const Vector3& origin, const Vector3& direction, float maxDistance, RayHit& hit) const
+        {
+            if (_nodes.empty())
+                return false;
+
+            const Vector3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+            // Entry distance of ray into box, or max float when box is missed or farther than closest hit.
+            const auto intersectBox = [&](const Node& bvhNode, float closest) {
+                const Vector3 t0 = (bvhNode.min - origin) * inverseDirection;
+                const Vector3 t1 = (bvhNode.max - origin) * inverseDirection;
+                const Vector3 tMin = min3(t0, t1);
+                const Vector3 tMax = max3(t0, t1);
+
+                const float entry = Max(Max(tMin.x, tMin.y), Max(tMin.z, 0.0f));
+                const float exit = Min(Min(tMax.x, tMax.y), Min(tMax.z, closest));
+                return entry <= exit ? entry : std::numeric_limits<float>::max();
+            };
+
+            float closest = maxDistance;
+            bool isHit = false;
+
+            std::array<uint32_t, MaxDepth * 2> stack;
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+
+            while (stackSize > 0)
+            {
+                const uint32_t node = stack[--stackSize];
+                const auto& bvhNode = _nodes[node];
+
+                if (intersectBox(bvhNode, closest) == std::numeric_limits<float>::max())
+                    continue;
+
+                if (bvhNode.count == 1)
+                {
+                    const uint32_t object = _objects[bvhNode.first];
+                    const float radius = _radii[object];
+                    if (radius < 0.0f)
+                        continue;
+
+                    const Vector3 offset = origin - _centers[object];
+                    const float b = offset.Dot(direction);
+                    const float c = offset.Dot(offset) - radius * radius;
+                    const float discriminant = b * b - c;
+                    if (discriminant < 0.0f || (c > 0.0f && b > 0.0f))
+                        continue;
+
+                    // Origin inside of sphere hits it at zero distance.
+                    const float distance = Max(-b - sqrtf(discriminant), 0.0f);
+                    if (distance <= closest)
+                    {
+                        closest = distance;
+                        hit = { object, distance };
+                        isHit = true;
+                    }
+                    continue;
+                }
+
+                // Nearer child is visited first, so farther one is likely pruned by closest hit.
+                uint32_t nearChild = node + 1;
+                uint32_t farChild = getRightChild(node);
+                if (intersectBox(_nodes[nearChild], closest) > intersectBox(_nodes[farChild], closest))
+                    std::swap(nearChild, farChild);
+
+                stack[stackSize++] = farChild;
+                stack[stackSize++] = nearChild;
+            }
+
+            return isHit;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class BoundingSpheres;
+        struct Frustum;
+
+        // Bounding volume hierarchy over object bounding spheres. Built with binned SAH into depth first node array, where
+        // left child directly follows its parent and every subtree owns contiguous range of nodes and objects. Moved objects
+        // are refitted, subtrees whose surface area degraded too much are rebuilt in place within per call budget.
+        class SceneBvh final
+        {
+        public:
+            struct RayHit
+            {
+                uint32_t object;
+                float distance;
+            };
+
+        public:
+            // Object ids are indices of spheres, negative radius hides object from queries.
+            void Build(const BoundingSpheres& bounds);
+            void Update(uint32_t object, const Vector3& center, float radius);
+            // Applies updates since last call, rebuilds at most maxRebuildObjects objects worth of subtrees.
+            void Refit(uint32_t maxRebuildObjects = 1024);
+
+            // Subtree is rebuilt once its surface area exceeds area at build time by that factor.
+            inline void SetRebuildAreaRatio(float value) { _rebuildAreaRatio = value; }
+
+            // Results are appended in no particular order.
+            void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+            void QuerySphere(const Vector3& center, float radius, std::vector<uint32_t>& result) const;
+            // Closest object whose bounding sphere is hit by ray, direction should be normalized.
+            bool Raycast(const Vector3& origin, const Vector3& direction, float maxDistance, RayHit& hit) const;
+
+            inline size_t GetObjectsCount() const { return _centers.size(); }
+            // Including updates not refitted yet.
+            inline const Vector3& GetCenter(uint32_t object) const { return _centers[object]; }
+            inline size_t GetNodesCount() const { return _nodes.size(); }
+
+        private:
+            // Single object per leaf, so subtree of n objects always takes 2n - 1 nodes and right child is found from left one.
+            struct Node
+            {
+                Vector3 min;
+                uint32_t first;
+                Vector3 max;
+                uint32_t count;
+            };
+
+            static constexpr uint32_t MaxDepth = 96;
+
+            inline uint32_t getRightChild(uint32_t node) const { return node + 2 * _nodes[node + 1].count; }
+
+            void buildNode(uint32_t node, uint32_t first, uint32_t count, uint32_t depth);
+            void refitNode(uint32_t node);
+            void rebuildSubtree(uint32_t node);
+
+        private:
+            std::vector<Node> _nodes;
+            // Surface area of each node at build time.
+            std::vector<float> _builtAreas;
+            std::vector<uint32_t> _objects;
+            std::vector<Vector3> _centers;
+            std::vector<float> _radii;
+            bool _isDirty = false;
+            float _rebuildAreaRatio = 1.5f;
+        };
+    }
+}
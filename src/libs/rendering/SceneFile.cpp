@@ -0,0 +1,117 @@
+#include "SceneFile.hpp"
+
+#include <cstring>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            // Floats and indices are four bytes.
+            inline size_t getElementSize(SceneFile::Block block)
+            {
+                return block == SceneFile::StaticFlags ? sizeof(uint8_t) : sizeof(uint32_t);
+            }
+        }
+
+        size_t SceneFile::getBlockSize(Block block, size_t objectsCount)
+        {
+            const size_t paddedCount = (objectsCount + Padding - 1) / Padding * Padding;
+            return paddedCount * getElementSize(block);
+        }
+
+        void SceneFile::Serialize(const Description& description, std::vector<uint8_t>& blob)
+        {
+            ASSERT(description.transforms);
+            ASSERT(description.bounds);
+            ASSERT(description.transforms->GetSize() == description.bounds->GetSize());
+
+            const size_t objectsCount = description.transforms->GetSize();
+            ASSERT((description.meshIndices && description.materialIndices) || objectsCount == 0);
+
+            const void* sources[BlocksCount] = {};
+            for (uint32_t component = 0; component < TransformBatch::Component::Count; component++)
+                sources[Transforms + component] = description.transforms->GetComponent(static_cast<TransformBatch::Component>(component));
+
+            sources[BoundCenterX] = description.bounds->GetCenterX();
+            sources[BoundCenterY] = description.bounds->GetCenterY();
+            sources[BoundCenterZ] = description.bounds->GetCenterZ();
+            sources[BoundRadius] = description.bounds->GetRadius();
+            sources[MeshIndices] = description.meshIndices;
+            sources[MaterialIndices] = description.materialIndices;
+            sources[StaticFlags] = description.isStatic;
+
+            Header header = {};
+            header.magic = Magic;
+            header.version = Version;
+            header.objectsCount = objectsCount;
+
+            blob.assign(sizeof(Header), 0);
+            for (uint32_t block = 0; block < BlocksCount; block++)
+            {
+                blob.resize(AlignTo(blob.size(), BlockAlignment), 0);
+                header.blockOffsets[block] = blob.size();
+
+                // Transforms and bounds are already padded, index blocks are padded with zeros here.
+                const size_t blockSize = getBlockSize(static_cast<Block>(block), objectsCount);
+                const size_t sourceSize = block < MeshIndices ? blockSize : objectsCount * getElementSize(static_cast<Block>(block));
+
+                const size_t offset = blob.size();
+                blob.resize(offset + blockSize, 0);
+                if (sources[block] && objectsCount > 0)
+                    std::memcpy(blob.data() + offset, sources[block], sourceSize);
+            }
+
+            blob.resize(AlignTo(blob.size(), BlockAlignment), 0);
+            header.size = blob.size();
+            std::memcpy(blob.data(), &header, sizeof(Header));
+        }
+
+        bool SceneFile::Load(const void* data, size_t size)
+        {
+            _objectsCount = 0;
+            std::fill(std::begin(_blocks), std::end(_blocks), nullptr);
+
+            if (!data || size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % BlockAlignment != 0)
+                return false;
+
+            const auto& header = *static_cast<const Header*>(data);
+            if (header.magic != Magic || header.version != Version || header.size > size)
+                return false;
+
+            // Guards block size computation against overflow.
+            if (header.objectsCount > header.size)
+                return false;
+
+            const auto base = static_cast<const uint8_t*>(data);
+            for (uint32_t block = 0; block < BlocksCount; block++)
+            {
+                const auto offset = header.blockOffsets[block];
+                const auto blockSize = getBlockSize(static_cast<Block>(block), static_cast<size_t>(header.objectsCount));
+
+                if (offset % BlockAlignment != 0 || offset < sizeof(Header) || offset > header.size || blockSize > header.size - offset)
+                    return false;
+
+                _blocks[block] = base + offset;
+            }
+
+            _objectsCount = static_cast<size_t>(header.objectsCount);
+            return true;
+        }
+
+        void SceneFile::Attach(TransformBatch& transforms, BoundingSpheres& bounds) const
+        {
+            const float* components[TransformBatch::Component::Count];
+            for (uint32_t component = 0; component < TransformBatch::Component::Count; component++)
+                components[component] = static_cast<const float*>(_blocks[Transforms + component]);
+
+            transforms.Attach(components, _objectsCount);
+            bounds.Attach(static_cast<const float*>(_blocks[BoundCenterX]),
+                          static_cast<const float*>(_blocks[BoundCenterY]),
+                          static_cast<const float*>(_blocks[BoundCenterZ]),
+                          static_cast<const float*>(_blocks[BoundRadius]),
+                          _objectsCount);
+        }
+    }
+}
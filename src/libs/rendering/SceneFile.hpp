@@ -0,0 +1,88 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include "rendering/Culling.hpp"
+
+#include <vector>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        // Binary scene with render side structure of arrays: transforms, bounds, mesh and material indices and static flags.
+        // Blocks are stored at aligned offsets exactly as TransformBatch and BoundingSpheres keep them, so memory mapped
+        // file (FileSystem::MappedFileStream::GetMappedView) is used in place: Load validates header and fixes block offsets
+        // up into pointers, nothing is copied or parsed. Meshes and materials are indices into tables owned by application.
+        class SceneFile final
+        {
+        public:
+            static constexpr uint32_t Magic = 0x4e435352; // 'RSCN'
+            static constexpr uint32_t Version = 1;
+            static constexpr uint32_t BlockAlignment = 64;
+            // Blocks hold objects count rounded up to it, matching TransformBatch and BoundingSpheres padding.
+            static constexpr uint32_t Padding = TransformBatch::Width;
+
+            enum Block : uint32_t
+            {
+                // TransformBatch::Component::Count blocks in component order.
+                Transforms,
+                BoundCenterX = Transforms + TransformBatch::Component::Count,
+                BoundCenterY,
+                BoundCenterZ,
+                BoundRadius,
+                MeshIndices,
+                MaterialIndices,
+                // One byte per object.
+                StaticFlags,
+                BlocksCount
+            };
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint64_t size;
+                uint64_t objectsCount;
+                // Offsets from file start.
+                uint64_t blockOffsets[BlocksCount];
+            };
+
+            struct Description
+            {
+                const TransformBatch* transforms = nullptr;
+                const BoundingSpheres* bounds = nullptr;
+                const uint32_t* meshIndices = nullptr;
+                const uint32_t* materialIndices = nullptr;
+                // Optional, objects are dynamic without it.
+                const uint8_t* isStatic = nullptr;
+            };
+
+        public:
+            // Transforms and bounds should be of the same size.
+            static void Serialize(const Description& description, std::vector<uint8_t>& blob);
+
+            // Returns false for malformed data. Data should be aligned to BlockAlignment, which holds for mapped views,
+            // and stay alive while scene or batches attached to it are used.
+            bool Load(const void* data, size_t size);
+
+            inline size_t GetObjectsCount() const { return _objectsCount; }
+
+            // Batches use file blocks in place until modified.
+            void Attach(TransformBatch& transforms, BoundingSpheres& bounds) const;
+
+            inline const uint32_t* GetMeshIndices() const { return static_cast<const uint32_t*>(_blocks[MeshIndices]); }
+            inline const uint32_t* GetMaterialIndices() const { return static_cast<const uint32_t*>(_blocks[MaterialIndices]); }
+            inline const uint8_t* GetStaticFlags() const { return static_cast<const uint8_t*>(_blocks[StaticFlags]); }
+
+        private:
+            static size_t getBlockSize(Block block, size_t objectsCount);
+
+        private:
+            size_t _objectsCount = 0;
+            const void* _blocks[BlocksCount] = {};
+        };
+    }
+}
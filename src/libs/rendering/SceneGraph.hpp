@@ -6,6 +6,7 @@ namespace RR
     {
         class RenderContext;
         class Camera;
+        class SceneBvh;
 
         class SceneGraph
         {
@@ -14,8 +15,12 @@ namespace RR
             virtual void Terminate() = 0;
             virtual void Update() = 0;
 
+            // Either sets RenderElement::modelMatrix directly or adds one transform per element to RenderContext::GetTransformBatch.
+            // Meshes with LOD chain should be picked with RenderContext::GetLodSelector using stable object ids.
             virtual void Collect(RenderContext& renderContext) = 0;
             virtual std::shared_ptr<Camera> GetMainCamera() = 0;
+            // Spatial index over scene objects for frustum, sphere and ray queries, null when scene doesn't keep one.
+            virtual const SceneBvh* GetSpatialIndex() const { return nullptr; }
         };
     }
 }
\ No newline at end of file
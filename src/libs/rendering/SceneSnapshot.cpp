@@ -0,0 +1,199 @@
+#include "SceneSnapshot.hpp"
+
+#include "rendering/Camera.hpp"
+
+#include <algorithm>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            // Jitter is ignored, it's applied by render side every frame.
+            bool isSameView(const Camera& a, const Camera& b)
+            {
+                const Transform transformA = a.GetTransform();
+                const Transform transformB = b.GetTransform();
+
+                return transformA.Position == transformB.Position &&
+                       transformA.Rotation.x == transformB.Rotation.x && transformA.Rotation.y == transformB.Rotation.y &&
+                       transformA.Rotation.z == transformB.Rotation.z && transformA.Rotation.w == transformB.Rotation.w &&
+                       a.IsOrtho() == b.IsOrtho() && a.GetAspect() == b.GetAspect() && a.GetFov() == b.GetFov() &&
+                       a.GetOrthoSize() == b.GetOrthoSize() && a.GetZNear() == b.GetZNear() && a.GetZFar() == b.GetZFar();
+            }
+
+            bool isSameLights(const std::vector<PointLight>& a, const std::vector<PointLight>& b)
+            {
+                return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const PointLight& lightA, const PointLight& lightB) {
+                    return lightA.position == lightB.position && lightA.radius == lightB.radius && lightA.color == lightB.color;
+                });
+            }
+        }
+
+        SceneExtractor::SceneExtractor(uint32_t snapshotsCount)
+            : _snapshots(snapshotsCount), _dirtyObjects(snapshotsCount)
+        {
+            ASSERT(snapshotsCount > 0 && snapshotsCount <= MaxSnapshots);
+        }
+
+        uint32_t SceneExtractor::Add(const ObjectDescription& description)
+        {
+            // New objects are appended to every snapshot on extraction, no need to mark them.
+            _objects.push_back(description);
+            _dirtyMasks.push_back(0);
+            _revision++;
+
+            if (description.isStatic)
+                _staticRevision++;
+
+            return static_cast<uint32_t>(_objects.size() - 1);
+        }
+
+        void SceneExtractor::SetTransform(uint32_t id, const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+        {
+            ASSERT(id < _objects.size());
+
+            auto& object = _objects[id];
+            object.position = position;
+            object.rotation = rotation;
+            object.scale = scale;
+
+            markDirty(id);
+        }
+
+        void SceneExtractor::SetBounds(uint32_t id, const Vector3& center, float radius)
+        {
+            ASSERT(id < _objects.size());
+
+            auto& object = _objects[id];
+            object.boundCenter = center;
+            object.boundRadius = radius;
+
+            markDirty(id);
+        }
+
+        void SceneExtractor::SetMesh(uint32_t id, const std::shared_ptr<Mesh>& mesh, const Material& material)
+        {
+            ASSERT(id < _objects.size());
+
+            auto& object = _objects[id];
+            object.mesh = mesh;
+            object.lodChain = nullptr;
+            object.material = material;
+
+            markDirty(id);
+        }
+
+        void SceneExtractor::SetLodChain(uint32_t id, const std::shared_ptr<LodChain>& lodChain, const Material& material)
+        {
+            ASSERT(id < _objects.size());
+            ASSERT(lodChain && lodChain->GetLodsCount() > 0);
+
+            auto& object = _objects[id];
+            object.mesh = lodChain->GetMesh(0);
+            object.lodChain = lodChain;
+            object.material = material;
+
+            markDirty(id);
+        }
+
+        void SceneExtractor::SetCamera(const Camera& camera)
+        {
+            if (_camera)
+            {
+                if (!isSameView(*_camera, camera))
+                    _revision++;
+
+                *_camera = camera;
+            }
+            else
+            {
+                _camera = std::make_shared<Camera>(camera);
+                _revision++;
+            }
+        }
+
+        void SceneExtractor::SetLights(const std::vector<PointLight>& lights)
+        {
+            if (isSameLights(_lights, lights))
+                return;
+
+            _lights = lights;
+            _revision++;
+        }
+
+        void SceneExtractor::markDirty(uint32_t id)
+        {
+            auto& mask = _dirtyMasks[id];
+            _revision++;
+
+            if (_objects[id].isStatic)
+                _staticRevision++;
+
+            // Object is listed once per snapshot no matter how often it changes.
+            for (uint32_t index = 0; index < _snapshots.size(); index++)
+            {
+                const auto bit = static_cast<uint8_t>(1 << index);
+                if (mask & bit)
+                    continue;
+
+                mask |= bit;
+                _dirtyObjects[index].push_back(id);
+            }
+        }
+
+        const SceneSnapshot& SceneExtractor::Extract()
+        {
+            _current = (_current + 1) % _snapshots.size();
+
+            auto& snapshot = _snapshots[_current];
+            auto& dirtyObjects = _dirtyObjects[_current];
+            const auto bit = static_cast<uint8_t>(1 << _current);
+            const auto extractedCount = snapshot.GetSize();
+
+            for (const auto id : dirtyObjects)
+            {
+                _dirtyMasks[id] &= static_cast<uint8_t>(~bit);
+
+                // Appended below with actual state.
+                if (id >= extractedCount)
+                    continue;
+
+                const auto& object = _objects[id];
+                snapshot.transforms.Set(id, object.position, object.rotation, object.scale);
+                snapshot.bounds.Set(id, object.boundCenter, object.boundRadius);
+                snapshot.meshes[id] = object.mesh;
+                snapshot.lodChains[id] = object.lodChain;
+                snapshot.materials[id] = object.material;
+            }
+            dirtyObjects.clear();
+
+            for (size_t id = extractedCount; id < _objects.size(); id++)
+            {
+                const auto& object = _objects[id];
+                snapshot.transforms.Add(object.position, object.rotation, object.scale);
+                snapshot.bounds.Add(object.boundCenter, object.boundRadius);
+                snapshot.meshes.push_back(object.mesh);
+                snapshot.lodChains.push_back(object.lodChain);
+                snapshot.materials.push_back(object.material);
+                snapshot.isStatic.push_back(object.isStatic);
+            }
+
+            snapshot.staticRevision = _staticRevision;
+            snapshot.revision = _revision;
+
+            snapshot.lights = _lights;
+
+            if (_camera)
+            {
+                if (snapshot.camera)
+                    *snapshot.camera = *_camera;
+                else
+                    snapshot.camera = std::make_shared<Camera>(*_camera);
+            }
+
+            return snapshot;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include "rendering/Culling.hpp"
+#include "rendering/LightClusters.hpp"
+#include "rendering/MeshLod.hpp"
+#include "rendering/Material.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Camera;
+        class Mesh;
+
+        // Render side copy of scene state in structure of arrays layout, one element per scene object.
+        // Owned by render thread between SceneExtractor::Extract calls, so it's read without locks.
+        struct SceneSnapshot final
+        {
+            inline size_t GetSize() const { return meshes.size(); }
+
+            TransformBatch transforms;
+            BoundingSpheres bounds;
+            std::vector<std::shared_ptr<Mesh>> meshes;
+            // Null for objects without levels of detail.
+            std::vector<std::shared_ptr<LodChain>> lodChains;
+            std::vector<Material> materials;
+            std::vector<uint8_t> isStatic;
+            // Changes whenever static object is added or modified.
+            uint32_t staticRevision = 0;
+            // Changes whenever any object, light or camera changes, snapshots of equal revision render the same frame.
+            uint32_t revision = 0;
+            std::vector<PointLight> lights;
+            std::shared_ptr<Camera> camera;
+        };
+
+        // Simulation side of scene extraction. Keeps a ring of snapshots and copies into the next one
+        // only objects changed since that snapshot was extracted last time.
+        class SceneExtractor final
+        {
+        public:
+            static constexpr uint32_t MaxSnapshots = 8;
+
+            struct ObjectDescription
+            {
+                Vector3 position = Vector3(0.0f, 0.0f, 0.0f);
+                Quaternion rotation = Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+                Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
+                Vector3 boundCenter = Vector3(0.0f, 0.0f, 0.0f);
+                float boundRadius = 0.0f;
+                std::shared_ptr<Mesh> mesh;
+                // Overrides mesh with level picked per frame, mesh should be set to finest level for passes without selection.
+                std::shared_ptr<LodChain> lodChain;
+                Material material;
+                // Changing static object invalidates caches built from static objects, like shadow maps.
+                bool isStatic = false;
+            };
+
+        public:
+            // Snapshot stays valid for snapshotsCount - 1 following extractions, so it should be
+            // at least frames in flight plus one.
+            SceneExtractor(uint32_t snapshotsCount);
+
+            // Returns object id.
+            uint32_t Add(const ObjectDescription& description);
+
+            // World space transform, bounds center is not moved with it.
+            void SetTransform(uint32_t id, const Vector3& position, const Quaternion& rotation, const Vector3& scale = Vector3(1.0f, 1.0f, 1.0f));
+            // World space bounds, negative infinite radius hides the object.
+            void SetBounds(uint32_t id, const Vector3& center, float radius);
+            void SetMesh(uint32_t id, const std::shared_ptr<Mesh>& mesh, const Material& material);
+            // Mesh is set to finest level.
+            void SetLodChain(uint32_t id, const std::shared_ptr<LodChain>& lodChain, const Material& material);
+            // Could be called every frame, revision changes only when view or projection differs.
+            void SetCamera(const Camera& camera);
+            // Lights are few compared to objects, so whole list is copied into every snapshot.
+            void SetLights(const std::vector<PointLight>& lights);
+
+            inline size_t GetObjectsCount() const { return _objects.size(); }
+
+            // Brings next snapshot of the ring up to date and returns it.
+            const SceneSnapshot& Extract();
+
+        private:
+            void markDirty(uint32_t id);
+
+        private:
+            std::vector<ObjectDescription> _objects;
+            // Bit per snapshot which misses object changes.
+            std::vector<uint8_t> _dirtyMasks;
+            std::vector<SceneSnapshot> _snapshots;
+            std::vector<std::vector<uint32_t>> _dirtyObjects;
+            std::vector<PointLight> _lights;
+            uint32_t _staticRevision = 0;
+            uint32_t _revision = 0;
+            std::shared_ptr<Camera> _camera;
+            uint32_t _current = 0;
+        };
+    }
+}
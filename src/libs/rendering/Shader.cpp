@@ -4,7 +4,22 @@ namespace OpenDemo
 {
     namespace Rendering
     {
-        const char* const Shader::UniformsNames[Uniform::UNIFORM_MAX] = { "ViewProjection", "Model", "CameraPosition", "Material", "LightDirection" };
-        const char* const Shader::SamplerNames[Sampler::SAMPLER_MAX] = { "AlbedoMap", "NormalMap", "RoughnessMap", "MetallicMap" };
+        const char* const Shader::UniformsNames[Uniform::UNIFORM_MAX] = { "ViewProjection", "Model", "CameraPosition", "Material", "LightDirection", "UVScale", "BlitParams", "PostParams", "ColorGrading" };
+        const char* const Shader::SamplerNames[Sampler::SAMPLER_MAX] = { "AlbedoMap", "NormalMap", "RoughnessMap", "MetallicMap", "BloomMap", "HistoryMap", "MotionMap" };
+        const char* const Shader::UniformBlockNames[UniformBlock::UNIFORM_BLOCK_MAX] = { "FrameParams", "SkinningParams" };
+        const char* const Shader::BufferSamplerNames[BufferSampler::BUFFER_SAMPLER_MAX] = { "LightClusters", "LightIndices", "Lights" };
+
+        bool Shader::LinkSources(const std::vector<ShaderSource>& sources)
+        {
+            for (const auto& source : sources)
+                source.shader->BeginLink(source.stream);
+
+            // Every link is ended even after a failure, pending compilation state is released only by EndLink.
+            bool linked = true;
+            for (const auto& source : sources)
+                linked &= source.shader->EndLink();
+
+            return linked;
+        }
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "common/Math.hpp"
 
@@ -24,19 +25,73 @@ namespace OpenDemo
                 CAMERA_POSITION,
                 MATERIAL,
                 LIGHT_DIR,
+                // xy scales texture coordinates into rendered region, zw clamps them inside it.
+                UV_SCALE,
+                // Meaning depends on shader, see Render::Blit.
+                BLIT_PARAMS,
+                // x: bloom intensity, y: exposure, z: dither amplitude, w: tonemapping enabled.
+                POST_PARAMS,
+                // xyz: tint, w: saturation.
+                COLOR_GRADING,
                 UNIFORM_MAX
             };
         }
 
+        namespace UniformBlock
+        {
+            // Value is also the uniform buffer binding point of the block.
+            enum Type
+            {
+                FRAME,
+                // Joint palette of Render::Skin.
+                SKINNING,
+                UNIFORM_BLOCK_MAX
+            };
+        }
+
+        namespace BufferSampler
+        {
+            // Texture buffers bound after material samplers, unit is Sampler::SAMPLER_MAX + value.
+            enum Type
+            {
+                LIGHT_CLUSTERS,
+                LIGHT_INDICES,
+                LIGHTS,
+                BUFFER_SAMPLER_MAX
+            };
+        }
+
+        class Shader;
+
+        struct ShaderSource
+        {
+            std::shared_ptr<Shader> shader;
+            std::shared_ptr<Stream> stream;
+        };
+
         class Shader
         {
         public:
             static const char* const UniformsNames[Uniform::UNIFORM_MAX];
             static const char* const SamplerNames[Sampler::SAMPLER_MAX];
+            static const char* const UniformBlockNames[UniformBlock::UNIFORM_BLOCK_MAX];
+            static const char* const BufferSamplerNames[BufferSampler::BUFFER_SAMPLER_MAX];
 
             virtual ~Shader() {};
 
-            virtual bool LinkSource(const std::shared_ptr<Stream>& stream) = 0;
+            // Starts compilation without waiting for it. Every BeginLink should be followed by EndLink.
+            virtual void BeginLink(const std::shared_ptr<Stream>& stream) = 0;
+            // Waits for compilation started by BeginLink, false when it failed.
+            virtual bool EndLink() = 0;
+
+            inline bool LinkSource(const std::shared_ptr<Stream>& stream)
+            {
+                BeginLink(stream);
+                return EndLink();
+            }
+
+            // Begins all links before ending any, so driver can compile them concurrently. False when any of them failed.
+            static bool LinkSources(const std::vector<ShaderSource>& sources);
             virtual void Bind() const = 0;
 
             virtual void SetParam(Uniform::Type uType, const Vector4& value, int count = 1) const = 0;
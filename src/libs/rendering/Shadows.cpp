@@ -0,0 +1,233 @@
+#include "Shadows.hpp"
+
+#include "resource_manager/ResourceManager.hpp"
+
+#include "rendering/Camera.hpp"
+#include "rendering/Render.hpp"
+#include "rendering/RenderContext.hpp"
+#include "rendering/RenderTarget.hpp"
+#include "rendering/RenderTargetContext.hpp"
+#include "rendering/Texture.hpp"
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+            Vector3 pickUpVector(const Vector3& direction)
+            {
+                return fabsf(direction.y) > 0.99f ? Vector3::UNIT_X : Vector3::UNIT_Y;
+            }
+
+            float snap(float value, float step)
+            {
+                return floorf(value / step + 0.5f) * step;
+            }
+        }
+
+        ShadowCache::ShadowCache(Render& render, const Description& description)
+            : _render(&render), _description(description), _renderContext(new RenderContext())
+        {
+            ASSERT(description.cascadesCount >= 0 && description.cascadesCount <= MaxCascades);
+            ASSERT(description.resolution > description.cacheSnapTexels * 2);
+
+            auto* resourceManager = ResourceManager::Instance().get();
+            _renderContext->SetShader(resourceManager->LoadShader("../../assets/shaders/depthOnly.shader"));
+            _renderContext->SetDepthWrite(true);
+            _renderContext->SetDepthTestFunction(LEQUAL);
+            _renderContext->SetDepthOnly(true);
+            _renderContext->SetBlending(false);
+            _renderContext->SetDepthBias(description.depthBiasSlopeScale, description.depthBiasConstant);
+
+            _cascadeSplits.fill(0.0f);
+        }
+
+        const Matrix4& ShadowCache::GetViewProjection(int view) const
+        {
+            ASSERT(view < _viewsCount);
+            return _views[view].viewProjection;
+        }
+
+        std::shared_ptr<Texture2D> ShadowCache::GetDepthTexture(int view) const
+        {
+            ASSERT(view < _viewsCount);
+            const auto& shadowView = _views[view];
+            return shadowView.hasDynamicCasters ? shadowView.finalTexture : shadowView.staticTexture;
+        }
+
+        void ShadowCache::Update(const Camera& camera, const Vector3& lightDirection, const std::vector<SpotShadowDescription>& spotLights, uint32_t staticRevision,
+                                 const std::vector<RenderElement>& staticCasters, const std::vector<RenderElement>& dynamicCasters)
+        {
+            _viewsCount = 0;
+            _cascadesCount = lightDirection.Length() > 0.0f ? _description.cascadesCount : 0;
+
+            const float zNear = camera.GetZNear();
+            const float zFar = Min(camera.GetZFar(), _description.maxDistance);
+            ASSERT(zFar > zNear);
+
+            float nearSplit = zNear;
+            for (int cascade = 0; cascade < _cascadesCount; cascade++)
+            {
+                // Practical split scheme.
+                const float fraction = static_cast<float>(cascade + 1) / _cascadesCount;
+                const float logSplit = zNear * powf(zFar / zNear, fraction);
+                const float uniformSplit = zNear + (zFar - zNear) * fraction;
+                const float farSplit = _description.splitLambda * logSplit + (1.0f - _description.splitLambda) * uniformSplit;
+
+                _cascadeSplits[cascade] = farSplit;
+                auto& view = _views[_viewsCount++];
+                updateView(view, setupCascade(view, camera, lightDirection.Normal(), nearSplit, farSplit), staticRevision, staticCasters, dynamicCasters);
+                nearSplit = farSplit;
+            }
+
+            for (size_t index = 0; index < Min<size_t>(spotLights.size(), MaxSpotLights); index++)
+            {
+                auto& view = _views[_viewsCount++];
+                updateView(view, setupSpot(view, spotLights[index]), staticRevision, staticCasters, dynamicCasters);
+            }
+        }
+
+        ShadowCache::ViewKey ShadowCache::setupCascade(View& view, const Camera& camera, const Vector3& lightDirection, float nearSplit, float farSplit) const
+        {
+            view.resolution = _description.resolution;
+
+            // Bounding sphere of frustum slice depends only on projection, so its size stays constant while camera moves or turns.
+            float halfWidth, halfHeight;
+            if (camera.IsOrtho())
+            {
+                halfHeight = camera.GetOrthoSize() * 0.5f;
+                halfWidth = halfHeight * camera.GetAspect();
+            }
+            else
+            {
+                halfHeight = tanf(camera.GetFov() * 0.5f);
+                halfWidth = halfHeight * camera.GetAspect();
+            }
+
+            const float centerDepth = (nearSplit + farSplit) * 0.5f;
+            const auto cornerDistance = [&](float depth) {
+                const float scale = camera.IsOrtho() ? 1.0f : depth;
+                return Vector3(halfWidth * scale, halfHeight * scale, depth - centerDepth).Length();
+            };
+            const float sphereRadius = Max(cornerDistance(nearSplit), cornerDistance(farSplit));
+
+            // Snapping moves center by up to one step, enlarged radius keeps the original sphere covered.
+            const float resolution = static_cast<float>(view.resolution);
+            const float radius = sphereRadius * resolution / (resolution - 2.0f * _description.cacheSnapTexels);
+            const float snapStep = 2.0f * radius / resolution * _description.cacheSnapTexels;
+
+            // Light camera looks along negative z.
+            const Vector3 toLight = lightDirection * -1.0f;
+            const Quaternion rotation(toLight, pickUpVector(toLight));
+            const Matrix4 lightToWorld(rotation, Vector3(0, 0, 0));
+            const Matrix4 worldToLight = lightToWorld.InverseOrtho();
+
+            const Vector3 center = camera.GetViewMatrix() * Vector3(0, 0, -centerDepth);
+            Vector3 lightSpaceCenter = worldToLight * center;
+            lightSpaceCenter = Vector3(snap(lightSpaceCenter.x, snapStep), snap(lightSpaceCenter.y, snapStep), snap(lightSpaceCenter.z, snapStep));
+
+            const float zFar = 2.0f * radius + _description.casterDistance;
+
+            if (!view.camera)
+                view.camera.reset(new Camera({ true, 1.0f, 0.0f, 2.0f * radius, 0.0f, zFar }));
+
+            view.camera->SetOrtho(true);
+            view.camera->SetOrthoSize(2.0f * radius);
+            view.camera->SetZField(0.0f, zFar);
+
+            Transform transform;
+            transform.Rotation = rotation;
+            transform.Position = lightToWorld * lightSpaceCenter + toLight * (radius + _description.casterDistance);
+            view.camera->SetTransform(transform);
+            view.viewProjection = view.camera->GetViewProjectionMatrix();
+
+            return { lightSpaceCenter.x, lightSpaceCenter.y, lightSpaceCenter.z, radius, toLight.x, toLight.y, toLight.z, zFar };
+        }
+
+        ShadowCache::ViewKey ShadowCache::setupSpot(View& view, const SpotShadowDescription& spotLight) const
+        {
+            ASSERT(spotLight.range > 0.0f && spotLight.angle > 0.0f);
+
+            view.resolution = _description.spotResolution;
+
+            const float zNear = Max(spotLight.range * 0.005f, 0.05f);
+
+            if (!view.camera)
+                view.camera.reset(new Camera({ false, 1.0f, spotLight.angle, 0.0f, zNear, spotLight.range }));
+
+            view.camera->SetOrtho(false);
+            view.camera->SetFov(spotLight.angle);
+            view.camera->SetZField(zNear, spotLight.range);
+
+            const Vector3 backward = spotLight.direction.Normal() * -1.0f;
+
+            Transform transform;
+            transform.Rotation = Quaternion(backward, pickUpVector(backward));
+            transform.Position = spotLight.position;
+            view.camera->SetTransform(transform);
+            view.viewProjection = view.camera->GetViewProjectionMatrix();
+
+            return { spotLight.position.x, spotLight.position.y, spotLight.position.z, spotLight.range, backward.x, backward.y, backward.z, spotLight.angle };
+        }
+
+        void ShadowCache::updateView(View& view, const ViewKey& key, uint32_t staticRevision, const std::vector<RenderElement>& staticCasters, const std::vector<RenderElement>& dynamicCasters)
+        {
+            if (!view.staticTarget || view.staticTarget->GetWidth() != view.resolution)
+            {
+                allocateTarget(view.resolution, view.staticTexture, view.staticTarget);
+                view.isCached = false;
+            }
+
+            _renderContext->SetCamera(view.camera);
+
+            if (!view.isCached || view.key != key || view.staticRevision != staticRevision)
+            {
+                _renderContext->SetRenderTarget(view.staticTarget);
+
+                _render->Begin(_renderContext);
+                _render->ClearDepthStencil(1.0f);
+                _render->DrawElements(staticCasters);
+                _render->End();
+
+                view.isCached = true;
+                view.key = key;
+                view.staticRevision = staticRevision;
+                _staticUpdatesCount++;
+            }
+
+            view.hasDynamicCasters = !dynamicCasters.empty();
+            if (!view.hasDynamicCasters)
+                return;
+
+            if (!view.finalTarget || view.finalTarget->GetWidth() != view.resolution)
+                allocateTarget(view.resolution, view.finalTexture, view.finalTarget);
+
+            _render->CopyDepth(view.staticTarget, view.finalTarget);
+
+            _renderContext->SetRenderTarget(view.finalTarget);
+
+            _render->Begin(_renderContext);
+            _render->DrawElements(dynamicCasters);
+            _render->End();
+        }
+
+        void ShadowCache::allocateTarget(int resolution, std::shared_ptr<Texture2D>& texture, std::shared_ptr<RenderTargetContext>& target) const
+        {
+            Texture2D::Description textureDescription;
+            textureDescription.width = resolution;
+            textureDescription.height = resolution;
+            textureDescription.pixelFormat = PixelFormat::D16;
+
+            texture = _render->CreateTexture2D();
+            texture->Init(textureDescription, nullptr);
+
+            RenderTarget::RenderTargetDescription depthTarget;
+            depthTarget.texture = texture;
+            depthTarget.isDepthTarget = true;
+
+            target = _render->CreateRenderTargetContext();
+            target->SetDepthStencilTarget(depthTarget);
+        }
+    }
+}
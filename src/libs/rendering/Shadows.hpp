@@ -0,0 +1,113 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+#include <array>
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Camera;
+        class Render;
+        class RenderContext;
+        class RenderTargetContext;
+        class Shader;
+        class Texture2D;
+        struct RenderElement;
+
+        struct SpotShadowDescription
+        {
+            Vector3 position;
+            Vector3 direction;
+            // Full cone angle in radians.
+            float angle;
+            float range;
+        };
+
+        // Directional cascades and spot light shadow maps with static casters cached per view. Static depth is
+        // re-rendered only when view bounds or static revision change, dynamic casters are drawn each frame over copy of it.
+        // Cascade bounds are snapped to coarse light space grid, so they stay unchanged while camera moves within a cell.
+        class ShadowCache final
+        {
+        public:
+            static constexpr int MaxCascades = 4;
+            static constexpr int MaxSpotLights = 8;
+
+            struct Description
+            {
+                int resolution = 2048;
+                int cascadesCount = 4;
+                // Cascades cover view depth up to that distance or camera far plane, whichever is closer.
+                float maxDistance = 100.0f;
+                // Blend between logarithmic and uniform split distribution.
+                float splitLambda = 0.75f;
+                int spotResolution = 1024;
+                // Grid step of cascade center in texels. Larger steps keep cache longer at cost of resolution.
+                int cacheSnapTexels = 64;
+                // Casters that far behind cascade toward light still cast into it.
+                float casterDistance = 100.0f;
+                float depthBiasSlopeScale = 2.0f;
+                float depthBiasConstant = 2.0f;
+            };
+
+        public:
+            ShadowCache(Render& render, const Description& description);
+
+            // Light direction points from light into scene, zero disables cascades.
+            void Update(const Camera& camera, const Vector3& lightDirection, const std::vector<SpotShadowDescription>& spotLights, uint32_t staticRevision,
+                        const std::vector<RenderElement>& staticCasters, const std::vector<RenderElement>& dynamicCasters);
+
+            inline const Description& GetDescription() const { return _description; }
+
+            // Cascades come first, followed by spot lights.
+            inline int GetViewsCount() const { return _viewsCount; }
+            inline int GetCascadesCount() const { return _cascadesCount; }
+            const Matrix4& GetViewProjection(int view) const;
+            // D16 depth of static and dynamic casters.
+            std::shared_ptr<Texture2D> GetDepthTexture(int view) const;
+            // Far view distance of cascade.
+            inline float GetCascadeSplit(int cascade) const { return _cascadeSplits[cascade]; }
+
+            // Views re-rendered from static casters so far, stays still in static scenes.
+            inline uint32_t GetStaticUpdatesCount() const { return _staticUpdatesCount; }
+
+        private:
+            // Everything static depth depends on besides static revision.
+            using ViewKey = std::array<float, 8>;
+
+            struct View
+            {
+                int resolution = 0;
+                std::shared_ptr<Camera> camera;
+                Matrix4 viewProjection;
+                std::shared_ptr<Texture2D> staticTexture;
+                std::shared_ptr<RenderTargetContext> staticTarget;
+                // Static depth with dynamic casters on top, allocated on first dynamic caster.
+                std::shared_ptr<Texture2D> finalTexture;
+                std::shared_ptr<RenderTargetContext> finalTarget;
+                bool hasDynamicCasters = false;
+                bool isCached = false;
+                ViewKey key;
+                uint32_t staticRevision = 0;
+            };
+
+            ViewKey setupCascade(View& view, const Camera& camera, const Vector3& lightDirection, float nearSplit, float farSplit) const;
+            ViewKey setupSpot(View& view, const SpotShadowDescription& spotLight) const;
+            void updateView(View& view, const ViewKey& key, uint32_t staticRevision, const std::vector<RenderElement>& staticCasters, const std::vector<RenderElement>& dynamicCasters);
+            void allocateTarget(int resolution, std::shared_ptr<Texture2D>& texture, std::shared_ptr<RenderTargetContext>& target) const;
+
+        private:
+            Render* _render;
+            Description _description;
+            int _viewsCount = 0;
+            int _cascadesCount = 0;
+            uint32_t _staticUpdatesCount = 0;
+            std::array<float, MaxCascades> _cascadeSplits;
+            std::array<View, MaxCascades + MaxSpotLights> _views;
+            std::shared_ptr<RenderContext> _renderContext;
+        };
+    }
+}
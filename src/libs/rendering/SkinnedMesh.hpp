@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        class Mesh;
+        struct Vertex;
+
+#pragma pack(push, 1)
+        struct SkinVertex
+        {
+            uint8_t joints[4];
+            // Should sum up to one.
+            Common::Vector4 weights;
+        };
+#pragma pack(pop)
+
+        // Bind pose vertices with joint weights. Render::Skin writes skinned vertices into output mesh on GPU,
+        // which is then drawn by regular mesh path as any other mesh of full vertex format.
+        class SkinnedMesh
+        {
+        public:
+            virtual ~SkinnedMesh() {};
+
+            virtual void Init(const std::vector<Vertex>& vertices, const std::vector<SkinVertex>& skin, const std::vector<int32_t>& indexes) = 0;
+
+            // Holds bind pose until first skinning.
+            inline const std::shared_ptr<Mesh>& GetMesh() const { return _mesh; }
+
+        protected:
+            std::shared_ptr<Mesh> _mesh;
+        };
+    }
+}
@@ -14,6 +14,11 @@ namespace RR
                 NORMAL,
                 ROUGHNESS,
                 METALLIC,
+                // Post process only.
+                BLOOM,
+                // Temporal resolve only.
+                HISTORY,
+                MOTION,
                 SAMPLER_MAX
             };
         };
@@ -23,6 +28,7 @@ namespace RR
         public:
             virtual int GetWidth() const = 0;
             virtual int GetHeight() const = 0;
+            virtual int GetMipLevels() const = 0;
 
             virtual void Resize(int width, int height) = 0;
 
@@ -37,9 +43,31 @@ namespace RR
                 int width;
                 int height;
                 PixelFormat pixelFormat;
+                int mipLevels = 1;
             };
 
             virtual void Init(const Description& description, void* data) = 0;
         };
+
+        // Layers of same size, format and mip count, sampled as sampler2DArray. See TextureArrayPacker.
+        class Texture2DArray : public CommonTexture
+        {
+        public:
+            struct Description
+            {
+                int width;
+                int height;
+                int layers;
+                PixelFormat pixelFormat;
+                int mipLevels = 1;
+            };
+
+            virtual int GetLayers() const = 0;
+
+            virtual void Init(const Description& description) = 0;
+            // Data layout of first mip matches Texture2D::Init, other mips are generated once all layers are uploaded.
+            virtual void UploadLayer(int layer, const void* data) = 0;
+            virtual void GenerateMips() = 0;
+        };
     }
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "TextureArrayPacker.hpp"
+
+#include "rendering/Render.hpp"
+
+#include <map>
+#include <tuple>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        TextureArrayPacker::TextureArrayPacker(uint32_t maxLayers)
+            : _maxLayers(maxLayers)
+        {
+            ASSERT(maxLayers > 0);
+        }
+
+        uint32_t TextureArrayPacker::Add(const Texture2D::Description& description, std::vector<uint8_t>&& data)
+        {
+            ASSERT(!_isBuilt);
+            ASSERT(description.width > 0 && description.height > 0);
+            ASSERT(!data.empty());
+
+            _entries.push_back({ description, std::move(data) });
+            return static_cast<uint32_t>(_entries.size() - 1);
+        }
+
+        void TextureArrayPacker::Build(Render& render)
+        {
+            ASSERT(!_isBuilt);
+
+            // Textures of a group are layers in add order.
+            std::map<std::tuple<int, int, int, int>, std::vector<uint32_t>> groups;
+            for (uint32_t index = 0; index < _entries.size(); index++)
+            {
+                const auto& description = _entries[index].description;
+                groups[{ description.width, description.height, description.pixelFormat, description.mipLevels }].push_back(index);
+            }
+
+            _locations.resize(_entries.size());
+
+            for (const auto& group : groups)
+            {
+                const auto& indices = group.second;
+                const auto& description = _entries[indices.front()].description;
+
+                for (size_t first = 0; first < indices.size(); first += _maxLayers)
+                {
+                    const auto layers = static_cast<uint32_t>(std::min<size_t>(_maxLayers, indices.size() - first));
+
+                    const auto texture = render.CreateTexture2DArray();
+                    texture->Init({ description.width, description.height, static_cast<int>(layers), description.pixelFormat, description.mipLevels });
+
+                    for (uint32_t layer = 0; layer < layers; layer++)
+                    {
+                        const uint32_t index = indices[first + layer];
+                        texture->UploadLayer(static_cast<int>(layer), _entries[index].data.data());
+                        _locations[index] = { texture, layer };
+                    }
+
+                    texture->GenerateMips();
+                }
+            }
+
+            _entries.clear();
+            _entries.shrink_to_fit();
+            _isBuilt = true;
+        }
+
+        const TextureArrayPacker::Location& TextureArrayPacker::GetLocation(uint32_t index) const
+        {
+            ASSERT(_isBuilt);
+            ASSERT(index < _locations.size());
+
+            return _locations[index];
+        }
+    }
+}
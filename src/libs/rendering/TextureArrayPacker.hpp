@@ -0,0 +1,53 @@
+#pragma once
+
+#include "rendering/Texture.hpp"
+
+#include <vector>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        class Render;
+
+        // Packs material textures of same size, format and mip count into texture arrays at load time. Materials referencing
+        // layers of one array share material sort key, so DrawElements batches them into single instanced draw without texture
+        // binds in between. Every added texture becomes an array layer, material shaders sample maps as sampler2DArray with
+        // layer from INSTANCE_LAYERS attribute.
+        class TextureArrayPacker final
+        {
+        public:
+            // Minimum GL_MAX_ARRAY_TEXTURE_LAYERS of GL 3.3, larger groups are split into several arrays.
+            static constexpr uint32_t DefaultMaxLayers = 256;
+
+            struct Location
+            {
+                std::shared_ptr<Texture2DArray> texture;
+                uint32_t layer = 0;
+            };
+
+        public:
+            explicit TextureArrayPacker(uint32_t maxLayers = DefaultMaxLayers);
+
+            // Data layout matches Texture2D::Init, only first mip is provided. Returns index of location after Build.
+            uint32_t Add(const Texture2D::Description& description, std::vector<uint8_t>&& data);
+            // Creates arrays, uploads layers and generates mips. Data of added textures is released.
+            void Build(Render& render);
+
+            inline bool IsBuilt() const { return _isBuilt; }
+            const Location& GetLocation(uint32_t index) const;
+
+        private:
+            struct Entry
+            {
+                Texture2D::Description description;
+                std::vector<uint8_t> data;
+            };
+
+            uint32_t _maxLayers;
+            bool _isBuilt = false;
+            std::vector<Entry> _entries;
+            std::vector<Location> _locations;
+        };
+    }
+}
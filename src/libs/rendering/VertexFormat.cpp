@@ -0,0 +1,231 @@
+#include "VertexFormat.hpp"
+
+#include "rendering/Mesh.hpp"
+#include "rendering/Render.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace
+        {
+#pragma pack(push, 1)
+            struct CompactVertex
+            {
+                Vector3 position;
+                uint16_t texCoord[2];
+                int16_t normal[2];
+                // Octahedral tangent, bitangent sign and zero marking encoded tangent frame for shaders.
+                int16_t tangent[4];
+                uint8_t color[4];
+            };
+
+            struct QuantizedVertex
+            {
+                uint16_t position[4];
+                uint16_t texCoord[2];
+                int16_t normal[2];
+                int16_t tangent[4];
+                uint8_t color[4];
+            };
+#pragma pack(pop)
+
+            static_assert(sizeof(CompactVertex) == 32);
+            static_assert(sizeof(QuantizedVertex) == 28);
+
+            inline float saturate(float value, float min)
+            {
+                return std::max(min, std::min(1.0f, value));
+            }
+
+            inline int16_t toSnorm16(float value) { return static_cast<int16_t>(std::round(saturate(value, -1.0f) * 32767.0f)); }
+            inline uint16_t toUnorm16(float value) { return static_cast<uint16_t>(std::round(saturate(value, 0.0f) * 65535.0f)); }
+            inline uint8_t toUnorm8(float value) { return static_cast<uint8_t>(std::round(saturate(value, 0.0f) * 255.0f)); }
+
+            uint16_t toHalf(float value)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+                const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+                uint32_t mantissa = bits & 0x7fffff;
+
+                // Inf and NaN.
+                if ((bits & 0x7fffffff) >= 0x7f800000)
+                    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+
+                if (exponent >= 31)
+                    return sign | 0x7c00;
+
+                // Denormals, values below smallest denormal are flushed to zero.
+                if (exponent <= 0)
+                {
+                    if (exponent < -10)
+                        return sign;
+
+                    mantissa |= 0x800000;
+                    const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+                    const uint32_t half = (mantissa >> shift) + ((mantissa >> (shift - 1)) & 1);
+                    return sign | static_cast<uint16_t>(half);
+                }
+
+                // Rounding carry propagates into exponent, which is still valid half.
+                const uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+                return sign | static_cast<uint16_t>(half + ((mantissa >> 12) & 1));
+            }
+
+            void encodeOctahedral(const Vector3& direction, int16_t* encoded)
+            {
+                const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+                if (length == 0.0f)
+                {
+                    encoded[0] = encoded[1] = 0;
+                    return;
+                }
+
+                float x = direction.x / length;
+                float y = direction.y / length;
+
+                // Lower hemisphere is folded over diagonals.
+                if (direction.z < 0.0f)
+                {
+                    const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                    const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                    x = foldedX;
+                    y = foldedY;
+                }
+
+                encoded[0] = toSnorm16(x);
+                encoded[1] = toSnorm16(y);
+            }
+
+            template <typename EncodedVertex>
+            void encodeSurface(const Vertex& vertex, EncodedVertex& encoded)
+            {
+                encoded.texCoord[0] = toHalf(vertex.texCoord.x);
+                encoded.texCoord[1] = toHalf(vertex.texCoord.y);
+
+                encodeOctahedral(vertex.normal, encoded.normal);
+                encodeOctahedral(vertex.tangent, encoded.tangent);
+
+                const float handedness = vertex.normal.Cross(vertex.tangent).Dot(vertex.binormal);
+                encoded.tangent[2] = toSnorm16(handedness < 0.0f ? -1.0f : 1.0f);
+                encoded.tangent[3] = 0;
+
+                encoded.color[0] = toUnorm8(vertex.color.x);
+                encoded.color[1] = toUnorm8(vertex.color.y);
+                encoded.color[2] = toUnorm8(vertex.color.z);
+                encoded.color[3] = toUnorm8(vertex.color.w);
+            }
+
+            template <typename EncodedVertex>
+            VertexLayout compactLayout(uint32_t positionComponents, VertexAttributeType positionType)
+            {
+                return {
+                    static_cast<uint32_t>(sizeof(EncodedVertex)),
+                    {
+                        { Attributes::POSITION, positionComponents, positionType, static_cast<uint32_t>(offsetof(EncodedVertex, position)) },
+                        { Attributes::TEXCOORD, 2, ATTRIBUTE_HALF, static_cast<uint32_t>(offsetof(EncodedVertex, texCoord)) },
+                        { Attributes::NORMAL, 2, ATTRIBUTE_SNORM16, static_cast<uint32_t>(offsetof(EncodedVertex, normal)) },
+                        { Attributes::TANGENT, 4, ATTRIBUTE_SNORM16, static_cast<uint32_t>(offsetof(EncodedVertex, tangent)) },
+                        { Attributes::COLOR, 4, ATTRIBUTE_UNORM8, static_cast<uint32_t>(offsetof(EncodedVertex, color)) },
+                    }
+                };
+            }
+        }
+
+        const VertexLayout& VertexLayout::Get(VertexFormat format)
+        {
+            static const VertexLayout layouts[VERTEX_FORMAT_MAX] = {
+                { static_cast<uint32_t>(sizeof(Vertex)),
+                  {
+                      { Attributes::POSITION, 3, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, position)) },
+                      { Attributes::TEXCOORD, 2, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, texCoord)) },
+                      { Attributes::NORMAL, 3, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, normal)) },
+                      { Attributes::TANGENT, 3, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, tangent)) },
+                      { Attributes::BINORMAL, 3, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, binormal)) },
+                      { Attributes::COLOR, 4, ATTRIBUTE_FLOAT, static_cast<uint32_t>(offsetof(Vertex, color)) },
+                  } },
+                compactLayout<CompactVertex>(3, ATTRIBUTE_FLOAT),
+                compactLayout<QuantizedVertex>(3, ATTRIBUTE_UNORM16),
+            };
+
+            ASSERT(format >= 0 && format < VERTEX_FORMAT_MAX);
+            return layouts[format];
+        }
+
+        EncodedVertices EncodeVertices(const Vertex* vertices, int32_t vCount, VertexFormat format)
+        {
+            EncodedVertices result;
+            result.format = format;
+            result.positionDequantization.Identity();
+
+            const auto count = static_cast<size_t>(std::max(vCount, 0));
+            result.data.resize(count * VertexLayout::Get(format).stride);
+
+            switch (format)
+            {
+            case VERTEX_FORMAT_FULL:
+                if (count)
+                    std::memcpy(result.data.data(), vertices, count * sizeof(Vertex));
+                break;
+
+            case VERTEX_FORMAT_COMPACT:
+            {
+                auto encoded = reinterpret_cast<CompactVertex*>(result.data.data());
+                for (size_t index = 0; index < count; index++)
+                {
+                    encoded[index].position = vertices[index].position;
+                    encodeSurface(vertices[index], encoded[index]);
+                }
+                break;
+            }
+
+            case VERTEX_FORMAT_COMPACT_QUANTIZED:
+            {
+                if (!count)
+                    break;
+
+                Vector3 boundsMin = vertices[0].position;
+                Vector3 boundsMax = vertices[0].position;
+                for (size_t index = 1; index < count; index++)
+                {
+                    const auto& position = vertices[index].position;
+                    boundsMin = Vector3(std::min(boundsMin.x, position.x), std::min(boundsMin.y, position.y), std::min(boundsMin.z, position.z));
+                    boundsMax = Vector3(std::max(boundsMax.x, position.x), std::max(boundsMax.y, position.y), std::max(boundsMax.z, position.z));
+                }
+
+                // Single scale for all axes keeps normal matrix derived from model matrix valid.
+                const Vector3 size = boundsMax - boundsMin;
+                const float extent = std::max(std::max(size.x, size.y), std::max(size.z, std::numeric_limits<float>::min()));
+
+                auto encoded = reinterpret_cast<QuantizedVertex*>(result.data.data());
+                for (size_t index = 0; index < count; index++)
+                {
+                    const Vector3 position = (vertices[index].position - boundsMin) / extent;
+                    encoded[index].position[0] = toUnorm16(position.x);
+                    encoded[index].position[1] = toUnorm16(position.y);
+                    encoded[index].position[2] = toUnorm16(position.z);
+                    encoded[index].position[3] = 0;
+                    encodeSurface(vertices[index], encoded[index]);
+                }
+
+                result.positionDequantization.SetPos(boundsMin);
+                result.positionDequantization.Scale(Vector3(extent));
+                break;
+            }
+
+            default:
+                ASSERT_MSG(false, "Unknown vertex format");
+            }
+
+            return result;
+        }
+    }
+}
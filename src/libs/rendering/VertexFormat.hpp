@@ -0,0 +1,62 @@
+#pragma once
+
+#include "common/Math.hpp"
+
+namespace OpenDemo
+{
+    using namespace Common;
+
+    namespace Rendering
+    {
+        struct Vertex;
+
+        enum VertexFormat : int
+        {
+            // Rendering::Vertex as is, 92 bytes.
+            VERTEX_FORMAT_FULL,
+            // Float position, half UV, octahedral normal and tangent with bitangent sign, RGBA8 color, 32 bytes.
+            VERTEX_FORMAT_COMPACT,
+            // Same as compact with positions quantized to 16 bit inside mesh bounds, 28 bytes.
+            VERTEX_FORMAT_COMPACT_QUANTIZED,
+            VERTEX_FORMAT_MAX
+        };
+
+        enum VertexAttributeType : int
+        {
+            ATTRIBUTE_FLOAT,
+            ATTRIBUTE_HALF,
+            ATTRIBUTE_SNORM16,
+            ATTRIBUTE_UNORM16,
+            ATTRIBUTE_UNORM8,
+            ATTRIBUTE_TYPE_MAX
+        };
+
+        struct VertexAttributeDescription
+        {
+            // Attributes value the data is bound to.
+            uint32_t location;
+            uint32_t components;
+            VertexAttributeType type;
+            uint32_t offset;
+        };
+
+        // Attributes not listed in layout are left disabled.
+        struct VertexLayout
+        {
+            static const VertexLayout& Get(VertexFormat format);
+
+            uint32_t stride;
+            std::vector<VertexAttributeDescription> attributes;
+        };
+
+        struct EncodedVertices
+        {
+            VertexFormat format;
+            std::vector<uint8_t> data;
+            // Maps decoded attribute position to mesh space, identity unless positions are quantized.
+            Matrix4 positionDequantization;
+        };
+
+        EncodedVertices EncodeVertices(const Vertex* vertices, int32_t vCount, VertexFormat format);
+    }
+}
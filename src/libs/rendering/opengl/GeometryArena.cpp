@@ -0,0 +1,312 @@
+#include "GeometryArena.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            namespace
+            {
+                constexpr uint32_t InitialVertexCapacity = 64 * 1024;
+                constexpr uint32_t InitialIndexCapacity = 1024 * 1024;
+                constexpr uint32_t IndexAlignment = 4;
+
+                GLuint createBuffer(GLsizeiptr size)
+                {
+                    GLuint buffer;
+
+                    // Pools never change size, so immutable storage fits. Dynamic bit keeps glNamedBufferSubData allowed.
+                    if (GLAD_GL_VERSION_4_5)
+                    {
+                        glCreateBuffers(1, &buffer);
+                        glNamedBufferStorage(buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+                        return buffer;
+                    }
+
+                    glGenBuffers(1, &buffer);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+                    glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                    return buffer;
+                }
+
+                void uploadBuffer(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+                {
+                    if (GLAD_GL_VERSION_4_5)
+                    {
+                        glNamedBufferSubData(buffer, offset, size, data);
+                        return;
+                    }
+
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+                    glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                }
+
+                void copyBuffer(GLuint source, GLuint destination, GLsizeiptr size)
+                {
+                    if (GLAD_GL_VERSION_4_5)
+                    {
+                        glCopyNamedBufferSubData(source, destination, 0, 0, size);
+                        return;
+                    }
+
+                    glBindBuffer(GL_COPY_READ_BUFFER, source);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+                    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                }
+            }
+
+            void FreeListAllocator::Reset(uint32_t capacity)
+            {
+                _capacity = capacity;
+                _freeBlocks.clear();
+
+                if (capacity > 0)
+                    _freeBlocks.push_back({ 0, capacity });
+            }
+
+            void FreeListAllocator::Grow(uint32_t newCapacity)
+            {
+                ASSERT(newCapacity >= _capacity);
+
+                const uint32_t oldCapacity = _capacity;
+                _capacity = newCapacity;
+
+                Free(oldCapacity, newCapacity - oldCapacity);
+            }
+
+            bool FreeListAllocator::Allocate(uint32_t size, uint32_t alignment, uint32_t& offset)
+            {
+                ASSERT(size > 0 && alignment > 0);
+
+                for (size_t index = 0; index < _freeBlocks.size(); index++)
+                {
+                    const Block block = _freeBlocks[index];
+                    const uint32_t aligned = (block.offset + alignment - 1) / alignment * alignment;
+
+                    if (aligned + size > block.offset + block.size)
+                        continue;
+
+                    const Block head = { block.offset, aligned - block.offset };
+                    const Block tail = { aligned + size, block.offset + block.size - aligned - size };
+
+                    _freeBlocks.erase(_freeBlocks.begin() + index);
+                    if (tail.size > 0)
+                        _freeBlocks.insert(_freeBlocks.begin() + index, tail);
+                    if (head.size > 0)
+                        _freeBlocks.insert(_freeBlocks.begin() + index, head);
+
+                    offset = aligned;
+                    return true;
+                }
+
+                return false;
+            }
+
+            void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+            {
+                if (size == 0)
+                    return;
+
+                auto next = std::lower_bound(_freeBlocks.begin(), _freeBlocks.end(), offset,
+                                             [](const Block& block, uint32_t value) { return block.offset < value; });
+                next = _freeBlocks.insert(next, { offset, size });
+
+                if (next + 1 != _freeBlocks.end() && next->offset + next->size == (next + 1)->offset)
+                {
+                    next->size += (next + 1)->size;
+                    _freeBlocks.erase(next + 1);
+                }
+
+                if (next != _freeBlocks.begin() && (next - 1)->offset + (next - 1)->size == next->offset)
+                {
+                    (next - 1)->size += next->size;
+                    _freeBlocks.erase(next);
+                }
+            }
+
+            GeometryArena::~GeometryArena()
+            {
+                Terminate();
+            }
+
+            void GeometryArena::Terminate()
+            {
+                for (auto& vertexArray : _vertexArrays)
+                {
+                    if (vertexArray)
+                        glDeleteVertexArrays(1, &vertexArray);
+
+                    vertexArray = 0;
+                }
+
+                for (auto& pool : _vertexPools)
+                {
+                    if (pool.buffer)
+                        glDeleteBuffers(1, &pool.buffer);
+
+                    pool = Pool();
+                }
+
+                if (_indexPool.buffer)
+                    glDeleteBuffers(1, &_indexPool.buffer);
+
+                _indexPool = Pool();
+            }
+
+            GeometryArena::Range GeometryArena::AllocateVertices(VertexFormat format, const void* vertices, uint32_t vCount)
+            {
+                const uint32_t stride = VertexLayout::Get(format).stride;
+                auto& pool = _vertexPools[format];
+
+                if (vCount == 0)
+                    return {};
+
+                if (!pool.buffer)
+                {
+                    initPool(pool, std::max(InitialVertexCapacity, vCount), stride);
+                    setupVertexArray(format);
+                }
+
+                Range range;
+                range.size = vCount;
+
+                if (!pool.allocator.Allocate(vCount, 1, range.offset))
+                {
+                    growPool(pool, vCount, stride);
+                    // Attribute pointers captured the old buffer.
+                    setupVertexArray(format);
+
+                    const bool allocated = pool.allocator.Allocate(vCount, 1, range.offset);
+                    ASSERT(allocated);
+                    (void)allocated;
+                }
+
+                uploadBuffer(pool.buffer, static_cast<GLintptr>(range.offset) * stride, static_cast<GLsizeiptr>(vCount) * stride, vertices);
+
+                return range;
+            }
+
+            GeometryArena::Range GeometryArena::AllocateIndices(const void* indexes, uint32_t size)
+            {
+                if (size == 0)
+                    return {};
+
+                if (!_indexPool.buffer)
+                {
+                    initPool(_indexPool, std::max(InitialIndexCapacity, size), 1);
+                    bindIndexBuffer();
+                }
+
+                Range range;
+                range.size = size;
+
+                if (!_indexPool.allocator.Allocate(size, IndexAlignment, range.offset))
+                {
+                    growPool(_indexPool, size + IndexAlignment, 1);
+                    bindIndexBuffer();
+
+                    const bool allocated = _indexPool.allocator.Allocate(size, IndexAlignment, range.offset);
+                    ASSERT(allocated);
+                    (void)allocated;
+                }
+
+                uploadBuffer(_indexPool.buffer, range.offset, size, indexes);
+
+                return range;
+            }
+
+            void GeometryArena::FreeVertices(VertexFormat format, const Range& range)
+            {
+                if (_vertexPools[format].buffer)
+                    _vertexPools[format].allocator.Free(range.offset, range.size);
+            }
+
+            void GeometryArena::FreeIndices(const Range& range)
+            {
+                if (_indexPool.buffer)
+                    _indexPool.allocator.Free(range.offset, range.size);
+            }
+
+            GLuint GeometryArena::GetVertexArray(VertexFormat format)
+            {
+                if (!_vertexArrays[format])
+                    setupVertexArray(format);
+
+                return _vertexArrays[format];
+            }
+
+            void GeometryArena::initPool(Pool& pool, uint32_t capacity, uint32_t unitSize)
+            {
+                pool.buffer = createBuffer(static_cast<GLsizeiptr>(capacity) * unitSize);
+                pool.allocator.Reset(capacity);
+            }
+
+            void GeometryArena::growPool(Pool& pool, uint32_t requiredSize, uint32_t unitSize)
+            {
+                const uint32_t oldCapacity = pool.allocator.GetCapacity();
+                const uint32_t newCapacity = std::max(oldCapacity * 2, oldCapacity + requiredSize);
+
+                const GLuint buffer = createBuffer(static_cast<GLsizeiptr>(newCapacity) * unitSize);
+                copyBuffer(pool.buffer, buffer, static_cast<GLsizeiptr>(oldCapacity) * unitSize);
+
+                glDeleteBuffers(1, &pool.buffer);
+                pool.buffer = buffer;
+                pool.allocator.Grow(newCapacity);
+            }
+
+            void GeometryArena::bindIndexBuffer()
+            {
+                // Element array binding is vertex array state.
+                for (const auto vertexArray : _vertexArrays)
+                {
+                    if (!vertexArray)
+                        continue;
+
+                    glBindVertexArray(vertexArray);
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexPool.buffer);
+                }
+
+                glBindVertexArray(0);
+            }
+
+            void GeometryArena::setupVertexArray(VertexFormat format)
+            {
+                static const GLenum types[ATTRIBUTE_TYPE_MAX] = { GL_FLOAT, GL_HALF_FLOAT, GL_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_BYTE };
+
+                auto& vertexArray = _vertexArrays[format];
+                if (!vertexArray)
+                    glGenVertexArrays(1, &vertexArray);
+
+                glBindVertexArray(vertexArray);
+
+                const auto& pool = _vertexPools[format];
+                if (pool.buffer)
+                {
+                    const auto& layout = VertexLayout::Get(format);
+
+                    glBindBuffer(GL_ARRAY_BUFFER, pool.buffer);
+                    for (const auto& attribute : layout.attributes)
+                    {
+                        glEnableVertexAttribArray(attribute.location);
+                        glVertexAttribPointer(attribute.location, attribute.components, types[attribute.type], true, layout.stride, (void*)(size_t)attribute.offset);
+                    }
+                    glBindBuffer(GL_ARRAY_BUFFER, 0);
+                }
+
+                if (_indexPool.buffer)
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexPool.buffer);
+
+                glBindVertexArray(0);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "rendering/VertexFormat.hpp"
+
+#include <array>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            typedef uint32_t GLuint;
+
+            // First fit free list over [0, capacity), neighbouring free blocks are merged on release.
+            class FreeListAllocator final
+            {
+            public:
+                void Reset(uint32_t capacity);
+                // Appends [capacity, newCapacity) to free space.
+                void Grow(uint32_t newCapacity);
+
+                bool Allocate(uint32_t size, uint32_t alignment, uint32_t& offset);
+                void Free(uint32_t offset, uint32_t size);
+
+                inline uint32_t GetCapacity() const { return _capacity; }
+
+            private:
+                struct Block
+                {
+                    uint32_t offset;
+                    uint32_t size;
+                };
+
+                uint32_t _capacity = 0;
+                // Sorted by offset.
+                std::vector<Block> _freeBlocks;
+            };
+
+            // Large shared vertex and index buffers all meshes are sub-allocated from.
+            // Every vertex format has one vertex array object, so meshes of same format are drawn without rebinding,
+            // distinguished only by base vertex and index offset.
+            class GeometryArena final
+            {
+            public:
+                struct Range
+                {
+                    uint32_t offset = 0;
+                    uint32_t size = 0;
+                };
+
+                GeometryArena() = default;
+                ~GeometryArena();
+
+                void Terminate();
+
+                // Range is in vertices, so its offset is the base vertex of the mesh.
+                Range AllocateVertices(VertexFormat format, const void* vertices, uint32_t vCount);
+                // Range is in bytes, offset is aligned to four bytes and suits both 16 and 32 bit indices.
+                Range AllocateIndices(const void* indexes, uint32_t size);
+
+                void FreeVertices(VertexFormat format, const Range& range);
+                void FreeIndices(const Range& range);
+
+                GLuint GetVertexArray(VertexFormat format);
+                // Changes when pool grows, so it shouldn't be kept across allocations.
+                inline GLuint GetVertexBuffer(VertexFormat format) const { return _vertexPools[format].buffer; }
+
+            private:
+                struct Pool
+                {
+                    GLuint buffer = 0;
+                    FreeListAllocator allocator;
+                };
+
+                void initPool(Pool& pool, uint32_t capacity, uint32_t unitSize);
+                void growPool(Pool& pool, uint32_t requiredSize, uint32_t unitSize);
+                void bindIndexBuffer();
+                void setupVertexArray(VertexFormat format);
+
+                std::array<Pool, VERTEX_FORMAT_MAX> _vertexPools;
+                std::array<GLuint, VERTEX_FORMAT_MAX> _vertexArrays = {};
+                Pool _indexPool;
+            };
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include "Mesh.hpp"
 
 #include "vector"
+#include <limits>
 
 #include "glad/glad.h"
 #include "rendering/Render.hpp"
@@ -11,97 +12,166 @@ namespace OpenDemo
     {
         namespace OpenGL
         {
-            Mesh::Mesh()
+            Mesh::Mesh(const std::shared_ptr<GeometryArena>& arena)
+                : _arena(arena)
             {
-                glGenBuffers(2, _vboId);
-                glGenVertexArrays(1, &_vaoId);
             }
 
             Mesh::~Mesh()
             {
-                glDeleteBuffers(2, _vboId);
-                glDeleteVertexArrays(1, &_vaoId);
+                release();
             }
 
             void Mesh::Init(const Rendering::Vertex* vertices, int32_t vCount_)
             {
-                _vCount = vCount_;
-                _iCount = 0;
-
-                glBindVertexArray(_vaoId);
+                Init(vertices, vCount_, nullptr, 0);
+            }
 
-                glBindBuffer(GL_ARRAY_BUFFER, _vboId[0]);
-                glBufferData(GL_ARRAY_BUFFER, _vCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
+            void Mesh::Init(const Vertex* vertices, int32_t vCount_, const int32_t* indexes, int32_t iCount_)
+            {
+                release();
 
-                SetupAttributes();
+                _vertexFormat = VERTEX_FORMAT_FULL;
+                _positionDequantization.Identity();
 
-                glBindVertexArray(0);
+                init(vertices, vCount_, indexes, iCount_);
             }
 
-            void Mesh::Init(const Vertex* vertices, int32_t vCount_, const int32_t* indexes, int32_t iCount_)
+            void Mesh::Init(const std::vector<Vertex>& vertices)
             {
-                _vCount = vCount_;
-                _iCount = iCount_;
+                Init(vertices.data(), static_cast<int32_t>(vertices.size()));
+            }
 
-                glBindVertexArray(_vaoId);
+            void Mesh::Init(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes)
+            {
+                Init(vertices.data(), static_cast<int32_t>(vertices.size()), indexes.data(), static_cast<int32_t>(indexes.size()));
+            }
 
-                glBindBuffer(GL_ARRAY_BUFFER, _vboId[0]);
-                glBufferData(GL_ARRAY_BUFFER, _vCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
+            void Mesh::Init(const EncodedVertices& vertices, const std::vector<int32_t>& indexes)
+            {
+                const auto& layout = VertexLayout::Get(vertices.format);
 
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _vboId[1]);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, _iCount * sizeof(int32_t), indexes, GL_STATIC_DRAW);
+                // Ranges are returned to the pool of format they were allocated with.
+                release();
 
-                SetupAttributes();
+                _vertexFormat = vertices.format;
+                _positionDequantization = vertices.positionDequantization;
 
-                glBindVertexArray(0);
+                init(vertices.data.data(), static_cast<int32_t>(vertices.data.size() / layout.stride), indexes.data(), static_cast<int32_t>(indexes.size()));
             }
 
-            void Mesh::Init(const std::vector<Vertex>& vertices)
+            void Mesh::init(const void* vertices, int32_t vCount_, const int32_t* indexes, int32_t iCount_)
             {
-                Init(vertices.data(), static_cast<int32_t>(vertices.size()));
+                _vCount = vCount_;
+                _iCount = iCount_;
+
+                _vertexRange = _arena->AllocateVertices(_vertexFormat, vertices, static_cast<uint32_t>(_vCount));
+
+                if (_iCount > 0)
+                {
+                    // Indices are relative to base vertex, so narrowing depends only on this mesh size.
+                    if (_vCount <= std::numeric_limits<uint16_t>::max())
+                    {
+                        const std::vector<uint16_t> narrowed(indexes, indexes + _iCount);
+
+                        _indexType = GL_UNSIGNED_SHORT;
+                        _indexRange = _arena->AllocateIndices(narrowed.data(), static_cast<uint32_t>(_iCount * sizeof(uint16_t)));
+                    }
+                    else
+                    {
+                        _indexType = GL_UNSIGNED_INT;
+                        _indexRange = _arena->AllocateIndices(indexes, static_cast<uint32_t>(_iCount * sizeof(int32_t)));
+                    }
+                }
             }
 
-            void Mesh::Init(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes)
+            void Mesh::release()
             {
-                Init(vertices.data(), static_cast<int32_t>(vertices.size()), indexes.data(), static_cast<int32_t>(indexes.size()));
+                if (_vertexRange.size > 0)
+                    _arena->FreeVertices(_vertexFormat, _vertexRange);
+
+                if (_indexRange.size > 0)
+                    _arena->FreeIndices(_indexRange);
+
+                _vertexRange = {};
+                _indexRange = {};
+                _vCount = 0;
+                _iCount = 0;
             }
 
-            void Mesh::SetupAttributes()
+            const void* Mesh::getIndexOffset(uint32_t firstIndex) const
             {
-                glEnableVertexAttribArray(Attributes::POSITION);
-                glEnableVertexAttribArray(Attributes::TEXCOORD);
-                glEnableVertexAttribArray(Attributes::NORMAL);
-                glEnableVertexAttribArray(Attributes::TANGENT);
-                glEnableVertexAttribArray(Attributes::BINORMAL);
-                glEnableVertexAttribArray(Attributes::COLOR);
-
-                glVertexAttribPointer(Attributes::POSITION, 3, GL_FLOAT, false, sizeof(Vertex), (void*)offsetof(Vertex, position));
-                glVertexAttribPointer(Attributes::TEXCOORD, 2, GL_FLOAT, true, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-                glVertexAttribPointer(Attributes::NORMAL, 3, GL_FLOAT, true, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-                glVertexAttribPointer(Attributes::TANGENT, 3, GL_FLOAT, true, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-                glVertexAttribPointer(Attributes::BINORMAL, 3, GL_FLOAT, true, sizeof(Vertex), (void*)offsetof(Vertex, binormal));
-                glVertexAttribPointer(Attributes::COLOR, 4, GL_FLOAT, true, sizeof(Vertex), (void*)offsetof(Vertex, color));
-            };
+                const size_t indexSize = _indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+                return reinterpret_cast<const void*>(_indexRange.offset + firstIndex * indexSize);
+            }
 
             void Mesh::Bind() const
             {
-                glBindVertexArray(_vaoId);
+                glBindVertexArray(GetVertexArray());
             }
 
             void Mesh::Draw() const
             {
                 Bind();
+                Submit();
+                glBindVertexArray(0);
+            }
 
+            void Mesh::Submit() const
+            {
                 if (_iCount == 0)
                 {
-                    glDrawArrays(GL_TRIANGLES, 0, _vCount);
+                    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(_vertexRange.offset), _vCount);
                 }
                 else
                 {
-                    glDrawElements(GL_TRIANGLES, _iCount, GL_UNSIGNED_INT, 0);
+                    glDrawElementsBaseVertex(GL_TRIANGLES, _iCount, _indexType, getIndexOffset(0), static_cast<GLint>(_vertexRange.offset));
                 }
+            }
 
-                glBindVertexArray(0);
+            void Mesh::SubmitInstanced(int32_t instanceCount) const
+            {
+                if (_iCount == 0)
+                {
+                    glDrawArraysInstanced(GL_TRIANGLES, static_cast<GLint>(_vertexRange.offset), _vCount, instanceCount);
+                }
+                else
+                {
+                    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, _iCount, _indexType, getIndexOffset(0), instanceCount,
+                                                      static_cast<GLint>(_vertexRange.offset));
+                }
+            }
+
+            void Mesh::SubmitMeshlets(const std::vector<uint32_t>& visibleMeshlets) const
+            {
+                if (_iCount == 0 || visibleMeshlets.empty())
+                    return;
+
+                _multiDrawCounts.clear();
+                _multiDrawOffsets.clear();
+                _multiDrawBaseVertices.clear();
+
+                uint32_t rangeEnd = 0;
+                for (const auto index : visibleMeshlets)
+                {
+                    const auto& meshlet = _meshlets[index];
+
+                    if (!_multiDrawCounts.empty() && meshlet.firstIndex == rangeEnd)
+                    {
+                        _multiDrawCounts.back() += static_cast<int32_t>(meshlet.indexCount);
+                    }
+                    else
+                    {
+                        _multiDrawCounts.push_back(static_cast<int32_t>(meshlet.indexCount));
+                        _multiDrawOffsets.push_back(getIndexOffset(meshlet.firstIndex));
+                        _multiDrawBaseVertices.push_back(static_cast<int32_t>(_vertexRange.offset));
+                    }
+
+                    rangeEnd = meshlet.firstIndex + meshlet.indexCount;
+                }
+
+                glMultiDrawElementsBaseVertex(GL_TRIANGLES, _multiDrawCounts.data(), _indexType, _multiDrawOffsets.data(),
+                                              static_cast<GLsizei>(_multiDrawCounts.size()), _multiDrawBaseVertices.data());
             }
         }
     }
@@ -2,6 +2,8 @@
 
 #include "rendering/Mesh.hpp"
 
+#include "rendering/opengl/GeometryArena.hpp"
+
 namespace OpenDemo
 {
     namespace Rendering
@@ -9,11 +11,12 @@ namespace OpenDemo
         namespace OpenGL
         {
             typedef uint32_t GLuint;
+            typedef uint32_t GLenum;
 
             class Mesh final : public Rendering::Mesh
             {
             public:
-                Mesh();
+                Mesh(const std::shared_ptr<GeometryArena>& arena);
                 virtual ~Mesh() override;
 
                 virtual void Init(const Vertex* vertices, int32_t vCount) override;
@@ -21,18 +24,37 @@ namespace OpenDemo
 
                 virtual void Init(const std::vector<Vertex>& vertices) override;
                 virtual void Init(const std::vector<Vertex>& vertices, const std::vector<int32_t>& indexes) override;
+                virtual void Init(const EncodedVertices& vertices, const std::vector<int32_t>& indexes) override;
 
                 virtual void Bind() const override;
                 virtual void Draw() const override;
+                // Issues draw call, expects mesh to be bound already.
+                void Submit() const;
+                void SubmitInstanced(int32_t instanceCount) const;
+                // Draws listed meshlets with a single multi draw, adjacent ones are merged into one range.
+                void SubmitMeshlets(const std::vector<uint32_t>& visibleMeshlets) const;
 
-            private:
-                GLuint _vaoId;
-                GLuint _vboId[2];
-
-                int32_t _vCount;
-                int32_t _iCount;
+                inline const GeometryArena::Range& GetVertexRange() const { return _vertexRange; }
+                // Shared by every mesh of same vertex format.
+                inline GLuint GetVertexArray() const { return _arena->GetVertexArray(_vertexFormat); }
 
-                void SetupAttributes();
+            private:
+                std::shared_ptr<GeometryArena> _arena;
+                GeometryArena::Range _vertexRange;
+                GeometryArena::Range _indexRange;
+
+                int32_t _vCount = 0;
+                int32_t _iCount = 0;
+                // Indices are narrowed to 16 bit when every vertex is addressable with them.
+                GLenum _indexType = 0;
+
+                mutable std::vector<int32_t> _multiDrawCounts;
+                mutable std::vector<const void*> _multiDrawOffsets;
+                mutable std::vector<int32_t> _multiDrawBaseVertices;
+
+                void init(const void* vertices, int32_t vCount, const int32_t* indexes, int32_t iCount);
+                void release();
+                const void* getIndexOffset(uint32_t firstIndex) const;
             };
         }
     }
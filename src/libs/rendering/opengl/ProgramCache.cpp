@@ -0,0 +1,141 @@
+#include "ProgramCache.hpp"
+
+#include "glad/glad.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            namespace
+            {
+                constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325ull;
+                constexpr uint64_t FnvPrime = 0x100000001b3ull;
+
+                constexpr uint32_t Magic = 0x4D475250; // PRGM
+                // Bump when header layout or location tables change meaning.
+                constexpr uint32_t Version = 1;
+
+                struct Header
+                {
+                    uint32_t magic;
+                    uint32_t version;
+                    GLenum binaryFormat;
+                    uint32_t binarySize;
+                    ProgramCache::Locations locations;
+                };
+
+                uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+                {
+                    const auto bytes = static_cast<const uint8_t*>(data);
+                    for (size_t index = 0; index < size; index++)
+                    {
+                        hash ^= bytes[index];
+                        hash *= FnvPrime;
+                    }
+
+                    return hash;
+                }
+
+                uint64_t hashString(uint64_t hash, const char* string)
+                {
+                    // Include terminator so adjacent strings don't collide.
+                    return string ? hashBytes(hash, string, std::strlen(string) + 1) : hashBytes(hash, "", 1);
+                }
+            }
+
+            ProgramCache::ProgramCache(const std::string& cacheDirectory)
+                : _cacheDirectory(cacheDirectory)
+            {
+                GLint formatsCount = 0;
+                if (GLAD_GL_VERSION_4_1)
+                    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatsCount);
+
+                _isSupported = formatsCount > 0;
+                if (!_isSupported)
+                    return;
+
+                _driverHash = FnvOffsetBasis;
+                _driverHash = hashString(_driverHash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+                _driverHash = hashString(_driverHash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+                _driverHash = hashString(_driverHash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+                std::error_code error;
+                std::filesystem::create_directories(_cacheDirectory, error);
+            }
+
+            uint64_t ProgramCache::GetKey(const char* const* sources, size_t count) const
+            {
+                uint64_t hash = hashBytes(_driverHash, &Version, sizeof(Version));
+                // Location tables grow with uniform enums.
+                const uint32_t headerSize = sizeof(Header);
+                hash = hashBytes(hash, &headerSize, sizeof(headerSize));
+
+                for (size_t index = 0; index < count; index++)
+                    hash = hashString(hash, sources[index]);
+
+                return hash;
+            }
+
+            bool ProgramCache::Load(uint64_t key, Entry& entry) const
+            {
+                std::ifstream file(getEntryPath(key), std::ios::binary);
+                if (!file)
+                    return false;
+
+                Header header;
+                if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+                    return false;
+
+                if (header.magic != Magic || header.version != Version || header.binarySize == 0)
+                    return false;
+
+                entry.binaryFormat = header.binaryFormat;
+                entry.locations = header.locations;
+                entry.binary.resize(header.binarySize);
+
+                return static_cast<bool>(file.read(reinterpret_cast<char*>(entry.binary.data()), static_cast<std::streamsize>(entry.binary.size())));
+            }
+
+            void ProgramCache::Store(uint64_t key, const Entry& entry) const
+            {
+                const auto path = getEntryPath(key);
+                const auto tempPath = path + ".tmp";
+
+                Header header;
+                header.magic = Magic;
+                header.version = Version;
+                header.binaryFormat = entry.binaryFormat;
+                header.binarySize = static_cast<uint32_t>(entry.binary.size());
+                header.locations = entry.locations;
+
+                {
+                    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                    if (!file)
+                        return;
+
+                    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    file.write(reinterpret_cast<const char*>(entry.binary.data()), static_cast<std::streamsize>(entry.binary.size()));
+                    if (!file)
+                        return;
+                }
+
+                // Partially written entry is never visible under the final name.
+                std::error_code error;
+                std::filesystem::rename(tempPath, path, error);
+                if (error)
+                    std::filesystem::remove(tempPath, error);
+            }
+
+            std::string ProgramCache::getEntryPath(uint64_t key) const
+            {
+                return (std::filesystem::path(_cacheDirectory) / fmt::format(FMT_STRING("{:016x}.bin"), key)).string();
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "rendering/Shader.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            typedef int GLint;
+            typedef uint32_t GLuint;
+            typedef uint32_t GLenum;
+
+            // On-disk cache of linked programs, see glGetProgramBinary. Binary is valid only for the driver which produced it,
+            // so key covers driver version next to shader source. Entries keep uniform locations too, warm start skips the lookups.
+            class ProgramCache final
+            {
+            public:
+                struct Locations
+                {
+                    std::array<GLint, Uniform::UNIFORM_MAX> uniforms;
+                    std::array<GLint, Sampler::SAMPLER_MAX> samplers;
+                    std::array<GLint, BufferSampler::BUFFER_SAMPLER_MAX> bufferSamplers;
+                    // GL_INVALID_INDEX when shader doesn't declare the block.
+                    std::array<GLuint, UniformBlock::UNIFORM_BLOCK_MAX> uniformBlocks;
+                };
+
+                struct Entry
+                {
+                    GLenum binaryFormat = 0;
+                    std::vector<uint8_t> binary;
+                    Locations locations;
+                };
+
+                // Should be created with current context, driver is identified once.
+                ProgramCache(const std::string& cacheDirectory);
+
+                // False below GL 4.1 or when driver exposes no binary formats.
+                inline bool IsSupported() const { return _isSupported; }
+
+                uint64_t GetKey(const char* const* sources, size_t count) const;
+
+                bool Load(uint64_t key, Entry& entry) const;
+                void Store(uint64_t key, const Entry& entry) const;
+
+            private:
+                std::string getEntryPath(uint64_t key) const;
+
+            private:
+                std::string _cacheDirectory;
+                uint64_t _driverHash = 0;
+                bool _isSupported = false;
+            };
+        }
+    }
+}
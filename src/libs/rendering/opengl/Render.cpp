@@ -4,19 +4,34 @@
 
 #include "glad/glad.h"
 
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
 #include "common/Exception.hpp"
 
 #include "windowing/Window.hpp"
 
+#include "rendering/Animation.hpp"
 #include "rendering/Camera.hpp"
+#include "rendering/Culling.hpp"
+#include "rendering/LightClusters.hpp"
+#include "rendering/Meshlets.hpp"
+#include "rendering/Primitives.hpp"
 #include "rendering/Render.hpp"
 #include "rendering/RenderContext.hpp"
 
+#include "rendering/opengl/GeometryArena.hpp"
 #include "rendering/opengl/Mesh.hpp"
+#include "rendering/opengl/ProgramCache.hpp"
 #include "rendering/opengl/Render.hpp"
 #include "rendering/opengl/RenderTargetContext.hpp"
+#include "rendering/opengl/SkinnedMesh.hpp"
 #include "rendering/opengl/Shader.hpp"
 #include "rendering/opengl/Texture.hpp"
+#include "rendering/opengl/TextureStreamer.hpp"
+#include "rendering/opengl/UniformRing.hpp"
 
 #include "gapi_dx12/Device.hpp"
 
@@ -57,6 +72,13 @@ namespace OpenDemo
                 }
             };
 
+            // Sampler order, shaders index texture arrays of material maps with it.
+            Vector4 getMaterialLayers(const Material& material)
+            {
+                return Vector4(static_cast<float>(material.albedoLayer), static_cast<float>(material.normalLayer),
+                               static_cast<float>(material.roughnessLayer), static_cast<float>(material.metallicLayer));
+            }
+
             GLuint GetOpenGLDepthTestFunction(DepthTestFunction depthTestFunction)
             {
                 static const GLuint depthTestFunctions[DEPTH_TEST_FUNC_MAX] = {
@@ -66,11 +88,42 @@ namespace OpenDemo
                 return depthTestFunctions[depthTestFunction];
             }
 
+            namespace
+            {
+                constexpr size_t UniformRingSize = 1024 * 1024;
+                // Relative to working directory, like shader sources.
+                constexpr const char* ProgramCacheDirectory = "shaderCache";
+                // Bytes of streamed texture rows copied per frame, 2048x2048 RGBA8 texture takes 4 frames.
+                constexpr size_t TextureStreamingBudget = 4 * 1024 * 1024;
+
+                // std140 layout of FrameParams block.
+                struct FrameParams
+                {
+                    Matrix4 viewProjection;
+                    Vector4 cameraPosition;
+                    Vector4 lightDirection;
+                    Vector4 cameraForward;
+                    // xy: clusters per pixel, z: slice scale, w: slice bias.
+                    Vector4 clusterScale;
+                    // xyz: clusters grid size, w: lights count.
+                    Vector4 clusterGrid;
+                    Matrix4 unjitteredViewProjection;
+                    Matrix4 previousViewProjection;
+                };
+
+                // Texel formats of BufferSampler::Type buffers.
+                constexpr GLenum LightBufferFormats[BufferSampler::BUFFER_SAMPLER_MAX] = { GL_RG32UI, GL_R32UI, GL_RGBA32F };
+            }
+
             Render::Render()
                 : _context(nullptr)
             {
             }
 
+            Render::~Render()
+            {
+            }
+
             void Render::Init(const std::shared_ptr<Windowing::Window>& window)
             {
                 _window = window;
@@ -93,13 +146,128 @@ namespace OpenDemo
                 if (!GLAD_GL_VERSION_3_3)
                     throw Common::Exception("OpenGL version is not supported.");
 
+                // Not covered by generated loader. Links are then compiled on driver threads, see Shader::LinkSources.
+                if (SDL_GL_ExtensionSupported("GL_KHR_parallel_shader_compile"))
+                {
+                    typedef void(APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+                    const auto maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsKHR"));
+
+                    // Implementation chosen count.
+                    if (maxShaderCompilerThreads)
+                        maxShaderCompilerThreads(0xFFFFFFFF);
+                }
+
                 glCullFace(GL_BACK);
                 glEnable(GL_CULL_FACE);
                 // glDisable(GL_CULL_FACE);
+
+                // Scissor always matches viewport, so clears don't touch target area outside of scaled viewport.
+                glEnable(GL_SCISSOR_TEST);
+
+                glGenBuffers(1, &_instanceBuffer);
+                glGenBuffers(1, &_instanceLayersBuffer);
+                glGenFramebuffers(1, &_blitFramebuffer);
+                glGenVertexArrays(1, &_emptyVertexArray);
+                glGenBuffers(1, &_skinningBuffer);
+
+                _geometryArena = std::make_shared<GeometryArena>();
+                _programCache = std::make_shared<ProgramCache>(ProgramCacheDirectory);
+
+                _uniformRing = std::make_unique<UniformRing>();
+                _uniformRing->Init(UniformRingSize);
+
+                _textureStreamer = std::make_unique<TextureStreamer>();
+                _textureStreamer->Init(TextureStreamingBudget);
+
+                glGenQueries(static_cast<GLsizei>(_timerQueries.size()), _timerQueries.data());
+
+                glGenBuffers(static_cast<GLsizei>(_lightBuffers.size()), _lightBuffers.data());
+                glGenTextures(static_cast<GLsizei>(_lightTextures.size()), _lightTextures.data());
+
+                for (int bt = 0; bt < BufferSampler::BUFFER_SAMPLER_MAX; bt++)
+                {
+                    glBindBuffer(GL_TEXTURE_BUFFER, _lightBuffers[bt]);
+                    // Texture buffer needs storage before first draw, even if no lights are ever uploaded.
+                    glBufferData(GL_TEXTURE_BUFFER, sizeof(Vector4), nullptr, GL_DYNAMIC_DRAW);
+
+                    glBindTexture(GL_TEXTURE_BUFFER, _lightTextures[bt]);
+                    glTexBuffer(GL_TEXTURE_BUFFER, LightBufferFormats[bt], _lightBuffers[bt]);
+                }
+
+                glBindBuffer(GL_TEXTURE_BUFFER, 0);
+                glBindTexture(GL_TEXTURE_BUFFER, 0);
             }
 
             void Render::Terminate()
             {
+                Primitives::ReleaseCache();
+
+                if (_geometryArena)
+                {
+                    // Meshes still alive keep the arena object, but its GL objects go away with the context.
+                    _geometryArena->Terminate();
+                    _geometryArena.reset();
+                }
+
+                _programCache.reset();
+
+                if (_uniformRing)
+                {
+                    _uniformRing->Terminate();
+                    _uniformRing.reset();
+                }
+
+                if (_textureStreamer)
+                {
+                    _textureStreamer->Terminate();
+                    _textureStreamer.reset();
+                }
+
+                if (_lightTextures[0])
+                {
+                    glDeleteTextures(static_cast<GLsizei>(_lightTextures.size()), _lightTextures.data());
+                    glDeleteBuffers(static_cast<GLsizei>(_lightBuffers.size()), _lightBuffers.data());
+                    _lightTextures.fill(0);
+                    _lightBuffers.fill(0);
+                    _uploadedLightClusters = nullptr;
+                }
+
+                if (_timerQueries[0])
+                {
+                    glDeleteQueries(static_cast<GLsizei>(_timerQueries.size()), _timerQueries.data());
+                    _timerQueries.fill(0);
+                }
+
+                if (_blitFramebuffer)
+                {
+                    glDeleteFramebuffers(1, &_blitFramebuffer);
+                    _blitFramebuffer = 0;
+                }
+
+                if (_emptyVertexArray)
+                {
+                    glDeleteVertexArrays(1, &_emptyVertexArray);
+                    _emptyVertexArray = 0;
+                }
+
+                if (_skinningBuffer)
+                {
+                    glDeleteBuffers(1, &_skinningBuffer);
+                    _skinningBuffer = 0;
+                }
+
+                if (_instanceBuffer)
+                {
+                    glDeleteBuffers(1, &_instanceBuffer);
+                    _instanceBuffer = 0;
+                }
+
+                if (_instanceLayersBuffer)
+                {
+                    glDeleteBuffers(1, &_instanceLayersBuffer);
+                    _instanceLayersBuffer = 0;
+                }
+
                 if (_context)
                 {
                     SDL_GL_DeleteContext(_context);
@@ -115,7 +283,61 @@ namespace OpenDemo
                     fprintf(stderr, "GL_ERROR: %d : %s\n", error, gluErrorU8String(error));
                 }
 
+                endFrameTimer();
+
                 SDL_GL_SwapWindow(_window->GetSDLWindow());
+
+                if (_uniformRing)
+                    _uniformRing->MoveToNextFrame();
+
+                if (_textureStreamer)
+                    _textureStreamer->MoveToNextFrame();
+            }
+
+            float Render::GetGpuFrameTime()
+            {
+                float frameTime = -1.0f;
+
+                while (_timerQueriesResolved < _timerQueriesIssued)
+                {
+                    const GLuint query = _timerQueries[_timerQueriesResolved % _timerQueries.size()];
+
+                    GLint available = GL_FALSE;
+                    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                    if (!available)
+                        break;
+
+                    GLuint64 elapsed;
+                    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+                    frameTime = static_cast<float>(elapsed) * 1e-6f;
+
+                    _timerQueriesResolved++;
+                }
+
+                return frameTime;
+            }
+
+            void Render::beginFrameTimer()
+            {
+                if (_timerQueryActive)
+                    return;
+
+                // All queries are still in flight, this frame goes unmeasured.
+                if (_timerQueriesIssued - _timerQueriesResolved == _timerQueries.size())
+                    return;
+
+                glBeginQuery(GL_TIME_ELAPSED, _timerQueries[_timerQueriesIssued % _timerQueries.size()]);
+                _timerQueryActive = true;
+            }
+
+            void Render::endFrameTimer() const
+            {
+                if (!_timerQueryActive)
+                    return;
+
+                glEndQuery(GL_TIME_ELAPSED);
+                _timerQueriesIssued++;
+                _timerQueryActive = false;
             }
 
             void Render::Clear(const Common::Vector4& color, float depth) const
@@ -141,6 +363,10 @@ namespace OpenDemo
             void Render::Begin(const std::shared_ptr<RenderContext>& renderContext)
             {
                 _renderContext = renderContext;
+                _boundTextures.fill(nullptr);
+
+                // First pass of the frame starts GPU frame time measurement, SwapBuffers stops it.
+                beginFrameTimer();
 
                 const auto& camera = _renderContext->GetCamera();
                 const auto& shader = _renderContext->GetShader();
@@ -161,11 +387,31 @@ namespace OpenDemo
                     rtHeight = renderTarget->GetHeight();
                 }
 
+                if (_renderContext->GetViewportWidth() > 0 && _renderContext->GetViewportHeight() > 0)
+                {
+                    ASSERT(_renderContext->GetViewportWidth() <= rtWidth && _renderContext->GetViewportHeight() <= rtHeight);
+                    rtWidth = _renderContext->GetViewportWidth();
+                    rtHeight = _renderContext->GetViewportHeight();
+                }
+
                 glViewport(0, 0, rtWidth, rtHeight);
                 glScissor(0, 0, rtWidth, rtHeight);
 
                 glDepthMask(_renderContext->GetDepthWrite());
 
+                const GLboolean colorWrite = _renderContext->GetDepthOnly() ? GL_FALSE : GL_TRUE;
+                glColorMask(colorWrite, colorWrite, colorWrite, colorWrite);
+
+                if (_renderContext->GetDepthBiasSlopeScale() != 0.0f || _renderContext->GetDepthBiasConstant() != 0.0f)
+                {
+                    glEnable(GL_POLYGON_OFFSET_FILL);
+                    glPolygonOffset(_renderContext->GetDepthBiasSlopeScale(), _renderContext->GetDepthBiasConstant());
+                }
+                else
+                {
+                    glDisable(GL_POLYGON_OFFSET_FILL);
+                }
+
                 const auto depthTestFunction = _renderContext->GetDepthTestFunction();
                 if (depthTestFunction == ALWAYS)
                 {
@@ -183,14 +429,95 @@ namespace OpenDemo
                 const auto& lightDir = _renderContext->GetLightDirection();
 
                 shader->Bind();
-                shader->SetParam(Uniform::Type::LIGHT_DIR, Vector4(lightDir, 0));
 
                 if (camera != nullptr)
-                {
-                    const auto& cameraPos = camera->GetTransform().Position;
                     camera->SetAspect(rtWidth, rtHeight);
+
+                const auto& lightClusters = _renderContext->GetLightClusters();
+                if (lightClusters != nullptr)
+                    bindLightClusters(*lightClusters);
+
+                setFrameParams(Vector4(lightDir, 0), rtWidth, rtHeight);
+            }
+
+            void Render::bindLightClusters(const LightClusters& lightClusters)
+            {
+                if (_uploadedLightClusters != &lightClusters || _uploadedLightClustersRevision != lightClusters.GetRevision())
+                {
+                    const auto upload = [this](BufferSampler::Type type, const void* data, size_t size) {
+                        glBindBuffer(GL_TEXTURE_BUFFER, _lightBuffers[type]);
+                        // Orphans previous storage, frames in flight keep reading old lists.
+                        if (size > 0)
+                            glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+                    };
+
+                    upload(BufferSampler::LIGHT_CLUSTERS, lightClusters.GetClusterData().data(), lightClusters.GetClusterData().size() * sizeof(uint32_t));
+                    upload(BufferSampler::LIGHT_INDICES, lightClusters.GetLightIndices().data(), lightClusters.GetLightIndices().size() * sizeof(uint32_t));
+                    upload(BufferSampler::LIGHTS, lightClusters.GetLightData().data(), lightClusters.GetLightData().size() * sizeof(Vector4));
+                    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+                    _uploadedLightClusters = &lightClusters;
+                    _uploadedLightClustersRevision = lightClusters.GetRevision();
+                }
+
+                for (int bt = 0; bt < BufferSampler::BUFFER_SAMPLER_MAX; bt++)
+                {
+                    glActiveTexture(GL_TEXTURE0 + Sampler::SAMPLER_MAX + bt);
+                    glBindTexture(GL_TEXTURE_BUFFER, _lightTextures[bt]);
+                }
+            }
+
+            void Render::setFrameParams(const Vector4& lightDirection, int viewportWidth, int viewportHeight) const
+            {
+                const auto& camera = _renderContext->GetCamera();
+                const auto& shader = _renderContext->GetShader();
+
+                if (static_cast<const OpenGL::Shader*>(shader.get())->HasUniformBlock(UniformBlock::FRAME))
+                {
+                    // Block is written as a whole, camera less passes get identity instead of stale values.
+                    FrameParams params;
+                    params.viewProjection.Identity();
+                    params.cameraPosition = Vector4(0, 0, 0, 0);
+                    params.lightDirection = lightDirection;
+                    params.cameraForward = Vector4(0, 0, 0, 0);
+                    params.clusterScale = Vector4(0, 0, 0, 0);
+                    params.clusterGrid = Vector4(0, 0, 0, 0);
+                    params.unjitteredViewProjection.Identity();
+                    params.previousViewProjection.Identity();
+
+                    if (camera != nullptr)
+                    {
+                        params.viewProjection = camera->GetViewProjectionMatrix();
+                        params.cameraPosition = Vector4(camera->GetTransform().Position, 0);
+                        // Camera looks along negative z of its transform.
+                        params.cameraForward = Vector4(camera->GetViewMatrix().Forward().Normal() * -1.0f, 0);
+                        params.unjitteredViewProjection = camera->GetUnjitteredViewProjectionMatrix();
+                        // Zero motion until previous frame is known.
+                        params.previousViewProjection = _renderContext->HasPreviousViewProjection()
+                                                            ? _renderContext->GetPreviousViewProjection()
+                                                            : params.unjitteredViewProjection;
+                    }
+
+                    const auto& lightClusters = _renderContext->GetLightClusters();
+                    if (lightClusters != nullptr)
+                    {
+                        params.clusterScale = Vector4(static_cast<float>(LightClusters::TilesX) / viewportWidth,
+                                                      static_cast<float>(LightClusters::TilesY) / viewportHeight,
+                                                      lightClusters->GetSliceScale(), lightClusters->GetSliceBias());
+                        params.clusterGrid = Vector4(static_cast<float>(LightClusters::TilesX), static_cast<float>(LightClusters::TilesY),
+                                                     static_cast<float>(LightClusters::Slices), static_cast<float>(lightClusters->GetLightsCount()));
+                    }
+
+                    if (_uniformRing->Write(UniformBlock::FRAME, &params, sizeof(params)))
+                        return;
+                }
+
+                shader->SetParam(Uniform::Type::LIGHT_DIR, lightDirection);
+
+                if (camera != nullptr)
+                {
                     shader->SetParam(Uniform::Type::VIEW_PROJECTION_MATRIX, camera->GetViewProjectionMatrix());
-                    shader->SetParam(Uniform::Type::CAMERA_POSITION, Vector4(cameraPos, 0));
+                    shader->SetParam(Uniform::Type::CAMERA_POSITION, Vector4(camera->GetTransform().Position, 0));
                 }
             }
 
@@ -199,7 +526,18 @@ namespace OpenDemo
                 const auto& shader = _renderContext->GetShader();
                 const auto& material = renderElement.material;
 
-                shader->SetParam(Uniform::Type::MODEL_MATRIX, renderElement.modelMatrix);
+                const auto& mesh = renderElement.mesh;
+                const Matrix4 modelMatrix = mesh->HasQuantizedPositions()
+                                                ? renderElement.modelMatrix * mesh->GetPositionDequantization()
+                                                : renderElement.modelMatrix;
+
+                shader->SetParam(Uniform::Type::MODEL_MATRIX, modelMatrix);
+                // Instance attribute arrays are disabled outside of batches, so shaders read generic attribute value.
+                for (uint32_t column = 0; column < 4; column++)
+                    glVertexAttrib4fv(Attributes::INSTANCE_MODEL + column, &modelMatrix.e00 + column * 4);
+
+                const Vector4 layers = getMaterialLayers(material);
+                glVertexAttrib4fv(Attributes::INSTANCE_LAYERS, &layers.x);
                 // shader->SetParam(Uniform::Type::MATERIAL, Vector4(renderElement.material.roughness,1,1,1));
 
                 if (material.albedoMap)
@@ -214,31 +552,369 @@ namespace OpenDemo
                 if (material.roughnessMap)
                     material.roughnessMap->Bind(Sampler::ROUGHNESS);
 
-                renderElement.mesh->Draw();
+                mesh->Draw();
+            }
+
+            void Render::DrawElements(const std::vector<RenderElement>& renderElements)
+            {
+                // Key layout: shader 8 | material 12 | mesh 12 | depth 32 bits, ids are assigned in first seen order.
+                // Depth only passes don't bind materials, so material bits hold coarse depth to draw front to back.
+                constexpr uint32_t MaxMaterialId = (1u << 12) - 1;
+                constexpr uint32_t MaxMeshId = (1u << 12) - 1;
+                // Exponent and top mantissa bits of squared distance, about eight buckets per distance octave.
+                constexpr uint32_t CoarseDepthShift = 20;
+
+                const bool depthOnly = _renderContext->GetDepthOnly();
+
+                const auto& camera = _renderContext->GetCamera();
+                const auto cameraPosition = camera ? camera->GetTransform().Position : Vector3(0.0f);
+
+                std::unordered_map<const Rendering::Mesh*, uint32_t> meshIds;
+                std::map<std::array<const CommonTexture*, Sampler::SAMPLER_MAX>, uint32_t> materialIds;
+
+                _statistics = {};
+                _sortItems.clear();
+                _sortItems.reserve(renderElements.size());
+
+                for (uint32_t index = 0; index < renderElements.size(); index++)
+                {
+                    const auto& element = renderElements[index];
+                    const auto& material = element.material;
+                    const std::array<const CommonTexture*, Sampler::SAMPLER_MAX> textures = {
+                        material.albedoMap.get(), material.normalMap.get(), material.roughnessMap.get(), material.metallicMap.get()
+                    };
+
+                    const uint32_t meshId = meshIds.emplace(element.mesh.get(), static_cast<uint32_t>(meshIds.size())).first->second;
+
+                    // Squared distance is non negative, so its bit pattern orders as unsigned integer.
+                    const float distance = (element.modelMatrix.getPos() - cameraPosition).LengthSqr();
+                    uint32_t depth;
+                    std::memcpy(&depth, &distance, sizeof(depth));
+
+                    const uint32_t materialId = depthOnly
+                                                    ? (depth >> CoarseDepthShift)
+                                                    : materialIds.emplace(textures, static_cast<uint32_t>(materialIds.size())).first->second;
+
+                    const uint64_t key = (static_cast<uint64_t>(std::min(materialId, MaxMaterialId)) << 44) |
+                                         (static_cast<uint64_t>(std::min(meshId, MaxMeshId)) << 32) |
+                                         depth;
+
+                    _sortItems.push_back({ key, index });
+                }
+
+                std::sort(_sortItems.begin(), _sortItems.end(), [](const SortItem& a, const SortItem& b) { return a.key < b.key; });
+
+                _instanceMatrices.clear();
+                _instanceMatrices.reserve(_sortItems.size());
+                _instanceLayers.clear();
+                _instanceLayers.reserve(_sortItems.size());
+                for (const auto& item : _sortItems)
+                {
+                    const auto& element = renderElements[item.index];
+                    _instanceMatrices.push_back(element.mesh->HasQuantizedPositions()
+                                                    ? element.modelMatrix * element.mesh->GetPositionDequantization()
+                                                    : element.modelMatrix);
+                    _instanceLayers.push_back(getMaterialLayers(element.material));
+                }
+
+                // Orphan previous storage, so upload doesn't wait for draws of last frame.
+                glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+                glBufferData(GL_ARRAY_BUFFER, _instanceMatrices.size() * sizeof(Matrix4), nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, _instanceMatrices.size() * sizeof(Matrix4), _instanceMatrices.data());
+
+                glBindBuffer(GL_ARRAY_BUFFER, _instanceLayersBuffer);
+                glBufferData(GL_ARRAY_BUFFER, _instanceLayers.size() * sizeof(Vector4), nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, _instanceLayers.size() * sizeof(Vector4), _instanceLayers.data());
+
+                const auto isSameBatch = [depthOnly](const RenderElement& a, const RenderElement& b) {
+                    if (depthOnly)
+                        return a.mesh == b.mesh;
+
+                    return a.mesh == b.mesh &&
+                           a.material.albedoMap == b.material.albedoMap &&
+                           a.material.normalMap == b.material.normalMap &&
+                           a.material.metallicMap == b.material.metallicMap &&
+                           a.material.roughnessMap == b.material.roughnessMap;
+                };
+
+                const auto frustum = camera ? camera->GetFrustum() : Frustum();
+
+                GLuint boundVertexArray = 0;
+                for (size_t first = 0; first < _sortItems.size();)
+                {
+                    const auto& element = renderElements[_sortItems[first].index];
+                    const auto& material = element.material;
+
+                    size_t last = first + 1;
+                    while (last < _sortItems.size() && isSameBatch(element, renderElements[_sortItems[last].index]))
+                        last++;
+
+                    if (!depthOnly)
+                    {
+                        bindTexture(material.albedoMap, Sampler::ALBEDO);
+                        bindTexture(material.normalMap, Sampler::NORMAL);
+                        bindTexture(material.metallicMap, Sampler::METALLIC);
+                        bindTexture(material.roughnessMap, Sampler::ROUGHNESS);
+                    }
+
+                    const auto mesh = static_cast<const OpenGL::Mesh*>(element.mesh.get());
+                    // Meshes of same vertex format share arena vertex array.
+                    if (mesh->GetVertexArray() != boundVertexArray)
+                    {
+                        mesh->Bind();
+                        boundVertexArray = mesh->GetVertexArray();
+                        _statistics.meshBinds++;
+                    }
+
+                    if (camera != nullptr && !mesh->GetMeshlets().empty())
+                    {
+                        drawMeshlets(renderElements, first, last, frustum, cameraPosition);
+                        first = last;
+                        continue;
+                    }
+
+                    // Instance attributes are VAO state, they are disabled after draw to keep DrawElement path intact.
+                    setInstanceAttributes(first, true);
+
+                    mesh->SubmitInstanced(static_cast<int32_t>(last - first));
+                    setInstanceAttributes(0, false);
+
+                    _statistics.drawCalls++;
+                    _statistics.instances += static_cast<uint32_t>(last - first);
+                    first = last;
+                }
+
+                if (boundVertexArray)
+                    glBindVertexArray(0);
+            }
+
+            void Render::drawMeshlets(const std::vector<RenderElement>& renderElements, size_t first, size_t last,
+                                      const Frustum& frustum, const Vector3& cameraPosition)
+            {
+                // There is no instanced multi draw in GL 3.3, so every instance is culled and drawn on its own.
+                for (size_t item = first; item < last; item++)
+                {
+                    const auto& element = renderElements[_sortItems[item].index];
+                    const auto mesh = static_cast<const OpenGL::Mesh*>(element.mesh.get());
+                    const auto& meshlets = mesh->GetMeshlets();
+
+                    // Meshlet bounds are in mesh space, so dequantization is not applied for culling.
+                    CullMeshlets(meshlets, element.modelMatrix, frustum, cameraPosition, _visibleMeshlets);
+
+                    _statistics.meshlets += static_cast<uint32_t>(_visibleMeshlets.size());
+                    _statistics.culledMeshlets += static_cast<uint32_t>(meshlets.size() - _visibleMeshlets.size());
+
+                    if (_visibleMeshlets.empty())
+                        continue;
+
+                    const auto& modelMatrix = _instanceMatrices[item];
+                    for (uint32_t column = 0; column < 4; column++)
+                        glVertexAttrib4fv(Attributes::INSTANCE_MODEL + column, &modelMatrix.e00 + column * 4);
+                    glVertexAttrib4fv(Attributes::INSTANCE_LAYERS, &_instanceLayers[item].x);
+
+                    mesh->SubmitMeshlets(_visibleMeshlets);
+
+                    _statistics.drawCalls++;
+                    _statistics.instances++;
+                }
+            }
+
+            void Render::setInstanceAttributes(size_t firstInstance, bool enable) const
+            {
+                if (!enable)
+                {
+                    for (uint32_t column = 0; column < 4; column++)
+                        glDisableVertexAttribArray(Attributes::INSTANCE_MODEL + column);
+                    glDisableVertexAttribArray(Attributes::INSTANCE_LAYERS);
+                    return;
+                }
+
+                glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+                for (uint32_t column = 0; column < 4; column++)
+                {
+                    const auto location = Attributes::INSTANCE_MODEL + column;
+
+                    glEnableVertexAttribArray(location);
+                    glVertexAttribPointer(location, 4, GL_FLOAT, false, sizeof(Matrix4), (void*)(firstInstance * sizeof(Matrix4) + column * sizeof(Vector4)));
+                    glVertexAttribDivisor(location, 1);
+                }
+
+                glBindBuffer(GL_ARRAY_BUFFER, _instanceLayersBuffer);
+                glEnableVertexAttribArray(Attributes::INSTANCE_LAYERS);
+                glVertexAttribPointer(Attributes::INSTANCE_LAYERS, 4, GL_FLOAT, false, sizeof(Vector4), (void*)(firstInstance * sizeof(Vector4)));
+                glVertexAttribDivisor(Attributes::INSTANCE_LAYERS, 1);
+            }
+
+            void Render::bindTexture(const std::shared_ptr<CommonTexture>& texture, Sampler::Type sampler)
+            {
+                // Missing texture keeps whatever was bound before, same as DrawElement.
+                if (!texture || _boundTextures[sampler] == texture.get())
+                    return;
+
+                texture->Bind(sampler);
+                _boundTextures[sampler] = texture.get();
+                _statistics.textureBinds++;
             }
 
             void Render::End() const
             {
             }
 
-            std::shared_ptr<Rendering::Texture2D> Render::CreateTexture2D() const
+            bool Render::IsRenderTargetFormatSupported(PixelFormat format) const
+            {
+                ASSERT(format < PIXEL_FORMAT_MAX);
+
+                auto& support = _renderTargetFormatSupport[format];
+                if (support != 0)
+                    return support > 0;
+
+                OpenGL::Texture2D texture;
+                texture.Init({ 4, 4, format }, nullptr);
+
+                // Blit framebuffer is rebound on every use, so probing can borrow it.
+                glBindFramebuffer(GL_FRAMEBUFFER, _blitFramebuffer);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, format == D16 ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.GetNativeId(), 0);
+
+                const bool supported = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+                glFramebufferTexture2D(GL_FRAMEBUFFER, format == D16 ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+                support = supported ? 1 : -1;
+                return supported;
+            }
+
+            void Render::DrawFullScreenTriangle() const
+            {
+                glBindVertexArray(_emptyVertexArray);
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+                glBindVertexArray(0);
+            }
+
+            void Render::Blit(const std::shared_ptr<Rendering::Texture2D>& source, int sourceLevel, const std::shared_ptr<Rendering::Texture2D>& target, int targetLevel,
+                              const std::shared_ptr<Rendering::Shader>& shader, const Vector4& params, bool additive)
+            {
+                ASSERT(source != target || sourceLevel != targetLevel);
+                ASSERT(sourceLevel < source->GetMipLevels() && targetLevel < target->GetMipLevels());
+
+                const auto openGlSource = static_cast<OpenGL::Texture2D*>(source.get());
+                const auto openGlTarget = static_cast<OpenGL::Texture2D*>(target.get());
+
+                const int width = std::max(1, target->GetWidth() >> targetLevel);
+                const int height = std::max(1, target->GetHeight() >> targetLevel);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, _blitFramebuffer);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, openGlTarget->GetNativeId(), targetLevel);
+                glViewport(0, 0, width, height);
+                glScissor(0, 0, width, height);
+
+                glDisable(GL_DEPTH_TEST);
+                glDepthMask(GL_FALSE);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                ApplyBlending(additive, BlendingDescription(BlendingMode::ADDITIVE));
+
+                openGlSource->Bind(Sampler::ALBEDO);
+                // Only source mip is visible to sampler, so writing other mip of same texture isn't a feedback loop.
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, sourceLevel);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, sourceLevel);
+                // Filters would wrap around otherwise.
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+                shader->Bind();
+                shader->SetParam(Uniform::BLIT_PARAMS, params);
+                DrawFullScreenTriangle();
+
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, source->GetMipLevels() - 1);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                _boundTextures.fill(nullptr);
+            }
+
+            std::shared_ptr<Rendering::Texture2DArray> Render::CreateTexture2DArray() const
             {
-                return std::shared_ptr<OpenGL::Texture2D>(new OpenGL::Texture2D());
+                return std::make_shared<OpenGL::Texture2DArray>();
             }
 
             std::shared_ptr<Rendering::Shader> Render::CreateShader() const
             {
-                return std::shared_ptr<OpenGL::Shader>(new OpenGL::Shader());
+                return std::make_shared<OpenGL::Shader>(_programCache);
+            }
+
+            std::shared_ptr<Rendering::SkinnedMesh> Render::CreateSkinnedMesh() const
+            {
+                return std::make_shared<OpenGL::SkinnedMesh>(_geometryArena);
             }
 
-            std::shared_ptr<Rendering::Mesh> Render::CreateMesh() const
+            void Render::StreamTexture2D(const std::shared_ptr<Rendering::Texture2D>& texture, std::vector<uint8_t>&& data)
             {
-                return std::shared_ptr<OpenGL::Mesh>(new OpenGL::Mesh());
+                ASSERT(_textureStreamer);
+
+                auto const& openGlTexture = std::dynamic_pointer_cast<OpenGL::Texture2D, Rendering::Texture2D>(texture);
+                _textureStreamer->Enqueue(openGlTexture, std::move(data));
+            }
+
+            void Render::Skin(const Rendering::SkinnedMesh& skinnedMesh, const std::vector<Matrix4>& palette, const std::shared_ptr<Rendering::Shader>& shader)
+            {
+                ASSERT(palette.size() <= Skeleton::MaxJoints);
+
+                const auto& openGlSkinnedMesh = static_cast<const OpenGL::SkinnedMesh&>(skinnedMesh);
+                const auto& output = static_cast<const OpenGL::Mesh&>(*skinnedMesh.GetMesh());
+                const auto& outputRange = output.GetVertexRange();
+
+                if (outputRange.size == 0)
+                    return;
+
+                ASSERT(output.GetVertexFormat() == VERTEX_FORMAT_FULL);
+                ASSERT(static_cast<int32_t>(outputRange.size) == openGlSkinnedMesh.GetVerticesCount());
+
+                const size_t paletteSize = palette.size() * sizeof(Matrix4);
+                if (!_uniformRing->Write(UniformBlock::SKINNING, palette.data(), paletteSize))
+                {
+                    glBindBuffer(GL_UNIFORM_BUFFER, _skinningBuffer);
+                    // Orphaned every call, so previous skinning keeps reading its own palette.
+                    glBufferData(GL_UNIFORM_BUFFER, Skeleton::MaxJoints * sizeof(Matrix4), nullptr, GL_STREAM_DRAW);
+                    glBufferSubData(GL_UNIFORM_BUFFER, 0, paletteSize, palette.data());
+                    glBindBufferBase(GL_UNIFORM_BUFFER, UniformBlock::SKINNING, _skinningBuffer);
+                }
+
+                shader->Bind();
+
+                const GLsizeiptr stride = sizeof(Rendering::Vertex);
+                glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _geometryArena->GetVertexBuffer(VERTEX_FORMAT_FULL), outputRange.offset * stride, outputRange.size * stride);
+
+                glEnable(GL_RASTERIZER_DISCARD);
+                glBindVertexArray(openGlSkinnedMesh.GetSourceVertexArray());
+
+                glBeginTransformFeedback(GL_POINTS);
+                glDrawArrays(GL_POINTS, 0, openGlSkinnedMesh.GetVerticesCount());
+                glEndTransformFeedback();
+
+                glBindVertexArray(0);
+                glDisable(GL_RASTERIZER_DISCARD);
+                glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
             }
 
-            std::shared_ptr<Rendering::RenderTargetContext> Render::CreateRenderTargetContext() const
+            void Render::CopyDepth(const std::shared_ptr<Rendering::RenderTargetContext>& source, const std::shared_ptr<Rendering::RenderTargetContext>& target)
             {
-                return std::shared_ptr<OpenGL::RenderTargetContext>(new OpenGL::RenderTargetContext);
+                ASSERT(source && target);
+                ASSERT(source->GetWidth() == target->GetWidth() && source->GetHeight() == target->GetHeight());
+
+                const auto openGlSource = static_cast<OpenGL::RenderTargetContext*>(source.get());
+                const auto openGlTarget = static_cast<OpenGL::RenderTargetContext*>(target.get());
+
+                const int width = source->GetWidth();
+                const int height = source->GetHeight();
+
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, openGlSource->GetNativeId());
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, openGlTarget->GetNativeId());
+                // Blit is clipped by scissor and masked by depth write state.
+                glScissor(0, 0, width, height);
+                glDepthMask(GL_TRUE);
+                glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
             }
 
             void Render::ApplyBlending(bool blending, const BlendingDescription& description) const
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "rendering/Render.hpp"
+#include "rendering/Shader.hpp"
+#include "rendering/Texture.hpp"
 
 typedef void* SDL_GLContext;
 
@@ -9,6 +11,8 @@ namespace OpenDemo
     namespace Rendering
     {
         struct BlendingDescription;
+        struct Frustum;
+        class LightClusters;
     }
 
     namespace Rendering
@@ -19,15 +23,34 @@ namespace OpenDemo
             typedef uint32_t GLuint;
             typedef uint32_t GLenum;
 
+            class GeometryArena;
+            class ProgramCache;
+            class TextureStreamer;
+            class UniformRing;
+
             class Render final : public Rendering::Render
             {
+            public:
+                // GL calls issued by DrawElements during last frame pass.
+                struct Statistics
+                {
+                    uint32_t drawCalls = 0;
+                    uint32_t instances = 0;
+                    uint32_t meshBinds = 0;
+                    uint32_t textureBinds = 0;
+                    uint32_t meshlets = 0;
+                    uint32_t culledMeshlets = 0;
+                };
+
             public:
                 Render();
+                virtual ~Render() override;
 
                 virtual void Init(const std::shared_ptr<Windowing::Window>& window) override;
                 virtual void Terminate() override;
 
                 virtual void SwapBuffers() const override;
+                virtual float GetGpuFrameTime() override;
 
                 virtual void Clear(const Common::Vector4& color, float depth) const override;
                 virtual void ClearColor(const Common::Vector4& color) const override;
@@ -35,19 +58,90 @@ namespace OpenDemo
 
                 virtual void Begin(const std::shared_ptr<RenderContext>& renderContext) override;
                 virtual void DrawElement(const RenderElement& renderElement) const override;
+                // Sorts by shader, material, mesh and then front to back, binds only changed state.
+                // Consecutive elements sharing mesh and material are drawn as single instanced draw call.
+                virtual void DrawElements(const std::vector<RenderElement>& renderElements) override;
                 virtual void End() const override;
 
                 virtual std::shared_ptr<Rendering::Texture2D> CreateTexture2D() const override;
+                virtual std::shared_ptr<Rendering::Texture2DArray> CreateTexture2DArray() const override;
                 virtual std::shared_ptr<Rendering::Shader> CreateShader() const override;
                 virtual std::shared_ptr<Rendering::Mesh> CreateMesh() const override;
                 virtual std::shared_ptr<Rendering::RenderTargetContext> CreateRenderTargetContext() const override;
+                virtual std::shared_ptr<Rendering::SkinnedMesh> CreateSkinnedMesh() const override;
+
+                // Probed once per format by checking framebuffer completeness.
+                virtual bool IsRenderTargetFormatSupported(PixelFormat format) const override;
+                // Streamed through pixel unpack buffers within per frame budget, copies are issued on SwapBuffers.
+                virtual void StreamTexture2D(const std::shared_ptr<Rendering::Texture2D>& texture, std::vector<uint8_t>&& data) override;
+
+                // Empty vertex array is bound, core profile doesn't allow draws without one.
+                virtual void DrawFullScreenTriangle() const override;
+                virtual void Blit(const std::shared_ptr<Rendering::Texture2D>& source, int sourceLevel, const std::shared_ptr<Rendering::Texture2D>& target, int targetLevel,
+                                  const std::shared_ptr<Rendering::Shader>& shader, const Vector4& params, bool additive) override;
+                // Vertex shader output is captured by transform feedback with rasterization disabled.
+                virtual void Skin(const Rendering::SkinnedMesh& skinnedMesh, const std::vector<Matrix4>& palette, const std::shared_ptr<Rendering::Shader>& shader) override;
+                virtual void CopyDepth(const std::shared_ptr<Rendering::RenderTargetContext>& source, const std::shared_ptr<Rendering::RenderTargetContext>& target) override;
+
+                inline const Statistics& GetStatistics() const { return _statistics; }
 
             private:
+                struct SortItem
+                {
+                    uint64_t key;
+                    uint32_t index;
+                };
+
                 void ApplyBlending(bool blending, const BlendingDescription& description) const;
+                void bindTexture(const std::shared_ptr<CommonTexture>& texture, Sampler::Type sampler);
+                void setInstanceAttributes(size_t firstInstance, bool enable) const;
+                void drawMeshlets(const std::vector<RenderElement>& renderElements, size_t first, size_t last,
+                                  const Frustum& frustum, const Vector3& cameraPosition);
+                void setFrameParams(const Vector4& lightDirection, int viewportWidth, int viewportHeight) const;
+                void bindLightClusters(const LightClusters& lightClusters);
+                void beginFrameTimer();
+                void endFrameTimer() const;
 
                 std::shared_ptr<Windowing::Window> _window;
                 std::shared_ptr<RenderContext> _renderContext;
                 SDL_GLContext _context;
+
+                Statistics _statistics;
+                std::vector<SortItem> _sortItems;
+                // Model matrices in sorted order, streamed to _instanceBuffer every DrawElements.
+                std::vector<Matrix4> _instanceMatrices;
+                // Material layers in sorted order, streamed to _instanceLayersBuffer along with matrices.
+                std::vector<Vector4> _instanceLayers;
+                std::vector<uint32_t> _visibleMeshlets;
+                GLuint _instanceBuffer = 0;
+                GLuint _instanceLayersBuffer = 0;
+                // Target of Blit, never bound by render target contexts.
+                GLuint _blitFramebuffer = 0;
+                // Vertex array without attributes for full screen triangles.
+                GLuint _emptyVertexArray = 0;
+                // Zero is not probed yet, positive is supported.
+                mutable std::array<int8_t, PIXEL_FORMAT_MAX> _renderTargetFormatSupport = {};
+                std::shared_ptr<GeometryArena> _geometryArena;
+                // Linked program binaries, shared with shaders created by CreateShader.
+                std::shared_ptr<ProgramCache> _programCache;
+                // Palettes which don't fit into uniform ring region are streamed through it.
+                GLuint _skinningBuffer = 0;
+                // Per frame uniform blocks, advanced on SwapBuffers.
+                std::unique_ptr<UniformRing> _uniformRing;
+                std::unique_ptr<TextureStreamer> _textureStreamer;
+                // Textures can be rebound outside of DrawElements, so tracking is reset on Begin.
+                std::array<const CommonTexture*, Sampler::SAMPLER_MAX> _boundTextures;
+                // Texture buffers with cluster light lists, reuploaded only when clusters are rebuilt.
+                std::array<GLuint, BufferSampler::BUFFER_SAMPLER_MAX> _lightBuffers = {};
+                std::array<GLuint, BufferSampler::BUFFER_SAMPLER_MAX> _lightTextures = {};
+                const LightClusters* _uploadedLightClusters = nullptr;
+                uint32_t _uploadedLightClustersRevision = 0;
+                // Frame GPU time queries, read back a few frames later so results are ready without stalling.
+                std::array<GLuint, 4> _timerQueries = {};
+                // Monotonic counters of issued and resolved queries, ring slot is counter modulo ring size.
+                mutable uint64_t _timerQueriesIssued = 0;
+                uint64_t _timerQueriesResolved = 0;
+                mutable bool _timerQueryActive = false;
             };
         }
     }
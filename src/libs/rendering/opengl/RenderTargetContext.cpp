@@ -26,36 +26,59 @@ namespace OpenDemo
             {
                 Rendering::RenderTargetContext::SetColorTarget(index, renderTargetDescription);
 
-                Bind();
-
                 auto const& texture = renderTargetDescription.texture;
-                if (texture)
-                {
-                    auto const& openGlTexture = std::dynamic_pointer_cast<Rendering::OpenGL::Texture2D, Rendering::CommonTexture>(texture);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, openGlTexture->GetNativeId(), 0);
-                }
+                // Draw buffers name color attachments only when there are ones, otherwise framebuffer is incomplete.
+                _hasColorTargets[index] = texture != nullptr;
+
+                Bind();
+                attach(GL_COLOR_ATTACHMENT0 + index, renderTargetDescription);
             }
 
-            //TODO remove duplicated code
             void RenderTargetContext::SetDepthStencilTarget(const RenderTarget::RenderTargetDescription& renderTargetDescription)
             {
                 Rendering::RenderTargetContext::SetDepthStencilTarget(renderTargetDescription);
 
                 Bind();
+                attach(GL_DEPTH_ATTACHMENT, renderTargetDescription);
+            }
+
+            void RenderTargetContext::Resize(int width, int height)
+            {
+                Rendering::RenderTargetContext::Resize(width, height);
+
+                // Textures with immutable storage are recreated on resize, attachments would point to deleted objects.
+                Bind();
+                attach(GL_DEPTH_ATTACHMENT, getDepthStencilTarget());
+                for (int index = 0; index < RenderTargetIndex::INDEX_MAX; index++)
+                    attach(GL_COLOR_ATTACHMENT0 + index, getColorTarget(static_cast<RenderTargetIndex>(index)));
+            }
 
+            void RenderTargetContext::attach(GLenum attachment, const RenderTarget::RenderTargetDescription& renderTargetDescription)
+            {
                 auto const& texture = renderTargetDescription.texture;
-                if (texture)
-                {
-                    auto const& openGlTexture = std::dynamic_pointer_cast<Rendering::OpenGL::Texture2D, Rendering::CommonTexture>(texture);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, openGlTexture->GetNativeId(), 0);
-                }
+                if (!texture)
+                    return;
+
+                auto const& openGlTexture = std::dynamic_pointer_cast<Rendering::OpenGL::Texture2D, Rendering::CommonTexture>(texture);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, openGlTexture->GetNativeId(), renderTargetDescription.mipLevel);
             }
 
             void RenderTargetContext::Bind()
             {
                 glBindFramebuffer(GL_FRAMEBUFFER, _id);
-                GLenum DrawBuffers[1] = { GL_COLOR_ATTACHMENT0 }; //TODO FIX IT IMMEDIATELY
-                glDrawBuffers(1, DrawBuffers);
+
+                // Fragment output locations match attachment indices, gaps are left as GL_NONE.
+                std::array<GLenum, RenderTargetIndex::INDEX_MAX> drawBuffers;
+                GLsizei drawBuffersCount = 1;
+                for (int index = 0; index < RenderTargetIndex::INDEX_MAX; index++)
+                {
+                    drawBuffers[index] = _hasColorTargets[index] ? GL_COLOR_ATTACHMENT0 + index : GL_NONE;
+                    if (_hasColorTargets[index])
+                        drawBuffersCount = index + 1;
+                }
+
+                glDrawBuffers(drawBuffersCount, drawBuffers.data());
+                glReadBuffer(drawBuffers[0]);
             }
         }
     }
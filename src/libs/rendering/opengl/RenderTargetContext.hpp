@@ -3,6 +3,8 @@
 #include "rendering/RenderTargetContext.hpp"
 #include "rendering/opengl/Render.hpp"
 
+#include <array>
+
 namespace OpenDemo
 {
     namespace Rendering
@@ -18,10 +20,18 @@ namespace OpenDemo
                 virtual void SetDepthStencilTarget(const RenderTarget::RenderTargetDescription& renderTargetDescription) override;
                 virtual void SetColorTarget(RenderTargetIndex index, const RenderTarget::RenderTargetDescription& renderTargetDescription) override;
 
+                virtual void Resize(int width, int height) override;
+
                 virtual void Bind() override;
 
+                inline GLuint GetNativeId() const { return _id; }
+
+            private:
+                void attach(GLenum attachment, const RenderTarget::RenderTargetDescription& renderTargetDescription);
+
             private:
                 GLuint _id;
+                std::array<bool, RenderTargetIndex::INDEX_MAX> _hasColorTargets = {};
             };
         }
     }
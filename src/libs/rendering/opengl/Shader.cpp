@@ -2,6 +2,8 @@
 
 #include "glad/glad.h"
 
+#include <string>
+
 #include "common/Stream.hpp"
 
 #include "rendering/opengl/Render.hpp"
@@ -12,55 +14,141 @@ namespace OpenDemo
     {
         namespace OpenGL
         {
-            Shader::Shader()
-                : _id(glCreateProgram())
+            namespace
+            {
+                const char GLSL_VERSION[] = "#version 330 core\n";
+            }
+
+            Shader::Shader(const std::shared_ptr<ProgramCache>& programCache)
+                : _id(glCreateProgram()),
+                  _programCache(programCache && programCache->IsSupported() ? programCache : nullptr)
             {
             }
 
             Shader::~Shader()
             {
+                for (const auto obj : _pendingShaders)
+                {
+                    if (obj)
+                        glDeleteShader(obj);
+                }
+
                 glDeleteProgram(_id);
             }
 
-            bool Shader::LinkSource(const std::shared_ptr<Common::Stream>& stream)
+            void Shader::BeginLink(const std::shared_ptr<Common::Stream>& stream)
             {
-                const char GLSL_VERT[] = "#define VERTEX\n";
-                const char GLSL_FRAG[] = "#define FRAGMENT\n";
+                ASSERT(!_linkPending);
+
+                _pendingText.assign(static_cast<size_t>(stream->GetSize()), '\0');
+                stream->Read(_pendingText.data(), _pendingText.size());
+
+                // Stage defines are the same for every shader, version and source are enough for the key.
+                const char* const keySources[2] = { GLSL_VERSION, _pendingText.c_str() };
+                _pendingKey = _programCache ? _programCache->GetKey(keySources, 2) : 0;
 
-                size_t shaderSize = static_cast<size_t>(stream->GetSize());
-                char* text = new char[shaderSize + 1];
-                text[shaderSize] = 0;
+                _pendingBinary = _programCache && issueBinary();
+                if (!_pendingBinary)
+                    issueSource();
+
+                _linkPending = true;
+            }
+
+            bool Shader::EndLink()
+            {
+                ASSERT(_linkPending);
+                _linkPending = false;
+
+                bool linked = false;
+
+                if (_pendingBinary && checkLink())
+                {
+                    // Uniform values and block bindings aren't part of binary, only locations are reused.
+                    applyLocations(_pendingLocations);
+                    linked = true;
+                }
+                else
+                {
+                    // Driver may reject binary even for same version, e.g. after hardware change. Program is relinked from source then.
+                    if (_pendingBinary)
+                    {
+                        Log::Format::Warning(FMT_STRING("Program binary {:016x} was rejected, compiling from source\n"), _pendingKey);
+                        issueSource();
+                    }
+
+                    linked = finishSource();
+                }
 
-                stream->Read(text, shaderSize);
+                _pendingText.clear();
+                _pendingText.shrink_to_fit();
+
+                return linked;
+            }
+
+            bool Shader::issueBinary()
+            {
+                ProgramCache::Entry entry;
+                if (!_programCache->Load(_pendingKey, entry))
+                    return false;
+
+                glProgramBinary(_id, entry.binaryFormat, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+                _pendingLocations = entry.locations;
+
+                return true;
+            }
+
+            void Shader::issueSource()
+            {
+                const char GLSL_VERT[] = "#define VERTEX\n";
+                const char GLSL_FRAG[] = "#define FRAGMENT\n";
 
                 const int type[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
                 const char* code[2][4] = {
-                    { "#version 330 core\n", GLSL_VERT, "#line 0\n", text },
-                    { "#version 330 core\n", GLSL_FRAG, "#line 0\n", text }
+                    { GLSL_VERSION, GLSL_VERT, "#line 0\n", _pendingText.c_str() },
+                    { GLSL_VERSION, GLSL_FRAG, "#line 0\n", _pendingText.c_str() }
                 };
 
-                GLchar info[1024];
-
+                // Nothing is queried here, so driver with parallel compilation doesn't have to finish before EndLink.
                 for (int i = 0; i < 2; i++)
                 {
                     GLuint obj = glCreateShader(type[i]);
                     glShaderSource(obj, 4, code[i], NULL);
                     glCompileShader(obj);
 
-                    glGetShaderInfoLog(obj, sizeof(info), NULL, info);
-                    if (info[0])
-                        Log::Format::Warning(FMT_STRING("! shader: {}\n"), info);
-
                     glAttachShader(_id, obj);
-                    glDeleteShader(obj);
+                    _pendingShaders[i] = obj;
                 }
 
-                delete[] text;
+                // Vertex captured by transform feedback is laid out as Rendering::Vertex, see Render::Skin.
+                if (_pendingText.find("#define FEEDBACK_VERTEX") != std::string::npos)
+                {
+                    static const char* const varyings[] = { "OutPosition", "OutTexCoord", "OutNormal", "OutTangent", "OutBinormal", "OutColor" };
+                    glTransformFeedbackVaryings(_id, 6, varyings, GL_INTERLEAVED_ATTRIBS);
+                }
 
                 //        for (int at = 0; at < aMAX; at++)
                 //            glBindAttribLocation(id, at, AttribName[at]);
 
+                if (_programCache)
+                    glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
                 glLinkProgram(_id);
+            }
+
+            bool Shader::finishSource()
+            {
+                GLchar info[1024];
+
+                for (auto& obj : _pendingShaders)
+                {
+                    glGetShaderInfoLog(obj, sizeof(info), NULL, info);
+                    if (info[0])
+                        Log::Format::Warning(FMT_STRING("! shader: {}\n"), info);
+
+                    glDetachShader(_id, obj);
+                    glDeleteShader(obj);
+                    obj = 0;
+                }
 
                 glGetProgramInfoLog(_id, sizeof(info), NULL, info);
                 if (info[0])
@@ -69,19 +157,77 @@ namespace OpenDemo
                 if (!checkLink())
                     return false;
 
-                Bind();
+                ProgramCache::Locations locations;
+                queryLocations(locations);
+                applyLocations(locations);
+
+                if (_programCache)
+                    storeBinary(_pendingKey, locations);
+
+                return true;
+            }
+
+            void Shader::storeBinary(uint64_t key, const ProgramCache::Locations& locations) const
+            {
+                GLint length = 0;
+                glGetProgramiv(_id, GL_PROGRAM_BINARY_LENGTH, &length);
+                if (length <= 0)
+                    return;
 
+                ProgramCache::Entry entry;
+                entry.binary.resize(static_cast<size_t>(length));
+                entry.locations = locations;
+
+                GLsizei written = 0;
+                glGetProgramBinary(_id, length, &written, &entry.binaryFormat, entry.binary.data());
+                if (written <= 0)
+                    return;
+
+                entry.binary.resize(static_cast<size_t>(written));
+                _programCache->Store(key, entry);
+            }
+
+            void Shader::queryLocations(ProgramCache::Locations& locations) const
+            {
                 for (int ut = 0; ut < Uniform::UNIFORM_MAX; ut++)
-                    _uniformID[ut] = glGetUniformLocation(_id, (GLchar*)UniformsNames[ut]);
+                    locations.uniforms[ut] = glGetUniformLocation(_id, (GLchar*)UniformsNames[ut]);
+
+                for (int ub = 0; ub < UniformBlock::UNIFORM_BLOCK_MAX; ub++)
+                    locations.uniformBlocks[ub] = glGetUniformBlockIndex(_id, UniformBlockNames[ub]);
 
                 for (int st = 0; st < Sampler::SAMPLER_MAX; st++)
+                    locations.samplers[st] = glGetUniformLocation(_id, (GLchar*)SamplerNames[st]);
+
+                for (int bt = 0; bt < BufferSampler::BUFFER_SAMPLER_MAX; bt++)
+                    locations.bufferSamplers[bt] = glGetUniformLocation(_id, (GLchar*)BufferSamplerNames[bt]);
+            }
+
+            void Shader::applyLocations(const ProgramCache::Locations& locations)
+            {
+                Bind();
+
+                _uniformID = locations.uniforms;
+
+                for (int ub = 0; ub < UniformBlock::UNIFORM_BLOCK_MAX; ub++)
                 {
-                    GLint idx = glGetUniformLocation(_id, (GLchar*)SamplerNames[st]);
-                    if (idx != -1)
-                        glUniform1iv(idx, 1, &st);
+                    const GLuint idx = locations.uniformBlocks[ub];
+                    _uniformBlocks[ub] = idx != GL_INVALID_INDEX;
+
+                    if (_uniformBlocks[ub])
+                        glUniformBlockBinding(_id, idx, ub);
                 }
 
-                return true;
+                for (int st = 0; st < Sampler::SAMPLER_MAX; st++)
+                {
+                    if (locations.samplers[st] != -1)
+                        glUniform1iv(locations.samplers[st], 1, &st);
+                }
+
+                for (int bt = 0; bt < BufferSampler::BUFFER_SAMPLER_MAX; bt++)
+                {
+                    if (locations.bufferSamplers[bt] != -1)
+                        glUniform1i(locations.bufferSamplers[bt], Sampler::SAMPLER_MAX + bt);
+                }
             }
 
             bool Shader::checkLink() const
@@ -4,6 +4,7 @@
 
 #include "rendering/Shader.hpp"
 
+#include "rendering/opengl/ProgramCache.hpp"
 #include "rendering/opengl/Render.hpp"
 
 namespace OpenDemo
@@ -20,20 +21,43 @@ namespace OpenDemo
             class Shader final : public Rendering::Shader
             {
             public:
-                Shader();
+                // Without program cache shaders are compiled on every link.
+                Shader(const std::shared_ptr<ProgramCache>& programCache = nullptr);
                 virtual ~Shader() override;
 
-                virtual bool LinkSource(const std::shared_ptr<Stream>& stream) override;
+                // Source is compiled on driver threads when GL_KHR_parallel_shader_compile is available, see Render::Init.
+                virtual void BeginLink(const std::shared_ptr<Stream>& stream) override;
+                virtual bool EndLink() override;
                 virtual void Bind() const override;
 
                 virtual void SetParam(Uniform::Type uType, const Vector4& value, int count = 1) const override;
                 virtual void SetParam(Uniform::Type uType, const Matrix4& value, int count = 1) const override;
                 //virtual void SetParam(Uniform::Type uType, const Common::Basis& value, int count = 1) const override;
 
+                inline bool HasUniformBlock(UniformBlock::Type type) const { return _uniformBlocks[type]; }
+
+            private:
+                bool checkLink() const;
+                bool issueBinary();
+                void issueSource();
+                bool finishSource();
+                void storeBinary(uint64_t key, const ProgramCache::Locations& locations) const;
+                void queryLocations(ProgramCache::Locations& locations) const;
+                void applyLocations(const ProgramCache::Locations& locations);
+
             private:
                 GLuint _id;
+                std::shared_ptr<ProgramCache> _programCache;
                 std::array<GLint, Uniform::UNIFORM_MAX> _uniformID = {};
-                bool checkLink() const;
+                std::array<bool, UniformBlock::UNIFORM_BLOCK_MAX> _uniformBlocks = {};
+
+                // State between BeginLink and EndLink.
+                bool _linkPending = false;
+                bool _pendingBinary = false;
+                uint64_t _pendingKey = 0;
+                std::string _pendingText;
+                std::array<GLuint, 2> _pendingShaders = {};
+                ProgramCache::Locations _pendingLocations;
             };
         }
     }
@@ -0,0 +1,99 @@
+#include "SkinnedMesh.hpp"
+
+#include "glad/glad.h"
+
+#include <cstddef>
+
+#include "rendering/Render.hpp"
+#include "rendering/opengl/Mesh.hpp"
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            SkinnedMesh::SkinnedMesh(const std::shared_ptr<GeometryArena>& arena)
+                : _arena(arena)
+            {
+            }
+
+            SkinnedMesh::~SkinnedMesh()
+            {
+                release();
+            }
+
+            void SkinnedMesh::Init(const std::vector<Vertex>& vertices, const std::vector<SkinVertex>& skin, const std::vector<int32_t>& indexes)
+            {
+                ASSERT(vertices.size() == skin.size());
+
+                release();
+
+                _vCount = static_cast<int32_t>(vertices.size());
+
+                // Output starts as bind pose, so mesh is drawable before first skinning.
+                auto mesh = std::make_shared<OpenGL::Mesh>(_arena);
+                mesh->Init(vertices, indexes);
+                _mesh = mesh;
+
+                glGenVertexArrays(1, &_sourceVertexArray);
+
+                // Source buffers are written once, immutable storage without flags lets driver place them in video memory.
+                if (GLAD_GL_VERSION_4_5)
+                {
+                    glCreateBuffers(1, &_vertexBuffer);
+                    glNamedBufferStorage(_vertexBuffer, vertices.size() * sizeof(Vertex), vertices.data(), 0);
+                    glCreateBuffers(1, &_skinBuffer);
+                    glNamedBufferStorage(_skinBuffer, skin.size() * sizeof(SkinVertex), skin.data(), 0);
+                }
+                else
+                {
+                    glGenBuffers(1, &_vertexBuffer);
+                    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+                    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+                    glGenBuffers(1, &_skinBuffer);
+                    glBindBuffer(GL_ARRAY_BUFFER, _skinBuffer);
+                    glBufferData(GL_ARRAY_BUFFER, skin.size() * sizeof(SkinVertex), skin.data(), GL_STATIC_DRAW);
+                }
+
+                glBindVertexArray(_sourceVertexArray);
+
+                glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+
+                for (const auto& attribute : VertexLayout::Get(VERTEX_FORMAT_FULL).attributes)
+                {
+                    glEnableVertexAttribArray(attribute.location);
+                    glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>(static_cast<size_t>(attribute.offset)));
+                }
+
+                glBindBuffer(GL_ARRAY_BUFFER, _skinBuffer);
+
+                glEnableVertexAttribArray(Attributes::SKIN_JOINTS);
+                glVertexAttribIPointer(Attributes::SKIN_JOINTS, 4, GL_UNSIGNED_BYTE, sizeof(SkinVertex), reinterpret_cast<const void*>(offsetof(SkinVertex, joints)));
+                glEnableVertexAttribArray(Attributes::SKIN_WEIGHTS);
+                glVertexAttribPointer(Attributes::SKIN_WEIGHTS, 4, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), reinterpret_cast<const void*>(offsetof(SkinVertex, weights)));
+
+                glBindVertexArray(0);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            }
+
+            void SkinnedMesh::release()
+            {
+                if (_sourceVertexArray)
+                    glDeleteVertexArrays(1, &_sourceVertexArray);
+
+                if (_vertexBuffer)
+                    glDeleteBuffers(1, &_vertexBuffer);
+
+                if (_skinBuffer)
+                    glDeleteBuffers(1, &_skinBuffer);
+
+                _sourceVertexArray = 0;
+                _vertexBuffer = 0;
+                _skinBuffer = 0;
+                _vCount = 0;
+                _mesh.reset();
+            }
+        }
+    }
+}
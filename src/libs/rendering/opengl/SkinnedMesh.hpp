@@ -0,0 +1,40 @@
+#pragma once
+
+#include "rendering/SkinnedMesh.hpp"
+
+#include "rendering/opengl/GeometryArena.hpp"
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            typedef uint32_t GLuint;
+
+            // Bind pose is kept in private buffers, skinned vertices are captured by transform feedback
+            // straight into output mesh range of geometry arena.
+            class SkinnedMesh final : public Rendering::SkinnedMesh
+            {
+            public:
+                SkinnedMesh(const std::shared_ptr<GeometryArena>& arena);
+                virtual ~SkinnedMesh() override;
+
+                virtual void Init(const std::vector<Vertex>& vertices, const std::vector<SkinVertex>& skin, const std::vector<int32_t>& indexes) override;
+
+                inline GLuint GetSourceVertexArray() const { return _sourceVertexArray; }
+                inline int32_t GetVerticesCount() const { return _vCount; }
+
+            private:
+                void release();
+
+            private:
+                std::shared_ptr<GeometryArena> _arena;
+                GLuint _sourceVertexArray = 0;
+                GLuint _vertexBuffer = 0;
+                GLuint _skinBuffer = 0;
+                int32_t _vCount = 0;
+            };
+        }
+    }
+}
@@ -2,6 +2,8 @@
 
 #include "glad/glad.h"
 
+#include <algorithm>
+
 namespace OpenDemo
 {
     namespace Rendering
@@ -9,9 +11,13 @@ namespace OpenDemo
         namespace OpenGL
         {
             Texture2D::Texture2D()
-                : _width(0), _height(0)
+                : _width(0), _height(0), _mipLevels(1)
             {
-                glGenTextures(1, &_id);
+                // Objects of glCreateTextures have target set, as required by direct state access.
+                if (GLAD_GL_VERSION_4_5)
+                    glCreateTextures(GL_TEXTURE_2D, 1, &_id);
+                else
+                    glGenTextures(1, &_id);
             }
 
             Texture2D::~Texture2D()
@@ -19,18 +25,21 @@ namespace OpenDemo
                 glDeleteTextures(1, &_id);
             }
 
-            Texture2D::OpenGlPixelFormatDescription Texture2D::GetOpenGlPixelFormatDescription(PixelFormat pixelFormat) const
+            Texture2D::OpenGlPixelFormatDescription Texture2D::GetOpenGlPixelFormatDescription(PixelFormat pixelFormat)
             {
                 static const OpenGlPixelFormatDescription formats[PIXEL_FORMAT_MAX] = {
-                    { GL_R8, GL_RED, GL_UNSIGNED_BYTE }, // R8
-                    { GL_RG8, GL_RG, GL_UNSIGNED_BYTE }, // RG8
-                    { GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE }, // RGB8
-                    { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE }, // RGBA8
-                    { GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5 }, // R5G6B5
-                    { GL_RGB5_A1, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1 }, // R5G5B5A1
-                    { GL_RGBA32F, GL_RGBA, GL_FLOAT }, // R32G32B32A32_FLOAT
-                    { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT }, // R16G16B16A16_HALF
-                    { GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT }, // D16
+                    { GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1 }, // R8
+                    { GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2 }, // RG8
+                    { GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, 3 }, // RGB8
+                    { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 }, // RGBA8
+                    { GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2 }, // R5G6B5
+                    { GL_RGB5_A1, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, 2 }, // R5G5B5A1
+                    { GL_RGBA32F, GL_RGBA, GL_FLOAT, 16 }, // R32G32B32A32_FLOAT
+                    { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8 }, // R16G16B16A16_HALF
+                    { GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, 2 }, // D16
+                    { GL_R32F, GL_RED, GL_FLOAT, 4 }, // R32F
+                    { GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV, 4 }, // R11G11B10F
+                    { GL_RG16F, GL_RG, GL_HALF_FLOAT, 4 }, // RG16F
                 };
 
                 return formats[pixelFormat];
@@ -40,16 +49,87 @@ namespace OpenDemo
             {
                 _width = description.width;
                 _height = description.height;
+                _mipLevels = description.mipLevels;
                 _pixelFormatDescription = GetOpenGlPixelFormatDescription(description.pixelFormat);
 
-                Bind(0);
-                glTexImage2D(GL_TEXTURE_2D, 0, _pixelFormatDescription.internalFormat, _width, _height, 0, _pixelFormatDescription.format, _pixelFormatDescription.type, data);
+                ASSERT(_mipLevels > 0);
+
+                allocateStorage(data);
+            }
+
+            void Texture2D::allocateStorage(void* data)
+            {
+                if (GLAD_GL_VERSION_4_5)
+                {
+                    if (_hasImmutableStorage)
+                    {
+                        glDeleteTextures(1, &_id);
+                        glCreateTextures(GL_TEXTURE_2D, 1, &_id);
+                    }
+
+                    // All mips are allocated at once, so driver doesn't revalidate completeness on use.
+                    glTextureStorage2D(_id, _mipLevels, _pixelFormatDescription.internalFormat, _width, _height);
+                    _hasImmutableStorage = true;
+
+                    // Only first mip is initialized with data.
+                    if (data)
+                        glTextureSubImage2D(_id, 0, 0, 0, _width, _height, _pixelFormatDescription.format, _pixelFormatDescription.type, data);
+                }
+                else
+                {
+                    Bind(0);
+                    allocateMips(data);
+                }
 
                 //TODO: normal sampler setup
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                setParameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+                setParameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+                setParameter(GL_TEXTURE_MIN_FILTER, _mipLevels > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+                setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                setParameter(GL_TEXTURE_MAX_LEVEL, _mipLevels - 1);
+            }
+
+            void Texture2D::setParameter(GLenum name, GLint value)
+            {
+                // Bind to edit path expects texture bound by allocateStorage.
+                if (GLAD_GL_VERSION_4_5)
+                    glTextureParameteri(_id, name, value);
+                else
+                    glTexParameteri(GL_TEXTURE_2D, name, value);
+            }
+
+            void Texture2D::allocateMips(void* data)
+            {
+                // Only first mip is initialized with data.
+                for (int level = 0; level < _mipLevels; level++)
+                {
+                    const int width = std::max(1, _width >> level);
+                    const int height = std::max(1, _height >> level);
+
+                    glTexImage2D(GL_TEXTURE_2D, level, _pixelFormatDescription.internalFormat, width, height, 0,
+                                 _pixelFormatDescription.format, _pixelFormatDescription.type, level == 0 ? data : nullptr);
+                }
+            }
+
+            size_t Texture2D::GetRowPitch() const
+            {
+                return (static_cast<size_t>(_width) * _pixelFormatDescription.pixelSize + 3) & ~size_t(3);
+            }
+
+            void Texture2D::UploadRows(int firstRow, int rowsCount, size_t bufferOffset)
+            {
+                ASSERT(firstRow >= 0 && firstRow + rowsCount <= _height);
+
+                const auto pixels = reinterpret_cast<const void*>(bufferOffset);
+
+                if (GLAD_GL_VERSION_4_5)
+                {
+                    glTextureSubImage2D(_id, 0, 0, firstRow, _width, rowsCount, _pixelFormatDescription.format, _pixelFormatDescription.type, pixels);
+                    return;
+                }
+
+                Bind(0);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, _width, rowsCount, _pixelFormatDescription.format, _pixelFormatDescription.type, pixels);
             }
 
             void Texture2D::Bind(int sampler)
@@ -60,13 +140,112 @@ namespace OpenDemo
 
             void Texture2D::Resize(int width_, int height_)
             {
-                //TODO asserts and check for update
+                //TODO asserts
+                // Texture shared by several render target contexts is resized by each of them.
+                if (width_ == _width && height_ == _height)
+                    return;
+
                 _width = width_;
                 _height = height_;
 
-                Bind(0);
-                glTexImage2D(GL_TEXTURE_2D, 0, _pixelFormatDescription.internalFormat, _width, _height, 0, _pixelFormatDescription.format, _pixelFormatDescription.type, nullptr);
+                // Texture object changes on GL 4.5 path, framebuffers have to reattach it.
+                allocateStorage(nullptr);
             };
+
+            Texture2DArray::Texture2DArray()
+            {
+                if (GLAD_GL_VERSION_4_5)
+                    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &_id);
+                else
+                    glGenTextures(1, &_id);
+            }
+
+            Texture2DArray::~Texture2DArray()
+            {
+                glDeleteTextures(1, &_id);
+            }
+
+            void Texture2DArray::Init(const Description& description)
+            {
+                ASSERT(_layers == 0);
+                ASSERT(description.layers > 0);
+                ASSERT(description.mipLevels > 0);
+
+                _width = description.width;
+                _height = description.height;
+                _layers = description.layers;
+                _mipLevels = description.mipLevels;
+                _pixelFormatDescription = Texture2D::GetOpenGlPixelFormatDescription(description.pixelFormat);
+
+                if (GLAD_GL_VERSION_4_5)
+                    glTextureStorage3D(_id, _mipLevels, _pixelFormatDescription.internalFormat, _width, _height, _layers);
+                else
+                {
+                    Bind(0);
+                    for (int level = 0; level < _mipLevels; level++)
+                        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, _pixelFormatDescription.internalFormat,
+                                     std::max(1, _width >> level), std::max(1, _height >> level), _layers, 0,
+                                     _pixelFormatDescription.format, _pixelFormatDescription.type, nullptr);
+                }
+
+                setParameter(GL_TEXTURE_WRAP_S, GL_REPEAT);
+                setParameter(GL_TEXTURE_WRAP_T, GL_REPEAT);
+                setParameter(GL_TEXTURE_MIN_FILTER, _mipLevels > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+                setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                setParameter(GL_TEXTURE_MAX_LEVEL, _mipLevels - 1);
+            }
+
+            void Texture2DArray::UploadLayer(int layer, const void* data)
+            {
+                ASSERT(layer >= 0 && layer < _layers);
+                ASSERT(data);
+
+                if (GLAD_GL_VERSION_4_5)
+                {
+                    glTextureSubImage3D(_id, 0, 0, 0, layer, _width, _height, 1, _pixelFormatDescription.format, _pixelFormatDescription.type, data);
+                    return;
+                }
+
+                Bind(0);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, _width, _height, 1, _pixelFormatDescription.format, _pixelFormatDescription.type, data);
+            }
+
+            void Texture2DArray::GenerateMips()
+            {
+                if (_mipLevels == 1)
+                    return;
+
+                if (GLAD_GL_VERSION_4_5)
+                {
+                    glGenerateTextureMipmap(_id);
+                    return;
+                }
+
+                Bind(0);
+                glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+            }
+
+            void Texture2DArray::Bind(int sampler)
+            {
+                glActiveTexture(GL_TEXTURE0 + sampler);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, _id);
+            }
+
+            void Texture2DArray::Resize(int width, int height)
+            {
+                ASSERT_MSG(width == _width && height == _height, "Texture array can't be resized");
+                std::ignore = width;
+                std::ignore = height;
+            }
+
+            void Texture2DArray::setParameter(GLenum name, GLint value)
+            {
+                // Bind to edit path expects texture bound by Init.
+                if (GLAD_GL_VERSION_4_5)
+                    glTextureParameteri(_id, name, value);
+                else
+                    glTexParameteri(GL_TEXTURE_2D_ARRAY, name, value);
+            }
         }
     }
 }
\ No newline at end of file
@@ -16,27 +16,73 @@ namespace OpenDemo
                 {
                     GLuint internalFormat, format;
                     GLenum type;
+                    int pixelSize;
                 };
 
                 Texture2D();
                 virtual ~Texture2D();
 
+                static OpenGlPixelFormatDescription GetOpenGlPixelFormatDescription(PixelFormat pixelFormat);
+
                 virtual void Init(const Description& description, void* data) override;
                 virtual void Bind(int sampler) override;
 
                 inline virtual int GetWidth() const override { return _width; }
                 inline virtual int GetHeight() const override { return _height; }
+                inline virtual int GetMipLevels() const override { return _mipLevels; }
 
                 virtual void Resize(int width, int height) override;
 
                 inline GLuint GetNativeId() const { return _id; }
 
+                // Bytes of first mip row, aligned to 4 as default GL_UNPACK_ALIGNMENT expects. Init data uses the same layout.
+                size_t GetRowPitch() const;
+                // Copies rows of first mip from buffer bound to GL_PIXEL_UNPACK_BUFFER, offset points to first copied row.
+                void UploadRows(int firstRow, int rowsCount, size_t bufferOffset);
+
             private:
                 GLuint _id;
                 OpenGlPixelFormatDescription _pixelFormatDescription;
                 int _width, _height;
+                int _mipLevels;
+                // Immutable storage can't be reallocated, texture object is recreated instead.
+                bool _hasImmutableStorage = false;
+
+                void allocateStorage(void* data);
+                void allocateMips(void* data);
+                void setParameter(GLenum name, GLint value);
+            };
+
+            class Texture2DArray final : public Rendering::Texture2DArray
+            {
+            public:
+                Texture2DArray();
+                virtual ~Texture2DArray();
+
+                virtual void Init(const Description& description) override;
+                virtual void UploadLayer(int layer, const void* data) override;
+                virtual void GenerateMips() override;
+                virtual void Bind(int sampler) override;
+
+                inline virtual int GetWidth() const override { return _width; }
+                inline virtual int GetHeight() const override { return _height; }
+                inline virtual int GetMipLevels() const override { return _mipLevels; }
+                inline virtual int GetLayers() const override { return _layers; }
+
+                // Layers are packed at load time and never resized.
+                virtual void Resize(int width, int height) override;
+
+                inline GLuint GetNativeId() const { return _id; }
+
+            private:
+                void setParameter(GLenum name, GLint value);
 
-                OpenGlPixelFormatDescription GetOpenGlPixelFormatDescription(PixelFormat pixelFormat) const;
+            private:
+                GLuint _id;
+                Texture2D::OpenGlPixelFormatDescription _pixelFormatDescription;
+                int _width = 0, _height = 0;
+                int _layers = 0;
+                int _mipLevels = 1;
             };
         }
     }
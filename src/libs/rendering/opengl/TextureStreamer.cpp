@@ -0,0 +1,204 @@
+#include "TextureStreamer.hpp"
+
+#include "glad/glad.h"
+
+#include "Texture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            namespace
+            {
+                // Recycled buffers are fenced a couple of frames ago, so this wait is normally no-op.
+                constexpr GLuint64 FenceTimeout = 1000000000; // 1 second
+                // Offsets of pixel data in unpack buffer should be multiple of component size, RGBA32F is the largest.
+                constexpr size_t CopyAlignment = 16;
+
+                inline size_t alignUp(size_t value, size_t alignment)
+                {
+                    return (value + alignment - 1) / alignment * alignment;
+                }
+            }
+
+            TextureStreamer::~TextureStreamer()
+            {
+                Terminate();
+            }
+
+            void TextureStreamer::Init(size_t frameBudget)
+            {
+                ASSERT(frameBudget > 0);
+
+                _frameBudget = alignUp(frameBudget, CopyAlignment);
+                const auto bufferSize = static_cast<GLsizeiptr>(_frameBudget);
+
+                glGenBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+
+                for (uint32_t index = 0; index < FramesCount; index++)
+                {
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffers[index]);
+
+                    if (GLAD_GL_VERSION_4_4)
+                    {
+                        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                        glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, flags);
+                        _persistentData[index] = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, flags));
+                    }
+                    else
+                    {
+                        glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+                    }
+                }
+
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+                _frame = 0;
+            }
+
+            void TextureStreamer::Terminate()
+            {
+                for (auto& fence : _fences)
+                {
+                    if (fence)
+                        glDeleteSync(fence);
+
+                    fence = nullptr;
+                }
+
+                if (_buffers[0])
+                {
+                    for (uint32_t index = 0; index < FramesCount; index++)
+                    {
+                        if (!_persistentData[index])
+                            continue;
+
+                        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffers[index]);
+                        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                    }
+
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    glDeleteBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+                }
+
+                _buffers.fill(0);
+                _persistentData.fill(nullptr);
+                _requests.clear();
+
+                Threading::UniqueLock<Threading::Mutex> lock(_incomingMutex);
+                _incoming.clear();
+            }
+
+            void TextureStreamer::Enqueue(const std::shared_ptr<Texture2D>& texture, std::vector<uint8_t>&& data)
+            {
+                ASSERT(texture);
+                ASSERT(data.size() >= texture->GetRowPitch() * texture->GetHeight());
+
+                if (texture->GetRowPitch() > _frameBudget)
+                {
+                    Log::Format::Warning(FMT_STRING("Texture row of {} bytes exceeds streaming budget of {} bytes\n"), texture->GetRowPitch(), _frameBudget);
+                    return;
+                }
+
+                Threading::UniqueLock<Threading::Mutex> lock(_incomingMutex);
+                _incoming.push_back({ texture, std::move(data), 0 });
+            }
+
+            size_t TextureStreamer::GetPendingCount() const
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(_incomingMutex);
+                return _incoming.size() + _requests.size();
+            }
+
+            void TextureStreamer::MoveToNextFrame()
+            {
+                if (!_buffers[0])
+                    return;
+
+                _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                _frame = (_frame + 1) % FramesCount;
+
+                auto& fence = _fences[_frame];
+                if (fence)
+                {
+                    const auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+                    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+                        Log::Format::Warning(FMT_STRING("Texture streamer fence wait failed\n"));
+
+                    glDeleteSync(fence);
+                    fence = nullptr;
+                }
+
+                {
+                    Threading::UniqueLock<Threading::Mutex> lock(_incomingMutex);
+                    std::move(_incoming.begin(), _incoming.end(), std::back_inserter(_requests));
+                    _incoming.clear();
+                }
+
+                if (!_requests.empty())
+                    fillBuffer();
+            }
+
+            void TextureStreamer::fillBuffer()
+            {
+                const GLuint buffer = _buffers[_frame];
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+                uint8_t* mapped = _persistentData[_frame];
+                if (!mapped)
+                {
+                    // Buffer is guarded by fence, so driver doesn't need to synchronize the mapping.
+                    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+                    mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(_frameBudget), flags));
+                }
+
+                if (!mapped)
+                {
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    return;
+                }
+
+                // Texture copies source buffer, so they are issued only after it's unmapped.
+                _copies.clear();
+                size_t offset = 0;
+
+                for (auto& request : _requests)
+                {
+                    const size_t rowPitch = request.texture->GetRowPitch();
+                    const int rowsLeft = request.texture->GetHeight() - request.uploadedRows;
+                    const int rowsCount = std::min(rowsLeft, static_cast<int>((_frameBudget - offset) / rowPitch));
+
+                    if (rowsCount == 0)
+                        break;
+
+                    std::memcpy(mapped + offset, request.data.data() + request.uploadedRows * rowPitch, rowsCount * rowPitch);
+                    _copies.push_back({ request.texture.get(), request.uploadedRows, rowsCount, offset });
+
+                    request.uploadedRows += rowsCount;
+                    offset = alignUp(offset + rowsCount * rowPitch, CopyAlignment);
+
+                    if (offset >= _frameBudget)
+                        break;
+                }
+
+                if (!_persistentData[_frame])
+                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+                for (const auto& copy : _copies)
+                    copy.texture->UploadRows(copy.firstRow, copy.rowsCount, copy.offset);
+
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+                // Copies point to textures of requests, so these are released only now. Requests are filled in order, finished ones are at the front.
+                while (!_requests.empty() && _requests.front().uploadedRows == _requests.front().texture->GetHeight())
+                    _requests.pop_front();
+            }
+        }
+    }
+}
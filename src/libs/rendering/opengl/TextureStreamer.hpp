@@ -0,0 +1,80 @@
+#pragma once
+
+#include "common/threading/Mutex.hpp"
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+typedef struct __GLsync* GLsync;
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            typedef uint32_t GLuint;
+
+            class Texture2D;
+
+            // Streams first mip of textures through ring of pixel unpack buffers, one buffer per frame in flight.
+            // Enqueue can be called from any thread, e.g. by jobs reading texture files. Copies are issued on MoveToNextFrame
+            // within per frame byte budget, textures larger than budget are split by rows over several frames.
+            // Buffer is reused only after fence issued at the end of its frame is signaled.
+            // Buffers are persistently mapped when GL 4.4 buffer storage is available, otherwise mapped unsynchronized every frame.
+            class TextureStreamer final
+            {
+            public:
+                TextureStreamer() = default;
+                ~TextureStreamer();
+
+                void Init(size_t frameBudget);
+                void Terminate();
+
+                // Texture should be initialized with null data, data layout matches Texture2D::Init.
+                void Enqueue(const std::shared_ptr<Texture2D>& texture, std::vector<uint8_t>&& data);
+
+                // Fences buffer of current frame, waits until next one is released and fills it with pending rows.
+                void MoveToNextFrame();
+
+                // Textures with rows not yet copied, including ones enqueued since last frame. GL thread only.
+                size_t GetPendingCount() const;
+
+            private:
+                struct Request
+                {
+                    std::shared_ptr<Texture2D> texture;
+                    std::vector<uint8_t> data;
+                    int uploadedRows = 0;
+                };
+
+                struct Copy
+                {
+                    Texture2D* texture;
+                    int firstRow;
+                    int rowsCount;
+                    size_t offset;
+                };
+
+                void fillBuffer();
+
+            private:
+                static constexpr uint32_t FramesCount = 3;
+
+                std::array<GLuint, FramesCount> _buffers = {};
+                std::array<uint8_t*, FramesCount> _persistentData = {};
+                std::array<GLsync, FramesCount> _fences = {};
+                size_t _frameBudget = 0;
+                uint32_t _frame = 0;
+
+                // Filled by producers, drained into _requests by GL thread.
+                mutable Threading::Mutex _incomingMutex;
+                std::vector<Request> _incoming;
+                std::deque<Request> _requests;
+                std::vector<Copy> _copies;
+            };
+        }
+    }
+}
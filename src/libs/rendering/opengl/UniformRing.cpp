@@ -0,0 +1,145 @@
+#include "UniformRing.hpp"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            namespace
+            {
+                // Recycled regions are fenced a couple of frames ago, so this wait is normally no-op.
+                constexpr GLuint64 FenceTimeout = 1000000000; // 1 second
+
+                inline size_t alignUp(size_t value, size_t alignment)
+                {
+                    return (value + alignment - 1) / alignment * alignment;
+                }
+            }
+
+            UniformRing::~UniformRing()
+            {
+                Terminate();
+            }
+
+            void UniformRing::Init(size_t size)
+            {
+                GLint alignment;
+                glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+                _alignment = std::max<size_t>(alignment, 1);
+                _regionSize = alignUp(size / FramesCount, _alignment);
+
+                const auto bufferSize = static_cast<GLsizeiptr>(_regionSize * FramesCount);
+
+                glGenBuffers(1, &_buffer);
+                glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+
+                if (GLAD_GL_VERSION_4_4)
+                {
+                    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                    glBufferStorage(GL_UNIFORM_BUFFER, bufferSize, nullptr, flags);
+                    _persistentData = static_cast<uint8_t*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, bufferSize, flags));
+                }
+                else
+                {
+                    glBufferData(GL_UNIFORM_BUFFER, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+                }
+
+                glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+                _frame = 0;
+                _offset = 0;
+            }
+
+            void UniformRing::Terminate()
+            {
+                for (auto& fence : _fences)
+                {
+                    if (fence)
+                        glDeleteSync(fence);
+
+                    fence = nullptr;
+                }
+
+                if (_buffer)
+                {
+                    if (_persistentData)
+                    {
+                        glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+                        glUnmapBuffer(GL_UNIFORM_BUFFER);
+                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+                    }
+
+                    glDeleteBuffers(1, &_buffer);
+                }
+
+                _buffer = 0;
+                _persistentData = nullptr;
+            }
+
+            bool UniformRing::Write(uint32_t binding, const void* data, size_t size)
+            {
+                if (!_buffer)
+                    return false;
+
+                const auto offset = alignUp(_offset, _alignment);
+                if (offset + size > _regionSize)
+                {
+                    Log::Format::Warning(FMT_STRING("Uniform ring region of {} bytes is exhausted\n"), _regionSize);
+                    return false;
+                }
+
+                const auto bufferOffset = _frame * _regionSize + offset;
+                _offset = offset + size;
+
+                if (_persistentData)
+                {
+                    std::memcpy(_persistentData + bufferOffset, data, size);
+                }
+                else
+                {
+                    // Region is guarded by fence, so driver doesn't need to synchronize the mapping.
+                    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+                    glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+                    void* mapped = glMapBufferRange(GL_UNIFORM_BUFFER, bufferOffset, size, flags);
+                    if (!mapped)
+                        return false;
+
+                    std::memcpy(mapped, data, size);
+                    glUnmapBuffer(GL_UNIFORM_BUFFER);
+                }
+
+                glBindBufferRange(GL_UNIFORM_BUFFER, binding, _buffer, bufferOffset, size);
+                return true;
+            }
+
+            void UniformRing::MoveToNextFrame()
+            {
+                if (!_buffer)
+                    return;
+
+                _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+                _frame = (_frame + 1) % FramesCount;
+                _offset = 0;
+
+                auto& fence = _fences[_frame];
+                if (!fence)
+                    return;
+
+                const auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+                if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+                    Log::Format::Warning(FMT_STRING("Uniform ring fence wait failed\n"));
+
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+
+typedef struct __GLsync* GLsync;
+
+namespace OpenDemo
+{
+    namespace Rendering
+    {
+        namespace OpenGL
+        {
+            typedef uint32_t GLuint;
+
+            // Uniform buffer split into per frame regions and sub-allocated with pointer bump.
+            // Region is reused only after fence issued at the end of its frame is signaled.
+            // Storage is persistently mapped when GL 4.4 buffer storage is available, otherwise every write maps unsynchronized range.
+            class UniformRing final
+            {
+            public:
+                UniformRing() = default;
+                ~UniformRing();
+
+                void Init(size_t size);
+                void Terminate();
+
+                // Copies data into current frame region and binds it to uniform block binding point.
+                // Returns false when region is exhausted, caller should fallback to plain uniforms.
+                bool Write(uint32_t binding, const void* data, size_t size);
+
+                // Fences current region and waits until next one is released by GPU.
+                void MoveToNextFrame();
+
+            private:
+                static constexpr uint32_t FramesCount = 3;
+
+                GLuint _buffer = 0;
+                uint8_t* _persistentData = nullptr;
+                size_t _alignment = 256;
+                size_t _regionSize = 0;
+                size_t _offset = 0;
+                uint32_t _frame = 0;
+                std::array<GLsync, FramesCount> _fences = {};
+            };
+        }
+    }
+}
@@ -33,26 +33,70 @@ namespace RR
 #endif
         }
 
-        void GlfwWindowImpl::windowResizeCallback(GLFWwindow* glfwWindow, int width, int height)
+        Window& GlfwWindowImpl::getOwner(GLFWwindow* glfwWindow)
         {
-            ASSERT(width >= 0);
-            ASSERT(height >= 0);
-
             const auto windowPtr = glfwGetWindowUserPointer(glfwWindow);
             auto windowImpl = static_cast<GlfwWindowImpl*>(windowPtr);
             ASSERT(windowImpl);
+            ASSERT(windowImpl->owner_);
+
+            return *windowImpl->owner_;
+        }
 
-            windowImpl->callbacks_->OnWindowResize(static_cast<uint32_t>(width),
-                                                   static_cast<uint32_t>(height));
+        void GlfwWindowImpl::windowResizeCallback(GLFWwindow* glfwWindow, int width, int height)
+        {
+            ASSERT(width >= 0);
+            ASSERT(height >= 0);
+
+            getOwner(glfwWindow).OnResize.Fire(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
         }
 
         void GlfwWindowImpl::windowCloseCallback(GLFWwindow* glfwWindow)
         {
-            const auto windowPtr = glfwGetWindowUserPointer(glfwWindow);
-            auto windowImpl = static_cast<GlfwWindowImpl*>(windowPtr);
-            ASSERT(windowImpl);
+            getOwner(glfwWindow).OnClose.Fire();
+        }
+
+        void GlfwWindowImpl::windowFocusCallback(GLFWwindow* glfwWindow, int focused)
+        {
+            auto& window = getOwner(glfwWindow);
+
+            if (focused == GLFW_TRUE)
+                window.OnFocusGained.Fire();
+            else
+                window.OnFocusLost.Fire();
+        }
+
+        void GlfwWindowImpl::windowIconifyCallback(GLFWwindow* glfwWindow, int iconified)
+        {
+            auto& window = getOwner(glfwWindow);
 
-            windowImpl->callbacks_->OnClose();
+            if (iconified == GLFW_TRUE)
+                window.OnHidden.Fire();
+            else
+                window.OnShown.Fire();
+        }
+
+        void GlfwWindowImpl::keyCallback(GLFWwindow* glfwWindow, int key, int scancode, int action, int mods)
+        {
+            (void)scancode;
+            (void)mods;
+
+            if (key == GLFW_KEY_UNKNOWN)
+                return;
+
+            getOwner(glfwWindow).OnKey.Fire(key, action != GLFW_RELEASE);
+        }
+
+        void GlfwWindowImpl::mouseButtonCallback(GLFWwindow* glfwWindow, int button, int action, int mods)
+        {
+            (void)mods;
+
+            getOwner(glfwWindow).OnMouseButton.Fire(button, action != GLFW_RELEASE);
+        }
+
+        void GlfwWindowImpl::cursorPositionCallback(GLFWwindow* glfwWindow, double x, double y)
+        {
+            getOwner(glfwWindow).OnMouseMove.Fire(Vector2i(static_cast<int32_t>(x), static_cast<int32_t>(y)));
         }
 
         GlfwWindowImpl::~GlfwWindowImpl()
@@ -65,12 +109,11 @@ namespace RR
 #endif
         }
 
-        bool GlfwWindowImpl::Init(Window::ICallbacks* callbacks, const Window::Description& description)
+        bool GlfwWindowImpl::Init(Window& window, const Window::Description& description)
         {
             ASSERT(!window_);
-            ASSERT(callbacks);
 
-            callbacks_ = callbacks;
+            owner_ = &window;
             window_ = glfwCreateWindow(description.Width, description.Height, description.Title.c_str(), nullptr, nullptr);
 
             if (!window_)
@@ -79,6 +122,11 @@ namespace RR
             glfwSetWindowRefreshCallback(window_, &windowUpdateCallback);
             glfwSetWindowSizeCallback(window_, &windowResizeCallback);
             glfwSetWindowCloseCallback(window_, &windowCloseCallback);
+            glfwSetWindowFocusCallback(window_, &windowFocusCallback);
+            glfwSetWindowIconifyCallback(window_, &windowIconifyCallback);
+            glfwSetKeyCallback(window_, &keyCallback);
+            glfwSetMouseButtonCallback(window_, &mouseButtonCallback);
+            glfwSetCursorPosCallback(window_, &cursorPositionCallback);
             glfwSetWindowUserPointer(window_, this);
 
 #ifdef OS_WINDOWS
@@ -99,13 +147,25 @@ namespace RR
             }
             else
             {
-                const auto rawSupported = glfwRawMouseMotionSupported();
-
+                // Raw mouse motion isn't enabled, raw input devices are registered per process and owned by Inputting.
                 glfwSetInputMode(window_, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-                glfwSetInputMode(window_, GLFW_RAW_MOUSE_MOTION, rawSupported ? GLFW_TRUE : GLFW_FALSE);
             }
         }
 
+        bool GlfwWindowImpl::IsFocused() const
+        {
+            ASSERT(window_);
+
+            return glfwGetWindowAttrib(window_, GLFW_FOCUSED) == GLFW_TRUE;
+        }
+
+        bool GlfwWindowImpl::IsMinimized() const
+        {
+            ASSERT(window_);
+
+            return glfwGetWindowAttrib(window_, GLFW_ICONIFIED) == GLFW_TRUE;
+        }
+
         int GlfwWindowImpl::GetWidth() const
         {
             ASSERT(window_);
@@ -17,9 +17,11 @@ namespace RR
         public:
             ~GlfwWindowImpl();
 
-            bool Init(Window::ICallbacks* callbacks, const Window::Description& description) override;
+            bool Init(Window& window, const Window::Description& description) override;
 
             void ShowCursor(bool value) override;
+            bool IsFocused() const override;
+            bool IsMinimized() const override;
             int32_t GetWidth() const override;
             int32_t GetHeight() const override;
             std::any GetNativeHandle() const override;
@@ -28,9 +30,16 @@ namespace RR
             static void windowUpdateCallback(GLFWwindow* glfwWindow);
             static void windowResizeCallback(GLFWwindow* glfwWindow, int width, int height);
             static void windowCloseCallback(GLFWwindow* glfwWindow);
+            static void windowFocusCallback(GLFWwindow* glfwWindow, int focused);
+            static void windowIconifyCallback(GLFWwindow* glfwWindow, int iconified);
+            static void keyCallback(GLFWwindow* glfwWindow, int key, int scancode, int action, int mods);
+            static void mouseButtonCallback(GLFWwindow* glfwWindow, int button, int action, int mods);
+            static void cursorPositionCallback(GLFWwindow* glfwWindow, double x, double y);
+
+            static Window& getOwner(GLFWwindow* glfwWindow);
 
         private:
-            Window::ICallbacks* callbacks_;
+            Window* owner_ = nullptr;
             GLFWwindow* window_;
 #ifdef OS_WINDOWS
             HBRUSH bgBrush_;
@@ -30,13 +30,13 @@ namespace RR
             isInited_ = true;
         }
 
-        std::shared_ptr<Window> WindowSystem::Create(Window::ICallbacks* callbacks, const Window::Description& description) const
+        std::shared_ptr<Window> WindowSystem::Create(const Window::Description& description) const
         {
             ASSERT(isInited_);
 
             const auto& window = std::shared_ptr<Window>(new Window());
 
-            if (!window->Init(callbacks, description))
+            if (!window->Init(description))
                 return nullptr;
 
             return window;
@@ -48,5 +48,13 @@ namespace RR
 
             glfwPollEvents();
         }
+
+        void WindowSystem::WaitEvents(double timeoutSeconds) const
+        {
+            ASSERT(isInited_);
+            ASSERT(timeoutSeconds >= 0.0);
+
+            glfwWaitEventsTimeout(timeoutSeconds);
+        }
     }
 }
\ No newline at end of file
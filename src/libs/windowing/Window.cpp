@@ -20,12 +20,12 @@ namespace RR
             impl_.reset();
         }
 
-        bool Window::Init(Window::ICallbacks* callbacks, const Window::Description& description)
+        bool Window::Init(const Window::Description& description)
         {
             ASSERT(!impl_)
 
             impl_ = std::make_unique<GlfwWindowImpl>();
-            return impl_->Init(callbacks, description);
+            return impl_->Init(*this, description);
         }
     }
 }
\ No newline at end of file
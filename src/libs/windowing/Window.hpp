@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/EventProvider.hpp"
 #include "common/Math.hpp"
 
 #include <any>
@@ -17,50 +18,6 @@ namespace RR
             using SharedPtr = std::shared_ptr<Window>;
             using SharedConstPtr = std::shared_ptr<const Window>;
 
-            class ICallbacks
-            {
-            public:
-                virtual void OnWindowShown() {};
-                virtual void OnWindowHidden() {};
-
-                virtual void OnWindowFocusGained() {};
-                virtual void OnWindowFocusLost() {};
-
-                // clang-format off
-                virtual void OnWindowResize(uint32_t width, uint32_t height) { (void)width; (void)height; };
-                // clang-format on
-                /*
-            virtual void OnKeyUp(const Window& window, const SDL_Keysym& keysym)
-            {
-                (void)window;
-                (void)keysym;
-            }
-            virtual void OnKeyDown(const Window& window, const SDL_Keysym& keysym)
-            {
-                (void)window;
-                (void)keysym;
-            }
-           
-            virtual void OnMouseMotion(const Window& window, const Vector2i& position, const Vector2i& relative)
-            {
-                (void)window;
-                (void)position;
-                (void)relative;
-            }
-            virtual void OnMouseButtonUp(const Window& window, uint32_t button)
-            {
-                (void)window;
-                (void)button;
-            }
-            virtual void OnMouseButtonDown(const Window& window, uint32_t button)
-            {
-                (void)window;
-                (void)button;
-            }
-             */
-                virtual void OnClose() {};
-            };
-
             struct Description
             {
                 U8String Title = "";
@@ -71,7 +28,23 @@ namespace RR
         public:
             ~Window();
 
+            // Fired on thread calling WindowSystem::PoolEvents.
+            Event<void()> OnShown;
+            Event<void()> OnHidden;
+            Event<void()> OnFocusGained;
+            Event<void()> OnFocusLost;
+            Event<void(uint32_t width, uint32_t height)> OnResize;
+            Event<void()> OnClose;
+            // Key is GLFW key code. Repeats are reported as presses.
+            Event<void(int32_t key, bool pressed)> OnKey;
+            Event<void(int32_t button, bool pressed)> OnMouseButton;
+            // Cursor position in window client area.
+            Event<void(const Vector2i& position)> OnMouseMove;
+
             inline void ShowCursor(bool value);
+            // Current state, events above report changes.
+            inline bool IsFocused() const;
+            inline bool IsMinimized() const;
             inline int GetWidth() const;
             inline int GetHeight() const;
             inline std::any GetNativeHandle() const;
@@ -79,7 +52,7 @@ namespace RR
 
         private:
             Window() = default;
-            bool Init(ICallbacks* callbacks, const Description& description);
+            bool Init(const Description& description);
 
             std::unique_ptr<IWindowImpl> impl_;
 
@@ -90,10 +63,13 @@ namespace RR
         class IWindowImpl
         {
         public:
-            virtual bool Init(Window::ICallbacks* callbacks, const Window::Description& description) = 0;
+            virtual bool Init(Window& window, const Window::Description& description) = 0;
 
             virtual void ShowCursor(bool value) = 0;
 
+            virtual bool IsFocused() const = 0;
+            virtual bool IsMinimized() const = 0;
+
             virtual int32_t GetWidth() const = 0;
             virtual int32_t GetHeight() const = 0;
             virtual std::any GetNativeHandle() const = 0;
@@ -105,6 +81,18 @@ namespace RR
             impl_->ShowCursor(value);
         }
 
+        inline bool Window::IsFocused() const
+        {
+            ASSERT(impl_);
+            return impl_->IsFocused();
+        }
+
+        inline bool Window::IsMinimized() const
+        {
+            ASSERT(impl_);
+            return impl_->IsMinimized();
+        }
+
         inline int Window::GetWidth() const
         {
             ASSERT(impl_);
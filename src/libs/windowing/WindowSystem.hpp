@@ -20,8 +20,11 @@ namespace RR
 
             void Init();
 
-            std::shared_ptr<Window> Create(Window::ICallbacks* callbacks, const Window::Description& description) const;
+            std::shared_ptr<Window> Create(const Window::Description& description) const;
             void PoolEvents() const;
+            // Sleeps until any event arrives or timeout expires, then processes events like PoolEvents.
+            // Lets applications render on events only while their windows aren't visible.
+            void WaitEvents(double timeoutSeconds) const;
 
         private:
             bool isInited_ = false;
@@ -0,0 +1,99 @@
+#include "render/CommandReplay.hpp"
+#include "render/DeviceContext.hpp"
+
+#include "common/threading/JobSystem.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct Summary
+    {
+        double average = 0.0;
+        double min = 0.0;
+        double median = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+    };
+
+    Summary summarize(std::vector<double> values)
+    {
+        ASSERT(!values.empty());
+
+        std::sort(values.begin(), values.end());
+
+        Summary summary;
+        for (const auto value : values)
+            summary.average += value;
+
+        summary.average /= values.size();
+        summary.min = values.front();
+        summary.median = values[values.size() / 2];
+        summary.p95 = values[std::min(values.size() - 1, values.size() * 95 / 100)];
+        summary.max = values.back();
+        return summary;
+    }
+
+    void printSummary(const char* name, const Summary& summary)
+    {
+        Log::Print::Info("%s: avg %.3fms, min %.3fms, median %.3fms, p95 %.3fms, max %.3fms\n",
+                         name, summary.average, summary.min, summary.median, summary.p95, summary.max);
+    }
+}
+
+// replay capture.rrcp [--iterations N]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        Log::Print::Info("Usage: replay <capture> [--iterations N]\n");
+        return 1;
+    }
+
+    const char* path = argv[1];
+    uint32_t iterations = 10;
+
+    for (int index = 2; index < argc; index++)
+        if (strcmp(argv[index], "--iterations") == 0 && index + 1 < argc)
+            iterations = std::max(1u, static_cast<uint32_t>(strtoul(argv[++index], nullptr, 10)));
+
+    RR::Common::Threading::JobSystem::Instance().Init();
+
+    auto deviceContext = std::make_unique<RR::Render::DeviceContext>();
+    deviceContext->Init();
+
+    int result = 1;
+
+    {
+        RR::Render::CommandReplay replay;
+        if (replay.Load(*deviceContext, path))
+        {
+            // First pass warms up pipeline states and residency, it's not measured.
+            replay.Replay(*deviceContext, 1);
+            const auto timings = replay.Replay(*deviceContext, iterations);
+
+            std::vector<double> cpuMs;
+            std::vector<double> frameMs;
+            for (const auto& timing : timings)
+            {
+                cpuMs.push_back(timing.cpuMs);
+                frameMs.push_back(timing.frameMs);
+            }
+
+            Log::Print::Info("Replayed %zu frames %u times\n", replay.GetFramesCount(), iterations);
+            printSummary("CPU submit", summarize(cpuMs));
+            printSummary("Frame", summarize(frameMs));
+
+            result = 0;
+        }
+    }
+
+    deviceContext->Terminate();
+    deviceContext = nullptr;
+
+    RR::Common::Threading::JobSystem::Instance().Terminate();
+
+    return result;
+}
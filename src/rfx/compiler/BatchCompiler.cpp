@@ -0,0 +1,419 @@
+#include "BatchCompiler.hpp"
+
+#include "compiler/CompileCache.hpp"
+#include "compiler/Program.hpp"
+#include "compiler/RemoteCompiler.hpp"
+#include "compiler/Session.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/Thread.hpp"
+
+#include "include/rfx.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+
+namespace
+{
+    void writeFile(const std::string& path, const std::vector<uint8_t>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    void serializePermutations(const Rfx::Compiler::Manifest::PermutationSet& permutationSet, const std::vector<uint32_t>& masks, std::vector<uint8_t>& blob)
+    {
+        using namespace Rfx::Permutations;
+
+        std::vector<Keyword> keywords;
+        std::vector<char> strings;
+        for (const auto& name : permutationSet.keywords)
+        {
+            keywords.push_back({ Rfx::Reflection::HashName(name.c_str()), static_cast<uint32_t>(strings.size()) });
+            strings.insert(strings.end(), name.c_str(), name.c_str() + name.size() + 1);
+        }
+
+        Header header = {};
+        header.magic = Magic;
+        header.version = Version;
+
+        blob.assign(sizeof(Header), 0);
+
+        header.keywordsOffset = static_cast<uint32_t>(blob.size());
+        header.keywordsCount = static_cast<uint32_t>(keywords.size());
+        blob.insert(blob.end(), reinterpret_cast<const uint8_t*>(keywords.data()), reinterpret_cast<const uint8_t*>(keywords.data() + keywords.size()));
+
+        header.masksOffset = static_cast<uint32_t>(blob.size());
+        header.masksCount = static_cast<uint32_t>(masks.size());
+        blob.insert(blob.end(), reinterpret_cast<const uint8_t*>(masks.data()), reinterpret_cast<const uint8_t*>(masks.data() + masks.size()));
+
+        header.stringsOffset = static_cast<uint32_t>(blob.size());
+        header.stringsSize = static_cast<uint32_t>(strings.size());
+        blob.insert(blob.end(), strings.begin(), strings.end());
+        blob.resize((blob.size() + 3) & ~size_t(3), 0);
+
+        header.size = static_cast<uint32_t>(blob.size());
+        std::memcpy(blob.data(), &header, sizeof(Header));
+    }
+
+    struct PackShader final
+    {
+        uint64_t key;
+        std::string name;
+        std::vector<uint8_t> bytecode;
+        std::vector<uint8_t> reflection;
+    };
+
+    class PackBuilder final
+    {
+    public:
+        // Returns false on key collision.
+        bool Serialize(std::vector<PackShader>& shaders, std::vector<uint8_t>& pack, std::string& log)
+        {
+            using namespace Rfx::Pack;
+
+            std::sort(shaders.begin(), shaders.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+            std::vector<Entry> entries;
+            entries.reserve(shaders.size());
+            for (size_t index = 0; index < shaders.size(); index++)
+            {
+                if (index > 0 && shaders[index].key == shaders[index - 1].key)
+                {
+                    log += fmt::sprintf("Shader pack key collision between %s and %s\n", shaders[index - 1].name, shaders[index].name);
+                    return false;
+                }
+
+                entries.push_back({ shaders[index].key, addBlob(shaders[index].bytecode), addBlob(shaders[index].reflection) });
+            }
+
+            Header header = {};
+            header.magic = Magic;
+            header.version = Version;
+
+            pack.assign(sizeof(Header), 0);
+            header.entriesOffset = static_cast<uint32_t>(pack.size());
+            header.entriesCount = static_cast<uint32_t>(entries.size());
+            append(pack, entries.data(), entries.size() * sizeof(Entry));
+
+            header.blobsOffset = static_cast<uint32_t>(pack.size());
+            header.blobsCount = static_cast<uint32_t>(blobs_.size());
+            append(pack, nullptr, blobs_.size() * sizeof(Blob));
+
+            // Blob table is patched once data offsets are known.
+            for (uint32_t index = 0; index < blobs_.size(); index++)
+            {
+                pack.resize((pack.size() + BlobAlignment - 1) & ~size_t(BlobAlignment - 1), 0);
+
+                const Blob blob = { static_cast<uint32_t>(pack.size()), static_cast<uint32_t>(blobs_[index]->size()) };
+                std::memcpy(pack.data() + header.blobsOffset + index * sizeof(Blob), &blob, sizeof(Blob));
+                append(pack, blobs_[index]->data(), blobs_[index]->size());
+            }
+
+            header.size = static_cast<uint32_t>(pack.size());
+            std::memcpy(pack.data(), &header, sizeof(Header));
+
+            return true;
+        }
+
+    private:
+        static void append(std::vector<uint8_t>& pack, const void* data, size_t size)
+        {
+            const auto offset = pack.size();
+            pack.resize(offset + size, 0);
+            if (data)
+                std::memcpy(pack.data() + offset, data, size);
+        }
+
+        // Permutations often compile to identical bytecode and share reflection.
+        uint32_t addBlob(const std::vector<uint8_t>& data)
+        {
+            // FNV-1a
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (const auto byte : data)
+            {
+                hash ^= byte;
+                hash *= 0x100000001b3ull;
+            }
+
+            auto& candidates = blobsByHash_[hash];
+            for (const auto index : candidates)
+                if (*blobs_[index] == data)
+                    return index;
+
+            const auto index = static_cast<uint32_t>(blobs_.size());
+            blobs_.push_back(&data);
+            candidates.push_back(index);
+
+            return index;
+        }
+
+    private:
+        std::vector<const std::vector<uint8_t>*> blobs_;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> blobsByHash_;
+    };
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        BatchCompiler::BatchCompiler(const Description& description)
+            : description_(description)
+        {
+        }
+
+        BatchCompiler::Statistics BatchCompiler::Compile(const Manifest& manifest)
+        {
+            std::error_code error;
+            std::filesystem::create_directories(description_.outputDirectory, error);
+
+            std::optional<CompileCache> cache;
+            if (!description_.cacheDirectory.empty())
+                cache.emplace(description_.cacheDirectory);
+
+            const auto entriesCount = static_cast<uint32_t>(manifest.entries.size());
+            const auto hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+            const auto threadsCount = std::min(description_.threadsCount ? description_.threadsCount : hardwareThreads, entriesCount);
+
+            std::atomic<uint32_t> nextEntry = 0;
+            std::atomic<uint32_t> compiled = 0;
+            std::atomic<uint32_t> cached = 0;
+            std::atomic<uint32_t> failed = 0;
+            Threading::Mutex logMutex;
+
+            std::vector<PackShader> packShaders;
+            Threading::Mutex packMutex;
+
+            // Entries are pulled from the shared queue by local and remote threads alike.
+            const auto processEntries = [&](const auto& compile, const auto& isStopped) {
+                while (!isStopped())
+                {
+                    const auto index = nextEntry++;
+                    if (index >= entriesCount)
+                        return;
+
+                    const auto& entry = manifest.entries[index];
+
+                    uint64_t key = 0;
+                    const bool hasKey = cache && cache->GetKey(entry, description_.searchPaths, key);
+
+                    std::vector<uint8_t> bytecode;
+                    std::vector<uint8_t> reflection;
+                    std::string log;
+
+                    if (hasKey && cache->Load(key, CompileCache::BytecodeExtension, bytecode) &&
+                        cache->Load(key, CompileCache::ReflectionExtension, reflection))
+                    {
+                        cached++;
+                    }
+                    else if (compile(entry, bytecode, reflection, log))
+                    {
+                        if (hasKey)
+                        {
+                            cache->Store(key, CompileCache::ReflectionExtension, reflection);
+                            cache->Store(key, CompileCache::BytecodeExtension, bytecode);
+                        }
+
+                        compiled++;
+                    }
+                    else
+                    {
+                        failed++;
+
+                        Threading::UniqueLock<Threading::Mutex> lock(logMutex);
+                        Log::Print::Warning("Failed to compile %s:%s\n%s", entry.module, entry.entryPoint, log);
+                        continue;
+                    }
+
+                    if (!description_.packPath.empty())
+                    {
+                        Threading::UniqueLock<Threading::Mutex> lock(packMutex);
+                        packShaders.push_back({ getPackKey(entry), getOutputName(entry), std::move(bytecode), std::move(reflection) });
+                        continue;
+                    }
+
+                    writeFile(getOutputPath(entry, ".bin"), bytecode);
+                    writeFile(getOutputPath(entry, ".refl"), reflection);
+                }
+            };
+
+            const auto worker = [&]() {
+                ALLOCATION_TAG_SCOPE(Rfx);
+
+                // Slang global session isn't thread safe, every worker owns one.
+                Session session;
+
+                processEntries(
+                    [&](const Manifest::Entry& entry, std::vector<uint8_t>& bytecode, std::vector<uint8_t>& reflection, std::string& log) {
+                        return CompileEntry(session, entry, description_.searchPaths, bytecode, &reflection, log);
+                    },
+                    []() { return false; });
+            };
+
+            const auto remoteWorker = [&](const std::shared_ptr<Remote::Connection>& connection) {
+                ALLOCATION_TAG_SCOPE(Rfx);
+
+                processEntries(
+                    [&](const Manifest::Entry& entry, std::vector<uint8_t>& bytecode, std::vector<uint8_t>& reflection, std::string& log) {
+                        bool isCompiled = false;
+                        if (connection->Compile(entry, bytecode, reflection, log, isCompiled))
+                            return isCompiled;
+
+                        // Lost worker, entry falls back to local compilation and remaining ones are left to other threads.
+                        {
+                            Threading::UniqueLock<Threading::Mutex> lock(logMutex);
+                            Log::Print::Warning("Lost connection to rfx worker, compiling %s:%s locally\n", entry.module, entry.entryPoint);
+                        }
+
+                        Session session;
+                        bytecode.clear();
+                        reflection.clear();
+                        return CompileEntry(session, entry, description_.searchPaths, bytecode, &reflection, log);
+                    },
+                    [&]() { return !connection->IsOpen(); });
+            };
+
+            // Unreachable workers are skipped, local threads cover the whole manifest if none is available.
+            std::vector<std::shared_ptr<Remote::Connection>> connections;
+            for (const auto& address : description_.workers)
+            {
+                auto connection = std::make_shared<Remote::Connection>();
+                if (!connection->Open(address))
+                {
+                    Log::Print::Warning("rfx worker %s is unavailable\n", address);
+                    continue;
+                }
+
+                const auto slots = connection->GetSlots();
+                connections.push_back(std::move(connection));
+
+                for (uint32_t slot = 1; slot < slots; slot++)
+                {
+                    connection = std::make_shared<Remote::Connection>();
+                    if (!connection->Open(address))
+                        break;
+
+                    connections.push_back(std::move(connection));
+                }
+            }
+
+            std::vector<Threading::Thread> threads;
+            threads.reserve(threadsCount + connections.size());
+            for (uint32_t index = 0; index < threadsCount; index++)
+                threads.emplace_back(fmt::sprintf("Rfx compiler %d", index), worker);
+
+            for (uint32_t index = 0; index < connections.size(); index++)
+                threads.emplace_back(fmt::sprintf("Rfx remote compiler %d", index), remoteWorker, connections[index]);
+
+            for (auto& thread : threads)
+                thread.Join();
+
+            if (cache)
+                cache->SaveDependencies();
+
+            // Index lists every generated permutation, failed ones are reported by statistics.
+            for (uint32_t setIndex = 0; setIndex < manifest.permutationSets.size(); setIndex++)
+            {
+                const auto& permutationSet = manifest.permutationSets[setIndex];
+
+                std::vector<uint32_t> masks;
+                for (const auto& entry : manifest.entries)
+                    if (entry.permutationSet == setIndex)
+                        masks.push_back(entry.permutationMask);
+                std::sort(masks.begin(), masks.end());
+
+                std::vector<uint8_t> blob;
+                serializePermutations(permutationSet, masks, blob);
+
+                const auto name = std::filesystem::path(permutationSet.module).stem().string() + "_" + permutationSet.entryPoint + ".perm";
+                writeFile((std::filesystem::path(description_.outputDirectory) / name).string(), blob);
+            }
+
+            if (!description_.packPath.empty())
+            {
+                std::string log;
+                std::vector<uint8_t> pack;
+                if (PackBuilder().Serialize(packShaders, pack, log))
+                    writeFile(description_.packPath, pack);
+                else
+                {
+                    failed++;
+                    Log::Print::Warning(log);
+                }
+            }
+
+            Statistics statistics;
+            statistics.compiled = compiled;
+            statistics.cached = cached;
+            statistics.failed = failed;
+            return statistics;
+        }
+
+        bool BatchCompiler::CompileEntry(Session& session,
+                                         const Manifest::Entry& entry,
+                                         const std::vector<std::string>& searchPaths,
+                                         std::vector<uint8_t>& bytecode,
+                                         std::vector<uint8_t>* reflection,
+                                         std::string& log)
+        {
+            CompileRequest::Description description;
+            description.target = entry.target;
+            description.defines = entry.defines;
+            description.searchPaths = searchPaths;
+
+            const auto request = session.CreateCompileRequest(description);
+
+            if (!request->LoadModule(entry.module, log))
+                return false;
+
+            if (!request->AddEntryPoint(entry.entryPoint, log))
+                return false;
+
+            const auto program = request->Compile(log);
+            if (!program)
+                return false;
+
+            if (!program->GetShaderProgram(bytecode, log))
+                return false;
+
+            return !reflection || program->GetReflection(*reflection, log);
+        }
+
+        std::string BatchCompiler::getOutputName(const Manifest::Entry& entry)
+        {
+            auto name = std::filesystem::path(entry.module).stem().string() + "_" + entry.entryPoint;
+
+            // Keyword defines are implied by the mask, see Rfx::Permutations.
+            if (entry.permutationSet != Manifest::NoPermutationSet)
+                return name + fmt::sprintf("_P%x", entry.permutationMask);
+
+            for (const auto& define : entry.defines)
+                name += "_" + define.name + (define.value == "1" ? "" : define.value);
+
+            return name;
+        }
+
+        uint64_t BatchCompiler::getPackKey(const Manifest::Entry& entry)
+        {
+            if (entry.permutationSet != Manifest::NoPermutationSet)
+            {
+                const auto name = std::filesystem::path(entry.module).stem().string() + "_" + entry.entryPoint;
+                return Pack::GetKey(name.c_str(), entry.permutationMask);
+            }
+
+            return Pack::GetKey(getOutputName(entry).c_str());
+        }
+
+        std::string BatchCompiler::getOutputPath(const Manifest::Entry& entry, const char* extension) const
+        {
+            return (std::filesystem::path(description_.outputDirectory) / (getOutputName(entry) + extension)).string();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "compiler/Manifest.hpp"
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        class Session;
+
+        class BatchCompiler final
+        {
+        public:
+            struct Description final
+            {
+                std::string outputDirectory;
+                // Cache is disabled when empty.
+                std::string cacheDirectory;
+                std::vector<std::string> searchPaths;
+                // Zero means hardware concurrency.
+                uint32_t threadsCount = 0;
+                // Remote rfx workers as "host:port", they share the queue with local threads.
+                std::vector<std::string> workers;
+                // Shaders are written into single Rfx::Pack file instead of .bin and .refl pairs when set.
+                std::string packPath;
+            };
+
+            struct Statistics final
+            {
+                uint32_t compiled = 0;
+                uint32_t cached = 0;
+                uint32_t failed = 0;
+            };
+
+        public:
+            BatchCompiler(const Description& description);
+
+            Statistics Compile(const Manifest& manifest);
+
+            // Reflection is skipped when null.
+            static bool CompileEntry(Session& session,
+                                     const Manifest::Entry& entry,
+                                     const std::vector<std::string>& searchPaths,
+                                     std::vector<uint8_t>& bytecode,
+                                     std::vector<uint8_t>* reflection,
+                                     std::string& log);
+
+        private:
+            static std::string getOutputName(const Manifest::Entry& entry);
+            static uint64_t getPackKey(const Manifest::Entry& entry);
+            std::string getOutputPath(const Manifest::Entry& entry, const char* extension) const;
+
+        private:
+            Description description_;
+        };
+    }
+}
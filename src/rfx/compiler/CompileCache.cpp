@@ -0,0 +1,322 @@
+#include "CompileCache.hpp"
+
+#include "compiler/Dependencies.hpp"
+
+#include "include/rfx.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    constexpr uint64_t FnvOffsetBasis = 0xcbf29ce484222325ull;
+    constexpr uint64_t FnvPrime = 0x100000001b3ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t index = 0; index < size; index++)
+        {
+            hash ^= bytes[index];
+            hash *= FnvPrime;
+        }
+
+        return hash;
+    }
+
+    uint64_t hashString(uint64_t hash, const std::string& string)
+    {
+        // Include terminator so adjacent strings don't collide.
+        return hashBytes(hash, string.c_str(), string.size() + 1);
+    }
+
+    bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        return file.good() || file.eof();
+    }
+
+    constexpr const char* DependenciesFileName = "dependencies.txt";
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        CompileCache::CompileCache(const std::string& cacheDirectory)
+            : cacheDirectory_(cacheDirectory)
+        {
+            std::error_code error;
+            std::filesystem::create_directories(cacheDirectory_, error);
+
+            loadDependencies();
+        }
+
+        bool CompileCache::GetKey(const Manifest::Entry& entry, const std::vector<std::string>& searchPaths, uint64_t& key)
+        {
+            uint64_t dependenciesHash;
+            if (!getDependenciesHash(entry.module, searchPaths, dependenciesHash))
+                return false;
+
+            // Define order must not affect the key.
+            auto defines = entry.defines;
+            std::sort(defines.begin(), defines.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+            uint64_t hash = hashBytes(FnvOffsetBasis, &dependenciesHash, sizeof(dependenciesHash));
+            hash = hashString(hash, entry.entryPoint);
+            hash = hashBytes(hash, &entry.target, sizeof(entry.target));
+
+            for (const auto& define : defines)
+            {
+                hash = hashString(hash, define.name);
+                hash = hashString(hash, define.value);
+            }
+
+            key = hash;
+            return true;
+        }
+
+        bool CompileCache::Load(uint64_t key, const char* extension, std::vector<uint8_t>& data) const
+        {
+            return readFile(getEntryPath(key, extension), data);
+        }
+
+        void CompileCache::Store(uint64_t key, const char* extension, const std::vector<uint8_t>& data) const
+        {
+            const auto path = getEntryPath(key, extension);
+            const auto tempPath = path + ".tmp";
+
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file)
+                    return;
+
+                file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+                if (!file)
+                    return;
+            }
+
+            // Concurrent rfx instances may race on the same key, last rename wins with identical content.
+            std::error_code error;
+            std::filesystem::rename(tempPath, path, error);
+            if (error)
+                std::filesystem::remove(tempPath, error);
+        }
+
+        std::string CompileCache::getEntryPath(uint64_t key, const char* extension) const
+        {
+            return (std::filesystem::path(cacheDirectory_) / fmt::sprintf("%016llx%s", key, extension)).string();
+        }
+
+        bool CompileCache::getDependenciesHash(const std::string& module, const std::vector<std::string>& searchPaths, uint64_t& hash)
+        {
+            uint64_t moduleKey = hashString(FnvOffsetBasis, module);
+            for (const auto& searchPath : searchPaths)
+                moduleKey = hashString(moduleKey, searchPath);
+
+            std::vector<std::string> dependencies;
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                const auto resolved = dependencyHashes_.find(moduleKey);
+                if (resolved != dependencyHashes_.end())
+                {
+                    hash = resolved->second;
+                    return true;
+                }
+
+                const auto recorded = moduleDependencies_.find(moduleKey);
+                if (recorded != moduleDependencies_.end())
+                    dependencies = recorded->second;
+            }
+
+            // Recorded graph holds while no dependency content changed, edited file may add or remove imports.
+            bool isGraphValid = !dependencies.empty();
+            hash = FnvOffsetBasis;
+            for (const auto& dependency : dependencies)
+            {
+                FileState state;
+                bool isContentChanged = false;
+                if (!updateFileState(dependency, state, isContentChanged) || isContentChanged)
+                {
+                    isGraphValid = false;
+                    break;
+                }
+
+                hash = hashBytes(hash, &state.hash, sizeof(state.hash));
+            }
+
+            if (!isGraphValid)
+            {
+                dependencies.clear();
+                for (const auto& dependency : CollectDependencies(module, searchPaths))
+                    dependencies.push_back(dependency.lexically_normal().string());
+
+                if (dependencies.empty())
+                    return false;
+
+                hash = FnvOffsetBasis;
+                for (const auto& dependency : dependencies)
+                {
+                    FileState state;
+                    bool isContentChanged = false;
+                    if (!updateFileState(dependency, state, isContentChanged))
+                        return false;
+
+                    hash = hashBytes(hash, &state.hash, sizeof(state.hash));
+                }
+            }
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (!isGraphValid)
+            {
+                moduleDependencies_[moduleKey] = std::move(dependencies);
+                isDirty_ = true;
+            }
+
+            dependencyHashes_[moduleKey] = hash;
+            return true;
+        }
+
+        bool CompileCache::updateFileState(const std::string& path, FileState& state, bool& isContentChanged)
+        {
+            std::error_code error;
+            const auto modificationTime = std::filesystem::last_write_time(path, error);
+            if (error)
+                return false;
+
+            const auto size = std::filesystem::file_size(path, error);
+            if (error)
+                return false;
+
+            state.modificationTime = static_cast<int64_t>(modificationTime.time_since_epoch().count());
+            state.size = static_cast<uint64_t>(size);
+
+            bool isRecorded = false;
+            {
+                Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+                const auto it = fileStates_.find(path);
+                if (it != fileStates_.end())
+                {
+                    if (it->second.modificationTime == state.modificationTime && it->second.size == state.size)
+                    {
+                        state.hash = it->second.hash;
+                        isContentChanged = changedFiles_.count(path) != 0;
+                        return true;
+                    }
+
+                    isRecorded = true;
+                    state.hash = it->second.hash;
+                }
+            }
+
+            std::vector<uint8_t> content;
+            if (!readFile(path, content))
+                return false;
+
+            const auto hash = hashBytes(FnvOffsetBasis, content.data(), content.size());
+
+            // Touched but unchanged file keeps the graph.
+            isContentChanged = !isRecorded || state.hash != hash;
+            state.hash = hash;
+
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            fileStates_[path] = state;
+            if (isContentChanged)
+                changedFiles_.insert(path);
+            isDirty_ = true;
+
+            return true;
+        }
+
+        // Text format:
+        // F <modificationTime> <size> <hash> <path>
+        // M <moduleKey> followed by D <path> per dependency.
+        void CompileCache::loadDependencies()
+        {
+            std::ifstream file(std::filesystem::path(cacheDirectory_) / DependenciesFileName);
+            if (!file)
+                return;
+
+            std::vector<std::string>* dependencies = nullptr;
+
+            std::string line;
+            while (std::getline(file, line))
+            {
+                std::istringstream tokens(line);
+
+                std::string type;
+                tokens >> type;
+
+                if (type == "F")
+                {
+                    FileState state;
+                    std::string path;
+                    if (tokens >> state.modificationTime >> state.size >> std::hex >> state.hash >> std::ws && std::getline(tokens, path))
+                        fileStates_[path] = state;
+                }
+                else if (type == "M")
+                {
+                    uint64_t moduleKey;
+                    dependencies = (tokens >> std::hex >> moduleKey) ? &moduleDependencies_[moduleKey] : nullptr;
+                }
+                else if (type == "D" && dependencies)
+                {
+                    std::string path;
+                    if (std::getline(tokens >> std::ws, path))
+                        dependencies->push_back(path);
+                }
+            }
+        }
+
+        void CompileCache::SaveDependencies()
+        {
+            Threading::UniqueLock<Threading::Mutex> lock(mutex_);
+
+            if (!isDirty_)
+                return;
+
+            const auto path = std::filesystem::path(cacheDirectory_) / DependenciesFileName;
+            auto tempPath = path;
+            tempPath += ".tmp";
+
+            {
+                std::ofstream file(tempPath, std::ios::trunc);
+                if (!file)
+                    return;
+
+                for (const auto& [filePath, state] : fileStates_)
+                    file << "F " << state.modificationTime << " " << state.size << " " << std::hex << state.hash << std::dec << " " << filePath << "\n";
+
+                for (const auto& [moduleKey, dependencies] : moduleDependencies_)
+                {
+                    file << "M " << std::hex << moduleKey << std::dec << "\n";
+                    for (const auto& dependency : dependencies)
+                        file << "D " << dependency << "\n";
+                }
+
+                if (!file)
+                    return;
+            }
+
+            std::error_code error;
+            std::filesystem::rename(tempPath, path, error);
+            if (error)
+                std::filesystem::remove(tempPath, error);
+
+            isDirty_ = false;
+        }
+    }
+}
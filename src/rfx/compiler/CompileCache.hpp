@@ -0,0 +1,65 @@
+#pragma once
+
+#include "compiler/Manifest.hpp"
+
+#include "common/threading/Mutex.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // Content addressed on-disk cache of compiled shaders.
+        // Key covers module source with all its dependencies, entry point, target and defines.
+        // Dependency graph of every module and mtime, size and content hash of every file in it are kept in cache
+        // metadata between runs. Files with unchanged mtime and size aren't read and graph is rescanned only when
+        // content of some dependency changed, so no-op builds cost a stat per dependency.
+        class CompileCache final
+        {
+        public:
+            CompileCache(const std::string& cacheDirectory);
+
+            // Returns false when module source can't be read. Thread safe.
+            bool GetKey(const Manifest::Entry& entry, const std::vector<std::string>& searchPaths, uint64_t& key);
+
+            // Persists dependency graphs and file states for next run.
+            void SaveDependencies();
+
+            static constexpr const char* BytecodeExtension = ".bin";
+            static constexpr const char* ReflectionExtension = ".refl";
+
+            bool Load(uint64_t key, const char* extension, std::vector<uint8_t>& data) const;
+            void Store(uint64_t key, const char* extension, const std::vector<uint8_t>& data) const;
+
+        private:
+            struct FileState final
+            {
+                int64_t modificationTime;
+                uint64_t size;
+                uint64_t hash;
+            };
+
+        private:
+            std::string getEntryPath(uint64_t key, const char* extension) const;
+            bool getDependenciesHash(const std::string& module, const std::vector<std::string>& searchPaths, uint64_t& hash);
+            // Reads file only when mtime or size differs from recorded state.
+            bool updateFileState(const std::string& path, FileState& state, bool& isContentChanged);
+            void loadDependencies();
+
+        private:
+            std::string cacheDirectory_;
+
+            Threading::Mutex mutex_;
+            std::unordered_map<std::string, FileState> fileStates_;
+            // Normalized dependency paths by hash of module name and search paths, module source goes first.
+            std::unordered_map<uint64_t, std::vector<std::string>> moduleDependencies_;
+            // Resolved during this run, so entries sharing a module check it once.
+            std::unordered_map<uint64_t, uint64_t> dependencyHashes_;
+            // Files whose content changed during this run, graphs of all modules including them are rescanned.
+            std::unordered_set<std::string> changedFiles_;
+            bool isDirty_ = false;
+        };
+    }
+}
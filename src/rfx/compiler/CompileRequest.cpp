@@ -34,13 +34,45 @@ namespace Rfx
 {
     namespace Compiler
     {
-        CompileRequest::CompileRequest(const ::Slang::ComPtr<slang::IGlobalSession>& globalSesion)
+        CompileRequest::CompileRequest(const ::Slang::ComPtr<slang::IGlobalSession>& globalSesion,
+                                       const std::shared_ptr<SessionCache>& sessionCache,
+                                       const Description& description)
+            : sessionCache_(sessionCache)
         {
             ASSERT(globalSesion);
+            ASSERT(sessionCache_);
+
+            if (sessionCache_->session)
+            {
+                session_ = sessionCache_->session;
+                return;
+            }
+
+            slang::TargetDesc targetDesc = {};
+            targetDesc.format = getCompileTargetConversion(description.target);
+
+            std::vector<slang::PreprocessorMacroDesc> macros;
+            macros.reserve(description.defines.size());
+            for (const auto& define : description.defines)
+                macros.push_back({ define.name.c_str(), define.value.c_str() });
+
+            std::vector<const char*> searchPaths;
+            searchPaths.reserve(description.searchPaths.size());
+            for (const auto& searchPath : description.searchPaths)
+                searchPaths.push_back(searchPath.c_str());
 
             slang::SessionDesc desc = {};
+            desc.targets = &targetDesc;
+            desc.targetCount = 1;
+            desc.preprocessorMacros = macros.data();
+            desc.preprocessorMacroCount = static_cast<SlangInt>(macros.size());
+            desc.searchPaths = searchPaths.data();
+            desc.searchPathCount = static_cast<SlangInt>(searchPaths.size());
+
             globalSesion->createSession(desc, session_.writeRef());
             ASSERT(session_);
+
+            sessionCache_->session = session_;
         }
 
         CompileRequest::~CompileRequest()
@@ -50,6 +82,7 @@ namespace Rfx
 
         void CompileRequest::clearModules()
         {
+            entryPoints_.clear();
             components_.clear();
         }
 
@@ -57,35 +90,49 @@ namespace Rfx
         {
             ASSERT(session_);
 
+            const auto it = sessionCache_->modules.find(name);
+            if (it != sessionCache_->modules.end())
+            {
+                components_.push_back(it->second);
+                return true;
+            }
+
             Slang::ComPtr<slang::IBlob> diagnosticsBlob;
             slang::IModule* module = session_->loadModule(name.c_str(), diagnosticsBlob.writeRef());
 
             if (diagnosticsBlob)
                 log += (const char*)diagnosticsBlob->getBufferPointer();
 
+            // Failed modules are not cached, so fixed source is picked up by next request.
             if (!module)
                 return false;
 
+            sessionCache_->modules.emplace(name, Slang::ComPtr<slang::IModule>(module));
             components_.push_back(module);
 
             return true;
         }
 
-        bool CompileRequest::AddEntryPoint()
+        bool CompileRequest::AddEntryPoint(const std::string& name, std::string& log)
         {
             ASSERT(session_);
 
             for (auto component : components_)
             {
-                slang::IModule* module;
-                if (SLANG_FAILED(component->queryInterface(slang::IModule::getTypeGuid(), (void**)&module)))
+                Slang::ComPtr<slang::IModule> module;
+                if (SLANG_FAILED(component->queryInterface(slang::IModule::getTypeGuid(), (void**)module.writeRef())))
                     continue;
 
                 Slang::ComPtr<slang::IEntryPoint> entryPoint;
-                if (SLANG_FAILED(module->findEntryPointByName("weq", entryPoint.writeRef())))
+                if (SLANG_FAILED(module->findEntryPointByName(name.c_str(), entryPoint.writeRef())))
                     continue;
+
+                components_.push_back(entryPoint);
+                entryPoints_.push_back(entryPoint);
+                return true;
             }
 
+            log += fmt::sprintf("Entry point \"%s\" not found\n", name);
             return false;
         }
 
@@ -97,8 +144,8 @@ namespace Rfx
             Slang::ComPtr<slang::IBlob> diagnosticsBlob;
 
             const auto result = session_->createCompositeComponentType(
-                components_.empty() ? nullptr : &components_.front(),
-                components_.size(),
+                components_.empty() ? nullptr : components_.data(),
+                static_cast<SlangInt>(components_.size()),
                 composedProgram.writeRef(),
                 diagnosticsBlob.writeRef());
 
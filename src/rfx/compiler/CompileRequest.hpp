@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+
 namespace slang
 {
     struct ICompileRequest;
@@ -15,12 +17,27 @@ namespace Rfx
         class Session;
         class Program;
 
+        // Slang session shared between requests with equal description. Modules are parsed and checked once per session.
+        struct SessionCache final
+        {
+            ::Slang::ComPtr<slang::ISession> session;
+            std::unordered_map<std::string, ::Slang::ComPtr<slang::IModule>> modules;
+        };
+
         class CompileRequest final : public std::enable_shared_from_this<CompileRequest>
         {
         public:
+            struct Define final
+            {
+                std::string name;
+                std::string value;
+            };
+
             struct Description final
             {
                 CompileTarget target;
+                std::vector<Define> defines;
+                std::vector<std::string> searchPaths;
             };
 
         public:
@@ -30,19 +47,23 @@ namespace Rfx
             ~CompileRequest();
 
             bool LoadModule(const std::string& name, std::string& log);
-            bool AddEntryPoint();
+            bool AddEntryPoint(const std::string& name, std::string& log);
 
             std::shared_ptr<Program> Compile(std::string& log);
 
         private:
-            CompileRequest(const ::Slang::ComPtr<slang::IGlobalSession>& globalSesion);
+            CompileRequest(const ::Slang::ComPtr<slang::IGlobalSession>& globalSesion,
+                           const std::shared_ptr<SessionCache>& sessionCache,
+                           const Description& description);
 
         private:
             void clearModules();
 
         private:
+            std::shared_ptr<SessionCache> sessionCache_;
             ::Slang::ComPtr<slang::ISession> session_;
-            std::list<slang::IComponentType*> components_;
+            std::vector<slang::IComponentType*> components_;
+            std::vector<::Slang::ComPtr<slang::IEntryPoint>> entryPoints_;
 
             friend class Session;
         };
@@ -0,0 +1,96 @@
+#include "Dependencies.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <regex>
+#include <unordered_set>
+
+namespace
+{
+    std::filesystem::path findFile(const std::filesystem::path& fileName,
+                                   const std::filesystem::path& includerDirectory,
+                                   const std::vector<std::string>& searchPaths)
+    {
+        std::error_code error;
+
+        if (!includerDirectory.empty() && std::filesystem::exists(includerDirectory / fileName, error))
+            return includerDirectory / fileName;
+
+        if (std::filesystem::exists(fileName, error))
+            return fileName;
+
+        for (const auto& searchPath : searchPaths)
+        {
+            const auto path = std::filesystem::path(searchPath) / fileName;
+            if (std::filesystem::exists(path, error))
+                return path;
+        }
+
+        return {};
+    }
+
+    std::filesystem::path moduleToFileName(const std::string& module)
+    {
+        std::filesystem::path fileName = module;
+        if (fileName.has_extension() && fileName.extension() == ".slang")
+            return fileName;
+
+        // Same as slang: dots separate directories, underscores map to dashes.
+        auto name = module;
+        std::replace(name.begin(), name.end(), '.', '/');
+        std::replace(name.begin(), name.end(), '_', '-');
+        return name + ".slang";
+    }
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        std::filesystem::path FindModuleSource(const std::string& module, const std::vector<std::string>& searchPaths)
+        {
+            return findFile(moduleToFileName(module), {}, searchPaths);
+        }
+
+        std::vector<std::filesystem::path> CollectDependencies(const std::string& module, const std::vector<std::string>& searchPaths)
+        {
+            static const std::regex importRegex(R"(^\s*(?:__exported\s+)?import\s+([\w\.\-]+)\s*;)");
+            static const std::regex includeRegex(R"(^\s*#\s*include\s*[<"]([^>"]+)[>"])");
+
+            std::vector<std::filesystem::path> dependencies;
+
+            const auto source = FindModuleSource(module, searchPaths);
+            if (source.empty())
+                return dependencies;
+
+            std::unordered_set<std::string> visited;
+            visited.insert(source.lexically_normal().string());
+            dependencies.push_back(source);
+
+            for (size_t index = 0; index < dependencies.size(); index++)
+            {
+                // Copy, push_back below may reallocate.
+                const auto current = dependencies[index];
+                std::ifstream file(current);
+
+                std::string line;
+                std::smatch match;
+                while (std::getline(file, line))
+                {
+                    std::filesystem::path dependency;
+                    if (std::regex_search(line, match, importRegex))
+                        dependency = findFile(moduleToFileName(match[1]), current.parent_path(), searchPaths);
+                    else if (std::regex_search(line, match, includeRegex))
+                        dependency = findFile(match[1].str(), current.parent_path(), searchPaths);
+
+                    if (dependency.empty() || !visited.insert(dependency.lexically_normal().string()).second)
+                        continue;
+
+                    dependencies.push_back(dependency);
+                }
+            }
+
+            return dependencies;
+        }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <filesystem>
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // Resolves module name ("lighting.brdf") to source file. Returns empty path when not found.
+        std::filesystem::path FindModuleSource(const std::string& module, const std::vector<std::string>& searchPaths);
+
+        // Module source followed by every file it transitively imports or includes.
+        // Textual scan of import/#include directives, conditional compilation is not evaluated.
+        std::vector<std::filesystem::path> CollectDependencies(const std::string& module, const std::vector<std::string>& searchPaths);
+    }
+}
@@ -0,0 +1,309 @@
+#include "Manifest.hpp"
+
+#include "include/rfx.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    bool parseTarget(const std::string& name, Rfx::CompileTarget& target)
+    {
+        if (name == "dxil")
+            target = Rfx::CompileTarget::Dxil;
+        else if (name == "dxil_asm")
+            target = Rfx::CompileTarget::Dxil_asm;
+        else
+            return false;
+
+        return true;
+    }
+
+    std::vector<std::string> readKeywords(std::istringstream& tokens)
+    {
+        std::vector<std::string> keywords;
+        std::string keyword;
+        while (tokens >> keyword)
+            keywords.push_back(keyword);
+
+        return keywords;
+    }
+
+    Rfx::Compiler::Manifest::PermutationSet* findPermutationSet(Rfx::Compiler::Manifest& manifest, const std::string& module, const std::string& entryPoint)
+    {
+        for (auto& permutationSet : manifest.permutationSets)
+            if (permutationSet.module == module && permutationSet.entryPoint == entryPoint)
+                return &permutationSet;
+
+        return nullptr;
+    }
+
+    bool parsePermutations(const std::string& path, uint32_t lineNumber, std::istringstream& tokens, Rfx::Compiler::Manifest& manifest, std::string& log)
+    {
+        Rfx::Compiler::Manifest::PermutationSet permutationSet;
+
+        std::string target;
+        if (!(tokens >> permutationSet.module >> permutationSet.entryPoint >> target))
+        {
+            log += fmt::sprintf("%s(%d): expected permutations <module> <entryPoint> <target> KEYWORD...\n", path, lineNumber);
+            return false;
+        }
+
+        if (!parseTarget(target, permutationSet.target))
+        {
+            log += fmt::sprintf("%s(%d): unknown target \"%s\"\n", path, lineNumber, target);
+            return false;
+        }
+
+        if (findPermutationSet(manifest, permutationSet.module, permutationSet.entryPoint))
+        {
+            log += fmt::sprintf("%s(%d): permutations of %s:%s are already declared\n", path, lineNumber, permutationSet.module, permutationSet.entryPoint);
+            return false;
+        }
+
+        permutationSet.keywords = readKeywords(tokens);
+        if (permutationSet.keywords.size() > Rfx::Permutations::MaxKeywords)
+        {
+            log += fmt::sprintf("%s(%d): more than %d keywords\n", path, lineNumber, Rfx::Permutations::MaxKeywords);
+            return false;
+        }
+
+        for (auto it = permutationSet.keywords.begin(); it != permutationSet.keywords.end(); ++it)
+        {
+            if (std::find(permutationSet.keywords.begin(), it, *it) != it)
+            {
+                log += fmt::sprintf("%s(%d): duplicate keyword \"%s\"\n", path, lineNumber, *it);
+                return false;
+            }
+        }
+
+        manifest.permutationSets.push_back(std::move(permutationSet));
+        return true;
+    }
+
+    bool parseConstraint(const std::string& path, uint32_t lineNumber, const std::string& constraint, std::istringstream& tokens, Rfx::Compiler::Manifest& manifest, std::string& log)
+    {
+        if (manifest.permutationSets.empty())
+        {
+            log += fmt::sprintf("%s(%d): %s constraint without permutations declaration\n", path, lineNumber, constraint);
+            return false;
+        }
+
+        auto& permutationSet = manifest.permutationSets.back();
+        const auto keywords = readKeywords(tokens);
+
+        uint32_t mask = 0;
+        if (keywords.empty() || !permutationSet.GetMask(keywords, mask))
+        {
+            log += fmt::sprintf("%s(%d): %s constraint expects keywords of %s:%s\n", path, lineNumber, constraint, permutationSet.module, permutationSet.entryPoint);
+            return false;
+        }
+
+        if (constraint == "exclusive")
+        {
+            permutationSet.exclusiveMasks.push_back(mask);
+            return true;
+        }
+
+        uint32_t keywordMask = 0;
+        permutationSet.GetMask({ keywords.front() }, keywordMask);
+        permutationSet.requirements.push_back({ keywordMask, mask & ~keywordMask });
+
+        return true;
+    }
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        bool Manifest::Load(const std::string& path, Manifest& manifest, std::string& log)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                log += fmt::sprintf("Can't open manifest \"%s\"\n", path);
+                return false;
+            }
+
+            std::string line;
+            for (uint32_t lineNumber = 1; std::getline(file, line); lineNumber++)
+            {
+                std::istringstream tokens(line);
+
+                std::string module;
+                if (!(tokens >> module) || module[0] == '#')
+                    continue;
+
+                if (module == "permutations")
+                {
+                    if (!parsePermutations(path, lineNumber, tokens, manifest, log))
+                        return false;
+
+                    continue;
+                }
+
+                if (module == "exclusive" || module == "requires")
+                {
+                    if (!parseConstraint(path, lineNumber, module, tokens, manifest, log))
+                        return false;
+
+                    continue;
+                }
+
+                Entry entry;
+                entry.module = module;
+
+                std::string target;
+                if (!(tokens >> entry.entryPoint >> target))
+                {
+                    log += fmt::sprintf("%s(%d): expected <module> <entryPoint> <target>\n", path, lineNumber);
+                    return false;
+                }
+
+                if (!parseTarget(target, entry.target))
+                {
+                    log += fmt::sprintf("%s(%d): unknown target \"%s\"\n", path, lineNumber, target);
+                    return false;
+                }
+
+                std::string define;
+                while (tokens >> define)
+                {
+                    const auto separator = define.find('=');
+                    if (separator == std::string::npos)
+                        entry.defines.push_back({ define, "1" });
+                    else
+                        entry.defines.push_back({ define.substr(0, separator), define.substr(separator + 1) });
+                }
+
+                manifest.entries.push_back(std::move(entry));
+            }
+
+            return true;
+        }
+
+        bool Manifest::LoadUsage(const std::string& path, Manifest& manifest, std::string& log)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                log += fmt::sprintf("Can't open usage data \"%s\"\n", path);
+                return false;
+            }
+
+            std::string line;
+            for (uint32_t lineNumber = 1; std::getline(file, line); lineNumber++)
+            {
+                std::istringstream tokens(line);
+
+                std::string module;
+                if (!(tokens >> module) || module[0] == '#')
+                    continue;
+
+                std::string entryPoint;
+                if (!(tokens >> entryPoint))
+                {
+                    log += fmt::sprintf("%s(%d): expected <module> <entryPoint> [KEYWORD...]\n", path, lineNumber);
+                    return false;
+                }
+
+                const auto permutationSet = findPermutationSet(manifest, module, entryPoint);
+                if (!permutationSet)
+                {
+                    log += fmt::sprintf("%s(%d): no permutations declared for %s:%s\n", path, lineNumber, module, entryPoint);
+                    return false;
+                }
+
+                uint32_t mask = 0;
+                if (!permutationSet->GetMask(readKeywords(tokens), mask))
+                {
+                    log += fmt::sprintf("%s(%d): unknown keyword of %s:%s\n", path, lineNumber, module, entryPoint);
+                    return false;
+                }
+
+                // Material asking for disallowed combination would have no shader at runtime.
+                if (!permutationSet->IsAllowed(mask))
+                {
+                    log += fmt::sprintf("%s(%d): permutation isn't allowed by declaration of %s:%s\n", path, lineNumber, module, entryPoint);
+                    return false;
+                }
+
+                permutationSet->usedMasks.push_back(mask);
+            }
+
+            return true;
+        }
+
+        void Manifest::ExpandPermutations()
+        {
+            for (uint32_t setIndex = 0; setIndex < permutationSets.size(); setIndex++)
+            {
+                auto& permutationSet = permutationSets[setIndex];
+
+                std::vector<uint32_t> masks;
+                if (permutationSet.usedMasks.empty())
+                {
+                    const uint32_t permutationsCount = 1u << permutationSet.keywords.size();
+                    for (uint32_t mask = 0; mask < permutationsCount; mask++)
+                        if (permutationSet.IsAllowed(mask))
+                            masks.push_back(mask);
+                }
+                else
+                {
+                    masks = permutationSet.usedMasks;
+                    std::sort(masks.begin(), masks.end());
+                    masks.erase(std::unique(masks.begin(), masks.end()), masks.end());
+                }
+
+                for (const auto mask : masks)
+                {
+                    Entry entry;
+                    entry.module = permutationSet.module;
+                    entry.entryPoint = permutationSet.entryPoint;
+                    entry.target = permutationSet.target;
+                    entry.permutationSet = setIndex;
+                    entry.permutationMask = mask;
+
+                    // Disabled keywords are defined too, so shaders can test them with plain if.
+                    for (uint32_t keyword = 0; keyword < permutationSet.keywords.size(); keyword++)
+                        entry.defines.push_back({ permutationSet.keywords[keyword], (mask & (1u << keyword)) ? "1" : "0" });
+
+                    entries.push_back(std::move(entry));
+                }
+            }
+        }
+
+        bool Manifest::PermutationSet::IsAllowed(uint32_t mask) const
+        {
+            for (const auto exclusiveMask : exclusiveMasks)
+            {
+                const auto enabled = mask & exclusiveMask;
+                if (enabled & (enabled - 1))
+                    return false;
+            }
+
+            for (const auto& requirement : requirements)
+                if ((mask & requirement.keywordMask) && (mask & requirement.dependenciesMask) != requirement.dependenciesMask)
+                    return false;
+
+            return true;
+        }
+
+        bool Manifest::PermutationSet::GetMask(const std::vector<std::string>& keywordNames, uint32_t& mask) const
+        {
+            mask = 0;
+            for (const auto& name : keywordNames)
+            {
+                const auto it = std::find(keywords.begin(), keywords.end(), name);
+                if (it == keywords.end())
+                    return false;
+
+                mask |= 1u << static_cast<uint32_t>(it - keywords.begin());
+            }
+
+            return true;
+        }
+    }
+}
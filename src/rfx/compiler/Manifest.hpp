@@ -0,0 +1,71 @@
+#pragma once
+
+#include "compiler/CompileRequest.hpp"
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // Batch of shaders to compile. Text format, one shader per line:
+        // <module> <entryPoint> <target> [NAME[=VALUE]...]
+        // Empty lines and lines starting with '#' are ignored.
+        //
+        // Shader permutations are declared with feature keywords, constraint lines apply to the declaration above them:
+        // permutations <module> <entryPoint> <target> KEYWORD...
+        // exclusive KEYWORD...                 at most one of keywords is enabled
+        // requires KEYWORD DEPENDENCY...       keyword is enabled only together with all dependencies
+        // Every reachable permutation compiles to a separate entry with all keywords defined to 0 or 1, so shader
+        // branches on them are resolved at compile time.
+        struct Manifest final
+        {
+            static constexpr uint32_t NoPermutationSet = 0xFFFFFFFF;
+
+            struct Entry final
+            {
+                std::string module;
+                std::string entryPoint;
+                CompileTarget target;
+                std::vector<CompileRequest::Define> defines;
+                // Index into permutationSets and keywords bitmask for permutation entries.
+                uint32_t permutationSet = NoPermutationSet;
+                uint32_t permutationMask = 0;
+            };
+
+            struct PermutationSet final
+            {
+                struct Requirement final
+                {
+                    uint32_t keywordMask;
+                    uint32_t dependenciesMask;
+                };
+
+                std::string module;
+                std::string entryPoint;
+                CompileTarget target;
+                // Keyword index is its bit in permutation mask.
+                std::vector<std::string> keywords;
+                std::vector<uint32_t> exclusiveMasks;
+                std::vector<Requirement> requirements;
+                // Masks reported by usage data, all allowed permutations are reachable without it.
+                std::vector<uint32_t> usedMasks;
+
+                bool IsAllowed(uint32_t mask) const;
+                // Returns false for unknown keyword.
+                bool GetMask(const std::vector<std::string>& keywordNames, uint32_t& mask) const;
+            };
+
+            static bool Load(const std::string& path, Manifest& manifest, std::string& log);
+
+            // Material usage data, one used permutation per line:
+            // <module> <entryPoint> [KEYWORD...]
+            // Only used permutations of shaders listed in usage data are generated.
+            static bool LoadUsage(const std::string& path, Manifest& manifest, std::string& log);
+
+            // Appends entries for reachable permutations, call once declarations and usage data are loaded.
+            void ExpandPermutations();
+
+            std::vector<Entry> entries;
+            std::vector<PermutationSet> permutationSets;
+        };
+    }
+}
@@ -1,5 +1,161 @@
 #include "Program.hpp"
 
+#include "include/rfx.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    using namespace Rfx::Reflection;
+
+    struct ReflectionBuilder final
+    {
+        uint32_t addString(const char* string)
+        {
+            const auto offset = static_cast<uint32_t>(strings.size());
+            strings.insert(strings.end(), string, string + strlen(string) + 1);
+            return offset;
+        }
+
+        // Returns false for unsupported parameter kinds.
+        bool addParameter(slang::VariableLayoutReflection* parameter, std::string& log)
+        {
+            const char* name = parameter->getName() ? parameter->getName() : "";
+
+            Resource resource = {};
+            resource.nameHash = HashName(name);
+            resource.nameOffset = addString(name);
+            resource.space = static_cast<uint32_t>(parameter->getBindingSpace());
+            resource.binding = static_cast<uint32_t>(parameter->getBindingIndex());
+            resource.count = 1;
+            resource.constantBufferIndex = InvalidIndex;
+
+            auto typeLayout = parameter->getTypeLayout();
+            if (typeLayout->getKind() == slang::TypeReflection::Kind::Array)
+            {
+                resource.count = static_cast<uint32_t>(typeLayout->getElementCount());
+                typeLayout = typeLayout->getElementTypeLayout();
+            }
+
+            switch (typeLayout->getKind())
+            {
+                case slang::TypeReflection::Kind::ConstantBuffer:
+                {
+                    resource.type = ResourceType::ConstantBuffer;
+                    resource.constantBufferIndex = static_cast<uint32_t>(constantBuffers.size());
+
+                    const auto elementLayout = typeLayout->getElementTypeLayout();
+
+                    ConstantBuffer constantBuffer;
+                    constantBuffer.nameHash = resource.nameHash;
+                    constantBuffer.size = static_cast<uint32_t>(elementLayout->getSize());
+                    constantBuffer.firstVariable = static_cast<uint32_t>(variables.size());
+                    constantBuffer.variablesCount = elementLayout->getFieldCount();
+
+                    for (uint32_t index = 0; index < elementLayout->getFieldCount(); index++)
+                    {
+                        const auto field = elementLayout->getFieldByIndex(index);
+                        const char* fieldName = field->getName() ? field->getName() : "";
+
+                        Variable variable;
+                        variable.nameHash = HashName(fieldName);
+                        variable.nameOffset = addString(fieldName);
+                        variable.offset = static_cast<uint32_t>(field->getOffset());
+                        variable.size = static_cast<uint32_t>(field->getTypeLayout()->getSize());
+                        variables.push_back(variable);
+                    }
+
+                    constantBuffers.push_back(constantBuffer);
+                    break;
+                }
+                case slang::TypeReflection::Kind::Resource:
+                {
+                    const auto shape = typeLayout->getResourceShape() & SLANG_RESOURCE_BASE_SHAPE_MASK;
+                    const bool isTexture = shape >= SLANG_TEXTURE_1D && shape <= SLANG_TEXTURE_CUBE;
+                    const bool isWritable = typeLayout->getResourceAccess() == SLANG_RESOURCE_ACCESS_READ_WRITE;
+
+                    resource.type = isTexture ? (isWritable ? ResourceType::RWTexture : ResourceType::Texture)
+                                              : (isWritable ? ResourceType::RWBuffer : ResourceType::Buffer);
+                    break;
+                }
+                case slang::TypeReflection::Kind::SamplerState:
+                    resource.type = ResourceType::Sampler;
+                    break;
+                default:
+                    log += fmt::sprintf("Reflection of parameter \"%s\" is not supported\n", name);
+                    return false;
+            }
+
+            resources.push_back(resource);
+            return true;
+        }
+
+        void buildRootParameters()
+        {
+            const auto getTableType = [](const Resource& resource) {
+                return resource.type == ResourceType::Sampler ? RootParameterType::SamplerTable : RootParameterType::ResourceTable;
+            };
+
+            // Constant buffers keep their indices, only resources order changes.
+            std::stable_sort(resources.begin(), resources.end(), [&getTableType](const Resource& a, const Resource& b) {
+                if (getTableType(a) != getTableType(b))
+                    return getTableType(a) < getTableType(b);
+
+                return a.space != b.space ? a.space < b.space : a.binding < b.binding;
+            });
+
+            for (uint32_t index = 0; index < resources.size(); index++)
+            {
+                const auto type = getTableType(resources[index]);
+                if (rootParameters.empty() || rootParameters.back().type != type || rootParameters.back().space != resources[index].space)
+                    rootParameters.push_back({ type, resources[index].space, index, 0 });
+
+                rootParameters.back().resourcesCount++;
+            }
+        }
+
+        template <typename T>
+        static void append(std::vector<uint8_t>& blob, const std::vector<T>& items, uint32_t& offset, uint32_t& count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value && sizeof(T) % 4 == 0);
+
+            offset = static_cast<uint32_t>(blob.size());
+            count = static_cast<uint32_t>(items.size());
+
+            const auto data = reinterpret_cast<const uint8_t*>(items.data());
+            blob.insert(blob.end(), data, data + items.size() * sizeof(T));
+        }
+
+        void serialize(std::vector<uint8_t>& blob)
+        {
+            Header header = {};
+            header.magic = Magic;
+            header.version = Version;
+
+            blob.assign(sizeof(Header), 0);
+            append(blob, resources, header.resourcesOffset, header.resourcesCount);
+            append(blob, constantBuffers, header.constantBuffersOffset, header.constantBuffersCount);
+            append(blob, variables, header.variablesOffset, header.variablesCount);
+            append(blob, rootParameters, header.rootParametersOffset, header.rootParametersCount);
+
+            header.stringsOffset = static_cast<uint32_t>(blob.size());
+            header.stringsSize = static_cast<uint32_t>(strings.size());
+            blob.insert(blob.end(), strings.begin(), strings.end());
+            blob.resize((blob.size() + 3) & ~size_t(3), 0);
+
+            header.size = static_cast<uint32_t>(blob.size());
+            std::memcpy(blob.data(), &header, sizeof(Header));
+        }
+
+        std::vector<Resource> resources;
+        std::vector<ConstantBuffer> constantBuffers;
+        std::vector<Variable> variables;
+        std::vector<RootParameter> rootParameters;
+        std::vector<char> strings;
+    };
+}
+
 namespace Rfx
 {
     namespace Compiler
@@ -10,26 +166,46 @@ namespace Rfx
             ASSERT(composedProgram_);
         }
 
-        bool Program::GetShaderProgram(std::string& log)
+        bool Program::GetShaderProgram(std::vector<uint8_t>& bytecode, std::string& log)
         {
             auto programReflection = composedProgram_->getLayout();
-            for (uint32_t i = 0; i < programReflection->getEntryPointCount(); i++)
+            if (programReflection->getEntryPointCount() == 0)
             {
-              //  auto entryPointInfo = programReflection->getEntryPointByIndex(i);
-               // auto stage = entryPointInfo->getStage();
-                Slang::ComPtr<ISlangBlob> kernelCode;
-                Slang::ComPtr<ISlangBlob> diagnostics;
-                auto compileResult = composedProgram_->getEntryPointCode(
-                    i, 0, kernelCode.writeRef(), diagnostics.writeRef());
+                log += "Program has no entry points\n";
+                return false;
+            }
+
+            Slang::ComPtr<ISlangBlob> kernelCode;
+            Slang::ComPtr<ISlangBlob> diagnostics;
+            const auto compileResult = composedProgram_->getEntryPointCode(
+                0, 0, kernelCode.writeRef(), diagnostics.writeRef());
 
-                if (diagnostics)
-                    log = (char*)diagnostics->getBufferPointer();
+            if (diagnostics)
+                log += (char*)diagnostics->getBufferPointer();
 
-                if (!compileResult)
+            if (SLANG_FAILED(compileResult))
+                return false;
+
+            const auto data = static_cast<const uint8_t*>(kernelCode->getBufferPointer());
+            bytecode.assign(data, data + kernelCode->getBufferSize());
+
+            return true;
+        }
+
+        bool Program::GetReflection(std::vector<uint8_t>& blob, std::string& log)
+        {
+            auto programReflection = composedProgram_->getLayout();
+            ASSERT(programReflection);
+
+            ReflectionBuilder builder;
+            for (uint32_t index = 0; index < programReflection->getParameterCount(); index++)
+                if (!builder.addParameter(programReflection->getParameterByIndex(index), log))
                     return false;
-            }
+
+            builder.buildRootParameters();
+            builder.serialize(blob);
 
             return true;
         }
     }
-}
+}
\ No newline at end of file
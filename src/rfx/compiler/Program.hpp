@@ -12,7 +12,11 @@ namespace Rfx
             using SharedPtr = std::shared_ptr<Program>;
             using SharedConstPtr = std::shared_ptr<const Program>;
 
-            bool GetShaderProgram(std::string& log);
+            // Code of the first entry point for the first target.
+            bool GetShaderProgram(std::vector<uint8_t>& bytecode, std::string& log);
+            // Serializes program layout in Rfx::Reflection format.
+            bool GetReflection(std::vector<uint8_t>& blob, std::string& log);
+
         private:
             Program(const Slang::ComPtr<slang::IComponentType>& composedProgram);
 
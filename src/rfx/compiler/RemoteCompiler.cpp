@@ -0,0 +1,186 @@
+#include "RemoteCompiler.hpp"
+
+#include "compiler/BatchCompiler.hpp"
+#include "compiler/Session.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+#include "common/threading/Thread.hpp"
+
+#include "include/rfx.hpp"
+
+namespace
+{
+    // Guards worker against garbage from foreign clients.
+    constexpr uint32_t MaxMessageSize = 256 * 1024 * 1024;
+
+    class Writer final
+    {
+    public:
+        void Write(uint32_t value)
+        {
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            data_.insert(data_.end(), bytes, bytes + sizeof(value));
+        }
+
+        void Write(const void* data, size_t size)
+        {
+            Write(static_cast<uint32_t>(size));
+            data_.insert(data_.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+        }
+
+        void Write(const std::string& string) { Write(string.data(), string.size()); }
+        void Write(const std::vector<uint8_t>& blob) { Write(blob.data(), blob.size()); }
+
+        // Whole message goes with a single send.
+        bool Send(const Rfx::Compiler::Socket& socket) const { return socket.Send(data_.data(), data_.size()); }
+
+    private:
+        std::vector<uint8_t> data_;
+    };
+
+    bool receive(const Rfx::Compiler::Socket& socket, uint32_t& value)
+    {
+        return socket.Receive(&value, sizeof(value));
+    }
+
+    template <typename T>
+    bool receive(const Rfx::Compiler::Socket& socket, T& container)
+    {
+        uint32_t size;
+        if (!receive(socket, size) || size > MaxMessageSize)
+            return false;
+
+        container.resize(size);
+        return size == 0 || socket.Receive(container.data(), size);
+    }
+
+    void serveConnection(const Rfx::Compiler::Socket& socket, const std::vector<std::string>& searchPaths, uint32_t slots)
+    {
+        using namespace Rfx::Compiler;
+
+        ALLOCATION_TAG_SCOPE(Rfx);
+
+        Writer handshake;
+        handshake.Write(Remote::Magic);
+        handshake.Write(Remote::Version);
+        handshake.Write(slots);
+        if (!handshake.Send(socket))
+            return;
+
+        // Connections are long lived, modules loaded by earlier jobs are reused.
+        Session session;
+
+        for (;;)
+        {
+            Manifest::Entry entry;
+            uint32_t target;
+            uint32_t definesCount;
+            if (!receive(socket, entry.module) || !receive(socket, entry.entryPoint) ||
+                !receive(socket, target) || !receive(socket, definesCount) ||
+                target >= static_cast<uint32_t>(Rfx::CompileTarget::Count) || definesCount > MaxMessageSize)
+                return;
+
+            entry.target = static_cast<Rfx::CompileTarget>(target);
+            entry.defines.resize(definesCount);
+            for (auto& define : entry.defines)
+                if (!receive(socket, define.name) || !receive(socket, define.value))
+                    return;
+
+            std::vector<uint8_t> bytecode;
+            std::vector<uint8_t> reflection;
+            std::string log;
+            const bool isCompiled = BatchCompiler::CompileEntry(session, entry, searchPaths, bytecode, &reflection, log);
+
+            Writer result;
+            result.Write(isCompiled ? 1u : 0u);
+            result.Write(log);
+            result.Write(bytecode);
+            result.Write(reflection);
+            if (!result.Send(socket))
+                return;
+        }
+    }
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        namespace Remote
+        {
+            bool Connection::Open(const std::string& address)
+            {
+                socket_ = Socket::Connect(address);
+                if (!socket_.IsValid())
+                    return false;
+
+                uint32_t magic;
+                uint32_t version;
+                if (!receive(socket_, magic) || !receive(socket_, version) || !receive(socket_, slots_) ||
+                    magic != Magic || version != Version || slots_ == 0)
+                {
+                    socket_.Close();
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool Connection::Compile(const Manifest::Entry& entry,
+                                     std::vector<uint8_t>& bytecode,
+                                     std::vector<uint8_t>& reflection,
+                                     std::string& log,
+                                     bool& isCompiled)
+            {
+                ASSERT(IsOpen());
+
+                Writer request;
+                request.Write(entry.module);
+                request.Write(entry.entryPoint);
+                request.Write(static_cast<uint32_t>(entry.target));
+                request.Write(static_cast<uint32_t>(entry.defines.size()));
+                for (const auto& define : entry.defines)
+                {
+                    request.Write(define.name);
+                    request.Write(define.value);
+                }
+
+                uint32_t status;
+                std::string remoteLog;
+                if (!request.Send(socket_) || !receive(socket_, status) || !receive(socket_, remoteLog) ||
+                    !receive(socket_, bytecode) || !receive(socket_, reflection))
+                {
+                    socket_.Close();
+                    return false;
+                }
+
+                log += remoteLog;
+                isCompiled = status != 0;
+                return true;
+            }
+
+            bool RunWorker(uint16_t port, const std::vector<std::string>& searchPaths, uint32_t slots)
+            {
+                const auto listener = Socket::Listen(port);
+                if (!listener.IsValid())
+                {
+                    Log::Print::Warning("rfx worker can't listen on port %d\n", port);
+                    return false;
+                }
+
+                Log::Print::Info("rfx worker listening on port %d, %d slots\n", port, slots);
+
+                for (uint32_t index = 0;; index++)
+                {
+                    auto connection = listener.Accept();
+                    if (!connection.IsValid())
+                        continue;
+
+                    // Coordinator opens at most slots connections, they end when coordinator disconnects.
+                    const auto socket = std::make_shared<Socket>(std::move(connection));
+                    Threading::Thread(fmt::sprintf("Rfx worker %d", index), [socket, searchPaths, slots]() { serveConnection(*socket, searchPaths, slots); }).Detach();
+                }
+            }
+        }
+    }
+}
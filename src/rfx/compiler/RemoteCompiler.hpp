@@ -0,0 +1,50 @@
+#pragma once
+
+#include "compiler/Manifest.hpp"
+#include "compiler/Socket.hpp"
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // Distributed compilation over TCP. Coordinator (BatchCompiler) keeps manifest entries in one queue shared with
+        // local threads and pulls next entry for every idle worker connection, so faster nodes take more work.
+        // Cache lookups and stores stay on the coordinator, results land in its content addressed cache.
+        //
+        // Protocol, little endian, strings and blobs are prefixed with uint32 size:
+        // worker -> coordinator on connect: Magic, Version, slots (connections worker serves concurrently)
+        // coordinator -> worker per job: module, entryPoint, uint32 target, uint32 definesCount, (name, value)...
+        // worker -> coordinator per job: uint32 isCompiled, log, bytecode, reflection
+        namespace Remote
+        {
+            static constexpr uint32_t Magic = 0x4a584652; // 'RFXJ'
+            static constexpr uint32_t Version = 1;
+            static constexpr uint16_t DefaultPort = 7680;
+
+            class Connection final
+            {
+            public:
+                // Returns false when worker is unreachable or speaks other protocol version.
+                bool Open(const std::string& address);
+                bool IsOpen() const { return socket_.IsValid(); }
+
+                uint32_t GetSlots() const { return slots_; }
+
+                // Returns false when connection is lost, result is valid otherwise and isCompiled reports compile status.
+                bool Compile(const Manifest::Entry& entry,
+                             std::vector<uint8_t>& bytecode,
+                             std::vector<uint8_t>& reflection,
+                             std::string& log,
+                             bool& isCompiled);
+
+            private:
+                Socket socket_;
+                uint32_t slots_ = 0;
+            };
+
+            // Serves coordinators until listening fails, connection per thread. Sources are resolved with worker
+            // search paths, so nodes should see the same shader tree.
+            bool RunWorker(uint16_t port, const std::vector<std::string>& searchPaths, uint32_t slots);
+        }
+    }
+}
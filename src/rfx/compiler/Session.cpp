@@ -4,19 +4,59 @@
 
 #include <slang.h>
 
+#include <algorithm>
+
+#ifdef OS_WINDOWS
+#include <Windows.h>
+#endif
+
+namespace
+{
+    std::string getSessionKey(const Rfx::Compiler::CompileRequest::Description& description)
+    {
+        auto defines = description.defines;
+        std::sort(defines.begin(), defines.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+        // '\n' can't appear in names, paths or single line define values.
+        auto key = std::to_string(static_cast<uint32_t>(description.target));
+        for (const auto& define : defines)
+            key += "\nD" + define.name + "=" + define.value;
+
+        for (const auto& searchPath : description.searchPaths)
+            key += "\nI" + searchPath;
+
+        return key;
+    }
+}
+
 namespace Rfx
 {
     namespace Compiler
     {
-        Session::Session()
+        CompileRequest::SharedPtr Session::CreateCompileRequest(const CompileRequest::Description& description)
         {
-            slang::createGlobalSession(session_.writeRef());
-            ASSERT(session_);            
+            auto& sessionCache = sessionCaches_[getSessionKey(description)];
+            if (!sessionCache)
+                sessionCache = std::make_shared<SessionCache>();
+
+            return CompileRequest::SharedPtr(new CompileRequest(getGlobalSession(), sessionCache, description));
         }
 
-        CompileRequest::SharedPtr Session::CreateCompileRequest()
+        const ::Slang::ComPtr<slang::IGlobalSession>& Session::getGlobalSession()
         {
-            return CompileRequest::SharedPtr(new CompileRequest(session_));
+            if (session_)
+                return session_;
+
+#ifdef OS_WINDOWS
+            // Slang is delay loaded, missing runtime would fault on the first call otherwise.
+            if (!LoadLibraryW(L"slang.dll"))
+                LOG_FATAL("Slang runtime isn't available, shaders missing from compile cache can't be compiled");
+#endif
+
+            slang::createGlobalSession(session_.writeRef());
+            ASSERT(session_);
+
+            return session_;
         }
     }
 }
\ No newline at end of file
@@ -5,24 +5,35 @@ namespace slang
     struct IGlobalSession;
 }
 
+#include "compiler/CompileRequest.hpp"
+
 namespace Rfx
 {
     namespace Compiler
     {
-        class CompileRequest;
 
+        // Not thread safe, use one session per thread.
+        // Slang global session is created with the first compile request, so sessions are cheap to keep around.
         class Session final : public std::enable_shared_from_this<Session>
         {
         public:
             using SharedPtr = std::shared_ptr<Session>;
             using SharedConstPtr = std::shared_ptr<const Session>;
 
-            Session();
+            Session() = default;
+
+            // Requests with equal target, defines and search paths share slang session and loaded modules.
+            std::shared_ptr<CompileRequest> CreateCompileRequest(const CompileRequest::Description& description);
 
-            std::shared_ptr<CompileRequest> CreateCompileRequest();
+            // Drops pooled sessions with all loaded modules. Required to see source changes.
+            void ResetCache() { sessionCaches_.clear(); }
+
+        private:
+            const ::Slang::ComPtr<slang::IGlobalSession>& getGlobalSession();
 
         private:
             ::Slang::ComPtr<slang::IGlobalSession> session_;
+            std::unordered_map<std::string, std::shared_ptr<SessionCache>> sessionCaches_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "ShaderReloader.hpp"
+
+#include "compiler/BatchCompiler.hpp"
+#include "compiler/Dependencies.hpp"
+#include "compiler/Session.hpp"
+
+#include "include/rfx.hpp"
+
+#include "common/debug/AllocationTracker.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    std::filesystem::file_time_type getWriteTime(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        ShaderReloader::ShaderReloader(const Description& description)
+            : description_(description)
+        {
+            thread_ = RR::Common::Threading::Thread("Rfx shader reloader", [this]() { threadFunc(); });
+        }
+
+        ShaderReloader::~ShaderReloader()
+        {
+            {
+                RR::Common::Threading::UniqueLock<RR::Common::Threading::Mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wakeUp_.notify_one();
+
+            thread_.Join();
+        }
+
+        ShaderReloader::Handle ShaderReloader::Watch(const Manifest::Entry& entry, ReloadCallback callback)
+        {
+            RR::Common::Threading::UniqueLock<RR::Common::Threading::Mutex> lock(mutex_);
+
+            const auto handle = static_cast<Handle>(watches_.size());
+            watches_.push_back({ entry, std::move(callback), {}, true, nullptr });
+
+            lock.unlock();
+            wakeUp_.notify_one();
+
+            return handle;
+        }
+
+        ShaderReloader::Bytecode ShaderReloader::GetBytecode(Handle handle) const
+        {
+            RR::Common::Threading::UniqueLock<RR::Common::Threading::Mutex> lock(mutex_);
+
+            ASSERT(handle < watches_.size());
+            return watches_[handle].bytecode;
+        }
+
+        void ShaderReloader::ApplyPendingChanges()
+        {
+            std::vector<std::pair<Handle, Bytecode>> pending;
+            std::vector<ReloadCallback> callbacks;
+
+            {
+                RR::Common::Threading::UniqueLock<RR::Common::Threading::Mutex> lock(mutex_);
+                if (pending_.empty())
+                    return;
+
+                pending.swap(pending_);
+                callbacks.reserve(pending.size());
+
+                for (const auto& [handle, bytecode] : pending)
+                {
+                    watches_[handle].bytecode = bytecode;
+                    callbacks.push_back(watches_[handle].callback);
+                }
+            }
+
+            // Callbacks may call back into reloader.
+            for (size_t index = 0; index < pending.size(); index++)
+                if (callbacks[index])
+                    callbacks[index](pending[index].first, pending[index].second);
+        }
+
+        void ShaderReloader::markChangedFiles()
+        {
+            // Called under lock. Timestamps are cheap compared to reading sources.
+            std::vector<std::string> changedFiles;
+            for (auto& [path, time] : fileTimes_)
+            {
+                const auto currentTime = getWriteTime(path);
+                if (currentTime == time)
+                    continue;
+
+                time = currentTime;
+                changedFiles.push_back(path);
+            }
+
+            if (changedFiles.empty())
+                return;
+
+            for (const auto& path : changedFiles)
+                markDependents(path, static_cast<Handle>(watches_.size()));
+        }
+
+        void ShaderReloader::markDependents(const std::string& path, Handle except)
+        {
+            for (Handle handle = 0; handle < watches_.size(); handle++)
+            {
+                auto& watch = watches_[handle];
+                if (watch.dirty || handle == except)
+                    continue;
+
+                watch.dirty = std::any_of(watch.dependencies.begin(), watch.dependencies.end(),
+                                          [&path](const auto& dependency) { return dependency.lexically_normal().string() == path; });
+            }
+        }
+
+        void ShaderReloader::threadFunc()
+        {
+            ALLOCATION_TAG_SCOPE(Rfx);
+
+            // Slang global session stays alive for the reloader lifetime, so repeated compiles are cheaper.
+            Session session;
+
+            RR::Common::Threading::UniqueLock<RR::Common::Threading::Mutex> lock(mutex_);
+            while (!stop_)
+            {
+                markChangedFiles();
+
+                // Modules cached by session are stale once any source changed.
+                bool cacheReset = false;
+
+                for (Handle handle = 0; handle < watches_.size() && !stop_; handle++)
+                {
+                    if (!watches_[handle].dirty)
+                        continue;
+
+                    watches_[handle].dirty = false;
+                    const auto entry = watches_[handle].entry;
+
+                    lock.unlock();
+
+                    if (!cacheReset)
+                    {
+                        session.ResetCache();
+                        cacheReset = true;
+                    }
+
+                    // Dependencies are rescanned since the change could add or remove imports.
+                    auto dependencies = CollectDependencies(entry.module, description_.searchPaths);
+                    std::vector<std::pair<std::string, std::filesystem::file_time_type>> times;
+                    times.reserve(dependencies.size());
+                    for (const auto& dependency : dependencies)
+                        times.emplace_back(dependency.lexically_normal().string(), getWriteTime(dependency));
+
+                    std::vector<uint8_t> bytecode;
+                    std::string log;
+                    const bool compiled = BatchCompiler::CompileEntry(session, entry, description_.searchPaths, bytecode, nullptr, log);
+
+                    if (!compiled)
+                        Log::Print::Warning("Failed to reload %s:%s\n%s", entry.module, entry.entryPoint, log);
+
+                    lock.lock();
+
+                    watches_[handle].dependencies = std::move(dependencies);
+                    for (const auto& [path, time] : times)
+                    {
+                        // File changed since other shaders saw it, they won't notice it through timestamps anymore.
+                        const auto it = fileTimes_.find(path);
+                        if (it != fileTimes_.end() && it->second != time)
+                            markDependents(path, handle);
+
+                        fileTimes_[path] = time;
+                    }
+
+                    if (compiled)
+                        pending_.emplace_back(handle, std::make_shared<const std::vector<uint8_t>>(std::move(bytecode)));
+                }
+
+                wakeUp_.wait_for(lock, description_.pollInterval, [this]() {
+                    return stop_ || std::any_of(watches_.begin(), watches_.end(), [](const auto& watch) { return watch.dirty; });
+                });
+            }
+        }
+    }
+}
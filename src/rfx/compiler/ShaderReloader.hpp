@@ -0,0 +1,72 @@
+#pragma once
+
+#include "compiler/Manifest.hpp"
+
+#include "common/threading/ConditionVariable.hpp"
+#include "common/threading/Mutex.hpp"
+#include "common/threading/Thread.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <unordered_map>
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // In-process shader service. Background thread polls sources of watched shaders and recompiles
+        // only shaders whose dependency set changed. New bytecode is published on ApplyPendingChanges,
+        // so the swap happens at a point chosen by the caller (frame boundary).
+        class ShaderReloader final : private RR::Common::NonCopyable
+        {
+        public:
+            using Handle = uint32_t;
+            using Bytecode = std::shared_ptr<const std::vector<uint8_t>>;
+            using ReloadCallback = std::function<void(Handle handle, const Bytecode& bytecode)>;
+
+            struct Description final
+            {
+                std::vector<std::string> searchPaths;
+                std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250);
+            };
+
+        public:
+            ShaderReloader(const Description& description);
+            ~ShaderReloader();
+
+            // Shader is compiled asynchronously, GetBytecode returns null until first ApplyPendingChanges after that.
+            Handle Watch(const Manifest::Entry& entry, ReloadCallback callback = nullptr);
+            Bytecode GetBytecode(Handle handle) const;
+
+            // Publishes recompiled shaders and fires callbacks on calling thread. Failed recompiles keep previous bytecode.
+            void ApplyPendingChanges();
+
+        private:
+            struct WatchedShader final
+            {
+                Manifest::Entry entry;
+                ReloadCallback callback;
+                std::vector<std::filesystem::path> dependencies;
+                bool dirty = true;
+                Bytecode bytecode;
+            };
+
+            void threadFunc();
+            void markChangedFiles();
+            void markDependents(const std::string& path, Handle except);
+
+        private:
+            Description description_;
+
+            mutable RR::Common::Threading::Mutex mutex_;
+            RR::Common::Threading::ConditionVariable wakeUp_;
+            std::vector<WatchedShader> watches_;
+            std::unordered_map<std::string, std::filesystem::file_time_type> fileTimes_;
+            std::vector<std::pair<Handle, Bytecode>> pending_;
+
+            std::atomic<bool> stop_ = false;
+            RR::Common::Threading::Thread thread_;
+        };
+    }
+}
@@ -0,0 +1,195 @@
+#include "Socket.hpp"
+
+#ifdef OS_WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+namespace
+{
+#ifdef OS_WINDOWS
+    using NativeSocket = SOCKET;
+    using TransferSize = int;
+
+    void closeSocket(NativeSocket socket) { closesocket(socket); }
+
+    // Winsock is initialized once per process and stays up until exit.
+    bool initNetwork()
+    {
+        static const bool inited = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+
+        return inited;
+    }
+#else
+    using NativeSocket = int;
+    using TransferSize = size_t;
+
+    void closeSocket(NativeSocket socket) { close(socket); }
+    bool initNetwork() { return true; }
+#endif
+
+    // Single transfer is limited by int on Windows.
+    constexpr size_t MaxTransferSize = 1 << 30;
+
+    NativeSocket toNative(uintptr_t handle) { return static_cast<NativeSocket>(handle); }
+}
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        Socket& Socket::operator=(Socket&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                handle_ = other.handle_;
+                other.handle_ = InvalidHandle;
+            }
+
+            return *this;
+        }
+
+        Socket Socket::Connect(const std::string& address)
+        {
+            if (!initNetwork())
+                return {};
+
+            const auto separator = address.rfind(':');
+            if (separator == std::string::npos)
+                return {};
+
+            const auto host = address.substr(0, separator);
+            const auto port = address.substr(separator + 1);
+
+            addrinfo hints = {};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            hints.ai_protocol = IPPROTO_TCP;
+
+            addrinfo* addresses = nullptr;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+                return {};
+
+            Socket result;
+            for (auto info = addresses; info && !result.IsValid(); info = info->ai_next)
+            {
+                const auto handle = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+                if (static_cast<uintptr_t>(handle) == InvalidHandle)
+                    continue;
+
+                if (connect(handle, info->ai_addr, static_cast<int>(info->ai_addrlen)) != 0)
+                {
+                    closeSocket(handle);
+                    continue;
+                }
+
+                // Requests are small and latency bound.
+                int noDelay = 1;
+                setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+                result = Socket(static_cast<uintptr_t>(handle));
+            }
+
+            freeaddrinfo(addresses);
+            return result;
+        }
+
+        Socket Socket::Listen(uint16_t port)
+        {
+            if (!initNetwork())
+                return {};
+
+            const auto handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (static_cast<uintptr_t>(handle) == InvalidHandle)
+                return {};
+
+            Socket result(static_cast<uintptr_t>(handle));
+
+            int reuseAddress = 1;
+            setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(port);
+
+            if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, SOMAXCONN) != 0)
+                return {};
+
+            return result;
+        }
+
+        Socket Socket::Accept() const
+        {
+            ASSERT(IsValid());
+
+            const auto handle = accept(toNative(handle_), nullptr, nullptr);
+            if (static_cast<uintptr_t>(handle) == InvalidHandle)
+                return {};
+
+            int noDelay = 1;
+            setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+            return Socket(static_cast<uintptr_t>(handle));
+        }
+
+        void Socket::Close()
+        {
+            if (!IsValid())
+                return;
+
+            closeSocket(toNative(handle_));
+            handle_ = InvalidHandle;
+        }
+
+        bool Socket::Send(const void* data, size_t size) const
+        {
+            ASSERT(IsValid());
+
+            auto bytes = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                const auto chunk = static_cast<TransferSize>(std::min(size, MaxTransferSize));
+                const auto sent = send(toNative(handle_), bytes, chunk, 0);
+                if (sent <= 0)
+                    return false;
+
+                bytes += sent;
+                size -= static_cast<size_t>(sent);
+            }
+
+            return true;
+        }
+
+        bool Socket::Receive(void* data, size_t size) const
+        {
+            ASSERT(IsValid());
+
+            auto bytes = static_cast<char*>(data);
+            while (size > 0)
+            {
+                const auto chunk = static_cast<TransferSize>(std::min(size, MaxTransferSize));
+                const auto received = recv(toNative(handle_), bytes, chunk, 0);
+                if (received <= 0)
+                    return false;
+
+                bytes += received;
+                size -= static_cast<size_t>(received);
+            }
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+namespace Rfx
+{
+    namespace Compiler
+    {
+        // Blocking TCP socket for distributed compilation, owns the handle.
+        class Socket final : private NonCopyable
+        {
+        public:
+            Socket() = default;
+            Socket(Socket&& other) noexcept : handle_(other.handle_) { other.handle_ = InvalidHandle; }
+            ~Socket() { Close(); }
+
+            Socket& operator=(Socket&& other) noexcept;
+
+            // Address is "host:port". Returns invalid socket on failure.
+            static Socket Connect(const std::string& address);
+            // Listens on all interfaces. Returns invalid socket on failure.
+            static Socket Listen(uint16_t port);
+
+            // Blocks until connection arrives, invalid socket on failure.
+            Socket Accept() const;
+
+            bool IsValid() const { return handle_ != InvalidHandle; }
+            void Close();
+
+            // Send and receive transfer the whole range, false when connection is lost.
+            bool Send(const void* data, size_t size) const;
+            bool Receive(void* data, size_t size) const;
+
+        private:
+            // SOCKET is pointer sized on Windows.
+            static constexpr uintptr_t InvalidHandle = ~uintptr_t(0);
+
+            explicit Socket(uintptr_t handle) : handle_(handle) { }
+
+        private:
+            uintptr_t handle_ = InvalidHandle;
+        };
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 namespace Rfx
 {
     enum class CompileTarget : uint32_t
@@ -9,4 +11,316 @@ namespace Rfx
 
         Count
     };
-}
\ No newline at end of file
+
+    // Binary reflection emitted by rfx next to shader bytecode.
+    // Blob is position independent: plain structs and offsets from the blob start, all 4 byte aligned,
+    // so it can be used straight from a memory mapped file.
+    namespace Reflection
+    {
+        static constexpr uint32_t Magic = 0x52584652; // 'RFXR'
+        static constexpr uint32_t Version = 1;
+
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        constexpr uint32_t HashName(const char* name)
+        {
+            // FNV-1a
+            uint32_t hash = 0x811c9dc5;
+            for (; *name; name++)
+            {
+                hash ^= static_cast<uint8_t>(*name);
+                hash *= 0x01000193;
+            }
+            return hash;
+        }
+
+        enum class ResourceType : uint32_t
+        {
+            ConstantBuffer,
+            Texture,
+            RWTexture,
+            Buffer,
+            RWBuffer,
+            Sampler,
+        };
+
+        enum class RootParameterType : uint32_t
+        {
+            // CBV/SRV/UAV ranges.
+            ResourceTable,
+            SamplerTable,
+        };
+
+        struct Header final
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t size;
+
+            uint32_t resourcesOffset;
+            uint32_t resourcesCount;
+            uint32_t constantBuffersOffset;
+            uint32_t constantBuffersCount;
+            uint32_t variablesOffset;
+            uint32_t variablesCount;
+            uint32_t rootParametersOffset;
+            uint32_t rootParametersCount;
+            uint32_t stringsOffset;
+            uint32_t stringsSize;
+        };
+
+        struct Resource final
+        {
+            uint32_t nameHash;
+            uint32_t nameOffset;
+            ResourceType type;
+            uint32_t space;
+            uint32_t binding;
+            // Array size, 0 for unbounded arrays.
+            uint32_t count;
+            // Index into constant buffers for ResourceType::ConstantBuffer, InvalidIndex otherwise.
+            uint32_t constantBufferIndex;
+        };
+
+        struct ConstantBuffer final
+        {
+            uint32_t nameHash;
+            uint32_t size;
+            uint32_t firstVariable;
+            uint32_t variablesCount;
+        };
+
+        struct Variable final
+        {
+            uint32_t nameHash;
+            uint32_t nameOffset;
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        // One descriptor table per register space and heap type. Table resources are contiguous and sorted by binding.
+        struct RootParameter final
+        {
+            RootParameterType type;
+            uint32_t space;
+            uint32_t firstResource;
+            uint32_t resourcesCount;
+        };
+
+        // Read only accessor over reflection blob.
+        class View final
+        {
+        public:
+            View() = default;
+            View(const void* data, size_t size) : data_(static_cast<const uint8_t*>(data))
+            {
+                if (size < sizeof(Header) || header().magic != Magic || header().version != Version || header().size > size)
+                    data_ = nullptr;
+            }
+
+            bool IsValid() const { return data_ != nullptr; }
+
+            uint32_t GetResourcesCount() const { return header().resourcesCount; }
+            const Resource& GetResource(uint32_t index) const { return get<Resource>(header().resourcesOffset, index); }
+
+            uint32_t GetConstantBuffersCount() const { return header().constantBuffersCount; }
+            const ConstantBuffer& GetConstantBuffer(uint32_t index) const { return get<ConstantBuffer>(header().constantBuffersOffset, index); }
+
+            uint32_t GetVariablesCount() const { return header().variablesCount; }
+            const Variable& GetVariable(uint32_t index) const { return get<Variable>(header().variablesOffset, index); }
+
+            uint32_t GetRootParametersCount() const { return header().rootParametersCount; }
+            const RootParameter& GetRootParameter(uint32_t index) const { return get<RootParameter>(header().rootParametersOffset, index); }
+
+            const char* GetString(uint32_t offset) const { return reinterpret_cast<const char*>(data_ + header().stringsOffset + offset); }
+
+            // Returns InvalidIndex when not found.
+            uint32_t FindResource(uint32_t nameHash) const
+            {
+                for (uint32_t index = 0; index < GetResourcesCount(); index++)
+                    if (GetResource(index).nameHash == nameHash)
+                        return index;
+
+                return InvalidIndex;
+            }
+
+        private:
+            const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+
+            template <typename T>
+            const T& get(uint32_t offset, uint32_t index) const { return reinterpret_cast<const T*>(data_ + offset)[index]; }
+
+        private:
+            const uint8_t* data_ = nullptr;
+        };
+    }
+
+    // Permutation index emitted by rfx as <module>_<entryPoint>.perm next to bytecode of permutations declared
+    // in manifest. Bit N of permutation mask enables keyword N, bytecode of permutation is written as
+    // <module>_<entryPoint>_P<mask in hex>.bin. Same blob conventions as reflection.
+    namespace Permutations
+    {
+        static constexpr uint32_t Magic = 0x50584652; // 'RFXP'
+        static constexpr uint32_t Version = 1;
+
+        static constexpr uint32_t MaxKeywords = 16;
+
+        struct Header final
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t size;
+
+            uint32_t keywordsOffset;
+            uint32_t keywordsCount;
+            // Sorted masks of compiled permutations.
+            uint32_t masksOffset;
+            uint32_t masksCount;
+            uint32_t stringsOffset;
+            uint32_t stringsSize;
+        };
+
+        // Keyword index is its bit in permutation mask.
+        struct Keyword final
+        {
+            uint32_t nameHash;
+            uint32_t nameOffset;
+        };
+
+        // Read only accessor over permutation index blob.
+        class View final
+        {
+        public:
+            View() = default;
+            View(const void* data, size_t size) : data_(static_cast<const uint8_t*>(data))
+            {
+                if (size < sizeof(Header) || header().magic != Magic || header().version != Version || header().size > size)
+                    data_ = nullptr;
+            }
+
+            bool IsValid() const { return data_ != nullptr; }
+
+            uint32_t GetKeywordsCount() const { return header().keywordsCount; }
+            const Keyword& GetKeyword(uint32_t index) const { return get<Keyword>(header().keywordsOffset, index); }
+
+            uint32_t GetMasksCount() const { return header().masksCount; }
+            uint32_t GetMask(uint32_t index) const { return get<uint32_t>(header().masksOffset, index); }
+
+            const char* GetString(uint32_t offset) const { return reinterpret_cast<const char*>(data_ + header().stringsOffset + offset); }
+
+            // Returns zero for keywords shader doesn't declare, so they don't select anything.
+            uint32_t GetKeywordMask(uint32_t nameHash) const
+            {
+                for (uint32_t index = 0; index < GetKeywordsCount(); index++)
+                    if (GetKeyword(index).nameHash == nameHash)
+                        return 1u << index;
+
+                return 0;
+            }
+
+            // False for masks rfx didn't generate: disallowed combinations or ones no material uses.
+            bool HasPermutation(uint32_t mask) const
+            {
+                const auto masks = &get<uint32_t>(header().masksOffset, 0);
+                return std::binary_search(masks, masks + GetMasksCount(), mask);
+            }
+
+        private:
+            const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+
+            template <typename T>
+            const T& get(uint32_t offset, uint32_t index) const { return reinterpret_cast<const T*>(data_ + offset)[index]; }
+
+        private:
+            const uint8_t* data_ = nullptr;
+        };
+    }
+
+    // Shader pack emitted by rfx --pack: all compiled shaders of a manifest in one file meant to be memory mapped.
+    // Bytecode and reflection blobs are deduplicated by content, entries are sorted by key for binary search,
+    // so lookups touch only the pages they read and nothing is parsed on load.
+    namespace Pack
+    {
+        static constexpr uint32_t Magic = 0x4b584652; // 'RFXK'
+        static constexpr uint32_t Version = 1;
+
+        // Blobs start at multiples of it, which satisfies DXIL container and reflection alignment.
+        static constexpr uint32_t BlobAlignment = 16;
+
+        // Name is what rfx would use as output file name without extension. Permutations are named
+        // <module>_<entryPoint> and keyed by their mask, other shaders use zero mask.
+        constexpr uint64_t GetKey(const char* name, uint32_t permutationMask = 0)
+        {
+            return (static_cast<uint64_t>(Reflection::HashName(name)) << 32) | permutationMask;
+        }
+
+        struct Header final
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t size;
+
+            uint32_t entriesOffset;
+            uint32_t entriesCount;
+            uint32_t blobsOffset;
+            uint32_t blobsCount;
+            uint32_t reserved;
+        };
+
+        // Sorted by key.
+        struct Entry final
+        {
+            uint64_t key;
+            uint32_t bytecodeBlob;
+            uint32_t reflectionBlob;
+        };
+
+        // Offset from pack start.
+        struct Blob final
+        {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        // Read only accessor over mapped pack.
+        class View final
+        {
+        public:
+            View() = default;
+            View(const void* data, size_t size) : data_(static_cast<const uint8_t*>(data))
+            {
+                if (size < sizeof(Header) || header().magic != Magic || header().version != Version || header().size > size)
+                    data_ = nullptr;
+            }
+
+            bool IsValid() const { return data_ != nullptr; }
+
+            uint32_t GetEntriesCount() const { return header().entriesCount; }
+            const Entry& GetEntry(uint32_t index) const { return get<Entry>(header().entriesOffset, index); }
+
+            // Returns nullptr when not found.
+            const Entry* FindEntry(uint64_t key) const
+            {
+                const auto entries = &get<Entry>(header().entriesOffset, 0);
+                const auto end = entries + GetEntriesCount();
+                const auto it = std::lower_bound(entries, end, key, [](const Entry& entry, uint64_t key) { return entry.key < key; });
+
+                return (it != end && it->key == key) ? it : nullptr;
+            }
+
+            const void* GetBlobData(uint32_t index) const { return data_ + get<Blob>(header().blobsOffset, index).offset; }
+            uint32_t GetBlobSize(uint32_t index) const { return get<Blob>(header().blobsOffset, index).size; }
+
+            Reflection::View GetReflection(const Entry& entry) const { return Reflection::View(GetBlobData(entry.reflectionBlob), GetBlobSize(entry.reflectionBlob)); }
+
+        private:
+            const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+
+            template <typename T>
+            const T& get(uint32_t offset, uint32_t index) const { return reinterpret_cast<const T*>(data_ + offset)[index]; }
+
+        private:
+            const uint8_t* data_ = nullptr;
+        };
+    }
+}
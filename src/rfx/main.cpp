@@ -1,6 +1,126 @@
-#include "compiler/CompileRequest.hpp"
-#include "compiler/Program.hpp"
-#include "compiler/Session.hpp"
+#include "compiler/BatchCompiler.hpp"
+#include "compiler/Manifest.hpp"
+#include "compiler/RemoteCompiler.hpp"
+
+#include "include/rfx.hpp"
+
+#include <thread>
+
+namespace
+{
+    // rfx --worker <port> [--include <directory>]... [--threads <count>]
+    int runWorker(int argc, char** argv)
+    {
+        const auto port = argc >= 3 ? static_cast<uint16_t>(std::stoul(argv[2])) : Rfx::Compiler::Remote::DefaultPort;
+
+        std::vector<std::string> searchPaths;
+        uint32_t slots = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (int index = 3; index < argc; index++)
+        {
+            const std::string option = argv[index];
+            if (index + 1 >= argc)
+            {
+                Log::Print::Warning("Missing value for option %s\n", option);
+                return -1;
+            }
+
+            const std::string value = argv[++index];
+            if (option == "--include")
+                searchPaths.push_back(value);
+            else if (option == "--threads")
+                slots = std::max(static_cast<uint32_t>(std::stoul(value)), 1u);
+            else
+            {
+                Log::Print::Warning("Unknown option %s\n", option);
+                return -1;
+            }
+        }
+
+        return Rfx::Compiler::Remote::RunWorker(port, searchPaths, slots) ? 0 : -1;
+    }
+
+    // rfx <manifest> <outputDirectory> [--cache <directory>] [--include <directory>]... [--threads <count>] [--usage <file>]
+    //     [--workers <host:port>[,<host:port>...]] [--pack <file>]
+    int run(int argc, char** argv)
+    {
+        if (argc >= 2 && std::string(argv[1]) == "--worker")
+            return runWorker(argc, argv);
+
+        if (argc < 3)
+        {
+            Log::Print::Warning("Usage: rfx <manifest> <outputDirectory> [--cache <directory>] [--include <directory>]... [--threads <count>] [--usage <file>] [--workers <host:port>[,<host:port>...]] [--pack <file>]\n"
+                                "       rfx --worker <port> [--include <directory>]... [--threads <count>]\n");
+            return -1;
+        }
+
+        Rfx::Compiler::BatchCompiler::Description description;
+        description.outputDirectory = argv[2];
+
+        // Permutation usage collected from materials, all allowed permutations are compiled without it.
+        std::string usagePath;
+
+        for (int index = 3; index < argc; index++)
+        {
+            const std::string option = argv[index];
+            if (index + 1 >= argc)
+            {
+                Log::Print::Warning("Missing value for option %s\n", option);
+                return -1;
+            }
+
+            const std::string value = argv[++index];
+            if (option == "--cache")
+                description.cacheDirectory = value;
+            else if (option == "--include")
+                description.searchPaths.push_back(value);
+            else if (option == "--usage")
+                usagePath = value;
+            else if (option == "--pack")
+                description.packPath = value;
+            else if (option == "--workers")
+            {
+                for (size_t begin = 0; begin < value.size();)
+                {
+                    const auto end = std::min(value.find(',', begin), value.size());
+                    if (end > begin)
+                        description.workers.push_back(value.substr(begin, end - begin));
+                    begin = end + 1;
+                }
+            }
+            else if (option == "--threads")
+                description.threadsCount = static_cast<uint32_t>(std::stoul(value));
+            else
+            {
+                Log::Print::Warning("Unknown option %s\n", option);
+                return -1;
+            }
+        }
+
+        std::string log;
+        Rfx::Compiler::Manifest manifest;
+        if (!Rfx::Compiler::Manifest::Load(argv[1], manifest, log))
+        {
+            Log::Print::Warning(log);
+            return -1;
+        }
+
+        if (!usagePath.empty() && !Rfx::Compiler::Manifest::LoadUsage(usagePath, manifest, log))
+        {
+            Log::Print::Warning(log);
+            return -1;
+        }
+
+        manifest.ExpandPermutations();
+
+        Rfx::Compiler::BatchCompiler compiler(description);
+        const auto statistics = compiler.Compile(manifest);
+
+        Log::Print::Info("rfx: %d compiled, %d up to date, %d failed\n", statistics.compiled, statistics.cached, statistics.failed);
+
+        return statistics.failed == 0 ? 0 : -1;
+    }
+}
 
 #ifdef OS_WINDOWS
 #include <Windows.h>
@@ -11,73 +131,11 @@ INT WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine, INT nC
     (void)lpCmdLine;
     (void)nCmdShow;
 
+    return run(__argc, __argv);
+}
 #else
 int main(int argc, char** argv)
 {
-    (void)argc;
-    (void)argv;
+    return run(argc, argv);
+}
 #endif
-
-    auto session = new Rfx::Compiler::Session();
-
-    auto request = session->CreateCompileRequest();
-
-    std::string log;
-
-    const auto loaded = request->LoadModule("test", log);
-    if (!loaded)
-    {
-        Log::Print::Warning(log);
-        return -1;
-    }
-
-    const auto entryPoint = request->AddEntryPoint();
-    if (!entryPoint)
-    {
-        //Log::Print::Warning(log);
-        return -1;
-    }
-
-    const auto program = request->Compile(log);
-
-    if (!program)
-    {
-        Log::Print::Warning(log);
-        return -1;
-    }
-
-    auto shaderProgram = program->GetShaderProgram(log);
-    if (!shaderProgram)
-    {
-        Log::Print::Warning(log);
-        return -1;
-    }
-
-    /*
-    SlangSession* session = spCreateSession(NULL);
-
-    SlangCompileRequest* request = spCreateCompileRequest(session);
-    spSetCodeGenTarget(request, SLANG_SPIRV);
-
-    int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_HLSL, "");
-    spAddTranslationUnitSourceFile(request, translationUnitIndex, "some/file.hlsl");
-    SlangProfileID profileID = spFindProfile(session, "ps_5_0");
-    int entryPointIndex = spAddEntryPoint(
-        request,
-        translationUnitIndex,
-        "main",
-        profileID);
-
-    int anyErrors = spCompile(request);
-
-    if (anyErrors != 0)
-    {
-        char const* diagnostics = spGetDiagnosticOutput(request);
-        Log::Print::Warning(diagnostics);
-    }
-
-    spDestroyCompileRequest(request);
-    spDestroySession(session);*/
-
-    return 0;
-}
\ No newline at end of file
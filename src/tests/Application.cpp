@@ -4,6 +4,8 @@
 #include "render/DeviceContext.hpp"
 #include "windowing/WindowSystem.hpp"
 
+#include "common/threading/JobSystem.hpp"
+
 #define CATCH_CONFIG_RUNNER
 #include <catch2/catch.hpp>
 
@@ -11,6 +13,10 @@
 #include "ApprovalTests/ApprovalTests.hpp"
 
 #include "ApprovalIntegration/ImageComparator.hpp"
+#include "ApprovalIntegration/ImageHash.hpp"
+
+#include <cstdlib>
+#include <cstring>
 
 namespace RR
 {
@@ -18,6 +24,10 @@ namespace RR
     {
         int Application::Run(int argc, char** argv)
         {
+            Shard shard;
+            if (!parseShard(argc, argv, shard))
+                return -1;
+
             if (!init())
                 return -1;
 
@@ -27,6 +37,9 @@ namespace RR
                 auto ktxComparatorDisposer =
                     ApprovalTests::FileApprover::registerComparatorForExtension(
                         ".dds", std::make_shared<ImageComparator>());
+                auto hashComparatorDisposer =
+                    ApprovalTests::FileApprover::registerComparatorForExtension(
+                        ".xxh64", std::make_shared<ImageHashComparator>());
 
                 // We want to force the linker not to discard the global variable
                 // and its constructor, as it (optionally) registers leak detector
@@ -44,8 +57,11 @@ namespace RR
                    // config.testsOrTags.push_back("[ComputeCommandList]");
                     session.useConfigData(config);
                 }
+                else
+                    result = session.applyCommandLine(argc, argv);
 
-                result = session.run(argc, argv);
+                if (result == 0 && applyShard(session, shard))
+                    result = session.run();
             }
 
             terminate();
@@ -53,6 +69,62 @@ namespace RR
             return result;
         }
 
+        bool Application::parseShard(int& argc, char** argv, Shard& shard) const
+        {
+            int kept = 0;
+            for (int index = 0; index < argc; index++)
+            {
+                const bool isIndex = strcmp(argv[index], "--shard-index") == 0;
+                const bool isCount = strcmp(argv[index], "--shard-count") == 0;
+
+                if (!isIndex && !isCount)
+                {
+                    argv[kept++] = argv[index];
+                    continue;
+                }
+
+                if (++index == argc)
+                {
+                    Log::Format::Error("Missing value of {}\n", argv[index - 1]);
+                    return false;
+                }
+
+                (isIndex ? shard.index : shard.count) = static_cast<uint32_t>(std::strtoul(argv[index], nullptr, 10));
+            }
+
+            argc = kept;
+
+            if (shard.count == 0 || shard.index >= shard.count)
+            {
+                Log::Format::Error("Invalid shard {} of {}\n", shard.index, shard.count);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool Application::applyShard(Catch::Session& session, const Shard& shard) const
+        {
+            if (shard.count == 1)
+                return true;
+
+            const auto& config = session.config();
+            const auto& testCases = Catch::filterTests(Catch::getAllTestCasesSorted(config), config.testSpec(), config);
+
+            auto configData = session.configData();
+            configData.testsOrTags.clear();
+
+            for (size_t index = shard.index; index < testCases.size(); index += shard.count)
+                configData.testsOrTags.push_back("\"" + testCases[index].name + "\"");
+
+            // Empty filter would run everything.
+            if (configData.testsOrTags.empty())
+                return false;
+
+            session.useConfigData(configData);
+            return true;
+        }
+
         bool Application::init()
         {
             Windowing::Window::Description description;
@@ -67,8 +139,11 @@ namespace RR
                 return false;
             }*/
 
-            auto& renderContext = Render::DeviceContext::Instance();
-            renderContext.Init();
+            // Image comparison is parallelized over subresources.
+            Common::Threading::JobSystem::Instance().Init();
+
+            deviceContext_ = std::make_unique<Render::DeviceContext>();
+            deviceContext_->Init();
             /*
             TODO 
             
@@ -79,21 +154,15 @@ namespace RR
             }
             */
 
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Copy)] = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "Copy");
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Compute)] = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Compute, "Compute");
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Graphics)] = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Graphics, "Primary");
-
             return true;
         }
 
         void Application::terminate()
         {
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Copy)] = nullptr;
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Compute)] = nullptr;
-            commandQueue_[static_cast<size_t>(GAPI::CommandQueueType::Graphics)] = nullptr;
+            deviceContext_->Terminate();
+            deviceContext_ = nullptr;
 
-            auto& renderContext = Render::DeviceContext::Instance();
-            renderContext.Terminate();
+            Common::Threading::JobSystem::Instance().Terminate();
         }
     }
 }
\ No newline at end of file
@@ -1,10 +1,16 @@
 #pragma once
 
-#include "gapi/CommandQueue.hpp"
-#include "gapi/ForwardDeclarations.hpp"
+#include "render/DeviceContext.hpp"
 
 #include "common/Singleton.hpp"
 
+#include <memory>
+
+namespace Catch
+{
+    class Session;
+}
+
 namespace RR
 {
     namespace WindowSystem
@@ -14,24 +20,37 @@ namespace RR
 
     namespace Tests
     {
+        // Device is created once per process and shared by all tests.
+        // Test cases could be split between parallel processes with --shard-index and --shard-count, each process gets own device.
         class Application : public Singleton<Application>
         {
         public:
             int Run(int argc, char** argv);
 
-            std::shared_ptr<GAPI::CommandQueue> GetGraphicsCommandQueue(GAPI::CommandQueueType type)
+            Render::DeviceContext& GetDeviceContext() const
             {
-                ASSERT(type != GAPI::CommandQueueType::Count);
-                return commandQueue_[static_cast<size_t>(type)];
+                ASSERT(deviceContext_);
+                return *deviceContext_;
             }
 
         private:
+            struct Shard
+            {
+                uint32_t index = 0;
+                uint32_t count = 1;
+            };
+
             bool init();
             void terminate();
 
+            // Strips shard arguments, Catch doesn't know them.
+            bool parseShard(int& argc, char** argv, Shard& shard) const;
+            // Leaves every count-th of matching test cases, declaration order is the same in every process.
+            bool applyShard(Catch::Session& session, const Shard& shard) const;
+
         private:
             std::shared_ptr<WindowSystem::InputtingWindow> window_;
-            std::array<std::shared_ptr<GAPI::CommandQueue>, static_cast<size_t>(GAPI::CommandQueueType::Count)> commandQueue_;
+            std::unique_ptr<Render::DeviceContext> deviceContext_;
         };
     }
 }
\ No newline at end of file
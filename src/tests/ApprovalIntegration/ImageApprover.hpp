@@ -2,6 +2,7 @@
 
 #include "gapi/Texture.hpp"
 
+#include "ApprovalIntegration/ImageHash.hpp"
 #include "ApprovalIntegration/ImageWriter.hpp"
 
 #include "ApprovalTests/ApprovalTests.hpp"
@@ -11,12 +12,28 @@ namespace RR
 {
     namespace Tests
     {
+        enum class ApprovalMode
+        {
+            // Content hash is approved, full DDS is written and compared on mismatch only.
+            Hash,
+            // Full DDS is approved and compared every run.
+            Image
+        };
+
         class ImageApprover
         {
         public:
             static void verify(const GAPI::CpuResourceData::SharedPtr& resource,
-                               const ApprovalTests::Options& options = ApprovalTests::Options())
+                               const ApprovalTests::Options& options = ApprovalTests::Options(),
+                               ApprovalMode mode = ApprovalMode::Hash)
             {
+                if (mode == ApprovalMode::Hash)
+                {
+                    ImageHashWriter hash_writer(resource);
+                    ApprovalTests::Approvals::verify(hash_writer, options);
+                    return;
+                }
+
                 ImageWriter image_writer(resource);
                 ApprovalTests::Approvals::verify(image_writer, options);
             }
@@ -5,15 +5,37 @@
 #include "ApprovalTests/ApprovalTests.hpp"
 #include <catch2/catch.hpp>
 
+#include <optional>
+
 namespace RR
 {
     namespace Tests
     {
+        // Channel passes if it is within absolute or ulps tolerance. Once minPsnr is set, channels
+        // outside of them are accepted as long as PSNR of the whole image stays above it.
+        struct ImageTolerance
+        {
+            // Normalized units for UNorm formats.
+            float absolute = 0.0f;
+            // Units in the last place, one step of 8 bit UNorm is 1/255.
+            uint32_t ulps = 0;
+            // Decibels, zero disables PSNR check.
+            double minPsnr = 0.0;
+
+            static ImageTolerance ForFormat(uint32_t dxgiFormat);
+        };
+
         class ImageComparator : public ApprovalTests::ApprovalComparator
         {
         public:
+            // Tolerance is picked per format of approved image if not set.
+            ImageComparator(const std::optional<ImageTolerance>& tolerance = std::nullopt) : tolerance_(tolerance) { }
+
             bool contentsAreEquivalent(std::string receivedPath,
                                        std::string approvedPath) const override;
+
+        private:
+            std::optional<ImageTolerance> tolerance_;
         };
     }
-}
\ No newline at end of file
+}
@@ -1,11 +1,160 @@
 #include "ImageComparator.hpp"
 
+#include "common/Simd.hpp"
+#include "common/threading/Parallel.hpp"
+
 #include "DirectXTex.h"
+#include <DirectXPackedVector.h>
+
+#include <atomic>
+#include <cmath>
 
 namespace RR
 {
     namespace Tests
     {
+        namespace
+        {
+            enum class ChannelType
+            {
+                // Compared bitwise, tolerance is ignored.
+                Raw,
+                UNorm8,
+                Float16,
+                Float32
+            };
+
+            struct Difference
+            {
+                bool failed = false;
+                double squaredError = 0.0;
+                uint64_t channelsCount = 0;
+            };
+
+            ChannelType getChannelType(DXGI_FORMAT format)
+            {
+                if (DirectX::IsCompressed(format) || DirectX::IsPacked(format))
+                    return ChannelType::Raw;
+
+                const auto bitsPerColor = DirectX::BitsPerColor(format);
+                switch (DirectX::FormatDataType(format))
+                {
+                    case DirectX::FORMAT_TYPE_UNORM: return bitsPerColor == 8 ? ChannelType::UNorm8 : ChannelType::Raw;
+                    case DirectX::FORMAT_TYPE_FLOAT:
+                        return bitsPerColor == 32 ? ChannelType::Float32 : bitsPerColor == 16 ? ChannelType::Float16
+                                                                                              : ChannelType::Raw;
+                    default: return ChannelType::Raw;
+                }
+            }
+
+            // Maps sign-magnitude float bits to monotonic integers, so ulp distance is plain difference.
+            inline int64_t toOrderedBits(uint32_t bits, uint32_t signBit)
+            {
+                return (bits & signBit) ? -static_cast<int64_t>(bits & (signBit - 1)) : static_cast<int64_t>(bits);
+            }
+
+            struct ChannelComparator
+            {
+                const ImageTolerance& tolerance;
+
+                // Returns false if channel is out of tolerance.
+                bool compare(float received, float approved, uint32_t ulpDistance, Difference& difference) const
+                {
+                    const auto error = std::abs(received - approved);
+                    difference.squaredError += std::isfinite(error) ? static_cast<double>(error) * error : 1.0;
+
+                    return error <= tolerance.absolute || ulpDistance <= tolerance.ulps;
+                }
+            };
+
+            void compareRowUNorm8(const uint8_t* received, const uint8_t* approved, size_t count, const ChannelComparator& comparator, Difference& difference)
+            {
+                for (size_t index = 0; index < count; index++)
+                    if (received[index] != approved[index] &&
+                        !comparator.compare(received[index] / 255.0f, approved[index] / 255.0f, static_cast<uint32_t>(std::abs(received[index] - approved[index])), difference))
+                        difference.failed = true;
+            }
+
+            void compareRowFloat16(const uint16_t* received, const uint16_t* approved, size_t count, const ChannelComparator& comparator, Difference& difference)
+            {
+                for (size_t index = 0; index < count; index++)
+                {
+                    if (received[index] == approved[index])
+                        continue;
+
+                    const auto ulpDistance = std::abs(toOrderedBits(received[index], 0x8000) - toOrderedBits(approved[index], 0x8000));
+                    if (!comparator.compare(DirectX::PackedVector::XMConvertHalfToFloat(received[index]),
+                                            DirectX::PackedVector::XMConvertHalfToFloat(approved[index]),
+                                            static_cast<uint32_t>(ulpDistance), difference))
+                        difference.failed = true;
+                }
+            }
+
+            void compareFloat32(const float* received, const float* approved, size_t first, size_t last, const ChannelComparator& comparator, Difference& difference)
+            {
+                for (size_t index = first; index < last; index++)
+                {
+                    uint32_t receivedBits, approvedBits;
+                    memcpy(&receivedBits, received + index, sizeof(uint32_t));
+                    memcpy(&approvedBits, approved + index, sizeof(uint32_t));
+
+                    if (receivedBits == approvedBits)
+                        continue;
+
+                    const auto ulpDistance = std::min<int64_t>(std::abs(toOrderedBits(receivedBits, 0x80000000) - toOrderedBits(approvedBits, 0x80000000)),
+                                                               std::numeric_limits<uint32_t>::max());
+                    if (!comparator.compare(received[index], approved[index], static_cast<uint32_t>(ulpDistance), difference))
+                        difference.failed = true;
+                }
+            }
+
+            void compareRowFloat32(const float* received, const float* approved, size_t count, const ChannelComparator& comparator, Difference& difference)
+            {
+                const auto absoluteTolerance = Common::Simd::Splat(comparator.tolerance.absolute);
+
+                size_t index = 0;
+                for (; index + 4 <= count; index += 4)
+                {
+                    const auto error = Common::Simd::Abs(Common::Simd::Sub(Common::Simd::Load(received + index), Common::Simd::Load(approved + index)));
+
+                    // NaNs and lanes outside of absolute tolerance fall back to ulp comparison.
+                    if (!Common::Simd::AllLessEqual(error, absoluteTolerance))
+                    {
+                        compareFloat32(received, approved, index, index + 4, comparator, difference);
+                        continue;
+                    }
+
+                    alignas(16) float errors[4];
+                    Common::Simd::StoreAligned(errors, Common::Simd::Mul(error, error));
+                    difference.squaredError += static_cast<double>(errors[0]) + errors[1] + errors[2] + errors[3];
+                }
+
+                compareFloat32(received, approved, index, count, comparator, difference);
+            }
+
+            bool isSameLayout(const DirectX::TexMetadata& lhs, const DirectX::TexMetadata& rhs)
+            {
+                return lhs.width == rhs.width && lhs.height == rhs.height && lhs.depth == rhs.depth &&
+                       lhs.arraySize == rhs.arraySize && lhs.mipLevels == rhs.mipLevels &&
+                       lhs.format == rhs.format && lhs.dimension == rhs.dimension;
+            }
+        }
+
+        ImageTolerance ImageTolerance::ForFormat(uint32_t dxgiFormat)
+        {
+            ImageTolerance tolerance;
+
+            switch (getChannelType(static_cast<DXGI_FORMAT>(dxgiFormat)))
+            {
+                case ChannelType::UNorm8: tolerance.ulps = 1; break;
+                case ChannelType::Float16: tolerance.ulps = 1; break;
+                case ChannelType::Float32: tolerance.ulps = 4; break;
+                default: break;
+            }
+
+            return tolerance;
+        }
+
         bool ImageComparator::contentsAreEquivalent(std::string receivedPath, std::string approvedPath) const
         {
             HRESULT result;
@@ -20,10 +169,86 @@ namespace RR
             result = DirectX::LoadFromDDSFile(StringConversions::UTF8ToWString(approvedPath).c_str(), DirectX::DDS_FLAGS::DDS_FLAGS_NONE, &approvedMetadata, approvedImage);
             ASSERT(SUCCEEDED(result));
 
-            bool equal = (approvedImage.GetPixelsSize() == receivedImage.GetPixelsSize());
-            equal &= memcmp(approvedImage.GetPixels(), receivedImage.GetPixels(), approvedImage.GetPixelsSize()) == 0;
+            if (!isSameLayout(receivedMetadata, approvedMetadata) || receivedImage.GetImageCount() != approvedImage.GetImageCount())
+                return false;
+
+            const auto format = approvedMetadata.format;
+            const auto channelType = getChannelType(format);
+            const auto tolerance = tolerance_.value_or(ImageTolerance::ForFormat(format));
+            const ChannelComparator comparator { tolerance };
+
+            // Failed image stops the rest, unless PSNR has to be computed over the whole image.
+            std::atomic<bool> cancelled { false };
+            const bool earlyOut = tolerance.minPsnr <= 0.0 || channelType == ChannelType::Raw;
+
+            // Images are subresources and depth slices, each is compared by one job.
+            const auto difference = Common::Threading::ParallelReduce(
+                0, approvedImage.GetImageCount(), 1, Difference {},
+                [&](size_t first, size_t last) {
+                    Difference batch;
+
+                    for (size_t index = first; index < last && !cancelled.load(std::memory_order_relaxed); index++)
+                    {
+                        const auto& received = receivedImage.GetImages()[index];
+                        const auto& approved = approvedImage.GetImages()[index];
+
+                        size_t rowPitch, slicePitch;
+                        DirectX::ComputePitch(format, approved.width, approved.height, rowPitch, slicePitch);
+                        const auto rowsCount = DirectX::ComputeScanlines(format, approved.height);
+
+                        const auto bitsPerColor = channelType == ChannelType::Raw ? 8 : DirectX::BitsPerColor(format);
+                        const auto channelsCount = rowPitch * 8 / bitsPerColor;
+
+                        for (size_t row = 0; row < rowsCount; row++)
+                        {
+                            const auto* receivedRow = received.pixels + row * received.rowPitch;
+                            const auto* approvedRow = approved.pixels + row * approved.rowPitch;
+
+                            batch.channelsCount += channelsCount;
+
+                            if (memcmp(receivedRow, approvedRow, rowPitch) == 0)
+                                continue;
+
+                            switch (channelType)
+                            {
+                                case ChannelType::UNorm8: compareRowUNorm8(receivedRow, approvedRow, channelsCount, comparator, batch); break;
+                                case ChannelType::Float16:
+                                    compareRowFloat16(reinterpret_cast<const uint16_t*>(receivedRow), reinterpret_cast<const uint16_t*>(approvedRow), channelsCount, comparator, batch);
+                                    break;
+                                case ChannelType::Float32:
+                                    compareRowFloat32(reinterpret_cast<const float*>(receivedRow), reinterpret_cast<const float*>(approvedRow), channelsCount, comparator, batch);
+                                    break;
+                                default: batch.failed = true; break;
+                            }
+
+                            if (batch.failed && earlyOut)
+                            {
+                                cancelled = true;
+                                return batch;
+                            }
+                        }
+                    }
+
+                    return batch;
+                },
+                [](Difference&& accumulated, Difference&& batch) {
+                    accumulated.failed |= batch.failed;
+                    accumulated.squaredError += batch.squaredError;
+                    accumulated.channelsCount += batch.channelsCount;
+                    return accumulated;
+                });
+
+            if (!difference.failed)
+                return true;
+
+            if (earlyOut || difference.channelsCount == 0)
+                return false;
+
+            // Peak signal is one for both normalized and float channels.
+            const auto meanSquaredError = difference.squaredError / difference.channelsCount;
+            const auto psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(1.0 / meanSquaredError) : std::numeric_limits<double>::infinity();
 
-            return equal;
+            return psnr >= tolerance.minPsnr;
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,252 @@
+#include "ImageHash.hpp"
+
+#include "ApprovalIntegration/ImageComparator.hpp"
+#include "ApprovalIntegration/ImageWriter.hpp"
+
+#include "gapi/MemoryAllocation.hpp"
+
+#include "common/OnScopeExit.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace RR
+{
+    namespace Tests
+    {
+        namespace
+        {
+            // Streaming XXH64, seed is zero.
+            class XXHash64 final
+            {
+            public:
+                void Update(const uint8_t* data, size_t size)
+                {
+                    totalSize_ += size;
+
+                    if (bufferSize_ + size < StripeSize)
+                    {
+                        std::memcpy(buffer_ + bufferSize_, data, size);
+                        bufferSize_ += size;
+                        return;
+                    }
+
+                    if (bufferSize_ > 0)
+                    {
+                        const size_t fill = StripeSize - bufferSize_;
+                        std::memcpy(buffer_ + bufferSize_, data, fill);
+                        consumeStripe(buffer_);
+
+                        data += fill;
+                        size -= fill;
+                        bufferSize_ = 0;
+                    }
+
+                    for (; size >= StripeSize; data += StripeSize, size -= StripeSize)
+                        consumeStripe(data);
+
+                    std::memcpy(buffer_, data, size);
+                    bufferSize_ = size;
+                }
+
+                uint64_t Digest() const
+                {
+                    uint64_t hash;
+                    if (totalSize_ >= StripeSize)
+                    {
+                        hash = rotl(accumulators_[0], 1) + rotl(accumulators_[1], 7) + rotl(accumulators_[2], 12) + rotl(accumulators_[3], 18);
+                        for (const auto accumulator : accumulators_)
+                            hash = (hash ^ round(0, accumulator)) * Prime1 + Prime4;
+                    }
+                    else
+                        hash = Prime5;
+
+                    hash += totalSize_;
+
+                    const uint8_t* tail = buffer_;
+                    size_t size = bufferSize_;
+                    for (; size >= 8; tail += 8, size -= 8)
+                        hash = rotl(hash ^ round(0, read<uint64_t>(tail)), 27) * Prime1 + Prime4;
+
+                    if (size >= 4)
+                    {
+                        hash = rotl(hash ^ (read<uint32_t>(tail) * Prime1), 23) * Prime2 + Prime3;
+                        tail += 4;
+                        size -= 4;
+                    }
+
+                    for (; size > 0; tail++, size--)
+                        hash = rotl(hash ^ (*tail * Prime5), 11) * Prime1;
+
+                    hash ^= hash >> 33;
+                    hash *= Prime2;
+                    hash ^= hash >> 29;
+                    hash *= Prime3;
+                    hash ^= hash >> 32;
+
+                    return hash;
+                }
+
+            private:
+                static constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+                static constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+                static constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+                static constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+                static constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+                static constexpr size_t StripeSize = 32;
+
+                template <typename T>
+                static T read(const uint8_t* data)
+                {
+                    T value;
+                    std::memcpy(&value, data, sizeof(T));
+                    return value;
+                }
+
+                static uint64_t rotl(uint64_t value, uint32_t bits) { return (value << bits) | (value >> (64 - bits)); }
+                static uint64_t round(uint64_t accumulator, uint64_t input) { return rotl(accumulator + input * Prime2, 31) * Prime1; }
+
+                void consumeStripe(const uint8_t* data)
+                {
+                    for (uint32_t lane = 0; lane < 4; lane++)
+                        accumulators_[lane] = round(accumulators_[lane], read<uint64_t>(data + lane * 8));
+                }
+
+            private:
+                uint64_t accumulators_[4] = { Prime1 + Prime2, Prime2, 0, 0 - Prime1 };
+                uint8_t buffer_[StripeSize];
+                size_t bufferSize_ = 0;
+                uint64_t totalSize_ = 0;
+            };
+
+            // Files of the test share the name, only "received"/"approved" part and extension differ.
+            std::string replaceExtension(const std::string& path, const char* extension)
+            {
+                return path.substr(0, path.find_last_of('.')) + extension;
+            }
+
+            std::string toApprovedPath(const std::string& receivedPath)
+            {
+                const auto position = receivedPath.rfind(".received.");
+                ASSERT(position != std::string::npos);
+
+                return receivedPath.substr(0, position) + ".approved." + receivedPath.substr(position + std::strlen(".received."));
+            }
+
+            bool readText(const std::string& path, std::string& text)
+            {
+                std::ifstream file(path);
+                if (!file)
+                    return false;
+
+                std::stringstream stream;
+                stream << file.rdbuf();
+                text = stream.str();
+
+                return true;
+            }
+
+            bool writeText(const std::string& path, const std::string& text)
+            {
+                std::ofstream file(path);
+                file << text;
+
+                return file.good();
+            }
+
+            bool fileExists(const std::string& path)
+            {
+                return std::ifstream(path).good();
+            }
+        }
+
+        uint64_t ComputeImageHash(const GAPI::CpuResourceData::SharedPtr& resource)
+        {
+            ASSERT(resource);
+
+            const auto dataPointer = static_cast<const uint8_t*>(resource->GetAllocation()->Map());
+            ON_SCOPE_EXIT(
+                {
+                    resource->GetAllocation()->Unmap();
+                });
+
+            XXHash64 hash;
+            for (uint32_t index = 0; index < resource->GetNumSubresources(); index++)
+            {
+                const auto& footprint = resource->GetSubresourceFootprintAt(index);
+
+                for (uint32_t slice = 0; slice < footprint.depth; slice++)
+                    for (uint32_t row = 0; row < footprint.numRows; row++)
+                        hash.Update(dataPointer + footprint.offset + slice * footprint.depthPitch + row * footprint.rowPitch, footprint.rowSizeInBytes);
+            }
+
+            return hash.Digest();
+        }
+
+        ImageHashWriter::ImageHashWriter(const GAPI::CpuResourceData::SharedPtr& resource)
+            : resource_(resource)
+        {
+            ASSERT(resource_);
+
+            const auto& description = resource_->GetResourceDescription();
+            hashText_ = fmt::format("xxh64 {:016x}\n{} {}x{}x{} mips {} subresources {}\n",
+                                    ComputeImageHash(resource_),
+                                    GAPI::GpuResourceFormatInfo::ToString(description.GetFormat()),
+                                    description.GetWidth(), description.GetHeight(), description.GetDepth(),
+                                    description.GetMipCount(), resource_->GetNumSubresources());
+        }
+
+        void ImageHashWriter::write(std::string path) const
+        {
+            const auto approvedPath = toApprovedPath(path);
+
+            std::string approvedText;
+            const bool hasApprovedHash = readText(approvedPath, approvedText);
+
+            const bool isWritten = writeText(path, hashText_);
+            ASSERT(isWritten);
+            std::ignore = isWritten;
+
+            if (hasApprovedHash && approvedText == hashText_)
+                return;
+
+            // Mismatch or no approved hash yet, full image is needed.
+            const auto receivedImagePath = replaceExtension(path, ".dds");
+            ImageWriter(resource_).write(receivedImagePath);
+
+            const auto approvedImagePath = replaceExtension(approvedPath, ".dds");
+            if (!hasApprovedHash && fileExists(approvedImagePath) &&
+                ImageComparator().contentsAreEquivalent(receivedImagePath, approvedImagePath))
+            {
+                writeText(approvedPath, hashText_);
+                remove(receivedImagePath.c_str());
+            }
+        }
+
+        void ImageHashWriter::cleanUpReceived(std::string receivedPath) const
+        {
+            remove(receivedPath.c_str());
+            remove(replaceExtension(receivedPath, ".dds").c_str());
+        }
+
+        bool ImageHashComparator::contentsAreEquivalent(std::string receivedPath,
+                                                        std::string approvedPath) const
+        {
+            std::string receivedText, approvedText;
+            if (!readText(receivedPath, receivedText) || !readText(approvedPath, approvedText))
+                return false;
+
+            if (receivedText == approvedText)
+                return true;
+
+            // Bitwise different, but could be within tolerance of the image comparator.
+            const auto receivedImagePath = replaceExtension(receivedPath, ".dds");
+            const auto approvedImagePath = replaceExtension(approvedPath, ".dds");
+            if (!fileExists(receivedImagePath) || !fileExists(approvedImagePath))
+                return false;
+
+            return ImageComparator().contentsAreEquivalent(receivedImagePath, approvedImagePath);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "gapi/Texture.hpp"
+
+#include "ApprovalTests/ApprovalTests.hpp"
+#include <catch2/catch.hpp>
+
+namespace RR
+{
+    namespace Tests
+    {
+        // XXH64 of subresource rows in subresource, slice, row order. Row padding of footprints is skipped,
+        // so hash depends on texels only, not on readback layout of the device.
+        uint64_t ComputeImageHash(const GAPI::CpuResourceData::SharedPtr& resource);
+
+        // Approved file of hash mode: hash with format and dimensions, which keep diffs readable.
+        // Full DDS is written next to received file on mismatch only, for inspection and tolerant comparison.
+        class ImageHashWriter : public ApprovalTests::ApprovalWriter
+        {
+        public:
+            explicit ImageHashWriter(const GAPI::CpuResourceData::SharedPtr& resource);
+
+            std::string getFileExtensionWithDot() const override { return ".xxh64"; }
+
+            // Approved hash is missing but approved DDS from image mode exists: images are compared once and
+            // approved hash is written if they match, so suites move to hash mode without reapproving.
+            void write(std::string path) const override;
+
+            void cleanUpReceived(std::string receivedPath) const override;
+
+        private:
+            GAPI::CpuResourceData::SharedPtr resource_;
+            std::string hashText_;
+        };
+
+        // Equal hashes pass without touching images. Otherwise full images are compared with tolerance,
+        // if approved DDS is available locally.
+        class ImageHashComparator : public ApprovalTests::ApprovalComparator
+        {
+        public:
+            bool contentsAreEquivalent(std::string receivedPath,
+                                       std::string approvedPath) const override;
+        };
+    }
+}
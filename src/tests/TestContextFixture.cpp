@@ -1,10 +1,13 @@
 #include "TestContextFixture.hpp"
 
+#include "Application.hpp"
+
 #include "render/DeviceContext.hpp"
 
 #include "gapi/Buffer.hpp"
 #include "gapi/CommandList.hpp"
 #include "gapi/MemoryAllocation.hpp"
+#include "gapi/TexelConversion.hpp"
 
 #include "common/OnScopeExit.hpp"
 
@@ -66,36 +69,37 @@ namespace RR
                        (std::is_same<T, Vector4>::value && description.GetFormat() == GAPI::GpuResourceFormat::RGBA16Float) ||
                        (std::is_same<T, Vector4>::value && description.GetFormat() == GAPI::GpuResourceFormat::RGBA32Float));
 
-                const auto& subresourceFootprints = resourceData->GetSubresourceFootprints();
-                const auto dataPointer = static_cast<uint8_t*>(resourceData->GetAllocation()->Map());
                 const auto blockSize = GAPI::GpuResourceFormatInfo::GetBlockSize(description.GetFormat());
-
-                for (uint32_t index = 0; index < subresourceFootprints.size(); index++)
-                {
-                    const auto& subresourceFootprint = subresourceFootprints[index];
+                for (const auto& subresourceFootprint : resourceData->GetSubresourceFootprints())
                     ASSERT(subresourceFootprint.width * blockSize == subresourceFootprint.rowSizeInBytes);
 
-                    for (uint32_t depth = 0; depth < subresourceFootprint.depth; depth++)
+                GAPI::TexelConversion::ForEachRow(resourceData, [&description](uint8_t* rowPointer, const GAPI::CpuResourceData::SubresourceFootprint& footprint,
+                                                                        uint32_t index, uint32_t row, uint32_t depth) {
+                    if constexpr (std::is_same<T, Vector4>::value)
                     {
-                        const auto depthPointer = dataPointer + subresourceFootprint.offset +
-                                                  depth * subresourceFootprint.depthPitch;
-                        for (uint32_t row = 0; row < subresourceFootprint.numRows; row++)
+                        if (description.GetFormat() == GAPI::GpuResourceFormat::RGBA16Float)
                         {
-                            const auto rowPointer = depthPointer + row * subresourceFootprint.rowPitch;
-                            auto columnPointer = reinterpret_cast<T*>(rowPointer);
+                            thread_local std::vector<Vector4> texels;
+                            texels.resize(footprint.width);
 
-                            for (uint32_t column = 0; column < subresourceFootprint.width; column++)
-                            {
-                                const auto texel = Vector3u(column, row, depth);
+                            for (uint32_t column = 0; column < footprint.width; column++)
+                                texels[column] = checkerboardPattern<Vector4>(Vector3u(column, row, depth), index);
 
-                                *columnPointer = checkerboardPattern<T>(texel, index);
-                                columnPointer++;
-                            }
+                            GAPI::TexelConversion::ConvertRowRGBA32FloatToRGBA16Float(reinterpret_cast<const float*>(texels.data()),
+                                                                                     reinterpret_cast<uint16_t*>(rowPointer), footprint.width);
+                            return;
                         }
                     }
-                }
 
-                resourceData->GetAllocation()->Unmap();
+                    auto columnPointer = reinterpret_cast<T*>(rowPointer);
+                    for (uint32_t column = 0; column < footprint.width; column++)
+                    {
+                        const auto texel = Vector3u(column, row, depth);
+
+                        *columnPointer = checkerboardPattern<T>(texel, index);
+                        columnPointer++;
+                    }
+                });
             }
 
             void fillBufferData(const GAPI::GpuResourceDescription& description, const GAPI::CpuResourceData::SharedPtr& resourceData)
@@ -122,9 +126,19 @@ namespace RR
             }
         }
 
-        TestContextFixture::TestContextFixture() : renderContext(Render::DeviceContext::Instance())
+        TestContextFixture::TestContextFixture() : renderContext(Application::Instance().GetDeviceContext())
         {
-   
+        }
+
+        TestContextFixture::~TestContextFixture()
+        {
+            // Failed REQUIRE skips the wait, device is reused by following tests.
+            waitSubmitted();
+        }
+
+        const GAPI::CommandQueue::SharedPtr& TestContextFixture::getCommandQueue(GAPI::CommandQueueType type) const
+        {
+            return renderContext.GetCommandQueue(type);
         }
 
         const GAPI::GpuResourceDescription& TestContextFixture::createTextureDescription(GAPI::GpuResourceDimension dimension, uint32_t size, GAPI::GpuResourceFormat format)
@@ -174,14 +188,7 @@ namespace RR
             const auto& description = GAPI::GpuResourceDescription::Buffer(strlen(data), bindFlags);
             const auto bufferData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::CpuReadWrite);
 
-            const auto dataPointer = static_cast<char*>(bufferData->GetAllocation()->Map());
-            ON_SCOPE_EXIT(
-                {
-                    bufferData->GetAllocation()->Unmap();
-                });
-
-            const auto& footprint = bufferData->GetSubresourceFootprintAt(0);
-            memcpy(dataPointer, data, footprint.rowSizeInBytes);
+            bufferData->WriteSubresource(0, data, bufferData->GetSubresourceFootprintAt(0).rowSizeInBytes);
 
             auto result = renderContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Source");
             commandList->UpdateGpuResource(result, bufferData);
@@ -243,11 +250,33 @@ namespace RR
             return true;
         }
 
+        void TestContextFixture::submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList)
+        {
+            auto& pending = pendingSubmissions_[static_cast<size_t>(commandQueue->GetCommandQueueType())];
+            ASSERT(!pending.commandQueue || pending.commandQueue == commandQueue);
+
+            // Queue executes in order, last sync point covers previous submissions.
+            pending.commandQueue = commandQueue;
+            pending.syncPoint = renderContext.Submit(commandQueue, commandList);
+        }
+
+        void TestContextFixture::waitSubmitted()
+        {
+            for (auto& pending : pendingSubmissions_)
+            {
+                if (!pending.commandQueue)
+                    continue;
+
+                pending.syncPoint.Wait();
+                renderContext.MoveToNextFrame(pending.commandQueue);
+                pending = {};
+            }
+        }
+
         void TestContextFixture::submitAndWait(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList)
         {
-            renderContext.Submit(commandQueue, commandList);
-            renderContext.WaitForGpu(commandQueue);
-            renderContext.MoveToNextFrame(commandQueue);
+            submit(commandQueue, commandList);
+            waitSubmitted();
         }
     }
 }
\ No newline at end of file
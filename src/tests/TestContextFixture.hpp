@@ -2,8 +2,12 @@
 
 #include "gapi/ForwardDeclarations.hpp"
 
+#include "gapi/CommandQueue.hpp"
+#include "gapi/Fence.hpp"
 #include "gapi/GpuResource.hpp"
 
+#include <array>
+
 namespace RR
 {
     namespace Tests
@@ -12,7 +16,7 @@ namespace RR
         {
         public:
             TestContextFixture();
-            ~TestContextFixture() = default;
+            ~TestContextFixture();
 
         protected:
             const GAPI::GpuResourceDescription& createTextureDescription(GAPI::GpuResourceDimension dimension, uint32_t size, GAPI::GpuResourceFormat format);
@@ -23,10 +27,25 @@ namespace RR
             bool isSubresourceEqual(const std::shared_ptr<GAPI::CpuResourceData>& lhs, uint32_t lSubresourceIndex,
                                     const std::shared_ptr<GAPI::CpuResourceData>& rhs, uint32_t rSubresourceIndex);
 
+            // Queues of shared device context, created once per process.
+            const std::shared_ptr<GAPI::CommandQueue>& getCommandQueue(GAPI::CommandQueueType type) const;
+
+            // Independent submissions are batched and waited once by waitSubmitted.
+            void submit(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList);
+            void waitSubmitted();
             void submitAndWait(const std::shared_ptr<GAPI::CommandQueue>& commandQueue, const std::shared_ptr<GAPI::CommandList>& commandList);
 
         protected:
             Render::DeviceContext& renderContext;
+
+        private:
+            struct PendingSubmission
+            {
+                std::shared_ptr<GAPI::CommandQueue> commandQueue;
+                GAPI::GpuSyncPoint syncPoint;
+            };
+
+            std::array<PendingSubmission, static_cast<size_t>(GAPI::CommandQueueType::Count)> pendingSubmissions_;
         };
     }
 }
\ No newline at end of file
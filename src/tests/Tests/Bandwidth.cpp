@@ -0,0 +1,207 @@
+#include "Bandwidth.hpp"
+
+#include "TestContextFixture.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/GpuTimings.hpp"
+#include "gapi/MemoryAllocation.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <chrono>
+#include <limits>
+
+namespace RR
+{
+    namespace Tests
+    {
+        namespace
+        {
+            constexpr uint32_t SamplesCount = 5;
+
+            constexpr std::array<uint32_t, 6> BufferSizes = { 4 << 10, 64 << 10, 1 << 20, 16 << 20, 256 << 20, 1 << 30 };
+            constexpr std::array<uint32_t, 4> TextureSizes = { 256, 1024, 2048, 4096 };
+            constexpr std::array<GAPI::GpuResourceFormat, 3> TextureFormats = {
+                GAPI::GpuResourceFormat::RGBA8Unorm,
+                GAPI::GpuResourceFormat::RGBA16Float,
+                GAPI::GpuResourceFormat::RGBA32Float,
+            };
+
+            U8String sizeToString(uint32_t bytes)
+            {
+                if (bytes >= 1 << 30)
+                    return fmt::format("{}GB", bytes >> 30);
+
+                if (bytes >= 1 << 20)
+                    return fmt::format("{}MB", bytes >> 20);
+
+                return fmt::format("{}KB", bytes >> 10);
+            }
+
+            const char* queueTypeToString(GAPI::CommandQueueType type)
+            {
+                return type == GAPI::CommandQueueType::Copy ? "Copy" : "Graphics";
+            }
+        }
+
+        // Graphics queue is timed with GPU timestamp markers. Copy queue timestamps are optional in D3D12
+        // and copy lists ignore markers, so copy queue is timed by fence round trip minus empty submission.
+        class BandwidthFixture : public TestContextFixture
+        {
+        public:
+            BandwidthFixture()
+                : copyQueue_(renderContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "BandwidthCopy"))
+            {
+                // Submission overhead of copy queue.
+                emptySubmitMs_ = measure(copyQueue_, [](GAPI::CopyCommandList&) {});
+            }
+
+        protected:
+            using RecordFunction = std::function<void(GAPI::CopyCommandList&)>;
+
+            std::array<std::shared_ptr<GAPI::CommandQueue>, 2> getQueues() const
+            {
+                return { copyQueue_, renderContext.GetCommandQueue(GAPI::CommandQueueType::Graphics) };
+            }
+
+            // Best of samples in milliseconds.
+            double measure(const std::shared_ptr<GAPI::CommandQueue>& queue, const RecordFunction& record)
+            {
+                double bestMs = std::numeric_limits<double>::max();
+
+                for (uint32_t sample = 0; sample < SamplesCount; sample++)
+                {
+                    const auto sampleMs = queue->GetCommandQueueType() == GAPI::CommandQueueType::Copy ? measureCopyQueue(queue, record)
+                                                                                           : measureGraphicsQueue(queue, record);
+                    bestMs = std::min(bestMs, sampleMs);
+                }
+
+                return bestMs;
+            }
+
+            void report(const U8String& name, GAPI::CommandQueueType queueType, uint64_t bytes, double ms) const
+            {
+                const auto gbPerSecond = ms > 0.0 ? static_cast<double>(bytes) / (ms * 1e6) : 0.0;
+
+                Log::Print::Info("Bandwidth %s [%s]: %.3fms, %.2f GB/s\n", name.c_str(), queueTypeToString(queueType), ms, gbPerSecond);
+                CHECK(ms > 0.0);
+            }
+
+        private:
+            double measureCopyQueue(const std::shared_ptr<GAPI::CommandQueue>& queue, const RecordFunction& record)
+            {
+                const auto& commandList = renderContext.CreateCopyCommandList("Bandwidth");
+                record(*commandList);
+                commandList->Close();
+
+                const auto start = std::chrono::steady_clock::now();
+                renderContext.Submit(queue, commandList).Wait();
+                const auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                renderContext.MoveToNextFrame(queue);
+
+                return std::max(elapsedMs - emptySubmitMs_, 0.0);
+            }
+
+            double measureGraphicsQueue(const std::shared_ptr<GAPI::CommandQueue>& queue, const RecordFunction& record)
+            {
+                static constexpr char markerName[] = "Bandwidth";
+
+                const auto& commandList = renderContext.CreateGraphicsCommandList("Bandwidth");
+                commandList->BeginMarker(markerName);
+                record(*commandList);
+                commandList->EndMarker();
+                commandList->Close();
+
+                renderContext.Submit(queue, commandList).Wait();
+
+                // Timestamps of the frame are read back once its query range is reused.
+                for (uint32_t frame = 0; frame < renderContext.GetGpuFramesBuffered(); frame++)
+                    renderContext.MoveToNextFrame(queue);
+
+                renderContext.ExecuteAwait([](GAPI::Device&) {});
+
+                const auto& timings = renderContext.GetGpuFrameTimings();
+                for (const auto& marker : timings.markers)
+                    if (marker.name == markerName)
+                        return marker.durationMs;
+
+                FAIL("Bandwidth marker is missing in GPU frame timings");
+                return 0.0;
+            }
+
+        private:
+            std::shared_ptr<GAPI::CommandQueue> copyQueue_;
+            double emptySubmitMs_ = 0.0;
+        };
+
+        TEST_CASE_METHOD(BandwidthFixture, "BufferBandwidth", "[Bandwidth][!benchmark]")
+        {
+            for (const auto size : BufferSizes)
+            {
+                const auto& description = GAPI::GpuResourceDescription::Buffer(size);
+
+                const auto source = renderContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Source");
+                const auto dest = renderContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Dest");
+                const auto uploadData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Upload);
+                const auto readbackData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                const auto sizeName = sizeToString(size);
+
+                for (const auto& queue : getQueues())
+                {
+                    const auto queueType = queue->GetCommandQueueType();
+
+                    report(fmt::format("CopyBufferRegion {}", sizeName), queueType, size,
+                           measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.CopyBufferRegion(source, 0, dest, 0, size); }));
+
+                    report(fmt::format("UpdateGpuResource Buffer {}", sizeName), queueType, size,
+                           measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.UpdateGpuResource(dest, uploadData); }));
+
+                    report(fmt::format("ReadbackGpuResource Buffer {}", sizeName), queueType, size,
+                           measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.ReadbackGpuResource(source, readbackData); }));
+                }
+            }
+        }
+
+        TEST_CASE_METHOD(BandwidthFixture, "TextureBandwidth", "[Bandwidth][!benchmark]")
+        {
+            for (const auto format : TextureFormats)
+            {
+                const auto formatName = GAPI::GpuResourceFormatInfo::ToString(format);
+
+                for (const auto size : TextureSizes)
+                {
+                    const auto& description = GAPI::GpuResourceDescription::Texture2D(size, size, format, GAPI::GpuResourceBindFlags::ShaderResource, 1, 1);
+
+                    const auto source = renderContext.CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "Source");
+                    const auto dest = renderContext.CreateTexture(description, GAPI::GpuResourceCpuAccess::None, "Dest");
+                    const auto uploadData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Upload);
+                    const auto readbackData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                    const uint64_t bytes = static_cast<uint64_t>(size) * size * GAPI::GpuResourceFormatInfo::GetBlockSize(format);
+                    const auto textureName = fmt::format("{}x{} {}", size, size, formatName);
+
+                    for (const auto& queue : getQueues())
+                    {
+                        const auto queueType = queue->GetCommandQueueType();
+
+                        report(fmt::format("CopyTextureSubresource {}", textureName), queueType, bytes,
+                               measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.CopyTextureSubresource(source, 0, dest, 0); }));
+
+                        report(fmt::format("UpdateGpuResource Texture {}", textureName), queueType, bytes,
+                               measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.UpdateGpuResource(dest, uploadData); }));
+
+                        report(fmt::format("ReadbackGpuResource Texture {}", textureName), queueType, bytes,
+                               measure(queue, [&](GAPI::CopyCommandList& commandList) { commandList.ReadbackGpuResource(source, readbackData); }));
+                    }
+                }
+            }
+        }
+    }
+}
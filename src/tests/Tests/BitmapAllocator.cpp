@@ -0,0 +1,102 @@
+#include "BitmapAllocator.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/BitmapAllocator.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace RR
+{
+    namespace Tests
+    {
+        TEST_CASE("BitmapAllocator", "[Common][BitmapAllocator]")
+        {
+            BitmapAllocator allocator;
+            allocator.Init(1000);
+
+            SECTION("Single")
+            {
+                for (uint32_t index = 0; index < 1000; index++)
+                    REQUIRE(allocator.Allocate() == index);
+
+                REQUIRE(allocator.Allocate() == BitmapAllocator::InvalidIndex);
+                REQUIRE(allocator.GetAllocatedCount() == 1000);
+
+                allocator.Free(500);
+                REQUIRE(allocator.Allocate() == 500u);
+            }
+
+            SECTION("RangeWithinWord")
+            {
+                REQUIRE(allocator.Allocate(3) == 0u);
+                REQUIRE(allocator.Allocate(60) == 3u);
+                // Doesn't fit the rest of the first word.
+                REQUIRE(allocator.Allocate(2) == 64u);
+
+                allocator.Free(3, 60);
+                REQUIRE(allocator.Allocate(61) == 3u);
+            }
+
+            SECTION("RangeAcrossWords")
+            {
+                REQUIRE(allocator.Allocate(40) == 0u);
+                // Fits neither the rest of the first word nor a single word.
+                REQUIRE(allocator.Allocate(100) == 40u);
+                REQUIRE(allocator.Allocate(860) == 140u);
+                REQUIRE(allocator.GetAllocatedCount() == 1000);
+
+                allocator.Free(40, 100);
+                REQUIRE(allocator.Allocate(101) == BitmapAllocator::InvalidIndex);
+                REQUIRE(allocator.Allocate(100) == 40u);
+            }
+
+            SECTION("CapacityTail")
+            {
+                REQUIRE(allocator.Allocate(990) == 0u);
+                REQUIRE(allocator.Allocate(11) == BitmapAllocator::InvalidIndex);
+                REQUIRE(allocator.Allocate(10) == 990u);
+                REQUIRE(allocator.Allocate() == BitmapAllocator::InvalidIndex);
+            }
+
+            SECTION("Concurrent")
+            {
+                constexpr uint32_t threadsCount = 4;
+                constexpr uint32_t iterationsPerThread = 10000;
+
+                std::vector<std::atomic<uint32_t>> owners(1000);
+                std::atomic<bool> isOverlapped = false;
+
+                std::vector<std::thread> threads;
+                for (uint32_t thread = 0; thread < threadsCount; thread++)
+                    threads.emplace_back([&, thread] {
+                        for (uint32_t iteration = 0; iteration < iterationsPerThread; iteration++)
+                        {
+                            const uint32_t count = 1 + (iteration + thread) % 70;
+                            const uint32_t first = allocator.Allocate(count);
+                            if (first == BitmapAllocator::InvalidIndex)
+                                continue;
+
+                            for (uint32_t index = first; index < first + count; index++)
+                                if (owners[index].exchange(thread + 1) != 0)
+                                    isOverlapped = true;
+
+                            for (uint32_t index = first; index < first + count; index++)
+                                owners[index] = 0;
+
+                            allocator.Free(first, count);
+                        }
+                    });
+
+                for (auto& thread : threads)
+                    thread.join();
+
+                REQUIRE(!isOverlapped);
+                REQUIRE(allocator.GetAllocatedCount() == 0);
+                REQUIRE(allocator.Allocate(1000) == 0u);
+            }
+        }
+    }
+}
@@ -9,17 +9,39 @@
 #include "gapi/Buffer.hpp"
 #include "gapi/CommandList.hpp"
 #include "gapi/CommandQueue.hpp"
+#include "gapi/GpuResourceViews.hpp"
 #include "gapi/MemoryAllocation.hpp"
+#include "gapi/PipelineState.hpp"
 #include "gapi/Texture.hpp"
 
 #include "render/DeviceContext.hpp"
+#include "render/GpuDecompressor.hpp"
 
 #include "common/OnScopeExit.hpp"
+#include "common/TileCompression.hpp"
+
+#include <fstream>
 
 namespace RR
 {
     namespace Tests
     {
+        namespace
+        {
+            bool readFile(const char* path, std::vector<uint8_t>& data)
+            {
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file)
+                    return false;
+
+                data.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+                return !data.empty() && file.good();
+            }
+        }
+
         TEST_CASE_METHOD(TestContextFixture, "ComputeCommmandList", "[CommandList][ComputeCommandList]")
         {
             auto commandList = renderContext.CreateCopyCommandList(u8"ComputeCommmandList");
@@ -36,7 +58,7 @@ namespace RR
             auto commandList = renderContext.CreateComputeCommandList(u8"ComputeCommmandList");
             REQUIRE(commandList != nullptr);
 
-            auto queue = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Compute, "ComputeQueue");
+            auto queue = getCommandQueue(GAPI::CommandQueueType::Compute);
             REQUIRE(queue != nullptr);
 
             SECTION("[Buffer::RawBuffer] UAV clear ClearUnorderedAccessViewUint")
@@ -117,5 +139,136 @@ namespace RR
                // REQUIRE(memcmp(dataPointer, testData, footprint.rowSizeInBytes) == 0);
             }
         }
+
+        TEST_CASE_METHOD(TestContextFixture, "Dispatch", "[CommandList][ComputeCommandList][Dispatch]")
+        {
+            // Compiled by rfx from bin/shaders/FillBuffer.slang.
+            GAPI::PipelineStateDescription pipelineDescription;
+            pipelineDescription.type = GAPI::PipelineStateType::Compute;
+            if (!readFile("shaders/FillBuffer_main.bin", pipelineDescription.computeShader) ||
+                !readFile("shaders/FillBuffer_main.refl", pipelineDescription.reflection))
+            {
+                WARN("FillBuffer shader isn't compiled, dispatch isn't tested.");
+                return;
+            }
+
+            const auto pipelineState = renderContext.CreatePipelineState(pipelineDescription, "FillBuffer");
+            REQUIRE(pipelineState != nullptr);
+
+            auto commandList = renderContext.CreateComputeCommandList(u8"Dispatch");
+            REQUIRE(commandList != nullptr);
+
+            auto queue = getCommandQueue(GAPI::CommandQueueType::Compute);
+            REQUIRE(queue != nullptr);
+
+            constexpr uint32_t threadGroupSize = 64;
+            constexpr uint32_t elementsCount = threadGroupSize * 4;
+
+            const auto& description = GAPI::GpuResourceDescription::Buffer(elementsCount * sizeof(uint32_t), GAPI::GpuResourceBindFlags::UnorderedAccess);
+            const auto result = renderContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Result");
+            const auto readbackData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+            const auto uav = result->GetUAV(GAPI::GpuResourceFormat::R32Uint);
+
+            const auto checkResult = [&]()
+            {
+                const auto dataPointer = static_cast<const uint32_t*>(readbackData->GetAllocation()->Map());
+                ON_SCOPE_EXIT(
+                    {
+                        readbackData->GetAllocation()->Unmap();
+                    });
+
+                for (uint32_t index = 0; index < elementsCount; index++)
+                    REQUIRE(dataPointer[index] == index);
+            };
+
+            REQUIRE(commandList->SetComputePipelineState(pipelineState));
+            commandList->SetComputeDescriptorTable(0, uav->GetBindlessIndex());
+            commandList->TransitionToUnorderedAccess(uav);
+
+            SECTION("Dispatch")
+            {
+                commandList->Dispatch(elementsCount / threadGroupSize);
+                commandList->ReadbackGpuResource(result, readbackData);
+                commandList->Close();
+
+                submitAndWait(queue, commandList);
+                checkResult();
+            }
+
+            SECTION("DispatchIndirect")
+            {
+                const GAPI::DispatchArguments arguments = { elementsCount / threadGroupSize, 1, 1 };
+
+                const auto& argumentsDescription = GAPI::GpuResourceDescription::Buffer(sizeof(arguments));
+                const auto argumentsData = renderContext.AllocateIntermediateResourceData(argumentsDescription, GAPI::MemoryAllocationType::CpuReadWrite);
+                argumentsData->WriteSubresource(0, &arguments, sizeof(arguments));
+
+                const auto argumentBuffer = renderContext.CreateBuffer(argumentsDescription, GAPI::GpuResourceCpuAccess::None, "DispatchArguments");
+                commandList->UpdateGpuResource(argumentBuffer, argumentsData);
+
+                commandList->DispatchIndirect(argumentBuffer);
+                commandList->ReadbackGpuResource(result, readbackData);
+                commandList->Close();
+
+                submitAndWait(queue, commandList);
+                checkResult();
+            }
+        }
+
+        TEST_CASE_METHOD(TestContextFixture, "Decompress", "[CommandList][ComputeCommandList][Decompress]")
+        {
+            Render::GpuDecompressor decompressor;
+            decompressor.Init(renderContext);
+            ON_SCOPE_EXIT(
+                {
+                    decompressor.Terminate();
+                });
+
+            if (!decompressor.IsAvailable())
+            {
+                WARN("Decompress shader isn't compiled, GPU decompression isn't tested.");
+                return;
+            }
+
+            auto commandList = renderContext.CreateComputeCommandList(u8"Decompress");
+            REQUIRE(commandList != nullptr);
+
+            auto queue = getCommandQueue(GAPI::CommandQueueType::Compute);
+            REQUIRE(queue != nullptr);
+
+            // Few tiles, the last one partial and not multiple of 4. Slow ramps give matches, the rest gives literals.
+            std::vector<uint8_t> data(Common::TileCompression::TileSize * 3 + 1001);
+            for (size_t index = 0; index < data.size(); index++)
+                data[index] = static_cast<uint8_t>((index % 1024) < 512 ? index / 7 : index * 31 + index / 4096);
+
+            const auto compressed = Common::TileCompression::Compress(data.data(), data.size());
+            Common::TileCompression::Header header;
+            REQUIRE(Common::TileCompression::ReadHeader(compressed.data(), compressed.size(), header));
+            REQUIRE(compressed.size() < data.size());
+
+            const auto& sourceDescription = GAPI::GpuResourceDescription::Buffer(static_cast<uint32_t>(compressed.size()), GAPI::GpuResourceBindFlags::ShaderResource);
+            const auto source = renderContext.CreateBuffer(sourceDescription, GAPI::GpuResourceCpuAccess::None, "Compressed");
+            const auto sourceData = renderContext.AllocateIntermediateResourceData(sourceDescription, GAPI::MemoryAllocationType::CpuReadWrite);
+            sourceData->WriteSubresource(0, compressed.data(), compressed.size());
+
+            const auto& destDescription = GAPI::GpuResourceDescription::Buffer(static_cast<uint32_t>(AlignTo(data.size(), sizeof(uint32_t))), GAPI::GpuResourceBindFlags::UnorderedAccess);
+            const auto dest = renderContext.CreateBuffer(destDescription, GAPI::GpuResourceCpuAccess::None, "Decompressed");
+            const auto readbackData = renderContext.AllocateIntermediateResourceData(destDescription, GAPI::MemoryAllocationType::Readback);
+
+            commandList->UpdateGpuResource(source, sourceData);
+            decompressor.Decompress(*commandList, source, 0, header, dest);
+            commandList->ReadbackGpuResource(dest, readbackData);
+            commandList->Close();
+
+            submitAndWait(queue, commandList);
+
+            const auto dataPointer = readbackData->GetAllocation()->Map();
+            ON_SCOPE_EXIT(
+                {
+                    readbackData->GetAllocation()->Unmap();
+                });
+
+            REQUIRE(memcmp(dataPointer, data.data(), data.size()) == 0);
+        }
     }
-}
\ No newline at end of file
+}
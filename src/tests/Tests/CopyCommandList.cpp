@@ -37,7 +37,7 @@ namespace RR
             auto commandList = renderContext.CreateCopyCommandList(u8"CopyCommandList");
             REQUIRE(commandList != nullptr);
 
-            auto queue = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "CopyQueue");
+            auto queue = getCommandQueue(GAPI::CommandQueueType::Copy);
             REQUIRE(queue != nullptr);
 
             const auto format = GAPI::GpuResourceFormat::Unknown;
@@ -179,6 +179,60 @@ namespace RR
                     const auto& footprint = readbackData->GetSubresourceFootprintAt(0);
                     REQUIRE(memcmp(dataPointer, testData, footprint.rowSizeInBytes) == 0);
                 }
+
+                DYNAMIC_SECTION(fmt::format("[Buffer::{}] Update buffers batched", formatName))
+                {
+                    const auto firstData = "1234567890";
+                    auto first = initBufferWithData(firstData, commandList);
+
+                    const auto secondData = "QWERTYUIOP";
+                    auto second = initBufferWithData(secondData, commandList);
+
+                    // Overlapping updates of the same buffer are applied in call order.
+                    commandList->UpdateBuffers({ { second, 0, "AS", 2 },
+                                                 { first, 2, "abc", 3 },
+                                                 { second, 1, "DFG", 3 },
+                                                 { first, 8, "xy", 2 } });
+
+                    const auto& description = GAPI::GpuResourceDescription::Buffer(strlen(firstData));
+                    const auto firstReadback = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+                    const auto secondReadback = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                    commandList->ReadbackGpuResource(first, firstReadback);
+                    commandList->ReadbackGpuResource(second, secondReadback);
+                    commandList->Close();
+
+                    submitAndWait(queue, commandList);
+
+                    const auto& footprint = firstReadback->GetSubresourceFootprintAt(0);
+                    REQUIRE(memcmp(firstReadback->GetAllocation()->Map(), "12abc678xy", footprint.rowSizeInBytes) == 0);
+                    REQUIRE(memcmp(secondReadback->GetAllocation()->Map(), "ADFGTYUIOP", footprint.rowSizeInBytes) == 0);
+                    firstReadback->GetAllocation()->Unmap();
+                    secondReadback->GetAllocation()->Unmap();
+                }
+            }
+
+            SECTION("[Buffer] Write GPU upload buffer in place")
+            {
+                const auto testData = "1234567890";
+
+                const auto& description = GAPI::GpuResourceDescription::Buffer(strlen(testData));
+                const auto source = renderContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::GpuUpload, "GpuUpload");
+                REQUIRE(source->GetMappedData() != nullptr);
+                memcpy(source->GetMappedData(), testData, strlen(testData));
+
+                const auto dest = renderContext.CreateBuffer(description);
+                const auto readbackData = renderContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                commandList->CopyBufferRegion(source, 0, dest, 0, static_cast<uint32_t>(strlen(testData)));
+                commandList->ReadbackGpuResource(dest, readbackData);
+                commandList->Close();
+
+                submitAndWait(queue, commandList);
+
+                const auto& footprint = readbackData->GetSubresourceFootprintAt(0);
+                REQUIRE(memcmp(readbackData->GetAllocation()->Map(), testData, footprint.rowSizeInBytes) == 0);
+                readbackData->GetAllocation()->Unmap();
             }
         }
 
@@ -187,7 +241,7 @@ namespace RR
             auto commandList = renderContext.CreateCopyCommandList(u8"CopyCommandList");
             REQUIRE(commandList != nullptr);
 
-            auto copyQueue = renderContext.CreteCommandQueue(GAPI::CommandQueueType::Copy, "CopyQueue");
+            auto copyQueue = getCommandQueue(GAPI::CommandQueueType::Copy);
             REQUIRE(copyQueue != nullptr);
 
             std::array<GAPI::GpuResourceFormat, 2> formatsToTest = { GAPI::GpuResourceFormat::RGBA8Uint, GAPI::GpuResourceFormat::RGBA32Float };
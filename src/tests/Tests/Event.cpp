@@ -0,0 +1,212 @@
+#include "Event.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/threading/Event.hpp"
+#include "common/threading/Semaphore.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        using namespace Common::Threading;
+
+        namespace
+        {
+            // Polls condition changed by other threads, false on timeout.
+            template <typename Predicate>
+            bool waitFor(Predicate&& predicate)
+            {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while (!predicate())
+                {
+                    if (std::chrono::steady_clock::now() > deadline)
+                        return false;
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                return true;
+            }
+        }
+
+        TEST_CASE("Event", "[Threading][Event]")
+        {
+            SECTION("ManualReset")
+            {
+                Event event(true, false);
+                REQUIRE(!event.Wait(0));
+
+                event.Notify();
+                REQUIRE(event.Wait(0));
+                REQUIRE(event.Wait(0));
+
+                event.Reset();
+                REQUIRE(!event.Wait(0));
+            }
+
+            SECTION("AutoReset")
+            {
+                Event event(false, true);
+                REQUIRE(event.Wait(0));
+                REQUIRE(!event.Wait(0));
+
+                event.Notify();
+                event.Notify();
+                REQUIRE(event.Wait(0));
+                REQUIRE(!event.Wait(0));
+            }
+
+            SECTION("TimedWait")
+            {
+                Event event(false, false);
+
+                const auto start = std::chrono::steady_clock::now();
+                REQUIRE(!event.Wait(20));
+                REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+                std::thread notifier([&event] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    event.Notify();
+                });
+
+                REQUIRE(event.Wait(10000));
+                notifier.join();
+            }
+
+            SECTION("ManualResetWakesAll")
+            {
+                constexpr uint32_t waitersCount = 4;
+
+                Event event(true, false);
+                std::atomic<uint32_t> woken = 0;
+
+                std::vector<std::thread> waiters;
+                for (uint32_t index = 0; index < waitersCount; index++)
+                    waiters.emplace_back([&event, &woken] {
+                        event.Wait();
+                        woken++;
+                    });
+
+                // Give waiters time to park, so notify has to wake them.
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                REQUIRE(woken == 0);
+
+                event.Notify();
+                for (auto& waiter : waiters)
+                    waiter.join();
+
+                REQUIRE(woken == waitersCount);
+            }
+
+            SECTION("AutoResetWakesOne")
+            {
+                constexpr uint32_t waitersCount = 4;
+
+                Event event(false, false);
+                std::atomic<uint32_t> woken = 0;
+
+                std::vector<std::thread> waiters;
+                for (uint32_t index = 0; index < waitersCount; index++)
+                    waiters.emplace_back([&event, &woken] {
+                        event.Wait();
+                        woken++;
+                    });
+
+                for (uint32_t index = 0; index < waitersCount; index++)
+                {
+                    event.Notify();
+                    REQUIRE(waitFor([&woken, index] { return woken == index + 1; }));
+
+                    // Single notify never releases more than one waiter.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    REQUIRE(woken == index + 1);
+                }
+
+                for (auto& waiter : waiters)
+                    waiter.join();
+            }
+        }
+
+        TEST_CASE("Semaphore", "[Threading][Semaphore]")
+        {
+            SECTION("Count")
+            {
+                Semaphore semaphore(2);
+                REQUIRE(semaphore.TryAcquire());
+                REQUIRE(semaphore.TryAcquire());
+                REQUIRE(!semaphore.TryAcquire());
+
+                semaphore.Release(3);
+                for (uint32_t index = 0; index < 3; index++)
+                    REQUIRE(semaphore.TryAcquire());
+
+                REQUIRE(!semaphore.TryAcquire());
+            }
+
+            SECTION("MultipleWaiters")
+            {
+                constexpr uint32_t waitersCount = 4;
+
+                Semaphore semaphore(0);
+                std::atomic<uint32_t> acquired = 0;
+
+                std::vector<std::thread> waiters;
+                for (uint32_t index = 0; index < waitersCount; index++)
+                    waiters.emplace_back([&semaphore, &acquired] {
+                        semaphore.Acquire();
+                        acquired++;
+                    });
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                REQUIRE(acquired == 0);
+
+                // Exactly released count of waiters pass.
+                semaphore.Release(2);
+                REQUIRE(waitFor([&acquired] { return acquired == 2; }));
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                REQUIRE(acquired == 2);
+
+                semaphore.Release();
+                semaphore.Release();
+                for (auto& waiter : waiters)
+                    waiter.join();
+
+                REQUIRE(acquired == waitersCount);
+                REQUIRE(!semaphore.TryAcquire());
+            }
+
+            SECTION("ProducerConsumer")
+            {
+                constexpr uint32_t consumersCount = 3;
+                constexpr uint32_t itemsCount = 30000;
+
+                Semaphore semaphore(0);
+                std::atomic<uint32_t> consumed = 0;
+
+                std::vector<std::thread> consumers;
+                for (uint32_t index = 0; index < consumersCount; index++)
+                    consumers.emplace_back([&semaphore, &consumed] {
+                        for (uint32_t item = 0; item < itemsCount / consumersCount; item++)
+                        {
+                            semaphore.Acquire();
+                            consumed++;
+                        }
+                    });
+
+                for (uint32_t item = 0; item < itemsCount; item++)
+                    semaphore.Release();
+
+                for (auto& consumer : consumers)
+                    consumer.join();
+
+                REQUIRE(consumed == itemsCount);
+                REQUIRE(!semaphore.TryAcquire());
+            }
+        }
+    }
+}
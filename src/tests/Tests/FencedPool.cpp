@@ -0,0 +1,101 @@
+#include "FencedPool.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "gapi/FencedPool.hpp"
+
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        namespace
+        {
+            // Timeline advanced by test instead of GPU.
+            class TestFence final : public GAPI::IFence
+            {
+            public:
+                void Signal(const std::shared_ptr<GAPI::CommandQueue>&) override { }
+                void Signal(GAPI::CommandQueue&, uint64_t) override { }
+                void SyncCPU(std::optional<uint64_t>, uint32_t) const override { }
+                void SyncGPU(const std::shared_ptr<GAPI::CommandQueue>&, std::optional<uint64_t>) const override { }
+
+                uint64_t GetGpuValue() const override { return gpuValue; }
+                uint64_t GetCpuValue() const override { return gpuValue; }
+
+                uint64_t gpuValue = 0;
+            };
+        }
+
+        TEST_CASE("FencedPool", "[GAPI][FencedPool]")
+        {
+            GAPI::FencedPool<uint32_t> pool;
+            TestFence fence;
+
+            SECTION("ReuseAfterFence")
+            {
+                pool.Release(1, fence, 1);
+                REQUIRE(!pool.TryAcquire());
+
+                fence.gpuValue = 1;
+                REQUIRE(pool.TryAcquire() == 1u);
+                REQUIRE(!pool.TryAcquire());
+            }
+
+            SECTION("CreateWhenInFlight")
+            {
+                pool.Release(1, fence, 1);
+                REQUIRE(pool.Acquire([] { return 2u; }) == 2u);
+            }
+
+            SECTION("PerQueueTimelines")
+            {
+                TestFence otherFence;
+
+                pool.Release(1, fence, 5);
+                pool.Release(2, otherFence, 1);
+
+                otherFence.gpuValue = 1;
+                REQUIRE(pool.TryAcquire() == 2u);
+                REQUIRE(!pool.TryAcquire());
+            }
+
+            SECTION("ConcurrentRelease")
+            {
+                constexpr uint32_t threadsCount = 4;
+                constexpr uint32_t releasesPerThread = 1000;
+
+                std::vector<std::thread> threads;
+                for (uint32_t thread = 0; thread < threadsCount; thread++)
+                    threads.emplace_back([&pool, &fence, thread] {
+                        for (uint32_t index = 0; index < releasesPerThread; index++)
+                            pool.Release(thread * releasesPerThread + index, fence, index);
+                    });
+
+                for (auto& thread : threads)
+                    thread.join();
+
+                fence.gpuValue = releasesPerThread;
+
+                uint32_t acquired = 0;
+                while (pool.TryAcquire())
+                    acquired++;
+
+                REQUIRE(acquired == threadsCount * releasesPerThread);
+            }
+
+            SECTION("Drain")
+            {
+                pool.Release(1, fence, 1);
+                pool.Release(2, fence, 2);
+
+                uint32_t drained = 0;
+                pool.Drain([&drained](uint32_t&&) { drained++; });
+
+                REQUIRE(drained == 2);
+                REQUIRE(!pool.TryAcquire());
+            }
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#include "JobSystem.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/threading/CpuTopology.hpp"
+#include "common/threading/JobSystem.hpp"
+#include "common/threading/Parallel.hpp"
+#include "common/threading/SeqLock.hpp"
+#include "common/threading/Snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+namespace RR
+{
+    namespace Tests
+    {
+        using namespace Common::Threading;
+
+        TEST_CASE("JobSystem", "[Threading][JobSystem]")
+        {
+            auto& jobSystem = JobSystem::Instance();
+
+            // Application may already run the job system.
+            const bool ownsJobSystem = !jobSystem.IsInited();
+            if (ownsJobSystem)
+                jobSystem.Init(3);
+
+            SECTION("ParallelFor")
+            {
+                constexpr size_t count = 100000;
+
+                std::vector<uint32_t> visits(count, 0);
+                ParallelFor(0, count, 100, [&visits](size_t first, size_t last) {
+                    for (size_t index = first; index < last; index++)
+                        visits[index]++;
+                }, CacheLineElements<uint32_t>());
+
+                REQUIRE(std::all_of(visits.begin(), visits.end(), [](uint32_t value) { return value == 1; }));
+            }
+
+            SECTION("ParallelReduce")
+            {
+                constexpr size_t count = 100000;
+
+                const auto sum = ParallelReduce(
+                    0, count, 100, uint64_t(0),
+                    [](size_t first, size_t last) {
+                        uint64_t batchSum = 0;
+                        for (size_t index = first; index < last; index++)
+                            batchSum += index;
+
+                        return batchSum;
+                    },
+                    [](uint64_t accumulated, uint64_t batch) { return accumulated + batch; });
+
+                REQUIRE(sum == uint64_t(count) * (count - 1) / 2);
+
+                // Batches are combined in order.
+                const auto sequence = ParallelReduce(
+                    0, count, 100, std::vector<uint32_t>(),
+                    [](size_t first, size_t last) {
+                        std::vector<uint32_t> batch;
+                        for (size_t index = first; index < last; index++)
+                            batch.push_back(static_cast<uint32_t>(index));
+
+                        return batch;
+                    },
+                    [](std::vector<uint32_t>&& accumulated, std::vector<uint32_t>&& batch) {
+                        accumulated.insert(accumulated.end(), batch.begin(), batch.end());
+                        return std::move(accumulated);
+                    });
+
+                REQUIRE(sequence.size() == count);
+                REQUIRE(std::is_sorted(sequence.begin(), sequence.end()));
+            }
+
+            SECTION("RunAfter")
+            {
+                JobCounter first;
+                JobCounter second;
+
+                std::atomic<uint32_t> finished = 0;
+                std::atomic<bool> isOrdered = true;
+
+                for (uint32_t index = 0; index < 64; index++)
+                    jobSystem.Run([&finished]() { finished++; }, &first);
+
+                jobSystem.RunAfter(first, [&finished, &isOrdered]() { isOrdered = finished == 64; }, &second);
+                jobSystem.WaitFor(second);
+
+                REQUIRE(first.IsDone());
+                REQUIRE(isOrdered);
+            }
+
+            SECTION("Nested wait")
+            {
+                JobCounter counter;
+                std::atomic<uint32_t> finished = 0;
+
+                // Waiting inside a job executes other jobs instead of blocking the worker.
+                for (uint32_t index = 0; index < 16; index++)
+                    jobSystem.Run([&jobSystem, &finished]() {
+                        JobCounter inner;
+                        for (uint32_t innerIndex = 0; innerIndex < 8; innerIndex++)
+                            jobSystem.Run([&finished]() { finished++; }, &inner);
+
+                        jobSystem.WaitFor(inner);
+                    }, &counter);
+
+                jobSystem.WaitFor(counter);
+                REQUIRE(finished == 16 * 8);
+            }
+
+            SECTION("Terminate with queued jobs")
+            {
+                JobSystem localJobSystem;
+                localJobSystem.Init(2);
+
+                JobCounter counter;
+                JobCounter continuationCounter;
+                std::atomic<uint32_t> finished = 0;
+
+                for (uint32_t index = 0; index < 10000; index++)
+                    localJobSystem.Run([&finished]() { finished++; }, &counter);
+
+                localJobSystem.RunAfter(counter, [&finished]() { finished++; }, &continuationCounter);
+
+                // Queued jobs and released continuations are executed before workers are gone.
+                localJobSystem.Terminate();
+
+                REQUIRE(counter.IsDone());
+                REQUIRE(continuationCounter.IsDone());
+                REQUIRE(finished == 10001);
+            }
+
+            if (ownsJobSystem)
+                jobSystem.Terminate();
+        }
+
+        TEST_CASE("CpuTopology", "[Threading][CpuTopology]")
+        {
+            const auto& topology = CpuTopology::Get();
+
+            REQUIRE(topology.GetPhysicalCoresCount() > 0);
+            REQUIRE(topology.GetLogicalProcessorsCount() >= topology.GetPhysicalCoresCount());
+            REQUIRE(!topology.GetLastLevelCaches().empty());
+
+            // Performance cores are a subset of all cores and come first.
+            const auto& performanceMask = topology.GetPerformanceCoresMask();
+            const auto& allMask = topology.GetAllCoresMask();
+            REQUIRE(!performanceMask.IsEmpty());
+            REQUIRE((performanceMask.mask & ~allMask.mask) == 0);
+            REQUIRE((topology.GetCores().front().mask.mask & ~performanceMask.mask) == 0);
+            REQUIRE(topology.IsHybrid() == (performanceMask.mask != allMask.mask));
+
+            for (const auto& core : topology.GetCores())
+                REQUIRE(core.lastLevelCache < topology.GetLastLevelCaches().size());
+        }
+
+        TEST_CASE("Snapshot", "[Threading][Snapshot]")
+        {
+            using Table = std::unordered_map<uint32_t, uint32_t>;
+            Snapshot<Table> snapshot;
+
+            std::atomic<bool> stop = false;
+            std::atomic<bool> consistent = true;
+
+            // Every published version maps key to its double, readers must never see a partially updated table.
+            std::vector<std::thread> readers;
+            for (uint32_t index = 0; index < 3; index++)
+                readers.emplace_back([&] {
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        const auto table = snapshot.Read();
+                        for (const auto& entry : *table)
+                            if (entry.second != entry.first * 2)
+                                consistent = false;
+                    }
+                });
+
+            for (uint32_t index = 0; index < 10000; index++)
+                snapshot.Update([index](Table& table) { table[index % 64] = (index % 64) * 2; });
+
+            stop = true;
+            for (auto& reader : readers)
+                reader.join();
+
+            REQUIRE(consistent);
+            REQUIRE(snapshot.Read()->size() == 64);
+
+            // No readers left, every retired version is reclaimable.
+            EpochDomain::Instance().Collect();
+            REQUIRE(EpochDomain::Instance().GetRetiredCount() == 0);
+        }
+
+        TEST_CASE("SeqLock", "[Threading][SeqLock]")
+        {
+            struct State
+            {
+                uint64_t first;
+                uint64_t second;
+                uint32_t third;
+            };
+
+            SeqLock<State> seqLock({ 0, 0, 0 });
+
+            std::atomic<bool> stop = false;
+            std::atomic<bool> consistent = true;
+
+            std::thread reader([&] {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto state = seqLock.Load();
+                    if (state.first != state.second || state.third != static_cast<uint32_t>(state.first))
+                        consistent = false;
+                }
+            });
+
+            const auto write = [&seqLock] {
+                for (uint64_t index = 0; index < 100000; index++)
+                    seqLock.Store({ index, index, static_cast<uint32_t>(index) });
+            };
+
+            std::thread writer(write);
+            write();
+            writer.join();
+
+            stop = true;
+            reader.join();
+
+            REQUIRE(consistent);
+            REQUIRE(seqLock.Load().first == 99999);
+        }
+    }
+}
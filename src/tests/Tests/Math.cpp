@@ -0,0 +1,229 @@
+#include "Math.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/FastMath.hpp"
+#include "common/Math.hpp"
+
+#include <cstring>
+
+namespace RR
+{
+    namespace Tests
+    {
+        namespace
+        {
+            // Reference implementation, SIMD backend is expected to match it bit exactly.
+            Matrix4 multiplyScalar(const Matrix4& a, const Matrix4& b)
+            {
+                Matrix4 result;
+                const float* lhs = &a.e00;
+                const float* rhs = &b.e00;
+                float* dest = &result.e00;
+
+                for (uint32_t column = 0; column < 4; column++)
+                    for (uint32_t row = 0; row < 4; row++)
+                        dest[column * 4 + row] = lhs[row] * rhs[column * 4] + lhs[4 + row] * rhs[column * 4 + 1] +
+                                                 lhs[8 + row] * rhs[column * 4 + 2] + lhs[12 + row] * rhs[column * 4 + 3];
+
+                return result;
+            }
+
+            std::vector<Matrix4> randomMatrices(size_t count)
+            {
+                srand(42);
+                std::vector<Matrix4> matrices(count);
+
+                for (auto& matrix : matrices)
+                    for (uint32_t index = 0; index < 16; index++)
+                        (&matrix.e00)[index] = FRandom() * 2.0f - 1.0f;
+
+                return matrices;
+            }
+
+            bool isEqual(const Matrix4& a, const Matrix4& b)
+            {
+                return memcmp(&a, &b, sizeof(Matrix4)) == 0;
+            }
+        }
+
+        TEST_CASE("Matrix4", "[Math][Matrix4]")
+        {
+            const auto matrices = randomMatrices(256);
+
+            SECTION("Alignment")
+            {
+                REQUIRE(alignof(Matrix4) == 16);
+                REQUIRE(sizeof(Matrix4) == 16 * sizeof(float));
+            }
+
+            SECTION("Multiply")
+            {
+                for (size_t index = 0; index + 1 < matrices.size(); index++)
+                    REQUIRE(isEqual(matrices[index] * matrices[index + 1], multiplyScalar(matrices[index], matrices[index + 1])));
+            }
+
+            SECTION("Transform")
+            {
+                const Vector4 vector(0.5f, -2.0f, 3.0f, 1.0f);
+
+                for (const auto& matrix : matrices)
+                {
+                    const auto expected = Vector4(
+                        matrix.e00 * vector.x + matrix.e01 * vector.y + matrix.e02 * vector.z + matrix.e03 * vector.w,
+                        matrix.e10 * vector.x + matrix.e11 * vector.y + matrix.e12 * vector.z + matrix.e13 * vector.w,
+                        matrix.e20 * vector.x + matrix.e21 * vector.y + matrix.e22 * vector.z + matrix.e23 * vector.w,
+                        matrix.e30 * vector.x + matrix.e31 * vector.y + matrix.e32 * vector.z + matrix.e33 * vector.w);
+
+                    REQUIRE(matrix * vector == expected);
+                    REQUIRE(matrix * vector.xyz() == expected.xyz());
+                }
+            }
+
+            SECTION("Transpose")
+            {
+                for (const auto& matrix : matrices)
+                {
+                    const auto transposed = matrix.Transpose();
+
+                    for (uint32_t column = 0; column < 4; column++)
+                        for (uint32_t row = 0; row < 4; row++)
+                            REQUIRE((&transposed.e00)[column * 4 + row] == (&matrix.e00)[row * 4 + column]);
+                }
+            }
+
+            SECTION("Constexpr")
+            {
+                constexpr Matrix4 translation = []() {
+                    Matrix4 m(Identity);
+                    m.Translate(Vector3(1.0f, 2.0f, 3.0f));
+                    m.Scale(Vector3(2.0f));
+                    return m;
+                }();
+
+                static_assert(translation * Vector3(1.0f, 1.0f, 1.0f) == Vector3(3.0f, 4.0f, 5.0f));
+                static_assert(translation.Transpose().e30 == 1.0f);
+                static_assert((translation * translation.Inverse()).e03 == 0.0f);
+
+                // Constant evaluated scalar path matches runtime SIMD path bit for bit.
+                constexpr Matrix4 squared = translation * translation;
+                const Matrix4 runtime = translation;
+                REQUIRE(isEqual(runtime * runtime, squared));
+            }
+        }
+
+        TEST_CASE("TransformBatch", "[Math][TransformBatch]")
+        {
+            TransformBatch batch;
+            for (uint32_t index = 0; index < 7; index++)
+                batch.Add(Vector3(float(index), 1.0f, -2.0f), Quaternion(0.5f, 0.5f, 0.5f, 0.5f), Vector3(2.0f));
+
+            std::vector<Matrix4> expected(batch.GetSize());
+            batch.ComputeWorldMatrices(expected.data());
+
+            SECTION("Attach")
+            {
+                // Padded copy of components stands in for memory mapped storage.
+                std::vector<float> storage[TransformBatch::Component::Count];
+                const float* components[TransformBatch::Component::Count];
+                for (uint32_t component = 0; component < TransformBatch::Component::Count; component++)
+                {
+                    const auto data = batch.GetComponent(static_cast<TransformBatch::Component>(component));
+                    storage[component].assign(data, data + 8);
+                    components[component] = storage[component].data();
+                }
+
+                TransformBatch attached;
+                attached.Attach(components, batch.GetSize());
+                REQUIRE(attached.IsAttached());
+                REQUIRE(attached.GetComponent(TransformBatch::PositionX) == storage[TransformBatch::PositionX].data());
+
+                std::vector<Matrix4> matrices(attached.GetSize());
+                attached.ComputeWorldMatrices(matrices.data());
+                for (size_t index = 0; index < matrices.size(); index++)
+                    REQUIRE(isEqual(matrices[index], expected[index]));
+
+                // Modification copies storage first and leaves it intact.
+                attached.Set(1, Vector3(5.0f), Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+                REQUIRE(!attached.IsAttached());
+                REQUIRE(attached.GetComponent(TransformBatch::PositionX)[1] == 5.0f);
+                REQUIRE(attached.GetComponent(TransformBatch::PositionX)[2] == 2.0f);
+                REQUIRE(storage[TransformBatch::PositionX][1] == 1.0f);
+            }
+        }
+
+        TEST_CASE("FastMath", "[Math][FastMath]")
+        {
+            using namespace FastMath;
+
+            // Max error of scalar and Simd::Float4 versions over samples of [min, max].
+            const auto maxError = [](float min, float max, auto approximation, auto reference, bool relative) {
+                constexpr int Samples = 20000;
+                double result = 0.0;
+
+                for (int index = 0; index < Samples; index++)
+                {
+                    const float x = min + (max - min) * static_cast<float>(index) / (Samples - 1);
+                    const double expected = reference(static_cast<double>(x));
+                    const double scale = relative ? std::abs(expected) : 1.0;
+
+                    float lanes[4];
+                    Simd::Store(lanes, approximation(Simd::Splat(x)));
+
+                    result = std::max(result, std::abs(approximation(x) - expected) / scale);
+                    result = std::max(result, std::abs(lanes[index % 4] - expected) / scale);
+                }
+
+                return result;
+            };
+
+            SECTION("Medium")
+            {
+                REQUIRE(maxError(1e-6f, 1e6f, [](auto x) { return Rsqrt(x); }, [](double x) { return 1.0 / std::sqrt(x); }, true) < 5e-6);
+                REQUIRE(maxError(-1e4f, 1e4f, [](auto x) { return Sin(x); }, [](double x) { return std::sin(x); }, false) < 2e-6);
+                REQUIRE(maxError(-1e4f, 1e4f, [](auto x) { return Cos(x); }, [](double x) { return std::cos(x); }, false) < 2e-6);
+                REQUIRE(maxError(-4.0f, 4.0f, [](auto x) { return Atan2(x, Details::splat<decltype(x)>(1.5f)); }, [](double x) { return std::atan2(x, 1.5); }, false) < 5e-7);
+                REQUIRE(maxError(-4.0f, 4.0f, [](auto x) { return Atan2(x, Details::splat<decltype(x)>(-1.5f)); }, [](double x) { return std::atan2(x, -1.5); }, false) < 5e-7);
+                REQUIRE(maxError(-126.0f, 127.0f, [](auto x) { return Exp2(x); }, [](double x) { return std::exp2(x); }, true) < 5e-7);
+                REQUIRE(maxError(0.1f, 10.0f, [](auto x) { return Log(x); }, [](double x) { return std::log(x); }, false) < 5e-7);
+            }
+
+            SECTION("Low")
+            {
+                REQUIRE(maxError(1e-6f, 1e6f, [](auto x) { return Rsqrt<Precision::Low>(x); }, [](double x) { return 1.0 / std::sqrt(x); }, true) < 2e-3);
+                REQUIRE(maxError(-1e4f, 1e4f, [](auto x) { return Sin<Precision::Low>(x); }, [](double x) { return std::sin(x); }, false) < 5e-4);
+                REQUIRE(maxError(-126.0f, 127.0f, [](auto x) { return Exp2<Precision::Low>(x); }, [](double x) { return std::exp2(x); }, true) < 1e-4);
+                REQUIRE(maxError(0.1f, 10.0f, [](auto x) { return Log2<Precision::Low>(x); }, [](double x) { return std::log2(x); }, false) < 1e-4);
+            }
+        }
+
+        TEST_CASE("Matrix4 benchmark", "[Math][Matrix4][!benchmark]")
+        {
+            const auto matrices = randomMatrices(1024);
+
+            BENCHMARK("Multiply scalar")
+            {
+                Matrix4 result(Identity);
+                for (const auto& matrix : matrices)
+                    result = multiplyScalar(result, matrix);
+                return result;
+            };
+
+            BENCHMARK("Multiply")
+            {
+                Matrix4 result(Identity);
+                for (const auto& matrix : matrices)
+                    result = result * matrix;
+                return result;
+            };
+
+            BENCHMARK("Transform")
+            {
+                Vector4 result(0.0f);
+                for (const auto& matrix : matrices)
+                    result += matrix * Vector4(1.0f, 2.0f, 3.0f, 1.0f);
+                return result;
+            };
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "MpscChannel.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/threading/MpscChannel.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        using namespace Common::Threading;
+
+        TEST_CASE("MpscChannel", "[Threading][MpscChannel]")
+        {
+            SECTION("TryPutFull")
+            {
+                MpscChannel<uint32_t, 4> channel;
+
+                for (uint32_t index = 0; index < 4; index++)
+                    REQUIRE(channel.TryPut(index));
+
+                REQUIRE(!channel.TryPut(4));
+                REQUIRE(channel.TryGetNext() == 0u);
+                REQUIRE(channel.TryPut(4));
+
+                for (uint32_t index = 1; index < 5; index++)
+                    REQUIRE(channel.TryGetNext() == index);
+
+                REQUIRE(!channel.TryGetNext());
+            }
+
+            SECTION("Close")
+            {
+                MpscChannel<uint32_t, 4> channel;
+
+                channel.Put(1);
+                channel.Close();
+
+                REQUIRE(!channel.TryPut(2));
+                // Items put before close are still delivered.
+                REQUIRE(channel.GetNext() == 1u);
+                REQUIRE(!channel.GetNext());
+            }
+
+            SECTION("CloseWhileProducing")
+            {
+                constexpr uint32_t producersCount = 4;
+
+                for (uint32_t iteration = 0; iteration < 200; iteration++)
+                {
+                    MpscChannel<uint32_t, 1024> channel;
+                    std::atomic<uint32_t> accepted = 0;
+
+                    std::vector<std::thread> producers;
+                    for (uint32_t producer = 0; producer < producersCount; producer++)
+                        producers.emplace_back([&channel, &accepted] {
+                            while (channel.TryPut(1))
+                                accepted++;
+                        });
+
+                    std::this_thread::yield();
+                    channel.Close();
+
+                    // Every item accepted by TryPut is delivered even when close races with publication.
+                    uint32_t received = 0;
+                    while (channel.GetNext())
+                        received++;
+
+                    for (auto& producer : producers)
+                        producer.join();
+
+                    REQUIRE(received == accepted);
+                }
+            }
+
+            SECTION("MultipleProducers")
+            {
+                constexpr uint32_t producersCount = 4;
+                constexpr uint32_t itemsPerProducer = 50000;
+
+                // Small buffer, so producers wrap around and wait for consumer often.
+                MpscChannel<uint64_t, 64> channel;
+
+                std::vector<std::thread> producers;
+                for (uint32_t producer = 0; producer < producersCount; producer++)
+                    producers.emplace_back([&channel, producer] {
+                        for (uint32_t index = 0; index < itemsPerProducer; index++)
+                            channel.Put(uint64_t(producer) << 32 | index);
+                    });
+
+                // Next expected index of each producer, items of one producer arrive once and in order.
+                std::vector<uint32_t> expected(producersCount, 0);
+                bool isOrdered = true;
+
+                for (uint32_t received = 0; received < producersCount * itemsPerProducer; received++)
+                {
+                    const auto item = channel.GetNext();
+                    REQUIRE(item);
+
+                    const auto producer = static_cast<uint32_t>(*item >> 32);
+                    const auto index = static_cast<uint32_t>(*item);
+                    REQUIRE(producer < producersCount);
+
+                    isOrdered &= index == expected[producer];
+                    expected[producer] = index + 1;
+                }
+
+                for (auto& producer : producers)
+                    producer.join();
+
+                REQUIRE(isOrdered);
+                REQUIRE(std::all_of(expected.begin(), expected.end(), [](uint32_t count) { return count == itemsPerProducer; }));
+                REQUIRE(!channel.TryGetNext());
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include "MultipleDevices.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "gapi/Buffer.hpp"
+#include "gapi/CommandList.hpp"
+#include "gapi/CommandQueue.hpp"
+#include "gapi/Device.hpp"
+#include "gapi/Fence.hpp"
+#include "gapi/MemoryAllocation.hpp"
+
+#include "render/DeviceContext.hpp"
+
+namespace RR
+{
+    namespace Tests
+    {
+        namespace
+        {
+            struct BufferReadback
+            {
+                std::shared_ptr<GAPI::Buffer> buffer;
+                std::shared_ptr<GAPI::CpuResourceData> readbackData;
+                GAPI::GpuSyncPoint syncPoint;
+            };
+
+            BufferReadback uploadAndReadback(Render::DeviceContext& deviceContext, const char* data)
+            {
+                const auto& description = GAPI::GpuResourceDescription::Buffer(strlen(data));
+
+                const auto bufferData = deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::CpuReadWrite);
+                bufferData->WriteSubresource(0, data, bufferData->GetSubresourceFootprintAt(0).rowSizeInBytes);
+
+                BufferReadback result;
+                result.buffer = deviceContext.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Buffer");
+                result.readbackData = deviceContext.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                const auto& commandList = deviceContext.CreateCopyCommandList("MultipleDevices");
+                commandList->UpdateGpuResource(result.buffer, bufferData);
+                commandList->ReadbackGpuResource(result.buffer, result.readbackData);
+                commandList->Close();
+
+                result.syncPoint = deviceContext.Submit(deviceContext.GetCommandQueue(GAPI::CommandQueueType::Copy), commandList);
+                return result;
+            }
+        }
+
+        // Contexts are independent of the shared one of the test application, so three devices are live at once.
+        TEST_CASE("MultipleDeviceContexts", "[Device][MultipleDevices]")
+        {
+            Render::DeviceContext first;
+            Render::DeviceContext second;
+
+            first.Init();
+            second.Init();
+
+            {
+                // Work of both devices is in flight together.
+                const auto firstReadback = uploadAndReadback(first, "1234567890");
+                const auto secondReadback = uploadAndReadback(second, "QWERTYUIOP");
+
+                firstReadback.syncPoint.Wait();
+                secondReadback.syncPoint.Wait();
+
+                const auto& footprint = firstReadback.readbackData->GetSubresourceFootprintAt(0);
+                REQUIRE(memcmp(firstReadback.readbackData->GetAllocation()->Map(), "1234567890", footprint.rowSizeInBytes) == 0);
+                REQUIRE(memcmp(secondReadback.readbackData->GetAllocation()->Map(), "QWERTYUIOP", footprint.rowSizeInBytes) == 0);
+                firstReadback.readbackData->GetAllocation()->Unmap();
+                secondReadback.readbackData->GetAllocation()->Unmap();
+            }
+
+            // Terminated in creation order, not in reverse, so nothing depends on the last created device.
+            first.Terminate();
+            second.Terminate();
+        }
+
+        TEST_CASE("CrossDeviceBufferCopy", "[Device][MultipleDevices]")
+        {
+            Render::DeviceContext producer;
+            Render::DeviceContext consumer;
+
+            // Different adapters when node has several, otherwise both devices are created on the same one.
+            const auto& adapters = Render::DeviceContext::EnumerateAdapters();
+            REQUIRE(!adapters.empty());
+
+            producer.Init(Render::DeviceContext::DefaultGpuFramesBuffered, "", adapters.front().index);
+            consumer.Init(Render::DeviceContext::DefaultGpuFramesBuffered, "", adapters.back().index);
+
+            {
+                const auto testData = "1234567890";
+                const auto& description = GAPI::GpuResourceDescription::Buffer(strlen(testData));
+
+                const auto sharedBuffer = producer.CreateSharedBuffer(description, "Shared");
+                const auto sharedFence = producer.CreateSharedFence("Shared");
+                const auto openedBuffer = consumer.OpenSharedBuffer(sharedBuffer, "Opened");
+                const auto openedFence = consumer.OpenSharedFence(sharedFence, "Opened");
+
+                const auto& producerQueue = producer.GetCommandQueue(GAPI::CommandQueueType::Copy);
+                const auto& consumerQueue = consumer.GetCommandQueue(GAPI::CommandQueueType::Copy);
+
+                const auto sourceData = producer.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::CpuReadWrite);
+                sourceData->WriteSubresource(0, testData, sourceData->GetSubresourceFootprintAt(0).rowSizeInBytes);
+                const auto source = producer.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Source");
+
+                const auto& producerCommandList = producer.CreateCopyCommandList("Producer");
+                producerCommandList->UpdateGpuResource(source, sourceData);
+                producerCommandList->CopyGpuResource(source, sharedBuffer);
+                producerCommandList->Close();
+
+                producer.Submit(producerQueue, producerCommandList);
+                const auto producedSyncPoint = producer.Signal(producerQueue, sharedFence);
+
+                const auto dest = consumer.CreateBuffer(description, GAPI::GpuResourceCpuAccess::None, "Dest");
+                const auto readbackData = consumer.AllocateIntermediateResourceData(description, GAPI::MemoryAllocationType::Readback);
+
+                const auto& consumerCommandList = consumer.CreateCopyCommandList("Consumer");
+                consumerCommandList->CopyGpuResource(openedBuffer, dest);
+                consumerCommandList->ReadbackGpuResource(dest, readbackData);
+                consumerCommandList->Close();
+
+                // Consumer queue waits on GPU for the value signaled by producer device.
+                consumer.Wait(consumerQueue, { openedFence, producedSyncPoint.value });
+                consumer.Submit(consumerQueue, consumerCommandList).Wait();
+
+                const auto& footprint = readbackData->GetSubresourceFootprintAt(0);
+                REQUIRE(memcmp(readbackData->GetAllocation()->Map(), testData, footprint.rowSizeInBytes) == 0);
+                readbackData->GetAllocation()->Unmap();
+
+                producer.WaitForGpu(producerQueue);
+            }
+
+            consumer.Terminate();
+            producer.Terminate();
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "ResourceCreation.hpp"
+
+#include "TestContextFixture.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "gapi/Buffer.hpp"
+#include "gapi/DeviceStatistics.hpp"
+#include "gapi/GpuResourceViews.hpp"
+#include "gapi/Texture.hpp"
+
+#include "render/DeviceContext.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        TEST_CASE_METHOD(TestContextFixture, "ConcurrentResourceCreation", "[Threading][ResourceCreation]")
+        {
+            constexpr uint32_t threadsCount = 8;
+            constexpr uint32_t iterationsCount = 256;
+
+            const auto getAllocatedDescriptors = [this](GAPI::DescriptorHeapType type) {
+                return renderContext.GetDeviceStatistics().descriptorHeaps[static_cast<size_t>(type)].allocatedCount;
+            };
+
+            const auto cbvSrvUavBefore = getAllocatedDescriptors(GAPI::DescriptorHeapType::CbvSrvUav);
+            const auto rtvBefore = getAllocatedDescriptors(GAPI::DescriptorHeapType::RenderTarget);
+
+            {
+                struct ThreadResults
+                {
+                    std::vector<std::shared_ptr<GAPI::GpuResource>> resources;
+                    std::vector<std::shared_ptr<GAPI::GpuResourceView>> views;
+                };
+
+                std::array<ThreadResults, threadsCount> results;
+                std::atomic<uint32_t> failures = 0;
+                // Threads start together to maximize contention.
+                std::atomic<bool> start = false;
+
+                std::vector<std::thread> threads;
+                for (uint32_t threadIndex = 0; threadIndex < threadsCount; threadIndex++)
+                {
+                    threads.emplace_back([&, threadIndex] {
+                        auto& result = results[threadIndex];
+
+                        while (!start.load(std::memory_order_acquire))
+                            std::this_thread::yield();
+
+                        for (uint32_t iteration = 0; iteration < iterationsCount; iteration++)
+                        {
+                            const auto& bufferDescription = GAPI::GpuResourceDescription::Buffer(256, GAPI::GpuResourceBindFlags::ShaderResource | GAPI::GpuResourceBindFlags::UnorderedAccess);
+                            const auto buffer = renderContext.CreateBuffer(bufferDescription);
+
+                            const auto& textureDescription = GAPI::GpuResourceDescription::Texture2D(16, 16, GAPI::GpuResourceFormat::RGBA8Unorm, GAPI::GpuResourceBindFlags::ShaderResource | GAPI::GpuResourceBindFlags::RenderTarget, 1, 1);
+                            const auto texture = renderContext.CreateTexture(textureDescription);
+
+                            if (!buffer || !texture)
+                            {
+                                failures++;
+                                continue;
+                            }
+
+                            result.views.push_back(buffer->GetSRV(GAPI::GpuResourceFormat::R32Uint));
+                            result.views.push_back(buffer->GetUAV(GAPI::GpuResourceFormat::R32Uint));
+                            result.views.push_back(texture->GetSRV());
+                            result.views.push_back(texture->GetRTV());
+
+                            result.resources.push_back(buffer);
+                            result.resources.push_back(texture);
+                        }
+                    });
+                }
+
+                start.store(true, std::memory_order_release);
+                for (auto& thread : threads)
+                    thread.join();
+
+                REQUIRE(failures == 0);
+
+                // Live shader visible views never share bindless slot.
+                std::vector<uint32_t> bindlessIndices;
+                for (const auto& result : results)
+                {
+                    REQUIRE(result.views.size() == iterationsCount * 4);
+
+                    for (const auto& view : result.views)
+                    {
+                        REQUIRE(view);
+
+                        if (view->GetViewType() != GAPI::GpuResourceView::ViewType::RenderTargetView)
+                            bindlessIndices.push_back(view->GetBindlessIndex());
+                    }
+                }
+
+                std::sort(bindlessIndices.begin(), bindlessIndices.end());
+                REQUIRE(std::adjacent_find(bindlessIndices.begin(), bindlessIndices.end()) == bindlessIndices.end());
+            }
+
+            // CPU descriptors are returned as soon as views are released.
+            REQUIRE(getAllocatedDescriptors(GAPI::DescriptorHeapType::CbvSrvUav) == cbvSrvUavBefore);
+            REQUIRE(getAllocatedDescriptors(GAPI::DescriptorHeapType::RenderTarget) == rtvBefore);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#include "SpinLock.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/threading/SpinLock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        using namespace Common::Threading;
+
+        TEST_CASE("SpinLock", "[Threading][SpinLock]")
+        {
+            SpinLock spinLock;
+
+            SECTION("TryLock")
+            {
+                REQUIRE(spinLock.tryLock());
+                REQUIRE(!spinLock.tryLock());
+
+                spinLock.unlock();
+                REQUIRE(spinLock.tryLock());
+                spinLock.unlock();
+            }
+
+            SECTION("ContendedCounter")
+            {
+                constexpr uint32_t threadsCount = 4;
+                constexpr uint32_t incrementsPerThread = 100000;
+
+                // Plain counter, lost updates show broken mutual exclusion.
+                uint64_t counter = 0;
+
+                std::vector<std::thread> threads;
+                for (uint32_t thread = 0; thread < threadsCount; thread++)
+                    threads.emplace_back([&spinLock, &counter] {
+                        for (uint32_t index = 0; index < incrementsPerThread; index++)
+                        {
+                            std::lock_guard<SpinLock> lock(spinLock);
+                            counter++;
+                        }
+                    });
+
+                for (auto& thread : threads)
+                    thread.join();
+
+                REQUIRE(counter == uint64_t(threadsCount) * incrementsPerThread);
+            }
+
+            SECTION("ParkedWaiterIsWoken")
+            {
+                spinLock.lock();
+
+                std::atomic<bool> isAcquired = false;
+                std::thread waiter([&spinLock, &isAcquired] {
+                    spinLock.lock();
+                    isAcquired = true;
+                    spinLock.unlock();
+                });
+
+                // Lock is held until waiter runs out of spin budget and parks.
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while (spinLock.GetStatistics().parks == 0 && std::chrono::steady_clock::now() < deadline)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                REQUIRE(spinLock.GetStatistics().parks == 1);
+                REQUIRE(!isAcquired);
+
+                spinLock.unlock();
+                waiter.join();
+
+                REQUIRE(isAcquired);
+                // Lock is free again after parked waiter released it.
+                REQUIRE(spinLock.tryLock());
+                spinLock.unlock();
+            }
+        }
+    }
+}
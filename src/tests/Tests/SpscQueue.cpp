@@ -0,0 +1,212 @@
+#include "SpscQueue.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/CircularBuffer.hpp"
+#include "common/threading/SpscQueue.hpp"
+
+#include <thread>
+
+namespace RR
+{
+    namespace Tests
+    {
+        using namespace Common::Threading;
+
+        namespace
+        {
+            // Counts live instances, so missed or doubled destructor calls show up.
+            struct Tracked
+            {
+                static inline int32_t alive = 0;
+
+                Tracked(uint32_t value) : value(value) { alive++; }
+                Tracked(const Tracked& other) : value(other.value) { alive++; }
+                Tracked(Tracked&& other) noexcept : value(other.value) { alive++; }
+                ~Tracked() { alive--; }
+
+                uint32_t value;
+            };
+        }
+
+        TEST_CASE("CircularBuffer", "[Common][CircularBuffer]")
+        {
+            Tracked::alive = 0;
+
+            SECTION("Boundaries")
+            {
+                CircularBuffer<uint32_t, 4> buffer;
+                REQUIRE(buffer.empty());
+                REQUIRE(!buffer.full());
+
+                for (uint32_t index = 0; index < 4; index++)
+                    buffer.push_back(index);
+
+                REQUIRE(buffer.full());
+                REQUIRE(buffer.size() == 4);
+                REQUIRE(buffer.front() == 0u);
+                REQUIRE(buffer.back() == 3u);
+
+                for (uint32_t index = 0; index < 4; index++)
+                    buffer.pop_front();
+
+                REQUIRE(buffer.empty());
+                REQUIRE(buffer.size() == 0);
+            }
+
+            SECTION("Wraparound")
+            {
+                CircularBuffer<uint32_t, 4> buffer;
+
+                // Positions run many times around the storage.
+                uint32_t next = 0;
+                for (uint32_t round = 0; round < 100; round++)
+                {
+                    while (!buffer.full())
+                        buffer.push_back(next++);
+
+                    for (uint32_t index = 0; index < buffer.size(); index++)
+                        REQUIRE(buffer.at(index) == next - 4 + index);
+
+                    buffer.pop_front();
+                    buffer.pop_front();
+                    buffer.pop_front();
+                }
+
+                REQUIRE(buffer.size() == 1);
+                REQUIRE(buffer.front() == next - 1);
+            }
+
+            SECTION("Destructors")
+            {
+                {
+                    CircularBuffer<Tracked, 4> buffer;
+
+                    buffer.emplace_back(1u);
+                    buffer.emplace_back(2u);
+                    REQUIRE(Tracked::alive == 2);
+
+                    buffer.pop_front();
+                    REQUIRE(Tracked::alive == 1);
+
+                    for (uint32_t index = 0; index < 3; index++)
+                        buffer.emplace_back(index);
+
+                    const CircularBuffer<Tracked, 4> copy = buffer;
+                    REQUIRE(Tracked::alive == 8);
+                    REQUIRE(copy.front().value == 2u);
+
+                    buffer.clear();
+                    REQUIRE(Tracked::alive == 4);
+                    REQUIRE(buffer.empty());
+
+                    buffer.emplace_back(5u);
+                }
+
+                REQUIRE(Tracked::alive == 0);
+            }
+        }
+
+        TEST_CASE("SpscQueue", "[Threading][SpscQueue]")
+        {
+            Tracked::alive = 0;
+
+            SECTION("Boundaries")
+            {
+                SpscQueue<uint32_t, 4> queue;
+                REQUIRE(!queue.Front());
+                REQUIRE(!queue.TryPop());
+
+                for (uint32_t index = 0; index < 4; index++)
+                    REQUIRE(queue.TryPush(index));
+
+                REQUIRE(!queue.TryPush(4));
+                REQUIRE(queue.GetSize() == 4);
+
+                REQUIRE(queue.TryPop() == 0u);
+                REQUIRE(queue.TryPush(4));
+
+                for (uint32_t index = 1; index < 5; index++)
+                    REQUIRE(queue.TryPop() == index);
+
+                REQUIRE(!queue.Front());
+                REQUIRE(queue.GetSize() == 0);
+            }
+
+            SECTION("Wraparound")
+            {
+                SpscQueue<uint32_t, 8> queue;
+
+                uint32_t pushed = 0;
+                uint32_t popped = 0;
+                for (uint32_t round = 0; round < 100; round++)
+                {
+                    while (queue.TryPush(pushed))
+                        pushed++;
+
+                    for (uint32_t index = 0; index < 5; index++)
+                        REQUIRE(queue.TryPop() == popped++);
+                }
+
+                while (const auto item = queue.TryPop())
+                    REQUIRE(*item == popped++);
+
+                REQUIRE(popped == pushed);
+            }
+
+            SECTION("Destructors")
+            {
+                {
+                    SpscQueue<Tracked, 4> queue;
+
+                    REQUIRE(queue.TryEmplace(1u));
+                    REQUIRE(queue.TryEmplace(2u));
+                    REQUIRE(queue.TryPush(Tracked(3u)));
+                    REQUIRE(Tracked::alive == 3);
+
+                    REQUIRE(queue.Front()->value == 1u);
+                    queue.Pop();
+                    REQUIRE(Tracked::alive == 2);
+
+                    {
+                        const auto item = queue.TryPop();
+                        REQUIRE(item->value == 2u);
+                    }
+                    REQUIRE(Tracked::alive == 1);
+
+                    // Left for destructor.
+                    REQUIRE(queue.TryEmplace(4u));
+                }
+
+                REQUIRE(Tracked::alive == 0);
+            }
+
+            SECTION("Concurrent")
+            {
+                constexpr uint32_t itemsCount = 1000000;
+
+                SpscQueue<uint32_t, 64> queue;
+
+                std::thread producer([&queue] {
+                    for (uint32_t index = 0; index < itemsCount; index++)
+                        while (!queue.TryPush(index))
+                            std::this_thread::yield();
+                });
+
+                bool isOrdered = true;
+                for (uint32_t expected = 0; expected < itemsCount;)
+                {
+                    if (const auto item = queue.TryPop())
+                        isOrdered &= *item == expected++;
+                    else
+                        std::this_thread::yield();
+                }
+
+                producer.join();
+
+                REQUIRE(isOrdered);
+                REQUIRE(!queue.Front());
+            }
+        }
+    }
+}
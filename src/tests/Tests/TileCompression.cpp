@@ -0,0 +1,66 @@
+#include "TileCompression.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "common/TileCompression.hpp"
+
+#include <random>
+
+namespace RR
+{
+    namespace Tests
+    {
+        TEST_CASE("TileCompression", "[Compression]")
+        {
+            std::mt19937 random(42);
+
+            const auto roundTrip = [](const std::vector<uint8_t>& data) {
+                const auto compressed = Common::TileCompression::Compress(data.data(), data.size());
+                REQUIRE(compressed.size() % sizeof(uint32_t) == 0);
+
+                std::vector<uint8_t> decompressed(data.size());
+                REQUIRE(Common::TileCompression::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+                REQUIRE(decompressed == data);
+
+                return compressed.size();
+            };
+
+            // Sizes around tile and minimal match boundaries.
+            for (const size_t size : std::initializer_list<size_t> { 0, 1, 5, 12, 13, 100, 65535, 65536, 65537, 200003 })
+            {
+                DYNAMIC_SECTION("Size " << size)
+                {
+                    std::vector<uint8_t> noise(size);
+                    for (auto& value : noise)
+                        value = static_cast<uint8_t>(random());
+                    roundTrip(noise);
+
+                    std::vector<uint8_t> pattern(size);
+                    for (size_t index = 0; index < size; index++)
+                        pattern[index] = static_cast<uint8_t>(index % 7);
+
+                    const auto compressedSize = roundTrip(pattern);
+                    if (size >= Common::TileCompression::TileSize)
+                        REQUIRE(compressedSize * 50 < size);
+                }
+            }
+
+            SECTION("Malformed")
+            {
+                std::vector<uint8_t> data(100000);
+                for (size_t index = 0; index < data.size(); index++)
+                    data[index] = static_cast<uint8_t>(random() % 4);
+
+                auto compressed = Common::TileCompression::Compress(data.data(), data.size());
+                std::vector<uint8_t> decompressed(data.size());
+
+                REQUIRE_FALSE(Common::TileCompression::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size() - 1));
+                REQUIRE_FALSE(Common::TileCompression::Decompress(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size()));
+
+                // Corrupted tile data either fails or stays within destination.
+                compressed[compressed.size() / 2] ^= 0x5A;
+                std::ignore = Common::TileCompression::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+            }
+        }
+    }
+}